@@ -5,6 +5,8 @@ option(BUILD_NOGUI_FRONTEND "Build the NoGUI frontend" OFF)
 option(BUILD_QT_FRONTEND "Build the Qt frontend" ON)
 option(BUILD_REGTEST "Build regression test runner" OFF)
 option(BUILD_TESTS "Build unit tests" OFF)
+option(BUILD_BENCHMARKS "Build microbenchmarks" OFF)
+option(ENABLE_TRACING "Build with timeline tracing support" OFF)
 
 if(LINUX OR BSD)
   option(ENABLE_X11 "Support X11 window system" ON)
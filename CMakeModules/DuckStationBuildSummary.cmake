@@ -23,6 +23,12 @@ endif()
 if(BUILD_TESTS)
   message(STATUS "Building unit tests.")
 endif()
+if(BUILD_BENCHMARKS)
+  message(STATUS "Building microbenchmarks.")
+endif()
+if(ENABLE_TRACING)
+  message(STATUS "Building with timeline tracing.")
+endif()
 
 if(NOT IS_SUPPORTED_COMPILER)
   message(WARNING "
@@ -0,0 +1,110 @@
+import argparse
+import hashlib
+import sys
+import zipfile
+
+# Creates a delta update zip from two release zips. See src/common/binary_delta.h for the format.
+
+MANIFEST_FILENAME = "delta_manifest.txt"
+PATCH_SUFFIX = ".delta"
+PATCH_MAGIC = b"DSDELTA1"
+BLOCK_SIZE = 32
+
+# Always stored in full, the frontend extracts it from the zip before anything is patched.
+ALWAYS_FULL = ("updater.exe",)
+
+
+def sha1(data):
+    return hashlib.sha1(data).hexdigest()
+
+
+def make_patch(source, target):
+    blocks = {}
+    for offset in range(0, len(source) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        blocks.setdefault(source[offset:offset + BLOCK_SIZE], offset)
+
+    out = bytearray(PATCH_MAGIC)
+    out += len(target).to_bytes(8, "little")
+    literal = bytearray()
+
+    def flush_literal():
+        if literal:
+            out.append(0x01)
+            out.extend(len(literal).to_bytes(4, "little"))
+            out.extend(literal)
+            literal.clear()
+
+    pos = 0
+    while pos < len(target):
+        offset = blocks.get(target[pos:pos + BLOCK_SIZE]) if (len(target) - pos) >= BLOCK_SIZE else None
+        if offset is None:
+            literal.append(target[pos])
+            pos += 1
+            continue
+
+        length = BLOCK_SIZE
+        while (pos + length) < len(target) and (offset + length) < len(source) and \
+                target[pos + length] == source[offset + length] and length < 0xFFFFFFFF:
+            length += 1
+
+        flush_literal()
+        out.append(0x00)
+        out += offset.to_bytes(8, "little")
+        out += length.to_bytes(4, "little")
+        pos += length
+
+    flush_literal()
+    return bytes(out)
+
+
+def make_delta_update(old_zip_path, new_zip_path, out_zip_path):
+    with zipfile.ZipFile(old_zip_path) as old_zip:
+        old_files = {info.filename: old_zip.read(info) for info in old_zip.infolist() if not info.is_dir()}
+
+    manifest = []
+    with zipfile.ZipFile(new_zip_path) as new_zip, \
+            zipfile.ZipFile(out_zip_path, "w", zipfile.ZIP_DEFLATED, compresslevel=9) as out_zip:
+        new_filenames = set()
+        for info in new_zip.infolist():
+            if info.is_dir():
+                continue
+
+            new_filenames.add(info.filename)
+
+            data = new_zip.read(info)
+            old_data = old_files.get(info.filename)
+            if old_data == data and info.filename not in ALWAYS_FULL:
+                continue
+
+            if old_data is not None and info.filename not in ALWAYS_FULL:
+                patch = make_patch(old_data, data)
+                if len(patch) < len(data):
+                    print("Patched %s: %u -> %u bytes" % (info.filename, len(data), len(patch)))
+                    out_info = zipfile.ZipInfo(info.filename + PATCH_SUFFIX, info.date_time)
+                    out_info.external_attr = info.external_attr
+                    out_info.compress_type = zipfile.ZIP_DEFLATED
+                    out_zip.writestr(out_info, patch)
+                    manifest.append("%s %s %s" % (sha1(data), sha1(old_data), info.filename))
+                    continue
+
+            print("Stored %s: %u bytes" % (info.filename, len(data)))
+            out_zip.writestr(info, data, zipfile.ZIP_DEFLATED)
+            manifest.append("%s - %s" % (sha1(data), info.filename))
+
+        for filename in sorted(old_files.keys() - new_filenames):
+            print("Removed %s" % filename)
+            manifest.append("- - %s" % filename)
+
+        out_zip.writestr(MANIFEST_FILENAME, "\n".join(manifest) + "\n")
+
+    print("Wrote %s with %u files" % (out_zip_path, len(manifest)))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Creates a delta update zip between two release zips.")
+    parser.add_argument("old_zip", help="Release zip which is currently installed")
+    parser.add_argument("new_zip", help="Release zip to update to")
+    parser.add_argument("output_zip", help="Delta zip to write, named <asset>-delta-<old version hash>.zip")
+    args = parser.parse_args()
+    make_delta_update(args.old_zip, args.new_zip, args.output_zip)
+    sys.exit(0)
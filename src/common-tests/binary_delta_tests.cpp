@@ -0,0 +1,215 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/binary_delta.h"
+#include "common/error.h"
+
+#include "fmt/format.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Writes patches in the format described in binary_delta.h.
+class PatchBuilder
+{
+public:
+  explicit PatchBuilder(u64 target_size)
+  {
+    Append("DSDELTA1", 8);
+    Append(&target_size, sizeof(target_size));
+  }
+
+  PatchBuilder& Copy(u64 offset, u32 length)
+  {
+    m_data.push_back(0x00);
+    Append(&offset, sizeof(offset));
+    Append(&length, sizeof(length));
+    return *this;
+  }
+
+  PatchBuilder& Add(std::string_view bytes) { return Add(static_cast<u32>(bytes.size()), bytes); }
+
+  // Length is separate so it can disagree with the data.
+  PatchBuilder& Add(u32 length, std::string_view bytes)
+  {
+    m_data.push_back(0x01);
+    Append(&length, sizeof(length));
+    Append(bytes.data(), bytes.size());
+    return *this;
+  }
+
+  PatchBuilder& Raw(std::string_view bytes)
+  {
+    Append(bytes.data(), bytes.size());
+    return *this;
+  }
+
+  std::vector<u8> Truncated(size_t remove) const
+  {
+    return std::vector<u8>(m_data.begin(), m_data.end() - static_cast<std::ptrdiff_t>(remove));
+  }
+
+  const std::vector<u8>& Get() const { return m_data; }
+
+private:
+  void Append(const void* data, size_t size)
+  {
+    const size_t pos = m_data.size();
+    m_data.resize(pos + size);
+    if (size > 0)
+      std::memcpy(m_data.data() + pos, data, size);
+  }
+
+  std::vector<u8> m_data;
+};
+
+} // namespace
+
+static std::vector<u8> Bytes(std::string_view str)
+{
+  return std::vector<u8>(str.begin(), str.end());
+}
+
+static std::string_view AsString(const std::vector<u8>& data)
+{
+  return std::string_view(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// Checks that the patch is rejected, with a reason.
+static void ExpectRejected(const std::vector<u8>& source, const std::vector<u8>& patch)
+{
+  std::vector<u8> out;
+  Error error;
+  EXPECT_FALSE(BinaryDelta::ApplyPatch(source, patch, &out, &error));
+  EXPECT_FALSE(error.GetDescription().empty());
+}
+
+TEST(BinaryDelta, ApplyPatchCopiesAndAdds)
+{
+  const std::vector<u8> source = Bytes("Hello, world!");
+  const PatchBuilder patch = std::move(PatchBuilder(17).Copy(0, 7).Add("there").Copy(7, 5));
+
+  std::vector<u8> out;
+  Error error;
+  ASSERT_TRUE(BinaryDelta::ApplyPatch(source, patch.Get(), &out, &error)) << error.GetDescription();
+  ASSERT_EQ(AsString(out), "Hello, thereworld");
+}
+
+TEST(BinaryDelta, ApplyPatchEmptyTarget)
+{
+  std::vector<u8> out = Bytes("stale");
+  Error error;
+  ASSERT_TRUE(BinaryDelta::ApplyPatch(Bytes("abc"), PatchBuilder(0).Get(), &out, &error));
+  ASSERT_TRUE(out.empty());
+}
+
+TEST(BinaryDelta, ApplyPatchRejectsBadHeader)
+{
+  const std::vector<u8> source = Bytes("abc");
+  ExpectRejected(source, {});
+  ExpectRejected(source, Bytes("DSDELTA1"));
+  ExpectRejected(source, PatchBuilder(3).Truncated(1));
+
+  std::vector<u8> bad_magic = PatchBuilder(3).Add("abc").Get();
+  bad_magic[7] = '2';
+  ExpectRejected(source, bad_magic);
+}
+
+TEST(BinaryDelta, ApplyPatchRejectsTruncatedRecords)
+{
+  const std::vector<u8> source = Bytes("abcdefgh");
+
+  // Missing commands entirely, and cut anywhere inside a COPY record.
+  ExpectRejected(source, PatchBuilder(4).Get());
+  const PatchBuilder copy = std::move(PatchBuilder(4).Copy(0, 4));
+  for (size_t remove = 1; remove < 13; remove++)
+    ExpectRejected(source, copy.Truncated(remove));
+
+  // Cut inside an ADD record's length or data, or with a length past the end of the patch.
+  const PatchBuilder add = std::move(PatchBuilder(4).Add("wxyz"));
+  for (size_t remove = 1; remove < 9; remove++)
+    ExpectRejected(source, add.Truncated(remove));
+  ExpectRejected(source, PatchBuilder(8).Add(8, "wxyz").Get());
+}
+
+TEST(BinaryDelta, ApplyPatchRejectsOutOfRangeCopy)
+{
+  const std::vector<u8> source = Bytes("abcdefgh");
+  ExpectRejected(source, PatchBuilder(4).Copy(9, 0).Copy(0, 4).Get());
+  ExpectRejected(source, PatchBuilder(4).Copy(6, 4).Get());
+  ExpectRejected(source, PatchBuilder(4).Copy(0xFFFFFFFFFFFFFFFCull, 4).Get());
+  ExpectRejected(source, PatchBuilder(4).Copy(4, 0xFFFFFFFFu).Get());
+
+  // Past the end of the target, even though the source has the bytes.
+  ExpectRejected(source, PatchBuilder(4).Copy(0, 8).Get());
+}
+
+TEST(BinaryDelta, ApplyPatchRejectsOutOfRangeAdd)
+{
+  const std::vector<u8> source = Bytes("abc");
+  ExpectRejected(source, PatchBuilder(2).Add("xyz").Get());
+  ExpectRejected(source, PatchBuilder(4).Add("xy").Add(0xFFFFFFFFu, "zz").Get());
+}
+
+TEST(BinaryDelta, ApplyPatchRejectsUnknownCommandAndTrailingData)
+{
+  const std::vector<u8> source = Bytes("abc");
+  ExpectRejected(source, PatchBuilder(3).Raw("\x02").Raw(std::string_view("\0\0\0\0", 4)).Get());
+  ExpectRejected(source, PatchBuilder(3).Copy(0, 3).Raw("x").Get());
+}
+
+TEST(BinaryDelta, ParseManifest)
+{
+  static constexpr const char* hash_a = "a9993e364706816aba3e25717850c26c9cd0d89d";
+  static constexpr const char* hash_b = "84983E441C3BD26EBAAE4AA1F95129E5E54670F1";
+  const std::string manifest = fmt::format("# comment\n"
+                                           "{} - duckstation-qt.exe\r\n"
+                                           "\n"
+                                           "{} {} resources/shaders/my shader.glsl\n"
+                                           "- - translations/removed.qm\n",
+                                           hash_a, hash_b, hash_a);
+
+  Error error;
+  const std::optional<std::vector<BinaryDelta::ManifestEntry>> entries = BinaryDelta::ParseManifest(manifest, &error);
+  ASSERT_TRUE(entries.has_value()) << error.GetDescription();
+  ASSERT_EQ(entries->size(), 3u);
+
+  EXPECT_EQ((*entries)[0].path, "duckstation-qt.exe");
+  EXPECT_EQ((*entries)[0].target_hash, hash_a);
+  EXPECT_TRUE((*entries)[0].source_hash.empty());
+  EXPECT_FALSE((*entries)[0].IsRemoved());
+
+  EXPECT_EQ((*entries)[1].path, "resources/shaders/my shader.glsl");
+  EXPECT_EQ((*entries)[1].target_hash, hash_b);
+  EXPECT_EQ((*entries)[1].source_hash, hash_a);
+
+  EXPECT_EQ((*entries)[2].path, "translations/removed.qm");
+  EXPECT_TRUE((*entries)[2].IsRemoved());
+  EXPECT_TRUE((*entries)[2].source_hash.empty());
+}
+
+TEST(BinaryDelta, ParseManifestRejectsMalformedLines)
+{
+  static constexpr const char* hash = "a9993e364706816aba3e25717850c26c9cd0d89d";
+  const std::string bad_lines[] = {
+    "justonefield",
+    fmt::format("{} -", hash),
+    fmt::format("{} - ", hash),
+    "a9993e36 - short_hash.exe",
+    fmt::format("{} a9993e36 short_source.exe", hash),
+    fmt::format("- {} removed_with_source.exe", hash),
+  };
+
+  for (const std::string& line : bad_lines)
+  {
+    Error error;
+    EXPECT_FALSE(BinaryDelta::ParseManifest(fmt::format("{} - good.exe\n{}\n", hash, line), &error).has_value())
+      << line;
+    EXPECT_NE(error.GetDescription().find("line 2"), std::string::npos) << error.GetDescription();
+  }
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/fifo_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST(SPSCFIFOQueue, PushPopInOrder)
+{
+  SPSCFIFOQueue<u32, 4> queue;
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_TRUE(queue.Push(1));
+  ASSERT_TRUE(queue.Push(2));
+  ASSERT_EQ(queue.GetSize(), 2u);
+  ASSERT_EQ(*queue.Peek(), 1u);
+
+  u32 value;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 1u);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 2u);
+  ASSERT_FALSE(queue.Pop(&value));
+  ASSERT_EQ(queue.Peek(), nullptr);
+}
+
+TEST(SPSCFIFOQueue, PushFailsWhenFull)
+{
+  SPSCFIFOQueue<u32, 4> queue;
+  for (u32 i = 0; i < 4; i++)
+    ASSERT_TRUE(queue.Push(i));
+
+  ASSERT_TRUE(queue.IsFull());
+  ASSERT_FALSE(queue.Push(4));
+  ASSERT_TRUE(queue.RemoveOne());
+  ASSERT_TRUE(queue.Push(4));
+  ASSERT_EQ(*queue.Peek(), 1u);
+}
+
+TEST(SPSCFIFOQueue, RangesWrapAround)
+{
+  SPSCFIFOQueue<u32, 8> queue;
+  const std::array<u32, 6> first = {0, 1, 2, 3, 4, 5};
+  ASSERT_EQ(queue.PushRange(first), 6u);
+  ASSERT_EQ(queue.Remove(5), 5u);
+
+  // Only seven slots are free, and the write crosses the end of the buffer.
+  const std::array<u32, 10> second = {6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+  ASSERT_EQ(queue.PushRange(second), 7u);
+
+  std::array<u32, 10> out = {};
+  ASSERT_EQ(queue.PopRange(out), 8u);
+  for (u32 i = 0; i < 8; i++)
+    ASSERT_EQ(out[i], i + 5);
+  ASSERT_TRUE(queue.IsEmpty());
+}
+
+TEST(SPSCFIFOQueue, MovesNonTrivialTypes)
+{
+  SPSCFIFOQueue<std::string, 2> queue;
+  ASSERT_TRUE(queue.Emplace(40, 'x'));
+  ASSERT_TRUE(queue.Push(std::string("hello")));
+
+  std::string value;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, std::string(40, 'x'));
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, "hello");
+}
+
+TEST(SPSCFIFOQueue, Clear)
+{
+  SPSCFIFOQueue<u32, 4> queue;
+  queue.Push(1);
+  queue.Push(2);
+  queue.Clear();
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_TRUE(queue.Push(3));
+  ASSERT_EQ(*queue.Peek(), 3u);
+}
+
+TEST(SPSCFIFOQueue, TwoThreadsPreserveOrder)
+{
+  static constexpr u32 COUNT = 200000;
+  auto queue = std::make_unique<SPSCFIFOQueue<u32, 256>>();
+
+  std::thread producer([&queue]() {
+    u32 next = 0;
+    std::array<u32, 16> batch;
+    while (next < COUNT)
+    {
+      // Mix single and bulk pushes, so both paths race against the consumer.
+      u32 pushed;
+      if (next & 1)
+      {
+        pushed = queue->Push(next) ? 1 : 0;
+      }
+      else
+      {
+        const u32 batch_size = std::min<u32>(static_cast<u32>(batch.size()), COUNT - next);
+        for (u32 i = 0; i < batch_size; i++)
+          batch[i] = next + i;
+        pushed = queue->PushRange(std::span<const u32>(batch.data(), batch_size));
+      }
+
+      next += pushed;
+      if (pushed == 0)
+        std::this_thread::yield();
+    }
+  });
+
+  u32 expected = 0;
+  bool in_order = true;
+  std::array<u32, 32> out;
+  while (expected < COUNT)
+  {
+    const u32 count = queue->PopRange(out);
+    for (u32 i = 0; i < count; i++)
+      in_order &= (out[i] == expected++);
+    if (count == 0)
+      std::this_thread::yield();
+  }
+
+  producer.join();
+  ASSERT_TRUE(in_order);
+  ASSERT_TRUE(queue->IsEmpty());
+}
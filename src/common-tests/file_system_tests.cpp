@@ -1,9 +1,17 @@
 // SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
+#include "common/async_file.h"
 #include "common/file_system.h"
+
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
 #ifdef _WIN32
 
 TEST(FileSystem, GetWin32Path)
@@ -26,3 +34,46 @@ TEST(FileSystem, GetWin32Path)
 }
 
 #endif
+
+TEST(AsyncFile, WriteThenRead)
+{
+  const std::string path = (std::filesystem::temp_directory_path() / "duckstation_async_file_test.bin").string();
+  std::unique_ptr<FileSystem::AsyncFile> file =
+    FileSystem::AsyncFile::Open(path.c_str(), FileSystem::AsyncFile::OpenMode::Create);
+  ASSERT_NE(file, nullptr);
+
+  // Lots of small requests in flight at once, completing in any order.
+  static constexpr u32 NUM_BLOCKS = 64;
+  static constexpr u32 BLOCK_SIZE = 4096;
+  std::vector<u8> data(NUM_BLOCKS * BLOCK_SIZE);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 7);
+
+  std::atomic<u32> blocks_written{0};
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    file->Write(i * BLOCK_SIZE, &data[i * BLOCK_SIZE], BLOCK_SIZE, [&blocks_written](s64 result) {
+      if (result == BLOCK_SIZE)
+        blocks_written.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  file->WaitForCompletion();
+  ASSERT_EQ(blocks_written.load(), NUM_BLOCKS);
+  ASSERT_EQ(file->GetSize(), static_cast<s64>(data.size()));
+
+  std::vector<u8> read_back(data.size());
+  std::vector<std::future<s64>> reads;
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+    reads.push_back(file->Read(i * BLOCK_SIZE, &read_back[i * BLOCK_SIZE], BLOCK_SIZE));
+  for (std::future<s64>& read : reads)
+    ASSERT_EQ(read.get(), BLOCK_SIZE);
+  ASSERT_EQ(read_back, data);
+
+  // Reads past the end are short rather than failing.
+  u8 tail[BLOCK_SIZE];
+  ASSERT_EQ(file->Read(data.size() - 100, tail, BLOCK_SIZE).get(), 100);
+  ASSERT_EQ(file->Read(data.size(), tail, BLOCK_SIZE).get(), 0);
+
+  file.reset();
+  FileSystem::DeleteFile(path.c_str());
+}
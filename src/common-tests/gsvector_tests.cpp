@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/gsvector.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+
+// Each operation is checked against its scalar definition, lane by lane, on random inputs.
+
+static constexpr u32 NUM_ITERATIONS = 1000;
+
+template<typename T>
+using Lanes = std::array<T, 16 / sizeof(T)>;
+
+template<typename T>
+static Lanes<T> ToLanes(const GSVector4i& v)
+{
+  Lanes<T> ret;
+  GSVector4i::store<false>(ret.data(), v);
+  return ret;
+}
+
+template<typename T>
+static GSVector4i FromLanes(const Lanes<T>& lanes)
+{
+  return GSVector4i::load<false>(lanes.data());
+}
+
+static Lanes<float> ToFloatLanes(const GSVector4& v)
+{
+  Lanes<float> ret;
+  GSVector4::store<false>(ret.data(), v);
+  return ret;
+}
+
+template<typename T>
+static Lanes<T> RandomLanes(std::mt19937& rng)
+{
+  Lanes<T> ret;
+  for (T& lane : ret)
+    lane = static_cast<T>(rng());
+  return ret;
+}
+
+/// Applies a vector operation and a scalar operation to random inputs, and compares the results.
+template<typename T, typename R = T, typename VectorOp, typename ScalarOp>
+static void CompareBinary(VectorOp vop, ScalarOp sop)
+{
+  std::mt19937 rng(0x12345678u);
+  for (u32 iter = 0; iter < NUM_ITERATIONS; iter++)
+  {
+    const Lanes<T> a = RandomLanes<T>(rng);
+    const Lanes<T> b = RandomLanes<T>(rng);
+    const Lanes<R> result = ToLanes<R>(vop(FromLanes(a), FromLanes(b)));
+    for (u32 i = 0; i < result.size(); i++)
+      ASSERT_EQ(result[i], sop(a, b, i)) << "lane " << i << " iteration " << iter;
+  }
+}
+
+template<typename T, typename VectorOp, typename ScalarOp>
+static void CompareUnary(VectorOp vop, ScalarOp sop)
+{
+  CompareBinary<T>([&vop](const GSVector4i& a, const GSVector4i&) { return vop(a); },
+                   [&sop](const Lanes<T>& a, const Lanes<T>&, u32 i) { return sop(a[i]); });
+}
+
+TEST(GSVector, Bitwise)
+{
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a & b; },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] & b[i]; });
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a | b; },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] | b[i]; });
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a ^ b; },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] ^ b[i]; });
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a.andnot(b); },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] & ~b[i]; });
+}
+
+TEST(GSVector, Blend)
+{
+  // Use a mask built from a comparison, like the callers do.
+  CompareBinary<u16>(
+    [](const GSVector4i& a, const GSVector4i& b) {
+      return a.blend(b, (a & GSVector4i::broadcast16(1)).eq16(GSVector4i::zero()));
+    },
+    [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) { return static_cast<u16>((a[i] & 1) ? a[i] : b[i]); });
+}
+
+TEST(GSVector, Arithmetic16)
+{
+  CompareBinary<u16>([](const GSVector4i& a, const GSVector4i& b) { return a.add16(b); },
+                     [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) { return static_cast<u16>(a[i] + b[i]); });
+  CompareBinary<u16>([](const GSVector4i& a, const GSVector4i& b) { return a.sub16(b); },
+                     [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) { return static_cast<u16>(a[i] - b[i]); });
+  CompareBinary<u16>([](const GSVector4i& a, const GSVector4i& b) { return a.mul16l(b); },
+                     [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) {
+                       return static_cast<u16>(static_cast<u32>(a[i]) * static_cast<u32>(b[i]));
+                     });
+  CompareBinary<s16>([](const GSVector4i& a, const GSVector4i& b) { return a.mul16hs(b); },
+                     [](const Lanes<s16>& a, const Lanes<s16>& b, u32 i) {
+                       return static_cast<s16>((static_cast<s32>(a[i]) * static_cast<s32>(b[i])) >> 16);
+                     });
+  CompareBinary<s16>([](const GSVector4i& a, const GSVector4i& b) { return a.min_i16(b); },
+                     [](const Lanes<s16>& a, const Lanes<s16>& b, u32 i) { return std::min(a[i], b[i]); });
+  CompareBinary<s16>([](const GSVector4i& a, const GSVector4i& b) { return a.max_i16(b); },
+                     [](const Lanes<s16>& a, const Lanes<s16>& b, u32 i) { return std::max(a[i], b[i]); });
+
+  // Random values are rarely equal, so compare against a copy with some lanes changed.
+  CompareBinary<u16>(
+    [](const GSVector4i& a, const GSVector4i& b) { return a.eq16(a | (b & GSVector4i::broadcast16(1))); },
+    [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) {
+      return static_cast<u16>((a[i] == (a[i] | (b[i] & 1))) ? 0xFFFFu : 0u);
+    });
+}
+
+TEST(GSVector, Shift16)
+{
+  CompareUnary<u16>([](const GSVector4i& a) { return a.sll16<5>(); },
+                    [](u16 a) { return static_cast<u16>(a << 5); });
+  CompareUnary<u16>([](const GSVector4i& a) { return a.srl16<10>(); }, [](u16 a) { return static_cast<u16>(a >> 10); });
+  CompareUnary<s16>([](const GSVector4i& a) { return a.sra16<3>(); }, [](s16 a) { return static_cast<s16>(a >> 3); });
+  CompareUnary<s16>([](const GSVector4i& a) { return a.sra16<15>(); },
+                    [](s16 a) { return static_cast<s16>(a >> 15); });
+}
+
+TEST(GSVector, Unpack)
+{
+  CompareBinary<u16>([](const GSVector4i& a, const GSVector4i& b) { return a.upl16(b); },
+                     [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) { return (i & 1) ? b[i / 2] : a[i / 2]; });
+  CompareBinary<u16>(
+    [](const GSVector4i& a, const GSVector4i& b) { return a.uph16(b); },
+    [](const Lanes<u16>& a, const Lanes<u16>& b, u32 i) { return (i & 1) ? b[4 + i / 2] : a[4 + i / 2]; });
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a.upl32(b); },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return (i & 1) ? b[i / 2] : a[i / 2]; });
+  CompareBinary<u32>(
+    [](const GSVector4i& a, const GSVector4i& b) { return a.uph32(b); },
+    [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return (i & 1) ? b[2 + i / 2] : a[2 + i / 2]; });
+  CompareBinary<u64>([](const GSVector4i& a, const GSVector4i& b) { return a.upl64(b); },
+                     [](const Lanes<u64>& a, const Lanes<u64>& b, u32 i) { return (i & 1) ? b[0] : a[0]; });
+  CompareBinary<u64>([](const GSVector4i& a, const GSVector4i& b) { return a.uph64(b); },
+                     [](const Lanes<u64>& a, const Lanes<u64>& b, u32 i) { return (i & 1) ? b[1] : a[1]; });
+}
+
+TEST(GSVector, MultiplyAdd)
+{
+  CompareBinary<s16, s32>([](const GSVector4i& a, const GSVector4i& b) { return a.madd_s16(b); },
+                          [](const Lanes<s16>& a, const Lanes<s16>& b, u32 i) {
+                            // Wraps if both pairs are -32768 * -32768, the same as pmaddwd.
+                            return static_cast<s32>(static_cast<u32>(s32(a[i * 2]) * s32(b[i * 2])) +
+                                                    static_cast<u32>(s32(a[i * 2 + 1]) * s32(b[i * 2 + 1])));
+                          });
+}
+
+TEST(GSVector, Arithmetic32)
+{
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a.add32(b); },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] + b[i]; });
+  CompareBinary<u32>([](const GSVector4i& a, const GSVector4i& b) { return a.sub32(b); },
+                     [](const Lanes<u32>& a, const Lanes<u32>& b, u32 i) { return a[i] - b[i]; });
+}
+
+TEST(GSVector, Shift32)
+{
+  CompareUnary<u32>([](const GSVector4i& a) { return a.sll32<8>(); }, [](u32 a) { return a << 8; });
+  CompareUnary<u32>([](const GSVector4i& a) { return a.srl32<24>(); }, [](u32 a) { return a >> 24; });
+  CompareUnary<s32>([](const GSVector4i& a) { return a.sra32<13>(); }, [](s32 a) { return a >> 13; });
+  CompareUnary<s32>([](const GSVector4i& a) { return a.sra32<31>(); }, [](s32 a) { return a >> 31; });
+  CompareUnary<u64>([](const GSVector4i& a) { return a.srl64<32>(); }, [](u64 a) { return a >> 32; });
+
+  for (s32 shift = 0; shift < 32; shift++)
+  {
+    CompareUnary<u32>([shift](const GSVector4i& a) { return a.sll32(shift); }, [shift](u32 a) { return a << shift; });
+    CompareUnary<s32>([shift](const GSVector4i& a) { return a.sra32(shift); }, [shift](s32 a) { return a >> shift; });
+  }
+}
+
+TEST(GSVector, Pack)
+{
+  // Narrow the inputs, so both in-range and saturated values are covered.
+  CompareBinary<s32, s16>([](const GSVector4i& a, const GSVector4i& b) { return a.sra32<14>().ps32(b.sra32<14>()); },
+                          [](const Lanes<s32>& a, const Lanes<s32>& b, u32 i) {
+                            const s32 value = (i < 4) ? (a[i] >> 14) : (b[i - 4] >> 14);
+                            return static_cast<s16>(std::clamp<s32>(value, -32768, 32767));
+                          });
+}
+
+TEST(GSVector, HorizontalAdd)
+{
+  std::mt19937 rng(0x12345678u);
+  for (u32 iter = 0; iter < NUM_ITERATIONS; iter++)
+  {
+    const Lanes<u32> a = RandomLanes<u32>(rng);
+    ASSERT_EQ(static_cast<u32>(FromLanes(a).addv_s32()), a[0] + a[1] + a[2] + a[3]);
+  }
+}
+
+#if defined(CPU_ARCH_SSSE3) || defined(CPU_ARCH_NEON)
+TEST(GSVector, Shuffle8)
+{
+  CompareBinary<u8>(
+    [](const GSVector4i& a, const GSVector4i& b) {
+      // Keep the sign bit, so some lanes are zeroed.
+      return a.shuffle8(b & GSVector4i::broadcast16(0x8F8Fu));
+    },
+    [](const Lanes<u8>& a, const Lanes<u8>& b, u32 i) {
+      const u8 index = b[i] & 0x8F;
+      return static_cast<u8>((index & 0x80) ? 0 : a[index]);
+    });
+}
+#endif
+
+TEST(GSVector, LoadStore)
+{
+  alignas(16) static constexpr u8 data[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  const Lanes<u8> low = ToLanes<u8>(GSVector4i::loadl(data));
+  for (u32 i = 0; i < 16; i++)
+    ASSERT_EQ(low[i], (i < 8) ? data[i] : 0);
+
+  const Lanes<u32> first = ToLanes<u32>(GSVector4i::load32(0xDEADBEEFu));
+  ASSERT_EQ(first[0], 0xDEADBEEFu);
+  ASSERT_EQ(first[1] | first[2] | first[3], 0u);
+
+  u8 out[16];
+  std::memset(out, 0xCC, sizeof(out));
+  GSVector4i::storel(out, GSVector4i::load<true>(data));
+  for (u32 i = 0; i < 16; i++)
+    ASSERT_EQ(out[i], (i < 8) ? data[i] : 0xCC);
+
+  const GSVector4i v(static_cast<s16>(-1), 2, 3, 4, 5, 6, 7, static_cast<s16>(0x8000));
+  ASSERT_EQ(v.extract16<0>(), 0xFFFFu);
+  ASSERT_EQ(v.extract16<4>(), 5u);
+  ASSERT_EQ(v.extract16<7>(), 0x8000u);
+  ASSERT_EQ(GSVector4i(1, -2, 3, 4).extract32<1>(), -2);
+  ASSERT_EQ(GSVector4i(1, -2, 3, 4).extract32<3>(), 4);
+}
+
+TEST(GSVector, Float)
+{
+  std::mt19937 rng(0x12345678u);
+  for (u32 iter = 0; iter < NUM_ITERATIONS; iter++)
+  {
+    // Keep the values small enough to convert back to integers.
+    const Lanes<s32> ia = ToLanes<s32>(FromLanes(RandomLanes<s32>(rng)).sra32<8>());
+    const Lanes<s32> ib = ToLanes<s32>(FromLanes(RandomLanes<s32>(rng)).sra32<20>());
+    const GSVector4 a = GSVector4::from_i32(FromLanes(ia));
+    const GSVector4 b = GSVector4::from_i32(FromLanes(ib));
+    const GSVector4 scale = GSVector4::broadcast(-0.7143f);
+
+    const Lanes<float> fa = ToFloatLanes(a);
+    const Lanes<float> sum = ToFloatLanes(a + b);
+    const Lanes<float> diff = ToFloatLanes(a - b);
+    const Lanes<s32> scaled = ToLanes<s32>((b * scale).to_i32_trunc());
+    for (u32 i = 0; i < 4; i++)
+    {
+      ASSERT_EQ(fa[i], static_cast<float>(ia[i]));
+      ASSERT_EQ(sum[i], static_cast<float>(ia[i]) + static_cast<float>(ib[i]));
+      ASSERT_EQ(diff[i], static_cast<float>(ia[i]) - static_cast<float>(ib[i]));
+      ASSERT_EQ(scaled[i], static_cast<s32>(static_cast<float>(ib[i]) * -0.7143f));
+    }
+
+    const Lanes<float> fb = ToFloatLanes(b);
+    const Lanes<float> upl = ToFloatLanes(a.upl(b));
+    const Lanes<float> uph = ToFloatLanes(a.uph(b));
+    const Lanes<float> upld = ToFloatLanes(a.upld(b));
+    const Lanes<float> uphd = ToFloatLanes(a.uphd(b));
+    ASSERT_EQ(upl, (Lanes<float>{fa[0], fb[0], fa[1], fb[1]}));
+    ASSERT_EQ(uph, (Lanes<float>{fa[2], fb[2], fa[3], fb[3]}));
+    ASSERT_EQ(upld, (Lanes<float>{fa[0], fa[1], fb[0], fb[1]}));
+    ASSERT_EQ(uphd, (Lanes<float>{fa[2], fa[3], fb[2], fb[3]}));
+  }
+}
+
+#endif
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST(LRUCache, EvictsLeastRecentlyUsed)
+{
+  LRUCache<int, int> cache(2);
+  cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  ASSERT_NE(cache.Lookup(1), nullptr);
+
+  cache.Insert(3, 30);
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(cache.Lookup(2), nullptr);
+  ASSERT_EQ(*cache.Lookup(1), 10);
+  ASSERT_EQ(*cache.Lookup(3), 30);
+}
+
+TEST(LRUCache, ReplacingKeepsSize)
+{
+  LRUCache<int, int> cache(2);
+  cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(1, 11);
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(*cache.Lookup(1), 11);
+  ASSERT_EQ(*cache.Lookup(2), 20);
+}
+
+TEST(LRUCache, HeterogeneousStringLookup)
+{
+  LRUCache<std::string, int> cache(4);
+  cache.Insert("hello", 1);
+  ASSERT_EQ(*cache.Lookup(std::string_view("hello")), 1);
+  ASSERT_TRUE(cache.Remove(std::string_view("hello")));
+  ASSERT_EQ(cache.GetSize(), 0u);
+}
+
+TEST(LRUCache, WeightedCapacity)
+{
+  std::vector<int> evicted;
+  LRUCache<int, int> cache(100);
+  cache.SetEvictionCallback([&evicted](const int& key, int& value) { evicted.push_back(key); });
+
+  cache.Insert(1, 0, 40);
+  cache.Insert(2, 0, 40);
+  ASSERT_EQ(cache.GetWeight(), 80u);
+
+  // Needs both older items gone to fit.
+  cache.Insert(3, 0, 90);
+  ASSERT_EQ(cache.GetSize(), 1u);
+  ASSERT_EQ(cache.GetWeight(), 90u);
+  ASSERT_EQ(evicted, (std::vector<int>{1, 2}));
+
+  // Items larger than the whole cache are still kept until something else is inserted.
+  cache.Insert(4, 0, 150);
+  ASSERT_NE(cache.Lookup(4), nullptr);
+  ASSERT_EQ(cache.GetWeight(), 150u);
+}
+
+TEST(LRUCache, ManualEvictDefersEviction)
+{
+  LRUCache<int, int> cache(2, true);
+  int* first = cache.Insert(1, 10);
+  cache.Insert(2, 20);
+  cache.Insert(3, 30);
+  ASSERT_EQ(cache.GetSize(), 3u);
+  ASSERT_EQ(*first, 10);
+
+  cache.ManualEvict();
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(cache.Lookup(1), nullptr);
+}
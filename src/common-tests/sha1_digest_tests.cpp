@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/sha1_digest.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Runs each test once with the SHA instructions, if the CPU has them, and once with the portable implementation.
+class SHA1DigestTest : public ::testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    SHA1Digest::SetHardwareAccelerationEnabled(GetParam());
+    if (GetParam() && !SHA1Digest::IsUsingHardwareAcceleration())
+      GTEST_SKIP() << "CPU does not support SHA instructions";
+  }
+
+  void TearDown() override { SHA1Digest::SetHardwareAccelerationEnabled(true); }
+};
+
+} // namespace
+
+// Feeds the data in chunk_size pieces, so the buffered and multi-block paths in Update() are both exercised.
+static std::string Hash(std::string_view data, size_t chunk_size = 0)
+{
+  if (chunk_size == 0)
+    chunk_size = std::max<size_t>(data.size(), 1);
+
+  SHA1Digest digest;
+  for (size_t pos = 0; pos < data.size(); pos += chunk_size)
+  {
+    const size_t len = std::min(chunk_size, data.size() - pos);
+    digest.Update(data.data() + pos, static_cast<u32>(len));
+  }
+
+  u8 result[SHA1Digest::DIGEST_SIZE];
+  digest.Final(result);
+  return SHA1Digest::DigestToString(result);
+}
+
+// Known answers from FIPS 180 and its example documents.
+TEST_P(SHA1DigestTest, KnownAnswers)
+{
+  ASSERT_EQ(Hash(""), "DA39A3EE5E6B4B0D3255BFEF95601890AFD80709");
+  ASSERT_EQ(Hash("abc"), "A9993E364706816ABA3E25717850C26C9CD0D89D");
+  ASSERT_EQ(Hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+            "84983E441C3BD26EBAAE4AA1F95129E5E54670F1");
+  ASSERT_EQ(Hash("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrs"
+                 "tnopqrstu"),
+            "A49B2446A02C645BF419F995B67091253A04A259");
+}
+
+TEST_P(SHA1DigestTest, MillionA)
+{
+  const std::string data(1000000, 'a');
+  static constexpr const char* expected = "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F";
+  for (const size_t chunk_size : {size_t(0), size_t(1), size_t(63), size_t(64), size_t(1000), size_t(19584)})
+    ASSERT_EQ(Hash(data, chunk_size), expected) << "chunk size " << chunk_size;
+}
+
+TEST_P(SHA1DigestTest, ResetStartsOver)
+{
+  SHA1Digest digest;
+  digest.Update("garbage", 7);
+  digest.Reset();
+  digest.Update("abc", 3);
+
+  u8 result[SHA1Digest::DIGEST_SIZE];
+  digest.Final(result);
+  ASSERT_EQ(SHA1Digest::DigestToString(result), "A9993E364706816ABA3E25717850C26C9CD0D89D");
+}
+
+INSTANTIATE_TEST_SUITE_P(SHA1Digest, SHA1DigestTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Hardware" : "Scalar";
+                         });
+
+TEST(SHA1Digest, HardwareMatchesScalar)
+{
+  std::mt19937 rng(0x12345678);
+  std::vector<u8> data(4096);
+  for (u8& value : data)
+    value = static_cast<u8>(rng());
+
+  // Every length up to a few blocks, to cover each padding case.
+  for (u32 len = 0; len <= 300; len++)
+  {
+    const std::string_view view(reinterpret_cast<const char*>(data.data()), len);
+    SHA1Digest::SetHardwareAccelerationEnabled(false);
+    const std::string scalar = Hash(view);
+    SHA1Digest::SetHardwareAccelerationEnabled(true);
+    ASSERT_EQ(Hash(view), scalar) << "length " << len;
+  }
+}
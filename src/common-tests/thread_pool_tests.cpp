@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/thread_pool.h"
+#include "common/timer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Threading::ThreadPool;
+
+// Spins until pred returns true, giving up after a few seconds so a broken pool fails instead of hanging.
+template<typename Pred>
+static bool WaitFor(const Pred& pred)
+{
+  Common::Timer timer;
+  while (!pred())
+  {
+    if (timer.GetTimeSeconds() > 10.0)
+      return false;
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+TEST(ThreadPool, SubmitReturnsResult)
+{
+  ThreadPool pool(2);
+  ASSERT_EQ(pool.GetWorkerCount(), 2u);
+  ASSERT_FALSE(pool.IsWorkerThread());
+
+  std::future<int> value = pool.Submit([]() { return 42; });
+  std::future<bool> on_worker = pool.Submit([&pool]() { return pool.IsWorkerThread(); });
+  ASSERT_EQ(value.get(), 42);
+  ASSERT_TRUE(on_worker.get());
+}
+
+TEST(ThreadPool, WaitsForEveryTask)
+{
+  static constexpr u32 COUNT = 1000;
+  std::atomic<u32> counter{0};
+
+  {
+    ThreadPool pool(4);
+    std::vector<std::future<void>> futures;
+    for (u32 i = 0; i < COUNT; i++)
+    {
+      futures.push_back(pool.Submit([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); },
+                                    static_cast<ThreadPool::Priority>(i % 3)));
+    }
+    for (std::future<void>& future : futures)
+      future.get();
+    ASSERT_EQ(counter.load(), COUNT);
+
+    // Anything still queued at shutdown is run before the destructor returns.
+    for (u32 i = 0; i < COUNT; i++)
+      pool.Enqueue([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+  }
+
+  ASSERT_EQ(counter.load(), COUNT * 2);
+}
+
+TEST(ThreadPool, ParallelForCoversRangeOnce)
+{
+  static constexpr u32 COUNT = 10007;
+  ThreadPool pool(3);
+  std::unique_ptr<std::atomic<u32>[]> hits = std::make_unique<std::atomic<u32>[]>(COUNT);
+  pool.ParallelFor(
+    COUNT,
+    [&hits](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++)
+        hits[i].fetch_add(1, std::memory_order_relaxed);
+    },
+    7);
+
+  for (u32 i = 0; i < COUNT; i++)
+    ASSERT_EQ(hits[i].load(), 1u) << "index " << i;
+}
+
+TEST(ThreadPool, NestedParallelForCompletes)
+{
+  ThreadPool pool(2);
+  std::atomic<u32> total{0};
+  std::future<void> outer = pool.Submit([&pool, &total]() {
+    pool.ParallelFor(64, [&total](u32 start, u32 end) { total.fetch_add(end - start, std::memory_order_relaxed); });
+  });
+
+  ASSERT_TRUE(WaitFor([&outer]() { return outer.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }));
+  ASSERT_EQ(total.load(), 64u);
+}
+
+TEST(ThreadPool, IdleWorkerStealsQueuedTask)
+{
+  ThreadPool pool(2);
+
+  // The inner task goes on the outer task's own queue, which is busy until it runs, so only the other worker can
+  // pick it up.
+  std::future<bool> stolen = pool.Submit([&pool]() {
+    const std::thread::id owner = std::this_thread::get_id();
+    std::atomic<bool> done{false};
+    std::thread::id runner;
+    pool.Enqueue([&done, &runner]() {
+      runner = std::this_thread::get_id();
+      done.store(true, std::memory_order_release);
+    });
+
+    return (WaitFor([&done]() { return done.load(std::memory_order_acquire); }) && runner != owner);
+  });
+
+  ASSERT_TRUE(stolen.get());
+}
+
+TEST(ThreadPool, CallerRunsPendingTask)
+{
+  ThreadPool pool(1);
+
+  // Keep the only worker busy, so the queued task can only run on this thread.
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  pool.Enqueue([&started, &release]() {
+    started.store(true, std::memory_order_release);
+    while (!release.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  });
+  ASSERT_TRUE(WaitFor([&started]() { return started.load(std::memory_order_acquire); }));
+
+  std::thread::id runner;
+  pool.Enqueue([&runner]() { runner = std::this_thread::get_id(); });
+  const bool ran = pool.TryRunPendingTask();
+  const bool ran_again = pool.TryRunPendingTask();
+  release.store(true, std::memory_order_release);
+
+  ASSERT_TRUE(ran);
+  ASSERT_FALSE(ran_again);
+  ASSERT_EQ(runner, std::this_thread::get_id());
+}
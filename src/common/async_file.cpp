@@ -0,0 +1,554 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "async_file.h"
+#include "assert.h"
+#include "error.h"
+#include "file_system.h"
+#include "log.h"
+#include "thread_pool.h"
+#include "threading.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include "windows_headers.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+Log_SetChannel(AsyncFile);
+
+struct FileSystem::AsyncFile::Request
+{
+#ifdef _WIN32
+  // Must be first, completions only give us the OVERLAPPED pointer back.
+  OVERLAPPED overlapped;
+#elif defined(__linux__)
+  iovec iov;
+#endif
+
+  AsyncFile* file;
+  Callback callback;
+};
+
+#if defined(_WIN32)
+
+// Every file is associated with a single completion port, serviced by one thread.
+class FileSystem::AsyncFile::IOContext
+{
+public:
+  ~IOContext();
+
+  static IOContext* Get();
+
+  bool Associate(HANDLE handle);
+
+private:
+  bool Initialize();
+  void CompletionThreadEntryPoint();
+
+  HANDLE m_port = nullptr;
+  Threading::Thread m_thread;
+};
+
+FileSystem::AsyncFile::IOContext* FileSystem::AsyncFile::IOContext::Get()
+{
+  static std::unique_ptr<IOContext> s_context = []() {
+    std::unique_ptr<IOContext> context = std::make_unique<IOContext>();
+    if (!context->Initialize())
+      context.reset();
+    return context;
+  }();
+
+  return s_context.get();
+}
+
+FileSystem::AsyncFile::IOContext::~IOContext()
+{
+  if (m_thread.Joinable())
+  {
+    // A null OVERLAPPED tells the thread to exit.
+    PostQueuedCompletionStatus(m_port, 0, 0, nullptr);
+    m_thread.Join();
+  }
+
+  if (m_port)
+    CloseHandle(m_port);
+}
+
+bool FileSystem::AsyncFile::IOContext::Initialize()
+{
+  m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+  if (!m_port)
+  {
+    Log_ErrorFmt("CreateIoCompletionPort() failed: {}", GetLastError());
+    return false;
+  }
+
+  return m_thread.Start([this]() { CompletionThreadEntryPoint(); });
+}
+
+bool FileSystem::AsyncFile::IOContext::Associate(HANDLE handle)
+{
+  return (CreateIoCompletionPort(handle, m_port, 0, 0) != nullptr);
+}
+
+void FileSystem::AsyncFile::IOContext::CompletionThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Async I/O");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Background);
+
+  for (;;)
+  {
+    DWORD bytes_transferred;
+    ULONG_PTR key;
+    OVERLAPPED* overlapped;
+    const BOOL result = GetQueuedCompletionStatus(m_port, &bytes_transferred, &key, &overlapped, INFINITE);
+    if (!overlapped)
+    {
+      if (result)
+        break;
+
+      continue;
+    }
+
+    Request* request = CONTAINING_RECORD(overlapped, Request, overlapped);
+    request->file->CompleteRequest(
+      request, result ? static_cast<s64>(bytes_transferred) : ((GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1));
+  }
+}
+
+FileSystem::AsyncFile::AsyncFile(void* handle) : m_handle(handle)
+{
+}
+
+FileSystem::AsyncFile::~AsyncFile()
+{
+  WaitForCompletion();
+  CloseHandle(m_handle);
+}
+
+std::unique_ptr<FileSystem::AsyncFile> FileSystem::AsyncFile::Open(const char* path, OpenMode mode,
+                                                                    Error* error /* = nullptr */)
+{
+  IOContext* context = IOContext::Get();
+  if (!context)
+  {
+    Error::SetStringView(error, "Failed to create I/O completion port.");
+    return {};
+  }
+
+  const std::wstring wpath = GetWin32Path(path);
+  const DWORD access = (mode == OpenMode::Read) ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE);
+  const DWORD disposition = (mode == OpenMode::Create) ? CREATE_ALWAYS : OPEN_EXISTING;
+  const HANDLE handle = CreateFileW(wpath.c_str(), access, FILE_SHARE_READ, nullptr, disposition,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    Error::SetWin32(error, "CreateFileW() failed: ", GetLastError());
+    return {};
+  }
+
+  if (!context->Associate(handle))
+  {
+    Error::SetWin32(error, "CreateIoCompletionPort() failed: ", GetLastError());
+    CloseHandle(handle);
+    return {};
+  }
+
+  return std::unique_ptr<AsyncFile>(new AsyncFile(handle));
+}
+
+s64 FileSystem::AsyncFile::GetSize() const
+{
+  LARGE_INTEGER size;
+  return GetFileSizeEx(m_handle, &size) ? static_cast<s64>(size.QuadPart) : -1;
+}
+
+void FileSystem::AsyncFile::Submit(bool write, u64 offset, void* buffer, u32 size, Callback callback)
+{
+  {
+    std::unique_lock lock(m_pending_mutex);
+    m_pending_requests++;
+  }
+
+  Request* request = new Request{};
+  request->overlapped.Offset = static_cast<DWORD>(offset);
+  request->overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  request->file = this;
+  request->callback = std::move(callback);
+
+  // Requests which complete straight away still post a completion, so only errors need handling here.
+  const BOOL result = write ? WriteFile(m_handle, buffer, size, nullptr, &request->overlapped) :
+                              ReadFile(m_handle, buffer, size, nullptr, &request->overlapped);
+  if (!result)
+  {
+    const DWORD err = GetLastError();
+    if (err != ERROR_IO_PENDING)
+      CompleteRequest(request, (err == ERROR_HANDLE_EOF) ? 0 : -1);
+  }
+}
+
+#else
+
+#ifdef __linux__
+
+// A single io_uring instance is shared by every file, with one thread reaping completions. Submission is done by
+// whichever thread queues the request. If the kernel doesn't support io_uring, or it's blocked (e.g. by a container's
+// seccomp filter), requests fall back to blocking calls on the thread pool.
+class FileSystem::AsyncFile::IOContext
+{
+public:
+  ~IOContext();
+
+  static IOContext* Get();
+
+  bool Submit(int fd, bool write, u64 offset, Request* request);
+
+private:
+  static constexpr u32 RING_ENTRIES = 128;
+
+  bool Initialize();
+  bool SubmitEntry(u8 opcode, int fd, u64 offset, u64 addr, u64 user_data);
+  void CompletionThreadEntryPoint();
+
+  int m_ring_fd = -1;
+  void* m_ring = MAP_FAILED;
+  size_t m_ring_size = 0;
+  io_uring_sqe* m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t m_sqes_size = 0;
+
+  u32 m_sq_entries = 0;
+  u32* m_sq_head = nullptr;
+  u32* m_sq_tail = nullptr;
+  u32 m_sq_mask = 0;
+  u32* m_sq_array = nullptr;
+
+  u32* m_cq_head = nullptr;
+  u32* m_cq_tail = nullptr;
+  u32 m_cq_mask = 0;
+  io_uring_cqe* m_cqes = nullptr;
+
+  std::mutex m_submit_mutex;
+  Threading::Thread m_thread;
+};
+
+FileSystem::AsyncFile::IOContext* FileSystem::AsyncFile::IOContext::Get()
+{
+  static std::unique_ptr<IOContext> s_context = []() {
+    std::unique_ptr<IOContext> context = std::make_unique<IOContext>();
+    if (!context->Initialize())
+    {
+      Log_WarningPrint("io_uring is not available, asynchronous I/O will use the thread pool.");
+      context.reset();
+    }
+
+    return context;
+  }();
+
+  return s_context.get();
+}
+
+FileSystem::AsyncFile::IOContext::~IOContext()
+{
+  // A NOP without a request tells the thread to exit.
+  if (m_thread.Joinable())
+  {
+    if (SubmitEntry(IORING_OP_NOP, -1, 0, 0, 0))
+      m_thread.Join();
+    else
+      m_thread.Detach();
+  }
+
+  if (m_sqes != MAP_FAILED)
+    munmap(m_sqes, m_sqes_size);
+  if (m_ring != MAP_FAILED)
+    munmap(m_ring, m_ring_size);
+  if (m_ring_fd >= 0)
+    close(m_ring_fd);
+}
+
+bool FileSystem::AsyncFile::IOContext::Initialize()
+{
+  io_uring_params params = {};
+  m_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+  if (m_ring_fd < 0)
+  {
+    Log_DevFmt("io_uring_setup() failed: {}", errno);
+    return false;
+  }
+
+  // Without NODROP, completions are lost when the queue overflows, and we'd never call back.
+  if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_SINGLE_MMAP))
+  {
+    Log_DevFmt("io_uring is missing required features (0x{:X})", params.features);
+    return false;
+  }
+
+  m_ring_size = std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(u32),
+                                 params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  m_ring = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+  m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  m_sqes = static_cast<io_uring_sqe*>(
+    mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES));
+  if (m_ring == MAP_FAILED || m_sqes == MAP_FAILED)
+  {
+    Log_DevFmt("Failed to map io_uring: {}", errno);
+    return false;
+  }
+
+  u8* const ring = static_cast<u8*>(m_ring);
+  m_sq_entries = params.sq_entries;
+  m_sq_head = reinterpret_cast<u32*>(ring + params.sq_off.head);
+  m_sq_tail = reinterpret_cast<u32*>(ring + params.sq_off.tail);
+  m_sq_mask = *reinterpret_cast<u32*>(ring + params.sq_off.ring_mask);
+  m_sq_array = reinterpret_cast<u32*>(ring + params.sq_off.array);
+  m_cq_head = reinterpret_cast<u32*>(ring + params.cq_off.head);
+  m_cq_tail = reinterpret_cast<u32*>(ring + params.cq_off.tail);
+  m_cq_mask = *reinterpret_cast<u32*>(ring + params.cq_off.ring_mask);
+  m_cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+
+  return m_thread.Start([this]() { CompletionThreadEntryPoint(); });
+}
+
+bool FileSystem::AsyncFile::IOContext::Submit(int fd, bool write, u64 offset, Request* request)
+{
+  // READV/WRITEV rather than READ/WRITE, since they're supported from the first kernels with io_uring.
+  return SubmitEntry(write ? IORING_OP_WRITEV : IORING_OP_READV, fd, offset, reinterpret_cast<u64>(&request->iov),
+                     reinterpret_cast<u64>(request));
+}
+
+bool FileSystem::AsyncFile::IOContext::SubmitEntry(u8 opcode, int fd, u64 offset, u64 addr, u64 user_data)
+{
+  std::unique_lock lock(m_submit_mutex);
+
+  // Entries are consumed by io_uring_enter() below, so the queue is never left full.
+  const u32 tail = *m_sq_tail;
+  if ((tail - std::atomic_ref<u32>(*m_sq_head).load(std::memory_order_acquire)) >= m_sq_entries)
+    return false;
+
+  const u32 index = tail & m_sq_mask;
+  io_uring_sqe& sqe = m_sqes[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.fd = fd;
+  sqe.off = offset;
+  sqe.addr = addr;
+  sqe.len = (opcode == IORING_OP_NOP) ? 0 : 1;
+  sqe.user_data = user_data;
+  m_sq_array[index] = index;
+  std::atomic_ref<u32>(*m_sq_tail).store(tail + 1, std::memory_order_release);
+
+  for (;;)
+  {
+    const int res = static_cast<int>(syscall(__NR_io_uring_enter, m_ring_fd, 1, 0, 0, nullptr, 0));
+    if (res >= 1)
+      return true;
+
+    // EBUSY/EAGAIN mean the completion queue is backed up, which the completion thread will sort out.
+    if (res < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY))
+    {
+      Threading::Timeslice();
+      continue;
+    }
+
+    // Only we submit, so the kernel can't have looked at the entry, and it's safe to take back.
+    Log_ErrorFmt("io_uring_enter() failed: {}", errno);
+    std::atomic_ref<u32>(*m_sq_tail).store(tail, std::memory_order_release);
+    return false;
+  }
+}
+
+void FileSystem::AsyncFile::IOContext::CompletionThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Async I/O");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Background);
+
+  bool shutdown = false;
+  while (!shutdown)
+  {
+    u32 head = *m_cq_head;
+    const u32 tail = std::atomic_ref<u32>(*m_cq_tail).load(std::memory_order_acquire);
+    if (head == tail)
+    {
+      const int res =
+        static_cast<int>(syscall(__NR_io_uring_enter, m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (res < 0 && errno != EINTR)
+        Log_ErrorFmt("io_uring_enter() failed while waiting: {}", errno);
+
+      continue;
+    }
+
+    for (; head != tail; head++)
+    {
+      const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+      const u64 user_data = cqe.user_data;
+      const s32 res = cqe.res;
+
+      // Give the entry back before calling back, so the callback can queue more work without the ring filling up.
+      std::atomic_ref<u32>(*m_cq_head).store(head + 1, std::memory_order_release);
+
+      if (user_data == 0)
+      {
+        shutdown = true;
+        continue;
+      }
+
+      Request* request = reinterpret_cast<Request*>(user_data);
+      request->file->CompleteRequest(request, (res < 0) ? -1 : static_cast<s64>(res));
+    }
+  }
+}
+
+#endif
+
+// Used where there's no native asynchronous I/O. pread()/pwrite() can transfer less than asked for, so loop until
+// it's all done or we hit the end of the file.
+static s64 BlockingTransfer(int fd, bool write, u64 offset, void* buffer, u32 size)
+{
+  u32 done = 0;
+  while (done < size)
+  {
+    u8* ptr = static_cast<u8*>(buffer) + done;
+    const off_t pos = static_cast<off_t>(offset + done);
+    const ssize_t res = write ? pwrite(fd, ptr, size - done, pos) : pread(fd, ptr, size - done, pos);
+    if (res < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return -1;
+    }
+    else if (res == 0)
+    {
+      break;
+    }
+
+    done += static_cast<u32>(res);
+  }
+
+  return static_cast<s64>(done);
+}
+
+FileSystem::AsyncFile::AsyncFile(int fd) : m_fd(fd)
+{
+}
+
+FileSystem::AsyncFile::~AsyncFile()
+{
+  WaitForCompletion();
+  close(m_fd);
+}
+
+std::unique_ptr<FileSystem::AsyncFile> FileSystem::AsyncFile::Open(const char* path, OpenMode mode,
+                                                                    Error* error /* = nullptr */)
+{
+  int flags = O_CLOEXEC;
+  if (mode == OpenMode::Read)
+    flags |= O_RDONLY;
+  else if (mode == OpenMode::ReadWrite)
+    flags |= O_RDWR;
+  else
+    flags |= O_RDWR | O_CREAT | O_TRUNC;
+
+  const int fd = OpenFDFile(path, flags, 0644, error);
+  if (fd < 0)
+    return {};
+
+  return std::unique_ptr<AsyncFile>(new AsyncFile(fd));
+}
+
+s64 FileSystem::AsyncFile::GetSize() const
+{
+  struct stat st;
+  return (fstat(m_fd, &st) == 0) ? static_cast<s64>(st.st_size) : -1;
+}
+
+void FileSystem::AsyncFile::Submit(bool write, u64 offset, void* buffer, u32 size, Callback callback)
+{
+  {
+    std::unique_lock lock(m_pending_mutex);
+    m_pending_requests++;
+  }
+
+  Request* request = new Request{};
+  request->file = this;
+  request->callback = std::move(callback);
+
+#ifdef __linux__
+  request->iov.iov_base = buffer;
+  request->iov.iov_len = size;
+
+  if (IOContext* context = IOContext::Get(); context && context->Submit(m_fd, write, offset, request))
+    return;
+#endif
+
+  Threading::ThreadPool::GetShared().Enqueue([this, request, write, offset, buffer, size]() {
+    CompleteRequest(request, BlockingTransfer(m_fd, write, offset, buffer, size));
+  });
+}
+
+#endif
+
+void FileSystem::AsyncFile::Read(u64 offset, void* buffer, u32 size, Callback callback)
+{
+  Submit(false, offset, buffer, size, std::move(callback));
+}
+
+void FileSystem::AsyncFile::Write(u64 offset, const void* buffer, u32 size, Callback callback)
+{
+  Submit(true, offset, const_cast<void*>(buffer), size, std::move(callback));
+}
+
+std::future<s64> FileSystem::AsyncFile::Read(u64 offset, void* buffer, u32 size)
+{
+  std::shared_ptr<std::promise<s64>> promise = std::make_shared<std::promise<s64>>();
+  std::future<s64> future = promise->get_future();
+  Submit(false, offset, buffer, size, [promise](s64 result) { promise->set_value(result); });
+  return future;
+}
+
+std::future<s64> FileSystem::AsyncFile::Write(u64 offset, const void* buffer, u32 size)
+{
+  std::shared_ptr<std::promise<s64>> promise = std::make_shared<std::promise<s64>>();
+  std::future<s64> future = promise->get_future();
+  Submit(true, offset, const_cast<void*>(buffer), size, [promise](s64 result) { promise->set_value(result); });
+  return future;
+}
+
+u32 FileSystem::AsyncFile::GetPendingRequestCount() const
+{
+  std::unique_lock lock(m_pending_mutex);
+  return m_pending_requests;
+}
+
+void FileSystem::AsyncFile::WaitForCompletion()
+{
+  std::unique_lock lock(m_pending_mutex);
+  m_pending_cv.wait(lock, [this]() { return (m_pending_requests == 0); });
+}
+
+void FileSystem::AsyncFile::CompleteRequest(Request* request, s64 result)
+{
+  if (request->callback)
+    request->callback(result);
+  delete request;
+
+  // Notified with the lock held, since the waiter may destroy the file as soon as it sees the count reach zero.
+  std::unique_lock lock(m_pending_mutex);
+  DebugAssert(m_pending_requests > 0);
+  if ((--m_pending_requests) == 0)
+    m_pending_cv.notify_all();
+}
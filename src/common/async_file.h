@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+class Error;
+
+namespace FileSystem {
+
+/// File which is read and written without blocking the caller. Requests are handed to the OS's asynchronous I/O
+/// interface where there is one (IOCP on Windows, io_uring on Linux), or run on the shared thread pool otherwise, so
+/// many requests can be in flight without each user needing its own thread.
+///
+/// Callbacks are invoked on an I/O thread, so they should be short, and must not wait for other requests.
+class AsyncFile
+{
+public:
+  enum class OpenMode : u8
+  {
+    Read,      /// Existing file, read-only.
+    ReadWrite, /// Existing file, read and write.
+    Create,    /// Created if it doesn't exist, otherwise truncated. Read and write.
+  };
+
+  /// Called with the number of bytes transferred, which can be short at the end of the file, or -1 on error.
+  using Callback = std::function<void(s64 result)>;
+
+  ~AsyncFile();
+
+  AsyncFile(const AsyncFile&) = delete;
+  AsyncFile& operator=(const AsyncFile&) = delete;
+
+  static std::unique_ptr<AsyncFile> Open(const char* path, OpenMode mode, Error* error = nullptr);
+
+  /// Returns the current size of the file, or -1 on error.
+  s64 GetSize() const;
+
+  /// Queues a read of size bytes at offset. The buffer must stay valid until the callback has been called.
+  void Read(u64 offset, void* buffer, u32 size, Callback callback);
+
+  /// Queues a write of size bytes at offset. The buffer must stay valid until the callback has been called.
+  void Write(u64 offset, const void* buffer, u32 size, Callback callback);
+
+  /// Same as above, but returns a future for the result instead of calling back.
+  std::future<s64> Read(u64 offset, void* buffer, u32 size);
+  std::future<s64> Write(u64 offset, const void* buffer, u32 size);
+
+  /// Returns the number of requests which have been queued but not yet completed.
+  u32 GetPendingRequestCount() const;
+
+  /// Blocks until every queued request has completed and its callback has returned.
+  void WaitForCompletion();
+
+private:
+  struct Request;
+  class IOContext;
+
+#ifdef _WIN32
+  explicit AsyncFile(void* handle);
+#else
+  explicit AsyncFile(int fd);
+#endif
+
+  void Submit(bool write, u64 offset, void* buffer, u32 size, Callback callback);
+  void CompleteRequest(Request* request, s64 result);
+
+#ifdef _WIN32
+  void* m_handle;
+#else
+  int m_fd;
+#endif
+
+  mutable std::mutex m_pending_mutex;
+  std::condition_variable m_pending_cv;
+  u32 m_pending_requests = 0;
+};
+
+} // namespace FileSystem
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "binary_delta.h"
+#include "error.h"
+#include "sha1_digest.h"
+#include "string_util.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr char PATCH_MAGIC[8] = {'D', 'S', 'D', 'E', 'L', 'T', 'A', '1'};
+
+enum class PatchCommand : u8
+{
+  Copy = 0x00,
+  Add = 0x01,
+};
+
+std::optional<std::vector<BinaryDelta::ManifestEntry>> BinaryDelta::ParseManifest(std::string_view manifest,
+                                                                                   Error* error)
+{
+  std::vector<ManifestEntry> entries;
+  u32 line_number = 0;
+  for (std::string_view line : StringUtil::SplitString(manifest, '\n', false))
+  {
+    line_number++;
+    line = StringUtil::StripWhitespace(line);
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    // paths can contain spaces, so they take the rest of the line
+    const std::string_view::size_type first_space = line.find(' ');
+    const std::string_view::size_type second_space =
+      (first_space != std::string_view::npos) ? line.find(' ', first_space + 1) : std::string_view::npos;
+    if (second_space == std::string_view::npos)
+    {
+      Error::SetStringFmt(error, "Malformed delta manifest line {}", line_number);
+      return std::nullopt;
+    }
+
+    ManifestEntry entry;
+    const std::string_view target_hash = line.substr(0, first_space);
+    if (target_hash != "-")
+      entry.target_hash = target_hash;
+    const std::string_view source_hash = line.substr(first_space + 1, second_space - first_space - 1);
+    if (source_hash != "-")
+      entry.source_hash = source_hash;
+    entry.path = StringUtil::StripWhitespace(line.substr(second_space + 1));
+
+    // removed files have nothing to patch
+    const bool valid_target = entry.IsRemoved() ? entry.source_hash.empty() :
+                                                  (entry.target_hash.length() == (SHA1Digest::DIGEST_SIZE * 2));
+    if (entry.path.empty() || !valid_target ||
+        (!entry.source_hash.empty() && entry.source_hash.length() != (SHA1Digest::DIGEST_SIZE * 2)))
+    {
+      Error::SetStringFmt(error, "Malformed delta manifest line {}", line_number);
+      return std::nullopt;
+    }
+
+    entries.push_back(std::move(entry));
+  }
+
+  return entries;
+}
+
+std::string BinaryDelta::GetHash(std::span<const u8> data)
+{
+  SHA1Digest digest;
+  for (size_t offset = 0; offset < data.size();)
+  {
+    // Update() takes a 32-bit length
+    const u32 chunk = static_cast<u32>(std::min<size_t>(data.size() - offset, 0x10000000u));
+    digest.Update(data.data() + offset, chunk);
+    offset += chunk;
+  }
+
+  u8 result[SHA1Digest::DIGEST_SIZE];
+  digest.Final(result);
+  return SHA1Digest::DigestToString(result);
+}
+
+bool BinaryDelta::ApplyPatch(std::span<const u8> source, std::span<const u8> patch, std::vector<u8>* out,
+                             Error* error)
+{
+  size_t pos = 0;
+  const auto read = [&patch, &pos](void* dst, size_t size) {
+    if ((patch.size() - pos) < size)
+      return false;
+
+    std::memcpy(dst, patch.data() + pos, size);
+    pos += size;
+    return true;
+  };
+
+  char magic[sizeof(PATCH_MAGIC)];
+  u64 target_size;
+  if (!read(magic, sizeof(magic)) || std::memcmp(magic, PATCH_MAGIC, sizeof(magic)) != 0 ||
+      !read(&target_size, sizeof(target_size)))
+  {
+    Error::SetStringView(error, "Patch header is invalid");
+    return false;
+  }
+
+  // Don't trust the size for the reservation, a bad patch fails long before reaching it.
+  out->clear();
+  out->reserve(static_cast<size_t>(std::min<u64>(target_size, source.size() + patch.size())));
+  while (out->size() < target_size)
+  {
+    PatchCommand command;
+    u32 length;
+    if (!read(&command, sizeof(command)))
+    {
+      Error::SetStringView(error, "Patch is truncated");
+      return false;
+    }
+
+    if (command == PatchCommand::Copy)
+    {
+      u64 offset;
+      if (!read(&offset, sizeof(offset)) || !read(&length, sizeof(length)))
+      {
+        Error::SetStringView(error, "Patch is truncated");
+        return false;
+      }
+      if (offset > source.size() || length > (source.size() - offset) || length > (target_size - out->size()))
+      {
+        Error::SetStringFmt(error, "Patch copy of {} bytes at {} is out of range", length, offset);
+        return false;
+      }
+
+      out->insert(out->end(), source.begin() + static_cast<size_t>(offset),
+                  source.begin() + static_cast<size_t>(offset + length));
+    }
+    else if (command == PatchCommand::Add)
+    {
+      if (!read(&length, sizeof(length)) || length > (patch.size() - pos) || length > (target_size - out->size()))
+      {
+        Error::SetStringView(error, "Patch is truncated");
+        return false;
+      }
+
+      out->insert(out->end(), patch.begin() + pos, patch.begin() + pos + length);
+      pos += length;
+    }
+    else
+    {
+      Error::SetStringFmt(error, "Unknown patch command {}", static_cast<unsigned>(command));
+      return false;
+    }
+  }
+
+  if (pos != patch.size())
+  {
+    Error::SetStringView(error, "Patch has trailing data");
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Error;
+
+/// Per-file deltas for updates, so only the files which changed between two releases need to be downloaded.
+///
+/// A delta update zip contains MANIFEST_FILENAME, with one line for each file in the zip, and each file which was
+/// removed since the old release:
+///
+///   <sha1 of new file, or - if removed> <sha1 of old file, or - if stored in full or removed> <path in zip>
+///
+/// Files with an old hash are stored as <path in zip>PATCH_SUFFIX, and are applied to the installed copy. Removed files
+/// are deleted from the installation. Files which are not listed are left as they are.
+///
+/// Patches are a header of "DSDELTA1" and the little-endian u64 size of the new file, followed by commands until the
+/// new file is complete:
+///
+///   0x00 COPY: u64 offset, u32 length - copies length bytes from the old file.
+///   0x01 ADD:  u32 length, <length bytes> - appends the bytes which follow.
+///
+/// Deltas are created by scripts/make_delta_update.py.
+namespace BinaryDelta {
+
+static constexpr const char* MANIFEST_FILENAME = "delta_manifest.txt";
+static constexpr const char* PATCH_SUFFIX = ".delta";
+
+struct ManifestEntry
+{
+  std::string path;
+  std::string target_hash; // empty when the file was removed
+  std::string source_hash; // empty when the file is stored in full or was removed
+
+  ALWAYS_INLINE bool IsRemoved() const { return target_hash.empty(); }
+};
+
+/// Parses a delta manifest. Blank lines and lines starting with # are ignored.
+std::optional<std::vector<ManifestEntry>> ParseManifest(std::string_view manifest, Error* error);
+
+/// Returns the hex SHA-1 of the data, as used in the manifest. Compare with EqualNoCase(), case is not significant.
+std::string GetHash(std::span<const u8> data);
+
+/// Reconstructs the new file from the old file and a patch. The result should be checked against the manifest hash.
+bool ApplyPatch(std::span<const u8> source, std::span<const u8> patch, std::vector<u8>* out, Error* error);
+
+} // namespace BinaryDelta
@@ -6,6 +6,7 @@
 #include "error.h"
 #include "file_system.h"
 #include "log.h"
+#include "memmap.h"
 #include "string_util.h"
 
 #include <algorithm>
@@ -13,6 +14,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <sys/stat.h>
 
 #if defined(_WIN32)
@@ -562,6 +564,11 @@ u64 MemoryByteStream::GetPosition() const
   return (u64)m_iPosition;
 }
 
+const u8* MemoryByteStream::GetReadPointer(u32 ByteCount) const
+{
+  return (ByteCount <= (m_iSize - m_iPosition)) ? (m_pMemory + m_iPosition) : nullptr;
+}
+
 bool MemoryByteStream::Flush()
 {
   return true;
@@ -674,6 +681,11 @@ u64 ReadOnlyMemoryByteStream::GetPosition() const
   return (u64)m_iPosition;
 }
 
+const u8* ReadOnlyMemoryByteStream::GetReadPointer(u32 ByteCount) const
+{
+  return (ByteCount <= (m_iSize - m_iPosition)) ? (m_pMemory + m_iPosition) : nullptr;
+}
+
 bool ReadOnlyMemoryByteStream::Flush()
 {
   return false;
@@ -689,6 +701,121 @@ bool ReadOnlyMemoryByteStream::Discard()
   return false;
 }
 
+MemoryMappedByteStream::MemoryMappedByteStream(const void* pMapping, u32 MappingSize)
+{
+  m_iPosition = 0;
+  m_iSize = MappingSize;
+  m_pMemory = static_cast<const u8*>(pMapping);
+}
+
+MemoryMappedByteStream::~MemoryMappedByteStream()
+{
+  if (m_pMemory)
+    MemMap::UnmapFile(m_pMemory, m_iSize);
+}
+
+bool MemoryMappedByteStream::ReadByte(u8* pDestByte)
+{
+  if (m_iPosition < m_iSize)
+  {
+    *pDestByte = m_pMemory[m_iPosition++];
+    return true;
+  }
+
+  return false;
+}
+
+u32 MemoryMappedByteStream::Read(void* pDestination, u32 ByteCount)
+{
+  const u32 sz = std::min(ByteCount, m_iSize - m_iPosition);
+  if (sz > 0)
+  {
+    std::memcpy(pDestination, m_pMemory + m_iPosition, sz);
+    m_iPosition += sz;
+  }
+
+  return sz;
+}
+
+bool MemoryMappedByteStream::Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */)
+{
+  u32 r = Read(pDestination, ByteCount);
+  if (pNumberOfBytesRead != nullptr)
+    *pNumberOfBytesRead = r;
+
+  return (r == ByteCount);
+}
+
+bool MemoryMappedByteStream::WriteByte(u8 SourceByte)
+{
+  return false;
+}
+
+u32 MemoryMappedByteStream::Write(const void* pSource, u32 ByteCount)
+{
+  return 0;
+}
+
+bool MemoryMappedByteStream::Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */)
+{
+  return false;
+}
+
+bool MemoryMappedByteStream::SeekAbsolute(u64 Offset)
+{
+  if (Offset > m_iSize)
+    return false;
+
+  m_iPosition = static_cast<u32>(Offset);
+  return true;
+}
+
+bool MemoryMappedByteStream::SeekRelative(s64 Offset)
+{
+  const s64 new_position = static_cast<s64>(m_iPosition) + Offset;
+  if (new_position < 0 || new_position > static_cast<s64>(m_iSize))
+    return false;
+
+  m_iPosition = static_cast<u32>(new_position);
+  return true;
+}
+
+bool MemoryMappedByteStream::SeekToEnd()
+{
+  m_iPosition = m_iSize;
+  return true;
+}
+
+u64 MemoryMappedByteStream::GetSize() const
+{
+  return (u64)m_iSize;
+}
+
+u64 MemoryMappedByteStream::GetPosition() const
+{
+  return (u64)m_iPosition;
+}
+
+const u8* MemoryMappedByteStream::GetReadPointer(u32 ByteCount) const
+{
+  return (ByteCount <= (m_iSize - m_iPosition)) ? (m_pMemory + m_iPosition) : nullptr;
+}
+
+bool MemoryMappedByteStream::Flush()
+{
+  return false;
+}
+
+bool MemoryMappedByteStream::Commit()
+{
+  return false;
+}
+
+bool MemoryMappedByteStream::Discard()
+{
+  return false;
+}
+
 GrowableMemoryByteStream::GrowableMemoryByteStream(void* pInitialMem, u32 InitialMemSize)
 {
   m_iPosition = 0;
@@ -862,6 +989,11 @@ u64 GrowableMemoryByteStream::GetPosition() const
   return (u64)m_iPosition;
 }
 
+const u8* GrowableMemoryByteStream::GetReadPointer(u32 ByteCount) const
+{
+  return (ByteCount <= (m_iSize - m_iPosition)) ? (m_pMemory + m_iPosition) : nullptr;
+}
+
 bool GrowableMemoryByteStream::Flush()
 {
   return true;
@@ -1200,6 +1332,32 @@ std::unique_ptr<ReadOnlyMemoryByteStream> ByteStream::CreateReadOnlyMemoryStream
   return std::make_unique<ReadOnlyMemoryByteStream>(pMemory, Size);
 }
 
+std::unique_ptr<MemoryMappedByteStream> ByteStream::OpenMemoryMappedFile(const char* FileName,
+                                                                       Error* error /* = nullptr */)
+{
+  FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(FileName, "rb", error);
+  if (!fp)
+    return nullptr;
+
+  const s64 size = FileSystem::FSize64(fp.get());
+  if (size < 0 || static_cast<u64>(size) > std::numeric_limits<u32>::max())
+  {
+    Error::SetStringFmt(error, "File size {} is not supported.", size);
+    return nullptr;
+  }
+
+  // empty files can't be mapped, but are still valid streams.
+  const void* mapping = nullptr;
+  if (size > 0)
+  {
+    mapping = MemMap::MapFileReadOnly(fp.get(), static_cast<size_t>(size), error);
+    if (!mapping)
+      return nullptr;
+  }
+
+  return std::make_unique<MemoryMappedByteStream>(mapping, static_cast<u32>(size));
+}
+
 std::unique_ptr<NullByteStream> ByteStream::CreateNullStream()
 {
   return std::make_unique<NullByteStream>();
@@ -6,6 +6,7 @@
 #include "types.h"
 
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -30,6 +31,7 @@ class ByteStream;
 class MemoryByteStream;
 class GrowableMemoryByteStream;
 class ReadOnlyMemoryByteStream;
+class MemoryMappedByteStream;
 class NullByteStream;
 
 // interface class used by readers, writers, etc.
@@ -70,6 +72,10 @@ public:
   // gets the size of the stream
   virtual u64 GetSize() const = 0;
 
+  // returns a pointer to the next ByteCount bytes without copying them or advancing the position, for streams which are
+  // backed by memory. returns null for other streams, or if there aren't enough bytes left.
+  virtual const u8* GetReadPointer(u32 ByteCount) const { return nullptr; }
+
   // flush any changes to the stream to disk
   virtual bool Flush() = 0;
 
@@ -121,12 +127,25 @@ public:
   // readable memory stream
   static std::unique_ptr<ReadOnlyMemoryByteStream> CreateReadOnlyMemoryStream(const void* pMemory, u32 Size);
 
+  // maps a local file into memory for reading, so it can be parsed in place instead of copied through stdio.
+  static std::unique_ptr<MemoryMappedByteStream> OpenMemoryMappedFile(const char* FileName, Error* error = nullptr);
+
   // null memory stream
   static std::unique_ptr<NullByteStream> CreateNullStream();
 
   // zstd stream, actually defined in util/zstd_byte_stream.cpp, to avoid common dependency on libzstd
-  static std::unique_ptr<ByteStream> CreateZstdCompressStream(ByteStream* src_stream, int compression_level);
-  static std::unique_ptr<ByteStream> CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size);
+  // num_threads > 0 compresses on worker threads, the writer only blocks when the compressor falls behind
+  // if a dictionary is given, it must stay valid for the life of the stream, and the same one used to decompress
+  static std::unique_ptr<ByteStream> CreateZstdCompressStream(ByteStream* src_stream, int compression_level,
+                                                              u32 num_threads = 0,
+                                                              std::span<const u8> dictionary = {});
+  static std::unique_ptr<ByteStream> CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size,
+                                                                std::span<const u8> dictionary = {});
+
+  // trains a zstd dictionary from samples of similar data, e.g. states of the same game. samples are stored back to
+  // back in sample_data. returns an empty vector if there isn't enough data to train from.
+  static std::vector<u8> TrainZstdDictionary(const void* sample_data, std::span<const size_t> sample_sizes,
+                                             u32 max_dictionary_size);
 
   // copies one stream's contents to another. rewinds source streams automatically, and returns it back to its old
   // position.
@@ -197,6 +216,7 @@ public:
   bool SeekToEnd() override;
   u64 GetSize() const override;
   u64 GetPosition() const override;
+  const u8* GetReadPointer(u32 ByteCount) const override;
   bool Flush() override;
   bool Commit() override;
   bool Discard() override;
@@ -227,6 +247,40 @@ public:
   bool SeekToEnd() override;
   u64 GetSize() const override;
   u64 GetPosition() const override;
+  const u8* GetReadPointer(u32 ByteCount) const override;
+  bool Flush() override;
+  bool Commit() override;
+  bool Discard() override;
+
+private:
+  const u8* m_pMemory;
+  u32 m_iPosition;
+  u32 m_iSize;
+};
+
+// read-only view of a file which is mapped into memory. reads copy straight out of the page cache, and parsers can use
+// GetReadPointer() to work on the data in place.
+class MemoryMappedByteStream final : public ByteStream
+{
+public:
+  MemoryMappedByteStream(const void* pMapping, u32 MappingSize);
+  ~MemoryMappedByteStream() override;
+
+  const u8* GetMemoryPointer() const { return m_pMemory; }
+  u32 GetMemorySize() const { return m_iSize; }
+
+  bool ReadByte(u8* pDestByte) override;
+  u32 Read(void* pDestination, u32 ByteCount) override;
+  bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */) override;
+  bool WriteByte(u8 SourceByte) override;
+  u32 Write(const void* pSource, u32 ByteCount) override;
+  bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
+  bool SeekAbsolute(u64 Offset) override;
+  bool SeekRelative(s64 Offset) override;
+  bool SeekToEnd() override;
+  u64 GetSize() const override;
+  u64 GetPosition() const override;
+  const u8* GetReadPointer(u32 ByteCount) const override;
   bool Flush() override;
   bool Commit() override;
   bool Discard() override;
@@ -262,6 +316,7 @@ public:
   bool SeekToEnd() override;
   u64 GetSize() const override;
   u64 GetPosition() const override;
+  const u8* GetReadPointer(u32 ByteCount) const override;
   bool Flush() override;
   bool Commit() override;
   bool Discard() override;
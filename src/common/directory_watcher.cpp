@@ -0,0 +1,525 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "directory_watcher.h"
+#include "error.h"
+#include "file_system.h"
+#include "log.h"
+#include "string_util.h"
+#include "threading.h"
+#include "timer.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+#if defined(_WIN32)
+#include "windows_headers.h"
+#elif defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#endif
+
+Log_SetChannel(DirectoryWatcher);
+
+#if defined(_WIN32)
+
+namespace {
+struct Watch
+{
+  static constexpr DWORD BUFFER_SIZE = 64 * 1024;
+
+  DirectoryWatcher::Directory dir;
+  HANDLE handle = INVALID_HANDLE_VALUE;
+  OVERLAPPED overlapped = {};
+  alignas(DWORD) u8 buffer[BUFFER_SIZE];
+};
+} // namespace
+
+struct DirectoryWatcher::NativeState
+{
+  HANDLE wake_event = NULL;
+  std::vector<std::unique_ptr<Watch>> watches;
+};
+
+static constexpr DWORD WATCH_NOTIFY_FILTER =
+  FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+static bool IssueWatchRead(Watch* watch)
+{
+  ResetEvent(watch->overlapped.hEvent);
+  return ReadDirectoryChangesW(watch->handle, watch->buffer, Watch::BUFFER_SIZE, watch->dir.recursive,
+                               WATCH_NOTIFY_FILTER, nullptr, &watch->overlapped, nullptr);
+}
+
+bool DirectoryWatcher::CreateNativeState(Error* error)
+{
+  m_native = std::make_unique<NativeState>();
+  m_native->wake_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+  if (!m_native->wake_event)
+  {
+    Error::SetWin32(error, "CreateEventW() failed: ", GetLastError());
+    m_native.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void DirectoryWatcher::DestroyNativeState()
+{
+  if (!m_native)
+    return;
+
+  for (const std::unique_ptr<Watch>& watch : m_native->watches)
+  {
+    // The buffer can't be freed until the kernel is done with it.
+    DWORD bytes;
+    CancelIoEx(watch->handle, &watch->overlapped);
+    GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, TRUE);
+    CloseHandle(watch->handle);
+    CloseHandle(watch->overlapped.hEvent);
+  }
+
+  CloseHandle(m_native->wake_event);
+  m_native.reset();
+}
+
+bool DirectoryWatcher::AddNativeWatch(const Directory& dir)
+{
+  // One handle is needed for waking the thread.
+  if (!m_native || m_native->watches.size() >= (MAXIMUM_WAIT_OBJECTS - 1))
+    return false;
+
+  std::unique_ptr<Watch> watch = std::make_unique<Watch>();
+  watch->dir = dir;
+  watch->handle = CreateFileW(FileSystem::GetWin32Path(dir.path).c_str(), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+  if (watch->handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  watch->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  if (!watch->overlapped.hEvent)
+  {
+    CloseHandle(watch->handle);
+    return false;
+  }
+
+  // Fails for most network shares.
+  if (!IssueWatchRead(watch.get()))
+  {
+    Log_DevPrintf("ReadDirectoryChangesW() for '%s' failed: %08X", dir.path.c_str(), GetLastError());
+    CloseHandle(watch->overlapped.hEvent);
+    CloseHandle(watch->handle);
+    return false;
+  }
+
+  m_native->watches.push_back(std::move(watch));
+  return true;
+}
+
+void DirectoryWatcher::WakeThread()
+{
+  if (m_native)
+    SetEvent(m_native->wake_event);
+}
+
+void DirectoryWatcher::WaitForNativeEvents(u32 timeout_ms)
+{
+  std::array<HANDLE, MAXIMUM_WAIT_OBJECTS> handles;
+  DWORD num_handles = 0;
+  handles[num_handles++] = m_native->wake_event;
+  for (const std::unique_ptr<Watch>& watch : m_native->watches)
+    handles[num_handles++] = watch->overlapped.hEvent;
+
+  const DWORD result = WaitForMultipleObjects(num_handles, handles.data(), FALSE, timeout_ms);
+  if (result <= WAIT_OBJECT_0 || result >= (WAIT_OBJECT_0 + num_handles))
+    return;
+
+  Watch* watch = m_native->watches[result - WAIT_OBJECT_0 - 1].get();
+  DWORD bytes;
+  if (GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, FALSE))
+  {
+    if (bytes == 0)
+    {
+      // Buffer overflowed, so we don't know what changed.
+      m_pending_changes.insert(watch->dir.path);
+    }
+    else
+    {
+      const u8* ptr = watch->buffer;
+      for (;;)
+      {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+        const std::string name = StringUtil::WideStringToUTF8String(
+          std::wstring_view(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+        m_pending_changes.insert(fmt::format("{}\\{}", watch->dir.path, name));
+        if (info->NextEntryOffset == 0)
+          break;
+
+        ptr += info->NextEntryOffset;
+      }
+    }
+
+    m_last_change_time = Common::Timer::GetCurrentValue();
+  }
+
+  if (!IssueWatchRead(watch))
+  {
+    // Directory was probably deleted. Keep the handle, so the wait list doesn't change, but report it.
+    Log_WarningPrintf("Failed to re-issue watch for '%s': %08X", watch->dir.path.c_str(), GetLastError());
+    m_pending_changes.insert(watch->dir.path);
+    m_last_change_time = Common::Timer::GetCurrentValue();
+    ResetEvent(watch->overlapped.hEvent);
+  }
+}
+
+#elif defined(__linux__)
+
+struct DirectoryWatcher::NativeState
+{
+  int inotify_fd = -1;
+  int wake_fd = -1;
+  std::unordered_map<int, Directory> watches;
+};
+
+static constexpr u32 WATCH_MASK =
+  IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF;
+
+static bool AddInotifyWatch(int fd, std::unordered_map<int, DirectoryWatcher::Directory>& watches,
+                            const DirectoryWatcher::Directory& dir)
+{
+  const int wd = inotify_add_watch(fd, dir.path.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    Log_DevPrintf("inotify_add_watch() for '%s' failed: %d", dir.path.c_str(), errno);
+    return false;
+  }
+
+  watches[wd] = dir;
+
+  // inotify isn't recursive, so every subdirectory needs its own watch.
+  if (dir.recursive)
+  {
+    FileSystem::FindResultsArray subdirs;
+    FileSystem::FindFiles(dir.path.c_str(), "*",
+                          FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE, &subdirs);
+    for (const FILESYSTEM_FIND_DATA& fd_subdir : subdirs)
+    {
+      const int subdir_wd = inotify_add_watch(fd, fd_subdir.FileName.c_str(), WATCH_MASK);
+      if (subdir_wd >= 0)
+        watches[subdir_wd] = DirectoryWatcher::Directory{fd_subdir.FileName, true};
+    }
+  }
+
+  return true;
+}
+
+bool DirectoryWatcher::CreateNativeState(Error* error)
+{
+  m_native = std::make_unique<NativeState>();
+  m_native->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_native->inotify_fd < 0)
+  {
+    Error::SetErrno(error, "inotify_init1() failed: ", errno);
+    m_native.reset();
+    return false;
+  }
+
+  m_native->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_native->wake_fd < 0)
+  {
+    Error::SetErrno(error, "eventfd() failed: ", errno);
+    close(m_native->inotify_fd);
+    m_native.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void DirectoryWatcher::DestroyNativeState()
+{
+  if (!m_native)
+    return;
+
+  close(m_native->wake_fd);
+  close(m_native->inotify_fd);
+  m_native.reset();
+}
+
+bool DirectoryWatcher::AddNativeWatch(const Directory& dir)
+{
+  return (m_native && AddInotifyWatch(m_native->inotify_fd, m_native->watches, dir));
+}
+
+void DirectoryWatcher::WakeThread()
+{
+  if (m_native)
+  {
+    const u64 value = 1;
+    [[maybe_unused]] const ssize_t res = write(m_native->wake_fd, &value, sizeof(value));
+  }
+}
+
+void DirectoryWatcher::WaitForNativeEvents(u32 timeout_ms)
+{
+  pollfd fds[2] = {{m_native->inotify_fd, POLLIN, 0}, {m_native->wake_fd, POLLIN, 0}};
+  if (poll(fds, std::size(fds), static_cast<int>(timeout_ms)) <= 0)
+    return;
+
+  if (fds[1].revents & POLLIN)
+  {
+    u64 value;
+    [[maybe_unused]] const ssize_t res = read(m_native->wake_fd, &value, sizeof(value));
+  }
+
+  if (!(fds[0].revents & POLLIN))
+    return;
+
+  alignas(inotify_event) char buffer[16384];
+  for (;;)
+  {
+    const ssize_t len = read(m_native->inotify_fd, buffer, sizeof(buffer));
+    if (len <= 0)
+      break;
+
+    for (const char* ptr = buffer; ptr < (buffer + len);)
+    {
+      const inotify_event* ev = reinterpret_cast<const inotify_event*>(ptr);
+      ptr += sizeof(inotify_event) + ev->len;
+
+      if (ev->mask & IN_Q_OVERFLOW)
+      {
+        // Lost events, so everything could have changed.
+        for (const auto& it : m_native->watches)
+          m_pending_changes.insert(it.second.path);
+        continue;
+      }
+
+      const auto iter = m_native->watches.find(ev->wd);
+      if (iter == m_native->watches.end())
+        continue;
+
+      // Copy, since adding watches below can rehash the map.
+      const Directory dir = iter->second;
+      if (ev->mask & IN_IGNORED)
+      {
+        m_native->watches.erase(iter);
+        continue;
+      }
+
+      std::string path = (ev->len > 0 && ev->name[0] != '\0') ? fmt::format("{}/{}", dir.path, ev->name) : dir.path;
+      if ((ev->mask & IN_ISDIR) && (ev->mask & (IN_CREATE | IN_MOVED_TO)) && dir.recursive)
+        AddInotifyWatch(m_native->inotify_fd, m_native->watches, Directory{path, true});
+
+      m_pending_changes.insert(std::move(path));
+    }
+
+    m_last_change_time = Common::Timer::GetCurrentValue();
+  }
+}
+
+#else
+
+struct DirectoryWatcher::NativeState
+{
+  std::condition_variable wake_cv;
+  bool woken = false;
+};
+
+bool DirectoryWatcher::CreateNativeState(Error* error)
+{
+  // No notifications here yet, everything is polled.
+  m_native = std::make_unique<NativeState>();
+  return true;
+}
+
+void DirectoryWatcher::DestroyNativeState()
+{
+  m_native.reset();
+}
+
+bool DirectoryWatcher::AddNativeWatch(const Directory& dir)
+{
+  return false;
+}
+
+void DirectoryWatcher::WakeThread()
+{
+  if (!m_native)
+    return;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_native->woken = true;
+  }
+  m_native->wake_cv.notify_one();
+}
+
+void DirectoryWatcher::WaitForNativeEvents(u32 timeout_ms)
+{
+  std::unique_lock lock(m_mutex);
+  m_native->wake_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                             [this]() { return (m_native->woken || m_shutdown); });
+  m_native->woken = false;
+}
+
+#endif
+
+DirectoryWatcher::DirectoryWatcher() = default;
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+  Stop();
+}
+
+bool DirectoryWatcher::Start(std::vector<Directory> directories, u32 poll_interval_ms, ChangeCallback callback,
+                             Error* error)
+{
+  Stop();
+
+  if (!CreateNativeState(error))
+    return false;
+
+  for (Directory& dir : directories)
+  {
+    if (AddNativeWatch(dir))
+    {
+      Log_DevPrintf("Watching '%s'%s for changes", dir.path.c_str(), dir.recursive ? " (recursively)" : "");
+      continue;
+    }
+
+    Log_InfoPrintf("Notifications are not available for '%s', polling every %u ms instead", dir.path.c_str(),
+                   poll_interval_ms);
+    m_polled_directories.push_back(PolledDirectory{std::move(dir), {}});
+  }
+
+  m_callback = std::move(callback);
+  m_poll_interval_ms = poll_interval_ms;
+  m_shutdown = false;
+  m_pending_changes.clear();
+  m_thread = std::thread(&DirectoryWatcher::ThreadEntryPoint, this);
+  return true;
+}
+
+void DirectoryWatcher::Stop()
+{
+  if (m_thread.joinable())
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      m_shutdown = true;
+    }
+
+    WakeThread();
+    m_thread.join();
+  }
+
+  DestroyNativeState();
+  m_polled_directories.clear();
+  m_pending_changes.clear();
+  m_callback = {};
+}
+
+void DirectoryWatcher::ListPolledDirectory(PolledDirectory& pd, std::unordered_map<std::string, std::time_t>* files)
+{
+  FileSystem::FindResultsArray results;
+  FileSystem::FindFiles(pd.dir.path.c_str(), "*",
+                        pd.dir.recursive ?
+                          (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE) :
+                          (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES),
+                        &results);
+
+  files->clear();
+  files->reserve(results.size());
+  for (FILESYSTEM_FIND_DATA& fd : results)
+    files->emplace(std::move(fd.FileName), fd.ModificationTime);
+}
+
+void DirectoryWatcher::PollDirectories()
+{
+  std::unordered_map<std::string, std::time_t> files;
+  for (PolledDirectory& pd : m_polled_directories)
+  {
+    ListPolledDirectory(pd, &files);
+
+    bool changed = false;
+    for (const auto& [path, mtime] : files)
+    {
+      const auto iter = pd.files.find(path);
+      if (iter == pd.files.end() || iter->second != mtime)
+      {
+        m_pending_changes.insert(path);
+        changed = true;
+      }
+    }
+    for (const auto& [path, mtime] : pd.files)
+    {
+      if (!files.contains(path))
+      {
+        m_pending_changes.insert(path);
+        changed = true;
+      }
+    }
+
+    if (changed)
+      m_last_change_time = Common::Timer::GetCurrentValue();
+
+    pd.files.swap(files);
+  }
+}
+
+void DirectoryWatcher::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Directory Watcher");
+
+  // Initial listing for polled directories, done here since it can be slow over a network.
+  for (PolledDirectory& pd : m_polled_directories)
+    ListPolledDirectory(pd, &pd.files);
+
+  const Common::Timer::Value poll_interval = Common::Timer::ConvertMillisecondsToValue(m_poll_interval_ms);
+  const Common::Timer::Value settle_time = Common::Timer::ConvertMillisecondsToValue(SETTLE_TIME_MS);
+  Common::Timer::Value next_poll_time = Common::Timer::GetCurrentValue() + poll_interval;
+
+  for (;;)
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      if (m_shutdown)
+        break;
+    }
+
+    Common::Timer::Value now = Common::Timer::GetCurrentValue();
+    Common::Timer::Value wake_time = m_polled_directories.empty() ? (now + poll_interval) : next_poll_time;
+    if (!m_pending_changes.empty())
+      wake_time = std::min(wake_time, m_last_change_time + settle_time);
+
+    const u32 timeout_ms =
+      (wake_time > now) ? static_cast<u32>(Common::Timer::ConvertValueToMilliseconds(wake_time - now)) + 1 : 0;
+    WaitForNativeEvents(timeout_ms);
+
+    now = Common::Timer::GetCurrentValue();
+    if (!m_polled_directories.empty() && now >= next_poll_time)
+    {
+      PollDirectories();
+      next_poll_time = now + poll_interval;
+    }
+
+    if (!m_pending_changes.empty() && (now - m_last_change_time) >= settle_time)
+    {
+      std::vector<std::string> paths(m_pending_changes.begin(), m_pending_changes.end());
+      m_pending_changes.clear();
+      Log_DevPrintf("%zu paths changed", paths.size());
+      m_callback(std::move(paths));
+    }
+  }
+}
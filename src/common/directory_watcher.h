@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Error;
+
+/// Reports files which are added, removed, renamed or modified in a set of directories. Uses inotify on Linux and
+/// ReadDirectoryChangesW on Windows. Directories which can't be watched with notifications, and all directories on
+/// other platforms, are polled for modification time changes instead.
+class DirectoryWatcher
+{
+public:
+  /// Called from the watcher thread with the paths that changed, once they stop changing for a short time.
+  /// Paths can be files or directories, and may no longer exist.
+  using ChangeCallback = std::function<void(std::vector<std::string> paths)>;
+
+  struct Directory
+  {
+    std::string path;
+    bool recursive;
+  };
+
+  DirectoryWatcher();
+  ~DirectoryWatcher();
+
+  ALWAYS_INLINE bool IsRunning() const { return m_thread.joinable(); }
+
+  bool Start(std::vector<Directory> directories, u32 poll_interval_ms, ChangeCallback callback, Error* error);
+  void Stop();
+
+private:
+  /// Changes are held back until nothing has happened for this long, since copying an image produces many events.
+  static constexpr u32 SETTLE_TIME_MS = 1000;
+
+  struct PolledDirectory
+  {
+    Directory dir;
+    std::unordered_map<std::string, std::time_t> files;
+  };
+
+  struct NativeState;
+
+  bool CreateNativeState(Error* error);
+  void DestroyNativeState();
+  bool AddNativeWatch(const Directory& dir);
+  void WakeThread();
+
+  /// Waits up to timeout_ms for notifications, and adds any changed paths to m_pending_changes.
+  void WaitForNativeEvents(u32 timeout_ms);
+
+  void ListPolledDirectory(PolledDirectory& pd, std::unordered_map<std::string, std::time_t>* files);
+  void PollDirectories();
+  void ThreadEntryPoint();
+
+  std::unique_ptr<NativeState> m_native;
+  std::vector<PolledDirectory> m_polled_directories;
+  ChangeCallback m_callback;
+  u32 m_poll_interval_ms = 0;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  bool m_shutdown = false;
+
+  // Only accessed from the watcher thread.
+  std::unordered_set<std::string> m_pending_changes;
+  u64 m_last_change_time = 0;
+};
@@ -5,7 +5,10 @@
 #include "assert.h"
 #include "types.h"
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstring>
+#include <span>
 #include <type_traits>
 
 #ifdef _MSC_VER
@@ -160,6 +163,14 @@ public:
     }
   }
 
+  void AdvanceHead(u32 count)
+  {
+    DebugAssert(m_size >= count);
+    DebugAssert((m_head + count) <= CAPACITY);
+    m_head = (m_head + count) % CAPACITY;
+    m_size -= count;
+  }
+
   void AdvanceTail(u32 count)
   {
     DebugAssert((m_size + count) <= CAPACITY);
@@ -238,3 +249,168 @@ public:
     }
   }
 };
+
+/// Lock-free queue with exactly one producer thread and one consumer thread.
+/// Push*() may only be called by the producer, and Peek()/Pop*()/Remove*() by the consumer. Unlike FIFOQueue, pushing
+/// to a full queue or popping from an empty queue fails rather than asserting, since the other thread may be about to
+/// make room. The object is large, so it should usually live on the heap.
+template<typename T, u32 CAPACITY>
+class SPSCFIFOQueue
+{
+  static_assert(std::has_single_bit(CAPACITY) && CAPACITY <= 0x80000000u, "Capacity must be a power of two");
+  static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>);
+
+public:
+  SPSCFIFOQueue() = default;
+
+  constexpr u32 GetCapacity() const { return CAPACITY; }
+
+  // Sizes are only a snapshot when called while the other thread is active.
+  u32 GetSize() const
+  {
+    // Head has to be read first, otherwise it could pass the tail we read.
+    const u32 head = m_head.load(std::memory_order_acquire);
+    return std::min(m_tail.load(std::memory_order_acquire) - head, CAPACITY);
+  }
+  u32 GetSpace() const { return CAPACITY - GetSize(); }
+  bool IsEmpty() const { return GetSize() == 0; }
+  bool IsFull() const { return GetSize() == CAPACITY; }
+
+  bool Push(const T& value)
+  {
+    const u32 tail = m_tail.load(std::memory_order_relaxed);
+    if (!ProducerHasSpace(tail, 1))
+      return false;
+
+    m_data[tail & MASK] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Push(T&& value)
+  {
+    const u32 tail = m_tail.load(std::memory_order_relaxed);
+    if (!ProducerHasSpace(tail, 1))
+      return false;
+
+    m_data[tail & MASK] = std::move(value);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  template<class... Args>
+  bool Emplace(Args&&... args)
+  {
+    return Push(T(std::forward<Args>(args)...));
+  }
+
+  /// Pushes as many elements from the start of data as there is space for, returning the number pushed.
+  u32 PushRange(std::span<const T> data)
+  {
+    const u32 tail = m_tail.load(std::memory_order_relaxed);
+    const u32 wanted = static_cast<u32>(std::min<size_t>(data.size(), CAPACITY));
+    const u32 count = std::min(wanted, ProducerGetSpace(tail, wanted));
+    if (count == 0)
+      return 0;
+
+    const u32 start = tail & MASK;
+    const u32 count_before_end = std::min(count, CAPACITY - start);
+    std::copy_n(data.begin(), count_before_end, &m_data[start]);
+    std::copy_n(data.begin() + count_before_end, count - count_before_end, &m_data[0]);
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /// Returns the oldest element, or nullptr if the queue is empty. Stays valid until it's popped.
+  T* Peek()
+  {
+    const u32 head = m_head.load(std::memory_order_relaxed);
+    return ConsumerHasData(head, 1) ? &m_data[head & MASK] : nullptr;
+  }
+
+  bool Pop(T* value)
+  {
+    const u32 head = m_head.load(std::memory_order_relaxed);
+    if (!ConsumerHasData(head, 1))
+      return false;
+
+    *value = std::move(m_data[head & MASK]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Pops up to out_data.size() elements, returning the number popped.
+  u32 PopRange(std::span<T> out_data)
+  {
+    const u32 head = m_head.load(std::memory_order_relaxed);
+    const u32 wanted = static_cast<u32>(std::min<size_t>(out_data.size(), CAPACITY));
+    const u32 count = std::min(wanted, ConsumerGetSize(head, wanted));
+    if (count == 0)
+      return 0;
+
+    const u32 start = head & MASK;
+    const u32 count_before_end = std::min(count, CAPACITY - start);
+    std::move(&m_data[start], &m_data[start + count_before_end], out_data.begin());
+    std::move(&m_data[0], &m_data[count - count_before_end], out_data.begin() + count_before_end);
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /// Drops up to count elements without reading them, returning the number dropped.
+  u32 Remove(u32 count)
+  {
+    const u32 head = m_head.load(std::memory_order_relaxed);
+    count = std::min(count, ConsumerGetSize(head, count));
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  bool RemoveOne() { return (Remove(1) == 1); }
+
+  /// Drops everything the producer has pushed so far.
+  void Clear()
+  {
+    m_cached_tail = m_tail.load(std::memory_order_acquire);
+    m_head.store(m_cached_tail, std::memory_order_release);
+  }
+
+private:
+  static constexpr u32 MASK = CAPACITY - 1;
+
+  // Each side keeps a copy of the other side's index, and only reloads it when it looks like the queue is full or
+  // empty. That way the cache line holding the other index only bounces between cores when it has to.
+  ALWAYS_INLINE u32 ProducerGetSpace(u32 tail, u32 wanted)
+  {
+    u32 space = CAPACITY - (tail - m_cached_head);
+    if (space < wanted)
+    {
+      m_cached_head = m_head.load(std::memory_order_acquire);
+      space = CAPACITY - (tail - m_cached_head);
+    }
+
+    return space;
+  }
+  ALWAYS_INLINE bool ProducerHasSpace(u32 tail, u32 count) { return (ProducerGetSpace(tail, count) >= count); }
+
+  ALWAYS_INLINE u32 ConsumerGetSize(u32 head, u32 wanted)
+  {
+    u32 size = m_cached_tail - head;
+    if (size < wanted)
+    {
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+      size = m_cached_tail - head;
+    }
+
+    return size;
+  }
+  ALWAYS_INLINE bool ConsumerHasData(u32 head, u32 count) { return (ConsumerGetSize(head, count) >= count); }
+
+  // Indices increase forever and wrap naturally, the slot is the index masked by the capacity.
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_head{0};
+  u32 m_cached_tail = 0;
+
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_tail{0};
+  u32 m_cached_head = 0;
+
+  alignas(HOST_CACHE_LINE_SIZE) T m_data[CAPACITY] = {};
+};
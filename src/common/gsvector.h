@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+// Thin wrappers around the host's 128-bit vector registers, so vector code only has to be written once for SSE and
+// NEON. Only available when CPU_ARCH_SSE or CPU_ARCH_NEON is defined, callers still need a scalar fallback.
+//
+// GSVector4i holds four 32-bit, eight 16-bit or sixteen 8-bit integer lanes, and GSVector4 holds four floats. The
+// operation suffix gives the lane width, e.g. add16() adds 16-bit lanes, and _i16/_s16 mark signed operations where
+// it matters. Shifts with a template argument take an immediate, which must be less than the lane width.
+
+#pragma once
+
+#include "intrin.h"
+
+#if defined(CPU_ARCH_SSE)
+#include "gsvector_sse.h"
+#elif defined(CPU_ARCH_NEON)
+#include "gsvector_neon.h"
+#endif
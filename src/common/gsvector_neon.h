@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+// AArch64 NEON implementation of the GSVector types, include gsvector.h instead. Operations match the SSE version
+// bit-for-bit, including the saturation of ps32() and the zeroing of negative shuffle8() indices.
+
+#pragma once
+
+#include "intrin.h"
+
+class alignas(16) GSVector4i
+{
+public:
+  int32x4_t v4s;
+
+  GSVector4i() = default;
+
+  ALWAYS_INLINE explicit GSVector4i(int32x4_t m) : v4s(m) {}
+  ALWAYS_INLINE explicit GSVector4i(int16x8_t m) : v4s(vreinterpretq_s32_s16(m)) {}
+  ALWAYS_INLINE explicit GSVector4i(uint16x8_t m) : v4s(vreinterpretq_s32_u16(m)) {}
+  ALWAYS_INLINE explicit GSVector4i(uint32x4_t m) : v4s(vreinterpretq_s32_u32(m)) {}
+  ALWAYS_INLINE explicit GSVector4i(uint64x2_t m) : v4s(vreinterpretq_s32_u64(m)) {}
+  ALWAYS_INLINE explicit GSVector4i(uint8x16_t m) : v4s(vreinterpretq_s32_u8(m)) {}
+
+  ALWAYS_INLINE GSVector4i(s32 x, s32 y, s32 z, s32 w)
+  {
+    alignas(16) const s32 values[4] = {x, y, z, w};
+    v4s = vld1q_s32(values);
+  }
+
+  ALWAYS_INLINE GSVector4i(s16 s0, s16 s1, s16 s2, s16 s3, s16 s4, s16 s5, s16 s6, s16 s7)
+  {
+    alignas(16) const s16 values[8] = {s0, s1, s2, s3, s4, s5, s6, s7};
+    v4s = vreinterpretq_s32_s16(vld1q_s16(values));
+  }
+
+  ALWAYS_INLINE GSVector4i(s8 b0, s8 b1, s8 b2, s8 b3, s8 b4, s8 b5, s8 b6, s8 b7, s8 b8, s8 b9, s8 b10, s8 b11,
+                           s8 b12, s8 b13, s8 b14, s8 b15)
+  {
+    alignas(16) const s8 values[16] = {b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13, b14, b15};
+    v4s = vreinterpretq_s32_s8(vld1q_s8(values));
+  }
+
+  ALWAYS_INLINE static GSVector4i zero() { return GSVector4i(vdupq_n_s32(0)); }
+
+  ALWAYS_INLINE static GSVector4i broadcast16(u16 v) { return GSVector4i(vdupq_n_u16(v)); }
+
+  ALWAYS_INLINE static GSVector4i broadcast32(u32 v) { return GSVector4i(vdupq_n_u32(v)); }
+
+  /// Sets the first 32-bit lane, the rest are zeroed.
+  ALWAYS_INLINE static GSVector4i load32(u32 v) { return GSVector4i(vsetq_lane_u32(v, vdupq_n_u32(0), 0)); }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector4i load(const void* p)
+  {
+    // Byte loads have no alignment requirement.
+    return GSVector4i(vreinterpretq_s32_s8(vld1q_s8(static_cast<const s8*>(p))));
+  }
+
+  /// Loads 64 bits to the low half, the high half is zeroed.
+  ALWAYS_INLINE static GSVector4i loadl(const void* p)
+  {
+    return GSVector4i(vreinterpretq_s32_s8(vcombine_s8(vld1_s8(static_cast<const s8*>(p)), vdup_n_s8(0))));
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void store(void* p, const GSVector4i& v)
+  {
+    vst1q_s8(static_cast<s8*>(p), vreinterpretq_s8_s32(v.v4s));
+  }
+
+  /// Stores the low 64 bits.
+  ALWAYS_INLINE static void storel(void* p, const GSVector4i& v)
+  {
+    vst1_s8(static_cast<s8*>(p), vget_low_s8(vreinterpretq_s8_s32(v.v4s)));
+  }
+
+  ALWAYS_INLINE GSVector4i operator&(const GSVector4i& v) const { return GSVector4i(vandq_s32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4i operator|(const GSVector4i& v) const { return GSVector4i(vorrq_s32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4i operator^(const GSVector4i& v) const { return GSVector4i(veorq_s32(v4s, v.v4s)); }
+
+  /// Returns this & ~v.
+  ALWAYS_INLINE GSVector4i andnot(const GSVector4i& v) const { return GSVector4i(vbicq_s32(v4s, v.v4s)); }
+
+  /// Takes bits from v where the mask is set, otherwise from this.
+  ALWAYS_INLINE GSVector4i blend(const GSVector4i& v, const GSVector4i& mask) const
+  {
+    return GSVector4i(vbslq_s32(vreinterpretq_u32_s32(mask.v4s), v.v4s, v4s));
+  }
+
+  ALWAYS_INLINE GSVector4i add16(const GSVector4i& v) const { return GSVector4i(vaddq_s16(s16x8(), v.s16x8())); }
+  ALWAYS_INLINE GSVector4i sub16(const GSVector4i& v) const { return GSVector4i(vsubq_s16(s16x8(), v.s16x8())); }
+
+  /// Low 16 bits of each product.
+  ALWAYS_INLINE GSVector4i mul16l(const GSVector4i& v) const { return GSVector4i(vmulq_s16(s16x8(), v.s16x8())); }
+
+  /// High 16 bits of each signed product.
+  ALWAYS_INLINE GSVector4i mul16hs(const GSVector4i& v) const
+  {
+    const int32x4_t lo = vmull_s16(vget_low_s16(s16x8()), vget_low_s16(v.s16x8()));
+    const int32x4_t hi = vmull_high_s16(s16x8(), v.s16x8());
+    return GSVector4i(vuzp2q_s16(vreinterpretq_s16_s32(lo), vreinterpretq_s16_s32(hi)));
+  }
+
+  ALWAYS_INLINE GSVector4i min_i16(const GSVector4i& v) const { return GSVector4i(vminq_s16(s16x8(), v.s16x8())); }
+  ALWAYS_INLINE GSVector4i max_i16(const GSVector4i& v) const { return GSVector4i(vmaxq_s16(s16x8(), v.s16x8())); }
+
+  ALWAYS_INLINE GSVector4i eq16(const GSVector4i& v) const { return GSVector4i(vceqq_s16(s16x8(), v.s16x8())); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sll16() const
+  {
+    return GSVector4i(vshlq_n_s16(s16x8(), i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl16() const
+  {
+    return GSVector4i(vshrq_n_u16(vreinterpretq_u16_s32(v4s), i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sra16() const
+  {
+    return GSVector4i(vshrq_n_s16(s16x8(), i));
+  }
+
+  /// Interleaves the low/high four 16-bit lanes of this and v.
+  ALWAYS_INLINE GSVector4i upl16(const GSVector4i& v) const { return GSVector4i(vzip1q_s16(s16x8(), v.s16x8())); }
+  ALWAYS_INLINE GSVector4i uph16(const GSVector4i& v) const { return GSVector4i(vzip2q_s16(s16x8(), v.s16x8())); }
+
+  /// Multiplies signed 16-bit lanes, and adds adjacent pairs of the 32-bit products.
+  ALWAYS_INLINE GSVector4i madd_s16(const GSVector4i& v) const
+  {
+    const int32x4_t lo = vmull_s16(vget_low_s16(s16x8()), vget_low_s16(v.s16x8()));
+    const int32x4_t hi = vmull_high_s16(s16x8(), v.s16x8());
+    return GSVector4i(vpaddq_s32(lo, hi));
+  }
+
+  ALWAYS_INLINE GSVector4i add32(const GSVector4i& v) const { return GSVector4i(vaddq_s32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4i sub32(const GSVector4i& v) const { return GSVector4i(vsubq_s32(v4s, v.v4s)); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sll32() const
+  {
+    return GSVector4i(vshlq_n_s32(v4s, i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl32() const
+  {
+    return GSVector4i(vshrq_n_u32(vreinterpretq_u32_s32(v4s), i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sra32() const
+  {
+    return GSVector4i(vshrq_n_s32(v4s, i));
+  }
+
+  ALWAYS_INLINE GSVector4i sll32(s32 i) const { return GSVector4i(vshlq_s32(v4s, vdupq_n_s32(i))); }
+  ALWAYS_INLINE GSVector4i sra32(s32 i) const { return GSVector4i(vshlq_s32(v4s, vdupq_n_s32(-i))); }
+
+  ALWAYS_INLINE GSVector4i upl32(const GSVector4i& v) const { return GSVector4i(vzip1q_s32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4i uph32(const GSVector4i& v) const { return GSVector4i(vzip2q_s32(v4s, v.v4s)); }
+
+  /// Narrows the 32-bit lanes of this (low half) and v (high half) to 16 bits, with signed saturation.
+  ALWAYS_INLINE GSVector4i ps32(const GSVector4i& v) const
+  {
+    return GSVector4i(vcombine_s16(vqmovn_s32(v4s), vqmovn_s32(v.v4s)));
+  }
+
+  /// Sum of all four signed 32-bit lanes.
+  ALWAYS_INLINE s32 addv_s32() const { return vaddvq_s32(v4s); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl64() const
+  {
+    return GSVector4i(vshrq_n_u64(vreinterpretq_u64_s32(v4s), i));
+  }
+
+  ALWAYS_INLINE GSVector4i upl64(const GSVector4i& v) const
+  {
+    return GSVector4i(vreinterpretq_s32_s64(vzip1q_s64(vreinterpretq_s64_s32(v4s), vreinterpretq_s64_s32(v.v4s))));
+  }
+  ALWAYS_INLINE GSVector4i uph64(const GSVector4i& v) const
+  {
+    return GSVector4i(vreinterpretq_s32_s64(vzip2q_s64(vreinterpretq_s64_s32(v4s), vreinterpretq_s64_s32(v.v4s))));
+  }
+
+  /// Selects bytes by the indices in mask. Negative indices produce zero.
+  ALWAYS_INLINE GSVector4i shuffle8(const GSVector4i& mask) const
+  {
+    return GSVector4i(vqtbl1q_u8(vreinterpretq_u8_s32(v4s), vreinterpretq_u8_s32(mask.v4s)));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE u16 extract16() const
+  {
+    return vgetq_lane_u16(vreinterpretq_u16_s32(v4s), i);
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s32 extract32() const
+  {
+    return vgetq_lane_s32(v4s, i);
+  }
+
+private:
+  ALWAYS_INLINE int16x8_t s16x8() const { return vreinterpretq_s16_s32(v4s); }
+};
+
+class alignas(16) GSVector4
+{
+public:
+  float32x4_t v4s;
+
+  GSVector4() = default;
+
+  ALWAYS_INLINE explicit GSVector4(float32x4_t m) : v4s(m) {}
+
+  ALWAYS_INLINE GSVector4(float x, float y, float z, float w)
+  {
+    alignas(16) const float values[4] = {x, y, z, w};
+    v4s = vld1q_f32(values);
+  }
+
+  ALWAYS_INLINE static GSVector4 broadcast(float v) { return GSVector4(vdupq_n_f32(v)); }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector4 load(const float* p)
+  {
+    return GSVector4(vld1q_f32(p));
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void store(float* p, const GSVector4& v)
+  {
+    vst1q_f32(p, v.v4s);
+  }
+
+  /// Converts signed 32-bit lanes to float.
+  ALWAYS_INLINE static GSVector4 from_i32(const GSVector4i& v) { return GSVector4(vcvtq_f32_s32(v.v4s)); }
+
+  /// Converts to signed 32-bit lanes, truncating towards zero.
+  ALWAYS_INLINE GSVector4i to_i32_trunc() const { return GSVector4i(vcvtq_s32_f32(v4s)); }
+
+  ALWAYS_INLINE GSVector4 operator+(const GSVector4& v) const { return GSVector4(vaddq_f32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4 operator-(const GSVector4& v) const { return GSVector4(vsubq_f32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4 operator*(const GSVector4& v) const { return GSVector4(vmulq_f32(v4s, v.v4s)); }
+
+  /// Interleaves the low/high two lanes of this and v.
+  ALWAYS_INLINE GSVector4 upl(const GSVector4& v) const { return GSVector4(vzip1q_f32(v4s, v.v4s)); }
+  ALWAYS_INLINE GSVector4 uph(const GSVector4& v) const { return GSVector4(vzip2q_f32(v4s, v.v4s)); }
+
+  /// Combines the low/high halves of this and v, i.e. { this.lo, v.lo } and { this.hi, v.hi }.
+  ALWAYS_INLINE GSVector4 upld(const GSVector4& v) const
+  {
+    return GSVector4(vcombine_f32(vget_low_f32(v4s), vget_low_f32(v.v4s)));
+  }
+  ALWAYS_INLINE GSVector4 uphd(const GSVector4& v) const
+  {
+    return GSVector4(vcombine_f32(vget_high_f32(v4s), vget_high_f32(v.v4s)));
+  }
+};
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+// SSE2 implementation of the GSVector types, include gsvector.h instead. shuffle8() additionally requires SSSE3.
+
+#pragma once
+
+#include "intrin.h"
+
+class alignas(16) GSVector4i
+{
+public:
+  __m128i m;
+
+  GSVector4i() = default;
+
+  ALWAYS_INLINE explicit GSVector4i(__m128i m_) : m(m_) {}
+
+  ALWAYS_INLINE GSVector4i(s32 x, s32 y, s32 z, s32 w) : m(_mm_setr_epi32(x, y, z, w)) {}
+
+  ALWAYS_INLINE GSVector4i(s16 s0, s16 s1, s16 s2, s16 s3, s16 s4, s16 s5, s16 s6, s16 s7)
+    : m(_mm_setr_epi16(s0, s1, s2, s3, s4, s5, s6, s7))
+  {
+  }
+
+  ALWAYS_INLINE GSVector4i(s8 b0, s8 b1, s8 b2, s8 b3, s8 b4, s8 b5, s8 b6, s8 b7, s8 b8, s8 b9, s8 b10, s8 b11,
+                           s8 b12, s8 b13, s8 b14, s8 b15)
+    : m(_mm_setr_epi8(b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13, b14, b15))
+  {
+  }
+
+  ALWAYS_INLINE static GSVector4i zero() { return GSVector4i(_mm_setzero_si128()); }
+
+  ALWAYS_INLINE static GSVector4i broadcast16(u16 v) { return GSVector4i(_mm_set1_epi16(static_cast<s16>(v))); }
+
+  ALWAYS_INLINE static GSVector4i broadcast32(u32 v) { return GSVector4i(_mm_set1_epi32(static_cast<s32>(v))); }
+
+  /// Sets the first 32-bit lane, the rest are zeroed.
+  ALWAYS_INLINE static GSVector4i load32(u32 v) { return GSVector4i(_mm_cvtsi32_si128(static_cast<s32>(v))); }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector4i load(const void* p)
+  {
+    return GSVector4i(aligned ? _mm_load_si128(static_cast<const __m128i*>(p)) :
+                                _mm_loadu_si128(static_cast<const __m128i*>(p)));
+  }
+
+  /// Loads 64 bits to the low half, the high half is zeroed.
+  ALWAYS_INLINE static GSVector4i loadl(const void* p)
+  {
+    return GSVector4i(_mm_loadl_epi64(static_cast<const __m128i*>(p)));
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void store(void* p, const GSVector4i& v)
+  {
+    if constexpr (aligned)
+      _mm_store_si128(static_cast<__m128i*>(p), v.m);
+    else
+      _mm_storeu_si128(static_cast<__m128i*>(p), v.m);
+  }
+
+  /// Stores the low 64 bits.
+  ALWAYS_INLINE static void storel(void* p, const GSVector4i& v) { _mm_storel_epi64(static_cast<__m128i*>(p), v.m); }
+
+  ALWAYS_INLINE GSVector4i operator&(const GSVector4i& v) const { return GSVector4i(_mm_and_si128(m, v.m)); }
+  ALWAYS_INLINE GSVector4i operator|(const GSVector4i& v) const { return GSVector4i(_mm_or_si128(m, v.m)); }
+  ALWAYS_INLINE GSVector4i operator^(const GSVector4i& v) const { return GSVector4i(_mm_xor_si128(m, v.m)); }
+
+  /// Returns this & ~v.
+  ALWAYS_INLINE GSVector4i andnot(const GSVector4i& v) const { return GSVector4i(_mm_andnot_si128(v.m, m)); }
+
+  /// Takes bits from v where the mask is set, otherwise from this.
+  ALWAYS_INLINE GSVector4i blend(const GSVector4i& v, const GSVector4i& mask) const
+  {
+    return GSVector4i(_mm_or_si128(_mm_and_si128(mask.m, v.m), _mm_andnot_si128(mask.m, m)));
+  }
+
+  ALWAYS_INLINE GSVector4i add16(const GSVector4i& v) const { return GSVector4i(_mm_add_epi16(m, v.m)); }
+  ALWAYS_INLINE GSVector4i sub16(const GSVector4i& v) const { return GSVector4i(_mm_sub_epi16(m, v.m)); }
+
+  /// Low 16 bits of each product.
+  ALWAYS_INLINE GSVector4i mul16l(const GSVector4i& v) const { return GSVector4i(_mm_mullo_epi16(m, v.m)); }
+
+  /// High 16 bits of each signed product.
+  ALWAYS_INLINE GSVector4i mul16hs(const GSVector4i& v) const { return GSVector4i(_mm_mulhi_epi16(m, v.m)); }
+
+  ALWAYS_INLINE GSVector4i min_i16(const GSVector4i& v) const { return GSVector4i(_mm_min_epi16(m, v.m)); }
+  ALWAYS_INLINE GSVector4i max_i16(const GSVector4i& v) const { return GSVector4i(_mm_max_epi16(m, v.m)); }
+
+  ALWAYS_INLINE GSVector4i eq16(const GSVector4i& v) const { return GSVector4i(_mm_cmpeq_epi16(m, v.m)); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sll16() const
+  {
+    return GSVector4i(_mm_slli_epi16(m, i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl16() const
+  {
+    return GSVector4i(_mm_srli_epi16(m, i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sra16() const
+  {
+    return GSVector4i(_mm_srai_epi16(m, i));
+  }
+
+  /// Interleaves the low/high four 16-bit lanes of this and v.
+  ALWAYS_INLINE GSVector4i upl16(const GSVector4i& v) const { return GSVector4i(_mm_unpacklo_epi16(m, v.m)); }
+  ALWAYS_INLINE GSVector4i uph16(const GSVector4i& v) const { return GSVector4i(_mm_unpackhi_epi16(m, v.m)); }
+
+  /// Multiplies signed 16-bit lanes, and adds adjacent pairs of the 32-bit products.
+  ALWAYS_INLINE GSVector4i madd_s16(const GSVector4i& v) const { return GSVector4i(_mm_madd_epi16(m, v.m)); }
+
+  ALWAYS_INLINE GSVector4i add32(const GSVector4i& v) const { return GSVector4i(_mm_add_epi32(m, v.m)); }
+  ALWAYS_INLINE GSVector4i sub32(const GSVector4i& v) const { return GSVector4i(_mm_sub_epi32(m, v.m)); }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sll32() const
+  {
+    return GSVector4i(_mm_slli_epi32(m, i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl32() const
+  {
+    return GSVector4i(_mm_srli_epi32(m, i));
+  }
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i sra32() const
+  {
+    return GSVector4i(_mm_srai_epi32(m, i));
+  }
+
+  ALWAYS_INLINE GSVector4i sll32(s32 i) const { return GSVector4i(_mm_sll_epi32(m, _mm_cvtsi32_si128(i))); }
+  ALWAYS_INLINE GSVector4i sra32(s32 i) const { return GSVector4i(_mm_sra_epi32(m, _mm_cvtsi32_si128(i))); }
+
+  ALWAYS_INLINE GSVector4i upl32(const GSVector4i& v) const { return GSVector4i(_mm_unpacklo_epi32(m, v.m)); }
+  ALWAYS_INLINE GSVector4i uph32(const GSVector4i& v) const { return GSVector4i(_mm_unpackhi_epi32(m, v.m)); }
+
+  /// Narrows the 32-bit lanes of this (low half) and v (high half) to 16 bits, with signed saturation.
+  ALWAYS_INLINE GSVector4i ps32(const GSVector4i& v) const { return GSVector4i(_mm_packs_epi32(m, v.m)); }
+
+  /// Sum of all four signed 32-bit lanes.
+  ALWAYS_INLINE s32 addv_s32() const
+  {
+    const __m128i pairs = _mm_add_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1))));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE GSVector4i srl64() const
+  {
+    return GSVector4i(_mm_srli_epi64(m, i));
+  }
+
+  ALWAYS_INLINE GSVector4i upl64(const GSVector4i& v) const { return GSVector4i(_mm_unpacklo_epi64(m, v.m)); }
+  ALWAYS_INLINE GSVector4i uph64(const GSVector4i& v) const { return GSVector4i(_mm_unpackhi_epi64(m, v.m)); }
+
+#ifdef CPU_ARCH_SSSE3
+  /// Selects bytes by the indices in mask. Negative indices produce zero.
+  ALWAYS_INLINE GSVector4i shuffle8(const GSVector4i& mask) const { return GSVector4i(_mm_shuffle_epi8(m, mask.m)); }
+#endif
+
+  template<s32 i>
+  ALWAYS_INLINE u16 extract16() const
+  {
+    return static_cast<u16>(_mm_extract_epi16(m, i));
+  }
+
+  template<s32 i>
+  ALWAYS_INLINE s32 extract32() const
+  {
+    return _mm_cvtsi128_si32(_mm_shuffle_epi32(m, _MM_SHUFFLE(i, i, i, i)));
+  }
+};
+
+class alignas(16) GSVector4
+{
+public:
+  __m128 m;
+
+  GSVector4() = default;
+
+  ALWAYS_INLINE explicit GSVector4(__m128 m_) : m(m_) {}
+
+  ALWAYS_INLINE GSVector4(float x, float y, float z, float w) : m(_mm_setr_ps(x, y, z, w)) {}
+
+  ALWAYS_INLINE static GSVector4 broadcast(float v) { return GSVector4(_mm_set1_ps(v)); }
+
+  template<bool aligned>
+  ALWAYS_INLINE static GSVector4 load(const float* p)
+  {
+    return GSVector4(aligned ? _mm_load_ps(p) : _mm_loadu_ps(p));
+  }
+
+  template<bool aligned>
+  ALWAYS_INLINE static void store(float* p, const GSVector4& v)
+  {
+    if constexpr (aligned)
+      _mm_store_ps(p, v.m);
+    else
+      _mm_storeu_ps(p, v.m);
+  }
+
+  /// Converts signed 32-bit lanes to float.
+  ALWAYS_INLINE static GSVector4 from_i32(const GSVector4i& v) { return GSVector4(_mm_cvtepi32_ps(v.m)); }
+
+  /// Converts to signed 32-bit lanes, truncating towards zero.
+  ALWAYS_INLINE GSVector4i to_i32_trunc() const { return GSVector4i(_mm_cvttps_epi32(m)); }
+
+  ALWAYS_INLINE GSVector4 operator+(const GSVector4& v) const { return GSVector4(_mm_add_ps(m, v.m)); }
+  ALWAYS_INLINE GSVector4 operator-(const GSVector4& v) const { return GSVector4(_mm_sub_ps(m, v.m)); }
+  ALWAYS_INLINE GSVector4 operator*(const GSVector4& v) const { return GSVector4(_mm_mul_ps(m, v.m)); }
+
+  /// Interleaves the low/high two lanes of this and v.
+  ALWAYS_INLINE GSVector4 upl(const GSVector4& v) const { return GSVector4(_mm_unpacklo_ps(m, v.m)); }
+  ALWAYS_INLINE GSVector4 uph(const GSVector4& v) const { return GSVector4(_mm_unpackhi_ps(m, v.m)); }
+
+  /// Combines the low/high halves of this and v, i.e. { this.lo, v.lo } and { this.hi, v.hi }.
+  ALWAYS_INLINE GSVector4 upld(const GSVector4& v) const { return GSVector4(_mm_movelh_ps(m, v.m)); }
+  ALWAYS_INLINE GSVector4 uphd(const GSVector4& v) const { return GSVector4(_mm_movehl_ps(v.m, m)); }
+};
@@ -13,6 +13,10 @@
 #if defined(CPU_ARCH_X86) || defined(CPU_ARCH_X64)
 #define CPU_ARCH_SSE 1
 #include <emmintrin.h>
+#if defined(__SSSE3__) || defined(__AVX__)
+#define CPU_ARCH_SSSE3 1
+#include <tmmintrin.h>
+#endif
 #elif defined(CPU_ARCH_ARM64)
 #define CPU_ARCH_NEON 1
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -76,3 +80,15 @@ ALWAYS_INLINE_RELEASE static void MemsetPtrs(T* ptr, T value, u32 count)
   for (u32 i = 0; i < remaining_count; i++)
     *(dest++) = value;
 }
+
+/// Hints to the CPU that the caller is busy-waiting, reducing power use and the penalty when the spin ends.
+ALWAYS_INLINE static void SpinPause()
+{
+#if defined(CPU_ARCH_SSE)
+  _mm_pause();
+#elif defined(CPU_ARCH_ARM64) && defined(_MSC_VER) && !defined(__clang__)
+  __yield();
+#elif defined(CPU_ARCH_ARM64) || defined(CPU_ARCH_ARM32)
+  __asm__ __volatile__("yield");
+#endif
+}
@@ -3,6 +3,7 @@
 
 #include "layered_settings_interface.h"
 #include "common/assert.h"
+#include "common/small_string.h"
 #include <unordered_set>
 
 LayeredSettingsInterface::LayeredSettingsInterface() = default;
@@ -24,102 +25,99 @@ bool LayeredSettingsInterface::IsEmpty()
   return false;
 }
 
-bool LayeredSettingsInterface::GetIntValue(const char* section, const char* key, s32* value) const
+LayeredSettingsInterface::LayerGenerations LayeredSettingsInterface::GetLayerGenerations() const
 {
+  LayerGenerations ret;
   for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
+    ret[layer] = m_layers[layer] ? m_layers[layer]->GetGeneration() : 0;
+  return ret;
+}
+
+template<typename T>
+bool LayeredSettingsInterface::GetCachedValue(const char* section, const char* key, T* value,
+                                              bool (SettingsInterface::*getter)(const char*, const char*, T*)
+                                                const) const
+{
+  std::unique_lock lock(m_cache_mutex);
+
+  // Generations are unique, so this also catches layers being swapped for another interface.
+  const LayerGenerations generations = GetLayerGenerations();
+  if (m_cache_generations != generations)
   {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetIntValue(section, key, value))
-        return true;
-    }
+    m_cache.clear();
+    m_cache_generations = generations;
   }
 
-  return false;
-}
+  // Neither sections nor keys can contain newlines.
+  SmallString cache_key;
+  cache_key.format("{}{}\n{}", CachedValue(std::in_place_type<T>).index(), section, key);
 
-bool LayeredSettingsInterface::GetUIntValue(const char* section, const char* key, u32* value) const
-{
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
+  auto it = m_cache.find(cache_key.view());
+  if (it == m_cache.end())
   {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
+    CachedValue resolved;
+    for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
     {
-      if (sif->GetUIntValue(section, key, value))
-        return true;
+      if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
+      {
+        T layer_value;
+        if ((sif->*getter)(section, key, &layer_value))
+        {
+          resolved.emplace<T>(std::move(layer_value));
+          break;
+        }
+      }
     }
+
+    it = m_cache.emplace(std::string(cache_key.view()), std::move(resolved)).first;
   }
 
-  return false;
+  const T* cached_value = std::get_if<T>(&it->second);
+  if (!cached_value)
+    return false;
+
+  *value = *cached_value;
+  return true;
 }
 
-bool LayeredSettingsInterface::GetFloatValue(const char* section, const char* key, float* value) const
+bool LayeredSettingsInterface::GetIntValue(const char* section, const char* key, s32* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetFloatValue(section, key, value))
-        return true;
-    }
-  }
+  return GetCachedValue(section, key, value, &SettingsInterface::GetIntValue);
+}
 
-  return false;
+bool LayeredSettingsInterface::GetUIntValue(const char* section, const char* key, u32* value) const
+{
+  return GetCachedValue(section, key, value, &SettingsInterface::GetUIntValue);
 }
 
-bool LayeredSettingsInterface::GetDoubleValue(const char* section, const char* key, double* value) const
+bool LayeredSettingsInterface::GetFloatValue(const char* section, const char* key, float* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetDoubleValue(section, key, value))
-        return true;
-    }
-  }
+  return GetCachedValue(section, key, value, &SettingsInterface::GetFloatValue);
+}
 
-  return false;
+bool LayeredSettingsInterface::GetDoubleValue(const char* section, const char* key, double* value) const
+{
+  return GetCachedValue(section, key, value, &SettingsInterface::GetDoubleValue);
 }
 
 bool LayeredSettingsInterface::GetBoolValue(const char* section, const char* key, bool* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetBoolValue(section, key, value))
-        return true;
-    }
-  }
-
-  return false;
+  return GetCachedValue(section, key, value, &SettingsInterface::GetBoolValue);
 }
 
 bool LayeredSettingsInterface::GetStringValue(const char* section, const char* key, std::string* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetStringValue(section, key, value))
-        return true;
-    }
-  }
-
-  return false;
+  return GetCachedValue(section, key, value, &SettingsInterface::GetStringValue);
 }
 
 bool LayeredSettingsInterface::GetStringValue(const char* section, const char* key, SmallStringBase* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetStringValue(section, key, value))
-        return true;
-    }
-  }
+  std::string str_value;
+  if (!GetCachedValue(section, key, &str_value, &SettingsInterface::GetStringValue))
+    return false;
 
-  return false;
+  value->assign(str_value);
+  return true;
 }
 
 void LayeredSettingsInterface::SetIntValue(const char* section, const char* key, int value)
@@ -2,8 +2,12 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #pragma once
+#include "heterogeneous_containers.h"
 #include "settings_interface.h"
+
 #include <array>
+#include <mutex>
+#include <variant>
 
 class LayeredSettingsInterface final : public SettingsInterface
 {
@@ -20,9 +24,15 @@ public:
   LayeredSettingsInterface();
   ~LayeredSettingsInterface() override;
 
+  using LayerGenerations = std::array<u64, NUM_LAYERS>;
+
   SettingsInterface* GetLayer(Layer layer) const { return m_layers[layer]; }
   void SetLayer(Layer layer, SettingsInterface* sif) { m_layers[layer] = sif; }
 
+  /// Returns the generation of every layer, or zero for empty layers. If this matches an earlier snapshot, lookups
+  /// will return the same values as they did at the time.
+  LayerGenerations GetLayerGenerations() const;
+
   bool Save(Error* error = nullptr) override;
 
   void Clear() override;
@@ -69,5 +79,17 @@ private:
   static constexpr Layer FIRST_LAYER = LAYER_CMDLINE;
   static constexpr Layer LAST_LAYER = LAYER_BASE;
 
+  using CachedValue = std::variant<std::monostate, s32, u32, float, double, bool, std::string>;
+
+  template<typename T>
+  bool GetCachedValue(const char* section, const char* key, T* value,
+                      bool (SettingsInterface::*getter)(const char*, const char*, T*) const) const;
+
   std::array<SettingsInterface*, NUM_LAYERS> m_layers{};
+
+  // Resolved values of typed lookups, discarded whenever a layer is changed or modified.
+  // Keyed by value type, section and key, since a value can fail to parse as one type but not another.
+  mutable std::mutex m_cache_mutex;
+  mutable LayerGenerations m_cache_generations{};
+  mutable PreferUnorderedStringMap<CachedValue> m_cache;
 };
\ No newline at end of file
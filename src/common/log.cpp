@@ -5,12 +5,20 @@
 #include "assert.h"
 #include "file_system.h"
 #include "small_string.h"
+#include "threading.h"
 #include "timer.h"
 
 #include "fmt/format.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -30,6 +38,35 @@ struct RegisteredCallback
   Log::CallbackFunctionType Function;
   void* Parameter;
 };
+
+struct QueuedMessage
+{
+  Common::Timer::Value timestamp;
+  const char* channel_name;
+  const char* function_name;
+  LOGLEVEL level;
+
+  // Keeps its capacity when the slot is reused, so queueing doesn't allocate once the queue has warmed up.
+  std::string message;
+};
+
+// Ring of messages written by the owning thread and read by the logger thread, without any locking.
+struct ThreadMessageQueue
+{
+  static constexpr u32 CAPACITY = 1024;
+
+  std::array<QueuedMessage, CAPACITY> messages;
+  std::atomic<u32> head{0};
+  std::atomic<u32> tail{0};
+  std::atomic_bool abandoned{false};
+};
+
+struct ThreadMessageQueueHolder
+{
+  ~ThreadMessageQueueHolder();
+
+  std::shared_ptr<ThreadMessageQueue> queue;
+};
 } // namespace
 
 static void RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam,
@@ -58,6 +95,13 @@ static void FormatLogMessageAndPrintW(const char* channelName, const char* funct
                                       std::string_view message, bool timestamp, bool ansi_color_code, bool newline,
                                       const T& callback);
 #endif
+static bool ShouldQueueMessage(LOGLEVEL level);
+static ThreadMessageQueue* GetThreadMessageQueue();
+template<typename T>
+static void QueueMessage(const char* channelName, const char* functionName, LOGLEVEL level, const T& format_message);
+static void WakeAsyncThread();
+static void DrainMessageQueues(const std::vector<std::shared_ptr<ThreadMessageQueue>>& queues);
+static void AsyncThreadEntryPoint();
 
 static const char s_log_level_characters[LOGLEVEL_COUNT] = {'X', 'E', 'W', 'P', 'I', 'V', 'D', 'R', 'B', 'T'};
 
@@ -74,6 +118,26 @@ static bool s_file_output_enabled = false;
 static bool s_file_output_timestamp = false;
 static bool s_debug_output_enabled = false;
 
+static constexpr std::chrono::milliseconds ASYNC_OUTPUT_INTERVAL{10};
+
+static std::atomic_bool s_async_output_enabled{false};
+static std::atomic_bool s_async_wake{false};
+static std::mutex s_async_mutex;
+static std::condition_variable s_async_cv;
+static std::condition_variable s_async_flush_cv;
+static std::thread s_async_thread;
+static std::vector<std::shared_ptr<ThreadMessageQueue>> s_async_queues;
+static u64 s_async_flush_request = 0;
+static u64 s_async_flush_done = 0;
+static bool s_async_shutdown = false;
+static bool s_async_atexit_registered = false;
+
+static thread_local ThreadMessageQueueHolder s_thread_queue;
+static thread_local bool s_is_logger_thread = false;
+
+// Set while the logger thread delivers a message, so callbacks see the time it was written, not the time it arrived.
+static thread_local Common::Timer::Value s_current_message_timestamp = 0;
+
 #ifdef _WIN32
 static HANDLE s_hConsoleStdIn = NULL;
 static HANDLE s_hConsoleStdOut = NULL;
@@ -125,7 +189,9 @@ void Log::UnregisterCallback(CallbackFunctionType callbackFunction, void* pUserP
 
 float Log::GetCurrentMessageTime()
 {
-  return static_cast<float>(Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - s_start_timestamp));
+  const Common::Timer::Value timestamp =
+    (s_current_message_timestamp != 0) ? s_current_message_timestamp : Common::Timer::GetCurrentValue();
+  return static_cast<float>(Common::Timer::ConvertValueToSeconds(timestamp - s_start_timestamp));
 }
 
 bool Log::IsConsoleOutputEnabled()
@@ -420,6 +486,10 @@ void Log::FileOutputLogCallback(void* pUserParam, const char* channelName, const
 
 void Log::SetFileOutputParams(bool enabled, const char* filename, bool timestamps /* = true */)
 {
+  // Don't lose anything still queued for the file.
+  if (!enabled)
+    Flush();
+
   std::unique_lock lock(s_callback_mutex);
   if (s_file_output_enabled == enabled)
     return;
@@ -446,6 +516,224 @@ void Log::SetFileOutputParams(bool enabled, const char* filename, bool timestamp
   s_file_output_timestamp = timestamps;
 }
 
+Log::ThreadMessageQueueHolder::~ThreadMessageQueueHolder()
+{
+  // The logger thread removes the queue once it has been drained.
+  if (queue)
+    queue->abandoned.store(true, std::memory_order_release);
+}
+
+bool Log::IsAsyncOutputEnabled()
+{
+  return s_async_output_enabled.load(std::memory_order_relaxed);
+}
+
+void Log::SetAsyncOutput(bool enabled)
+{
+  std::unique_lock lock(s_async_mutex);
+  if (s_async_thread.joinable() == enabled)
+    return;
+
+  if (enabled)
+  {
+    s_async_shutdown = false;
+    s_async_thread = std::thread(&AsyncThreadEntryPoint);
+    s_async_output_enabled.store(true, std::memory_order_release);
+
+    // The thread has to be gone before statics are destroyed.
+    if (!s_async_atexit_registered)
+    {
+      s_async_atexit_registered = true;
+      std::atexit([]() { SetAsyncOutput(false); });
+    }
+  }
+  else
+  {
+    s_async_output_enabled.store(false, std::memory_order_release);
+    s_async_shutdown = true;
+    s_async_cv.notify_one();
+    lock.unlock();
+    s_async_thread.join();
+
+    // Deliver anything which was queued after the thread's last pass. Nothing else reads the queues now.
+    lock.lock();
+    const std::vector<std::shared_ptr<ThreadMessageQueue>> queues = s_async_queues;
+    lock.unlock();
+    DrainMessageQueues(queues);
+  }
+}
+
+void Log::Flush()
+{
+  if (s_is_logger_thread)
+    return;
+
+  std::unique_lock lock(s_async_mutex);
+  if (!s_async_thread.joinable() || s_async_shutdown)
+    return;
+
+  const u64 request = ++s_async_flush_request;
+  s_async_wake.store(true, std::memory_order_relaxed);
+  s_async_cv.notify_one();
+  s_async_flush_cv.wait(lock, [request]() { return (s_async_flush_done >= request); });
+}
+
+ALWAYS_INLINE_RELEASE bool Log::ShouldQueueMessage(LOGLEVEL level)
+{
+  // Messages written by callbacks on the logger thread can't wait for it.
+  return (s_async_output_enabled.load(std::memory_order_relaxed) && !s_is_logger_thread && level <= s_log_level);
+}
+
+Log::ThreadMessageQueue* Log::GetThreadMessageQueue()
+{
+  if (!s_thread_queue.queue) [[unlikely]]
+  {
+    s_thread_queue.queue = std::make_shared<ThreadMessageQueue>();
+
+    std::unique_lock lock(s_async_mutex);
+    s_async_queues.push_back(s_thread_queue.queue);
+  }
+
+  return s_thread_queue.queue.get();
+}
+
+template<typename T>
+void Log::QueueMessage(const char* channelName, const char* functionName, LOGLEVEL level, const T& format_message)
+{
+  ThreadMessageQueue* queue = GetThreadMessageQueue();
+  const u32 head = queue->head.load(std::memory_order_relaxed);
+
+  // Only this thread writes to the queue, so the slot can't be taken once there's room.
+  while ((head - queue->tail.load(std::memory_order_acquire)) == ThreadMessageQueue::CAPACITY) [[unlikely]]
+  {
+    WakeAsyncThread();
+    std::this_thread::yield();
+  }
+
+  QueuedMessage& msg = queue->messages[head % ThreadMessageQueue::CAPACITY];
+  msg.timestamp = Common::Timer::GetCurrentValue();
+  msg.channel_name = channelName;
+  msg.function_name = functionName;
+  msg.level = level;
+  msg.message.clear();
+  format_message(msg.message);
+  queue->head.store(head + 1, std::memory_order_release);
+
+  // Otherwise the thread picks it up on its next pass. Errors and warnings go out straight away.
+  if (level <= LOGLEVEL_WARNING ||
+      (head + 1 - queue->tail.load(std::memory_order_relaxed)) >= (ThreadMessageQueue::CAPACITY / 2))
+  {
+    WakeAsyncThread();
+  }
+}
+
+void Log::WakeAsyncThread()
+{
+  // Not holding the mutex means the notification can be missed, but then the thread's wait times out.
+  if (!s_async_wake.exchange(true, std::memory_order_relaxed))
+    s_async_cv.notify_one();
+}
+
+void Log::DrainMessageQueues(const std::vector<std::shared_ptr<ThreadMessageQueue>>& queues)
+{
+  struct PendingRange
+  {
+    ThreadMessageQueue* queue;
+    u32 tail;
+    u32 head;
+  };
+
+  std::vector<PendingRange> ranges;
+  for (const std::shared_ptr<ThreadMessageQueue>& queue : queues)
+  {
+    const u32 tail = queue->tail.load(std::memory_order_relaxed);
+    const u32 head = queue->head.load(std::memory_order_acquire);
+    if (tail != head)
+      ranges.push_back(PendingRange{queue.get(), tail, head});
+  }
+
+  if (ranges.empty())
+    return;
+
+  // Messages from different threads are interleaved by the time they were written.
+  std::unique_lock lock(s_callback_mutex);
+  while (!ranges.empty())
+  {
+    size_t next = 0;
+    for (size_t i = 1; i < ranges.size(); i++)
+    {
+      if (ranges[i].queue->messages[ranges[i].tail % ThreadMessageQueue::CAPACITY].timestamp <
+          ranges[next].queue->messages[ranges[next].tail % ThreadMessageQueue::CAPACITY].timestamp)
+      {
+        next = i;
+      }
+    }
+
+    PendingRange& range = ranges[next];
+    const QueuedMessage& msg = range.queue->messages[range.tail % ThreadMessageQueue::CAPACITY];
+    if (FilterTest(msg.level, msg.channel_name, lock))
+    {
+      s_current_message_timestamp = msg.timestamp;
+      ExecuteCallbacks(msg.channel_name, msg.function_name, msg.level, msg.message, lock);
+    }
+
+    // Hands the slot back to the writer.
+    range.tail++;
+    range.queue->tail.store(range.tail, std::memory_order_release);
+    if (range.tail == range.head)
+    {
+      range = ranges.back();
+      ranges.pop_back();
+    }
+  }
+
+  s_current_message_timestamp = 0;
+}
+
+void Log::AsyncThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Log Output");
+  s_is_logger_thread = true;
+
+  std::vector<std::shared_ptr<ThreadMessageQueue>> queues;
+  std::unique_lock lock(s_async_mutex);
+  for (;;)
+  {
+    s_async_cv.wait_for(lock, ASYNC_OUTPUT_INTERVAL,
+                        []() { return (s_async_shutdown || s_async_wake.load(std::memory_order_relaxed)); });
+    s_async_wake.store(false, std::memory_order_relaxed);
+
+    const bool shutdown = s_async_shutdown;
+    const u64 flush_request = s_async_flush_request;
+    queues = s_async_queues;
+    lock.unlock();
+
+    DrainMessageQueues(queues);
+
+    lock.lock();
+
+    // Threads which have exited won't write anything more.
+    for (auto it = s_async_queues.begin(); it != s_async_queues.end();)
+    {
+      ThreadMessageQueue* queue = it->get();
+      if (queue->abandoned.load(std::memory_order_acquire) &&
+          queue->head.load(std::memory_order_acquire) == queue->tail.load(std::memory_order_relaxed))
+      {
+        it = s_async_queues.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    s_async_flush_done = flush_request;
+    s_async_flush_cv.notify_all();
+    if (shutdown)
+      break;
+  }
+}
+
 LOGLEVEL Log::GetLogLevel()
 {
   return s_log_level;
@@ -482,6 +770,12 @@ ALWAYS_INLINE_RELEASE bool Log::FilterTest(LOGLEVEL level, const char* channelNa
 
 void Log::Write(const char* channelName, const char* functionName, LOGLEVEL level, std::string_view message)
 {
+  if (ShouldQueueMessage(level))
+  {
+    QueueMessage(channelName, functionName, level, [message](std::string& str) { str.append(message); });
+    return;
+  }
+
   std::unique_lock lock(s_callback_mutex);
   if (!FilterTest(level, channelName, lock))
     return;
@@ -499,6 +793,24 @@ void Log::Writef(const char* channelName, const char* functionName, LOGLEVEL lev
 
 void Log::Writev(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, va_list ap)
 {
+  if (ShouldQueueMessage(level))
+  {
+    QueueMessage(channelName, functionName, level, [format, &ap](std::string& str) {
+      std::va_list apCopy;
+      va_copy(apCopy, ap);
+      const int len = std::vsnprintf(nullptr, 0, format, apCopy);
+      va_end(apCopy);
+      if (len <= 0)
+        return;
+
+      va_copy(apCopy, ap);
+      str.resize(static_cast<size_t>(len));
+      std::vsnprintf(str.data(), str.size() + 1, format, apCopy);
+      va_end(apCopy);
+    });
+    return;
+  }
+
   std::unique_lock lock(s_callback_mutex);
   if (!FilterTest(level, channelName, lock))
     return;
@@ -533,6 +845,13 @@ void Log::Writev(const char* channelName, const char* functionName, LOGLEVEL lev
 void Log::WriteFmtArgs(const char* channelName, const char* functionName, LOGLEVEL level, fmt::string_view fmt,
                        fmt::format_args args)
 {
+  if (ShouldQueueMessage(level))
+  {
+    QueueMessage(channelName, functionName, level,
+                 [fmt, &args](std::string& str) { fmt::vformat_to(std::back_inserter(str), fmt, args); });
+    return;
+  }
+
   std::unique_lock lock(s_callback_mutex);
   if (!FilterTest(level, channelName, lock))
     return;
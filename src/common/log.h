@@ -52,6 +52,15 @@ void SetDebugOutputParams(bool enabled);
 // adds a file output
 void SetFileOutputParams(bool enabled, const char* filename, bool timestamps = true);
 
+// Moves delivery of messages to a logger thread. Messages are still formatted on the calling thread, but are then
+// put in a queue owned by that thread, so writing a message never blocks on the outputs. Callbacks are called from the
+// logger thread while this is enabled.
+bool IsAsyncOutputEnabled();
+void SetAsyncOutput(bool enabled);
+
+// Waits until all queued messages have been delivered to the callbacks.
+void Flush();
+
 // Returns the current global filtering level.
 LOGLEVEL GetLogLevel();
 
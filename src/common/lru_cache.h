@@ -1,41 +1,67 @@
-// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #pragma once
 #include "heterogeneous_containers.h"
 #include <cstdint>
-#include <map>
-
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+/// Least-recently-used cache. Items are kept in a hash map, with an intrusive list threaded through the map nodes
+/// tracking access order, so lookups, insertions and evictions are all constant time.
+///
+/// Capacity is measured in weight units. Items weigh one unit unless a weight is passed to Insert(), so caches of
+/// variable-sized objects (e.g. textures) can be bounded by bytes instead of count.
 template<class K, class V>
 class LRUCache
 {
-  using CounterType = std::uint64_t;
-
   struct Item
   {
     V value;
-    CounterType last_access;
+    std::size_t weight;
+
+    // Nodes in the map never move, so the list can point straight at them.
+    const K* key;
+    Item* prev;
+    Item* next;
   };
 
-  using MapType = std::conditional_t<std::is_same_v<K, std::string>, StringMap<Item>, std::map<K, Item>>;
+  using MapType = std::conditional_t<std::is_same_v<K, std::string>, PreferUnorderedStringMap<Item>,
+                                     std::unordered_map<K, Item>>;
 
 public:
+  /// Called with each item removed to make space, before it is destroyed. Not called for Remove() or Clear().
+  using EvictionCallback = std::function<void(const K& key, V& value)>;
+
   LRUCache(std::size_t max_capacity = 16, bool manual_evict = false)
     : m_max_capacity(max_capacity), m_manual_evict(manual_evict)
   {
   }
   ~LRUCache() = default;
 
+  LRUCache(const LRUCache&) = delete;
+  LRUCache& operator=(const LRUCache&) = delete;
+
   std::size_t GetSize() const { return m_items.size(); }
+  std::size_t GetWeight() const { return m_weight; }
   std::size_t GetMaxCapacity() const { return m_max_capacity; }
 
-  void Clear() { m_items.clear(); }
+  void SetEvictionCallback(EvictionCallback callback) { m_eviction_callback = std::move(callback); }
+
+  void Clear()
+  {
+    m_items.clear();
+    m_head = nullptr;
+    m_tail = nullptr;
+    m_weight = 0;
+  }
 
   void SetMaxCapacity(std::size_t capacity)
   {
     m_max_capacity = capacity;
-    if (m_items.size() > m_max_capacity)
-      Evict(m_items.size() - m_max_capacity);
+    if (!m_manual_evict)
+      ManualEvict();
   }
 
   template<typename KeyT>
@@ -45,42 +71,42 @@ public:
     if (iter == m_items.end())
       return nullptr;
 
-    iter->second.last_access = ++m_last_counter;
+    MoveToFront(&iter->second);
     return &iter->second.value;
   }
 
-  V* Insert(K key, V value)
+  V* Insert(K key, V value, std::size_t weight = 1)
   {
-    ShrinkForNewItem();
-
     auto iter = m_items.find(key);
     if (iter != m_items.end())
     {
-      iter->second.value = std::move(value);
-      iter->second.last_access = ++m_last_counter;
-      return &iter->second.value;
-    }
-    else
-    {
-      Item it;
-      it.last_access = ++m_last_counter;
-      it.value = std::move(value);
-      auto ip = m_items.emplace(std::move(key), std::move(it));
-      return &ip.first->second.value;
+      Item& item = iter->second;
+      item.value = std::move(value);
+      m_weight = m_weight - item.weight + weight;
+      item.weight = weight;
+      MoveToFront(&item);
+      if (!m_manual_evict)
+        EvictToCapacity(&item);
+      return &item.value;
     }
+
+    if (!m_manual_evict)
+      ShrinkForNewItem(weight);
+
+    auto ip = m_items.emplace(std::move(key), Item{std::move(value), weight, nullptr, nullptr, nullptr});
+    Item& item = ip.first->second;
+    item.key = &ip.first->first;
+    m_weight += weight;
+    LinkAtFront(&item);
+    return &item.value;
   }
 
+  /// Evicts the count least recently used items.
   void Evict(std::size_t count = 1)
   {
-    while (!m_items.empty() && count > 0)
+    while (m_tail && count > 0)
     {
-      typename MapType::iterator lowest = m_items.end();
-      for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
-      {
-        if (lowest == m_items.end() || iter->second.last_access < lowest->second.last_access)
-          lowest = iter;
-      }
-      m_items.erase(lowest);
+      EvictTail();
       count--;
     }
   }
@@ -91,33 +117,83 @@ public:
     auto iter = m_items.find(key);
     if (iter == m_items.end())
       return false;
+
+    Unlink(&iter->second);
+    m_weight -= iter->second.weight;
     m_items.erase(iter);
     return true;
   }
+
+  /// While manual eviction is enabled, inserting never evicts, so pointers returned by Lookup() and Insert() stay
+  /// valid until ManualEvict() is called.
   void SetManualEvict(bool block)
   {
     m_manual_evict = block;
     if (!m_manual_evict)
       ManualEvict();
   }
-  void ManualEvict()
+  void ManualEvict() { EvictToCapacity(nullptr); }
+
+private:
+  void ShrinkForNewItem(std::size_t weight)
   {
-    // evict if we went over
-    while (m_items.size() > m_max_capacity)
-      Evict(m_items.size() - m_max_capacity);
+    while (m_tail && (m_weight + weight) > m_max_capacity)
+      EvictTail();
   }
 
-private:
-  void ShrinkForNewItem()
+  // Never evicts keep, so a just-inserted item survives even if it alone is over capacity.
+  void EvictToCapacity(const Item* keep)
+  {
+    while (m_weight > m_max_capacity && m_tail && m_tail != keep)
+      EvictTail();
+  }
+
+  void EvictTail()
+  {
+    Item* item = m_tail;
+    Unlink(item);
+    m_weight -= item->weight;
+
+    // Find the node before calling back, in case the callback looks at the cache.
+    auto iter = m_items.find(*item->key);
+    if (m_eviction_callback)
+      m_eviction_callback(iter->first, item->value);
+    m_items.erase(iter);
+  }
+
+  void LinkAtFront(Item* item)
+  {
+    item->prev = nullptr;
+    item->next = m_head;
+    if (m_head)
+      m_head->prev = item;
+    else
+      m_tail = item;
+    m_head = item;
+  }
+
+  void Unlink(Item* item)
+  {
+    (item->prev ? item->prev->next : m_head) = item->next;
+    (item->next ? item->next->prev : m_tail) = item->prev;
+    item->prev = nullptr;
+    item->next = nullptr;
+  }
+
+  void MoveToFront(Item* item)
   {
-    if (m_items.size() < m_max_capacity)
+    if (m_head == item)
       return;
 
-    Evict(m_items.size() - (m_max_capacity - 1));
+    Unlink(item);
+    LinkAtFront(item);
   }
 
   MapType m_items;
-  CounterType m_last_counter = 0;
+  EvictionCallback m_eviction_callback;
+  Item* m_head = nullptr; // most recently used
+  Item* m_tail = nullptr; // least recently used
+  std::size_t m_weight = 0;
   std::size_t m_max_capacity = 0;
   bool m_manual_evict = false;
-};
\ No newline at end of file
+};
@@ -13,7 +13,8 @@
 
 #if defined(_WIN32)
 #include "windows_headers.h"
-#elif !defined(__ANDROID__)
+#include <io.h>
+#else
 #include <cerrno>
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -446,3 +447,139 @@ void MemMap::EndCodeWrite()
 }
 
 #endif
+
+#ifdef _WIN32
+
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  const HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  const HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping)
+  {
+    Error::SetWin32(error, "CreateFileMappingW() failed: ", GetLastError());
+    return nullptr;
+  }
+
+  // The view holds a reference to the mapping.
+  const void* ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  if (!ret)
+    Error::SetWin32(error, "MapViewOfFile() failed: ", GetLastError());
+
+  CloseHandle(mapping);
+  return ret;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  UnmapViewOfFile(ptr);
+}
+
+void MemMap::PrefetchMappedRange(const void* ptr, size_t size)
+{
+  WIN32_MEMORY_RANGE_ENTRY range = {const_cast<void*>(ptr), size};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void* MemMap::AllocateZeroedMemory(size_t size, Error* error)
+{
+  void* ret = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  if (!ret)
+    Error::SetWin32(error, "VirtualAlloc() failed: ", GetLastError());
+
+  return ret;
+}
+
+void MemMap::FreeZeroedMemory(void* ptr, size_t size)
+{
+  VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+void MemMap::DiscardMemory(void* ptr, size_t size)
+{
+  // Pages are zeroed when they're committed again, which only happens on first touch.
+  if (!VirtualFree(ptr, size, MEM_DECOMMIT) || !VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE))
+    Panic("Failed to discard memory");
+}
+
+bool MemMap::AdviseHugePages(void* ptr, size_t size)
+{
+  // Large pages have to be requested at allocation time with SeLockMemoryPrivilege, and can't be used for views of
+  // placeholders, which is how the shared memory is mapped.
+  return false;
+}
+
+#else
+
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  void* ret = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+  if (ret == MAP_FAILED)
+  {
+    Error::SetErrno(error, "mmap() failed: ", errno);
+    return nullptr;
+  }
+
+  return ret;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  munmap(const_cast<void*>(ptr), size);
+}
+
+void MemMap::PrefetchMappedRange(const void* ptr, size_t size)
+{
+  // madvise() needs a page-aligned start.
+  const uintptr_t start = reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(HOST_PAGE_MASK);
+  const uintptr_t end = reinterpret_cast<uintptr_t>(ptr) + size;
+  madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
+}
+
+void* MemMap::AllocateZeroedMemory(size_t size, Error* error)
+{
+  void* ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ret == MAP_FAILED)
+  {
+    Error::SetErrno(error, "mmap() failed: ", errno);
+    return nullptr;
+  }
+
+  return ret;
+}
+
+void MemMap::FreeZeroedMemory(void* ptr, size_t size)
+{
+  munmap(ptr, size);
+}
+
+void MemMap::DiscardMemory(void* ptr, size_t size)
+{
+  // Replacing the mapping gives zero pages everywhere, MADV_DONTNEED only guarantees that on Linux.
+  if (mmap(ptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+    Panic("Failed to discard memory");
+}
+
+bool MemMap::AdviseHugePages(void* ptr, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Transparent huge pages are PMD-sized, only ranges covering an entire one can use it.
+  static constexpr uintptr_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+  const uintptr_t start = Common::AlignUpPow2(reinterpret_cast<uintptr_t>(ptr), HUGE_PAGE_SIZE);
+  const uintptr_t end = Common::AlignDownPow2(reinterpret_cast<uintptr_t>(ptr) + size, HUGE_PAGE_SIZE);
+  if (start >= end)
+    return false;
+
+  if (madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE) != 0)
+  {
+    Log_WarningFmt("madvise(MADV_HUGEPAGE) for {} bytes at {} failed: {}", end - start, reinterpret_cast<void*>(start),
+                   errno);
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "types.h"
 
+#include <cstdio>
 #include <map>
 #include <string>
 
@@ -44,6 +45,26 @@ void* MapSharedMemory(void* handle, size_t offset, void* baseaddr, size_t size,
 void UnmapSharedMemory(void* baseaddr, size_t size);
 bool MemProtect(void* baseaddr, size_t size, PageProtect mode);
 
+/// Maps the first size bytes of an open file into memory, read-only. The file can be closed afterwards.
+const void* MapFileReadOnly(std::FILE* fp, size_t size, Error* error);
+void UnmapFile(const void* ptr, size_t size);
+
+/// Hints that a range of a mapped file will be read soon, so the OS can start paging it in.
+void PrefetchMappedRange(const void* ptr, size_t size);
+
+/// Allocates zero-filled, read-write memory directly from the OS. Physical pages are only assigned when each is first
+/// touched, so large allocations which are sparsely used stay cheap.
+void* AllocateZeroedMemory(size_t size, Error* error);
+void FreeZeroedMemory(void* ptr, size_t size);
+
+/// Returns the pages in a range from AllocateZeroedMemory() to the OS, so they read back as zero. Much cheaper than
+/// clearing a large range which is mostly untouched. The range must be page-aligned.
+void DiscardMemory(void* ptr, size_t size);
+
+/// Asks the OS to back the whole huge pages within a range with huge pages, to reduce TLB misses. Returns false if
+/// huge pages aren't supported, in which case the range keeps using normal pages.
+bool AdviseHugePages(void* ptr, size_t size);
+
 /// JIT write protect for Apple Silicon. Needs to be called prior to writing to any RWX pages.
 #if !defined(__APPLE__) || !defined(__aarch64__)
 // clang-format off
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "memory_accounting.h"
+#include "assert.h"
+
+#include <array>
+#include <atomic>
+
+namespace MemoryAccounting {
+static constexpr size_t NUM_CATEGORIES = static_cast<size_t>(Category::Count);
+
+static constexpr std::array<const char*, NUM_CATEGORIES> s_category_names = {{
+  "Emulated Memory",
+  "Fastmem LUT",
+  "Code Cache",
+  "PGXP",
+  "Rewind",
+  "CD Image Precache",
+  "Texture Replacements",
+  "Shader Cache",
+  "GPU Texture Pool",
+  "GPU Textures",
+  "VRAM Snapshots",
+}};
+
+static std::array<std::atomic<size_t>, NUM_CATEGORIES> s_host_bytes = {};
+static std::array<std::atomic<size_t>, NUM_CATEGORIES> s_gpu_bytes = {};
+} // namespace MemoryAccounting
+
+const char* MemoryAccounting::GetCategoryName(Category category)
+{
+  return s_category_names[static_cast<size_t>(category)];
+}
+
+void MemoryAccounting::SetHostBytes(Category category, size_t bytes)
+{
+  s_host_bytes[static_cast<size_t>(category)].store(bytes, std::memory_order_relaxed);
+}
+
+void MemoryAccounting::AddHostBytes(Category category, size_t bytes)
+{
+  s_host_bytes[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryAccounting::SubtractHostBytes(Category category, size_t bytes)
+{
+  [[maybe_unused]] const size_t prev =
+    s_host_bytes[static_cast<size_t>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+  DebugAssert(prev >= bytes);
+}
+
+void MemoryAccounting::SetGPUBytes(Category category, size_t bytes)
+{
+  s_gpu_bytes[static_cast<size_t>(category)].store(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryAccounting::GetHostBytes(Category category)
+{
+  return s_host_bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryAccounting::GetGPUBytes(Category category)
+{
+  return s_gpu_bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryAccounting::GetTotalHostBytes()
+{
+  size_t total = 0;
+  for (const std::atomic<size_t>& bytes : s_host_bytes)
+    total += bytes.load(std::memory_order_relaxed);
+  return total;
+}
+
+size_t MemoryAccounting::GetTotalGPUBytes()
+{
+  size_t total = 0;
+  for (const std::atomic<size_t>& bytes : s_gpu_bytes)
+    total += bytes.load(std::memory_order_relaxed);
+  return total;
+}
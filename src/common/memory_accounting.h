@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <cstddef>
+
+/// Tracks how much host and GPU memory each subsystem has allocated. Subsystems update their totals when they
+/// allocate or free, and the totals can be read from any thread. Reserved-but-untouched memory counts in full.
+namespace MemoryAccounting {
+
+enum class Category : u8
+{
+  EmulatedMemory,
+  FastmemLUT,
+  CodeCache,
+  PGXP,
+  Rewind,
+  CDImagePrecache,
+  TextureReplacements,
+  ShaderCache,
+  GPUTexturePool,
+  GPUTextures,
+  VRAMSnapshots,
+
+  Count
+};
+
+const char* GetCategoryName(Category category);
+
+void SetHostBytes(Category category, size_t bytes);
+void AddHostBytes(Category category, size_t bytes);
+void SubtractHostBytes(Category category, size_t bytes);
+void SetGPUBytes(Category category, size_t bytes);
+
+size_t GetHostBytes(Category category);
+size_t GetGPUBytes(Category category);
+size_t GetTotalHostBytes();
+size_t GetTotalGPUBytes();
+
+} // namespace MemoryAccounting
@@ -20,6 +20,7 @@ bool MemorySettingsInterface::Save(Error* error /* = nullptr */)
 void MemorySettingsInterface::Clear()
 {
   m_sections.clear();
+  UpdateGeneration();
 }
 
 bool MemorySettingsInterface::IsEmpty()
@@ -194,10 +195,14 @@ void MemorySettingsInterface::SetKeyValueList(const char* section,
   sit->second.clear();
   for (const auto& [key, value] : items)
     sit->second.emplace(key, value);
+
+  UpdateGeneration();
 }
 
 void MemorySettingsInterface::SetValue(const char* section, const char* key, std::string value)
 {
+  UpdateGeneration();
+
   auto sit = m_sections.find(section);
   if (sit == m_sections.end())
     sit = m_sections.emplace(std::make_pair(std::string(section), KeyMap())).first;
@@ -249,6 +254,8 @@ void MemorySettingsInterface::SetStringList(const char* section, const char* key
   std::string_view keysv(key);
   for (const std::string& value : items)
     sit->second.emplace(keysv, value);
+
+  UpdateGeneration();
 }
 
 bool MemorySettingsInterface::RemoveFromStringList(const char* section, const char* key, const char* item)
@@ -264,6 +271,7 @@ bool MemorySettingsInterface::RemoveFromStringList(const char* section, const ch
     if (iter->second == item)
     {
       sit->second.erase(iter++);
+      UpdateGeneration();
       result = true;
     }
     else
@@ -289,6 +297,7 @@ bool MemorySettingsInterface::AddToStringList(const char* section, const char* k
   }
 
   sit->second.emplace(std::string(key), std::string(item));
+  UpdateGeneration();
   return true;
 }
 
@@ -310,6 +319,8 @@ void MemorySettingsInterface::DeleteValue(const char* section, const char* key)
   const auto range = sit->second.equal_range(key);
   for (auto iter = range.first; iter != range.second;)
     sit->second.erase(iter++);
+
+  UpdateGeneration();
 }
 
 void MemorySettingsInterface::ClearSection(const char* section)
@@ -319,6 +330,7 @@ void MemorySettingsInterface::ClearSection(const char* section)
     return;
 
   m_sections.erase(sit);
+  UpdateGeneration();
 }
 
 void MemorySettingsInterface::RemoveSection(const char* section)
@@ -328,6 +340,7 @@ void MemorySettingsInterface::RemoveSection(const char* section)
     return;
 
   m_sections.erase(sit);
+  UpdateGeneration();
 }
 
 void MemorySettingsInterface::RemoveEmptySections()
@@ -341,5 +354,6 @@ void MemorySettingsInterface::RemoveEmptySections()
     }
 
     sit = m_sections.erase(sit);
+    UpdateGeneration();
   }
 }
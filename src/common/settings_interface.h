@@ -6,6 +6,7 @@
 #include "small_string.h"
 #include "types.h"
 
+#include <atomic>
 #include <optional>
 #include <string>
 #include <vector>
@@ -15,8 +16,13 @@ class Error;
 class SettingsInterface
 {
 public:
+  SettingsInterface() : m_generation(GetNextGeneration()) {}
   virtual ~SettingsInterface() = default;
 
+  /// Returns a value which changes every time the contents of the interface are modified. Values are unique across
+  /// all interfaces, so a new interface never has the same generation as one it replaces.
+  ALWAYS_INLINE u64 GetGeneration() const { return m_generation; }
+
   virtual bool Save(Error* error = nullptr) = 0;
   virtual void Clear() = 0;
   virtual bool IsEmpty() = 0;
@@ -267,4 +273,17 @@ public:
     else
       DeleteValue(section, key);
   }
+
+protected:
+  /// Should be called by implementations whenever a value is changed.
+  ALWAYS_INLINE void UpdateGeneration() { m_generation = GetNextGeneration(); }
+
+private:
+  static u64 GetNextGeneration()
+  {
+    static std::atomic<u64> s_next_generation{1};
+    return s_next_generation.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  u64 m_generation;
 };
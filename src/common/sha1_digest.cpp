@@ -1,6 +1,24 @@
 #include "sha1_digest.h"
+#include "intrin.h"
+
 #include <cstring>
 
+#if defined(CPU_ARCH_X64) || defined(CPU_ARCH_X86)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(CPU_ARCH_ARM64)
+#if defined(_WIN32)
+#include "windows_headers.h"
+#elif defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
 // mostly based on this implementation (public domain): https://gist.github.com/jrabbit/1042021
 #define rol(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
 
@@ -67,6 +85,217 @@ static void SHA1Transform(u32 state[5], const unsigned char buffer[64])
   state[4] += e;
 }
 
+static void SHA1TransformBlocksScalar(u32 state[5], const u8* data, u32 num_blocks)
+{
+  for (; num_blocks > 0; num_blocks--, data += 64)
+    SHA1Transform(state, data);
+}
+
+// The hardware paths are compiled for the extension regardless of the build's baseline, and only picked if the CPU
+// has it. They're several times faster than the scalar transform, which matters when hashing whole files.
+#if defined(CPU_ARCH_X64) || defined(CPU_ARCH_X86)
+
+#ifdef _MSC_VER
+#define SHA1_NI_TARGET
+#else
+#define SHA1_NI_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+#endif
+
+static bool CPUHasSHA1Extensions()
+{
+  // SHA is leaf 7 EBX bit 29, the shuffles need SSSE3 and the extract SSE4.1.
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7)
+    return false;
+  __cpuid(regs, 1);
+  const bool has_sse = ((regs[2] & (1 << 9)) != 0 && (regs[2] & (1 << 19)) != 0);
+  __cpuidex(regs, 7, 0);
+  return (has_sse && (regs[1] & (1 << 29)) != 0);
+#else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & (1u << 9)) == 0 || (ecx & (1u << 19)) == 0)
+    return false;
+  return (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29)) != 0);
+#endif
+}
+
+// One group of four rounds. Message words for group k live in msg[k % 4], and the schedule for group k + 1..k + 3 is
+// advanced alongside, since each step only depends on groups that have already been loaded.
+template<u32 k>
+SHA1_NI_TARGET ALWAYS_INLINE static void SHA1NIRounds(__m128i& abcd, __m128i& e0, __m128i& e1, __m128i msg[4])
+{
+  __m128i e;
+  if constexpr (k == 0)
+    e = _mm_add_epi32(e0, msg[0]);
+  else
+    e = _mm_sha1nexte_epu32(((k % 2) == 0) ? e0 : e1, msg[k % 4]);
+
+  (((k % 2) == 0) ? e1 : e0) = abcd;
+
+  if constexpr (k >= 3 && k <= 18)
+    msg[(k + 1) % 4] = _mm_sha1msg2_epu32(msg[(k + 1) % 4], msg[k % 4]);
+
+  abcd = _mm_sha1rnds4_epu32(abcd, e, k / 5);
+
+  if constexpr (k >= 1 && k <= 16)
+    msg[(k + 3) % 4] = _mm_sha1msg1_epu32(msg[(k + 3) % 4], msg[k % 4]);
+  if constexpr (k >= 2 && k <= 17)
+    msg[(k + 2) % 4] = _mm_xor_si128(msg[(k + 2) % 4], msg[k % 4]);
+}
+
+SHA1_NI_TARGET static void SHA1TransformBlocksSHANI(u32 state[5], const u8* data, u32 num_blocks)
+{
+  const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+  __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+  __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+  __m128i e1;
+
+  for (; num_blocks > 0; num_blocks--, data += 64)
+  {
+    const __m128i abcd_save = abcd;
+    const __m128i e0_save = e0;
+
+    __m128i msg[4];
+    for (u32 i = 0; i < 4; i++)
+      msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byte_swap);
+
+    SHA1NIRounds<0>(abcd, e0, e1, msg);
+    SHA1NIRounds<1>(abcd, e0, e1, msg);
+    SHA1NIRounds<2>(abcd, e0, e1, msg);
+    SHA1NIRounds<3>(abcd, e0, e1, msg);
+    SHA1NIRounds<4>(abcd, e0, e1, msg);
+    SHA1NIRounds<5>(abcd, e0, e1, msg);
+    SHA1NIRounds<6>(abcd, e0, e1, msg);
+    SHA1NIRounds<7>(abcd, e0, e1, msg);
+    SHA1NIRounds<8>(abcd, e0, e1, msg);
+    SHA1NIRounds<9>(abcd, e0, e1, msg);
+    SHA1NIRounds<10>(abcd, e0, e1, msg);
+    SHA1NIRounds<11>(abcd, e0, e1, msg);
+    SHA1NIRounds<12>(abcd, e0, e1, msg);
+    SHA1NIRounds<13>(abcd, e0, e1, msg);
+    SHA1NIRounds<14>(abcd, e0, e1, msg);
+    SHA1NIRounds<15>(abcd, e0, e1, msg);
+    SHA1NIRounds<16>(abcd, e0, e1, msg);
+    SHA1NIRounds<17>(abcd, e0, e1, msg);
+    SHA1NIRounds<18>(abcd, e0, e1, msg);
+    SHA1NIRounds<19>(abcd, e0, e1, msg);
+
+    // group 19 is odd, so its E input came from e1, and the next E is derived from the ABCD it saved in e0
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+  state[4] = static_cast<u32>(_mm_extract_epi32(e0, 3));
+}
+
+#elif defined(CPU_ARCH_ARM64)
+
+#if defined(__clang__)
+#define SHA1_ARM_TARGET __attribute__((target("crypto")))
+#elif defined(__GNUC__)
+#define SHA1_ARM_TARGET __attribute__((target("+crypto")))
+#else
+#define SHA1_ARM_TARGET
+#endif
+
+static bool CPUHasSHA1Extensions()
+{
+#if defined(__APPLE__)
+  return true;
+#elif defined(_WIN32)
+  return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+#elif defined(__linux__)
+  return ((getauxval(AT_HWCAP) & HWCAP_SHA1) != 0);
+#else
+  return false;
+#endif
+}
+
+SHA1_ARM_TARGET static void SHA1TransformBlocksARM(u32 state[5], const u8* data, u32 num_blocks)
+{
+  static constexpr u32 round_constants[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+
+  uint32x4_t abcd = vld1q_u32(state);
+  u32 e = state[4];
+
+  for (; num_blocks > 0; num_blocks--, data += 64)
+  {
+    const uint32x4_t abcd_save = abcd;
+    const u32 e_save = e;
+
+    uint32x4_t msg[4];
+    for (u32 i = 0; i < 4; i++)
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+
+    for (u32 k = 0; k < 20; k++)
+    {
+      // words for group k >= 4 are expanded from the previous four groups, whose slots are reused
+      if (k >= 4)
+      {
+        msg[k % 4] = vsha1su1q_u32(vsha1su0q_u32(msg[k % 4], msg[(k + 1) % 4], msg[(k + 2) % 4]), msg[(k + 3) % 4]);
+      }
+
+      const uint32x4_t wk = vaddq_u32(msg[k % 4], vdupq_n_u32(round_constants[k / 5]));
+      const u32 next_e = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+      if (k < 5)
+        abcd = vsha1cq_u32(abcd, e, wk);
+      else if (k < 10 || k >= 15)
+        abcd = vsha1pq_u32(abcd, e, wk);
+      else
+        abcd = vsha1mq_u32(abcd, e, wk);
+      e = next_e;
+    }
+
+    abcd = vaddq_u32(abcd, abcd_save);
+    e += e_save;
+  }
+
+  vst1q_u32(state, abcd);
+  state[4] = e;
+}
+
+#endif
+
+using SHA1TransformBlocksFunction = void (*)(u32 state[5], const u8* data, u32 num_blocks);
+
+static SHA1TransformBlocksFunction SelectSHA1TransformBlocksFunction(bool allow_hardware)
+{
+#if defined(CPU_ARCH_X64) || defined(CPU_ARCH_X86)
+  if (allow_hardware && CPUHasSHA1Extensions())
+    return SHA1TransformBlocksSHANI;
+#elif defined(CPU_ARCH_ARM64)
+  if (allow_hardware && CPUHasSHA1Extensions())
+    return SHA1TransformBlocksARM;
+#endif
+
+  return SHA1TransformBlocksScalar;
+}
+
+static SHA1TransformBlocksFunction& GetSHA1TransformBlocksFunction()
+{
+  static SHA1TransformBlocksFunction func = SelectSHA1TransformBlocksFunction(true);
+  return func;
+}
+
+static void SHA1TransformBlocks(u32 state[5], const u8* data, u32 num_blocks)
+{
+  GetSHA1TransformBlocksFunction()(state, data, num_blocks);
+}
+
+bool SHA1Digest::IsUsingHardwareAcceleration()
+{
+  return (GetSHA1TransformBlocksFunction() != SHA1TransformBlocksScalar);
+}
+
+void SHA1Digest::SetHardwareAccelerationEnabled(bool enabled)
+{
+  GetSHA1TransformBlocksFunction() = SelectSHA1TransformBlocksFunction(enabled);
+}
+
 SHA1Digest::SHA1Digest()
 {
   Reset();
@@ -120,10 +349,13 @@ void SHA1Digest::Update(const void* data, u32 len)
   if ((j + len) > 63)
   {
     std::memcpy(&buffer[j], bdata, (i = 64 - j));
-    SHA1Transform(state, buffer);
-    for (; i + 63 < len; i += 64)
+    SHA1TransformBlocks(state, buffer, 1);
+
+    const u32 num_blocks = (len - i) / 64;
+    if (num_blocks > 0)
     {
-      SHA1Transform(state, &bdata[i]);
+      SHA1TransformBlocks(state, &bdata[i], num_blocks);
+      i += num_blocks * 64;
     }
     j = 0;
   }
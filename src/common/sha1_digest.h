@@ -21,6 +21,13 @@ public:
 
   static std::string DigestToString(const u8 digest[DIGEST_SIZE]);
 
+  /// Returns true if the CPU's SHA instructions are being used, i.e. SHA-NI or the ARMv8 SHA1 extension.
+  static bool IsUsingHardwareAcceleration();
+
+  /// Switches between the SHA instructions and the portable implementation, so tests can check both. Has no effect if
+  /// the CPU lacks SHA instructions. Not thread-safe, hashing must not be in progress on any other thread.
+  static void SetHardwareAccelerationEnabled(bool enabled);
+
 private:
   u32 state[5];
   u32 count[2];
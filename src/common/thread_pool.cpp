@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "thread_pool.h"
+#include "assert.h"
+#include "log.h"
+#include "small_string.h"
+
+#include <algorithm>
+#include <thread>
+
+Log_SetChannel(ThreadPool);
+
+// CPUs left for the CPU and GPU threads, which are busy the whole time a game is running.
+static constexpr u32 RESERVED_CPUS = 2;
+
+static thread_local const Threading::ThreadPool* s_current_pool = nullptr;
+static thread_local u32 s_current_worker_index = 0;
+
+Threading::ThreadPool::ThreadPool(u32 num_workers /* = 0 */)
+  : m_worker_count((num_workers != 0) ? num_workers : GetDefaultWorkerCount())
+{
+  Log_DevFmt("Starting thread pool with {} workers", m_worker_count);
+
+  m_queues.reserve(m_worker_count);
+  for (u32 i = 0; i < m_worker_count; i++)
+    m_queues.push_back(std::make_unique<WorkerQueue>());
+
+  m_workers.reserve(m_worker_count);
+  for (u32 i = 0; i < m_worker_count; i++)
+    m_workers.emplace_back([this, i]() { WorkerThreadEntryPoint(i); });
+}
+
+Threading::ThreadPool::~ThreadPool()
+{
+  {
+    std::unique_lock lock(m_wake_mutex);
+    m_shutdown = true;
+  }
+  m_wake_cv.notify_all();
+
+  // Workers finish anything still queued before exiting, so no future is left without a result.
+  for (Thread& worker : m_workers)
+    worker.Join();
+}
+
+Threading::ThreadPool& Threading::ThreadPool::GetShared()
+{
+  static ThreadPool s_shared_pool;
+  return s_shared_pool;
+}
+
+u32 Threading::ThreadPool::GetDefaultWorkerCount()
+{
+  const u32 num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+  return std::max(num_cpus, RESERVED_CPUS + 1) - RESERVED_CPUS;
+}
+
+bool Threading::ThreadPool::IsWorkerThread() const
+{
+  return (s_current_pool == this);
+}
+
+void Threading::ThreadPool::Enqueue(Task task, Priority priority /* = Priority::Normal */)
+{
+  // Tasks queued by a worker usually work on the same data, so keep them on that worker while it's hot in cache.
+  const u32 queue_index = IsWorkerThread() ?
+                            s_current_worker_index :
+                            (m_next_queue.fetch_add(1, std::memory_order_relaxed) % GetWorkerCount());
+
+  // Counted before it's visible, so a worker can't take it and drop the count below zero.
+  m_pending_tasks.fetch_add(1, std::memory_order_release);
+
+  {
+    WorkerQueue& queue = *m_queues[queue_index];
+    std::unique_lock lock(queue.mutex);
+    queue.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+  }
+
+  // Workers check the count with this mutex held, so taking it here means the wakeup can't be missed.
+  {
+    std::unique_lock lock(m_wake_mutex);
+  }
+  m_wake_cv.notify_one();
+}
+
+void Threading::ThreadPool::ParallelFor(u32 count, const std::function<void(u32 start, u32 end)>& func,
+                                        u32 min_batch_size /* = 1 */, Priority priority /* = Priority::Normal */)
+{
+  if (count == 0)
+    return;
+
+  const u32 max_batches = GetWorkerCount() + 1;
+  const u32 batch_size = std::max(std::max(min_batch_size, 1u), (count + max_batches - 1) / max_batches);
+  const u32 num_batches = (count + batch_size - 1) / batch_size;
+  if (num_batches == 1)
+  {
+    func(0, count);
+    return;
+  }
+
+  // Helper tasks can start after we've returned, in which case there are no batches left for them and they must not
+  // touch func. The state is shared so they can still find that out.
+  struct State
+  {
+    const std::function<void(u32, u32)>* func;
+    u32 count;
+    u32 batch_size;
+    u32 num_batches;
+    std::atomic<u32> next_batch{0};
+    std::atomic<u32> completed_batches{0};
+  };
+
+  const auto run_batches = [](State& state) {
+    u32 batch;
+    while ((batch = state.next_batch.fetch_add(1, std::memory_order_relaxed)) < state.num_batches)
+    {
+      const u32 start = batch * state.batch_size;
+      (*state.func)(start, std::min(start + state.batch_size, state.count));
+      state.completed_batches.fetch_add(1, std::memory_order_release);
+    }
+  };
+
+  std::shared_ptr<State> state = std::make_shared<State>();
+  state->func = &func;
+  state->count = count;
+  state->batch_size = batch_size;
+  state->num_batches = num_batches;
+
+  for (u32 i = 1; i < num_batches; i++)
+    Enqueue([state, run_batches]() { run_batches(*state); }, priority);
+
+  run_batches(*state);
+
+  // Help out with other work while the last batches finish, in case they're stuck behind it.
+  while (state->completed_batches.load(std::memory_order_acquire) != num_batches)
+  {
+    if (!TryRunPendingTask())
+      Timeslice();
+  }
+}
+
+bool Threading::ThreadPool::TryRunPendingTask()
+{
+  Task task;
+  const bool found = IsWorkerThread() ? PopTask(s_current_worker_index, &task) : StealTask(GetWorkerCount(), &task);
+  if (!found)
+    return false;
+
+  task();
+  return true;
+}
+
+bool Threading::ThreadPool::PopTask(u32 worker_index, Task* task)
+{
+  WorkerQueue& own = *m_queues[worker_index];
+  for (size_t priority = 0; priority < static_cast<size_t>(Priority::Count); priority++)
+  {
+    {
+      std::unique_lock lock(own.mutex);
+      std::deque<Task>& tasks = own.tasks[priority];
+      if (!tasks.empty())
+      {
+        *task = std::move(tasks.back());
+        tasks.pop_back();
+        m_pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    // Higher priority work elsewhere goes before our own lower priority work.
+    for (u32 i = 1; i < GetWorkerCount(); i++)
+    {
+      WorkerQueue& victim = *m_queues[(worker_index + i) % GetWorkerCount()];
+      std::unique_lock lock(victim.mutex);
+      std::deque<Task>& tasks = victim.tasks[priority];
+      if (!tasks.empty())
+      {
+        *task = std::move(tasks.front());
+        tasks.pop_front();
+        m_pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool Threading::ThreadPool::StealTask(u32 thief_index, Task* task)
+{
+  // Oldest first, since the owner is working from the other end.
+  for (size_t priority = 0; priority < static_cast<size_t>(Priority::Count); priority++)
+  {
+    for (u32 i = 0; i < GetWorkerCount(); i++)
+    {
+      WorkerQueue& victim = *m_queues[(thief_index + i) % GetWorkerCount()];
+      std::unique_lock lock(victim.mutex);
+      std::deque<Task>& tasks = victim.tasks[priority];
+      if (!tasks.empty())
+      {
+        *task = std::move(tasks.front());
+        tasks.pop_front();
+        m_pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void Threading::ThreadPool::WorkerThreadEntryPoint(u32 index)
+{
+  SetNameOfCurrentThread(TinyString::from_format("Worker {}", index).c_str());
+  SetCurrentThreadRole(ThreadRole::Worker);
+  s_current_pool = this;
+  s_current_worker_index = index;
+
+  for (;;)
+  {
+    Task task;
+    if (PopTask(index, &task))
+    {
+      task();
+      continue;
+    }
+
+    std::unique_lock lock(m_wake_mutex);
+    m_wake_cv.wait(lock, [this]() { return (m_shutdown || m_pending_tasks.load(std::memory_order_acquire) > 0); });
+    if (m_shutdown && m_pending_tasks.load(std::memory_order_acquire) == 0)
+      break;
+  }
+
+  s_current_pool = nullptr;
+}
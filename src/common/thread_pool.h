@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "threading.h"
+#include "types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Threading {
+
+// --------------------------------------------------------------------------------------
+//  ThreadPool
+// --------------------------------------------------------------------------------------
+// Pool of worker threads for short-lived jobs, such as shader compilation, image decoding or hashing. Each worker has
+// its own queue, which it runs newest-first, and steals the oldest tasks from other workers when its own runs dry.
+// Tasks should not block on other tasks through futures, since that can deadlock once every worker is waiting. Use
+// ParallelFor() instead, which runs work on the calling thread while it waits.
+//
+class ThreadPool
+{
+public:
+  enum class Priority : u8
+  {
+    High,
+    Normal,
+    Low,
+    Count
+  };
+
+  using Task = std::function<void()>;
+
+  /// Starts num_workers threads. Zero picks a count based on the number of CPUs.
+  explicit ThreadPool(u32 num_workers = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Returns the pool shared by the whole application, creating it on first use.
+  static ThreadPool& GetShared();
+
+  /// Returns the number of workers which the pool should have, leaving some CPUs for the emulation and GPU threads.
+  static u32 GetDefaultWorkerCount();
+
+  ALWAYS_INLINE u32 GetWorkerCount() const { return m_worker_count; }
+
+  /// Returns true if the calling thread is one of this pool's workers.
+  bool IsWorkerThread() const;
+
+  /// Queues a task, without any way to find out when it finishes.
+  void Enqueue(Task task, Priority priority = Priority::Normal);
+
+  /// Queues a task, returning a future for its result.
+  template<typename F>
+  std::future<std::invoke_result_t<F>> Submit(F&& func, Priority priority = Priority::Normal)
+  {
+    using R = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+    std::future<R> future = task->get_future();
+    Enqueue([task = std::move(task)]() { (*task)(); }, priority);
+    return future;
+  }
+
+  /// Calls func(start, end) over [0, count) split into batches of at least min_batch_size, and returns once every
+  /// batch has completed. The calling thread runs batches too, so this is safe to use from within a task.
+  void ParallelFor(u32 count, const std::function<void(u32 start, u32 end)>& func, u32 min_batch_size = 1,
+                   Priority priority = Priority::Normal);
+
+  /// Runs one queued task on the calling thread, if there is one. Returns false if nothing was queued.
+  bool TryRunPendingTask();
+
+private:
+  struct WorkerQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks[static_cast<size_t>(Priority::Count)];
+  };
+
+  bool PopTask(u32 worker_index, Task* task);
+  bool StealTask(u32 thief_index, Task* task);
+  void WorkerThreadEntryPoint(u32 index);
+
+  // Fixed before any worker starts, since workers use it to pick queues to steal from while others are still starting.
+  const u32 m_worker_count;
+
+  std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+  std::vector<Thread> m_workers;
+
+  // Wakes workers when a task is queued. The count lets workers check for tasks without taking every queue's lock.
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake_cv;
+  std::atomic<u32> m_pending_tasks{0};
+  std::atomic<u32> m_next_queue{0};
+  bool m_shutdown = false;
+};
+
+} // namespace Threading
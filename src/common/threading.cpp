@@ -3,7 +3,16 @@
 
 #include "threading.h"
 #include "assert.h"
+#include "log.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #if !defined(_WIN32) && !defined(__APPLE__)
 #ifndef _GNU_SOURCE
@@ -33,11 +42,50 @@
 #include <mach/mach_time.h>
 #include <mach/semaphore.h>
 #include <mach/task.h>
+#include <pthread/qos.h>
+#include <sys/sysctl.h>
 #else
 #include <pthread_np.h>
 #endif
 #endif
 
+Log_SetChannel(Threading);
+
+namespace Threading {
+namespace {
+struct ProcessorMasks
+{
+  u64 performance;
+  u64 efficiency;
+};
+
+struct RegisteredThread
+{
+  std::thread::id id;
+  ThreadHandle handle;
+  ThreadRole role;
+};
+
+// Removes the thread from the placement list when it exits.
+struct ThreadRoleRegistration
+{
+  ~ThreadRoleRegistration();
+
+  bool registered = false;
+};
+} // namespace
+
+static ProcessorMasks DetectProcessorMasks();
+static const ProcessorMasks& GetProcessorMasks();
+static u64 GetPlacementMask(ThreadRole role, ThreadPlacementPolicy policy);
+static void ApplyCurrentThreadQoS(ThreadRole role, ThreadPlacementPolicy policy);
+
+static std::mutex s_thread_placement_mutex;
+static ThreadPlacementPolicy s_thread_placement_policy = ThreadPlacementPolicy::Default;
+static std::vector<RegisteredThread> s_registered_threads;
+static thread_local ThreadRoleRegistration s_thread_role_registration;
+} // namespace Threading
+
 #ifdef _WIN32
 union FileTimeU64Union
 {
@@ -237,10 +285,16 @@ u64 Threading::ThreadHandle::GetCPUTime() const
 bool Threading::ThreadHandle::SetAffinity(u64 processor_mask) const
 {
 #if defined(_WIN32)
+  // Windows won't accept processors which don't exist.
+  DWORD_PTR process_mask, system_mask;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    return false;
+
+  processor_mask = (processor_mask != 0) ? (processor_mask & process_mask) : process_mask;
   if (processor_mask == 0)
-    processor_mask = ~processor_mask;
+    return false;
 
-  return (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)processor_mask) != 0 || GetLastError() != ERROR_SUCCESS);
+  return (SetThreadAffinityMask((HANDLE)m_native_handle, (DWORD_PTR)processor_mask) != 0);
 #elif defined(__linux__)
   cpu_set_t set;
   CPU_ZERO(&set);
@@ -559,6 +613,8 @@ void Threading::SetNameOfCurrentThread(const char* name)
 #else
   pthread_set_name_np(pthread_self(), name);
 #endif
+
+  Trace::SetCurrentThreadName(name);
 }
 
 Threading::KernelSemaphore::KernelSemaphore()
@@ -617,3 +673,258 @@ bool Threading::KernelSemaphore::TryWait()
   return sem_trywait(&m_sema) == 0;
 #endif
 }
+
+Threading::ThreadRoleRegistration::~ThreadRoleRegistration()
+{
+  if (!registered)
+    return;
+
+  const std::thread::id id = std::this_thread::get_id();
+  std::unique_lock lock(s_thread_placement_mutex);
+  const auto it = std::find_if(s_registered_threads.begin(), s_registered_threads.end(),
+                               [&id](const RegisteredThread& rt) { return (rt.id == id); });
+  if (it != s_registered_threads.end())
+    s_registered_threads.erase(it);
+}
+
+#if defined(__linux__)
+
+// Parses a kernel CPU list such as "0-3,8-11".
+static u64 ReadProcessorListMask(const char* path)
+{
+  std::FILE* fp = std::fopen(path, "r");
+  if (!fp)
+    return 0;
+
+  char buf[256];
+  const bool read = (std::fgets(buf, sizeof(buf), fp) != nullptr);
+  std::fclose(fp);
+  if (!read)
+    return 0;
+
+  u64 mask = 0;
+  const char* ptr = buf;
+  while (*ptr >= '0' && *ptr <= '9')
+  {
+    char* end;
+    const unsigned long first = std::strtoul(ptr, &end, 10);
+    unsigned long last = first;
+    if (*end == '-')
+      last = std::strtoul(end + 1, &end, 10);
+
+    for (unsigned long i = first; i <= last && i < 64; i++)
+      mask |= (static_cast<u64>(1) << i);
+
+    ptr = (*end == ',') ? (end + 1) : end;
+  }
+
+  return mask;
+}
+
+static bool ReadProcessorCapacity(u32 index, u32* capacity)
+{
+  char path[64];
+  std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpu_capacity", index);
+
+  std::FILE* fp = std::fopen(path, "r");
+  if (!fp)
+    return false;
+
+  const bool result = (std::fscanf(fp, "%u", capacity) == 1);
+  std::fclose(fp);
+  return result;
+}
+
+#endif
+
+Threading::ProcessorMasks Threading::DetectProcessorMasks()
+{
+  ProcessorMasks masks = {};
+
+#if defined(_WIN32)
+  ULONG length = 0;
+  GetSystemCpuSetInformation(nullptr, 0, &length, GetCurrentProcess(), 0);
+  if (length == 0)
+    return masks;
+
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(length);
+  if (!GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(buffer.get()), length, &length,
+                                  GetCurrentProcess(), 0))
+  {
+    return masks;
+  }
+
+  // Higher efficiency classes are faster. Only the first processor group fits in a mask.
+  u8 classes[64] = {};
+  u64 present = 0;
+  for (ULONG offset = 0; offset < length;)
+  {
+    const SYSTEM_CPU_SET_INFORMATION* info = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(&buffer[offset]);
+    offset += info->Size;
+    if (info->Type != CpuSetInformation || info->CpuSet.Group != 0 || info->CpuSet.LogicalProcessorIndex >= 64)
+      continue;
+
+    classes[info->CpuSet.LogicalProcessorIndex] = info->CpuSet.EfficiencyClass;
+    present |= (static_cast<u64>(1) << info->CpuSet.LogicalProcessorIndex);
+  }
+
+  u8 min_class = 0xFF, max_class = 0;
+  for (u32 i = 0; i < 64; i++)
+  {
+    if (present & (static_cast<u64>(1) << i))
+    {
+      min_class = std::min(min_class, classes[i]);
+      max_class = std::max(max_class, classes[i]);
+    }
+  }
+
+  if (min_class >= max_class)
+    return masks;
+
+  for (u32 i = 0; i < 64; i++)
+  {
+    if (!(present & (static_cast<u64>(1) << i)))
+      continue;
+
+    if (classes[i] == max_class)
+      masks.performance |= (static_cast<u64>(1) << i);
+    else if (classes[i] == min_class)
+      masks.efficiency |= (static_cast<u64>(1) << i);
+  }
+#elif defined(__linux__)
+  // Intel hybrid parts have a PMU for each core type, which lists its processors.
+  masks.performance = ReadProcessorListMask("/sys/devices/cpu_core/cpus");
+  masks.efficiency = ReadProcessorListMask("/sys/devices/cpu_atom/cpus");
+  if (masks.performance != 0 && masks.efficiency != 0)
+    return masks;
+
+  // ARM big.LITTLE reports each core's relative capacity to the scheduler.
+  masks = {};
+  u32 capacities[64];
+  u32 num_processors = 0;
+  while (num_processors < 64 && ReadProcessorCapacity(num_processors, &capacities[num_processors]))
+    num_processors++;
+  if (num_processors == 0)
+    return masks;
+
+  const auto [min_capacity, max_capacity] = std::minmax_element(capacities, capacities + num_processors);
+  if (*min_capacity == *max_capacity)
+    return masks;
+
+  for (u32 i = 0; i < num_processors; i++)
+  {
+    if (capacities[i] == *max_capacity)
+      masks.performance |= (static_cast<u64>(1) << i);
+    else if (capacities[i] == *min_capacity)
+      masks.efficiency |= (static_cast<u64>(1) << i);
+  }
+#endif
+
+  return masks;
+}
+
+const Threading::ProcessorMasks& Threading::GetProcessorMasks()
+{
+  static const ProcessorMasks s_masks = []() {
+    const ProcessorMasks masks = DetectProcessorMasks();
+    if (masks.performance != 0)
+    {
+      Log_InfoFmt("Detected hybrid CPU, performance cores 0x{:X}, efficiency cores 0x{:X}", masks.performance,
+                  masks.efficiency);
+    }
+
+    return masks;
+  }();
+
+  return s_masks;
+}
+
+u64 Threading::GetPerformanceProcessorMask()
+{
+  return GetProcessorMasks().performance;
+}
+
+u64 Threading::GetEfficiencyProcessorMask()
+{
+  return GetProcessorMasks().efficiency;
+}
+
+u64 Threading::GetPlacementMask(ThreadRole role, ThreadPlacementPolicy policy)
+{
+  const ProcessorMasks& masks = GetProcessorMasks();
+  if (policy == ThreadPlacementPolicy::Default || masks.performance == 0)
+    return 0;
+
+  switch (role)
+  {
+    case ThreadRole::Emulation:
+    case ThreadRole::Presenter:
+      return masks.performance;
+
+    default:
+      return (policy == ThreadPlacementPolicy::SplitCores) ? masks.efficiency : 0;
+  }
+}
+
+void Threading::ApplyCurrentThreadQoS(ThreadRole role, ThreadPlacementPolicy policy)
+{
+#ifdef __APPLE__
+  // macOS doesn't do affinity, but it picks the core type from the QoS class.
+  qos_class_t qos = QOS_CLASS_DEFAULT;
+  if (policy != ThreadPlacementPolicy::Default)
+  {
+    if (role == ThreadRole::Emulation || role == ThreadRole::Presenter)
+      qos = QOS_CLASS_USER_INTERACTIVE;
+    else if (policy == ThreadPlacementPolicy::SplitCores)
+      qos = QOS_CLASS_UTILITY;
+  }
+
+  pthread_set_qos_class_self_np(qos, 0);
+#endif
+}
+
+Threading::ThreadPlacementPolicy Threading::GetThreadPlacementPolicy()
+{
+  std::unique_lock lock(s_thread_placement_mutex);
+  return s_thread_placement_policy;
+}
+
+void Threading::SetThreadPlacementPolicy(ThreadPlacementPolicy policy)
+{
+  std::unique_lock lock(s_thread_placement_mutex);
+  if (s_thread_placement_policy == policy)
+    return;
+
+  s_thread_placement_policy = policy;
+
+  // QoS can only be changed by the thread itself on macOS, so other threads keep their class until they're restarted.
+  for (const RegisteredThread& rt : s_registered_threads)
+  {
+    if (rt.id == std::this_thread::get_id())
+      ApplyCurrentThreadQoS(rt.role, policy);
+
+    if (!rt.handle.SetAffinity(GetPlacementMask(rt.role, policy)))
+      Log_DevFmt("Failed to set affinity for thread with role {}", static_cast<u32>(rt.role));
+  }
+}
+
+void Threading::SetCurrentThreadRole(ThreadRole role)
+{
+  std::unique_lock lock(s_thread_placement_mutex);
+  const std::thread::id id = std::this_thread::get_id();
+  auto it = std::find_if(s_registered_threads.begin(), s_registered_threads.end(),
+                         [&id](const RegisteredThread& rt) { return (rt.id == id); });
+  if (it != s_registered_threads.end())
+    it->role = role;
+  else
+    it = s_registered_threads.insert(s_registered_threads.end(), {id, ThreadHandle::GetForCallingThread(), role});
+
+  s_thread_role_registration.registered = true;
+
+  ApplyCurrentThreadQoS(role, s_thread_placement_policy);
+
+  // Threads which were never placed don't need their affinity reset.
+  const u64 mask = GetPlacementMask(role, s_thread_placement_policy);
+  if (mask != 0 && !it->handle.SetAffinity(mask))
+    Log_DevFmt("Failed to set affinity for thread with role {}", static_cast<u32>(role));
+}
@@ -23,6 +23,38 @@ extern void SetNameOfCurrentThread(const char* name);
 // Releases a timeslice to other threads.
 extern void Timeslice();
 
+/// Controls which processors threads are allowed to run on, for systems with more than one type of core.
+enum class ThreadPlacementPolicy : u8
+{
+  Default,          // Leave it to the OS.
+  PerformanceCores, // Emulation and presentation on performance cores, everything else anywhere.
+  SplitCores,       // Emulation and presentation on performance cores, everything else on efficiency cores.
+  Count
+};
+
+enum class ThreadRole : u8
+{
+  Emulation,
+  Presenter,
+  Worker,
+  Audio,
+  Background,
+};
+
+/// Returns a mask of the processors in the fastest/slowest class. Zero if the cores are all the same type, the type
+/// could not be determined, or the OS doesn't support affinity (macOS, where thread QoS is used instead).
+extern u64 GetPerformanceProcessorMask();
+extern u64 GetEfficiencyProcessorMask();
+
+extern ThreadPlacementPolicy GetThreadPlacementPolicy();
+
+/// Changes the policy, and moves every thread which has set its role.
+extern void SetThreadPlacementPolicy(ThreadPlacementPolicy policy);
+
+/// Places the calling thread according to its role and the current policy. Threads should call this once, after
+/// setting their name. The thread is forgotten when it exits.
+extern void SetCurrentThreadRole(ThreadRole role);
+
 // --------------------------------------------------------------------------------------
 //  ThreadHandle
 // --------------------------------------------------------------------------------------
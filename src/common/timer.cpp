@@ -3,6 +3,9 @@
 
 #include "timer.h"
 #include "types.h"
+
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 
@@ -17,6 +20,40 @@
 
 namespace Common {
 
+// Even with high-resolution timers, the OS doesn't wake us up *exactly* when we ask it to. So for exact sleeps, we
+// wake up early by however late the OS has recently been, and spin off the rest. The lateness depends on the OS,
+// timer resolution and load, so it's measured rather than guessed.
+static constexpr double MIN_OVERSLEEP_MARGIN_NS = 50000.0;
+static constexpr double MAX_OVERSLEEP_MARGIN_NS = 2000000.0;
+static constexpr double OVERSLEEP_SMOOTHING = 1.0 / 16.0;
+static thread_local double s_oversleep_mean_ns = 250000.0;
+static thread_local double s_oversleep_deviation_ns = 125000.0;
+
+static void SleepUntilExact(Timer::Value value)
+{
+  // Mean plus a few deviations, so a wakeup on the slow side of normal still lands before the deadline.
+  const double margin_ns = std::clamp(s_oversleep_mean_ns + s_oversleep_deviation_ns * 4.0, MIN_OVERSLEEP_MARGIN_NS,
+                                      MAX_OVERSLEEP_MARGIN_NS);
+  const Timer::Value wake_at = value - Timer::ConvertNanosecondsToValue(margin_ns);
+  Timer::Value current = Timer::GetCurrentValue();
+  if (wake_at > current)
+  {
+    Timer::SleepUntil(wake_at, false);
+
+    current = Timer::GetCurrentValue();
+    const double late_ns =
+      (current > wake_at) ? std::min(Timer::ConvertValueToNanoseconds(current - wake_at), MAX_OVERSLEEP_MARGIN_NS) :
+                            0.0;
+    const double error_ns = late_ns - s_oversleep_mean_ns;
+    s_oversleep_mean_ns += error_ns * OVERSLEEP_SMOOTHING;
+    s_oversleep_deviation_ns += (std::abs(error_ns) - s_oversleep_deviation_ns) * OVERSLEEP_SMOOTHING;
+  }
+
+  // And spin off whatever time is left.
+  while (current < value)
+    current = Timer::GetCurrentValue();
+}
+
 #ifdef _WIN32
 
 static double s_counter_frequency;
@@ -98,18 +135,7 @@ void Timer::SleepUntil(Value value, bool exact)
 {
   if (exact)
   {
-    // Even with the high-precision timer, it's not precise enough to wake us up *exactly* when we want
-    // to. Dropping off the last 0.5ms and spinning for it seems enough on my system (Win11 22H2).
-    const Value wake_at = value - ConvertMillisecondsToValue(0.5);
-    Value current = GetCurrentValue();
-    if (wake_at > current)
-      SleepUntil(wake_at, false);
-
-    // And spin off whatever time is left.
-    do
-    {
-      current = GetCurrentValue();
-    } while (current < value);
+    SleepUntilExact(value);
   }
   else
   {
@@ -187,17 +213,7 @@ void Timer::SleepUntil(Value value, bool exact)
 {
   if (exact)
   {
-    static constexpr Value min_sleep_time = static_cast<Value>(0.5 * 1000000);
-    const Value wake_at = value - min_sleep_time;
-    Value current = GetCurrentValue();
-    if (wake_at > current)
-      SleepUntil(wake_at, false);
-
-    // And spin off whatever time is left.
-    do
-    {
-      current = GetCurrentValue();
-    } while (current < value);
+    SleepUntilExact(value);
   }
   else
   {
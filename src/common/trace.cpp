@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "trace.h"
+
+#ifdef ENABLE_TRACING
+
+#include "error.h"
+#include "file_system.h"
+#include "log.h"
+#include "timer.h"
+
+#include "fmt/format.h"
+
+#include <cerrno>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+Log_SetChannel(Trace);
+
+namespace Trace {
+namespace {
+struct ZoneEvent
+{
+  const char* name;
+  u64 start;
+  u64 end;
+};
+
+struct ThreadBuffer
+{
+  static constexpr u32 MAX_EVENTS = 1024 * 1024;
+
+  std::unique_ptr<ZoneEvent[]> events;
+  std::string name;
+  u32 id = 0;
+
+  // Written by the owning thread only, the capture reads up to count.
+  std::atomic<u32> count{0};
+  std::atomic<u32> generation{0};
+  u32 dropped = 0;
+  std::atomic_bool in_use{false};
+};
+
+struct ThreadBufferRef
+{
+  ThreadBuffer* buffer = nullptr;
+
+  ~ThreadBufferRef()
+  {
+    if (buffer)
+      buffer->in_use.store(false, std::memory_order_release);
+  }
+};
+} // namespace
+
+static ThreadBuffer* GetThreadBuffer();
+static void AppendEscapedString(std::string* dst, const char* str);
+
+static std::mutex s_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static std::atomic<u32> s_generation{0};
+static u32 s_next_thread_id = 1;
+static u64 s_capture_start = 0;
+static thread_local ThreadBufferRef s_thread_buffer;
+
+} // namespace Trace
+
+std::atomic_bool Trace::Internal::g_capturing{false};
+
+u64 Trace::Internal::GetTimestamp()
+{
+  return static_cast<u64>(Common::Timer::GetCurrentValue());
+}
+
+Trace::ThreadBuffer* Trace::GetThreadBuffer()
+{
+  if (s_thread_buffer.buffer)
+    return s_thread_buffer.buffer;
+
+  // Buffers belonging to exited threads are recycled, unless they hold events for the current capture.
+  std::unique_lock lock(s_buffers_mutex);
+  const u32 generation = s_generation.load(std::memory_order_relaxed);
+  ThreadBuffer* buffer = nullptr;
+  for (const std::unique_ptr<ThreadBuffer>& it : s_buffers)
+  {
+    if (!it->in_use.load(std::memory_order_acquire) &&
+        (it->generation.load(std::memory_order_relaxed) != generation ||
+         it->count.load(std::memory_order_relaxed) == 0))
+    {
+      buffer = it.get();
+      break;
+    }
+  }
+  if (!buffer)
+    buffer = s_buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+
+  buffer->id = s_next_thread_id++;
+  buffer->name.clear();
+  buffer->generation.store(generation, std::memory_order_relaxed);
+  buffer->count.store(0, std::memory_order_relaxed);
+  buffer->dropped = 0;
+  buffer->in_use.store(true, std::memory_order_relaxed);
+  s_thread_buffer.buffer = buffer;
+  return buffer;
+}
+
+void Trace::Internal::AddZone(const char* name, u64 start, u64 end)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+
+  // A new capture was started since this thread last recorded, throw away the old events.
+  const u32 generation = s_generation.load(std::memory_order_relaxed);
+  if (buffer->generation.load(std::memory_order_relaxed) != generation)
+  {
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->generation.store(generation, std::memory_order_relaxed);
+    buffer->dropped = 0;
+  }
+
+  // Storage is only allocated once a thread records something, naming a thread is free.
+  if (!buffer->events)
+    buffer->events = std::make_unique<ZoneEvent[]>(ThreadBuffer::MAX_EVENTS);
+
+  const u32 index = buffer->count.load(std::memory_order_relaxed);
+  if (index == ThreadBuffer::MAX_EVENTS)
+  {
+    buffer->dropped++;
+    return;
+  }
+
+  buffer->events[index] = ZoneEvent{name, start, end};
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void Trace::SetCurrentThreadName(const char* name)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::unique_lock lock(s_buffers_mutex);
+  buffer->name = name;
+}
+
+void Trace::StartCapture()
+{
+  std::unique_lock lock(s_buffers_mutex);
+  s_generation.fetch_add(1, std::memory_order_relaxed);
+  s_capture_start = Internal::GetTimestamp();
+  Internal::g_capturing.store(true, std::memory_order_release);
+  Log_InfoPrint("Trace capture started.");
+}
+
+bool Trace::StopCapture(const char* path, Error* error)
+{
+  Internal::g_capturing.store(false, std::memory_order_release);
+
+  std::unique_lock lock(s_buffers_mutex);
+  const u32 generation = s_generation.load(std::memory_order_relaxed);
+  const double start_us = Common::Timer::ConvertValueToNanoseconds(s_capture_start) / 1000.0;
+
+  std::string json;
+  json.reserve(1024 * 1024);
+  json.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  bool first = true;
+  u32 num_events = 0;
+  u32 num_dropped = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    // Zones still being written by other threads land past count, so this never sees a partial event.
+    const u32 count = (buffer->generation.load(std::memory_order_relaxed) == generation) ?
+                        buffer->count.load(std::memory_order_acquire) :
+                        0;
+    if (count == 0)
+      continue;
+
+    json.append(first ? "" : ",\n");
+    fmt::format_to(std::back_inserter(json), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},",
+                   buffer->id);
+    json.append("\"args\":{\"name\":\"");
+    AppendEscapedString(&json, buffer->name.empty() ? "Unnamed Thread" : buffer->name.c_str());
+    json.append("\"}}");
+    first = false;
+
+    for (u32 i = 0; i < count; i++)
+    {
+      const ZoneEvent& ev = buffer->events[i];
+      const double ts = Common::Timer::ConvertValueToNanoseconds(ev.start) / 1000.0 - start_us;
+      const double dur = Common::Timer::ConvertValueToNanoseconds(ev.end - ev.start) / 1000.0;
+      fmt::format_to(std::back_inserter(json),
+                     ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", ev.name,
+                     buffer->id, ts, dur);
+    }
+
+    num_events += count;
+    num_dropped += buffer->dropped;
+  }
+
+  json.append("\n]}\n");
+
+  FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(path, "wb", error);
+  if (!fp)
+    return false;
+
+  if (std::fwrite(json.data(), json.size(), 1, fp.get()) != 1 || std::fflush(fp.get()) != 0)
+  {
+    Error::SetErrno(error, "fwrite() failed: ", errno);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote {} trace events to '{}'.", num_events, path);
+  if (num_dropped > 0)
+    Log_WarningFmt("{} trace events were dropped because a thread buffer was full.", num_dropped);
+
+  return true;
+}
+
+void Trace::AppendEscapedString(std::string* dst, const char* str)
+{
+  for (; *str != '\0'; str++)
+  {
+    if (*str == '"' || *str == '\\')
+      dst->push_back('\\');
+    dst->push_back(*str);
+  }
+}
+
+#endif
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+
+class Error;
+
+/// Timeline tracing for diagnosing frame pacing. Zones are recorded into per-thread buffers while a capture is
+/// active, and written out in the Chrome trace event format (chrome://tracing, Perfetto) when it is stopped.
+/// Everything here compiles away unless ENABLE_TRACING is defined.
+namespace Trace {
+
+#ifdef ENABLE_TRACING
+
+namespace Internal {
+extern std::atomic_bool g_capturing;
+
+u64 GetTimestamp();
+void AddZone(const char* name, u64 start, u64 end);
+} // namespace Internal
+
+/// Returns true if a capture is in progress.
+ALWAYS_INLINE bool IsCapturing()
+{
+  return Internal::g_capturing.load(std::memory_order_relaxed);
+}
+
+/// Begins recording zones, discarding anything from a previous capture.
+void StartCapture();
+
+/// Stops recording and writes the captured zones to the specified file.
+bool StopCapture(const char* path, Error* error);
+
+/// Names the calling thread in the trace. Called by Threading::SetNameOfCurrentThread().
+void SetCurrentThreadName(const char* name);
+
+/// Records the time spent in the enclosing scope. Name must be a string literal, only the pointer is stored.
+class Zone
+{
+public:
+  ALWAYS_INLINE Zone(const char* name) : m_name(name), m_start(IsCapturing() ? Internal::GetTimestamp() : 0) {}
+  ALWAYS_INLINE ~Zone()
+  {
+    if (m_start != 0)
+      Internal::AddZone(m_name, m_start, Internal::GetTimestamp());
+  }
+
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+
+private:
+  const char* m_name;
+  u64 m_start;
+};
+
+#define TRACE_ZONE_CONCAT_(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_(a, b)
+#define TRACE_ZONE(name) Trace::Zone TRACE_ZONE_CONCAT(trace_zone_, __LINE__)(name)
+
+#else
+
+ALWAYS_INLINE bool IsCapturing()
+{
+  return false;
+}
+
+ALWAYS_INLINE void SetCurrentThreadName(const char* name)
+{
+}
+
+#define TRACE_ZONE(name)                                                                                               \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+
+#endif
+
+} // namespace Trace
@@ -26,6 +26,8 @@
 #include "common/scoped_guard.h"
 #include "common/small_string.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
+#include "common/timer.h"
 
 #include "util/cd_image.h"
 #include "util/http_downloader.h"
@@ -46,8 +48,10 @@
 #include <atomic>
 #include <cstdarg>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <functional>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -127,12 +131,15 @@ static void EnsureCacheDirectoriesExist();
 static void ClearGameInfo();
 static void ClearGameHash();
 static std::string GetGameHash(CDImage* image);
+static std::string GetGameHashForPath(const std::string& path, u32 subimage, bool load_patches);
 static void SetHardcoreMode(bool enabled, bool force_display_message);
 static bool IsLoggedInOrLoggingIn();
 static bool CanEnableHardcoreMode();
 static void ShowLoginSuccess(const rc_client_t* client);
 static void ShowLoginNotification();
 static void IdentifyGame(const std::string& path, CDImage* image);
+static void PollGameHash();
+static void FinishIdentifyGame(std::string path, std::string game_hash);
 static void BeginLoadGame();
 static void UpdateGameSummary();
 static void DownloadImage(std::string url, std::string cache_filename);
@@ -198,6 +205,11 @@ static std::unique_ptr<HTTPDownloader> s_http_downloader;
 
 static std::string s_game_path;
 static std::string s_game_hash;
+
+// Hash of the game being identified, computed on a worker. The game is loaded once it's ready.
+static std::future<std::string> s_pending_game_hash;
+static std::string s_pending_game_path;
+
 static std::string s_game_title;
 static std::string s_game_icon;
 static rc_client_user_game_summary_t s_game_summary;
@@ -225,6 +237,12 @@ static bool s_is_showing_all_leaderboard_entries = false;
 static std::vector<LeaderboardTrackerIndicator> s_active_leaderboard_trackers;
 static std::vector<AchievementChallengeIndicator> s_active_challenge_indicators;
 static std::optional<AchievementProgressIndicator> s_active_progress_indicator;
+
+// Time spent evaluating conditions in FrameUpdate(), averaged over FRAME_UPDATE_TIME_FRAMES frames.
+static constexpr u32 FRAME_UPDATE_TIME_FRAMES = 60;
+static Common::Timer::Value s_frame_update_time_accumulator = 0;
+static u32 s_frame_update_time_frames = 0;
+static float s_average_frame_update_time = 0.0f;
 } // namespace Achievements
 
 std::unique_lock<std::recursive_mutex> Achievements::GetLock()
@@ -305,6 +323,19 @@ std::string Achievements::GetGameHash(CDImage* image)
   return hash_str;
 }
 
+std::string Achievements::GetGameHashForPath(const std::string& path, u32 subimage, bool load_patches)
+{
+  Error error;
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str(), load_patches, &error);
+  if (!image || (subimage != 0 && !image->SwitchSubImage(subimage, &error)))
+  {
+    Log_ErrorFmt("Failed to open CD image '{}' for hashing: {}", path, error.GetDescription());
+    return {};
+  }
+
+  return GetGameHash(image.get());
+}
+
 void Achievements::DownloadImage(std::string url, std::string cache_filename)
 {
   auto callback = [cache_filename](s32 status_code, const std::string& content_type,
@@ -593,6 +624,14 @@ void Achievements::ClientMessageCallback(const char* message, const rc_client_t*
 
 uint32_t Achievements::ClientReadMemory(uint32_t address, uint8_t* buffer, uint32_t num_bytes, rc_client_t* client)
 {
+  // rcheevos only maps the first 2MB of RAM for PS1, so nearly every peek can be copied straight out of RAM, instead
+  // of going through the bus. rcheevos already reads each address once per frame, and shares it between conditions.
+  if (address < Bus::RAM_2MB_SIZE && num_bytes <= (Bus::RAM_2MB_SIZE - address))
+  {
+    std::memcpy(buffer, &Bus::g_ram[address], num_bytes);
+    return num_bytes;
+  }
+
   switch (num_bytes)
   {
     case 1:
@@ -658,6 +697,7 @@ void Achievements::IdleUpdate()
 
   const auto lock = GetLock();
 
+  PollGameHash();
   s_http_downloader->PollRequests();
   rc_client_idle(s_client);
 }
@@ -668,7 +708,7 @@ bool Achievements::NeedsIdleUpdate()
     return false;
 
   const auto lock = GetLock();
-  return (s_http_downloader && s_http_downloader->HasAnyRequests());
+  return (s_pending_game_hash.valid() || (s_http_downloader && s_http_downloader->HasAnyRequests()));
 }
 
 void Achievements::FrameUpdate()
@@ -686,12 +726,32 @@ void Achievements::FrameUpdate()
 
   auto lock = GetLock();
 
+  PollGameHash();
   s_http_downloader->PollRequests();
-  rc_client_do_frame(s_client);
+
+  {
+    System::ProfileSubsystemScope profile(System::ProfiledSubsystem::Achievements);
+    const Common::Timer::Value start_time = Common::Timer::GetCurrentValue();
+    rc_client_do_frame(s_client);
+    s_frame_update_time_accumulator += Common::Timer::GetCurrentValue() - start_time;
+    if ((++s_frame_update_time_frames) == FRAME_UPDATE_TIME_FRAMES)
+    {
+      s_average_frame_update_time =
+        static_cast<float>(Common::Timer::ConvertValueToMilliseconds(s_frame_update_time_accumulator) /
+                           static_cast<double>(FRAME_UPDATE_TIME_FRAMES));
+      s_frame_update_time_accumulator = 0;
+      s_frame_update_time_frames = 0;
+    }
+  }
 
   UpdateRichPresence(lock);
 }
 
+float Achievements::GetAverageFrameUpdateTime()
+{
+  return s_average_frame_update_time;
+}
+
 void Achievements::ClientEventHandler(const rc_client_event_t* event, rc_client_t* client)
 {
   switch (event->type)
@@ -815,36 +875,63 @@ void Achievements::GameChanged(const std::string& path, CDImage* image)
 
 void Achievements::IdentifyGame(const std::string& path, CDImage* image)
 {
-  if (s_game_path == path)
+  if (s_pending_game_hash.valid() ? (s_pending_game_path == path) : (s_game_path == path))
   {
     Log_WarningPrint("Game path is unchanged.");
     return;
   }
 
-  std::unique_ptr<CDImage> temp_image;
-  if (!path.empty() && (!image || (g_settings.achievements_use_first_disc_from_playlist && image->HasSubImages() &&
-                                   image->GetCurrentSubImage() != 0)))
+  // Any earlier request is stale now, its result is dropped when the worker finishes.
+  s_pending_game_hash = {};
+  s_pending_game_path = {};
+  if (path.empty())
+  {
+    FinishIdentifyGame(path, {});
+    return;
+  }
+
+  // The CD-ROM owns the image passed in, so the executable is read from a separate instance of it.
+  const u32 subimage =
+    (image && !g_settings.achievements_use_first_disc_from_playlist) ? image->GetCurrentSubImage() : 0;
+  const bool load_patches = g_settings.cdrom_load_image_patches;
+  if (IsUsingRAIntegration())
   {
-    temp_image = CDImage::Open(path.c_str(), g_settings.cdrom_load_image_patches, nullptr);
-    image = temp_image.get();
-    if (!temp_image)
-      Log_ErrorPrintf("Failed to open temporary CD image '%s'", path.c_str());
+    FinishIdentifyGame(path, GetGameHashForPath(path, subimage, load_patches));
+    return;
   }
 
-  std::string game_hash;
-  if (image)
-    game_hash = GetGameHash(image);
+  // Reading the executable from compressed images can take a while, so emulation starts without waiting for it.
+  // Hardcore restrictions stay in place until the game is loaded, or turns out not to be supported.
+  s_pending_game_path = path;
+  s_pending_game_hash = Threading::ThreadPool::GetShared().Submit(
+    [path, subimage, load_patches]() { return GetGameHashForPath(path, subimage, load_patches); });
+}
 
+void Achievements::PollGameHash()
+{
+  if (!s_pending_game_hash.valid() ||
+      s_pending_game_hash.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return;
+  }
+
+  std::string game_hash = s_pending_game_hash.get();
+  FinishIdentifyGame(std::move(s_pending_game_path), std::move(game_hash));
+  s_pending_game_path = {};
+}
+
+void Achievements::FinishIdentifyGame(std::string path, std::string game_hash)
+{
   if (s_game_hash == game_hash)
   {
     // only the path has changed - different format/save state/etc.
     Log_InfoPrintf("Detected path change from '%s' to '%s'", s_game_path.c_str(), path.c_str());
-    s_game_path = path;
+    s_game_path = std::move(path);
     return;
   }
 
   ClearGameHash();
-  s_game_path = path;
+  s_game_path = std::move(path);
   s_game_hash = std::move(game_hash);
 
 #ifdef ENABLE_RAINTEGRATION
@@ -871,6 +958,10 @@ void Achievements::IdentifyGame(const std::string& path, CDImage* image)
 
 void Achievements::BeginLoadGame()
 {
+  // started once the hash is ready
+  if (s_pending_game_hash.valid())
+    return;
+
   // cancel previous requests
   if (s_load_game_request)
   {
@@ -1002,6 +1093,8 @@ void Achievements::ClearGameHash()
 {
   s_game_path = {};
   std::string().swap(s_game_hash);
+  s_pending_game_hash = {};
+  s_pending_game_path = {};
 }
 
 void Achievements::DisplayAchievementSummary()
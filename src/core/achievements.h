@@ -55,6 +55,9 @@ void OnSystemPaused(bool paused);
 /// Called once a frame at vsync time on the CPU thread.
 void FrameUpdate();
 
+/// Returns the average time taken to evaluate achievements in FrameUpdate() over the last second, in milliseconds.
+float GetAverageFrameUpdateTime();
+
 /// Called when the system is paused, because FrameUpdate() won't be getting called.
 void IdleUpdate();
 
@@ -28,8 +28,11 @@
 #include "common/intrin.h"
 #include "common/log.h"
 #include "common/memmap.h"
+#include "common/memory_accounting.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <tuple>
 #include <utility>
 
@@ -105,6 +108,7 @@ union MEMCTRL
 } // namespace
 
 static void* s_shmem_handle = nullptr;
+static bool s_use_huge_pages = false;
 
 std::bitset<RAM_8MB_CODE_PAGE_COUNT> g_ram_code_bits{};
 u8* g_ram = nullptr;
@@ -138,6 +142,7 @@ static std::vector<std::pair<u8*, size_t>> s_fastmem_ram_views;
 static u8** s_fastmem_lut = nullptr;
 
 static void SetRAMSize(bool enable_8mb_ram);
+static void LoadChangedRAMPages(StateWrapper& sw);
 
 static std::tuple<TickCount, TickCount, TickCount> CalculateMemoryTiming(MEMDELAY mem_delay, COMDELAY common_delay);
 static void RecalculateMemoryTimings();
@@ -174,7 +179,7 @@ static constexpr size_t TOTAL_SIZE = LUT_OFFSET + LUT_SIZE;
 #define FIXUP_WORD_WRITE_VALUE(size, offset, value)                                                                    \
   ((size == MemoryAccessSize::Word) ? (value) : ((value) << (((offset) & 3u) * 8)))
 
-bool Bus::AllocateMemory(Error* error)
+bool Bus::AllocateMemory(bool use_huge_pages, Error* error)
 {
   s_shmem_handle =
     MemMap::CreateSharedMemory(MemMap::GetFileMappingName("duckstation").c_str(), MemoryMap::TOTAL_SIZE, error);
@@ -202,6 +207,23 @@ bool Bus::AllocateMemory(Error* error)
 
   Log_VerboseFmt("RAM is mapped at {}.", static_cast<void*>(g_ram));
 
+  // Code pages in g_ram get write-protected individually, which splits its huge pages. The unprotected view, DMA and
+  // the fastmem views of pages without code, still benefit from the huge backing pages.
+  s_use_huge_pages = use_huge_pages;
+  if (use_huge_pages)
+  {
+    if (MemMap::AdviseHugePages(g_ram, MemoryMap::RAM_SIZE) &&
+        MemMap::AdviseHugePages(g_unprotected_ram, MemoryMap::RAM_SIZE))
+    {
+      Log_InfoPrint("Using huge pages for RAM.");
+    }
+    else
+    {
+      Log_WarningPrint("Huge pages are not available for RAM, using normal pages.");
+      s_use_huge_pages = false;
+    }
+  }
+
   g_bios = static_cast<u8*>(MemMap::MapSharedMemory(s_shmem_handle, MemoryMap::BIOS_OFFSET, nullptr,
                                                     MemoryMap::BIOS_SIZE, PageProtect::ReadWrite));
   if (!g_bios)
@@ -241,6 +263,7 @@ bool Bus::AllocateMemory(Error* error)
   Exports::RAM = reinterpret_cast<uintptr_t>(g_unprotected_ram);
 #endif
 
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::EmulatedMemory, MemoryMap::TOTAL_SIZE);
   return true;
 }
 
@@ -259,6 +282,7 @@ void Bus::ReleaseMemory()
 
   std::free(s_fastmem_lut);
   s_fastmem_lut = nullptr;
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::FastmemLUT, 0);
 
   g_memory_handlers_isc = nullptr;
   if (g_memory_handlers)
@@ -290,6 +314,8 @@ void Bus::ReleaseMemory()
     MemMap::DestroySharedMemory(s_shmem_handle);
     s_shmem_handle = nullptr;
   }
+
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::EmulatedMemory, 0);
 }
 
 bool Bus::Initialize()
@@ -371,12 +397,17 @@ void Bus::AddTTYString(std::string_view str)
     AddTTYCharacter(ch);
 }
 
-bool Bus::DoState(StateWrapper& sw)
+bool Bus::DoState(StateWrapper& sw, bool is_memory_state)
 {
   u32 ram_size = g_ram_size;
   sw.DoEx(&ram_size, 52, static_cast<u32>(RAM_2MB_SIZE));
-  if (ram_size != g_ram_size)
+  const bool ram_size_changed = (ram_size != g_ram_size);
+  if (ram_size_changed)
   {
+    // non-memory states have already reset the code cache
+    if (is_memory_state)
+      CPU::CodeCache::InvalidateAllRAMBlocks();
+
     const bool using_8mb_ram = (ram_size == RAM_8MB_SIZE);
     SetRAMSize(using_8mb_ram);
     UpdateFastmemViews(s_fastmem_mode);
@@ -388,7 +419,11 @@ bool Bus::DoState(StateWrapper& sw)
   sw.Do(&g_bios_access_time);
   sw.Do(&g_cdrom_access_time);
   sw.Do(&g_spu_access_time);
-  sw.DoBytes(g_ram, g_ram_size);
+
+  if (sw.IsReading() && is_memory_state && !ram_size_changed)
+    LoadChangedRAMPages(sw);
+  else
+    sw.DoBytes(g_ram, g_ram_size);
 
   if (sw.GetVersion() < 58)
   {
@@ -402,6 +437,26 @@ bool Bus::DoState(StateWrapper& sw)
   return !sw.HasError();
 }
 
+void Bus::LoadChangedRAMPages(StateWrapper& sw)
+{
+  // Runahead and rewind states are loaded over RAM that is mostly the same as the state. Only copy the pages which
+  // differ, and only throw away the code in those pages, instead of invalidating every block in RAM.
+  alignas(16) u8 page_data[HOST_PAGE_SIZE];
+  for (u32 page_index = 0, offset = 0; offset < g_ram_size; page_index++, offset += HOST_PAGE_SIZE)
+  {
+    const u32 size = std::min(g_ram_size - offset, HOST_PAGE_SIZE);
+    sw.DoBytes(page_data, size);
+    if (std::memcmp(&g_ram[offset], page_data, size) == 0)
+      continue;
+
+    // has to happen first, the page is write-protected if it has code
+    if (g_ram_code_bits[page_index])
+      CPU::CodeCache::InvalidateRAMPageBlocks(page_index);
+
+    std::memcpy(&g_ram[offset], page_data, size);
+  }
+}
+
 void Bus::SetExpansionROM(std::vector<u8> data)
 {
   s_exp1_rom = std::move(data);
@@ -510,6 +565,9 @@ void Bus::UpdateFastmemViews(CPUFastmemMode mode)
         return;
       }
 
+      if (s_use_huge_pages)
+        MemMap::AdviseHugePages(map_address, g_ram_size);
+
       // mark all pages with code as non-writable
       for (u32 i = 0; i < static_cast<u32>(g_ram_code_bits.size()); i++)
       {
@@ -545,6 +603,7 @@ void Bus::UpdateFastmemViews(CPUFastmemMode mode)
   {
     s_fastmem_lut = static_cast<u8**>(std::malloc(sizeof(u8*) * FASTMEM_LUT_SLOTS));
     Assert(s_fastmem_lut);
+    MemoryAccounting::SetHostBytes(MemoryAccounting::Category::FastmemLUT, sizeof(u8*) * FASTMEM_LUT_SLOTS);
 
     Log_InfoPrintf("Fastmem base (software): %p", s_fastmem_lut);
   }
@@ -945,6 +1004,42 @@ void Bus::RAMWriteHandler(VirtualMemoryAddress address, u32 value)
 {
   const u32 offset = address & g_ram_mask;
 
+  // Stores to pages holding code go through the unprotected view, so only the blocks they overlap are invalidated.
+  if (g_ram_code_bits[offset / HOST_PAGE_SIZE]) [[unlikely]]
+  {
+    if constexpr (size == MemoryAccessSize::Byte)
+    {
+      if (g_unprotected_ram[offset] != Truncate8(value))
+      {
+        g_unprotected_ram[offset] = Truncate8(value);
+        CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u8));
+      }
+    }
+    else if constexpr (size == MemoryAccessSize::HalfWord)
+    {
+      const u16 new_value = Truncate16(value);
+      u16 old_value;
+      std::memcpy(&old_value, &g_unprotected_ram[offset], sizeof(old_value));
+      if (old_value != new_value)
+      {
+        std::memcpy(&g_unprotected_ram[offset], &new_value, sizeof(u16));
+        CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u16));
+      }
+    }
+    else if constexpr (size == MemoryAccessSize::Word)
+    {
+      u32 old_value;
+      std::memcpy(&old_value, &g_unprotected_ram[offset], sizeof(u32));
+      if (old_value != value)
+      {
+        std::memcpy(&g_unprotected_ram[offset], &value, sizeof(u32));
+        CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u32));
+      }
+    }
+
+    return;
+  }
+
   if constexpr (size == MemoryAccessSize::Byte)
   {
     g_ram[offset] = Truncate8(value);
@@ -111,13 +111,14 @@ enum : u32
 static constexpr size_t FASTMEM_ARENA_SIZE = UINT64_C(0x100000000);
 #endif
 
-bool AllocateMemory(Error* error);
+/// Backs RAM with huge pages when use_huge_pages is set and the host supports it.
+bool AllocateMemory(bool use_huge_pages, Error* error);
 void ReleaseMemory();
 
 bool Initialize();
 void Shutdown();
 void Reset();
-bool DoState(StateWrapper& sw);
+bool DoState(StateWrapper& sw, bool is_memory_state);
 
 using MemoryReadHandler = u32 (*)(VirtualMemoryAddress address);
 using MemoryWriteHandler = void (*)(VirtualMemoryAddress, u32);
@@ -21,6 +21,7 @@
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
 #include "common/file_system.h"
+#include "common/gsvector.h"
 #include "common/heap_array.h"
 #include "common/intrin.h"
 #include "common/log.h"
@@ -819,7 +820,20 @@ bool CDROM::PrecacheMedia()
   }
 
   HostInterfaceProgressCallback callback;
-  if (!s_reader.Precache(&callback))
+  const CDImage::PrecacheResult res =
+    s_reader.Precache(&callback, static_cast<u64>(g_settings.cdrom_preload_memory_limit) * 1048576);
+  if (res == CDImage::PrecacheResult::TooLarge)
+  {
+    Host::AddFormattedOSDMessage(
+      15.0f, TRANSLATE("OSDMessage", "CD image is larger than the preload limit of %u MB, it will be read from disk."),
+      g_settings.cdrom_preload_memory_limit);
+    return false;
+  }
+  else if (res == CDImage::PrecacheResult::Cancelled)
+  {
+    return false;
+  }
+  else if (res != CDImage::PrecacheResult::Success)
   {
     Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Precaching CD image failed, it may be unreliable."), 15.0f);
     return false;
@@ -849,6 +863,16 @@ void CDROM::SetReadaheadSectors(u32 readahead_sectors)
     s_reader.QueueReadSector(s_requested_lba);
 }
 
+u32 CDROM::GetReadaheadHits()
+{
+  return s_reader.GetReadaheadHits();
+}
+
+u32 CDROM::GetReadaheadMisses()
+{
+  return s_reader.GetReadaheadMisses();
+}
+
 void CDROM::CPUClockChanged()
 {
   // reschedule the disc read event
@@ -2931,7 +2955,7 @@ ALWAYS_INLINE_RELEASE void CDROM::ProcessDataSector(const u8* raw_sector, const
   SetAsyncInterrupt(Interrupt::DataReady);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
+static constexpr std::array<std::array<s16, 29>, 7> s_zigzag_table = {
   {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
     0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
     0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
@@ -2954,13 +2978,51 @@ static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
     0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
     0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
 
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
+// The zigzag tables rearranged to apply to the ring buffer rotated so that the write position is first, i.e.
+// window[k] = ringbuf[(p + k) & 0x1F]. Tap i reads ringbuf[(p - i) & 0x1F], which is window[(32 - i) & 0x1F], and
+// window[1..3] are never read, so they get zero taps.
+static constexpr std::array<std::array<s16, 32>, 7> s_zigzag_window_taps = []() {
+  std::array<std::array<s16, 32>, 7> ret = {};
+  for (u32 j = 0; j < 7; j++)
+  {
+    for (u32 i = 0; i < 29; i++)
+      ret[j][(32 - i) % 32] = s_zigzag_table[j][i];
+  }
+  return ret;
+}();
+
+static void RotateZigZagWindow(s16* window, const s16* ringbuf, u8 p)
 {
-  s32 sum = 0;
-  for (u8 i = 0; i < 29; i++)
-    sum += (s32(ringbuf[(p - i) & 0x1F]) * s32(table[i])) / 0x8000;
+  std::memcpy(window, &ringbuf[p], sizeof(s16) * (32 - p));
+  std::memcpy(&window[32 - p], ringbuf, sizeof(s16) * p);
+}
 
-  return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+static s16 ZigZagInterpolate(const s16* window, const s16* taps)
+{
+  // Each product is divided (truncating towards zero) before summing, so a widening multiply-add can't be used.
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  const GSVector4i round_mask = GSVector4i::broadcast32(0x7FFF);
+  GSVector4i sum = GSVector4i::zero();
+  for (u32 i = 0; i < 32; i += 8)
+  {
+    // Widen the products by interleaving the low and high halves.
+    const GSVector4i s = GSVector4i::load<false>(&window[i]);
+    const GSVector4i t = GSVector4i::load<false>(&taps[i]);
+    const GSVector4i lo = s.mul16l(t);
+    const GSVector4i hi = s.mul16hs(t);
+    const GSVector4i p0 = lo.upl16(hi);
+    const GSVector4i p1 = lo.uph16(hi);
+    sum = sum.add32(p0.add32(p0.sra32<31>() & round_mask).sra32<15>());
+    sum = sum.add32(p1.add32(p1.sra32<31>() & round_mask).sra32<15>());
+  }
+  const s32 total = sum.addv_s32();
+#else
+  s32 total = 0;
+  for (u32 i = 0; i < 32; i++)
+    total += (s32(window[i]) * s32(taps[i])) / 0x8000;
+#endif
+
+  return static_cast<s16>(std::clamp<s32>(total, -0x8000, 0x7FFF));
 }
 
 std::tuple<s16, s16> CDROM::GetAudioFrame()
@@ -3027,10 +3089,19 @@ void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
       if (sixstep == 0)
       {
         sixstep = 6;
-        for (u32 j = 0; j < 7; j++)
+
+        // All seven outputs use the same window, so only rotate it once.
+        std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE> left_window;
+        std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE> right_window;
+        RotateZigZagWindow(left_window.data(), left_ringbuf, p);
+        if constexpr (STEREO)
+          RotateZigZagWindow(right_window.data(), right_ringbuf, p);
+
+        for (u32 j = 0; j < XA_RESAMPLE_NUM_ZIGZAG_TABLES; j++)
         {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
+          const s16 left_interp = ZigZagInterpolate(left_window.data(), s_zigzag_window_taps[j].data());
+          const s16 right_interp =
+            STEREO ? ZigZagInterpolate(right_window.data(), s_zigzag_window_taps[j].data()) : left_interp;
           AddCDAudioFrame(left_interp, right_interp);
         }
       }
@@ -3412,6 +3483,14 @@ void CDROM::DrawDebugWindow()
       ImGui::Text("Last Sector: %02X:%02X:%02X (Mode %u)", s_last_sector_header.minute, s_last_sector_header.second,
                   s_last_sector_header.frame, s_last_sector_header.sector_mode);
 
+      if (s_reader.IsUsingThread())
+      {
+        ImGui::Text("Readahead: Depth[%u/%u] Hits[%u] Misses[%u] Run[%u] Longest Run[%u]",
+                    s_reader.GetReadaheadDepth(), s_reader.GetReadaheadCount(), s_reader.GetReadaheadHits(),
+                    s_reader.GetReadaheadMisses(), s_reader.GetSequentialRunLength(),
+                    s_reader.GetLongestSequentialRunLength());
+      }
+
       if (s_show_current_file)
       {
         if (media->GetTrackNumber() == 1)
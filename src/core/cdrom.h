@@ -41,6 +41,10 @@ void DrawDebugWindow();
 
 void SetReadaheadSectors(u32 readahead_sectors);
 
+/// Returns the number of sector reads which were/weren't satisfied by readahead. Zero when readahead is disabled.
+u32 GetReadaheadHits();
+u32 GetReadaheadMisses();
+
 /// Reads a frame from the audio FIFO, used by the SPU.
 std::tuple<s16, s16> GetAudioFrame();
 
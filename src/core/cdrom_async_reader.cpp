@@ -2,9 +2,15 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "cdrom_async_reader.h"
+#include "system.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "common/timer.h"
+#include "common/trace.h"
+
+#include <algorithm>
+
 Log_SetChannel(CDROMAsyncReader);
 
 CDROMAsyncReader::CDROMAsyncReader() = default;
@@ -22,6 +28,7 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
   m_buffers.clear();
   m_buffers.resize(readahead_count);
   EmptyBuffers();
+  ResetReadaheadStatistics();
 
   m_shutdown_flag.store(false);
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
@@ -50,6 +57,7 @@ void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
     CancelReadahead();
 
   m_media = std::move(media);
+  ResetReadaheadStatistics();
 }
 
 std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
@@ -60,22 +68,25 @@ std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
   return std::move(m_media);
 }
 
-bool CDROMAsyncReader::Precache(ProgressCallback* callback)
+CDImage::PrecacheResult CDROMAsyncReader::Precache(ProgressCallback* callback, u64 max_size)
 {
   WaitForIdle();
 
   std::unique_lock lock(m_mutex);
   if (!m_media)
-    return false;
+    return CDImage::PrecacheResult::Unsupported;
   else if (m_media->IsPrecached())
-    return true;
+    return CDImage::PrecacheResult::Success;
 
   EmptyBuffers();
 
-  const CDImage::PrecacheResult res = m_media->Precache(callback);
+  const CDImage::PrecacheResult res = m_media->Precache(callback, max_size);
   if (res == CDImage::PrecacheResult::Unsupported)
   {
     // fall back to copy precaching
+    if ((static_cast<u64>(m_media->GetLBACount()) * CDImage::RAW_SECTOR_SIZE) > max_size)
+      return CDImage::PrecacheResult::TooLarge;
+
     std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(m_media.get(), callback);
     if (memory_image)
     {
@@ -83,20 +94,20 @@ bool CDROMAsyncReader::Precache(ProgressCallback* callback)
       if (!memory_image->Seek(lba))
       {
         Log_ErrorPrintf("Failed to seek to LBA %u in memory image", lba);
-        return false;
+        return CDImage::PrecacheResult::ReadError;
       }
 
       m_media.reset();
       m_media = std::move(memory_image);
-      return true;
+      return CDImage::PrecacheResult::Success;
     }
     else
     {
-      return false;
+      return CDImage::PrecacheResult::ReadError;
     }
   }
 
-  return (res == CDImage::PrecacheResult::Success);
+  return res;
 }
 
 void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
@@ -125,6 +136,7 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     {
       // great, don't need a seek, but still kick the thread to start reading ahead again
       Log_DebugPrintf("Readahead buffer hit for sector %u", lba);
+      UpdateReadaheadDepth(true);
       m_buffer_front.store(next_buffer);
       m_buffer_count.fetch_sub(1);
       m_can_readahead.store(true);
@@ -135,6 +147,7 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
 
   // we need to toss away our readahead and start fresh
   Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
+  UpdateReadaheadDepth(false);
   std::unique_lock<std::mutex> lock(m_mutex);
   m_next_position_set.store(true);
   m_next_position = lba;
@@ -165,6 +178,9 @@ bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ
 
 bool CDROMAsyncReader::InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
 {
+  TRACE_ZONE("CDROMAsyncReader::ReadSectorUncached");
+  System::ProfileSubsystemScope profile(System::ProfiledSubsystem::CDROMRead);
+
   if (m_media->GetPositionOnDisc() != lba && !m_media->Seek(lba))
   {
     Log_WarningPrintf("Seek to LBA %u failed", lba);
@@ -226,8 +242,49 @@ void CDROMAsyncReader::EmptyBuffers()
   m_buffer_count.store(0);
 }
 
+void CDROMAsyncReader::ResetReadaheadStatistics()
+{
+  m_readahead_depth.store(static_cast<u32>(m_buffers.size()), std::memory_order_relaxed);
+  m_readahead_hits = 0;
+  m_readahead_misses = 0;
+  m_sequential_run_length = 0;
+  m_longest_sequential_run_length = 0;
+}
+
+void CDROMAsyncReader::UpdateReadaheadDepth(bool hit)
+{
+  const u32 max_depth = static_cast<u32>(m_buffers.size());
+  const u32 min_depth = std::min(MIN_READAHEAD_DEPTH, max_depth);
+  const u32 depth = m_readahead_depth.load(std::memory_order_relaxed);
+  u32 new_depth = depth;
+  if (hit)
+  {
+    // Streaming, read further ahead once the run has used up what we're currently reading.
+    m_readahead_hits++;
+    m_sequential_run_length++;
+    m_longest_sequential_run_length = std::max(m_longest_sequential_run_length, m_sequential_run_length);
+    if (m_sequential_run_length >= depth)
+      new_depth = std::min(depth * 2, max_depth);
+  }
+  else
+  {
+    // Most of the readahead for a run this short was wasted.
+    m_readahead_misses++;
+    if (m_sequential_run_length < (depth / 2))
+      new_depth = std::max(depth / 2, min_depth);
+    m_sequential_run_length = 0;
+  }
+
+  if (new_depth != depth)
+  {
+    Log_DebugPrintf("Readahead depth %u -> %u", depth, new_depth);
+    m_readahead_depth.store(new_depth, std::memory_order_relaxed);
+  }
+}
+
 bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
 {
+  TRACE_ZONE("CDROMAsyncReader::ReadSector");
   Common::Timer timer;
 
   const u32 slot = m_buffer_back.load();
@@ -240,7 +297,10 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
 
   Log_TracePrintf("Reading LBA %u...", buffer.lba);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  {
+    System::ProfileSubsystemScope profile(System::ProfiledSubsystem::CDROMRead);
+    buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  }
   if (buffer.result)
   {
     const double read_time = timer.GetTimeMilliseconds();
@@ -261,6 +321,7 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
 
 void CDROMAsyncReader::ReadSectorNonThreaded(CDImage::LBA lba)
 {
+  TRACE_ZONE("CDROMAsyncReader::ReadSector");
   Common::Timer timer;
 
   m_buffers.resize(1);
@@ -279,7 +340,10 @@ void CDROMAsyncReader::ReadSectorNonThreaded(CDImage::LBA lba)
 
   Log_TracePrintf("Reading LBA %u...", buffer.lba);
 
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  {
+    System::ProfileSubsystemScope profile(System::ProfiledSubsystem::CDROMRead);
+    buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+  }
   if (buffer.result)
   {
     const double read_time = timer.GetTimeMilliseconds();
@@ -310,6 +374,9 @@ void CDROMAsyncReader::CancelReadahead()
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
+  Threading::SetNameOfCurrentThread("CDROM Reader");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Background);
+
   std::unique_lock lock(m_mutex);
 
   for (;;)
@@ -359,9 +426,11 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
       if (!m_can_readahead.load())
         break;
 
-      // readahead time! read as many sectors as we have space for
-      Log_DebugPrintf("Reading ahead %u sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
+      // readahead time! read as many sectors as the current depth allows
+      const u32 depth =
+        std::clamp(m_readahead_depth.load(std::memory_order_relaxed), 1u, static_cast<u32>(m_buffers.size()));
+      Log_DebugPrintf("Reading ahead %u sectors...", depth - std::min(m_buffer_count.load(), depth));
+      while (m_buffer_count.load() < depth)
       {
         if (m_next_position_set.load())
         {
@@ -33,6 +33,11 @@ public:
   u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
   bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
   u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  u32 GetReadaheadDepth() const { return m_readahead_depth.load(std::memory_order_relaxed); }
+  u32 GetReadaheadHits() const { return m_readahead_hits; }
+  u32 GetReadaheadMisses() const { return m_readahead_misses; }
+  u32 GetSequentialRunLength() const { return m_sequential_run_length; }
+  u32 GetLongestSequentialRunLength() const { return m_longest_sequential_run_length; }
 
   bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
@@ -47,7 +52,8 @@ public:
   std::unique_ptr<CDImage> RemoveMedia();
 
   /// Precaches image, either to memory, or using the underlying image precache.
-  bool Precache(ProgressCallback* callback);
+  /// Images which would take more than max_size bytes are left alone, and still read from disk.
+  CDImage::PrecacheResult Precache(ProgressCallback* callback, u64 max_size);
 
   void QueueReadSector(CDImage::LBA lba);
 
@@ -58,7 +64,12 @@ public:
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
 private:
+  // Readahead depth never shrinks below this, since a seek almost always reads a few sectors.
+  static constexpr u32 MIN_READAHEAD_DEPTH = 2;
+
   void EmptyBuffers();
+  void ResetReadaheadStatistics();
+  void UpdateReadaheadDepth(bool hit);
   bool ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock);
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
@@ -85,4 +96,14 @@ private:
   std::atomic<u32> m_buffer_front{0};
   std::atomic<u32> m_buffer_back{0};
   std::atomic<u32> m_buffer_count{0};
+
+  // Number of sectors the worker reads ahead, at most the buffer count. Grows while reads stay sequential, and
+  // shrinks when seeks cut runs short, so random access doesn't waste I/O on sectors which get thrown away.
+  std::atomic<u32> m_readahead_depth{0};
+
+  // Only accessed from the CPU thread.
+  u32 m_readahead_hits = 0;
+  u32 m_readahead_misses = 0;
+  u32 m_sequential_run_length = 0;
+  u32 m_longest_sequential_run_length = 0;
 };
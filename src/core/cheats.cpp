@@ -4,8 +4,10 @@
 #include "cheats.h"
 #include "bus.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/byte_stream.h"
 #include "common/file_system.h"
+#include "common/intrin.h"
 #include "common/log.h"
 #include "common/small_string.h"
 #include "common/string_util.h"
@@ -14,9 +16,13 @@
 #include "cpu_core.h"
 #include "host.h"
 #include "system.h"
+#include <algorithm>
+#include <bit>
 #include <cctype>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 Log_SetChannel(Cheats);
 static std::array<u32, 256> cht_register; // Used for D7 ,51 & 52 cheat types
@@ -948,6 +954,7 @@ bool CheatCode::SetInstructionsFromString(const std::string& str)
     return false;
 
   instructions = std::move(new_instructions);
+  compiled = {};
   return true;
 }
 
@@ -990,8 +997,153 @@ u32 CheatCode::GetNextNonConditionalInstruction(u32 index) const
   return index;
 }
 
+bool CheatCode::Compile() const
+{
+  if (compiled.instructions == instructions.data() && compiled.instruction_count == instructions.size() &&
+      compiled.ram_mask == Bus::g_ram_mask)
+  {
+    return compiled.valid;
+  }
+
+  compiled = {};
+  compiled.instructions = instructions.data();
+  compiled.instruction_count = static_cast<u32>(instructions.size());
+  compiled.ram_mask = Bus::g_ram_mask;
+
+  // Resolve every byte written to its destination. Later writes to the same byte replace earlier ones.
+  struct ByteWrite
+  {
+    u32 offset;
+    bool scratchpad;
+    u8 value;
+  };
+  std::vector<ByteWrite> byte_writes;
+  const auto add_write = [&byte_writes](VirtualMemoryAddress address, u32 value, u32 size) {
+    for (u32 i = 0; i < size; i++, address++, value >>= 8)
+    {
+      const u32 segment = (address >> 29);
+      if ((segment == 0 || segment == 4) && (address & CPU::SCRATCHPAD_ADDR_MASK) == CPU::SCRATCHPAD_ADDR)
+      {
+        byte_writes.push_back({address & CPU::SCRATCHPAD_OFFSET_MASK, true, Truncate8(value)});
+        continue;
+      }
+
+      const PhysicalMemoryAddress phys_address = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+      if ((segment != 0 && segment != 4 && segment != 5) || phys_address >= Bus::RAM_MIRROR_END)
+        return false;
+
+      byte_writes.push_back({phys_address & Bus::g_ram_mask, false, Truncate8(value)});
+    }
+
+    return true;
+  };
+
+  for (const Instruction& inst : instructions)
+  {
+    bool result;
+    switch (inst.code)
+    {
+      case InstructionCode::Nop:
+        result = true;
+        break;
+      case InstructionCode::ConstantWrite8:
+        result = add_write(inst.address, inst.value8, sizeof(u8));
+        break;
+      case InstructionCode::ConstantWrite16:
+        result = add_write(inst.address, inst.value16, sizeof(u16));
+        break;
+      case InstructionCode::ExtConstantWrite32:
+        result = add_write(inst.address, inst.value32, sizeof(u32));
+        break;
+      case InstructionCode::ScratchpadWrite16:
+        result = add_write(CPU::SCRATCHPAD_ADDR | (inst.address & CPU::SCRATCHPAD_OFFSET_MASK), inst.value16,
+                           sizeof(u16));
+        break;
+      case InstructionCode::ExtScratchpadWrite32:
+        result = add_write(CPU::SCRATCHPAD_ADDR | (inst.address & CPU::SCRATCHPAD_OFFSET_MASK), inst.value32,
+                           sizeof(u32));
+        break;
+      default:
+        result = false;
+        break;
+    }
+
+    if (!result)
+      return false;
+  }
+
+  std::stable_sort(byte_writes.begin(), byte_writes.end(), [](const ByteWrite& lhs, const ByteWrite& rhs) {
+    return (lhs.scratchpad != rhs.scratchpad) ? lhs.scratchpad : (lhs.offset < rhs.offset);
+  });
+
+  // Merge contiguous bytes into a single copy.
+  for (size_t i = 0; i < byte_writes.size(); i++)
+  {
+    const ByteWrite& bw = byte_writes[i];
+    if (i + 1 < byte_writes.size() && byte_writes[i + 1].offset == bw.offset &&
+        byte_writes[i + 1].scratchpad == bw.scratchpad)
+    {
+      continue;
+    }
+
+    if (!compiled.writes.empty())
+    {
+      CompiledWrite& last = compiled.writes.back();
+      if (last.scratchpad == bw.scratchpad && (last.offset + last.length) == bw.offset)
+      {
+        last.length++;
+        compiled.data.push_back(bw.value);
+        continue;
+      }
+    }
+
+    compiled.writes.push_back({bw.offset, static_cast<u32>(compiled.data.size()), 1, bw.scratchpad});
+    compiled.data.push_back(bw.value);
+  }
+
+  compiled.valid = true;
+  return true;
+}
+
+void CheatCode::ApplyCompiled() const
+{
+  for (const CompiledWrite& write : compiled.writes)
+  {
+    const u8* src = &compiled.data[write.data_offset];
+    if (write.scratchpad)
+    {
+      std::memcpy(&CPU::g_state.scratchpad[write.offset], src, write.length);
+      continue;
+    }
+
+    // Same as the safe write path, only invalidate code if the contents actually change.
+    u8* dst = &Bus::g_unprotected_ram[write.offset];
+    if (std::memcmp(dst, src, write.length) == 0)
+      continue;
+
+    std::memcpy(dst, src, write.length);
+
+    const u32 first_page = write.offset / HOST_PAGE_SIZE;
+    const u32 last_page = (write.offset + write.length - 1) / HOST_PAGE_SIZE;
+    for (u32 page = first_page; page <= last_page; page++)
+    {
+      if (Bus::g_ram_code_bits[page])
+      {
+        CPU::CodeCache::InvalidateBlocksInRange(write.offset, write.length);
+        break;
+      }
+    }
+  }
+}
+
 void CheatCode::Apply() const
 {
+  if (Compile())
+  {
+    ApplyCompiled();
+    return;
+  }
+
   const u32 count = static_cast<u32>(instructions.size());
   u32 index = 0;
   for (; index < count;)
@@ -2815,6 +2967,302 @@ std::optional<CheatCode::Activation> CheatCode::ParseActivationName(const char*
   return std::nullopt;
 }
 
+namespace {
+struct ScanChunk
+{
+  const u8* values;
+  const u8* last_values;
+  u64* candidates;
+  PhysicalMemoryAddress address;
+  u32 first_word;
+  u32 end_word;
+  u32 num_slots;
+  u32 comp_value;
+  bool new_search;
+  u32 result_count;
+};
+} // namespace
+
+using ScanChunkFunction = void (*)(ScanChunk& chunk);
+
+static constexpr u32 MAX_SEARCH_THREADS = 8;
+static constexpr u32 MIN_WORDS_PER_SEARCH_THREAD = 4096;
+
+/// Copies memory for searching. RAM is copied directly, everything else goes through the bus.
+static void ReadScanMemory(PhysicalMemoryAddress address, u32 length, u8* dst)
+{
+  while (length > 0)
+  {
+    const bool is_scratchpad = ((address & CPU::SCRATCHPAD_ADDR_MASK) == CPU::SCRATCHPAD_ADDR);
+    const PhysicalMemoryAddress phys_address = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+    if (!is_scratchpad && phys_address < Bus::RAM_MIRROR_END)
+    {
+      const u32 offset = phys_address & Bus::g_ram_mask;
+      const u32 count =
+        std::min(length, std::min(Bus::g_ram_size - offset, static_cast<u32>(Bus::RAM_MIRROR_END) - phys_address));
+      std::memcpy(dst, &Bus::g_ram[offset], count);
+      address += count;
+      dst += count;
+      length -= count;
+    }
+    else
+    {
+      *(dst++) = DoMemoryRead<u8>(address++);
+      length--;
+    }
+  }
+}
+
+template<typename T, bool is_signed>
+ALWAYS_INLINE static u32 ExtendScanValue(T value)
+{
+  if constexpr (is_signed)
+    return SignExtend32(value);
+  else
+    return ZeroExtend32(value);
+}
+
+template<MemoryScan::Operator op, bool is_signed>
+ALWAYS_INLINE static bool TestScanValue(u32 value, u32 last_value, u32 comp_value)
+{
+  using Operator = MemoryScan::Operator;
+
+  if constexpr (op == Operator::Equal)
+    return (value == comp_value);
+  else if constexpr (op == Operator::NotEqual)
+    return (value != comp_value);
+  else if constexpr (op == Operator::GreaterThan)
+    return is_signed ? (static_cast<s32>(value) > static_cast<s32>(comp_value)) : (value > comp_value);
+  else if constexpr (op == Operator::GreaterEqual)
+    return is_signed ? (static_cast<s32>(value) >= static_cast<s32>(comp_value)) : (value >= comp_value);
+  else if constexpr (op == Operator::LessThan)
+    return is_signed ? (static_cast<s32>(value) < static_cast<s32>(comp_value)) : (value < comp_value);
+  else if constexpr (op == Operator::LessEqual)
+    return is_signed ? (static_cast<s32>(value) <= static_cast<s32>(comp_value)) : (value <= comp_value);
+  else if constexpr (op == Operator::IncreasedBy)
+    return is_signed ? ((static_cast<s32>(value) - static_cast<s32>(last_value)) == static_cast<s32>(comp_value)) :
+                       ((value - last_value) == comp_value);
+  else if constexpr (op == Operator::DecreasedBy)
+    return is_signed ? ((static_cast<s32>(last_value) - static_cast<s32>(value)) == static_cast<s32>(comp_value)) :
+                       ((last_value - value) == comp_value);
+  else if constexpr (op == Operator::ChangedBy)
+    return is_signed ?
+             (std::abs(static_cast<s32>(last_value) - static_cast<s32>(value)) == static_cast<s32>(comp_value)) :
+             (((last_value > value) ? (last_value - value) : (value - last_value)) == comp_value);
+  else if constexpr (op == Operator::EqualLast)
+    return (value == last_value);
+  else if constexpr (op == Operator::NotEqualLast)
+    return (value != last_value);
+  else if constexpr (op == Operator::GreaterThanLast)
+    return is_signed ? (static_cast<s32>(value) > static_cast<s32>(last_value)) : (value > last_value);
+  else if constexpr (op == Operator::GreaterEqualLast)
+    return is_signed ? (static_cast<s32>(value) >= static_cast<s32>(last_value)) : (value >= last_value);
+  else if constexpr (op == Operator::LessThanLast)
+    return is_signed ? (static_cast<s32>(value) < static_cast<s32>(last_value)) : (value < last_value);
+  else if constexpr (op == Operator::LessEqualLast)
+    return is_signed ? (static_cast<s32>(value) <= static_cast<s32>(last_value)) : (value <= last_value);
+  else // if constexpr (op == Operator::Any)
+    return true;
+}
+
+#if defined(CPU_ARCH_NEON)
+ALWAYS_INLINE static u32 NEONMoveMask(uint8x16_t value)
+{
+  static constexpr u8 bit_weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t sum = vandq_u8(value, vld1q_u8(bit_weights));
+  sum = vpaddq_u8(sum, sum);
+  sum = vpaddq_u8(sum, sum);
+  sum = vpaddq_u8(sum, sum);
+  return vgetq_lane_u16(vreinterpretq_u16_u8(sum), 0);
+}
+#endif
+
+/// Returns a bit for each of the 64 values in lhs which are equal to rhs.
+template<typename T>
+ALWAYS_INLINE static u64 GetEqualMask(const T* lhs, const T* rhs)
+{
+  u64 mask = 0;
+
+#if defined(CPU_ARCH_SSE)
+  for (u32 i = 0; i < 64; i += 16)
+  {
+    __m128i cmp;
+    if constexpr (sizeof(T) == 1)
+    {
+      cmp = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+      const __m128i cmp0 = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+      const __m128i cmp1 = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i + 8)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i + 8)));
+      cmp = _mm_packs_epi16(cmp0, cmp1);
+    }
+    else
+    {
+      __m128i cmp32[4];
+      for (u32 j = 0; j < 4; j++)
+      {
+        cmp32[j] = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i + j * 4)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i + j * 4)));
+      }
+      cmp = _mm_packs_epi16(_mm_packs_epi32(cmp32[0], cmp32[1]), _mm_packs_epi32(cmp32[2], cmp32[3]));
+    }
+
+    mask |= static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(cmp))) << i;
+  }
+#elif defined(CPU_ARCH_NEON)
+  for (u32 i = 0; i < 64; i += 16)
+  {
+    uint8x16_t cmp;
+    if constexpr (sizeof(T) == 1)
+    {
+      cmp = vceqq_u8(vld1q_u8(reinterpret_cast<const u8*>(lhs + i)), vld1q_u8(reinterpret_cast<const u8*>(rhs + i)));
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+      const uint16x8_t cmp0 = vceqq_u16(vld1q_u16(reinterpret_cast<const u16*>(lhs + i)),
+                                        vld1q_u16(reinterpret_cast<const u16*>(rhs + i)));
+      const uint16x8_t cmp1 = vceqq_u16(vld1q_u16(reinterpret_cast<const u16*>(lhs + i + 8)),
+                                        vld1q_u16(reinterpret_cast<const u16*>(rhs + i + 8)));
+      cmp = vcombine_u8(vmovn_u16(cmp0), vmovn_u16(cmp1));
+    }
+    else
+    {
+      uint16x4_t cmp32[4];
+      for (u32 j = 0; j < 4; j++)
+      {
+        cmp32[j] = vmovn_u32(vceqq_u32(vld1q_u32(reinterpret_cast<const u32*>(lhs + i + j * 4)),
+                                       vld1q_u32(reinterpret_cast<const u32*>(rhs + i + j * 4))));
+      }
+      cmp = vcombine_u8(vmovn_u16(vcombine_u16(cmp32[0], cmp32[1])), vmovn_u16(vcombine_u16(cmp32[2], cmp32[3])));
+    }
+
+    mask |= static_cast<u64>(NEONMoveMask(cmp)) << i;
+  }
+#else
+  for (u32 i = 0; i < 64; i++)
+    mask |= static_cast<u64>(lhs[i] == rhs[i]) << i;
+#endif
+
+  return mask;
+}
+
+template<typename T, bool is_signed, MemoryScan::Operator op>
+static void ScanChunkValues(ScanChunk& chunk)
+{
+  using Operator = MemoryScan::Operator;
+  static constexpr bool is_equality_test =
+    (op == Operator::Equal || op == Operator::NotEqual || op == Operator::EqualLast || op == Operator::NotEqualLast);
+  static constexpr bool compares_last = (op == Operator::EqualLast || op == Operator::NotEqualLast);
+
+  const T* values = reinterpret_cast<const T*>(chunk.values);
+  const T* last_values = reinterpret_cast<const T*>(chunk.last_values);
+
+  // Equality can be tested on the raw values, as long as the comparison value survives truncation.
+  const T comp_value = static_cast<T>(chunk.comp_value);
+  const bool comp_value_representable = (ExtendScanValue<T, is_signed>(comp_value) == chunk.comp_value);
+  alignas(16) T comp_values[64];
+  if constexpr (is_equality_test && !compares_last)
+    std::fill_n(comp_values, 64, comp_value);
+
+  u32 result_count = 0;
+  for (u32 word = chunk.first_word; word < chunk.end_word; word++)
+  {
+    const u32 first_slot = word * 64;
+    const u32 num_slots = std::min<u32>(chunk.num_slots - first_slot, 64);
+
+    u64 candidates;
+    if (chunk.new_search)
+    {
+      // Valid regions and the gaps between them are larger than a word of slots, so if both ends are valid, the
+      // whole word is too.
+      const PhysicalMemoryAddress address = chunk.address + first_slot * static_cast<u32>(sizeof(T));
+      if (IsValidScanAddress(address) && IsValidScanAddress(address + (num_slots - 1) * static_cast<u32>(sizeof(T))))
+      {
+        candidates = (num_slots == 64) ? ~static_cast<u64>(0) : ((static_cast<u64>(1) << num_slots) - 1);
+      }
+      else
+      {
+        candidates = 0;
+        for (u32 i = 0; i < num_slots; i++)
+          candidates |= static_cast<u64>(IsValidScanAddress(address + i * static_cast<u32>(sizeof(T)))) << i;
+      }
+    }
+    else
+    {
+      candidates = chunk.candidates[word];
+    }
+
+    if (candidates == 0)
+    {
+      chunk.candidates[word] = 0;
+      continue;
+    }
+
+    u64 mask;
+    if constexpr (is_equality_test)
+    {
+      if (num_slots == 64 && (compares_last || comp_value_representable))
+      {
+        mask = GetEqualMask(values + first_slot, compares_last ? (last_values + first_slot) : comp_values);
+        if constexpr (op == Operator::NotEqual || op == Operator::NotEqualLast)
+          mask = ~mask;
+
+        candidates &= mask;
+        chunk.candidates[word] = candidates;
+        result_count += static_cast<u32>(std::popcount(candidates));
+        continue;
+      }
+    }
+
+    mask = 0;
+    for (u32 i = 0; i < num_slots; i++)
+    {
+      const u32 value = ExtendScanValue<T, is_signed>(values[first_slot + i]);
+      const u32 last_value = ExtendScanValue<T, is_signed>(last_values[first_slot + i]);
+      mask |= static_cast<u64>(TestScanValue<op, is_signed>(value, last_value, chunk.comp_value)) << i;
+    }
+
+    candidates &= mask;
+    chunk.candidates[word] = candidates;
+    result_count += static_cast<u32>(std::popcount(candidates));
+  }
+
+  chunk.result_count = result_count;
+}
+
+template<typename T, bool is_signed>
+static ScanChunkFunction GetScanChunkFunction(MemoryScan::Operator op)
+{
+  using Operator = MemoryScan::Operator;
+
+  switch (op)
+  {
+    // clang-format off
+    case Operator::Any: return &ScanChunkValues<T, is_signed, Operator::Any>;
+    case Operator::LessThanLast: return &ScanChunkValues<T, is_signed, Operator::LessThanLast>;
+    case Operator::LessEqualLast: return &ScanChunkValues<T, is_signed, Operator::LessEqualLast>;
+    case Operator::GreaterThanLast: return &ScanChunkValues<T, is_signed, Operator::GreaterThanLast>;
+    case Operator::GreaterEqualLast: return &ScanChunkValues<T, is_signed, Operator::GreaterEqualLast>;
+    case Operator::NotEqualLast: return &ScanChunkValues<T, is_signed, Operator::NotEqualLast>;
+    case Operator::EqualLast: return &ScanChunkValues<T, is_signed, Operator::EqualLast>;
+    case Operator::DecreasedBy: return &ScanChunkValues<T, is_signed, Operator::DecreasedBy>;
+    case Operator::IncreasedBy: return &ScanChunkValues<T, is_signed, Operator::IncreasedBy>;
+    case Operator::ChangedBy: return &ScanChunkValues<T, is_signed, Operator::ChangedBy>;
+    case Operator::Equal: return &ScanChunkValues<T, is_signed, Operator::Equal>;
+    case Operator::NotEqual: return &ScanChunkValues<T, is_signed, Operator::NotEqual>;
+    case Operator::LessThan: return &ScanChunkValues<T, is_signed, Operator::LessThan>;
+    case Operator::LessEqual: return &ScanChunkValues<T, is_signed, Operator::LessEqual>;
+    case Operator::GreaterThan: return &ScanChunkValues<T, is_signed, Operator::GreaterThan>;
+    case Operator::GreaterEqual: return &ScanChunkValues<T, is_signed, Operator::GreaterEqual>;
+    default: return nullptr;
+      // clang-format on
+  }
+}
+
 MemoryScan::MemoryScan() = default;
 
 MemoryScan::~MemoryScan() = default;
@@ -2822,24 +3270,28 @@ MemoryScan::~MemoryScan() = default;
 void MemoryScan::ResetSearch()
 {
   m_results.clear();
+  m_result_count = 0;
+  m_candidates = {};
+  m_last_values = {};
+  m_search_slots = 0;
 }
 
 void MemoryScan::Search()
 {
-  m_results.clear();
+  ResetSearch();
 
   switch (m_size)
   {
     case MemoryAccessSize::Byte:
-      SearchBytes();
+      SearchValues<u8>(true);
       break;
 
     case MemoryAccessSize::HalfWord:
-      SearchHalfwords();
+      SearchValues<u16>(true);
       break;
 
     case MemoryAccessSize::Word:
-      SearchWords();
+      SearchValues<u32>(true);
       break;
 
     default:
@@ -2847,80 +3299,115 @@ void MemoryScan::Search()
   }
 }
 
-void MemoryScan::SearchBytes()
+void MemoryScan::SearchAgain()
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address++)
+  if (m_search_slots == 0)
+    return;
+
+  switch (m_search_size)
   {
-    if (!IsValidScanAddress(address))
-      continue;
+    case MemoryAccessSize::Byte:
+      SearchValues<u8>(false);
+      break;
 
-    const u8 bvalue = DoMemoryRead<u8>(address);
+    case MemoryAccessSize::HalfWord:
+      SearchValues<u16>(false);
+      break;
 
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.value_changed = false;
+    case MemoryAccessSize::Word:
+      SearchValues<u32>(false);
+      break;
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+    default:
+      break;
   }
 }
 
-void MemoryScan::SearchHalfwords()
+template<typename T>
+void MemoryScan::SearchValues(bool new_search)
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 2)
+  if (new_search)
   {
-    if (!IsValidScanAddress(address))
-      continue;
+    if (m_end_address <= m_start_address)
+      return;
 
-    const u16 bvalue = DoMemoryRead<u16>(address);
-
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.value_changed = false;
+    u32 length = m_end_address - m_start_address;
+    if (length > MAX_SEARCH_LENGTH)
+    {
+      Log_WarningFmt("Truncating search of {} bytes at 0x{:08X} to {} bytes", length, m_start_address,
+                     MAX_SEARCH_LENGTH);
+      length = MAX_SEARCH_LENGTH;
+    }
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+    m_search_address = m_start_address;
+    m_search_size = m_size;
+    m_search_slots = (length + (sizeof(T) - 1)) / sizeof(T);
+    m_candidates.resize((m_search_slots + 63) / 64);
   }
-}
 
-void MemoryScan::SearchWords()
-{
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 4)
+  // Everything is compared against a copy, so values which change mid-search don't give inconsistent results.
+  std::vector<u8> values(m_search_slots * sizeof(T));
+  ReadScanMemory(m_search_address, static_cast<u32>(values.size()), values.data());
+
+  const ScanChunkFunction func =
+    m_signed ? GetScanChunkFunction<T, true>(m_operator) : GetScanChunkFunction<T, false>(m_operator);
+  if (!func)
   {
-    if (!IsValidScanAddress(address))
-      continue;
+    ResetSearch();
+    return;
+  }
 
-    Result res;
-    res.address = address;
-    res.value = DoMemoryRead<u32>(address);
-    res.last_value = res.value;
-    res.value_changed = false;
+  const u32 num_words = static_cast<u32>(m_candidates.size());
+  const u32 num_threads =
+    std::clamp(std::min(std::thread::hardware_concurrency(), num_words / MIN_WORDS_PER_SEARCH_THREAD), 1u,
+               MAX_SEARCH_THREADS);
+  const u32 words_per_thread = (num_words + (num_threads - 1)) / num_threads;
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+  std::array<ScanChunk, MAX_SEARCH_THREADS> chunks;
+  for (u32 i = 0; i < num_threads; i++)
+  {
+    ScanChunk& chunk = chunks[i];
+    chunk.values = values.data();
+    chunk.last_values = new_search ? values.data() : m_last_values.data();
+    chunk.candidates = m_candidates.data();
+    chunk.address = m_search_address;
+    chunk.first_word = std::min(i * words_per_thread, num_words);
+    chunk.end_word = std::min(chunk.first_word + words_per_thread, num_words);
+    chunk.num_slots = m_search_slots;
+    chunk.comp_value = m_value;
+    chunk.new_search = new_search;
+    chunk.result_count = 0;
   }
-}
 
-void MemoryScan::SearchAgain()
-{
-  ResultVector new_results;
-  new_results.reserve(m_results.size());
-  for (Result& res : m_results)
-  {
-    res.UpdateValue(m_size, m_signed);
+  std::array<std::thread, MAX_SEARCH_THREADS - 1> threads;
+  for (u32 i = 1; i < num_threads; i++)
+    threads[i - 1] = std::thread(func, std::ref(chunks[i]));
+  func(chunks[0]);
+  for (u32 i = 1; i < num_threads; i++)
+    threads[i - 1].join();
 
-    if (res.Filter(m_operator, m_value, m_signed))
+  m_result_count = 0;
+  for (u32 i = 0; i < num_threads; i++)
+    m_result_count += chunks[i].result_count;
+
+  m_results.clear();
+  m_results.reserve(std::min(m_result_count, MAX_RESULTS_WITH_VALUES));
+  const T* typed_values = reinterpret_cast<const T*>(values.data());
+  for (u32 word = 0; word < num_words && m_results.size() < MAX_RESULTS_WITH_VALUES; word++)
+  {
+    for (u64 bits = m_candidates[word]; bits != 0 && m_results.size() < MAX_RESULTS_WITH_VALUES; bits &= (bits - 1))
     {
+      const u32 slot = word * 64 + CountTrailingZeros(bits);
+      Result& res = m_results.emplace_back();
+      res.address = m_search_address + slot * static_cast<u32>(sizeof(T));
+      res.value =
+        m_signed ? ExtendScanValue<T, true>(typed_values[slot]) : ExtendScanValue<T, false>(typed_values[slot]);
       res.last_value = res.value;
-      new_results.push_back(res);
+      res.value_changed = false;
     }
   }
 
-  m_results.swap(new_results);
+  m_last_values = std::move(values);
 }
 
 void MemoryScan::UpdateResultsValues()
@@ -2957,98 +3444,6 @@ void MemoryScan::SetResultValue(u32 index, u32 value)
   res.value_changed = true;
 }
 
-bool MemoryScan::Result::Filter(Operator op, u32 comp_value, bool is_signed) const
-{
-  switch (op)
-  {
-    case Operator::Equal:
-    {
-      return (value == comp_value);
-    }
-
-    case Operator::NotEqual:
-    {
-      return (value != comp_value);
-    }
-
-    case Operator::GreaterThan:
-    {
-      return is_signed ? (static_cast<s32>(value) > static_cast<s32>(comp_value)) : (value > comp_value);
-    }
-
-    case Operator::GreaterEqual:
-    {
-      return is_signed ? (static_cast<s32>(value) >= static_cast<s32>(comp_value)) : (value >= comp_value);
-    }
-
-    case Operator::LessThan:
-    {
-      return is_signed ? (static_cast<s32>(value) < static_cast<s32>(comp_value)) : (value < comp_value);
-    }
-
-    case Operator::LessEqual:
-    {
-      return is_signed ? (static_cast<s32>(value) <= static_cast<s32>(comp_value)) : (value <= comp_value);
-    }
-
-    case Operator::IncreasedBy:
-    {
-      return is_signed ? ((static_cast<s32>(value) - static_cast<s32>(last_value)) == static_cast<s32>(comp_value)) :
-                         ((value - last_value) == comp_value);
-    }
-
-    case Operator::DecreasedBy:
-    {
-      return is_signed ? ((static_cast<s32>(last_value) - static_cast<s32>(value)) == static_cast<s32>(comp_value)) :
-                         ((last_value - value) == comp_value);
-    }
-
-    case Operator::ChangedBy:
-    {
-      if (is_signed)
-        return (std::abs(static_cast<s32>(last_value) - static_cast<s32>(value)) == static_cast<s32>(comp_value));
-      else
-        return ((last_value > value) ? (last_value - value) : (value - last_value)) == comp_value;
-    }
-
-    case Operator::EqualLast:
-    {
-      return (value == last_value);
-    }
-
-    case Operator::NotEqualLast:
-    {
-      return (value != last_value);
-    }
-
-    case Operator::GreaterThanLast:
-    {
-      return is_signed ? (static_cast<s32>(value) > static_cast<s32>(last_value)) : (value > last_value);
-    }
-
-    case Operator::GreaterEqualLast:
-    {
-      return is_signed ? (static_cast<s32>(value) >= static_cast<s32>(last_value)) : (value >= last_value);
-    }
-
-    case Operator::LessThanLast:
-    {
-      return is_signed ? (static_cast<s32>(value) < static_cast<s32>(last_value)) : (value < last_value);
-    }
-
-    case Operator::LessEqualLast:
-    {
-      return is_signed ? (static_cast<s32>(value) <= static_cast<s32>(last_value)) : (value <= last_value);
-    }
-
-    case Operator::Any:
-      return true;
-
-    default:
-      return false;
-  }
-}
-
 void MemoryScan::Result::UpdateValue(MemoryAccessSize size, bool is_signed)
 {
   const u32 old_value = value;
@@ -3185,10 +3580,76 @@ bool MemoryWatchList::RemoveEntryByDescription(const char* description)
   return result;
 }
 
+/// Returns the offset of a watch in RAM, if it's aligned and can be read from a copy of RAM.
+static std::optional<u32> GetWatchRAMOffset(VirtualMemoryAddress address, MemoryAccessSize size)
+{
+  const u32 size_in_bytes = 1u << static_cast<u32>(size);
+  const bool is_scratchpad = ((address & CPU::SCRATCHPAD_ADDR_MASK) == CPU::SCRATCHPAD_ADDR);
+  const PhysicalMemoryAddress phys_address = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (is_scratchpad || phys_address >= Bus::RAM_MIRROR_END || (address & (size_in_bytes - 1)) != 0)
+    return std::nullopt;
+
+  return phys_address & Bus::g_ram_mask;
+}
+
 void MemoryWatchList::UpdateValues()
 {
-  for (Entry& entry : m_entries)
-    UpdateEntryValue(&entry);
+  m_changed_entries.clear();
+
+  u32 ram_start = Bus::g_ram_size;
+  u32 ram_end = 0;
+  for (const Entry& entry : m_entries)
+  {
+    if (const std::optional<u32> offset = GetWatchRAMOffset(entry.address, entry.size))
+    {
+      ram_start = std::min(ram_start, offset.value());
+      ram_end = std::max(ram_end, offset.value() + (1u << static_cast<u32>(entry.size)));
+    }
+  }
+
+  if (ram_start < ram_end)
+  {
+    m_ram_snapshot.resize(ram_end - ram_start);
+    std::memcpy(m_ram_snapshot.data(), &Bus::g_ram[ram_start], ram_end - ram_start);
+  }
+
+  for (u32 i = 0; i < static_cast<u32>(m_entries.size()); i++)
+  {
+    Entry& entry = m_entries[i];
+    if (const std::optional<u32> offset = GetWatchRAMOffset(entry.address, entry.size))
+    {
+      const u8* ptr = &m_ram_snapshot[offset.value() - ram_start];
+      u32 raw_value;
+      switch (entry.size)
+      {
+        case MemoryAccessSize::Byte:
+          raw_value = *ptr;
+          break;
+
+        case MemoryAccessSize::HalfWord:
+        {
+          u16 hvalue;
+          std::memcpy(&hvalue, ptr, sizeof(hvalue));
+          raw_value = hvalue;
+        }
+        break;
+
+        case MemoryAccessSize::Word:
+        default:
+          std::memcpy(&raw_value, ptr, sizeof(raw_value));
+          break;
+      }
+
+      UpdateEntryValue(&entry, raw_value);
+    }
+    else
+    {
+      UpdateEntryValue(&entry);
+    }
+
+    if (entry.changed)
+      m_changed_entries.push_back(i);
+  }
 }
 
 void MemoryWatchList::SetEntryValue(Entry* entry, u32 value)
@@ -3213,30 +3674,40 @@ void MemoryWatchList::SetEntryValue(Entry* entry, u32 value)
 }
 
 void MemoryWatchList::UpdateEntryValue(Entry* entry)
+{
+  switch (entry->size)
+  {
+    case MemoryAccessSize::Byte:
+      UpdateEntryValue(entry, DoMemoryRead<u8>(entry->address));
+      break;
+
+    case MemoryAccessSize::HalfWord:
+      UpdateEntryValue(entry, DoMemoryRead<u16>(entry->address));
+      break;
+
+    case MemoryAccessSize::Word:
+      UpdateEntryValue(entry, DoMemoryRead<u32>(entry->address));
+      break;
+  }
+}
+
+void MemoryWatchList::UpdateEntryValue(Entry* entry, u32 raw_value)
 {
   const u32 old_value = entry->value;
 
   switch (entry->size)
   {
     case MemoryAccessSize::Byte:
-    {
-      u8 bvalue = DoMemoryRead<u8>(entry->address);
-      entry->value = entry->is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
+      entry->value = entry->is_signed ? SignExtend32(Truncate8(raw_value)) : ZeroExtend32(Truncate8(raw_value));
+      break;
 
     case MemoryAccessSize::HalfWord:
-    {
-      u16 bvalue = DoMemoryRead<u16>(entry->address);
-      entry->value = entry->is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
+      entry->value = entry->is_signed ? SignExtend32(Truncate16(raw_value)) : ZeroExtend32(Truncate16(raw_value));
+      break;
 
     case MemoryAccessSize::Word:
-    {
-      entry->value = DoMemoryRead<u32>(entry->address);
-    }
-    break;
+      entry->value = raw_value;
+      break;
   }
 
   entry->changed = (old_value != entry->value);
@@ -107,6 +107,26 @@ struct CheatCode
     BitField<u64, u8, 0, 8> value8;
   };
 
+  /// Codes which only write constants to RAM or the scratchpad are applied as a list of copies, instead of
+  /// interpreting the instructions every frame. Built on first use, and rebuilt when the instructions change.
+  struct CompiledWrite
+  {
+    u32 offset;
+    u32 data_offset;
+    u32 length;
+    bool scratchpad;
+  };
+
+  struct CompiledCode
+  {
+    std::vector<CompiledWrite> writes;
+    std::vector<u8> data;
+    const Instruction* instructions = nullptr;
+    u32 instruction_count = 0;
+    u32 ram_mask = 0;
+    bool valid = false;
+  };
+
   std::string group;
   std::string description;
   std::vector<Instruction> instructions;
@@ -114,6 +134,7 @@ struct CheatCode
   Type type = Type::Gameshark;
   Activation activation = Activation::EndFrame;
   bool enabled = false;
+  mutable CompiledCode compiled;
 
   ALWAYS_INLINE bool Valid() const { return !instructions.empty() && !description.empty(); }
   ALWAYS_INLINE bool IsManuallyActivated() const { return (activation == Activation::Manual); }
@@ -126,6 +147,10 @@ struct CheatCode
   void Apply() const;
   void ApplyOnDisable() const;
 
+  /// Returns true if the code was compiled to a write list, which can be applied without the interpreter.
+  bool Compile() const;
+  void ApplyCompiled() const;
+
   static const char* GetTypeName(Type type);
   static const char* GetTypeDisplayName(Type type);
   static std::optional<Type> ParseTypeName(const char* str);
@@ -229,12 +254,17 @@ public:
     u32 last_value;
     bool value_changed;
 
-    bool Filter(Operator op, u32 comp_value, bool is_signed) const;
     void UpdateValue(MemoryAccessSize size, bool is_signed);
   };
 
   using ResultVector = std::vector<Result>;
 
+  /// Only the first results are kept with their values, the rest are just tracked in the candidate bitmap.
+  static constexpr u32 MAX_RESULTS_WITH_VALUES = 5000;
+
+  /// Larger ranges are truncated, since a copy of the range is kept for comparing against the last values.
+  static constexpr u32 MAX_SEARCH_LENGTH = 64 * 1024 * 1024;
+
   MemoryScan();
   ~MemoryScan();
 
@@ -246,7 +276,7 @@ public:
   PhysicalMemoryAddress GetEndAddress() const { return m_end_address; }
   const ResultVector& GetResults() const { return m_results; }
   const Result& GetResult(u32 index) const { return m_results[index]; }
-  u32 GetResultCount() const { return static_cast<u32>(m_results.size()); }
+  u32 GetResultCount() const { return m_result_count; }
 
   void SetValue(u32 value) { m_value = value; }
   void SetValueSigned(bool s) { m_signed = s; }
@@ -263,17 +293,26 @@ public:
   void SetResultValue(u32 index, u32 value);
 
 private:
-  void SearchBytes();
-  void SearchHalfwords();
-  void SearchWords();
+  template<typename T>
+  void SearchValues(bool new_search);
+
 
   u32 m_value = 0;
   MemoryAccessSize m_size = MemoryAccessSize::HalfWord;
   Operator m_operator = Operator::Equal;
   PhysicalMemoryAddress m_start_address = 0;
   PhysicalMemoryAddress m_end_address = 0x200000;
-  ResultVector m_results;
   bool m_signed = false;
+
+  ResultVector m_results;
+  u32 m_result_count = 0;
+
+  // One bit per value in the searched range, and the contents of the range when it was last searched.
+  std::vector<u64> m_candidates;
+  std::vector<u8> m_last_values;
+  PhysicalMemoryAddress m_search_address = 0;
+  MemoryAccessSize m_search_size = MemoryAccessSize::Byte;
+  u32 m_search_slots = 0;
 };
 
 class MemoryWatchList
@@ -300,6 +339,9 @@ public:
   const Entry& GetEntry(u32 index) const { return m_entries[index]; }
   u32 GetEntryCount() const { return static_cast<u32>(m_entries.size()); }
 
+  /// Indices of the entries whose value changed in the last UpdateValues().
+  const std::vector<u32>& GetChangedEntryIndices() const { return m_changed_entries; }
+
   bool AddEntry(std::string description, u32 address, MemoryAccessSize size, bool is_signed, bool freeze);
   void RemoveEntry(u32 index);
   bool RemoveEntryByDescription(const char* description);
@@ -314,6 +356,11 @@ public:
 private:
   static void SetEntryValue(Entry* entry, u32 value);
   static void UpdateEntryValue(Entry* entry);
+  static void UpdateEntryValue(Entry* entry, u32 raw_value);
 
   EntryVector m_entries;
+  std::vector<u32> m_changed_entries;
+
+  // RAM covered by the watches, copied once per update instead of reading each watch through the bus.
+  std::vector<u8> m_ram_snapshot;
 };
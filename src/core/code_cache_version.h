@@ -0,0 +1,8 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "common/types.h"
+
+static constexpr u32 CODE_CACHE_SIGNATURE = 0x43424A44; // DJBC
+static constexpr u32 CODE_CACHE_VERSION = 1;
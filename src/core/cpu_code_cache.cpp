@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "bus.h"
+#include "code_cache_version.h"
 #include "cpu_code_cache_private.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
@@ -13,10 +14,19 @@
 #include "timing_event.h"
 
 #include "common/assert.h"
+#include "common/byte_stream.h"
 #include "common/error.h"
+#include "common/file_system.h"
 #include "common/intrin.h"
 #include "common/log.h"
 #include "common/memmap.h"
+#include "common/memory_accounting.h"
+#include "common/path.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+
+#include "fmt/format.h"
+#include "xxhash.h"
 
 Log_SetChannel(CPU::CodeCache);
 
@@ -28,6 +38,8 @@ Log_SetChannel(CPU::CodeCache);
 #include "cpu_newrec_compiler.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <unordered_set>
 #include <zlib.h>
@@ -48,6 +60,19 @@ static constexpr u32 RECOMPILE_FRAMES_FOR_INTERPRETER_FALLBACK = 15;
 static constexpr u32 INVALIDATE_COUNT_FOR_MANUAL_PROTECTION = 4;
 static constexpr u32 INVALIDATE_FRAMES_FOR_MANUAL_PROTECTION = 60;
 
+// Number of guest instructions which can be compiled per frame when deferred compilation is enabled. Blocks which are
+// entered after the budget is exhausted get interpreted until the next frame, bounding the stall from bursts of new code.
+static constexpr u32 COMPILE_BUDGET_INSTRUCTIONS_PER_FRAME = 8192;
+
+// Blocks which execute this many times get recompiled as a superblock, continuing through conditional branches
+// instead of ending at them. Taken branches leave the superblock through a side exit, each using one exit link.
+static constexpr u32 SUPERBLOCK_PROMOTE_EXECUTION_COUNT = 1024;
+static constexpr u32 SUPERBLOCK_MAX_INSTRUCTIONS = 256;
+static constexpr u32 SUPERBLOCK_MAX_SIDE_EXITS = 6;
+
+// Idle loops are small self-looping blocks which only poll memory, e.g. waiting for a VSync flag to be set.
+static constexpr u32 IDLE_LOOP_MAX_INSTRUCTIONS = 16;
+
 static CodeLUT DecodeCodeLUTPointer(u32 slot, CodeLUT ptr);
 static CodeLUT EncodeCodeLUTPointer(u32 slot, CodeLUT ptr);
 static CodeLUT OffsetCodeLUTPointer(CodeLUT fake_ptr, u32 pc);
@@ -66,12 +91,19 @@ static bool RevalidateBlock(Block* block);
 PageProtectionMode GetProtectionModeForPC(u32 pc);
 PageProtectionMode GetProtectionModeForBlock(const Block* block);
 static bool ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata);
+static bool IsIdleLoop(u32 start_pc, const BlockInstructionList& instructions);
+static bool IsIdleLoopPollAddress(VirtualMemoryAddress address);
 static void FillBlockRegInfo(Block* block);
 static void CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src);
 static void SetRegAccess(InstructionInfo* inst, Reg reg, bool write);
 static void AddBlockToPageList(Block* block);
 static void RemoveBlockFromPageList(Block* block);
+static u64 GetCodeGranuleMask(u32 page_offset, u32 size);
+static u64 GetBlockCodeGranuleMask(const Block* block);
+static BlockState UpdatePageInvalidateCount(u32 index);
+static void InvalidatePageBlocks(u32 index, BlockState new_state);
 
+template<PGXPMode pgxp_mode>
 static Block* CreateCachedInterpreterBlock(u32 pc);
 [[noreturn]] static void ExecuteCachedInterpreter();
 template<PGXPMode pgxp_mode>
@@ -95,14 +127,71 @@ static void UnlinkBlockExits(Block* block);
 static void ClearASMFunctions();
 static void CompileASMFunctions();
 static bool CompileBlock(Block* block);
+static bool EvictCodeGeneration();
+static bool HasCompileBudget();
+static bool IsSuperblockTierEnabled();
+static const char* GetBlockStateName(BlockState state);
+static void DeferBlockCompilation(u32 pc);
 static PageFaultHandler::HandlerResult HandleFastmemException(void* exception_pc, void* fault_address, bool is_write);
 static void BackpatchLoadStore(void* host_pc, const LoadstoreBackpatchInfo& info);
 static void RemoveBackpatchInfoForRange(const void* host_code, u32 size);
+static void AddBackpatchInfo(const void* host_pc, const LoadstoreBackpatchInfo& info);
+static LoadstoreBackpatchInfo* FindBackpatchInfo(const void* host_pc);
+static void CompactBackpatchInfo();
 
 static BlockLinkMap s_block_links;
-static std::map<const void*, LoadstoreBackpatchInfo> s_fastmem_backpatch_info;
+
+// Backpatch info is kept in a flat array sorted by host address. Code is allocated linearly from the code buffer, so
+// entries are almost always appended in order, and the rare out-of-order entry is inserted in place, so lookups from
+// the fault handler never have to sort or allocate. Removed entries are tombstoned (code_size == 0), and the array is
+// compacted once more than half of it is dead, which keeps per-block removal proportional to the block's entries.
+struct BackpatchInfoEntry
+{
+  const void* host_pc;
+  LoadstoreBackpatchInfo info;
+};
+static std::vector<BackpatchInfoEntry> s_fastmem_backpatch_info;
+static u32 s_fastmem_backpatch_dead_count = 0;
 static std::unordered_set<u32> s_fastmem_faulting_pcs;
 
+static std::vector<u32> s_deferred_compile_pcs;
+static std::unordered_set<u32> s_superblock_pcs;
+
+// Exit links past MAX_BLOCK_EXIT_LINKS. Only superblocks have more than that, so they are kept out of the block.
+static std::unordered_map<u32, std::vector<BlockLinkMap::iterator>> s_superblock_exit_links;
+
+// Toggled on the CPU thread, but also polled by the debugger UI.
+static std::atomic<bool> s_block_profiling{false};
+static std::array<u64, static_cast<size_t>(InvalidationCause::Count)> s_invalidation_counts = {};
+static u32 s_compile_budget_used = 0;
+
+// Persistent block cache. Guest blocks which were compiled in a previous session are remembered by their start PC,
+// size and instruction hash, and compiled up-front when their page is first entered, instead of one at a time.
+struct PersistentBlockInfo
+{
+  u32 size;
+  u64 hash;
+};
+using PersistentBlockMap = std::map<u32, PersistentBlockInfo>;
+
+static std::string GetPersistentCacheFileName();
+static void LoadPersistentCache();
+static void SavePersistentCache();
+static u64 GetPersistentBlockHash(const Instruction* instructions, u32 size);
+static void AddPersistentBlock(const Block* block);
+static void CompilePersistentBlocksInPage(u32 pc);
+static bool HasSpaceForSpeculativeCompile(u32 size);
+static bool CompilePersistentBlock(u32 pc, const PersistentBlockInfo& info);
+
+// Blocks which were live when a resume state was saved, compiled before execution starts when it's loaded.
+static constexpr u32 WARMUP_LIST_SIGNATURE = 0x4D524157; // WARM
+
+static PersistentBlockMap s_persistent_blocks;
+static std::string s_persistent_cache_filename;
+static std::vector<Instruction> s_persistent_hash_buffer;
+static std::unordered_set<u32> s_persistent_pages_compiled;
+static bool s_persistent_cache_dirty = false;
+
 NORETURN_FUNCTION_POINTER void (*g_enter_recompiler)();
 const void* g_compile_or_revalidate_block;
 const void* g_check_events_and_dispatch;
@@ -136,6 +225,7 @@ alignas(HOST_PAGE_SIZE) static u8 s_code_storage[RECOMPILER_CODE_CACHE_SIZE + RE
 #endif
 
 static JitCodeBuffer s_code_buffer;
+static u32 s_code_evictions = 0;
 
 #ifdef _DEBUG
 static u32 s_total_instructions_compiled = 0;
@@ -154,7 +244,17 @@ bool CPU::CodeCache::IsUsingFastmem()
   return IsUsingAnyRecompiler() && g_settings.cpu_fastmem_mode != CPUFastmemMode::Disabled;
 }
 
-bool CPU::CodeCache::ProcessStartup(Error* error)
+CPU::CodeCache::Statistics CPU::CodeCache::GetStatistics()
+{
+  Statistics stats;
+  stats.num_blocks = static_cast<u32>(s_blocks.size());
+  stats.code_buffer_used = s_code_buffer.GetTotalUsed();
+  stats.code_buffer_size = s_code_buffer.GetTotalSize();
+  stats.code_evictions = s_code_evictions;
+  return stats;
+}
+
+bool CPU::CodeCache::ProcessStartup(bool use_huge_pages, Error* error)
 {
   AllocateLUTs();
 
@@ -170,15 +270,25 @@ bool CPU::CodeCache::ProcessStartup(Error* error)
     return false;
   }
 
+  if (use_huge_pages)
+  {
+    if (MemMap::AdviseHugePages(s_code_buffer.GetCodePointer(), s_code_buffer.GetTotalSize()))
+      Log_InfoPrint("Using huge pages for code buffer.");
+    else
+      Log_WarningPrint("Huge pages are not available for code buffer, using normal pages.");
+  }
+
   if (!PageFaultHandler::Install(error))
     return false;
 
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::CodeCache, s_code_buffer.GetTotalSize());
   return true;
 }
 
 void CPU::CodeCache::ProcessShutdown()
 {
   s_code_buffer.Destroy();
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::CodeCache, 0);
   DeallocateLUTs();
 }
 
@@ -191,6 +301,7 @@ void CPU::CodeCache::Initialize()
     s_code_buffer.Reset();
     CompileASMFunctions();
     ResetCodeLUT();
+    LoadPersistentCache();
   }
 
   Bus::UpdateFastmemViews(IsUsingAnyRecompiler() ? g_settings.cpu_fastmem_mode : CPUFastmemMode::Disabled);
@@ -199,6 +310,7 @@ void CPU::CodeCache::Initialize()
 
 void CPU::CodeCache::Shutdown()
 {
+  SavePersistentCache();
   ClearBlocks();
   ClearASMFunctions();
 
@@ -219,6 +331,14 @@ void CPU::CodeCache::Reset()
   }
 }
 
+void CPU::CodeCache::ReloadPersistentCache()
+{
+  SavePersistentCache();
+
+  if (IsUsingAnyRecompiler())
+    LoadPersistentCache();
+}
+
 void CPU::CodeCache::Execute()
 {
   if (IsUsingAnyRecompiler())
@@ -403,6 +523,8 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   const u32 frame_number = System::GetFrameNumber();
   u32 recompile_frame = System::GetFrameNumber();
   u8 recompile_count = 0;
+  u32 execution_count = 0;
+  u32 invalidate_count = 0;
 
   const u32 idx = (pc & 0xFFFF) >> 2;
   Block* block = s_block_lut[table][idx];
@@ -414,6 +536,8 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
     // keep recompile stats before resetting, that way we actually count recompiles
     recompile_frame = block->compile_frame;
     recompile_count = block->compile_count;
+    execution_count = block->execution_count;
+    invalidate_count = block->invalidate_count;
 
     // if it has the same number of instructions, we can reuse it
     if (block->size != size)
@@ -432,8 +556,9 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
 
   if (!block)
   {
-    block =
-      static_cast<Block*>(std::malloc(sizeof(Block) + (sizeof(Instruction) * size) + (sizeof(InstructionInfo) * size)));
+    // the execution mode can't change without the blocks being cleared, so reused blocks always match
+    block = static_cast<Block*>(std::malloc(
+      Block::GetAllocationSize(size, g_settings.cpu_execution_mode == CPUExecutionMode::CachedInterpreter)));
     Assert(block);
     new (block) Block();
     s_blocks.push_back(block);
@@ -449,9 +574,13 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   block->protection = GetProtectionModeForBlock(block);
   block->uncached_fetch_ticks = metadata.uncached_fetch_ticks;
   block->icache_line_count = metadata.icache_line_count;
+  block->icache_line_fill_ticks = metadata.icache_line_fill_ticks;
   block->host_code_size = 0;
   block->compile_frame = recompile_frame;
   block->compile_count = recompile_count + 1;
+  block->hot_count = SUPERBLOCK_PROMOTE_EXECUTION_COUNT;
+  block->execution_count = execution_count;
+  block->invalidate_count = invalidate_count;
 
   // copy instructions/info
   {
@@ -543,6 +672,7 @@ void CPU::CodeCache::AddBlockToPageList(Block* block)
   const u32 page_idx = block->StartPageIndex();
   PageProtectionInfo& entry = s_page_protection[page_idx];
   Bus::SetRAMCodePage(page_idx);
+  entry.code_granule_mask |= GetBlockCodeGranuleMask(block);
 
   if (entry.last_block_in_page)
   {
@@ -587,14 +717,28 @@ void CPU::CodeCache::RemoveBlockFromPageList(Block* block)
     cur_block->next_block_in_page = nullptr;
     break;
   }
+
+  entry.code_granule_mask = 0;
+  for (cur_block = entry.first_block_in_page; cur_block; cur_block = cur_block->next_block_in_page)
+    entry.code_granule_mask |= GetBlockCodeGranuleMask(cur_block);
 }
 
-void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+u64 CPU::CodeCache::GetCodeGranuleMask(u32 page_offset, u32 size)
 {
-  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
-  Bus::ClearRAMCodePage(index);
+  const u32 first = page_offset / CODE_GRANULE_SIZE;
+  const u32 last = std::min(page_offset + size - 1, HOST_PAGE_SIZE - 1) / CODE_GRANULE_SIZE;
+  const u64 upper = (last == 63) ? ~u64(0) : ((u64(1) << (last + 1)) - 1);
+  return upper & ~((u64(1) << first) - 1);
+}
+
+u64 CPU::CodeCache::GetBlockCodeGranuleMask(const Block* block)
+{
+  // write protected blocks never span pages, the ones with delay slots crossing use manual protection
+  return GetCodeGranuleMask(block->pc & (HOST_PAGE_SIZE - 1), block->size * sizeof(Instruction));
+}
 
-  BlockState new_block_state = BlockState::Invalidated;
+CPU::CodeCache::BlockState CPU::CodeCache::UpdatePageInvalidateCount(u32 index)
+{
   PageProtectionInfo& ppi = s_page_protection[index];
 
   const u32 frame_number = System::GetFrameNumber();
@@ -611,25 +755,133 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
     Log_DevFmt("{} invalidations in {} frames to page {} [0x{:08X} -> 0x{:08X}], switching to manual protection",
                ppi.invalidate_count, frame_delta, index, (index * HOST_PAGE_SIZE), ((index + 1) * HOST_PAGE_SIZE));
     ppi.mode = PageProtectionMode::ManualCheck;
-    new_block_state = BlockState::NeedsRecompile;
+    return BlockState::NeedsRecompile;
   }
 
+  return BlockState::Invalidated;
+}
+
+void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
+{
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  Bus::ClearRAMCodePage(index);
+  s_invalidation_counts[static_cast<size_t>(InvalidationCause::PageFault)]++;
+
+  InvalidatePageBlocks(index, UpdatePageInvalidateCount(index));
+}
+
+void CPU::CodeCache::InvalidateRAMPageBlocks(u32 index)
+{
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  Bus::ClearRAMCodePage(index);
+  InvalidatePageBlocks(index, BlockState::Invalidated);
+}
+
+void CPU::CodeCache::InvalidatePageBlocks(u32 index, BlockState new_state)
+{
+  PageProtectionInfo& ppi = s_page_protection[index];
   if (!ppi.first_block_in_page)
     return;
 
-  MemMap::BeginCodeWrite();
-
+  // Only valid blocks have links to rewrite. Pages which are invalidated repeatedly usually hold nothing but blocks
+  // which are already waiting for recompilation, so skip the write protection toggle unless it's needed.
+  bool code_writable = false;
   Block* block = ppi.first_block_in_page;
   while (block)
   {
-    InvalidateBlock(block, new_block_state);
+    if (block->state == BlockState::Valid && !code_writable)
+    {
+      MemMap::BeginCodeWrite();
+      code_writable = true;
+    }
+
+    InvalidateBlock(block, new_state);
     block = std::exchange(block->next_block_in_page, nullptr);
   }
 
   ppi.first_block_in_page = nullptr;
   ppi.last_block_in_page = nullptr;
+  ppi.code_granule_mask = 0;
 
-  MemMap::EndCodeWrite();
+  if (code_writable)
+    MemMap::EndCodeWrite();
+}
+
+void CPU::CodeCache::InvalidateBlocksInRange(u32 ram_offset, u32 size)
+{
+  const u32 index = ram_offset / HOST_PAGE_SIZE;
+  const u32 write_start = ram_offset % HOST_PAGE_SIZE;
+  const u32 write_end = write_start + size;
+  DebugAssert(index < Bus::RAM_8MB_CODE_PAGE_COUNT && write_end <= HOST_PAGE_SIZE);
+
+  PageProtectionInfo& ppi = s_page_protection[index];
+  if (!(ppi.code_granule_mask & GetCodeGranuleMask(write_start, size)))
+  {
+    s_invalidation_counts[static_cast<size_t>(InvalidationCause::DataWrite)]++;
+    return;
+  }
+
+  // The store went through the unprotected view, so the page can stay protected for the blocks it didn't touch.
+  // Code is only made writable once a valid block is hit, same as InvalidatePageBlocks().
+  bool code_writable = false;
+  bool invalidated = false;
+  Block* prev_block = nullptr;
+  Block* block = ppi.first_block_in_page;
+  ppi.code_granule_mask = 0;
+  while (block)
+  {
+    Block* const next_block = block->next_block_in_page;
+    const u32 block_start = block->pc & (HOST_PAGE_SIZE - 1);
+    const u32 block_end = block_start + (block->size * sizeof(Instruction));
+    if (write_start < block_end && write_end > block_start)
+    {
+      if (block->state == BlockState::Valid && !code_writable)
+      {
+        MemMap::BeginCodeWrite();
+        code_writable = true;
+      }
+
+      InvalidateBlock(block, BlockState::Invalidated);
+      block->next_block_in_page = nullptr;
+      if (prev_block)
+        prev_block->next_block_in_page = next_block;
+      else
+        ppi.first_block_in_page = next_block;
+
+      invalidated = true;
+    }
+    else
+    {
+      ppi.code_granule_mask |= GetBlockCodeGranuleMask(block);
+      prev_block = block;
+    }
+
+    block = next_block;
+  }
+
+  ppi.last_block_in_page = prev_block;
+
+  if (code_writable)
+    MemMap::EndCodeWrite();
+
+  if (!invalidated)
+  {
+    s_invalidation_counts[static_cast<size_t>(InvalidationCause::DataWrite)]++;
+    return;
+  }
+
+  s_invalidation_counts[static_cast<size_t>(InvalidationCause::CodeWrite)]++;
+
+  // switching to manual protection affects every block in the page
+  if (UpdatePageInvalidateCount(index) == BlockState::NeedsRecompile)
+  {
+    Bus::ClearRAMCodePage(index);
+    InvalidatePageBlocks(index, BlockState::NeedsRecompile);
+  }
+  else if (!ppi.first_block_in_page)
+  {
+    Bus::ClearRAMCodePage(index);
+  }
 }
 
 CPU::CodeCache::PageProtectionMode CPU::CodeCache::GetProtectionModeForPC(u32 pc)
@@ -657,6 +909,7 @@ void CPU::CodeCache::InvalidateBlock(Block* block, BlockState new_state)
   {
     SetCodeLUT(block->pc, g_compile_or_revalidate_block);
     BacklinkBlocks(block->pc, g_compile_or_revalidate_block);
+    block->invalidate_count++;
   }
 
   block->state = new_state;
@@ -680,6 +933,7 @@ void CPU::CodeCache::InvalidateAllRAMBlocks()
   {
     ppi.first_block_in_page = nullptr;
     ppi.last_block_in_page = nullptr;
+    ppi.code_granule_mask = 0;
   }
 
   MemMap::EndCodeWrite();
@@ -698,8 +952,13 @@ void CPU::CodeCache::ClearBlocks()
   }
 
   s_fastmem_backpatch_info.clear();
+  s_fastmem_backpatch_dead_count = 0;
   s_fastmem_faulting_pcs.clear();
   s_block_links.clear();
+  s_deferred_compile_pcs.clear();
+  s_superblock_pcs.clear();
+  s_superblock_exit_links.clear();
+  s_persistent_pages_compiled.clear();
 
   for (Block* block : s_blocks)
   {
@@ -719,6 +978,11 @@ PageFaultHandler::HandlerResult PageFaultHandler::HandlePageFault(void* exceptio
   {
     // Writing to protected RAM.
     DebugAssert(is_write);
+
+    // LUT fastmem stores from recompiled code are switched to the slow path, which only invalidates overlapped blocks.
+    if (g_settings.cpu_fastmem_mode == CPUFastmemMode::LUT && CPU::CodeCache::FindBackpatchInfo(exception_pc))
+      return CPU::CodeCache::HandleFastmemException(exception_pc, fault_address, is_write);
+
     const u32 guest_address = static_cast<u32>(static_cast<const u8*>(fault_address) - Bus::g_ram);
     const u32 page_index = Bus::GetRAMCodePageIndex(guest_address);
     Log_DevFmt("Page fault on protected RAM @ 0x{:08X} (page #{}), invalidating code cache.", guest_address,
@@ -734,11 +998,33 @@ PageFaultHandler::HandlerResult PageFaultHandler::HandlePageFault(void* exceptio
 // MARK: - Cached Interpreter
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template<PGXPMode pgxp_mode>
 CPU::CodeCache::Block* CPU::CodeCache::CreateCachedInterpreterBlock(u32 pc)
 {
   BlockMetadata metadata = {};
   ReadBlockInstructions(pc, &s_block_instructions, &metadata);
-  return CreateBlock(pc, s_block_instructions, metadata);
+
+  Block* block = CreateBlock(pc, s_block_instructions, metadata);
+
+  // decode once, so executing the block doesn't have to go through the opcode switch
+  InterpreterHandler* handler = block->InterpreterHandlers();
+  const Instruction* instruction = block->Instructions();
+  for (u32 i = 0; i < block->size; i++)
+    handler[i] = GetInterpreterHandler<pgxp_mode>(instruction[i]);
+
+  // common sequences get a single handler, the handlers of the instructions after the first are skipped over
+  // PGXP-CPU tracks every instruction individually, so it's not worth the extra handlers there
+  if constexpr (pgxp_mode != PGXPMode::CPU)
+  {
+    const InstructionInfo* info = block->InstructionsInfo();
+    for (u32 i = 0; i < block->size;)
+    {
+      const u32 fused = GetFusedInterpreterHandler<pgxp_mode>(&instruction[i], &info[i], block->size - i, &handler[i]);
+      i += std::max(fused, 1u);
+    }
+  }
+
+  return block;
 }
 
 template<PGXPMode pgxp_mode>
@@ -779,7 +1065,7 @@ template<PGXPMode pgxp_mode>
     reexecute_block:
       if (!block)
       {
-        if ((block = CreateCachedInterpreterBlock(pc))->size == 0) [[unlikely]]
+        if ((block = CreateCachedInterpreterBlock<pgxp_mode>(pc))->size == 0) [[unlikely]]
           goto interpret_block;
       }
       else
@@ -790,17 +1076,23 @@ template<PGXPMode pgxp_mode>
         if ((block->state != BlockState::Valid && !RevalidateBlock(block)) ||
             (block->protection == PageProtectionMode::ManualCheck && !IsBlockCodeCurrent(block)))
         {
-          if ((block = CreateCachedInterpreterBlock(pc))->size == 0) [[unlikely]]
+          if ((block = CreateCachedInterpreterBlock<pgxp_mode>(pc))->size == 0) [[unlikely]]
             goto interpret_block;
         }
       }
 
       DebugAssert(!(HasPendingInterrupt()));
       if (g_settings.cpu_recompiler_icache)
-        CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
+        CheckAndUpdateICacheTags(block->icache_line_count, block->icache_line_fill_ticks, block->uncached_fetch_ticks);
+
+      if (s_block_profiling.load(std::memory_order_relaxed))
+        block->execution_count++;
 
       InterpretCachedBlock<pgxp_mode>(block);
 
+      if (block->HasFlag(BlockFlags::IdleLoop) && g_state.pc == block->pc)
+        SkipIdleLoop();
+
       CHECK_DOWNCOUNT();
 
       // Handle self-looping blocks
@@ -877,12 +1169,20 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
 
   instructions->clear();
   metadata->icache_line_count = 0;
+  metadata->icache_line_fill_ticks =
+    g_settings.cpu_recompiler_icache ? GetICacheFillTicks(GetICacheTagForAddress(start_pc)) : 0;
   metadata->uncached_fetch_ticks = 0;
   metadata->flags = BlockFlags::None;
 
   u32 last_cache_line = ICACHE_LINES;
   u32 last_page = (protection == PageProtectionMode::WriteProtected) ? Bus::GetRAMCodePageIndex(start_pc) : 0;
 
+  // hot blocks get re-read as a trace running through conditional branches
+  const bool is_trace = IsSuperblockTierEnabled() && s_superblock_pcs.contains(start_pc);
+  u32 side_exits = 0;
+  if (IsSuperblockTierEnabled() && !is_trace)
+    metadata->flags |= BlockFlags::CountsExecutions;
+
   for (;;)
   {
     if (protection == PageProtectionMode::WriteProtected)
@@ -969,7 +1269,22 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
     if (is_branch_delay_slot && !info.is_branch_instruction)
-      break;
+    {
+      // superblocks keep going through the not-taken path of conditional branches
+      const InstructionInfo& branch_info = (instructions->end() - 2)->second;
+      if (!is_trace || branch_info.is_unconditional_branch_instruction || !branch_info.is_direct_branch_instruction ||
+          side_exits == SUPERBLOCK_MAX_SIDE_EXITS || instructions->size() >= SUPERBLOCK_MAX_INSTRUCTIONS ||
+          IsExitBlockInstruction(instruction))
+      {
+        break;
+      }
+
+      metadata->flags |= BlockFlags::Superblock;
+      side_exits++;
+      is_branch_delay_slot = false;
+      is_load_delay_slot = info.has_load_delay;
+      continue;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = info.is_branch_instruction;
@@ -990,6 +1305,12 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
 
   instructions->back().second.is_last_instruction = true;
 
+  if (g_settings.cpu_idle_loop_skipping && IsIdleLoop(start_pc, *instructions))
+  {
+    Log_DevFmt("Block 0x{:08X} is an idle loop", start_pc);
+    metadata->flags |= BlockFlags::IdleLoop;
+  }
+
 #ifdef _DEBUG
   SmallString disasm;
   Log_DebugPrintf("Block at 0x%08X", start_pc);
@@ -1004,6 +1325,202 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   return true;
 }
 
+bool CPU::CodeCache::IsIdleLoop(u32 start_pc, const BlockInstructionList& instructions)
+{
+  // must be a direct branch back to the start of the block, and only that
+  const size_t count = instructions.size();
+  if (count < 2 || count > IDLE_LOOP_MAX_INSTRUCTIONS)
+    return false;
+
+  const BlockInstructionInfoPair& branch = instructions[count - 2];
+  const bool branch_links =
+    IsCallInstruction(branch.first) || (branch.first.op == InstructionOp::b &&
+                                        (static_cast<u8>(branch.first.i.rt.GetValue()) & u8(0x1E)) == u8(0x10));
+  if (!branch.second.is_direct_branch_instruction || branch_links ||
+      GetDirectBranchTarget(branch.first, branch.second.pc) != start_pc)
+  {
+    return false;
+  }
+
+  // Each iteration has to behave exactly the same as the last, as long as memory hasn't changed. That means only
+  // loads and ALU ops without side effects, and any register written in the loop is written before it is read.
+  struct RegAccess
+  {
+    Reg reads[2];
+    Reg write;
+  };
+  std::array<RegAccess, IDLE_LOOP_MAX_INSTRUCTIONS> accesses;
+  u64 written_regs = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    const Instruction inst = instructions[i].first;
+    RegAccess& access = accesses[i];
+    access = {{Reg::zero, Reg::zero}, Reg::zero};
+
+    if (i != (count - 2) && instructions[i].second.is_branch_instruction)
+      return false;
+
+    switch (inst.op)
+    {
+      case InstructionOp::funct:
+      {
+        switch (inst.r.funct)
+        {
+          case InstructionFunct::sll:
+          case InstructionFunct::srl:
+          case InstructionFunct::sra:
+            access = {{inst.r.rt, Reg::zero}, inst.r.rd};
+            break;
+
+          case InstructionFunct::sllv:
+          case InstructionFunct::srlv:
+          case InstructionFunct::srav:
+          case InstructionFunct::addu:
+          case InstructionFunct::subu:
+          case InstructionFunct::and_:
+          case InstructionFunct::or_:
+          case InstructionFunct::xor_:
+          case InstructionFunct::nor:
+          case InstructionFunct::slt:
+          case InstructionFunct::sltu:
+            access = {{inst.r.rs, inst.r.rt}, inst.r.rd};
+            break;
+
+          // HI/LO can't be written in the loop, so they're invariant
+          case InstructionFunct::mfhi:
+          case InstructionFunct::mflo:
+            access = {{Reg::zero, Reg::zero}, inst.r.rd};
+            break;
+
+          default:
+            return false;
+        }
+      }
+      break;
+
+      case InstructionOp::j:
+        break;
+
+      case InstructionOp::b:
+      case InstructionOp::blez:
+      case InstructionOp::bgtz:
+        access = {{inst.i.rs, Reg::zero}, Reg::zero};
+        break;
+
+      case InstructionOp::beq:
+      case InstructionOp::bne:
+        access = {{inst.i.rs, inst.i.rt}, Reg::zero};
+        break;
+
+      case InstructionOp::lui:
+        access = {{Reg::zero, Reg::zero}, inst.i.rt};
+        break;
+
+      case InstructionOp::addiu:
+      case InstructionOp::slti:
+      case InstructionOp::sltiu:
+      case InstructionOp::andi:
+      case InstructionOp::ori:
+      case InstructionOp::xori:
+      case InstructionOp::lb:
+      case InstructionOp::lbu:
+      case InstructionOp::lh:
+      case InstructionOp::lhu:
+      case InstructionOp::lw:
+        access = {{inst.i.rs, Reg::zero}, inst.i.rt};
+        break;
+
+      default:
+        return false;
+    }
+
+    if (access.write != Reg::zero)
+      written_regs |= u64(1) << static_cast<u8>(access.write);
+  }
+
+  u64 committed_regs = 0;
+  u64 pending_load_reg = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    const RegAccess& access = accesses[i];
+    const u64 write_bit = (access.write != Reg::zero) ? (u64(1) << static_cast<u8>(access.write)) : 0;
+    for (const Reg reg : access.reads)
+    {
+      // reading a value from the previous iteration, including through a load delay slot
+      const u64 read_bit = u64(1) << static_cast<u8>(reg);
+      if (reg != Reg::zero && (written_regs & read_bit) && !(committed_regs & read_bit))
+        return false;
+    }
+
+    if (instructions[i].second.is_load_instruction)
+    {
+      // the address is checked at runtime, so the base register can't change after the load, and the load can't be
+      // in the delay slot, because it'd complete in the next iteration
+      const Reg base = access.reads[0];
+      if (i == (count - 1) || base == access.write)
+        return false;
+      for (size_t j = i + 1; j < count; j++)
+      {
+        if (accesses[j].write == base)
+          return false;
+      }
+    }
+
+    if (write_bit & pending_load_reg)
+      return false;
+
+    committed_regs |= pending_load_reg;
+    if (instructions[i].second.is_load_instruction)
+    {
+      pending_load_reg = write_bit;
+    }
+    else
+    {
+      committed_regs |= write_bit;
+      pending_load_reg = 0;
+    }
+  }
+
+  return true;
+}
+
+bool CPU::CodeCache::IsIdleLoopPollAddress(VirtualMemoryAddress address)
+{
+  // RAM and the scratchpad only change through DMA or the CPU, and reading the interrupt registers has no side
+  // effects. Everything else could be a FIFO or counter where skipping time would change the result.
+  if ((address & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR)
+    return true;
+
+  const PhysicalMemoryAddress paddr = VirtualAddressToPhysical(address);
+  return (Bus::IsRAMAddress(paddr) || (paddr >= Bus::INTC_BASE && paddr < (Bus::INTC_BASE + Bus::INTC_SIZE)));
+}
+
+void CPU::CodeCache::SkipIdleLoop()
+{
+  if (g_state.pending_ticks >= g_state.downcount || HasPendingInterrupt())
+    return;
+
+  const u32 pc = g_state.pc;
+  const u32 table = pc >> LUT_TABLE_SHIFT;
+  const Block* block = s_block_lut[table] ? s_block_lut[table][(pc & 0xFFFF) >> 2] : nullptr;
+  if (!block || !block->HasFlag(BlockFlags::IdleLoop) || block->state != BlockState::Valid)
+    return;
+
+  // We've just completed an iteration, so the base registers still hold the addresses that were polled.
+  // Nothing they point to can change until the next event runs.
+  const Instruction* inst = block->Instructions();
+  for (u32 i = 0; i < block->size; i++, inst++)
+  {
+    if (IsMemoryLoadInstruction(*inst) &&
+        !IsIdleLoopPollAddress(g_state.regs.r[static_cast<u8>(inst->i.rs.GetValue())] + inst->i.imm_sext32()))
+    {
+      return;
+    }
+  }
+
+  g_state.pending_ticks = g_state.downcount;
+}
+
 void CPU::CodeCache::CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src)
 {
   std::memcpy(dst->reg_flags, src->reg_flags, sizeof(dst->reg_flags));
@@ -1061,8 +1578,30 @@ void CPU::CodeCache::SetRegAccess(InstructionInfo* inst, Reg reg, bool write)
     SetRegAccess(inst, reg, true);                                                                                     \
   } while (0)
 
-// TODO: memory loads should be delayed one instruction because of stupid load delays.
-#define BackpropSetWritesDelayed(reg) BackpropSetWrites(reg)
+// Loaded values don't land until after the next instruction, so if it reads the register, the old value is still live.
+#define BackpropSetWritesDelayed(reg)                                                                                  \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (!inst->is_last_instruction && InstructionMayReadRegister(iinst[1], reg))                                       \
+    {                                                                                                                  \
+      if (!(inst->reg_flags[static_cast<u8>(reg)] & RI_USED))                                                          \
+        inst->reg_flags[static_cast<u8>(reg)] |= RI_LASTUSE;                                                           \
+      inst->reg_flags[static_cast<u8>(reg)] |= RI_USED;                                                                \
+      SetRegAccess(inst, reg, true);                                                                                   \
+    }                                                                                                                  \
+    else                                                                                                               \
+    {                                                                                                                  \
+      BackpropSetWrites(reg);                                                                                          \
+    }                                                                                                                  \
+  } while (0)
+
+// Used for instructions which the block may be truncated or interrupted at, so nothing before them can be dead.
+#define BackpropSetAllLive()                                                                                           \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    for (u8& flags : prev->reg_flags)                                                                                  \
+      flags |= RI_LIVE;                                                                                                \
+  } while (0)
 
 void CPU::CodeCache::FillBlockRegInfo(Block* block)
 {
@@ -1159,6 +1698,7 @@ void CPU::CodeCache::FillBlockRegInfo(Block* block)
 
           default:
             Log_ErrorPrintf("Unknown funct %u", static_cast<u32>(iinst->r.funct.GetValue()));
+            BackpropSetAllLive();
             break;
         }
       }
@@ -1258,24 +1798,409 @@ void CPU::CodeCache::FillBlockRegInfo(Block* block)
 
         default:
           Log_ErrorPrintf("Unknown op %u", static_cast<u32>(iinst->r.funct.GetValue()));
+          BackpropSetAllLive();
           break;
       }
     } // end switch
 
+    // the exception handler sees every register as it was before a faulting instruction, so none of them can be dead
+    if (inst->can_trap || inst->is_load_instruction || inst->is_store_instruction)
+      BackpropSetAllLive();
+
+    // superblocks can leave at any branch, so everything is live after its delay slot
+    if (prev->is_branch_delay_slot)
+    {
+      for (u8& flags : prev->reg_flags)
+        flags |= RI_LIVE;
+    }
+
     inst--;
     iinst--;
   } // end while
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// MARK: - Recompiler Glue
+// MARK: - Block Profiling
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
+bool CPU::CodeCache::IsBlockProfilingEnabled()
 {
-  // TODO: this doesn't currently handle when the cache overflows...
-  DebugAssert(IsUsingAnyRecompiler());
-  MemMap::BeginCodeWrite();
+  return s_block_profiling.load(std::memory_order_relaxed);
+}
+
+void CPU::CodeCache::SetBlockProfilingEnabled(bool enabled)
+{
+  if (s_block_profiling.load(std::memory_order_relaxed) == enabled)
+    return;
+
+  Log_InfoFmt("Block profiling {}", enabled ? "enabled" : "disabled");
+  s_block_profiling.store(enabled, std::memory_order_relaxed);
+
+  // start counting from zero, recompilers need the counters compiled in
+  if (enabled)
+  {
+    for (Block* block : s_blocks)
+    {
+      block->execution_count = 0;
+      block->invalidate_count = 0;
+    }
+
+    s_invalidation_counts = {};
+  }
+
+  if (IsUsingAnyRecompiler())
+  {
+    CPU::ExecutionModeChanged();
+    Reset();
+  }
+}
+
+const char* CPU::CodeCache::GetBlockStateName(BlockState state)
+{
+  static constexpr std::array<const char*, 4> names = {
+    {"Valid", "Invalidated", "NeedsRecompile", "FallbackToInterpreter"}};
+  return names[static_cast<u8>(state)];
+}
+
+bool CPU::CodeCache::DumpBlockProfile(const char* path, Error* error)
+{
+  std::vector<const Block*> blocks(s_blocks.begin(), s_blocks.end());
+  std::sort(blocks.begin(), blocks.end(),
+            [](const Block* lhs, const Block* rhs) { return lhs->execution_count > rhs->execution_count; });
+
+  const u64 code_writes = s_invalidation_counts[static_cast<size_t>(InvalidationCause::CodeWrite)];
+  const u64 data_writes = s_invalidation_counts[static_cast<size_t>(InvalidationCause::DataWrite)];
+  const u64 page_faults = s_invalidation_counts[static_cast<size_t>(InvalidationCause::PageFault)];
+  Log_InfoFmt("Invalidations: {} code writes, {} page faults, {} data writes to code pages skipped", code_writes,
+              page_faults, data_writes);
+
+  const bool json = StringUtil::EndsWithNoCase(path, ".json");
+  std::string out;
+  if (json)
+  {
+    fmt::format_to(std::back_inserter(out),
+                   "{{\n\"invalidations\": {{\"code_writes\": {}, \"data_writes\": {}, \"page_faults\": {}}},\n"
+                   "\"blocks\": [\n",
+                   code_writes, data_writes, page_faults);
+  }
+  else
+  {
+    out += "pc,size,host_size,state,invalidations,executions\n";
+  }
+
+  for (size_t i = 0; i < blocks.size(); i++)
+  {
+    const Block* block = blocks[i];
+    if (json)
+    {
+      fmt::format_to(std::back_inserter(out),
+                     "  {{\"pc\": \"0x{:08X}\", \"size\": {}, \"host_size\": {}, \"state\": \"{}\", "
+                     "\"invalidations\": {}, \"executions\": {}}}{}\n",
+                     block->pc, block->size, block->host_code_size, GetBlockStateName(block->state),
+                     block->invalidate_count, block->execution_count, (i == (blocks.size() - 1)) ? "" : ",");
+    }
+    else
+    {
+      fmt::format_to(std::back_inserter(out), "0x{:08X},{},{},{},{},{}\n", block->pc, block->size,
+                     block->host_code_size, GetBlockStateName(block->state), block->invalidate_count,
+                     block->execution_count);
+    }
+  }
+
+  if (json)
+    out += "]\n}\n";
+
+  auto fp = FileSystem::OpenManagedCFile(path, "wb", error);
+  if (!fp)
+    return false;
+
+  if (std::fwrite(out.data(), out.size(), 1, fp.get()) != 1)
+  {
+    Error::SetErrno(error, "fwrite() failed: ", errno);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote profile for {} blocks to {}", blocks.size(), path);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MARK: - Persistent Block Cache
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string CPU::CodeCache::GetPersistentCacheFileName()
+{
+  const std::string& serial = System::GetGameSerial();
+  return Path::Combine(EmuFolders::Cache,
+                       fmt::format("blocks_{}.cache", serial.empty() ? std::string("bios") : Path::SanitizeFileName(serial)));
+}
+
+void CPU::CodeCache::LoadPersistentCache()
+{
+  s_persistent_blocks.clear();
+  s_persistent_pages_compiled.clear();
+  s_persistent_cache_filename = {};
+  s_persistent_cache_dirty = false;
+  if (!g_settings.cpu_recompiler_persistent_cache)
+    return;
+
+  s_persistent_cache_filename = GetPersistentCacheFileName();
+
+  std::unique_ptr<ByteStream> stream =
+    ByteStream::OpenFile(s_persistent_cache_filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+    return;
+
+  u32 signature, version, num_blocks;
+  bool result = (stream->ReadU32(&signature) && signature == CODE_CACHE_SIGNATURE && stream->ReadU32(&version) &&
+                 version == CODE_CACHE_VERSION && stream->ReadU32(&num_blocks));
+  for (u32 i = 0; result && i < num_blocks; i++)
+  {
+    u32 pc;
+    PersistentBlockInfo info;
+    result = (stream->ReadU32(&pc) && stream->ReadU32(&info.size) && stream->ReadU64(&info.hash) && info.size > 0);
+    if (result)
+      s_persistent_blocks.emplace(pc, info);
+  }
+
+  if (!result)
+  {
+    Log_WarningFmt("Discarding stale or corrupted block cache '{}'", Path::GetFileName(s_persistent_cache_filename));
+    stream.reset();
+    s_persistent_blocks.clear();
+    FileSystem::DeleteFile(s_persistent_cache_filename.c_str());
+    return;
+  }
+
+  Log_InfoFmt("Loaded {} blocks from block cache '{}'", s_persistent_blocks.size(),
+              Path::GetFileName(s_persistent_cache_filename));
+}
+
+void CPU::CodeCache::SavePersistentCache()
+{
+  if (s_persistent_cache_filename.empty() || !s_persistent_cache_dirty)
+  {
+    s_persistent_blocks.clear();
+    s_persistent_pages_compiled.clear();
+    s_persistent_cache_filename = {};
+    return;
+  }
+
+  Error error;
+  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(
+    s_persistent_cache_filename.c_str(),
+    BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE, &error);
+  if (!stream)
+  {
+    Log_ErrorFmt("Failed to open block cache '{}': {}", Path::GetFileName(s_persistent_cache_filename),
+                 error.GetDescription());
+  }
+  else
+  {
+    bool result = (stream->WriteU32(CODE_CACHE_SIGNATURE) && stream->WriteU32(CODE_CACHE_VERSION) &&
+                   stream->WriteU32(static_cast<u32>(s_persistent_blocks.size())));
+    for (auto it = s_persistent_blocks.begin(); result && it != s_persistent_blocks.end(); ++it)
+      result = (stream->WriteU32(it->first) && stream->WriteU32(it->second.size) && stream->WriteU64(it->second.hash));
+
+    if (result && stream->Commit())
+    {
+      Log_InfoFmt("Wrote {} blocks to block cache '{}'", s_persistent_blocks.size(),
+                  Path::GetFileName(s_persistent_cache_filename));
+    }
+    else
+    {
+      Log_ErrorFmt("Failed to write block cache '{}'", Path::GetFileName(s_persistent_cache_filename));
+      stream->Discard();
+    }
+  }
+
+  s_persistent_blocks.clear();
+  s_persistent_pages_compiled.clear();
+  s_persistent_cache_filename = {};
+  s_persistent_cache_dirty = false;
+}
+
+u64 CPU::CodeCache::GetPersistentBlockHash(const Instruction* instructions, u32 size)
+{
+  return XXH3_64bits(instructions, sizeof(Instruction) * size);
+}
+
+void CPU::CodeCache::AddPersistentBlock(const Block* block)
+{
+  const PersistentBlockInfo info = {block->size, GetPersistentBlockHash(block->Instructions(), block->size)};
+  auto it = s_persistent_blocks.find(block->pc);
+  if (it != s_persistent_blocks.end())
+  {
+    if (it->second.size == info.size && it->second.hash == info.hash)
+      return;
+
+    it->second = info;
+  }
+  else
+  {
+    s_persistent_blocks.emplace(block->pc, info);
+  }
+
+  s_persistent_cache_dirty = true;
+}
+
+void CPU::CodeCache::CompilePersistentBlocksInPage(u32 pc)
+{
+  // Each page is only expanded the first time it's entered, blocks which failed to match aren't retried. If the budget
+  // runs out, the page is tried again on its next compile.
+  const u32 page_start = pc & ~(HOST_PAGE_SIZE - 1);
+  const u32 page_end = page_start + HOST_PAGE_SIZE;
+  if (!s_persistent_pages_compiled.insert(page_start).second)
+    return;
+
+  u32 num_compiled = 0;
+
+  for (auto it = s_persistent_blocks.lower_bound(page_start); it != s_persistent_blocks.end() && it->first < page_end;
+       ++it)
+  {
+    const u32 block_pc = it->first;
+    const PersistentBlockInfo& info = it->second;
+    if (LookupBlock(block_pc))
+      continue;
+    if (!HasCompileBudget() || !HasSpaceForSpeculativeCompile(info.size))
+    {
+      s_persistent_pages_compiled.erase(page_start);
+      break;
+    }
+
+    num_compiled += BoolToUInt32(CompilePersistentBlock(block_pc, info));
+  }
+
+  if (num_compiled > 0)
+    Log_DevFmt("Compiled {} blocks from block cache in page 0x{:08X}", num_compiled, page_start);
+}
+
+bool CPU::CodeCache::HasSpaceForSpeculativeCompile(u32 size)
+{
+  // Don't flush the cache for speculative compiles, the block will get compiled whenever it's executed anyway.
+  return (s_code_buffer.GetFreeCodeSpace() >= (size * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) &&
+          s_code_buffer.GetFreeFarCodeSpace() >= (size * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION));
+}
+
+bool CPU::CodeCache::CompilePersistentBlock(u32 pc, const PersistentBlockInfo& info)
+{
+  // Only compile if the code in memory still matches what we saw last time.
+  BlockMetadata metadata = {};
+  if (!ReadBlockInstructions(pc, &s_block_instructions, &metadata) || s_block_instructions.size() != info.size)
+    return false;
+
+  s_persistent_hash_buffer.resize(info.size);
+  for (u32 i = 0; i < info.size; i++)
+    s_persistent_hash_buffer[i].bits = s_block_instructions[i].first.bits;
+  if (GetPersistentBlockHash(s_persistent_hash_buffer.data(), info.size) != info.hash)
+    return false;
+
+  Block* block = CreateBlock(pc, s_block_instructions, metadata);
+  if (!block || block->size == 0 || !CompileBlock(block))
+  {
+    SetCodeLUT(pc, g_interpret_block);
+    BacklinkBlocks(pc, g_interpret_block);
+    return false;
+  }
+
+  SetCodeLUT(pc, block->host_code);
+  BacklinkBlocks(pc, block->host_code);
+  return true;
+}
+
+bool CPU::CodeCache::SaveWarmupList(const char* path, Error* error)
+{
+  // Hottest first, so they're the ones that get compiled if the code buffer fills up.
+  std::vector<const Block*> blocks;
+  blocks.reserve(s_blocks.size());
+  for (const Block* block : s_blocks)
+  {
+    if (block->state == BlockState::Valid && block->host_code)
+      blocks.push_back(block);
+  }
+  std::sort(blocks.begin(), blocks.end(), [](const Block* lhs, const Block* rhs) {
+    return (lhs->hot_count != rhs->hot_count) ? (lhs->hot_count < rhs->hot_count) :
+                                                (lhs->execution_count > rhs->execution_count);
+  });
+
+  std::unique_ptr<ByteStream> stream =
+    ByteStream::OpenFile(path,
+                         BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                           BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED,
+                         error);
+  if (!stream)
+    return false;
+
+  bool result = (stream->WriteU32(WARMUP_LIST_SIGNATURE) && stream->WriteU32(CODE_CACHE_VERSION) &&
+                 stream->WriteU32(static_cast<u32>(blocks.size())));
+  for (size_t i = 0; result && i < blocks.size(); i++)
+  {
+    const Block* block = blocks[i];
+    result = (stream->WriteU32(block->pc) && stream->WriteU32(block->size) &&
+              stream->WriteU64(GetPersistentBlockHash(block->Instructions(), block->size)));
+  }
+
+  if (!result || !stream->Commit())
+  {
+    Error::SetStringView(error, "Failed to write warmup list.");
+    stream->Discard();
+    return false;
+  }
+
+  Log_DevFmt("Wrote {} blocks to warmup list '{}'", blocks.size(), Path::GetFileName(path));
+  return true;
+}
+
+void CPU::CodeCache::CompileWarmupList(const char* path)
+{
+  if (!IsUsingAnyRecompiler())
+    return;
+
+  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(path, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+    return;
+
+  u32 signature, version, num_blocks;
+  if (!stream->ReadU32(&signature) || signature != WARMUP_LIST_SIGNATURE || !stream->ReadU32(&version) ||
+      version != CODE_CACHE_VERSION || !stream->ReadU32(&num_blocks))
+  {
+    Log_WarningFmt("Ignoring stale or corrupted warmup list '{}'", Path::GetFileName(path));
+    return;
+  }
+
+  Common::Timer timer;
+  u32 num_compiled = 0;
+  MemMap::BeginCodeWrite();
+
+  for (u32 i = 0; i < num_blocks; i++)
+  {
+    u32 pc;
+    PersistentBlockInfo info;
+    if (!stream->ReadU32(&pc) || !stream->ReadU32(&info.size) || !stream->ReadU64(&info.hash) || info.size == 0)
+      break;
+    if (LookupBlock(pc))
+      continue;
+    if (!HasSpaceForSpeculativeCompile(info.size))
+      break;
+
+    num_compiled += BoolToUInt32(CompilePersistentBlock(pc, info));
+  }
+
+  MemMap::EndCodeWrite();
+
+  Log_InfoFmt("Compiled {} of {} blocks from warmup list in {:.2f} ms", num_compiled, num_blocks,
+              timer.GetTimeMilliseconds());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MARK: - Recompiler Glue
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
+{
+  // TODO: this doesn't currently handle when the cache overflows...
+  DebugAssert(IsUsingAnyRecompiler());
+  MemMap::BeginCodeWrite();
 
   Block* block = LookupBlock(start_pc);
   if (block)
@@ -1290,7 +2215,18 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       MemMap::EndCodeWrite();
       return;
     }
+  }
 
+  // Must happen before unlinking, otherwise a later revalidation would leave stale exit links.
+  if (!HasCompileBudget())
+  {
+    DeferBlockCompilation(start_pc);
+    MemMap::EndCodeWrite();
+    return;
+  }
+
+  if (block)
+  {
     // remove outward links from this block, since we're recompiling it
     UnlinkBlockExits(block);
 
@@ -1315,8 +2251,11 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
   if (s_code_buffer.GetFreeCodeSpace() < (block_size * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
       s_code_buffer.GetFreeFarCodeSpace() < (block_size * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
   {
-    Log_ErrorFmt("Out of code space while compiling {:08X}. Resetting code cache.", start_pc);
-    CodeCache::Reset();
+    if (!EvictCodeGeneration())
+    {
+      Log_ErrorFmt("Out of code space while compiling {:08X}. Resetting code cache.", start_pc);
+      CodeCache::Reset();
+    }
   }
 
   if ((block = CreateBlock(start_pc, s_block_instructions, metadata)) == nullptr || block->size == 0 ||
@@ -1331,6 +2270,60 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
 
   SetCodeLUT(start_pc, block->host_code);
   BacklinkBlocks(start_pc, block->host_code);
+
+  if (!s_persistent_cache_filename.empty())
+  {
+    AddPersistentBlock(block);
+    CompilePersistentBlocksInPage(start_pc);
+  }
+
+  MemMap::EndCodeWrite();
+}
+
+bool CPU::CodeCache::IsSuperblockTierEnabled()
+{
+#ifdef ENABLE_NEWREC
+  return (NewRec::SUPPORTS_SUPERBLOCKS && g_settings.cpu_execution_mode == CPUExecutionMode::NewRec &&
+          g_settings.cpu_recompiler_superblocks);
+#else
+  return false;
+#endif
+}
+
+bool CPU::CodeCache::HasCompileBudget()
+{
+  return (!g_settings.cpu_recompiler_defer_compilation ||
+          s_compile_budget_used < COMPILE_BUDGET_INSTRUCTIONS_PER_FRAME);
+}
+
+void CPU::CodeCache::DeferBlockCompilation(u32 pc)
+{
+  Log_DevFmt("Compile budget exhausted, interpreting block 0x{:08X} until next frame", pc);
+  SetCodeLUT(pc, g_interpret_block);
+  BacklinkBlocks(pc, g_interpret_block);
+  s_deferred_compile_pcs.push_back(pc);
+}
+
+void CPU::CodeCache::ResetCompileBudget()
+{
+  s_compile_budget_used = 0;
+  if (s_deferred_compile_pcs.empty())
+    return;
+
+  MemMap::BeginCodeWrite();
+
+  for (const u32 pc : s_deferred_compile_pcs)
+  {
+    // may have been compiled in the meantime by the persistent cache
+    const Block* block = LookupBlock(pc);
+    if (block && block->state == BlockState::Valid)
+      continue;
+
+    SetCodeLUT(pc, g_compile_or_revalidate_block);
+    BacklinkBlocks(pc, g_compile_or_revalidate_block);
+  }
+  s_deferred_compile_pcs.clear();
+
   MemMap::EndCodeWrite();
 }
 
@@ -1338,9 +2331,18 @@ void CPU::CodeCache::DiscardAndRecompileBlock(u32 start_pc)
 {
   MemMap::BeginCodeWrite();
 
-  Log_DevPrintf("Discard block %08X with manual protection", start_pc);
   Block* block = LookupBlock(start_pc);
   DebugAssert(block && block->state == BlockState::Valid);
+  if (block->HasFlag(BlockFlags::CountsExecutions) && block->hot_count == 0)
+  {
+    Log_DevFmt("Promoting hot block {:08X} to superblock", start_pc);
+    s_superblock_pcs.insert(start_pc);
+  }
+  else
+  {
+    Log_DevPrintf("Discard block %08X with manual protection", start_pc);
+  }
+
   InvalidateBlock(block, BlockState::NeedsRecompile);
   CompileOrRevalidateBlock(start_pc);
 
@@ -1370,8 +2372,15 @@ const void* CPU::CodeCache::CreateBlockLink(Block* block, void* code, u32 newpc)
     }
 
     BlockLinkMap::iterator iter = s_block_links.emplace(newpc, code);
-    DebugAssert(block->num_exit_links < MAX_BLOCK_EXIT_LINKS);
-    block->exit_links[block->num_exit_links++] = iter;
+    if (block->num_exit_links < MAX_BLOCK_EXIT_LINKS)
+    {
+      block->exit_links[block->num_exit_links++] = iter;
+    }
+    else
+    {
+      DebugAssert(block->HasFlag(BlockFlags::Superblock));
+      s_superblock_exit_links[block->pc].push_back(iter);
+    }
   }
 
   Log_DebugPrintf("Linking %p with dst pc %08X to %p%s", code, newpc, dst,
@@ -1399,6 +2408,17 @@ void CPU::CodeCache::UnlinkBlockExits(Block* block)
   for (u32 i = 0; i < num_exit_links; i++)
     s_block_links.erase(block->exit_links[i]);
   block->num_exit_links = 0;
+
+  if (num_exit_links == MAX_BLOCK_EXIT_LINKS)
+  {
+    const auto iter = s_superblock_exit_links.find(block->pc);
+    if (iter != s_superblock_exit_links.end())
+    {
+      for (const BlockLinkMap::iterator& link : iter->second)
+        s_block_links.erase(link);
+      s_superblock_exit_links.erase(iter);
+    }
+  }
 }
 
 JitCodeBuffer& CPU::CodeCache::GetCodeBuffer()
@@ -1448,11 +2468,56 @@ void CPU::CodeCache::CompileASMFunctions()
 #endif
 
   s_code_buffer.CommitCode(asm_size);
+
+  // blocks are evicted a generation at a time, the dispatchers stay where they are
+  s_code_buffer.EnableGenerations();
+
   MemMap::EndCodeWrite();
 }
 
+bool CPU::CodeCache::EvictCodeGeneration()
+{
+  if (!s_code_buffer.SwitchGeneration())
+    return false;
+
+  // Backpatch thunks are always placed in the generation being filled, which is never older than the block that they
+  // belong to. So dropping every block with code in the generation we're about to overwrite is enough.
+  u32 num_evicted = 0;
+  for (Block* block : s_blocks)
+  {
+    if (!block->host_code || !s_code_buffer.IsInCurrentGeneration(block->host_code))
+      continue;
+
+    if (block->state == BlockState::Valid)
+    {
+      RemoveBlockFromPageList(block);
+      SetCodeLUT(block->pc, g_compile_or_revalidate_block);
+      BacklinkBlocks(block->pc, g_compile_or_revalidate_block);
+    }
+
+    // host code is gone, so it can't be revalidated
+    if (block->state != BlockState::FallbackToInterpreter)
+      block->state = BlockState::NeedsRecompile;
+
+    UnlinkBlockExits(block);
+    RemoveBackpatchInfoForRange(block->host_code, block->host_code_size);
+    block->host_code = nullptr;
+    block->host_code_size = 0;
+
+    // recompiling after eviction isn't the block changing, don't let it push the block to the interpreter
+    block->compile_count = 0;
+    num_evicted++;
+  }
+
+  s_code_evictions++;
+  Log_InfoFmt("Evicted {} blocks from old code generation, {} evictions so far.", num_evicted, s_code_evictions);
+  return true;
+}
+
 bool CPU::CodeCache::CompileBlock(Block* block)
 {
+  System::ProfileSubsystemScope profile(System::ProfiledSubsystem::CodeCompile);
+
   const void* host_code = nullptr;
   u32 host_code_size = 0;
   u32 host_far_code_size = 0;
@@ -1471,6 +2536,7 @@ bool CPU::CodeCache::CompileBlock(Block* block)
 
   block->host_code = host_code;
   block->host_code_size = host_code_size;
+  s_compile_budget_used += block->size;
 
   if (!host_code)
   {
@@ -1513,16 +2579,12 @@ void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 gue
 {
   DebugAssert(code_size < std::numeric_limits<u8>::max());
 
-  auto iter = s_fastmem_backpatch_info.find(code_address);
-  if (iter != s_fastmem_backpatch_info.end())
-    s_fastmem_backpatch_info.erase(iter);
-
   LoadstoreBackpatchInfo info;
   info.thunk_address = thunk_address;
   info.guest_pc = guest_pc;
   info.guest_block = 0;
   info.code_size = static_cast<u8>(code_size);
-  s_fastmem_backpatch_info.emplace(code_address, info);
+  AddBackpatchInfo(code_address, info);
 }
 
 void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 guest_pc, u32 guest_block,
@@ -1532,10 +2594,6 @@ void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 gue
   DebugAssert(code_size < std::numeric_limits<u8>::max());
   DebugAssert(cycles >= 0 && cycles < std::numeric_limits<u16>::max());
 
-  auto iter = s_fastmem_backpatch_info.find(code_address);
-  if (iter != s_fastmem_backpatch_info.end())
-    s_fastmem_backpatch_info.erase(iter);
-
   LoadstoreBackpatchInfo info;
   info.thunk_address = nullptr;
   info.guest_pc = guest_pc;
@@ -1548,7 +2606,7 @@ void CPU::CodeCache::AddLoadStoreInfo(void* code_address, u32 code_size, u32 gue
   info.is_signed = is_signed;
   info.is_load = is_load;
   info.code_size = static_cast<u8>(code_size);
-  s_fastmem_backpatch_info.emplace(code_address, info);
+  AddBackpatchInfo(code_address, info);
 }
 
 PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exception_pc, void* fault_address,
@@ -1569,9 +2627,9 @@ PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exc
     guest_address = static_cast<PhysicalMemoryAddress>(
       static_cast<ptrdiff_t>(static_cast<u8*>(fault_address) - static_cast<u8*>(g_state.fastmem_base)));
 
-    // if we're writing to ram, let it go through a few times, and use manual block protection to sort it out
-    // TODO: path for manual protection to return back to read-only pages
-    if (is_write && !g_state.cop0_regs.sr.Isc && AddressInRAM(guest_address))
+    // stores from recompiled code are backpatched to the slow path below, which writes through the unprotected view
+    // and only invalidates the blocks the store overlaps, anything else invalidates the whole page
+    if (is_write && !g_state.cop0_regs.sr.Isc && AddressInRAM(guest_address) && !FindBackpatchInfo(exception_pc))
     {
       Log_DevFmt("Ignoring fault due to RAM write @ 0x{:08X}", guest_address);
       InvalidateBlocksWithPageIndex(Bus::GetRAMCodePageIndex(guest_address));
@@ -1588,14 +2646,14 @@ PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exc
   Log_DevFmt("Page fault handler invoked at PC={} Address={} {}, fastmem offset {:08X}", exception_pc, fault_address,
              is_write ? "(write)" : "(read)", guest_address);
 
-  auto iter = s_fastmem_backpatch_info.find(exception_pc);
-  if (iter == s_fastmem_backpatch_info.end())
+  LoadstoreBackpatchInfo* const info_ptr = FindBackpatchInfo(exception_pc);
+  if (!info_ptr)
   {
     Log_ErrorFmt("No backpatch info found for {}", exception_pc);
     return PageFaultHandler::HandlerResult::ExecuteNextHandler;
   }
 
-  LoadstoreBackpatchInfo& info = iter->second;
+  LoadstoreBackpatchInfo& info = *info_ptr;
   Log_DevFmt("Backpatching {} at {}[{}] (pc {:08X} addr {:08X}): Bitmask {:08X} Addr {} Data {} Size {} Signed {:02X}",
              info.is_load ? "load" : "store", exception_pc, info.code_size, info.guest_pc, guest_address,
              info.gpr_bitmask, static_cast<unsigned>(info.address_register), static_cast<unsigned>(info.data_register),
@@ -1626,7 +2684,8 @@ PageFaultHandler::HandlerResult CPU::CodeCache::HandleFastmemException(void* exc
 
   // and store the pc in the faulting list, so that we don't emit another fastmem loadstore
   s_fastmem_faulting_pcs.insert(info.guest_pc);
-  s_fastmem_backpatch_info.erase(iter);
+  info.code_size = 0;
+  s_fastmem_backpatch_dead_count++;
   return PageFaultHandler::HandlerResult::ContinueExecution;
 }
 
@@ -1647,26 +2706,65 @@ void CPU::CodeCache::BackpatchLoadStore(void* host_pc, const LoadstoreBackpatchI
 #endif
 }
 
-void CPU::CodeCache::RemoveBackpatchInfoForRange(const void* host_code, u32 size)
+void CPU::CodeCache::AddBackpatchInfo(const void* host_pc, const LoadstoreBackpatchInfo& info)
 {
-  const u8* start = static_cast<const u8*>(host_code);
-  const u8* end = start + size;
-
-  auto start_iter = s_fastmem_backpatch_info.lower_bound(start);
-  if (start_iter == s_fastmem_backpatch_info.end())
+  if (s_fastmem_backpatch_info.empty() || s_fastmem_backpatch_info.back().host_pc < host_pc)
+  {
+    s_fastmem_backpatch_info.push_back(BackpatchInfoEntry{host_pc, info});
     return;
+  }
 
-  // this might point to another block, so bail out in that case
-  if (start_iter->first >= end)
+  // code which is emitted after a generation switch or reset can land before existing entries
+  const auto iter =
+    std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), host_pc,
+                     [](const BackpatchInfoEntry& entry, const void* pc) { return entry.host_pc < pc; });
+  if (iter != s_fastmem_backpatch_info.end() && iter->host_pc == host_pc)
+  {
+    // the most recently emitted code wins
+    if (iter->info.code_size == 0)
+      s_fastmem_backpatch_dead_count--;
+    iter->info = info;
     return;
+  }
 
-  // find the end point, or last instruction in the range
-  auto end_iter = start_iter;
-  do
+  s_fastmem_backpatch_info.insert(iter, BackpatchInfoEntry{host_pc, info});
+}
+
+CPU::CodeCache::LoadstoreBackpatchInfo* CPU::CodeCache::FindBackpatchInfo(const void* host_pc)
+{
+  const auto iter =
+    std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), host_pc,
+                     [](const BackpatchInfoEntry& entry, const void* pc) { return entry.host_pc < pc; });
+  if (iter == s_fastmem_backpatch_info.end() || iter->host_pc != host_pc || iter->info.code_size == 0)
+    return nullptr;
+
+  return &iter->info;
+}
+
+void CPU::CodeCache::CompactBackpatchInfo()
+{
+  s_fastmem_backpatch_info.erase(std::remove_if(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(),
+                                                [](const BackpatchInfoEntry& entry) { return entry.info.code_size == 0; }),
+                                 s_fastmem_backpatch_info.end());
+  s_fastmem_backpatch_dead_count = 0;
+}
+
+void CPU::CodeCache::RemoveBackpatchInfoForRange(const void* host_code, u32 size)
+{
+  const u8* start = static_cast<const u8*>(host_code);
+  const u8* end = start + size;
+
+  auto iter = std::lower_bound(s_fastmem_backpatch_info.begin(), s_fastmem_backpatch_info.end(), start,
+                               [](const BackpatchInfoEntry& entry, const u8* pc) { return entry.host_pc < pc; });
+  for (; iter != s_fastmem_backpatch_info.end() && static_cast<const u8*>(iter->host_pc) < end; ++iter)
   {
-    ++end_iter;
-  } while (end_iter != s_fastmem_backpatch_info.end() && end_iter->first < end);
+    if (iter->info.code_size == 0)
+      continue;
+
+    iter->info.code_size = 0;
+    s_fastmem_backpatch_dead_count++;
+  }
 
-  // erase the whole range at once
-  s_fastmem_backpatch_info.erase(start_iter, end_iter);
+  if (s_fastmem_backpatch_dead_count > (s_fastmem_backpatch_info.size() / 2))
+    CompactBackpatchInfo();
 }
@@ -16,8 +16,9 @@ bool IsUsingAnyRecompiler();
 /// Returns true if any recompiler and fastmem is in use.
 bool IsUsingFastmem();
 
-/// Allocates resources, call once at startup.
-bool ProcessStartup(Error* error);
+/// Allocates resources, call once at startup. The code buffer is backed by huge pages when use_huge_pages is set and
+/// the host supports it.
+bool ProcessStartup(bool use_huge_pages, Error* error);
 
 /// Frees resources, call once at shutdown.
 void ProcessShutdown();
@@ -34,9 +35,49 @@ void Shutdown();
 /// Flushes the code cache, forcing all blocks to be recompiled.
 void Reset();
 
+struct Statistics
+{
+  u32 num_blocks;
+  u32 code_buffer_used; // near and far code, in bytes
+  u32 code_buffer_size;
+  u32 code_evictions;
+};
+
+/// Returns the block count and code buffer usage, for monitoring.
+Statistics GetStatistics();
+
+/// Allows blocks which were deferred due to the per-frame compile budget to be compiled again. Call once per frame.
+void ResetCompileBudget();
+
+/// Returns true if block executions are being counted.
+bool IsBlockProfilingEnabled();
+
+/// Starts or stops counting block executions. The counters are compiled into the blocks, so this flushes the cache.
+void SetBlockProfilingEnabled(bool enabled);
+
+/// Writes execution and invalidation statistics for every block to a file. JSON if the extension is .json, else CSV.
+bool DumpBlockProfile(const char* path, Error* error);
+
+/// Writes out the persistent block cache, and reopens it if still enabled. Call when the setting changes.
+void ReloadPersistentCache();
+
+/// Writes the PC, size and hash of every compiled block to a file, hottest first. Used for resume states.
+bool SaveWarmupList(const char* path, Error* error);
+
+/// Compiles the blocks in a warmup list which still match memory, so they don't have to be compiled as they're
+/// executed. Call after loading the state the list was saved with.
+void CompileWarmupList(const char* path);
+
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates the blocks overlapping a store to a code page. Stores which don't touch any code are ignored.
+void InvalidateBlocksInRange(u32 ram_offset, u32 size);
+
+/// Invalidates all blocks in the specified code page, without counting it towards the page's write frequency.
+/// Used when loading memory states.
+void InvalidateRAMPageBlocks(u32 page_index);
+
 /// Invalidates all blocks in the cache.
 void InvalidateAllRAMBlocks();
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "bus.h"
+#include "common/align.h"
 #include "common/bitfield.h"
 #include "common/perf_scope.h"
 #include "cpu_code_cache.h"
@@ -80,6 +81,9 @@ struct InstructionInfo
 
   /// Returns true if this instruction reads this register.
   inline bool ReadsReg(Reg reg) const { return (read_reg[0] == reg || read_reg[1] == reg || read_reg[2] == reg); }
+
+  /// Returns true if the value in the register after this instruction is overwritten before it is read.
+  inline bool IsDeadWrite(Reg reg) const { return ((reg_flags[static_cast<u8>(reg)] & RI_LIVE) == 0); }
 };
 
 enum class BlockState : u8
@@ -96,6 +100,9 @@ enum class BlockFlags : u8
   ContainsLoadStoreInstructions = (1 << 0),
   SpansPages = (1 << 1),
   BranchDelaySpansPages = (1 << 2),
+  Superblock = (1 << 3),
+  CountsExecutions = (1 << 4),
+  IdleLoop = (1 << 5),
 };
 IMPLEMENT_ENUM_CLASS_BITWISE_OPERATORS(BlockFlags);
 
@@ -110,9 +117,14 @@ struct BlockMetadata
 {
   TickCount uncached_fetch_ticks;
   u32 icache_line_count;
+  TickCount icache_line_fill_ticks;
   BlockFlags flags;
 };
 
+/// Pre-decoded cached interpreter handler, executes g_state.current_instruction, which is at inst in the block.
+/// Returns the number of following instructions which were also executed, for fused handlers.
+using InterpreterHandler = u32 (*)(const Instruction* inst);
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4324) // C4324: 'CPU::CodeCache::Block': structure was padded due to alignment specifier)
@@ -137,12 +149,32 @@ struct alignas(16) Block
 
   TickCount uncached_fetch_ticks;
   u32 icache_line_count;
+  TickCount icache_line_fill_ticks; // all lines are in the same region, so they take the same time to fill
 
   u32 host_code_size;
   u32 compile_frame;
   u8 compile_count;
 
-  // followed by Instruction * size, InstructionRegInfo * size
+  // executions remaining before the block is promoted to a superblock, decremented by the block itself
+  u32 hot_count;
+
+  // only updated when block profiling is enabled, kept across recompiles
+  u32 execution_count;
+  u32 invalidate_count;
+
+  // followed by Instruction * size, InstructionRegInfo * size, then InterpreterHandler * size if cached interpreter
+  ALWAYS_INLINE static size_t GetAllocationSize(u32 size, bool has_interpreter_handlers)
+  {
+    const size_t size_without_handlers = GetInterpreterHandlersOffset(size);
+    return has_interpreter_handlers ? (size_without_handlers + (sizeof(InterpreterHandler) * size)) :
+                                      size_without_handlers;
+  }
+  ALWAYS_INLINE static size_t GetInterpreterHandlersOffset(u32 size)
+  {
+    return Common::AlignUpPow2(sizeof(Block) + ((sizeof(Instruction) + sizeof(InstructionInfo)) * size),
+                               alignof(InterpreterHandler));
+  }
+
   ALWAYS_INLINE const Instruction* Instructions() const { return reinterpret_cast<const Instruction*>(this + 1); }
   ALWAYS_INLINE Instruction* Instructions() { return reinterpret_cast<Instruction*>(this + 1); }
 
@@ -155,6 +187,17 @@ struct alignas(16) Block
     return reinterpret_cast<InstructionInfo*>(Instructions() + size);
   }
 
+  // only allocated when the cached interpreter is in use
+  ALWAYS_INLINE const InterpreterHandler* InterpreterHandlers() const
+  {
+    return reinterpret_cast<const InterpreterHandler*>(reinterpret_cast<const u8*>(this) +
+                                                       GetInterpreterHandlersOffset(size));
+  }
+  ALWAYS_INLINE InterpreterHandler* InterpreterHandlers()
+  {
+    return reinterpret_cast<InterpreterHandler*>(reinterpret_cast<u8*>(this) + GetInterpreterHandlersOffset(size));
+  }
+
   // returns true if the block has a given flag
   ALWAYS_INLINE bool HasFlag(BlockFlags flag) const { return ((flags & flag) != BlockFlags::None); }
 
@@ -210,16 +253,39 @@ static inline bool AddressInRAM(VirtualMemoryAddress pc)
   return VirtualAddressToPhysical(pc) < Bus::g_ram_size;
 }
 
+// Stores to a page only invalidate the blocks they overlap, tracked in granules so data next to code can be skipped.
+static constexpr u32 CODE_GRANULE_SIZE = HOST_PAGE_SIZE / 64;
+
 struct PageProtectionInfo
 {
   Block* first_block_in_page;
   Block* last_block_in_page;
 
+  // one bit per CODE_GRANULE_SIZE bytes of the page, set if any block in the list covers it
+  u64 code_granule_mask;
+
   PageProtectionMode mode;
   u16 invalidate_count;
   u32 invalidate_frame;
 };
-static_assert(sizeof(PageProtectionInfo) == (sizeof(Block*) * 2 + 8));
+static_assert(sizeof(PageProtectionInfo) == (sizeof(Block*) * 2 + 16));
+
+enum class InvalidationCause : u8
+{
+  CodeWrite,   // store overlapping a block, only the overlapping blocks are invalidated
+  DataWrite,   // store to a code page which didn't touch any code, ignored
+  PageFault,   // write fault on a protected page, all blocks in the page are invalidated
+  Count
+};
+
+template<PGXPMode pgxp_mode>
+InterpreterHandler GetInterpreterHandler(const Instruction inst);
+
+/// Looks for a common sequence of instructions at inst which can be executed by a single handler. Returns the number
+/// of instructions covered by the handler written to out_handler, or zero if there isn't one.
+template<PGXPMode pgxp_mode>
+u32 GetFusedInterpreterHandler(const Instruction* inst, const InstructionInfo* info, u32 count,
+                               InterpreterHandler* out_handler);
 
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const Block* block);
@@ -227,6 +293,9 @@ void InterpretCachedBlock(const Block* block);
 template<PGXPMode pgxp_mode>
 void InterpretUncachedBlock();
 
+/// Fast-forwards to the next event if the block at the current PC is an idle loop, called when it branches to itself.
+void SkipIdleLoop();
+
 void LogCurrentState();
 
 #if defined(_DEBUG) || false
@@ -18,9 +18,11 @@
 #include "util/state_wrapper.h"
 
 #include "common/align.h"
+#include "common/error.h"
 #include "common/fastjmp.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/trace.h"
 
 #include <cstdio>
 
@@ -62,13 +64,15 @@ static void TracePrintInstruction();
 static void DisassembleAndPrint(u32 addr, bool regs, const char* prefix);
 static void PrintInstruction(u32 bits, u32 pc, bool regs, const char* prefix);
 static void LogInstruction(u32 bits, u32 pc, bool regs);
+static void AddTraceBufferEntry(u32 pc, u32 bits);
+static void SetTraceBufferAddress(VirtualMemoryAddress address, bool is_write);
 
 static void HandleWriteSyscall();
 static void HandlePutcSyscall();
 static void HandlePutsSyscall();
 static void ExecuteDebug();
 
-template<PGXPMode pgxp_mode, bool debug>
+template<PGXPMode pgxp_mode, bool debug, s32 decoded_op = -1, s32 decoded_funct = -1>
 static void ExecuteInstruction();
 
 template<PGXPMode pgxp_mode, bool debug>
@@ -98,6 +102,11 @@ static std::FILE* s_log_file = nullptr;
 static bool s_log_file_opened = false;
 static bool s_trace_to_log = false;
 
+// Only written by the CPU thread, and only read when it isn't executing, so it doesn't need any synchronization.
+static std::unique_ptr<TraceBufferEntry[]> s_trace_buffer;
+static u32 s_trace_buffer_position = 0;
+static bool s_trace_buffer_wrapped = false;
+
 static constexpr u32 INVALID_BREAKPOINT_PC = UINT32_C(0xFFFFFFFF);
 static std::array<std::vector<Breakpoint>, static_cast<u32>(BreakpointType::Count)> s_breakpoints;
 static u32 s_breakpoint_counter = 1;
@@ -135,6 +144,108 @@ void CPU::StopTrace()
     System::InterruptExecution();
 }
 
+bool CPU::IsTraceBufferEnabled()
+{
+  return static_cast<bool>(s_trace_buffer);
+}
+
+void CPU::SetTraceBufferEnabled(bool enabled)
+{
+  if (enabled == IsTraceBufferEnabled())
+    return;
+
+  if (enabled)
+    s_trace_buffer = std::make_unique<TraceBufferEntry[]>(TRACE_BUFFER_SIZE);
+  else
+    s_trace_buffer.reset();
+
+  s_trace_buffer_position = 0;
+  s_trace_buffer_wrapped = false;
+  if (UpdateDebugDispatcherFlag())
+    System::InterruptExecution();
+}
+
+ALWAYS_INLINE_RELEASE void CPU::AddTraceBufferEntry(u32 pc, u32 bits)
+{
+  TraceBufferEntry& entry = s_trace_buffer[s_trace_buffer_position];
+  entry.pc = pc;
+  entry.bits = bits;
+  entry.has_address = false;
+
+  s_trace_buffer_position = (s_trace_buffer_position + 1) % TRACE_BUFFER_SIZE;
+  s_trace_buffer_wrapped |= (s_trace_buffer_position == 0);
+}
+
+ALWAYS_INLINE_RELEASE void CPU::SetTraceBufferAddress(VirtualMemoryAddress address, bool is_write)
+{
+  // always follows the entry for the instruction doing the access
+  TraceBufferEntry& entry = s_trace_buffer[(s_trace_buffer_position + TRACE_BUFFER_SIZE - 1) % TRACE_BUFFER_SIZE];
+  entry.address = address;
+  entry.has_address = true;
+  entry.is_write = is_write;
+}
+
+std::vector<CPU::TraceBufferEntry> CPU::CopyTraceBuffer(u32 max_entries)
+{
+  std::vector<TraceBufferEntry> ret;
+  if (!s_trace_buffer)
+    return ret;
+
+  const u32 count = std::min(s_trace_buffer_wrapped ? TRACE_BUFFER_SIZE : s_trace_buffer_position, max_entries);
+  const u32 start = (s_trace_buffer_position + TRACE_BUFFER_SIZE - count) % TRACE_BUFFER_SIZE;
+  const u32 first_part = std::min(count, TRACE_BUFFER_SIZE - start);
+  ret.reserve(count);
+  ret.insert(ret.end(), &s_trace_buffer[start], &s_trace_buffer[start] + first_part);
+  ret.insert(ret.end(), &s_trace_buffer[0], &s_trace_buffer[0] + (count - first_part));
+  return ret;
+}
+
+bool CPU::DumpTraceBuffer(const char* path, Error* error)
+{
+  const std::vector<TraceBufferEntry> entries = CopyTraceBuffer();
+
+  auto fp = FileSystem::OpenManagedCFile(path, "wb", error);
+  if (!fp)
+    return false;
+
+  std::string out;
+  TinyString instr;
+  for (const TraceBufferEntry& entry : entries)
+  {
+    DisassembleInstruction(&instr, entry.pc, entry.bits);
+    if (entry.has_address)
+    {
+      fmt::format_to(std::back_inserter(out), "{:08x}: {:08x} {:<30} ; {} 0x{:08X}\n", entry.pc, entry.bits,
+                     instr.view(), entry.is_write ? "write" : "read", entry.address);
+    }
+    else
+    {
+      fmt::format_to(std::back_inserter(out), "{:08x}: {:08x} {}\n", entry.pc, entry.bits, instr.view());
+    }
+
+    // don't build the whole thing in memory, it's ~100MB for a full buffer
+    if (out.size() >= 1024 * 1024)
+    {
+      if (std::fwrite(out.data(), out.size(), 1, fp.get()) != 1)
+      {
+        Error::SetErrno(error, "fwrite() failed: ", errno);
+        return false;
+      }
+
+      out.clear();
+    }
+  }
+
+  if (!out.empty() && std::fwrite(out.data(), out.size(), 1, fp.get()) != 1)
+  {
+    Error::SetErrno(error, "fwrite() failed: ", errno);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote {} trace buffer entries to {}", entries.size(), path);
+  return true;
+}
+
 void CPU::WriteToExecutionLog(const char* format, ...)
 {
   if (!s_log_file_opened)
@@ -179,6 +290,7 @@ void CPU::Shutdown()
 {
   ClearBreakpoints();
   StopTrace();
+  SetTraceBufferEnabled(false);
 }
 
 void CPU::Reset()
@@ -939,10 +1051,10 @@ void CPU::DisassembleAndPrint(u32 addr, u32 instructions_before /* = 0 */, u32 i
   }
 }
 
-template<PGXPMode pgxp_mode, bool debug>
+template<PGXPMode pgxp_mode, bool debug, s32 decoded_op, s32 decoded_funct>
 ALWAYS_INLINE_RELEASE void CPU::ExecuteInstruction()
 {
-restart_instruction:
+[[maybe_unused]] restart_instruction:
   const Instruction inst = g_state.current_instruction;
 
 #if 0
@@ -962,11 +1074,12 @@ restart_instruction:
   if (inst.bits == 0)
     return;
 
-  switch (inst.op)
+  // When the opcode/function was decoded ahead of time, the switches fold down to a single case.
+  switch ((decoded_op >= 0) ? static_cast<InstructionOp>(decoded_op) : inst.op.GetValue())
   {
     case InstructionOp::funct:
     {
-      switch (inst.r.funct)
+      switch ((decoded_funct >= 0) ? static_cast<InstructionFunct>(decoded_funct) : inst.r.funct.GetValue())
       {
         case InstructionFunct::sll:
         {
@@ -1940,7 +2053,17 @@ restart_instruction:
         Log_ErrorPrintf("Stale icache at 0x%08X - ICache: %08X RAM: %08X", g_state.current_instruction_pc,
                         g_state.current_instruction.bits, ram_value);
         g_state.current_instruction.bits = ram_value;
-        goto restart_instruction;
+
+        // the pre-decoded opcode no longer applies
+        if constexpr (decoded_op >= 0)
+        {
+          ExecuteInstruction<pgxp_mode, debug>();
+          return;
+        }
+        else
+        {
+          goto restart_instruction;
+        }
       }
 
       RaiseException(Exception::RI);
@@ -1979,7 +2102,7 @@ bool CPU::UpdateDebugDispatcherFlag()
                                     dcic.execution_breakpoint_enable && IsCop0ExecutionBreakpointUnmasked();
 
   const bool use_debug_dispatcher =
-    has_any_breakpoints || has_cop0_breakpoints || s_trace_to_log ||
+    has_any_breakpoints || has_cop0_breakpoints || s_trace_to_log || s_trace_buffer ||
     (g_settings.cpu_execution_mode == CPUExecutionMode::Interpreter && g_settings.bios_tty_logging);
   if (use_debug_dispatcher == g_state.use_debug_dispatcher)
     return false;
@@ -2280,6 +2403,9 @@ ALWAYS_INLINE_RELEASE void CPU::MemoryBreakpointCheck(VirtualMemoryAddress addre
   const BreakpointType bptype = (type == MemoryAccessType::Read) ? BreakpointType::Read : BreakpointType::Write;
   if (CheckBreakpointList(bptype, address))
     s_break_after_instruction = true;
+
+  if (s_trace_buffer)
+    SetTraceBufferAddress(address, (type == MemoryAccessType::Write));
 }
 
 template<PGXPMode pgxp_mode, bool debug>
@@ -2317,6 +2443,8 @@ template<PGXPMode pgxp_mode, bool debug>
       {
         if (s_trace_to_log)
           LogInstruction(g_state.current_instruction.bits, g_state.current_instruction_pc, true);
+        if (s_trace_buffer)
+          AddTraceBufferEntry(g_state.current_instruction_pc, g_state.current_instruction.bits);
 
         if (g_state.current_instruction_pc == 0xA0) [[unlikely]]
           HandleA0Syscall();
@@ -2369,6 +2497,8 @@ void CPU::ExecuteDebug()
 
 void CPU::Execute()
 {
+  TRACE_ZONE("CPU::Execute");
+
   const CPUExecutionMode exec_mode = g_settings.cpu_execution_mode;
   const bool use_debug_dispatcher = g_state.use_debug_dispatcher;
   if (fastjmp_set(&s_jmp_buf) != 0)
@@ -2429,6 +2559,294 @@ void CPU::SetSingleStepFlag()
     System::InterruptExecution();
 }
 
+namespace CPU::CodeCache {
+namespace {
+struct FusableInstruction
+{
+  s32 op;
+  s32 funct;
+};
+} // namespace
+
+// Instructions which make up the superinstructions. Simple ALU ops, and the constant/address setup (LUI+ORI/ADDIU),
+// which is often followed by a load or store. Loads are usually followed by an ALU op in their delay slot, and branches
+// by an ALU op or a NOP (SLL zero) in theirs. The sets are kept small, since every combination is its own handler.
+static constexpr std::array<FusableInstruction, 8> s_fusable_alu_instructions = {{
+  {static_cast<s32>(InstructionOp::addiu), -1},
+  {static_cast<s32>(InstructionOp::lui), -1},
+  {static_cast<s32>(InstructionOp::ori), -1},
+  {static_cast<s32>(InstructionOp::andi), -1},
+  {static_cast<s32>(InstructionOp::funct), static_cast<s32>(InstructionFunct::sll)},
+  {static_cast<s32>(InstructionOp::funct), static_cast<s32>(InstructionFunct::srl)},
+  {static_cast<s32>(InstructionOp::funct), static_cast<s32>(InstructionFunct::addu)},
+  {static_cast<s32>(InstructionOp::funct), static_cast<s32>(InstructionFunct::or_)},
+}};
+static constexpr std::array<FusableInstruction, 8> s_fusable_memory_instructions = {{
+  {static_cast<s32>(InstructionOp::lb), -1},
+  {static_cast<s32>(InstructionOp::lh), -1},
+  {static_cast<s32>(InstructionOp::lw), -1},
+  {static_cast<s32>(InstructionOp::lbu), -1},
+  {static_cast<s32>(InstructionOp::lhu), -1},
+  {static_cast<s32>(InstructionOp::sb), -1},
+  {static_cast<s32>(InstructionOp::sh), -1},
+  {static_cast<s32>(InstructionOp::sw), -1},
+}};
+static constexpr std::array<FusableInstruction, 8> s_fusable_branch_instructions = {{
+  {static_cast<s32>(InstructionOp::b), -1},
+  {static_cast<s32>(InstructionOp::j), -1},
+  {static_cast<s32>(InstructionOp::jal), -1},
+  {static_cast<s32>(InstructionOp::beq), -1},
+  {static_cast<s32>(InstructionOp::bne), -1},
+  {static_cast<s32>(InstructionOp::blez), -1},
+  {static_cast<s32>(InstructionOp::bgtz), -1},
+  {static_cast<s32>(InstructionOp::funct), static_cast<s32>(InstructionFunct::jr)},
+}};
+
+// LUI, followed by ORI/ADDIU, for the constant/address triples.
+static constexpr std::array<FusableInstruction, 1> s_fusable_lui_instruction = {{
+  {static_cast<s32>(InstructionOp::lui), -1},
+}};
+static constexpr std::array<FusableInstruction, 2> s_fusable_lui_low_instructions = {{
+  {static_cast<s32>(InstructionOp::addiu), -1},
+  {static_cast<s32>(InstructionOp::ori), -1},
+}};
+
+template<PGXPMode pgxp_mode, s32 op, s32 funct>
+static u32 InterpretDecodedInstruction(const Instruction* inst);
+template<PGXPMode pgxp_mode, size_t... ops>
+static constexpr std::array<InterpreterHandler, sizeof...(ops)> MakeOpHandlers(std::index_sequence<ops...>);
+template<PGXPMode pgxp_mode, size_t... functs>
+static constexpr std::array<InterpreterHandler, sizeof...(functs)> MakeFunctHandlers(std::index_sequence<functs...>);
+
+static void AdvanceFusedInstruction(const Instruction inst, bool in_branch_delay_slot);
+template<PGXPMode pgxp_mode, s32 op0, s32 funct0, s32 op1, s32 funct1, s32 op2, s32 funct2>
+static u32 InterpretFusedInstructions(const Instruction* inst);
+template<PGXPMode pgxp_mode, const auto& first, const auto& second, size_t... i>
+static constexpr std::array<InterpreterHandler, sizeof...(i)> MakeFusedPairHandlers(std::index_sequence<i...>);
+template<PGXPMode pgxp_mode, const auto& first, const auto& second, const auto& third, size_t... i>
+static constexpr std::array<InterpreterHandler, sizeof...(i)> MakeFusedTripleHandlers(std::index_sequence<i...>);
+template<size_t count>
+static std::optional<u32> GetFusableInstructionIndex(const std::array<FusableInstruction, count>& list,
+                                                     const Instruction inst);
+} // namespace CPU::CodeCache
+
+template<PGXPMode pgxp_mode, s32 op, s32 funct>
+u32 CPU::CodeCache::InterpretDecodedInstruction(const Instruction* inst)
+{
+  ExecuteInstruction<pgxp_mode, false, op, funct>();
+  return 0;
+}
+
+template<PGXPMode pgxp_mode, size_t... ops>
+constexpr std::array<CPU::CodeCache::InterpreterHandler, sizeof...(ops)>
+CPU::CodeCache::MakeOpHandlers(std::index_sequence<ops...>)
+{
+  return {&InterpretDecodedInstruction<pgxp_mode, static_cast<s32>(ops), -1>...};
+}
+
+template<PGXPMode pgxp_mode, size_t... functs>
+constexpr std::array<CPU::CodeCache::InterpreterHandler, sizeof...(functs)>
+CPU::CodeCache::MakeFunctHandlers(std::index_sequence<functs...>)
+{
+  return {&InterpretDecodedInstruction<pgxp_mode, static_cast<s32>(InstructionOp::funct), static_cast<s32>(functs)>...};
+}
+
+template<PGXPMode pgxp_mode>
+CPU::CodeCache::InterpreterHandler CPU::CodeCache::GetInterpreterHandler(const Instruction inst)
+{
+  static constexpr std::array<InterpreterHandler, 64> op_handlers =
+    MakeOpHandlers<pgxp_mode>(std::make_index_sequence<64>());
+  static constexpr std::array<InterpreterHandler, 64> funct_handlers =
+    MakeFunctHandlers<pgxp_mode>(std::make_index_sequence<64>());
+
+  if (inst.bits == 0)
+    return [](const Instruction*) -> u32 { return 0; };
+  else if (inst.op == InstructionOp::funct)
+    return funct_handlers[static_cast<u8>(inst.r.funct.GetValue())];
+  else
+    return op_handlers[static_cast<u8>(inst.op.GetValue())];
+}
+
+template CPU::CodeCache::InterpreterHandler
+CPU::CodeCache::GetInterpreterHandler<PGXPMode::Disabled>(const Instruction inst);
+template CPU::CodeCache::InterpreterHandler CPU::CodeCache::GetInterpreterHandler<PGXPMode::Memory>(const Instruction inst);
+template CPU::CodeCache::InterpreterHandler CPU::CodeCache::GetInterpreterHandler<PGXPMode::CPU>(const Instruction inst);
+
+ALWAYS_INLINE_RELEASE void CPU::CodeCache::AdvanceFusedInstruction(const Instruction inst, bool in_branch_delay_slot)
+{
+  // same as InterpretCachedBlock() does between instructions
+  UpdateLoadDelay();
+
+  g_state.pending_ticks++;
+  g_state.current_instruction.bits = inst.bits;
+  g_state.current_instruction_pc = g_state.pc;
+  g_state.current_instruction_in_branch_delay_slot = in_branch_delay_slot;
+  g_state.current_instruction_was_branch_taken = g_state.branch_was_taken;
+  g_state.branch_was_taken = false;
+
+  g_state.pc = g_state.npc;
+  g_state.npc += 4;
+}
+
+template<PGXPMode pgxp_mode, s32 op0, s32 funct0, s32 op1, s32 funct1, s32 op2, s32 funct2>
+u32 CPU::CodeCache::InterpretFusedInstructions(const Instruction* inst)
+{
+  // Only the first instruction of a fused handler can be a branch, so the second is in its delay slot.
+  constexpr bool first_is_branch = (op0 == static_cast<s32>(InstructionOp::b) ||
+                                    (op0 >= static_cast<s32>(InstructionOp::j) &&
+                                     op0 <= static_cast<s32>(InstructionOp::bgtz)) ||
+                                    (op0 == static_cast<s32>(InstructionOp::funct) &&
+                                     funct0 == static_cast<s32>(InstructionFunct::jr)));
+
+  ExecuteInstruction<pgxp_mode, false, op0, funct0>();
+  if (g_state.exception_raised)
+    return 0;
+
+  AdvanceFusedInstruction(inst[1], first_is_branch);
+  ExecuteInstruction<pgxp_mode, false, op1, funct1>();
+  if constexpr (op2 < 0)
+  {
+    return 1;
+  }
+  else
+  {
+    if (g_state.exception_raised)
+      return 1;
+
+    AdvanceFusedInstruction(inst[2], false);
+    ExecuteInstruction<pgxp_mode, false, op2, funct2>();
+    return 2;
+  }
+}
+
+template<PGXPMode pgxp_mode, const auto& first, const auto& second, size_t... i>
+constexpr std::array<CPU::CodeCache::InterpreterHandler, sizeof...(i)>
+CPU::CodeCache::MakeFusedPairHandlers(std::index_sequence<i...>)
+{
+  constexpr size_t n = second.size();
+  return {&InterpretFusedInstructions<pgxp_mode, first[i / n].op, first[i / n].funct, second[i % n].op,
+                                      second[i % n].funct, -1, -1>...};
+}
+
+template<PGXPMode pgxp_mode, const auto& first, const auto& second, const auto& third, size_t... i>
+constexpr std::array<CPU::CodeCache::InterpreterHandler, sizeof...(i)>
+CPU::CodeCache::MakeFusedTripleHandlers(std::index_sequence<i...>)
+{
+  constexpr size_t n2 = second.size();
+  constexpr size_t n3 = third.size();
+  return {&InterpretFusedInstructions<pgxp_mode, first[i / (n2 * n3)].op, first[i / (n2 * n3)].funct,
+                                      second[(i / n3) % n2].op, second[(i / n3) % n2].funct, third[i % n3].op,
+                                      third[i % n3].funct>...};
+}
+
+template<size_t count>
+std::optional<u32> CPU::CodeCache::GetFusableInstructionIndex(const std::array<FusableInstruction, count>& list,
+                                                               const Instruction inst)
+{
+  const s32 op = static_cast<s32>(inst.op.GetValue());
+  const s32 funct = static_cast<s32>(inst.r.funct.GetValue());
+  for (u32 i = 0; i < count; i++)
+  {
+    if (list[i].op == op && (list[i].funct < 0 || list[i].funct == funct))
+      return i;
+  }
+
+  return std::nullopt;
+}
+
+template<PGXPMode pgxp_mode>
+u32 CPU::CodeCache::GetFusedInterpreterHandler(const Instruction* inst, const InstructionInfo* info, u32 count,
+                                               InterpreterHandler* out_handler)
+{
+  static constexpr size_t num_alu = s_fusable_alu_instructions.size();
+  static constexpr size_t num_memory = s_fusable_memory_instructions.size();
+  static constexpr size_t num_branch = s_fusable_branch_instructions.size();
+  static constexpr size_t num_lui_low = s_fusable_lui_low_instructions.size();
+
+  static constexpr std::array alu_alu_handlers =
+    MakeFusedPairHandlers<pgxp_mode, s_fusable_alu_instructions, s_fusable_alu_instructions>(
+      std::make_index_sequence<num_alu * num_alu>());
+  static constexpr std::array lui_memory_handlers =
+    MakeFusedPairHandlers<pgxp_mode, s_fusable_lui_instruction, s_fusable_memory_instructions>(
+      std::make_index_sequence<num_memory>());
+  static constexpr std::array memory_alu_handlers =
+    MakeFusedPairHandlers<pgxp_mode, s_fusable_memory_instructions, s_fusable_alu_instructions>(
+      std::make_index_sequence<num_memory * num_alu>());
+  static constexpr std::array branch_alu_handlers =
+    MakeFusedPairHandlers<pgxp_mode, s_fusable_branch_instructions, s_fusable_alu_instructions>(
+      std::make_index_sequence<num_branch * num_alu>());
+  static constexpr std::array lui_low_memory_handlers =
+    MakeFusedTripleHandlers<pgxp_mode, s_fusable_lui_instruction, s_fusable_lui_low_instructions,
+                            s_fusable_memory_instructions>(std::make_index_sequence<num_lui_low * num_memory>());
+
+  if (count < 2 || info[0].is_branch_delay_slot)
+    return 0;
+
+  // branches only fuse with their delay slot
+  if (const std::optional<u32> branch = GetFusableInstructionIndex(s_fusable_branch_instructions, inst[0]))
+  {
+    const std::optional<u32> slot = GetFusableInstructionIndex(s_fusable_alu_instructions, inst[1]);
+    if (!slot.has_value() || !info[1].is_branch_delay_slot)
+      return 0;
+
+    *out_handler = branch_alu_handlers[branch.value() * num_alu + slot.value()];
+    return 2;
+  }
+
+  // otherwise nothing after the first instruction can be in a delay slot, since it wouldn't be a branch
+  if (info[1].is_branch_delay_slot)
+    return 0;
+
+  if (const std::optional<u32> alu = GetFusableInstructionIndex(s_fusable_alu_instructions, inst[0]))
+  {
+    if (inst[0].op == InstructionOp::lui)
+    {
+      if (count >= 3 && !info[2].is_branch_delay_slot)
+      {
+        const std::optional<u32> low = GetFusableInstructionIndex(s_fusable_lui_low_instructions, inst[1]);
+        const std::optional<u32> memory = GetFusableInstructionIndex(s_fusable_memory_instructions, inst[2]);
+        if (low.has_value() && memory.has_value())
+        {
+          *out_handler = lui_low_memory_handlers[low.value() * num_memory + memory.value()];
+          return 3;
+        }
+      }
+
+      if (const std::optional<u32> memory = GetFusableInstructionIndex(s_fusable_memory_instructions, inst[1]))
+      {
+        *out_handler = lui_memory_handlers[memory.value()];
+        return 2;
+      }
+    }
+
+    if (const std::optional<u32> next = GetFusableInstructionIndex(s_fusable_alu_instructions, inst[1]))
+    {
+      *out_handler = alu_alu_handlers[alu.value() * num_alu + next.value()];
+      return 2;
+    }
+
+    return 0;
+  }
+
+  if (const std::optional<u32> memory = GetFusableInstructionIndex(s_fusable_memory_instructions, inst[0]))
+  {
+    if (const std::optional<u32> next = GetFusableInstructionIndex(s_fusable_alu_instructions, inst[1]))
+    {
+      *out_handler = memory_alu_handlers[memory.value() * num_alu + next.value()];
+      return 2;
+    }
+  }
+
+  return 0;
+}
+
+template u32 CPU::CodeCache::GetFusedInterpreterHandler<PGXPMode::Disabled>(const Instruction* inst,
+                                                                            const InstructionInfo* info, u32 count,
+                                                                            InterpreterHandler* out_handler);
+template u32 CPU::CodeCache::GetFusedInterpreterHandler<PGXPMode::Memory>(const Instruction* inst,
+                                                                          const InstructionInfo* info, u32 count,
+                                                                          InterpreterHandler* out_handler);
+
 template<PGXPMode pgxp_mode>
 void CPU::CodeCache::InterpretCachedBlock(const Block* block)
 {
@@ -2436,6 +2854,7 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
   DebugAssert(g_state.pc == block->pc);
   g_state.npc = block->pc + 4;
 
+  const InterpreterHandler* handler = block->InterpreterHandlers();
   const Instruction* instruction = block->Instructions();
   const Instruction* end_instruction = instruction + block->size;
   const CodeCache::InstructionInfo* info = block->InstructionsInfo();
@@ -2456,8 +2875,9 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
     g_state.pc = g_state.npc;
     g_state.npc += 4;
 
-    // execute the instruction we previously fetched
-    ExecuteInstruction<pgxp_mode, false>();
+    // execute the instruction we previously fetched, the opcode was already decoded when the block was created
+    // fused handlers execute the instructions after it too, and return how many
+    const u32 fused = (*handler)(instruction);
 
     // next load delay
     UpdateLoadDelay();
@@ -2465,8 +2885,9 @@ void CPU::CodeCache::InterpretCachedBlock(const Block* block)
     if (g_state.exception_raised)
       break;
 
-    instruction++;
-    info++;
+    handler += fused + 1;
+    instruction += fused + 1;
+    info += fused + 1;
   } while (instruction != end_instruction);
 
   // cleanup so the interpreter can kick in if needed
@@ -2653,29 +3074,27 @@ TickCount CPU::GetICacheFillTicks(VirtualMemoryAddress address)
   }
 }
 
-void CPU::CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks)
+void CPU::CheckAndUpdateICacheTags(u32 line_count, TickCount line_fill_ticks, TickCount uncached_ticks)
 {
-  VirtualMemoryAddress current_pc = g_state.pc & ICACHE_TAG_ADDRESS_MASK;
-  if (IsCachedAddress(current_pc))
+  VirtualMemoryAddress current_tag = GetICacheTagForAddress(g_state.pc);
+  if (!IsCachedAddress(current_tag))
   {
-    TickCount ticks = 0;
-    TickCount cached_ticks_per_line = GetICacheFillTicks(current_pc);
-    for (u32 i = 0; i < line_count; i++, current_pc += ICACHE_LINE_SIZE)
-    {
-      const u32 line = GetICacheLine(current_pc);
-      if (g_state.icache_tags[line] != current_pc)
-      {
-        g_state.icache_tags[line] = current_pc;
-        ticks += cached_ticks_per_line;
-      }
-    }
-
-    g_state.pending_ticks += ticks;
+    g_state.pending_ticks += uncached_ticks;
+    return;
   }
-  else
+
+  // Most entries hit every line, so count the misses instead of branching on each tag.
+  // Storing the tag unconditionally is harmless, it's the same value on a hit.
+  u32 line = GetICacheLine(current_tag);
+  u32 misses = 0;
+  for (u32 i = 0; i < line_count; i++, current_tag += ICACHE_LINE_SIZE)
   {
-    g_state.pending_ticks += uncached_ticks;
+    misses += static_cast<u32>(g_state.icache_tags[line] != current_tag);
+    g_state.icache_tags[line] = current_tag;
+    line = (line + 1) % ICACHE_LINES;
   }
+
+  g_state.pending_ticks += static_cast<TickCount>(misses) * line_fill_ticks;
 }
 
 u32 CPU::FillICache(VirtualMemoryAddress address)
@@ -2939,7 +3358,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           g_unprotected_ram[offset] = Truncate8(value);
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u8));
         }
       }
       else if constexpr (size == MemoryAccessSize::HalfWord)
@@ -2951,7 +3370,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           std::memcpy(&g_unprotected_ram[offset], &new_value, sizeof(u16));
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u16));
         }
       }
       else if constexpr (size == MemoryAccessSize::Word)
@@ -2962,7 +3381,7 @@ ALWAYS_INLINE bool CPU::DoSafeMemoryAccess(VirtualMemoryAddress address, u32& va
         {
           std::memcpy(&g_unprotected_ram[offset], &value, sizeof(u32));
           if (g_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u32));
         }
       }
     }
@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 
+class Error;
 class StateWrapper;
 
 namespace CPU {
@@ -194,6 +195,27 @@ bool IsTraceEnabled();
 void StartTrace();
 void StopTrace();
 
+// Trace buffer - keeps the most recently executed instructions in memory, instead of writing them to the log.
+struct TraceBufferEntry
+{
+  u32 pc;
+  u32 bits;
+  u32 address; // effective address of loads and stores
+  bool has_address;
+  bool is_write;
+};
+
+static constexpr u32 TRACE_BUFFER_SIZE = 1024 * 1024;
+
+bool IsTraceBufferEnabled();
+void SetTraceBufferEnabled(bool enabled);
+
+/// Returns up to max_entries of the most recent entries, oldest first. Only call on the CPU thread, or while paused.
+std::vector<TraceBufferEntry> CopyTraceBuffer(u32 max_entries = TRACE_BUFFER_SIZE);
+
+/// Writes the buffer to a text file, with disassembly.
+bool DumpTraceBuffer(const char* path, Error* error);
+
 // Breakpoint types - execute => breakpoint, read/write => watchpoints
 enum class BreakpointType : u8
 {
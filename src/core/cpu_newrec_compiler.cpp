@@ -302,6 +302,32 @@ u32 CPU::NewRec::Compiler::GetFlagsForNewLoadDelayedReg() const
   return g_settings.gpu_pgxp_enable ? (HR_MODE_WRITE | HR_CALLEE_SAVED) : (HR_MODE_WRITE);
 }
 
+CPU::NewRec::Compiler::HostRegAllocType CPU::NewRec::Compiler::GetTypeForNewLoadDelayedReg(Reg reg) const
+{
+  if (!EMULATE_LOAD_DELAYS)
+    return HR_TYPE_CPU_REG;
+
+  // The new value is only visible after the next instruction. If that's in this block and doesn't touch the
+  // register, nothing can tell the difference if we write it now. Delay slots are excluded, because the next
+  // instruction is the branch target, and memory exceptions could observe the register in the handler.
+  if (iinfo->is_last_instruction || iinfo->is_branch_delay_slot || m_load_delay_dirty ||
+      m_load_delay_register == reg || g_settings.cpu_recompiler_memory_exceptions ||
+      InstructionMayReadRegister(inst[1], reg))
+  {
+    return HR_TYPE_NEXT_LOAD_DELAY_VALUE;
+  }
+
+  Log_DebugPrintf("Skipping load delay to %s", GetRegName(reg));
+  return HR_TYPE_CPU_REG;
+}
+
+bool CPU::NewRec::Compiler::IsDeadWrite(Reg reg) const
+{
+  // pending loads to the register are cancelled by the write, so it has to go through
+  return (iinfo->IsDeadWrite(reg) && !m_load_delay_dirty && m_load_delay_register != reg &&
+          m_next_load_delay_register != reg);
+}
+
 void CPU::NewRec::Compiler::ClearConstantReg(Reg r)
 {
   DebugAssert(r < Reg::count && r != Reg::zero);
@@ -333,12 +359,38 @@ u32 CPU::NewRec::Compiler::GetConditionalBranchTarget(CompileFlags cf) const
   return current_pc + (inst->i.imm_sext32() << 2);
 }
 
+bool CPU::NewRec::Compiler::IsIdleLoopBackEdge(const std::optional<u32>& newpc) const
+{
+  return (newpc.has_value() && newpc.value() == m_block->pc && m_block->HasFlag(CodeCache::BlockFlags::IdleLoop));
+}
+
 u32 CPU::NewRec::Compiler::GetBranchReturnAddress(CompileFlags cf) const
 {
   // compiler pc has already been advanced when swapping branch delay slots
   return m_compiler_pc + (cf.delay_slot_swapped ? 0 : sizeof(Instruction));
 }
 
+bool CPU::NewRec::Compiler::IsSuperblockSideExit(CompileFlags cf) const
+{
+  // iinfo has already been advanced to the delay slot when swapping
+  const CodeCache::InstructionInfo* delay_slot_info = iinfo + (cf.delay_slot_swapped ? 0 : 1);
+  return (SUPPORTS_SUPERBLOCKS && m_block->HasFlag(CodeCache::BlockFlags::Superblock) &&
+          !delay_slot_info->is_last_instruction);
+}
+
+u32 CPU::NewRec::Compiler::GetFetchSegmentSize(const CodeCache::InstructionInfo* start) const
+{
+  // Segments run up to and including the next branch delay slot, which is only before the end in superblocks.
+  u32 size = 1;
+  for (const CodeCache::InstructionInfo* info = start; !info->is_branch_delay_slot && !info->is_last_instruction;
+       info++)
+  {
+    size++;
+  }
+
+  return size;
+}
+
 bool CPU::NewRec::Compiler::TrySwapDelaySlot(Reg rs, Reg rt, Reg rd)
 {
   if constexpr (!SWAP_BRANCH_DELAY_SLOTS)
@@ -1202,6 +1254,8 @@ void CPU::NewRec::Compiler::CompileInstruction()
     return;
   }
 
+  const bool is_branch_instruction = iinfo->is_branch_instruction;
+
   switch (inst->op)
   {
 #define PGXPFN(x) reinterpret_cast<const void*>(&PGXP::x)
@@ -1341,7 +1395,10 @@ void CPU::NewRec::Compiler::CompileInstruction()
   }
 
   ClearHostRegsNeeded();
-  UpdateLoadDelay();
+
+  // branches which continue in a superblock have already compiled the delay slot, and updated the load delay with it
+  if (!is_branch_instruction || m_block_ended)
+    UpdateLoadDelay();
 
 #if 0
   const void* end = GetCurrentCodePointer();
@@ -1402,6 +1459,15 @@ void CPU::NewRec::Compiler::CompileTemplate(void (Compiler::*const_func)(Compile
     return;
   }
 
+  // and instructions whose result is overwritten before anything reads it
+  if (!(tflags & (TF_NO_NOP | TF_LOAD_DELAY | TF_WRITES_LO | TF_WRITES_HI)) &&
+      (!g_settings.cpu_recompiler_memory_exceptions || !(tflags & TF_CAN_OVERFLOW)) &&
+      ((tflags & TF_WRITES_T && IsDeadWrite(rt)) || (tflags & TF_WRITES_D && IsDeadWrite(rd))))
+  {
+    Log_DebugPrintf("Skipping instruction because its result is dead");
+    return;
+  }
+
   // handle rename operations
   if ((tflags & TF_RENAME_WITH_ZERO_T && HasConstantRegValue(rt, 0)))
   {
@@ -1694,6 +1760,14 @@ void CPU::NewRec::Compiler::CompileLoadStoreTemplate(void (Compiler::*func)(Comp
     }
   }
 
+  // Scratchpad isn't mapped in fastmem, but it's cheap enough to check for inline instead of calling the handler.
+  if (!use_fastmem && spec_addr.has_value() && (spec_addr.value() & SCRATCHPAD_ADDR_MASK) == SCRATCHPAD_ADDR &&
+      !SpecIsCacheIsolated())
+  {
+    Log_DebugFmt("Inlining scratchpad access for {}{:08X}", cf.const_s ? "" : "speculative ", spec_addr.value());
+    cf.scratchpad = true;
+  }
+
   (this->*func)(cf, size, sign, use_fastmem, addr);
 
   if (store && !m_block_ended && !m_current_instruction_branch_delay_slot && spec_addr.has_value() &&
@@ -1753,11 +1827,22 @@ void CPU::NewRec::Compiler::CompileMoveRegTemplate(Reg dst, Reg src, bool pgxp_m
   if (g_settings.gpu_pgxp_enable && pgxp_move)
   {
     // might've been renamed, so use dst here
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
-                                 dst);
+    GeneratePGXPMove(dst, src);
   }
 }
 
+void CPU::NewRec::Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_MOVE_Packed), PGXP::PackMoveArgs(dst, src),
+                               dst);
+}
+
+void CPU::NewRec::Compiler::GeneratePGXPLui(Reg rt)
+{
+  DebugAssert(rt == inst->i.rt);
+  GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_LUI), inst->bits);
+}
+
 void CPU::NewRec::Compiler::Compile_j()
 {
   const u32 newpc = (m_compiler_pc & UINT32_C(0xF0000000)) | (inst->j.target << 2);
@@ -2158,7 +2243,7 @@ void CPU::NewRec::Compiler::Compile_lui()
   SetConstantReg(inst->i.rt, inst->i.imm_zext32() << 16);
 
   if (g_settings.UsingPGXPCPUMode())
-    GeneratePGXPCallWithMIPSRegs(reinterpret_cast<const void*>(&PGXP::CPU_LUI), inst->bits);
+    GeneratePGXPLui(inst->i.rt);
 }
 
 static constexpr const std::array<std::pair<u32*, u32>, 16> s_cop0_table = {
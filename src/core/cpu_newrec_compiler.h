@@ -18,18 +18,23 @@ static constexpr bool EMULATE_LOAD_DELAYS = true;
 static constexpr bool SWAP_BRANCH_DELAY_SLOTS = true;
 
 // Arch-specific options
+// SUPPORTS_SUPERBLOCKS is set for backends which emit side exits in Compile_bxx() and charge fetch ticks per segment.
 #if defined(CPU_ARCH_X64)
 static constexpr u32 NUM_HOST_REGS = 16;
 static constexpr bool HAS_MEMORY_OPERANDS = true;
+static constexpr bool SUPPORTS_SUPERBLOCKS = true;
 #elif defined(CPU_ARCH_ARM32)
 static constexpr u32 NUM_HOST_REGS = 16;
 static constexpr bool HAS_MEMORY_OPERANDS = false;
+static constexpr bool SUPPORTS_SUPERBLOCKS = false;
 #elif defined(CPU_ARCH_ARM64)
 static constexpr u32 NUM_HOST_REGS = 32;
 static constexpr bool HAS_MEMORY_OPERANDS = false;
+static constexpr bool SUPPORTS_SUPERBLOCKS = false;
 #elif defined(CPU_ARCH_RISCV64)
 static constexpr u32 NUM_HOST_REGS = 32;
 static constexpr bool HAS_MEMORY_OPERANDS = false;
+static constexpr bool SUPPORTS_SUPERBLOCKS = false;
 #endif
 
 // TODO: Get rid of the virtuals... somehow.
@@ -91,7 +96,8 @@ protected:
       u32 host_lo : 5; // LO host register
 
       u32 delay_slot_swapped : 1;
-      u32 pad1 : 2; // 28..31
+      u32 scratchpad : 1; // load/store address is likely to be in the scratchpad
+      u32 pad1 : 1;       // 29..31
 
       u32 host_hi : 5; // HI host register
 
@@ -197,6 +203,9 @@ protected:
   Reg MipsD() const;
   u32 GetConditionalBranchTarget(CompileFlags cf) const;
   u32 GetBranchReturnAddress(CompileFlags cf) const;
+  bool IsSuperblockSideExit(CompileFlags cf) const;
+  u32 GetFetchSegmentSize(const CodeCache::InstructionInfo* start) const;
+  bool IsIdleLoopBackEdge(const std::optional<u32>& newpc) const;
   bool TrySwapDelaySlot(Reg rs = Reg::zero, Reg rt = Reg::zero, Reg rd = Reg::zero);
   void SetCompilerPC(u32 newpc);
   void TruncateBlock();
@@ -257,6 +266,13 @@ protected:
   /// Uses a caller-saved register for load delays when PGXP is enabled.
   u32 GetFlagsForNewLoadDelayedReg() const;
 
+  /// Returns the allocation type for a load-delayed register. If the next instruction can't observe the old value,
+  /// the load delay is skipped and the guest register is written directly.
+  HostRegAllocType GetTypeForNewLoadDelayedReg(Reg reg) const;
+
+  /// Returns true if the current instruction's write to the register is never read, and can be skipped.
+  bool IsDeadWrite(Reg reg) const;
+
   void BackupHostState();
   void RestoreHostState();
 
@@ -278,6 +294,11 @@ protected:
   virtual void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                             Reg arg3reg = Reg::count) = 0;
 
+  /// PGXP bookkeeping for moves and LUI. Backends can override these to update the shadow registers inline, which
+  /// avoids flushing the register cache for a C call.
+  virtual void GeneratePGXPMove(Reg dst, Reg src);
+  virtual void GeneratePGXPLui(Reg rt);
+
   virtual void Compile_Fallback() = 0;
 
   void Compile_j();
@@ -370,6 +370,11 @@ void CPU::NewRec::AArch32Compiler::EndBlock(const std::optional<u32>& newpc, boo
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+
+  // polling loops fast-forward to the next event, registers need to be flushed for the address check
+  if (IsIdleLoopBackEdge(newpc))
+    GenerateCall(reinterpret_cast<const void*>(&CodeCache::SkipIdleLoop));
+
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
@@ -1557,7 +1562,7 @@ void CPU::NewRec::AArch32Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize
       return RRET;
 
     return Register(AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                                    EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, cf.MipsT()));
+                                    GetTypeForNewLoadDelayedReg(cf.MipsT()), cf.MipsT()));
   });
 
   if (g_settings.gpu_pgxp_enable)
@@ -2064,7 +2069,7 @@ void CPU::NewRec::AArch32Compiler::Compile_mfc2(CompileFlags cf)
   if (action == GTERegisterAccessAction::Direct)
   {
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     armAsm->ldr(Register(hreg), PTR(ptr));
   }
   else if (action == GTERegisterAccessAction::CallHandler)
@@ -2074,7 +2079,7 @@ void CPU::NewRec::AArch32Compiler::Compile_mfc2(CompileFlags cf)
     EmitCall(reinterpret_cast<const void*>(&GTE::ReadRegister));
 
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     armAsm->mov(Register(hreg), RRET);
   }
   else
@@ -206,6 +206,14 @@ vixl::aarch64::Operand CPU::NewRec::AArch64Compiler::armCheckLogicalConstant(u32
 
 void CPU::NewRec::AArch64Compiler::BeginBlock()
 {
+  if (CodeCache::IsBlockProfilingEnabled())
+  {
+    armMoveAddressToReg(armAsm, RXARG1, &m_block->execution_count);
+    armAsm->ldr(RWARG2, MemOperand(RXARG1));
+    armAsm->add(RWARG2, RWARG2, 1);
+    armAsm->str(RWARG2, MemOperand(RXARG1));
+  }
+
   Compiler::BeginBlock();
 }
 
@@ -342,6 +350,11 @@ void CPU::NewRec::AArch64Compiler::EndBlock(const std::optional<u32>& newpc, boo
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+
+  // polling loops fast-forward to the next event, registers need to be flushed for the address check
+  if (IsIdleLoopBackEdge(newpc))
+    GenerateCall(reinterpret_cast<const void*>(&CodeCache::SkipIdleLoop));
+
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
@@ -597,6 +610,43 @@ void CPU::NewRec::AArch64Compiler::GeneratePGXPCallWithMIPSRegs(const void* func
   EmitCall(func);
 }
 
+void CPU::NewRec::AArch64Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  // Same as PGXP::CPU_MOVE(), but without flushing everything for the call.
+  // flags = (src.value == value) ? src.flags : 0, then dst = src.
+  const u32 src_offset = OFFSETOF(State, pgxp_gpr) + static_cast<u32>(src) * sizeof(PGXP_value);
+  const u32 dst_offset = OFFSETOF(State, pgxp_gpr) + static_cast<u32>(dst) * sizeof(PGXP_value);
+  DebugAssert(Assembler::IsImmAddSub(src_offset) && Assembler::IsImmAddSub(dst_offset));
+  MoveMIPSRegToReg(RWARG1, dst);
+  armAsm->add(RXARG2, RSTATE, src_offset);
+  armAsm->add(RXARG3, RSTATE, dst_offset);
+  armAsm->ldr(RWSCRATCH, MemOperand(RXARG2, OFFSETOF(PGXP_value, value)));
+  armAsm->cmp(RWARG1, RWSCRATCH);
+  armAsm->ldr(RWSCRATCH, MemOperand(RXARG2, OFFSETOF(PGXP_value, flags)));
+  armAsm->csel(RWSCRATCH, RWSCRATCH, wzr, eq);
+  armAsm->str(RWSCRATCH, MemOperand(RXARG2, OFFSETOF(PGXP_value, flags)));
+  armAsm->str(RWSCRATCH, MemOperand(RXARG3, OFFSETOF(PGXP_value, flags)));
+
+  static_assert(OFFSETOF(PGXP_value, x) == 0 && OFFSETOF(PGXP_value, value) == 12);
+  armAsm->ldp(RXARG1, RXSCRATCH, MemOperand(RXARG2));
+  armAsm->stp(RXARG1, RXSCRATCH, MemOperand(RXARG3));
+}
+
+void CPU::NewRec::AArch64Compiler::GeneratePGXPLui(Reg rt)
+{
+  // Result is known at compile time, so just store it.
+  const PGXP_value value = PGXP::GetLUIValue(inst->bits);
+  const u32 offset = OFFSETOF(State, pgxp_gpr) + static_cast<u32>(rt) * sizeof(PGXP_value);
+  DebugAssert(Assembler::IsImmAddSub(offset) && value.x == 0.0f && value.z == 0.0f);
+  armAsm->add(RXARG1, RSTATE, offset);
+  EmitMov(RWARG2, std::bit_cast<u32>(value.y));
+  armAsm->stp(wzr, RWARG2, MemOperand(RXARG1, OFFSETOF(PGXP_value, x)));
+  EmitMov(RWARG2, value.value);
+  armAsm->stp(wzr, RWARG2, MemOperand(RXARG1, OFFSETOF(PGXP_value, z)));
+  EmitMov(RWARG2, value.flags);
+  armAsm->str(RWARG2, MemOperand(RXARG1, OFFSETOF(PGXP_value, flags)));
+}
+
 void CPU::NewRec::AArch64Compiler::Flush(u32 flags)
 {
   Compiler::Flush(flags);
@@ -1535,8 +1585,7 @@ void CPU::NewRec::AArch64Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize
       return RWRET;
 
     return WRegister(AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                                     EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG,
-                                     cf.MipsT()));
+                                     GetTypeForNewLoadDelayedReg(cf.MipsT()), cf.MipsT()));
   });
 
   if (g_settings.gpu_pgxp_enable)
@@ -2037,7 +2086,7 @@ void CPU::NewRec::AArch64Compiler::Compile_mfc2(CompileFlags cf)
   if (action == GTERegisterAccessAction::Direct)
   {
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     armAsm->ldr(WRegister(hreg), PTR(ptr));
   }
   else if (action == GTERegisterAccessAction::CallHandler)
@@ -2047,7 +2096,7 @@ void CPU::NewRec::AArch64Compiler::Compile_mfc2(CompileFlags cf)
     EmitCall(reinterpret_cast<const void*>(&GTE::ReadRegister));
 
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     armAsm->mov(WRegister(hreg), RWRET);
   }
   else
@@ -2132,13 +2181,118 @@ void CPU::NewRec::AArch64Compiler::Compile_cop2(CompileFlags cf)
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
-  Flush(FLUSH_FOR_C_CALL);
-  EmitMov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
-  EmitCall(reinterpret_cast<const void*>(func));
+  // simple commands which are executed a lot are emitted inline, to save flushing registers
+  const GTE::Instruction ginst{inst->bits};
+  if (ginst.command == 0x06 && !(g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling))
+  {
+    Compile_NCLIP();
+  }
+  else if (ginst.command == 0x2D || ginst.command == 0x2E)
+  {
+    Compile_AVSZ(ginst.command == 0x2E);
+  }
+  else
+  {
+    Flush(FLUSH_FOR_C_CALL);
+    EmitMov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
+    EmitCall(reinterpret_cast<const void*>(func));
+  }
 
   AddGTETicks(func_ticks);
 }
 
+void CPU::NewRec::AArch64Compiler::StoreGTEMAC0(const vixl::aarch64::XRegister& value,
+                                                const vixl::aarch64::XRegister& temp,
+                                                const vixl::aarch64::WRegister& flags)
+{
+  // MAC0 takes the low 32 bits, if the value doesn't fit, it's an overflow or underflow depending on sign.
+  Label done;
+  armAsm->str(value.W(), PTR(&g_state.gte_regs.MAC0));
+  armAsm->sxtw(temp, value.W());
+  EmitMov(flags, 0);
+  armAsm->cmp(temp, value);
+  armAsm->b(&done, eq);
+  EmitMov(flags, 0x80008000u);
+  EmitMov(WRegister(temp.GetCode()), 0x80010000u);
+  armAsm->cmp(value, 0);
+  armAsm->csel(flags, WRegister(temp.GetCode()), flags, gt);
+  armAsm->bind(&done);
+}
+
+void CPU::NewRec::AArch64Compiler::Compile_NCLIP()
+{
+  // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+  const XRegister acc = XRegister(AllocateTempHostReg());
+  const XRegister t0 = XRegister(AllocateTempHostReg());
+  const XRegister t1 = XRegister(AllocateTempHostReg());
+  const WRegister flags = WRegister(t1.GetCode());
+
+  static constexpr const std::array<std::array<u8, 2>, 6> terms = {
+    {{{0, 1}}, {{1, 2}}, {{2, 0}}, {{0, 2}}, {{1, 0}}, {{2, 1}}}};
+  for (u32 i = 0; i < terms.size(); i++)
+  {
+    const s16* x = &g_state.gte_regs.SXY0[0] + (terms[i][0] * 2);
+    const s16* y = &g_state.gte_regs.SXY0[1] + (terms[i][1] * 2);
+    armAsm->ldrsh(i == 0 ? acc : t0, PTR(x));
+    armAsm->ldrsh(t1, PTR(y));
+    if (i == 0)
+      armAsm->mul(acc, acc, t1);
+    else if (i < 3)
+      armAsm->madd(acc, t0, t1, acc);
+    else
+      armAsm->msub(acc, t0, t1, acc);
+  }
+
+  StoreGTEMAC0(acc, t0, flags);
+  armAsm->str(flags, PTR(&g_state.gte_regs.FLAG.bits));
+
+  FreeHostReg(t1.GetCode());
+  FreeHostReg(t0.GetCode());
+  FreeHostReg(acc.GetCode());
+}
+
+void CPU::NewRec::AArch64Compiler::Compile_AVSZ(bool avsz4)
+{
+  // MAC0 = ZSF3*(SZ1+SZ2+SZ3), or ZSF4*(SZ0+SZ1+SZ2+SZ3), OTZ = saturate(MAC0 >> 12)
+  const XRegister acc = XRegister(AllocateTempHostReg());
+  const XRegister t0 = XRegister(AllocateTempHostReg());
+  const XRegister t1 = XRegister(AllocateTempHostReg());
+  const WRegister flags = WRegister(t1.GetCode());
+
+  armAsm->ldrh(acc.W(), PTR(&g_state.gte_regs.SZ1));
+  armAsm->ldrh(t0.W(), PTR(&g_state.gte_regs.SZ2));
+  armAsm->add(acc.W(), acc.W(), t0.W());
+  armAsm->ldrh(t0.W(), PTR(&g_state.gte_regs.SZ3));
+  armAsm->add(acc.W(), acc.W(), t0.W());
+  if (avsz4)
+  {
+    armAsm->ldrh(t0.W(), PTR(&g_state.gte_regs.SZ0));
+    armAsm->add(acc.W(), acc.W(), t0.W());
+  }
+  armAsm->ldrsh(t0, PTR(avsz4 ? &g_state.gte_regs.ZSF4 : &g_state.gte_regs.ZSF3));
+  armAsm->mul(acc, acc, t0);
+
+  StoreGTEMAC0(acc, t0, flags);
+
+  // OTZ is saturated to 0..0xFFFF, which also flags an error
+  Label otz_in_range;
+  armAsm->asr(acc, acc, 12);
+  EmitMov(WRegister(t0.GetCode()), 0xFFFF);
+  armAsm->cmp(acc.W(), t0.W());
+  armAsm->b(&otz_in_range, ls);
+  armAsm->cmp(acc.W(), 0);
+  armAsm->csel(acc.W(), wzr, t0.W(), lt);
+  EmitMov(WRegister(t0.GetCode()), 0x80040000u);
+  armAsm->orr(flags, flags, t0.W());
+  armAsm->bind(&otz_in_range);
+  armAsm->str(acc.W(), PTR(&g_state.gte_regs.dr32[7]));
+  armAsm->str(flags, PTR(&g_state.gte_regs.FLAG.bits));
+
+  FreeHostReg(t1.GetCode());
+  FreeHostReg(t0.GetCode());
+  FreeHostReg(acc.GetCode());
+}
+
 u32 CPU::NewRec::CompileLoadStoreThunk(void* thunk_code, u32 thunk_space, void* code_address, u32 code_size,
                                        TickCount cycles_to_add, TickCount cycles_to_remove, u32 gpr_bitmask,
                                        u8 address_register, u8 data_register, MemoryAccessSize size, bool is_signed,
@@ -126,6 +126,8 @@ protected:
 
   void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                     Reg arg3reg = Reg::count) override;
+  void GeneratePGXPMove(Reg dst, Reg src) override;
+  void GeneratePGXPLui(Reg rt) override;
 
 private:
   void EmitMov(const vixl::aarch64::WRegister& dst, u32 val);
@@ -154,6 +156,11 @@ private:
   void MoveTToReg(const vixl::aarch64::WRegister& dst, CompileFlags cf);
   void MoveMIPSRegToReg(const vixl::aarch64::WRegister& dst, Reg reg);
 
+  void Compile_NCLIP();
+  void Compile_AVSZ(bool avsz4);
+  void StoreGTEMAC0(const vixl::aarch64::XRegister& value, const vixl::aarch64::XRegister& temp,
+                    const vixl::aarch64::WRegister& flags);
+
   vixl::aarch64::Assembler m_emitter;
   vixl::aarch64::Assembler m_far_emitter;
   vixl::aarch64::Assembler* armAsm;
@@ -40,6 +40,7 @@ static constexpr u32 STACK_SHADOW_SIZE = 0;
 
 using namespace Xbyak;
 
+using CPU::Recompiler::g_host_features;
 using CPU::Recompiler::IsCallerSavedRegister;
 
 // TODO: try using a pointer to state instead of rip-relative.. it might end up faster due to smaller code
@@ -109,6 +110,20 @@ void CPU::NewRec::X64Compiler::SwitchToNearCode(bool emit_jump, void (Xbyak::Cod
 
 void CPU::NewRec::X64Compiler::BeginBlock()
 {
+  if (m_block->HasFlag(CodeCache::BlockFlags::CountsExecutions))
+  {
+    // recompile as a superblock once it gets hot, before anything else so the ticks aren't added twice
+    cg->mov(RXARG1, static_cast<size_t>(reinterpret_cast<uintptr_t>(&m_block->hot_count)));
+    cg->sub(cg->dword[RXARG1], 1);
+    cg->jz(CodeCache::g_discard_and_recompile_block);
+  }
+
+  if (CodeCache::IsBlockProfilingEnabled())
+  {
+    cg->mov(RXARG1, static_cast<size_t>(reinterpret_cast<uintptr_t>(&m_block->execution_count)));
+    cg->inc(cg->dword[RXARG1]);
+  }
+
   Compiler::BeginBlock();
 
 #if 0
@@ -179,6 +194,13 @@ void CPU::NewRec::X64Compiler::GenerateBlockProtectCheck(const u8* ram_ptr, cons
 
 void CPU::NewRec::X64Compiler::GenerateICacheCheckAndUpdate()
 {
+  // superblocks only charge up to the first side exit here, the rest is charged as each exit falls through
+  if (m_block->HasFlag(CodeCache::BlockFlags::Superblock))
+  {
+    GenerateFetchTicks(m_block->pc, GetFetchSegmentSize(m_block->InstructionsInfo()));
+    return;
+  }
+
   if (GetSegmentForAddress(m_block->pc) >= Segment::KSEG1)
   {
     cg->add(cg->dword[PTR(&g_state.pending_ticks)], static_cast<u32>(m_block->uncached_fetch_ticks));
@@ -209,6 +231,44 @@ void CPU::NewRec::X64Compiler::GenerateICacheCheckAndUpdate()
   }
 }
 
+void CPU::NewRec::X64Compiler::GenerateFetchTicks(u32 start_pc, u32 count)
+{
+  if (GetSegmentForAddress(start_pc) >= Segment::KSEG1)
+  {
+    TickCount ticks = 0;
+    for (u32 i = 0; i < count; i++)
+      ticks += GetInstructionReadTicks(start_pc + i * sizeof(Instruction));
+    if (ticks > 0)
+      cg->add(cg->dword[PTR(&g_state.pending_ticks)], static_cast<u32>(ticks));
+    return;
+  }
+
+  if (!g_settings.cpu_recompiler_icache)
+    return;
+
+  cg->lea(RXARG1, cg->dword[PTR(&g_state.icache_tags)]);
+
+  const VirtualMemoryAddress end_pc = start_pc + (count - 1) * sizeof(Instruction);
+  for (VirtualMemoryAddress current_pc = start_pc & ICACHE_TAG_ADDRESS_MASK; current_pc <= end_pc;
+       current_pc += ICACHE_LINE_SIZE)
+  {
+    const VirtualMemoryAddress tag = GetICacheTagForAddress(current_pc);
+    const TickCount fill_ticks = GetICacheFillTicks(current_pc);
+    if (fill_ticks <= 0)
+      continue;
+
+    const u32 line = GetICacheLine(current_pc);
+    const u32 offset = (line * sizeof(u32));
+    Xbyak::Label cache_hit;
+
+    cg->cmp(cg->dword[RXARG1 + offset], tag);
+    cg->je(cache_hit);
+    cg->mov(cg->dword[RXARG1 + offset], tag);
+    cg->add(cg->dword[PTR(&g_state.pending_ticks)], static_cast<u32>(fill_ticks));
+    cg->L(cache_hit);
+  }
+}
+
 void CPU::NewRec::X64Compiler::GenerateCall(const void* func, s32 arg1reg /*= -1*/, s32 arg2reg /*= -1*/,
                                             s32 arg3reg /*= -1*/)
 {
@@ -232,6 +292,11 @@ void CPU::NewRec::X64Compiler::EndBlock(const std::optional<u32>& newpc, bool do
 
   // flush regs
   Flush(FLUSH_END_BLOCK);
+
+  // polling loops fast-forward to the next event, registers need to be flushed for the address check
+  if (IsIdleLoopBackEdge(newpc))
+    GenerateCall(reinterpret_cast<const void*>(&CodeCache::SkipIdleLoop));
+
   EndAndLinkBlock(newpc, do_event_test, false);
 }
 
@@ -525,6 +590,39 @@ void CPU::NewRec::X64Compiler::GeneratePGXPCallWithMIPSRegs(const void* func, u3
   cg->call(func);
 }
 
+void CPU::NewRec::X64Compiler::GeneratePGXPMove(Reg dst, Reg src)
+{
+  // Same as PGXP::CPU_MOVE(), but without flushing everything for the call.
+  // flags = (src.value == value) ? src.flags : 0, then dst = src.
+  const PGXP_value* src_ptr = &g_state.pgxp_gpr[static_cast<u8>(src)];
+  const PGXP_value* dst_ptr = &g_state.pgxp_gpr[static_cast<u8>(dst)];
+  MoveMIPSRegToReg(RWARG1, dst);
+  cg->mov(RWARG2, cg->dword[PTR(&src_ptr->flags)]);
+  cg->xor_(RWARG3, RWARG3);
+  cg->cmp(RWARG1, cg->dword[PTR(&src_ptr->value)]);
+  cg->cmovne(RWARG2, RWARG3);
+  cg->mov(cg->dword[PTR(&src_ptr->flags)], RWARG2);
+  cg->mov(cg->dword[PTR(&dst_ptr->flags)], RWARG2);
+
+  static_assert(OFFSETOF(PGXP_value, x) == 0 && OFFSETOF(PGXP_value, value) == 12);
+  cg->mov(RXARG2, cg->qword[PTR(&src_ptr->x)]);
+  cg->mov(RXARG3, cg->qword[PTR(&src_ptr->z)]);
+  cg->mov(cg->qword[PTR(&dst_ptr->x)], RXARG2);
+  cg->mov(cg->qword[PTR(&dst_ptr->z)], RXARG3);
+}
+
+void CPU::NewRec::X64Compiler::GeneratePGXPLui(Reg rt)
+{
+  // Result is known at compile time, so just store it.
+  const PGXP_value value = PGXP::GetLUIValue(inst->bits);
+  PGXP_value* ptr = &g_state.pgxp_gpr[static_cast<u8>(rt)];
+  cg->mov(cg->dword[PTR(&ptr->x)], std::bit_cast<u32>(value.x));
+  cg->mov(cg->dword[PTR(&ptr->y)], std::bit_cast<u32>(value.y));
+  cg->mov(cg->dword[PTR(&ptr->z)], std::bit_cast<u32>(value.z));
+  cg->mov(cg->dword[PTR(&ptr->value)], value.value);
+  cg->mov(cg->dword[PTR(&ptr->flags)], value.flags);
+}
+
 void CPU::NewRec::X64Compiler::Flush(u32 flags)
 {
   Compiler::Flush(flags);
@@ -689,6 +787,9 @@ void CPU::NewRec::X64Compiler::Compile_bxx(CompileFlags cf, BranchCondition cond
 
   // TODO: Swap this back to near once instructions don't blow up
   constexpr CodeGenerator::LabelType type = CodeGenerator::T_NEAR;
+
+  // Superblocks carry on with the not-taken path, so the condition is flipped to jump over the taken exit.
+  const bool side_exit = IsSuperblockSideExit(cf);
   Label taken;
   switch (cond)
   {
@@ -704,39 +805,66 @@ void CPU::NewRec::X64Compiler::Compile_bxx(CompileFlags cf, BranchCondition cond
       else
         cg->cmp(CFGetRegS(cf), MipsPtr(cf.MipsT()));
 
-      (cond == BranchCondition::Equal) ? cg->je(taken, type) : cg->jne(taken, type);
+      ((cond == BranchCondition::Equal) != side_exit) ? cg->je(taken, type) : cg->jne(taken, type);
     }
     break;
 
     case BranchCondition::GreaterThanZero:
     {
       cg->cmp(CFGetRegS(cf), 0);
-      cg->jg(taken, type);
+      side_exit ? cg->jle(taken, type) : cg->jg(taken, type);
     }
     break;
 
     case BranchCondition::GreaterEqualZero:
     {
       cg->test(CFGetRegS(cf), CFGetRegS(cf));
-      cg->jns(taken, type);
+      side_exit ? cg->js(taken, type) : cg->jns(taken, type);
     }
     break;
 
     case BranchCondition::LessThanZero:
     {
       cg->test(CFGetRegS(cf), CFGetRegS(cf));
-      cg->js(taken, type);
+      side_exit ? cg->jns(taken, type) : cg->js(taken, type);
     }
     break;
 
     case BranchCondition::LessEqualZero:
     {
       cg->cmp(CFGetRegS(cf), 0);
-      cg->jle(taken, type);
+      side_exit ? cg->jg(taken, type) : cg->jle(taken, type);
     }
     break;
   }
 
+  if (side_exit)
+  {
+    BackupHostState();
+    if (!cf.delay_slot_swapped)
+      CompileBranchDelaySlot();
+
+    EndBlock(taken_pc, true);
+
+    cg->L(taken);
+
+    RestoreHostState();
+    if (!cf.delay_slot_swapped)
+    {
+      CompileBranchDelaySlot();
+    }
+    else
+    {
+      // delay slot was compiled before the branch, just move past it
+      inst++;
+      m_current_instruction_pc += sizeof(Instruction);
+    }
+
+    // charge fetch for the next segment now that we know the exit wasn't taken
+    GenerateFetchTicks(m_current_instruction_pc + sizeof(Instruction), GetFetchSegmentSize(iinfo + 1));
+    return;
+  }
+
   BackupHostState();
   if (!cf.delay_slot_swapped)
     CompileBranchDelaySlot();
@@ -856,10 +984,37 @@ void CPU::NewRec::X64Compiler::Compile_sra(CompileFlags cf)
 
 void CPU::NewRec::X64Compiler::Compile_variable_shift(
   CompileFlags cf, void (Xbyak::CodeGenerator::*op)(const Xbyak::Operand&, const Xbyak::Reg8&),
-  void (Xbyak::CodeGenerator::*op_const)(const Xbyak::Operand&, int))
+  void (Xbyak::CodeGenerator::*op_const)(const Xbyak::Operand&, int),
+  void (Xbyak::CodeGenerator::*op_bmi2)(const Xbyak::Reg32e&, const Xbyak::Operand&, const Xbyak::Reg32e&))
 {
   const Reg32 rd = CFGetRegD(cf);
-  if (!cf.const_s)
+  if (!cf.const_s && g_host_features.bmi2)
+  {
+    // no need to go through ecx, or copy t to d, if they're already in host registers
+    const Reg32 rs = cf.valid_host_s ? CFGetRegS(cf) : cg->ecx;
+    if (!cf.valid_host_s)
+      MoveSToReg(rs, cf);
+
+    Reg32 rt = rd;
+    if (cf.valid_host_t)
+    {
+      rt = CFGetRegT(cf);
+    }
+    else if (rs == rd)
+    {
+      cg->mov(cg->ecx, rs);
+      MoveTToReg(rd, cf);
+      (cg->*op_bmi2)(rd, rd, cg->ecx);
+      return;
+    }
+    else
+    {
+      MoveTToReg(rd, cf);
+    }
+
+    (cg->*op_bmi2)(rd, rt, rs);
+  }
+  else if (!cf.const_s)
   {
     MoveSToReg(cg->ecx, cf);
     MoveTToReg(rd, cf);
@@ -874,17 +1029,17 @@ void CPU::NewRec::X64Compiler::Compile_variable_shift(
 
 void CPU::NewRec::X64Compiler::Compile_sllv(CompileFlags cf)
 {
-  Compile_variable_shift(cf, &CodeGenerator::shl, &CodeGenerator::shl);
+  Compile_variable_shift(cf, &CodeGenerator::shl, &CodeGenerator::shl, &CodeGenerator::shlx);
 }
 
 void CPU::NewRec::X64Compiler::Compile_srlv(CompileFlags cf)
 {
-  Compile_variable_shift(cf, &CodeGenerator::shr, &CodeGenerator::shr);
+  Compile_variable_shift(cf, &CodeGenerator::shr, &CodeGenerator::shr, &CodeGenerator::shrx);
 }
 
 void CPU::NewRec::X64Compiler::Compile_srav(CompileFlags cf)
 {
-  Compile_variable_shift(cf, &CodeGenerator::sar, &CodeGenerator::sar);
+  Compile_variable_shift(cf, &CodeGenerator::sar, &CodeGenerator::sar, &CodeGenerator::sarx);
 }
 
 void CPU::NewRec::X64Compiler::Compile_mult(CompileFlags cf, bool sign)
@@ -1253,9 +1408,24 @@ CPU::NewRec::X64Compiler::ComputeLoadStoreAddressArg(CompileFlags cf,
   return dst;
 }
 
+void CPU::NewRec::X64Compiler::GenerateScratchpadCheck(MemoryAccessSize size, Xbyak::Label& not_scratchpad)
+{
+  // Address is in RWARG1. Scratchpad is only mapped in KUSEG/KSEG0, and not when the cache is isolated.
+  // Misaligned accesses take the slow path, so the handler can raise the exception.
+  cg->test(cg->dword[PTR(&g_state.cop0_regs.sr.bits)], 1u << 16);
+  cg->jnz(not_scratchpad, CodeGenerator::T_NEAR);
+  cg->mov(RWARG3, RWARG1);
+  cg->and_(RWARG3, SCRATCHPAD_ADDR_MASK | ((1u << static_cast<u32>(size)) - 1));
+  cg->cmp(RWARG3, SCRATCHPAD_ADDR);
+  cg->jne(not_scratchpad, CodeGenerator::T_NEAR);
+  cg->mov(RWARG3, RWARG1);
+  cg->and_(RWARG3, SCRATCHPAD_OFFSET_MASK);
+}
+
 template<typename RegAllocFn>
 Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg, MemoryAccessSize size, bool sign,
-                                                    bool use_fastmem, const RegAllocFn& dst_reg_alloc)
+                                                    bool use_fastmem, bool check_scratchpad,
+                                                    const RegAllocFn& dst_reg_alloc)
 {
   if (use_fastmem)
   {
@@ -1311,6 +1481,26 @@ Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg
   if (addr_reg != RWARG1)
     cg->mov(RWARG1, addr_reg);
 
+  Label not_scratchpad, done;
+  if (check_scratchpad)
+  {
+    GenerateScratchpadCheck(size, not_scratchpad);
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+        cg->movzx(RWRET, cg->byte[PTR(g_state.scratchpad.data()) + RXARG3]);
+        break;
+      case MemoryAccessSize::HalfWord:
+        cg->movzx(RWRET, cg->word[PTR(g_state.scratchpad.data()) + RXARG3]);
+        break;
+      case MemoryAccessSize::Word:
+        cg->mov(RWRET, cg->dword[PTR(g_state.scratchpad.data()) + RXARG3]);
+        break;
+    }
+    cg->jmp(done, CodeGenerator::T_NEAR);
+    cg->L(not_scratchpad);
+  }
+
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
   switch (size)
   {
@@ -1361,6 +1551,9 @@ Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg
     RestoreHostState();
   }
 
+  if (check_scratchpad)
+    cg->L(done);
+
   const Xbyak::Reg32 dst_reg = dst_reg_alloc();
   switch (size)
   {
@@ -1386,7 +1579,7 @@ Xbyak::Reg32 CPU::NewRec::X64Compiler::GenerateLoad(const Xbyak::Reg32& addr_reg
 }
 
 void CPU::NewRec::X64Compiler::GenerateStore(const Xbyak::Reg32& addr_reg, const Xbyak::Reg32& value_reg,
-                                             MemoryAccessSize size, bool use_fastmem)
+                                             MemoryAccessSize size, bool use_fastmem, bool check_scratchpad)
 {
   if (use_fastmem)
   {
@@ -1432,6 +1625,26 @@ void CPU::NewRec::X64Compiler::GenerateStore(const Xbyak::Reg32& addr_reg, const
   if (value_reg != RWARG2)
     cg->mov(RWARG2, value_reg);
 
+  Label not_scratchpad, done;
+  if (check_scratchpad)
+  {
+    GenerateScratchpadCheck(size, not_scratchpad);
+    switch (size)
+    {
+      case MemoryAccessSize::Byte:
+        cg->mov(cg->byte[PTR(g_state.scratchpad.data()) + RXARG3], RWARG2.cvt8());
+        break;
+      case MemoryAccessSize::HalfWord:
+        cg->mov(cg->word[PTR(g_state.scratchpad.data()) + RXARG3], RWARG2.cvt16());
+        break;
+      case MemoryAccessSize::Word:
+        cg->mov(cg->dword[PTR(g_state.scratchpad.data()) + RXARG3], RWARG2);
+        break;
+    }
+    cg->jmp(done, CodeGenerator::T_NEAR);
+    cg->L(not_scratchpad);
+  }
+
   const bool checked = g_settings.cpu_recompiler_memory_exceptions;
   switch (size)
   {
@@ -1480,6 +1693,9 @@ void CPU::NewRec::X64Compiler::GenerateStore(const Xbyak::Reg32& addr_reg, const
     SwitchToNearCode(false);
     RestoreHostState();
   }
+
+  if (check_scratchpad)
+    cg->L(done);
 }
 
 void CPU::NewRec::X64Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -1491,12 +1707,12 @@ void CPU::NewRec::X64Compiler::Compile_lxx(CompileFlags cf, MemoryAccessSize siz
   FlushForLoadStore(address, false, use_fastmem);
   const Reg32 addr = ComputeLoadStoreAddressArg(cf, address, addr_reg);
 
-  const Reg32 data = GenerateLoad(addr, size, sign, use_fastmem, [this, cf]() {
+  const Reg32 data = GenerateLoad(addr, size, sign, use_fastmem, cf.scratchpad, [this, cf]() {
     if (cf.MipsT() == Reg::zero)
       return RWRET;
 
     return Reg32(AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                                 EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, cf.MipsT()));
+                                 GetTypeForNewLoadDelayedReg(cf.MipsT()), cf.MipsT()));
   });
 
   if (g_settings.gpu_pgxp_enable)
@@ -1529,7 +1745,7 @@ void CPU::NewRec::X64Compiler::Compile_lwx(CompileFlags cf, MemoryAccessSize siz
   ComputeLoadStoreAddressArg(cf, address, addr);
   cg->mov(RWARG1, addr);
   cg->and_(RWARG1, ~0x3u);
-  GenerateLoad(RWARG1, MemoryAccessSize::Word, false, use_fastmem, []() { return RWRET; });
+  GenerateLoad(RWARG1, MemoryAccessSize::Word, false, use_fastmem, false, []() { return RWRET; });
 
   if (inst->r.rt == Reg::zero)
   {
@@ -1623,11 +1839,12 @@ void CPU::NewRec::X64Compiler::Compile_lwc2(CompileFlags cf, MemoryAccessSize si
                                           std::optional<Reg32>();
   FlushForLoadStore(address, false, use_fastmem);
   const Reg32 addr = ComputeLoadStoreAddressArg(cf, address, addr_reg);
-  const Reg32 value = GenerateLoad(addr, MemoryAccessSize::Word, false, use_fastmem, [this, action = action]() {
-    return (action == GTERegisterAccessAction::CallHandler && g_settings.gpu_pgxp_enable) ?
-             Reg32(AllocateTempHostReg(HR_CALLEE_SAVED)) :
-             RWRET;
-  });
+  const Reg32 value =
+    GenerateLoad(addr, MemoryAccessSize::Word, false, use_fastmem, cf.scratchpad, [this, action = action]() {
+      return (action == GTERegisterAccessAction::CallHandler && g_settings.gpu_pgxp_enable) ?
+               Reg32(AllocateTempHostReg(HR_CALLEE_SAVED)) :
+               RWRET;
+    });
 
   switch (action)
   {
@@ -1711,7 +1928,7 @@ void CPU::NewRec::X64Compiler::Compile_sxx(CompileFlags cf, MemoryAccessSize siz
   if (!cf.valid_host_t)
     MoveTToReg(RWARG2, cf);
 
-  GenerateStore(addr, data, size, use_fastmem);
+  GenerateStore(addr, data, size, use_fastmem, cf.scratchpad);
 
   if (g_settings.gpu_pgxp_enable)
   {
@@ -1743,7 +1960,7 @@ void CPU::NewRec::X64Compiler::Compile_swx(CompileFlags cf, MemoryAccessSize siz
   ComputeLoadStoreAddressArg(cf, address, addr);
   cg->mov(RWARG1, addr);
   cg->and_(RWARG1, ~0x3u);
-  GenerateLoad(RWARG1, MemoryAccessSize::Word, false, use_fastmem, []() { return RWRET; });
+  GenerateLoad(RWARG1, MemoryAccessSize::Word, false, use_fastmem, false, []() { return RWRET; });
 
   DebugAssert(value != cg->ecx);
   cg->mov(cg->ecx, addr);
@@ -1787,12 +2004,12 @@ void CPU::NewRec::X64Compiler::Compile_swx(CompileFlags cf, MemoryAccessSize siz
 
   if (!g_settings.gpu_pgxp_enable)
   {
-    GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem);
+    GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem, false);
     FreeHostReg(addr.getIdx());
   }
   else
   {
-    GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem);
+    GenerateStore(addr, value, MemoryAccessSize::Word, use_fastmem, false);
 
     Flush(FLUSH_FOR_C_CALL);
     cg->mov(RWARG3, value);
@@ -1839,7 +2056,7 @@ void CPU::NewRec::X64Compiler::Compile_swc2(CompileFlags cf, MemoryAccessSize si
   {
     FlushForLoadStore(address, true, use_fastmem);
     const Reg32 addr = ComputeLoadStoreAddressArg(cf, address);
-    GenerateStore(addr, RWARG2, size, use_fastmem);
+    GenerateStore(addr, RWARG2, size, use_fastmem, cf.scratchpad);
     return;
   }
 
@@ -1849,7 +2066,7 @@ void CPU::NewRec::X64Compiler::Compile_swc2(CompileFlags cf, MemoryAccessSize si
   FlushForLoadStore(address, true, use_fastmem);
   ComputeLoadStoreAddressArg(cf, address, addr_reg);
   cg->mov(data_backup, RWARG2);
-  GenerateStore(addr_reg, RWARG2, size, use_fastmem);
+  GenerateStore(addr_reg, RWARG2, size, use_fastmem, cf.scratchpad);
 
   Flush(FLUSH_FOR_C_CALL);
   cg->mov(RWARG3, data_backup);
@@ -2020,7 +2237,7 @@ void CPU::NewRec::X64Compiler::Compile_mfc2(CompileFlags cf)
   if (action == GTERegisterAccessAction::Direct)
   {
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     cg->mov(Reg32(hreg), cg->dword[PTR(ptr)]);
   }
   else if (action == GTERegisterAccessAction::CallHandler)
@@ -2030,7 +2247,7 @@ void CPU::NewRec::X64Compiler::Compile_mfc2(CompileFlags cf)
     cg->call(&GTE::ReadRegister);
 
     hreg = AllocateHostReg(GetFlagsForNewLoadDelayedReg(),
-                           EMULATE_LOAD_DELAYS ? HR_TYPE_NEXT_LOAD_DELAY_VALUE : HR_TYPE_CPU_REG, rt);
+                           GetTypeForNewLoadDelayedReg(rt), rt);
     cg->mov(Reg32(hreg), RWRET);
   }
   else
@@ -2055,6 +2272,20 @@ void CPU::NewRec::X64Compiler::Compile_mtc2(CompileFlags cf)
   if (action == GTERegisterAccessAction::Ignore)
     return;
 
+  if (index == 30 && g_host_features.lzcnt)
+  {
+    // LZCS, done inline instead of flushing for the handler. LZCR counts the leading bits which match the sign bit,
+    // so flip negative values and count zeros.
+    MoveTToReg(RWARG1, cf);
+    cg->mov(cg->dword[PTR(&g_state.gte_regs.LZCS)], RWARG1);
+    cg->mov(RWARG2, RWARG1);
+    cg->sar(RWARG2, 31);
+    cg->xor_(RWARG1, RWARG2);
+    cg->lzcnt(RWARG1, RWARG1);
+    cg->mov(cg->dword[PTR(&g_state.gte_regs.LZCR)], RWARG1);
+    return;
+  }
+
   if (action == GTERegisterAccessAction::Direct)
   {
     if (cf.const_t)
@@ -2127,13 +2358,121 @@ void CPU::NewRec::X64Compiler::Compile_cop2(CompileFlags cf)
   TickCount func_ticks;
   GTE::InstructionImpl func = GTE::GetInstructionImpl(inst->bits, &func_ticks);
 
-  Flush(FLUSH_FOR_C_CALL);
-  cg->mov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
-  cg->call(reinterpret_cast<const void*>(func));
+  // simple commands which are executed a lot are emitted inline, to save flushing registers
+  const GTE::Instruction ginst{inst->bits};
+  if (ginst.command == 0x06 && !(g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling))
+  {
+    Compile_NCLIP();
+  }
+  else if (ginst.command == 0x2D || ginst.command == 0x2E)
+  {
+    Compile_AVSZ(ginst.command == 0x2E);
+  }
+  else
+  {
+    Flush(FLUSH_FOR_C_CALL);
+    cg->mov(RWARG1, inst->bits & GTE::Instruction::REQUIRED_BITS_MASK);
+    cg->call(reinterpret_cast<const void*>(func));
+  }
 
   AddGTETicks(func_ticks);
 }
 
+void CPU::NewRec::X64Compiler::StoreGTEMAC0(const Xbyak::Reg64& value, const Xbyak::Reg64& temp,
+                                            const Xbyak::Reg32& flags)
+{
+  // MAC0 takes the low 32 bits, if the value doesn't fit, it's an overflow or underflow depending on sign.
+  Xbyak::Label done;
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.MAC0)], value.cvt32());
+  cg->movsxd(temp, value.cvt32());
+  cg->xor_(flags, flags);
+  cg->cmp(temp, value);
+  cg->je(done);
+  cg->mov(flags, 0x80008000u);
+  cg->mov(temp.cvt32(), 0x80010000u);
+  cg->test(value, value);
+  cg->cmovg(flags, temp.cvt32());
+  cg->L(done);
+}
+
+void CPU::NewRec::X64Compiler::Compile_NCLIP()
+{
+  // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+  const Reg64 acc = Reg64(AllocateTempHostReg());
+  const Reg64 t0 = Reg64(AllocateTempHostReg());
+  const Reg64 t1 = Reg64(AllocateTempHostReg());
+
+  static constexpr const std::array<std::array<u8, 2>, 6> terms = {
+    {{{0, 1}}, {{1, 2}}, {{2, 0}}, {{0, 2}}, {{1, 0}}, {{2, 1}}}};
+  for (u32 i = 0; i < terms.size(); i++)
+  {
+    const s16* x = &g_state.gte_regs.SXY0[0] + (terms[i][0] * 2);
+    const s16* y = &g_state.gte_regs.SXY0[1] + (terms[i][1] * 2);
+    cg->movsx(i == 0 ? acc : t0, cg->word[PTR(x)]);
+    cg->movsx(t1, cg->word[PTR(y)]);
+    if (i == 0)
+    {
+      cg->imul(acc, t1);
+    }
+    else
+    {
+      cg->imul(t0, t1);
+      if (i < 3)
+        cg->add(acc, t0);
+      else
+        cg->sub(acc, t0);
+    }
+  }
+
+  StoreGTEMAC0(acc, t0, t1.cvt32());
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.FLAG.bits)], t1.cvt32());
+
+  FreeHostReg(t1.getIdx());
+  FreeHostReg(t0.getIdx());
+  FreeHostReg(acc.getIdx());
+}
+
+void CPU::NewRec::X64Compiler::Compile_AVSZ(bool avsz4)
+{
+  // MAC0 = ZSF3*(SZ1+SZ2+SZ3), or ZSF4*(SZ0+SZ1+SZ2+SZ3), OTZ = saturate(MAC0 >> 12)
+  const Reg64 acc = Reg64(AllocateTempHostReg());
+  const Reg64 t0 = Reg64(AllocateTempHostReg());
+  const Reg64 t1 = Reg64(AllocateTempHostReg());
+
+  cg->movzx(acc.cvt32(), cg->word[PTR(&g_state.gte_regs.SZ1)]);
+  cg->movzx(t0.cvt32(), cg->word[PTR(&g_state.gte_regs.SZ2)]);
+  cg->add(acc.cvt32(), t0.cvt32());
+  cg->movzx(t0.cvt32(), cg->word[PTR(&g_state.gte_regs.SZ3)]);
+  cg->add(acc.cvt32(), t0.cvt32());
+  if (avsz4)
+  {
+    cg->movzx(t0.cvt32(), cg->word[PTR(&g_state.gte_regs.SZ0)]);
+    cg->add(acc.cvt32(), t0.cvt32());
+  }
+  cg->movsx(t0, cg->word[PTR(avsz4 ? &g_state.gte_regs.ZSF4 : &g_state.gte_regs.ZSF3)]);
+  cg->imul(acc, t0);
+
+  StoreGTEMAC0(acc, t0, t1.cvt32());
+
+  // OTZ is saturated to 0..0xFFFF, which also flags an error
+  Xbyak::Label otz_in_range;
+  cg->sar(acc, 12);
+  cg->cmp(acc.cvt32(), 0xFFFF);
+  cg->jbe(otz_in_range);
+  cg->or_(t1.cvt32(), 0x80040000u);
+  cg->xor_(t0.cvt32(), t0.cvt32());
+  cg->test(acc.cvt32(), acc.cvt32());
+  cg->mov(acc.cvt32(), 0xFFFF);
+  cg->cmovs(acc.cvt32(), t0.cvt32());
+  cg->L(otz_in_range);
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.dr32[7])], acc.cvt32());
+  cg->mov(cg->dword[PTR(&g_state.gte_regs.FLAG.bits)], t1.cvt32());
+
+  FreeHostReg(t1.getIdx());
+  FreeHostReg(t0.getIdx());
+  FreeHostReg(acc.getIdx());
+}
+
 u32 CPU::NewRec::CompileLoadStoreThunk(void* thunk_code, u32 thunk_space, void* code_address, u32 code_size,
                                        TickCount cycles_to_add, TickCount cycles_to_remove, u32 gpr_bitmask,
                                        u8 address_register, u8 data_register, MemoryAccessSize size, bool is_signed,
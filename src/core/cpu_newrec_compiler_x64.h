@@ -31,6 +31,7 @@ protected:
   void BeginBlock() override;
   void GenerateBlockProtectCheck(const u8* ram_ptr, const u8* shadow_ptr, u32 size) override;
   void GenerateICacheCheckAndUpdate() override;
+  void GenerateFetchTicks(u32 start_pc, u32 count);
   void GenerateCall(const void* func, s32 arg1reg = -1, s32 arg2reg = -1, s32 arg3reg = -1) override;
   void EndBlock(const std::optional<u32>& newpc, bool do_event_test) override;
   void EndBlockWithException(Exception excode) override;
@@ -58,9 +59,10 @@ protected:
   void Compile_sll(CompileFlags cf) override;
   void Compile_srl(CompileFlags cf) override;
   void Compile_sra(CompileFlags cf) override;
-  void Compile_variable_shift(CompileFlags cf,
-                              void (Xbyak::CodeGenerator::*op)(const Xbyak::Operand&, const Xbyak::Reg8&),
-                              void (Xbyak::CodeGenerator::*op_const)(const Xbyak::Operand&, int));
+  void Compile_variable_shift(
+    CompileFlags cf, void (Xbyak::CodeGenerator::*op)(const Xbyak::Operand&, const Xbyak::Reg8&),
+    void (Xbyak::CodeGenerator::*op_const)(const Xbyak::Operand&, int),
+    void (Xbyak::CodeGenerator::*op_bmi2)(const Xbyak::Reg32e&, const Xbyak::Operand&, const Xbyak::Reg32e&));
   void Compile_sllv(CompileFlags cf) override;
   void Compile_srlv(CompileFlags cf) override;
   void Compile_srav(CompileFlags cf) override;
@@ -89,9 +91,10 @@ protected:
                                           const std::optional<const Xbyak::Reg32>& reg = std::nullopt);
   template<typename RegAllocFn>
   Xbyak::Reg32 GenerateLoad(const Xbyak::Reg32& addr_reg, MemoryAccessSize size, bool sign, bool use_fastmem,
-                            const RegAllocFn& dst_reg_alloc);
+                            bool check_scratchpad, const RegAllocFn& dst_reg_alloc);
   void GenerateStore(const Xbyak::Reg32& addr_reg, const Xbyak::Reg32& value_reg, MemoryAccessSize size,
-                     bool use_fastmem);
+                     bool use_fastmem, bool check_scratchpad);
+  void GenerateScratchpadCheck(MemoryAccessSize size, Xbyak::Label& not_scratchpad);
   void Compile_lxx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
                    const std::optional<VirtualMemoryAddress>& address) override;
   void Compile_lwx(CompileFlags cf, MemoryAccessSize size, bool sign, bool use_fastmem,
@@ -115,6 +118,8 @@ protected:
 
   void GeneratePGXPCallWithMIPSRegs(const void* func, u32 arg1val, Reg arg2reg = Reg::count,
                                     Reg arg3reg = Reg::count) override;
+  void GeneratePGXPMove(Reg dst, Reg src) override;
+  void GeneratePGXPLui(Reg rt) override;
 
 private:
   void SwitchToFarCode(bool emit_jump, void (Xbyak::CodeGenerator::*jump_op)(const void*) = nullptr);
@@ -134,6 +139,10 @@ private:
   void MoveTToReg(const Xbyak::Reg32& dst, CompileFlags cf);
   void MoveMIPSRegToReg(const Xbyak::Reg32& dst, Reg reg);
 
+  void Compile_NCLIP();
+  void Compile_AVSZ(bool avsz4);
+  void StoreGTEMAC0(const Xbyak::Reg64& value, const Xbyak::Reg64& temp, const Xbyak::Reg32& flags);
+
   std::unique_ptr<Xbyak::CodeGenerator> m_emitter;
   std::unique_ptr<Xbyak::CodeGenerator> m_far_emitter;
   Xbyak::CodeGenerator* cg;
@@ -6,11 +6,16 @@
 #include "cpu_core.h"
 #include "cpu_disasm.h"
 #include "settings.h"
+#include "system.h"
 
 #include "util/gpu_device.h"
 
+#include "common/align.h"
 #include "common/assert.h"
+#include "common/error.h"
 #include "common/log.h"
+#include "common/memmap.h"
+#include "common/memory_accounting.h"
 
 #include <climits>
 #include <cmath>
@@ -27,9 +32,10 @@ namespace {
 
 enum : u32
 {
-  VERTEX_CACHE_WIDTH = 0x800 * 2,
-  VERTEX_CACHE_HEIGHT = 0x800 * 2,
-  VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
+  VERTEX_CACHE_BITS = 14,
+  VERTEX_CACHE_SIZE = 1u << VERTEX_CACHE_BITS,
+  VERTEX_CACHE_MAX_PROBES = 8,
+  VERTEX_CACHE_MAX_AGE = 4, // in frames, enough for games running at 15fps
   PGXP_MEM_SIZE = (static_cast<u32>(Bus::RAM_8MB_SIZE) + static_cast<u32>(CPU::SCRATCHPAD_SIZE)) / 4,
   PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
 };
@@ -55,6 +61,12 @@ enum : u32
   VALID_ALL = (VALID_X | VALID_Y | VALID_Z),
 };
 
+struct VertexCacheEntry
+{
+  u32 frame;
+  PGXP_value vertex; // vertex.value is the key, empty if flags is zero
+};
+
 union psx_value
 {
   u32 d;
@@ -70,8 +82,10 @@ union psx_value
 };
 } // namespace
 
-static void CacheVertex(s16 sx, s16 sy, const PGXP_value& vertex);
-static PGXP_value* GetCachedVertex(short sx, short sy);
+static u32 GetVertexCacheSlot(u32 value);
+static bool IsVertexCacheEntryStale(const VertexCacheEntry& entry, u32 frame);
+static void CacheVertex(const PGXP_value& vertex);
+static const PGXP_value* GetCachedVertex(u32 value);
 
 static float TruncateVertexPosition(float p);
 static bool IsWithinTolerance(float precise_x, float precise_y, int int_x, int int_y);
@@ -124,8 +138,15 @@ static void LogValueStr(SmallStringBase& str, const char* name, u32 rval, const
 static constexpr PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, 0, 0};
 static constexpr PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, 0, VALID_XY};
 
+// Shadow memory is allocated from the OS, so pages which are never written to never take any physical memory, such as
+// RAM which only holds code.
+static constexpr size_t PGXP_MEM_ALLOCATION_SIZE =
+  Common::AlignUpPow2(sizeof(PGXP_value) * PGXP_MEM_SIZE, HOST_PAGE_SIZE);
+static constexpr size_t VERTEX_CACHE_ALLOCATION_SIZE =
+  Common::AlignUpPow2(sizeof(VertexCacheEntry) * VERTEX_CACHE_SIZE, HOST_PAGE_SIZE);
+
 static PGXP_value* s_mem = nullptr;
-static PGXP_value* s_vertex_cache = nullptr;
+static VertexCacheEntry* s_vertex_cache = nullptr;
 
 #ifdef LOG_VALUES
 static std::FILE* s_log;
@@ -140,23 +161,36 @@ void CPU::PGXP::Initialize()
 
   if (!s_mem)
   {
-    s_mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
+    Error error;
+    s_mem = static_cast<PGXP_value*>(MemMap::AllocateZeroedMemory(PGXP_MEM_ALLOCATION_SIZE, &error));
     if (!s_mem)
+    {
+      Log_ErrorFmt("Failed to allocate PGXP memory: {}", error.GetDescription());
       Panic("Failed to allocate PGXP memory");
+    }
   }
 
-  if (g_settings.gpu_pgxp_vertex_cache && !s_vertex_cache)
+  if (g_settings.gpu_pgxp_vertex_cache)
   {
-    s_vertex_cache = static_cast<PGXP_value*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(PGXP_value)));
     if (!s_vertex_cache)
     {
-      Log_ErrorPrint("Failed to allocate memory for vertex cache, disabling.");
-      g_settings.gpu_pgxp_vertex_cache = false;
+      Error error;
+      s_vertex_cache =
+        static_cast<VertexCacheEntry*>(MemMap::AllocateZeroedMemory(VERTEX_CACHE_ALLOCATION_SIZE, &error));
+      if (!s_vertex_cache)
+      {
+        Log_ErrorFmt("Failed to allocate memory for vertex cache, disabling: {}", error.GetDescription());
+        g_settings.gpu_pgxp_vertex_cache = false;
+      }
+    }
+    else
+    {
+      MemMap::DiscardMemory(s_vertex_cache, VERTEX_CACHE_ALLOCATION_SIZE);
     }
   }
 
-  if (s_vertex_cache)
-    std::memset(s_vertex_cache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::PGXP,
+                                 PGXP_MEM_ALLOCATION_SIZE + (s_vertex_cache ? VERTEX_CACHE_ALLOCATION_SIZE : 0));
 }
 
 void CPU::PGXP::Reset()
@@ -166,24 +200,25 @@ void CPU::PGXP::Reset()
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
 
   if (s_mem)
-    std::memset(s_mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
+    MemMap::DiscardMemory(s_mem, PGXP_MEM_ALLOCATION_SIZE);
 
   if (s_vertex_cache)
-    std::memset(s_vertex_cache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+    MemMap::DiscardMemory(s_vertex_cache, VERTEX_CACHE_ALLOCATION_SIZE);
 }
 
 void CPU::PGXP::Shutdown()
 {
   if (s_vertex_cache)
   {
-    std::free(s_vertex_cache);
+    MemMap::FreeZeroedMemory(s_vertex_cache, VERTEX_CACHE_ALLOCATION_SIZE);
     s_vertex_cache = nullptr;
   }
   if (s_mem)
   {
-    std::free(s_mem);
+    MemMap::FreeZeroedMemory(s_mem, PGXP_MEM_ALLOCATION_SIZE);
     s_mem = nullptr;
   }
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::PGXP, 0);
 
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
   std::memset(g_state.pgxp_gpr, 0, sizeof(g_state.pgxp_gpr));
@@ -474,7 +509,7 @@ void CPU::PGXP::GTE_PushSXYZ2f(float x, float y, float z, u32 v)
   SXY2.flags = VALID_ALL;
 
   if (g_settings.gpu_pgxp_vertex_cache)
-    CacheVertex(static_cast<s16>(Truncate16(v)), static_cast<s16>(Truncate16(v >> 16)), SXY2);
+    CacheVertex(SXY2);
 }
 
 #define VX(n) (psxRegs.CP2D.p[n << 1].sw.l)
@@ -583,21 +618,55 @@ void CPU::PGXP::CPU_SWC2(u32 instr, u32 addr, u32 rtVal)
   WriteMem(&g_state.pgxp_gte[idx], addr);
 }
 
-ALWAYS_INLINE_RELEASE void CPU::PGXP::CacheVertex(s16 sx, s16 sy, const PGXP_value& vertex)
+ALWAYS_INLINE_RELEASE u32 CPU::PGXP::GetVertexCacheSlot(u32 value)
 {
-  if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
+  // Fibonacci hashing, so neighbouring screen coordinates don't cluster.
+  return (value * 0x9E3779B1u) >> (32 - VERTEX_CACHE_BITS);
+}
+
+ALWAYS_INLINE_RELEASE bool CPU::PGXP::IsVertexCacheEntryStale(const VertexCacheEntry& entry, u32 frame)
+{
+  // Frame numbers restart on reset, which makes the difference wrap around, so older entries are stale as well.
+  return (entry.vertex.flags == 0 || (frame - entry.frame) >= VERTEX_CACHE_MAX_AGE);
+}
+
+ALWAYS_INLINE_RELEASE void CPU::PGXP::CacheVertex(const PGXP_value& vertex)
+{
+  // Replace the existing entry for this position, or the first stale one. If the whole probe sequence is in use, the
+  // home slot is overwritten, since newer vertices are more likely to be looked up.
+  const u32 frame = System::GetInternalFrameNumber();
+  const u32 home = GetVertexCacheSlot(vertex.value);
+  VertexCacheEntry* dest = nullptr;
+  for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
   {
-    // Write vertex into cache
-    s_vertex_cache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)] = vertex;
+    VertexCacheEntry& entry = s_vertex_cache[(home + i) & (VERTEX_CACHE_SIZE - 1)];
+    if (entry.vertex.value == vertex.value && entry.vertex.flags != 0)
+    {
+      dest = &entry;
+      break;
+    }
+    else if (!dest && IsVertexCacheEntryStale(entry, frame))
+    {
+      dest = &entry;
+    }
   }
+
+  if (!dest)
+    dest = &s_vertex_cache[home];
+
+  dest->frame = frame;
+  dest->vertex = vertex;
 }
 
-ALWAYS_INLINE_RELEASE CPU::PGXP_value* CPU::PGXP::GetCachedVertex(short sx, short sy)
+ALWAYS_INLINE_RELEASE const CPU::PGXP_value* CPU::PGXP::GetCachedVertex(u32 value)
 {
-  if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
+  const u32 frame = System::GetInternalFrameNumber();
+  const u32 home = GetVertexCacheSlot(value);
+  for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
   {
-    // Return pointer to cache entry
-    return &s_vertex_cache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)];
+    const VertexCacheEntry& entry = s_vertex_cache[(home + i) & (VERTEX_CACHE_SIZE - 1)];
+    if (entry.vertex.value == value && !IsVertexCacheEntryStale(entry, frame))
+      return &entry.vertex;
   }
 
   return nullptr;
@@ -646,11 +715,8 @@ bool CPU::PGXP::GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, i
 
   if (g_settings.gpu_pgxp_vertex_cache)
   {
-    const short psx_x = (short)(value & 0xFFFFu);
-    const short psx_y = (short)(value >> 16);
-
     // Look in cache for valid vertex
-    vert = GetCachedVertex(psx_x, psx_y);
+    vert = GetCachedVertex(value);
     if (vert && (vert->flags & VALID_XY) == VALID_XY)
     {
       *out_x = TruncateVertexPosition(vert->x) + static_cast<float>(xOffs);
@@ -925,10 +991,16 @@ void CPU::PGXP::CPU_LUI(u32 instr)
   LOG_VALUES_NV();
 
   // Rt = Imm << 16
-  g_state.pgxp_gpr[rt(instr)] = PGXP_value_zero;
-  g_state.pgxp_gpr[rt(instr)].y = (float)(s16)imm(instr);
-  g_state.pgxp_gpr[rt(instr)].value = static_cast<u32>(imm(instr)) << 16;
-  g_state.pgxp_gpr[rt(instr)].flags = VALID_XY;
+  g_state.pgxp_gpr[rt(instr)] = GetLUIValue(instr);
+}
+
+CPU::PGXP_value CPU::PGXP::GetLUIValue(u32 instr)
+{
+  PGXP_value ret = PGXP_value_zero;
+  ret.y = (float)(s16)imm(instr);
+  ret.value = static_cast<u32>(imm(instr)) << 16;
+  ret.flags = VALID_XY;
+  return ret;
 }
 
 ////////////////////////////////////
@@ -52,6 +52,7 @@ void CPU_SLTIU(u32 instr, u32 rsVal);
 
 // Load Upper
 void CPU_LUI(u32 instr);
+PGXP_value GetLUIValue(u32 instr); // for recompilers writing the result directly
 
 // Register Arithmetic
 void CPU_ADD(u32 instr, u32 rsVal, u32 rtVal);
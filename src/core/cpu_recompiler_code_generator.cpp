@@ -1177,6 +1177,12 @@ Value CodeGenerator::GetCurrentInstructionPC(u32 offset /* = 0 */)
   return Value::FromConstantU32(m_current_instruction.info->pc);
 }
 
+bool CodeGenerator::IsIdleLoopBackEdge(const Value& target) const
+{
+  return (target.IsConstant() && static_cast<u32>(target.constant_value) == m_block->pc &&
+          m_block->HasFlag(CodeCache::BlockFlags::IdleLoop));
+}
+
 void CodeGenerator::WriteNewPC(const Value& value, bool commit)
 {
   // TODO: This _could_ be moved into the register cache, but would it gain anything?
@@ -2448,6 +2454,10 @@ bool CodeGenerator::Compile_Branch(Instruction instruction, const CodeCache::Ins
           EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                                 &return_to_dispatcher);
 
+          // polling loops fast-forward to the next event, picked up by the downcount check on the next iteration
+          if (IsIdleLoopBackEdge(branch_target))
+            EmitFunctionCall(nullptr, &CodeCache::SkipIdleLoop);
+
           // we're committed at this point :D
           EmitEndBlock(true, nullptr);
 
@@ -2484,9 +2494,12 @@ bool CodeGenerator::Compile_Branch(Instruction instruction, const CodeCache::Ins
       EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                             &return_to_dispatcher);
 
+      const Value& jump_target = (condition != Condition::Always) ? constant_next_pc : branch_target;
+      if (IsIdleLoopBackEdge(jump_target))
+        EmitFunctionCall(nullptr, &CodeCache::SkipIdleLoop);
+
       EmitEndBlock(true, nullptr);
 
-      const Value& jump_target = (condition != Condition::Always) ? constant_next_pc : branch_target;
       DebugAssert(jump_target.IsConstant());
       if (static_cast<u32>(jump_target.constant_value) == m_block->pc)
       {
@@ -238,6 +238,7 @@ private:
 
   Value CalculatePC(u32 offset = 0);
   Value GetCurrentInstructionPC(u32 offset = 0);
+  bool IsIdleLoopBackEdge(const Value& target) const;
   void WriteNewPC(const Value& value, bool commit);
 
   Value DoGTERegisterRead(u32 index);
@@ -23,6 +23,17 @@ Log_SetChannel(Recompiler::CodeGenerator);
 #include "Zydis/Zydis.h"
 #endif
 
+#include "xbyak_util.h"
+
+static CPU::Recompiler::HostFeatures DetectHostFeatures()
+{
+  const Xbyak::util::Cpu cpu;
+  return CPU::Recompiler::HostFeatures{.bmi2 = cpu.has(Xbyak::util::Cpu::tBMI2),
+                                       .lzcnt = cpu.has(Xbyak::util::Cpu::tLZCNT)};
+}
+
+const CPU::Recompiler::HostFeatures CPU::Recompiler::g_host_features = DetectHostFeatures();
+
 bool CPU::Recompiler::IsCallerSavedRegister(u32 id)
 {
 #ifdef _WIN32
@@ -1187,7 +1198,17 @@ void CodeGenerator::EmitShl(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
-  // We have to use CL for the shift amount :(
+  // BMI2 can take the amount from any register, and doesn't need the source copied to the destination first.
+  if (!amount_value.IsConstant() && g_host_features.bmi2 && (size == RegSize_32 || size == RegSize_64))
+  {
+    if (size == RegSize_32)
+      m_emit->shlx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->shlx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
+  // Otherwise we have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
   if (save_cl)
@@ -1256,7 +1277,17 @@ void CodeGenerator::EmitShr(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
-  // We have to use CL for the shift amount :(
+  // BMI2 can take the amount from any register, and doesn't need the source copied to the destination first.
+  if (!amount_value.IsConstant() && g_host_features.bmi2 && (size == RegSize_32 || size == RegSize_64))
+  {
+    if (size == RegSize_32)
+      m_emit->shrx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->shrx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
+  // Otherwise we have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
   if (save_cl)
@@ -1325,7 +1356,17 @@ void CodeGenerator::EmitSar(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
-  // We have to use CL for the shift amount :(
+  // BMI2 can take the amount from any register, and doesn't need the source copied to the destination first.
+  if (!amount_value.IsConstant() && g_host_features.bmi2 && (size == RegSize_32 || size == RegSize_64))
+  {
+    if (size == RegSize_32)
+      m_emit->sarx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->sarx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
+  // Otherwise we have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
   if (save_cl)
@@ -63,6 +63,14 @@ static constexpr u32 FUNCTION_CALL_SHADOW_SPACE = 0;
 
 bool IsCallerSavedRegister(u32 id);
 
+/// Optional instruction set extensions, detected from the host CPU at startup.
+struct HostFeatures
+{
+  bool bmi2;  // SHLX/SHRX/SARX, shift by any register without overwriting the source
+  bool lzcnt; // LZCNT, which is defined for zero unlike BSR
+};
+extern const HostFeatures g_host_features;
+
 } // namespace CPU::Recompiler
 
 #elif defined(CPU_ARCH_ARM32)
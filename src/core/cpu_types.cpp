@@ -244,6 +244,24 @@ bool InstructionHasLoadDelay(const Instruction& instruction)
   }
 }
 
+bool InstructionMayReadRegister(const Instruction& instruction, Reg reg)
+{
+  if (reg == Reg::zero)
+    return false;
+
+  switch (instruction.op)
+  {
+    case InstructionOp::j:
+    case InstructionOp::jal:
+    case InstructionOp::lui:
+      return false;
+
+      // conservative, anything else with rs/rt fields is assumed to read them
+    default:
+      return (instruction.r.rs == reg || instruction.r.rt == reg);
+  }
+}
+
 bool IsExitBlockInstruction(const Instruction& instruction)
 {
   switch (instruction.op)
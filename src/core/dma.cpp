@@ -184,6 +184,13 @@ static bool TransferChannel();
 
 static bool IsLinkedListTerminator(PhysicalMemoryAddress address);
 static bool CheckForBusError(Channel channel, ChannelState& cs, PhysicalMemoryAddress address, u32 size);
+
+/// Returns true if a transfer covers one forward span of RAM, so devices can use it in place.
+static bool IsContiguousRAMTransfer(u32 address, u32 increment, u32 word_count);
+
+/// Stages transfers which wrap around the end of RAM, or go backwards, through s_transfer_buffer.
+static u32* ReadRAMToTransferBuffer(u32 address, u32 increment, u32 word_count);
+static void WriteRAMFromTransferBuffer(u32 address, u32 increment, u32 word_count);
 static void CompleteTransfer(Channel channel, ChannelState& cs);
 
 // from device -> memory
@@ -530,6 +537,69 @@ ALWAYS_INLINE_RELEASE bool DMA::CheckForBusError(Channel channel, ChannelState&
   return false;
 }
 
+ALWAYS_INLINE_RELEASE bool DMA::IsContiguousRAMTransfer(u32 address, u32 increment, u32 word_count)
+{
+  return (increment == sizeof(u32) && (address + (word_count * sizeof(u32))) <= (Bus::g_ram_mask + 1));
+}
+
+u32* DMA::ReadRAMToTransferBuffer(u32 address, u32 increment, u32 word_count)
+{
+  if (s_transfer_buffer.size() < word_count)
+    s_transfer_buffer.resize(word_count);
+
+  const u8* ram_pointer = Bus::g_ram;
+  const u32 mask = Bus::g_ram_mask;
+  u32* dst = s_transfer_buffer.data();
+  if (increment == sizeof(u32))
+  {
+    // Forwards, so it's only discontiguous at the wrap.
+    while (word_count > 0)
+    {
+      const u32 count = std::min(word_count, ((mask + 1) - address) / static_cast<u32>(sizeof(u32)));
+      std::memcpy(dst, &ram_pointer[address], count * sizeof(u32));
+      dst += count;
+      word_count -= count;
+      address = (address + (count * sizeof(u32))) & mask;
+    }
+  }
+  else
+  {
+    for (u32 i = 0; i < word_count; i++)
+    {
+      std::memcpy(&dst[i], &ram_pointer[address], sizeof(u32));
+      address = (address + increment) & mask;
+    }
+  }
+
+  return s_transfer_buffer.data();
+}
+
+void DMA::WriteRAMFromTransferBuffer(u32 address, u32 increment, u32 word_count)
+{
+  u8* ram_pointer = Bus::g_ram;
+  const u32 mask = Bus::g_ram_mask;
+  const u32* src = s_transfer_buffer.data();
+  if (increment == sizeof(u32))
+  {
+    while (word_count > 0)
+    {
+      const u32 count = std::min(word_count, ((mask + 1) - address) / static_cast<u32>(sizeof(u32)));
+      std::memcpy(&ram_pointer[address], src, count * sizeof(u32));
+      src += count;
+      word_count -= count;
+      address = (address + (count * sizeof(u32))) & mask;
+    }
+  }
+  else
+  {
+    for (u32 i = 0; i < word_count; i++)
+    {
+      std::memcpy(&ram_pointer[address], &src[i], sizeof(u32));
+      address = (address + increment) & mask;
+    }
+  }
+}
+
 ALWAYS_INLINE_RELEASE void DMA::CompleteTransfer(Channel channel, ChannelState& cs)
 {
   // start/busy bit is cleared on end of transfer
@@ -784,23 +854,12 @@ TickCount DMA::TransferMemoryToDevice(u32 address, u32 increment, u32 word_count
 
   address &= mask;
 
+  // Devices read straight from RAM, unless the transfer wraps around the end of it or goes backwards.
   const u32* src_pointer = reinterpret_cast<u32*>(Bus::g_ram + address);
   if constexpr (channel != Channel::GPU)
   {
-    if (static_cast<s32>(increment) < 0 || ((address + (increment * word_count)) & mask) <= address) [[unlikely]]
-    {
-      // Use temp buffer if it's wrapping around
-      if (s_transfer_buffer.size() < word_count)
-        s_transfer_buffer.resize(word_count);
-      src_pointer = s_transfer_buffer.data();
-
-      u8* ram_pointer = Bus::g_ram;
-      for (u32 i = 0; i < word_count; i++)
-      {
-        std::memcpy(&s_transfer_buffer[i], &ram_pointer[address], sizeof(u32));
-        address = (address + increment) & mask;
-      }
-    }
+    if (!IsContiguousRAMTransfer(address, increment, word_count)) [[unlikely]]
+      src_pointer = ReadRAMToTransferBuffer(address, increment, word_count);
   }
 
   switch (channel)
@@ -810,12 +869,20 @@ TickCount DMA::TransferMemoryToDevice(u32 address, u32 increment, u32 word_count
       if (g_gpu->BeginDMAWrite()) [[likely]]
       {
         u8* ram_pointer = Bus::g_ram;
-        for (u32 i = 0; i < word_count; i++)
+        if (IsContiguousRAMTransfer(address, increment, word_count)) [[likely]]
         {
-          u32 value;
-          std::memcpy(&value, &ram_pointer[address], sizeof(u32));
-          g_gpu->DMAWrite(address, value);
-          address = (address + increment) & mask;
+          // Linked list packets and forward block transfers are contiguous, so they can be pushed in one go.
+          g_gpu->DMAWriteRange(ram_pointer, address, word_count);
+        }
+        else
+        {
+          for (u32 i = 0; i < word_count; i++)
+          {
+            u32 value;
+            std::memcpy(&value, &ram_pointer[address], sizeof(u32));
+            g_gpu->DMAWrite(address, value);
+            address = (address + increment) & mask;
+          }
         }
         g_gpu->EndDMAWrite();
       }
@@ -870,10 +937,11 @@ TickCount DMA::TransferDeviceToMemory(u32 address, u32 increment, u32 word_count
     return Bus::GetDMARAMTickCount(word_count);
   }
 
+  // Devices write straight to RAM, unless the transfer wraps around the end of it or goes backwards.
   u32* dest_pointer = reinterpret_cast<u32*>(&Bus::g_ram[address]);
-  if (static_cast<s32>(increment) < 0 || ((address + (increment * word_count)) & mask) <= address) [[unlikely]]
+  const bool staged = !IsContiguousRAMTransfer(address, increment, word_count);
+  if (staged) [[unlikely]]
   {
-    // Use temp buffer if it's wrapping around
     if (s_transfer_buffer.size() < word_count)
       s_transfer_buffer.resize(word_count);
     dest_pointer = s_transfer_buffer.data();
@@ -904,15 +972,8 @@ TickCount DMA::TransferDeviceToMemory(u32 address, u32 increment, u32 word_count
       break;
   }
 
-  if (dest_pointer == s_transfer_buffer.data()) [[unlikely]]
-  {
-    u8* ram_pointer = Bus::g_ram;
-    for (u32 i = 0; i < word_count; i++)
-    {
-      std::memcpy(&ram_pointer[address], &s_transfer_buffer[i], sizeof(u32));
-      address = (address + increment) & mask;
-    }
-  }
+  if (staged) [[unlikely]]
+    WriteRAMFromTransferBuffer(address, increment, word_count);
 
   return Bus::GetDMARAMTickCount(word_count);
 }
@@ -3368,6 +3368,18 @@ void FullscreenUI::DrawConsoleSettingsPage()
     bsi, FSUI_ICONSTR(ICON_FA_DOWNLOAD, "Preload Images to RAM"),
     FSUI_CSTR("Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay."),
     "CDROM", "LoadImageToRAM", false);
+  DrawIntRangeSetting(bsi, FSUI_ICONSTR(ICON_FA_MEMORY, "Preload Memory Limit"),
+                      FSUI_CSTR("Images which would need more memory than this when preloaded are read from disk."),
+                      "CDROM", "PreloadMemoryLimit", Settings::DEFAULT_CDROM_PRELOAD_MEMORY_LIMIT, 64, 4096,
+                      FSUI_CSTR("%d MB"), GetEffectiveBoolSetting(bsi, "CDROM", "LoadImageToRAM", false));
+  DrawToggleSetting(
+    bsi, FSUI_ICONSTR(ICON_FA_HDD, "Cache Images Locally"),
+    FSUI_CSTR("Copies game images into the cache folder as they are read. Useful for images on network shares."),
+    "CDROM", "LocalCache", false);
+  DrawIntRangeSetting(bsi, FSUI_ICONSTR(ICON_FA_HDD, "Local Cache Size"),
+                      FSUI_CSTR("The least recently played images are removed when the cache grows beyond this size."),
+                      "CDROM", "LocalCacheSize", Settings::DEFAULT_CDROM_LOCAL_CACHE_SIZE, 1024, 262144,
+                      FSUI_CSTR("%d MB"), GetEffectiveBoolSetting(bsi, "CDROM", "LocalCache", false));
   DrawToggleSetting(
     bsi, FSUI_ICONSTR(ICON_FA_VEST_PATCHES, "Apply Image Patches"),
     FSUI_CSTR("Automatically applies patches to disc images when they are present, currently only PPF is supported."),
@@ -3461,6 +3473,23 @@ void FullscreenUI::DrawEmulationSettingsPage()
     FSUI_CSTR("Specifies the amount of buffer time added, which reduces the additional sleep time introduced."),
     "Display", "PreFrameSleepBuffer", Settings::DEFAULT_DISPLAY_PRE_FRAME_SLEEP_BUFFER, 0.0f, 20.0f, "%.1f", 1.0f,
     pre_frame_sleep_active);
+  DrawToggleSetting(
+    bsi, FSUI_ICONSTR(ICON_FA_GAMEPAD, "Late Input Polling"),
+    FSUI_CSTR("Polls controllers again when the game reads them, instead of only at the start of each frame."), "Main",
+    "LateInputPolling", false);
+  DrawToggleSetting(
+    bsi, FSUI_ICONSTR(ICON_FA_FORWARD, "Adaptive Frame Skip"),
+    FSUI_CSTR("Skips displaying frames when the host can't keep up with the target speed."), "Display",
+    "AdaptiveFrameSkip", false);
+  DrawToggleSetting(
+    bsi, FSUI_ICONSTR(ICON_FA_SYNC, "Reuse Unchanged Frames"),
+    FSUI_CSTR("Reuses the previous frame when the image is unchanged, instead of post-processing it again."),
+    "Display", "SkipUnchangedFrames", false);
+  DrawToggleSetting(
+    bsi, FSUI_ICONSTR(ICON_FA_PAUSE, "Skip Presenting Unchanged Frames"),
+    FSUI_CSTR("Stops presenting while the image is unchanged, the variable refresh display keeps the last image."),
+    "Display", "SkipUnchangedPresents", false,
+    optimal_frame_pacing_active && GetEffectiveBoolSetting(bsi, "Display", "SkipUnchangedFrames", false));
 
   MenuHeading(FSUI_CSTR("Runahead/Rewind"));
 
@@ -4259,6 +4288,10 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, FSUI_CSTR("Threaded Presentation"),
                         FSUI_CSTR("Presents frames on a background thread when fast forwarding or vsync is disabled."),
                         "GPU", "ThreadedPresentation", true);
+      DrawToggleSetting(bsi, FSUI_CSTR("Non-Blocking Presentation"),
+                        FSUI_CSTR("Drops frames instead of waiting for the previous frame to be displayed."), "GPU",
+                        "NonBlockingPresentation", false,
+                        GetEffectiveBoolSetting(bsi, "GPU", "ThreadedPresentation", true));
     }
     break;
 #endif
@@ -4268,6 +4301,13 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, FSUI_CSTR("Threaded Rendering"),
                         FSUI_CSTR("Uses a second thread for drawing graphics. Speed boost, and safe to use."), "GPU",
                         "UseThread", true);
+      DrawIntRangeSetting(bsi, FSUI_CSTR("Software Rasterizer Threads"),
+                          FSUI_CSTR("Draws bands of the screen in parallel. Set to the number of free CPU cores."),
+                          "GPU", "SoftwareRasterizerThreads", Settings::DEFAULT_GPU_SW_RASTERIZER_THREADS, 1,
+                          Settings::MAX_GPU_SW_RASTERIZER_THREADS, FSUI_CSTR("%d threads"));
+      DrawToggleSetting(bsi, FSUI_CSTR("Recompile Software Rasterizer"),
+                        FSUI_CSTR("Generates machine code for each drawing state. Results are identical."), "GPU",
+                        "SoftwareRasterizerJIT", false);
     }
     break;
 
@@ -4282,6 +4322,15 @@ void FullscreenUI::DrawDisplaySettingsPage()
       FSUI_CSTR("Runs the software renderer in parallel for VRAM readbacks. On some systems, this may result "
                 "in greater performance."),
       "GPU", "UseSoftwareRendererForReadbacks", false);
+    DrawToggleSetting(bsi, FSUI_CSTR("Batch Mixed Texture Modes"),
+                      FSUI_CSTR("Draws primitives with different texture modes together, reducing draw calls."), "GPU",
+                      "BatchMixedTextureModes", false);
+    DrawToggleSetting(bsi, FSUI_CSTR("Deferred Pipeline Compilation"),
+                      FSUI_CSTR("Starts games faster by building most pipelines during gameplay."), "GPU",
+                      "DeferPipelineCompilation", false);
+    DrawToggleSetting(bsi, FSUI_CSTR("Cache Filtered Textures"),
+                      FSUI_CSTR("Filters palette texture pages once instead of in every draw, when using xBR or JINC2."),
+                      "GPU", "TextureFilterCache", false);
   }
 
   MenuHeading(FSUI_CSTR("Rendering"));
@@ -4291,6 +4340,15 @@ void FullscreenUI::DrawDisplaySettingsPage()
     FSUI_CSTR("Scales internal VRAM resolution by the specified multiplier. Some games require 1x VRAM resolution."),
     "GPU", "ResolutionScale", 1, resolution_scales.data(), resolution_scales.size(), true, 0, is_hardware);
 
+  const bool dynamic_resolution = GetEffectiveBoolSetting(bsi, "GPU", "DynamicResolution", false);
+  DrawToggleSetting(bsi, FSUI_CSTR("Dynamic Resolution"),
+                    FSUI_CSTR("Lowers the internal resolution when the GPU can't keep up, up to the resolution above."),
+                    "GPU", "DynamicResolution", false, is_hardware);
+  DrawIntRangeSetting(bsi, FSUI_CSTR("Minimum Dynamic Resolution"),
+                      FSUI_CSTR("Lowest internal resolution which dynamic resolution will use."), "GPU",
+                      "DynamicResolutionMinScale", 1, 1, GPU::MAX_RESOLUTION_SCALE, "%dx",
+                      is_hardware && dynamic_resolution);
+
   DrawEnumSetting(
     bsi, FSUI_CSTR("Texture Filtering"), FSUI_CSTR("Smooths out the blockiness of magnified textures on 3D objects."),
     "GPU", "TextureFilter", Settings::DEFAULT_GPU_TEXTURE_FILTER, &Settings::ParseTextureFilterName,
@@ -4385,6 +4443,17 @@ void FullscreenUI::DrawDisplaySettingsPage()
   DrawIntRangeSetting(bsi, FSUI_CSTR("Screenshot Quality"),
                       FSUI_CSTR("Selects the quality at which screenshots will be compressed."), "Display",
                       "ScreenshotQuality", Settings::DEFAULT_DISPLAY_SCREENSHOT_QUALITY, 1, 100, "%d%%");
+  DrawEnumSetting(bsi, FSUI_CSTR("Video Capture Encoder"),
+                  FSUI_CSTR("Selects the FFmpeg encoder used for video captures."), "MediaCapture", "Encoder",
+                  Settings::DEFAULT_MEDIA_CAPTURE_ENCODER, &MediaCapture::ParseEncoderName,
+                  &MediaCapture::GetEncoderName, &MediaCapture::GetEncoderDisplayName, MediaCaptureEncoder::Count);
+  DrawIntSpinBoxSetting(bsi, FSUI_CSTR("Video Capture Bitrate"),
+                        FSUI_CSTR("Sets the bitrate which video captures are encoded at."), "MediaCapture",
+                        "VideoBitrate", Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE, 100, 100000, 500,
+                        FSUI_CSTR("%d kbps"));
+  DrawToggleSetting(bsi, FSUI_CSTR("Capture at Internal Resolution"),
+                    FSUI_CSTR("Captures video at the internal resolution, instead of the window size."),
+                    "MediaCapture", "InternalResolution", false);
 
   MenuHeading(FSUI_CSTR("Enhancements"));
   DrawToggleSetting(
@@ -4447,6 +4516,11 @@ void FullscreenUI::DrawDisplaySettingsPage()
   DrawToggleSetting(bsi, FSUI_CSTR("Preload Replacement Textures"),
                     FSUI_CSTR("Loads all replacement texture to RAM, reducing stuttering at runtime."),
                     "TextureReplacements", "PreloadTextures", false);
+  DrawIntRangeSetting(bsi, FSUI_CSTR("Replacement Cache Size"),
+                      FSUI_CSTR("Maximum memory used by loaded replacements. The least recently used are unloaded when "
+                                "it is exceeded. Ignored when preloading."),
+                      "TextureReplacements", "MaxCacheSizeMB", Settings::DEFAULT_TEXTURE_REPLACEMENT_CACHE_SIZE_MB,
+                      16, 16384, FSUI_CSTR("%d MB"));
 
   EndMenuButtons();
 }
@@ -5046,6 +5120,10 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                     FSUI_CSTR("Logs messages to the debug console where supported."), "Logging", "LogToDebug", false);
   DrawToggleSetting(bsi, FSUI_CSTR("Log To File"), FSUI_CSTR("Logs messages to duckstation.log in the user directory."),
                     "Logging", "LogToFile", false);
+  DrawToggleSetting(bsi, FSUI_CSTR("Asynchronous Logging"),
+                    FSUI_CSTR("Writes messages to the outputs from a separate thread, so logging doesn't slow down "
+                              "emulation. The last messages can be lost if the application crashes."),
+                    "Logging", "LogAsync", false);
 
   MenuHeading(FSUI_CSTR("Debugging Settings"));
 
@@ -5059,6 +5137,13 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                     "IncreaseTimerResolution", true);
 #endif
 
+  DrawEnumSetting(
+    bsi, FSUI_CSTR("Thread Placement"),
+    FSUI_CSTR("Keeps emulation and rendering threads on performance cores, on CPUs with mixed core types."), "Main",
+    "ThreadPlacement", Settings::DEFAULT_THREAD_PLACEMENT, &Settings::ParseThreadPlacementPolicy,
+    &Settings::GetThreadPlacementPolicyName, &Settings::GetThreadPlacementPolicyDisplayName,
+    Threading::ThreadPlacementPolicy::Count);
+
   DrawToggleSetting(bsi, FSUI_CSTR("Allow Booting Without SBI File"),
                     FSUI_CSTR("Allows loading protected games without subchannel information."), "CDROM",
                     "AllowBootingWithoutSBIFile", false);
@@ -5091,6 +5176,9 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                   "WireframeMode", GPUWireframeMode::Disabled, &Settings::ParseGPUWireframeMode,
                   &Settings::GetGPUWireframeModeName, &Settings::GetGPUWireframeModeDisplayName,
                   GPUWireframeMode::Count);
+  DrawToggleSetting(bsi, FSUI_CSTR("Use Sparse VRAM"),
+                    FSUI_CSTR("Only allocates GPU memory for the parts of VRAM which are used. Requires Vulkan."),
+                    "GPU", "SparseVRAM", false);
 
   MenuHeading(FSUI_CSTR("PGXP Settings"));
 
@@ -5130,6 +5218,19 @@ void FullscreenUI::DrawAdvancedSettingsPage()
     bsi, FSUI_CSTR("Enable Recompiler Block Linking"),
     FSUI_CSTR("Performance enhancement - jumps directly between blocks instead of returning to the dispatcher."), "CPU",
     "RecompilerBlockLinking", true);
+  DrawToggleSetting(bsi, FSUI_CSTR("Enable Recompiler Persistent Block Cache"),
+                    FSUI_CSTR("Remembers compiled blocks between sessions, and compiles them ahead of time."), "CPU",
+                    "RecompilerPersistentCache", false);
+  DrawToggleSetting(
+    bsi, FSUI_CSTR("Defer Recompiler Block Compilation"),
+    FSUI_CSTR("Limits how much code is compiled each frame, interpreting it until the next frame. Reduces stutter."),
+    "CPU", "RecompilerDeferCompilation", false);
+  DrawToggleSetting(bsi, FSUI_CSTR("Enable Recompiler Superblocks"),
+                    FSUI_CSTR("Recompiles frequently run code through conditional branches, reducing block exits."),
+                    "CPU", "RecompilerSuperblocks", false);
+  DrawToggleSetting(bsi, FSUI_CSTR("Skip Idle Loops"),
+                    FSUI_CSTR("Fast-forwards loops which wait for an interrupt or memory flag. Reduces CPU usage."),
+                    "CPU", "IdleLoopSkipping", false);
   DrawEnumSetting(bsi, FSUI_CSTR("Recompiler Fast Memory Access"),
                   FSUI_CSTR("Avoids calls to C++ code, significantly speeding up the recompiler."), "CPU",
                   "FastmemMode", Settings::DEFAULT_CPU_FASTMEM_MODE, &Settings::ParseCPUFastmemMode,
@@ -7087,8 +7188,11 @@ bool FullscreenUI::IsLeaderboardsWindowOpen()
 // TRANSLATION-STRING-AREA-BEGIN
 TRANSLATE_NOOP("FullscreenUI", "%.2f Seconds");
 TRANSLATE_NOOP("FullscreenUI", "%d Frames");
+TRANSLATE_NOOP("FullscreenUI", "%d MB");
+TRANSLATE_NOOP("FullscreenUI", "%d kbps");
 TRANSLATE_NOOP("FullscreenUI", "%d ms");
 TRANSLATE_NOOP("FullscreenUI", "%d sectors");
+TRANSLATE_NOOP("FullscreenUI", "%d threads");
 TRANSLATE_NOOP("FullscreenUI", "-");
 TRANSLATE_NOOP("FullscreenUI", "1 Frame");
 TRANSLATE_NOOP("FullscreenUI", "10 Frames");
@@ -7161,6 +7265,7 @@ TRANSLATE_NOOP("FullscreenUI", "Achievement Notifications");
 TRANSLATE_NOOP("FullscreenUI", "Achievements");
 TRANSLATE_NOOP("FullscreenUI", "Achievements Settings");
 TRANSLATE_NOOP("FullscreenUI", "Achievements are not enabled.");
+TRANSLATE_NOOP("FullscreenUI", "Adaptive Frame Skip");
 TRANSLATE_NOOP("FullscreenUI", "Add Search Directory");
 TRANSLATE_NOOP("FullscreenUI", "Add Shader");
 TRANSLATE_NOOP("FullscreenUI", "Adds a new directory to the game search list.");
@@ -7201,13 +7306,18 @@ TRANSLATE_NOOP("FullscreenUI", "BIOS to use when emulating {} consoles.");
 TRANSLATE_NOOP("FullscreenUI", "Back");
 TRANSLATE_NOOP("FullscreenUI", "Back To Pause Menu");
 TRANSLATE_NOOP("FullscreenUI", "Backend Settings");
+TRANSLATE_NOOP("FullscreenUI", "Batch Mixed Texture Modes");
 TRANSLATE_NOOP("FullscreenUI", "Behavior");
 TRANSLATE_NOOP("FullscreenUI", "Borderless Fullscreen");
 TRANSLATE_NOOP("FullscreenUI", "Buffer Size");
 TRANSLATE_NOOP("FullscreenUI", "CD-ROM Emulation");
 TRANSLATE_NOOP("FullscreenUI", "CPU Emulation");
 TRANSLATE_NOOP("FullscreenUI", "CPU Mode");
+TRANSLATE_NOOP("FullscreenUI", "Cache Filtered Textures");
+TRANSLATE_NOOP("FullscreenUI", "Cache Images Locally");
 TRANSLATE_NOOP("FullscreenUI", "Cancel");
+TRANSLATE_NOOP("FullscreenUI", "Capture at Internal Resolution");
+TRANSLATE_NOOP("FullscreenUI", "Captures video at the internal resolution, instead of the window size.");
 TRANSLATE_NOOP("FullscreenUI", "Change Disc");
 TRANSLATE_NOOP("FullscreenUI", "Change Page");
 TRANSLATE_NOOP("FullscreenUI", "Change Selection");
@@ -7246,6 +7356,7 @@ TRANSLATE_NOOP("FullscreenUI", "Controller settings reset to default.");
 TRANSLATE_NOOP("FullscreenUI", "Controls");
 TRANSLATE_NOOP("FullscreenUI", "Controls the volume of the audio played on the host when fast forwarding.");
 TRANSLATE_NOOP("FullscreenUI", "Controls the volume of the audio played on the host.");
+TRANSLATE_NOOP("FullscreenUI", "Copies game images into the cache folder as they are read. Useful for images on network shares.");
 TRANSLATE_NOOP("FullscreenUI", "Copies the current global settings to this game.");
 TRANSLATE_NOOP("FullscreenUI", "Copies the global controller configuration to this game.");
 TRANSLATE_NOOP("FullscreenUI", "Copy Global Settings");
@@ -7265,6 +7376,8 @@ TRANSLATE_NOOP("FullscreenUI", "Default Boot");
 TRANSLATE_NOOP("FullscreenUI", "Default View");
 TRANSLATE_NOOP("FullscreenUI", "Default: Disabled");
 TRANSLATE_NOOP("FullscreenUI", "Default: Enabled");
+TRANSLATE_NOOP("FullscreenUI", "Defer Recompiler Block Compilation");
+TRANSLATE_NOOP("FullscreenUI", "Deferred Pipeline Compilation");
 TRANSLATE_NOOP("FullscreenUI", "Deinterlacing Mode");
 TRANSLATE_NOOP("FullscreenUI", "Delete Save");
 TRANSLATE_NOOP("FullscreenUI", "Delete State");
@@ -7306,9 +7419,13 @@ TRANSLATE_NOOP("FullscreenUI", "Downloads covers from a user-specified URL templ
 TRANSLATE_NOOP("FullscreenUI", "Downsamples the rendered image prior to displaying it. Can improve overall image quality in mixed 2D/3D games.");
 TRANSLATE_NOOP("FullscreenUI", "Downsampling");
 TRANSLATE_NOOP("FullscreenUI", "Downsampling Display Scale");
+TRANSLATE_NOOP("FullscreenUI", "Draws bands of the screen in parallel. Set to the number of free CPU cores.");
+TRANSLATE_NOOP("FullscreenUI", "Draws primitives with different texture modes together, reducing draw calls.");
+TRANSLATE_NOOP("FullscreenUI", "Drops frames instead of waiting for the previous frame to be displayed.");
 TRANSLATE_NOOP("FullscreenUI", "Duck icon by icons8 (https://icons8.com/icon/74847/platforms.undefined.short-title)");
 TRANSLATE_NOOP("FullscreenUI", "DuckStation is a free and open-source simulator/emulator of the Sony PlayStation(TM) console, focusing on playability, speed, and long-term maintainability.");
 TRANSLATE_NOOP("FullscreenUI", "Dump Replaceable VRAM Writes");
+TRANSLATE_NOOP("FullscreenUI", "Dynamic Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Emulation Settings");
 TRANSLATE_NOOP("FullscreenUI", "Emulation Speed");
 TRANSLATE_NOOP("FullscreenUI", "Enable 8MB RAM");
@@ -7323,6 +7440,8 @@ TRANSLATE_NOOP("FullscreenUI", "Enable Post Processing");
 TRANSLATE_NOOP("FullscreenUI", "Enable Recompiler Block Linking");
 TRANSLATE_NOOP("FullscreenUI", "Enable Recompiler ICache");
 TRANSLATE_NOOP("FullscreenUI", "Enable Recompiler Memory Exceptions");
+TRANSLATE_NOOP("FullscreenUI", "Enable Recompiler Persistent Block Cache");
+TRANSLATE_NOOP("FullscreenUI", "Enable Recompiler Superblocks");
 TRANSLATE_NOOP("FullscreenUI", "Enable Region Check");
 TRANSLATE_NOOP("FullscreenUI", "Enable Rewinding");
 TRANSLATE_NOOP("FullscreenUI", "Enable SDL Input Source");
@@ -7358,9 +7477,11 @@ TRANSLATE_NOOP("FullscreenUI", "Failed to save input profile '{}'.");
 TRANSLATE_NOOP("FullscreenUI", "Fast Boot");
 TRANSLATE_NOOP("FullscreenUI", "Fast Forward Speed");
 TRANSLATE_NOOP("FullscreenUI", "Fast Forward Volume");
+TRANSLATE_NOOP("FullscreenUI", "Fast-forwards loops which wait for an interrupt or memory flag. Reduces CPU usage.");
 TRANSLATE_NOOP("FullscreenUI", "File Size");
 TRANSLATE_NOOP("FullscreenUI", "File Size: %.2f MB");
 TRANSLATE_NOOP("FullscreenUI", "File Title");
+TRANSLATE_NOOP("FullscreenUI", "Filters palette texture pages once instead of in every draw, when using xBR or JINC2.");
 TRANSLATE_NOOP("FullscreenUI", "Force 4:3 For 24-Bit Display");
 TRANSLATE_NOOP("FullscreenUI", "Force NTSC Timings");
 TRANSLATE_NOOP("FullscreenUI", "Forces PAL games to run at NTSC timings, i.e. 60hz. Some PAL games will run at their \"normal\" speeds, while others will break.");
@@ -7388,6 +7509,7 @@ TRANSLATE_NOOP("FullscreenUI", "Game settings initialized with global settings f
 TRANSLATE_NOOP("FullscreenUI", "Game title copied to clipboard.");
 TRANSLATE_NOOP("FullscreenUI", "Game type copied to clipboard.");
 TRANSLATE_NOOP("FullscreenUI", "Game: {} ({})");
+TRANSLATE_NOOP("FullscreenUI", "Generates machine code for each drawing state. Results are identical.");
 TRANSLATE_NOOP("FullscreenUI", "Genre: %s");
 TRANSLATE_NOOP("FullscreenUI", "GitHub Repository");
 TRANSLATE_NOOP("FullscreenUI", "Global Slot {0} - {1}##global_slot_{0}");
@@ -7402,6 +7524,7 @@ TRANSLATE_NOOP("FullscreenUI", "How many saves will be kept for rewinding. Highe
 TRANSLATE_NOOP("FullscreenUI", "How often a rewind state will be created. Higher frequencies have greater system requirements.");
 TRANSLATE_NOOP("FullscreenUI", "Identifies any new files added to the game directories.");
 TRANSLATE_NOOP("FullscreenUI", "If not enabled, the current post processing chain will be ignored.");
+TRANSLATE_NOOP("FullscreenUI", "Images which would need more memory than this when preloaded are read from disk.");
 TRANSLATE_NOOP("FullscreenUI", "Increase Timer Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Increases the field of view from 4:3 to the chosen display aspect ratio in 3D games.");
 TRANSLATE_NOOP("FullscreenUI", "Increases the precision of polygon culling, reducing the number of holes in geometry.");
@@ -7413,8 +7536,10 @@ TRANSLATE_NOOP("FullscreenUI", "Input profile '{}' saved.");
 TRANSLATE_NOOP("FullscreenUI", "Integration");
 TRANSLATE_NOOP("FullscreenUI", "Interface Settings");
 TRANSLATE_NOOP("FullscreenUI", "Internal Resolution");
+TRANSLATE_NOOP("FullscreenUI", "Keeps emulation and rendering threads on performance cores, on CPUs with mixed core types.");
 TRANSLATE_NOOP("FullscreenUI", "Last Played");
 TRANSLATE_NOOP("FullscreenUI", "Last Played: %s");
+TRANSLATE_NOOP("FullscreenUI", "Late Input Polling");
 TRANSLATE_NOOP("FullscreenUI", "Latency Control");
 TRANSLATE_NOOP("FullscreenUI", "Launch Options");
 TRANSLATE_NOOP("FullscreenUI", "Launch a game by selecting a file/disc image.");
@@ -7424,6 +7549,7 @@ TRANSLATE_NOOP("FullscreenUI", "Leaderboard Notifications");
 TRANSLATE_NOOP("FullscreenUI", "Leaderboards");
 TRANSLATE_NOOP("FullscreenUI", "Leaderboards are not enabled.");
 TRANSLATE_NOOP("FullscreenUI", "Limits how many frames are displayed to the screen. These frames are still rendered.");
+TRANSLATE_NOOP("FullscreenUI", "Limits how much code is compiled each frame, interpreting it until the next frame. Reduces stutter.");
 TRANSLATE_NOOP("FullscreenUI", "Line Detection");
 TRANSLATE_NOOP("FullscreenUI", "List Settings");
 TRANSLATE_NOOP("FullscreenUI", "Load Devices From Save States");
@@ -7433,6 +7559,7 @@ TRANSLATE_NOOP("FullscreenUI", "Load Resume State");
 TRANSLATE_NOOP("FullscreenUI", "Load State");
 TRANSLATE_NOOP("FullscreenUI", "Loads all replacement texture to RAM, reducing stuttering at runtime.");
 TRANSLATE_NOOP("FullscreenUI", "Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay.");
+TRANSLATE_NOOP("FullscreenUI", "Local Cache Size");
 TRANSLATE_NOOP("FullscreenUI", "Log Level");
 TRANSLATE_NOOP("FullscreenUI", "Log To Debug Console");
 TRANSLATE_NOOP("FullscreenUI", "Log To File");
@@ -7443,6 +7570,8 @@ TRANSLATE_NOOP("FullscreenUI", "Login");
 TRANSLATE_NOOP("FullscreenUI", "Login token generated on {}");
 TRANSLATE_NOOP("FullscreenUI", "Logout");
 TRANSLATE_NOOP("FullscreenUI", "Logs BIOS calls to printf(). Not all games contain debugging messages.");
+TRANSLATE_NOOP("FullscreenUI", "Lowers the internal resolution when the GPU can't keep up, up to the resolution above.");
+TRANSLATE_NOOP("FullscreenUI", "Lowest internal resolution which dynamic resolution will use.");
 TRANSLATE_NOOP("FullscreenUI", "Logs in to RetroAchievements.");
 TRANSLATE_NOOP("FullscreenUI", "Logs messages to duckstation.log in the user directory.");
 TRANSLATE_NOOP("FullscreenUI", "Logs messages to the console window.");
@@ -7453,6 +7582,7 @@ TRANSLATE_NOOP("FullscreenUI", "Macro {} Frequency");
 TRANSLATE_NOOP("FullscreenUI", "Macro {} Press To Toggle");
 TRANSLATE_NOOP("FullscreenUI", "Macro {} Trigger");
 TRANSLATE_NOOP("FullscreenUI", "Makes games run closer to their console framerate, at a small cost to performance.");
+TRANSLATE_NOOP("FullscreenUI", "Maximum memory used by loaded replacements. The least recently used are unloaded when it is exceeded. Ignored when preloading.");
 TRANSLATE_NOOP("FullscreenUI", "Memory Card Busy");
 TRANSLATE_NOOP("FullscreenUI", "Memory Card Directory");
 TRANSLATE_NOOP("FullscreenUI", "Memory Card Port {}");
@@ -7461,6 +7591,7 @@ TRANSLATE_NOOP("FullscreenUI", "Memory Card {} Type");
 TRANSLATE_NOOP("FullscreenUI", "Merge Multi-Disc Games");
 TRANSLATE_NOOP("FullscreenUI", "Merges multi-disc games into one item in the game list.");
 TRANSLATE_NOOP("FullscreenUI", "Minimal Output Latency");
+TRANSLATE_NOOP("FullscreenUI", "Minimum Dynamic Resolution");
 TRANSLATE_NOOP("FullscreenUI", "Move Down");
 TRANSLATE_NOOP("FullscreenUI", "Move Up");
 TRANSLATE_NOOP("FullscreenUI", "Moves this shader higher in the chain, applying it earlier.");
@@ -7478,6 +7609,7 @@ TRANSLATE_NOOP("FullscreenUI", "No resume save state found.");
 TRANSLATE_NOOP("FullscreenUI", "No save present in this slot.");
 TRANSLATE_NOOP("FullscreenUI", "No save states found.");
 TRANSLATE_NOOP("FullscreenUI", "No, resume the game.");
+TRANSLATE_NOOP("FullscreenUI", "Non-Blocking Presentation");
 TRANSLATE_NOOP("FullscreenUI", "None (Double Speed)");
 TRANSLATE_NOOP("FullscreenUI", "None (Normal Speed)");
 TRANSLATE_NOOP("FullscreenUI", "Not Logged In");
@@ -7485,6 +7617,7 @@ TRANSLATE_NOOP("FullscreenUI", "Not Scanning Subdirectories");
 TRANSLATE_NOOP("FullscreenUI", "OK");
 TRANSLATE_NOOP("FullscreenUI", "OSD Scale");
 TRANSLATE_NOOP("FullscreenUI", "On-Screen Display");
+TRANSLATE_NOOP("FullscreenUI", "Only allocates GPU memory for the parts of VRAM which are used. Requires Vulkan.");
 TRANSLATE_NOOP("FullscreenUI", "Open Containing Directory");
 TRANSLATE_NOOP("FullscreenUI", "Open in File Browser");
 TRANSLATE_NOOP("FullscreenUI", "Operations");
@@ -7515,12 +7648,14 @@ TRANSLATE_NOOP("FullscreenUI", "Performance enhancement - jumps directly between
 TRANSLATE_NOOP("FullscreenUI", "Perspective Correct Colors");
 TRANSLATE_NOOP("FullscreenUI", "Perspective Correct Textures");
 TRANSLATE_NOOP("FullscreenUI", "Plays sound effects for events such as achievement unlocks and leaderboard submissions.");
+TRANSLATE_NOOP("FullscreenUI", "Polls controllers again when the game reads them, instead of only at the start of each frame.");
 TRANSLATE_NOOP("FullscreenUI", "Port {} Controller Type");
 TRANSLATE_NOOP("FullscreenUI", "Position");
 TRANSLATE_NOOP("FullscreenUI", "Post-Processing Settings");
 TRANSLATE_NOOP("FullscreenUI", "Post-processing chain cleared.");
 TRANSLATE_NOOP("FullscreenUI", "Post-processing shaders reloaded.");
 TRANSLATE_NOOP("FullscreenUI", "Preload Images to RAM");
+TRANSLATE_NOOP("FullscreenUI", "Preload Memory Limit");
 TRANSLATE_NOOP("FullscreenUI", "Preload Replacement Textures");
 TRANSLATE_NOOP("FullscreenUI", "Presents frames on a background thread when fast forwarding or vsync is disabled.");
 TRANSLATE_NOOP("FullscreenUI", "Preserve Projection Precision");
@@ -7532,7 +7667,9 @@ TRANSLATE_NOOP("FullscreenUI", "Quick Save");
 TRANSLATE_NOOP("FullscreenUI", "RAIntegration is being used instead of the built-in achievements implementation.");
 TRANSLATE_NOOP("FullscreenUI", "Read Speedup");
 TRANSLATE_NOOP("FullscreenUI", "Readahead Sectors");
+TRANSLATE_NOOP("FullscreenUI", "Recompile Software Rasterizer");
 TRANSLATE_NOOP("FullscreenUI", "Recompiler Fast Memory Access");
+TRANSLATE_NOOP("FullscreenUI", "Recompiles frequently run code through conditional branches, reducing block exits.");
 TRANSLATE_NOOP("FullscreenUI", "Reduce Input Latency");
 TRANSLATE_NOOP("FullscreenUI", "Reduces \"wobbly\" polygons by attempting to preserve the fractional component through memory transfers.");
 TRANSLATE_NOOP("FullscreenUI", "Reduces hitches in emulation by reading/decompressing CD data asynchronously on a worker thread.");
@@ -7543,12 +7680,14 @@ TRANSLATE_NOOP("FullscreenUI", "Region: ");
 TRANSLATE_NOOP("FullscreenUI", "Release Date: %s");
 TRANSLATE_NOOP("FullscreenUI", "Reload Shaders");
 TRANSLATE_NOOP("FullscreenUI", "Reloads the shaders from disk, applying any changes.");
+TRANSLATE_NOOP("FullscreenUI", "Remembers compiled blocks between sessions, and compiles them ahead of time.");
 TRANSLATE_NOOP("FullscreenUI", "Remove From Chain");
 TRANSLATE_NOOP("FullscreenUI", "Remove From List");
 TRANSLATE_NOOP("FullscreenUI", "Removed stage {} ({}).");
 TRANSLATE_NOOP("FullscreenUI", "Removes this shader from the chain.");
 TRANSLATE_NOOP("FullscreenUI", "Renames existing save states when saving to a backup file.");
 TRANSLATE_NOOP("FullscreenUI", "Rendering");
+TRANSLATE_NOOP("FullscreenUI", "Replacement Cache Size");
 TRANSLATE_NOOP("FullscreenUI", "Replaces these settings with a previously saved input profile.");
 TRANSLATE_NOOP("FullscreenUI", "Rescan All Games");
 TRANSLATE_NOOP("FullscreenUI", "Reset Memory Card Directory");
@@ -7564,6 +7703,8 @@ TRANSLATE_NOOP("FullscreenUI", "Resume Last Session");
 TRANSLATE_NOOP("FullscreenUI", "Return To Game");
 TRANSLATE_NOOP("FullscreenUI", "Return to desktop mode, or exit the application.");
 TRANSLATE_NOOP("FullscreenUI", "Return to the previous menu.");
+TRANSLATE_NOOP("FullscreenUI", "Reuse Unchanged Frames");
+TRANSLATE_NOOP("FullscreenUI", "Reuses the previous frame when the image is unchanged, instead of post-processing it again.");
 TRANSLATE_NOOP("FullscreenUI", "Reverses the game list sort order from the default (usually ascending to descending).");
 TRANSLATE_NOOP("FullscreenUI", "Rewind Save Frequency");
 TRANSLATE_NOOP("FullscreenUI", "Rewind Save Slots");
@@ -7601,6 +7742,7 @@ TRANSLATE_NOOP("FullscreenUI", "Select Disc Image");
 TRANSLATE_NOOP("FullscreenUI", "Select Game");
 TRANSLATE_NOOP("FullscreenUI", "Select Macro {} Binds");
 TRANSLATE_NOOP("FullscreenUI", "Select State");
+TRANSLATE_NOOP("FullscreenUI", "Selects the FFmpeg encoder used for video captures.");
 TRANSLATE_NOOP("FullscreenUI", "Selects the GPU to use for rendering.");
 TRANSLATE_NOOP("FullscreenUI", "Selects the percentage of the normal clock speed the emulated hardware will run at.");
 TRANSLATE_NOOP("FullscreenUI", "Selects the quality at which screenshots will be compressed.");
@@ -7613,6 +7755,7 @@ TRANSLATE_NOOP("FullscreenUI", "Set Input Binding");
 TRANSLATE_NOOP("FullscreenUI", "Set VRAM Write Dump Alpha Channel");
 TRANSLATE_NOOP("FullscreenUI", "Sets a threshold for discarding precise values when exceeded. May help with glitches in some games.");
 TRANSLATE_NOOP("FullscreenUI", "Sets a threshold for discarding the emulated depth buffer. May help in some games.");
+TRANSLATE_NOOP("FullscreenUI", "Sets the bitrate which video captures are encoded at.");
 TRANSLATE_NOOP("FullscreenUI", "Sets the fast forward speed. It is not guaranteed that this speed will be reached on all systems.");
 TRANSLATE_NOOP("FullscreenUI", "Sets the target emulation speed. It is not guaranteed that this speed will be reached on all systems.");
 TRANSLATE_NOOP("FullscreenUI", "Sets the turbo speed. It is not guaranteed that this speed will be reached on all systems.");
@@ -7652,9 +7795,13 @@ TRANSLATE_NOOP("FullscreenUI", "Shows the number of frames (or v-syncs) displaye
 TRANSLATE_NOOP("FullscreenUI", "Simulates the CPU's instruction cache in the recompiler. Can help with games running too fast.");
 TRANSLATE_NOOP("FullscreenUI", "Simulates the region check present in original, unmodified consoles.");
 TRANSLATE_NOOP("FullscreenUI", "Simulates the system ahead of time and rolls back/replays to reduce input lag. Very high system requirements.");
+TRANSLATE_NOOP("FullscreenUI", "Skip Idle Loops");
+TRANSLATE_NOOP("FullscreenUI", "Skip Presenting Unchanged Frames");
+TRANSLATE_NOOP("FullscreenUI", "Skips displaying frames when the host can't keep up with the target speed.");
 TRANSLATE_NOOP("FullscreenUI", "Slow Boot");
 TRANSLATE_NOOP("FullscreenUI", "Smooths out blockyness between colour transitions in 24-bit content, usually FMVs. Only applies to the hardware renderers.");
 TRANSLATE_NOOP("FullscreenUI", "Smooths out the blockiness of magnified textures on 3D objects.");
+TRANSLATE_NOOP("FullscreenUI", "Software Rasterizer Threads");
 TRANSLATE_NOOP("FullscreenUI", "Sort By");
 TRANSLATE_NOOP("FullscreenUI", "Sort Reversed");
 TRANSLATE_NOOP("FullscreenUI", "Sound Effects");
@@ -7671,6 +7818,8 @@ TRANSLATE_NOOP("FullscreenUI", "Start Fullscreen");
 TRANSLATE_NOOP("FullscreenUI", "Start Game");
 TRANSLATE_NOOP("FullscreenUI", "Start a game from a disc in your PC's DVD drive.");
 TRANSLATE_NOOP("FullscreenUI", "Start the console without any disc inserted.");
+TRANSLATE_NOOP("FullscreenUI", "Starts games faster by building most pipelines during gameplay.");
+TRANSLATE_NOOP("FullscreenUI", "Stops presenting while the image is unchanged, the variable refresh display keeps the last image.");
 TRANSLATE_NOOP("FullscreenUI", "Stores the current settings to an input profile.");
 TRANSLATE_NOOP("FullscreenUI", "Stretch Display Vertically");
 TRANSLATE_NOOP("FullscreenUI", "Stretch Mode");
@@ -7688,9 +7837,11 @@ TRANSLATE_NOOP("FullscreenUI", "Texture Replacements");
 TRANSLATE_NOOP("FullscreenUI", "The SDL input source supports most controllers.");
 TRANSLATE_NOOP("FullscreenUI", "The XInput source provides support for XBox 360/XBox One/XBox Series controllers.");
 TRANSLATE_NOOP("FullscreenUI", "The audio backend determines how frames produced by the emulator are submitted to the host.");
+TRANSLATE_NOOP("FullscreenUI", "The least recently played images are removed when the cache grows beyond this size.");
 TRANSLATE_NOOP("FullscreenUI", "The selected memory card image will be used in shared mode for this slot.");
 TRANSLATE_NOOP("FullscreenUI", "This game has no achievements.");
 TRANSLATE_NOOP("FullscreenUI", "This game has no leaderboards.");
+TRANSLATE_NOOP("FullscreenUI", "Thread Placement");
 TRANSLATE_NOOP("FullscreenUI", "Threaded Presentation");
 TRANSLATE_NOOP("FullscreenUI", "Threaded Rendering");
 TRANSLATE_NOOP("FullscreenUI", "Time Played");
@@ -7718,6 +7869,7 @@ TRANSLATE_NOOP("FullscreenUI", "Use Global Setting");
 TRANSLATE_NOOP("FullscreenUI", "Use Light Theme");
 TRANSLATE_NOOP("FullscreenUI", "Use Single Card For Multi-Disc Games");
 TRANSLATE_NOOP("FullscreenUI", "Use Software Renderer For Readbacks");
+TRANSLATE_NOOP("FullscreenUI", "Use Sparse VRAM");
 TRANSLATE_NOOP("FullscreenUI", "Username: {}");
 TRANSLATE_NOOP("FullscreenUI", "Uses PGXP for all instructions, not just memory operations.");
 TRANSLATE_NOOP("FullscreenUI", "Uses a blit presentation model instead of flipping. This may be needed on some systems.");
@@ -7729,6 +7881,8 @@ TRANSLATE_NOOP("FullscreenUI", "Uses perspective-correct interpolation for textu
 TRANSLATE_NOOP("FullscreenUI", "Uses screen positions to resolve PGXP data. May improve visuals in some games.");
 TRANSLATE_NOOP("FullscreenUI", "Value: {} | Default: {} | Minimum: {} | Maximum: {}");
 TRANSLATE_NOOP("FullscreenUI", "Vertical Sync (VSync)");
+TRANSLATE_NOOP("FullscreenUI", "Video Capture Bitrate");
+TRANSLATE_NOOP("FullscreenUI", "Video Capture Encoder");
 TRANSLATE_NOOP("FullscreenUI", "WARNING: Your game is still saving to the memory card. Continuing to {0} may IRREVERSIBLY DESTROY YOUR MEMORY CARD. We recommend resuming your game and waiting 5 seconds for it to finish saving.\n\nDo you want to {0} anyway?");
 TRANSLATE_NOOP("FullscreenUI", "When enabled and logged in, DuckStation will scan for achievements on startup.");
 TRANSLATE_NOOP("FullscreenUI", "When enabled, DuckStation will assume all achievements are locked and not send any unlock notifications to the server.");
@@ -11,16 +11,23 @@
 
 #include "common/assert.h"
 #include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
 
 #include "ryml.hpp"
+#include "xxhash.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <type_traits>
@@ -34,14 +41,52 @@ namespace GameDatabase {
 enum : u32
 {
   GAME_DATABASE_CACHE_SIGNATURE = 0x45434C48,
-  GAME_DATABASE_CACHE_VERSION = 8,
+  GAME_DATABASE_CACHE_VERSION = 9,
 };
 
-static Entry* GetMutableEntry(std::string_view serial);
-static const Entry* GetEntryForId(std::string_view code);
+/// Cache file layout: CacheHeader, CacheEntry[num_entries], u32 bucket_seeds[num_buckets],
+/// CacheCodeSlot[num_slots], then the serialized entries and strings.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u64 gamedb_timestamp;
+  u32 num_entries;
+  u32 num_buckets;
+  u32 num_slots;
+  u32 data_size;
+};
+static_assert(sizeof(CacheHeader) == 32);
+
+struct CacheEntry
+{
+  u32 data_offset;
+  u32 data_size;
+  u32 serial_offset;
+  u32 serial_length;
+};
+static_assert(sizeof(CacheEntry) == 16);
+
+struct CacheCodeSlot
+{
+  u32 code_offset;
+  u32 code_length;
+  u32 entry_index;
+};
+static_assert(sizeof(CacheCodeSlot) == 12);
 
+static constexpr u32 CODES_PER_BUCKET = 4;
+static constexpr u32 MAX_BUCKET_SEED = 1000000;
+static constexpr u32 INVALID_ENTRY_INDEX = 0xFFFFFFFFu;
+
+static bool ReadEntryFromStream(ByteStream* stream, Entry* entry);
+static bool WriteEntryToStream(ByteStream* stream, const Entry& entry);
 static bool LoadFromCache();
 static bool SaveToCache();
+static void UnmapCache();
+static std::string_view GetCacheString(u32 offset, u32 length);
+static std::optional<u32> FindCachedCode(std::string_view code);
+static const Entry* GetCachedEntry(u32 index);
 
 static void SetRymlCallbacks();
 static bool LoadGameDBYaml();
@@ -81,6 +126,7 @@ static constexpr const std::array<const char*, static_cast<u32>(GameDatabase::Tr
   "ForceRecompilerMemoryExceptions",
   "ForceRecompilerICache",
   "ForceRecompilerLUTFastmem",
+  "DisableIdleLoopSkipping",
   "IsLibCryptProtected",
 }};
 
@@ -106,6 +152,7 @@ static constexpr const std::array<const char*, static_cast<u32>(GameDatabase::Tr
   TRANSLATE_NOOP("GameDatabase", "Force Recompiler Memory Exceptions"),
   TRANSLATE_NOOP("GameDatabase", "Force Recompiler ICache"),
   TRANSLATE_NOOP("GameDatabase", "Force Recompiler LUT Fastmem"),
+  TRANSLATE_NOOP("GameDatabase", "Disable Idle Loop Skipping"),
   TRANSLATE_NOOP("GameDatabase", "Is LibCrypt Protected"),
 }};
 
@@ -115,9 +162,22 @@ static constexpr const char* DISCDB_YAML_FILENAME = "discdb.yaml";
 static bool s_loaded = false;
 static bool s_track_hashes_loaded = false;
 
+// Only used when the cache couldn't be written, or while it's being built.
 static std::vector<GameDatabase::Entry> s_entries;
 static PreferUnorderedStringMap<u32> s_code_lookup;
 
+static const u8* s_cache_data = nullptr;
+static size_t s_cache_data_size = 0;
+static const CacheHeader* s_cache_header = nullptr;
+static const CacheEntry* s_cache_entries = nullptr;
+static const u32* s_cache_bucket_seeds = nullptr;
+static const CacheCodeSlot* s_cache_slots = nullptr;
+static const char* s_cache_strings = nullptr;
+
+// Lookups can come from game list scan threads.
+static std::mutex s_decode_mutex;
+static std::vector<std::unique_ptr<GameDatabase::Entry>> s_decoded_entries;
+
 static TrackHashesMap s_track_hashes_map;
 } // namespace GameDatabase
 
@@ -248,15 +308,22 @@ void GameDatabase::EnsureLoaded()
     s_entries = {};
     s_code_lookup = {};
 
+    // Once the cache is written, use it like any other run, so the parsed entries can be released.
     LoadGameDBYaml();
-    SaveToCache();
+    if (SaveToCache() && LoadFromCache())
+    {
+      s_entries = {};
+      s_code_lookup = {};
+    }
   }
 
-  Log_InfoFmt("Database load of {} entries took {:.0f}ms.", s_entries.size(), timer.GetTimeMilliseconds());
+  const size_t num_entries = s_cache_header ? s_cache_header->num_entries : s_entries.size();
+  Log_InfoFmt("Database load of {} entries took {:.0f}ms.", num_entries, timer.GetTimeMilliseconds());
 }
 
 void GameDatabase::Unload()
 {
+  UnmapCache();
   s_entries = {};
   s_code_lookup = {};
   s_loaded = false;
@@ -269,6 +336,12 @@ const GameDatabase::Entry* GameDatabase::GetEntryForId(std::string_view code)
 
   EnsureLoaded();
 
+  if (s_cache_data)
+  {
+    const std::optional<u32> index = FindCachedCode(code);
+    return index.has_value() ? GetCachedEntry(index.value()) : nullptr;
+  }
+
   auto iter = s_code_lookup.find(code);
   return (iter != s_code_lookup.end()) ? &s_entries[iter->second] : nullptr;
 }
@@ -334,15 +407,27 @@ const GameDatabase::Entry* GameDatabase::GetEntryForSerial(std::string_view seri
 {
   EnsureLoaded();
 
-  return GetMutableEntry(serial);
-}
+  // Serials are almost always one of the entry's codes, so try the index first.
+  const Entry* entry = GetEntryForId(serial);
+  if (entry && entry->serial == serial)
+    return entry;
 
-GameDatabase::Entry* GameDatabase::GetMutableEntry(std::string_view serial)
-{
-  for (Entry& entry : s_entries)
+  if (s_cache_data)
   {
-    if (entry.serial == serial)
-      return &entry;
+    for (u32 i = 0; i < s_cache_header->num_entries; i++)
+    {
+      const CacheEntry& ce = s_cache_entries[i];
+      if (GetCacheString(ce.serial_offset, ce.serial_length) == serial)
+        return GetCachedEntry(i);
+    }
+  }
+  else
+  {
+    for (const Entry& it : s_entries)
+    {
+      if (it.serial == serial)
+        return &it;
+    }
   }
 
   return nullptr;
@@ -652,6 +737,12 @@ void GameDatabase::Entry::ApplySettings(Settings& settings, bool display_osd_mes
     settings.cpu_fastmem_mode = CPUFastmemMode::LUT;
   }
 
+  if (HasTrait(Trait::DisableIdleLoopSkipping))
+  {
+    Log_WarningPrint("Idle loop skipping disabled by compatibility settings.");
+    settings.cpu_idle_loop_skipping = false;
+  }
+
 #define BIT_FOR(ctype) (static_cast<u16>(1) << static_cast<u32>(ctype))
 
   if (supported_controllers != 0 && supported_controllers != static_cast<u16>(-1))
@@ -855,181 +946,358 @@ static std::string GetCacheFile()
   return Path::Combine(EmuFolders::Cache, "gamedb.cache");
 }
 
+bool GameDatabase::ReadEntryFromStream(ByteStream* stream, Entry* entry)
+{
+  constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
+  std::array<u8, num_bytes> bits;
+  u8 compatibility;
+  u32 num_disc_set_serials;
+
+  if (!stream->ReadSizePrefixedString(&entry->serial) || !stream->ReadSizePrefixedString(&entry->title) ||
+      !stream->ReadSizePrefixedString(&entry->genre) || !stream->ReadSizePrefixedString(&entry->developer) ||
+      !stream->ReadSizePrefixedString(&entry->publisher) ||
+      !stream->ReadSizePrefixedString(&entry->compatibility_version_tested) ||
+      !stream->ReadSizePrefixedString(&entry->compatibility_comments) || !stream->ReadU64(&entry->release_date) ||
+      !stream->ReadU8(&entry->min_players) || !stream->ReadU8(&entry->max_players) ||
+      !stream->ReadU8(&entry->min_blocks) || !stream->ReadU8(&entry->max_blocks) ||
+      !stream->ReadU16(&entry->supported_controllers) || !stream->ReadU8(&compatibility) ||
+      compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count) ||
+      !stream->Read2(bits.data(), num_bytes) || !ReadOptionalFromStream(stream, &entry->display_active_start_offset) ||
+      !ReadOptionalFromStream(stream, &entry->display_active_end_offset) ||
+      !ReadOptionalFromStream(stream, &entry->display_line_start_offset) ||
+      !ReadOptionalFromStream(stream, &entry->display_line_end_offset) ||
+      !ReadOptionalFromStream(stream, &entry->dma_max_slice_ticks) ||
+      !ReadOptionalFromStream(stream, &entry->dma_halt_ticks) ||
+      !ReadOptionalFromStream(stream, &entry->gpu_fifo_size) ||
+      !ReadOptionalFromStream(stream, &entry->gpu_max_run_ahead) ||
+      !ReadOptionalFromStream(stream, &entry->gpu_pgxp_tolerance) ||
+      !ReadOptionalFromStream(stream, &entry->gpu_pgxp_depth_threshold) ||
+      !ReadOptionalFromStream(stream, &entry->gpu_line_detect_mode) ||
+      !stream->ReadSizePrefixedString(&entry->disc_set_name) || !stream->ReadU32(&num_disc_set_serials))
+  {
+    return false;
+  }
+
+  if (num_disc_set_serials > 0)
+  {
+    entry->disc_set_serials.reserve(num_disc_set_serials);
+    for (u32 j = 0; j < num_disc_set_serials; j++)
+    {
+      if (!stream->ReadSizePrefixedString(&entry->disc_set_serials.emplace_back()))
+        return false;
+    }
+  }
+
+  entry->compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility);
+  entry->traits.reset();
+  for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
+  {
+    if ((bits[j / 8] & (1u << (j % 8))) != 0)
+      entry->traits[j] = true;
+  }
+
+  return true;
+}
+
+bool GameDatabase::WriteEntryToStream(ByteStream* stream, const Entry& entry)
+{
+  bool result = stream->WriteSizePrefixedString(entry.serial);
+  result = result && stream->WriteSizePrefixedString(entry.title);
+  result = result && stream->WriteSizePrefixedString(entry.genre);
+  result = result && stream->WriteSizePrefixedString(entry.developer);
+  result = result && stream->WriteSizePrefixedString(entry.publisher);
+  result = result && stream->WriteSizePrefixedString(entry.compatibility_version_tested);
+  result = result && stream->WriteSizePrefixedString(entry.compatibility_comments);
+  result = result && stream->WriteU64(entry.release_date);
+  result = result && stream->WriteU8(entry.min_players);
+  result = result && stream->WriteU8(entry.max_players);
+  result = result && stream->WriteU8(entry.min_blocks);
+  result = result && stream->WriteU8(entry.max_blocks);
+  result = result && stream->WriteU16(entry.supported_controllers);
+  result = result && stream->WriteU8(static_cast<u8>(entry.compatibility));
+
+  constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
+  std::array<u8, num_bytes> bits;
+  bits.fill(0);
+  for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
+  {
+    if (entry.traits[j])
+      bits[j / 8] |= (1u << (j % 8));
+  }
+
+  result = result && stream->Write2(bits.data(), num_bytes);
+
+  result = result && WriteOptionalToStream(stream, entry.display_active_start_offset);
+  result = result && WriteOptionalToStream(stream, entry.display_active_end_offset);
+  result = result && WriteOptionalToStream(stream, entry.display_line_start_offset);
+  result = result && WriteOptionalToStream(stream, entry.display_line_end_offset);
+  result = result && WriteOptionalToStream(stream, entry.dma_max_slice_ticks);
+  result = result && WriteOptionalToStream(stream, entry.dma_halt_ticks);
+  result = result && WriteOptionalToStream(stream, entry.gpu_fifo_size);
+  result = result && WriteOptionalToStream(stream, entry.gpu_max_run_ahead);
+  result = result && WriteOptionalToStream(stream, entry.gpu_pgxp_tolerance);
+  result = result && WriteOptionalToStream(stream, entry.gpu_pgxp_depth_threshold);
+  result = result && WriteOptionalToStream(stream, entry.gpu_line_detect_mode);
+
+  result = result && stream->WriteSizePrefixedString(entry.disc_set_name);
+  result = result && stream->WriteU32(static_cast<u32>(entry.disc_set_serials.size()));
+  for (const std::string& serial : entry.disc_set_serials)
+    result = result && stream->WriteSizePrefixedString(serial);
+
+  return result;
+}
+
+ALWAYS_INLINE static u64 HashCode(std::string_view code, u64 seed)
+{
+  return XXH64(code.data(), code.length(), seed);
+}
+
 bool GameDatabase::LoadFromCache()
 {
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
+  Assert(!s_cache_data);
+
+  const std::string filename = GetCacheFile();
+  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "rb");
+  if (!fp)
   {
     Log_DevPrintf("Cache does not exist, loading full database.");
     return false;
   }
 
-  const u64 gamedb_ts = Host::GetResourceFileTimestamp("gamedb.yaml", false).value_or(0);
+  const u64 gamedb_ts = Host::GetResourceFileTimestamp(GAMEDB_YAML_FILENAME, false).value_or(0);
 
-  u32 signature, version, num_entries, num_codes;
-  u64 file_gamedb_ts;
-  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU64(&file_gamedb_ts) ||
-      !stream->ReadU32(&num_entries) || !stream->ReadU32(&num_codes) || signature != GAME_DATABASE_CACHE_SIGNATURE ||
-      version != GAME_DATABASE_CACHE_VERSION)
+  const s64 size = FileSystem::FSize64(fp.get());
+  CacheHeader header;
+  if (size < static_cast<s64>(sizeof(CacheHeader)) || std::fread(&header, sizeof(header), 1, fp.get()) != 1 ||
+      header.signature != GAME_DATABASE_CACHE_SIGNATURE || header.version != GAME_DATABASE_CACHE_VERSION ||
+      header.num_buckets == 0 || header.num_slots == 0 ||
+      static_cast<u64>(size) != (sizeof(CacheHeader) + static_cast<u64>(header.num_entries) * sizeof(CacheEntry) +
+                                 static_cast<u64>(header.num_buckets) * sizeof(u32) +
+                                 static_cast<u64>(header.num_slots) * sizeof(CacheCodeSlot) + header.data_size))
   {
     Log_DevPrintf("Cache header is corrupted or version mismatch.");
     return false;
   }
 
-  if (gamedb_ts != file_gamedb_ts)
+  if (gamedb_ts != header.gamedb_timestamp)
   {
     Log_DevPrintf("Cache is out of date, recreating.");
     return false;
   }
 
-  s_entries.reserve(num_entries);
-
-  for (u32 i = 0; i < num_entries; i++)
+  // Entries are decoded from the mapping when they're first looked up, so there's nothing to parse here.
+  Error error;
+  s_cache_data = static_cast<const u8*>(MemMap::MapFileReadOnly(fp.get(), static_cast<size_t>(size), &error));
+  if (!s_cache_data)
   {
-    Entry& entry = s_entries.emplace_back();
+    Log_ErrorFmt("Failed to map game database cache: {}", error.GetDescription());
+    return false;
+  }
 
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    u8 compatibility;
-    u32 num_disc_set_serials;
-
-    if (!stream->ReadSizePrefixedString(&entry.serial) || !stream->ReadSizePrefixedString(&entry.title) ||
-        !stream->ReadSizePrefixedString(&entry.genre) || !stream->ReadSizePrefixedString(&entry.developer) ||
-        !stream->ReadSizePrefixedString(&entry.publisher) ||
-        !stream->ReadSizePrefixedString(&entry.compatibility_version_tested) ||
-        !stream->ReadSizePrefixedString(&entry.compatibility_comments) || !stream->ReadU64(&entry.release_date) ||
-        !stream->ReadU8(&entry.min_players) || !stream->ReadU8(&entry.max_players) ||
-        !stream->ReadU8(&entry.min_blocks) || !stream->ReadU8(&entry.max_blocks) ||
-        !stream->ReadU16(&entry.supported_controllers) || !stream->ReadU8(&compatibility) ||
-        compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count) ||
-        !stream->Read2(bits.data(), num_bytes) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_max_slice_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_halt_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_fifo_size) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_max_run_ahead) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_tolerance) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_depth_threshold) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_line_detect_mode) ||
-        !stream->ReadSizePrefixedString(&entry.disc_set_name) || !stream->ReadU32(&num_disc_set_serials))
-    {
-      Log_DevPrintf("Cache entry is corrupted.");
-      return false;
-    }
+  s_cache_data_size = static_cast<size_t>(size);
+  s_cache_header = reinterpret_cast<const CacheHeader*>(s_cache_data);
+  s_cache_entries = reinterpret_cast<const CacheEntry*>(s_cache_data + sizeof(CacheHeader));
+  s_cache_bucket_seeds = reinterpret_cast<const u32*>(s_cache_entries + header.num_entries);
+  s_cache_slots = reinterpret_cast<const CacheCodeSlot*>(s_cache_bucket_seeds + header.num_buckets);
+  s_cache_strings = reinterpret_cast<const char*>(s_cache_slots + header.num_slots);
+  s_decoded_entries.resize(header.num_entries);
+  return true;
+}
 
-    if (num_disc_set_serials > 0)
-    {
-      entry.disc_set_serials.reserve(num_disc_set_serials);
-      for (u32 j = 0; j < num_disc_set_serials; j++)
-      {
-        if (!stream->ReadSizePrefixedString(&entry.disc_set_serials.emplace_back()))
-        {
-          Log_DevPrintf("Cache entry is corrupted.");
-          return false;
-        }
-      }
-    }
+void GameDatabase::UnmapCache()
+{
+  if (!s_cache_data)
+    return;
 
-    entry.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility);
-    entry.traits.reset();
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
-    {
-      if ((bits[j / 8] & (1u << (j % 8))) != 0)
-        entry.traits[j] = true;
-    }
-  }
+  MemMap::UnmapFile(s_cache_data, s_cache_data_size);
+  s_cache_data = nullptr;
+  s_cache_data_size = 0;
+  s_cache_header = nullptr;
+  s_cache_entries = nullptr;
+  s_cache_bucket_seeds = nullptr;
+  s_cache_slots = nullptr;
+  s_cache_strings = nullptr;
+  s_decoded_entries.clear();
+}
 
-  for (u32 i = 0; i < num_codes; i++)
+std::string_view GameDatabase::GetCacheString(u32 offset, u32 length)
+{
+  if (offset > s_cache_header->data_size || length > (s_cache_header->data_size - offset))
+    return {};
+
+  return std::string_view(s_cache_strings + offset, length);
+}
+
+std::optional<u32> GameDatabase::FindCachedCode(std::string_view code)
+{
+  const u32 bucket = static_cast<u32>(HashCode(code, 0) % s_cache_header->num_buckets);
+  const u32 seed = s_cache_bucket_seeds[bucket];
+  if (seed == 0)
+    return std::nullopt;
+
+  const CacheCodeSlot& slot = s_cache_slots[HashCode(code, seed) % s_cache_header->num_slots];
+  if (slot.entry_index >= s_cache_header->num_entries || GetCacheString(slot.code_offset, slot.code_length) != code)
+    return std::nullopt;
+
+  return slot.entry_index;
+}
+
+const GameDatabase::Entry* GameDatabase::GetCachedEntry(u32 index)
+{
+  std::unique_lock lock(s_decode_mutex);
+  if (s_decoded_entries[index])
+    return s_decoded_entries[index].get();
+
+  const CacheEntry& ce = s_cache_entries[index];
+  if (ce.data_offset > s_cache_header->data_size || ce.data_size > (s_cache_header->data_size - ce.data_offset))
   {
-    std::string code;
-    u32 index;
-    if (!stream->ReadSizePrefixedString(&code) || !stream->ReadU32(&index) ||
-        index >= static_cast<u32>(s_entries.size()))
-    {
-      Log_DevPrintf("Cache code entry is corrupted.");
-      return false;
-    }
+    Log_ErrorFmt("Cache entry {} is out of range.", index);
+    return nullptr;
+  }
 
-    s_code_lookup.emplace(std::move(code), index);
+  std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream =
+    ByteStream::CreateReadOnlyMemoryStream(s_cache_strings + ce.data_offset, ce.data_size);
+  if (!ReadEntryFromStream(stream.get(), entry.get()))
+  {
+    Log_ErrorFmt("Cache entry {} is corrupted.", index);
+    return nullptr;
   }
 
-  return true;
+  s_decoded_entries[index] = std::move(entry);
+  return s_decoded_entries[index].get();
 }
 
 bool GameDatabase::SaveToCache()
 {
-  const u64 gamedb_ts = Host::GetResourceFileTimestamp("gamedb.yaml", false).value_or(0);
+  // Build a perfect hash over the codes, by hashing them into small buckets, then searching for a seed for each
+  // bucket, largest first, which sends all of its codes to unused slots. Lookups are then two hashes and one compare.
+  const u32 num_codes = static_cast<u32>(s_code_lookup.size());
+  const u32 num_buckets = std::max<u32>((num_codes + CODES_PER_BUCKET - 1) / CODES_PER_BUCKET, 1);
+  const u32 num_slots = std::max<u32>(num_codes + (num_codes / 4), 1);
 
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
-                                                   BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
-    return false;
+  std::vector<std::vector<std::string_view>> buckets(num_buckets);
+  for (const auto& it : s_code_lookup)
+    buckets[HashCode(it.first, 0) % num_buckets].push_back(it.first);
+
+  std::vector<u32> bucket_order(num_buckets);
+  for (u32 i = 0; i < num_buckets; i++)
+    bucket_order[i] = i;
+  std::sort(bucket_order.begin(), bucket_order.end(),
+            [&buckets](u32 lhs, u32 rhs) { return (buckets[lhs].size() > buckets[rhs].size()); });
+
+  std::vector<u32> bucket_seeds(num_buckets, 0);
+  std::vector<bool> slot_used(num_slots, false);
+  std::vector<std::string_view> slot_codes(num_slots);
+  std::vector<u32> candidate_slots;
+  for (const u32 bucket : bucket_order)
+  {
+    const std::vector<std::string_view>& codes = buckets[bucket];
+    if (codes.empty())
+      break;
 
-  bool result = stream->WriteU32(GAME_DATABASE_CACHE_SIGNATURE);
-  result = result && stream->WriteU32(GAME_DATABASE_CACHE_VERSION);
-  result = result && stream->WriteU64(static_cast<u64>(gamedb_ts));
+    u32 seed = 1;
+    for (; seed <= MAX_BUCKET_SEED; seed++)
+    {
+      candidate_slots.clear();
+      bool okay = true;
+      for (const std::string_view code : codes)
+      {
+        const u32 slot = static_cast<u32>(HashCode(code, seed) % num_slots);
+        if (slot_used[slot] ||
+            std::find(candidate_slots.begin(), candidate_slots.end(), slot) != candidate_slots.end())
+        {
+          okay = false;
+          break;
+        }
 
-  result = result && stream->WriteU32(static_cast<u32>(s_entries.size()));
-  result = result && stream->WriteU32(static_cast<u32>(s_code_lookup.size()));
+        candidate_slots.push_back(slot);
+      }
 
-  for (const Entry& entry : s_entries)
-  {
-    result = result && stream->WriteSizePrefixedString(entry.serial);
-    result = result && stream->WriteSizePrefixedString(entry.title);
-    result = result && stream->WriteSizePrefixedString(entry.genre);
-    result = result && stream->WriteSizePrefixedString(entry.developer);
-    result = result && stream->WriteSizePrefixedString(entry.publisher);
-    result = result && stream->WriteSizePrefixedString(entry.compatibility_version_tested);
-    result = result && stream->WriteSizePrefixedString(entry.compatibility_comments);
-    result = result && stream->WriteU64(entry.release_date);
-    result = result && stream->WriteU8(entry.min_players);
-    result = result && stream->WriteU8(entry.max_players);
-    result = result && stream->WriteU8(entry.min_blocks);
-    result = result && stream->WriteU8(entry.max_blocks);
-    result = result && stream->WriteU16(entry.supported_controllers);
-    result = result && stream->WriteU8(static_cast<u8>(entry.compatibility));
-
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    bits.fill(0);
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
+      if (okay)
+        break;
+    }
+
+    if (seed > MAX_BUCKET_SEED)
     {
-      if (entry.traits[j])
-        bits[j / 8] |= (1u << (j % 8));
+      Log_ErrorPrint("Failed to build code hash for game database cache.");
+      return false;
     }
 
-    result = result && stream->Write2(bits.data(), num_bytes);
+    bucket_seeds[bucket] = seed;
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+      slot_used[candidate_slots[i]] = true;
+      slot_codes[candidate_slots[i]] = codes[i];
+    }
+  }
 
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_max_slice_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_halt_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_fifo_size);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_max_run_ahead);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_tolerance);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_depth_threshold);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_line_detect_mode);
+  // Entries are stored in the same serialized form as before, with the codes and serials alongside them.
+  std::unique_ptr<GrowableMemoryByteStream> data = ByteStream::CreateGrowableMemoryStream();
+  std::vector<CacheEntry> entries;
+  entries.reserve(s_entries.size());
+  bool result = true;
+  for (const Entry& entry : s_entries)
+  {
+    CacheEntry& ce = entries.emplace_back();
+    ce.serial_offset = static_cast<u32>(data->GetPosition());
+    ce.serial_length = static_cast<u32>(entry.serial.length());
+    result = result && data->Write2(entry.serial.data(), ce.serial_length, nullptr);
+    ce.data_offset = static_cast<u32>(data->GetPosition());
+    result = result && WriteEntryToStream(data.get(), entry);
+    ce.data_size = static_cast<u32>(data->GetPosition()) - ce.data_offset;
+  }
 
-    result = result && stream->WriteSizePrefixedString(entry.disc_set_name);
-    result = result && stream->WriteU32(static_cast<u32>(entry.disc_set_serials.size()));
-    for (const std::string& serial : entry.disc_set_serials)
-      result = result && stream->WriteSizePrefixedString(serial);
+  std::vector<CacheCodeSlot> slots(num_slots, CacheCodeSlot{0, 0, INVALID_ENTRY_INDEX});
+  for (u32 i = 0; i < num_slots; i++)
+  {
+    if (!slot_used[i])
+      continue;
+
+    const std::string_view code = slot_codes[i];
+    slots[i].code_offset = static_cast<u32>(data->GetPosition());
+    slots[i].code_length = static_cast<u32>(code.length());
+    slots[i].entry_index = s_code_lookup.find(code)->second;
+    result = result && data->Write2(code.data(), slots[i].code_length, nullptr);
   }
 
-  for (const auto& it : s_code_lookup)
+  if (!result)
+    return false;
+
+  CacheHeader header = {};
+  header.signature = GAME_DATABASE_CACHE_SIGNATURE;
+  header.version = GAME_DATABASE_CACHE_VERSION;
+  header.gamedb_timestamp = Host::GetResourceFileTimestamp(GAMEDB_YAML_FILENAME, false).value_or(0);
+  header.num_entries = static_cast<u32>(entries.size());
+  header.num_buckets = num_buckets;
+  header.num_slots = num_slots;
+  header.data_size = static_cast<u32>(data->GetPosition());
+
+  std::vector<u8> file_data(sizeof(CacheHeader) + entries.size() * sizeof(CacheEntry) + num_buckets * sizeof(u32) +
+                            num_slots * sizeof(CacheCodeSlot) + header.data_size);
+  u8* file_ptr = file_data.data();
+  std::memcpy(file_ptr, &header, sizeof(header));
+  file_ptr += sizeof(header);
+  std::memcpy(file_ptr, entries.data(), entries.size() * sizeof(CacheEntry));
+  file_ptr += entries.size() * sizeof(CacheEntry);
+  std::memcpy(file_ptr, bucket_seeds.data(), num_buckets * sizeof(u32));
+  file_ptr += num_buckets * sizeof(u32);
+  std::memcpy(file_ptr, slots.data(), num_slots * sizeof(CacheCodeSlot));
+  file_ptr += num_slots * sizeof(CacheCodeSlot);
+  std::memcpy(file_ptr, data->GetMemoryPointer(), header.data_size);
+
+  // Write to a temporary file first, so a crash doesn't leave a half-written cache.
+  const std::string filename = GetCacheFile();
+  const std::string temp_filename = filename + ".tmp";
+  Error error;
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), file_data.data(), file_data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str(), &error))
   {
-    result = result && stream->WriteSizePrefixedString(it.first);
-    result = result && stream->WriteU32(it.second);
+    Log_ErrorFmt("Failed to write game database cache '{}': {}", filename, error.GetDescription());
+    FileSystem::DeleteFile(temp_filename.c_str());
+    return false;
   }
 
-  result = result && stream->Flush();
   return true;
 }
 
@@ -12,19 +12,32 @@
 #include "util/http_downloader.h"
 
 #include "common/assert.h"
-#include "common/byte_stream.h"
+#include "common/directory_watcher.h"
+#include "common/error.h"
 #include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
+#include "common/threading.h"
+#include "common/timer.h"
+
+#include "xxhash.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <ctime>
+#include <deque>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -33,6 +46,10 @@ Log_SetChannel(GameList);
 
 #ifdef _WIN32
 #include "common/windows_headers.h"
+#include <winioctl.h>
+#elif defined(__linux__)
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 #endif
 
 namespace GameList {
@@ -41,13 +58,35 @@ namespace {
 enum : u32
 {
   GAME_LIST_CACHE_SIGNATURE = 0x45434C48,
-  GAME_LIST_CACHE_VERSION = 34,
+  GAME_LIST_CACHE_VERSION = 35,
 
   PLAYED_TIME_SERIAL_LENGTH = 32,
   PLAYED_TIME_LAST_TIME_LENGTH = 20,  // uint64
   PLAYED_TIME_TOTAL_TIME_LENGTH = 20, // uint64
   PLAYED_TIME_LINE_LENGTH =
     PLAYED_TIME_SERIAL_LENGTH + 1 + PLAYED_TIME_LAST_TIME_LENGTH + 1 + PLAYED_TIME_TOTAL_TIME_LENGTH,
+
+  // Once the journal has this many updates, it's folded back into playtime.dat when it's next loaded.
+  PLAYED_TIME_COMPACT_THRESHOLD = 256,
+  PLAYED_TIME_OPEN_RETRIES = 100,
+
+  INVALID_CACHE_RECORD = 0xFFFFFFFFu,
+
+  MAX_SCAN_THREADS = 8,
+
+  // Reading several images at once from a spinning disk is slower than one after another.
+  MAX_SEEK_PENALTY_SCANS = 1,
+
+  // Scanned entries are added to the list in groups, so the UI isn't locked out for every file.
+  SCAN_MERGE_BATCH_SIZE = 32,
+
+  // Directories without change notifications (e.g. network shares) are checked this often.
+  WATCHER_POLL_INTERVAL_MS = 60 * 1000,
+
+  MAX_COVER_DOWNLOAD_CONCURRENCY = 16,
+  COVER_DOWNLOAD_MAX_RETRIES = 3,
+  COVER_DOWNLOAD_RETRY_DELAY_MS = 500,
+  COVER_DOWNLOAD_STATUS_INTERVAL_MS = 250,
 };
 
 struct PlayedTimeEntry
@@ -56,9 +95,88 @@ struct PlayedTimeEntry
   std::time_t total_played_time;
 };
 
+// The cache file is a header, then fixed-size records, a hash table of paths, and the strings they refer to.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u32 num_records;
+  u32 hash_table_size;
+  u32 string_table_size;
+  u32 reserved;
+};
+static_assert(sizeof(CacheHeader) == 24);
+
+struct CacheString
+{
+  u32 offset;
+  u32 length;
+};
+
+struct CacheRecord
+{
+  CacheString path;
+  CacheString serial;
+  CacheString title;
+  CacheString disc_set_name;
+  CacheString genre;
+  CacheString publisher;
+  CacheString developer;
+  u64 hash;
+  s64 file_size;
+  u64 uncompressed_size;
+  s64 last_modified_time;
+  u64 release_date;
+  u16 supported_controllers;
+  u8 type;
+  u8 region;
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  s8 disc_set_index;
+  u8 compatibility;
+  u8 reserved[6];
+};
+static_assert(sizeof(CacheRecord) == 112);
+
+struct PendingScan
+{
+  std::string path;
+  std::time_t timestamp;
+  bool seek_penalty;
+};
+
+struct CoverDownload
+{
+  std::string entry_path;
+  std::string existing_cover_path;
+  std::vector<std::string> urls;
+  size_t url_index = 0;
+  u32 attempts = 0;
+  Common::Timer::Value retry_time = 0;
+};
+
+using CoverValidatorsMap = PreferUnorderedStringMap<HTTPDownloader::CacheValidators>;
+
+/// Appends lines to the played time journal on a worker thread, so updates never wait for the file.
+struct PlayedTimeJournalWriter
+{
+  ~PlayedTimeJournalWriter();
+
+  void Append(std::string path, std::string line);
+  void ThreadEntryPoint();
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::string path;
+  std::string pending;
+  bool shutdown = false;
+};
+
 } // namespace
 
-using CacheMap = PreferUnorderedStringMap<Entry>;
 using PlayedTimeMap = PreferUnorderedStringMap<PlayedTimeEntry>;
 
 static_assert(std::is_same_v<decltype(Entry::hash), System::GameHash>);
@@ -68,37 +186,79 @@ static bool GetPsfListEntry(const std::string& path, Entry* entry);
 static bool GetDiscListEntry(const std::string& path, Entry* entry);
 
 static bool GetGameListEntryFromCache(const std::string& path, Entry* entry);
+static bool HasSeekPenalty(const char* path);
 static void ScanDirectory(const char* path, bool recursive, bool only_cache,
                           const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                          ProgressCallback* progress);
+                          std::vector<PendingScan>* pending_scans, ProgressCallback* progress);
 static bool AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map);
-static bool ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                     const PlayedTimeMap& played_time_map);
+static void ScanFiles(std::vector<PendingScan> pending_scans, const PlayedTimeMap& played_time_map,
+                      ProgressCallback* progress);
+static void AddScannedEntry(Entry entry, const PlayedTimeMap& played_time_map);
 
 static std::string GetCacheFilename();
 static void LoadCache();
-static bool LoadEntriesFromCache(ByteStream* stream);
-static bool OpenCacheForWriting();
-static bool WriteEntryToCache(const Entry* entry);
-static void CloseCacheFileStream();
+static void UnmapCache();
+static void CloseCache();
+static u32 FindCacheRecord(std::string_view path);
+static bool ReadCacheRecord(u32 index, Entry* entry);
+static void AddEntryToCache(const Entry& entry);
 static void DeleteCacheFile();
 static void CreateDiscSetEntries(const PlayedTimeMap& played_time_map);
+static void RecreateDiscSetEntries(const PlayedTimeMap& played_time_map);
+
+static std::optional<bool> GetWatchedDirectoryRecursion(std::string_view path);
+static void ProcessChangedPaths(std::vector<std::string> paths, const std::function<void()>& on_change);
+static bool UpdateEntryForChangedFile(const std::string& path, std::time_t timestamp,
+                                      const std::vector<std::string>& excluded_paths,
+                                      const PlayedTimeMap& played_time_map);
+static bool RemoveEntriesForPath(std::string_view path);
 
 static std::string GetPlayedTimeFile();
+static std::string GetTrackHashCacheFile();
 static bool ParsePlayedTimeLine(char* line, std::string& serial, PlayedTimeEntry& entry);
 static std::string MakePlayedTimeLine(const std::string& serial, const PlayedTimeEntry& entry);
-static PlayedTimeMap LoadPlayedTimeMap(const std::string& path);
-static PlayedTimeEntry UpdatePlayedTimeFile(const std::string& path, const std::string& serial, std::time_t last_time,
-                                            std::time_t add_time);
+static std::string GetPlayedTimeJournalFile();
+static void ApplyPlayedTimeUpdate(PlayedTimeMap& map, const std::string& serial, std::time_t last_time,
+                                  std::time_t add_time);
+static void EnsurePlayedTimeMapLoaded();
+static void AppendPlayedTimeJournal(const std::string& path, const std::string& data);
+static PlayedTimeEntry UpdatePlayedTime(const std::string& serial, std::time_t last_time, std::time_t add_time);
+static PlayedTimeMap GetPlayedTimeMap();
+
+static std::string GetCoverValidatorsFile();
+static CoverValidatorsMap LoadCoverValidators();
+static void SaveCoverValidators(const CoverValidatorsMap& validators);
+static std::string FormatHTTPDate(std::time_t time);
+static bool IsRetryableDownloadStatus(s32 status_code);
+static bool SaveDownloadedCover(const CoverDownload& download, std::string_view url, const std::string& content_type,
+                                const HTTPDownloader::Request::Data& data, bool use_serial,
+                                const std::function<void(const Entry*, std::string)>& save_callback);
 } // namespace GameList
 
 static std::vector<GameList::Entry> s_entries;
 static std::recursive_mutex s_mutex;
-static GameList::CacheMap s_cache_map;
-static std::unique_ptr<ByteStream> s_cache_write_stream;
+
+// Held while the list is being refreshed or updated from the watcher, since both use the cache.
+static std::mutex s_refresh_mutex;
+static std::atomic_uint32_t s_refresh_waiters{0};
+static std::atomic_bool s_deferred_hashing_cancelled{false};
+static DirectoryWatcher s_directory_watcher;
+static std::vector<DirectoryWatcher::Directory> s_watched_directories;
+static std::mutex s_track_hash_cache_mutex;
+static const u8* s_cache_data = nullptr;
+static size_t s_cache_data_size = 0;
+static const char* s_cache_strings = nullptr;
+static std::vector<bool> s_cache_records_used;
+static std::vector<GameList::Entry> s_cache_new_entries;
 
 static bool s_game_list_loaded = false;
 
+// Played time is loaded once. Updates change the map, then are appended to the journal from another thread.
+static std::mutex s_played_time_mutex;
+static GameList::PlayedTimeMap s_played_time_map;
+static bool s_played_time_loaded = false;
+static GameList::PlayedTimeJournalWriter s_played_time_journal;
+
 const char* GameList::GetEntryTypeName(EntryType type)
 {
   static std::array<const char*, static_cast<int>(EntryType::Count)> names = {
@@ -217,11 +377,21 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
   entry->type = EntryType::Disc;
   entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
 
+  // Hashing reads the whole executable, so it's skipped when the serial alone finds the game in the database. Discs
+  // without a serial, or with one the database doesn't know, still need the hash to be identified.
   std::string id;
-  System::GetGameDetailsFromImage(cdi.get(), &id, &entry->hash);
+  const GameDatabase::Entry* dentry = nullptr;
+  if (System::GetGameIdFromImage(cdi.get(), &id, &entry->region) && (dentry = GameDatabase::GetEntryForId(id)))
+  {
+    entry->hash = 0;
+  }
+  else
+  {
+    System::GetGameDetailsFromImage(cdi.get(), &id, &entry->hash);
+    dentry = GameDatabase::GetEntryForGameDetails(id, entry->hash);
+  }
 
   // try the database first
-  const GameDatabase::Entry* dentry = GameDatabase::GetEntryForGameDetails(id, entry->hash);
   if (dentry)
   {
     // pull from database
@@ -267,9 +437,6 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
     entry->supported_controllers = static_cast<u16>(~0u);
   }
 
-  // region detection
-  entry->region = System::GetRegionForImage(cdi.get());
-
   if (cdi->HasSubImages())
   {
     entry->type = EntryType::Playlist;
@@ -304,92 +471,90 @@ bool GameList::PopulateEntryFromPath(const std::string& path, Entry* entry)
   return GetDiscListEntry(path, entry);
 }
 
-bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry)
-{
-  auto iter = s_cache_map.find(path);
-  if (iter == s_cache_map.end())
-    return false;
-
-  *entry = std::move(iter->second);
-  s_cache_map.erase(iter);
-  return true;
-}
-
-bool GameList::LoadEntriesFromCache(ByteStream* stream)
+u32 GameList::FindCacheRecord(std::string_view path)
 {
-  u32 file_signature, file_version;
-  if (!stream->ReadU32(&file_signature) || !stream->ReadU32(&file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  if (!s_cache_data)
+    return INVALID_CACHE_RECORD;
+
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_data);
+  const CacheRecord* records = reinterpret_cast<const CacheRecord*>(s_cache_data + sizeof(CacheHeader));
+  const u32* hash_table = reinterpret_cast<const u32*>(records + header->num_records);
+  const u32 mask = header->hash_table_size - 1;
+  u32 slot = static_cast<u32>(XXH64(path.data(), path.length(), 0)) & mask;
+  for (u32 probes = 0; probes < header->hash_table_size; probes++, slot = (slot + 1) & mask)
   {
-    Log_WarningPrintf("Game list cache is corrupted");
-    return false;
+    // Slots hold the record index plus one, so that zero can mean empty.
+    const u32 value = hash_table[slot];
+    if (value == 0 || value > header->num_records)
+      return INVALID_CACHE_RECORD;
+
+    const CacheString& record_path = records[value - 1].path;
+    if (record_path.length == path.length() && record_path.offset <= header->string_table_size &&
+        record_path.length <= (header->string_table_size - record_path.offset) &&
+        std::memcmp(s_cache_strings + record_path.offset, path.data(), path.length()) == 0)
+    {
+      return value - 1;
+    }
   }
 
-  while (stream->GetPosition() != stream->GetSize())
-  {
-    std::string path;
-    Entry ge;
-
-    u8 type;
-    u8 region;
-    u8 compatibility_rating;
+  return INVALID_CACHE_RECORD;
+}
 
-    if (!stream->ReadU8(&type) || !stream->ReadU8(&region) || !stream->ReadSizePrefixedString(&path) ||
-        !stream->ReadSizePrefixedString(&ge.serial) || !stream->ReadSizePrefixedString(&ge.title) ||
-        !stream->ReadSizePrefixedString(&ge.disc_set_name) || !stream->ReadSizePrefixedString(&ge.genre) ||
-        !stream->ReadSizePrefixedString(&ge.publisher) || !stream->ReadSizePrefixedString(&ge.developer) ||
-        !stream->ReadU64(&ge.hash) || !stream->ReadS64(&ge.file_size) || !stream->ReadU64(&ge.uncompressed_size) ||
-        !stream->ReadU64(reinterpret_cast<u64*>(&ge.last_modified_time)) || !stream->ReadU64(&ge.release_date) ||
-        !stream->ReadU16(&ge.supported_controllers) || !stream->ReadU8(&ge.min_players) ||
-        !stream->ReadU8(&ge.max_players) || !stream->ReadU8(&ge.min_blocks) || !stream->ReadU8(&ge.max_blocks) ||
-        !stream->ReadS8(&ge.disc_set_index) || !stream->ReadU8(&compatibility_rating) ||
-        region >= static_cast<u8>(DiscRegion::Count) || type >= static_cast<u8>(EntryType::Count) ||
-        compatibility_rating >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted");
+bool GameList::ReadCacheRecord(u32 index, Entry* entry)
+{
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_data);
+  const CacheRecord& record = reinterpret_cast<const CacheRecord*>(s_cache_data + sizeof(CacheHeader))[index];
+  const auto read_string = [header](const CacheString& cs, std::string* str) {
+    if (cs.offset > header->string_table_size || cs.length > (header->string_table_size - cs.offset))
       return false;
-    }
 
-    ge.path = path;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<EntryType>(type);
-    ge.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility_rating);
+    str->assign(s_cache_strings + cs.offset, cs.length);
+    return true;
+  };
 
-    auto iter = s_cache_map.find(ge.path);
-    if (iter != s_cache_map.end())
-      iter->second = std::move(ge);
-    else
-      s_cache_map.emplace(std::move(path), std::move(ge));
+  if (!read_string(record.path, &entry->path) || !read_string(record.serial, &entry->serial) ||
+      !read_string(record.title, &entry->title) || !read_string(record.disc_set_name, &entry->disc_set_name) ||
+      !read_string(record.genre, &entry->genre) || !read_string(record.publisher, &entry->publisher) ||
+      !read_string(record.developer, &entry->developer) || record.region >= static_cast<u8>(DiscRegion::Count) ||
+      record.type >= static_cast<u8>(EntryType::Count) ||
+      record.compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
+  {
+    Log_WarningPrintf("Game list cache record %u is corrupted", index);
+    return false;
   }
 
+  entry->type = static_cast<EntryType>(record.type);
+  entry->region = static_cast<DiscRegion>(record.region);
+  entry->hash = record.hash;
+  entry->file_size = record.file_size;
+  entry->uncompressed_size = record.uncompressed_size;
+  entry->last_modified_time = static_cast<std::time_t>(record.last_modified_time);
+  entry->release_date = record.release_date;
+  entry->supported_controllers = record.supported_controllers;
+  entry->min_players = record.min_players;
+  entry->max_players = record.max_players;
+  entry->min_blocks = record.min_blocks;
+  entry->max_blocks = record.max_blocks;
+  entry->disc_set_index = record.disc_set_index;
+  entry->compatibility = static_cast<GameDatabase::CompatibilityRating>(record.compatibility);
   return true;
 }
 
-bool GameList::WriteEntryToCache(const Entry* entry)
-{
-  bool result = true;
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->type));
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->region));
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->path);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->serial);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->title);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->disc_set_name);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->genre);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->publisher);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->developer);
-  result &= s_cache_write_stream->WriteU64(entry->hash);
-  result &= s_cache_write_stream->WriteS64(entry->file_size);
-  result &= s_cache_write_stream->WriteU64(entry->uncompressed_size);
-  result &= s_cache_write_stream->WriteU64(entry->last_modified_time);
-  result &= s_cache_write_stream->WriteU64(entry->release_date);
-  result &= s_cache_write_stream->WriteU16(entry->supported_controllers);
-  result &= s_cache_write_stream->WriteU8(entry->min_players);
-  result &= s_cache_write_stream->WriteU8(entry->max_players);
-  result &= s_cache_write_stream->WriteU8(entry->min_blocks);
-  result &= s_cache_write_stream->WriteU8(entry->max_blocks);
-  result &= s_cache_write_stream->WriteS8(entry->disc_set_index);
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->compatibility));
-  return result;
+bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry)
+{
+  // Each record is only handed out once, the same file can be found through more than one directory.
+  const u32 index = FindCacheRecord(path);
+  if (index == INVALID_CACHE_RECORD || s_cache_records_used[index])
+    return false;
+
+  s_cache_records_used[index] = true;
+  return ReadCacheRecord(index, entry);
+}
+
+void GameList::AddEntryToCache(const Entry& entry)
+{
+  // Written out when the refresh finishes, along with the records which are still valid.
+  s_cache_new_entries.push_back(entry);
 }
 
 static std::string GameList::GetCacheFilename()
@@ -399,75 +564,173 @@ static std::string GameList::GetCacheFilename()
 
 void GameList::LoadCache()
 {
+  Assert(!s_cache_data);
+
   std::string filename(GetCacheFilename());
-  std::unique_ptr<ByteStream> stream =
-    ByteStream::OpenFile(filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "rb");
+  if (!fp)
     return;
 
-  if (!LoadEntriesFromCache(stream.get()))
+  const s64 size = FileSystem::FSize64(fp.get());
+  CacheHeader header;
+  if (size < static_cast<s64>(sizeof(CacheHeader)) || std::fread(&header, sizeof(header), 1, fp.get()) != 1 ||
+      header.signature != GAME_LIST_CACHE_SIGNATURE || header.version != GAME_LIST_CACHE_VERSION ||
+      header.hash_table_size == 0 || (header.hash_table_size & (header.hash_table_size - 1)) != 0 ||
+      header.num_records >= header.hash_table_size ||
+      static_cast<u64>(size) != (sizeof(CacheHeader) + static_cast<u64>(header.num_records) * sizeof(CacheRecord) +
+                                 static_cast<u64>(header.hash_table_size) * sizeof(u32) + header.string_table_size))
   {
     Log_WarningPrintf("Deleting corrupted cache file '%s'", filename.c_str());
-    stream.reset();
-    s_cache_map.clear();
+    fp.reset();
     DeleteCacheFile();
     return;
   }
+
+  // Records are read from the mapping as they're looked up, so there's nothing to parse at startup.
+  Error error;
+  s_cache_data = static_cast<const u8*>(MemMap::MapFileReadOnly(fp.get(), static_cast<size_t>(size), &error));
+  if (!s_cache_data)
+  {
+    Log_ErrorPrintf("Failed to map game list cache: %s", error.GetDescription().c_str());
+    return;
+  }
+
+  s_cache_data_size = static_cast<size_t>(size);
+  s_cache_strings = reinterpret_cast<const char*>(s_cache_data + sizeof(CacheHeader) +
+                                                  header.num_records * sizeof(CacheRecord) +
+                                                  header.hash_table_size * sizeof(u32));
+  s_cache_records_used.assign(header.num_records, false);
+  Log_DevPrintf("Mapped game list cache with %u records", header.num_records);
 }
 
-bool GameList::OpenCacheForWriting()
+void GameList::UnmapCache()
 {
-  const std::string cache_filename(GetCacheFilename());
-  Assert(!s_cache_write_stream);
+  if (!s_cache_data)
+    return;
+
+  MemMap::UnmapFile(s_cache_data, s_cache_data_size);
+  s_cache_data = nullptr;
+  s_cache_data_size = 0;
+  s_cache_strings = nullptr;
+  s_cache_records_used.clear();
+}
+
+void GameList::CloseCache()
+{
+  if (s_cache_new_entries.empty())
+  {
+    UnmapCache();
+    return;
+  }
 
-  s_cache_write_stream = ByteStream::OpenFile(cache_filename.c_str(),
-                                              BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_SEEKABLE);
-  if (s_cache_write_stream)
+  // Compact the old records and the new entries into a new file. Entries that were rescanned replace their old record.
+  std::vector<Entry> entries = std::move(s_cache_new_entries);
+  s_cache_new_entries = {};
+  if (s_cache_data)
   {
-    // check the header
-    u32 signature, version;
-    if (s_cache_write_stream->ReadU32(&signature) && signature == GAME_LIST_CACHE_SIGNATURE &&
-        s_cache_write_stream->ReadU32(&version) && version == GAME_LIST_CACHE_VERSION &&
-        s_cache_write_stream->SeekToEnd())
+    PreferUnorderedStringSet new_paths;
+    for (const Entry& entry : entries)
+      new_paths.insert(entry.path);
+
+    const u32 num_old_records = reinterpret_cast<const CacheHeader*>(s_cache_data)->num_records;
+    for (u32 i = 0; i < num_old_records; i++)
     {
-      return true;
+      Entry entry;
+      if (ReadCacheRecord(i, &entry) && !new_paths.contains(entry.path))
+        entries.push_back(std::move(entry));
     }
 
-    s_cache_write_stream.reset();
+    UnmapCache();
   }
 
-  Log_InfoPrintf("Creating new game list cache file: '%s'", cache_filename.c_str());
+  u32 hash_table_size = 16;
+  while (hash_table_size < (entries.size() * 2))
+    hash_table_size *= 2;
 
-  s_cache_write_stream = ByteStream::OpenFile(
-    cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_WRITE);
-  if (!s_cache_write_stream)
-    return false;
+  // Genre/publisher/developer repeat a lot, so identical strings are only stored once.
+  std::string strings;
+  PreferUnorderedStringMap<u32> string_offsets;
+  const auto intern_string = [&strings, &string_offsets](const std::string& str) {
+    auto iter = string_offsets.find(str);
+    if (iter == string_offsets.end())
+    {
+      iter = string_offsets.emplace(str, static_cast<u32>(strings.size())).first;
+      strings.append(str);
+    }
 
-  // new cache file, write header
-  if (!s_cache_write_stream->WriteU32(GAME_LIST_CACHE_SIGNATURE) ||
-      !s_cache_write_stream->WriteU32(GAME_LIST_CACHE_VERSION))
+    return CacheString{iter->second, static_cast<u32>(str.length())};
+  };
+
+  std::vector<CacheRecord> records;
+  std::vector<u32> hash_table(hash_table_size, 0);
+  records.reserve(entries.size());
+  for (const Entry& entry : entries)
   {
-    Log_ErrorPrintf("Failed to write game list cache header");
-    s_cache_write_stream.reset();
-    FileSystem::DeleteFile(cache_filename.c_str());
-    return false;
+    u32 slot = static_cast<u32>(XXH64(entry.path.data(), entry.path.length(), 0)) & (hash_table_size - 1);
+    while (hash_table[slot] != 0)
+      slot = (slot + 1) & (hash_table_size - 1);
+
+    records.push_back(CacheRecord{.path = intern_string(entry.path),
+                                  .serial = intern_string(entry.serial),
+                                  .title = intern_string(entry.title),
+                                  .disc_set_name = intern_string(entry.disc_set_name),
+                                  .genre = intern_string(entry.genre),
+                                  .publisher = intern_string(entry.publisher),
+                                  .developer = intern_string(entry.developer),
+                                  .hash = entry.hash,
+                                  .file_size = entry.file_size,
+                                  .uncompressed_size = entry.uncompressed_size,
+                                  .last_modified_time = static_cast<s64>(entry.last_modified_time),
+                                  .release_date = entry.release_date,
+                                  .supported_controllers = entry.supported_controllers,
+                                  .type = static_cast<u8>(entry.type),
+                                  .region = static_cast<u8>(entry.region),
+                                  .min_players = entry.min_players,
+                                  .max_players = entry.max_players,
+                                  .min_blocks = entry.min_blocks,
+                                  .max_blocks = entry.max_blocks,
+                                  .disc_set_index = entry.disc_set_index,
+                                  .compatibility = static_cast<u8>(entry.compatibility),
+                                  .reserved = {}});
+    hash_table[slot] = static_cast<u32>(records.size());
   }
 
-  return true;
-}
-
-void GameList::CloseCacheFileStream()
-{
-  if (!s_cache_write_stream)
+  CacheHeader header = {};
+  header.signature = GAME_LIST_CACHE_SIGNATURE;
+  header.version = GAME_LIST_CACHE_VERSION;
+  header.num_records = static_cast<u32>(records.size());
+  header.hash_table_size = hash_table_size;
+  header.string_table_size = static_cast<u32>(strings.size());
+  std::vector<u8> data(sizeof(CacheHeader) + records.size() * sizeof(CacheRecord) + hash_table_size * sizeof(u32) +
+                       strings.size());
+  u8* data_ptr = data.data();
+  std::memcpy(data_ptr, &header, sizeof(header));
+  data_ptr += sizeof(header);
+  std::memcpy(data_ptr, records.data(), records.size() * sizeof(CacheRecord));
+  data_ptr += records.size() * sizeof(CacheRecord);
+  std::memcpy(data_ptr, hash_table.data(), hash_table_size * sizeof(u32));
+  data_ptr += hash_table_size * sizeof(u32);
+  std::memcpy(data_ptr, strings.data(), strings.size());
+
+  // Write to a temporary file first, so a crash doesn't leave a half-written cache.
+  const std::string filename = GetCacheFilename();
+  const std::string temp_filename = filename + ".tmp";
+  Error error;
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str(), &error))
+  {
+    Log_ErrorPrintf("Failed to write game list cache '%s': %s", filename.c_str(), error.GetDescription().c_str());
+    FileSystem::DeleteFile(temp_filename.c_str());
     return;
+  }
 
-  s_cache_write_stream->Commit();
-  s_cache_write_stream.reset();
+  Log_DevPrintf("Wrote game list cache with %zu records", records.size());
 }
 
 void GameList::DeleteCacheFile()
 {
-  Assert(!s_cache_write_stream);
+  UnmapCache();
+  s_cache_new_entries.clear();
 
   const std::string filename(GetCacheFilename());
   if (!FileSystem::FileExists(filename.c_str()))
@@ -485,9 +748,58 @@ static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const
                       [&path](const std::string& entry) { return path.starts_with(entry); }) != excluded_paths.end();
 }
 
+bool GameList::HasSeekPenalty(const char* path)
+{
+#if defined(_WIN32)
+  const std::wstring wpath = StringUtil::UTF8StringToWideString(path);
+  wchar_t volume_path[MAX_PATH];
+  wchar_t volume_name[MAX_PATH];
+  if (!GetVolumePathNameW(wpath.c_str(), volume_path, static_cast<DWORD>(std::size(volume_path))) ||
+      !GetVolumeNameForVolumeMountPointW(volume_path, volume_name, static_cast<DWORD>(std::size(volume_name))))
+  {
+    return false;
+  }
+
+  // Volume names end in a backslash, which opens the root directory instead of the device.
+  std::wstring device_name(volume_name);
+  if (!device_name.empty() && device_name.back() == L'\\')
+    device_name.pop_back();
+
+  const HANDLE hDevice =
+    CreateFileW(device_name.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+  if (hDevice == INVALID_HANDLE_VALUE)
+    return false;
+
+  STORAGE_PROPERTY_QUERY query = {};
+  query.PropertyId = StorageDeviceSeekPenaltyProperty;
+  query.QueryType = PropertyStandardQuery;
+  DEVICE_SEEK_PENALTY_DESCRIPTOR desc = {};
+  DWORD bytes_returned = 0;
+  const bool result = DeviceIoControl(hDevice, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), &desc,
+                                      sizeof(desc), &bytes_returned, nullptr) &&
+                      bytes_returned >= sizeof(desc) && desc.IncursSeekPenalty;
+  CloseHandle(hDevice);
+  return result;
+#elif defined(__linux__)
+  struct stat st;
+  if (stat(path, &st) != 0)
+    return false;
+
+  // Partitions don't have a queue directory, it belongs to the parent device.
+  const std::string device_path = fmt::format("/sys/dev/block/{}:{}", major(st.st_dev), minor(st.st_dev));
+  std::optional<std::string> rotational = FileSystem::ReadFileToString((device_path + "/queue/rotational").c_str());
+  if (!rotational.has_value())
+    rotational = FileSystem::ReadFileToString((device_path + "/../queue/rotational").c_str());
+
+  return (rotational.has_value() && !rotational->empty() && rotational->front() == '1');
+#else
+  return false;
+#endif
+}
+
 void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
                              const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                             ProgressCallback* progress)
+                             std::vector<PendingScan>* pending_scans, ProgressCallback* progress)
 {
   Log_InfoPrintf("Scanning %s%s", path, recursive ? " (recursively)" : "");
 
@@ -505,6 +817,9 @@ void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
   progress->SetProgressRange(static_cast<u32>(files.size()));
   progress->SetProgressValue(0);
 
+  // Only needed if there's something to scan, and it's the same for the whole directory.
+  std::optional<bool> seek_penalty;
+
   u32 files_scanned = 0;
   for (FILESYSTEM_FIND_DATA& ffd : files)
   {
@@ -522,9 +837,22 @@ void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
     {
       continue;
     }
+    lock.unlock();
+
+    // Might be in both the recursive and non-recursive list.
+    if (std::any_of(pending_scans->begin(), pending_scans->end(),
+                    [&ffd](const PendingScan& ps) { return ps.path == ffd.FileName; }))
+    {
+      continue;
+    }
+
+    if (!seek_penalty.has_value())
+    {
+      seek_penalty = HasSeekPenalty(path);
+      Log_DevPrintf("'%s' %s a seek penalty", path, seek_penalty.value() ? "has" : "does not have");
+    }
 
-    progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(ffd.FileName).c_str());
-    ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map);
+    pending_scans->push_back(PendingScan{std::move(ffd.FileName), ffd.ModificationTime, seek_penalty.value()});
     progress->SetProgressValue(files_scanned);
   }
 
@@ -549,27 +877,148 @@ bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp,
   return true;
 }
 
-bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                        const PlayedTimeMap& played_time_map)
+void GameList::ScanFiles(std::vector<PendingScan> pending_scans, const PlayedTimeMap& played_time_map,
+                         ProgressCallback* progress)
 {
-  // don't block UI while scanning
-  lock.unlock();
+  if (pending_scans.empty())
+    return;
 
-  Log_DevPrintf("Scanning '%s'...", path.c_str());
+  // Load the database up front, since the workers would race to do it.
+  GameDatabase::EnsureLoaded();
 
-  Entry entry;
-  if (!PopulateEntryFromPath(path, &entry))
-    return false;
+  const u32 total_files = static_cast<u32>(pending_scans.size());
+  const u32 num_threads =
+    std::min(std::clamp(std::thread::hardware_concurrency(), 1u, static_cast<u32>(MAX_SCAN_THREADS)), total_files);
+  Log_InfoPrintf("Scanning %u files with %u threads", total_files, num_threads);
+
+  progress->PushState();
+  progress->SetProgressRange(total_files);
+  progress->SetProgressValue(0);
+
+  // Files on storage with a seek penalty go in their own queue, which is limited to fewer concurrent scans.
+  std::mutex mutex;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  std::deque<PendingScan> queue;
+  std::deque<PendingScan> seek_penalty_queue;
+  std::vector<Entry> scanned_entries;
+  std::string last_scanned_path;
+  u32 active_seek_penalty_scans = 0;
+  u32 active_threads = num_threads;
+  u32 files_scanned = 0;
+  bool cancelled = false;
+  for (PendingScan& ps : pending_scans)
+    (ps.seek_penalty ? seek_penalty_queue : queue).push_back(std::move(ps));
+
+  const auto worker = [&]() {
+    Threading::SetNameOfCurrentThread("Game List Scan");
+
+    std::unique_lock lock(mutex);
+    for (;;)
+    {
+      PendingScan ps;
+      if (cancelled)
+      {
+        break;
+      }
+      else if (!seek_penalty_queue.empty() && active_seek_penalty_scans < MAX_SEEK_PENALTY_SCANS)
+      {
+        ps = std::move(seek_penalty_queue.front());
+        seek_penalty_queue.pop_front();
+        active_seek_penalty_scans++;
+      }
+      else if (!queue.empty())
+      {
+        ps = std::move(queue.front());
+        queue.pop_front();
+      }
+      else if (!seek_penalty_queue.empty())
+      {
+        work_cv.wait(lock);
+        continue;
+      }
+      else
+      {
+        break;
+      }
+      lock.unlock();
+
+      Log_DevPrintf("Scanning '%s'...", ps.path.c_str());
+
+      Entry entry;
+      const bool populated = PopulateEntryFromPath(ps.path, &entry);
+
+      lock.lock();
+      if (ps.seek_penalty)
+      {
+        active_seek_penalty_scans--;
+        work_cv.notify_one();
+      }
+      if (populated)
+      {
+        entry.path = ps.path;
+        entry.last_modified_time = ps.timestamp;
+        scanned_entries.push_back(std::move(entry));
+      }
+      last_scanned_path = std::move(ps.path);
+      files_scanned++;
+      done_cv.notify_one();
+    }
+
+    active_threads--;
+    work_cv.notify_all();
+    done_cv.notify_one();
+  };
 
-  entry.path = std::move(path);
-  entry.last_modified_time = timestamp;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; i++)
+    threads.emplace_back(worker);
 
-  if (s_cache_write_stream || OpenCacheForWriting())
+  std::vector<Entry> batch;
+  std::unique_lock lock(mutex);
+  for (;;)
   {
-    if (!WriteEntryToCache(&entry))
-      Log_WarningPrintf("Failed to write entry '%s' to cache", entry.path.c_str());
+    done_cv.wait_for(lock, std::chrono::milliseconds(100), [&]() {
+      return (active_threads == 0 || scanned_entries.size() >= SCAN_MERGE_BATCH_SIZE);
+    });
+
+    const bool finished = (active_threads == 0);
+    const u32 current_files_scanned = files_scanned;
+    const std::string current_path = last_scanned_path;
+    batch.swap(scanned_entries);
+    if (!cancelled && progress->IsCancelled())
+    {
+      cancelled = true;
+      work_cv.notify_all();
+    }
+    lock.unlock();
+
+    // The cache stream and progress callback can only be used from this thread.
+    for (Entry& entry : batch)
+      AddScannedEntry(std::move(entry), played_time_map);
+    batch.clear();
+
+    if (!current_path.empty())
+      progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(current_path).c_str());
+    progress->SetProgressValue(current_files_scanned);
+
+    if (finished)
+      break;
+
+    lock.lock();
   }
 
+  for (std::thread& thread : threads)
+    thread.join();
+
+  progress->PopState();
+}
+
+void GameList::AddScannedEntry(Entry entry, const PlayedTimeMap& played_time_map)
+{
+  AddEntryToCache(entry);
+
   auto iter = played_time_map.find(entry.serial);
   if (iter != played_time_map.end())
   {
@@ -577,9 +1026,8 @@ bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
     entry.total_played_time = iter->second.total_played_time;
   }
 
-  lock.lock();
+  std::unique_lock lock(s_mutex);
   s_entries.push_back(std::move(entry));
-  return true;
 }
 
 std::unique_lock<std::recursive_mutex> GameList::GetLock()
@@ -622,9 +1070,20 @@ const GameList::Entry* GameList::GetEntryBySerial(std::string_view serial)
 
 const GameList::Entry* GameList::GetEntryBySerialAndHash(std::string_view serial, u64 hash)
 {
-  for (const Entry& entry : s_entries)
+  for (Entry& entry : s_entries)
   {
-    if (entry.serial == serial && entry.hash == hash)
+    if (entry.serial != serial)
+      continue;
+
+    // The hash may not have been computed yet, do it now rather than miss the entry.
+    if (entry.IsHashDeferred())
+    {
+      std::unique_ptr<CDImage> cdi = CDImage::Open(entry.path.c_str(), false, nullptr);
+      if (cdi)
+        System::GetGameDetailsFromImage(cdi.get(), nullptr, &entry.hash);
+    }
+
+    if (entry.hash == hash)
       return &entry;
   }
 
@@ -683,6 +1142,11 @@ u32 GameList::GetEntryCount()
 
 void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback* progress /* = nullptr */)
 {
+  // Tells any deferred hashing which is holding the lock to stop.
+  s_refresh_waiters.fetch_add(1, std::memory_order_acq_rel);
+  std::unique_lock refresh_lock(s_refresh_mutex);
+  s_refresh_waiters.fetch_sub(1, std::memory_order_acq_rel);
+  s_deferred_hashing_cancelled.store(false, std::memory_order_release);
   s_game_list_loaded = true;
 
   if (!progress)
@@ -703,7 +1167,7 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
   const std::vector<std::string> excluded_paths(Host::GetBaseStringListSetting("GameList", "ExcludedPaths"));
   const std::vector<std::string> dirs(Host::GetBaseStringListSetting("GameList", "Paths"));
   std::vector<std::string> recursive_dirs(Host::GetBaseStringListSetting("GameList", "RecursivePaths"));
-  const PlayedTimeMap played_time(LoadPlayedTimeMap(GetPlayedTimeFile()));
+  const PlayedTimeMap played_time(GetPlayedTimeMap());
 
 #ifdef __ANDROID__
   recursive_dirs.push_back(Path::Combine(EmuFolders::DataRoot, "games"));
@@ -711,6 +1175,8 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
 
   if (!dirs.empty() || !recursive_dirs.empty())
   {
+    // Cached entries are added while finding files, everything else is scanned afterwards, in parallel.
+    std::vector<PendingScan> pending_scans;
     progress->SetProgressRange(static_cast<u32>(dirs.size() + recursive_dirs.size()));
     progress->SetProgressValue(0);
 
@@ -721,7 +1187,7 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
       if (progress->IsCancelled())
         break;
 
-      ScanDirectory(dir.c_str(), false, only_cache, excluded_paths, played_time, progress);
+      ScanDirectory(dir.c_str(), false, only_cache, excluded_paths, played_time, &pending_scans, progress);
       progress->SetProgressValue(++directory_counter);
     }
     for (const std::string& dir : recursive_dirs)
@@ -729,62 +1195,327 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
       if (progress->IsCancelled())
         break;
 
-      ScanDirectory(dir.c_str(), true, only_cache, excluded_paths, played_time, progress);
+      ScanDirectory(dir.c_str(), true, only_cache, excluded_paths, played_time, &pending_scans, progress);
       progress->SetProgressValue(++directory_counter);
     }
+
+    if (!progress->IsCancelled())
+      ScanFiles(std::move(pending_scans), played_time, progress);
   }
 
   // don't need unused cache entries
-  CloseCacheFileStream();
-  s_cache_map.clear();
+  CloseCache();
 
   // merge multi-disc games
   CreateDiscSetEntries(played_time);
+
+  // The list is usable now, the hashes which were skipped can be filled in when the workers are otherwise idle.
+  if (!only_cache && !progress->IsCancelled())
+  {
+    refresh_lock.unlock();
+    Threading::ThreadPool::GetShared().Enqueue([]() { HashDeferredEntries(); },
+                                               Threading::ThreadPool::Priority::Low);
+  }
 }
 
-void GameList::CreateDiscSetEntries(const PlayedTimeMap& played_time_map)
+void GameList::HashDeferredEntries(ProgressCallback* progress /* = nullptr */)
 {
-  std::unique_lock lock(s_mutex);
+  if (!progress)
+    progress = ProgressCallback::NullProgressCallback;
 
-  for (size_t i = 0; i < s_entries.size(); i++)
+  const std::unique_lock refresh_lock(s_refresh_mutex);
+
+  std::vector<std::string> paths;
   {
-    const Entry& entry = s_entries[i];
+    std::unique_lock lock(s_mutex);
+    for (const Entry& entry : s_entries)
+    {
+      if (entry.IsHashDeferred())
+        paths.push_back(entry.path);
+    }
+  }
+  if (paths.empty())
+    return;
 
-    // only first discs can create sets
-    if (entry.type != EntryType::Disc || entry.disc_set_member || entry.disc_set_index != 0)
-      continue;
+  Log_InfoPrintf("Hashing %zu deferred game list entries", paths.size());
+  progress->SetProgressRange(static_cast<u32>(paths.size()));
+  progress->SetProgressValue(0);
 
-    // already have a disc set by this name?
-    const std::string& disc_set_name = entry.disc_set_name;
-    if (GetEntryForPath(disc_set_name.c_str()))
+  LoadCache();
+
+  u32 files_hashed = 0;
+  for (const std::string& path : paths)
+  {
+    if (progress->IsCancelled() || s_refresh_waiters.load(std::memory_order_acquire) != 0 ||
+        s_deferred_hashing_cancelled.load(std::memory_order_acquire))
+    {
+      break;
+    }
+
+    progress->SetProgressValue(files_hashed++);
+
+    System::GameHash hash = 0;
+    std::unique_ptr<CDImage> cdi = CDImage::Open(path.c_str(), false, nullptr);
+    if (!cdi || !System::GetGameDetailsFromImage(cdi.get(), nullptr, &hash) || hash == 0)
       continue;
+    cdi.reset();
 
-    const GameDatabase::Entry* dbentry = GameDatabase::GetEntryForSerial(entry.serial);
-    if (!dbentry)
+    std::unique_lock lock(s_mutex);
+    Entry* entry = const_cast<Entry*>(GetEntryForPath(path));
+    if (!entry || !entry->IsHashDeferred())
       continue;
 
-    // need at least two discs for a set
-    bool found_another_disc = false;
-    for (const Entry& other_entry : s_entries)
+    entry->hash = hash;
+    AddEntryToCache(*entry);
+
+    // Disc sets take their hash from one of the members.
+    for (Entry& set_entry : s_entries)
     {
-      if (other_entry.type != EntryType::Disc || other_entry.disc_set_member ||
-          other_entry.disc_set_name != disc_set_name || other_entry.disc_set_index == entry.disc_set_index)
+      if (set_entry.IsDiscSet() && set_entry.hash == 0 && set_entry.serial == entry->serial)
+        set_entry.hash = hash;
+    }
+  }
+
+  progress->SetProgressValue(files_hashed);
+
+  // Keeps the records of entries which weren't reached, so they aren't rescanned next time.
+  CloseCache();
+}
+
+void GameList::CancelDeferredHashing()
+{
+  s_deferred_hashing_cancelled.store(true, std::memory_order_release);
+}
+
+static std::vector<DirectoryWatcher::Directory> GetSearchDirectories()
+{
+  std::vector<DirectoryWatcher::Directory> ret;
+  for (std::string& dir : Host::GetBaseStringListSetting("GameList", "Paths"))
+    ret.push_back(DirectoryWatcher::Directory{std::move(dir), false});
+  for (std::string& dir : Host::GetBaseStringListSetting("GameList", "RecursivePaths"))
+    ret.push_back(DirectoryWatcher::Directory{std::move(dir), true});
+#ifdef __ANDROID__
+  ret.push_back(DirectoryWatcher::Directory{Path::Combine(EmuFolders::DataRoot, "games"), true});
+#endif
+  return ret;
+}
+
+void GameList::StartDirectoryWatcher(std::function<void()> on_change)
+{
+  StopDirectoryWatcher();
+
+  s_watched_directories = GetSearchDirectories();
+  if (s_watched_directories.empty())
+    return;
+
+  Error error;
+  if (!s_directory_watcher.Start(
+        s_watched_directories, WATCHER_POLL_INTERVAL_MS,
+        [on_change = std::move(on_change)](std::vector<std::string> paths) {
+          ProcessChangedPaths(std::move(paths), on_change);
+        },
+        &error))
+  {
+    Log_ErrorPrintf("Failed to start directory watcher: %s", error.GetDescription().c_str());
+    s_watched_directories.clear();
+  }
+}
+
+void GameList::StopDirectoryWatcher()
+{
+  s_directory_watcher.Stop();
+  s_watched_directories.clear();
+}
+
+std::optional<bool> GameList::GetWatchedDirectoryRecursion(std::string_view path)
+{
+  // Non-recursive directories only include files directly inside them.
+  const std::string_view parent = Path::GetDirectory(path);
+  for (const DirectoryWatcher::Directory& dir : s_watched_directories)
+  {
+    if (dir.recursive)
+    {
+      if (path.length() > dir.path.length() && path.starts_with(dir.path) &&
+          (path[dir.path.length()] == '/' || path[dir.path.length()] == FS_OSPATH_SEPARATOR_CHARACTER))
       {
-        continue;
+        return true;
       }
-      found_another_disc = true;
-      break;
     }
-    if (!found_another_disc)
+    else if (Path::Canonicalize(parent) == Path::Canonicalize(dir.path))
     {
-      Log_DevFmt("Not creating disc set {}, only one disc found", disc_set_name);
-      continue;
+      return false;
     }
+  }
 
-    Entry set_entry;
-    set_entry.type = EntryType::DiscSet;
-    set_entry.region = entry.region;
-    set_entry.path = disc_set_name;
+  return std::nullopt;
+}
+
+void GameList::ProcessChangedPaths(std::vector<std::string> paths, const std::function<void()>& on_change)
+{
+  const std::unique_lock refresh_lock(s_refresh_mutex);
+  const std::vector<std::string> excluded_paths(Host::GetBaseStringListSetting("GameList", "ExcludedPaths"));
+  const PlayedTimeMap played_time(GetPlayedTimeMap());
+
+  LoadCache();
+
+  bool changed = false;
+  for (const std::string& path : paths)
+  {
+    FILESYSTEM_STAT_DATA sd;
+    if (!FileSystem::StatFile(path.c_str(), &sd))
+    {
+      // Deleted or renamed away. If it was a directory, everything inside it is gone too.
+      changed |= RemoveEntriesForPath(path);
+      continue;
+    }
+
+    if (!(sd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY))
+    {
+      if (GetWatchedDirectoryRecursion(path).has_value())
+        changed |= UpdateEntryForChangedFile(path, sd.ModificationTime, excluded_paths, played_time);
+      continue;
+    }
+
+    // A directory which was moved or copied in, or the watcher lost track and is asking for a rescan.
+    // Subdirectories of non-recursive directories aren't part of the list.
+    const auto root = std::find_if(s_watched_directories.begin(), s_watched_directories.end(),
+                                   [&path](const DirectoryWatcher::Directory& dir) { return dir.path == path; });
+    const bool recursive = (root != s_watched_directories.end()) ? root->recursive : true;
+    if (root == s_watched_directories.end() && !GetWatchedDirectoryRecursion(path).value_or(false))
+      continue;
+
+    FileSystem::FindResultsArray files;
+    FileSystem::FindFiles(path.c_str(), "*",
+                          FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES |
+                            (recursive ? FILESYSTEM_FIND_RECURSIVE : 0),
+                          &files);
+    for (const FILESYSTEM_FIND_DATA& ffd : files)
+      changed |= UpdateEntryForChangedFile(ffd.FileName, ffd.ModificationTime, excluded_paths, played_time);
+  }
+
+  CloseCache();
+
+  if (!changed)
+    return;
+
+  RecreateDiscSetEntries(played_time);
+  on_change();
+}
+
+bool GameList::UpdateEntryForChangedFile(const std::string& path, std::time_t timestamp,
+                                         const std::vector<std::string>& excluded_paths,
+                                         const PlayedTimeMap& played_time_map)
+{
+  if (!IsScannableFilename(path) || IsPathExcluded(excluded_paths, path))
+    return false;
+
+  {
+    std::unique_lock lock(s_mutex);
+    const Entry* existing = GetEntryForPath(path);
+    if (existing && existing->last_modified_time == timestamp)
+      return false;
+  }
+
+  // Copying a file in can give us events before it's complete, in which case we'll get another one later.
+  Entry entry;
+  if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != timestamp)
+  {
+    Log_DevPrintf("Scanning changed file '%s'...", path.c_str());
+    entry = {};
+    if (!PopulateEntryFromPath(path, &entry))
+      return RemoveEntriesForPath(path);
+
+    entry.path = path;
+    entry.last_modified_time = timestamp;
+    AddEntryToCache(entry);
+  }
+
+  auto iter = played_time_map.find(entry.serial);
+  if (iter != played_time_map.end())
+  {
+    entry.last_played_time = iter->second.last_played_time;
+    entry.total_played_time = iter->second.total_played_time;
+  }
+
+  std::unique_lock lock(s_mutex);
+  Entry* existing = const_cast<Entry*>(GetEntryForPath(path));
+  if (existing)
+    *existing = std::move(entry);
+  else
+    s_entries.push_back(std::move(entry));
+
+  return true;
+}
+
+bool GameList::RemoveEntriesForPath(std::string_view path)
+{
+  std::unique_lock lock(s_mutex);
+  const size_t removed = std::erase_if(s_entries, [&path](const Entry& entry) {
+    return (entry.type != EntryType::DiscSet && entry.path.starts_with(path) &&
+            (entry.path.length() == path.length() || entry.path[path.length()] == '/' ||
+             entry.path[path.length()] == FS_OSPATH_SEPARATOR_CHARACTER));
+  });
+  if (removed > 0)
+    Log_DevPrintf("Removed %zu entries for '%.*s'", removed, static_cast<int>(path.length()), path.data());
+
+  return (removed > 0);
+}
+
+void GameList::RecreateDiscSetEntries(const PlayedTimeMap& played_time_map)
+{
+  {
+    std::unique_lock lock(s_mutex);
+    std::erase_if(s_entries, [](const Entry& entry) { return (entry.type == EntryType::DiscSet); });
+    for (Entry& entry : s_entries)
+      entry.disc_set_member = false;
+  }
+
+  CreateDiscSetEntries(played_time_map);
+}
+
+void GameList::CreateDiscSetEntries(const PlayedTimeMap& played_time_map)
+{
+  std::unique_lock lock(s_mutex);
+
+  for (size_t i = 0; i < s_entries.size(); i++)
+  {
+    const Entry& entry = s_entries[i];
+
+    // only first discs can create sets
+    if (entry.type != EntryType::Disc || entry.disc_set_member || entry.disc_set_index != 0)
+      continue;
+
+    // already have a disc set by this name?
+    const std::string& disc_set_name = entry.disc_set_name;
+    if (GetEntryForPath(disc_set_name.c_str()))
+      continue;
+
+    const GameDatabase::Entry* dbentry = GameDatabase::GetEntryForSerial(entry.serial);
+    if (!dbentry)
+      continue;
+
+    // need at least two discs for a set
+    bool found_another_disc = false;
+    for (const Entry& other_entry : s_entries)
+    {
+      if (other_entry.type != EntryType::Disc || other_entry.disc_set_member ||
+          other_entry.disc_set_name != disc_set_name || other_entry.disc_set_index == entry.disc_set_index)
+      {
+        continue;
+      }
+      found_another_disc = true;
+      break;
+    }
+    if (!found_another_disc)
+    {
+      Log_DevFmt("Not creating disc set {}, only one disc found", disc_set_name);
+      continue;
+    }
+
+    Entry set_entry;
+    set_entry.type = EntryType::DiscSet;
+    set_entry.region = entry.region;
+    set_entry.path = disc_set_name;
     set_entry.serial = entry.serial;
     set_entry.title = entry.disc_set_name;
     set_entry.genre = entry.developer;
@@ -933,11 +1664,63 @@ size_t GameList::Entry::GetReleaseDateString(char* buffer, size_t buffer_size) c
   return std::strftime(buffer, buffer_size, "%d %B %Y", &date_tm);
 }
 
+GameList::PlayedTimeJournalWriter::~PlayedTimeJournalWriter()
+{
+  if (!thread.joinable())
+    return;
+
+  // Anything still queued is written before the thread exits.
+  {
+    std::unique_lock lock(mutex);
+    shutdown = true;
+    cv.notify_one();
+  }
+
+  thread.join();
+}
+
+void GameList::PlayedTimeJournalWriter::Append(std::string path_, std::string line)
+{
+  // The path is kept here since EmuFolders may already be gone when the last lines are written at exit.
+  std::unique_lock lock(mutex);
+  path = std::move(path_);
+  pending.append(line);
+  if (!thread.joinable())
+    thread = std::thread(&PlayedTimeJournalWriter::ThreadEntryPoint, this);
+  else
+    cv.notify_one();
+}
+
+void GameList::PlayedTimeJournalWriter::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Played Time Journal");
+
+  std::unique_lock lock(mutex);
+  for (;;)
+  {
+    cv.wait(lock, [this]() { return (shutdown || !pending.empty()); });
+    if (pending.empty())
+      break;
+
+    std::string data = std::move(pending);
+    pending = {};
+    const std::string data_path = path;
+    lock.unlock();
+    AppendPlayedTimeJournal(data_path, data);
+    lock.lock();
+  }
+}
+
 std::string GameList::GetPlayedTimeFile()
 {
   return Path::Combine(EmuFolders::DataRoot, "playtime.dat");
 }
 
+std::string GameList::GetPlayedTimeJournalFile()
+{
+  return Path::Combine(EmuFolders::DataRoot, "playtime.journal");
+}
+
 bool GameList::ParsePlayedTimeLine(char* line, std::string& serial, PlayedTimeEntry& entry)
 {
   size_t len = std::strlen(line);
@@ -974,120 +1757,264 @@ std::string GameList::MakePlayedTimeLine(const std::string& serial, const Played
                      entry.last_played_time, static_cast<unsigned>(PLAYED_TIME_LAST_TIME_LENGTH));
 }
 
-GameList::PlayedTimeMap GameList::LoadPlayedTimeMap(const std::string& path)
+void GameList::ApplyPlayedTimeUpdate(PlayedTimeMap& map, const std::string& serial, std::time_t last_time,
+                                     std::time_t add_time)
 {
-  PlayedTimeMap ret;
+  // A last time of zero clears the played time.
+  if (last_time == 0)
+  {
+    map.erase(serial);
+    return;
+  }
+
+  auto iter = map.find(serial);
+  if (iter == map.end())
+  {
+    map.emplace(serial, PlayedTimeEntry{last_time, add_time});
+    return;
+  }
+
+  iter->second.last_played_time = last_time;
+  iter->second.total_played_time += add_time;
+}
 
-  // Use write mode here, even though we're not writing, so we can lock the file from other updates.
-  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "r+b");
+void GameList::EnsurePlayedTimeMapLoaded()
+{
+  if (s_played_time_loaded)
+    return;
+
+  s_played_time_loaded = true;
+
+  // playtime.dat holds the totals as of the last compaction, with fixed-size lines.
+  const std::string path = GetPlayedTimeFile();
+  if (auto fp = FileSystem::OpenManagedCFile(path.c_str(), "rb"))
+  {
+    char line[256];
+    while (std::fgets(line, sizeof(line), fp.get()))
+    {
+      std::string serial;
+      PlayedTimeEntry entry;
+      if (!ParsePlayedTimeLine(line, serial, entry) || entry.last_played_time == 0)
+        continue;
+
+      if (s_played_time_map.find(serial) != s_played_time_map.end())
+      {
+        Log_WarningPrintf("Duplicate entry: '%s'", serial.c_str());
+        continue;
+      }
+
+      s_played_time_map.emplace(std::move(serial), entry);
+    }
+  }
+
+  // The journal holds every update since then, as "<last time> <added time> <serial>" lines. Updates from other
+  // instances are appended to the same file, so times are added rather than overwritten.
+  const std::string journal_path = GetPlayedTimeJournalFile();
+  auto fp = FileSystem::OpenManagedCFile(journal_path.c_str(), "r+b");
 
 #ifdef _WIN32
   // On Windows, the file is implicitly locked.
-  while (!fp && GetLastError() == ERROR_SHARING_VIOLATION)
+  for (u32 i = 0; !fp && GetLastError() == ERROR_SHARING_VIOLATION && i < PLAYED_TIME_OPEN_RETRIES; i++)
   {
     Sleep(10);
-    fp = FileSystem::OpenManagedCFile(path.c_str(), "r+b");
+    fp = FileSystem::OpenManagedCFile(journal_path.c_str(), "r+b");
   }
 #endif
 
-  if (fp)
+  if (!fp)
+    return;
+
+  bool compacted = false;
   {
 #ifndef _WIN32
     FileSystem::POSIXLock flock(fp.get());
 #endif
 
+    u32 num_updates = 0;
     char line[256];
     while (std::fgets(line, sizeof(line), fp.get()))
     {
-      std::string serial;
-      PlayedTimeEntry entry;
-      if (!ParsePlayedTimeLine(line, serial, entry))
-        continue;
-
-      if (ret.find(serial) != ret.end())
+      const std::vector<std::string_view> tokens =
+        StringUtil::SplitString(StringUtil::StripWhitespace(std::string_view(line)), ' ');
+      std::optional<u64> last_time, add_time;
+      if (tokens.size() != 3 || !(last_time = StringUtil::FromChars<u64>(tokens[0])).has_value() ||
+          !(add_time = StringUtil::FromChars<u64>(tokens[1])).has_value())
       {
-        Log_WarningPrintf("Duplicate entry: '%s'", serial.c_str());
+        Log_WarningPrintf("Malformed journal line: '%s'", line);
         continue;
       }
 
-      ret.emplace(std::move(serial), entry);
+      ApplyPlayedTimeUpdate(s_played_time_map, std::string(tokens[2]), static_cast<std::time_t>(last_time.value()),
+                            static_cast<std::time_t>(add_time.value()));
+      num_updates++;
+    }
+
+    // Fold the journal back into playtime.dat once it gets long, so it doesn't grow forever.
+    if (num_updates >= PLAYED_TIME_COMPACT_THRESHOLD)
+    {
+      std::string data;
+      for (const auto& [serial, entry] : s_played_time_map)
+        data.append(MakePlayedTimeLine(serial, entry));
+
+      const std::string temp_path = path + ".tmp";
+      Error error;
+      if (FileSystem::WriteStringToFile(temp_path.c_str(), data) &&
+          FileSystem::RenamePath(temp_path.c_str(), path.c_str(), &error))
+      {
+        compacted = true;
+      }
+      else
+      {
+        Log_ErrorPrintf("Failed to compact '%s': %s", path.c_str(), error.GetDescription().c_str());
+        FileSystem::DeleteFile(temp_path.c_str());
+      }
     }
+
+#ifndef _WIN32
+    if (compacted)
+      FileSystem::DeleteFile(journal_path.c_str());
+#endif
   }
 
-  return ret;
+#ifdef _WIN32
+  // Can't delete it while it's open.
+  fp.reset();
+  if (compacted)
+    FileSystem::DeleteFile(journal_path.c_str());
+#endif
 }
 
-GameList::PlayedTimeEntry GameList::UpdatePlayedTimeFile(const std::string& path, const std::string& serial,
-                                                         std::time_t last_time, std::time_t add_time)
+void GameList::AppendPlayedTimeJournal(const std::string& path, const std::string& data)
 {
-  const PlayedTimeEntry new_entry{last_time, add_time};
-
-  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "r+b");
+  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "ab");
 
 #ifdef _WIN32
-  // On Windows, the file is implicitly locked.
-  while (!fp && GetLastError() == ERROR_SHARING_VIOLATION)
+  // On Windows, the file is implicitly locked. This runs on the journal thread, so waiting is fine.
+  for (u32 i = 0; !fp && GetLastError() == ERROR_SHARING_VIOLATION && i < PLAYED_TIME_OPEN_RETRIES; i++)
   {
     Sleep(10);
-    fp = FileSystem::OpenManagedCFile(path.c_str(), "r+b");
+    fp = FileSystem::OpenManagedCFile(path.c_str(), "ab");
   }
 #endif
 
-  // Doesn't exist? Create it.
-  if (!fp && errno == ENOENT)
-    fp = FileSystem::OpenManagedCFile(path.c_str(), "w+b");
-
   if (!fp)
   {
-    Log_ErrorPrintf("Failed to open '%s' for update.", path.c_str());
-    return new_entry;
+    Log_ErrorPrintf("Failed to open '%s' for append.", path.c_str());
+    return;
   }
 
 #ifndef _WIN32
   FileSystem::POSIXLock flock(fp.get());
 #endif
 
-  for (;;)
+  if (std::fwrite(data.data(), data.length(), 1, fp.get()) != 1 || std::fflush(fp.get()) != 0)
+    Log_ErrorPrintf("Failed to write '%s'.", path.c_str());
+}
+
+GameList::PlayedTimeEntry GameList::UpdatePlayedTime(const std::string& serial, std::time_t last_time,
+                                                     std::time_t add_time)
+{
+  PlayedTimeEntry ret = {};
   {
-    char line[256];
-    const s64 line_pos = FileSystem::FTell64(fp.get());
-    if (!std::fgets(line, sizeof(line), fp.get()))
-      break;
+    std::unique_lock lock(s_played_time_mutex);
+    EnsurePlayedTimeMapLoaded();
+    ApplyPlayedTimeUpdate(s_played_time_map, serial, last_time, add_time);
+    if (auto iter = s_played_time_map.find(serial); iter != s_played_time_map.end())
+      ret = iter->second;
+  }
 
-    std::string line_serial;
-    PlayedTimeEntry line_entry;
-    if (!ParsePlayedTimeLine(line, line_serial, line_entry))
-      continue;
+  if (serial.find_first_of(" \r\n") == std::string::npos)
+    s_played_time_journal.Append(GetPlayedTimeJournalFile(), fmt::format("{} {} {}\n", last_time, add_time, serial));
+  else
+    Log_ErrorPrintf("Not saving played time for invalid serial '%s'", serial.c_str());
 
-    if (line_serial != serial)
-      continue;
+  return ret;
+}
 
-    // found it!
-    line_entry.last_played_time = (last_time != 0) ? last_time : 0;
-    line_entry.total_played_time = (last_time != 0) ? (line_entry.total_played_time + add_time) : 0;
+GameList::PlayedTimeMap GameList::GetPlayedTimeMap()
+{
+  std::unique_lock lock(s_played_time_mutex);
+  EnsurePlayedTimeMapLoaded();
+  return s_played_time_map;
+}
+
+std::string GameList::GetTrackHashCacheFile()
+{
+  return Path::Combine(EmuFolders::Cache, "trackhashes.cache");
+}
+
+bool GameList::GetCachedTrackHashes(const std::string& path, std::vector<CDImageHasher::Hash>* hashes)
+{
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(path.c_str(), &sd))
+    return false;
+
+  std::unique_lock lock(s_track_hash_cache_mutex);
+  std::optional<std::string> data = FileSystem::ReadFileToString(GetTrackHashCacheFile().c_str());
+  if (!data.has_value())
+    return false;
 
-    std::string new_line(MakePlayedTimeLine(serial, line_entry));
-    if (FileSystem::FSeek64(fp.get(), line_pos, SEEK_SET) != 0 ||
-        std::fwrite(new_line.data(), new_line.length(), 1, fp.get()) != 1)
+  // Lines are "<size> <mtime> <hash>[,<hash>...] <path>". Entries are only ever appended, so the last match wins.
+  bool found = false;
+  for (const std::string_view line : StringUtil::SplitString(data.value(), '\n'))
+  {
+    const std::vector<std::string_view> tokens = StringUtil::SplitString(line, ' ', false);
+    if (tokens.size() < 4)
+      continue;
+
+    const std::string_view line_path = line.substr(tokens[0].size() + tokens[1].size() + tokens[2].size() + 3);
+    if (line_path != path || StringUtil::FromChars<s64>(tokens[0]).value_or(-1) != sd.Size ||
+        StringUtil::FromChars<s64>(tokens[1]).value_or(-1) != static_cast<s64>(sd.ModificationTime))
     {
-      Log_ErrorPrintf("Failed to update '%s'.", path.c_str());
+      continue;
     }
 
-    return line_entry;
-  }
+    std::vector<CDImageHasher::Hash> line_hashes;
+    for (const std::string_view hash_str : StringUtil::SplitString(tokens[2], ','))
+    {
+      const std::optional<CDImageHasher::Hash> hash = CDImageHasher::HashFromString(hash_str);
+      if (!hash.has_value())
+      {
+        Log_WarningFmt("Malformed track hash line: '{}'", line);
+        line_hashes.clear();
+        break;
+      }
 
-  if (last_time != 0)
-  {
-    // new entry.
-    std::string new_line(MakePlayedTimeLine(serial, new_entry));
-    if (FileSystem::FSeek64(fp.get(), 0, SEEK_END) != 0 ||
-        std::fwrite(new_line.data(), new_line.length(), 1, fp.get()) != 1)
+      line_hashes.push_back(hash.value());
+    }
+
+    if (!line_hashes.empty())
     {
-      Log_ErrorPrintf("Failed to write '%s'.", path.c_str());
+      *hashes = std::move(line_hashes);
+      found = true;
     }
   }
 
-  return new_entry;
+  return found;
+}
+
+void GameList::AddCachedTrackHashes(const std::string& path, const std::vector<CDImageHasher::Hash>& hashes)
+{
+  FILESYSTEM_STAT_DATA sd;
+  if (hashes.empty() || path.find('\n') != std::string::npos || !FileSystem::StatFile(path.c_str(), &sd))
+    return;
+
+  std::string line = fmt::format("{} {} ", sd.Size, static_cast<s64>(sd.ModificationTime));
+  for (size_t i = 0; i < hashes.size(); i++)
+  {
+    if (i > 0)
+      line.push_back(',');
+    line.append(CDImageHasher::HashToString(hashes[i]));
+  }
+  line.push_back(' ');
+  line.append(path);
+  line.push_back('\n');
+
+  std::unique_lock lock(s_track_hash_cache_mutex);
+  const std::string cache_path = GetTrackHashCacheFile();
+  auto fp = FileSystem::OpenManagedCFile(cache_path.c_str(), "ab");
+  if (!fp || std::fwrite(line.data(), line.length(), 1, fp.get()) != 1)
+    Log_ErrorFmt("Failed to write '{}'.", cache_path);
 }
 
 void GameList::AddPlayedTimeForSerial(const std::string& serial, std::time_t last_time, std::time_t add_time)
@@ -1095,7 +2022,7 @@ void GameList::AddPlayedTimeForSerial(const std::string& serial, std::time_t las
   if (serial.empty())
     return;
 
-  const PlayedTimeEntry pt(UpdatePlayedTimeFile(GetPlayedTimeFile(), serial, last_time, add_time));
+  const PlayedTimeEntry pt(UpdatePlayedTime(serial, last_time, add_time));
   Log_VerbosePrintf("Add %u seconds play time to %s -> now %u", static_cast<unsigned>(add_time), serial.c_str(),
                     static_cast<unsigned>(pt.total_played_time));
 
@@ -1129,7 +2056,7 @@ void GameList::ClearPlayedTimeForSerial(const std::string& serial)
   if (serial.empty())
     return;
 
-  UpdatePlayedTimeFile(GetPlayedTimeFile(), serial, 0, 0);
+  UpdatePlayedTime(serial, 0, 0);
 
   std::unique_lock<std::recursive_mutex> lock(s_mutex);
   for (GameList::Entry& entry : s_entries)
@@ -1273,8 +2200,116 @@ GameList::GetMatchingEntriesForSerial(const std::span<const std::string> serials
   return ret;
 }
 
-bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, bool use_serial,
-                              ProgressCallback* progress, std::function<void(const Entry*, std::string)> save_callback)
+std::string GameList::GetCoverValidatorsFile()
+{
+  return Path::Combine(EmuFolders::Cache, "covers.validators");
+}
+
+GameList::CoverValidatorsMap GameList::LoadCoverValidators()
+{
+  // One line per URL: url, etag and last-modified, separated by tabs. None of them can contain tabs.
+  CoverValidatorsMap ret;
+  const std::optional<std::string> data = FileSystem::ReadFileToString(GetCoverValidatorsFile().c_str());
+  if (!data.has_value())
+    return ret;
+
+  for (const std::string_view line : StringUtil::SplitString(data.value(), '\n'))
+  {
+    const std::vector<std::string_view> fields = StringUtil::SplitString(line, '\t', false);
+    if (fields.size() != 3 || fields[0].empty())
+      continue;
+
+    HTTPDownloader::CacheValidators& validators = ret[std::string(fields[0])];
+    validators.etag = fields[1];
+    validators.last_modified = fields[2];
+  }
+
+  return ret;
+}
+
+void GameList::SaveCoverValidators(const CoverValidatorsMap& validators)
+{
+  std::string data;
+  for (const auto& [url, url_validators] : validators)
+    fmt::format_to(std::back_inserter(data), "{}\t{}\t{}\n", url, url_validators.etag, url_validators.last_modified);
+
+  if (!FileSystem::WriteStringToFile(GetCoverValidatorsFile().c_str(), data))
+    Log_ErrorPrint("Failed to save cover validators.");
+}
+
+std::string GameList::FormatHTTPDate(std::time_t time)
+{
+  // strftime() can't be used, since the names of days and months depend on the locale.
+  static constexpr const char* day_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+  static constexpr const char* month_names[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+  tm time_tm = {};
+#ifdef _WIN32
+  gmtime_s(&time_tm, &time);
+#else
+  gmtime_r(&time, &time_tm);
+#endif
+
+  return fmt::format("{}, {:02d} {} {} {:02d}:{:02d}:{:02d} GMT", day_names[time_tm.tm_wday], time_tm.tm_mday,
+                     month_names[time_tm.tm_mon], time_tm.tm_year + 1900, time_tm.tm_hour, time_tm.tm_min,
+                     time_tm.tm_sec);
+}
+
+bool GameList::IsRetryableDownloadStatus(s32 status_code)
+{
+  // Server errors, timeouts and rate limiting are likely to go away if we try again later.
+  return ((status_code < 0 && status_code != HTTPDownloader::HTTP_STATUS_CANCELLED) || status_code == 408 ||
+          status_code == 429 || status_code >= 500);
+}
+
+bool GameList::SaveDownloadedCover(const CoverDownload& download, std::string_view url,
+                                   const std::string& content_type, const HTTPDownloader::Request::Data& data,
+                                   bool use_serial, const std::function<void(const Entry*, std::string)>& save_callback)
+{
+  std::unique_lock lock(s_mutex);
+  const GameList::Entry* entry = GetEntryForPath(download.entry_path);
+  if (!entry)
+    return false;
+
+  // Don't replace a cover which was added while we were downloading.
+  const std::string current_path(GetCoverImagePathForEntry(entry));
+  if (download.existing_cover_path.empty() && !current_path.empty())
+    return false;
+
+  // prefer the content type from the response for the extension
+  // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
+  const std::string filename(Path::URLDecode(url));
+  std::string template_filename;
+  std::string content_type_extension(HTTPDownloader::GetExtensionForContentType(content_type));
+
+  // don't treat the domain name as an extension..
+  const std::string::size_type last_slash = filename.find('/');
+  const std::string::size_type last_dot = filename.find('.');
+  if (!content_type_extension.empty())
+    template_filename = fmt::format("cover.{}", content_type_extension);
+  else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
+    template_filename = Path::GetFileName(filename);
+  else
+    template_filename = "cover.jpg";
+
+  std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
+  if (write_path.empty() || !FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()))
+    return false;
+
+  // A replacement with a different extension would otherwise be hidden by the old file.
+  if (!current_path.empty() && current_path != write_path)
+    FileSystem::DeleteFile(current_path.c_str());
+
+  if (save_callback)
+    save_callback(entry, std::move(write_path));
+
+  return true;
+}
+
+bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, bool use_serial, bool update_existing,
+                              u32 max_concurrent_downloads, ProgressCallback* progress,
+                              std::function<void(const Entry*, std::string)> save_callback)
 {
   if (!progress)
     progress = ProgressCallback::NullProgressCallback;
@@ -1297,15 +2332,19 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
-  std::vector<std::pair<std::string, std::string>> download_urls;
+  // Each game tries the templates in order, until one of them has a cover.
+  std::vector<CoverDownload> downloads;
   {
     std::unique_lock lock(s_mutex);
     for (const GameList::Entry& entry : s_entries)
     {
-      const std::string existing_path(GetCoverImagePathForEntry(&entry));
-      if (!existing_path.empty())
+      std::string existing_path(GetCoverImagePathForEntry(&entry));
+      if (!existing_path.empty() && !update_existing)
         continue;
 
+      CoverDownload& download = downloads.emplace_back();
+      download.entry_path = entry.path;
+      download.existing_cover_path = std::move(existing_path);
       for (const std::string& url_template : url_templates)
       {
         std::string url(url_template);
@@ -1319,11 +2358,11 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
         if (has_serial)
           StringUtil::ReplaceAll(&url, "${serial}", Path::URLEncode(entry.serial));
 
-        download_urls.emplace_back(entry.path, std::move(url));
+        download.urls.push_back(std::move(url));
       }
     }
   }
-  if (download_urls.empty())
+  if (downloads.empty())
   {
     progress->DisplayError("No URLs to download enumerated.");
     return false;
@@ -1336,65 +2375,145 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
+  max_concurrent_downloads = std::clamp<u32>(max_concurrent_downloads, 1, MAX_COVER_DOWNLOAD_CONCURRENCY);
+  downloader->SetMaxActiveRequests(max_concurrent_downloads);
+
+  CoverValidatorsMap validators = LoadCoverValidators();
+  bool validators_changed = false;
+
   progress->SetCancellable(true);
-  progress->SetProgressRange(static_cast<u32>(download_urls.size()));
+  progress->SetProgressRange(static_cast<u32>(downloads.size()));
 
-  for (auto& [entry_path, url] : download_urls)
-  {
-    if (progress->IsCancelled())
-      break;
+  std::deque<size_t> queue;
+  std::vector<size_t> retries;
+  for (size_t i = 0; i < downloads.size(); i++)
+    queue.push_back(i);
 
-    // make sure it didn't get done already
-    {
-      std::unique_lock lock(s_mutex);
-      const GameList::Entry* entry = GetEntryForPath(entry_path);
-      if (!entry || !GetCoverImagePathForEntry(entry).empty())
-      {
-        progress->IncrementProgressValue();
-        continue;
-      }
+  u32 active_downloads = 0;
+  u32 completed_downloads = 0;
+  u32 saved_covers = 0;
+  u64 bytes_received = 0;
+
+  const auto complete_download = [&progress, &completed_downloads]() {
+    completed_downloads++;
+    progress->IncrementProgressValue();
+  };
+
+  // Callbacks are run from PollRequests() on this thread, so none of this needs to be locked.
+  const auto start_download = [&](size_t index) {
+    const CoverDownload& download = downloads[index];
+    const std::string& url = download.urls[download.url_index];
 
-      progress->SetFormattedStatusText("Downloading cover for %s...", entry->title.c_str());
+    // Covers we already have are only downloaded again if they've changed on the server.
+    HTTPDownloader::CacheValidators request_validators;
+    if (!download.existing_cover_path.empty())
+    {
+      FILESYSTEM_STAT_DATA sd;
+      if (const auto iter = validators.find(url); iter != validators.end())
+        request_validators = iter->second;
+      else if (FileSystem::StatFile(download.existing_cover_path.c_str(), &sd))
+        request_validators.last_modified = FormatHTTPDate(sd.ModificationTime);
     }
 
-    // we could actually do a few in parallel here...
-    std::string filename = Path::URLDecode(url);
-    downloader->CreateRequest(
-      std::move(url), [use_serial, &save_callback, entry_path = std::move(entry_path), filename = std::move(filename)](
-                        s32 status_code, const std::string& content_type, HTTPDownloader::Request::Data data) {
-        if (status_code != HTTPDownloader::HTTP_STATUS_OK || data.empty())
+    active_downloads++;
+    downloader->CreateConditionalRequest(
+      url, std::move(request_validators),
+      [&, index](s32 status_code, const std::string& content_type, HTTPDownloader::CacheValidators response_validators,
+                 HTTPDownloader::Request::Data data) {
+        active_downloads--;
+        bytes_received += data.size();
+
+        CoverDownload& download = downloads[index];
+        const std::string& url = download.urls[download.url_index];
+        if (status_code == HTTPDownloader::HTTP_STATUS_OK && !data.empty())
+        {
+          if (SaveDownloadedCover(download, url, content_type, data, use_serial, save_callback))
+          {
+            saved_covers++;
+            if (!response_validators.IsEmpty())
+            {
+              validators[url] = std::move(response_validators);
+              validators_changed = true;
+            }
+          }
+
+          complete_download();
           return;
-
-        std::unique_lock lock(s_mutex);
-        const GameList::Entry* entry = GetEntryForPath(entry_path);
-        if (!entry || !GetCoverImagePathForEntry(entry).empty())
+        }
+        else if (status_code == HTTPDownloader::HTTP_STATUS_NOT_MODIFIED)
+        {
+          complete_download();
           return;
+        }
 
-        // prefer the content type from the response for the extension
-        // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
-        std::string template_filename;
-        std::string content_type_extension(HTTPDownloader::GetExtensionForContentType(content_type));
-
-        // don't treat the domain name as an extension..
-        const std::string::size_type last_slash = filename.find('/');
-        const std::string::size_type last_dot = filename.find('.');
-        if (!content_type_extension.empty())
-          template_filename = fmt::format("cover.{}", content_type_extension);
-        else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
-          template_filename = Path::GetFileName(filename);
-        else
-          template_filename = "cover.jpg";
+        if (IsRetryableDownloadStatus(status_code) && download.attempts < COVER_DOWNLOAD_MAX_RETRIES)
+        {
+          download.retry_time = Common::Timer::GetCurrentValue() +
+                                Common::Timer::ConvertMillisecondsToValue(COVER_DOWNLOAD_RETRY_DELAY_MS
+                                                                          << download.attempts);
+          download.attempts++;
+          retries.push_back(index);
+          return;
+        }
 
-        std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
-        if (write_path.empty())
+        // Not found, or it kept failing, so move on to the next template.
+        download.attempts = 0;
+        if ((++download.url_index) < download.urls.size())
+        {
+          queue.push_front(index);
           return;
+        }
 
-        if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
-          save_callback(entry, std::move(write_path));
+        complete_download();
       });
-    downloader->WaitForAllRequests();
-    progress->IncrementProgressValue();
+  };
+
+  Common::Timer timer;
+  Common::Timer status_timer;
+  while (active_downloads > 0 || (!progress->IsCancelled() && (!queue.empty() || !retries.empty())))
+  {
+    if (!progress->IsCancelled())
+    {
+      const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+      for (auto iter = retries.begin(); iter != retries.end();)
+      {
+        if (downloads[*iter].retry_time <= current_time)
+        {
+          queue.push_back(*iter);
+          iter = retries.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+
+      while (!queue.empty() && active_downloads < max_concurrent_downloads)
+      {
+        const size_t index = queue.front();
+        queue.pop_front();
+        start_download(index);
+      }
+    }
+
+    downloader->PollRequests();
+
+    if (status_timer.GetTimeMilliseconds() >= static_cast<double>(COVER_DOWNLOAD_STATUS_INTERVAL_MS))
+    {
+      status_timer.Reset();
+      const double kb_per_second = static_cast<double>(bytes_received) / 1024.0 / timer.GetTimeSeconds();
+      progress->SetStatusText(fmt::format("Checked {} of {} games, downloaded {} covers ({:.1f} KB/s)...",
+                                          completed_downloads, downloads.size(), saved_covers, kb_per_second)
+                                .c_str());
+    }
+
+    Common::Timer::NanoSleep(1000000);
   }
 
+  if (validators_changed)
+    SaveCoverValidators(validators);
+
+  Log_InfoFmt("Downloaded {} covers ({} bytes) in {:.1f} seconds.", saved_covers, bytes_received,
+              timer.GetTimeSeconds());
   return true;
 }
@@ -7,6 +7,7 @@
 #include "types.h"
 
 #include "util/cd_image.h"
+#include "util/cd_image_hasher.h"
 
 #include "common/small_string.h"
 
@@ -22,6 +23,8 @@ class ProgressCallback;
 struct SystemBootParameters;
 
 namespace GameList {
+static constexpr u32 DEFAULT_COVER_DOWNLOAD_CONCURRENCY = 4;
+
 enum class EntryType
 {
   Disc,
@@ -44,7 +47,7 @@ struct Entry
   std::string genre;
   std::string publisher;
   std::string developer;
-  u64 hash = 0;
+  u64 hash = 0; // zero for discs identified by serial alone, until HashDeferredEntries() runs
   s64 file_size = 0;
   u64 uncompressed_size = 0;
   std::time_t last_modified_time = 0;
@@ -66,6 +69,9 @@ struct Entry
 
   ALWAYS_INLINE bool IsDisc() const { return (type == EntryType::Disc); }
   ALWAYS_INLINE bool IsDiscSet() const { return (type == EntryType::DiscSet); }
+  ALWAYS_INLINE bool IsHashDeferred() const { return (type == EntryType::Disc && hash == 0 && !serial.empty()); }
+
+  bool operator==(const Entry& rhs) const = default;
 };
 
 const char* GetEntryTypeName(EntryType type);
@@ -94,6 +100,18 @@ bool IsGameListLoaded();
 /// If only_cache is set, no new files will be scanned, only those present in the cache.
 void Refresh(bool invalidate_cache, bool only_cache = false, ProgressCallback* progress = nullptr);
 
+/// Computes the hashes which were skipped while scanning, because the serial was enough to identify the disc.
+/// Refresh() queues this on the shared thread pool at low priority, and gives up early if another refresh starts.
+void HashDeferredEntries(ProgressCallback* progress = nullptr);
+
+/// Stops deferred hashing until the next refresh, so it doesn't hold up shutdown.
+void CancelDeferredHashing();
+
+/// Watches the configured directories, and adds, removes or rescans entries as files change, without a full refresh.
+/// on_change is called from the watcher thread after the list has been updated.
+void StartDirectoryWatcher(std::function<void()> on_change);
+void StopDirectoryWatcher();
+
 /// Add played time for the specified serial.
 void AddPlayedTimeForSerial(const std::string& serial, std::time_t last_time, std::time_t add_time);
 void ClearPlayedTimeForSerial(const std::string& serial);
@@ -101,6 +119,11 @@ void ClearPlayedTimeForSerial(const std::string& serial);
 /// Returns the total time played for a game. Requires the game to be scanned in the list.
 std::time_t GetCachedPlayedTimeForSerial(const std::string& serial);
 
+/// Looks up previously-computed track hashes for an image. Entries are dropped when the file's size or modification
+/// time changes, so stale hashes are never returned.
+bool GetCachedTrackHashes(const std::string& path, std::vector<CDImageHasher::Hash>* hashes);
+void AddCachedTrackHashes(const std::string& path, const std::vector<CDImageHasher::Hash>& hashes);
+
 /// Formats a timestamp to something human readable (e.g. Today, Yesterday, 10/11/12).
 TinyString FormatTimestamp(std::time_t timestamp);
 
@@ -118,7 +141,10 @@ GetMatchingEntriesForSerial(const std::span<const std::string> serials);
 
 /// Downloads covers using the specified URL templates. By default, covers are saved by title, but this can be changed
 /// with the use_serial parameter. save_callback optionall takes the entry and the path the new cover is saved to.
+/// If update_existing is set, games which already have a cover are checked too, and the cover is replaced if the
+/// server has a newer one. Up to max_concurrent_downloads requests are made at once.
 bool DownloadCovers(const std::vector<std::string>& url_templates, bool use_serial = false,
+                    bool update_existing = false, u32 max_concurrent_downloads = DEFAULT_COVER_DOWNLOAD_CONCURRENCY,
                     ProgressCallback* progress = nullptr,
                     std::function<void(const Entry*, std::string)> save_callback = {});
 }; // namespace GameList
@@ -3,6 +3,7 @@
 
 #include "gdb_protocol.h"
 #include "bus.h"
+#include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
@@ -11,17 +12,23 @@
 #include "common/small_string.h"
 #include "common/string_util.h"
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iomanip>
 #include <map>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 Log_SetChannel(GDBProtocol);
 
 namespace GDBProtocol {
 
+/// Largest packet we accept. Memory reads are answered in full, so this is also how much GDB asks for at once.
+static constexpr u32 MAX_PACKET_SIZE = 0x20000;
+
 static u8* GetMemoryPointer(PhysicalMemoryAddress address, u32 length)
 {
   auto region = Bus::GetMemoryRegionForAddress(address);
@@ -37,6 +44,102 @@ static u8* GetMemoryPointer(PhysicalMemoryAddress address, u32 length)
   return nullptr;
 }
 
+static void InvalidateCodeInRange(PhysicalMemoryAddress address, u32 length)
+{
+  // Writes through the pointer bypass the bus, so we have to tell the code cache ourselves.
+  if (length == 0 || !Bus::IsRAMAddress(address))
+    return;
+
+  // can wrap around into the mirrors
+  const u32 page_count = (Bus::g_ram_mask + 1) / HOST_PAGE_SIZE;
+  const u32 first_page = Bus::GetRAMCodePageIndex(address);
+  const u32 last_page = Bus::GetRAMCodePageIndex(address + length - 1);
+  for (u32 page = first_page;; page = (page + 1) % page_count)
+  {
+    if (Bus::IsRAMCodePage(page))
+      CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
+    if (page == last_page)
+      break;
+  }
+}
+
+static bool ParseAddressAndLength(std::string_view data, char separator, VirtualMemoryAddress* address, u32* length,
+                                  std::string_view* remaining = nullptr)
+{
+  const std::string_view::size_type comma = data.find(',');
+  if (comma == std::string_view::npos)
+    return false;
+
+  const std::string_view::size_type end = (separator != 0) ? data.find(separator, comma + 1) : data.size();
+  if (end == std::string_view::npos)
+    return false;
+
+  const std::optional<VirtualMemoryAddress> parsed_address =
+    StringUtil::FromChars<VirtualMemoryAddress>(data.substr(0, comma), 16);
+  const std::optional<u32> parsed_length = StringUtil::FromChars<u32>(data.substr(comma + 1, end - comma - 1), 16);
+  if (!parsed_address.has_value() || !parsed_length.has_value())
+    return false;
+
+  *address = parsed_address.value();
+  *length = parsed_length.value();
+  if (remaining)
+    *remaining = data.substr(std::min(end + 1, data.size()));
+  return true;
+}
+
+static void AppendHex(std::string* dest, const u8* data, u32 length)
+{
+  static constexpr char hex_chars[] = "0123456789abcdef";
+
+  const size_t pos = dest->size();
+  dest->resize(pos + length * 2);
+  char* out = dest->data() + pos;
+  for (u32 i = 0; i < length; i++)
+  {
+    *(out++) = hex_chars[data[i] >> 4];
+    *(out++) = hex_chars[data[i] & 0xF];
+  }
+}
+
+/// Binary data has '#', '$', '}' and '*' escaped with '}', followed by the byte XORed with 0x20.
+static std::optional<std::vector<u8>> UnescapeBinary(std::string_view data)
+{
+  std::vector<u8> ret;
+  ret.reserve(data.size());
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    if (data[i] == '}')
+    {
+      if (++i == data.size())
+        return std::nullopt;
+
+      ret.push_back(static_cast<u8>(data[i]) ^ 0x20);
+    }
+    else
+    {
+      ret.push_back(static_cast<u8>(data[i]));
+    }
+  }
+
+  return ret;
+}
+
+static void AppendEscapedBinary(std::string* dest, std::string_view data)
+{
+  for (const char ch : data)
+  {
+    if (ch == '#' || ch == '$' || ch == '}' || ch == '*')
+    {
+      dest->push_back('}');
+      dest->push_back(ch ^ 0x20);
+    }
+    else
+    {
+      dest->push_back(ch);
+    }
+  }
+}
+
 static u8 ComputeChecksum(std::string_view str)
 {
   u8 checksum = 0;
@@ -70,9 +173,13 @@ static std::optional<std::string_view> DeserializePacket(std::string_view in)
 
 static std::string SerializePacket(std::string_view in)
 {
-  std::stringstream ss;
-  ss << '$' << in << '#' << TinyString::from_format("{:02x}", ComputeChecksum(in));
-  return ss.str();
+  std::string ret;
+  ret.reserve(in.size() + 5);
+  ret.push_back('$');
+  ret.append(in);
+  ret.push_back('#');
+  ret.append(TinyString::from_format("{:02x}", ComputeChecksum(in)).view());
+  return ret;
 }
 
 /// List of GDB remote protocol registers for MIPS III (excluding FP).
@@ -173,57 +280,69 @@ static std::optional<std::string> Cmd$G(std::string_view data)
   return {""};
 }
 
+static bool WriteMemory(VirtualMemoryAddress address, const u8* data, u32 length)
+{
+  const PhysicalMemoryAddress phys_addr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  u8* ptr_data = GetMemoryPointer(phys_addr, length);
+  if (!ptr_data)
+    return false;
+
+  std::memcpy(ptr_data, data, length);
+  InvalidateCodeInRange(phys_addr, length);
+  return true;
+}
+
 /// Get memory.
 static std::optional<std::string> Cmd$m(std::string_view data)
 {
-  std::stringstream ss{std::string{data}};
-  std::string dataAddress, dataLength;
-
-  std::getline(ss, dataAddress, ',');
-  std::getline(ss, dataLength, '\0');
-
-  auto address = StringUtil::FromChars<VirtualMemoryAddress>(dataAddress, 16);
-  auto length = StringUtil::FromChars<u32>(dataLength, 16);
-
-  if (address && length)
+  VirtualMemoryAddress address;
+  u32 length;
+  if (ParseAddressAndLength(data, 0, &address, &length) && length <= (MAX_PACKET_SIZE / 2))
   {
-    PhysicalMemoryAddress phys_addr = *address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
-    u32 phys_length = *length;
-
-    u8* ptr_data = GetMemoryPointer(phys_addr, phys_length);
+    const PhysicalMemoryAddress phys_addr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+    const u8* ptr_data = GetMemoryPointer(phys_addr, length);
     if (ptr_data)
     {
-      return {StringUtil::EncodeHex(ptr_data, phys_length)};
+      std::string ret;
+      AppendHex(&ret, ptr_data, length);
+      return ret;
     }
   }
+
   return {"E00"};
 }
 
 /// Set memory.
 static std::optional<std::string> Cmd$M(std::string_view data)
 {
-  std::stringstream ss{std::string{data}};
-  std::string dataAddress, dataLength, dataPayload;
-
-  std::getline(ss, dataAddress, ',');
-  std::getline(ss, dataLength, ':');
-  std::getline(ss, dataPayload, '\0');
+  VirtualMemoryAddress address;
+  u32 length;
+  std::string_view hex_payload;
+  if (ParseAddressAndLength(data, ':', &address, &length, &hex_payload))
+  {
+    const std::optional<std::vector<u8>> payload = StringUtil::DecodeHex(hex_payload);
+    if (payload.has_value() && payload->size() == length && WriteMemory(address, payload->data(), length))
+      return {"OK"};
+  }
 
-  auto address = StringUtil::FromChars<VirtualMemoryAddress>(dataAddress, 16);
-  auto length = StringUtil::FromChars<u32>(dataLength, 16);
-  auto payload = StringUtil::DecodeHex(dataPayload);
+  return {"E00"};
+}
 
-  if (address && length && payload && (payload->size() == *length))
+/// Set memory, with a binary payload.
+static std::optional<std::string> Cmd$X(std::string_view data)
+{
+  VirtualMemoryAddress address;
+  u32 length;
+  std::string_view escaped_payload;
+  if (ParseAddressAndLength(data, ':', &address, &length, &escaped_payload))
   {
-    u32 phys_addr = *address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
-    u32 phys_length = *length;
+    // zero-length writes are used to check whether we support X
+    if (length == 0)
+      return {"OK"};
 
-    u8* ptr_data = GetMemoryPointer(phys_addr, phys_length);
-    if (ptr_data)
-    {
-      memcpy(ptr_data, payload->data(), phys_length);
+    const std::optional<std::vector<u8>> payload = UnescapeBinary(escaped_payload);
+    if (payload.has_value() && payload->size() == length && WriteMemory(address, payload->data(), length))
       return {"OK"};
-    }
   }
 
   return {"E00"};
@@ -266,7 +385,45 @@ static std::optional<std::string> Cmd$vMustReplyEmpty(std::string_view data)
 
 static std::optional<std::string> Cmd$qSupported(std::string_view data)
 {
-  return {""};
+  return {fmt::format("PacketSize={:x};qXfer:memory-map:read+", MAX_PACKET_SIZE)};
+}
+
+/// Describe memory regions, so GDB doesn't try to read unmapped addresses.
+static std::optional<std::string> Cmd$qXfer_memory_map_read(std::string_view data)
+{
+  // annex is empty, leaving "offset,length"
+  VirtualMemoryAddress offset;
+  u32 length;
+  if (!data.starts_with(':') || !ParseAddressAndLength(data.substr(1), 0, &offset, &length))
+    return {"E00"};
+
+  std::string xml = "<?xml version=\"1.0\"?>\n"
+                    "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" "
+                    "\"http://sourceware.org/gdb/gdb-memory-map.dtd\">\n"
+                    "<memory-map>\n";
+  for (const u32 segment : {0x00000000u, 0x80000000u, 0xA0000000u})
+  {
+    fmt::format_to(std::back_inserter(xml), "  <memory type=\"ram\" start=\"0x{:08x}\" length=\"0x{:x}\"/>\n",
+                   segment, Bus::g_ram_size);
+    if (segment != 0xA0000000u)
+    {
+      fmt::format_to(std::back_inserter(xml), "  <memory type=\"ram\" start=\"0x{:08x}\" length=\"0x{:x}\"/>\n",
+                     segment | CPU::SCRATCHPAD_ADDR, static_cast<u32>(CPU::SCRATCHPAD_SIZE));
+    }
+    fmt::format_to(std::back_inserter(xml), "  <memory type=\"rom\" start=\"0x{:08x}\" length=\"0x{:x}\"/>\n",
+                   segment | Bus::BIOS_BASE, static_cast<u32>(Bus::BIOS_SIZE));
+  }
+  xml += "</memory-map>\n";
+
+  // 'm' means there's more to come, 'l' that this is the last part
+  if (offset >= xml.size())
+    return {"l"};
+
+  const std::string_view part = std::string_view(xml).substr(offset, std::min<u32>(length, MAX_PACKET_SIZE / 2));
+  std::string ret;
+  ret.push_back(((offset + part.size()) >= xml.size()) ? 'l' : 'm');
+  AppendEscapedBinary(&ret, part);
+  return ret;
 }
 
 /// List of all GDB remote protocol packets supported by us.
@@ -276,17 +433,24 @@ static const std::map<const char*, std::function<std::optional<std::string>(std:
   {"G", Cmd$G},
   {"m", Cmd$m},
   {"M", Cmd$M},
+  {"X", Cmd$X},
   {"z0,", Cmd$z1},
   {"Z0,", Cmd$Z1},
   {"z1,", Cmd$z1},
   {"Z1,", Cmd$Z1},
   {"vMustReplyEmpty", Cmd$vMustReplyEmpty},
   {"qSupported", Cmd$qSupported},
+  {"qXfer:memory-map:read:", Cmd$qXfer_memory_map_read},
 };
 
 bool IsPacketInterrupt(std::string_view data)
 {
-  return (data.size() >= 1) && (data[data.size() - 1] == '\003');
+  // Binary payloads can contain 0x03, so it's only an interrupt outside of a packet.
+  if (data.empty() || data.back() != '\003')
+    return false;
+
+  const std::string_view::size_type start = data.find_first_not_of("+-");
+  return (start == std::string_view::npos || data[start] != '$');
 }
 
 bool IsPacketContinue(std::string_view data)
@@ -14,6 +14,7 @@
 #include "util/gpu_device.h"
 #include "util/image.h"
 #include "util/imgui_manager.h"
+#include "util/media_capture.h"
 #include "util/postprocessing.h"
 #include "util/shadergen.h"
 #include "util/state_wrapper.h"
@@ -28,9 +29,11 @@
 
 #include "IconsFontAwesome5.h"
 #include "fmt/format.h"
+#include "xxhash.h"
 
 #include <cmath>
 #include <thread>
+#include <utility>
 
 Log_SetChannel(GPU);
 
@@ -38,7 +41,7 @@ std::unique_ptr<GPU> g_gpu;
 alignas(HOST_PAGE_SIZE) u16 g_vram[VRAM_SIZE / sizeof(u16)];
 u16 g_gpu_clut[GPU_CLUT_SIZE];
 
-const GPU::GP0CommandHandlerTable GPU::s_GP0_command_handler_table = GPU::GenerateGP0CommandHandlerTable();
+const GPU::GP0CommandTable GPU::s_GP0_command_table = GPU::GenerateGP0CommandTable();
 
 static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string filename, FileSystem::ManagedCFilePtr fp,
                                           u8 quality, bool clear_alpha, bool flip_y, std::vector<u32> texture_data,
@@ -65,6 +68,7 @@ GPU::~GPU()
   JoinScreenshotThreads();
   DestroyDeinterlaceTextures();
   g_gpu_device->RecycleTexture(std::move(m_chroma_smoothing_texture));
+  g_gpu_device->RecycleTexture(std::move(m_display_cache_texture));
 
   if (g_gpu_device)
     g_gpu_device->SetGPUTimingEnabled(false);
@@ -93,7 +97,7 @@ bool GPU::Initialize()
     return false;
   }
 
-  g_gpu_device->SetGPUTimingEnabled(g_settings.display_show_gpu_usage);
+  g_gpu_device->SetGPUTimingEnabled(g_settings.display_show_gpu_usage || g_settings.gpu_dynamic_resolution);
 
 #ifdef PSX_GPU_STATS
   s_active_gpu_cycles = 0;
@@ -137,7 +141,7 @@ void GPU::UpdateSettings(const Settings& old_settings)
     }
   }
 
-  g_gpu_device->SetGPUTimingEnabled(g_settings.display_show_gpu_usage);
+  g_gpu_device->SetGPUTimingEnabled(g_settings.display_show_gpu_usage || g_settings.gpu_dynamic_resolution);
 }
 
 void GPU::CPUClockChanged()
@@ -149,6 +153,10 @@ void GPU::UpdateResolutionScale()
 {
 }
 
+void GPU::UpdateDynamicResolution(float average_gpu_time, float frame_time_budget)
+{
+}
+
 std::tuple<u32, u32> GPU::GetEffectiveDisplayResolution(bool scaled /* = true */)
 {
   return std::tie(m_crtc_state.display_vram_width, m_crtc_state.display_vram_height);
@@ -161,6 +169,8 @@ std::tuple<u32, u32> GPU::GetFullDisplayResolution(bool scaled /* = true */)
 
 void GPU::Reset(bool clear_vram)
 {
+  WaitForVRAMReadback();
+
   m_GPUSTAT.bits = 0x14802000;
   m_set_texture_disable_mask = false;
   m_GPUREAD_latch = 0;
@@ -190,6 +200,7 @@ void GPU::Reset(bool clear_vram)
 void GPU::SoftReset()
 {
   FlushRender();
+  WaitForVRAMReadback();
   if (m_blitter_state == BlitterState::WritingVRAM)
     FinishVRAMWrite();
 
@@ -235,9 +246,37 @@ void GPU::SoftReset()
   UpdateGPUIdle();
 }
 
+std::unique_ptr<GPUTexture> GPU::CreateVRAMSnapshotTexture()
+{
+  return {};
+}
+
+bool GPU::IsValidVRAMSnapshotTexture(const GPUTexture* tex) const
+{
+  return false;
+}
+
+void GPU::BeginSaveStateVRAMReadback()
+{
+  FlushRender();
+  WaitForVRAMReadback();
+  m_vram_readback_pending = BeginVRAMReadback(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  m_save_state_vram_readback = true;
+}
+
+void GPU::CancelSaveStateVRAMReadback()
+{
+  if (!m_save_state_vram_readback)
+    return;
+
+  WaitForVRAMReadback();
+  m_save_state_vram_readback = false;
+}
+
 bool GPU::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
   FlushRender();
+  WaitForVRAMReadback();
 
   if (sw.IsReading())
   {
@@ -362,7 +401,9 @@ bool GPU::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_displ
     }
     else
     {
-      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+      // WaitForVRAMReadback() above already completed it if it was started early.
+      if (!std::exchange(m_save_state_vram_readback, false))
+        ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
       sw.DoBytes(g_vram, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
     }
   }
@@ -475,8 +516,9 @@ u32 GPU::ReadRegister(u32 offset)
     case 0x04:
     {
       // code can be dependent on the odd/even bit, so update the GPU state when reading.
-      // we can mitigate this slightly by only updating when the raster is actually hitting a new line
-      if (IsCRTCScanlinePending())
+      // we can mitigate this slightly by only updating when the raster is actually hitting a new line, and only
+      // running the event when the new line changes more than the line bit.
+      if (IsCRTCScanlinePending() && !UpdatePendingDisplayLineLSB())
         SynchronizeCRTC();
       if (IsCommandCompletionPending())
         m_command_tick_event->InvokeEarly();
@@ -522,6 +564,37 @@ void GPU::DMARead(u32* words, u32 word_count)
     words[i] = ReadGPUREAD();
 }
 
+void GPU::DMAWriteRange(const u8* ram, u32 address, u32 word_count)
+{
+  // Fill the FIFO in runs of contiguous space, instead of going through Push() for every word.
+  while (word_count > 0)
+  {
+    const u32 count = std::min(word_count, m_fifo.GetContiguousSpace());
+    if (count == 0) [[unlikely]]
+    {
+      // Full, let Push() handle it the same way as a word-at-a-time transfer would.
+      for (; word_count > 0; word_count--, address += sizeof(u32))
+      {
+        u32 value;
+        std::memcpy(&value, &ram[address], sizeof(value));
+        DMAWrite(address, value);
+      }
+      return;
+    }
+
+    u64* dst = m_fifo.GetWritePointer();
+    for (u32 i = 0; i < count; i++, address += sizeof(u32))
+    {
+      u32 value;
+      std::memcpy(&value, &ram[address], sizeof(value));
+      dst[i] = (ZeroExtend64(address) << 32) | ZeroExtend64(value);
+    }
+
+    m_fifo.AdvanceTail(count);
+    word_count -= count;
+  }
+}
+
 void GPU::EndDMAWrite()
 {
   ExecuteCommands();
@@ -930,6 +1003,26 @@ bool GPU::IsCRTCScanlinePending() const
   return (ticks >= m_crtc_state.horizontal_total);
 }
 
+bool GPU::UpdatePendingDisplayLineLSB()
+{
+  const CRTCState& cs = m_crtc_state;
+  const u32 lines = static_cast<u32>((GetPendingCRTCTicks() + cs.current_tick_in_scanline) / cs.horizontal_total);
+  const u32 new_scanline = cs.current_scanline + lines;
+
+  // the field flips at the end of the frame, and interlaced mode depends on vblank
+  if (new_scanline >= cs.vertical_total)
+    return false;
+
+  if (m_GPUSTAT.InInterleaved480iMode())
+  {
+    return !((cs.current_scanline < cs.vertical_display_start && new_scanline >= cs.vertical_display_start) ||
+             (cs.current_scanline < cs.vertical_display_end && new_scanline >= cs.vertical_display_end));
+  }
+
+  m_GPUSTAT.display_line_lsb = ConvertToBoolUnchecked((cs.regs.Y + new_scanline) & u32(1));
+  return true;
+}
+
 bool GPU::IsCommandCompletionPending() const
 {
   return (m_pending_command_ticks > 0 && GetPendingCommandTicks() >= m_pending_command_ticks);
@@ -1021,7 +1114,8 @@ void GPU::CRTCTickEvent(TickCount ticks)
         // flush any pending draws and "scan out" the image
         // TODO: move present in here I guess
         FlushRender();
-        UpdateDisplay();
+        if (!System::IsSkippingFrame())
+          UpdateDisplay();
         TimingEvents::SetFrameDone();
 
         // switch fields early. this is needed so we draw to the correct one.
@@ -1191,6 +1285,8 @@ u32 GPU::ReadGPUREAD()
   if (m_blitter_state != BlitterState::ReadingVRAM)
     return m_GPUREAD_latch;
 
+  WaitForVRAMReadback();
+
   // Read two pixels out of VRAM and combine them. Zero fill odd pixel counts.
   u32 value = 0;
   for (u32 i = 0; i < 2; i++)
@@ -1246,6 +1342,7 @@ void GPU::WriteGP1(u32 value)
       if (m_blitter_state == BlitterState::WritingVRAM)
         FinishVRAMWrite();
 
+      WaitForVRAMReadback();
       m_blitter_state = BlitterState::Idle;
       m_command_total_words = 0;
       m_vram_transfer = {};
@@ -1493,6 +1590,16 @@ void GPU::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
 }
 
+bool GPU::BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height)
+{
+  ReadVRAM(x, y, width, height);
+  return false;
+}
+
+void GPU::FinishVRAMReadback()
+{
+}
+
 void GPU::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
   const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
@@ -1783,6 +1890,21 @@ bool GPU::CompileDisplayPipelines(bool display, bool deinterlace, bool chroma_sm
       return false;
     GL_OBJECT_NAME_FMT(m_display_pipeline, "Display Pipeline [{}]",
                        Settings::GetDisplayScalingName(g_settings.display_scaling));
+
+    std::unique_ptr<GPUShader> copy_vso =
+      g_gpu_device->CreateShader(GPUShaderStage::Vertex, shadergen.GenerateScreenQuadVertexShader());
+    std::unique_ptr<GPUShader> copy_fso =
+      g_gpu_device->CreateShader(GPUShaderStage::Fragment, shadergen.GenerateCopyFragmentShader());
+    if (!copy_vso || !copy_fso)
+      return false;
+    GL_OBJECT_NAME(copy_vso, "Display Cache Copy Vertex Shader");
+    GL_OBJECT_NAME(copy_fso, "Display Cache Copy Fragment Shader");
+
+    plconfig.vertex_shader = copy_vso.get();
+    plconfig.fragment_shader = copy_fso.get();
+    if (!(m_display_cache_copy_pipeline = g_gpu_device->CreatePipeline(plconfig)))
+      return false;
+    GL_OBJECT_NAME(m_display_cache_copy_pipeline, "Display Cache Copy Pipeline");
   }
 
   if (deinterlace)
@@ -1951,20 +2073,83 @@ void GPU::SetDisplayParameters(s32 display_width, s32 display_height, s32 active
 
 bool GPU::PresentDisplay()
 {
-  FlushRender();
+  SyncRenderThread();
+
+  // Only the first present of an unchanged frame can reuse the cache, presents while paused are rendered in full.
+  const bool frame_unchanged = std::exchange(m_display_frame_unchanged, false);
 
   if (!HasDisplayTexture())
     return g_gpu_device->BeginPresent(false);
 
   const Common::Rectangle<s32> draw_rect =
     CalculateDrawRect(g_gpu_device->GetWindowWidth(), g_gpu_device->GetWindowHeight());
+  if (g_settings.display_skip_unchanged_frames && PostProcessing::IsActive())
+    return PresentCachedDisplay(draw_rect, frame_unchanged);
+
   return RenderDisplay(nullptr, draw_rect, true);
 }
 
+bool GPU::PresentCachedDisplay(const Common::Rectangle<s32>& draw_rect, bool frame_unchanged)
+{
+  const GPUTexture::Format format = g_gpu_device->GetWindowFormat();
+  const u32 width = g_gpu_device->GetWindowWidth();
+  const u32 height = g_gpu_device->GetWindowHeight();
+  if (format == GPUTexture::Format::Unknown || width == 0 || height == 0)
+    return RenderDisplay(nullptr, draw_rect, true);
+
+  // Post-processing is only run again when the frame, where it's drawn, or the chain has changed. Shaders which
+  // animate over time will stop moving while the display is unchanged.
+  const u32 postfx_generation = PostProcessing::GetGeneration();
+  if (!frame_unchanged || !m_display_cache_texture || m_display_cache_texture->GetWidth() != width ||
+      m_display_cache_texture->GetHeight() != height || m_display_cache_texture->GetFormat() != format ||
+      m_display_cache_draw_rect != draw_rect || m_display_cache_postfx_generation != postfx_generation)
+  {
+    if (!m_display_cache_texture || m_display_cache_texture->GetWidth() != width ||
+        m_display_cache_texture->GetHeight() != height || m_display_cache_texture->GetFormat() != format)
+    {
+      g_gpu_device->RecycleTexture(std::move(m_display_cache_texture));
+      if (!(m_display_cache_texture =
+              g_gpu_device->FetchTexture(width, height, 1, 1, 1, GPUTexture::Type::RenderTarget, format)))
+      {
+        return RenderDisplay(nullptr, draw_rect, true);
+      }
+    }
+
+    g_gpu_device->ClearRenderTarget(m_display_cache_texture.get(), 0);
+    if (!RenderDisplay(m_display_cache_texture.get(), draw_rect, true))
+    {
+      g_gpu_device->RecycleTexture(std::move(m_display_cache_texture));
+      return false;
+    }
+
+    m_display_cache_draw_rect = draw_rect;
+    m_display_cache_postfx_generation = PostProcessing::GetGeneration();
+  }
+  else
+  {
+    GL_INS("Reusing post-processed output of unchanged frame");
+  }
+
+  if (!g_gpu_device->BeginPresent(false))
+    return false;
+
+  SetTimingRegion(GPUTimingRegion::Display);
+  m_display_cache_texture->MakeReadyForSampling();
+  g_gpu_device->SetPipeline(m_display_cache_copy_pipeline.get());
+  g_gpu_device->SetTextureSampler(0, m_display_cache_texture.get(), g_gpu_device->GetNearestSampler());
+
+  static constexpr float uniforms[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+  g_gpu_device->PushUniformBuffer(uniforms, sizeof(uniforms));
+  g_gpu_device->SetViewportAndScissor(0, 0, width, height);
+  g_gpu_device->Draw(3, 0);
+  return true;
+}
+
 bool GPU::RenderDisplay(GPUTexture* target, const Common::Rectangle<s32>& draw_rect, bool postfx)
 {
   GL_SCOPE_FMT("RenderDisplay: {}x{} at {},{}", draw_rect.left, draw_rect.top, draw_rect.GetWidth(),
                draw_rect.GetHeight());
+  SetTimingRegion(GPUTimingRegion::Display);
 
   if (m_display_texture)
     m_display_texture->MakeReadyForSampling();
@@ -2064,6 +2249,7 @@ bool GPU::RenderDisplay(GPUTexture* target, const Common::Rectangle<s32>& draw_r
 
   if (really_postfx)
   {
+    SetTimingRegion(GPUTimingRegion::PostProcessing);
     return PostProcessing::Apply(target, real_draw_rect.left, real_draw_rect.top, real_draw_rect.GetWidth(),
                                  real_draw_rect.GetHeight(), m_display_texture_view_width,
                                  m_display_texture_view_height);
@@ -2527,7 +2713,7 @@ void JoinScreenshotThreads()
   }
 }
 
-bool GPU::WriteDisplayTextureToFile(std::string filename, bool compress_on_thread /* = false */)
+bool GPU::ReadDisplayTexture(u32* width, u32* height, std::vector<u32>* data, u32* stride)
 {
   if (!m_display_texture)
     return false;
@@ -2539,7 +2725,8 @@ bool GPU::WriteDisplayTextureToFile(std::string filename, bool compress_on_threa
 
   const u32 texture_data_stride =
     Common::AlignUpPow2(GPUTexture::GetPixelSize(m_display_texture->GetFormat()) * read_width, 4);
-  std::vector<u32> texture_data((texture_data_stride * read_height) / sizeof(u32));
+  std::vector<u32>& texture_data = *data;
+  texture_data.resize((texture_data_stride * read_height) / sizeof(u32));
 
   std::unique_ptr<GPUDownloadTexture> dltex;
   if (g_gpu_device->GetFeatures().memory_import)
@@ -2567,6 +2754,19 @@ bool GPU::WriteDisplayTextureToFile(std::string filename, bool compress_on_threa
 
   RestoreDeviceContext();
 
+  *width = read_width;
+  *height = read_height;
+  *stride = texture_data_stride;
+  return true;
+}
+
+bool GPU::WriteDisplayTextureToFile(std::string filename, bool compress_on_thread /* = false */)
+{
+  u32 read_width, read_height, texture_data_stride;
+  std::vector<u32> texture_data;
+  if (!ReadDisplayTexture(&read_width, &read_height, &texture_data, &texture_data_stride))
+    return false;
+
   auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "wb");
   if (!fp)
   {
@@ -2582,6 +2782,27 @@ bool GPU::WriteDisplayTextureToFile(std::string filename, bool compress_on_threa
     flip_y, std::move(texture_data), texture_data_stride, m_display_texture->GetFormat(), false, compress_on_thread);
 }
 
+bool GPU::GetDisplayTextureHash(u64* hash)
+{
+  u32 width, height, stride;
+  std::vector<u32> texture_data;
+  if (!ReadDisplayTexture(&width, &height, &texture_data, &stride))
+    return false;
+
+  // rows can be padded, only hash the pixels
+  const u32 row_size = GPUTexture::GetPixelSize(m_display_texture->GetFormat()) * width;
+  const u8* row_ptr = reinterpret_cast<const u8*>(texture_data.data());
+  XXH3_state_t* state = XXH3_createState();
+  XXH3_64bits_reset(state);
+  XXH3_64bits_update(state, &width, sizeof(width));
+  XXH3_64bits_update(state, &height, sizeof(height));
+  for (u32 row = 0; row < height; row++, row_ptr += stride)
+    XXH3_64bits_update(state, row_ptr, row_size);
+  *hash = XXH3_64bits_digest(state);
+  XXH3_freeState(state);
+  return true;
+}
+
 bool GPU::RenderScreenshotToBuffer(u32 width, u32 height, const Common::Rectangle<s32>& draw_rect, bool postfx,
                                    std::vector<u32>* out_pixels, u32* out_stride, GPUTexture::Format* out_format)
 {
@@ -2629,20 +2850,20 @@ bool GPU::RenderScreenshotToBuffer(u32 width, u32 height, const Common::Rectangl
   return true;
 }
 
-bool GPU::RenderScreenshotToFile(std::string filename, DisplayScreenshotMode mode, u8 quality, bool compress_on_thread,
-                                 bool show_osd_message)
+void GPU::CalculateScreenshotSize(DisplayScreenshotMode mode, u32* width, u32* height,
+                                  Common::Rectangle<s32>* draw_rect, bool* internal_resolution) const
 {
-  u32 width = g_gpu_device->GetWindowWidth();
-  u32 height = g_gpu_device->GetWindowHeight();
-  Common::Rectangle<s32> draw_rect = CalculateDrawRect(width, height);
+  *width = g_gpu_device->GetWindowWidth();
+  *height = g_gpu_device->GetWindowHeight();
+  *draw_rect = CalculateDrawRect(*width, *height);
 
-  const bool internal_resolution = (mode != DisplayScreenshotMode::ScreenResolution);
-  if (internal_resolution && m_display_texture_view_width != 0 && m_display_texture_view_height != 0)
+  *internal_resolution = (mode != DisplayScreenshotMode::ScreenResolution);
+  if (*internal_resolution && m_display_texture_view_width != 0 && m_display_texture_view_height != 0)
   {
     if (mode == DisplayScreenshotMode::InternalResolution)
     {
-      const u32 draw_width = static_cast<u32>(draw_rect.GetWidth());
-      const u32 draw_height = static_cast<u32>(draw_rect.GetHeight());
+      const u32 draw_width = static_cast<u32>(draw_rect->GetWidth());
+      const u32 draw_height = static_cast<u32>(draw_rect->GetHeight());
 
       // If internal res, scale the computed draw rectangle to the internal res.
       // We re-use the draw rect because it's already been AR corrected.
@@ -2653,41 +2874,50 @@ bool GPU::RenderScreenshotToFile(std::string filename, DisplayScreenshotMode mod
       {
         // stretch height, preserve width
         const float scale = static_cast<float>(m_display_texture_view_width) / static_cast<float>(draw_width);
-        width = m_display_texture_view_width;
-        height = static_cast<u32>(std::round(static_cast<float>(draw_height) * scale));
+        *width = m_display_texture_view_width;
+        *height = static_cast<u32>(std::round(static_cast<float>(draw_height) * scale));
       }
       else
       {
         // stretch width, preserve height
         const float scale = static_cast<float>(m_display_texture_view_height) / static_cast<float>(draw_height);
-        width = static_cast<u32>(std::round(static_cast<float>(draw_width) * scale));
-        height = m_display_texture_view_height;
+        *width = static_cast<u32>(std::round(static_cast<float>(draw_width) * scale));
+        *height = m_display_texture_view_height;
       }
 
       // DX11 won't go past 16K texture size.
       const u32 max_texture_size = g_gpu_device->GetMaxTextureSize();
-      if (width > max_texture_size)
+      if (*width > max_texture_size)
       {
-        height = static_cast<u32>(static_cast<float>(height) /
-                                  (static_cast<float>(width) / static_cast<float>(max_texture_size)));
-        width = max_texture_size;
+        *height = static_cast<u32>(static_cast<float>(*height) /
+                                   (static_cast<float>(*width) / static_cast<float>(max_texture_size)));
+        *width = max_texture_size;
       }
-      if (height > max_texture_size)
+      if (*height > max_texture_size)
       {
-        height = max_texture_size;
-        width = static_cast<u32>(static_cast<float>(width) /
-                                 (static_cast<float>(height) / static_cast<float>(max_texture_size)));
+        *height = max_texture_size;
+        *width = static_cast<u32>(static_cast<float>(*width) /
+                                  (static_cast<float>(*height) / static_cast<float>(max_texture_size)));
       }
     }
     else // if (mode == DisplayScreenshotMode::UncorrectedInternalResolution)
     {
-      width = m_display_texture_view_width;
-      height = m_display_texture_view_height;
+      *width = m_display_texture_view_width;
+      *height = m_display_texture_view_height;
     }
 
     // Remove padding, it's not part of the framebuffer.
-    draw_rect.Set(0, 0, static_cast<s32>(width), static_cast<s32>(height));
+    draw_rect->Set(0, 0, static_cast<s32>(*width), static_cast<s32>(*height));
   }
+}
+
+bool GPU::RenderScreenshotToFile(std::string filename, DisplayScreenshotMode mode, u8 quality, bool compress_on_thread,
+                                 bool show_osd_message)
+{
+  u32 width, height;
+  Common::Rectangle<s32> draw_rect;
+  bool internal_resolution;
+  CalculateScreenshotSize(mode, &width, &height, &draw_rect, &internal_resolution);
   if (width == 0 || height == 0)
     return false;
 
@@ -2714,6 +2944,85 @@ bool GPU::RenderScreenshotToFile(std::string filename, DisplayScreenshotMode mod
                                        pixels_format, show_osd_message, compress_on_thread);
 }
 
+bool GPU::SendDisplayToMediaCapture(MediaCapture* cap, bool postfx)
+{
+  const u32 width = cap->GetVideoWidth();
+  const u32 height = cap->GetVideoHeight();
+  const GPUTexture::Format hdformat =
+    g_gpu_device->HasSurface() ? g_gpu_device->GetWindowFormat() : GPUTexture::Format::RGBA8;
+
+  auto render_texture =
+    g_gpu_device->FetchAutoRecycleTexture(width, height, 1, 1, 1, GPUTexture::Type::RenderTarget, hdformat);
+  if (!render_texture)
+    return false;
+
+  g_gpu_device->ClearRenderTarget(render_texture.get(), 0);
+  RenderDisplay(render_texture.get(), CalculateDrawRect(width, height), postfx);
+
+  // The oldest frame was queued several frames ago, so its copy has long since completed.
+  if (m_media_capture_pending == MEDIA_CAPTURE_READBACK_FRAMES && !SendOldestMediaCaptureFrame(cap))
+  {
+    RestoreDeviceContext();
+    return false;
+  }
+
+  std::unique_ptr<GPUDownloadTexture>& dltex = m_media_capture_textures[m_media_capture_write_pos];
+  if (!dltex || dltex->GetWidth() != width || dltex->GetHeight() != height || dltex->GetFormat() != hdformat)
+  {
+    dltex.reset();
+    if (!(dltex = g_gpu_device->CreateDownloadTexture(width, height, hdformat)))
+    {
+      Log_ErrorFmt("Failed to create {}x{} download texture", width, height);
+      RestoreDeviceContext();
+      return false;
+    }
+  }
+
+  dltex->CopyFromTexture(0, 0, render_texture.get(), 0, 0, width, height, 0, 0, true);
+  m_media_capture_write_pos = (m_media_capture_write_pos + 1) % MEDIA_CAPTURE_READBACK_FRAMES;
+  m_media_capture_pending++;
+
+  RestoreDeviceContext();
+  return true;
+}
+
+bool GPU::SendOldestMediaCaptureFrame(MediaCapture* cap)
+{
+  DebugAssert(m_media_capture_pending > 0);
+  const u32 index = (m_media_capture_write_pos + MEDIA_CAPTURE_READBACK_FRAMES - m_media_capture_pending) %
+                    MEDIA_CAPTURE_READBACK_FRAMES;
+  m_media_capture_pending--;
+
+  GPUDownloadTexture* dltex = m_media_capture_textures[index].get();
+  const u32 width = dltex->GetWidth();
+  const u32 height = dltex->GetHeight();
+  const u32 stride = Common::AlignUpPow2(GPUTexture::GetPixelSize(dltex->GetFormat()) * width, sizeof(u32));
+
+  std::vector<u32> pixels = cap->GetVideoFrameBuffer();
+  pixels.resize((height * stride) / sizeof(u32));
+  if (!dltex->ReadTexels(0, 0, width, height, pixels.data(), stride))
+  {
+    Log_ErrorFmt("Failed to read back {}x{} capture frame", width, height);
+    return false;
+  }
+
+  return cap->DeliverVideoFrame(std::move(pixels), stride, dltex->GetFormat());
+}
+
+bool GPU::FlushMediaCapture(MediaCapture* cap)
+{
+  bool result = true;
+  while (m_media_capture_pending > 0)
+    result = SendOldestMediaCaptureFrame(cap) && result;
+
+  for (std::unique_ptr<GPUDownloadTexture>& dltex : m_media_capture_textures)
+    dltex.reset();
+  m_media_capture_write_pos = 0;
+
+  RestoreDeviceContext();
+  return result;
+}
+
 bool GPU::DumpVRAMToFile(const char* filename)
 {
   ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
@@ -2758,6 +3067,20 @@ bool GPU::DumpVRAMToFile(const char* filename, u32 width, u32 height, u32 stride
   return image.SaveToFile(filename);
 }
 
+static_assert(static_cast<u32>(GPUTimingRegion::Count) <= GPUDevice::MAX_GPU_TIMING_REGIONS);
+
+void GPU::SetTimingRegion(GPUTimingRegion region)
+{
+  g_gpu_device->SetGPUTimingRegion(static_cast<u32>(region));
+}
+
+const char* GPU::GetTimingRegionName(GPUTimingRegion region)
+{
+  static constexpr const std::array<const char*, static_cast<size_t>(GPUTimingRegion::Count)> names = {
+    {"Other", "Draw", "Copy/Fill", "Readback", "Downsample", "Display", "Post-Processing", "ImGui"}};
+  return names[static_cast<size_t>(region)];
+}
+
 void GPU::DrawDebugStateWindow()
 {
   const float framebuffer_scale = Host::GetOSDScale();
@@ -2771,6 +3094,16 @@ void GPU::DrawDebugStateWindow()
 
   DrawRendererStats();
 
+  if (g_gpu_device->IsGPUTimingRegionsEnabled() &&
+      ImGui::CollapsingHeader("GPU Timing", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    for (u32 i = 0; i < static_cast<u32>(GPUTimingRegion::Count); i++)
+    {
+      const GPUTimingRegion region = static_cast<GPUTimingRegion>(i);
+      ImGui::Text("%s: %.3f ms", GetTimingRegionName(region), System::GetGPUTimingRegionAverageTime(region));
+    }
+  }
+
   if (ImGui::CollapsingHeader("GPU", ImGuiTreeNodeFlags_DefaultOpen))
   {
     static constexpr std::array<const char*, 5> state_strings = {
@@ -2835,10 +3168,12 @@ void GPU::GetStatsString(SmallStringBase& str)
 {
   if (IsHardwareRenderer())
   {
-    str.format("{} HW | {} P | {} DC | {} B | {} RP | {} RB | {} C | {} W",
+    str.format("{} HW | {} P | {} DC | {} B | {} RP | {} RB | {} C | {} W ({} KB, {} M) | {} RTU",
                GPUDevice::RenderAPIToString(g_gpu_device->GetRenderAPI()), m_stats.num_primitives,
                m_stats.host_num_draws, m_stats.host_num_barriers, m_stats.host_num_render_passes,
-               m_stats.host_num_downloads, m_stats.num_copies, m_stats.num_writes);
+               m_stats.host_num_downloads, m_stats.num_copies, m_stats.num_writes,
+               (m_stats.num_write_bytes + (1024 - 1)) / 1024, m_stats.num_merged_writes,
+               m_stats.num_read_texture_updates);
   }
   else
   {
@@ -2875,8 +3210,10 @@ void GPU::UpdateStatistics(u32 frame_count)
   UPDATE_COUNTER(num_copies);
   UPDATE_COUNTER(num_vertices);
   UPDATE_COUNTER(num_primitives);
+  UPDATE_COUNTER(num_write_bytes);
+  UPDATE_COUNTER(num_merged_writes);
+  UPDATE_COUNTER(num_read_texture_updates);
 
-  // UPDATE_COUNTER(num_read_texture_updates);
   // UPDATE_COUNTER(num_ubo_updates);
 
   UPDATE_GPU_STAT(buffer_streamed);
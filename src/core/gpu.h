@@ -28,6 +28,7 @@ class StateWrapper;
 class GPUDevice;
 class GPUTexture;
 class GPUPipeline;
+class MediaCapture;
 
 struct Settings;
 class TimingEvent;
@@ -62,6 +63,7 @@ public:
     HBLANK_TIMER_INDEX = 1,
     MAX_RESOLUTION_SCALE = 32,
     DEINTERLACE_BUFFER_COUNT = 4,
+    MEDIA_CAPTURE_READBACK_FRAMES = 4,
     DRAWING_AREA_COORD_MASK = 1023,
   };
 
@@ -96,6 +98,19 @@ public:
   virtual void Reset(bool clear_vram);
   virtual bool DoState(StateWrapper& sw, GPUTexture** save_to_texture, bool update_display);
 
+  /// Starts downloading all of VRAM for a save state, so it's in flight while the CPU and RAM are serialized. The next
+  /// DoState() which writes VRAM to the state waits for it instead of reading back again.
+  void BeginSaveStateVRAMReadback();
+
+  /// Drops the readback started by BeginSaveStateVRAMReadback(), if DoState() didn't use it.
+  void CancelSaveStateVRAMReadback();
+
+  /// Creates a texture which can hold a copy of VRAM for memory save states, or null if VRAM isn't on the host GPU.
+  virtual std::unique_ptr<GPUTexture> CreateVRAMSnapshotTexture();
+
+  /// Returns true if the texture can hold a VRAM snapshot at the current resolution.
+  virtual bool IsValidVRAMSnapshotTexture(const GPUTexture* tex) const;
+
   // Graphics API state reset/restore - call when drawing the UI etc.
   // TODO: replace with "invalidate cached state"
   virtual void RestoreDeviceContext();
@@ -105,7 +120,11 @@ public:
   void GetStatsString(SmallStringBase& str);
   void GetMemoryStatsString(SmallStringBase& str);
   void ResetStatistics();
-  void UpdateStatistics(u32 frame_count);
+  virtual void UpdateStatistics(u32 frame_count);
+
+  /// Attributes GPU time from this point onwards to the specified part of the frame.
+  static void SetTimingRegion(GPUTimingRegion region);
+  static const char* GetTimingRegionName(GPUTimingRegion region);
 
   void CPUClockChanged();
 
@@ -121,6 +140,7 @@ public:
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
   }
+  void DMAWriteRange(const u8* ram, u32 address, u32 word_count);
   void EndDMAWrite();
 
   /// Returns true if no data is being sent from VRAM to the DAC or that no portion of VRAM would be visible on screen.
@@ -163,6 +183,9 @@ public:
   /// Updates the resolution scale when it's set to automatic.
   virtual void UpdateResolutionScale();
 
+  /// Adjusts the internal resolution to the average GPU time per frame, when dynamic resolution is enabled.
+  virtual void UpdateDynamicResolution(float average_gpu_time, float frame_time_budget);
+
   /// Returns the effective display resolution of the GPU.
   virtual std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true);
 
@@ -176,6 +199,9 @@ public:
   static std::unique_ptr<GPU> CreateHardwareRenderer();
   static std::unique_ptr<GPU> CreateSoftwareRenderer();
 
+  // Discards all drawing, for when there is no video to show.
+  static std::unique_ptr<GPU> CreateNullRenderer();
+
   // Converts window coordinates into horizontal ticks and scanlines. Returns false if out of range. Used for lightguns.
   void ConvertScreenCoordinatesToDisplayCoordinates(float window_x, float window_y, float* display_x,
                                                     float* display_y) const;
@@ -202,18 +228,28 @@ public:
   // Ensures all buffered vertices are drawn.
   virtual void FlushRender() = 0;
 
+  // Waits for the render thread to consume all queued commands, so the host device can be used by the caller.
+  virtual void SyncRenderThread() { FlushRender(); }
+
   ALWAYS_INLINE const void* GetDisplayTextureHandle() const { return m_display_texture; }
   ALWAYS_INLINE s32 GetDisplayWidth() const { return m_display_width; }
   ALWAYS_INLINE s32 GetDisplayHeight() const { return m_display_height; }
   ALWAYS_INLINE float GetDisplayAspectRatio() const { return m_display_aspect_ratio; }
   ALWAYS_INLINE bool HasDisplayTexture() const { return static_cast<bool>(m_display_texture); }
 
+  /// Returns true if the last frame scanned out is identical to the one before it, and will only be true until the
+  /// frame is presented.
+  ALWAYS_INLINE bool IsDisplayFrameUnchanged() const { return m_display_frame_unchanged; }
+
   /// Helper function for computing the draw rectangle in a larger window.
   Common::Rectangle<s32> CalculateDrawRect(s32 window_width, s32 window_height, bool apply_aspect_ratio = true) const;
 
   /// Helper function to save current display texture to PNG.
   bool WriteDisplayTextureToFile(std::string filename, bool compress_on_thread = false);
 
+  /// Hashes the contents of the current display texture, for comparing frames between runs.
+  bool GetDisplayTextureHash(u64* hash);
+
   /// Renders the display, optionally with postprocessing to the specified image.
   bool RenderScreenshotToBuffer(u32 width, u32 height, const Common::Rectangle<s32>& draw_rect, bool postfx,
                                 std::vector<u32>* out_pixels, u32* out_stride, GPUTexture::Format* out_format);
@@ -222,6 +258,18 @@ public:
   bool RenderScreenshotToFile(std::string filename, DisplayScreenshotMode mode, u8 quality, bool compress_on_thread,
                               bool show_osd_message);
 
+  /// Computes the size of a screenshot or capture in the specified mode, and where the display is drawn within it.
+  /// internal_resolution is set if post-processing should not be applied.
+  void CalculateScreenshotSize(DisplayScreenshotMode mode, u32* width, u32* height, Common::Rectangle<s32>* draw_rect,
+                               bool* internal_resolution) const;
+
+  /// Renders the display at the capture's size, and queues a readback. Frames are sent to the capture when a later
+  /// frame needs their readback slot, by which point the copy has completed, so the GPU is never waited on.
+  bool SendDisplayToMediaCapture(MediaCapture* cap, bool postfx);
+
+  /// Sends any frames which are still being read back to the capture, and releases the readback textures.
+  bool FlushMediaCapture(MediaCapture* cap);
+
   /// Draws the current display texture, with any post-processing.
   bool PresentDisplay();
 
@@ -229,6 +277,12 @@ public:
   static void ReadCLUT(u16* dest, GPUTexturePaletteReg reg, bool clut_is_8bit);
 
 protected:
+  /// Downloads the visible region of the display texture.
+  bool ReadDisplayTexture(u32* width, u32* height, std::vector<u32>* data, u32* stride);
+
+  /// Reads back the oldest frame queued for media capture, and sends it to the capture.
+  bool SendOldestMediaCaptureFrame(MediaCapture* cap);
+
   TickCount CRTCTicksToSystemTicks(TickCount crtc_ticks, TickCount fractional_ticks) const;
   TickCount SystemTicksToCRTCTicks(TickCount sysclk_ticks, TickCount* fractional_ticks) const;
 
@@ -263,6 +317,10 @@ protected:
   void UpdateCRTCTickEvent();
   void UpdateCommandTickEvent();
 
+  /// Updates the line bit in GPUSTAT from the pending ticks, without running the CRTC event. Returns false if a field
+  /// or vblank change is pending, in which case the event must be run instead.
+  bool UpdatePendingDisplayLineLSB();
+
   // Updates dynamic bits in GPUSTAT (ready to send VRAM/ready to receive DMA)
   void UpdateDMARequest();
   void UpdateGPUIdle();
@@ -312,8 +370,23 @@ protected:
   void UpdateCLUTIfNeeded(GPUTextureMode texmode, GPUTexturePaletteReg clut);
   void InvalidateCLUT();
 
+  /// Waits for the readback started by a VRAM->CPU transfer, if it hasn't completed yet.
+  ALWAYS_INLINE void WaitForVRAMReadback()
+  {
+    if (m_vram_readback_pending) [[unlikely]]
+    {
+      m_vram_readback_pending = false;
+      FinishVRAMReadback();
+    }
+  }
+
   // Rendering in the backend
   virtual void ReadVRAM(u32 x, u32 y, u32 width, u32 height);
+
+  /// Starts reading back the region of a VRAM->CPU transfer. Returns true if the readback is still in progress, in
+  /// which case the region of g_vram is only valid after FinishVRAMReadback(). Defaults to a synchronous ReadVRAM().
+  virtual bool BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height);
+  virtual void FinishVRAMReadback();
   virtual void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color);
   virtual void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask);
   virtual void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height);
@@ -582,6 +655,12 @@ protected:
   /// True if currently executing/syncing.
   bool m_executing_commands = false;
 
+  /// True if the data for the current VRAM->CPU transfer is still being read back.
+  bool m_vram_readback_pending = false;
+
+  /// True if the pending readback covers all of VRAM for a save state.
+  bool m_save_state_vram_readback = false;
+
   struct VRAMTransfer
   {
     u16 x;
@@ -615,6 +694,7 @@ protected:
                                              bool apply_aspect_ratio = true) const;
 
   bool RenderDisplay(GPUTexture* target, const Common::Rectangle<s32>& draw_rect, bool postfx);
+  bool PresentCachedDisplay(const Common::Rectangle<s32>& draw_rect, bool frame_unchanged);
 
   bool Deinterlace(GPUTexture* src, u32 x, u32 y, u32 width, u32 height, u32 field, u32 line_skip);
   bool DeinterlaceExtractField(u32 dst_bufidx, GPUTexture* src, u32 x, u32 y, u32 width, u32 height, u32 line_skip);
@@ -646,6 +726,17 @@ protected:
   s32 m_display_texture_view_width = 0;
   s32 m_display_texture_view_height = 0;
 
+  // Post-processed output of the last presented frame, re-presented as-is while the display doesn't change.
+  std::unique_ptr<GPUPipeline> m_display_cache_copy_pipeline;
+  std::unique_ptr<GPUTexture> m_display_cache_texture;
+  Common::Rectangle<s32> m_display_cache_draw_rect;
+  u32 m_display_cache_postfx_generation = 0;
+  bool m_display_frame_unchanged = false;
+
+  std::array<std::unique_ptr<GPUDownloadTexture>, MEDIA_CAPTURE_READBACK_FRAMES> m_media_capture_textures;
+  u32 m_media_capture_write_pos = 0;
+  u32 m_media_capture_pending = 0;
+
   struct Counters
   {
     u32 num_reads;
@@ -653,8 +744,10 @@ protected:
     u32 num_copies;
     u32 num_vertices;
     u32 num_primitives;
+    u32 num_write_bytes;
+    u32 num_merged_writes;
+    u32 num_read_texture_updates;
 
-    // u32 num_read_texture_updates;
     // u32 num_ubo_updates;
   };
 
@@ -676,8 +769,21 @@ private:
   bool CompileDisplayPipelines(bool display, bool deinterlace, bool chroma_smoothing);
 
   using GP0CommandHandler = bool (GPU::*)();
-  using GP0CommandHandlerTable = std::array<GP0CommandHandler, 256>;
-  static GP0CommandHandlerTable GenerateGP0CommandHandlerTable();
+  struct GP0CommandInfo
+  {
+    GP0CommandHandler handler;
+
+    /// Words which must be in the FIFO before the handler is called. Only the first vertices for polylines.
+    u32 num_words;
+  };
+  using GP0CommandTable = std::array<GP0CommandInfo, 256>;
+  static GP0CommandTable GenerateGP0CommandTable();
+
+  /// Moves words from the FIFO to the blit buffer, a contiguous run at a time.
+  void FifoPopToBlitBuffer(u32 count);
+
+  /// Returns the index of the polyline terminator in the FIFO, or the FIFO size if it hasn't arrived yet.
+  u32 FindPolyLineTerminator(u32 start_index, u32 words_per_vertex) const;
 
   // Rendering commands, returns false if not enough data is provided
   bool HandleUnknownGP0Command();
@@ -699,7 +805,7 @@ private:
   bool HandleCopyRectangleVRAMToCPUCommand();
   bool HandleCopyRectangleVRAMToVRAMCommand();
 
-  static const GP0CommandHandlerTable s_GP0_command_handler_table;
+  static const GP0CommandTable s_GP0_command_table;
 };
 
 extern std::unique_ptr<GPU> g_gpu;
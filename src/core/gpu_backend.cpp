@@ -3,10 +3,16 @@
 
 #include "gpu_backend.h"
 #include "common/align.h"
+#include "common/intrin.h"
 #include "common/log.h"
 #include "common/timer.h"
+#include "common/trace.h"
 #include "settings.h"
+#include "system.h"
 #include "util/state_wrapper.h"
+
+#include <algorithm>
+
 Log_SetChannel(GPUBackend);
 
 std::unique_ptr<GPUBackend> g_gpu_backend;
@@ -103,45 +109,61 @@ GPUBackendDrawLineCommand* GPUBackend::NewDrawLineCommand(u32 num_vertices)
   return cmd;
 }
 
+GPUBackendCommand* GPUBackend::NewFlushRenderCommand()
+{
+  return static_cast<GPUBackendCommand*>(
+    AllocateCommand(GPUBackendCommandType::FlushRender, sizeof(GPUBackendCommand)));
+}
+
 void* GPUBackend::AllocateCommand(GPUBackendCommandType command, u32 size)
 {
   // Ensure size is a multiple of 4 so we don't end up with an unaligned command.
   size = Common::AlignUpPow2(size, 4);
 
+  // Always leave space for a wraparound command after this one. The write pointer can't catch up to the read pointer
+  // either, since that would look like an empty queue.
+  const u32 required_size = size + sizeof(GPUBackendCommand);
+  bool stalled = false;
+
   for (;;)
   {
-    u32 read_ptr = m_command_fifo_read_ptr.load();
-    u32 write_ptr = m_command_fifo_write_ptr.load();
+    const u32 write_ptr = m_command_fifo_pending_write_ptr;
+    const u32 read_ptr = m_command_fifo_read_ptr.load(std::memory_order_acquire);
     if (read_ptr > write_ptr)
     {
-      u32 available_size = read_ptr - write_ptr;
-      while (available_size < (size + sizeof(GPUBackendCommandType)))
-      {
-        WakeGPUThread();
-        read_ptr = m_command_fifo_read_ptr.load();
-        available_size = (read_ptr > write_ptr) ? (read_ptr - write_ptr) : (COMMAND_QUEUE_SIZE - write_ptr);
-      }
+      if ((read_ptr - write_ptr) > required_size)
+        break;
     }
-    else
+    else if ((COMMAND_QUEUE_SIZE - write_ptr) >= required_size)
     {
-      const u32 available_size = COMMAND_QUEUE_SIZE - write_ptr;
-      if ((size + sizeof(GPUBackendCommand)) > available_size)
-      {
-        // allocate a dummy command to wrap the buffer around
-        GPUBackendCommand* dummy_cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[write_ptr]);
-        dummy_cmd->type = GPUBackendCommandType::Wraparound;
-        dummy_cmd->size = available_size;
-        dummy_cmd->params.bits = 0;
-        m_command_fifo_write_ptr.store(0);
-        continue;
-      }
+      break;
+    }
+    else if (read_ptr > required_size)
+    {
+      // allocate a dummy command to wrap the buffer around
+      GPUBackendCommand* dummy_cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[write_ptr]);
+      dummy_cmd->type = GPUBackendCommandType::Wraparound;
+      dummy_cmd->size = COMMAND_QUEUE_SIZE - write_ptr;
+      dummy_cmd->params.bits = 0;
+      m_command_fifo_pending_write_ptr = 0;
+      continue;
+    }
+
+    // Queue is full, make sure the GPU thread can see everything it has to drain.
+    if (!stalled)
+    {
+      m_counters.num_stalls++;
+      stalled = true;
+      PublishCommands();
     }
 
-    GPUBackendCommand* cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[write_ptr]);
-    cmd->type = command;
-    cmd->size = size;
-    return cmd;
+    SpinPause();
   }
+
+  GPUBackendCommand* cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[m_command_fifo_pending_write_ptr]);
+  cmd->type = command;
+  cmd->size = size;
+  return cmd;
 }
 
 u32 GPUBackend::GetPendingCommandSize() const
@@ -161,20 +183,35 @@ void GPUBackend::PushCommand(GPUBackendCommand* cmd)
   }
   else
   {
-    const u32 new_write_ptr = m_command_fifo_write_ptr.fetch_add(cmd->size) + cmd->size;
-    DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
-    UNREFERENCED_VARIABLE(new_write_ptr);
-    if (GetPendingCommandSize() >= THRESHOLD_TO_WAKE_GPU)
-      WakeGPUThread();
+    m_command_fifo_pending_write_ptr += cmd->size;
+    DebugAssert(m_command_fifo_pending_write_ptr <= COMMAND_QUEUE_SIZE);
+    m_counters.bytes_pushed += cmd->size;
+
+    const u32 write_ptr = m_command_fifo_write_ptr.load(std::memory_order_relaxed);
+    const u32 unpublished_size = (m_command_fifo_pending_write_ptr >= write_ptr) ?
+                                   (m_command_fifo_pending_write_ptr - write_ptr) :
+                                   (COMMAND_QUEUE_SIZE - write_ptr + m_command_fifo_pending_write_ptr);
+    if (unpublished_size >= THRESHOLD_TO_PUBLISH || cmd->type == GPUBackendCommandType::Sync)
+      PublishCommands();
   }
 }
 
+void GPUBackend::PublishCommands()
+{
+  // Sequentially consistent, so that either the GPU thread sees the new pointer before it goes to sleep, or we see
+  // that it is sleeping. The GPU thread only needs waking in the latter case, which skips the mutex otherwise.
+  m_command_fifo_write_ptr.store(m_command_fifo_pending_write_ptr);
+  if (m_gpu_thread_sleeping.load())
+    WakeGPUThread();
+}
+
 void GPUBackend::WakeGPUThread()
 {
   std::unique_lock<std::mutex> lock(m_sync_mutex);
   if (!m_gpu_thread_sleeping.load())
     return;
 
+  m_counters.num_wakeups++;
   m_wake_gpu_thread_cv.notify_one();
 }
 
@@ -191,6 +228,7 @@ void GPUBackend::StopGPUThread()
   if (!m_use_gpu_thread)
     return;
 
+  PublishCommands();
   m_gpu_loop_done.store(true);
   WakeGPUThread();
   m_gpu_thread.Join();
@@ -201,47 +239,95 @@ void GPUBackend::StopGPUThread()
 void GPUBackend::Sync(bool allow_sleep)
 {
   if (!m_use_gpu_thread)
+  {
+    FlushRender();
     return;
+  }
 
   GPUBackendSyncCommand* cmd =
     static_cast<GPUBackendSyncCommand*>(AllocateCommand(GPUBackendCommandType::Sync, sizeof(GPUBackendSyncCommand)));
   cmd->allow_sleep = allow_sleep;
   PushCommand(cmd);
-  WakeGPUThread();
 
   m_sync_semaphore.Wait();
 }
 
+void GPUBackend::UpdateStatistics(u32 frame_count)
+{
+  const u32 round = (frame_count - 1);
+  m_stats.num_wakeups = (m_counters.num_wakeups + round) / frame_count;
+  m_stats.num_stalls = (m_counters.num_stalls + round) / frame_count;
+  m_stats.bytes_pushed = (m_counters.bytes_pushed + round) / frame_count;
+  m_counters = {};
+}
+
+bool GPUBackend::WaitForCommands(u32* spin_time_ns)
+{
+  // Spin for a while before sleeping, since waking up is expensive. The spin time adapts to how long the queue is
+  // typically empty for, so a lightly loaded GPU thread isn't burning a core for nothing.
+  if (*spin_time_ns > 0)
+  {
+    const Common::Timer::Value spin_start = Common::Timer::GetCurrentValue();
+    const Common::Timer::Value spin_end = spin_start + Common::Timer::ConvertNanosecondsToValue(*spin_time_ns);
+    do
+    {
+      for (u32 i = 0; i < 64; i++)
+      {
+        if (GetPendingCommandSize() > 0)
+          return true;
+
+        SpinPause();
+      }
+    } while (Common::Timer::GetCurrentValue() < spin_end);
+  }
+
+  const Common::Timer::Value sleep_start = Common::Timer::GetCurrentValue();
+  {
+    std::unique_lock<std::mutex> lock(m_sync_mutex);
+    m_gpu_thread_sleeping.store(true);
+    m_wake_gpu_thread_cv.wait(lock, [this]() { return m_gpu_loop_done.load() || GetPendingCommandSize() > 0; });
+    m_gpu_thread_sleeping.store(false);
+  }
+
+  // Woken shortly after giving up, a longer spin would have caught it. A long sleep means the spin was wasted.
+  const double sleep_time_ns =
+    Common::Timer::ConvertValueToNanoseconds(Common::Timer::GetCurrentValue() - sleep_start);
+  if (sleep_time_ns < static_cast<double>(MAX_SPIN_TIME_NS))
+    *spin_time_ns = std::clamp<u32>(*spin_time_ns * 2, MIN_SPIN_TIME_NS, MAX_SPIN_TIME_NS);
+  else
+    *spin_time_ns = std::max<u32>(*spin_time_ns / 2, MIN_SPIN_TIME_NS);
+
+  return !m_gpu_loop_done.load();
+}
+
 void GPUBackend::RunGPULoop()
 {
-  static constexpr double SPIN_TIME_NS = 1 * 1000000;
-  Common::Timer::Value last_command_time = 0;
+  u32 spin_time_ns = MAX_SPIN_TIME_NS;
+  bool allow_sleep = false;
+
+  Threading::SetNameOfCurrentThread("GPU Backend");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Presenter);
 
   for (;;)
   {
-    u32 write_ptr = m_command_fifo_write_ptr.load();
-    u32 read_ptr = m_command_fifo_read_ptr.load();
+    u32 write_ptr = m_command_fifo_write_ptr.load(std::memory_order_acquire);
+    u32 read_ptr = m_command_fifo_read_ptr.load(std::memory_order_relaxed);
     if (read_ptr == write_ptr)
     {
-      const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
-      if (Common::Timer::ConvertValueToNanoseconds(current_time - last_command_time) < SPIN_TIME_NS)
-        continue;
-
-      std::unique_lock<std::mutex> lock(m_sync_mutex);
-      m_gpu_thread_sleeping.store(true);
-      m_wake_gpu_thread_cv.wait(lock, [this]() { return m_gpu_loop_done.load() || GetPendingCommandSize() > 0; });
-      m_gpu_thread_sleeping.store(false);
-
-      if (m_gpu_loop_done.load())
+      // After a sync which allows sleeping, the CPU thread is usually throttling, so go straight to sleep.
+      u32 no_spin = 0;
+      if (!WaitForCommands(allow_sleep ? &no_spin : &spin_time_ns))
         break;
-      else
-        continue;
+
+      allow_sleep = false;
+      continue;
     }
 
     if (write_ptr < read_ptr)
       write_ptr = COMMAND_QUEUE_SIZE;
 
-    bool allow_sleep = false;
+    TRACE_ZONE("GPUBackend::RunGPULoop");
+    allow_sleep = false;
     while (read_ptr < write_ptr)
     {
       const GPUBackendCommand* cmd = reinterpret_cast<const GPUBackendCommand*>(&m_command_fifo_data[read_ptr]);
@@ -252,7 +338,7 @@ void GPUBackend::RunGPULoop()
         case GPUBackendCommandType::Wraparound:
         {
           DebugAssert(read_ptr == COMMAND_QUEUE_SIZE);
-          write_ptr = m_command_fifo_write_ptr.load();
+          write_ptr = m_command_fifo_write_ptr.load(std::memory_order_acquire);
           read_ptr = 0;
         }
         break;
@@ -260,6 +346,7 @@ void GPUBackend::RunGPULoop()
         case GPUBackendCommandType::Sync:
         {
           DebugAssert(read_ptr == write_ptr);
+          FlushRender();
           m_sync_semaphore.Post();
           allow_sleep = static_cast<const GPUBackendSyncCommand*>(cmd)->allow_sleep;
         }
@@ -271,8 +358,7 @@ void GPUBackend::RunGPULoop()
       }
     }
 
-    last_command_time = allow_sleep ? 0 : Common::Timer::GetCurrentValue();
-    m_command_fifo_read_ptr.store(read_ptr);
+    m_command_fifo_read_ptr.store(read_ptr, std::memory_order_release);
   }
 }
 
@@ -340,6 +426,12 @@ void GPUBackend::HandleCommand(const GPUBackendCommand* cmd)
     }
     break;
 
+    case GPUBackendCommandType::FlushRender:
+    {
+      FlushRender();
+    }
+    break;
+
     default:
       UnreachableCode();
   }
@@ -19,6 +19,14 @@
 class GPUBackend
 {
 public:
+  /// Command queue statistics, averaged per frame.
+  struct Stats
+  {
+    u32 num_wakeups;
+    u32 num_stalls;
+    u32 bytes_pushed;
+  };
+
   GPUBackend();
   virtual ~GPUBackend();
 
@@ -37,10 +45,17 @@ public:
   GPUBackendDrawPolygonCommand* NewDrawPolygonCommand(u32 num_vertices);
   GPUBackendDrawRectangleCommand* NewDrawRectangleCommand();
   GPUBackendDrawLineCommand* NewDrawLineCommand(u32 num_vertices);
+  GPUBackendCommand* NewFlushRenderCommand();
 
   void PushCommand(GPUBackendCommand* cmd);
   void Sync(bool allow_sleep);
 
+  /// Makes queued commands visible to the GPU thread without waiting for them, so it can start on them early.
+  void PublishCommands();
+
+  ALWAYS_INLINE const Stats& GetStatistics() const { return m_stats; }
+  void UpdateStatistics(u32 frame_count);
+
   /// Processes all pending GPU commands.
   void RunGPULoop();
 
@@ -48,6 +63,7 @@ protected:
   void* AllocateCommand(GPUBackendCommandType command, u32 size);
   u32 GetPendingCommandSize() const;
   void WakeGPUThread();
+  bool WaitForCommands(u32* spin_time_ns);
   void StartGPUThread();
   void StopGPUThread();
 
@@ -63,7 +79,7 @@ protected:
   virtual void DrawingAreaChanged() = 0;
   virtual void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) = 0;
 
-  void HandleCommand(const GPUBackendCommand* cmd);
+  virtual void HandleCommand(const GPUBackendCommand* cmd);
 
   GPUDrawingArea m_drawing_area = {};
 
@@ -81,12 +97,22 @@ protected:
   enum : u32
   {
     COMMAND_QUEUE_SIZE = 4 * 1024 * 1024,
-    THRESHOLD_TO_WAKE_GPU = 256
+    THRESHOLD_TO_PUBLISH = 256,
+
+    MIN_SPIN_TIME_NS = 10 * 1000,
+    MAX_SPIN_TIME_NS = 1000 * 1000,
   };
 
+  // The queue is single-producer, single-consumer. Commands are written past the published write pointer, and only
+  // made visible to the GPU thread in batches, which keeps the cache line holding it from bouncing between cores.
   FixedHeapArray<u8, COMMAND_QUEUE_SIZE> m_command_fifo_data;
   alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_command_fifo_read_ptr{0};
   alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_command_fifo_write_ptr{0};
+
+  // Only accessed by the CPU thread.
+  alignas(HOST_CACHE_LINE_SIZE) u32 m_command_fifo_pending_write_ptr = 0;
+  Stats m_counters = {};
+  Stats m_stats = {};
 };
 
 #ifdef _MSC_VER
@@ -10,13 +10,6 @@
 #include "texture_replacements.h"
 Log_SetChannel(GPU);
 
-#define CHECK_COMMAND_SIZE(num_words)                                                                                  \
-  if (m_fifo.GetSize() < num_words)                                                                                    \
-  {                                                                                                                    \
-    m_command_total_words = num_words;                                                                                 \
-    return false;                                                                                                      \
-  }
-
 static u32 s_cpu_to_vram_dump_id = 1;
 static u32 s_vram_to_cpu_dump_id = 1;
 
@@ -33,8 +26,16 @@ void GPU::TryExecuteCommands()
     {
       case BlitterState::Idle:
       {
-        const u32 command = FifoPeek(0) >> 24;
-        if ((this->*s_GP0_command_handler_table[command])())
+        // The packet length only depends on the command byte, so we can wait for the whole packet without calling
+        // into the handler each time another word arrives.
+        const GP0CommandInfo& info = s_GP0_command_table[FifoPeek(0) >> 24];
+        if (m_fifo.GetSize() < info.num_words)
+        {
+          m_command_total_words = info.num_words;
+          return;
+        }
+
+        if ((this->*info.handler)())
           continue;
         else
           return;
@@ -44,9 +45,7 @@ void GPU::TryExecuteCommands()
       {
         DebugAssert(m_blit_remaining_words > 0);
         const u32 words_to_copy = std::min(m_blit_remaining_words, m_fifo.GetSize());
-        m_blit_buffer.reserve(m_blit_buffer.size() + words_to_copy);
-        for (u32 i = 0; i < words_to_copy; i++)
-          m_blit_buffer.push_back(FifoPop());
+        FifoPopToBlitBuffer(words_to_copy);
         m_blit_remaining_words -= words_to_copy;
 
         Log_DebugPrintf("VRAM write burst of %u words, %u words remaining", words_to_copy, m_blit_remaining_words);
@@ -65,24 +64,15 @@ void GPU::TryExecuteCommands()
       case BlitterState::DrawingPolyLine:
       {
         const u32 words_per_vertex = m_render_command.shading_enable ? 2 : 1;
-        u32 terminator_index =
+        const u32 start_index =
           m_render_command.shading_enable ? ((static_cast<u32>(m_blit_buffer.size()) & 1u) ^ 1u) : 0u;
-        for (; terminator_index < m_fifo.GetSize(); terminator_index += words_per_vertex)
-        {
-          // polyline must have at least two vertices, and the terminator is (word & 0xf000f000) == 0x50005000.
-          // terminator is on the first word for the vertex
-          if ((FifoPeek(terminator_index) & UINT32_C(0xF000F000)) == UINT32_C(0x50005000))
-            break;
-        }
+        const u32 terminator_index = FindPolyLineTerminator(start_index, words_per_vertex);
 
+        // everything before the terminator has been checked, so it can all go to the blit buffer now
         const bool found_terminator = (terminator_index < m_fifo.GetSize());
-        const u32 words_to_copy = std::min(terminator_index, m_fifo.GetSize());
+        const u32 words_to_copy = terminator_index;
         if (words_to_copy > 0)
-        {
-          m_blit_buffer.reserve(m_blit_buffer.size() + words_to_copy);
-          for (u32 i = 0; i < words_to_copy; i++)
-            m_blit_buffer.push_back(FifoPop());
-        }
+          FifoPopToBlitBuffer(words_to_copy);
 
         Log_DebugPrintf("Added %u words to polyline", words_to_copy);
         if (found_terminator)
@@ -103,6 +93,8 @@ void GPU::TryExecuteCommands()
 
 void GPU::ExecuteCommands()
 {
+  System::ProfileSubsystemScope profile(System::ProfiledSubsystem::GPUCommands);
+
   const bool was_executing_from_event = std::exchange(m_executing_commands, true);
 
   TryExecuteCommands();
@@ -114,60 +106,126 @@ void GPU::ExecuteCommands()
     UpdateCommandTickEvent();
 }
 
+void GPU::FifoPopToBlitBuffer(u32 count)
+{
+  DebugAssert(m_fifo.GetSize() >= count);
+
+  const size_t start = m_blit_buffer.size();
+  m_blit_buffer.resize(start + count);
+  u32* dst = m_blit_buffer.data() + start;
+
+  // FIFO entries are the address and value, we only want the value.
+  while (count > 0)
+  {
+    const u32 run = std::min(count, m_fifo.GetContiguousSize());
+    const u64* src = m_fifo.GetReadPointer();
+    for (u32 i = 0; i < run; i++)
+      dst[i] = Truncate32(src[i]);
+
+    m_fifo.AdvanceHead(run);
+    dst += run;
+    count -= run;
+  }
+}
+
+u32 GPU::FindPolyLineTerminator(u32 start_index, u32 words_per_vertex) const
+{
+  // polyline must have at least two vertices, and the terminator is (word & 0xf000f000) == 0x50005000.
+  // terminator is on the first word for the vertex. The FIFO can wrap, so search the run up to the end of the
+  // buffer, then the run at the start.
+  const u32 size = m_fifo.GetSize();
+  const u32 contiguous_size = m_fifo.GetContiguousSize();
+  const u64* run = m_fifo.GetReadPointer();
+  u32 index = start_index;
+  for (; index < contiguous_size; index += words_per_vertex)
+  {
+    if ((Truncate32(run[index]) & UINT32_C(0xF000F000)) == UINT32_C(0x50005000))
+      return index;
+  }
+
+  const u64* wrapped = m_fifo.GetDataPointer();
+  for (; index < size; index += words_per_vertex)
+  {
+    if ((Truncate32(wrapped[index - contiguous_size]) & UINT32_C(0xF000F000)) == UINT32_C(0x50005000))
+      return index;
+  }
+
+  return size;
+}
+
 void GPU::EndCommand()
 {
   m_blitter_state = BlitterState::Idle;
   m_command_total_words = 0;
 }
 
-GPU::GP0CommandHandlerTable GPU::GenerateGP0CommandHandlerTable()
+GPU::GP0CommandTable GPU::GenerateGP0CommandTable()
 {
-  GP0CommandHandlerTable table = {};
+  GP0CommandTable table = {};
   for (u32 i = 0; i < static_cast<u32>(table.size()); i++)
-    table[i] = &GPU::HandleUnknownGP0Command;
-  table[0x00] = &GPU::HandleNOPCommand;
-  table[0x01] = &GPU::HandleClearCacheCommand;
-  table[0x02] = &GPU::HandleFillRectangleCommand;
-  table[0x03] = &GPU::HandleNOPCommand;
+    table[i] = {&GPU::HandleUnknownGP0Command, 1};
+  table[0x00] = {&GPU::HandleNOPCommand, 1};
+  table[0x01] = {&GPU::HandleClearCacheCommand, 1};
+  table[0x02] = {&GPU::HandleFillRectangleCommand, 3};
+  table[0x03] = {&GPU::HandleNOPCommand, 1};
   for (u32 i = 0x04; i <= 0x1E; i++)
-    table[i] = &GPU::HandleNOPCommand;
-  table[0x1F] = &GPU::HandleInterruptRequestCommand;
+    table[i] = {&GPU::HandleNOPCommand, 1};
+  table[0x1F] = {&GPU::HandleInterruptRequestCommand, 1};
   for (u32 i = 0x20; i <= 0x7F; i++)
   {
     const GPURenderCommand rc{i << 24};
     switch (rc.primitive)
     {
       case GPUPrimitive::Polygon:
-        table[i] = &GPU::HandleRenderPolygonCommand;
-        break;
+      {
+        // shaded vertices use the colour from the first word for the first vertex
+        const u32 words_per_vertex = 1 + BoolToUInt32(rc.texture_enable) + BoolToUInt32(rc.shading_enable);
+        const u32 num_vertices = rc.quad_polygon ? 4 : 3;
+        table[i] = {&GPU::HandleRenderPolygonCommand,
+                    words_per_vertex * num_vertices + BoolToUInt32(!rc.shading_enable)};
+      }
+      break;
+
       case GPUPrimitive::Line:
-        table[i] = rc.polyline ? &GPU::HandleRenderPolyLineCommand : &GPU::HandleRenderLineCommand;
-        break;
+      {
+        // always read the first two vertices for polylines, we test for the terminator after that
+        if (rc.polyline)
+          table[i] = {&GPU::HandleRenderPolyLineCommand, rc.shading_enable ? 3u : 4u};
+        else
+          table[i] = {&GPU::HandleRenderLineCommand, rc.shading_enable ? 4u : 3u};
+      }
+      break;
+
       case GPUPrimitive::Rectangle:
-        table[i] = &GPU::HandleRenderRectangleCommand;
-        break;
+      {
+        table[i] = {&GPU::HandleRenderRectangleCommand,
+                    2 + BoolToUInt32(rc.texture_enable) +
+                      BoolToUInt32(rc.rectangle_size == GPUDrawRectangleSize::Variable)};
+      }
+      break;
+
       default:
-        table[i] = &GPU::HandleUnknownGP0Command;
+        table[i] = {&GPU::HandleUnknownGP0Command, 1};
         break;
     }
   }
-  table[0xE0] = &GPU::HandleNOPCommand;
-  table[0xE1] = &GPU::HandleSetDrawModeCommand;
-  table[0xE2] = &GPU::HandleSetTextureWindowCommand;
-  table[0xE3] = &GPU::HandleSetDrawingAreaTopLeftCommand;
-  table[0xE4] = &GPU::HandleSetDrawingAreaBottomRightCommand;
-  table[0xE5] = &GPU::HandleSetDrawingOffsetCommand;
-  table[0xE6] = &GPU::HandleSetMaskBitCommand;
+  table[0xE0] = {&GPU::HandleNOPCommand, 1};
+  table[0xE1] = {&GPU::HandleSetDrawModeCommand, 1};
+  table[0xE2] = {&GPU::HandleSetTextureWindowCommand, 1};
+  table[0xE3] = {&GPU::HandleSetDrawingAreaTopLeftCommand, 1};
+  table[0xE4] = {&GPU::HandleSetDrawingAreaBottomRightCommand, 1};
+  table[0xE5] = {&GPU::HandleSetDrawingOffsetCommand, 1};
+  table[0xE6] = {&GPU::HandleSetMaskBitCommand, 1};
   for (u32 i = 0xE7; i <= 0xEF; i++)
-    table[i] = &GPU::HandleNOPCommand;
+    table[i] = {&GPU::HandleNOPCommand, 1};
   for (u32 i = 0x80; i <= 0x9F; i++)
-    table[i] = &GPU::HandleCopyRectangleVRAMToVRAMCommand;
+    table[i] = {&GPU::HandleCopyRectangleVRAMToVRAMCommand, 4};
   for (u32 i = 0xA0; i <= 0xBF; i++)
-    table[i] = &GPU::HandleCopyRectangleCPUToVRAMCommand;
+    table[i] = {&GPU::HandleCopyRectangleCPUToVRAMCommand, 3};
   for (u32 i = 0xC0; i <= 0xDF; i++)
-    table[i] = &GPU::HandleCopyRectangleVRAMToCPUCommand;
+    table[i] = {&GPU::HandleCopyRectangleVRAMToCPUCommand, 3};
 
-  table[0xFF] = &GPU::HandleNOPCommand;
+  table[0xFF] = {&GPU::HandleNOPCommand, 1};
 
   return table;
 }
@@ -319,12 +377,9 @@ bool GPU::HandleSetMaskBitCommand()
 bool GPU::HandleRenderPolygonCommand()
 {
   const GPURenderCommand rc{FifoPeek(0)};
-
-  // shaded vertices use the colour from the first word for the first vertex
-  const u32 words_per_vertex = 1 + BoolToUInt32(rc.texture_enable) + BoolToUInt32(rc.shading_enable);
+  [[maybe_unused]] const u32 words_per_vertex =
+    1 + BoolToUInt32(rc.texture_enable) + BoolToUInt32(rc.shading_enable);
   const u32 num_vertices = rc.quad_polygon ? 4 : 3;
-  const u32 total_words = words_per_vertex * num_vertices + BoolToUInt32(!rc.shading_enable);
-  CHECK_COMMAND_SIZE(total_words);
 
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
@@ -364,10 +419,7 @@ bool GPU::HandleRenderPolygonCommand()
 bool GPU::HandleRenderRectangleCommand()
 {
   const GPURenderCommand rc{FifoPeek(0)};
-  const u32 total_words =
-    2 + BoolToUInt32(rc.texture_enable) + BoolToUInt32(rc.rectangle_size == GPUDrawRectangleSize::Variable);
-
-  CHECK_COMMAND_SIZE(total_words);
+  [[maybe_unused]] const u32 total_words = s_GP0_command_table[rc.bits >> 24].num_words;
 
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
@@ -399,8 +451,7 @@ bool GPU::HandleRenderRectangleCommand()
 bool GPU::HandleRenderLineCommand()
 {
   const GPURenderCommand rc{FifoPeek(0)};
-  const u32 total_words = rc.shading_enable ? 4 : 3;
-  CHECK_COMMAND_SIZE(total_words);
+  [[maybe_unused]] const u32 total_words = s_GP0_command_table[rc.bits >> 24].num_words;
 
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
@@ -422,8 +473,7 @@ bool GPU::HandleRenderPolyLineCommand()
 {
   // always read the first two vertices, we test for the terminator after that
   const GPURenderCommand rc{FifoPeek(0)};
-  const u32 min_words = rc.shading_enable ? 3 : 4;
-  CHECK_COMMAND_SIZE(min_words);
+  const u32 min_words = s_GP0_command_table[rc.bits >> 24].num_words;
 
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
@@ -437,12 +487,7 @@ bool GPU::HandleRenderPolyLineCommand()
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
-  const u32 words_to_pop = min_words - 1;
-  // m_blit_buffer.resize(words_to_pop);
-  // FifoPopRange(m_blit_buffer.data(), words_to_pop);
-  m_blit_buffer.reserve(words_to_pop);
-  for (u32 i = 0; i < words_to_pop; i++)
-    m_blit_buffer.push_back(Truncate32(FifoPop()));
+  FifoPopToBlitBuffer(min_words - 1);
 
   // polyline goes via a different path through the blit buffer
   m_blitter_state = BlitterState::DrawingPolyLine;
@@ -452,8 +497,6 @@ bool GPU::HandleRenderPolyLineCommand()
 
 bool GPU::HandleFillRectangleCommand()
 {
-  CHECK_COMMAND_SIZE(3);
-
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
 
@@ -478,7 +521,6 @@ bool GPU::HandleFillRectangleCommand()
 
 bool GPU::HandleCopyRectangleCPUToVRAMCommand()
 {
-  CHECK_COMMAND_SIZE(3);
   m_fifo.RemoveOne();
 
   const u32 dst_x = FifoPeek() & VRAM_WIDTH_MASK;
@@ -562,7 +604,6 @@ void GPU::FinishVRAMWrite()
 
 bool GPU::HandleCopyRectangleVRAMToCPUCommand()
 {
-  CHECK_COMMAND_SIZE(3);
   m_fifo.RemoveOne();
 
   m_vram_transfer.x = Truncate16(FifoPeek() & VRAM_WIDTH_MASK);
@@ -577,11 +618,13 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
   // all rendering should be done first...
   FlushRender();
 
-  // ensure VRAM shadow is up to date
-  ReadVRAM(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height);
+  // ensure VRAM shadow is up to date, this can complete in the background until the first read
+  m_vram_readback_pending =
+    BeginVRAMReadback(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height);
 
   if (g_settings.debugging.dump_vram_to_cpu_copies)
   {
+    WaitForVRAMReadback();
     DumpVRAMToFile(TinyString::from_format("vram_to_cpu_copy_{}.png", s_vram_to_cpu_dump_id++), m_vram_transfer.width,
                    m_vram_transfer.height, sizeof(u16) * VRAM_WIDTH,
                    &g_vram[m_vram_transfer.y * VRAM_WIDTH + m_vram_transfer.x], true);
@@ -596,7 +639,6 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
 
 bool GPU::HandleCopyRectangleVRAMToVRAMCommand()
 {
-  CHECK_COMMAND_SIZE(4);
   m_fifo.RemoveOne();
 
   const u32 src_x = FifoPeek() & VRAM_WIDTH_MASK;
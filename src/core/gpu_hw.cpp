@@ -15,13 +15,22 @@
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
+#include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/gsvector.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/scoped_guard.h"
 #include "common/string_util.h"
+#include "common/timer.h"
+#include "common/trace.h"
 
 #include "IconsFontAwesome5.h"
 #include "imgui.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <tuple>
@@ -33,6 +42,9 @@ Log_SetChannel(GPU_HW);
 static constexpr GPUTexture::Format VRAM_RT_FORMAT = GPUTexture::Format::RGBA8;
 static constexpr GPUTexture::Format VRAM_DS_FORMAT = GPUTexture::Format::D16;
 
+static constexpr u32 PIPELINE_USAGE_SIGNATURE = 0x55504C50; // PLPU
+static constexpr u32 PIPELINE_USAGE_VERSION = 1;
+
 #ifdef _DEBUG
 static u32 s_draw_number = 0;
 #endif
@@ -137,6 +149,10 @@ GPU_HW::GPU_HW() : GPU()
 
 GPU_HW::~GPU_HW()
 {
+  WaitForVRAMReadback();
+  m_render_queue.Shutdown();
+  SavePipelineUsage();
+
   if (m_sw_renderer)
   {
     m_sw_renderer->Shutdown();
@@ -199,6 +215,8 @@ bool GPU_HW::Initialize()
   m_true_color = g_settings.gpu_true_color;
   m_debanding = g_settings.gpu_debanding;
   m_scaled_dithering = g_settings.gpu_scaled_dithering;
+  m_batch_mixed_texture_modes = g_settings.gpu_batch_mixed_texture_modes;
+  m_defer_pipeline_compilation = g_settings.gpu_defer_pipeline_compilation;
   m_texture_filtering = g_settings.gpu_texture_filter;
   m_line_detect_mode = (m_resolution_scale > 1) ? g_settings.gpu_line_detect_mode : GPULineDetectMode::Disabled;
   m_clamp_uvs = ShouldClampUVs();
@@ -206,6 +224,11 @@ bool GPU_HW::Initialize()
   m_downsample_mode = GetDownsampleMode(m_resolution_scale);
   m_wireframe_mode = g_settings.gpu_wireframe_mode;
   m_disable_color_perspective = features.noperspective_interpolation && ShouldDisableColorPerspective();
+
+  // Push constants and root constants are recorded into the command list, whereas every other API streams them
+  // through a buffer anyway, so only the former are worth pushing again for every draw.
+  m_batch_push_constants =
+    (g_gpu_device->GetRenderAPI() == RenderAPI::Vulkan || g_gpu_device->GetRenderAPI() == RenderAPI::D3D12);
   m_pgxp_depth_buffer = g_settings.UsingPGXPDepthBuffer();
 
   CheckSettings();
@@ -226,12 +249,14 @@ bool GPU_HW::Initialize()
     return false;
   }
 
-  RestoreDeviceContext();
-  return true;
+  RestoreVRAMRenderState();
+  return m_render_queue.Initialize(false);
 }
 
 void GPU_HW::Reset(bool clear_vram)
 {
+  RenderThreadSuspendScope suspend(m_render_queue);
+  FlushVRAMWrites();
   GPU::Reset(clear_vram);
 
   if (m_batch_vertex_ptr)
@@ -240,6 +265,8 @@ void GPU_HW::Reset(bool clear_vram)
   if (m_sw_renderer)
     m_sw_renderer->Reset();
 
+  m_render_queue.Reset();
+
   m_batch = {};
   m_batch_ubo_data = {};
   m_batch_ubo_dirty = true;
@@ -250,8 +277,24 @@ void GPU_HW::Reset(bool clear_vram)
     ClearFramebuffer();
 }
 
+std::unique_ptr<GPUTexture> GPU_HW::CreateVRAMSnapshotTexture()
+{
+  RenderThreadSuspendScope suspend(m_render_queue);
+  return g_gpu_device->FetchTexture(m_vram_texture->GetWidth(), m_vram_texture->GetHeight(), 1, 1,
+                                    m_vram_texture->GetSamples(), GPUTexture::Type::RenderTarget,
+                                    GPUTexture::Format::RGBA8, nullptr, 0);
+}
+
+bool GPU_HW::IsValidVRAMSnapshotTexture(const GPUTexture* tex) const
+{
+  return (tex && tex->GetWidth() == m_vram_texture->GetWidth() && tex->GetHeight() == m_vram_texture->GetHeight() &&
+          tex->GetSamples() == m_vram_texture->GetSamples());
+}
+
 bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
+  RenderThreadSuspendScope suspend(m_render_queue);
+  FlushVRAMWrites();
   if (!GPU::DoState(sw, host_texture, update_display))
     return false;
 
@@ -260,27 +303,20 @@ bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
     GPUTexture* tex = *host_texture;
     if (sw.IsReading())
     {
-      if (tex->GetWidth() != m_vram_texture->GetWidth() || tex->GetHeight() != m_vram_texture->GetHeight() ||
-          tex->GetSamples() != m_vram_texture->GetSamples())
-      {
+      if (!IsValidVRAMSnapshotTexture(tex))
         return false;
-      }
 
       g_gpu_device->CopyTextureRegion(m_vram_texture.get(), 0, 0, 0, 0, tex, 0, 0, 0, 0, tex->GetWidth(),
                                       tex->GetHeight());
+      m_display_vram_changed = true;
     }
     else
     {
-      if (!tex || tex->GetWidth() != m_vram_texture->GetWidth() || tex->GetHeight() != m_vram_texture->GetHeight() ||
-          tex->GetSamples() != m_vram_texture->GetSamples())
+      if (!IsValidVRAMSnapshotTexture(tex))
       {
         delete tex;
 
-        tex =
-          g_gpu_device
-            ->FetchTexture(m_vram_texture->GetWidth(), m_vram_texture->GetHeight(), 1, 1, m_vram_texture->GetSamples(),
-                           GPUTexture::Type::RenderTarget, GPUTexture::Format::RGBA8, nullptr, 0)
-            .release();
+        tex = CreateVRAMSnapshotTexture().release();
         *host_texture = tex;
         if (!tex)
           return false;
@@ -303,6 +339,12 @@ bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
 }
 
 void GPU_HW::RestoreDeviceContext()
+{
+  RenderThreadSuspendScope suspend(m_render_queue);
+  RestoreVRAMRenderState();
+}
+
+void GPU_HW::RestoreVRAMRenderState()
 {
   g_gpu_device->SetTextureSampler(0, m_vram_read_texture.get(), g_gpu_device->GetNearestSampler());
   SetVRAMRenderTarget();
@@ -313,10 +355,22 @@ void GPU_HW::RestoreDeviceContext()
 
 void GPU_HW::UpdateSettings(const Settings& old_settings)
 {
+  m_render_queue.UpdateSettings();
+
+  RenderThreadSuspendScope suspend(m_render_queue);
+  WaitForVRAMReadback();
+  FlushVRAMWrites();
   GPU::UpdateSettings(old_settings);
+  m_display_vram_changed = true;
 
   const GPUDevice::Features features = g_gpu_device->GetFeatures();
 
+  if (!g_settings.gpu_dynamic_resolution || g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale)
+  {
+    m_dynamic_resolution_reduction = 0;
+    m_dynamic_resolution_headroom_intervals = 0;
+  }
+
   const u8 resolution_scale = Truncate8(CalculateResolutionScale());
   const u8 multisamples = Truncate8(std::min<u32>(g_settings.gpu_multisamples, g_gpu_device->GetMaxMultisamples()));
   const bool per_sample_shading = g_settings.gpu_per_sample_shading && features.noperspective_interpolation;
@@ -332,12 +386,16 @@ void GPU_HW::UpdateSettings(const Settings& old_settings)
      (static_cast<bool>(m_vram_depth_texture) !=
       (g_settings.UsingPGXPDepthBuffer() || !m_supports_framebuffer_fetch)) ||
      (m_downsample_mode == GPUDownsampleMode::Box &&
-      g_settings.gpu_downsample_scale != old_settings.gpu_downsample_scale));
+      g_settings.gpu_downsample_scale != old_settings.gpu_downsample_scale) ||
+     g_settings.gpu_sparse_vram != old_settings.gpu_sparse_vram);
   const bool shaders_changed =
     (m_resolution_scale != resolution_scale || m_multisamples != multisamples ||
      m_true_color != g_settings.gpu_true_color || m_debanding != g_settings.gpu_debanding ||
      m_per_sample_shading != per_sample_shading || m_scaled_dithering != g_settings.gpu_scaled_dithering ||
-     m_texture_filtering != g_settings.gpu_texture_filter || m_clamp_uvs != clamp_uvs ||
+     m_batch_mixed_texture_modes != g_settings.gpu_batch_mixed_texture_modes ||
+     m_defer_pipeline_compilation != g_settings.gpu_defer_pipeline_compilation ||
+     m_texture_filtering != g_settings.gpu_texture_filter ||
+     g_settings.gpu_texture_filter_cache != old_settings.gpu_texture_filter_cache || m_clamp_uvs != clamp_uvs ||
      m_downsample_mode != downsample_mode ||
      (m_downsample_mode == GPUDownsampleMode::Box &&
       g_settings.gpu_downsample_scale != old_settings.gpu_downsample_scale) ||
@@ -373,11 +431,31 @@ void GPU_HW::UpdateSettings(const Settings& old_settings)
     }
   }
 
-  // Back up VRAM if we're recreating the framebuffer.
+  // Back up VRAM if we're recreating the framebuffer. When only the scale changes, the upscaled copy is kept and
+  // rescaled, which avoids the readback and keeps the detail which has already been rendered.
+  std::unique_ptr<GPUTexture> old_vram_texture;
   if (framebuffer_changed)
   {
-    RestoreDeviceContext();
-    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    FlushBatch();
+    RestoreVRAMRenderState();
+    if (m_resolution_scale != resolution_scale && !IsUsingSparseVRAM())
+    {
+      if (m_vram_texture->IsMultisampled())
+      {
+        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), 0, 0, 0, 0, m_vram_texture.get(), 0, 0,
+                                           m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
+        old_vram_texture = std::move(m_vram_read_texture);
+      }
+      else
+      {
+        old_vram_texture = std::move(m_vram_texture);
+      }
+    }
+    else
+    {
+      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    }
+
     DestroyBuffers();
   }
 
@@ -387,6 +465,8 @@ void GPU_HW::UpdateSettings(const Settings& old_settings)
   m_true_color = g_settings.gpu_true_color;
   m_debanding = g_settings.gpu_debanding;
   m_scaled_dithering = g_settings.gpu_scaled_dithering;
+  m_batch_mixed_texture_modes = g_settings.gpu_batch_mixed_texture_modes;
+  m_defer_pipeline_compilation = g_settings.gpu_defer_pipeline_compilation;
   m_texture_filtering = g_settings.gpu_texture_filter;
   m_line_detect_mode = (m_resolution_scale > 1) ? g_settings.gpu_line_detect_mode : GPULineDetectMode::Disabled;
   m_clamp_uvs = clamp_uvs;
@@ -418,6 +498,8 @@ void GPU_HW::UpdateSettings(const Settings& old_settings)
 
   if (shaders_changed)
   {
+    // Slots depend on the resolution scale and filter, so the cache has to be refilled.
+    DestroyFilteredTexPageCache();
     DestroyPipelines();
     if (!CompilePipelines())
       Panic("Failed to recompile pipelnes.");
@@ -428,8 +510,17 @@ void GPU_HW::UpdateSettings(const Settings& old_settings)
     if (!CreateBuffers())
       Panic("Failed to recreate buffers.");
 
-    RestoreDeviceContext();
-    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, g_vram, false, false);
+    RestoreVRAMRenderState();
+    if (old_vram_texture)
+    {
+      RescaleVRAM(old_vram_texture.get());
+      g_gpu_device->RecycleTexture(std::move(old_vram_texture));
+    }
+    else
+    {
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, g_vram, false, false);
+    }
+
     UpdateDepthBufferFromMaskBit();
     UpdateDisplay();
   }
@@ -499,20 +590,44 @@ void GPU_HW::CheckSettings()
     if (box_downscale == g_settings.gpu_resolution_scale)
       m_downsample_mode = GPUDownsampleMode::Disabled;
   }
+
+  m_filtered_texpage_cache = ShouldCacheFilteredTexPages();
+  if (m_filtered_texpage_cache)
+  {
+    const u32 slot_size = 256u * m_resolution_scale;
+    const u32 row_texels = FILTERED_TEXPAGE_CACHE_COLUMNS * slot_size * slot_size;
+    const u32 rows = std::min(MAX_FILTERED_TEXPAGE_CACHE_TEXELS / row_texels,
+                              MAX_FILTERED_TEXPAGES / FILTERED_TEXPAGE_CACHE_COLUMNS);
+    m_num_filtered_texpages = FILTERED_TEXPAGE_CACHE_COLUMNS * rows;
+  }
+  else
+  {
+    m_num_filtered_texpages = 0;
+  }
 }
 
 void GPU_HW::SetClampedDrawingArea()
 {
-  if (!IsDrawingAreaIsValid()) [[unlikely]]
+  const GPUDrawingArea& area = m_render_queue.GetDrawingArea();
+  if (area.left > area.right || area.top > area.bottom) [[unlikely]]
   {
     m_clamped_drawing_area = {};
     return;
   }
 
-  m_clamped_drawing_area.right = std::min(m_drawing_area.right + 1, static_cast<u32>(VRAM_WIDTH));
-  m_clamped_drawing_area.left = std::min(m_drawing_area.left, std::min(m_clamped_drawing_area.right, VRAM_WIDTH - 1));
-  m_clamped_drawing_area.bottom = std::min(m_drawing_area.bottom + 1, static_cast<u32>(VRAM_HEIGHT));
-  m_clamped_drawing_area.top = std::min(m_drawing_area.top, std::min(m_drawing_area.bottom, VRAM_HEIGHT - 1));
+  m_clamped_drawing_area.right = std::min(area.right + 1, static_cast<u32>(VRAM_WIDTH));
+  m_clamped_drawing_area.left = std::min(area.left, std::min(m_clamped_drawing_area.right, VRAM_WIDTH - 1));
+  m_clamped_drawing_area.bottom = std::min(area.bottom + 1, static_cast<u32>(VRAM_HEIGHT));
+  m_clamped_drawing_area.top = std::min(area.top, std::min(area.bottom, VRAM_HEIGHT - 1));
+}
+
+void GPU_HW::DrawingAreaChanged()
+{
+  SetClampedDrawingArea();
+  SetScissor();
+
+  if (m_pgxp_depth_buffer && m_last_depth_z < 1.0f)
+    ClearDepthBuffer();
 }
 
 u32 GPU_HW::CalculateResolutionScale() const
@@ -551,6 +666,13 @@ u32 GPU_HW::CalculateResolutionScale() const
     scale = static_cast<u32>(std::clamp<s32>(preferred_scale, 1, max_resolution_scale));
   }
 
+  // Dynamic resolution steps down from the configured scale, but not below the minimum.
+  if (g_settings.gpu_dynamic_resolution && m_dynamic_resolution_reduction > 0)
+  {
+    const u32 min_scale = std::clamp<u32>(g_settings.gpu_dynamic_resolution_min_scale, 1, scale);
+    scale = std::max(scale - std::min<u32>(m_dynamic_resolution_reduction, scale), min_scale);
+  }
+
   if (g_settings.gpu_downsample_mode == GPUDownsampleMode::Adaptive && scale > 1 && !Common::IsPow2(scale))
   {
     const u32 new_scale = Common::PreviousPow2(scale);
@@ -580,6 +702,64 @@ void GPU_HW::UpdateResolutionScale()
     UpdateSettings(g_settings);
 }
 
+void GPU_HW::UpdateDynamicResolution(float average_gpu_time, float frame_time_budget)
+{
+  // Steps down as soon as the GPU falls behind, and back up only after several intervals where the next scale would
+  // still fit, assuming GPU time grows with the number of pixels.
+  static constexpr float STEP_DOWN_THRESHOLD = 0.9f;
+  static constexpr float STEP_UP_THRESHOLD = 0.75f;
+  static constexpr u8 STEP_UP_INTERVALS = 3;
+
+  if (!g_settings.gpu_dynamic_resolution || average_gpu_time <= 0.0f || frame_time_budget <= 0.0f)
+    return;
+
+  // The interval after a change includes frames at the old scale.
+  if (m_dynamic_resolution_settling)
+  {
+    m_dynamic_resolution_settling = false;
+    return;
+  }
+
+  const u32 scale = m_resolution_scale;
+  if (average_gpu_time > (frame_time_budget * STEP_DOWN_THRESHOLD))
+  {
+    m_dynamic_resolution_headroom_intervals = 0;
+    if (scale <= std::max<u32>(g_settings.gpu_dynamic_resolution_min_scale, 1))
+      return;
+
+    m_dynamic_resolution_reduction++;
+  }
+  else if (m_dynamic_resolution_reduction > 0)
+  {
+    const float next_scale_ratio = static_cast<float>(scale + 1) / static_cast<float>(scale);
+    if ((average_gpu_time * next_scale_ratio * next_scale_ratio) >= (frame_time_budget * STEP_UP_THRESHOLD))
+    {
+      m_dynamic_resolution_headroom_intervals = 0;
+      return;
+    }
+
+    if (++m_dynamic_resolution_headroom_intervals < STEP_UP_INTERVALS)
+      return;
+
+    m_dynamic_resolution_headroom_intervals = 0;
+    m_dynamic_resolution_reduction--;
+  }
+  else
+  {
+    return;
+  }
+
+  // Adaptive downsampling can round to the same scale, in which case the next interval steps again.
+  const u32 new_scale = CalculateResolutionScale();
+  if (new_scale == scale)
+    return;
+
+  Log_DevFmt("Dynamic resolution: GPU time {:.2f}ms of {:.2f}ms, changing scale from {}x to {}x", average_gpu_time,
+             frame_time_budget, scale, new_scale);
+  m_dynamic_resolution_settling = true;
+  UpdateSettings(g_settings);
+}
+
 GPUDownsampleMode GPU_HW::GetDownsampleMode(u32 resolution_scale) const
 {
   return (resolution_scale == 1) ? GPUDownsampleMode::Disabled : g_settings.gpu_downsample_mode;
@@ -598,13 +778,42 @@ bool GPU_HW::IsUsingDownsampling() const
 void GPU_HW::SetFullVRAMDirtyRectangle()
 {
   m_vram_dirty_draw_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
-  m_draw_mode.SetTexturePageChanged();
+  m_display_vram_changed = true;
+  m_vram_dirty_tiles.fill((1u << VRAM_DIRTY_TILES_WIDE) - 1u);
+  m_filtered_texpage_valid_mask = 0;
+  m_render_texture_page_changed = true;
 }
 
 void GPU_HW::ClearVRAMDirtyRectangle()
 {
   m_vram_dirty_draw_rect.SetInvalid();
   m_vram_dirty_write_rect.SetInvalid();
+  m_vram_dirty_tiles.fill(0);
+}
+
+void GPU_HW::MarkVRAMTilesDirty(u32 left, u32 top, u32 right, u32 bottom)
+{
+  if (left >= right || top >= bottom)
+    return;
+
+  if (m_filtered_texpage_valid_mask != 0)
+    InvalidateFilteredTexPages(left, top, right, bottom);
+
+  if (!m_display_vram_changed && left < m_display_vram_rect.right && right > m_display_vram_rect.left &&
+      top < m_display_vram_rect.bottom && bottom > m_display_vram_rect.top)
+  {
+    m_display_vram_changed = true;
+  }
+
+  const u32 tile_left = left / VRAM_DIRTY_TILE_SIZE;
+  const u32 tile_right =
+    std::min<u32>((right + (VRAM_DIRTY_TILE_SIZE - 1)) / VRAM_DIRTY_TILE_SIZE, VRAM_DIRTY_TILES_WIDE);
+  const u32 tile_top = top / VRAM_DIRTY_TILE_SIZE;
+  const u32 tile_bottom =
+    std::min<u32>((bottom + (VRAM_DIRTY_TILE_SIZE - 1)) / VRAM_DIRTY_TILE_SIZE, VRAM_DIRTY_TILES_HIGH);
+  const u16 column_mask = static_cast<u16>(((1u << tile_right) - 1u) & ~((1u << tile_left) - 1u));
+  for (u32 tile_y = tile_top; tile_y < tile_bottom; tile_y++)
+    m_vram_dirty_tiles[tile_y] |= column_mask;
 }
 
 void GPU_HW::IncludeDrawnDirtyRectangle(s32 min_x, s32 min_y, s32 max_x, s32 max_y)
@@ -622,6 +831,10 @@ void GPU_HW::IncludeDrawnDirtyRectangle(s32 min_x, s32 min_y, s32 max_x, s32 max
     std::clamp(max_y, static_cast<s32>(m_clamped_drawing_area.top), static_cast<s32>(m_clamped_drawing_area.bottom));
   m_vram_dirty_draw_rect.top = std::min(m_vram_dirty_draw_rect.top, clamped_min_y);
   m_vram_dirty_draw_rect.bottom = std::max(m_vram_dirty_draw_rect.bottom, clamped_max_y);
+  MarkVRAMTilesDirty(clamped_min_x, clamped_min_y, clamped_max_x, clamped_max_y);
+
+  if (IsUsingSparseVRAM())
+    m_sparse_vram_draw_rect.Include(clamped_min_x, clamped_max_x, clamped_min_y, clamped_max_y);
 
   DebugAssert(m_vram_dirty_draw_rect.left < VRAM_WIDTH && m_vram_dirty_draw_rect.right <= VRAM_WIDTH);
   DebugAssert(m_vram_dirty_draw_rect.top < VRAM_HEIGHT && m_vram_dirty_draw_rect.bottom <= VRAM_HEIGHT);
@@ -648,8 +861,12 @@ void GPU_HW::PrintSettingsToLog()
               (!m_true_color && m_scaled_dithering) ? " (Scaled)" :
                                                       ((m_true_color && m_debanding) ? " (Debanding)" : ""));
   Log_InfoFmt("Texture Filtering: {}", Settings::GetTextureFilterDisplayName(m_texture_filtering));
+  Log_InfoFmt("Filtered texture page cache: {} pages", m_num_filtered_texpages);
   Log_InfoFmt("Dual-source blending: {}", m_supports_dual_source_blend ? "Supported" : "Not supported");
+  Log_InfoFmt("Batch uniforms: {}", m_batch_push_constants ? "Push constants" : "Uniform buffer");
   Log_InfoFmt("Clamping UVs: {}", m_clamp_uvs ? "YES" : "NO");
+  Log_InfoFmt("Batching mixed texture modes: {}", m_batch_mixed_texture_modes ? "YES" : "NO");
+  Log_InfoFmt("Deferred pipeline compilation: {}", m_defer_pipeline_compilation ? "YES" : "NO");
   Log_InfoFmt("Depth buffer: {}", m_pgxp_depth_buffer ? "YES" : "NO");
   Log_InfoFmt("Downsampling: {}", Settings::GetDownsampleModeDisplayName(m_downsample_mode));
   Log_InfoFmt("Wireframe rendering: {}", Settings::GetGPUWireframeModeDisplayName(m_wireframe_mode));
@@ -678,13 +895,20 @@ bool GPU_HW::CreateBuffers()
                                                GPUTexture::Type::RWTexture :
                                                GPUTexture::Type::Texture;
 
-  if (!(m_vram_texture = g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, samples,
-                                                    GPUTexture::Type::RenderTarget, VRAM_RT_FORMAT)) ||
-      (needs_depth_buffer &&
-       !(m_vram_depth_texture = g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, samples,
-                                                           GPUTexture::Type::DepthStencil, VRAM_DS_FORMAT))) ||
-      !(m_vram_read_texture =
-          g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, 1, read_texture_type, VRAM_RT_FORMAT)) ||
+  if (g_settings.gpu_sparse_vram && samples == 1 && g_gpu_device->GetFeatures().sparse_textures &&
+      !CreateSparseVRAMTextures(texture_width, texture_height, needs_depth_buffer))
+  {
+    Log_WarningPrint("Failed to create sparse VRAM textures, falling back to regular textures.");
+  }
+
+  if ((!IsUsingSparseVRAM() &&
+       (!(m_vram_texture = g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, samples,
+                                                      GPUTexture::Type::RenderTarget, VRAM_RT_FORMAT)) ||
+        (needs_depth_buffer &&
+         !(m_vram_depth_texture = g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, samples,
+                                                             GPUTexture::Type::DepthStencil, VRAM_DS_FORMAT))) ||
+        !(m_vram_read_texture = g_gpu_device->FetchTexture(texture_width, texture_height, 1, 1, 1, read_texture_type,
+                                                           VRAM_RT_FORMAT)))) ||
       !(m_vram_readback_texture = g_gpu_device->FetchTexture(VRAM_WIDTH / 2, VRAM_HEIGHT, 1, 1, 1,
                                                              GPUTexture::Type::RenderTarget, VRAM_RT_FORMAT)))
   {
@@ -740,12 +964,169 @@ bool GPU_HW::CreateBuffers()
   return true;
 }
 
+bool GPU_HW::CreateSparseVRAMTextures(u32 width, u32 height, bool needs_depth_buffer)
+{
+  if (!(m_vram_texture = g_gpu_device->CreateSparseTexture(width, height, GPUTexture::Type::RenderTarget,
+                                                           VRAM_RT_FORMAT)) ||
+      (needs_depth_buffer && !(m_vram_depth_texture = g_gpu_device->CreateSparseTexture(
+                                 width, height, GPUTexture::Type::DepthStencil, VRAM_DS_FORMAT))) ||
+      !(m_vram_read_texture =
+          g_gpu_device->CreateSparseTexture(width, height, GPUTexture::Type::Texture, VRAM_RT_FORMAT)))
+  {
+    m_vram_read_texture.reset();
+    m_vram_depth_texture.reset();
+    m_vram_texture.reset();
+    return false;
+  }
+
+  // Tile sizes are powers of two, so the largest is a multiple of the others.
+  u32 block_width = std::max(m_vram_texture->GetSparseTileWidth(), m_vram_read_texture->GetSparseTileWidth());
+  u32 block_height = std::max(m_vram_texture->GetSparseTileHeight(), m_vram_read_texture->GetSparseTileHeight());
+  if (m_vram_depth_texture)
+  {
+    block_width = std::max(block_width, m_vram_depth_texture->GetSparseTileWidth());
+    block_height = std::max(block_height, m_vram_depth_texture->GetSparseTileHeight());
+  }
+  for (const GPUTexture* tex : {m_vram_texture.get(), m_vram_depth_texture.get(), m_vram_read_texture.get()})
+  {
+    if (tex && ((block_width % tex->GetSparseTileWidth()) != 0 || (block_height % tex->GetSparseTileHeight()) != 0))
+    {
+      Log_ErrorFmt("Sparse tile size {}x{} doesn't divide block size {}x{}", tex->GetSparseTileWidth(),
+                   tex->GetSparseTileHeight(), block_width, block_height);
+      m_vram_read_texture.reset();
+      m_vram_depth_texture.reset();
+      m_vram_texture.reset();
+      return false;
+    }
+  }
+
+  m_sparse_vram_block_width = block_width;
+  m_sparse_vram_block_height = block_height;
+  m_sparse_vram_blocks_wide = (width + block_width - 1) / block_width;
+  m_sparse_vram_blocks.assign(m_sparse_vram_blocks_wide * ((height + block_height - 1) / block_height), false);
+  Log_InfoFmt("Using sparse VRAM with {} blocks of {}x{}", m_sparse_vram_blocks.size(), block_width, block_height);
+  return true;
+}
+
+void GPU_HW::CommitSparseVRAM(const Common::Rectangle<u32>& rect)
+{
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  const u32 blocks_high = static_cast<u32>(m_sparse_vram_blocks.size()) / m_sparse_vram_blocks_wide;
+  const u32 end_block_x = std::min((scaled_rect.right + m_sparse_vram_block_width - 1) / m_sparse_vram_block_width,
+                                   m_sparse_vram_blocks_wide);
+  const u32 end_block_y =
+    std::min((scaled_rect.bottom + m_sparse_vram_block_height - 1) / m_sparse_vram_block_height, blocks_high);
+
+  bool committed = false;
+  for (u32 block_y = scaled_rect.top / m_sparse_vram_block_height; block_y < end_block_y; block_y++)
+  {
+    for (u32 block_x = scaled_rect.left / m_sparse_vram_block_width; block_x < end_block_x; block_x++)
+      committed |= CommitSparseVRAMBlock(block_x, block_y);
+  }
+
+  if (committed)
+    RestoreVRAMRenderState();
+}
+
+void GPU_HW::CommitSparseVRAMForWrite(u32 x, u32 y, u32 width, u32 height, const u16* data, u32 data_stride,
+                                      bool set_mask)
+{
+  // Uncommitted blocks already read as zero, so there's no need to back them for a write of zeros. Otherwise, loading
+  // a state would commit the whole of VRAM.
+  if (set_mask || (x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT)
+  {
+    CommitSparseVRAM(GetVRAMTransferBounds(x, y, width, height));
+    return;
+  }
+
+  const u32 scale = m_resolution_scale;
+  const u32 block_width = m_sparse_vram_block_width;
+  const u32 block_height = m_sparse_vram_block_height;
+  bool committed = false;
+  for (u32 block_y = (y * scale) / block_height; (block_y * block_height) < ((y + height) * scale); block_y++)
+  {
+    // Native pixels which overlap this row of blocks.
+    const u32 top = std::max(y, (block_y * block_height) / scale);
+    const u32 bottom = std::min(y + height, ((block_y + 1) * block_height + scale - 1) / scale);
+    for (u32 block_x = (x * scale) / block_width; (block_x * block_width) < ((x + width) * scale); block_x++)
+    {
+      if (m_sparse_vram_blocks[block_y * m_sparse_vram_blocks_wide + block_x])
+        continue;
+
+      const u32 left = std::max(x, (block_x * block_width) / scale);
+      const u32 right = std::min(x + width, ((block_x + 1) * block_width + scale - 1) / scale);
+      bool non_zero = false;
+      for (u32 row = top; row < bottom && !non_zero; row++)
+      {
+        const u16* row_ptr = &data[(row - y) * data_stride + (left - x)];
+        for (u32 col = 0; col < (right - left); col++)
+          non_zero |= (row_ptr[col] != 0);
+      }
+
+      if (non_zero)
+        committed |= CommitSparseVRAMBlock(block_x, block_y);
+    }
+  }
+
+  if (committed)
+    RestoreVRAMRenderState();
+}
+
+bool GPU_HW::CommitSparseVRAMBlock(u32 block_x, u32 block_y)
+{
+  const u32 block_index = block_y * m_sparse_vram_blocks_wide + block_x;
+  if (m_sparse_vram_blocks[block_index])
+    return false;
+
+  // Only try once, otherwise a failed allocation would be retried for every draw.
+  m_sparse_vram_blocks[block_index] = true;
+
+  const u32 left = block_x * m_sparse_vram_block_width;
+  const u32 top = block_y * m_sparse_vram_block_height;
+  const u32 width = std::min(m_sparse_vram_block_width, m_vram_texture->GetWidth() - left);
+  const u32 height = std::min(m_sparse_vram_block_height, m_vram_texture->GetHeight() - top);
+  GL_INS_FMT("Commit sparse VRAM block {},{} => {},{}", left, top, left + width, top + height);
+  if (!m_vram_texture->CommitSparseRegion(left, top, width, height) ||
+      (m_vram_depth_texture && !m_vram_depth_texture->CommitSparseRegion(left, top, width, height)) ||
+      !m_vram_read_texture->CommitSparseRegion(left, top, width, height))
+  {
+    Log_ErrorFmt("Failed to commit sparse VRAM block at {},{}. Things are gonna break.", left, top);
+    return false;
+  }
+
+  // New tiles have undefined contents. Fill them the same way a VRAM fill of black would, which also resets depth.
+  // The read texture is updated from the dirty rectangle before it's sampled.
+  struct VRAMFillUBOData
+  {
+    u32 u_dst_x;
+    u32 u_dst_y;
+    u32 u_end_x;
+    u32 u_end_y;
+    std::array<float, 4> u_fill_color;
+    u32 u_interlaced_displayed_field;
+  };
+  const VRAMFillUBOData uniforms = {left, top, left + width, top + height, {}, 0};
+  g_gpu_device->SetPipeline(m_vram_fill_pipelines[0][0].get());
+  g_gpu_device->SetViewportAndScissor(left, top, width, height);
+  g_gpu_device->PushUniformBuffer(&uniforms, sizeof(uniforms));
+  g_gpu_device->Draw(3, 0);
+
+  IncludeVRAMDirtyRectangle(m_vram_dirty_draw_rect,
+                            Common::Rectangle<u32>(left / m_resolution_scale, top / m_resolution_scale,
+                                                   (left + width + m_resolution_scale - 1) / m_resolution_scale,
+                                                   (top + height + m_resolution_scale - 1) / m_resolution_scale)
+                              .Clamped(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+  return true;
+}
+
 void GPU_HW::ClearFramebuffer()
 {
   g_gpu_device->ClearRenderTarget(m_vram_texture.get(), 0);
   if (m_vram_depth_texture)
     g_gpu_device->ClearDepth(m_vram_depth_texture.get(), m_pgxp_depth_buffer ? 1.0f : 0.0f);
   ClearVRAMDirtyRectangle();
+  m_filtered_texpage_valid_mask = 0;
+  m_display_vram_changed = true;
   m_last_depth_z = 1.0f;
 }
 
@@ -763,8 +1144,12 @@ void GPU_HW::DestroyBuffers()
   if (m_batch_vertex_ptr)
     UnmapGPUBuffer(0, 0);
 
+  m_pending_vram_write_rect.SetInvalid();
+  m_sparse_vram_blocks.clear();
+  m_sparse_vram_draw_rect.SetInvalid();
   m_vram_upload_buffer.reset();
   m_vram_readback_download_texture.reset();
+  DestroyFilteredTexPageCache();
   g_gpu_device->RecycleTexture(std::move(m_downsample_texture));
   g_gpu_device->RecycleTexture(std::move(m_vram_extract_texture));
   g_gpu_device->RecycleTexture(std::move(m_vram_read_texture));
@@ -773,6 +1158,144 @@ void GPU_HW::DestroyBuffers()
   g_gpu_device->RecycleTexture(std::move(m_vram_readback_texture));
 }
 
+std::span<const GPUPipeline::VertexAttribute> GPU_HW::GetBatchVertexAttributes(bool textured, bool uv_limits)
+{
+  static constexpr GPUPipeline::VertexAttribute vertex_attributes[] = {
+    GPUPipeline::VertexAttribute::Make(0, GPUPipeline::VertexAttribute::Semantic::Position, 0,
+                                       GPUPipeline::VertexAttribute::Type::Float, 4, OFFSETOF(BatchVertex, x)),
+    GPUPipeline::VertexAttribute::Make(1, GPUPipeline::VertexAttribute::Semantic::Color, 0,
+                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, color)),
+    GPUPipeline::VertexAttribute::Make(2, GPUPipeline::VertexAttribute::Semantic::TexCoord, 0,
+                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, u)),
+    GPUPipeline::VertexAttribute::Make(3, GPUPipeline::VertexAttribute::Semantic::TexCoord, 1,
+                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, texpage)),
+    GPUPipeline::VertexAttribute::Make(4, GPUPipeline::VertexAttribute::Semantic::TexCoord, 2,
+                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, uv_limits)),
+  };
+  static constexpr u32 NUM_BATCH_VERTEX_ATTRIBUTES = 2;
+  static constexpr u32 NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES = 4;
+  static constexpr u32 NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES = 5;
+
+
+  return std::span<const GPUPipeline::VertexAttribute>(
+    vertex_attributes, textured ? (uv_limits ? NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES :
+                                               NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES) :
+                                  NUM_BATCH_VERTEX_ATTRIBUTES);
+}
+
+void GPU_HW::InitBatchPipelineConfig(GPUPipeline::GraphicsConfig& plconfig) const
+{
+  plconfig = {};
+  plconfig.layout = m_batch_push_constants ? GPUPipeline::Layout::SingleTextureAndPushConstants :
+                                             GPUPipeline::Layout::SingleTextureAndUBO;
+  plconfig.input_layout.vertex_stride = sizeof(BatchVertex);
+  plconfig.rasterization = GPUPipeline::RasterizationState::GetNoCullState();
+  plconfig.primitive = GPUPipeline::Primitive::Triangles;
+  plconfig.geometry_shader = nullptr;
+  plconfig.SetTargetFormats(VRAM_RT_FORMAT, NeedsDepthBuffer() ? VRAM_DS_FORMAT : GPUTexture::Format::Unknown);
+  plconfig.samples = m_multisamples;
+  plconfig.per_sample_shading = m_per_sample_shading;
+  plconfig.render_pass_flags = m_allow_shader_blend ? GPUPipeline::ColorFeedbackLoop : GPUPipeline::NoRenderPassFlags;
+  plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
+}
+
+bool GPU_HW::IsBatchRenderModeUsed(u8 render_mode) const
+{
+  return !(
+    // Can't generate shader blending.
+    (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && !m_allow_shader_blend) ||
+    // Don't need multipass shaders.
+    (m_supports_framebuffer_fetch && (render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
+                                      render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))));
+}
+
+bool GPU_HW::ShouldCacheFilteredTexPages() const
+{
+  // Only worth it for the expensive filters, and at 1x there's nothing to gain over filtering in the draw.
+  if (!g_settings.gpu_texture_filter_cache || m_resolution_scale == 1 ||
+      (m_texture_filtering != GPUTextureFilter::JINC2 && m_texture_filtering != GPUTextureFilter::JINC2BinAlpha &&
+       m_texture_filtering != GPUTextureFilter::xBR && m_texture_filtering != GPUTextureFilter::xBRBinAlpha))
+  {
+    return false;
+  }
+
+  // Needs at least one row of pages.
+  const u32 slot_size = 256u * m_resolution_scale;
+  return ((slot_size * FILTERED_TEXPAGE_CACHE_COLUMNS) <= g_gpu_device->GetMaxTextureSize() &&
+          (FILTERED_TEXPAGE_CACHE_COLUMNS * slot_size * slot_size) <= MAX_FILTERED_TEXPAGE_CACHE_TEXELS);
+}
+
+bool GPU_HW::IsBatchTextureModeUsed(u8 texture_mode) const
+{
+  // The mixed texture mode variants are only used if enabled, or as the fallback while deferred pipelines are built.
+  if (texture_mode == MIXED_TEXTURE_MODE)
+    return (m_batch_mixed_texture_modes || m_defer_pipeline_compilation);
+  else if (texture_mode >= FILTERED_TEXTURE_MODE)
+    return m_filtered_texpage_cache;
+  else
+    return true;
+}
+
+bool GPU_HW::SetBatchPipelineState(GPUPipeline::GraphicsConfig& plconfig, u8 depth_test, u8 transparency_mode,
+                                   u8 render_mode, u8 texture_mode, u8 check_mask) const
+{
+  const GPUTransparencyMode transparency = static_cast<GPUTransparencyMode>(transparency_mode);
+  const BatchRenderMode rmode = static_cast<BatchRenderMode>(render_mode);
+  const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+  const bool use_shader_blending =
+    (rmode == BatchRenderMode::ShaderBlend &&
+     ((textured && NeedsShaderBlending(transparency, (check_mask != 0))) || check_mask));
+
+  plconfig.input_layout.vertex_attributes = GetBatchVertexAttributes(textured, m_clamp_uvs);
+
+  if (NeedsDepthBuffer())
+  {
+    plconfig.depth.depth_test =
+      m_pgxp_depth_buffer ? (depth_test ? GPUPipeline::DepthFunc::LessEqual : GPUPipeline::DepthFunc::Always) :
+                            (check_mask ? GPUPipeline::DepthFunc::GreaterEqual : GPUPipeline::DepthFunc::Always);
+
+    // Don't write for transparent, but still test.
+    plconfig.depth.depth_write = !m_pgxp_depth_buffer || (depth_test && transparency == GPUTransparencyMode::Disabled);
+  }
+
+  plconfig.blend = GPUPipeline::BlendState::GetNoBlendingState();
+
+  const bool blending_pass =
+    (rmode != BatchRenderMode::TransparencyDisabled && rmode != BatchRenderMode::OnlyOpaque);
+  if (!use_shader_blending && ((transparency != GPUTransparencyMode::Disabled && blending_pass) ||
+                               (textured && IsBlendedTextureFiltering(m_texture_filtering))))
+  {
+    plconfig.blend.enable = true;
+    plconfig.blend.src_alpha_blend = GPUPipeline::BlendFunc::One;
+    plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::Zero;
+    plconfig.blend.alpha_blend_op = GPUPipeline::BlendOp::Add;
+    plconfig.blend.blend_op = (transparency == GPUTransparencyMode::BackgroundMinusForeground && blending_pass) ?
+                                GPUPipeline::BlendOp::ReverseSubtract :
+                                GPUPipeline::BlendOp::Add;
+
+    if (m_supports_dual_source_blend)
+    {
+      plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
+      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::SrcAlpha1;
+    }
+    else
+    {
+      // TODO: This isn't entirely accurate, 127.5 versus 128.
+      // But if we use fbfetch on Mali, it doesn't matter.
+      plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
+      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::One;
+      if (transparency == GPUTransparencyMode::HalfBackgroundPlusHalfForeground)
+      {
+        plconfig.blend.dst_blend = GPUPipeline::BlendFunc::ConstantColor;
+        plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::ConstantColor;
+        plconfig.blend.constant = 0x00808080u;
+      }
+    }
+  }
+
+  return use_shader_blending;
+}
+
 bool GPU_HW::CompilePipelines()
 {
   const GPUDevice::Features features = g_gpu_device->GetFeatures();
@@ -785,9 +1308,17 @@ bool GPU_HW::CompilePipelines()
                              m_disable_color_perspective, m_supports_dual_source_blend, m_supports_framebuffer_fetch,
                              m_debanding);
 
-  const u32 total_pipelines = 2 +                                                           // vertex shaders
-                              (5 * 5 * 9 * 2 * 2 * 2) +                                     // fragment shaders
-                              ((m_pgxp_depth_buffer ? 2 : 1) * 5 * 5 * 9 * 2 * 2 * 2) +     // batch pipelines
+  // The mixed texture mode variants don't need dithering.
+  const bool mixed_texture_modes = IsBatchTextureModeUsed(MIXED_TEXTURE_MODE);
+  u8 num_texture_modes = 0;
+  for (u8 texture_mode = 0; texture_mode < NUM_BATCH_TEXTURE_MODES; texture_mode++)
+    num_texture_modes += BoolToUInt8(IsBatchTextureModeUsed(texture_mode));
+
+  const u32 num_batch_variants = 5 * 5 * num_texture_modes * 2 * 2 * 2;
+  const u32 total_pipelines = (2 + BoolToUInt32(mixed_texture_modes) +
+                               BoolToUInt32(m_filtered_texpage_cache)) +                    // vertex shaders
+                              num_batch_variants +                                          // fragment shaders
+                              ((m_pgxp_depth_buffer ? 2 : 1) * num_batch_variants) +        // batch pipelines
                               ((m_wireframe_mode != GPUWireframeMode::Disabled) ? 1 : 0) +  // wireframe
                               1 +                                                           // fullscreen quad VS
                               (2 * 2) +                                                     // vram fill
@@ -797,6 +1328,7 @@ bool GPU_HW::CompilePipelines()
                               (needs_depth_buffer ? 1 : 0) +                                // mask -> depth
                               1 +                                                           // vram read
                               2 +                                                           // extract/display
+                              (m_filtered_texpage_cache ? 2 : 0) +                          // filtered texpage
                               ((m_downsample_mode != GPUDownsampleMode::Disabled) ? 1 : 0); // downsample
 
   ShaderCompileProgressTracker progress("Compiling Pipelines", total_pipelines);
@@ -805,21 +1337,49 @@ bool GPU_HW::CompilePipelines()
   // fragment shaders - [render_mode][transparency_mode][texture_mode][check_mask][dithering][interlacing]
   static constexpr auto destroy_shader = [](std::unique_ptr<GPUShader>& s) { s.reset(); };
   DimensionalArray<std::unique_ptr<GPUShader>, 2> batch_vertex_shaders{};
-  DimensionalArray<std::unique_ptr<GPUShader>, 2, 2, 2, 9, 5, 5> batch_fragment_shaders{};
-  ScopedGuard batch_shader_guard([&batch_vertex_shaders, &batch_fragment_shaders]() {
+  std::unique_ptr<GPUShader> mixed_texture_mode_vertex_shader;
+  std::unique_ptr<GPUShader> filtered_texpage_vertex_shader;
+  DimensionalArray<std::unique_ptr<GPUShader>, 2, 2, 2, NUM_BATCH_TEXTURE_MODES, 5, 5> batch_fragment_shaders{};
+  ScopedGuard batch_shader_guard([&batch_vertex_shaders, &mixed_texture_mode_vertex_shader,
+                                  &filtered_texpage_vertex_shader, &batch_fragment_shaders]() {
     batch_vertex_shaders.enumerate(destroy_shader);
+    mixed_texture_mode_vertex_shader.reset();
+    filtered_texpage_vertex_shader.reset();
     batch_fragment_shaders.enumerate(destroy_shader);
   });
 
   for (u8 textured = 0; textured < 2; textured++)
   {
-    const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured), m_pgxp_depth_buffer);
+    const std::string vs =
+      shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured), false, false, m_pgxp_depth_buffer);
     if (!(batch_vertex_shaders[textured] = g_gpu_device->CreateShader(GPUShaderStage::Vertex, vs)))
       return false;
 
     progress.Increment();
   }
 
+  if (mixed_texture_modes)
+  {
+    const std::string vs = shadergen.GenerateBatchVertexShader(true, true, false, m_pgxp_depth_buffer);
+    if (!(mixed_texture_mode_vertex_shader = g_gpu_device->CreateShader(GPUShaderStage::Vertex, vs)))
+      return false;
+
+    progress.Increment();
+  }
+
+  if (m_filtered_texpage_cache)
+  {
+    const std::string vs = shadergen.GenerateBatchVertexShader(true, false, true, m_pgxp_depth_buffer);
+    if (!(filtered_texpage_vertex_shader = g_gpu_device->CreateShader(GPUShaderStage::Vertex, vs)))
+      return false;
+
+    progress.Increment();
+  }
+
+  // Fragment shaders are the bulk of the compile time, so they're created as one set, letting the device compile them
+  // in parallel.
+  std::vector<GPUDevice::ShaderCompileRequest> fs_requests;
+  std::vector<std::unique_ptr<GPUShader>*> fs_destinations;
   for (u8 render_mode = 0; render_mode < 5; render_mode++)
   {
     for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
@@ -833,12 +1393,30 @@ bool GPU_HW::CompilePipelines()
         (m_supports_framebuffer_fetch && (render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
                                           render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))))
       {
-        progress.Increment(9 * 2 * 2 * 2);
+        progress.Increment(num_texture_modes * 2 * 2 * 2);
         continue;
       }
 
-      for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+      for (u8 texture_mode = 0; texture_mode < NUM_BATCH_TEXTURE_MODES; texture_mode++)
       {
+        if (!IsBatchTextureModeUsed(texture_mode))
+          continue;
+
+        if (m_defer_pipeline_compilation && texture_mode < static_cast<u8>(GPUTextureMode::Disabled))
+        {
+          progress.Increment(2 * 2 * 2);
+          continue;
+        }
+
+        // Mixed and filtered texpage shaders sample as direct, the latter keeps the raw texture bit.
+        const bool mixed_texture_mode = (texture_mode == MIXED_TEXTURE_MODE);
+        const bool filtered_texpage = (texture_mode >= FILTERED_TEXTURE_MODE);
+        GPUTextureMode shader_texture_mode = static_cast<GPUTextureMode>(texture_mode);
+        if (mixed_texture_mode || texture_mode == FILTERED_TEXTURE_MODE)
+          shader_texture_mode = GPUTextureMode::Direct16Bit;
+        else if (texture_mode == FILTERED_RAW_TEXTURE_MODE)
+          shader_texture_mode = GPUTextureMode::RawDirect16Bit;
+
         for (u8 check_mask = 0; check_mask < 2; check_mask++)
         {
           if (check_mask && render_mode != static_cast<u8>(BatchRenderMode::ShaderBlend))
@@ -850,20 +1428,24 @@ bool GPU_HW::CompilePipelines()
 
           for (u8 dithering = 0; dithering < 2; dithering++)
           {
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
+            if (dithering && mixed_texture_mode)
             {
-              const std::string fs = shadergen.GenerateBatchFragmentShader(
-                static_cast<BatchRenderMode>(render_mode), static_cast<GPUTransparencyMode>(transparency_mode),
-                static_cast<GPUTextureMode>(texture_mode), ConvertToBoolUnchecked(dithering),
-                ConvertToBoolUnchecked(interlacing), ConvertToBoolUnchecked(check_mask));
-
-              if (!(batch_fragment_shaders[render_mode][transparency_mode][texture_mode][check_mask][dithering]
-                                          [interlacing] = g_gpu_device->CreateShader(GPUShaderStage::Fragment, fs)))
-              {
-                return false;
-              }
+              progress.Increment(2);
+              continue;
+            }
 
-              progress.Increment();
+            for (u8 interlacing = 0; interlacing < 2; interlacing++)
+            {
+              fs_requests.push_back(GPUDevice::ShaderCompileRequest{
+                GPUShaderStage::Fragment,
+                shadergen.GenerateBatchFragmentShader(
+                  static_cast<BatchRenderMode>(render_mode), static_cast<GPUTransparencyMode>(transparency_mode),
+                  shader_texture_mode, mixed_texture_mode, filtered_texpage, ConvertToBoolUnchecked(dithering),
+                  ConvertToBoolUnchecked(interlacing), ConvertToBoolUnchecked(check_mask)),
+                "main", {}});
+              fs_destinations.push_back(
+                &batch_fragment_shaders[render_mode][transparency_mode][texture_mode][check_mask][dithering]
+                                       [interlacing]);
             }
           }
         }
@@ -871,33 +1453,20 @@ bool GPU_HW::CompilePipelines()
     }
   }
 
-  static constexpr GPUPipeline::VertexAttribute vertex_attributes[] = {
-    GPUPipeline::VertexAttribute::Make(0, GPUPipeline::VertexAttribute::Semantic::Position, 0,
-                                       GPUPipeline::VertexAttribute::Type::Float, 4, OFFSETOF(BatchVertex, x)),
-    GPUPipeline::VertexAttribute::Make(1, GPUPipeline::VertexAttribute::Semantic::Color, 0,
-                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, color)),
-    GPUPipeline::VertexAttribute::Make(2, GPUPipeline::VertexAttribute::Semantic::TexCoord, 0,
-                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, u)),
-    GPUPipeline::VertexAttribute::Make(3, GPUPipeline::VertexAttribute::Semantic::TexCoord, 1,
-                                       GPUPipeline::VertexAttribute::Type::UInt32, 1, OFFSETOF(BatchVertex, texpage)),
-    GPUPipeline::VertexAttribute::Make(4, GPUPipeline::VertexAttribute::Semantic::TexCoord, 2,
-                                       GPUPipeline::VertexAttribute::Type::UNorm8, 4, OFFSETOF(BatchVertex, uv_limits)),
-  };
-  static constexpr u32 NUM_BATCH_VERTEX_ATTRIBUTES = 2;
-  static constexpr u32 NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES = 4;
-  static constexpr u32 NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES = 5;
+  u32 fs_progress = 0;
+  if (!g_gpu_device->CreateShaders(fs_requests, [&progress, &fs_progress](u32 completed) {
+        progress.Increment(completed - fs_progress);
+        fs_progress = completed;
+      }))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < fs_requests.size(); i++)
+    *fs_destinations[i] = std::move(fs_requests[i].shader);
+  fs_requests.clear();
 
   GPUPipeline::GraphicsConfig plconfig = {};
-  plconfig.layout = GPUPipeline::Layout::SingleTextureAndUBO;
-  plconfig.input_layout.vertex_stride = sizeof(BatchVertex);
-  plconfig.rasterization = GPUPipeline::RasterizationState::GetNoCullState();
-  plconfig.primitive = GPUPipeline::Primitive::Triangles;
-  plconfig.geometry_shader = nullptr;
-  plconfig.SetTargetFormats(VRAM_RT_FORMAT, needs_depth_buffer ? VRAM_DS_FORMAT : GPUTexture::Format::Unknown);
-  plconfig.samples = m_multisamples;
-  plconfig.per_sample_shading = m_per_sample_shading;
-  plconfig.render_pass_flags = m_allow_shader_blend ? GPUPipeline::ColorFeedbackLoop : GPUPipeline::NoRenderPassFlags;
-  plconfig.depth = GPUPipeline::DepthState::GetNoTestsState();
+  InitBatchPipelineConfig(plconfig);
 
   // [depth_test][transparency_mode][render_mode][texture_mode][dithering][interlacing][check_mask]
   for (u8 depth_test = 0; depth_test < 2; depth_test++)
@@ -912,41 +1481,45 @@ bool GPU_HW::CompilePipelines()
     {
       for (u8 render_mode = 0; render_mode < 5; render_mode++)
       {
-        if (
-          // Can't generate shader blending.
-          (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) && !m_allow_shader_blend) ||
-          // Don't need multipass shaders.
-          (m_supports_framebuffer_fetch && (render_mode == static_cast<u8>(BatchRenderMode::OnlyOpaque) ||
-                                            render_mode == static_cast<u8>(BatchRenderMode::OnlyTransparent))))
+        if (!IsBatchRenderModeUsed(render_mode))
         {
-          progress.Increment(9 * 2 * 2 * 2);
+          progress.Increment(num_texture_modes * 2 * 2 * 2);
           continue;
         }
 
-        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+        for (u8 texture_mode = 0; texture_mode < NUM_BATCH_TEXTURE_MODES; texture_mode++)
         {
+          if (!IsBatchTextureModeUsed(texture_mode))
+            continue;
+
+          if (m_defer_pipeline_compilation && texture_mode < static_cast<u8>(GPUTextureMode::Disabled))
+          {
+            // Built by CompileDeferredPipelines(), the mixed mode pipelines are used until then.
+            progress.Increment(2 * 2 * 2);
+            continue;
+          }
+
+          const bool mixed_texture_mode = (texture_mode == MIXED_TEXTURE_MODE);
+          const bool filtered_texpage = (texture_mode >= FILTERED_TEXTURE_MODE);
           for (u8 dithering = 0; dithering < 2; dithering++)
           {
+            if (dithering && mixed_texture_mode)
+            {
+              progress.Increment(2 * 2);
+              continue;
+            }
+
             for (u8 interlacing = 0; interlacing < 2; interlacing++)
             {
               for (u8 check_mask = 0; check_mask < 2; check_mask++)
               {
                 const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
                 const bool use_shader_blending =
-                  (render_mode == static_cast<u8>(BatchRenderMode::ShaderBlend) &&
-                   ((textured &&
-                     NeedsShaderBlending(static_cast<GPUTransparencyMode>(transparency_mode), (check_mask != 0))) ||
-                    check_mask));
-
-                plconfig.input_layout.vertex_attributes =
-                  textured ?
-                    (m_clamp_uvs ? std::span<const GPUPipeline::VertexAttribute>(
-                                     vertex_attributes, NUM_BATCH_TEXTURED_LIMITS_VERTEX_ATTRIBUTES) :
-                                   std::span<const GPUPipeline::VertexAttribute>(
-                                     vertex_attributes, NUM_BATCH_TEXTURED_VERTEX_ATTRIBUTES)) :
-                    std::span<const GPUPipeline::VertexAttribute>(vertex_attributes, NUM_BATCH_VERTEX_ATTRIBUTES);
-
-                plconfig.vertex_shader = batch_vertex_shaders[BoolToUInt8(textured)].get();
+                  SetBatchPipelineState(plconfig, depth_test, transparency_mode, render_mode, texture_mode, check_mask);
+
+                plconfig.vertex_shader = mixed_texture_mode ? mixed_texture_mode_vertex_shader.get() :
+                                         filtered_texpage ? filtered_texpage_vertex_shader.get() :
+                                                            batch_vertex_shaders[BoolToUInt8(textured)].get();
                 plconfig.fragment_shader =
                   batch_fragment_shaders[render_mode]
                                         [use_shader_blending ? transparency_mode :
@@ -955,68 +1528,6 @@ bool GPU_HW::CompilePipelines()
                                           .get();
                 Assert(plconfig.vertex_shader && plconfig.fragment_shader);
 
-                if (needs_depth_buffer)
-                {
-                  plconfig.depth.depth_test =
-                    m_pgxp_depth_buffer ?
-                      (depth_test ? GPUPipeline::DepthFunc::LessEqual : GPUPipeline::DepthFunc::Always) :
-                      (check_mask ? GPUPipeline::DepthFunc::GreaterEqual : GPUPipeline::DepthFunc::Always);
-
-                  // Don't write for transparent, but still test.
-                  plconfig.depth.depth_write =
-                    !m_pgxp_depth_buffer ||
-                    (depth_test && transparency_mode == static_cast<u8>(GPUTransparencyMode::Disabled));
-                }
-
-                plconfig.blend = GPUPipeline::BlendState::GetNoBlendingState();
-
-                if (!use_shader_blending &&
-                    ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                      (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                     (textured && IsBlendedTextureFiltering(m_texture_filtering))))
-                {
-                  plconfig.blend.enable = true;
-                  plconfig.blend.src_alpha_blend = GPUPipeline::BlendFunc::One;
-                  plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::Zero;
-                  plconfig.blend.alpha_blend_op = GPUPipeline::BlendOp::Add;
-
-                  if (m_supports_dual_source_blend)
-                  {
-                    plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
-                    plconfig.blend.dst_blend = GPUPipeline::BlendFunc::SrcAlpha1;
-                    plconfig.blend.blend_op =
-                      (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                         GPUTransparencyMode::BackgroundMinusForeground &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                        GPUPipeline::BlendOp::ReverseSubtract :
-                        GPUPipeline::BlendOp::Add;
-                  }
-                  else
-                  {
-                    // TODO: This isn't entirely accurate, 127.5 versus 128.
-                    // But if we use fbfetch on Mali, it doesn't matter.
-                    plconfig.blend.src_blend = GPUPipeline::BlendFunc::One;
-                    plconfig.blend.dst_blend = GPUPipeline::BlendFunc::One;
-                    if (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground)
-                    {
-                      plconfig.blend.dst_blend = GPUPipeline::BlendFunc::ConstantColor;
-                      plconfig.blend.dst_alpha_blend = GPUPipeline::BlendFunc::ConstantColor;
-                      plconfig.blend.constant = 0x00808080u;
-                    }
-
-                    plconfig.blend.blend_op =
-                      (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                         GPUTransparencyMode::BackgroundMinusForeground &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                       static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                        GPUPipeline::BlendOp::ReverseSubtract :
-                        GPUPipeline::BlendOp::Add;
-                  }
-                }
-
                 if (!(m_batch_pipelines[depth_test][transparency_mode][render_mode][texture_mode][dithering]
                                        [interlacing][check_mask] = g_gpu_device->CreatePipeline(plconfig)))
                 {
@@ -1044,8 +1555,7 @@ bool GPU_HW::CompilePipelines()
     GL_OBJECT_NAME(gs, "Batch Wireframe Geometry Shader");
     GL_OBJECT_NAME(fs, "Batch Wireframe Fragment Shader");
 
-    plconfig.input_layout.vertex_attributes =
-      std::span<const GPUPipeline::VertexAttribute>(vertex_attributes, NUM_BATCH_VERTEX_ATTRIBUTES);
+    plconfig.input_layout.vertex_attributes = GetBatchVertexAttributes(false, false);
     plconfig.blend = (m_wireframe_mode == GPUWireframeMode::OverlayWireframe) ?
                        GPUPipeline::BlendState::GetAlphaBlendingState() :
                        GPUPipeline::BlendState::GetNoBlendingState();
@@ -1067,6 +1577,19 @@ bool GPU_HW::CompilePipelines()
     progress.Increment();
   }
 
+  if (m_defer_pipeline_compilation)
+  {
+    m_batch_texture_modes_ready = 0;
+    m_deferred_pipeline_index = 0;
+    LoadPipelineUsage();
+    m_deferred_shadergen = std::make_unique<GPU_HW_ShaderGen>(shadergen);
+    m_deferred_batch_vertex_shader = std::move(batch_vertex_shaders[1]);
+  }
+  else
+  {
+    m_batch_texture_modes_ready = std::numeric_limits<u16>::max();
+  }
+
   batch_shader_guard.Run();
 
   // use a depth of 1, that way writes will reset the depth
@@ -1177,6 +1700,13 @@ bool GPU_HW::CompilePipelines()
     if (!(m_vram_write_replacement_pipeline = g_gpu_device->CreatePipeline(plconfig)))
       return false;
 
+    // Compressed replacements come with mip levels, trilinear filtering avoids shimmering when downscaling them.
+    GPUSampler::Config config = GPUSampler::GetLinearConfig();
+    config.mip_filter = GPUSampler::Filter::Linear;
+    config.max_lod = GPUSampler::Config::LOD_MAX;
+    if (!(m_vram_replacement_sampler = g_gpu_device->CreateSampler(config)))
+      return false;
+
     progress.Increment();
   }
 
@@ -1243,6 +1773,28 @@ bool GPU_HW::CompilePipelines()
     }
   }
 
+  // Filtered texpage cache - [8bit]
+  if (m_filtered_texpage_cache)
+  {
+    for (u8 palette_8bit = 0; palette_8bit < 2; palette_8bit++)
+    {
+      std::unique_ptr<GPUShader> fs = g_gpu_device->CreateShader(
+        GPUShaderStage::Fragment,
+        shadergen.GenerateFilteredTexPageFragmentShader(ConvertToBoolUnchecked(palette_8bit)));
+      if (!fs)
+        return false;
+
+      plconfig.fragment_shader = fs.get();
+
+      if (!(m_filtered_texpage_pipelines[palette_8bit] = g_gpu_device->CreatePipeline(plconfig)))
+        return false;
+
+      GL_OBJECT_NAME_FMT(m_filtered_texpage_pipelines[palette_8bit], "Filtered Texpage Pipeline ({})",
+                         palette_8bit ? "8-bit" : "4-bit");
+      progress.Increment();
+    }
+  }
+
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
     std::unique_ptr<GPUShader> vs =
@@ -1334,6 +1886,12 @@ void GPU_HW::DestroyPipelines()
 
   m_batch_pipelines.enumerate(destroy);
 
+  m_batch_texture_modes_ready = 0;
+  m_deferred_batch_fragment_shaders.enumerate([](std::unique_ptr<GPUShader>& s) { s.reset(); });
+  m_deferred_batch_vertex_shader.reset();
+  m_deferred_shadergen.reset();
+  SavePipelineUsage();
+
   m_vram_fill_pipelines.enumerate(destroy);
 
   for (std::unique_ptr<GPUPipeline>& p : m_vram_write_pipelines)
@@ -1345,9 +1903,13 @@ void GPU_HW::DestroyPipelines()
   for (std::unique_ptr<GPUPipeline>& p : m_vram_extract_pipeline)
     destroy(p);
 
+  for (std::unique_ptr<GPUPipeline>& p : m_filtered_texpage_pipelines)
+    destroy(p);
+
   destroy(m_vram_readback_pipeline);
   destroy(m_vram_update_depth_pipeline);
   destroy(m_vram_write_replacement_pipeline);
+  m_vram_replacement_sampler.reset();
 
   destroy(m_downsample_first_pass_pipeline);
   destroy(m_downsample_mid_pass_pipeline);
@@ -1362,9 +1924,200 @@ GPU_HW::BatchRenderMode GPU_HW::BatchConfig::GetRenderMode() const
                                                               BatchRenderMode::TransparentAndOpaque;
 }
 
+void GPU_HW::CompileDeferredPipelines()
+{
+  // Keep it well under a frame, a single pipeline can take longer than this if it's not in the cache yet.
+  static constexpr double TIME_BUDGET_MS = 4.0;
+
+  // Only groups which have been used are built, in the order they were first used. Unused texture modes never have
+  // their shaders generated or compiled.
+  const u32 num_queued_pipelines = m_num_used_deferred_groups * NUM_DEFERRED_PIPELINES_PER_GROUP;
+  if (!m_deferred_shadergen || m_deferred_pipeline_index == num_queued_pipelines)
+    return;
+
+  GL_SCOPE("CompileDeferredPipelines()");
+
+  Common::Timer timer;
+  GPUPipeline::GraphicsConfig plconfig;
+  InitBatchPipelineConfig(plconfig);
+  plconfig.vertex_shader = m_deferred_batch_vertex_shader.get();
+
+  // [group][depth_test][transparency_mode][render_mode][interlacing][check_mask], group is dithering * 8 + texture_mode
+  while (m_deferred_pipeline_index < num_queued_pipelines)
+  {
+    u32 index = m_deferred_pipeline_index++;
+    const u8 group = m_used_deferred_groups[index / NUM_DEFERRED_PIPELINES_PER_GROUP];
+    index %= NUM_DEFERRED_PIPELINES_PER_GROUP;
+    const u8 check_mask = static_cast<u8>(index % 2);
+    index /= 2;
+    const u8 interlacing = static_cast<u8>(index % 2);
+    index /= 2;
+    const u8 render_mode = static_cast<u8>(index % 5);
+    index /= 5;
+    const u8 transparency_mode = static_cast<u8>(index % 5);
+    index /= 5;
+    const u8 depth_test = static_cast<u8>(index);
+    const u8 texture_mode = group % NUM_DEFERRED_TEXTURE_MODES;
+    const u8 dithering = group / NUM_DEFERRED_TEXTURE_MODES;
+
+    if ((!depth_test || m_pgxp_depth_buffer) && IsBatchRenderModeUsed(render_mode))
+    {
+      const bool use_shader_blending =
+        SetBatchPipelineState(plconfig, depth_test, transparency_mode, render_mode, texture_mode, check_mask);
+      const u8 fs_transparency_mode =
+        use_shader_blending ? transparency_mode : static_cast<u8>(GPUTransparencyMode::Disabled);
+      const u8 fs_check_mask = use_shader_blending ? check_mask : 0;
+
+      std::unique_ptr<GPUShader>& fs =
+        m_deferred_batch_fragment_shaders[render_mode][fs_transparency_mode][texture_mode][fs_check_mask][dithering]
+                                         [interlacing];
+      if (!fs)
+      {
+        fs = g_gpu_device->CreateShader(
+          GPUShaderStage::Fragment,
+          m_deferred_shadergen->GenerateBatchFragmentShader(
+            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTransparencyMode>(fs_transparency_mode),
+            static_cast<GPUTextureMode>(texture_mode), false, false, ConvertToBoolUnchecked(dithering),
+            ConvertToBoolUnchecked(interlacing), ConvertToBoolUnchecked(fs_check_mask)));
+      }
+
+      plconfig.fragment_shader = fs.get();
+      if (!fs || !(m_batch_pipelines[depth_test][transparency_mode][render_mode][texture_mode][dithering][interlacing]
+                                    [check_mask] = g_gpu_device->CreatePipeline(plconfig)))
+      {
+        // Leave this group on the mixed pipelines, and move on to the next.
+        Log_ErrorFmt("Failed to compile deferred pipeline for texture mode {}, dithering {}", texture_mode, dithering);
+        m_deferred_pipeline_index = Common::AlignUp(m_deferred_pipeline_index, NUM_DEFERRED_PIPELINES_PER_GROUP);
+        continue;
+      }
+    }
+
+    if ((m_deferred_pipeline_index % NUM_DEFERRED_PIPELINES_PER_GROUP) == 0)
+    {
+      Log_DevFmt("Deferred pipelines for texture mode {}, dithering {} are ready", texture_mode, dithering);
+      m_batch_texture_modes_ready |= static_cast<u16>(1u << group);
+    }
+
+    if (timer.GetTimeMilliseconds() >= TIME_BUDGET_MS)
+      break;
+  }
+
+  if (m_deferred_pipeline_index == num_queued_pipelines)
+  {
+    // Fragment shaders are specific to a group, so they're not needed once its pipelines are built.
+    m_deferred_batch_fragment_shaders.enumerate([](std::unique_ptr<GPUShader>& s) { s.reset(); });
+    if (num_queued_pipelines == NUM_DEFERRED_PIPELINES)
+    {
+      Log_InfoPrint("All deferred pipelines have been compiled.");
+      m_deferred_batch_vertex_shader.reset();
+      m_deferred_shadergen.reset();
+    }
+    else
+    {
+      Log_DevFmt("Deferred pipelines for {} of {} groups have been compiled.", m_num_used_deferred_groups,
+                 NUM_DEFERRED_GROUPS);
+    }
+  }
+}
+
+std::string GPU_HW::GetPipelineUsageFileName() const
+{
+  const std::string& serial = System::GetGameSerial();
+  return Path::Combine(
+    EmuFolders::Cache,
+    fmt::format("pipeline_usage_{}.cache", serial.empty() ? std::string("bios") : Path::SanitizeFileName(serial)));
+}
+
+void GPU_HW::LoadPipelineUsage()
+{
+  m_num_used_deferred_groups = 0;
+  m_used_deferred_groups_mask = 0;
+  m_used_deferred_groups_dirty = false;
+
+  // Lives alongside the shader cache, so it's not written when that is disabled.
+  m_pipeline_usage_filename = g_settings.gpu_disable_shader_cache ? std::string() : GetPipelineUsageFileName();
+
+  std::unique_ptr<ByteStream> stream =
+    m_pipeline_usage_filename.empty() ?
+      std::unique_ptr<ByteStream>() :
+      ByteStream::OpenFile(m_pipeline_usage_filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  if (stream)
+  {
+    u32 signature, version, num_groups;
+    bool result = (stream->ReadU32(&signature) && signature == PIPELINE_USAGE_SIGNATURE &&
+                   stream->ReadU32(&version) && version == PIPELINE_USAGE_VERSION && stream->ReadU32(&num_groups) &&
+                   num_groups <= NUM_DEFERRED_GROUPS);
+    for (u32 i = 0; result && i < num_groups; i++)
+    {
+      u8 group;
+      result =
+        (stream->ReadU8(&group) && group < NUM_DEFERRED_GROUPS && !(m_used_deferred_groups_mask & (1u << group)));
+      if (result)
+      {
+        m_used_deferred_groups[m_num_used_deferred_groups++] = group;
+        m_used_deferred_groups_mask |= static_cast<u16>(1u << group);
+      }
+    }
+
+    if (!result)
+    {
+      Log_WarningFmt("Discarding corrupted pipeline usage file '{}'", Path::GetFileName(m_pipeline_usage_filename));
+      stream.reset();
+      m_num_used_deferred_groups = 0;
+      m_used_deferred_groups_mask = 0;
+      FileSystem::DeleteFile(m_pipeline_usage_filename.c_str());
+    }
+    else
+    {
+      Log_DevFmt("Loaded {} used pipeline groups from '{}'", m_num_used_deferred_groups,
+                 Path::GetFileName(m_pipeline_usage_filename));
+    }
+  }
+}
+
+void GPU_HW::SavePipelineUsage()
+{
+  if (!m_pipeline_usage_filename.empty() && m_used_deferred_groups_dirty)
+  {
+    Error error;
+    std::unique_ptr<ByteStream> stream =
+      ByteStream::OpenFile(m_pipeline_usage_filename.c_str(),
+                           BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                             BYTESTREAM_OPEN_ATOMIC_UPDATE,
+                           &error);
+    if (!stream)
+    {
+      Log_ErrorFmt("Failed to open pipeline usage file '{}': {}", Path::GetFileName(m_pipeline_usage_filename),
+                   error.GetDescription());
+    }
+    else if (!stream->WriteU32(PIPELINE_USAGE_SIGNATURE) || !stream->WriteU32(PIPELINE_USAGE_VERSION) ||
+             !stream->WriteU32(m_num_used_deferred_groups) ||
+             !stream->Write2(m_used_deferred_groups.data(), m_num_used_deferred_groups) || !stream->Commit())
+    {
+      Log_ErrorFmt("Failed to write pipeline usage file '{}'", Path::GetFileName(m_pipeline_usage_filename));
+      stream->Discard();
+    }
+  }
+
+  m_pipeline_usage_filename = {};
+  m_num_used_deferred_groups = 0;
+  m_used_deferred_groups_dirty = false;
+  m_used_deferred_groups_mask = std::numeric_limits<u16>::max();
+}
+
+void GPU_HW::RecordDeferredGroupUsed(u32 group)
+{
+  DebugAssert(m_num_used_deferred_groups < NUM_DEFERRED_GROUPS);
+  m_used_deferred_groups[m_num_used_deferred_groups++] = static_cast<u8>(group);
+  m_used_deferred_groups_mask |= static_cast<u16>(1u << group);
+  m_used_deferred_groups_dirty = true;
+}
+
 void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
 {
   GL_SCOPE("UpdateVRAMReadTexture()");
+  FlushVRAMWrites();
+  SetTimingRegion(GPUTimingRegion::CopyFill);
 
   const auto update = [this](Common::Rectangle<u32>& rect, u8 dbit) {
     if (m_texpage_dirty & dbit)
@@ -1374,29 +2127,18 @@ void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
         GL_INS_FMT("{} texpage is no longer dirty", (dbit & TEXPAGE_DIRTY_DRAWN_RECT) ? "DRAW" : "WRITE");
     }
 
-    const auto scaled_rect = rect * m_resolution_scale;
-    if (m_vram_texture->IsMultisampled())
+    if (m_vram_texture->IsMultisampled() && !g_gpu_device->GetFeatures().partial_msaa_resolve)
     {
-      if (g_gpu_device->GetFeatures().partial_msaa_resolve)
-      {
-        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                           m_vram_texture.get(), scaled_rect.left, scaled_rect.top,
-                                           scaled_rect.GetWidth(), scaled_rect.GetHeight());
-      }
-      else
-      {
-        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), 0, 0, 0, 0, m_vram_texture.get(), 0, 0,
-                                           m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
-      }
+      g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), 0, 0, 0, 0, m_vram_texture.get(), 0, 0,
+                                         m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
+      m_vram_dirty_tiles.fill(0);
+      m_counters.num_read_texture_updates++;
     }
     else
     {
-      g_gpu_device->CopyTextureRegion(m_vram_read_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                      m_vram_texture.get(), scaled_rect.left, scaled_rect.top, 0, 0,
-                                      scaled_rect.GetWidth(), scaled_rect.GetHeight());
+      CopyDirtyVRAMTiles(rect);
     }
 
-    // m_counters.num_read_texture_updates++;
     rect.SetInvalid();
   };
 
@@ -1431,11 +2173,86 @@ void GPU_HW::UpdateVRAMReadTexture(bool drawn, bool written)
   }
 }
 
+void GPU_HW::UpdateVRAMReadTextureForCopy(const Common::Rectangle<u32>& src_bounds, bool drawn, bool written)
+{
+  // Copies often read a small area out of a large dirty rectangle, e.g. a sprite from a framebuffer which was just
+  // drawn. Updating only the source is much cheaper at high resolution scales. The dirty rectangles are left as they
+  // are, so anything else reading from them still gets a full update.
+  const u32 src_area = src_bounds.GetWidth() * src_bounds.GetHeight();
+  const u32 dirty_area =
+    (drawn ? (m_vram_dirty_draw_rect.GetWidth() * m_vram_dirty_draw_rect.GetHeight()) : 0u) +
+    (written ? (m_vram_dirty_write_rect.GetWidth() * m_vram_dirty_write_rect.GetHeight()) : 0u);
+  if ((m_vram_texture->IsMultisampled() && !g_gpu_device->GetFeatures().partial_msaa_resolve) ||
+      (src_area * 4) > dirty_area)
+  {
+    UpdateVRAMReadTexture(drawn, written);
+    return;
+  }
+
+  GL_SCOPE_FMT("UpdateVRAMReadTextureForCopy({},{} => {},{} ({}x{}))", src_bounds.left, src_bounds.top,
+               src_bounds.right, src_bounds.bottom, src_bounds.GetWidth(), src_bounds.GetHeight());
+  FlushVRAMWrites();
+  SetTimingRegion(GPUTimingRegion::CopyFill);
+  CopyDirtyVRAMTiles(src_bounds);
+}
+
+void GPU_HW::CopyDirtyVRAMTiles(const Common::Rectangle<u32>& rect)
+{
+  const u32 tile_left = rect.left / VRAM_DIRTY_TILE_SIZE;
+  const u32 tile_right =
+    std::min<u32>((rect.right + (VRAM_DIRTY_TILE_SIZE - 1)) / VRAM_DIRTY_TILE_SIZE, VRAM_DIRTY_TILES_WIDE);
+  const u32 tile_top = rect.top / VRAM_DIRTY_TILE_SIZE;
+  const u32 tile_bottom =
+    std::min<u32>((rect.bottom + (VRAM_DIRTY_TILE_SIZE - 1)) / VRAM_DIRTY_TILE_SIZE, VRAM_DIRTY_TILES_HIGH);
+  const u16 column_mask = static_cast<u16>(((1u << tile_right) - 1u) & ~((1u << tile_left) - 1u));
+  const u32 scaled_tile_size = VRAM_DIRTY_TILE_SIZE * m_resolution_scale;
+  const bool resolve = m_vram_texture->IsMultisampled();
+
+  for (u32 tile_y = tile_top; tile_y < tile_bottom;)
+  {
+    // Consecutive rows with the same dirty columns are copied together.
+    const u32 row_mask = m_vram_dirty_tiles[tile_y] & column_mask;
+    u32 end_tile_y = tile_y + 1;
+    while (end_tile_y < tile_bottom && (m_vram_dirty_tiles[end_tile_y] & column_mask) == row_mask)
+      end_tile_y++;
+
+    for (u32 run_mask = row_mask; run_mask != 0;)
+    {
+      const u32 start_tile_x = static_cast<u32>(std::countr_zero(run_mask));
+      const u32 num_tiles_x = static_cast<u32>(std::countr_one(run_mask >> start_tile_x));
+      run_mask &= ~(((1u << num_tiles_x) - 1u) << start_tile_x);
+
+      const u32 x = start_tile_x * scaled_tile_size;
+      const u32 y = tile_y * scaled_tile_size;
+      const u32 width = num_tiles_x * scaled_tile_size;
+      const u32 height = (end_tile_y - tile_y) * scaled_tile_size;
+      GL_INS_FMT("Copying dirty tiles {},{} => {},{}", x, y, x + width, y + height);
+      if (resolve)
+      {
+        g_gpu_device->ResolveTextureRegion(m_vram_read_texture.get(), x, y, 0, 0, m_vram_texture.get(), x, y, width,
+                                           height);
+      }
+      else
+      {
+        g_gpu_device->CopyTextureRegion(m_vram_read_texture.get(), x, y, 0, 0, m_vram_texture.get(), x, y, 0, 0, width,
+                                        height);
+      }
+
+      m_counters.num_read_texture_updates++;
+    }
+
+    for (; tile_y < end_tile_y; tile_y++)
+      m_vram_dirty_tiles[tile_y] &= ~column_mask;
+  }
+}
+
 void GPU_HW::UpdateDepthBufferFromMaskBit()
 {
   if (m_pgxp_depth_buffer || !m_vram_depth_texture)
     return;
 
+  FlushVRAMWrites();
+
   // Viewport should already be set full, only need to fudge the scissor.
   g_gpu_device->SetScissor(0, 0, m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
   g_gpu_device->InvalidateRenderTarget(m_vram_depth_texture.get());
@@ -1450,6 +2267,26 @@ void GPU_HW::UpdateDepthBufferFromMaskBit()
   SetScissor();
 }
 
+void GPU_HW::RescaleVRAM(GPUTexture* src)
+{
+  GL_SCOPE_FMT("RescaleVRAM() {}x{} => {}x{}", src->GetWidth(), src->GetHeight(), m_vram_texture->GetWidth(),
+               m_vram_texture->GetHeight());
+
+  // Nearest sampling always lands within the same native pixel, so texture and palette data written at 1x, which is
+  // the same across the pixel, is preserved exactly.
+  static constexpr float src_rect[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+  src->MakeReadyForSampling();
+  g_gpu_device->SetPipeline(m_vram_write_replacement_pipeline.get());
+  g_gpu_device->SetTextureSampler(0, src, g_gpu_device->GetNearestSampler());
+  g_gpu_device->SetViewportAndScissor(0, 0, m_vram_texture->GetWidth(), m_vram_texture->GetHeight());
+  g_gpu_device->PushUniformBuffer(src_rect, sizeof(src_rect));
+  g_gpu_device->Draw(3, 0);
+
+  // The read texture is refreshed from the new contents as it's needed.
+  SetFullVRAMDirtyRectangle();
+  RestoreVRAMRenderState();
+}
+
 void GPU_HW::ClearDepthBuffer()
 {
   DebugAssert(m_pgxp_depth_buffer);
@@ -1460,10 +2297,11 @@ void GPU_HW::ClearDepthBuffer()
 
 void GPU_HW::SetScissor()
 {
-  const s32 left = m_drawing_area.left * m_resolution_scale;
-  const s32 right = std::max<u32>((m_drawing_area.right + 1) * m_resolution_scale, left + 1);
-  const s32 top = m_drawing_area.top * m_resolution_scale;
-  const s32 bottom = std::max<u32>((m_drawing_area.bottom + 1) * m_resolution_scale, top + 1);
+  const GPUDrawingArea& area = m_render_queue.GetDrawingArea();
+  const s32 left = area.left * m_resolution_scale;
+  const s32 right = std::max<u32>((area.right + 1) * m_resolution_scale, left + 1);
+  const s32 top = area.top * m_resolution_scale;
+  const s32 bottom = std::max<u32>((area.bottom + 1) * m_resolution_scale, top + 1);
 
   g_gpu_device->SetScissor(left, top, right - left, bottom - top);
 }
@@ -1506,6 +2344,8 @@ ALWAYS_INLINE_RELEASE void GPU_HW::DrawBatchVertices(BatchRenderMode render_mode
     render_mode)][static_cast<u8>(m_batch.texture_mode)][BoolToUInt8(m_batch.dithering)]
                                              [BoolToUInt8(m_batch.interlacing)][check_mask]
                                                .get());
+  if (m_batch_push_constants)
+    g_gpu_device->PushUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
 
   if (render_mode != BatchRenderMode::ShaderBlend || m_supports_framebuffer_fetch)
     g_gpu_device->DrawIndexed(num_indices, base_index, base_vertex);
@@ -1513,7 +2353,7 @@ ALWAYS_INLINE_RELEASE void GPU_HW::DrawBatchVertices(BatchRenderMode render_mode
     g_gpu_device->DrawIndexedWithBarrier(num_indices, base_index, base_vertex, GPUDevice::DrawBarrier::Full);
 }
 
-ALWAYS_INLINE_RELEASE void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
+ALWAYS_INLINE_RELEASE void GPU_HW::HandleFlippedQuadTextureCoordinates(PolygonVertices& vertices)
 {
   // Taken from beetle-psx gpu_polygon.cpp
   // For X/Y flipped 2D sprites, PSX games rely on a very specific rasterization behavior. If U or V is decreasing in X
@@ -1529,12 +2369,12 @@ ALWAYS_INLINE_RELEASE void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVert
 
   // It might be faster to do more direct checking here, but the code below handles primitives in any order and
   // orientation, and is far more SIMD-friendly if needed.
-  const float abx = vertices[1].x - vertices[0].x;
-  const float aby = vertices[1].y - vertices[0].y;
-  const float bcx = vertices[2].x - vertices[1].x;
-  const float bcy = vertices[2].y - vertices[1].y;
-  const float cax = vertices[0].x - vertices[2].x;
-  const float cay = vertices[0].y - vertices[2].y;
+  const float abx = vertices.x[1] - vertices.x[0];
+  const float aby = vertices.y[1] - vertices.y[0];
+  const float bcx = vertices.x[2] - vertices.x[1];
+  const float bcy = vertices.y[2] - vertices.y[1];
+  const float cax = vertices.x[0] - vertices.x[2];
+  const float cay = vertices.y[0] - vertices.y[2];
 
   // Hack for Wild Arms 2: The player sprite is drawn one line at a time with a quad, but the bottom V coordinates
   // are set to a large distance from the top V coordinate. When upscaling, this means that the coordinate is
@@ -1543,32 +2383,32 @@ ALWAYS_INLINE_RELEASE void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVert
   // same value, from the first vertex, ensuring no interpolation occurs. Gate it based on the Y distance being one
   // pixel, limiting the risk of false positives.
   if (m_line_detect_mode == GPULineDetectMode::Quads &&
-      (std::max(vertices[0].y, std::max(vertices[1].y, std::max(vertices[2].y, vertices[3].y))) -
-       std::min(vertices[0].y, std::min(vertices[1].y, std::min(vertices[2].y, vertices[3].y)))) == 1.0f) [[unlikely]]
+      (std::max(vertices.y[0], std::max(vertices.y[1], std::max(vertices.y[2], vertices.y[3]))) -
+       std::min(vertices.y[0], std::min(vertices.y[1], std::min(vertices.y[2], vertices.y[3])))) == 1.0f) [[unlikely]]
   {
-    GL_INS_FMT("HLineQuad detected at [{},{}={},{} {},{}={},{} {},{}={},{} {},{}={},{}", vertices[0].x, vertices[0].y,
-               vertices[0].u, vertices[0].v, vertices[1].x, vertices[1].y, vertices[1].u, vertices[1].v, vertices[2].x,
-               vertices[2].y, vertices[2].u, vertices[2].v, vertices[3].x, vertices[3].y, vertices[3].u, vertices[3].v);
-    vertices[1].v = vertices[0].v;
-    vertices[2].v = vertices[0].v;
-    vertices[3].v = vertices[0].v;
+    GL_INS_FMT("HLineQuad detected at [{},{}={},{} {},{}={},{} {},{}={},{} {},{}={},{}", vertices.x[0], vertices.y[0],
+               vertices.u[0], vertices.v[0], vertices.x[1], vertices.y[1], vertices.u[1], vertices.v[1], vertices.x[2],
+               vertices.y[2], vertices.u[2], vertices.v[2], vertices.x[3], vertices.y[3], vertices.u[3], vertices.v[3]);
+    vertices.v[1] = vertices.v[0];
+    vertices.v[2] = vertices.v[0];
+    vertices.v[3] = vertices.v[0];
   }
 
   // Compute static derivatives, just assume W is uniform across the primitive and that the plane equation remains the
   // same across the quad. (which it is, there is no Z.. yet).
-  const float dudx = -aby * static_cast<float>(vertices[2].u) - bcy * static_cast<float>(vertices[0].u) -
-                     cay * static_cast<float>(vertices[1].u);
-  const float dvdx = -aby * static_cast<float>(vertices[2].v) - bcy * static_cast<float>(vertices[0].v) -
-                     cay * static_cast<float>(vertices[1].v);
-  const float dudy = +abx * static_cast<float>(vertices[2].u) + bcx * static_cast<float>(vertices[0].u) +
-                     cax * static_cast<float>(vertices[1].u);
-  const float dvdy = +abx * static_cast<float>(vertices[2].v) + bcx * static_cast<float>(vertices[0].v) +
-                     cax * static_cast<float>(vertices[1].v);
+  const float dudx = -aby * static_cast<float>(vertices.u[2]) - bcy * static_cast<float>(vertices.u[0]) -
+                     cay * static_cast<float>(vertices.u[1]);
+  const float dvdx = -aby * static_cast<float>(vertices.v[2]) - bcy * static_cast<float>(vertices.v[0]) -
+                     cay * static_cast<float>(vertices.v[1]);
+  const float dudy = +abx * static_cast<float>(vertices.u[2]) + bcx * static_cast<float>(vertices.u[0]) +
+                     cax * static_cast<float>(vertices.u[1]);
+  const float dvdy = +abx * static_cast<float>(vertices.v[2]) + bcx * static_cast<float>(vertices.v[0]) +
+                     cax * static_cast<float>(vertices.v[1]);
   const float area = bcx * cay - bcy * cax;
 
   // Detect and reject any triangles with 0 size texture area
-  const s32 texArea = (vertices[1].u - vertices[0].u) * (vertices[2].v - vertices[0].v) -
-                      (vertices[2].u - vertices[0].u) * (vertices[1].v - vertices[0].v);
+  const s32 texArea = (vertices.u[1] - vertices.u[0]) * (vertices.v[2] - vertices.v[0]) -
+                      (vertices.u[2] - vertices.u[0]) * (vertices.v[1] - vertices.v[0]);
 
   // Shouldn't matter as degenerate primitives will be culled anyways.
   if (area == 0.0f || texArea == 0)
@@ -1603,18 +2443,18 @@ ALWAYS_INLINE_RELEASE void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVert
   // Case 4: V is decreasing in Y, but no change in X.
   if ((neg_dudx && zero_dudy) || (neg_dudy && zero_dudx))
   {
-    vertices[0].u++;
-    vertices[1].u++;
-    vertices[2].u++;
-    vertices[3].u++;
+    vertices.u[0]++;
+    vertices.u[1]++;
+    vertices.u[2]++;
+    vertices.u[3]++;
   }
 
   if ((neg_dvdx && zero_dvdy) || (neg_dvdy && zero_dvdx))
   {
-    vertices[0].v++;
-    vertices[1].v++;
-    vertices[2].v++;
-    vertices[3].v++;
+    vertices.v[0]++;
+    vertices.v[1]++;
+    vertices.v[2]++;
+    vertices.v[3]++;
   }
 }
 
@@ -1788,6 +2628,83 @@ void GPU_HW::ComputePolygonUVLimits(u32 texpage, BatchVertex* vertices, u32 num_
     vertices[i].SetUVLimits(min_u, max_u, min_v, max_v);
 }
 
+u32 GPU_HW::ComputePolygonUVLimits(u32 texpage, const PolygonVertices& vertices)
+{
+  // Triangles have the first vertex in the fourth slot, so it can always be included.
+  static_assert(offsetof(PolygonVertices, v) == (offsetof(PolygonVertices, u) + sizeof(u16) * 4));
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  // U and V are at most 256 after flipped quad adjustments, so signed comparisons are fine. Reduces pairs of lanes,
+  // then pairs of pairs, leaving U in lane 0 and V in lane 4. The other lanes are partially against zero.
+  const GSVector4i uv = GSVector4i::load<true>(vertices.u);
+  GSVector4i uv_min = uv.min_i16(uv.srl32<16>());
+  GSVector4i uv_max = uv.max_i16(uv.srl32<16>());
+  uv_min = uv_min.min_i16(uv_min.srl64<32>());
+  uv_max = uv_max.max_i16(uv_max.srl64<32>());
+  const u32 min_u = uv_min.extract16<0>();
+  const u32 min_v = uv_min.extract16<4>();
+  u32 max_u = uv_max.extract16<0>();
+  u32 max_v = uv_max.extract16<4>();
+#else
+  u32 min_u = vertices.u[0], max_u = vertices.u[0], min_v = vertices.v[0], max_v = vertices.v[0];
+  for (u32 i = 1; i < 4; i++)
+  {
+    min_u = std::min<u32>(min_u, vertices.u[i]);
+    max_u = std::max<u32>(max_u, vertices.u[i]);
+    min_v = std::min<u32>(min_v, vertices.v[i]);
+    max_v = std::max<u32>(max_v, vertices.v[i]);
+  }
+#endif
+
+  max_u = (min_u != max_u) ? (max_u - 1) : max_u;
+  max_v = (min_v != max_v) ? (max_v - 1) : max_v;
+
+  CheckForTexPageOverlap(texpage, min_u, min_v, max_u, max_v);
+
+  return BatchVertex::PackUVLimits(min_u, max_u, min_v, max_v);
+}
+
+void GPU_HW::WritePolygonVertices(BatchVertex* dst, const PolygonVertices& vertices, float depth, u32 texpage,
+                                  u32 uv_limits)
+{
+  // Transposes the attribute arrays into vertices, without reading back from the (possibly write-combined) buffer.
+  // Each vertex is stored as a position vector followed by an attribute vector.
+  static_assert(sizeof(BatchVertex) == 32 && offsetof(BatchVertex, color) == 16);
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  const GSVector4 x = GSVector4::load<true>(vertices.x);
+  const GSVector4 y = GSVector4::load<true>(vertices.y);
+  const GSVector4 z = GSVector4::broadcast(depth);
+  const GSVector4 w = GSVector4::load<true>(vertices.w);
+  const GSVector4 xy01 = x.upl(y);
+  const GSVector4 xy23 = x.uph(y);
+  const GSVector4 zw01 = z.upl(w);
+  const GSVector4 zw23 = z.uph(w);
+
+  const GSVector4i color = GSVector4i::load<true>(vertices.color);
+  const GSVector4i tp = GSVector4i::broadcast32(texpage);
+  const GSVector4i uv = GSVector4i::loadl(vertices.u).upl16(GSVector4i::loadl(vertices.v));
+  const GSVector4i limits = GSVector4i::broadcast32(uv_limits);
+  const GSVector4i ct01 = color.upl32(tp);
+  const GSVector4i ct23 = color.uph32(tp);
+  const GSVector4i ul01 = uv.upl32(limits);
+  const GSVector4i ul23 = uv.uph32(limits);
+
+  GSVector4::store<false>(&dst[0].x, xy01.upld(zw01));
+  GSVector4i::store<false>(&dst[0].color, ct01.upl64(ul01));
+  GSVector4::store<false>(&dst[1].x, xy01.uphd(zw01));
+  GSVector4i::store<false>(&dst[1].color, ct01.uph64(ul01));
+  GSVector4::store<false>(&dst[2].x, xy23.upld(zw23));
+  GSVector4i::store<false>(&dst[2].color, ct23.upl64(ul23));
+  GSVector4::store<false>(&dst[3].x, xy23.uphd(zw23));
+  GSVector4i::store<false>(&dst[3].color, ct23.uph64(ul23));
+#else
+  for (u32 i = 0; i < 4; i++)
+  {
+    dst[i].Set(vertices.x[i], vertices.y[i], depth, vertices.w[i], vertices.color[i], texpage, vertices.u[i],
+               vertices.v[i], uv_limits);
+  }
+#endif
+}
+
 void GPU_HW::SetBatchDepthBuffer(bool enabled)
 {
   if (m_batch.use_depth_buffer == enabled)
@@ -1795,27 +2712,27 @@ void GPU_HW::SetBatchDepthBuffer(bool enabled)
 
   if (m_batch_index_count > 0)
   {
-    FlushRender();
+    FlushBatch();
     EnsureVertexBufferSpaceForCurrentCommand();
   }
 
   m_batch.use_depth_buffer = enabled;
 }
 
-void GPU_HW::CheckForDepthClear(const BatchVertex* vertices, u32 num_vertices)
+void GPU_HW::CheckForDepthClear(const PolygonVertices& vertices, u32 num_vertices)
 {
   DebugAssert(num_vertices == 3 || num_vertices == 4);
   float average_z;
   if (num_vertices == 3)
-    average_z = std::min((vertices[0].w + vertices[1].w + vertices[2].w) / 3.0f, 1.0f);
+    average_z = std::min((vertices.w[0] + vertices.w[1] + vertices.w[2]) / 3.0f, 1.0f);
   else
-    average_z = std::min((vertices[0].w + vertices[1].w + vertices[2].w + vertices[3].w) / 4.0f, 1.0f);
+    average_z = std::min((vertices.w[0] + vertices.w[1] + vertices.w[2] + vertices.w[3]) / 4.0f, 1.0f);
 
   if ((average_z - m_last_depth_z) >= g_settings.gpu_pgxp_depth_clear_threshold)
   {
     if (m_batch_index_count > 0)
     {
-      FlushRender();
+      FlushBatch();
       EnsureVertexBufferSpaceForCurrentCommand();
     }
 
@@ -1934,447 +2851,264 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   m_batch_index_space -= 6;
 }
 
-void GPU_HW::LoadVertices()
+void GPU_HW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
 {
-  if (m_GPUSTAT.check_mask_before_draw)
-    m_current_depth++;
-
-  const GPURenderCommand rc{m_render_command.bits};
-  const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg.bits) << 16);
+  // assume quad, in case of expansion
+  const GPURenderCommand rc{cmd->rc.bits};
+  const u32 texpage = PrepareDraw(cmd, 4, 6);
   const float depth = GetCurrentNormalizedVertexDepth();
+  const bool textured = rc.texture_enable;
 
-  switch (rc.primitive)
+  const u32 num_vertices = cmd->num_vertices;
+  PolygonVertices vertices;
+  for (u32 i = 0; i < num_vertices; i++)
   {
-    case GPUPrimitive::Polygon:
-    {
-      const u32 first_color = rc.color_for_first_vertex;
-      const bool shaded = rc.shading_enable;
-      const bool textured = rc.texture_enable;
-      const bool pgxp = g_settings.gpu_pgxp_enable;
+    const GPUBackendDrawPrecisePolygonCommand::Vertex& vert = cmd->vertices[i];
+    vertices.x[i] = vert.x;
+    vertices.y[i] = vert.y;
+    vertices.w[i] = vert.w;
+    vertices.color[i] = vert.color;
+    vertices.u[i] = vert.texcoord & 0xFF;
+    vertices.v[i] = vert.texcoord >> 8;
+  }
 
-      const u32 num_vertices = rc.quad_polygon ? 4 : 3;
-      std::array<BatchVertex, 4> vertices;
-      std::array<std::array<s32, 2>, 4> native_vertex_positions;
-      std::array<u16, 4> native_texcoords;
-      bool valid_w = g_settings.gpu_pgxp_texture_correction;
-      for (u32 i = 0; i < num_vertices; i++)
-      {
-        const u32 color = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
-        const u64 maddr_and_pos = m_fifo.Pop();
-        const GPUVertexPosition vp{Truncate32(maddr_and_pos)};
-        const u16 texcoord = textured ? Truncate16(FifoPop()) : 0;
-        const s32 native_x = m_drawing_offset.x + vp.x;
-        const s32 native_y = m_drawing_offset.y + vp.y;
-        native_vertex_positions[i][0] = native_x;
-        native_vertex_positions[i][1] = native_y;
-        native_texcoords[i] = texcoord;
-        vertices[i].Set(static_cast<float>(native_x), static_cast<float>(native_y), depth, 1.0f, color, texpage,
-                        texcoord, 0xFFFF0000u);
+  if (!cmd->valid_w)
+  {
+    SetBatchDepthBuffer(false);
+  }
+  else if (m_pgxp_depth_buffer)
+  {
+    SetBatchDepthBuffer(true);
+    CheckForDepthClear(vertices, num_vertices);
+  }
 
-        if (pgxp)
-        {
-          valid_w &= CPU::PGXP::GetPreciseVertex(Truncate32(maddr_and_pos >> 32), vp.bits, native_x, native_y,
-                                                 m_drawing_offset.x, m_drawing_offset.y, &vertices[i].x, &vertices[i].y,
-                                                 &vertices[i].w);
-        }
-      }
-      if (pgxp)
-      {
-        if (!valid_w)
-        {
-          SetBatchDepthBuffer(false);
-          for (BatchVertex& v : vertices)
-            v.w = 1.0f;
-        }
-        else if (m_pgxp_depth_buffer)
-        {
-          SetBatchDepthBuffer(true);
-          CheckForDepthClear(vertices.data(), num_vertices);
-        }
-      }
+  // The fourth vertex of a triangle is never drawn, but keeps the UV range and vertex stores branch-free.
+  if (!rc.quad_polygon)
+  {
+    vertices.x[3] = vertices.x[0];
+    vertices.y[3] = vertices.y[0];
+    vertices.w[3] = vertices.w[0];
+    vertices.color[3] = vertices.color[0];
+    vertices.u[3] = vertices.u[0];
+    vertices.v[3] = vertices.v[0];
+  }
 
-      // Use PGXP to exclude primitives that are definitely 3D.
-      const bool is_3d = (vertices[0].w != vertices[1].w || vertices[0].w != vertices[2].w);
-      if (m_resolution_scale > 1 && !is_3d && rc.quad_polygon)
-        HandleFlippedQuadTextureCoordinates(vertices.data());
+  // Use PGXP to exclude primitives that are definitely 3D.
+  const bool is_3d = (vertices.w[0] != vertices.w[1] || vertices.w[0] != vertices.w[2]);
+  if (m_resolution_scale > 1 && !is_3d && rc.quad_polygon)
+    HandleFlippedQuadTextureCoordinates(vertices);
 
-      if (m_compute_uv_range && textured)
-        ComputePolygonUVLimits(texpage, vertices.data(), num_vertices);
+  const u32 uv_limits = (m_compute_uv_range && textured) ? ComputePolygonUVLimits(texpage, vertices) : 0xFFFF0000u;
 
-      if (!IsDrawingAreaIsValid()) [[unlikely]]
-        return;
+  // Always writes four vertices, space is reserved for quads regardless.
+  const u32 start_index = m_batch_vertex_count;
+  DebugAssert(m_batch_vertex_space >= 4);
+  WritePolygonVertices(m_batch_vertex_ptr, vertices, depth, texpage, uv_limits);
+  m_batch_vertex_ptr += num_vertices;
+  m_batch_vertex_count += num_vertices;
+  m_batch_vertex_space -= num_vertices;
+
+  // Cull polygons which are too large.
+  const auto [min_x_12, max_x_12] = MinMax(cmd->vertices[1].native_x, cmd->vertices[2].native_x);
+  const auto [min_y_12, max_y_12] = MinMax(cmd->vertices[1].native_y, cmd->vertices[2].native_y);
+  const s32 min_x = std::min(min_x_12, cmd->vertices[0].native_x);
+  const s32 max_x = std::max(max_x_12, cmd->vertices[0].native_x);
+  const s32 min_y = std::min(min_y_12, cmd->vertices[0].native_y);
+  const s32 max_y = std::max(max_y_12, cmd->vertices[0].native_y);
+  const bool first_tri_culled = ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT);
+
+  if (!first_tri_culled)
+  {
+    // TODO: Cull triangles that fall entirely off-screen.
+    IncludeDrawnDirtyRectangle(min_x, min_y, max_x, max_y);
+
+    DebugAssert(m_batch_index_space >= 3);
+    *(m_batch_index_ptr++) = Truncate16(start_index);
+    *(m_batch_index_ptr++) = Truncate16(start_index + 1);
+    *(m_batch_index_ptr++) = Truncate16(start_index + 2);
+    m_batch_index_count += 3;
+    m_batch_index_space -= 3;
+  }
 
-      const u32 start_index = m_batch_vertex_count;
-      if (rc.quad_polygon)
-      {
-        DebugAssert(m_batch_vertex_space >= 4);
-        std::memcpy(m_batch_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 4);
-        m_batch_vertex_ptr += 4;
-        m_batch_vertex_count += 4;
-        m_batch_vertex_space -= 4;
-      }
-      else
-      {
-        DebugAssert(m_batch_vertex_space >= 3);
-        std::memcpy(m_batch_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 3);
-        m_batch_vertex_ptr += 3;
-        m_batch_vertex_count += 3;
-        m_batch_vertex_space -= 3;
-      }
+  // quads
+  if (rc.quad_polygon)
+  {
+    const s32 min_x_123 = std::min(min_x_12, cmd->vertices[3].native_x);
+    const s32 max_x_123 = std::max(max_x_12, cmd->vertices[3].native_x);
+    const s32 min_y_123 = std::min(min_y_12, cmd->vertices[3].native_y);
+    const s32 max_y_123 = std::max(max_y_12, cmd->vertices[3].native_y);
 
-      // Cull polygons which are too large.
-      const auto [min_x_12, max_x_12] = MinMax(native_vertex_positions[1][0], native_vertex_positions[2][0]);
-      const auto [min_y_12, max_y_12] = MinMax(native_vertex_positions[1][1], native_vertex_positions[2][1]);
-      const s32 min_x = std::min(min_x_12, native_vertex_positions[0][0]);
-      const s32 max_x = std::max(max_x_12, native_vertex_positions[0][0]);
-      const s32 min_y = std::min(min_y_12, native_vertex_positions[0][1]);
-      const s32 max_y = std::max(max_y_12, native_vertex_positions[0][1]);
-      const bool first_tri_culled = ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT);
+    // Cull polygons which are too large.
+    if ((max_x_123 - min_x_123) < MAX_PRIMITIVE_WIDTH && (max_y_123 - min_y_123) < MAX_PRIMITIVE_HEIGHT)
+    {
+      IncludeDrawnDirtyRectangle(min_x_123, min_y_123, max_x_123, max_y_123);
+
+      DebugAssert(m_batch_index_space >= 3);
+      *(m_batch_index_ptr++) = Truncate16(start_index + 2);
+      *(m_batch_index_ptr++) = Truncate16(start_index + 1);
+      *(m_batch_index_ptr++) = Truncate16(start_index + 3);
+      m_batch_index_count += 3;
+      m_batch_index_space -= 3;
+    }
+  }
+  else
+  {
+    // Expand lines to triangles (Doom, Soul Blade, etc.)
+    if (m_line_detect_mode >= GPULineDetectMode::BasicTriangles && !is_3d && !first_tri_culled)
+    {
+      std::array<BatchVertex, 4> line_vertices;
+      WritePolygonVertices(line_vertices.data(), vertices, depth, texpage, uv_limits);
+      ExpandLineTriangles(line_vertices.data(), start_index);
+    }
+  }
+}
 
-      if (first_tri_culled)
-      {
-        Log_DebugFmt("Culling too-large polygon: {},{} {},{} {},{}", native_vertex_positions[0][0],
-                     native_vertex_positions[0][1], native_vertex_positions[1][0], native_vertex_positions[1][1],
-                     native_vertex_positions[2][0], native_vertex_positions[2][1]);
-      }
-      else
-      {
-        // TODO: Cull triangles that fall entirely off-screen.
-        IncludeDrawnDirtyRectangle(min_x, min_y, max_x, max_y);
-
-        AddDrawTriangleTicks(native_vertex_positions[0][0], native_vertex_positions[0][1],
-                             native_vertex_positions[1][0], native_vertex_positions[1][1],
-                             native_vertex_positions[2][0], native_vertex_positions[2][1], rc.shading_enable,
-                             rc.texture_enable, rc.transparency_enable);
-
-        DebugAssert(m_batch_index_space >= 3);
-        *(m_batch_index_ptr++) = Truncate16(start_index);
-        *(m_batch_index_ptr++) = Truncate16(start_index + 1);
-        *(m_batch_index_ptr++) = Truncate16(start_index + 2);
-        m_batch_index_count += 3;
-        m_batch_index_space -= 3;
-      }
+void GPU_HW::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  const u32 texpage = PrepareDraw(cmd, MAX_VERTICES_FOR_RECTANGLE, MAX_VERTICES_FOR_RECTANGLE); // TODO: WRong
+  const float depth = GetCurrentNormalizedVertexDepth();
+  const u32 color = cmd->color;
+  const s32 pos_x = cmd->x;
+  const s32 pos_y = cmd->y;
+  const s32 rectangle_width = cmd->width;
+  const s32 rectangle_height = cmd->height;
+  const u16 orig_tex_left = cmd->texcoord & 0xFF;
+  const u16 orig_tex_top = cmd->texcoord >> 8;
+
+  // we can split the rectangle up into potentially 8 quads
+  SetBatchDepthBuffer(false);
+  DebugAssert(m_batch_vertex_space >= MAX_VERTICES_FOR_RECTANGLE && m_batch_index_space >= MAX_VERTICES_FOR_RECTANGLE);
+
+  // Split the rectangle into multiple quads if it's greater than 256x256, as the texture page should repeat.
+  u16 tex_top = orig_tex_top;
+  for (s32 y_offset = 0; y_offset < rectangle_height;)
+  {
+    const s32 quad_height = std::min<s32>(rectangle_height - y_offset, TEXTURE_PAGE_WIDTH - tex_top);
+    const float quad_start_y = static_cast<float>(pos_y + y_offset);
+    const float quad_end_y = quad_start_y + static_cast<float>(quad_height);
+    const u16 tex_bottom = tex_top + static_cast<u16>(quad_height);
 
-      // quads
-      if (rc.quad_polygon)
-      {
-        const s32 min_x_123 = std::min(min_x_12, native_vertex_positions[3][0]);
-        const s32 max_x_123 = std::max(max_x_12, native_vertex_positions[3][0]);
-        const s32 min_y_123 = std::min(min_y_12, native_vertex_positions[3][1]);
-        const s32 max_y_123 = std::max(max_y_12, native_vertex_positions[3][1]);
-
-        // Cull polygons which are too large.
-        if ((max_x_123 - min_x_123) >= MAX_PRIMITIVE_WIDTH || (max_y_123 - min_y_123) >= MAX_PRIMITIVE_HEIGHT)
-        {
-          Log_DebugFmt("Culling too-large polygon (quad second half): {},{} {},{} {},{}", native_vertex_positions[2][0],
-                       native_vertex_positions[2][1], native_vertex_positions[1][0], native_vertex_positions[1][1],
-                       native_vertex_positions[0][0], native_vertex_positions[0][1]);
-        }
-        else
-        {
-          IncludeDrawnDirtyRectangle(min_x_123, min_y_123, max_x_123, max_y_123);
-
-          AddDrawTriangleTicks(native_vertex_positions[2][0], native_vertex_positions[2][1],
-                               native_vertex_positions[1][0], native_vertex_positions[1][1],
-                               native_vertex_positions[3][0], native_vertex_positions[3][1], rc.shading_enable,
-                               rc.texture_enable, rc.transparency_enable);
-
-          DebugAssert(m_batch_index_space >= 3);
-          *(m_batch_index_ptr++) = Truncate16(start_index + 2);
-          *(m_batch_index_ptr++) = Truncate16(start_index + 1);
-          *(m_batch_index_ptr++) = Truncate16(start_index + 3);
-          m_batch_index_count += 3;
-          m_batch_index_space -= 3;
-        }
-      }
-      else
-      {
-        // Expand lines to triangles (Doom, Soul Blade, etc.)
-        if (m_line_detect_mode >= GPULineDetectMode::BasicTriangles && !is_3d && !first_tri_culled)
-          ExpandLineTriangles(vertices.data(), start_index);
-      }
-
-      if (m_sw_renderer)
-      {
-        GPUBackendDrawPolygonCommand* cmd = m_sw_renderer->NewDrawPolygonCommand(num_vertices);
-        FillDrawCommand(cmd, rc);
-
-        const u32 sw_num_vertices = rc.quad_polygon ? 4 : 3;
-        for (u32 i = 0; i < sw_num_vertices; i++)
-        {
-          GPUBackendDrawPolygonCommand::Vertex* vert = &cmd->vertices[i];
-          vert->x = native_vertex_positions[i][0];
-          vert->y = native_vertex_positions[i][1];
-          vert->texcoord = native_texcoords[i];
-          vert->color = vertices[i].color;
-        }
-
-        m_sw_renderer->PushCommand(cmd);
-      }
-    }
-    break;
-
-    case GPUPrimitive::Rectangle:
+    u16 tex_left = orig_tex_left;
+    for (s32 x_offset = 0; x_offset < rectangle_width;)
     {
-      const u32 color = rc.color_for_first_vertex;
-      const GPUVertexPosition vp{FifoPop()};
-      const s32 pos_x = TruncateGPUVertexPosition(m_drawing_offset.x + vp.x);
-      const s32 pos_y = TruncateGPUVertexPosition(m_drawing_offset.y + vp.y);
-
-      const auto [texcoord_x, texcoord_y] = UnpackTexcoord(rc.texture_enable ? Truncate16(FifoPop()) : 0);
-      u16 orig_tex_left = ZeroExtend16(texcoord_x);
-      u16 orig_tex_top = ZeroExtend16(texcoord_y);
-      s32 rectangle_width;
-      s32 rectangle_height;
-      switch (rc.rectangle_size)
-      {
-        case GPUDrawRectangleSize::R1x1:
-          rectangle_width = 1;
-          rectangle_height = 1;
-          break;
-        case GPUDrawRectangleSize::R8x8:
-          rectangle_width = 8;
-          rectangle_height = 8;
-          break;
-        case GPUDrawRectangleSize::R16x16:
-          rectangle_width = 16;
-          rectangle_height = 16;
-          break;
-        default:
-        {
-          const u32 width_and_height = FifoPop();
-          rectangle_width = static_cast<s32>(width_and_height & VRAM_WIDTH_MASK);
-          rectangle_height = static_cast<s32>((width_and_height >> 16) & VRAM_HEIGHT_MASK);
+      const s32 quad_width = std::min<s32>(rectangle_width - x_offset, TEXTURE_PAGE_HEIGHT - tex_left);
+      const float quad_start_x = static_cast<float>(pos_x + x_offset);
+      const float quad_end_x = quad_start_x + static_cast<float>(quad_width);
+      const u16 tex_right = tex_left + static_cast<u16>(quad_width);
+      const u32 uv_limits = BatchVertex::PackUVLimits(tex_left, tex_right - 1, tex_top, tex_bottom - 1);
+
+      CheckForTexPageOverlap(texpage, tex_left, tex_top, tex_right - 1, tex_bottom - 1);
+
+      const u32 base_vertex = m_batch_vertex_count;
+      (m_batch_vertex_ptr++)
+        ->Set(quad_start_x, quad_start_y, depth, 1.0f, color, texpage, tex_left, tex_top, uv_limits);
+      (m_batch_vertex_ptr++)
+        ->Set(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
+      (m_batch_vertex_ptr++)
+        ->Set(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
+      (m_batch_vertex_ptr++)
+        ->Set(quad_end_x, quad_end_y, depth, 1.0f, color, texpage, tex_right, tex_bottom, uv_limits);
+      m_batch_vertex_count += 4;
+      m_batch_vertex_space -= 4;
+
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 0);
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 1);
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 2);
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 2);
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 1);
+      *(m_batch_index_ptr++) = Truncate16(base_vertex + 3);
+      m_batch_index_count += 6;
+      m_batch_index_space -= 6;
+
+      x_offset += quad_width;
+      tex_left = 0;
+    }
 
-          if (rectangle_width >= MAX_PRIMITIVE_WIDTH || rectangle_height >= MAX_PRIMITIVE_HEIGHT)
-          {
-            Log_DebugFmt("Culling too-large rectangle: {},{} {}x{}", pos_x, pos_y, rectangle_width, rectangle_height);
-            return;
-          }
-        }
-        break;
-      }
+    y_offset += quad_height;
+    tex_top = 0;
+  }
 
-      if (!IsDrawingAreaIsValid()) [[unlikely]]
-        return;
+  IncludeDrawnDirtyRectangle(pos_x, pos_y, pos_x + rectangle_width, pos_y + rectangle_height);
+}
 
-      // we can split the rectangle up into potentially 8 quads
-      SetBatchDepthBuffer(false);
-      DebugAssert(m_batch_vertex_space >= MAX_VERTICES_FOR_RECTANGLE &&
-                  m_batch_index_space >= MAX_VERTICES_FOR_RECTANGLE);
+void GPU_HW::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  // Multiply by two because we don't use line strips.
+  const u32 num_vertices = cmd->num_vertices;
+  PrepareDraw(cmd, num_vertices * 4, num_vertices * 6);
+  const float depth = GetCurrentNormalizedVertexDepth();
+  SetBatchDepthBuffer(false);
+  DebugAssert(m_batch_vertex_space >= (num_vertices * 4) && m_batch_index_space >= (num_vertices * 6));
 
-      // Split the rectangle into multiple quads if it's greater than 256x256, as the texture page should repeat.
-      u16 tex_top = orig_tex_top;
-      for (s32 y_offset = 0; y_offset < rectangle_height;)
-      {
-        const s32 quad_height = std::min<s32>(rectangle_height - y_offset, TEXTURE_PAGE_WIDTH - tex_top);
-        const float quad_start_y = static_cast<float>(pos_y + y_offset);
-        const float quad_end_y = quad_start_y + static_cast<float>(quad_height);
-        const u16 tex_bottom = tex_top + static_cast<u16>(quad_height);
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    const GPUBackendDrawLineCommand::Vertex& start = cmd->vertices[i - 1];
+    const GPUBackendDrawLineCommand::Vertex& end = cmd->vertices[i];
+    const auto [min_x, max_x] = MinMax(start.x, end.x);
+    const auto [min_y, max_y] = MinMax(start.y, end.y);
+    if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
+      continue;
 
-        u16 tex_left = orig_tex_left;
-        for (s32 x_offset = 0; x_offset < rectangle_width;)
-        {
-          const s32 quad_width = std::min<s32>(rectangle_width - x_offset, TEXTURE_PAGE_HEIGHT - tex_left);
-          const float quad_start_x = static_cast<float>(pos_x + x_offset);
-          const float quad_end_x = quad_start_x + static_cast<float>(quad_width);
-          const u16 tex_right = tex_left + static_cast<u16>(quad_width);
-          const u32 uv_limits = BatchVertex::PackUVLimits(tex_left, tex_right - 1, tex_top, tex_bottom - 1);
-
-          CheckForTexPageOverlap(texpage, tex_left, tex_top, tex_right - 1, tex_bottom - 1);
-
-          const u32 base_vertex = m_batch_vertex_count;
-          (m_batch_vertex_ptr++)
-            ->Set(quad_start_x, quad_start_y, depth, 1.0f, color, texpage, tex_left, tex_top, uv_limits);
-          (m_batch_vertex_ptr++)
-            ->Set(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
-          (m_batch_vertex_ptr++)
-            ->Set(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
-          (m_batch_vertex_ptr++)
-            ->Set(quad_end_x, quad_end_y, depth, 1.0f, color, texpage, tex_right, tex_bottom, uv_limits);
-          m_batch_vertex_count += 4;
-          m_batch_vertex_space -= 4;
-
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 0);
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 1);
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 2);
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 2);
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 1);
-          *(m_batch_index_ptr++) = Truncate16(base_vertex + 3);
-          m_batch_index_count += 6;
-          m_batch_index_space -= 6;
-
-          x_offset += quad_width;
-          tex_left = 0;
-        }
+    IncludeDrawnDirtyRectangle(min_x, min_y, max_x + 1, max_y + 1);
 
-        y_offset += quad_height;
-        tex_top = 0;
-      }
+    // TODO: Should we do a PGXP lookup here? Most lines are 2D.
+    DrawLine(static_cast<float>(start.x), static_cast<float>(start.y), start.color, static_cast<float>(end.x),
+             static_cast<float>(end.y), end.color, depth);
+  }
+}
 
-      IncludeDrawnDirtyRectangle(pos_x, pos_y, pos_x + rectangle_width, pos_y + rectangle_height);
-      AddDrawRectangleTicks(pos_x, pos_y, rectangle_width, rectangle_height, rc.texture_enable, rc.transparency_enable);
+bool GPU_HW::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
+                                        u32 height)
+{
+  SetTimingRegion(GPUTimingRegion::CopyFill);
 
-      if (m_sw_renderer)
+  if (tex->IsCompressed())
+  {
+    // Uploaded with the whole mip chain, so the texture has to match exactly.
+    if (!m_vram_replacement_texture || m_vram_replacement_texture->GetFormat() != tex->GetFormat() ||
+        m_vram_replacement_texture->GetWidth() != tex->GetWidth() ||
+        m_vram_replacement_texture->GetHeight() != tex->GetHeight() ||
+        m_vram_replacement_texture->GetLevels() != tex->GetLevels() ||
+        g_gpu_device->GetFeatures().prefer_unused_textures)
+    {
+      g_gpu_device->RecycleTexture(std::move(m_vram_replacement_texture));
+      if (!(m_vram_replacement_texture = g_gpu_device->FetchTexture(tex->GetWidth(), tex->GetHeight(), 1,
+                                                                    tex->GetLevels(), 1, GPUTexture::Type::Texture,
+                                                                    tex->GetFormat())))
       {
-        GPUBackendDrawRectangleCommand* cmd = m_sw_renderer->NewDrawRectangleCommand();
-        FillDrawCommand(cmd, rc);
-        cmd->color = color;
-        cmd->x = pos_x;
-        cmd->y = pos_y;
-        cmd->width = static_cast<u16>(rectangle_width);
-        cmd->height = static_cast<u16>(rectangle_height);
-        cmd->texcoord = (static_cast<u16>(texcoord_y) << 8) | static_cast<u16>(texcoord_x);
-        m_sw_renderer->PushCommand(cmd);
+        return false;
       }
     }
-    break;
 
-    case GPUPrimitive::Line:
+    for (u32 level = 0; level < tex->GetLevels(); level++)
     {
-      SetBatchDepthBuffer(false);
-
-      if (!rc.polyline)
-      {
-        DebugAssert(m_batch_vertex_space >= 4 && m_batch_index_space >= 6);
-
-        u32 start_color, end_color;
-        GPUVertexPosition start_pos, end_pos;
-        if (rc.shading_enable)
-        {
-          start_color = rc.color_for_first_vertex;
-          start_pos.bits = FifoPop();
-          end_color = FifoPop() & UINT32_C(0x00FFFFFF);
-          end_pos.bits = FifoPop();
-        }
-        else
-        {
-          start_color = end_color = rc.color_for_first_vertex;
-          start_pos.bits = FifoPop();
-          end_pos.bits = FifoPop();
-        }
-
-        if (!IsDrawingAreaIsValid()) [[unlikely]]
-          return;
-
-        s32 start_x = start_pos.x + m_drawing_offset.x;
-        s32 start_y = start_pos.y + m_drawing_offset.y;
-        s32 end_x = end_pos.x + m_drawing_offset.x;
-        s32 end_y = end_pos.y + m_drawing_offset.y;
-        const auto [min_x, max_x] = MinMax(start_x, end_x);
-        const auto [min_y, max_y] = MinMax(start_y, end_y);
-        if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
-        {
-          Log_DebugFmt("Culling too-large line: {},{} - {},{}", start_x, start_y, end_x, end_y);
-          return;
-        }
-
-        IncludeDrawnDirtyRectangle(min_x, min_y, max_x + 1, max_y + 1);
-        AddDrawLineTicks(min_x, min_y, max_x, max_y, rc.shading_enable);
-
-        // TODO: Should we do a PGXP lookup here? Most lines are 2D.
-        DrawLine(static_cast<float>(start_x), static_cast<float>(start_y), start_color, static_cast<float>(end_x),
-                 static_cast<float>(end_y), end_color, depth);
-
-        if (m_sw_renderer)
-        {
-          GPUBackendDrawLineCommand* cmd = m_sw_renderer->NewDrawLineCommand(2);
-          FillDrawCommand(cmd, rc);
-          cmd->vertices[0].Set(start_x, start_y, start_color);
-          cmd->vertices[1].Set(end_x, end_y, end_color);
-          m_sw_renderer->PushCommand(cmd);
-        }
-      }
-      else
+      if (!m_vram_replacement_texture->Update(0, 0, tex->GetMipWidth(level), tex->GetMipHeight(level),
+                                              tex->GetLevelData(level), tex->GetLevelPitch(level), 0, level))
       {
-        // Multiply by two because we don't use line strips.
-        const u32 num_vertices = GetPolyLineVertexCount();
-        DebugAssert(m_batch_vertex_space >= (num_vertices * 4) && m_batch_index_space >= (num_vertices * 6));
-
-        if (!IsDrawingAreaIsValid()) [[unlikely]]
-          return;
-
-        const bool shaded = rc.shading_enable;
-
-        u32 buffer_pos = 0;
-        const GPUVertexPosition start_vp{m_blit_buffer[buffer_pos++]};
-        s32 start_x = start_vp.x + m_drawing_offset.x;
-        s32 start_y = start_vp.y + m_drawing_offset.y;
-        u32 start_color = rc.color_for_first_vertex;
-
-        GPUBackendDrawLineCommand* cmd;
-        if (m_sw_renderer)
-        {
-          cmd = m_sw_renderer->NewDrawLineCommand(num_vertices);
-          FillDrawCommand(cmd, rc);
-          cmd->vertices[0].Set(start_x, start_y, start_color);
-        }
-        else
-        {
-          cmd = nullptr;
-        }
-
-        for (u32 i = 1; i < num_vertices; i++)
-        {
-          const u32 end_color = shaded ? (m_blit_buffer[buffer_pos++] & UINT32_C(0x00FFFFFF)) : start_color;
-          const GPUVertexPosition vp{m_blit_buffer[buffer_pos++]};
-          const s32 end_x = m_drawing_offset.x + vp.x;
-          const s32 end_y = m_drawing_offset.y + vp.y;
-
-          const auto [min_x, max_x] = MinMax(start_x, end_x);
-          const auto [min_y, max_y] = MinMax(start_y, end_y);
-          if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
-          {
-            Log_DebugFmt("Culling too-large line: {},{} - {},{}", start_x, start_y, end_x, end_y);
-          }
-          else
-          {
-            IncludeDrawnDirtyRectangle(min_x, min_y, max_x + 1, max_y + 1);
-            AddDrawLineTicks(min_x, min_y, max_x, max_y, rc.shading_enable);
-
-            // TODO: Should we do a PGXP lookup here? Most lines are 2D.
-            DrawLine(static_cast<float>(start_x), static_cast<float>(start_y), start_color, static_cast<float>(end_x),
-                     static_cast<float>(end_y), end_color, depth);
-          }
-
-          start_x = end_x;
-          start_y = end_y;
-          start_color = end_color;
-
-          if (cmd)
-            cmd->vertices[i].Set(end_x, end_y, end_color);
-        }
-
-        if (cmd)
-          m_sw_renderer->PushCommand(cmd);
+        Log_ErrorFmt("Update {}x{} {} texture level {} failed.", tex->GetWidth(), tex->GetHeight(),
+                     GPUTexture::GetFormatName(tex->GetFormat()), level);
+        return false;
       }
     }
-    break;
-
-    default:
-      UnreachableCode();
-      break;
   }
-}
-
-bool GPU_HW::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
-                                        u32 height)
-{
-  if (!m_vram_replacement_texture || m_vram_replacement_texture->GetWidth() < tex->GetWidth() ||
-      m_vram_replacement_texture->GetHeight() < tex->GetHeight() || g_gpu_device->GetFeatures().prefer_unused_textures)
+  else if (!m_vram_replacement_texture || m_vram_replacement_texture->GetFormat() != GPUTexture::Format::RGBA8 ||
+           m_vram_replacement_texture->GetWidth() < tex->GetWidth() ||
+           m_vram_replacement_texture->GetHeight() < tex->GetHeight() ||
+           g_gpu_device->GetFeatures().prefer_unused_textures)
   {
     g_gpu_device->RecycleTexture(std::move(m_vram_replacement_texture));
 
     if (!(m_vram_replacement_texture =
             g_gpu_device->FetchTexture(tex->GetWidth(), tex->GetHeight(), 1, 1, 1, GPUTexture::Type::DynamicTexture,
-                                       GPUTexture::Format::RGBA8, tex->GetPixels(), tex->GetPitch())))
+                                       GPUTexture::Format::RGBA8, tex->GetLevelData(0), tex->GetLevelPitch(0))))
     {
       return false;
     }
   }
   else
   {
-    if (!m_vram_replacement_texture->Update(0, 0, tex->GetWidth(), tex->GetHeight(), tex->GetPixels(), tex->GetPitch()))
+    if (!m_vram_replacement_texture->Update(0, 0, tex->GetWidth(), tex->GetHeight(), tex->GetLevelData(0),
+                                            tex->GetLevelPitch(0)))
     {
       Log_ErrorFmt("Update {}x{} texture failed.", width, height);
       return false;
@@ -2389,27 +3123,30 @@ bool GPU_HW::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u3
     static_cast<float>(tex->GetHeight()) / static_cast<float>(m_vram_replacement_texture->GetHeight())};
 
   g_gpu_device->PushUniformBuffer(src_rect, sizeof(src_rect));
-  g_gpu_device->SetTextureSampler(0, m_vram_replacement_texture.get(), g_gpu_device->GetLinearSampler());
+  g_gpu_device->SetTextureSampler(0, m_vram_replacement_texture.get(),
+                                  (tex->GetLevels() > 1) ? m_vram_replacement_sampler.get() :
+                                                           g_gpu_device->GetLinearSampler());
   g_gpu_device->SetPipeline(m_vram_write_replacement_pipeline.get());
   g_gpu_device->SetViewportAndScissor(dst_x, dst_y, width, height);
   g_gpu_device->Draw(3, 0);
 
-  RestoreDeviceContext();
+  RestoreVRAMRenderState();
   return true;
 }
 
 void GPU_HW::IncludeVRAMDirtyRectangle(Common::Rectangle<u32>& rect, const Common::Rectangle<u32>& new_rect)
 {
   rect.Include(new_rect);
+  MarkVRAMTilesDirty(new_rect.left, new_rect.top, new_rect.right, new_rect.bottom);
 
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
-  if (!m_draw_mode.IsTexturePageChanged() &&
-      (m_draw_mode.mode_reg.GetTexturePageRectangle().Intersects(new_rect) ||
-       (m_draw_mode.mode_reg.IsUsingPalette() &&
-        m_draw_mode.palette_reg.GetRectangle(m_draw_mode.mode_reg.texture_mode).Intersects(new_rect))))
+  if (!m_render_texture_page_changed &&
+      (m_render_mode_reg.GetTexturePageRectangle().Intersects(new_rect) ||
+       (m_render_mode_reg.IsUsingPalette() &&
+        m_render_palette_reg.GetRectangle(m_render_mode_reg.texture_mode).Intersects(new_rect))))
   {
-    m_draw_mode.SetTexturePageChanged();
+    m_render_texture_page_changed = true;
   }
 }
 
@@ -2425,12 +3162,11 @@ ALWAYS_INLINE_RELEASE void GPU_HW::CheckForTexPageOverlap(u32 texpage, u32 min_u
   const u32 xshift = uv_shifts_adds[(texpage >> 7) & 3][0];
   const u32 xadd = uv_shifts_adds[(texpage >> 7) & 3][1];
 
-  const u32 vram_min_u =
-    (((min_u & m_draw_mode.texture_window.and_x) | m_draw_mode.texture_window.or_x) >> xshift) + xoffs;
-  const u32 vram_max_u =
-    ((((max_u & m_draw_mode.texture_window.and_x) | m_draw_mode.texture_window.or_x) + xadd) >> xshift) + xoffs;
-  const u32 vram_min_v = ((min_v & m_draw_mode.texture_window.and_y) | m_draw_mode.texture_window.or_y) + yoffs;
-  const u32 vram_max_v = ((max_v & m_draw_mode.texture_window.and_y) | m_draw_mode.texture_window.or_y) + yoffs;
+  const GPUTextureWindow& window = m_render_texture_window;
+  const u32 vram_min_u = (((min_u & window.and_x) | window.or_x) >> xshift) + xoffs;
+  const u32 vram_max_u = ((((max_u & window.and_x) | window.or_x) + xadd) >> xshift) + xoffs;
+  const u32 vram_min_v = ((min_v & window.and_y) | window.or_y) + yoffs;
+  const u32 vram_max_v = ((max_v & window.and_y) | window.or_y) + yoffs;
 
   // Log_InfoFmt("{}: {},{} => {},{}", s_draw_number, vram_min_u, vram_min_v, vram_max_u, vram_max_v);
 
@@ -2469,7 +3205,7 @@ ALWAYS_INLINE_RELEASE void GPU_HW::CheckForTexPageOverlap(u32 texpage, u32 min_u
     {
       if (m_batch_index_count > 0)
       {
-        FlushRender();
+        FlushBatch();
         EnsureVertexBufferSpaceForCurrentCommand();
       }
 
@@ -2509,7 +3245,7 @@ void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices, u32 required_indices
     if (m_batch_vertex_space >= required_vertices && m_batch_index_space >= required_indices)
       return;
 
-    FlushRender();
+    FlushBatch();
   }
 
   MapGPUBuffer(required_vertices, required_indices);
@@ -2517,35 +3253,13 @@ void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices, u32 required_indices
 
 void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
 {
-  u32 required_vertices;
-  u32 required_indices;
-  switch (m_render_command.primitive)
-  {
-    case GPUPrimitive::Polygon:
-      required_vertices = 4; // assume quad, in case of expansion
-      required_indices = 6;
-      break;
-    case GPUPrimitive::Rectangle:
-      required_vertices = MAX_VERTICES_FOR_RECTANGLE; // TODO: WRong
-      required_indices = MAX_VERTICES_FOR_RECTANGLE;
-      break;
-    case GPUPrimitive::Line:
-    {
-      // assume expansion
-      const u32 vert_count = m_render_command.polyline ? GetPolyLineVertexCount() : 2;
-      required_vertices = vert_count * 4;
-      required_indices = vert_count * 6;
-    }
-    break;
-
-    default:
-      UnreachableCode();
-  }
+  const u32 required_vertices = m_current_command_vertices;
+  const u32 required_indices = m_current_command_indices;
 
   // can we fit these vertices in the current depth buffer range?
   if ((m_current_depth + required_vertices) > MAX_BATCH_VERTEX_COUNTER_IDS)
   {
-    FlushRender();
+    FlushBatch();
     ResetBatchVertexDepth();
     MapGPUBuffer(required_vertices, required_indices);
     return;
@@ -2557,6 +3271,7 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
 void GPU_HW::ResetBatchVertexDepth()
 {
   Log_PerfPrint("Resetting batch vertex depth");
+  FlushVRAMWrites();
 
   if (m_vram_depth_texture && !m_pgxp_depth_buffer)
     UpdateDepthBufferFromMaskBit();
@@ -2571,6 +3286,8 @@ ALWAYS_INLINE float GPU_HW::GetCurrentNormalizedVertexDepth() const
 
 void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
 {
+  WaitForVRAMReadback();
+
   const bool current_enabled = (m_sw_renderer != nullptr);
   const bool new_enabled = g_settings.gpu_use_software_renderer_for_readbacks;
   if (current_enabled == new_enabled)
@@ -2591,7 +3308,7 @@ void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
   // We need to fill in the SW renderer's VRAM with the current state for hot toggles.
   if (copy_vram_from_hw)
   {
-    FlushRender();
+    FlushBatch();
     ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
 
     // Sync the drawing area.
@@ -2621,10 +3338,22 @@ void GPU_HW::FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) co
   cmd->window = m_draw_mode.texture_window;
 }
 
-void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
+void GPU_HW::FillRenderDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const
 {
-  GL_SCOPE_FMT("FillVRAM({},{} => {},{} ({}x{}) with 0x{:08X}", x, y, x + width, y + height, width, height, color);
+  FillDrawCommand(cmd, rc);
+  cmd->params.interlaced_rendering = IsInterlacedRenderingEnabled();
+}
+
+void GPU_HW::PushRenderDrawCommand(GPUBackendDrawCommand* cmd)
+{
+  // The render side keeps its own flag, since writes which it executes can also dirty the page.
+  cmd->params.texture_page_changed = m_draw_mode.IsTexturePageChanged();
+  m_draw_mode.ClearTexturePageChangedFlag();
+  m_render_queue.PushCommand(cmd);
+}
 
+void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
+{
   if (m_sw_renderer)
   {
     GPUBackendFillVRAMCommand* cmd = m_sw_renderer->NewFillVRAMCommand();
@@ -2637,6 +3366,30 @@ void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
     m_sw_renderer->PushCommand(cmd);
   }
 
+  GPUBackendFillVRAMCommand* cmd = m_render_queue.NewFillVRAMCommand();
+  FillBackendCommandParameters(cmd);
+  cmd->params.interlaced_rendering = IsInterlacedRenderingEnabled();
+  cmd->x = static_cast<u16>(x);
+  cmd->y = static_cast<u16>(y);
+  cmd->width = static_cast<u16>(width);
+  cmd->height = static_cast<u16>(height);
+  cmd->color = color;
+  m_render_queue.PushCommand(cmd);
+}
+
+void GPU_HW::RenderFillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+{
+  GL_SCOPE_FMT("FillVRAM({},{} => {},{} ({}x{}) with 0x{:08X}", x, y, x + width, y + height, width, height, color);
+  FlushVRAMWrites();
+
+  // drop precision unless true colour is enabled
+  const u32 fill_color = m_true_color ? color : VRAMRGBA5551ToRGBA8888(VRAMRGBA8888ToRGBA5551(color));
+  const Common::Rectangle<u32> bounds(GetVRAMTransferBounds(x, y, width, height));
+
+  // Filling uncommitted sparse VRAM with black doesn't change it.
+  if (IsUsingSparseVRAM() && fill_color != 0)
+    CommitSparseVRAM(bounds);
+
   GL_INS_FMT("Dirty draw area before: {},{} => {},{} ({}x{})", m_vram_dirty_draw_rect.left, m_vram_dirty_draw_rect.top,
              m_vram_dirty_draw_rect.right, m_vram_dirty_draw_rect.bottom, m_vram_dirty_draw_rect.GetWidth(),
              m_vram_dirty_draw_rect.GetHeight());
@@ -2649,11 +3402,12 @@ void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
              m_vram_dirty_draw_rect.right, m_vram_dirty_draw_rect.bottom, m_vram_dirty_draw_rect.GetWidth(),
              m_vram_dirty_draw_rect.GetHeight());
 
+  SetTimingRegion(GPUTimingRegion::CopyFill);
+
   const bool is_oversized = (((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT));
   g_gpu_device->SetPipeline(
-    m_vram_fill_pipelines[BoolToUInt8(is_oversized)][BoolToUInt8(IsInterlacedRenderingEnabled())].get());
+    m_vram_fill_pipelines[BoolToUInt8(is_oversized)][BoolToUInt8(params.interlaced_rendering)].get());
 
-  const Common::Rectangle<u32> bounds(GetVRAMTransferBounds(x, y, width, height));
   g_gpu_device->SetViewportAndScissor(bounds.left * m_resolution_scale, bounds.top * m_resolution_scale,
                                       bounds.GetWidth() * m_resolution_scale, bounds.GetHeight() * m_resolution_scale);
 
@@ -2671,27 +3425,67 @@ void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   uniforms.u_dst_y = (y % VRAM_HEIGHT) * m_resolution_scale;
   uniforms.u_end_x = ((x + width) % VRAM_WIDTH) * m_resolution_scale;
   uniforms.u_end_y = ((y + height) % VRAM_HEIGHT) * m_resolution_scale;
-  // drop precision unless true colour is enabled
-  uniforms.u_fill_color =
-    GPUDevice::RGBA8ToFloat(m_true_color ? color : VRAMRGBA5551ToRGBA8888(VRAMRGBA8888ToRGBA5551(color)));
-  uniforms.u_interlaced_displayed_field = GetActiveLineLSB();
+  uniforms.u_fill_color = GPUDevice::RGBA8ToFloat(fill_color);
+  uniforms.u_interlaced_displayed_field = params.active_line_lsb;
   g_gpu_device->PushUniformBuffer(&uniforms, sizeof(uniforms));
   g_gpu_device->Draw(3, 0);
 
-  RestoreDeviceContext();
+  RestoreVRAMRenderState();
 }
 
 void GPU_HW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
-  GL_PUSH_FMT("ReadVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+  RenderThreadSuspendScope suspend(m_render_queue);
+  WaitForVRAMReadback();
+  if (!m_sw_renderer)
+    QueueVRAMReadback(x, y, width, height);
+  FinishVRAMReadback();
+}
+
+bool GPU_HW::BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height)
+{
+  if (m_sw_renderer)
+  {
+    m_sw_renderer->PublishCommands();
+    return true;
+  }
+
+  RenderThreadSuspendScope suspend(m_render_queue);
+
+  // Kick the readback off now, the game usually does a bit of setup before it starts reading GPUREAD.
+  QueueVRAMReadback(x, y, width, height);
+  g_gpu_device->FlushCommands();
+  return true;
+}
 
+void GPU_HW::FinishVRAMReadback()
+{
   if (m_sw_renderer)
   {
     m_sw_renderer->Sync(false);
-    GL_POP();
     return;
   }
 
+  RenderThreadSuspendScope suspend(m_render_queue);
+  const Common::Rectangle<u32>& rect = m_vram_readback_rect;
+  if (m_vram_readback_download_texture->IsImported())
+  {
+    // Fast path, the GPU wrote directly into VRAM.
+    m_vram_readback_download_texture->Flush();
+  }
+  else
+  {
+    m_vram_readback_download_texture->ReadTexels(0, 0, rect.GetWidth() / 2, rect.GetHeight(),
+                                                 &g_vram[rect.top * VRAM_WIDTH + rect.left], VRAM_WIDTH * sizeof(u16));
+  }
+}
+
+void GPU_HW::QueueVRAMReadback(u32 x, u32 y, u32 width, u32 height)
+{
+  FlushVRAMWrites();
+  GL_PUSH_FMT("ReadVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+  SetTimingRegion(GPUTimingRegion::Readback);
+
   // Get bounds with wrap-around handled.
   Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
 
@@ -2718,31 +3512,26 @@ void GPU_HW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   m_vram_readback_texture->MakeReadyForSampling();
   GL_POP();
 
-  // Stage the readback and copy it into our shadow buffer.
+  // Stage the readback, it's copied into our shadow buffer in FinishVRAMReadback().
   if (m_vram_readback_download_texture->IsImported())
   {
     // Fast path, read directly.
     m_vram_readback_download_texture->CopyFromTexture(encoded_left, encoded_top, m_vram_readback_texture.get(), 0, 0,
                                                       encoded_width, encoded_height, 0, 0, false);
-    m_vram_readback_download_texture->Flush();
   }
   else
   {
     // Copy to staging buffer, then to VRAM.
     m_vram_readback_download_texture->CopyFromTexture(0, 0, m_vram_readback_texture.get(), 0, 0, encoded_width,
                                                       encoded_height, 0, 0, true);
-    m_vram_readback_download_texture->ReadTexels(0, 0, encoded_width, encoded_height,
-                                                 &g_vram[copy_rect.top * VRAM_WIDTH + copy_rect.left],
-                                                 VRAM_WIDTH * sizeof(u16));
   }
 
-  RestoreDeviceContext();
+  m_vram_readback_rect = copy_rect;
+  RestoreVRAMRenderState();
 }
 
 void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
-  GL_SCOPE_FMT("UpdateVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
-
   if (m_sw_renderer)
   {
     const u32 num_words = width * height;
@@ -2758,25 +3547,118 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
     m_sw_renderer->PushCommand(cmd);
   }
 
-  const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
-  DebugAssert(bounds.right <= VRAM_WIDTH && bounds.bottom <= VRAM_HEIGHT);
-  IncludeVRAMDirtyRectangle(m_vram_dirty_write_rect, bounds);
+  m_counters.num_write_bytes += width * height * sizeof(u16);
 
-  if (check_mask)
+  // Replacements are looked up here, since they can be reloaded while the render thread is idle. Those and writes
+  // without the thread are drawn directly, which saves copying the data into the queue.
+  const TextureReplacementTexture* rtex =
+    check_mask ? nullptr : g_texture_replacements.GetVRAMWriteReplacement(width, height, data);
+  if (rtex || !m_render_queue.GetThread())
   {
-    // set new vertex counter since we want this to take into consideration previous masked pixels
-    m_current_depth++;
+    RenderThreadSuspendScope suspend(m_render_queue);
+    RenderUpdateVRAM(x, y, width, height, data, set_mask, check_mask, rtex);
+    return;
   }
-  else
-  {
-    const TextureReplacementTexture* rtex = g_texture_replacements.GetVRAMWriteReplacement(width, height, data);
-    if (rtex && BlitVRAMReplacementTexture(rtex, x * m_resolution_scale, y * m_resolution_scale,
-                                           width * m_resolution_scale, height * m_resolution_scale))
-    {
+
+  const u32 num_words = width * height;
+  GPUBackendUpdateVRAMCommand* cmd = m_render_queue.NewUpdateVRAMCommand(num_words);
+  FillBackendCommandParameters(cmd);
+  cmd->params.set_mask_while_drawing = set_mask;
+  cmd->params.check_mask_before_draw = check_mask;
+  cmd->x = static_cast<u16>(x);
+  cmd->y = static_cast<u16>(y);
+  cmd->width = static_cast<u16>(width);
+  cmd->height = static_cast<u16>(height);
+  std::memcpy(cmd->data, data, sizeof(u16) * num_words);
+  m_render_queue.PushCommand(cmd);
+}
+
+void GPU_HW::RenderUpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask,
+                              const TextureReplacementTexture* rtex)
+{
+  GL_SCOPE_FMT("UpdateVRAM({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+
+  const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
+  DebugAssert(bounds.right <= VRAM_WIDTH && bounds.bottom <= VRAM_HEIGHT);
+  IncludeVRAMDirtyRectangle(m_vram_dirty_write_rect, bounds);
+
+  if (check_mask)
+  {
+    FlushVRAMWrites();
+
+    // set new vertex counter since we want this to take into consideration previous masked pixels
+    m_current_depth++;
+  }
+  else
+  {
+    if (rtex)
+    {
+      FlushVRAMWrites();
+      if (IsUsingSparseVRAM())
+        CommitSparseVRAM(bounds);
+      if (BlitVRAMReplacementTexture(rtex, x * m_resolution_scale, y * m_resolution_scale, width * m_resolution_scale,
+                                     height * m_resolution_scale))
+      {
+        return;
+      }
+    }
+
+    // Games often split uploads into strips, e.g. FMV frames decoded a column of macroblocks at a time. Stage writes
+    // which continue the pending one, so the whole area goes up in one draw.
+    if (m_vram_upload_buffer && (x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT)
+    {
+      const Common::Rectangle<u32>& prect = m_pending_vram_write_rect;
+      if (prect.Valid() && m_pending_vram_write_set_mask == set_mask &&
+          ((x == prect.left && width == prect.GetWidth() && y == prect.bottom) ||
+           (y == prect.top && height == prect.GetHeight() && x == prect.right)))
+      {
+        m_pending_vram_write_rect.Include(bounds);
+        m_counters.num_merged_writes++;
+      }
+      else
+      {
+        FlushVRAMWrites();
+        m_pending_vram_write_rect = bounds;
+        m_pending_vram_write_set_mask = set_mask;
+      }
+
+      const u16* src_ptr = static_cast<const u16*>(data);
+      u16* dst_ptr = &m_vram_write_staging[y * VRAM_WIDTH + x];
+      for (u32 row = 0; row < height; row++)
+      {
+        std::memcpy(dst_ptr, src_ptr, width * sizeof(u16));
+        src_ptr += width;
+        dst_ptr += VRAM_WIDTH;
+      }
+
       return;
     }
   }
 
+  FlushVRAMWrites();
+  DrawVRAMWrite(x, y, width, height, static_cast<const u16*>(data), width, set_mask, check_mask);
+}
+
+void GPU_HW::FlushPendingVRAMWrite()
+{
+  const Common::Rectangle<u32> rect = m_pending_vram_write_rect;
+  m_pending_vram_write_rect.SetInvalid();
+
+  DrawVRAMWrite(rect.left, rect.top, rect.GetWidth(), rect.GetHeight(),
+                &m_vram_write_staging[rect.top * VRAM_WIDTH + rect.left], VRAM_WIDTH, m_pending_vram_write_set_mask,
+                false);
+}
+
+void GPU_HW::DrawVRAMWrite(u32 x, u32 y, u32 width, u32 height, const u16* data, u32 data_stride, bool set_mask,
+                           bool check_mask)
+{
+  GL_SCOPE_FMT("DrawVRAMWrite({},{} => {},{} ({}x{})", x, y, x + width, y + height, width, height);
+  SetTimingRegion(GPUTimingRegion::CopyFill);
+
+  if (IsUsingSparseVRAM())
+    CommitSparseVRAMForWrite(x, y, width, height, data, data_stride, set_mask);
+
+  const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
   std::unique_ptr<GPUTexture> upload_texture;
   u32 map_index;
 
@@ -2784,7 +3666,7 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
   {
     map_index = 0;
     upload_texture = g_gpu_device->FetchTexture(width, height, 1, 1, 1, GPUTexture::Type::Texture,
-                                                GPUTexture::Format::R16U, data, width * sizeof(u16));
+                                                GPUTexture::Format::R16U, data, data_stride * sizeof(u16));
     if (!upload_texture)
     {
       Log_ErrorFmt("Failed to get {}x{} upload texture. Things are gonna break.", width, height);
@@ -2794,9 +3676,17 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
   else
   {
     const u32 num_pixels = width * height;
-    void* map = m_vram_upload_buffer->Map(num_pixels);
+    u16* map = static_cast<u16*>(m_vram_upload_buffer->Map(num_pixels));
     map_index = m_vram_upload_buffer->GetCurrentPosition();
-    std::memcpy(map, data, num_pixels * sizeof(u16));
+    if (data_stride == width)
+    {
+      std::memcpy(map, data, num_pixels * sizeof(u16));
+    }
+    else
+    {
+      for (u32 row = 0; row < height; row++)
+        std::memcpy(&map[row * width], &data[row * data_stride], width * sizeof(u16));
+    }
     m_vram_upload_buffer->Unmap(num_pixels);
   }
 
@@ -2834,13 +3724,11 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
     g_gpu_device->Draw(3, 0);
   }
 
-  RestoreDeviceContext();
+  RestoreVRAMRenderState();
 }
 
 void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
-  GL_SCOPE_FMT("CopyVRAM({}x{} @ {},{} => {},{}", width, height, src_x, src_y, dst_x, dst_y);
-
   if (m_sw_renderer)
   {
     GPUBackendCopyVRAMCommand* cmd = m_sw_renderer->NewCopyVRAMCommand();
@@ -2854,9 +3742,31 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
     m_sw_renderer->PushCommand(cmd);
   }
 
+  GPUBackendCopyVRAMCommand* cmd = m_render_queue.NewCopyVRAMCommand();
+  FillBackendCommandParameters(cmd);
+  cmd->src_x = static_cast<u16>(src_x);
+  cmd->src_y = static_cast<u16>(src_y);
+  cmd->dst_x = static_cast<u16>(dst_x);
+  cmd->dst_y = static_cast<u16>(dst_y);
+  cmd->width = static_cast<u16>(width);
+  cmd->height = static_cast<u16>(height);
+  m_render_queue.PushCommand(cmd);
+}
+
+void GPU_HW::RenderCopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                            GPUBackendCommandParameters params)
+{
+  GL_SCOPE_FMT("CopyVRAM({}x{} @ {},{} => {},{}", width, height, src_x, src_y, dst_x, dst_y);
+  FlushVRAMWrites();
+
+  SetTimingRegion(GPUTimingRegion::CopyFill);
+
+  if (IsUsingSparseVRAM())
+    CommitSparseVRAM(GetVRAMTransferBounds(dst_x, dst_y, width, height));
+
   // masking enabled, oversized, or overlapping
   const bool use_shader =
-    (m_GPUSTAT.IsMaskingEnabled() || ((src_x % VRAM_WIDTH) + width) > VRAM_WIDTH ||
+    (params.IsMaskingEnabled() || ((src_x % VRAM_WIDTH) + width) > VRAM_WIDTH ||
      ((src_y % VRAM_HEIGHT) + height) > VRAM_HEIGHT || ((dst_x % VRAM_WIDTH) + width) > VRAM_WIDTH ||
      ((dst_y % VRAM_HEIGHT) + height) > VRAM_HEIGHT);
   const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
@@ -2867,7 +3777,7 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
   if (use_shader || IsUsingMultisampling())
   {
     if (intersect_with_draw || intersect_with_write)
-      UpdateVRAMReadTexture(intersect_with_draw, intersect_with_write);
+      UpdateVRAMReadTextureForCopy(src_bounds, intersect_with_draw, intersect_with_write);
     IncludeVRAMDirtyRectangle(m_vram_dirty_draw_rect, dst_bounds);
 
     struct VRAMCopyUBOData
@@ -2891,7 +3801,7 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
                                       ((dst_y + height) % VRAM_HEIGHT) * m_resolution_scale,
                                       width * m_resolution_scale,
                                       height * m_resolution_scale,
-                                      m_GPUSTAT.set_mask_while_drawing ? 1u : 0u,
+                                      params.set_mask_while_drawing ? 1u : 0u,
                                       GetCurrentNormalizedVertexDepth()};
 
     // VRAM read texture should already be bound.
@@ -2899,13 +3809,13 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
     g_gpu_device->SetViewportAndScissor(dst_bounds_scaled.left, dst_bounds_scaled.top, dst_bounds_scaled.GetWidth(),
                                         dst_bounds_scaled.GetHeight());
     g_gpu_device->SetPipeline(
-      m_vram_copy_pipelines[BoolToUInt8(m_GPUSTAT.check_mask_before_draw && !m_pgxp_depth_buffer && NeedsDepthBuffer())]
+      m_vram_copy_pipelines[BoolToUInt8(params.check_mask_before_draw && !m_pgxp_depth_buffer && NeedsDepthBuffer())]
         .get());
     g_gpu_device->PushUniformBuffer(&uniforms, sizeof(uniforms));
     g_gpu_device->Draw(3, 0);
-    RestoreDeviceContext();
+    RestoreVRAMRenderState();
 
-    if (m_GPUSTAT.check_mask_before_draw && !m_pgxp_depth_buffer)
+    if (params.check_mask_before_draw && !m_pgxp_depth_buffer)
       m_current_depth++;
 
     return;
@@ -2917,7 +3827,7 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
   {
     src_tex = m_vram_read_texture.get();
     if (intersect_with_draw || intersect_with_write)
-      UpdateVRAMReadTexture(intersect_with_draw, intersect_with_write);
+      UpdateVRAMReadTextureForCopy(src_bounds, intersect_with_draw, intersect_with_write);
   }
 
   Common::Rectangle<u32>* update_rect;
@@ -2934,7 +3844,7 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
   }
   IncludeVRAMDirtyRectangle(*update_rect, dst_bounds);
 
-  if (m_GPUSTAT.check_mask_before_draw)
+  if (params.check_mask_before_draw)
   {
     // set new vertex counter since we want this to take into consideration previous masked pixels
     m_current_depth++;
@@ -2947,178 +3857,665 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
     m_vram_read_texture->MakeReadyForSampling();
 }
 
-void GPU_HW::DispatchRenderCommand()
+s32 GPU_HW::GetFilteredTexPageSlot()
 {
-  const GPURenderCommand rc{m_render_command.bits};
+  // Pages are filtered as a whole, so windowed textures have to be filtered in the draw.
+  const GPUDrawModeReg mode_reg = m_render_mode_reg;
+  const GPUTextureWindow& window = m_render_texture_window;
+  if (!mode_reg.IsUsingPalette() || window.and_x != 0xFF || window.and_y != 0xFF || window.or_x != 0 ||
+      window.or_y != 0)
+  {
+    return -1;
+  }
+
+  const u32 key = ZeroExtend32(mode_reg.bits & (GPUDrawModeReg::TEXTURE_PAGE_MASK | (3u << 7))) |
+                  (ZeroExtend32(m_render_palette_reg.bits) << 16);
+  for (u32 i = 0; i < m_num_filtered_texpages; i++)
+  {
+    if ((m_filtered_texpage_valid_mask & (1u << i)) && m_filtered_texpages[i].key == key)
+    {
+      m_filtered_texpages[i].last_used = ++m_filtered_texpage_counter;
+      return static_cast<s32>(i);
+    }
+  }
+
+  // Use a free slot if there is one, otherwise replace the least recently used page.
+  u32 slot = 0;
+  for (u32 i = 0; i < m_num_filtered_texpages; i++)
+  {
+    if (!(m_filtered_texpage_valid_mask & (1u << i)))
+    {
+      slot = i;
+      break;
+    }
+
+    if (m_filtered_texpages[i].last_used < m_filtered_texpages[slot].last_used)
+      slot = i;
+  }
+
+  m_filtered_texpage_valid_mask &= ~(1u << slot);
+
+  FilteredTexPage& page = m_filtered_texpages[slot];
+  page.key = key;
+  page.last_used = ++m_filtered_texpage_counter;
+  page.page_rect = mode_reg.GetTexturePageRectangle();
+  page.palette_rect = m_render_palette_reg.GetRectangle(mode_reg.texture_mode);
+  if (!FilterTexPage(slot, page))
+    return -1;
+
+  m_filtered_texpage_valid_mask |= (1u << slot);
+  return static_cast<s32>(slot);
+}
+
+bool GPU_HW::FilterTexPage(u32 slot, const FilteredTexPage& page)
+{
+  const u32 slot_size = 256u * m_resolution_scale;
+  if (!m_filtered_texpage_texture)
+  {
+    const u32 rows = m_num_filtered_texpages / FILTERED_TEXPAGE_CACHE_COLUMNS;
+    if (!(m_filtered_texpage_texture =
+            g_gpu_device->FetchTexture(slot_size * FILTERED_TEXPAGE_CACHE_COLUMNS, slot_size * rows, 1, 1, 1,
+                                       GPUTexture::Type::RenderTarget, VRAM_RT_FORMAT)))
+    {
+      Log_ErrorPrint("Failed to create filtered texpage cache texture, filtering in draws instead.");
+      m_filtered_texpage_cache = false;
+      return false;
+    }
+
+    GL_OBJECT_NAME(m_filtered_texpage_texture, "Filtered Texpage Cache Texture");
+  }
+
+  // The pending batch may still be sampling the slot which is about to be replaced.
+  if (!IsFlushed())
+    FlushBatch();
+
+  const bool update_drawn =
+    (page.page_rect.Intersects(m_vram_dirty_draw_rect) || page.palette_rect.Intersects(m_vram_dirty_draw_rect));
+  const bool update_written =
+    (page.page_rect.Intersects(m_vram_dirty_write_rect) || page.palette_rect.Intersects(m_vram_dirty_write_rect));
+  if (update_drawn || update_written)
+    UpdateVRAMReadTexture(update_drawn, update_written);
+
+  GL_SCOPE_FMT("FilterTexPage({}, page {},{}, palette {},{})", slot, page.page_rect.left, page.page_rect.top,
+               page.palette_rect.left, page.palette_rect.top);
+
+  const u32 dst_x = (slot % FILTERED_TEXPAGE_CACHE_COLUMNS) * slot_size;
+  const u32 dst_y = (slot / FILTERED_TEXPAGE_CACHE_COLUMNS) * slot_size;
+  const bool palette_8bit = (m_render_mode_reg.texture_mode == GPUTextureMode::Palette8Bit);
+  const u32 uniforms[] = {0xFFu,
+                          0xFFu,
+                          0u,
+                          0u,
+                          page.page_rect.left * m_resolution_scale,
+                          page.page_rect.top * m_resolution_scale,
+                          page.palette_rect.left,
+                          page.palette_rect.top * m_resolution_scale,
+                          dst_x,
+                          dst_y};
+
+  g_gpu_device->SetRenderTarget(m_filtered_texpage_texture.get());
+  g_gpu_device->SetPipeline(m_filtered_texpage_pipelines[BoolToUInt8(palette_8bit)].get());
+  g_gpu_device->SetViewportAndScissor(dst_x, dst_y, slot_size, slot_size);
+  g_gpu_device->PushUniformBuffer(uniforms, sizeof(uniforms));
+  g_gpu_device->Draw(3, 0);
+  m_filtered_texpage_texture->MakeReadyForSampling();
+
+  RestoreVRAMRenderState();
+  return true;
+}
+
+void GPU_HW::InvalidateFilteredTexPages(u32 left, u32 top, u32 right, u32 bottom)
+{
+  const Common::Rectangle<u32> rect(left, top, right, bottom);
+  u32 mask = m_filtered_texpage_valid_mask;
+  while (mask != 0)
+  {
+    const u32 slot = CountTrailingZeros(mask);
+    mask &= (mask - 1);
+
+    const FilteredTexPage& page = m_filtered_texpages[slot];
+    if (page.page_rect.Intersects(rect) || page.palette_rect.Intersects(rect))
+      m_filtered_texpage_valid_mask &= ~(1u << slot);
+  }
+}
+
+void GPU_HW::DestroyFilteredTexPageCache()
+{
+  m_filtered_texpage_valid_mask = 0;
+  g_gpu_device->RecycleTexture(std::move(m_filtered_texpage_texture));
+}
+
+u32 GPU_HW::PrepareDraw(const GPUBackendDrawCommand* cmd, u32 required_vertices, u32 required_indices)
+{
+  const GPURenderCommand rc{cmd->rc.bits};
+  FlushVRAMWrites();
+
+  m_current_command_vertices = required_vertices;
+  m_current_command_indices = required_indices;
+  m_render_mode_reg.bits = cmd->draw_mode.bits;
+  m_render_palette_reg.bits = cmd->palette.bits;
+  m_render_texture_window = cmd->window;
+  m_render_texture_page_changed |= cmd->params.texture_page_changed;
 
   GPUTextureMode texture_mode;
   if (rc.IsTexturingEnabled())
   {
     // texture page changed - check that the new page doesn't intersect the drawing area
-    if (m_draw_mode.IsTexturePageChanged())
+    if (m_render_texture_page_changed)
+    {
+      m_render_texture_page_changed = false;
+
+#if 0
+      if (m_vram_dirty_rect.Valid())
+      {
+        GL_INS_FMT("VRAM DIRTY: {},{} => {},{}", m_vram_dirty_rect.left, m_vram_dirty_rect.top, m_vram_dirty_rect.right,
+                   m_vram_dirty_rect.bottom);
+
+        auto tpr = m_render_mode_reg.GetTexturePageRectangle();
+        GL_INS_FMT("PAGE RECT: {},{} => {},{}", tpr.left, tpr.top, tpr.right, tpr.bottom);
+        if (m_render_mode_reg.IsUsingPalette())
+        {
+          tpr = m_render_palette_reg.GetRectangle(m_render_mode_reg.texture_mode);
+          GL_INS_FMT("PALETTE RECT: {},{} => {},{}", tpr.left, tpr.top, tpr.right, tpr.bottom);
+        }
+      }
+#endif
+
+      if (m_render_mode_reg.IsUsingPalette())
+      {
+        const Common::Rectangle<u32> palette_rect = m_render_palette_reg.GetRectangle(m_render_mode_reg.texture_mode);
+        const bool update_drawn = palette_rect.Intersects(m_vram_dirty_draw_rect);
+        const bool update_written = palette_rect.Intersects(m_vram_dirty_write_rect);
+        if (update_drawn || update_written)
+        {
+          GL_INS("Palette in VRAM dirty area, flushing cache");
+          if (!IsFlushed())
+            FlushBatch();
+
+          UpdateVRAMReadTexture(update_drawn, update_written);
+        }
+      }
+
+      const Common::Rectangle<u32> page_rect = m_render_mode_reg.GetTexturePageRectangle();
+      u8 new_texpage_dirty = m_vram_dirty_draw_rect.Intersects(page_rect) ? TEXPAGE_DIRTY_DRAWN_RECT : 0;
+      new_texpage_dirty |= m_vram_dirty_write_rect.Intersects(page_rect) ? TEXPAGE_DIRTY_WRITTEN_RECT : 0;
+
+      if (new_texpage_dirty != 0)
+      {
+        GL_INS("Texpage is in dirty area, checking UV ranges");
+        m_texpage_dirty = new_texpage_dirty;
+        m_compute_uv_range = true;
+        m_current_uv_range.SetInvalid();
+      }
+      else
+      {
+        m_compute_uv_range = m_clamp_uvs;
+        if (m_texpage_dirty)
+          GL_INS("Texpage is no longer dirty");
+        m_texpage_dirty = 0;
+      }
+    }
+
+    texture_mode = m_render_mode_reg.texture_mode;
+    if (rc.raw_texture_enable)
     {
-      m_draw_mode.ClearTexturePageChangedFlag();
+      texture_mode =
+        static_cast<GPUTextureMode>(static_cast<u8>(texture_mode) | static_cast<u8>(GPUTextureMode::RawTextureBit));
+    }
+  }
+  else
+  {
+    texture_mode = GPUTextureMode::Disabled;
+  }
+
+  // has any state changed which requires a new batch?
+  // Reverse blending breaks with mixed transparent and opaque pixels, so we have to do one draw per polygon.
+  // If we have fbfetch, we don't need to draw it in two passes. Test case: Suikoden 2 shadows.
+  const GPUTransparencyMode transparency_mode =
+    rc.transparency_enable ? m_render_mode_reg.transparency_mode : GPUTransparencyMode::Disabled;
+  bool dithering_enable = (!m_true_color && cmd->IsDitheringEnabled());
+
+  // Palette draws with an expensive filter can sample a page which was filtered ahead of time instead.
+  const s32 filtered_texpage_slot =
+    (m_filtered_texpage_cache && texture_mode != GPUTextureMode::Disabled) ? GetFilteredTexPageSlot() : -1;
+  if (filtered_texpage_slot >= 0)
+  {
+    const u32 slot = static_cast<u32>(filtered_texpage_slot);
+    m_batch_texpage_bits = ((slot % FILTERED_TEXPAGE_CACHE_COLUMNS) | ((slot / FILTERED_TEXPAGE_CACHE_COLUMNS) << 8))
+                           << 16;
+    texture_mode =
+      static_cast<GPUTextureMode>(rc.raw_texture_enable ? FILTERED_RAW_TEXTURE_MODE : FILTERED_TEXTURE_MODE);
+  }
+  else
+  {
+    // Textured draws can share a batch regardless of texture mode and dithering, the shader reads it from the
+    // texpage. Also used for texture modes which don't have their specialized pipelines built yet.
+    const u32 deferred_group =
+      (BoolToUInt32(dithering_enable) * NUM_DEFERRED_TEXTURE_MODES) + static_cast<u32>(texture_mode);
+    const bool textured = (texture_mode != GPUTextureMode::Disabled);
+    if (textured && !(m_used_deferred_groups_mask & (1u << deferred_group))) [[unlikely]]
+      RecordDeferredGroupUsed(deferred_group);
+    if (textured && (m_batch_mixed_texture_modes || !(m_batch_texture_modes_ready & (1u << deferred_group))))
+    {
+      m_batch_texpage_bits =
+        (rc.raw_texture_enable ? TEXPAGE_RAW_TEXTURE_BIT : 0u) | (dithering_enable ? TEXPAGE_DITHER_BIT : 0u);
+      texture_mode = static_cast<GPUTextureMode>(MIXED_TEXTURE_MODE);
+      dithering_enable = false;
+    }
+    else
+    {
+      m_batch_texpage_bits = 0;
+    }
+  }
+
+  if (texture_mode != m_batch.texture_mode || transparency_mode != m_batch.transparency_mode ||
+      (transparency_mode == GPUTransparencyMode::BackgroundMinusForeground && !m_allow_shader_blend) ||
+      dithering_enable != m_batch.dithering)
+  {
+    FlushBatch();
+  }
+
+  EnsureVertexBufferSpaceForCurrentCommand();
+
+  if (m_batch_index_count == 0)
+  {
+    // transparency mode change
+    const bool check_mask_before_draw = cmd->params.check_mask_before_draw;
+    if (transparency_mode != GPUTransparencyMode::Disabled &&
+        (texture_mode == GPUTextureMode::Disabled || !NeedsShaderBlending(transparency_mode, check_mask_before_draw)))
+    {
+      static constexpr float transparent_alpha[4][2] = {{0.5f, 0.5f}, {1.0f, 1.0f}, {1.0f, 1.0f}, {0.25f, 1.0f}};
+
+      const float src_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][0];
+      const float dst_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][1];
+      m_batch_ubo_dirty |= (m_batch_ubo_data.u_src_alpha_factor != src_alpha_factor ||
+                            m_batch_ubo_data.u_dst_alpha_factor != dst_alpha_factor);
+      m_batch_ubo_data.u_src_alpha_factor = src_alpha_factor;
+      m_batch_ubo_data.u_dst_alpha_factor = dst_alpha_factor;
+    }
+
+    const bool set_mask_while_drawing = cmd->params.set_mask_while_drawing;
+    if (m_batch.check_mask_before_draw != check_mask_before_draw ||
+        m_batch.set_mask_while_drawing != set_mask_while_drawing)
+    {
+      m_batch.check_mask_before_draw = check_mask_before_draw;
+      m_batch.set_mask_while_drawing = set_mask_while_drawing;
+      m_batch_ubo_dirty |= (m_batch_ubo_data.u_set_mask_while_drawing != BoolToUInt32(set_mask_while_drawing));
+      m_batch_ubo_data.u_set_mask_while_drawing = BoolToUInt32(set_mask_while_drawing);
+    }
+
+    m_batch.interlacing = cmd->params.interlaced_rendering;
+    if (m_batch.interlacing)
+    {
+      const u32 displayed_field = cmd->params.active_line_lsb;
+      m_batch_ubo_dirty |= (m_batch_ubo_data.u_interlaced_displayed_field != displayed_field);
+      m_batch_ubo_data.u_interlaced_displayed_field = displayed_field;
+    }
+
+    // update state
+    m_batch.texture_mode = texture_mode;
+    m_batch.transparency_mode = transparency_mode;
+    m_batch.dithering = dithering_enable;
+
+    // Changing the texture window flushes, so it only needs checking for new batches.
+    const GPUTextureWindow& window = m_render_texture_window;
+    if (m_batch_ubo_data.u_texture_window_and[0] != window.and_x ||
+        m_batch_ubo_data.u_texture_window_and[1] != window.and_y ||
+        m_batch_ubo_data.u_texture_window_or[0] != window.or_x ||
+        m_batch_ubo_data.u_texture_window_or[1] != window.or_y)
+    {
+      m_batch_ubo_data.u_texture_window_and[0] = ZeroExtend32(window.and_x);
+      m_batch_ubo_data.u_texture_window_and[1] = ZeroExtend32(window.and_y);
+      m_batch_ubo_data.u_texture_window_or[0] = ZeroExtend32(window.or_x);
+      m_batch_ubo_data.u_texture_window_or[1] = ZeroExtend32(window.or_y);
+      m_batch_ubo_dirty = true;
+    }
+  }
+
+  if (cmd->params.check_mask_before_draw)
+    m_current_depth++;
+
+  // Filtered texpages have the cache slot in place of the palette.
+  const u32 palette_bits = (static_cast<u8>(m_batch.texture_mode) >= FILTERED_TEXTURE_MODE) ?
+                             0u :
+                             (ZeroExtend32(m_render_palette_reg.bits) << 16);
+  return ZeroExtend32(m_render_mode_reg.bits) | palette_bits | m_batch_texpage_bits;
+}
+
+void GPU_HW::DispatchRenderCommand()
+{
+  const GPURenderCommand rc{m_render_command.bits};
+
+  if (m_drawing_area_changed)
+  {
+    m_drawing_area_changed = false;
+
+    GPUBackendSetDrawingAreaCommand* cmd = m_render_queue.NewSetDrawingAreaCommand();
+    cmd->new_area = m_drawing_area;
+    m_render_queue.PushCommand(cmd);
+
+    if (m_sw_renderer)
+    {
+      GPUBackendSetDrawingAreaCommand* sw_cmd = m_sw_renderer->NewSetDrawingAreaCommand();
+      sw_cmd->new_area = m_drawing_area;
+      m_sw_renderer->PushCommand(sw_cmd);
+    }
+  }
+
+  switch (rc.primitive)
+  {
+    case GPUPrimitive::Polygon:
+    {
+      const u32 first_color = rc.color_for_first_vertex;
+      const bool shaded = rc.shading_enable;
+      const bool textured = rc.texture_enable;
+      const bool pgxp = g_settings.gpu_pgxp_enable;
+
+      const u32 num_vertices = rc.quad_polygon ? 4 : 3;
+      GPUBackendDrawPrecisePolygonCommand* cmd = m_render_queue.NewDrawPrecisePolygonCommand(num_vertices);
+      FillRenderDrawCommand(cmd, rc);
+
+      bool valid_w = g_settings.gpu_pgxp_texture_correction;
+      for (u32 i = 0; i < num_vertices; i++)
+      {
+        GPUBackendDrawPrecisePolygonCommand::Vertex* vert = &cmd->vertices[i];
+        vert->color = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
+        const u64 maddr_and_pos = m_fifo.Pop();
+        const GPUVertexPosition vp{Truncate32(maddr_and_pos)};
+        vert->texcoord = textured ? Truncate16(FifoPop()) : 0;
+        vert->native_x = m_drawing_offset.x + vp.x;
+        vert->native_y = m_drawing_offset.y + vp.y;
+        vert->x = static_cast<float>(vert->native_x);
+        vert->y = static_cast<float>(vert->native_y);
+        vert->w = 1.0f;
+
+        if (pgxp)
+        {
+          valid_w &= CPU::PGXP::GetPreciseVertex(Truncate32(maddr_and_pos >> 32), vp.bits, vert->native_x,
+                                                 vert->native_y, m_drawing_offset.x, m_drawing_offset.y, &vert->x,
+                                                 &vert->y, &vert->w);
+        }
+      }
+      if (pgxp && !valid_w)
+      {
+        for (u32 i = 0; i < num_vertices; i++)
+          cmd->vertices[i].w = 1.0f;
+      }
+      cmd->valid_w = pgxp && valid_w;
+
+      if (!IsDrawingAreaIsValid()) [[unlikely]]
+        return;
+
+      // Cull polygons which are too large. The render side culls the same triangles.
+      const GPUBackendDrawPrecisePolygonCommand::Vertex* verts = cmd->vertices;
+      const auto [min_x_12, max_x_12] = MinMax(verts[1].native_x, verts[2].native_x);
+      const auto [min_y_12, max_y_12] = MinMax(verts[1].native_y, verts[2].native_y);
+      const s32 min_x = std::min(min_x_12, verts[0].native_x);
+      const s32 max_x = std::max(max_x_12, verts[0].native_x);
+      const s32 min_y = std::min(min_y_12, verts[0].native_y);
+      const s32 max_y = std::max(max_y_12, verts[0].native_y);
+      if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
+      {
+        Log_DebugFmt("Culling too-large polygon: {},{} {},{} {},{}", verts[0].native_x, verts[0].native_y,
+                     verts[1].native_x, verts[1].native_y, verts[2].native_x, verts[2].native_y);
+      }
+      else
+      {
+        AddDrawTriangleTicks(verts[0].native_x, verts[0].native_y, verts[1].native_x, verts[1].native_y,
+                             verts[2].native_x, verts[2].native_y, rc.shading_enable, rc.texture_enable,
+                             rc.transparency_enable);
+      }
+
+      // quads
+      if (rc.quad_polygon)
+      {
+        const s32 min_x_123 = std::min(min_x_12, verts[3].native_x);
+        const s32 max_x_123 = std::max(max_x_12, verts[3].native_x);
+        const s32 min_y_123 = std::min(min_y_12, verts[3].native_y);
+        const s32 max_y_123 = std::max(max_y_12, verts[3].native_y);
+
+        if ((max_x_123 - min_x_123) >= MAX_PRIMITIVE_WIDTH || (max_y_123 - min_y_123) >= MAX_PRIMITIVE_HEIGHT)
+        {
+          Log_DebugFmt("Culling too-large polygon (quad second half): {},{} {},{} {},{}", verts[2].native_x,
+                       verts[2].native_y, verts[1].native_x, verts[1].native_y, verts[0].native_x, verts[0].native_y);
+        }
+        else
+        {
+          AddDrawTriangleTicks(verts[2].native_x, verts[2].native_y, verts[1].native_x, verts[1].native_y,
+                               verts[3].native_x, verts[3].native_y, rc.shading_enable, rc.texture_enable,
+                               rc.transparency_enable);
+        }
+      }
+
+      if (m_sw_renderer)
+      {
+        GPUBackendDrawPolygonCommand* sw_cmd = m_sw_renderer->NewDrawPolygonCommand(num_vertices);
+        FillDrawCommand(sw_cmd, rc);
+
+        for (u32 i = 0; i < num_vertices; i++)
+        {
+          GPUBackendDrawPolygonCommand::Vertex* vert = &sw_cmd->vertices[i];
+          vert->x = verts[i].native_x;
+          vert->y = verts[i].native_y;
+          vert->texcoord = verts[i].texcoord;
+          vert->color = verts[i].color;
+        }
+
+        m_sw_renderer->PushCommand(sw_cmd);
+      }
+
+      PushRenderDrawCommand(cmd);
+    }
+    break;
+
+    case GPUPrimitive::Rectangle:
+    {
+      const u32 color = rc.color_for_first_vertex;
+      const GPUVertexPosition vp{FifoPop()};
+      const s32 pos_x = TruncateGPUVertexPosition(m_drawing_offset.x + vp.x);
+      const s32 pos_y = TruncateGPUVertexPosition(m_drawing_offset.y + vp.y);
+      const u16 texcoord = rc.texture_enable ? Truncate16(FifoPop()) : 0;
+
+      s32 rectangle_width;
+      s32 rectangle_height;
+      switch (rc.rectangle_size)
+      {
+        case GPUDrawRectangleSize::R1x1:
+          rectangle_width = 1;
+          rectangle_height = 1;
+          break;
+        case GPUDrawRectangleSize::R8x8:
+          rectangle_width = 8;
+          rectangle_height = 8;
+          break;
+        case GPUDrawRectangleSize::R16x16:
+          rectangle_width = 16;
+          rectangle_height = 16;
+          break;
+        default:
+        {
+          const u32 width_and_height = FifoPop();
+          rectangle_width = static_cast<s32>(width_and_height & VRAM_WIDTH_MASK);
+          rectangle_height = static_cast<s32>((width_and_height >> 16) & VRAM_HEIGHT_MASK);
+
+          if (rectangle_width >= MAX_PRIMITIVE_WIDTH || rectangle_height >= MAX_PRIMITIVE_HEIGHT)
+          {
+            Log_DebugFmt("Culling too-large rectangle: {},{} {}x{}", pos_x, pos_y, rectangle_width, rectangle_height);
+            return;
+          }
+        }
+        break;
+      }
+
+      if (!IsDrawingAreaIsValid()) [[unlikely]]
+        return;
+
+      AddDrawRectangleTicks(pos_x, pos_y, rectangle_width, rectangle_height, rc.texture_enable, rc.transparency_enable);
+
+      if (m_sw_renderer)
+      {
+        GPUBackendDrawRectangleCommand* sw_cmd = m_sw_renderer->NewDrawRectangleCommand();
+        FillDrawCommand(sw_cmd, rc);
+        sw_cmd->color = color;
+        sw_cmd->x = pos_x;
+        sw_cmd->y = pos_y;
+        sw_cmd->width = static_cast<u16>(rectangle_width);
+        sw_cmd->height = static_cast<u16>(rectangle_height);
+        sw_cmd->texcoord = texcoord;
+        m_sw_renderer->PushCommand(sw_cmd);
+      }
+
+      GPUBackendDrawRectangleCommand* cmd = m_render_queue.NewDrawRectangleCommand();
+      FillRenderDrawCommand(cmd, rc);
+      cmd->color = color;
+      cmd->x = pos_x;
+      cmd->y = pos_y;
+      cmd->width = static_cast<u16>(rectangle_width);
+      cmd->height = static_cast<u16>(rectangle_height);
+      cmd->texcoord = texcoord;
+      PushRenderDrawCommand(cmd);
+    }
+    break;
+
+    case GPUPrimitive::Line:
+    {
+      if (!rc.polyline)
+      {
+        u32 start_color, end_color;
+        GPUVertexPosition start_pos, end_pos;
+        if (rc.shading_enable)
+        {
+          start_color = rc.color_for_first_vertex;
+          start_pos.bits = FifoPop();
+          end_color = FifoPop() & UINT32_C(0x00FFFFFF);
+          end_pos.bits = FifoPop();
+        }
+        else
+        {
+          start_color = end_color = rc.color_for_first_vertex;
+          start_pos.bits = FifoPop();
+          end_pos.bits = FifoPop();
+        }
 
-#if 0
-      if (m_vram_dirty_rect.Valid())
-      {
-        GL_INS_FMT("VRAM DIRTY: {},{} => {},{}", m_vram_dirty_rect.left, m_vram_dirty_rect.top, m_vram_dirty_rect.right,
-                   m_vram_dirty_rect.bottom);
+        if (!IsDrawingAreaIsValid()) [[unlikely]]
+          return;
 
-        auto tpr = m_draw_mode.mode_reg.GetTexturePageRectangle();
-        GL_INS_FMT("PAGE RECT: {},{} => {},{}", tpr.left, tpr.top, tpr.right, tpr.bottom);
-        if (m_draw_mode.mode_reg.IsUsingPalette())
+        s32 start_x = start_pos.x + m_drawing_offset.x;
+        s32 start_y = start_pos.y + m_drawing_offset.y;
+        s32 end_x = end_pos.x + m_drawing_offset.x;
+        s32 end_y = end_pos.y + m_drawing_offset.y;
+        const auto [min_x, max_x] = MinMax(start_x, end_x);
+        const auto [min_y, max_y] = MinMax(start_y, end_y);
+        if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
         {
-          tpr = m_draw_mode.GetTexturePaletteRectangle();
-          GL_INS_FMT("PALETTE RECT: {},{} => {},{}", tpr.left, tpr.top, tpr.right, tpr.bottom);
+          Log_DebugFmt("Culling too-large line: {},{} - {},{}", start_x, start_y, end_x, end_y);
+          return;
         }
-      }
-#endif
 
-      if (m_draw_mode.mode_reg.IsUsingPalette())
-      {
-        const Common::Rectangle<u32> palette_rect =
-          m_draw_mode.palette_reg.GetRectangle(m_draw_mode.mode_reg.texture_mode);
-        const bool update_drawn = palette_rect.Intersects(m_vram_dirty_draw_rect);
-        const bool update_written = palette_rect.Intersects(m_vram_dirty_write_rect);
-        if (update_drawn || update_written)
-        {
-          GL_INS("Palette in VRAM dirty area, flushing cache");
-          if (!IsFlushed())
-            FlushRender();
+        AddDrawLineTicks(min_x, min_y, max_x, max_y, rc.shading_enable);
 
-          UpdateVRAMReadTexture(update_drawn, update_written);
+        if (m_sw_renderer)
+        {
+          GPUBackendDrawLineCommand* sw_cmd = m_sw_renderer->NewDrawLineCommand(2);
+          FillDrawCommand(sw_cmd, rc);
+          sw_cmd->vertices[0].Set(start_x, start_y, start_color);
+          sw_cmd->vertices[1].Set(end_x, end_y, end_color);
+          m_sw_renderer->PushCommand(sw_cmd);
         }
-      }
 
-      const Common::Rectangle<u32> page_rect = m_draw_mode.mode_reg.GetTexturePageRectangle();
-      u8 new_texpage_dirty = m_vram_dirty_draw_rect.Intersects(page_rect) ? TEXPAGE_DIRTY_DRAWN_RECT : 0;
-      new_texpage_dirty |= m_vram_dirty_write_rect.Intersects(page_rect) ? TEXPAGE_DIRTY_WRITTEN_RECT : 0;
-
-      if (new_texpage_dirty != 0)
-      {
-        GL_INS("Texpage is in dirty area, checking UV ranges");
-        m_texpage_dirty = new_texpage_dirty;
-        m_compute_uv_range = true;
-        m_current_uv_range.SetInvalid();
+        GPUBackendDrawLineCommand* cmd = m_render_queue.NewDrawLineCommand(2);
+        FillRenderDrawCommand(cmd, rc);
+        cmd->vertices[0].Set(start_x, start_y, start_color);
+        cmd->vertices[1].Set(end_x, end_y, end_color);
+        PushRenderDrawCommand(cmd);
       }
       else
       {
-        m_compute_uv_range = m_clamp_uvs;
-        if (m_texpage_dirty)
-          GL_INS("Texpage is no longer dirty");
-        m_texpage_dirty = 0;
-      }
-    }
-
-    texture_mode = m_draw_mode.mode_reg.texture_mode;
-    if (rc.raw_texture_enable)
-    {
-      texture_mode =
-        static_cast<GPUTextureMode>(static_cast<u8>(texture_mode) | static_cast<u8>(GPUTextureMode::RawTextureBit));
-    }
-  }
-  else
-  {
-    texture_mode = GPUTextureMode::Disabled;
-  }
-
-  // has any state changed which requires a new batch?
-  // Reverse blending breaks with mixed transparent and opaque pixels, so we have to do one draw per polygon.
-  // If we have fbfetch, we don't need to draw it in two passes. Test case: Suikoden 2 shadows.
-  const GPUTransparencyMode transparency_mode =
-    rc.transparency_enable ? m_draw_mode.mode_reg.transparency_mode : GPUTransparencyMode::Disabled;
-  const bool dithering_enable = (!m_true_color && rc.IsDitheringEnabled()) ? m_GPUSTAT.dither_enable : false;
-  if (texture_mode != m_batch.texture_mode || transparency_mode != m_batch.transparency_mode ||
-      (transparency_mode == GPUTransparencyMode::BackgroundMinusForeground && !m_allow_shader_blend) ||
-      dithering_enable != m_batch.dithering)
-  {
-    FlushRender();
-  }
+        const u32 num_vertices = GetPolyLineVertexCount();
+        if (!IsDrawingAreaIsValid()) [[unlikely]]
+          return;
 
-  EnsureVertexBufferSpaceForCurrentCommand();
+        const bool shaded = rc.shading_enable;
 
-  if (m_batch_index_count == 0)
-  {
-    // transparency mode change
-    const bool check_mask_before_draw = m_GPUSTAT.check_mask_before_draw;
-    if (transparency_mode != GPUTransparencyMode::Disabled &&
-        (texture_mode == GPUTextureMode::Disabled || !NeedsShaderBlending(transparency_mode, check_mask_before_draw)))
-    {
-      static constexpr float transparent_alpha[4][2] = {{0.5f, 0.5f}, {1.0f, 1.0f}, {1.0f, 1.0f}, {0.25f, 1.0f}};
+        GPUBackendDrawLineCommand* cmd = m_render_queue.NewDrawLineCommand(num_vertices);
+        FillRenderDrawCommand(cmd, rc);
 
-      const float src_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][0];
-      const float dst_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][1];
-      m_batch_ubo_dirty |= (m_batch_ubo_data.u_src_alpha_factor != src_alpha_factor ||
-                            m_batch_ubo_data.u_dst_alpha_factor != dst_alpha_factor);
-      m_batch_ubo_data.u_src_alpha_factor = src_alpha_factor;
-      m_batch_ubo_data.u_dst_alpha_factor = dst_alpha_factor;
-    }
+        u32 buffer_pos = 0;
+        const GPUVertexPosition start_vp{m_blit_buffer[buffer_pos++]};
+        s32 start_x = start_vp.x + m_drawing_offset.x;
+        s32 start_y = start_vp.y + m_drawing_offset.y;
+        u32 start_color = rc.color_for_first_vertex;
+        cmd->vertices[0].Set(start_x, start_y, start_color);
 
-    const bool set_mask_while_drawing = m_GPUSTAT.set_mask_while_drawing;
-    if (m_batch.check_mask_before_draw != check_mask_before_draw ||
-        m_batch.set_mask_while_drawing != set_mask_while_drawing)
-    {
-      m_batch.check_mask_before_draw = check_mask_before_draw;
-      m_batch.set_mask_while_drawing = set_mask_while_drawing;
-      m_batch_ubo_dirty |= (m_batch_ubo_data.u_set_mask_while_drawing != BoolToUInt32(set_mask_while_drawing));
-      m_batch_ubo_data.u_set_mask_while_drawing = BoolToUInt32(set_mask_while_drawing);
-    }
+        for (u32 i = 1; i < num_vertices; i++)
+        {
+          const u32 end_color = shaded ? (m_blit_buffer[buffer_pos++] & UINT32_C(0x00FFFFFF)) : start_color;
+          const GPUVertexPosition vp{m_blit_buffer[buffer_pos++]};
+          const s32 end_x = m_drawing_offset.x + vp.x;
+          const s32 end_y = m_drawing_offset.y + vp.y;
 
-    m_batch.interlacing = IsInterlacedRenderingEnabled();
-    if (m_batch.interlacing)
-    {
-      const u32 displayed_field = GetActiveLineLSB();
-      m_batch_ubo_dirty |= (m_batch_ubo_data.u_interlaced_displayed_field != displayed_field);
-      m_batch_ubo_data.u_interlaced_displayed_field = displayed_field;
-    }
+          const auto [min_x, max_x] = MinMax(start_x, end_x);
+          const auto [min_y, max_y] = MinMax(start_y, end_y);
+          if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
+            Log_DebugFmt("Culling too-large line: {},{} - {},{}", start_x, start_y, end_x, end_y);
+          else
+            AddDrawLineTicks(min_x, min_y, max_x, max_y, rc.shading_enable);
 
-    // update state
-    m_batch.texture_mode = texture_mode;
-    m_batch.transparency_mode = transparency_mode;
-    m_batch.dithering = dithering_enable;
+          start_x = end_x;
+          start_y = end_y;
+          start_color = end_color;
+          cmd->vertices[i].Set(end_x, end_y, end_color);
+        }
 
-    if (m_draw_mode.IsTextureWindowChanged())
-    {
-      m_draw_mode.ClearTextureWindowChangedFlag();
+        if (m_sw_renderer)
+        {
+          GPUBackendDrawLineCommand* sw_cmd = m_sw_renderer->NewDrawLineCommand(num_vertices);
+          FillDrawCommand(sw_cmd, rc);
+          std::memcpy(sw_cmd->vertices, cmd->vertices, sizeof(GPUBackendDrawLineCommand::Vertex) * num_vertices);
+          m_sw_renderer->PushCommand(sw_cmd);
+        }
 
-      m_batch_ubo_data.u_texture_window_and[0] = ZeroExtend32(m_draw_mode.texture_window.and_x);
-      m_batch_ubo_data.u_texture_window_and[1] = ZeroExtend32(m_draw_mode.texture_window.and_y);
-      m_batch_ubo_data.u_texture_window_or[0] = ZeroExtend32(m_draw_mode.texture_window.or_x);
-      m_batch_ubo_data.u_texture_window_or[1] = ZeroExtend32(m_draw_mode.texture_window.or_y);
-      m_batch_ubo_dirty = true;
+        PushRenderDrawCommand(cmd);
+      }
     }
+    break;
 
-    if (m_drawing_area_changed)
-    {
-      m_drawing_area_changed = false;
-      SetClampedDrawingArea();
-      SetScissor();
+    default:
+      UnreachableCode();
+      break;
+  }
+}
 
-      if (m_pgxp_depth_buffer && m_last_depth_z < 1.0f)
-        ClearDepthBuffer();
+void GPU_HW::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  GPUBackendUpdateCLUTCommand* cmd = m_render_queue.NewUpdateCLUTCommand();
+  FillBackendCommandParameters(cmd);
+  cmd->reg.bits = reg.bits;
+  cmd->clut_is_8bit = clut_is_8bit;
+  m_render_queue.PushCommand(cmd);
+}
 
-      if (m_sw_renderer)
-      {
-        GPUBackendSetDrawingAreaCommand* cmd = m_sw_renderer->NewSetDrawingAreaCommand();
-        cmd->new_area = m_drawing_area;
-        m_sw_renderer->PushCommand(cmd);
-      }
-    }
-  }
+void GPU_HW::FlushRender()
+{
+  m_render_queue.PushCommand(m_render_queue.NewFlushRenderCommand());
+}
 
-  LoadVertices();
+void GPU_HW::SyncRenderThread()
+{
+  m_render_queue.Sync(true);
 }
 
-void GPU_HW::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+void GPU_HW::RenderUpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
 {
   // Not done in HW
   GL_INS_FMT("Reloading CLUT from {},{}, {} not implemented", reg.GetXBase(), reg.GetYBase(),
              clut_is_8bit ? "8-bit" : "4-bit");
 }
 
-void GPU_HW::FlushRender()
+void GPU_HW::FlushBatch()
 {
+  TRACE_ZONE("GPU_HW::FlushBatch");
+
   const u32 base_vertex = m_batch_base_vertex;
   const u32 base_index = m_batch_base_index;
   const u32 index_count = m_batch_index_count;
@@ -3132,17 +4529,30 @@ void GPU_HW::FlushRender()
   GL_SCOPE_FMT("Hardware Draw {}", ++s_draw_number);
 #endif
 
+  SetTimingRegion(GPUTimingRegion::Draw);
+
   GL_INS_FMT("Dirty draw area: {},{} => {},{} ({}x{})", m_vram_dirty_draw_rect.left, m_vram_dirty_draw_rect.top,
              m_vram_dirty_draw_rect.right, m_vram_dirty_draw_rect.bottom, m_vram_dirty_draw_rect.GetWidth(),
              m_vram_dirty_draw_rect.GetHeight());
 
-  if (m_batch_ubo_dirty)
+  if (m_sparse_vram_draw_rect.Valid())
+  {
+    CommitSparseVRAM(m_sparse_vram_draw_rect);
+    m_sparse_vram_draw_rect.SetInvalid();
+  }
+
+  if (m_batch_ubo_dirty && !m_batch_push_constants)
   {
     g_gpu_device->UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
     // m_counters.num_ubo_updates++;
     m_batch_ubo_dirty = false;
   }
 
+  // Filtered texpage draws sample the cache instead of VRAM.
+  const bool filtered_texpage = (static_cast<u8>(m_batch.texture_mode) >= FILTERED_TEXTURE_MODE);
+  if (filtered_texpage)
+    g_gpu_device->SetTextureSampler(0, m_filtered_texpage_texture.get(), g_gpu_device->GetNearestSampler());
+
   if (m_wireframe_mode != GPUWireframeMode::OnlyWireframe)
   {
     if (NeedsShaderBlending(m_batch.transparency_mode, m_batch.check_mask_before_draw))
@@ -3165,14 +4575,22 @@ void GPU_HW::FlushRender()
     g_gpu_device->SetPipeline(m_wireframe_pipeline.get());
     g_gpu_device->DrawIndexed(index_count, base_index, base_vertex);
   }
+
+  if (filtered_texpage)
+    g_gpu_device->SetTextureSampler(0, m_vram_read_texture.get(), g_gpu_device->GetNearestSampler());
 }
 
 void GPU_HW::UpdateDisplay()
 {
-  FlushRender();
+  RenderThreadSuspendScope suspend(m_render_queue);
+  FlushBatch();
+  FlushVRAMWrites();
+  CompileDeferredPipelines();
 
   GL_SCOPE("UpdateDisplay()");
 
+  m_display_frame_unchanged = false;
+
   if (g_settings.debugging.show_vram)
   {
     if (IsUsingMultisampling())
@@ -3207,6 +4625,30 @@ void GPU_HW::UpdateDisplay()
   const u32 line_skip = BoolToUInt32(interlaced && m_GPUSTAT.vertical_resolution);
   bool drew_anything = false;
 
+  // 24-bit lines are read as 1.5 halfwords per pixel from the start X. Areas which wrap are affected by any change.
+  const u32 vram_left = m_GPUSTAT.display_area_color_depth_24 ? m_crtc_state.regs.X : m_crtc_state.display_vram_left;
+  const u32 vram_width =
+    m_GPUSTAT.display_area_color_depth_24 ?
+      ((m_crtc_state.display_vram_left - m_crtc_state.regs.X + m_crtc_state.display_vram_width) * 3u + 1u) / 2u :
+      m_crtc_state.display_vram_width;
+  Common::Rectangle<u32> display_vram_rect = Common::Rectangle<u32>::FromExtents(
+    vram_left, m_crtc_state.display_vram_top, vram_width, m_crtc_state.display_vram_height);
+  if (display_vram_rect.right > VRAM_WIDTH || display_vram_rect.bottom > VRAM_HEIGHT)
+    display_vram_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+
+  // Nothing has touched the displayed area since the last frame, so the display texture already holds this frame.
+  // Interlaced frames show the other field each time, so are always updated.
+  const bool unchanged = (g_settings.display_skip_unchanged_frames && !m_display_vram_changed && !interlaced &&
+                          !IsDisplayDisabled() && HasDisplayTexture() && display_vram_rect == m_display_vram_rect);
+  m_display_vram_rect = display_vram_rect;
+  m_display_vram_changed = false;
+  if (unchanged)
+  {
+    GL_INS("Display area unchanged, skipping update");
+    m_display_frame_unchanged = true;
+    return;
+  }
+
   if (IsDisplayDisabled())
   {
     ClearDisplayTexture();
@@ -3287,11 +4729,12 @@ void GPU_HW::UpdateDisplay()
   }
 
   if (drew_anything)
-    RestoreDeviceContext();
+    RestoreVRAMRenderState();
 }
 
 void GPU_HW::DownsampleFramebuffer(GPUTexture* source, u32 left, u32 top, u32 width, u32 height)
 {
+  SetTimingRegion(GPUTimingRegion::Downsample);
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
     DownsampleFramebufferAdaptive(source, left, top, width, height);
   else
@@ -3412,7 +4855,7 @@ void GPU_HW::DownsampleFramebufferAdaptive(GPUTexture* source, u32 left, u32 top
 
   GL_POP();
 
-  RestoreDeviceContext();
+  RestoreVRAMRenderState();
 
   SetDisplayTexture(m_downsample_texture.get(), 0, 0, width, height);
 }
@@ -3451,7 +4894,7 @@ void GPU_HW::DownsampleFramebufferBoxFilter(GPUTexture* source, u32 left, u32 to
   g_gpu_device->SetViewportAndScissor(0, 0, ds_width, ds_height);
   g_gpu_device->Draw(3, 0);
 
-  RestoreDeviceContext();
+  RestoreVRAMRenderState();
 
   SetDisplayTexture(m_downsample_texture.get(), 0, 0, ds_width, ds_height);
 }
@@ -3472,6 +4915,20 @@ void GPU_HW::DrawRendererStats()
                 VRAM_HEIGHT * m_resolution_scale);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Sparse VRAM:");
+    ImGui::NextColumn();
+    if (IsUsingSparseVRAM())
+    {
+      ImGui::TextColored(active_color, "%u of %u blocks",
+                         static_cast<u32>(std::count(m_sparse_vram_blocks.begin(), m_sparse_vram_blocks.end(), true)),
+                         static_cast<u32>(m_sparse_vram_blocks.size()));
+    }
+    else
+    {
+      ImGui::TextColored(inactive_color, "Disabled");
+    }
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("Effective Display Resolution:");
     ImGui::NextColumn();
     ImGui::Text("%ux%u", m_crtc_state.display_vram_width * m_resolution_scale,
@@ -3493,6 +4950,11 @@ void GPU_HW::DrawRendererStats()
     ImGui::TextColored(m_scaled_dithering ? active_color : inactive_color, m_scaled_dithering ? "Enabled" : "Disabled");
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Batch Uniforms:");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted(m_batch_push_constants ? "Push Constants" : "Uniform Buffer");
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("Texture Filtering:");
     ImGui::NextColumn();
     ImGui::TextColored((m_texture_filtering != GPUTextureFilter::Nearest) ? active_color : inactive_color, "%s",
@@ -3517,6 +4979,142 @@ void GPU_HW::DrawRendererStats()
   }
 }
 
+GPU_HW::RenderQueue::RenderQueue(GPU_HW* gpu) : m_gpu(gpu)
+{
+}
+
+GPU_HW::RenderQueue::~RenderQueue() = default;
+
+bool GPU_HW::RenderQueue::ShouldUseThread()
+{
+  const RenderAPI api = g_gpu_device->GetRenderAPI();
+  return (g_settings.gpu_use_hardware_render_thread && api != RenderAPI::OpenGL && api != RenderAPI::OpenGLES);
+}
+
+bool GPU_HW::RenderQueue::Initialize(bool force_thread)
+{
+  if (force_thread || ShouldUseThread())
+    StartGPUThread();
+
+  return true;
+}
+
+void GPU_HW::RenderQueue::UpdateSettings()
+{
+  DebugAssert(m_suspend_count == 0);
+  Sync(true);
+
+  const bool use_thread = ShouldUseThread();
+  if (m_use_gpu_thread != use_thread)
+  {
+    if (!use_thread)
+      StopGPUThread();
+    else
+      StartGPUThread();
+  }
+}
+
+void GPU_HW::RenderQueue::Shutdown()
+{
+  DebugAssert(m_suspend_count == 0);
+
+  // Commands which haven't been executed yet are dropped when the thread stops.
+  if (m_use_gpu_thread)
+    Sync(false);
+
+  StopGPUThread();
+}
+
+GPUBackendDrawPrecisePolygonCommand* GPU_HW::RenderQueue::NewDrawPrecisePolygonCommand(u32 num_vertices)
+{
+  const u32 size =
+    sizeof(GPUBackendDrawPrecisePolygonCommand) + (num_vertices * sizeof(GPUBackendDrawPrecisePolygonCommand::Vertex));
+  GPUBackendDrawPrecisePolygonCommand* cmd = static_cast<GPUBackendDrawPrecisePolygonCommand*>(
+    AllocateCommand(GPUBackendCommandType::DrawPrecisePolygon, size));
+  cmd->num_vertices = Truncate16(num_vertices);
+  return cmd;
+}
+
+void GPU_HW::RenderQueue::SuspendThread()
+{
+  if (m_suspend_count++ > 0 || !m_use_gpu_thread)
+    return;
+
+  Sync(false);
+  m_use_gpu_thread = false;
+  m_thread_suspended = true;
+}
+
+void GPU_HW::RenderQueue::ResumeThread()
+{
+  DebugAssert(m_suspend_count > 0);
+  if (--m_suspend_count > 0 || !m_thread_suspended)
+    return;
+
+  m_use_gpu_thread = true;
+  m_thread_suspended = false;
+}
+
+void GPU_HW::RenderQueue::HandleCommand(const GPUBackendCommand* cmd)
+{
+  if (cmd->type == GPUBackendCommandType::DrawPrecisePolygon)
+  {
+    m_gpu->DrawPrecisePolygon(static_cast<const GPUBackendDrawPrecisePolygonCommand*>(cmd));
+    return;
+  }
+
+  GPUBackend::HandleCommand(cmd);
+}
+
+void GPU_HW::RenderQueue::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+{
+  m_gpu->RenderFillVRAM(x, y, width, height, color, params);
+}
+
+void GPU_HW::RenderQueue::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
+                                     GPUBackendCommandParameters params)
+{
+  m_gpu->RenderUpdateVRAM(x, y, width, height, data, params.set_mask_while_drawing, params.check_mask_before_draw,
+                          nullptr);
+}
+
+void GPU_HW::RenderQueue::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                                   GPUBackendCommandParameters params)
+{
+  m_gpu->RenderCopyVRAM(src_x, src_y, dst_x, dst_y, width, height, params);
+}
+
+void GPU_HW::RenderQueue::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  // Polygons are always queued with their precise positions.
+  UnreachableCode();
+}
+
+void GPU_HW::RenderQueue::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  m_gpu->DrawRectangle(cmd);
+}
+
+void GPU_HW::RenderQueue::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  m_gpu->DrawLine(cmd);
+}
+
+void GPU_HW::RenderQueue::FlushRender()
+{
+  m_gpu->FlushBatch();
+}
+
+void GPU_HW::RenderQueue::DrawingAreaChanged()
+{
+  m_gpu->DrawingAreaChanged();
+}
+
+void GPU_HW::RenderQueue::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  m_gpu->RenderUpdateCLUT(reg, clut_is_8bit);
+}
+
 std::unique_ptr<GPU> GPU::CreateHardwareRenderer()
 {
   std::unique_ptr<GPU_HW> gpu(std::make_unique<GPU_HW>());
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "gpu.h"
+#include "gpu_backend.h"
 #include "texture_replacements.h"
 
 #include "util/gpu_device.h"
@@ -11,16 +12,20 @@
 #include "common/dimensional_array.h"
 #include "common/heap_array.h"
 
+#include <array>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+class GPU_HW_ShaderGen;
 class GPU_SW_Backend;
-struct GPUBackendCommand;
-struct GPUBackendDrawCommand;
 
+// GP0 commands are decoded on the emulation thread into self-contained packets, which the render queue executes to do
+// the batching, vertex generation and device submission. The queue runs inline by default, or on its own thread when
+// GPU/UseHardwareRenderThread is set. Everything else which uses the device or the render state, i.e. VRAM readbacks,
+// display updates, state saves and presentation, waits for the thread to go idle first.
 class GPU_HW final : public GPU
 {
 public:
@@ -42,11 +47,14 @@ public:
   bool Initialize() override;
   void Reset(bool clear_vram) override;
   bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display) override;
+  std::unique_ptr<GPUTexture> CreateVRAMSnapshotTexture() override;
+  bool IsValidVRAMSnapshotTexture(const GPUTexture* tex) const override;
 
   void RestoreDeviceContext() override;
 
   void UpdateSettings(const Settings& old_settings) override;
   void UpdateResolutionScale() override final;
+  void UpdateDynamicResolution(float average_gpu_time, float frame_time_budget) override final;
   std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true) override;
   std::tuple<u32, u32> GetFullDisplayResolution(bool scaled = true) override;
 
@@ -59,11 +67,44 @@ private:
     MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
                                  (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
   };
+  enum : u32
+  {
+    // Dirty VRAM is tracked in 64x64 tiles on top of the bounding rectangles, so updating the read texture only copies
+    // the areas which were actually drawn or written, not everything between them.
+    VRAM_DIRTY_TILE_SIZE = 64,
+    VRAM_DIRTY_TILES_WIDE = VRAM_WIDTH / VRAM_DIRTY_TILE_SIZE,
+    VRAM_DIRTY_TILES_HIGH = VRAM_HEIGHT / VRAM_DIRTY_TILE_SIZE,
+  };
   enum : u8
   {
     TEXPAGE_DIRTY_DRAWN_RECT = (1 << 0),
     TEXPAGE_DIRTY_WRITTEN_RECT = (1 << 1),
   };
+  enum : u32
+  {
+    // Unused bits in the vertex texpage, which carry raw texture/dithering with mixed texture mode batches.
+    TEXPAGE_RAW_TEXTURE_BIT = (1u << 14),
+    TEXPAGE_DITHER_BIT = (1u << 15),
+  };
+
+  // Texture mode index for textured batches which decode the texture mode, raw texture and dithering per-vertex.
+  static constexpr u8 MIXED_TEXTURE_MODE = 9;
+
+  // Texture mode indices for palette draws which sample the filtered texpage cache, without and with raw texturing.
+  static constexpr u8 FILTERED_TEXTURE_MODE = 10;
+  static constexpr u8 FILTERED_RAW_TEXTURE_MODE = 11;
+  static constexpr u8 NUM_BATCH_TEXTURE_MODES = 12;
+
+  // The filtered texpage cache is an atlas of upscaled pages, four wide and up to four high, within the texel budget.
+  static constexpr u32 FILTERED_TEXPAGE_CACHE_COLUMNS = 4;
+  static constexpr u32 MAX_FILTERED_TEXPAGES = 16;
+  static constexpr u32 MAX_FILTERED_TEXPAGE_CACHE_TEXELS = 4096 * 4096;
+
+  // Specialized textured pipelines which can be built after startup, grouped by [dithering][texture_mode].
+  static constexpr u8 NUM_DEFERRED_TEXTURE_MODES = static_cast<u8>(GPUTextureMode::Disabled);
+  static constexpr u32 NUM_DEFERRED_PIPELINES_PER_GROUP = 2 * 5 * 5 * 2 * 2;
+  static constexpr u8 NUM_DEFERRED_GROUPS = NUM_DEFERRED_TEXTURE_MODES * 2;
+  static constexpr u32 NUM_DEFERRED_PIPELINES = NUM_DEFERRED_GROUPS * NUM_DEFERRED_PIPELINES_PER_GROUP;
 
   static_assert(GPUDevice::MIN_TEXEL_BUFFER_ELEMENTS >= (VRAM_WIDTH * VRAM_HEIGHT));
 
@@ -85,6 +126,18 @@ private:
     void SetUVLimits(u32 min_u, u32 max_u, u32 min_v, u32 max_v);
   };
 
+  /// Polygon vertices before they're written to the vertex buffer, with each attribute in its own array so all of the
+  /// vertices can be processed at once. Triangles duplicate the first vertex into the fourth slot.
+  struct alignas(16) PolygonVertices
+  {
+    float x[4];
+    float y[4];
+    float w[4];
+    u32 color[4];
+    u16 u[4];
+    u16 v[4];
+  };
+
   struct BatchConfig
   {
     GPUTextureMode texture_mode = GPUTextureMode::Disabled;
@@ -109,6 +162,14 @@ private:
     u32 u_set_mask_while_drawing;
   };
 
+  struct FilteredTexPage
+  {
+    u32 key; // texpage x/y/mode in the low 16 bits, palette in the upper 16 bits
+    u32 last_used;
+    Common::Rectangle<u32> page_rect;
+    Common::Rectangle<u32> palette_rect;
+  };
+
   struct RendererStats
   {
     u32 num_batches;
@@ -116,6 +177,59 @@ private:
     u32 num_uniform_buffer_updates;
   };
 
+  /// Executes decoded commands with the render side of GPU_HW, either inline or on the render thread.
+  class RenderQueue final : public GPUBackend
+  {
+  public:
+    explicit RenderQueue(GPU_HW* gpu);
+    ~RenderQueue() override;
+
+    ALWAYS_INLINE const GPUDrawingArea& GetDrawingArea() const { return m_drawing_area; }
+
+    bool Initialize(bool force_thread) override;
+    void UpdateSettings() override;
+    void Shutdown() override;
+
+    GPUBackendDrawPrecisePolygonCommand* NewDrawPrecisePolygonCommand(u32 num_vertices);
+
+    /// Waits for the render thread to go idle, and executes commands inline until resumed. Can be nested.
+    void SuspendThread();
+    void ResumeThread();
+
+  protected:
+    void HandleCommand(const GPUBackendCommand* cmd) override;
+
+    void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params) override;
+    void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, GPUBackendCommandParameters params) override;
+    void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                  GPUBackendCommandParameters params) override;
+    void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd) override;
+    void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd) override;
+    void DrawLine(const GPUBackendDrawLineCommand* cmd) override;
+    void FlushRender() override;
+    void DrawingAreaChanged() override;
+    void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
+
+  private:
+    /// The device is current on one thread with OpenGL, so the render thread is only used with the other APIs.
+    static bool ShouldUseThread();
+
+    GPU_HW* m_gpu;
+    u32 m_suspend_count = 0;
+    bool m_thread_suspended = false;
+  };
+
+  /// Suspends the render thread for the lifetime of the scope.
+  class RenderThreadSuspendScope
+  {
+  public:
+    explicit RenderThreadSuspendScope(RenderQueue& queue) : m_queue(queue) { m_queue.SuspendThread(); }
+    ~RenderThreadSuspendScope() { m_queue.ResumeThread(); }
+
+  private:
+    RenderQueue& m_queue;
+  };
+
   /// Returns true if a depth buffer should be created.
   bool NeedsDepthBuffer() const;
 
@@ -123,17 +237,53 @@ private:
   void ClearFramebuffer();
   void DestroyBuffers();
 
+  /// Sparse VRAM only backs the blocks of the scaled VRAM which have been drawn or written to.
+  ALWAYS_INLINE bool IsUsingSparseVRAM() const { return !m_sparse_vram_blocks.empty(); }
+  bool CreateSparseVRAMTextures(u32 width, u32 height, bool needs_depth_buffer);
+
+  /// Commits any blocks overlapping the native VRAM rectangle, clearing them to black.
+  void CommitSparseVRAM(const Common::Rectangle<u32>& rect);
+  void CommitSparseVRAMForWrite(u32 x, u32 y, u32 width, u32 height, const u16* data, u32 data_stride, bool set_mask);
+  bool CommitSparseVRAMBlock(u32 block_x, u32 block_y);
+
   bool CompilePipelines();
   void DestroyPipelines();
 
-  void LoadVertices();
+  static std::span<const GPUPipeline::VertexAttribute> GetBatchVertexAttributes(bool textured, bool uv_limits);
+  void InitBatchPipelineConfig(GPUPipeline::GraphicsConfig& plconfig) const;
+  bool IsBatchRenderModeUsed(u8 render_mode) const;
+
+  /// Sets the vertex layout, depth and blend state for a batch pipeline. Returns true if it uses shader blending.
+  bool SetBatchPipelineState(GPUPipeline::GraphicsConfig& plconfig, u8 depth_test, u8 transparency_mode,
+                             u8 render_mode, u8 texture_mode, u8 check_mask) const;
+
+  /// Builds specialized pipelines skipped at startup, until the per-frame time budget runs out.
+  void CompileDeferredPipelines();
+
+  /// Per-game record of which deferred groups were used, so they can be compiled first on the next boot.
+  std::string GetPipelineUsageFileName() const;
+  void LoadPipelineUsage();
+  void SavePipelineUsage();
+  void RecordDeferredGroupUsed(u32 group);
+
+  /// Sets up the batch for a draw command, flushing if the state changed. Returns the texpage for its vertices.
+  u32 PrepareDraw(const GPUBackendDrawCommand* cmd, u32 required_vertices, u32 required_indices);
+  void DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd);
 
   void PrintSettingsToLog();
   void CheckSettings();
 
   void SetClampedDrawingArea();
+  void DrawingAreaChanged();
   void UpdateVRAMReadTexture(bool drawn, bool written);
+  void UpdateVRAMReadTextureForCopy(const Common::Rectangle<u32>& src_bounds, bool drawn, bool written);
+  void CopyDirtyVRAMTiles(const Common::Rectangle<u32>& rect);
   void UpdateDepthBufferFromMaskBit();
+
+  /// Fills the VRAM texture from a copy of VRAM at another resolution scale.
+  void RescaleVRAM(GPUTexture* src);
   void ClearDepthBuffer();
   void SetScissor();
   void SetVRAMRenderTarget();
@@ -147,10 +297,22 @@ private:
   bool IsUsingMultisampling() const;
   bool IsUsingDownsampling() const;
 
+  /// Returns true if palette texture pages should be filtered once into the cache, instead of on every draw.
+  bool ShouldCacheFilteredTexPages() const;
+  bool IsBatchTextureModeUsed(u8 texture_mode) const;
+
+  /// Returns the cache slot holding the filtered current texpage and palette, filtering it if needed. Returns -1 if
+  /// the draw can't use the cache.
+  s32 GetFilteredTexPageSlot();
+  bool FilterTexPage(u32 slot, const FilteredTexPage& page);
+  void InvalidateFilteredTexPages(u32 left, u32 top, u32 right, u32 bottom);
+  void DestroyFilteredTexPageCache();
+
   void SetFullVRAMDirtyRectangle();
   void ClearVRAMDirtyRectangle();
   void IncludeVRAMDirtyRectangle(Common::Rectangle<u32>& rect, const Common::Rectangle<u32>& new_rect);
   void IncludeDrawnDirtyRectangle(s32 min_x, s32 min_y, s32 max_x, s32 max_y);
+  void MarkVRAMTilesDirty(u32 left, u32 top, u32 right, u32 bottom);
   void CheckForTexPageOverlap(u32 texpage, u32 min_u, u32 min_v, u32 max_u, u32 max_v);
 
   bool IsFlushed() const;
@@ -169,32 +331,66 @@ private:
 
   void FillBackendCommandParameters(GPUBackendCommand* cmd) const;
   void FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
+
+  /// Fills a draw command for the render queue, which interlaces with the same rules as the hardware batches.
+  void FillRenderDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
+  void PushRenderDrawCommand(GPUBackendDrawCommand* cmd);
   void UpdateSoftwareRenderer(bool copy_vram_from_hw);
 
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  bool BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height) override;
+  void FinishVRAMReadback() override;
+  void QueueVRAMReadback(u32 x, u32 y, u32 width, u32 height);
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
+  void DrawVRAMWrite(u32 x, u32 y, u32 width, u32 height, const u16* data, u32 data_stride, bool set_mask,
+                     bool check_mask);
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void DispatchRenderCommand() override;
   void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
   void FlushRender() override;
+  void SyncRenderThread() override;
   void DrawRendererStats() override;
 
+  // Render side of the above, executed by the render queue.
+  void RenderFillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params);
+  void RenderUpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask,
+                        const TextureReplacementTexture* rtex);
+  void RenderCopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                      GPUBackendCommandParameters params);
+  void RenderUpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit);
+  void FlushBatch();
+  void RestoreVRAMRenderState();
+
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
 
+  /// Draws any VRAM writes which have been coalesced but not yet drawn. Must be called before anything else touches the
+  /// VRAM texture.
+  ALWAYS_INLINE void FlushVRAMWrites()
+  {
+    if (m_pending_vram_write_rect.Valid()) [[unlikely]]
+      FlushPendingVRAMWrite();
+  }
+  void FlushPendingVRAMWrite();
+
   /// Expands a line into two triangles.
   void DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth);
 
   /// Handles quads with flipped texture coordinate directions.
-  void HandleFlippedQuadTextureCoordinates(BatchVertex* vertices);
+  void HandleFlippedQuadTextureCoordinates(PolygonVertices& vertices);
   void ExpandLineTriangles(BatchVertex* vertices, u32 base_vertex);
 
   /// Computes polygon U/V boundaries.
   void ComputePolygonUVLimits(u32 texpage, BatchVertex* vertices, u32 num_vertices);
+  u32 ComputePolygonUVLimits(u32 texpage, const PolygonVertices& vertices);
+
+  /// Writes all four polygon vertices, even for triangles, since space for a quad is always reserved.
+  static void WritePolygonVertices(BatchVertex* dst, const PolygonVertices& vertices, float depth, u32 texpage,
+                                   u32 uv_limits);
 
   /// Sets the depth test flag for PGXP depth buffering.
   void SetBatchDepthBuffer(bool enabled);
-  void CheckForDepthClear(const BatchVertex* vertices, u32 num_vertices);
+  void CheckForDepthClear(const PolygonVertices& vertices, u32 num_vertices);
 
   /// Returns the number of mipmap levels used for adaptive smoothing.
   u32 GetAdaptiveDownsamplingMipLevels() const;
@@ -208,13 +404,22 @@ private:
   std::unique_ptr<GPUTexture> m_vram_read_texture;
   std::unique_ptr<GPUTexture> m_vram_readback_texture;
   std::unique_ptr<GPUDownloadTexture> m_vram_readback_download_texture;
+  Common::Rectangle<u32> m_vram_readback_rect = {};
   std::unique_ptr<GPUTexture> m_vram_replacement_texture;
+  std::unique_ptr<GPUTexture> m_filtered_texpage_texture;
 
   std::unique_ptr<GPUTextureBuffer> m_vram_upload_buffer;
+
+  // Unmasked writes which continue the previous one are staged here at their VRAM position, and drawn as one.
+  FixedHeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram_write_staging;
+  Common::Rectangle<u32> m_pending_vram_write_rect;
+  bool m_pending_vram_write_set_mask = false;
   std::unique_ptr<GPUTexture> m_vram_write_texture;
 
   std::unique_ptr<GPU_SW_Backend> m_sw_renderer;
 
+  RenderQueue m_render_queue{this};
+
   BatchVertex* m_batch_vertex_ptr = nullptr;
   u16* m_batch_index_ptr = nullptr;
   u32 m_batch_base_vertex = 0;
@@ -223,9 +428,18 @@ private:
   u16 m_batch_index_count = 0;
   u16 m_batch_vertex_space = 0;
   u16 m_batch_index_space = 0;
+  u32 m_batch_texpage_bits = 0;
   s32 m_current_depth = 0;
   float m_last_depth_z = 1.0f;
 
+  // Draw state of the command being executed, the emulation side's registers can be ahead of it.
+  GPUDrawModeReg m_render_mode_reg = {};
+  GPUTexturePaletteReg m_render_palette_reg = {};
+  GPUTextureWindow m_render_texture_window = {};
+  bool m_render_texture_page_changed = true;
+  u32 m_current_command_vertices = 0;
+  u32 m_current_command_indices = 0;
+
   u8 m_resolution_scale = 1;
   u8 m_multisamples = 1;
 
@@ -234,6 +448,7 @@ private:
   bool m_per_sample_shading : 1 = false;
   bool m_scaled_dithering : 1 = false;
   bool m_disable_color_perspective : 1 = false;
+  bool m_batch_push_constants : 1 = false;
 
   GPUTextureFilter m_texture_filtering = GPUTextureFilter::Nearest;
   GPULineDetectMode m_line_detect_mode = GPULineDetectMode::Disabled;
@@ -246,11 +461,20 @@ private:
   bool m_pgxp_depth_buffer : 1 = false;
   bool m_allow_shader_blend : 1 = false;
   bool m_prefer_shader_blend : 1 = false;
+  bool m_batch_mixed_texture_modes : 1 = false;
+  bool m_defer_pipeline_compilation : 1 = false;
+  bool m_filtered_texpage_cache : 1 = false;
   u8 m_texpage_dirty = 0;
 
+  // Dynamic resolution, the number of steps below the configured scale, and the intervals with room for one more.
+  u8 m_dynamic_resolution_reduction = 0;
+  u8 m_dynamic_resolution_headroom_intervals = 0;
+  bool m_dynamic_resolution_settling = false;
+
   BatchConfig m_batch;
 
-  // Changed state
+  // Changed state. Uploaded through the uniform stream buffer when dirty, or pushed with every draw when the batch
+  // pipelines use push constants, since other draws overwrite them.
   bool m_batch_ubo_dirty = true;
   BatchUBOData m_batch_ubo_data = {};
 
@@ -258,8 +482,27 @@ private:
   GPUDrawingArea m_clamped_drawing_area = {};
   Common::Rectangle<u32> m_vram_dirty_draw_rect;
   Common::Rectangle<u32> m_vram_dirty_write_rect;
+  std::array<u16, VRAM_DIRTY_TILES_HIGH> m_vram_dirty_tiles = {}; // bit per tile column, for drawn and written
   Common::Rectangle<u32> m_current_uv_range;
 
+  // VRAM area read by the last scanned out frame, and whether anything has been drawn or written to it since.
+  Common::Rectangle<u32> m_display_vram_rect;
+  bool m_display_vram_changed = true;
+
+  // Sparse VRAM blocks are the largest tile size of the sparse textures, so each covers whole tiles in all of them.
+  std::vector<bool> m_sparse_vram_blocks;
+  u32 m_sparse_vram_block_width = 0;
+  u32 m_sparse_vram_block_height = 0;
+  u32 m_sparse_vram_blocks_wide = 0;
+  Common::Rectangle<u32> m_sparse_vram_draw_rect;
+
+  // Filtered texpage cache, the least recently used slot is replaced on a miss. The mask has a bit per valid slot.
+  std::array<FilteredTexPage, MAX_FILTERED_TEXPAGES> m_filtered_texpages = {};
+  u32 m_num_filtered_texpages = 0;
+  u32 m_filtered_texpage_valid_mask = 0;
+  u32 m_filtered_texpage_counter = 0;
+  std::array<std::unique_ptr<GPUPipeline>, 2> m_filtered_texpage_pipelines; // [8bit]
+
   std::unique_ptr<GPUPipeline> m_wireframe_pipeline;
 
   // [wrapped][interlaced]
@@ -272,6 +515,7 @@ private:
   std::unique_ptr<GPUPipeline> m_vram_readback_pipeline;
   std::unique_ptr<GPUPipeline> m_vram_update_depth_pipeline;
   std::unique_ptr<GPUPipeline> m_vram_write_replacement_pipeline;
+  std::unique_ptr<GPUSampler> m_vram_replacement_sampler;
 
   std::array<std::unique_ptr<GPUPipeline>, 2> m_vram_extract_pipeline; // [24bit]
   std::unique_ptr<GPUTexture> m_vram_extract_texture;
@@ -286,5 +530,24 @@ private:
   u32 m_downsample_scale_or_levels = 0;
 
   // [depth_test][transparency_mode][render_mode][texture_mode][dithering][interlacing][check_mask]
-  DimensionalArray<std::unique_ptr<GPUPipeline>, 2, 2, 2, 9, 5, 5, 2> m_batch_pipelines{};
+  DimensionalArray<std::unique_ptr<GPUPipeline>, 2, 2, 2, NUM_BATCH_TEXTURE_MODES, 5, 5, 2> m_batch_pipelines{};
+
+  // Deferred pipeline compilation state. Bit (dithering * 8 + texture_mode) is set once that group is built.
+  u16 m_batch_texture_modes_ready = 0;
+  u32 m_deferred_pipeline_index = 0;
+
+  // Groups in order of first use, including those loaded from the usage file. This is also the compile queue, groups
+  // which are never used are never built. The mask is all set when not recording.
+  std::array<u8, NUM_DEFERRED_GROUPS> m_used_deferred_groups{};
+  u8 m_num_used_deferred_groups = 0;
+  bool m_used_deferred_groups_dirty = false;
+  u16 m_used_deferred_groups_mask = std::numeric_limits<u16>::max();
+  std::string m_pipeline_usage_filename;
+
+  std::unique_ptr<GPU_HW_ShaderGen> m_deferred_shadergen;
+  std::unique_ptr<GPUShader> m_deferred_batch_vertex_shader;
+
+  // [render_mode][transparency_mode][texture_mode][check_mask][dithering][interlacing]
+  DimensionalArray<std::unique_ptr<GPUShader>, 2, 2, 2, NUM_DEFERRED_TEXTURE_MODES, 5, 5>
+    m_deferred_batch_fragment_shaders{};
 };
@@ -56,14 +56,17 @@ void GPU_HW_ShaderGen::WriteBatchUniformBuffer(std::stringstream& ss)
                        {"uint2 u_texture_window_and", "uint2 u_texture_window_or", "float u_src_alpha_factor",
                         "float u_dst_alpha_factor", "uint u_interlaced_displayed_field",
                         "bool u_set_mask_while_drawing"},
-                       false);
+                       true);
 }
 
-std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured, bool pgxp_depth)
+std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured, bool mixed_texture_mode, bool filtered_texpage,
+                                                        bool pgxp_depth)
 {
   std::stringstream ss;
   WriteHeader(ss);
   DefineMacro(ss, "TEXTURED", textured);
+  DefineMacro(ss, "MIXED_TEXTURE_MODE", mixed_texture_mode);
+  DefineMacro(ss, "FILTERED_TEXPAGE", filtered_texpage);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "PGXP_DEPTH", pgxp_depth);
 
@@ -129,12 +132,25 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured, bool pgxp
     v_tex0 = float2(float((a_texcoord & 0xFFFFu) * RESOLUTION_SCALE),
                     float((a_texcoord >> 16) * RESOLUTION_SCALE));
 
-    // base_x,base_y,palette_x,palette_y
-    // Palette X is scaled in fragment shader, since it can wrap.
-    v_texpage.x = (a_texpage & 15u) * 64u * RESOLUTION_SCALE;
-    v_texpage.y = ((a_texpage >> 4) & 1u) * 256u * RESOLUTION_SCALE;
-    v_texpage.z = ((a_texpage >> 16) & 63u) * 16u;
-    v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
+    #if FILTERED_TEXPAGE
+      // Cache column/row in place of the palette, the page has already been decoded and filtered.
+      v_texpage.x = ((a_texpage >> 16) & 255u) * 256u * RESOLUTION_SCALE;
+      v_texpage.y = (a_texpage >> 24) * 256u * RESOLUTION_SCALE;
+      v_texpage.z = 0u;
+      v_texpage.w = 0u;
+    #else
+      // base_x,base_y,palette_x,palette_y
+      // Palette X is scaled in fragment shader, since it can wrap.
+      v_texpage.x = (a_texpage & 15u) * 64u * RESOLUTION_SCALE;
+      v_texpage.y = ((a_texpage >> 4) & 1u) * 256u * RESOLUTION_SCALE;
+      v_texpage.z = ((a_texpage >> 16) & 63u) * 16u;
+      v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
+    #endif
+
+    #if MIXED_TEXTURE_MODE
+      // Texture mode in bits 16-17, raw texture in bit 18, dithering in bit 19.
+      v_texpage.z |= (((a_texpage >> 7) & 3u) | ((a_texpage >> 12) & 12u)) << 16;
+    #endif
 
     #if UV_LIMITS
       v_uv_limits = a_uv_limits * float4(255.0, 255.0, 255.0, 255.0);
@@ -146,6 +162,98 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured, bool pgxp
   return ss.str();
 }
 
+void GPU_HW_ShaderGen::WriteBatchTextureFunctions(std::stringstream& ss)
+{
+  ss << R"(
+CONSTANT float4 TRANSPARENT_PIXEL_COLOR = float4(0.0, 0.0, 0.0, 0.0);
+
+uint2 ApplyTextureWindow(uint2 coords)
+{
+  uint x = (uint(coords.x) & u_texture_window_and.x) | u_texture_window_or.x;
+  uint y = (uint(coords.y) & u_texture_window_and.y) | u_texture_window_or.y;
+  return uint2(x, y);
+}
+
+uint2 ApplyUpscaledTextureWindow(uint2 coords)
+{
+  uint2 native_coords = coords / uint2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+  uint2 coords_offset = coords % uint2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+  return (ApplyTextureWindow(native_coords) * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE)) + coords_offset;
+}
+
+uint2 FloatToIntegerCoords(float2 coords)
+{
+  // With the vertex offset applied at 1x resolution scale, we want to round the texture coordinates.
+  // Floor them otherwise, as it currently breaks when upscaling as the vertex offset is not applied.
+  return uint2((RESOLUTION_SCALE == 1u) ? roundEven(coords) : floor(coords));
+}
+
+float4 SampleFromVRAM(uint4 texpage, float2 coords)
+{
+  #if MIXED_TEXTURE_MODE
+    uint texture_mode = (texpage.z >> 16) & 3u;
+    if (texture_mode < 2u)
+    {
+      // 4-bit indices are 4 per halfword, 8-bit are 2 per halfword.
+      uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
+      uint index_shift = 2u - texture_mode;
+      uint2 index_coord = uint2(icoord.x >> index_shift, icoord.y);
+      uint2 vicoord = texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+
+      float4 texel = LOAD_TEXTURE(samp0, int2(vicoord), 0);
+      uint vram_value = RGBA8ToRGBA5551(texel);
+
+      uint index_bits = 4u << texture_mode;
+      uint subpixel = icoord.x & ((1u << index_shift) - 1u);
+      uint palette_index = (vram_value >> (subpixel * index_bits)) & ((1u << index_bits) - 1u);
+      uint2 palette_icoord = uint2((((texpage.z & 0xFFFFu) + palette_index) & 0x3FFu) * RESOLUTION_SCALE, texpage.w);
+      return LOAD_TEXTURE(samp0, int2(palette_icoord), 0);
+    }
+    else
+    {
+      uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
+      uint2 direct_icoord = texpage.xy + icoord;
+      return LOAD_TEXTURE(samp0, int2(direct_icoord), 0);
+    }
+  #elif PALETTE
+    uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
+    uint2 index_coord = icoord;
+    #if PALETTE_4_BIT
+      index_coord.x /= 4u;
+    #elif PALETTE_8_BIT
+      index_coord.x /= 2u;
+    #endif
+
+    // fixup coords
+    uint2 vicoord = texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+
+    // load colour/palette
+    float4 texel = LOAD_TEXTURE(samp0, int2(vicoord), 0);
+    uint vram_value = RGBA8ToRGBA5551(texel);
+
+    // apply palette
+    #if PALETTE_4_BIT
+      uint subpixel = icoord.x & 3u;
+      uint palette_index = (vram_value >> (subpixel * 4u)) & 0x0Fu;
+      uint2 palette_icoord = uint2((texpage.z + palette_index) * RESOLUTION_SCALE, texpage.w);
+    #elif PALETTE_8_BIT
+      // can only wrap in X direction for 8-bit, 4-bit will fit in texpage size.
+      uint subpixel = icoord.x & 1u;
+      uint palette_index = (vram_value >> (subpixel * 8u)) & 0xFFu;
+      uint2 palette_icoord = uint2(((texpage.z + palette_index) & 0x3FFu) * RESOLUTION_SCALE, texpage.w);
+    #endif
+
+    return LOAD_TEXTURE(samp0, int2(palette_icoord), 0);
+  #else
+    // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
+    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
+    uint2 direct_icoord = texpage.xy + icoord;
+    return LOAD_TEXTURE(samp0, int2(direct_icoord), 0);
+  #endif
+}
+)";
+}
+
 void GPU_HW_ShaderGen::WriteBatchTextureFilter(std::stringstream& ss, GPUTextureFilter texture_filter)
 {
   // JINC2 and xBRZ shaders originally from beetle-psx, modified to support filtering mask channel.
@@ -633,10 +741,14 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
 
 std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMode render_mode,
                                                           GPUTransparencyMode transparency, GPUTextureMode texture_mode,
+                                                          bool mixed_texture_mode, bool filtered_texpage,
                                                           bool dithering, bool interlacing, bool check_mask)
 {
   // TODO: don't write depth for shader blend
   DebugAssert(transparency == GPUTransparencyMode::Disabled || render_mode == GPU_HW::BatchRenderMode::ShaderBlend);
+  DebugAssert(!mixed_texture_mode || (texture_mode == GPUTextureMode::Direct16Bit && !dithering));
+  DebugAssert(!filtered_texpage ||
+              (!mixed_texture_mode && (texture_mode & ~GPUTextureMode::RawTextureBit) == GPUTextureMode::Direct16Bit));
 
   const GPUTextureMode actual_texture_mode = texture_mode & ~GPUTextureMode::RawTextureBit;
   const bool raw_texture = (texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit;
@@ -657,6 +769,8 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
   DefineMacro(ss, "SHADER_BLENDING", shader_blending);
   DefineMacro(ss, "CHECK_MASK_BIT", check_mask);
   DefineMacro(ss, "TEXTURED", textured);
+  DefineMacro(ss, "MIXED_TEXTURE_MODE", mixed_texture_mode);
+  DefineMacro(ss, "FILTERED_TEXPAGE", filtered_texpage);
   DefineMacro(ss, "PALETTE",
               actual_texture_mode == GPUTextureMode::Palette4Bit || actual_texture_mode == GPUTextureMode::Palette8Bit);
   DefineMacro(ss, "PALETTE_4_BIT", actual_texture_mode == GPUTextureMode::Palette4Bit);
@@ -708,72 +822,12 @@ uint3 ApplyDithering(uint2 coord, uint3 icol)
     return uint3(clamp(int3(icol) + int3(offset, offset, offset), 0, 255));
   #endif
 }
+)";
 
-#if TEXTURED
-CONSTANT float4 TRANSPARENT_PIXEL_COLOR = float4(0.0, 0.0, 0.0, 0.0);
-
-uint2 ApplyTextureWindow(uint2 coords)
-{
-  uint x = (uint(coords.x) & u_texture_window_and.x) | u_texture_window_or.x;
-  uint y = (uint(coords.y) & u_texture_window_and.y) | u_texture_window_or.y;
-  return uint2(x, y);
-}
-
-uint2 ApplyUpscaledTextureWindow(uint2 coords)
-{
-  uint2 native_coords = coords / uint2(RESOLUTION_SCALE, RESOLUTION_SCALE);
-  uint2 coords_offset = coords % uint2(RESOLUTION_SCALE, RESOLUTION_SCALE);
-  return (ApplyTextureWindow(native_coords) * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE)) + coords_offset;
-}
-
-uint2 FloatToIntegerCoords(float2 coords)
-{
-  // With the vertex offset applied at 1x resolution scale, we want to round the texture coordinates.
-  // Floor them otherwise, as it currently breaks when upscaling as the vertex offset is not applied.
-  return uint2((RESOLUTION_SCALE == 1u) ? roundEven(coords) : floor(coords));
-}
-
-float4 SampleFromVRAM(uint4 texpage, float2 coords)
-{
-  #if PALETTE
-    uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
-    uint2 index_coord = icoord;
-    #if PALETTE_4_BIT
-      index_coord.x /= 4u;
-    #elif PALETTE_8_BIT
-      index_coord.x /= 2u;
-    #endif
-
-    // fixup coords
-    uint2 vicoord = texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
-
-    // load colour/palette
-    float4 texel = LOAD_TEXTURE(samp0, int2(vicoord), 0);
-    uint vram_value = RGBA8ToRGBA5551(texel);
-
-    // apply palette
-    #if PALETTE_4_BIT
-      uint subpixel = icoord.x & 3u;
-      uint palette_index = (vram_value >> (subpixel * 4u)) & 0x0Fu;
-      uint2 palette_icoord = uint2((texpage.z + palette_index) * RESOLUTION_SCALE, texpage.w);
-    #elif PALETTE_8_BIT
-      // can only wrap in X direction for 8-bit, 4-bit will fit in texpage size.
-      uint subpixel = icoord.x & 1u;
-      uint palette_index = (vram_value >> (subpixel * 8u)) & 0xFFu;
-      uint2 palette_icoord = uint2(((texpage.z + palette_index) & 0x3FFu) * RESOLUTION_SCALE, texpage.w);
-    #endif
-
-    return LOAD_TEXTURE(samp0, int2(palette_icoord), 0);
-  #else
-    // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
-    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
-    uint2 direct_icoord = texpage.xy + icoord;
-    return LOAD_TEXTURE(samp0, int2(direct_icoord), 0);
-  #endif
-}
-
-#endif
+  if (textured)
+    WriteBatchTextureFunctions(ss);
 
+  ss << R"(
 // From https://alex.vlachos.com/graphics/Alex_Vlachos_Advanced_VR_Rendering_GDC2015.pdf
 // and https://www.shadertoy.com/view/MslGR8 (5th one starting from the bottom)
 // NOTE: `frag_coord` is in pixels (i.e. not normalized UV).
@@ -795,7 +849,7 @@ float3 ApplyDebanding(float2 frag_coord)
 
   if (textured)
   {
-    if (m_texture_filter != GPUTextureFilter::Nearest)
+    if (m_texture_filter != GPUTextureFilter::Nearest && !filtered_texpage)
       WriteBatchTextureFilter(ss, m_texture_filter);
 
     if (m_uv_limits)
@@ -837,13 +891,25 @@ float3 ApplyDebanding(float2 frag_coord)
     // We can't currently use upscaled coordinate for palettes because of how they're packed.
     // Not that it would be any benefit anyway, render-to-texture effects don't use palettes.
     float2 coords = v_tex0;
-    #if PALETTE
+    #if MIXED_TEXTURE_MODE
+      bool palette = (((v_texpage.z >> 16) & 3u) < 2u);
+      bool raw_texture = ((v_texpage.z & 0x40000u) != 0u);
+      bool dithering = ((v_texpage.z & 0x80000u) != 0u);
+      if (palette)
+        coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+    #elif PALETTE
       coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
     #endif
 
     #if UV_LIMITS
       float4 uv_limits = v_uv_limits;
-      #if !PALETTE
+      #if MIXED_TEXTURE_MODE
+        if (!palette)
+        {
+          uv_limits *= float(RESOLUTION_SCALE);
+          uv_limits.zw += float(RESOLUTION_SCALE - 1u);
+        }
+      #elif !PALETTE
         // Extend the UV range to all "upscaled" pixels. This means 1-pixel-high polygon-based
         // framebuffer effects won't be downsampled. (e.g. Mega Man Legends 2 haze effect)
         uv_limits *= float(RESOLUTION_SCALE);
@@ -852,7 +918,20 @@ float3 ApplyDebanding(float2 frag_coord)
     #endif
 
     float4 texcol;
-    #if TEXTURE_FILTERING
+    #if FILTERED_TEXPAGE
+      // The page was decoded and filtered ahead of time, so only the upscaled texel is needed. Alpha holds the
+      // semi-transparency bit in the top bit, and the filtered coverage below it.
+      #if UV_LIMITS
+        coords = clamp(coords, uv_limits.xy, uv_limits.zw);
+      #endif
+      uint2 page_icoord = FloatToIntegerCoords(coords) % uint2(256u * RESOLUTION_SCALE, 256u * RESOLUTION_SCALE);
+      texcol = LOAD_TEXTURE(samp0, int2(v_texpage.xy + page_icoord), 0);
+      uint packed_alpha = uint(roundEven(texcol.a * 255.0));
+      texcol.a = float(packed_alpha >> 7);
+      ialpha = float(packed_alpha & 127u) / 127.0;
+      if (ialpha < 0.5)
+        discard;
+    #elif TEXTURE_FILTERING
       FilteredSampleFromVRAM(v_texpage, coords, uv_limits, texcol, ialpha);
       if (ialpha < 0.5)
         discard;
@@ -873,7 +952,16 @@ float3 ApplyDebanding(float2 frag_coord)
     // If not using true color, truncate the framebuffer colors to 5-bit.
     #if !TRUE_COLOR
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0)) >> 3;
-      #if !RAW_TEXTURE
+      #if MIXED_TEXTURE_MODE
+        if (!raw_texture)
+        {
+          icolor = (icolor * vertcol) >> 4;
+          if (dithering)
+            icolor = ApplyDithering(uint2(v_pos.xy), icolor);
+          else
+            icolor = min(icolor >> 3, uint3(31u, 31u, 31u));
+        }
+      #elif !RAW_TEXTURE
         icolor = (icolor * vertcol) >> 4;
         #if DITHERING
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
@@ -883,7 +971,16 @@ float3 ApplyDebanding(float2 frag_coord)
       #endif
     #else
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0) + ApplyDebanding(v_pos.xy));
-      #if !RAW_TEXTURE
+      #if MIXED_TEXTURE_MODE
+        if (!raw_texture)
+        {
+          icolor = (icolor * vertcol) >> 7;
+          if (dithering)
+            icolor = ApplyDithering(uint2(v_pos.xy), icolor);
+          else
+            icolor = min(icolor, uint3(255u, 255u, 255u));
+        }
+      #elif !RAW_TEXTURE
         icolor = (icolor * vertcol) >> 7;
         #if DITHERING
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
@@ -1027,6 +1124,41 @@ float3 ApplyDebanding(float2 frag_coord)
   return ss.str();
 }
 
+std::string GPU_HW_ShaderGen::GenerateFilteredTexPageFragmentShader(bool palette_8bit)
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  DefineMacro(ss, "TEXTURED", true);
+  DefineMacro(ss, "MIXED_TEXTURE_MODE", false);
+  DefineMacro(ss, "PALETTE", true);
+  DefineMacro(ss, "PALETTE_4_BIT", !palette_8bit);
+  DefineMacro(ss, "PALETTE_8_BIT", palette_8bit);
+  WriteCommonFunctions(ss);
+  DeclareUniformBuffer(
+    ss, {"uint2 u_texture_window_and", "uint2 u_texture_window_or", "uint4 u_texpage", "uint2 u_dst_offset"}, true);
+  DeclareTexture(ss, "samp0", 0);
+  WriteBatchTextureFunctions(ss);
+  WriteBatchTextureFilter(ss, m_texture_filter);
+  DeclareFragmentEntryPoint(ss, 0, 1, {}, true, 1);
+
+  ss << R"(
+{
+  // Filter at the centre of each upscaled texel, which is where a draw at this resolution would sample.
+  float2 coords = (floor(v_pos.xy) - float2(u_dst_offset) + float2(0.5, 0.5)) / float(RESOLUTION_SCALE);
+
+  float4 texcol;
+  float ialpha;
+  FilteredSampleFromVRAM(u_texpage, coords, float4(0.0, 0.0, 255.0, 255.0), texcol, ialpha);
+
+  // Semi-transparency bit in the top bit of alpha, coverage in the rest.
+  uint packed_alpha = ((texcol.a >= 0.5) ? 128u : 0u) | uint(roundEven(ialpha * 127.0));
+  o_col0 = float4(texcol.rgb, float(packed_alpha) / 255.0);
+}
+)";
+
+  return ss.str();
+}
+
 std::string GPU_HW_ShaderGen::GenerateVRAMExtractFragmentShader(bool depth_24bit)
 {
   std::stringstream ss;
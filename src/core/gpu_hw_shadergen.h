@@ -14,10 +14,18 @@ public:
                    bool supports_framebuffer_fetch, bool debanding);
   ~GPU_HW_ShaderGen();
 
-  std::string GenerateBatchVertexShader(bool textured, bool pgxp_depth);
+  std::string GenerateBatchVertexShader(bool textured, bool mixed_texture_mode, bool filtered_texpage,
+                                        bool pgxp_depth);
+
+  /// With mixed_texture_mode, the texture mode, raw texture and dithering are read from the vertex texpage, and
+  /// texture_mode/dithering should be a direct mode and false.
+  /// With filtered_texpage, texels are read from the filtered texpage cache, and texture_mode should be a direct mode.
   std::string GenerateBatchFragmentShader(GPU_HW::BatchRenderMode render_mode, GPUTransparencyMode transparency,
-                                          GPUTextureMode texture_mode, bool dithering, bool interlacing,
-                                          bool check_mask);
+                                          GPUTextureMode texture_mode, bool mixed_texture_mode, bool filtered_texpage,
+                                          bool dithering, bool interlacing, bool check_mask);
+
+  /// Decodes and filters a whole palette texture page into a slot of the filtered texpage cache.
+  std::string GenerateFilteredTexPageFragmentShader(bool palette_8bit);
   std::string GenerateWireframeGeometryShader();
   std::string GenerateWireframeFragmentShader();
   std::string GenerateVRAMReadFragmentShader();
@@ -39,6 +47,7 @@ private:
 
   void WriteCommonFunctions(std::stringstream& ss);
   void WriteBatchUniformBuffer(std::stringstream& ss);
+  void WriteBatchTextureFunctions(std::stringstream& ss);
   void WriteBatchTextureFilter(std::stringstream& ss, GPUTextureFilter texture_filter);
   void WriteAdaptiveDownsampleUniformBuffer(std::stringstream& ss);
 
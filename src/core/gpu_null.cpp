@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "gpu.h"
+
+#include "common/log.h"
+
+Log_SetChannel(GPU_Null);
+
+namespace {
+
+// Renderer which discards all drawing, used when nothing will ever be shown, e.g. playing PSF music. Command
+// processing, timing and VRAM transfers are still handled by the base class, so the software sees a working GPU.
+class GPU_Null final : public GPU
+{
+public:
+  const Threading::Thread* GetSWThread() const override;
+  bool IsHardwareRenderer() const override;
+
+protected:
+  void FlushRender() override;
+  void DispatchRenderCommand() override;
+  void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
+  void UpdateDisplay() override;
+};
+
+} // namespace
+
+const Threading::Thread* GPU_Null::GetSWThread() const
+{
+  return nullptr;
+}
+
+bool GPU_Null::IsHardwareRenderer() const
+{
+  return false;
+}
+
+void GPU_Null::FlushRender()
+{
+}
+
+void GPU_Null::DispatchRenderCommand()
+{
+}
+
+void GPU_Null::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+}
+
+void GPU_Null::UpdateDisplay()
+{
+  ClearDisplayTexture();
+}
+
+std::unique_ptr<GPU> GPU::CreateNullRenderer()
+{
+  std::unique_ptr<GPU_Null> gpu(std::make_unique<GPU_Null>());
+  if (!gpu->Initialize())
+    return nullptr;
+
+  Log_InfoPrint("Using null renderer, nothing will be drawn.");
+  return gpu;
+}
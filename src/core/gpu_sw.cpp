@@ -5,12 +5,15 @@
 #include "system.h"
 
 #include "util/gpu_device.h"
+#include "util/imgui_manager.h"
 
 #include "common/align.h"
 #include "common/assert.h"
-#include "common/intrin.h"
+#include "common/gsvector.h"
 #include "common/log.h"
 
+#include "imgui.h"
+
 #include <algorithm>
 
 Log_SetChannel(GPU_SW);
@@ -86,10 +89,45 @@ void GPU_SW::Reset(bool clear_vram)
 
 void GPU_SW::UpdateSettings(const Settings& old_settings)
 {
+  WaitForVRAMReadback();
   GPU::UpdateSettings(old_settings);
   m_backend.UpdateSettings();
 }
 
+void GPU_SW::UpdateStatistics(u32 frame_count)
+{
+  GPU::UpdateStatistics(frame_count);
+  m_backend.UpdateStatistics(frame_count);
+}
+
+void GPU_SW::DrawRendererStats()
+{
+  if (ImGui::CollapsingHeader("Command Queue", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    const GPUBackend::Stats& stats = m_backend.GetStatistics();
+
+    ImGui::Columns(2);
+    ImGui::SetColumnWidth(0, 200.0f * Host::GetOSDScale());
+
+    ImGui::TextUnformatted("Pushed Per Frame:");
+    ImGui::NextColumn();
+    ImGui::Text("%u KB", (stats.bytes_pushed + 1023) / 1024);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Wakeups Per Frame:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_wakeups);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Stalls Per Frame:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_stalls);
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+  }
+}
+
 GPUTexture* GPU_SW::GetDisplayTexture(u32 width, u32 height, GPUTexture::Format format)
 {
   if (!m_upload_texture || m_upload_texture->GetWidth() != width || m_upload_texture->GetHeight() != height ||
@@ -97,6 +135,7 @@ GPUTexture* GPU_SW::GetDisplayTexture(u32 width, u32 height, GPUTexture::Format
   {
     ClearDisplayTexture();
     g_gpu_device->RecycleTexture(std::move(m_upload_texture));
+    m_upload_texture_source.reset();
     m_upload_texture =
       g_gpu_device->FetchTexture(width, height, 1, 1, 1, GPUTexture::Type::DynamicTexture, format, nullptr, 0);
     if (!m_upload_texture)
@@ -150,93 +189,187 @@ ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGBA5551, u16>(const u16* sr
 {
   u32 col = 0;
 
-#if defined(CPU_ARCH_SSE)
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
   const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const GSVector4i single_mask = GSVector4i::broadcast16(0x1F);
+  const GSVector4i g_mask = GSVector4i::broadcast16(0x3E0);
   for (; col < aligned_width; col += 8)
   {
-    const __m128i single_mask = _mm_set1_epi16(0x1F);
-    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
     src_ptr += 8;
-    __m128i a = _mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0))));
-    __m128i b = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
-    __m128i c = _mm_slli_epi16(_mm_and_si128(value, single_mask), 10);
-    value = _mm_or_si128(_mm_or_si128(a, b), c);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+    const GSVector4i a = value & g_mask;
+    const GSVector4i b = value.srl16<10>() & single_mask;
+    const GSVector4i c = (value & single_mask).sll16<10>();
+    GSVector4i::store<false>(dst_ptr, a | b | c);
     dst_ptr += 8;
   }
-#elif defined(CPU_ARCH_NEON)
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA5551, u16>(*(src_ptr++));
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGB565, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
   const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const GSVector4i single_mask = GSVector4i::broadcast16(0x1F);
+  const GSVector4i g_mask = GSVector4i::broadcast16(0x3E0);
+  const GSVector4i g_low_mask = GSVector4i::broadcast16(0x20);
   for (; col < aligned_width; col += 8)
   {
-    const uint16x8_t single_mask = vdupq_n_u16(0x1F);
-    uint16x8_t value = vld1q_u16(src_ptr);
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
     src_ptr += 8;
-    uint16x8_t a = vandq_u16(value, vdupq_n_u16(0x3E0));
-    uint16x8_t b = vandq_u16(vshrq_n_u16(value, 10), single_mask);
-    uint16x8_t c = vshlq_n_u16(vandq_u16(value, single_mask), 10);
-    value = vorrq_u16(vorrq_u16(a, b), c);
-    vst1q_u16(dst_ptr, value);
+    const GSVector4i a = (value & g_mask).sll16<1>();
+    const GSVector4i b = (value & g_low_mask).sll16<1>();
+    const GSVector4i c = value.srl16<10>() & single_mask;
+    const GSVector4i d = (value & single_mask).sll16<11>();
+    GSVector4i::store<false>(dst_ptr, a | b | c | d);
     dst_ptr += 8;
   }
 #endif
 
   for (; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA5551, u16>(*(src_ptr++));
+    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGB565, u16>(*(src_ptr++));
 }
 
 template<>
-ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGB565, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
+ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
   u32 col = 0;
 
-#if defined(CPU_ARCH_SSE)
+  // Expands to two 16-bit halves, R|G and B|A, then interleaves them into 32-bit pixels.
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
   const u32 aligned_width = Common::AlignDownPow2(width, 8);
   for (; col < aligned_width; col += 8)
   {
-    const __m128i single_mask = _mm_set1_epi16(0x1F);
-    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
     src_ptr += 8;
-    __m128i a = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0)))), 1);
-    __m128i b = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x20)))), 1);
-    __m128i c = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
-    __m128i d = _mm_slli_epi16(_mm_and_si128(value, single_mask), 11);
-    value = _mm_or_si128(_mm_or_si128(_mm_or_si128(a, b), c), d);
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+    const GSVector4i r = (value & GSVector4i::broadcast16(0x1F)).sll16<3>();
+    const GSVector4i g = (value & GSVector4i::broadcast16(0x3E0)).sll16<6>();
+    const GSVector4i b = value.srl16<7>() & GSVector4i::broadcast16(0xF8);
+    const GSVector4i a = value.sra16<15>() & GSVector4i::broadcast16(0xFF00);
+    const GSVector4i rg = r | g;
+    const GSVector4i ba = b | a;
+    GSVector4i::store<false>(dst_ptr, rg.upl16(ba));
+    GSVector4i::store<false>(dst_ptr + 4, rg.uph16(ba));
     dst_ptr += 8;
   }
-#elif defined(CPU_ARCH_NEON)
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA8, u32>(*(src_ptr++));
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+  // Same as RGBA8, with R and B swapped and alpha forced to opaque.
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
   const u32 aligned_width = Common::AlignDownPow2(width, 8);
-  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
   for (; col < aligned_width; col += 8)
   {
-    uint16x8_t value = vld1q_u16(src_ptr);
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
     src_ptr += 8;
-    uint16x8_t a = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x3E0)), 1); // (value & 0x3E0) << 1
-    uint16x8_t b = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x20)), 1);  // (value & 0x20) << 1
-    uint16x8_t c = vandq_u16(vshrq_n_u16(value, 10), single_mask);       // ((value >> 10) & 0x1F)
-    uint16x8_t d = vshlq_n_u16(vandq_u16(value, single_mask), 11);       // ((value & 0x1F) << 11)
-    value = vorrq_u16(vorrq_u16(vorrq_u16(a, b), c), d);
-    vst1q_u16(dst_ptr, value);
+    const GSVector4i r = (value & GSVector4i::broadcast16(0x1F)).sll16<3>();
+    const GSVector4i g = (value & GSVector4i::broadcast16(0x3E0)).sll16<6>();
+    const GSVector4i b = value.srl16<7>() & GSVector4i::broadcast16(0xF8);
+    const GSVector4i bg = b | g;
+    const GSVector4i ra = r | GSVector4i::broadcast16(0xFF00);
+    GSVector4i::store<false>(dst_ptr, bg.upl16(ra));
+    GSVector4i::store<false>(dst_ptr + 4, bg.uph16(ra));
     dst_ptr += 8;
   }
 #endif
 
   for (; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGB565, u16>(*(src_ptr++));
+    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::BGRA8, u32>(*(src_ptr++));
 }
 
+template<GPUTexture::Format out_format>
+static void CopyOutRow24(const u8* src_ptr, u8* dst_ptr, u32 width);
+
 template<>
-ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGBA8>(const u8* src_ptr, u8* dst_ptr, u32 width)
 {
+  u32 col = 0;
+
+#if defined(CPU_ARCH_SSSE3) || defined(CPU_ARCH_NEON)
+  // Each load reads 16 bytes for 4 pixels, so stop early enough to not read past the end of the row.
+  const GSVector4i shuffle(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const GSVector4i alpha = GSVector4i::broadcast32(0xFF000000u);
+  for (; (col + 6) <= width; col += 4)
+  {
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
+    src_ptr += 12;
+    GSVector4i::store<false>(dst_ptr, value.shuffle8(shuffle) | alpha);
+    dst_ptr += 16;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst_ptr++) = *(src_ptr++);
+    *(dst_ptr++) = *(src_ptr++);
+    *(dst_ptr++) = *(src_ptr++);
+    *(dst_ptr++) = 0xFF;
+  }
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::BGRA8>(const u8* src_ptr, u8* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_ARCH_SSSE3) || defined(CPU_ARCH_NEON)
+  const GSVector4i shuffle(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+  const GSVector4i alpha = GSVector4i::broadcast32(0xFF000000u);
+  for (; (col + 6) <= width; col += 4)
+  {
+    const GSVector4i value = GSVector4i::load<false>(src_ptr);
+    src_ptr += 12;
+    GSVector4i::store<false>(dst_ptr, value.shuffle8(shuffle) | alpha);
+    dst_ptr += 16;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst_ptr++) = src_ptr[2];
+    *(dst_ptr++) = src_ptr[1];
+    *(dst_ptr++) = src_ptr[0];
+    *(dst_ptr++) = 0xFF;
+    src_ptr += 3;
+  }
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGB565>(const u8* src_ptr, u8* dst_ptr, u32 width)
+{
+  u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
   for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA8, u32>(*(src_ptr++));
+  {
+    *(dst_row_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 11) | ((static_cast<u16>(src_ptr[1]) >> 2) << 5) |
+                       (static_cast<u16>(src_ptr[2]) >> 3);
+    src_ptr += 3;
+  }
 }
 
 template<>
-ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGBA5551>(const u8* src_ptr, u8* dst_ptr, u32 width)
 {
+  u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
   for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::BGRA8, u32>(*(src_ptr++));
+  {
+    *(dst_row_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 10) | ((static_cast<u16>(src_ptr[1]) >> 3) << 5) |
+                       (static_cast<u16>(src_ptr[2]) >> 3);
+    src_ptr += 3;
+  }
 }
 
 template<GPUTexture::Format display_format>
@@ -312,54 +445,7 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x
     const u32 src_stride = (VRAM_WIDTH << line_skip) * sizeof(u16);
     for (u32 row = 0; row < height; row++)
     {
-      if constexpr (display_format == GPUTexture::Format::RGBA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = 0xFF;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::BGRA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = src_row_ptr[2];
-          *(dst_row_ptr++) = src_row_ptr[1];
-          *(dst_row_ptr++) = src_row_ptr[0];
-          *(dst_row_ptr++) = 0xFF;
-          src_row_ptr += 3;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::RGB565)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 11) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 2) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::RGBA5551)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 10) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 3) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
-
+      CopyOutRow24<display_format>(src_ptr, dst_ptr, width);
       src_ptr += src_stride;
       dst_ptr += dst_stride;
     }
@@ -413,6 +499,25 @@ ALWAYS_INLINE_RELEASE bool GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x
 }
 
 bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit)
+{
+  // Games running below the refresh rate present the same frame several times.
+  const UploadTextureSource source = {src_x, src_y, skip_x, line_skip, m_backend.GetVRAMWriteCounter(), is_24bit};
+  const GPUTexture::Format format = is_24bit ? m_24bit_display_format : m_16bit_display_format;
+  if (m_upload_texture && m_upload_texture->GetWidth() == width && m_upload_texture->GetHeight() == height &&
+      m_upload_texture->GetFormat() == format && m_upload_texture_source == source)
+  {
+    return true;
+  }
+
+  m_upload_texture_source.reset();
+  if (!CopyOutToTexture(src_x, src_y, skip_x, width, height, line_skip, is_24bit))
+    return false;
+
+  m_upload_texture_source = source;
+  return true;
+}
+
+bool GPU_SW::CopyOutToTexture(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit)
 {
   if (!is_24bit)
   {
@@ -780,6 +885,19 @@ void GPU_SW::DispatchRenderCommand()
 }
 
 void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+{
+  WaitForVRAMReadback();
+  m_backend.Sync(false);
+}
+
+bool GPU_SW::BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height)
+{
+  // Let the backend thread finish drawing while the CPU sets up the transfer.
+  m_backend.PublishCommands();
+  return true;
+}
+
+void GPU_SW::FinishVRAMReadback()
 {
   m_backend.Sync(false);
 }
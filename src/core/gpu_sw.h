@@ -11,6 +11,7 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace Threading {
@@ -34,9 +35,12 @@ public:
   bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display) override;
   void Reset(bool clear_vram) override;
   void UpdateSettings(const Settings& old_settings) override;
+  void UpdateStatistics(u32 frame_count) override;
 
 protected:
   void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  bool BeginVRAMReadback(u32 x, u32 y, u32 width, u32 height) override;
+  void FinishVRAMReadback() override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
@@ -50,8 +54,10 @@ protected:
   bool CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip);
 
   bool CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit);
+  bool CopyOutToTexture(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 line_skip, bool is_24bit);
 
   void UpdateDisplay() override;
+  void DrawRendererStats() override;
 
   void DispatchRenderCommand() override;
 
@@ -60,10 +66,25 @@ protected:
 
   GPUTexture* GetDisplayTexture(u32 width, u32 height, GPUTexture::Format format);
 
+  /// Where the current upload texture contents came from. Frames which display the same VRAM region, without it
+  /// having been written since, reuse the texture instead of converting and uploading it again.
+  struct UploadTextureSource
+  {
+    u32 src_x;
+    u32 src_y;
+    u32 skip_x;
+    u32 line_skip;
+    u32 vram_write_counter;
+    bool is_24bit;
+
+    bool operator==(const UploadTextureSource& rhs) const = default;
+  };
+
   FixedHeapArray<u8, GPU_MAX_DISPLAY_WIDTH * GPU_MAX_DISPLAY_HEIGHT * sizeof(u32)> m_upload_buffer;
   GPUTexture::Format m_16bit_display_format = GPUTexture::Format::RGB565;
   GPUTexture::Format m_24bit_display_format = GPUTexture::Format::RGBA8;
   std::unique_ptr<GPUTexture> m_upload_texture;
+  std::optional<UploadTextureSource> m_upload_texture_source;
 
   GPU_SW_Backend m_backend;
 };
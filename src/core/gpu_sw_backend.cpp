@@ -3,11 +3,20 @@
 
 #include "gpu_sw_backend.h"
 #include "gpu.h"
+#include "settings.h"
 #include "system.h"
 
 #include "util/gpu_device.h"
 
+#include "common/gsvector.h"
+#include "common/log.h"
+#include "common/trace.h"
+
 #include <algorithm>
+#include <array>
+#include <cstring>
+
+Log_SetChannel(GPU_SW_Backend);
 
 GPU_SW_Backend::GPU_SW_Backend() = default;
 
@@ -15,44 +24,474 @@ GPU_SW_Backend::~GPU_SW_Backend() = default;
 
 bool GPU_SW_Backend::Initialize(bool force_thread)
 {
-  return GPUBackend::Initialize(force_thread);
+  if (!GPUBackend::Initialize(force_thread))
+    return false;
+
+  StartBandWorkers(g_settings.gpu_sw_rasterizer_threads);
+  m_use_span_jit = g_settings.gpu_sw_span_jit;
+  return true;
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+
+  if (m_num_bands != g_settings.gpu_sw_rasterizer_threads)
+  {
+    StopBandWorkers();
+    StartBandWorkers(g_settings.gpu_sw_rasterizer_threads);
+  }
+
+  m_use_span_jit = g_settings.gpu_sw_span_jit;
 }
 
 void GPU_SW_Backend::Reset()
 {
   GPUBackend::Reset();
+  InvalidateTexturePageCache();
+  m_vram_write_counter++;
+}
+
+void GPU_SW_Backend::Shutdown()
+{
+  GPUBackend::Shutdown();
+  StopBandWorkers();
+  GPUSpanJIT::Shutdown();
+}
+
+void GPU_SW_Backend::HandleCommand(const GPUBackendCommand* cmd)
+{
+  System::ProfileSubsystemScope profile(System::ProfiledSubsystem::SoftwareRasterizer);
+  GPUBackend::HandleCommand(cmd);
+}
+
+void GPU_SW_Backend::StartBandWorkers(u32 num_bands)
+{
+  DebugAssert(m_band_threads.empty() && m_band_batch.empty());
+  m_num_bands = std::clamp<u32>(num_bands, 1, Settings::MAX_GPU_SW_RASTERIZER_THREADS);
+  if (m_num_bands == 1)
+    return;
+
+  m_band_shutdown = false;
+  m_band_threads.reserve(m_num_bands - 1);
+  for (u32 band = 1; band < m_num_bands; band++)
+  {
+    m_band_threads.emplace_back(
+      [this, band, generation = m_band_generation]() { BandWorkerThread(band, generation); });
+  }
+
+  Log_InfoFmt("Rasterizing in {} bands.", m_num_bands);
+}
+
+void GPU_SW_Backend::StopBandWorkers()
+{
+  FlushRender();
+
+  if (!m_band_threads.empty())
+  {
+    {
+      std::unique_lock lock(m_band_mutex);
+      m_band_shutdown = true;
+    }
+    m_band_start_cv.notify_all();
+
+    for (Threading::Thread& thread : m_band_threads)
+      thread.Join();
+    m_band_threads.clear();
+  }
+
+  m_num_bands = 1;
+}
+
+void GPU_SW_Backend::BandWorkerThread(u32 band, u32 generation)
+{
+  Threading::SetNameOfCurrentThread("GPU Band Worker");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Worker);
+
+  for (;;)
+  {
+    {
+      std::unique_lock lock(m_band_mutex);
+      m_band_start_cv.wait(lock, [this, generation]() { return m_band_shutdown || m_band_generation != generation; });
+      if (m_band_shutdown)
+        break;
+
+      generation = m_band_generation;
+    }
+
+    ExecuteBandCommands(band);
+
+    std::unique_lock lock(m_band_mutex);
+    if ((--m_bands_remaining) == 0)
+      m_band_done_cv.notify_one();
+  }
+}
+
+void GPU_SW_Backend::QueueBandCommand(const GPUBackendDrawCommand* cmd, const u16* texture_page)
+{
+  // Each command is preceded by its decoded texture page pointer.
+  const size_t offset = m_band_batch.size();
+  m_band_batch.resize(offset + sizeof(texture_page) + cmd->size);
+  std::memcpy(&m_band_batch[offset], &texture_page, sizeof(texture_page));
+  std::memcpy(&m_band_batch[offset + sizeof(texture_page)], cmd, cmd->size);
+
+  if (m_band_batch.size() >= MAX_BAND_BATCH_SIZE)
+    FlushRender();
+}
+
+void GPU_SW_Backend::ExecuteBandCommands(u32 band)
+{
+  TRACE_ZONE("GPU_SW_Backend::ExecuteBandCommands");
+
+  const GPUDrawingArea area = GetBandArea(band);
+  if (area.top > area.bottom)
+    return;
+
+  for (size_t offset = 0; offset < m_band_batch.size();)
+  {
+    const u16* texture_page;
+    std::memcpy(&texture_page, &m_band_batch[offset], sizeof(texture_page));
+    const GPUBackendCommand* cmd =
+      reinterpret_cast<const GPUBackendCommand*>(&m_band_batch[offset + sizeof(texture_page)]);
+    offset += sizeof(texture_page) + cmd->size;
+
+    switch (cmd->type)
+    {
+      case GPUBackendCommandType::DrawPolygon:
+        RasterizePolygon(static_cast<const GPUBackendDrawPolygonCommand*>(cmd), area, texture_page);
+        break;
+
+      case GPUBackendCommandType::DrawRectangle:
+        RasterizeRectangle(static_cast<const GPUBackendDrawRectangleCommand*>(cmd), area, texture_page);
+        break;
+
+      case GPUBackendCommandType::DrawLine:
+        RasterizeLine(static_cast<const GPUBackendDrawLineCommand*>(cmd), area);
+        break;
+
+      default:
+        UnreachableCode();
+    }
+  }
+}
+
+GPUDrawingArea GPU_SW_Backend::GetBandArea(u32 band) const
+{
+  // The drawing area can't change within a batch, since that flushes it.
+  GPUDrawingArea area = m_drawing_area;
+  if (area.top > area.bottom)
+    return area;
+
+  const u32 rows_per_band = (area.bottom - area.top + m_num_bands) / m_num_bands;
+  area.top = m_drawing_area.top + band * rows_per_band;
+  area.bottom = std::min(area.top + rows_per_band - 1, m_drawing_area.bottom);
+  return area;
+}
+
+bool GPU_SW_Backend::CanDrawInBands(const GPUBackendDrawCommand* cmd) const
+{
+  if (m_num_bands == 1)
+    return false;
+
+  // Primitives which sample from the drawing area have to see every band's writes, up to and including their own.
+  return (!cmd->rc.texture_enable || !IsTexturePageInDrawingArea(cmd));
+}
+
+bool GPU_SW_Backend::IsTexturePageInDrawingArea(const GPUBackendDrawCommand* cmd) const
+{
+  const Common::Rectangle<u32> area_rect(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right + 1,
+                                         m_drawing_area.bottom + 1);
+  const Common::Rectangle<u32> page_rect = cmd->draw_mode.GetTexturePageRectangle();
+  if (page_rect.Intersects(area_rect))
+    return true;
+
+  // Pages at the right edge of VRAM wrap around to the left.
+  return (page_rect.right > VRAM_WIDTH &&
+          Common::Rectangle<u32>(0, page_rect.top, page_rect.right - VRAM_WIDTH, page_rect.bottom)
+            .Intersects(area_rect));
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  const u16* texture_page = GetPolygonTexturePage(cmd);
+  MarkDrawingAreaWritten();
+
+  if (CanDrawInBands(cmd))
+  {
+    QueueBandCommand(cmd, texture_page);
+    return;
+  }
+
+  FlushRender();
+  RasterizePolygon(cmd, m_drawing_area, texture_page);
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  const u16* texture_page = GetRectangleTexturePage(cmd);
+  MarkDrawingAreaWritten();
+
+  if (CanDrawInBands(cmd))
+  {
+    QueueBandCommand(cmd, texture_page);
+    return;
+  }
+
+  FlushRender();
+  RasterizeRectangle(cmd, m_drawing_area, texture_page);
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  MarkDrawingAreaWritten();
+
+  if (CanDrawInBands(cmd))
+  {
+    QueueBandCommand(cmd, nullptr);
+    return;
+  }
+
+  FlushRender();
+  RasterizeLine(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::RasterizePolygon(const GPUBackendDrawPolygonCommand* cmd, const GPUDrawingArea& area,
+                                      const u16* texture_page)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
 
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
-
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  const GPUSpanJIT::SpanFunction span_function =
+    m_use_span_jit ? GPUSpanJIT::GetSpanFunction(GPUSpanJIT::GetKey(
+                       rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable,
+                       dithering_enable, cmd->draw_mode.texture_mode, cmd->draw_mode.transparency_mode,
+                       cmd->params.GetMaskAND() != 0, cmd->params.GetMaskOR() != 0)) :
+                     nullptr;
+  const DrawState state = {area, span_function, texture_page};
+
+  (this->*DrawFunction)(cmd, state, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
   if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    (this->*DrawFunction)(cmd, state, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::RasterizeRectangle(const GPUBackendDrawRectangleCommand* cmd, const GPUDrawingArea& area,
+                                        const u16* texture_page)
 {
   const GPURenderCommand rc{cmd->rc.bits};
 
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
-
-  (this->*DrawFunction)(cmd);
+  const GPUSpanJIT::SpanFunction span_function =
+    m_use_span_jit ? GPUSpanJIT::GetSpanFunction(GPUSpanJIT::GetKey(
+                       false, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, false,
+                       cmd->draw_mode.texture_mode, cmd->draw_mode.transparency_mode, cmd->params.GetMaskAND() != 0,
+                       cmd->params.GetMaskOR() != 0)) :
+                     nullptr;
+  const DrawState state = {area, span_function, texture_page};
+
+  (this->*DrawFunction)(cmd, state);
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::RasterizeLine(const GPUBackendDrawLineCommand* cmd, const GPUDrawingArea& area)
 {
   const DrawLineFunction DrawFunction =
     GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
 
   for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+    (this->*DrawFunction)(cmd, area, &cmd->vertices[i - 1], &cmd->vertices[i]);
+}
+
+void GPU_SW_Backend::MarkDrawingAreaWritten()
+{
+  m_vram_write_counter++;
+
+  // Pages overlapping the drawing area are never decoded while it's current, so invalidating them on the first draw
+  // covers every draw until the area changes.
+  if (m_drawing_area_written || m_drawing_area.left > m_drawing_area.right ||
+      m_drawing_area.top > m_drawing_area.bottom)
+  {
+    return;
+  }
+
+  InvalidateTexturePages(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right - m_drawing_area.left + 1,
+                         m_drawing_area.bottom - m_drawing_area.top + 1);
+  m_drawing_area_written = true;
+}
+
+const u16* GPU_SW_Backend::GetPolygonTexturePage(const GPUBackendDrawPolygonCommand* cmd)
+{
+  if (!cmd->rc.texture_enable)
+    return nullptr;
+
+  u32 min_u = TEXTURE_PAGE_SIZE - 1, max_u = 0;
+  u32 min_v = TEXTURE_PAGE_SIZE - 1, max_v = 0;
+  for (u32 i = 0; i < cmd->num_vertices; i++)
+  {
+    min_u = std::min<u32>(min_u, cmd->vertices[i].u);
+    max_u = std::max<u32>(max_u, cmd->vertices[i].u);
+    min_v = std::min<u32>(min_v, cmd->vertices[i].v);
+    max_v = std::max<u32>(max_v, cmd->vertices[i].v);
+  }
+
+  // Interpolation can step a texel outside of the range covered by the vertices.
+  return GetTexturePage(cmd, Truncate8(min_u - 1), max_u - min_u + 3, Truncate8(min_v - 1), max_v - min_v + 3);
+}
+
+const u16* GPU_SW_Backend::GetRectangleTexturePage(const GPUBackendDrawRectangleCommand* cmd)
+{
+  if (!cmd->rc.texture_enable)
+    return nullptr;
+
+  return GetTexturePage(cmd, Truncate8(cmd->texcoord), cmd->width, Truncate8(cmd->texcoord >> 8), cmd->height);
+}
+
+const u16* GPU_SW_Backend::GetTexturePage(const GPUBackendDrawCommand* cmd, u8 first_column, u32 num_columns,
+                                          u8 first_row, u32 num_rows)
+{
+  const GPUTextureMode mode = cmd->draw_mode.texture_mode;
+  if ((mode != GPUTextureMode::Palette4Bit && mode != GPUTextureMode::Palette8Bit) || num_columns == 0 ||
+      num_rows == 0 || IsTexturePageInDrawingArea(cmd))
+  {
+    return nullptr;
+  }
+
+  const bool is_8bit = (mode == GPUTextureMode::Palette8Bit);
+  const u32 block_x = cmd->draw_mode.GetTexturePageBaseX() / VRAM_BLOCK_WIDTH;
+  const u32 block_y = cmd->draw_mode.GetTexturePageBaseY() / VRAM_BLOCK_HEIGHT;
+  const std::array<u32, 2> block_versions = {
+    m_vram_block_versions[block_y][block_x],
+    is_8bit ? m_vram_block_versions[block_y][(block_x + 1) % NUM_VRAM_BLOCKS_X] : 0u};
+  const u32 palette_size = is_8bit ? 256 : 16;
+  const u32 key = (ZeroExtend32(cmd->palette.bits) << 6) | (block_y << 5) | (block_x << 1) | BoolToUInt32(is_8bit);
+
+  TexturePageCacheEntry* entry = nullptr;
+  for (TexturePageCacheEntry& it : m_texture_page_cache)
+  {
+    if (it.texels && it.key == key)
+    {
+      entry = &it;
+      break;
+    }
+  }
+
+  if (!entry || entry->block_versions != block_versions ||
+      std::memcmp(entry->palette.data(), g_gpu_clut, palette_size * sizeof(u16)) != 0)
+  {
+    if (!entry)
+    {
+      entry = &*std::min_element(m_texture_page_cache.begin(), m_texture_page_cache.end(),
+                                 [](const TexturePageCacheEntry& lhs, const TexturePageCacheEntry& rhs) {
+                                   return lhs.last_used < rhs.last_used;
+                                 });
+
+      // Evicting pages which are still in use costs more than sampling VRAM directly when there are more pages in
+      // the working set than entries, so leave the cache alone until something goes cold.
+      if (entry->texels && (m_texture_page_cache_tick - entry->last_used) < TEXTURE_PAGE_CACHE_EVICT_AGE)
+        return nullptr;
+    }
+
+    // Draws queued for the bands may still be reading the entry.
+    FlushRender();
+
+    if (!entry->texels)
+      entry->texels = std::make_unique<u16[]>(TEXTURE_PAGE_SIZE * TEXTURE_PAGE_SIZE);
+    entry->key = key;
+    entry->block_versions = block_versions;
+    std::memcpy(entry->palette.data(), g_gpu_clut, palette_size * sizeof(u16));
+    entry->valid_chunks.fill(0);
+  }
+
+  entry->last_used = ++m_texture_page_cache_tick;
+
+  // The texture window can remap any coordinate to any texel.
+  if (num_columns >= TEXTURE_PAGE_SIZE || cmd->window.and_x != 0xFF || cmd->window.or_x != 0)
+  {
+    first_column = 0;
+    num_columns = TEXTURE_PAGE_SIZE;
+  }
+  if (num_rows >= TEXTURE_PAGE_SIZE || cmd->window.and_y != 0xFF || cmd->window.or_y != 0)
+  {
+    first_row = 0;
+    num_rows = TEXTURE_PAGE_SIZE;
+  }
+
+  u8 chunk_mask = 0;
+  const u32 last_chunk = (first_column + num_columns - 1) / TEXTURE_PAGE_CHUNK_SIZE;
+  for (u32 chunk = first_column / TEXTURE_PAGE_CHUNK_SIZE; chunk <= last_chunk; chunk++)
+    chunk_mask |= u8(1) << (chunk % NUM_TEXTURE_PAGE_CHUNKS);
+
+  for (u32 i = 0; i < num_rows; i++)
+  {
+    const u32 row = (first_row + i) % TEXTURE_PAGE_SIZE;
+    const u8 missing_chunks = chunk_mask & ~entry->valid_chunks[row];
+    if (missing_chunks == 0)
+      continue;
+
+    DecodeTexturePageRow(cmd, &entry->texels[row * TEXTURE_PAGE_SIZE], row, missing_chunks);
+    entry->valid_chunks[row] |= missing_chunks;
+  }
+
+  return entry->texels.get();
+}
+
+void GPU_SW_Backend::DecodeTexturePageRow(const GPUBackendDrawCommand* cmd, u16* texels, u32 row, u8 chunks) const
+{
+  const u32 page_x = cmd->draw_mode.GetTexturePageBaseX();
+  const u16* src_row = &g_vram[((cmd->draw_mode.GetTexturePageBaseY() + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+  for (u32 chunk = 0; chunk < NUM_TEXTURE_PAGE_CHUNKS; chunk++)
+  {
+    if (!(chunks & (u8(1) << chunk)))
+      continue;
+
+    const u32 first_texel = chunk * TEXTURE_PAGE_CHUNK_SIZE;
+    if (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
+    {
+      for (u32 x = first_texel / 4; x < (first_texel + TEXTURE_PAGE_CHUNK_SIZE) / 4; x++)
+      {
+        const u16 value = src_row[(page_x + x) % VRAM_WIDTH];
+        texels[x * 4 + 0] = g_gpu_clut[value & 0x0Fu];
+        texels[x * 4 + 1] = g_gpu_clut[(value >> 4) & 0x0Fu];
+        texels[x * 4 + 2] = g_gpu_clut[(value >> 8) & 0x0Fu];
+        texels[x * 4 + 3] = g_gpu_clut[value >> 12];
+      }
+    }
+    else
+    {
+      for (u32 x = first_texel / 2; x < (first_texel + TEXTURE_PAGE_CHUNK_SIZE) / 2; x++)
+      {
+        const u16 value = src_row[(page_x + x) % VRAM_WIDTH];
+        texels[x * 2 + 0] = g_gpu_clut[value & 0xFFu];
+        texels[x * 2 + 1] = g_gpu_clut[value >> 8];
+      }
+    }
+  }
+}
+
+void GPU_SW_Backend::InvalidateTexturePages(u32 x, u32 y, u32 width, u32 height)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  x %= VRAM_WIDTH;
+  y %= VRAM_HEIGHT;
+  const u32 first_block_x = x / VRAM_BLOCK_WIDTH;
+  const u32 first_block_y = y / VRAM_BLOCK_HEIGHT;
+  const u32 num_blocks_x = std::min((x + width - 1) / VRAM_BLOCK_WIDTH - first_block_x + 1, NUM_VRAM_BLOCKS_X);
+  const u32 num_blocks_y = std::min((y + height - 1) / VRAM_BLOCK_HEIGHT - first_block_y + 1, NUM_VRAM_BLOCKS_Y);
+  for (u32 by = 0; by < num_blocks_y; by++)
+  {
+    for (u32 bx = 0; bx < num_blocks_x; bx++)
+      m_vram_block_versions[(first_block_y + by) % NUM_VRAM_BLOCKS_Y][(first_block_x + bx) % NUM_VRAM_BLOCKS_X]++;
+  }
+}
+
+void GPU_SW_Backend::InvalidateTexturePageCache()
+{
+  FlushRender();
+  for (TexturePageCacheEntry& entry : m_texture_page_cache)
+    entry.valid_chunks.fill(0);
 }
 
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
@@ -74,9 +513,199 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+
+// Spans of 8 or more pixels are shaded 8 pixels at a time. The lanes are computed exactly like ShadePixel(), so the
+// output is identical, it's only the texel fetches which are still done one pixel at a time.
+#define GPU_SW_VECTOR_SPANS 1
+
+namespace {
+
+/// Dither offsets for 8 consecutive pixels, indexed by [y & 3][x & 3] of the first pixel.
+struct DitherRows
+{
+  alignas(VECTOR_ALIGNMENT) u16 offsets[DITHER_MATRIX_SIZE][DITHER_MATRIX_SIZE][8];
+};
+
+constexpr DitherRows ComputeDitherRows()
+{
+  DitherRows rows = {};
+  for (u32 y = 0; y < DITHER_MATRIX_SIZE; y++)
+  {
+    for (u32 x = 0; x < DITHER_MATRIX_SIZE; x++)
+    {
+      for (u32 lane = 0; lane < 8; lane++)
+        rows.offsets[y][x][lane] = static_cast<u16>(DITHER_MATRIX[y][(x + lane) % DITHER_MATRIX_SIZE]);
+    }
+  }
+  return rows;
+}
+
+constexpr DitherRows s_dither_rows = ComputeDitherRows();
+
+/// Equivalent to s_dither_lut, for 8 values at once. The non-dithered LUT entry has an offset of zero.
+ALWAYS_INLINE GSVector4i VecDither(const GSVector4i& value, const GSVector4i& offset)
+{
+  return value.add16(offset).sra16<3>().max_i16(GSVector4i::zero()).min_i16(GSVector4i::broadcast16(31));
+}
+
+/// Blends with the background one channel at a time. Bit 15 is always set, matching the packed blargg version.
+ALWAYS_INLINE GSVector4i VecBlend(GPUTransparencyMode mode, const GSVector4i& fg, const GSVector4i& bg)
+{
+  const GSVector4i mask5 = GSVector4i::broadcast16(31);
+
+  const auto blend_channel = [mode, &mask5](const GSVector4i& f, const GSVector4i& b) {
+    switch (mode)
+    {
+      case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+        return f.add16(b).srl16<1>();
+      case GPUTransparencyMode::BackgroundPlusForeground:
+        return f.add16(b).min_i16(mask5);
+      case GPUTransparencyMode::BackgroundMinusForeground:
+        return b.sub16(f).max_i16(GSVector4i::zero());
+      case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+      default:
+        return f.srl16<2>().add16(b).min_i16(mask5);
+    }
+  };
+
+  return GSVector4i::broadcast16(0x8000u) | blend_channel(fg & mask5, bg & mask5) |
+         blend_channel(fg.srl16<5>() & mask5, bg.srl16<5>() & mask5).sll16<5>() |
+         blend_channel(fg.srl16<10>() & mask5, bg.srl16<10>() & mask5).sll16<10>();
+}
+
+/// Returns true if a span could be sampled by its own primitive, in which case each pixel must be written before the
+/// next is shaded.
+ALWAYS_INLINE_RELEASE bool IsSpanInTexturePage(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 width)
+{
+  const Common::Rectangle<u32> page_rect = cmd->draw_mode.GetTexturePageRectangle();
+  const Common::Rectangle<u32> span_rect(x, y, x + width, y + 1);
+  return (page_rect.Intersects(span_rect) ||
+          (page_rect.right > VRAM_WIDTH &&
+           Common::Rectangle<u32>(0, page_rect.top, page_rect.right - VRAM_WIDTH, page_rect.bottom)
+             .Intersects(span_rect)));
+}
+
+/// Vector version of ShadePixel(), for 8 pixels starting at (x, y). The row must not wrap around VRAM.
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+ALWAYS_INLINE_RELEASE void ShadePixels8(const GPUBackendDrawCommand* cmd, const u16* texture_page, u32 x, u32 y,
+                                        const GSVector4i& color_r, const GSVector4i& color_g,
+                                        const GSVector4i& color_b, GSVector4i texcoord_x, GSVector4i texcoord_y)
+{
+  u16* const row_ptr = &g_vram[VRAM_WIDTH * y + x];
+  const GSVector4i bg_color = GSVector4i::load<false>(row_ptr);
+  const GSVector4i zero = GSVector4i::zero();
+  const GSVector4i mask5 = GSVector4i::broadcast16(31);
+  const GSVector4i dither_offset =
+    dithering_enable ? GSVector4i::load<true>(s_dither_rows.offsets[y & 3][x & 3]) : zero;
+
+  GSVector4i write_mask = (bg_color & GSVector4i::broadcast16(cmd->params.GetMaskAND())).eq16(zero);
+  GSVector4i color;
+  if constexpr (texture_enable)
+  {
+    // Apply texture window
+    texcoord_x = (texcoord_x & GSVector4i::broadcast16(cmd->window.and_x)) | GSVector4i::broadcast16(cmd->window.or_x);
+    texcoord_y = (texcoord_y & GSVector4i::broadcast16(cmd->window.and_y)) | GSVector4i::broadcast16(cmd->window.or_y);
+
+    alignas(VECTOR_ALIGNMENT) u16 u[8];
+    alignas(VECTOR_ALIGNMENT) u16 v[8];
+    alignas(VECTOR_ALIGNMENT) u16 texels[8];
+    GSVector4i::store<true>(u, texcoord_x);
+    GSVector4i::store<true>(v, texcoord_y);
+
+    const u32 page_x = cmd->draw_mode.GetTexturePageBaseX();
+    const u32 page_y = cmd->draw_mode.GetTexturePageBaseY();
+    if (texture_page)
+    {
+      for (u32 i = 0; i < 8; i++)
+        texels[i] = texture_page[ZeroExtend32(v[i]) * 256 + ZeroExtend32(u[i])];
+    }
+    else
+    {
+      switch (cmd->draw_mode.texture_mode)
+      {
+        case GPUTextureMode::Palette4Bit:
+        {
+          for (u32 i = 0; i < 8; i++)
+          {
+            const u16 palette_value =
+              g_vram[((page_y + v[i]) % VRAM_HEIGHT) * VRAM_WIDTH + (page_x + u[i] / 4) % VRAM_WIDTH];
+            texels[i] = g_gpu_clut[(palette_value >> ((u[i] % 4) * 4)) & 0x0Fu];
+          }
+        }
+        break;
+
+        case GPUTextureMode::Palette8Bit:
+        {
+          for (u32 i = 0; i < 8; i++)
+          {
+            const u16 palette_value =
+              g_vram[((page_y + v[i]) % VRAM_HEIGHT) * VRAM_WIDTH + (page_x + u[i] / 2) % VRAM_WIDTH];
+            texels[i] = g_gpu_clut[(palette_value >> ((u[i] % 2) * 8)) & 0xFFu];
+          }
+        }
+        break;
+
+        default:
+        {
+          for (u32 i = 0; i < 8; i++)
+            texels[i] = g_vram[((page_y + v[i]) % VRAM_HEIGHT) * VRAM_WIDTH + (page_x + u[i]) % VRAM_WIDTH];
+        }
+        break;
+      }
+    }
+
+    const GSVector4i texture_color = GSVector4i::load<true>(texels);
+    write_mask = write_mask.andnot(texture_color.eq16(zero));
+
+    if constexpr (raw_texture_enable)
+    {
+      color = texture_color;
+    }
+    else
+    {
+      const GSVector4i r = (texture_color & mask5).mul16l(color_r).srl16<4>();
+      const GSVector4i g = (texture_color.srl16<5>() & mask5).mul16l(color_g).srl16<4>();
+      const GSVector4i b = (texture_color.srl16<10>() & mask5).mul16l(color_b).srl16<4>();
+      color = VecDither(r, dither_offset) | VecDither(g, dither_offset).sll16<5>() |
+              VecDither(b, dither_offset).sll16<10>() | (texture_color & GSVector4i::broadcast16(0x8000u));
+    }
+  }
+  else
+  {
+    // Non-textured transparent polygons don't set bit 15, but are treated as transparent.
+    color = VecDither(color_r, dither_offset) | VecDither(color_g, dither_offset).sll16<5>() |
+            VecDither(color_b, dither_offset).sll16<10>() |
+            GSVector4i::broadcast16(transparency_enable ? 0x8000u : 0u);
+  }
+
+  if constexpr (transparency_enable)
+  {
+    const GSVector4i blended = VecBlend(cmd->draw_mode.transparency_mode, color, bg_color);
+    if constexpr (texture_enable)
+    {
+      const GSVector4i bit15 = GSVector4i::broadcast16(0x8000u);
+      color = color.blend(blended, (color & bit15).eq16(bit15));
+    }
+    else
+    {
+      // See above.
+      color = blended & GSVector4i::broadcast16(0x7FFFu);
+    }
+  }
+
+  GSVector4i::store<false>(row_ptr,
+                           bg_color.blend(color | GSVector4i::broadcast16(cmd->params.GetMaskOR()), write_mask));
+}
+
+} // namespace
+
+#endif
+
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
-                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, const u16* texture_page, u32 x,
+                                                      u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
+                                                      u8 texcoord_y)
 {
   VRAMPixel color;
   if constexpr (texture_enable)
@@ -86,34 +715,42 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
     texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
     VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+    if (texture_page)
+    {
+      texture_color.bits = texture_page[ZeroExtend32(texcoord_y) * TEXTURE_PAGE_SIZE + ZeroExtend32(texcoord_x)];
+    }
+    else
     {
-      case GPUTextureMode::Palette4Bit:
+      switch (cmd->draw_mode.texture_mode)
       {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const size_t palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
-        texture_color.bits = g_gpu_clut[palette_index];
-      }
-      break;
+        case GPUTextureMode::Palette4Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const size_t palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+          texture_color.bits = g_gpu_clut[palette_index];
+        }
+        break;
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const size_t palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits = g_gpu_clut[palette_index];
-      }
-      break;
+        case GPUTextureMode::Palette8Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const size_t palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+          texture_color.bits = g_gpu_clut[palette_index];
+        }
+        break;
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        default:
+        {
+          texture_color.bits =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        }
+        break;
       }
-      break;
     }
 
     if (texture_color.bits == 0)
@@ -215,8 +852,49 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
   SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | cmd->params.GetMaskOR());
 }
 
+#ifdef _DEBUG
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void GPU_SW_Backend::CheckSpanFunction(const GPUBackendDrawCommand* cmd, const DrawState& state, u32 x, u32 y,
+                                       const GPUSpanJIT::SpanArgs& args)
+{
+  // Both versions have to start from the same VRAM contents, since the span can overlap its texture page.
+  std::array<u16, VRAM_WIDTH> original, generated;
+  u16* const row = args.dst;
+  std::copy_n(row, args.count, original.begin());
+  state.span_function(&args);
+  std::copy_n(row, args.count, generated.begin());
+  std::copy_n(original.begin(), args.count, row);
+
+  static constexpr u32 shift = 24;
+  u32 r = args.r, g = args.g, b = args.b, u = args.u, v = args.v;
+  for (u32 i = 0; i < args.count; i++)
+  {
+    ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      cmd, state.texture_page, x + i, y, Truncate8(r >> shift), Truncate8(g >> shift), Truncate8(b >> shift),
+      Truncate8(u >> shift), Truncate8(v >> shift));
+    r += args.dr;
+    g += args.dg;
+    b += args.db;
+    u += args.du;
+    v += args.dv;
+  }
+
+  for (u32 i = 0; i < args.count; i++)
+  {
+    if (row[i] != generated[i])
+    {
+      Log_ErrorFmt("Span function mismatch at ({},{}): generated {:04X}, expected {:04X}", x + i, y, generated[i],
+                   row[i]);
+      Panic("Generated span function does not match ShadePixel()");
+    }
+  }
+}
+
+#endif
+
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawState& state)
 {
   const s32 origin_x = cmd->x;
   const s32 origin_y = cmd->y;
@@ -226,7 +904,7 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
   for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
+    if (y < static_cast<s32>(state.area.top) || y > static_cast<s32>(state.area.bottom) ||
         (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
     {
       continue;
@@ -234,17 +912,71 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
 
     const u32 draw_y = static_cast<u32>(y) & VRAM_HEIGHT_MASK;
     const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
+    const s32 x_end = std::min(origin_x + static_cast<s32>(cmd->width) - 1, static_cast<s32>(state.area.right));
+    s32 x = std::max(origin_x, static_cast<s32>(state.area.left));
+
+#ifdef GPU_SW_VECTOR_SPANS
+    const bool vector_enable =
+      (!texture_enable || x > x_end ||
+       !IsSpanInTexturePage(cmd, static_cast<u32>(x), draw_y, static_cast<u32>(x_end - x + 1)));
+    for (; vector_enable && (x + 7) <= x_end; x += 8)
+    {
+      static constexpr u16 lane_offsets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+      const u32 offset_x = static_cast<u32>(x - origin_x);
+      const GSVector4i texcoord_x =
+        GSVector4i::broadcast16(Truncate16(ZeroExtend32(origin_texcoord_x) + offset_x))
+          .add16(GSVector4i::load<false>(lane_offsets)) &
+        GSVector4i::broadcast16(0xFFu);
+
+      ShadePixels8<texture_enable, raw_texture_enable, transparency_enable, false>(
+        cmd, state.texture_page, static_cast<u32>(x), draw_y, GSVector4i::broadcast16(r), GSVector4i::broadcast16(g),
+        GSVector4i::broadcast16(b), texcoord_x, GSVector4i::broadcast16(texcoord_y));
+    }
+#endif
 
-    for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
+    // See DrawSpan().
+    if (state.span_function)
     {
-      const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
+      if (x > x_end)
         continue;
 
+      const GPUSpanJIT::SpanArgs args = {
+        .dst = GetPixelPtr(static_cast<u32>(x), draw_y),
+        .dither_row = s_dither_lut[2][3].data(),
+        .count = static_cast<u32>(x_end - x + 1),
+        .r = ZeroExtend32(r) << 24,
+        .g = ZeroExtend32(g) << 24,
+        .b = ZeroExtend32(b) << 24,
+        .u = ZeroExtend32(Truncate8(ZeroExtend32(origin_texcoord_x) + static_cast<u32>(x - origin_x))) << 24,
+        .v = ZeroExtend32(texcoord_y) << 24,
+        .dr = 0,
+        .dg = 0,
+        .db = 0,
+        .du = 1u << 24,
+        .dv = 0,
+        .page_x = cmd->draw_mode.GetTexturePageBaseX(),
+        .page_y = cmd->draw_mode.GetTexturePageBaseY(),
+        .window_and_x = cmd->window.and_x,
+        .window_and_y = cmd->window.and_y,
+        .window_or_x = cmd->window.or_x,
+        .window_or_y = cmd->window.or_y,
+      };
+#ifdef _DEBUG
+      CheckSpanFunction<texture_enable, raw_texture_enable, transparency_enable, false>(
+        cmd, state, static_cast<u32>(x), draw_y, args);
+#else
+      state.span_function(&args);
+#endif
+      continue;
+    }
+
+    for (; x <= x_end; x++)
+    {
+      const u32 offset_x = static_cast<u32>(x - origin_x);
       const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
 
-      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(cmd, static_cast<u32>(x), draw_y, r, g,
-                                                                                 b, texcoord_x, texcoord_y);
+      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
+        cmd, state.texture_page, static_cast<u32>(x), draw_y, r, g, b, texcoord_x, texcoord_y);
     }
   }
 }
@@ -357,8 +1089,8 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                              const i_deltas& idl)
+void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, const DrawState& state, s32 y, s32 x_start,
+                              s32 x_bound, i_group ig, const i_deltas& idl)
 {
   if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
     return;
@@ -367,16 +1099,16 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   s32 w = x_bound - x_start;
   s32 x = TruncateGPUVertexPosition(x_start);
 
-  if (x < static_cast<s32>(m_drawing_area.left))
+  if (x < static_cast<s32>(state.area.left))
   {
-    s32 delta = static_cast<s32>(m_drawing_area.left) - x;
+    s32 delta = static_cast<s32>(state.area.left) - x;
     x_ig_adjust += delta;
     x += delta;
     w -= delta;
   }
 
-  if ((x + w) > (static_cast<s32>(m_drawing_area.right) + 1))
-    w = static_cast<s32>(m_drawing_area.right) + 1 - x;
+  if ((x + w) > (static_cast<s32>(state.area.right) + 1))
+    w = static_cast<s32>(state.area.right) + 1 - x;
 
   if (w <= 0)
     return;
@@ -384,6 +1116,96 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
+#ifdef GPU_SW_VECTOR_SPANS
+  if (w >= 8 && (!texture_enable || !IsSpanInTexturePage(cmd, static_cast<u32>(x), static_cast<u32>(y),
+                                                          static_cast<u32>(w))))
+  {
+    const u32 r_step = shading_enable ? idl.dr_dx : 0;
+    const u32 g_step = shading_enable ? idl.dg_dx : 0;
+    const u32 b_step = shading_enable ? idl.db_dx : 0;
+    const u32 u_step = texture_enable ? idl.du_dx : 0;
+    const u32 v_step = texture_enable ? idl.dv_dx : 0;
+    const auto ramp = [](u32 base, u32 step) {
+      return GSVector4i(static_cast<s32>(base), static_cast<s32>(base + step), static_cast<s32>(base + step * 2),
+                        static_cast<s32>(base + step * 3));
+    };
+    GSVector4i r_lo = ramp(ig.r, r_step), r_hi = r_lo.add32(GSVector4i::broadcast32(r_step * 4));
+    GSVector4i g_lo = ramp(ig.g, g_step), g_hi = g_lo.add32(GSVector4i::broadcast32(g_step * 4));
+    GSVector4i b_lo = ramp(ig.b, b_step), b_hi = b_lo.add32(GSVector4i::broadcast32(b_step * 4));
+    GSVector4i u_lo = ramp(ig.u, u_step), u_hi = u_lo.add32(GSVector4i::broadcast32(u_step * 4));
+    GSVector4i v_lo = ramp(ig.v, v_step), v_hi = v_lo.add32(GSVector4i::broadcast32(v_step * 4));
+
+    static constexpr u32 shift = COORD_FBS + COORD_POST_PADDING;
+    const s32 vector_pixels = w & ~7;
+    do
+    {
+      ShadePixels8<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+        cmd, state.texture_page, static_cast<u32>(x), static_cast<u32>(y),
+        r_lo.srl32<shift>().ps32(r_hi.srl32<shift>()), g_lo.srl32<shift>().ps32(g_hi.srl32<shift>()),
+        b_lo.srl32<shift>().ps32(b_hi.srl32<shift>()), u_lo.srl32<shift>().ps32(u_hi.srl32<shift>()),
+        v_lo.srl32<shift>().ps32(v_hi.srl32<shift>()));
+
+      if constexpr (shading_enable)
+      {
+        r_lo = r_lo.add32(GSVector4i::broadcast32(r_step * 8));
+        r_hi = r_hi.add32(GSVector4i::broadcast32(r_step * 8));
+        g_lo = g_lo.add32(GSVector4i::broadcast32(g_step * 8));
+        g_hi = g_hi.add32(GSVector4i::broadcast32(g_step * 8));
+        b_lo = b_lo.add32(GSVector4i::broadcast32(b_step * 8));
+        b_hi = b_hi.add32(GSVector4i::broadcast32(b_step * 8));
+      }
+      if constexpr (texture_enable)
+      {
+        u_lo = u_lo.add32(GSVector4i::broadcast32(u_step * 8));
+        u_hi = u_hi.add32(GSVector4i::broadcast32(u_step * 8));
+        v_lo = v_lo.add32(GSVector4i::broadcast32(v_step * 8));
+        v_hi = v_hi.add32(GSVector4i::broadcast32(v_step * 8));
+      }
+
+      x += 8;
+      w -= 8;
+    } while (w >= 8);
+
+    if (w == 0)
+      return;
+
+    AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, static_cast<u32>(vector_pixels));
+  }
+#endif
+
+  // Generated code replaces the scalar loop, the vector path is still faster where it can be used.
+  if (state.span_function)
+  {
+    const GPUSpanJIT::SpanArgs args = {
+      .dst = GetPixelPtr(static_cast<u32>(x), static_cast<u32>(y)),
+      .dither_row = dithering_enable ? s_dither_lut[y & 3][0].data() : s_dither_lut[2][3].data(),
+      .count = static_cast<u32>(w),
+      .r = ig.r,
+      .g = ig.g,
+      .b = ig.b,
+      .u = ig.u,
+      .v = ig.v,
+      .dr = shading_enable ? idl.dr_dx : 0,
+      .dg = shading_enable ? idl.dg_dx : 0,
+      .db = shading_enable ? idl.db_dx : 0,
+      .du = texture_enable ? idl.du_dx : 0,
+      .dv = texture_enable ? idl.dv_dx : 0,
+      .page_x = cmd->draw_mode.GetTexturePageBaseX(),
+      .page_y = cmd->draw_mode.GetTexturePageBaseY(),
+      .window_and_x = cmd->window.and_x,
+      .window_and_y = cmd->window.and_y,
+      .window_or_x = cmd->window.or_x,
+      .window_or_y = cmd->window.or_y,
+    };
+#ifdef _DEBUG
+    CheckSpanFunction<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      cmd, state, static_cast<u32>(x), static_cast<u32>(y), args);
+#else
+    state.span_function(&args);
+#endif
+    return;
+  }
+
   do
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -393,8 +1215,8 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
     const u32 v = ig.v >> (COORD_FBS + COORD_POST_PADDING);
 
     ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-      cmd, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b), Truncate8(u),
-      Truncate8(v));
+      cmd, state.texture_page, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b),
+      Truncate8(u), Truncate8(v));
 
     x++;
     AddIDeltas_DX<shading_enable, texture_enable>(ig, idl);
@@ -403,7 +1225,7 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
+void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const DrawState& state,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
                                   const GPUBackendDrawPolygonCommand::Vertex* v2)
@@ -561,14 +1383,14 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
 
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y < static_cast<s32>(m_drawing_area.top))
+        if (y < static_cast<s32>(state.area.top))
           break;
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(state.area.bottom))
           continue;
 
         DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, y & VRAM_HEIGHT_MASK, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          cmd, state, y & VRAM_HEIGHT_MASK, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
       }
     }
     else
@@ -577,13 +1399,13 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
       {
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(state.area.bottom))
           break;
 
-        if (y >= static_cast<s32>(m_drawing_area.top))
+        if (y >= static_cast<s32>(state.area.top))
         {
           DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, y & VRAM_HEIGHT_MASK, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+            cmd, state, y & VRAM_HEIGHT_MASK, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
         }
 
         yi++;
@@ -628,8 +1450,8 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
 }
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUDrawingArea& area,
+                              const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -689,15 +1511,15 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
     const s32 y = (cur_point.y >> Line_XY_FractBits) & 2047;
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
-        x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        x >= static_cast<s32>(area.left) && x <= static_cast<s32>(area.right) &&
+        y >= static_cast<s32>(area.top) && y <= static_cast<s32>(area.bottom))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
       const u8 b = shading_enable ? static_cast<u8>(cur_point.b >> Line_RGB_FractBits) : p0->b;
 
       ShadePixel<false, false, transparency_enable, dithering_enable>(
-        cmd, static_cast<u32>(x), static_cast<u32>(y) & VRAM_HEIGHT_MASK, r, g, b, 0, 0);
+        cmd, nullptr, static_cast<u32>(x), static_cast<u32>(y) & VRAM_HEIGHT_MASK, r, g, b, 0, 0);
     }
 
     cur_point.x += step.dx_dk;
@@ -714,6 +1536,9 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
 
 void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
 {
+  InvalidateTexturePages(x, y, width, height);
+  m_vram_write_counter++;
+
   const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
   if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
   {
@@ -759,6 +1584,9 @@ void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GP
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
 {
+  InvalidateTexturePages(x, y, width, height);
+  m_vram_write_counter++;
+
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
   {
@@ -795,6 +1623,9 @@ void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
                               GPUBackendCommandParameters params)
 {
+  InvalidateTexturePages(dst_x, dst_y, width, height);
+  m_vram_write_counter++;
+
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
   {
@@ -868,14 +1699,35 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
 
 void GPU_SW_Backend::FlushRender()
 {
+  if (m_band_batch.empty())
+    return;
+
+  {
+    std::unique_lock lock(m_band_mutex);
+    m_band_generation++;
+    m_bands_remaining = m_num_bands - 1;
+  }
+  m_band_start_cv.notify_all();
+
+  ExecuteBandCommands(0);
+
+  {
+    std::unique_lock lock(m_band_mutex);
+    m_band_done_cv.wait(lock, [this]() { return m_bands_remaining == 0; });
+  }
+
+  m_band_batch.clear();
 }
 
 void GPU_SW_Backend::DrawingAreaChanged()
 {
+  m_drawing_area_written = false;
 }
 
 void GPU_SW_Backend::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
 {
+  // Queued draws may still be using the current palette.
+  FlushRender();
   GPU::ReadCLUT(g_gpu_clut, reg, clut_is_8bit);
 }
 
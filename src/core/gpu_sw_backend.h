@@ -5,9 +5,12 @@
 
 #include "gpu.h"
 #include "gpu_backend.h"
+#include "gpu_sw_span_jit.h"
 
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class GPU_SW_Backend final : public GPUBackend
@@ -17,13 +20,18 @@ public:
   ~GPU_SW_Backend() override;
 
   bool Initialize(bool force_thread) override;
+  void UpdateSettings() override;
   void Reset() override;
+  void Shutdown() override;
 
   ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return g_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &g_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE u16* GetPixelPtr(const u32 x, const u32 y) { return &g_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE void SetPixel(const u32 x, const u32 y, const u16 value) { g_vram[VRAM_WIDTH * y + x] = value; }
 
+  /// Incremented by every command which can write to VRAM. Only valid to read after a sync.
+  ALWAYS_INLINE u32 GetVRAMWriteCounter() const { return m_vram_write_counter; }
+
   // this is actually (31 * 255) >> 4) == 494, but to simplify addressing we use the next power of two (512)
   static constexpr u32 DITHER_LUT_SIZE = 512;
   using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
@@ -101,18 +109,118 @@ protected:
   void FlushRender() override;
   void DrawingAreaChanged() override;
   void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
+  void HandleCommand(const GPUBackendCommand* cmd) override;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Band workers
+  //////////////////////////////////////////////////////////////////////////
+
+  // Draws are split into horizontal bands of the drawing area, and each band is rasterized by its own thread, with
+  // band 0 being drawn by the thread issuing the commands. Within a band, commands execute in order, so the only
+  // hazards are primitives which sample from the area being drawn to, and those are drawn on their own.
+  static constexpr u32 MAX_BAND_BATCH_SIZE = 256 * 1024;
+
+  void StartBandWorkers(u32 num_bands);
+  void StopBandWorkers();
+  void BandWorkerThread(u32 band, u32 generation);
+  void QueueBandCommand(const GPUBackendDrawCommand* cmd, const u16* texture_page);
+  void ExecuteBandCommands(u32 band);
+  GPUDrawingArea GetBandArea(u32 band) const;
+  bool CanDrawInBands(const GPUBackendDrawCommand* cmd) const;
+  bool IsTexturePageInDrawingArea(const GPUBackendDrawCommand* cmd) const;
+
+  void RasterizePolygon(const GPUBackendDrawPolygonCommand* cmd, const GPUDrawingArea& area,
+                        const u16* texture_page);
+  void RasterizeRectangle(const GPUBackendDrawRectangleCommand* cmd, const GPUDrawingArea& area,
+                          const u16* texture_page);
+  void RasterizeLine(const GPUBackendDrawLineCommand* cmd, const GPUDrawingArea& area);
+
+  std::vector<Threading::Thread> m_band_threads;
+  std::vector<u8> m_band_batch;
+  u32 m_num_bands = 1;
+  bool m_use_span_jit = false;
+
+  std::mutex m_band_mutex;
+  std::condition_variable m_band_start_cv;
+  std::condition_variable m_band_done_cv;
+  u32 m_band_generation = 0;
+  u32 m_bands_remaining = 0;
+  bool m_band_shutdown = false;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Decoded texture page cache
+  //////////////////////////////////////////////////////////////////////////
+
+  // Palette textures are decoded to 16-bit texels on first use, so textured pixels only need a single fetch. Rows are
+  // decoded 32 texels at a time, so small sprites don't pay for the whole page. Entries are keyed by page, mode and
+  // palette address, and are checked against the versions of the VRAM blocks they were decoded from, and the current
+  // CLUT contents. Lookups happen on the thread issuing commands, band workers only read texels which were decoded
+  // for their commands.
+  static constexpr u32 TEXTURE_PAGE_SIZE = 256;
+  static constexpr u32 TEXTURE_PAGE_CHUNK_SIZE = 32;
+  static constexpr u32 NUM_TEXTURE_PAGE_CHUNKS = TEXTURE_PAGE_SIZE / TEXTURE_PAGE_CHUNK_SIZE;
+  static constexpr u32 TEXTURE_PAGE_CACHE_SIZE = 32;
+  static constexpr u32 TEXTURE_PAGE_CACHE_EVICT_AGE = TEXTURE_PAGE_CACHE_SIZE * 4;
+  static constexpr u32 VRAM_BLOCK_WIDTH = 64;
+  static constexpr u32 VRAM_BLOCK_HEIGHT = 256;
+  static constexpr u32 NUM_VRAM_BLOCKS_X = VRAM_WIDTH / VRAM_BLOCK_WIDTH;
+  static constexpr u32 NUM_VRAM_BLOCKS_Y = VRAM_HEIGHT / VRAM_BLOCK_HEIGHT;
+
+  struct TexturePageCacheEntry
+  {
+    std::unique_ptr<u16[]> texels;
+    std::array<u8, TEXTURE_PAGE_SIZE> valid_chunks;
+    std::array<u16, GPU_CLUT_SIZE> palette;
+    std::array<u32, 2> block_versions;
+    u32 key;
+    u32 last_used;
+  };
+
+  const u16* GetTexturePage(const GPUBackendDrawCommand* cmd, u8 first_column, u32 num_columns, u8 first_row,
+                            u32 num_rows);
+  const u16* GetPolygonTexturePage(const GPUBackendDrawPolygonCommand* cmd);
+  const u16* GetRectangleTexturePage(const GPUBackendDrawRectangleCommand* cmd);
+  void DecodeTexturePageRow(const GPUBackendDrawCommand* cmd, u16* texels, u32 row, u8 chunks) const;
+  void InvalidateTexturePages(u32 x, u32 y, u32 width, u32 height);
+  void InvalidateTexturePageCache();
+  void MarkDrawingAreaWritten();
+
+  std::array<TexturePageCacheEntry, TEXTURE_PAGE_CACHE_SIZE> m_texture_page_cache = {};
+  std::array<std::array<u32, NUM_VRAM_BLOCKS_X>, NUM_VRAM_BLOCKS_Y> m_vram_block_versions = {};
+  u32 m_texture_page_cache_tick = 0;
+  u32 m_vram_write_counter = 0;
+  bool m_drawing_area_written = false;
 
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
+
+  /// State for rasterizing a primitive which isn't part of the command.
+  struct DrawState
+  {
+    GPUDrawingArea area;
+    GPUSpanJIT::SpanFunction span_function;
+
+    /// Decoded texels for the primitive's texture page, or nullptr to sample VRAM.
+    const u16* texture_page;
+  };
+
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+  void ShadePixel(const GPUBackendDrawCommand* cmd, const u16* texture_page, u32 x, u32 y, u8 color_r, u8 color_g,
+                  u8 color_b, u8 texcoord_x, u8 texcoord_y);
+
+#ifdef _DEBUG
+  /// Runs a generated span function, then redraws the span with ShadePixel() and checks the output matches.
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-  void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
-                  u8 texcoord_y);
+  void CheckSpanFunction(const GPUBackendDrawCommand* cmd, const DrawState& state, u32 x, u32 y,
+                         const GPUSpanJIT::SpanArgs& args);
+#endif
 
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const DrawState& state);
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd,
+                                                         const DrawState& state);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -146,15 +254,17 @@ protected:
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                const i_deltas& idl);
+  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, const DrawState& state, s32 y, s32 x_start, s32 x_bound,
+                i_group ig, const i_deltas& idl);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const DrawState& state,
+                    const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                    const GPUBackendDrawPolygonCommand::Vertex* v2);
 
   using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
+                                                        const DrawState& state,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v2);
@@ -162,10 +272,10 @@ protected:
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                const GPUBackendDrawLineCommand::Vertex* p1);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUDrawingArea& area,
+                const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1);
 
-  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
+  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd, const GPUDrawingArea& area,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
                                                     const GPUBackendDrawLineCommand::Vertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
@@ -0,0 +1,500 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "gpu_sw_span_jit.h"
+#include "gpu.h"
+
+#include "common/log.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#if defined(CPU_ARCH_X64)
+
+#include "util/jit_code_buffer.h"
+
+// We need to include windows.h before xbyak does..
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#endif
+
+#define XBYAK_NO_OP_NAMES 1
+#include "xbyak.h"
+
+#endif
+
+Log_SetChannel(GPUSpanJIT);
+
+namespace GPUSpanJIT {
+namespace {
+enum KeyBits : u32
+{
+  KEY_SHADING = (1u << 0),
+  KEY_TEXTURE = (1u << 1),
+  KEY_RAW_TEXTURE = (1u << 2),
+  KEY_TRANSPARENCY = (1u << 3),
+  KEY_DITHERING = (1u << 4),
+  KEY_CHECK_MASK = (1u << 5),
+  KEY_SET_MASK = (1u << 6),
+  KEY_TEXTURE_MODE_SHIFT = 7,
+  KEY_TRANSPARENCY_MODE_SHIFT = 9,
+
+  NUM_KEYS = (1u << 11),
+};
+} // namespace
+} // namespace GPUSpanJIT
+
+u32 GPUSpanJIT::GetKey(bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+                       bool dithering_enable, GPUTextureMode texture_mode, GPUTransparencyMode transparency_mode,
+                       bool check_mask, bool set_mask)
+{
+  u32 key = (shading_enable ? KEY_SHADING : 0u) | (check_mask ? KEY_CHECK_MASK : 0u) | (set_mask ? KEY_SET_MASK : 0u);
+
+  if (texture_enable)
+  {
+    // Both direct modes sample the same way.
+    const u32 mode = std::min<u32>(static_cast<u32>(texture_mode) & 3u, static_cast<u32>(GPUTextureMode::Direct16Bit));
+    key |= KEY_TEXTURE | (raw_texture_enable ? KEY_RAW_TEXTURE : 0u) | (mode << KEY_TEXTURE_MODE_SHIFT);
+  }
+  if (transparency_enable)
+    key |= KEY_TRANSPARENCY | ((static_cast<u32>(transparency_mode) & 3u) << KEY_TRANSPARENCY_MODE_SHIFT);
+
+  // Dithering doesn't apply to raw textures.
+  if (dithering_enable && !(texture_enable && raw_texture_enable))
+    key |= KEY_DITHERING;
+
+  return key;
+}
+
+#if defined(CPU_ARCH_X64)
+
+namespace GPUSpanJIT {
+namespace {
+static constexpr u32 CODE_BUFFER_SIZE = 1 * 1024 * 1024;
+static constexpr u32 MAX_FUNCTION_SIZE = 4096;
+
+class SpanCompiler : public Xbyak::CodeGenerator
+{
+public:
+  SpanCompiler(u32 key, void* buffer, size_t size);
+
+  void Compile();
+
+private:
+  static constexpr const Xbyak::Reg64& RARGS = Xbyak::util::rbx;
+  static constexpr const Xbyak::Reg64& RDST = Xbyak::util::rsi;
+  static constexpr const Xbyak::Reg32& RCOUNT = Xbyak::util::edi;
+  static constexpr const Xbyak::Reg32& RR = Xbyak::util::r8d;
+  static constexpr const Xbyak::Reg32& RG = Xbyak::util::r9d;
+  static constexpr const Xbyak::Reg32& RB = Xbyak::util::r10d;
+  static constexpr const Xbyak::Reg32& RU = Xbyak::util::r11d;
+  static constexpr const Xbyak::Reg32& RV = Xbyak::util::r12d;
+  static constexpr const Xbyak::Reg64& RVRAM = Xbyak::util::r13;
+  static constexpr const Xbyak::Reg64& RCLUT = Xbyak::util::r14;
+  static constexpr const Xbyak::Reg64& RDITHER = Xbyak::util::r15;
+
+  // Temporaries. eax holds the colour being built.
+  static constexpr const Xbyak::Reg32& RCOLOR = Xbyak::util::eax;
+  static constexpr const Xbyak::Reg32& RTEMP1 = Xbyak::util::ecx;
+  static constexpr const Xbyak::Reg32& RTEMP2 = Xbyak::util::edx;
+  static constexpr const Xbyak::Reg32& RTEMP3 = Xbyak::util::ebp;
+
+  ALWAYS_INLINE bool HasKey(u32 bit) const { return (m_key & bit) != 0; }
+  ALWAYS_INLINE u32 GetTextureMode() const { return (m_key >> KEY_TEXTURE_MODE_SHIFT) & 3u; }
+  ALWAYS_INLINE GPUTransparencyMode GetTransparencyMode() const
+  {
+    return static_cast<GPUTransparencyMode>((m_key >> KEY_TRANSPARENCY_MODE_SHIFT) & 3u);
+  }
+
+  static Xbyak::Address ArgPtr(size_t offset) { return Xbyak::util::dword[RARGS + static_cast<u32>(offset)]; }
+
+  void EmitPrologue();
+  void EmitEpilogue();
+  void EmitTextureFetch(const Xbyak::Label& skip_pixel);
+  void EmitDither(const Xbyak::Reg32& value);
+  void EmitModulate();
+  void EmitUntexturedColor();
+  void EmitBlend();
+
+  u32 m_key;
+};
+
+static constexpr std::array<Xbyak::Reg64, 8> s_saved_registers = {
+  Xbyak::util::rbx, Xbyak::util::rbp, Xbyak::util::rsi, Xbyak::util::rdi,
+  Xbyak::util::r12, Xbyak::util::r13, Xbyak::util::r14, Xbyak::util::r15,
+};
+
+static JitCodeBuffer s_code_buffer;
+static std::mutex s_compile_mutex;
+static std::array<std::atomic<SpanFunction>, NUM_KEYS> s_functions = {};
+static bool s_code_buffer_full = false;
+} // namespace
+} // namespace GPUSpanJIT
+
+GPUSpanJIT::SpanCompiler::SpanCompiler(u32 key, void* buffer, size_t size)
+  : Xbyak::CodeGenerator(size, buffer), m_key(key)
+{
+}
+
+void GPUSpanJIT::SpanCompiler::EmitPrologue()
+{
+  for (const Xbyak::Reg64& reg : s_saved_registers)
+    push(reg);
+
+#ifdef _WIN32
+  mov(RARGS, rcx);
+#else
+  mov(RARGS, rdi);
+#endif
+
+  mov(RDST, qword[RARGS + offsetof(SpanArgs, dst)]);
+  mov(RDITHER, qword[RARGS + offsetof(SpanArgs, dither_row)]);
+  mov(RCOUNT, ArgPtr(offsetof(SpanArgs, count)));
+  mov(RR, ArgPtr(offsetof(SpanArgs, r)));
+  mov(RG, ArgPtr(offsetof(SpanArgs, g)));
+  mov(RB, ArgPtr(offsetof(SpanArgs, b)));
+  mov(RU, ArgPtr(offsetof(SpanArgs, u)));
+  mov(RV, ArgPtr(offsetof(SpanArgs, v)));
+  mov(RVRAM, reinterpret_cast<size_t>(g_vram));
+  mov(RCLUT, reinterpret_cast<size_t>(g_gpu_clut));
+}
+
+void GPUSpanJIT::SpanCompiler::EmitEpilogue()
+{
+  for (auto it = s_saved_registers.rbegin(); it != s_saved_registers.rend(); ++it)
+    pop(*it);
+
+  ret();
+}
+
+void GPUSpanJIT::SpanCompiler::EmitTextureFetch(const Xbyak::Label& skip_pixel)
+{
+  const Xbyak::Reg64 RCOLOR_64 = RCOLOR.cvt64();
+
+  // Apply texture window, ecx = u, edx = v.
+  mov(RTEMP1, RU);
+  shr(RTEMP1, 24);
+  and_(RTEMP1, ArgPtr(offsetof(SpanArgs, window_and_x)));
+  or_(RTEMP1, ArgPtr(offsetof(SpanArgs, window_or_x)));
+  mov(RTEMP2, RV);
+  shr(RTEMP2, 24);
+  and_(RTEMP2, ArgPtr(offsetof(SpanArgs, window_and_y)));
+  or_(RTEMP2, ArgPtr(offsetof(SpanArgs, window_or_y)));
+
+  // eax = row offset
+  mov(RCOLOR, RTEMP2);
+  add(RCOLOR, ArgPtr(offsetof(SpanArgs, page_y)));
+  and_(RCOLOR, VRAM_HEIGHT - 1);
+  shl(RCOLOR, 10);
+
+  switch (static_cast<GPUTextureMode>(GetTextureMode()))
+  {
+    case GPUTextureMode::Palette4Bit:
+    {
+      mov(RTEMP2, RTEMP1);
+      shr(RTEMP2, 2);
+      add(RTEMP2, ArgPtr(offsetof(SpanArgs, page_x)));
+      and_(RTEMP2, VRAM_WIDTH - 1);
+      add(RCOLOR, RTEMP2);
+      movzx(RCOLOR, word[RVRAM + RCOLOR_64 * 2]);
+      and_(RTEMP1, 3);
+      shl(RTEMP1, 2);
+      shr(RCOLOR, cl);
+      and_(RCOLOR, 0x0F);
+      movzx(RCOLOR, word[RCLUT + RCOLOR_64 * 2]);
+    }
+    break;
+
+    case GPUTextureMode::Palette8Bit:
+    {
+      mov(RTEMP2, RTEMP1);
+      shr(RTEMP2, 1);
+      add(RTEMP2, ArgPtr(offsetof(SpanArgs, page_x)));
+      and_(RTEMP2, VRAM_WIDTH - 1);
+      add(RCOLOR, RTEMP2);
+      movzx(RCOLOR, word[RVRAM + RCOLOR_64 * 2]);
+      and_(RTEMP1, 1);
+      shl(RTEMP1, 3);
+      shr(RCOLOR, cl);
+      and_(RCOLOR, 0xFF);
+      movzx(RCOLOR, word[RCLUT + RCOLOR_64 * 2]);
+    }
+    break;
+
+    default:
+    {
+      add(RTEMP1, ArgPtr(offsetof(SpanArgs, page_x)));
+      and_(RTEMP1, VRAM_WIDTH - 1);
+      add(RCOLOR, RTEMP1);
+      movzx(RCOLOR, word[RVRAM + RCOLOR_64 * 2]);
+    }
+    break;
+  }
+
+  test(RCOLOR, RCOLOR);
+  jz(skip_pixel, T_NEAR);
+}
+
+void GPUSpanJIT::SpanCompiler::EmitDither(const Xbyak::Reg32& value)
+{
+  // value = dither_row[column * DITHER_LUT_SIZE + value], the column comes from the destination address, since VRAM
+  // is page aligned. Without dithering, the row already points at the single entry which is used.
+  if (HasKey(KEY_DITHERING))
+  {
+    mov(RTEMP3, RDST.cvt32());
+    shr(RTEMP3, 1);
+    and_(RTEMP3, 3);
+    shl(RTEMP3, 9);
+    add(value, RTEMP3);
+  }
+
+  movzx(value, byte[RDITHER + value.cvt64()]);
+}
+
+void GPUSpanJIT::SpanCompiler::EmitModulate()
+{
+  // edx = result, eax = texture colour
+  xor_(RTEMP2, RTEMP2);
+
+  const Xbyak::Reg32 channels[3] = {RR, RG, RB};
+  for (u32 i = 0; i < 3; i++)
+  {
+    mov(RTEMP3, channels[i]);
+    shr(RTEMP3, 24);
+    mov(RTEMP1, RCOLOR);
+    if (i > 0)
+      shr(RTEMP1, i * 5);
+    and_(RTEMP1, 0x1F);
+    imul(RTEMP1, RTEMP3);
+    shr(RTEMP1, 4);
+    EmitDither(RTEMP1);
+    if (i > 0)
+      shl(RTEMP1, i * 5);
+    or_(RTEMP2, RTEMP1);
+  }
+
+  and_(RCOLOR, 0x8000);
+  or_(RCOLOR, RTEMP2);
+}
+
+void GPUSpanJIT::SpanCompiler::EmitUntexturedColor()
+{
+  // Non-textured transparent polygons don't set bit 15, but are treated as transparent.
+  if (HasKey(KEY_TRANSPARENCY))
+    mov(RCOLOR, 0x8000);
+  else
+    xor_(RCOLOR, RCOLOR);
+
+  const Xbyak::Reg32 channels[3] = {RR, RG, RB};
+  for (u32 i = 0; i < 3; i++)
+  {
+    mov(RTEMP1, channels[i]);
+    shr(RTEMP1, 24);
+    EmitDither(RTEMP1);
+    if (i > 0)
+      shl(RTEMP1, i * 5);
+    or_(RCOLOR, RTEMP1);
+  }
+}
+
+void GPUSpanJIT::SpanCompiler::EmitBlend()
+{
+  // Same as the blargg bit math in GPU_SW_Backend::ShadePixel(). eax = foreground, edx = background.
+  switch (GetTransparencyMode())
+  {
+    case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+    {
+      or_(RTEMP2, 0x8000);
+      mov(RTEMP1, RCOLOR);
+      xor_(RTEMP1, RTEMP2);
+      and_(RTEMP1, 0x0421);
+      add(RCOLOR, RTEMP2);
+      sub(RCOLOR, RTEMP1);
+      shr(RCOLOR, 1);
+    }
+    break;
+
+    case GPUTransparencyMode::BackgroundPlusForeground:
+    case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+    {
+      and_(RTEMP2, ~0x8000u);
+      if (GetTransparencyMode() == GPUTransparencyMode::BackgroundPlusQuarterForeground)
+      {
+        shr(RCOLOR, 2);
+        and_(RCOLOR, 0x1CE7);
+        or_(RCOLOR, 0x8000);
+      }
+
+      // ecx = sum, eax = carry
+      lea(RTEMP1, ptr[RCOLOR.cvt64() + RTEMP2.cvt64()]);
+      xor_(RCOLOR, RTEMP2);
+      and_(RCOLOR, 0x8421);
+      mov(RTEMP2, RTEMP1);
+      sub(RTEMP2, RCOLOR);
+      and_(RTEMP2, 0x8420);
+      mov(RCOLOR, RTEMP2);
+      shr(RCOLOR, 5);
+      sub(RTEMP1, RTEMP2);
+      sub(RTEMP2, RCOLOR);
+      or_(RTEMP1, RTEMP2);
+      mov(RCOLOR, RTEMP1);
+    }
+    break;
+
+    case GPUTransparencyMode::BackgroundMinusForeground:
+    default:
+    {
+      or_(RTEMP2, 0x8000);
+      and_(RCOLOR, ~0x8000u);
+
+      // ecx = diff, eax = borrow
+      lea(RTEMP1, ptr[RTEMP2.cvt64() + 0x108420]);
+      sub(RTEMP1, RCOLOR);
+      xor_(RCOLOR, RTEMP2);
+      and_(RCOLOR, 0x108420);
+      mov(RTEMP2, RTEMP1);
+      sub(RTEMP2, RCOLOR);
+      and_(RTEMP2, 0x108420);
+      mov(RCOLOR, RTEMP2);
+      shr(RCOLOR, 5);
+      sub(RTEMP1, RTEMP2);
+      sub(RTEMP2, RCOLOR);
+      and_(RTEMP1, RTEMP2);
+      mov(RCOLOR, RTEMP1);
+    }
+    break;
+  }
+
+  // See above.
+  if (!HasKey(KEY_TEXTURE))
+    and_(RCOLOR, 0x7FFF);
+}
+
+void GPUSpanJIT::SpanCompiler::Compile()
+{
+  Xbyak::Label loop;
+  Xbyak::Label skip_pixel;
+
+  EmitPrologue();
+
+  L(loop);
+  if (HasKey(KEY_TEXTURE))
+  {
+    EmitTextureFetch(skip_pixel);
+    if (!HasKey(KEY_RAW_TEXTURE))
+      EmitModulate();
+  }
+  else
+  {
+    EmitUntexturedColor();
+  }
+
+  movzx(RTEMP2, word[RDST]);
+  if (HasKey(KEY_CHECK_MASK))
+  {
+    test(RTEMP2, 0x8000);
+    jnz(skip_pixel, T_NEAR);
+  }
+
+  if (HasKey(KEY_TRANSPARENCY))
+  {
+    // Only texels with bit 15 set are blended. Texture data is effectively random, so select the result instead of
+    // branching on it.
+    if (HasKey(KEY_TEXTURE))
+    {
+      mov(RTEMP3, RCOLOR);
+      EmitBlend();
+      test(RTEMP3, 0x8000);
+      cmovz(RCOLOR, RTEMP3);
+    }
+    else
+    {
+      EmitBlend();
+    }
+  }
+
+  if (HasKey(KEY_SET_MASK))
+    or_(RCOLOR, 0x8000);
+  mov(word[RDST], RCOLOR.cvt16());
+
+  L(skip_pixel);
+  if (HasKey(KEY_SHADING))
+  {
+    add(RR, ArgPtr(offsetof(SpanArgs, dr)));
+    add(RG, ArgPtr(offsetof(SpanArgs, dg)));
+    add(RB, ArgPtr(offsetof(SpanArgs, db)));
+  }
+  if (HasKey(KEY_TEXTURE))
+  {
+    add(RU, ArgPtr(offsetof(SpanArgs, du)));
+    add(RV, ArgPtr(offsetof(SpanArgs, dv)));
+  }
+  add(RDST, sizeof(u16));
+  dec(RCOUNT);
+  jnz(loop, T_NEAR);
+
+  EmitEpilogue();
+}
+
+GPUSpanJIT::SpanFunction GPUSpanJIT::GetSpanFunction(u32 key)
+{
+  DebugAssert(key < NUM_KEYS);
+  SpanFunction func = s_functions[key].load(std::memory_order_acquire);
+  if (func)
+    return func;
+
+  std::unique_lock lock(s_compile_mutex);
+  func = s_functions[key].load(std::memory_order_relaxed);
+  if (func || s_code_buffer_full)
+    return func;
+
+  if (!s_code_buffer.IsValid() && !s_code_buffer.Allocate(CODE_BUFFER_SIZE))
+  {
+    Log_ErrorPrint("Failed to allocate code buffer, falling back to the templated rasterizer.");
+    s_code_buffer_full = true;
+    return nullptr;
+  }
+
+  if (s_code_buffer.GetFreeCodeSpace() < MAX_FUNCTION_SIZE)
+  {
+    Log_WarningPrint("Code buffer is full, new draw states will use the templated rasterizer.");
+    s_code_buffer_full = true;
+    return nullptr;
+  }
+
+  SpanCompiler compiler(key, s_code_buffer.GetFreeCodePointer(), s_code_buffer.GetFreeCodeSpace());
+  compiler.Compile();
+
+  func = reinterpret_cast<SpanFunction>(s_code_buffer.GetFreeCodePointer());
+  s_code_buffer.CommitCode(static_cast<u32>(compiler.getSize()));
+  s_code_buffer.Align(16, 0xCC);
+  s_functions[key].store(func, std::memory_order_release);
+
+  Log_DevFmt("Compiled span function for key 0x{:03X} ({} bytes)", key, compiler.getSize());
+  return func;
+}
+
+void GPUSpanJIT::Shutdown()
+{
+  std::unique_lock lock(s_compile_mutex);
+  for (std::atomic<SpanFunction>& func : s_functions)
+    func.store(nullptr, std::memory_order_relaxed);
+  s_code_buffer.Destroy();
+  s_code_buffer_full = false;
+}
+
+#else
+
+GPUSpanJIT::SpanFunction GPUSpanJIT::GetSpanFunction(u32 key)
+{
+  return nullptr;
+}
+
+void GPUSpanJIT::Shutdown()
+{
+}
+
+#endif
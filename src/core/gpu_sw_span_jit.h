@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "gpu_types.h"
+
+/// Generates span rasterization functions for the software renderer, specialized for one draw state each, so the
+/// per-pixel loop doesn't branch on the texture mode, transparency mode or masking. Only implemented for x64, on other
+/// architectures GetSpanFunction() always returns nullptr, and the templated rasterizer is used instead.
+namespace GPUSpanJIT {
+
+/// Everything a span function needs which isn't part of the key. Interpolants are in the same 8.24 fixed-point format
+/// as the rasterizer's i_group, and are stepped by the deltas after each pixel.
+struct SpanArgs
+{
+  u16* dst;
+  const u8* dither_row;
+  u32 count;
+  u32 r, g, b, u, v;
+  u32 dr, dg, db, du, dv;
+  u32 page_x, page_y;
+  u32 window_and_x, window_and_y;
+  u32 window_or_x, window_or_y;
+};
+
+using SpanFunction = void (*)(const SpanArgs* args);
+
+/// Builds the cache key for a draw state. State which has no effect (e.g. the texture mode for untextured draws) is
+/// dropped, so those draws share a function.
+u32 GetKey(bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+           bool dithering_enable, GPUTextureMode texture_mode, GPUTransparencyMode transparency_mode, bool check_mask,
+           bool set_mask);
+
+/// Returns the span function for a key, generating it on first use. Safe to call from multiple threads.
+/// Returns nullptr if the JIT is unavailable, or out of space.
+SpanFunction GetSpanFunction(u32 key);
+
+/// Releases all generated code. No span functions may be running.
+void Shutdown();
+
+} // namespace GPUSpanJIT
@@ -264,6 +264,8 @@ enum class GPUBackendCommandType : u8
   DrawPolygon,
   DrawRectangle,
   DrawLine,
+  DrawPrecisePolygon,
+  FlushRender,
 };
 
 union GPUBackendCommandParameters
@@ -278,6 +280,9 @@ union GPUBackendCommandParameters
   BitField<u8, bool, 2, 1> set_mask_while_drawing;
   BitField<u8, bool, 3, 1> check_mask_before_draw;
 
+  /// Set on draws after the texture page or palette changed, for renderers which cache them.
+  BitField<u8, bool, 4, 1> texture_page_changed;
+
   ALWAYS_INLINE bool IsMaskingEnabled() const { return (bits & 12u) != 0u; }
 
   // During transfer/render operations, if ((dst_pixel & mask_and) == 0) { pixel = src_pixel | mask_or }
@@ -390,6 +395,23 @@ struct GPUBackendDrawPolygonCommand : public GPUBackendDrawCommand
   Vertex vertices[0];
 };
 
+/// Polygon with the PGXP positions and depth alongside the native positions, for the hardware renderers.
+struct GPUBackendDrawPrecisePolygonCommand : public GPUBackendDrawCommand
+{
+  u16 num_vertices;
+  bool valid_w;
+
+  struct Vertex
+  {
+    float x, y, w;
+    s32 native_x, native_y;
+    u32 color;
+    u16 texcoord;
+  };
+
+  Vertex vertices[0];
+};
+
 struct GPUBackendDrawRectangleCommand : public GPUBackendDrawCommand
 {
   s32 x, y;
@@ -14,6 +14,7 @@
 
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/intrin.h"
 
 #include <algorithm>
 #include <array>
@@ -521,6 +522,86 @@ ALWAYS_INLINE u32 GTE::UNRDivide(u32 lhs, u32 rhs)
 void GTE::MulMatVec(const s16* M_, const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
 #define M(i, j) M_[((i)*3) + (j)]
+
+  // Without a translation vector, each row is the sum of three 16x16 products, which is at most 33 bits. That means
+  // the 44-bit MAC overflow checks can never trigger, and only the IR saturation flags have to be computed, so all
+  // three rows can be done at once.
+  DebugAssert(shift == 0 || shift == 12);
+
+#if defined(CPU_ARCH_SSE)
+  // M0*Vx+M1*Vy only wraps when all four are -0x8000, which produces INT32_MIN in place of 2^31.
+  const __m128i a = _mm_madd_epi16(_mm_setr_epi16(M(0, 0), M(0, 1), M(1, 0), M(1, 1), M(2, 0), M(2, 1), 0, 0),
+                                   _mm_setr_epi16(Vx, Vy, Vx, Vy, Vx, Vy, 0, 0));
+  const __m128i b = _mm_madd_epi16(_mm_setr_epi16(M(0, 2), 0, M(1, 2), 0, M(2, 2), 0, 0, 0),
+                                   _mm_setr_epi16(Vz, 0, Vz, 0, Vz, 0, 0, 0));
+
+  __m128i mac;
+  if (shift == 0)
+  {
+    // MAC is the low 32 bits of the sum, which the wrapped value doesn't affect.
+    mac = _mm_add_epi32(a, b);
+  }
+  else
+  {
+    // Shift both halves separately, and add the carry out of the low bits. The wrapped case needs 2^20 added back.
+    const __m128i low_mask = _mm_set1_epi32(0xFFF);
+    const __m128i carry = _mm_srli_epi32(_mm_add_epi32(_mm_and_si128(a, low_mask), _mm_and_si128(b, low_mask)), 12);
+    const __m128i wrapped =
+      _mm_and_si128(_mm_cmpeq_epi32(a, _mm_set1_epi32(std::numeric_limits<s32>::min())), _mm_set1_epi32(1 << 20));
+    mac = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(a, 12), _mm_srai_epi32(b, 12)), _mm_add_epi32(carry, wrapped));
+  }
+
+  // Saturate to 16 bits, then compare against the unsaturated value to get the flags.
+  __m128i ir = _mm_packs_epi32(mac, mac);
+  if (lm)
+    ir = _mm_max_epi16(ir, _mm_setzero_si128());
+  ir = _mm_srai_epi32(_mm_unpacklo_epi16(ir, ir), 16);
+  const u32 saturated = ~static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(ir, mac)))) & 7u;
+
+  alignas(VECTOR_ALIGNMENT) s32 mac_values[4];
+  alignas(VECTOR_ALIGNMENT) s32 ir_values[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(mac_values), mac);
+  _mm_store_si128(reinterpret_cast<__m128i*>(ir_values), ir);
+#elif defined(CPU_ARCH_NEON)
+  const s16 col0[4] = {M(0, 0), M(1, 0), M(2, 0), 0};
+  const s16 col1[4] = {M(0, 1), M(1, 1), M(2, 1), 0};
+  const s16 col2[4] = {M(0, 2), M(1, 2), M(2, 2), 0};
+  const int32x4_t p0 = vmull_n_s16(vld1_s16(col0), Vx);
+  const int32x4_t p1 = vmull_n_s16(vld1_s16(col1), Vy);
+  const int32x4_t p2 = vmull_n_s16(vld1_s16(col2), Vz);
+
+  const int64x2_t shift_vec = vdupq_n_s64(-static_cast<s64>(shift));
+  const int64x2_t lo = vshlq_s64(
+    vaddq_s64(vaddl_s32(vget_low_s32(p0), vget_low_s32(p1)), vmovl_s32(vget_low_s32(p2))), shift_vec);
+  const int64x2_t hi = vshlq_s64(
+    vaddq_s64(vaddl_s32(vget_high_s32(p0), vget_high_s32(p1)), vmovl_s32(vget_high_s32(p2))), shift_vec);
+  const int32x4_t mac = vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+
+  // Saturate to 16 bits, then compare against the unsaturated value to get the flags.
+  int16x4_t ir16 = vqmovn_s32(mac);
+  if (lm)
+    ir16 = vmax_s16(ir16, vdup_n_s16(0));
+  const int32x4_t ir = vmovl_s16(ir16);
+  const uint32x4_t unsaturated = vceqq_s32(ir, mac);
+  const u32 saturated = (vgetq_lane_u32(unsaturated, 0) ? 0u : 1u) | (vgetq_lane_u32(unsaturated, 1) ? 0u : 2u) |
+                        (vgetq_lane_u32(unsaturated, 2) ? 0u : 4u);
+
+  s32 mac_values[4];
+  s32 ir_values[4];
+  vst1q_s32(mac_values, mac);
+  vst1q_s32(ir_values, ir);
+#endif
+
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  for (u32 i = 0; i < 3; i++)
+  {
+    REGS.dr32[25 + i] = static_cast<u32>(mac_values[i]);
+    REGS.dr32[9 + i] = static_cast<u32>(ir_values[i]);
+  }
+
+  // IR1..IR3 saturation flags are bits 24..22
+  REGS.FLAG.bits |= ((saturated & 1u) << 24) | ((saturated & 2u) << 22) | ((saturated & 4u) << 20);
+#else
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M(i, 0)) * s64(Vx)) + (s64(M(i, 1)) * s64(Vy))) +      \
                                   (s64(M(i, 2)) * s64(Vz)),                                                            \
@@ -531,6 +612,8 @@ void GTE::MulMatVec(const s16* M_, const s16 Vx, const s16 Vy, const s16 Vz, u8
   dot3(2);
 
 #undef dot3
+#endif
+
 #undef M
 }
 
@@ -245,6 +245,11 @@ void Host::Internal::SetInputSettingsLayer(SettingsInterface* sif, std::unique_l
   s_layered_settings_interface.SetLayer(LayeredSettingsInterface::LAYER_INPUT, sif);
 }
 
+LayeredSettingsInterface::LayerGenerations Host::Internal::GetSettingsLayerGenerations()
+{
+  return s_layered_settings_interface.GetLayerGenerations();
+}
+
 std::string Host::GetHTTPUserAgent()
 {
   return fmt::format("DuckStation for {} ({}) {}", TARGET_OS_STR, CPU_ARCH_STR, g_scm_tag_str);
@@ -5,6 +5,7 @@
 
 #include "util/host.h"
 
+#include "common/layered_settings_interface.h"
 #include "common/small_string.h"
 #include "common/types.h"
 
@@ -120,5 +121,8 @@ void SetGameSettingsLayer(SettingsInterface* sif, std::unique_lock<std::mutex>&
 
 /// Sets the input profile settings layer. Called by VMManager when the game changes.
 void SetInputSettingsLayer(SettingsInterface* sif, std::unique_lock<std::mutex>& lock);
+
+/// Returns the generations of all settings layers, for detecting changes. Must call with lock held.
+LayeredSettingsInterface::LayerGenerations GetSettingsLayerGenerations();
 } // namespace Internal
 } // namespace Host
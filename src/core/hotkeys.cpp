@@ -285,6 +285,31 @@ DEFINE_HOTKEY("TogglePatchCodes", TRANSLATE_NOOP("Hotkeys", "System"), TRANSLATE
               })
 #endif
 
+DEFINE_HOTKEY("ToggleMediaCapture", TRANSLATE_NOOP("Hotkeys", "System"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle Video Capture"), [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                {
+                  if (System::GetMediaCapture())
+                    System::StopMediaCapture();
+                  else
+                    System::StartMediaCapture();
+                }
+              })
+
+DEFINE_HOTKEY("ToggleCPUTraceBuffer", TRANSLATE_NOOP("Hotkeys", "System"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle CPU Trace Buffer"), [](s32 pressed) {
+                if (!pressed)
+                  System::ToggleCPUTraceBuffer();
+              })
+
+#ifdef ENABLE_TRACING
+DEFINE_HOTKEY("ToggleTraceCapture", TRANSLATE_NOOP("Hotkeys", "System"),
+              TRANSLATE_NOOP("Hotkeys", "Toggle Trace Capture"), [](s32 pressed) {
+                if (!pressed)
+                  System::ToggleTraceCapture();
+              })
+#endif
+
 DEFINE_HOTKEY("ToggleOverclocking", TRANSLATE_NOOP("Hotkeys", "System"),
               TRANSLATE_NOOP("Hotkeys", "Toggle Clock Speed Control (Overclocking)"), [](s32 pressed) {
                 if (!pressed && System::IsValid())
@@ -4,6 +4,7 @@
 #define IMGUI_DEFINE_MATH_OPERATORS
 
 #include "imgui_overlays.h"
+#include "achievements.h"
 #include "cdrom.h"
 #include "controller.h"
 #include "dma.h"
@@ -15,6 +16,7 @@
 #include "settings.h"
 #include "spu.h"
 #include "system.h"
+#include "texture_replacements.h"
 
 #include "util/audio_stream.h"
 #include "util/gpu_device.h"
@@ -30,6 +32,7 @@
 #include "common/file_system.h"
 #include "common/intrin.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/thirdparty/SmallVector.h"
@@ -41,6 +44,7 @@
 #include "imgui.h"
 #include "imgui_internal.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cmath>
@@ -54,8 +58,46 @@ Log_SetChannel(ImGuiManager);
 namespace ImGuiManager {
 static void FormatProcessorStat(SmallStringBase& text, double usage, double time);
 static void DrawPerformanceOverlay();
+static float BuildPerformanceOverlay(ImDrawList* dl);
+static void AppendCachedDrawList(ImDrawList* dst, const ImDrawList& src);
 static void DrawEnhancementsOverlay();
 static void DrawInputsOverlay();
+static void DrawMemoryStateWindow();
+
+namespace {
+/// Everything which changes the layout of the performance overlay, rather than just the numbers in it.
+struct PerformanceOverlayKey
+{
+  ImTextureID font_texture;
+  float display_width;
+  float display_height;
+  float scale;
+  System::State state;
+  bool show_fps;
+  bool show_speed;
+  bool show_gpu_stats;
+  bool show_resolution;
+  bool show_cpu_usage;
+  bool show_latency_stats;
+  bool show_status_indicators;
+  bool fast_forward;
+  bool turbo;
+  bool rewinding;
+  bool fullscreen_ui_active;
+
+  bool operator==(const PerformanceOverlayKey& rhs) const = default;
+};
+} // namespace
+
+// The counters only change once per second, so formatting and laying out the text every frame is wasted time on
+// the CPU thread, which is the time that the overlay reports. Lines are built into a private draw list instead, and
+// its vertices copied to the background list each frame.
+static constexpr float PERFORMANCE_OVERLAY_REFRESH_INTERVAL = 0.25f;
+static ImDrawList s_performance_overlay_draw_list(nullptr);
+static PerformanceOverlayKey s_performance_overlay_key = {};
+static Common::Timer::Value s_performance_overlay_build_time = 0;
+static float s_performance_overlay_height = 0.0f;
+static bool s_performance_overlay_valid = false;
 } // namespace ImGuiManager
 
 static std::tuple<float, float> GetMinMax(std::span<const float> values)
@@ -230,6 +272,9 @@ void ImGuiManager::RenderDebugWindows()
     if (g_settings.debugging.show_dma_state)
       DMA::DrawDebugStateWindow();
   }
+
+  if (g_settings.debugging.show_memory_state)
+    DrawMemoryStateWindow();
 }
 
 void ImGuiManager::RenderTextOverlays()
@@ -258,6 +303,25 @@ void ImGuiManager::FormatProcessorStat(SmallStringBase& text, double usage, doub
     text.append_format("{:.1f}% ({:.2f}ms)", usage, time);
 }
 
+void ImGuiManager::AppendCachedDrawList(ImDrawList* dst, const ImDrawList& src)
+{
+  // Everything in the overlay is drawn with the font atlas, and without clipping, so one command covers it.
+  if (src.IdxBuffer.empty())
+    return;
+
+  dst->PrimReserve(src.IdxBuffer.Size, src.VtxBuffer.Size);
+
+  // Read after reserving, since it's reset if a new vertex offset had to be started.
+  const ImDrawIdx base_vertex = static_cast<ImDrawIdx>(dst->_VtxCurrentIdx);
+  std::memcpy(dst->_VtxWritePtr, src.VtxBuffer.Data, src.VtxBuffer.size_in_bytes());
+  for (int i = 0; i < src.IdxBuffer.Size; i++)
+    dst->_IdxWritePtr[i] = static_cast<ImDrawIdx>(src.IdxBuffer.Data[i] + base_vertex);
+
+  dst->_VtxWritePtr += src.VtxBuffer.Size;
+  dst->_IdxWritePtr += src.IdxBuffer.Size;
+  dst->_VtxCurrentIdx += static_cast<unsigned int>(src.VtxBuffer.Size);
+}
+
 void ImGuiManager::DrawPerformanceOverlay()
 {
   if (!(g_settings.display_show_fps || g_settings.display_show_speed || g_settings.display_show_gpu_stats ||
@@ -265,9 +329,138 @@ void ImGuiManager::DrawPerformanceOverlay()
         (g_settings.display_show_status_indicators &&
          (System::IsPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
   {
+    s_performance_overlay_valid = false;
     return;
   }
 
+  const ImGuiIO& io = ImGui::GetIO();
+  const System::State state = System::GetState();
+  const float scale = ImGuiManager::GetGlobalScale();
+  const PerformanceOverlayKey key = {
+    .font_texture = io.Fonts->TexID,
+    .display_width = io.DisplaySize.x,
+    .display_height = io.DisplaySize.y,
+    .scale = scale,
+    .state = state,
+    .show_fps = g_settings.display_show_fps,
+    .show_speed = g_settings.display_show_speed,
+    .show_gpu_stats = g_settings.display_show_gpu_stats,
+    .show_resolution = g_settings.display_show_resolution,
+    .show_cpu_usage = g_settings.display_show_cpu_usage,
+    .show_latency_stats = g_settings.display_show_latency_stats,
+    .show_status_indicators = g_settings.display_show_status_indicators,
+    .fast_forward = System::IsFastForwardEnabled(),
+    .turbo = System::IsTurboEnabled(),
+    .rewinding = System::IsRewinding(),
+    .fullscreen_ui_active = FullscreenUI::HasActiveWindow(),
+  };
+
+  const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+  if (!s_performance_overlay_valid || key != s_performance_overlay_key ||
+      Common::Timer::ConvertValueToSeconds(current_time - s_performance_overlay_build_time) >=
+        PERFORMANCE_OVERLAY_REFRESH_INTERVAL)
+  {
+    ImDrawList* bg_dl = ImGui::GetBackgroundDrawList();
+    ImDrawList* cached_dl = &s_performance_overlay_draw_list;
+
+    // Shared data belongs to the context, which can be recreated along with the device.
+    cached_dl->_Data = ImGui::GetDrawListSharedData();
+    cached_dl->_ResetForNewFrame();
+    cached_dl->Flags = bg_dl->Flags;
+    cached_dl->PushTextureID(io.Fonts->TexID);
+    cached_dl->PushClipRectFullScreen();
+    s_performance_overlay_height = BuildPerformanceOverlay(cached_dl);
+    cached_dl->PopClipRect();
+    cached_dl->PopTextureID();
+
+    s_performance_overlay_key = key;
+    s_performance_overlay_build_time = current_time;
+    s_performance_overlay_valid = true;
+  }
+
+  AppendCachedDrawList(ImGui::GetBackgroundDrawList(), s_performance_overlay_draw_list);
+
+  // The frame time graph changes every frame, so it's always drawn live.
+  if (state == System::State::Running && g_settings.display_show_frame_times)
+  {
+    const float shadow_offset = std::ceil(1.0f * scale);
+    const float margin = std::ceil(10.0f * scale);
+    const float spacing = std::ceil(5.0f * scale);
+    const float position_y = s_performance_overlay_height;
+    ImFont* fixed_font = ImGuiManager::GetFixedFont();
+    SmallString text;
+    ImVec2 text_size;
+
+    const ImVec2 history_size(200.0f * scale, 50.0f * scale);
+    ImGui::SetNextWindowSize(ImVec2(history_size.x, history_size.y));
+    ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - margin - history_size.x, position_y));
+    ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.25f));
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
+    ImGui::PushStyleColor(ImGuiCol_PlotLines, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0.0f, 0.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 0.0f);
+    if (ImGui::Begin("##frame_times", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs))
+    {
+      ImGui::PushFont(fixed_font);
+
+      auto [min, max] = GetMinMax(System::GetFrameTimeHistory());
+
+      // add a little bit of space either side, so we're not constantly resizing
+      if ((max - min) < 4.0f)
+      {
+        min = min - std::fmod(min, 1.0f);
+        max = max - std::fmod(max, 1.0f) + 1.0f;
+        min = std::max(min - 2.0f, 0.0f);
+        max += 2.0f;
+      }
+
+      ImGui::PlotEx(
+        ImGuiPlotType_Lines, "##frame_times",
+        [](void*, int idx) -> float {
+          return System::GetFrameTimeHistory()[((System::GetFrameTimeHistoryPos() + idx) %
+                                                System::NUM_FRAME_TIME_SAMPLES)];
+        },
+        nullptr, System::NUM_FRAME_TIME_SAMPLES, 0, nullptr, min, max, history_size);
+
+      ImDrawList* win_dl = ImGui::GetCurrentWindow()->DrawList;
+      const ImVec2 wpos(ImGui::GetCurrentWindow()->Pos);
+
+      text.format("{:.1f} ms", max);
+      text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.c_str(), text.end_ptr());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset, wpos.y + shadow_offset),
+                      IM_COL32(0, 0, 0, 100), text.c_str(), text.end_ptr());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y), IM_COL32(255, 255, 255, 255),
+                      text.c_str(), text.end_ptr());
+
+      text.format("{:.1f} ms", min);
+      text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.c_str(), text.end_ptr());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset,
+                             wpos.y + history_size.y - fixed_font->FontSize + shadow_offset),
+                      IM_COL32(0, 0, 0, 100), text.c_str(), text.end_ptr());
+      win_dl->AddText(
+        ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y + history_size.y - fixed_font->FontSize),
+        IM_COL32(255, 255, 255, 255), text.c_str(), text.end_ptr());
+
+      // How far off the throttler's wakeups were, which is what makes pacing uneven even when the average is right.
+      text.format("~{:.2f} ms", System::GetFramePacingJitter());
+      win_dl->AddText(ImVec2(wpos.x + spacing + shadow_offset,
+                             wpos.y + history_size.y - fixed_font->FontSize + shadow_offset),
+                      IM_COL32(0, 0, 0, 100), text.c_str(), text.end_ptr());
+      win_dl->AddText(ImVec2(wpos.x + spacing, wpos.y + history_size.y - fixed_font->FontSize),
+                      IM_COL32(255, 255, 255, 255), text.c_str(), text.end_ptr());
+      ImGui::PopFont();
+    }
+    ImGui::End();
+    ImGui::PopStyleVar(5);
+    ImGui::PopStyleColor(3);
+  }
+}
+
+float ImGuiManager::BuildPerformanceOverlay(ImDrawList* dl)
+{
   const float scale = ImGuiManager::GetGlobalScale();
   const float shadow_offset = std::ceil(1.0f * scale);
   const float margin = std::ceil(10.0f * scale);
@@ -276,7 +469,6 @@ void ImGuiManager::DrawPerformanceOverlay()
   ImFont* standard_font = ImGuiManager::GetStandardFont();
   float position_y = margin;
 
-  ImDrawList* dl = ImGui::GetBackgroundDrawList();
   SmallString text;
   ImVec2 text_size;
   bool first = true;
@@ -336,6 +528,12 @@ void ImGuiManager::DrawPerformanceOverlay()
 
       g_gpu->GetMemoryStatsString(text);
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      if (g_settings.texture_replacements.AnyReplacementsEnabled())
+      {
+        g_texture_replacements.GetCacheStatsString(text);
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
     }
 
     if (g_settings.display_show_resolution)
@@ -353,6 +551,35 @@ void ImGuiManager::DrawPerformanceOverlay()
     {
       System::FormatLatencyStats(text);
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      System::InputLatencyStats latency;
+      System::GetInputLatencyStats(&latency);
+      if (latency.num_samples > 0)
+      {
+        text.format("Input: {:.1f}ms [{:.1f}-{:.1f}ms] | L: {:.1f} | F: {:.1f} | S: {:.1f}", latency.average.present,
+                    latency.minimum, latency.maximum, latency.average.latch, latency.average.frame_done,
+                    latency.average.submit);
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+        // histogram of total latency, bucket width is INPUT_LATENCY_HISTOGRAM_BUCKET_MS
+        const float bar_width = std::ceil(4.0f * scale);
+        const float bar_height = std::ceil(30.0f * scale);
+        const u32 max_count = *std::max_element(latency.histogram.begin(), latency.histogram.end());
+        const float right = ImGui::GetIO().DisplaySize.x - margin;
+        const float left = right - bar_width * static_cast<float>(System::NUM_INPUT_LATENCY_HISTOGRAM_BUCKETS);
+        dl->AddRectFilled(ImVec2(left, position_y), ImVec2(right, position_y + bar_height), IM_COL32(0, 0, 0, 64));
+        for (u32 i = 0; i < System::NUM_INPUT_LATENCY_HISTOGRAM_BUCKETS; i++)
+        {
+          if (latency.histogram[i] == 0)
+            continue;
+
+          const float x = left + bar_width * static_cast<float>(i);
+          const float height = bar_height * (static_cast<float>(latency.histogram[i]) / static_cast<float>(max_count));
+          dl->AddRectFilled(ImVec2(x, position_y + bar_height - height),
+                            ImVec2(x + bar_width - 1.0f, position_y + bar_height), IM_COL32(255, 255, 255, 255));
+        }
+        position_y += bar_height + spacing;
+      }
     }
 
     if (g_settings.display_show_cpu_usage)
@@ -416,6 +643,12 @@ void ImGuiManager::DrawPerformanceOverlay()
         FormatProcessorStat(text, System::GetSWThreadUsage(), System::GetSWThreadAverageTime());
         DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
       }
+
+      if (Achievements::HasActiveGame())
+      {
+        text.format("RA: {:.2f}ms", Achievements::GetAverageFrameUpdateTime());
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
     }
 
     if (g_settings.display_show_gpu_usage && g_gpu_device->IsGPUTimingEnabled())
@@ -423,6 +656,21 @@ void ImGuiManager::DrawPerformanceOverlay()
       text.assign("GPU: ");
       FormatProcessorStat(text, System::GetGPUUsage(), System::GetGPUAverageTime());
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      if (g_gpu_device->IsGPUTimingRegionsEnabled())
+      {
+        // Only the regions which take a noticeable amount of time, to keep the line short.
+        text.clear();
+        for (u32 i = 0; i < static_cast<u32>(GPUTimingRegion::Count); i++)
+        {
+          const GPUTimingRegion region = static_cast<GPUTimingRegion>(i);
+          const float time = System::GetGPUTimingRegionAverageTime(region);
+          if (time >= 0.01f)
+            text.append_format("{}{}: {:.2f}ms", text.empty() ? "" : " | ", GPU::GetTimingRegionName(region), time);
+        }
+        if (!text.empty())
+          DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
     }
 
     if (g_settings.display_show_status_indicators)
@@ -434,67 +682,6 @@ void ImGuiManager::DrawPerformanceOverlay()
         DRAW_LINE(standard_font, text, IM_COL32(255, 255, 255, 255));
       }
     }
-
-    if (g_settings.display_show_frame_times)
-    {
-      const ImVec2 history_size(200.0f * scale, 50.0f * scale);
-      ImGui::SetNextWindowSize(ImVec2(history_size.x, history_size.y));
-      ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - margin - history_size.x, position_y));
-      ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.25f));
-      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
-      ImGui::PushStyleColor(ImGuiCol_PlotLines, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
-      ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0.0f, 0.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 0.0f);
-      if (ImGui::Begin("##frame_times", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs))
-      {
-        ImGui::PushFont(fixed_font);
-
-        auto [min, max] = GetMinMax(System::GetFrameTimeHistory());
-
-        // add a little bit of space either side, so we're not constantly resizing
-        if ((max - min) < 4.0f)
-        {
-          min = min - std::fmod(min, 1.0f);
-          max = max - std::fmod(max, 1.0f) + 1.0f;
-          min = std::max(min - 2.0f, 0.0f);
-          max += 2.0f;
-        }
-
-        ImGui::PlotEx(
-          ImGuiPlotType_Lines, "##frame_times",
-          [](void*, int idx) -> float {
-            return System::GetFrameTimeHistory()[((System::GetFrameTimeHistoryPos() + idx) %
-                                                  System::NUM_FRAME_TIME_SAMPLES)];
-          },
-          nullptr, System::NUM_FRAME_TIME_SAMPLES, 0, nullptr, min, max, history_size);
-
-        ImDrawList* win_dl = ImGui::GetCurrentWindow()->DrawList;
-        const ImVec2 wpos(ImGui::GetCurrentWindow()->Pos);
-
-        text.format("{:.1f} ms", max);
-        text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.c_str(), text.end_ptr());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset, wpos.y + shadow_offset),
-                        IM_COL32(0, 0, 0, 100), text.c_str(), text.end_ptr());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y), IM_COL32(255, 255, 255, 255),
-                        text.c_str(), text.end_ptr());
-
-        text.format("{:.1f} ms", min);
-        text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.c_str(), text.end_ptr());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset,
-                               wpos.y + history_size.y - fixed_font->FontSize + shadow_offset),
-                        IM_COL32(0, 0, 0, 100), text.c_str(), text.end_ptr());
-        win_dl->AddText(
-          ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y + history_size.y - fixed_font->FontSize),
-          IM_COL32(255, 255, 255, 255), text.c_str(), text.end_ptr());
-        ImGui::PopFont();
-      }
-      ImGui::End();
-      ImGui::PopStyleVar(5);
-      ImGui::PopStyleColor(3);
-    }
   }
   else if (g_settings.display_show_status_indicators && state == System::State::Paused &&
            !FullscreenUI::HasActiveWindow())
@@ -504,6 +691,8 @@ void ImGuiManager::DrawPerformanceOverlay()
   }
 
 #undef DRAW_LINE
+
+  return position_y;
 }
 
 void ImGuiManager::DrawEnhancementsOverlay()
@@ -514,7 +703,11 @@ void ImGuiManager::DrawEnhancementsOverlay()
                      g_gpu->IsHardwareRenderer() ? "HW" : "SW");
 
   if (g_settings.rewind_enable)
+  {
     text.append_format(" RW={}/{}", g_settings.rewind_save_frequency, g_settings.rewind_save_slots);
+    if (const u64 rewind_memory_per_second = System::GetRewindMemoryPerSecond(); rewind_memory_per_second > 0)
+      text.append_format(" ({:.1f}KB/s)", static_cast<double>(rewind_memory_per_second) / 1024.0);
+  }
   if (g_settings.IsRunaheadEnabled())
     text.append_format(" RA={}", g_settings.runahead_frames);
 
@@ -589,6 +782,60 @@ void ImGuiManager::DrawEnhancementsOverlay()
               IM_COL32(255, 255, 255, 255), text.c_str(), text.end_ptr());
 }
 
+void ImGuiManager::DrawMemoryStateWindow()
+{
+  static constexpr float MB = 1048576.0f;
+
+  const float framebuffer_scale = Host::GetOSDScale();
+
+  ImGui::SetNextWindowSize(ImVec2(400.0f * framebuffer_scale, 300.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Memory State", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
+
+  ImGui::Columns(3);
+  ImGui::SetColumnWidth(0, 200.0f * framebuffer_scale);
+  ImGui::SetColumnWidth(1, 100.0f * framebuffer_scale);
+  ImGui::SetColumnWidth(2, 100.0f * framebuffer_scale);
+
+  for (const char* title : {"Category", "Host", "GPU"})
+  {
+    ImGui::TextUnformatted(title);
+    ImGui::NextColumn();
+  }
+
+  const ImVec4 active(1.0f, 1.0f, 1.0f, 1.0f);
+  const ImVec4 inactive(0.5f, 0.5f, 0.5f, 1.0f);
+
+  for (u32 i = 0; i < static_cast<u32>(MemoryAccounting::Category::Count); i++)
+  {
+    const MemoryAccounting::Category category = static_cast<MemoryAccounting::Category>(i);
+    const size_t host_bytes = MemoryAccounting::GetHostBytes(category);
+    const size_t gpu_bytes = MemoryAccounting::GetGPUBytes(category);
+
+    ImGui::TextColored((host_bytes != 0 || gpu_bytes != 0) ? active : inactive, "%s",
+                       MemoryAccounting::GetCategoryName(category));
+    ImGui::NextColumn();
+    ImGui::TextColored((host_bytes != 0) ? active : inactive, "%.2f MB", static_cast<float>(host_bytes) / MB);
+    ImGui::NextColumn();
+    ImGui::TextColored((gpu_bytes != 0) ? active : inactive, "%.2f MB", static_cast<float>(gpu_bytes) / MB);
+    ImGui::NextColumn();
+  }
+
+  ImGui::Separator();
+  ImGui::TextUnformatted("Total");
+  ImGui::NextColumn();
+  ImGui::Text("%.2f MB", static_cast<float>(MemoryAccounting::GetTotalHostBytes()) / MB);
+  ImGui::NextColumn();
+  ImGui::Text("%.2f MB", static_cast<float>(MemoryAccounting::GetTotalGPUBytes()) / MB);
+  ImGui::NextColumn();
+
+  ImGui::Columns(1);
+  ImGui::End();
+}
+
 void ImGuiManager::DrawInputsOverlay()
 {
   const float scale = ImGuiManager::GetGlobalScale();
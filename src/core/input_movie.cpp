@@ -0,0 +1,417 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "input_movie.h"
+#include "achievements.h"
+#include "bios.h"
+#include "bus.h"
+#include "controller.h"
+#include "gpu.h"
+#include "host.h"
+#include "settings.h"
+#include "system.h"
+
+#include "util/imgui_manager.h"
+
+#include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/string_util.h"
+
+#include "IconsFontAwesome5.h"
+#include "xxhash.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+Log_SetChannel(InputMovie);
+
+namespace InputMovie {
+namespace {
+enum class State : u8
+{
+  Inactive,
+  Recording,
+  Playing,
+};
+
+#pragma pack(push, 4)
+struct Header
+{
+  static constexpr u32 MAGIC = 0x564D5344; // DSMV
+  static constexpr u32 VERSION = 1;
+
+  u32 magic;
+  u32 version;
+  u32 checksum_interval;
+  u32 reserved;
+  char serial[32];
+  BIOS::Hash bios_hash;
+  std::array<ControllerType, NUM_CONTROLLER_AND_CARD_PORTS> controller_types;
+};
+#pragma pack(pop)
+
+struct BindEvent
+{
+  u8 pad;
+  u16 bind_index;
+  float value;
+};
+} // namespace
+
+static constexpr int COMPRESSION_LEVEL = 3;
+static constexpr u32 CHECKSUM_INTERVAL = 1;
+
+static void ResetControllers();
+static void ApplyEvents();
+static u64 GetRAMChecksum();
+static u64 GetVRAMChecksum();
+static bool WriteFrame();
+static bool ReadFrame(bool* end_of_movie);
+static bool BeginMovie(const char* path, Error* error);
+
+static State s_state = State::Inactive;
+static std::string s_path;
+static std::unique_ptr<ByteStream> s_file_stream;
+static std::unique_ptr<ByteStream> s_stream;
+static u32 s_checksum_interval = CHECKSUM_INTERVAL;
+static u32 s_frame_number = 0;
+static std::optional<u32> s_desync_frame;
+static std::vector<BindEvent> s_events;
+
+} // namespace InputMovie
+
+bool InputMovie::IsActive()
+{
+  return (s_state != State::Inactive);
+}
+
+bool InputMovie::IsRecording()
+{
+  return (s_state == State::Recording);
+}
+
+bool InputMovie::IsPlaying()
+{
+  return (s_state == State::Playing);
+}
+
+u32 InputMovie::GetFrameNumber()
+{
+  return s_frame_number;
+}
+
+std::optional<u32> InputMovie::GetDesyncFrame()
+{
+  return s_desync_frame;
+}
+
+bool InputMovie::BeginMovie(const char* path, Error* error)
+{
+  if (!System::IsValid())
+  {
+    Error::SetStringView(error, "System is not running.");
+    return false;
+  }
+
+  // runahead and rewind load states behind our back, and achievements can refuse the reset
+  if (g_settings.runahead_frames > 0 || g_settings.rewind_enable)
+  {
+    Error::SetStringView(error, "Runahead and rewind must be disabled to use input movies.");
+    return false;
+  }
+  if (Achievements::IsHardcoreModeActive())
+  {
+    Error::SetStringView(error, "Input movies can't be used in hardcore mode.");
+    return false;
+  }
+
+  Stop();
+
+  s_path = path;
+  s_frame_number = 0;
+  s_desync_frame.reset();
+  s_events.clear();
+
+  System::ResetSystem();
+  ResetControllers();
+  return true;
+}
+
+bool InputMovie::StartRecording(const char* path, Error* error)
+{
+  if (!BeginMovie(path, error))
+    return false;
+
+  s_file_stream = ByteStream::OpenFile(path,
+                                       BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                         BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED,
+                                       error);
+  if (!s_file_stream)
+    return false;
+
+  Header header = {};
+  header.magic = Header::MAGIC;
+  header.version = Header::VERSION;
+  header.checksum_interval = CHECKSUM_INTERVAL;
+  StringUtil::Strlcpy(header.serial, System::GetGameSerial().c_str(), sizeof(header.serial));
+  header.bios_hash = System::GetBIOSHash();
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = System::GetController(i);
+    header.controller_types[i] = controller ? controller->GetType() : ControllerType::None;
+  }
+
+  if (!s_file_stream->Write2(&header, sizeof(header)))
+  {
+    Error::SetStringView(error, "Failed to write header.");
+    s_file_stream->Discard();
+    s_file_stream.reset();
+    return false;
+  }
+
+  s_stream = ByteStream::CreateZstdCompressStream(s_file_stream.get(), COMPRESSION_LEVEL);
+  s_checksum_interval = CHECKSUM_INTERVAL;
+  s_state = State::Recording;
+
+  Log_InfoFmt("Recording input movie to '{}'.", path);
+  Host::AddIconOSDMessage("input_movie", ICON_FA_VIDEO, TRANSLATE_STR("InputMovie", "Recording input movie."),
+                          Host::OSD_INFO_DURATION);
+  return true;
+}
+
+bool InputMovie::StartPlayback(const char* path, Error* error)
+{
+  std::unique_ptr<ByteStream> file_stream =
+    ByteStream::OpenFile(path, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED, error);
+  if (!file_stream)
+    return false;
+
+  Header header;
+  if (!file_stream->Read2(&header, sizeof(header)) || header.magic != Header::MAGIC)
+  {
+    Error::SetStringView(error, "File is not an input movie.");
+    return false;
+  }
+  if (header.version != Header::VERSION)
+  {
+    Error::SetStringFmt(error, "Unsupported input movie version {}.", header.version);
+    return false;
+  }
+
+  header.serial[sizeof(header.serial) - 1] = 0;
+  if (System::GetGameSerial() != header.serial)
+  {
+    Error::SetStringFmt(error, "Movie was recorded with '{}', but '{}' is running.", header.serial,
+                        System::GetGameSerial());
+    return false;
+  }
+  if (System::GetBIOSHash() != header.bios_hash)
+    Log_WarningFmt("Movie '{}' was recorded with a different BIOS, it will probably desync.", path);
+
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = System::GetController(i);
+    const ControllerType type = controller ? controller->GetType() : ControllerType::None;
+    if (type != header.controller_types[i])
+    {
+      Error::SetStringFmt(error, "Controller in port {} does not match the movie.", i + 1);
+      return false;
+    }
+  }
+
+  if (!BeginMovie(path, error))
+    return false;
+
+  const u32 compressed_size = static_cast<u32>(file_stream->GetSize() - sizeof(header));
+  s_file_stream = std::move(file_stream);
+  s_stream = ByteStream::CreateZstdDecompressStream(s_file_stream.get(), compressed_size);
+  s_checksum_interval = std::max(header.checksum_interval, 1u);
+  s_state = State::Playing;
+
+  Log_InfoFmt("Playing back input movie '{}'.", path);
+  Host::AddIconOSDMessage("input_movie", ICON_FA_VIDEO, TRANSLATE_STR("InputMovie", "Playing back input movie."),
+                          Host::OSD_INFO_DURATION);
+  return true;
+}
+
+void InputMovie::Stop()
+{
+  if (s_state == State::Inactive)
+    return;
+
+  // compressor has to flush before the file is committed
+  const bool was_recording = (s_state == State::Recording);
+  s_stream.reset();
+  if (was_recording && !s_file_stream->Commit())
+    Log_ErrorFmt("Failed to commit input movie '{}'.", s_path);
+  s_file_stream.reset();
+  s_events.clear();
+  s_state = State::Inactive;
+
+  Log_InfoFmt("Input movie {} after {} frames.", was_recording ? "recording stopped" : "playback stopped",
+              s_frame_number);
+  Host::AddIconOSDMessage("input_movie", ICON_FA_VIDEO,
+                          fmt::format(was_recording ? TRANSLATE_FS("InputMovie", "Recorded {} frames of input.") :
+                                                      TRANSLATE_FS("InputMovie", "Played back {} frames of input."),
+                                      s_frame_number),
+                          Host::OSD_INFO_DURATION);
+}
+
+bool InputMovie::InterceptBindState(u32 pad, u32 bind_index, float value)
+{
+  if (s_state == State::Inactive)
+    return false;
+
+  // host input is ignored during playback
+  if (s_state == State::Recording)
+    s_events.push_back(BindEvent{static_cast<u8>(pad), static_cast<u16>(bind_index), value});
+
+  return true;
+}
+
+void InputMovie::OnFrameDone()
+{
+  if (s_state == State::Recording)
+  {
+    if (!WriteFrame())
+    {
+      Log_ErrorFmt("Failed to write frame {} to input movie.", s_frame_number);
+      Stop();
+      return;
+    }
+
+    ApplyEvents();
+    s_events.clear();
+    s_frame_number++;
+  }
+  else if (s_state == State::Playing)
+  {
+    bool end_of_movie = false;
+    if (!ReadFrame(&end_of_movie))
+    {
+      if (end_of_movie)
+        Log_InfoFmt("Reached end of input movie after {} frames.", s_frame_number);
+      Stop();
+      return;
+    }
+
+    ApplyEvents();
+    s_events.clear();
+    s_frame_number++;
+  }
+}
+
+void InputMovie::ResetControllers()
+{
+  // whatever the host was holding when the movie started shouldn't leak into it
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    Controller* controller = System::GetController(i);
+    if (!controller)
+      continue;
+
+    const Controller::ControllerInfo* cinfo = Controller::GetControllerInfo(controller->GetType());
+    if (!cinfo)
+      continue;
+
+    for (const Controller::ControllerBindingInfo& bi : cinfo->bindings)
+    {
+      if (bi.type == InputBindingInfo::Type::Button || bi.type == InputBindingInfo::Type::HalfAxis)
+        controller->SetBindState(bi.bind_index, 0.0f);
+    }
+  }
+}
+
+void InputMovie::ApplyEvents()
+{
+  for (const BindEvent& ev : s_events)
+  {
+    if (Controller* controller = System::GetController(ev.pad))
+      controller->SetBindState(ev.bind_index, ev.value);
+  }
+}
+
+u64 InputMovie::GetRAMChecksum()
+{
+  return XXH3_64bits(Bus::g_ram, Bus::g_ram_size);
+}
+
+u64 InputMovie::GetVRAMChecksum()
+{
+  // hardware renderers only write back VRAM on demand, so the copy here isn't authoritative
+  return g_gpu->IsHardwareRenderer() ? 0 : XXH3_64bits(g_vram, sizeof(g_vram));
+}
+
+bool InputMovie::WriteFrame()
+{
+  bool result = s_stream->WriteU16(static_cast<u16>(s_events.size()));
+  for (const BindEvent& ev : s_events)
+  {
+    result &= s_stream->WriteU8(ev.pad);
+    result &= s_stream->WriteU16(ev.bind_index);
+    result &= s_stream->Write2(&ev.value, sizeof(ev.value));
+  }
+
+  if ((s_frame_number % s_checksum_interval) == 0)
+  {
+    result &= s_stream->WriteU64(GetRAMChecksum());
+    result &= s_stream->WriteU64(GetVRAMChecksum());
+  }
+
+  return result;
+}
+
+bool InputMovie::ReadFrame(bool* end_of_movie)
+{
+  u16 num_events;
+  if (!s_stream->ReadU16(&num_events))
+  {
+    *end_of_movie = true;
+    return false;
+  }
+
+  s_events.resize(num_events);
+  bool result = true;
+  for (BindEvent& ev : s_events)
+  {
+    result &= s_stream->ReadU8(&ev.pad);
+    result &= s_stream->ReadU16(&ev.bind_index);
+    result &= s_stream->Read2(&ev.value, sizeof(ev.value));
+  }
+
+  // checksums are of the state at the end of the frame, before its input is applied
+  if ((s_frame_number % s_checksum_interval) == 0)
+  {
+    u64 ram_checksum, vram_checksum;
+    result &= s_stream->ReadU64(&ram_checksum);
+    result &= s_stream->ReadU64(&vram_checksum);
+    if (!result)
+    {
+      Log_ErrorFmt("Input movie is truncated at frame {}.", s_frame_number);
+      return false;
+    }
+
+    const u64 current_vram_checksum = (vram_checksum != 0) ? GetVRAMChecksum() : 0;
+    if (ram_checksum != GetRAMChecksum() || (current_vram_checksum != 0 && vram_checksum != current_vram_checksum))
+    {
+      Log_ErrorFmt("Input movie desynced at frame {}.", s_frame_number);
+      Host::AddIconOSDMessage(
+        "input_movie", ICON_FA_VIDEO,
+        fmt::format(TRANSLATE_FS("InputMovie", "Input movie desynced at frame {}."), s_frame_number),
+        Host::OSD_ERROR_DURATION);
+      s_desync_frame = s_frame_number;
+      return false;
+    }
+  }
+
+  if (!result)
+    Log_ErrorFmt("Input movie is truncated at frame {}.", s_frame_number);
+
+  return result;
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <optional>
+
+class Error;
+
+/// Records and replays controller input, so that a run takes exactly the same path every time.
+/// Movies start from a system reset. While one is active, host input is only applied to the controllers at the end of
+/// each frame, which is the same point it is applied on playback. RAM (and VRAM with the software renderer) checksums
+/// are stored per-frame, so playback stops at the first frame which diverges.
+namespace InputMovie {
+
+bool IsActive();
+bool IsRecording();
+bool IsPlaying();
+
+/// Resets the system, and starts recording input to the specified file.
+bool StartRecording(const char* path, Error* error);
+
+/// Resets the system, and starts replaying input from the specified file.
+bool StartPlayback(const char* path, Error* error);
+
+/// Stops recording or playback. Recordings are finalized and written.
+void Stop();
+
+/// Returns the number of frames recorded or replayed so far.
+u32 GetFrameNumber();
+
+/// Returns the frame at which playback diverged from the recording, if it has.
+std::optional<u32> GetDesyncFrame();
+
+/// Called when the host changes a controller binding. Returns true if the movie has taken the input, in which case it
+/// should not be applied to the controller.
+bool InterceptBindState(u32 pad, u32 bind_index, float value);
+
+/// Called at the end of each frame, after host input has been polled.
+void OnFrameDone();
+
+} // namespace InputMovie
@@ -13,12 +13,18 @@
 
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
+#include "common/gsvector.h"
 #include "common/log.h"
+#include "common/threading.h"
 
 #include "imgui.h"
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 Log_SetChannel(MDEC);
 
@@ -30,6 +36,9 @@ static constexpr u32 DATA_OUT_FIFO_SIZE = 768;
 static constexpr u32 NUM_BLOCKS = 6;
 static constexpr TickCount TICKS_PER_BLOCK = 448;
 
+// How long to spin waiting for the worker before sleeping. Conversion of a macroblock only takes a few microseconds.
+static constexpr u32 WORKER_SPIN_ITERATIONS = 4096;
+
 enum DataOutputDepth : u8
 {
   DataOutputDepth_4Bit = 0,
@@ -109,16 +118,35 @@ static void HandleSetScaleCommand();
 
 static bool DecodeMonoMacroblock();
 static bool DecodeColoredMacroblock();
+static void ConvertMacroblock(bool colored);
 static void ScheduleBlockCopyOut(TickCount ticks);
 static void CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late);
 
 // from nocash spec
+namespace {
+struct MacroblockJob
+{
+  u32 first_block;
+  u32 num_blocks;
+  bool colored;
+  bool old_routines;
+  bool signed_output;
+};
+} // namespace
+
+static void ExecuteMacroblockJob(const MacroblockJob& job);
+static void TransformPendingBlocks();
+static void StartWorkerThread();
+static void StopWorkerThread();
+static void WaitForWorkerThread();
+static void WorkerThreadEntryPoint();
+
 static bool rl_decode_block(s16* blk, const u8* qt);
-static void IDCT(s16* blk);
+static void IDCT(s16* blk, bool old_routines);
 static void IDCT_New(s16* blk);
 static void IDCT_Old(s16* blk);
-static void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                       const std::array<s16, 64>& Yblk);
+static void yuv_to_rgb(u32 xx, u32 yy, bool signed_output, const std::array<s16, 64>& Crblk,
+                       const std::array<s16, 64>& Cbblk, const std::array<s16, 64>& Yblk);
 static void y_to_mono(const std::array<s16, 64>& Yblk);
 
 static StatusRegister s_status = {};
@@ -141,11 +169,21 @@ static std::array<std::array<s16, 64>, NUM_BLOCKS> s_blocks;
 static u32 s_current_block = 0;        // block (0-5)
 static u32 s_current_coefficient = 64; // k (in block)
 static u16 s_current_q_scale = 0;
+static u32 s_transformed_blocks = 0; // blocks which have been through the IDCT, <= s_current_block
 
 alignas(16) static std::array<u32, 256> s_block_rgb{};
 static std::unique_ptr<TimingEvent> s_block_copy_out_event;
 
 static u32 s_total_blocks_decoded = 0;
+
+// The worker owns s_blocks and s_block_rgb while busy, which is only between decoding finishing and the copy out.
+static std::thread s_worker_thread;
+static std::mutex s_worker_mutex;
+static std::condition_variable s_worker_cv;
+static std::condition_variable s_worker_done_cv;
+static MacroblockJob s_worker_job = {};
+static std::atomic_bool s_worker_busy{false};
+static bool s_worker_shutdown = false;
 } // namespace MDEC
 
 void MDEC::Initialize()
@@ -154,10 +192,14 @@ void MDEC::Initialize()
     TimingEvents::CreateTimingEvent("MDEC Block Copy Out", 1, 1, &MDEC::CopyOutBlock, nullptr, false);
   s_total_blocks_decoded = 0;
   Reset();
+
+  if (g_settings.mdec_use_thread)
+    StartWorkerThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopWorkerThread();
   s_block_copy_out_event.reset();
 }
 
@@ -169,6 +211,11 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  // Save states always hold transformed blocks, since they're loaded without the thread.
+  WaitForWorkerThread();
+  if (!sw.IsReading())
+    TransformPendingBlocks();
+
   sw.Do(&s_status.bits);
   sw.Do(&s_enable_dma_in);
   sw.Do(&s_enable_dma_out);
@@ -188,11 +235,30 @@ bool MDEC::DoState(StateWrapper& sw)
   bool block_copy_out_pending = HasPendingBlockCopyOut();
   sw.Do(&block_copy_out_pending);
   if (sw.IsReading())
+  {
     s_block_copy_out_event->SetState(block_copy_out_pending);
+    s_transformed_blocks = s_current_block;
+  }
 
   return !sw.HasError();
 }
 
+void MDEC::SetUseThread(bool enabled)
+{
+  if (s_worker_thread.joinable() == enabled)
+    return;
+
+  if (enabled)
+  {
+    StartWorkerThread();
+  }
+  else
+  {
+    StopWorkerThread();
+    TransformPendingBlocks();
+  }
+}
+
 u32 MDEC::ReadRegister(u32 offset)
 {
   switch (offset)
@@ -286,6 +352,7 @@ bool MDEC::HasPendingBlockCopyOut()
 
 void MDEC::SoftReset()
 {
+  WaitForWorkerThread();
   s_status.bits = 0;
   s_enable_dma_in = false;
   s_enable_dma_out = false;
@@ -296,6 +363,7 @@ void MDEC::SoftReset()
   s_current_block = 0;
   s_current_coefficient = 64;
   s_current_q_scale = 0;
+  s_transformed_blocks = 0;
   s_block_copy_out_event->Deactivate();
   UpdateStatus();
 }
@@ -305,6 +373,7 @@ void MDEC::ResetDecoder()
   s_current_block = 0;
   s_current_coefficient = 64;
   s_current_q_scale = 0;
+  s_transformed_blocks = 0;
 }
 
 void MDEC::UpdateStatus()
@@ -508,14 +577,12 @@ bool MDEC::DecodeMonoMacroblock()
   if (!rl_decode_block(s_blocks[0].data(), s_iq_y.data()))
     return false;
 
-  IDCT(s_blocks[0].data());
+  ConvertMacroblock(false);
 
   Log_DebugPrintf("Decoded mono macroblock, %u words remaining", s_remaining_halfwords / 2);
   ResetDecoder();
   s_state = State::WritingMacroblock;
 
-  y_to_mono(s_blocks[0]);
-
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
 
   s_total_blocks_decoded++;
@@ -529,7 +596,12 @@ bool MDEC::DecodeColoredMacroblock()
     if (!rl_decode_block(s_blocks[s_current_block].data(), (s_current_block >= 2) ? s_iq_y.data() : s_iq_uv.data()))
       return false;
 
-    IDCT(s_blocks[s_current_block].data());
+    // With the thread, the IDCT happens along with the colour conversion once the whole macroblock is here.
+    if (!s_worker_thread.joinable())
+    {
+      IDCT(s_blocks[s_current_block].data(), g_settings.use_old_mdec_routines);
+      s_transformed_blocks = s_current_block + 1;
+    }
   }
 
   if (!s_data_out_fifo.IsEmpty())
@@ -537,19 +609,119 @@ bool MDEC::DecodeColoredMacroblock()
 
   // done decoding
   Log_DebugPrintf("Decoded colored macroblock, %u words remaining", s_remaining_halfwords / 2);
+  ConvertMacroblock(true);
+
   ResetDecoder();
   s_state = State::WritingMacroblock;
-
-  yuv_to_rgb(0, 0, s_blocks[0], s_blocks[1], s_blocks[2]);
-  yuv_to_rgb(8, 0, s_blocks[0], s_blocks[1], s_blocks[3]);
-  yuv_to_rgb(0, 8, s_blocks[0], s_blocks[1], s_blocks[4]);
-  yuv_to_rgb(8, 8, s_blocks[0], s_blocks[1], s_blocks[5]);
   s_total_blocks_decoded += 4;
 
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
   return true;
 }
 
+void MDEC::ConvertMacroblock(bool colored)
+{
+  const MacroblockJob job = {s_transformed_blocks, colored ? NUM_BLOCKS : 1, colored,
+                             g_settings.use_old_mdec_routines, s_status.data_output_signed};
+
+  if (!s_worker_thread.joinable())
+  {
+    ExecuteMacroblockJob(job);
+    return;
+  }
+
+  {
+    std::unique_lock lock(s_worker_mutex);
+    s_worker_job = job;
+    s_worker_busy.store(true, std::memory_order_release);
+  }
+  s_worker_cv.notify_one();
+}
+
+void MDEC::ExecuteMacroblockJob(const MacroblockJob& job)
+{
+  for (u32 i = job.first_block; i < job.num_blocks; i++)
+    IDCT(s_blocks[i].data(), job.old_routines);
+
+  if (job.colored)
+  {
+    yuv_to_rgb(0, 0, job.signed_output, s_blocks[0], s_blocks[1], s_blocks[2]);
+    yuv_to_rgb(8, 0, job.signed_output, s_blocks[0], s_blocks[1], s_blocks[3]);
+    yuv_to_rgb(0, 8, job.signed_output, s_blocks[0], s_blocks[1], s_blocks[4]);
+    yuv_to_rgb(8, 8, job.signed_output, s_blocks[0], s_blocks[1], s_blocks[5]);
+  }
+  else
+  {
+    y_to_mono(s_blocks[0]);
+  }
+}
+
+void MDEC::TransformPendingBlocks()
+{
+  // Only colored macroblocks can be partially decoded, the mono block is transformed along with the conversion.
+  for (; s_transformed_blocks < s_current_block; s_transformed_blocks++)
+    IDCT(s_blocks[s_transformed_blocks].data(), g_settings.use_old_mdec_routines);
+}
+
+void MDEC::StartWorkerThread()
+{
+  DebugAssert(!s_worker_thread.joinable());
+  Log_DevPrint("Starting MDEC worker thread.");
+  s_worker_shutdown = false;
+  s_worker_thread = std::thread(&MDEC::WorkerThreadEntryPoint);
+}
+
+void MDEC::StopWorkerThread()
+{
+  if (!s_worker_thread.joinable())
+    return;
+
+  WaitForWorkerThread();
+  {
+    std::unique_lock lock(s_worker_mutex);
+    s_worker_shutdown = true;
+  }
+  s_worker_cv.notify_one();
+  s_worker_thread.join();
+  Log_DevPrint("MDEC worker thread stopped.");
+}
+
+void MDEC::WaitForWorkerThread()
+{
+  for (u32 i = 0; i < WORKER_SPIN_ITERATIONS; i++)
+  {
+    if (!s_worker_busy.load(std::memory_order_acquire))
+      return;
+
+    SpinPause();
+  }
+
+  std::unique_lock lock(s_worker_mutex);
+  s_worker_done_cv.wait(lock, []() { return !s_worker_busy.load(std::memory_order_acquire); });
+}
+
+void MDEC::WorkerThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("MDEC Worker");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Worker);
+
+  std::unique_lock lock(s_worker_mutex);
+  for (;;)
+  {
+    s_worker_cv.wait(lock, []() { return (s_worker_shutdown || s_worker_busy.load(std::memory_order_acquire)); });
+    if (s_worker_shutdown)
+      break;
+
+    const MacroblockJob job = s_worker_job;
+    lock.unlock();
+    ExecuteMacroblockJob(job);
+    lock.lock();
+
+    s_worker_busy.store(false, std::memory_order_release);
+    s_worker_done_cv.notify_one();
+  }
+}
+
 void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 {
   DebugAssert(!HasPendingBlockCopyOut());
@@ -561,6 +733,7 @@ void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 {
   Assert(s_state == State::WritingMacroblock);
+  WaitForWorkerThread();
   s_block_copy_out_event->Deactivate();
 
   switch (s_status.data_output_depth)
@@ -770,10 +943,10 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
   return false;
 }
 
-void MDEC::IDCT(s16* blk)
+void MDEC::IDCT(s16* blk, bool old_routines)
 {
   // people have made texture packs using the old conversion routines.. best to just leave them be.
-  if (g_settings.use_old_mdec_routines) [[unlikely]]
+  if (old_routines) [[unlikely]]
     IDCT_Old(blk);
   else
     IDCT_New(blk);
@@ -781,6 +954,56 @@ void MDEC::IDCT(s16* blk)
 
 void MDEC::IDCT_New(s16* blk)
 {
+  // Coefficients are clamped to 11 bits, and the scale table divided by 8 is at most 13 bits, so each sum fits in
+  // 32 bits, and the first pass fits in 16 bits. That lets both passes use widening 16-bit multiply-adds.
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  GSVector4i scale_lo[4], scale_hi[4];
+  for (u32 i = 0; i < 4; i++)
+  {
+    // Division truncates towards zero.
+    const GSVector4i seven = GSVector4i::broadcast16(7);
+    GSVector4i s0 = GSVector4i::load<false>(&s_scale_table[i * 16]);
+    GSVector4i s1 = GSVector4i::load<false>(&s_scale_table[i * 16 + 8]);
+    s0 = s0.add16(s0.sra16<15>() & seven).sra16<3>();
+    s1 = s1.add16(s1.sra16<15>() & seven).sra16<3>();
+
+    // Interleave rows z and z+1, so each multiply-add covers two terms.
+    scale_lo[i] = s0.upl16(s1);
+    scale_hi[i] = s0.uph16(s1);
+  }
+
+  const auto pass = [&scale_lo, &scale_hi](const s16* in, s16* out, bool clamp) {
+    const GSVector4i bias = GSVector4i::broadcast32(0xfff);
+    const GSVector4i round_mask = GSVector4i::broadcast32(0x1fff);
+    for (u32 y = 0; y < 8; y++)
+    {
+      GSVector4i sum_lo = GSVector4i::zero();
+      GSVector4i sum_hi = GSVector4i::zero();
+      for (u32 i = 0; i < 4; i++)
+      {
+        const u32 z0 = ZeroExtend32(static_cast<u16>(in[y + i * 16]));
+        const u32 z1 = ZeroExtend32(static_cast<u16>(in[y + i * 16 + 8]));
+        const GSVector4i pair = GSVector4i::broadcast32(z0 | (z1 << 16));
+        sum_lo = sum_lo.add32(pair.madd_s16(scale_lo[i]));
+        sum_hi = sum_hi.add32(pair.madd_s16(scale_hi[i]));
+      }
+
+      sum_lo = sum_lo.add32(bias);
+      sum_hi = sum_hi.add32(bias);
+      sum_lo = sum_lo.add32(sum_lo.sra32<31>() & round_mask).sra32<13>();
+      sum_hi = sum_hi.add32(sum_hi.sra32<31>() & round_mask).sra32<13>();
+
+      GSVector4i res = sum_lo.ps32(sum_hi);
+      if (clamp)
+        res = res.min_i16(GSVector4i::broadcast16(127)).max_i16(GSVector4i::broadcast16(static_cast<u16>(-128)));
+      GSVector4i::store<false>(&out[y * 8], res);
+    }
+  };
+
+  alignas(VECTOR_ALIGNMENT) std::array<s16, 64> temp;
+  pass(blk, temp.data(), false);
+  pass(temp.data(), blk, true);
+#else
   std::array<s32, 64> temp;
   for (u32 x = 0; x < 8; x++)
   {
@@ -804,6 +1027,7 @@ void MDEC::IDCT_New(s16* blk)
       blk[x + y * 8] = static_cast<s16>(std::clamp<s32>((sum + 0xfff) / 0x2000, -128, 127));
     }
   }
+#endif
 }
 
 void MDEC::IDCT_Old(s16* blk)
@@ -833,10 +1057,55 @@ void MDEC::IDCT_Old(s16* blk)
   }
 }
 
-void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                      const std::array<s16, 64>& Yblk)
+void MDEC::yuv_to_rgb(u32 xx, u32 yy, bool signed_output, const std::array<s16, 64>& Crblk,
+                      const std::array<s16, 64>& Cbblk, const std::array<s16, 64>& Yblk)
 {
-  const s16 addval = s_status.data_output_signed ? 0 : 0x80;
+  const s16 addval = signed_output ? 0 : 0x80;
+
+  // Chroma is at most 8 bits after the IDCT, so everything except the float multiplies fits in 16-bit lanes. The
+  // multiplies and adds are kept separate, to round the same way as the scalar version.
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  const GSVector4i vaddval = GSVector4i::broadcast16(static_cast<u16>(addval));
+  const GSVector4i zero = GSVector4i::zero();
+  for (u32 y = 0; y < 8; y++)
+  {
+    // Each chroma sample covers two pixels.
+    const u32 c_offset = (xx / 2) + ((y + yy) / 2) * 8;
+    GSVector4i cr = GSVector4i::loadl(&Crblk[c_offset]);
+    GSVector4i cb = GSVector4i::loadl(&Cbblk[c_offset]);
+    cr = cr.upl16(cr);
+    cb = cb.upl16(cb);
+
+    const auto convert = [](const GSVector4i& cr32, const GSVector4i& cb32, GSVector4i* r, GSVector4i* g,
+                            GSVector4i* b) {
+      const GSVector4 fr = GSVector4::from_i32(cr32);
+      const GSVector4 fb = GSVector4::from_i32(cb32);
+      *g = (GSVector4::broadcast(-0.3437f) * fb + GSVector4::broadcast(-0.7143f) * fr).to_i32_trunc();
+      *r = (GSVector4::broadcast(1.402f) * fr).to_i32_trunc();
+      *b = (GSVector4::broadcast(1.772f) * fb).to_i32_trunc();
+    };
+
+    // Sign-extend to 32 bits by shifting down from the top half of each lane.
+    GSVector4i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    convert(cr.upl16(cr).sra32<16>(), cb.upl16(cb).sra32<16>(), &r_lo, &g_lo, &b_lo);
+    convert(cr.uph16(cr).sra32<16>(), cb.uph16(cb).sra32<16>(), &r_hi, &g_hi, &b_hi);
+
+    const GSVector4i luma = GSVector4i::load<false>(&Yblk[y * 8]);
+    const auto apply = [&luma, &vaddval](const GSVector4i& lo, const GSVector4i& hi) {
+      return luma.add16(lo.ps32(hi))
+        .min_i16(GSVector4i::broadcast16(127))
+        .max_i16(GSVector4i::broadcast16(static_cast<u16>(-128)))
+        .add16(vaddval);
+    };
+    const GSVector4i r = apply(r_lo, r_hi);
+    const GSVector4i g = apply(g_lo, g_hi);
+    const GSVector4i b = apply(b_lo, b_hi);
+
+    u32* out = &s_block_rgb[xx + ((y + yy) * 16)];
+    GSVector4i::store<false>(out, r.upl16(zero) | g.upl16(zero).sll32<8>() | b.upl16(zero).sll32<16>());
+    GSVector4i::store<false>(out + 4, r.uph16(zero) | g.uph16(zero).sll32<8>() | b.uph16(zero).sll32<16>());
+  }
+#else
   for (u32 y = 0; y < 8; y++)
   {
     for (u32 x = 0; x < 8; x++)
@@ -858,10 +1127,23 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
                                                 (ZeroExtend32(static_cast<u16>(B)) << 16);
     }
   }
+#endif
 }
 
 void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
 {
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  const GSVector4i zero = GSVector4i::zero();
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    GSVector4i v = GSVector4i::load<false>(&Yblk[i]);
+    v = v.sll16<6>().sra16<6>();
+    v = v.min_i16(GSVector4i::broadcast16(127)).max_i16(GSVector4i::broadcast16(static_cast<u16>(-128)));
+    v = v.add16(GSVector4i::broadcast16(128));
+    GSVector4i::store<false>(&s_block_rgb[i], v.upl16(zero));
+    GSVector4i::store<false>(&s_block_rgb[i + 4], v.uph16(zero));
+  }
+#else
   for (u32 i = 0; i < 64; i++)
   {
     s16 Y = Yblk[i];
@@ -870,6 +1152,7 @@ void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
     Y += 128;
     s_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
   }
+#endif
 }
 
 void MDEC::HandleSetQuantTableCommand()
@@ -13,6 +13,9 @@ void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Moves the IDCT and colour conversion of each macroblock to a worker thread. Emulated timing is unaffected.
+void SetUseThread(bool enabled);
+
 // I/O
 u32 ReadRegister(u32 offset);
 void WriteRegister(u32 offset, u32 value);
@@ -3,6 +3,7 @@
 
 #include "memory_card.h"
 #include "host.h"
+#include "settings.h"
 #include "system.h"
 
 #include "util/imgui_manager.h"
@@ -14,13 +15,44 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 
 #include "IconsFontAwesome5.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 Log_SetChannel(MemoryCard);
 
+namespace {
+struct PendingSave
+{
+  std::string filename;
+  std::unique_ptr<MemoryCardImage::DataArray> data;
+  bool sync_to_disk = false;
+  bool display_osd_message = false;
+};
+} // namespace
+
+static void QueueBackgroundSave(const std::string& filename, const MemoryCardImage::DataArray& data,
+                                bool display_osd_message);
+static void WaitForBackgroundSave(const std::string& filename);
+static void SaveThreadEntryPoint();
+static void WriteSave(const PendingSave& save);
+
+static std::mutex s_save_mutex;
+static std::condition_variable s_save_cv;
+static std::condition_variable s_save_done_cv;
+static std::deque<PendingSave> s_pending_saves;
+static std::string s_active_save_filename;
+static std::thread s_save_thread;
+static bool s_save_thread_shutdown = false;
+
 MemoryCard::MemoryCard()
 {
   m_FLAG.no_write_yet = true;
@@ -306,6 +338,8 @@ void MemoryCard::Format()
 
 bool MemoryCard::LoadFromFile()
 {
+  // Don't read back stale data if the card was just ejected.
+  WaitForBackgroundSave(m_filename);
   return MemoryCardImage::LoadFromFile(&m_data, m_filename.c_str());
 }
 
@@ -321,36 +355,114 @@ bool MemoryCard::SaveIfChanged(bool display_osd_message)
   if (m_filename.empty())
     return false;
 
-  std::string osd_key;
-  std::string display_name;
-  if (display_osd_message)
-  {
-    osd_key = fmt::format("memory_card_save_{}", m_filename);
-    display_name = FileSystem::GetDisplayNameFromPath(m_filename);
-  }
+  QueueBackgroundSave(m_filename, m_data, display_osd_message);
+  return true;
+}
 
-  if (!MemoryCardImage::SaveToFile(m_data, m_filename.c_str()))
+void QueueBackgroundSave(const std::string& filename, const MemoryCardImage::DataArray& data,
+                         bool display_osd_message)
+{
+  std::unique_lock lock(s_save_mutex);
+
+  // Replace the data of a save which hasn't started yet, rather than writing the file twice.
+  PendingSave* save = nullptr;
+  for (PendingSave& it : s_pending_saves)
   {
-    if (display_osd_message)
+    if (it.filename == filename)
     {
-      Host::AddIconOSDMessage(
-        std::move(osd_key), ICON_FA_SD_CARD,
-        fmt::format(TRANSLATE_FS("OSDMessage", "Failed to save memory card to '{}'."), Path::GetFileName(display_name)),
-        Host::OSD_ERROR_DURATION);
+      save = &it;
+      break;
     }
+  }
+  if (!save)
+  {
+    save = &s_pending_saves.emplace_back();
+    save->filename = filename;
+    save->data = std::make_unique<MemoryCardImage::DataArray>();
+  }
 
-    return false;
+  std::memcpy(save->data->data(), data.data(), data.size());
+  save->sync_to_disk = g_settings.memory_card_sync_on_save;
+  save->display_osd_message |= display_osd_message;
+
+  if (!s_save_thread.joinable())
+  {
+    s_save_thread_shutdown = false;
+    s_save_thread = std::thread(&SaveThreadEntryPoint);
+  }
+
+  s_save_cv.notify_one();
+}
+
+void WaitForBackgroundSave(const std::string& filename)
+{
+  std::unique_lock lock(s_save_mutex);
+  s_save_done_cv.wait(lock, [&filename]() {
+    return (s_active_save_filename != filename &&
+            std::none_of(s_pending_saves.begin(), s_pending_saves.end(),
+                         [&filename](const PendingSave& save) { return (save.filename == filename); }));
+  });
+}
+
+void MemoryCard::StopSaveThread()
+{
+  std::unique_lock lock(s_save_mutex);
+  if (!s_save_thread.joinable())
+    return;
+
+  // The thread writes everything which is queued before exiting.
+  s_save_thread_shutdown = true;
+  s_save_cv.notify_one();
+  lock.unlock();
+  s_save_thread.join();
+}
+
+void SaveThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Memory Card Save");
+
+  std::unique_lock lock(s_save_mutex);
+  for (;;)
+  {
+    s_save_cv.wait(lock, []() { return (s_save_thread_shutdown || !s_pending_saves.empty()); });
+    if (s_pending_saves.empty())
+      break;
+
+    PendingSave save = std::move(s_pending_saves.front());
+    s_pending_saves.pop_front();
+    s_active_save_filename = save.filename;
+    lock.unlock();
+
+    WriteSave(save);
+
+    lock.lock();
+    s_active_save_filename.clear();
+    s_save_done_cv.notify_all();
   }
+}
+
+void WriteSave(const PendingSave& save)
+{
+  const bool result = MemoryCardImage::SaveToFile(*save.data, save.filename.c_str(), save.sync_to_disk);
+  if (!save.display_osd_message)
+    return;
 
-  if (display_osd_message)
+  std::string osd_key = fmt::format("memory_card_save_{}", save.filename);
+  const std::string display_name = FileSystem::GetDisplayNameFromPath(save.filename);
+  if (!result)
+  {
+    Host::AddIconOSDMessage(
+      std::move(osd_key), ICON_FA_SD_CARD,
+      fmt::format(TRANSLATE_FS("OSDMessage", "Failed to save memory card to '{}'."), Path::GetFileName(display_name)),
+      Host::OSD_ERROR_DURATION);
+  }
+  else
   {
     Host::AddIconOSDMessage(
       std::move(osd_key), ICON_FA_SD_CARD,
       fmt::format(TRANSLATE_FS("OSDMessage", "Saved memory card to '{}'."), Path::GetFileName(display_name)),
       Host::OSD_QUICK_DURATION);
   }
-
-  return true;
 }
 
 void MemoryCard::QueueFileSave()
@@ -23,6 +23,9 @@ public:
   static std::unique_ptr<MemoryCard> Create();
   static std::unique_ptr<MemoryCard> Open(std::string_view filename);
 
+  /// Saves are written on a background thread. Waits for any queued saves to finish, and stops the thread.
+  static void StopSaveThread();
+
   const MemoryCardImage::DataArray& GetData() const { return m_data; }
   MemoryCardImage::DataArray& GetData() { return m_data; }
   const std::string& GetFilename() const { return m_filename; }
@@ -20,6 +20,12 @@
 #include <cstdio>
 #include <optional>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 Log_SetChannel(MemoryCard);
 
 namespace MemoryCardImage {
@@ -118,21 +124,41 @@ bool MemoryCardImage::LoadFromFile(DataArray* data, const char* filename)
   return true;
 }
 
-bool MemoryCardImage::SaveToFile(const DataArray& data, const char* filename)
+bool MemoryCardImage::SaveToFile(const DataArray& data, const char* filename, bool sync_to_disk)
 {
-  std::unique_ptr<ByteStream> stream =
-    ByteStream::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_WRITE |
-                                     BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  const std::string temp_filename = fmt::format("{}.tmp", filename);
+  Error error;
+
+  auto fp = FileSystem::OpenManagedCFile(temp_filename.c_str(), "wb", &error);
+  if (!fp)
   {
-    Log_ErrorFmt("Failed to open '{}' for writing.", filename);
+    Log_ErrorFmt("Failed to open '{}' for writing: {}", temp_filename, error.GetDescription());
     return false;
   }
 
-  if (!stream->Write2(data.data(), DATA_SIZE) || !stream->Commit())
+  bool result = (std::fwrite(data.data(), DATA_SIZE, 1, fp.get()) == 1 && std::fflush(fp.get()) == 0);
+  if (result && sync_to_disk)
   {
-    Log_ErrorFmt("Failed to write sectors to '{}'", filename);
-    stream->Discard();
+#ifdef _WIN32
+    result = (_commit(_fileno(fp.get())) == 0);
+#else
+    result = (fsync(fileno(fp.get())) == 0);
+#endif
+  }
+
+  fp.reset();
+
+  if (!result)
+  {
+    Log_ErrorFmt("Failed to write sectors to '{}'", temp_filename);
+    FileSystem::DeleteFile(temp_filename.c_str());
+    return false;
+  }
+
+  if (!FileSystem::RenamePath(temp_filename.c_str(), filename, &error))
+  {
+    Log_ErrorFmt("Failed to rename '{}' to '{}': {}", temp_filename, filename, error.GetDescription());
+    FileSystem::DeleteFile(temp_filename.c_str());
     return false;
   }
 
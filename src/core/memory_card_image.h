@@ -26,7 +26,9 @@ enum : u32
 using DataArray = std::array<u8, DATA_SIZE>;
 
 bool LoadFromFile(DataArray* data, const char* filename);
-bool SaveToFile(const DataArray& data, const char* filename);
+/// Writes to a temporary file which replaces the original, so a failed save doesn't lose the card. If sync_to_disk
+/// is set, the data is flushed to the storage device before the rename.
+bool SaveToFile(const DataArray& data, const char* filename, bool sync_to_disk);
 
 void Format(DataArray* data);
 
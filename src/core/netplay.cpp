@@ -0,0 +1,1109 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "netplay.h"
+#include "achievements.h"
+#include "bios.h"
+#include "bus.h"
+#include "controller.h"
+#include "host.h"
+#include "input_movie.h"
+#include "save_state_version.h"
+#include "settings.h"
+#include "spu.h"
+#include "system.h"
+
+#include "util/gpu_texture.h"
+#include "util/imgui_manager.h"
+
+#include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+
+#include "IconsFontAwesome5.h"
+#include "xxhash.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+Log_SetChannel(Netplay);
+
+namespace Netplay {
+namespace {
+
+#ifdef _WIN32
+using SocketType = SOCKET;
+static constexpr SocketType INVALID_SOCKET_VALUE = INVALID_SOCKET;
+#else
+using SocketType = int;
+static constexpr SocketType INVALID_SOCKET_VALUE = -1;
+#endif
+
+enum class State : u8
+{
+  Inactive,
+  Connecting,
+  Running,
+};
+
+enum class PacketType : u8
+{
+  Hello,
+  Welcome,
+  Reject,
+  Input,
+  Checksum,
+  Quit,
+};
+
+enum class RejectReason : u8
+{
+  VersionMismatch,
+  GameMismatch,
+  BIOSMismatch,
+  ControllerMismatch,
+};
+
+static constexpr u32 MAX_BINDS = 32;
+
+struct PlayerInput
+{
+  std::array<u8, MAX_BINDS> values;
+
+  ALWAYS_INLINE bool operator==(const PlayerInput& rhs) const { return (values == rhs.values); }
+  ALWAYS_INLINE bool operator!=(const PlayerInput& rhs) const { return (values != rhs.values); }
+};
+
+#pragma pack(push, 1)
+struct PacketHeader
+{
+  static constexpr u32 MAGIC = 0x504E5344; // DSNP
+  static constexpr u16 PROTOCOL_VERSION = 1;
+
+  u32 magic;
+  u16 protocol_version;
+  PacketType type;
+  u8 reserved;
+};
+
+struct HelloPacket
+{
+  PacketHeader header;
+  u32 save_state_version;
+  char serial[32];
+  BIOS::Hash bios_hash;
+  std::array<ControllerType, 2> controller_types;
+};
+
+struct RejectPacket
+{
+  PacketHeader header;
+  RejectReason reason;
+};
+
+/// Followed by num_frames PlayerInputs, starting at start_frame.
+struct InputPacket
+{
+  PacketHeader header;
+  u32 ack_frame;
+  u32 start_frame;
+  u8 num_frames;
+};
+
+struct ChecksumPacket
+{
+  PacketHeader header;
+  u32 frame;
+  u64 checksum;
+};
+#pragma pack(pop)
+
+struct FrameState
+{
+  u32 frame;
+  System::MemorySaveState mss;
+};
+
+struct FrameChecksum
+{
+  u32 frame;
+  u64 checksum;
+  bool confirmed;
+};
+
+} // namespace
+
+static constexpr u32 INVALID_FRAME = 0xFFFFFFFFu;
+static constexpr u32 INPUT_BUFFER_SIZE = 128;
+static constexpr u32 MIN_ROLLBACK_FRAMES = 2;
+static constexpr u32 MAX_ROLLBACK_FRAMES = 12;
+static constexpr u32 STATE_BUFFER_SIZE = MAX_ROLLBACK_FRAMES + 2;
+static constexpr u32 MAX_FRAMES_PER_PACKET = 32;
+static constexpr u32 MAX_PACKET_SIZE = 1400;
+static constexpr u32 CHECKSUM_INTERVAL = 30;
+static constexpr u32 CHECKSUM_BUFFER_SIZE = 8;
+static constexpr float HELLO_INTERVAL_MS = 250.0f;
+static constexpr float RESEND_INTERVAL_MS = 10.0f;
+static constexpr float DISCONNECT_TIMEOUT_MS = 10000.0f;
+static constexpr float TIME_AVERAGE_WEIGHT = 0.1f;
+
+static_assert(sizeof(InputPacket) + sizeof(PlayerInput) * MAX_FRAMES_PER_PACKET <= MAX_PACKET_SIZE);
+static_assert(INPUT_BUFFER_SIZE > (MAX_ROLLBACK_FRAMES + MAX_INPUT_DELAY) * 2);
+
+static bool CheckCanStart(Error* error);
+static bool OpenSocket(u16 port, Error* error);
+static void CloseSocket();
+static bool ResolveAddress(const std::string& address, u16 port, Error* error);
+static void FillHeader(PacketHeader* header, PacketType type);
+static void SendPacket(const void* data, size_t size);
+static void SendHello();
+static void SendReject(RejectReason reason);
+static void SendInputs();
+static void ReceivePackets();
+static void HandlePacket(const u8* data, size_t size, const sockaddr_storage& from, u32 from_length);
+static void HandleHello(const HelloPacket& packet, const sockaddr_storage& from, u32 from_length);
+static void HandleInput(const InputPacket& packet, const PlayerInput* inputs);
+static void HandleChecksum(const ChecksumPacket& packet);
+static void Disconnect(std::string message);
+
+static void BeginSession();
+static PlayerInput GetNeutralInput();
+static void CaptureLocalInput();
+static void ApplyInputs(u32 frame);
+static void SetPadInput(u32 pad, const PlayerInput& input);
+static void BeginFrame(u32 frame);
+static bool WaitForRemoteInput();
+static bool StartRollback();
+static void UpdateMaxRollbackFrames();
+
+static void UpdateChecksum(u32 frame);
+static void SendConfirmedChecksums();
+static void CompareChecksums(u32 frame);
+
+static State s_state = State::Inactive;
+static bool s_is_host = false;
+static SocketType s_socket = INVALID_SOCKET_VALUE;
+static sockaddr_storage s_peer_address = {};
+static u32 s_peer_address_length = 0;
+static bool s_has_peer = false;
+static Common::Timer::Value s_last_receive_time = 0;
+static Common::Timer::Value s_last_send_time = 0;
+
+static u32 s_input_delay = DEFAULT_INPUT_DELAY;
+static u32 s_local_pad = 0;
+static u32 s_remote_pad = 1;
+static std::vector<u32> s_bind_indices;
+static PlayerInput s_current_local_input = {};
+
+// Frame numbers start at zero when the session begins. Inputs are kept in rings indexed by frame.
+static u32 s_frame = 0;
+static u32 s_local_input_end = 0;
+static u32 s_remote_input_end = 0;
+static u32 s_remote_ack = 0;
+static u32 s_rollback_frame = INVALID_FRAME;
+static u32 s_replay_target_frame = 0;
+static bool s_replaying = false;
+static std::array<PlayerInput, INPUT_BUFFER_SIZE> s_local_inputs;
+static std::array<PlayerInput, INPUT_BUFFER_SIZE> s_remote_inputs;
+static std::array<PlayerInput, INPUT_BUFFER_SIZE> s_remote_used_inputs;
+static std::array<FrameState, STATE_BUFFER_SIZE> s_states;
+
+static std::array<FrameChecksum, CHECKSUM_BUFFER_SIZE> s_local_checksums;
+static std::array<FrameChecksum, CHECKSUM_BUFFER_SIZE> s_remote_checksums;
+
+static float s_save_time_ms = 0.0f;
+static float s_load_time_ms = 0.0f;
+static u32 s_max_rollback_frames = MAX_ROLLBACK_FRAMES;
+static u32 s_last_rollback_frames = 0;
+
+} // namespace Netplay
+
+bool Netplay::IsActive()
+{
+  return (s_state != State::Inactive);
+}
+
+bool Netplay::IsConnected()
+{
+  return (s_state == State::Running);
+}
+
+bool Netplay::IsReplaying()
+{
+  return s_replaying;
+}
+
+u32 Netplay::GetLastRollbackFrames()
+{
+  return s_last_rollback_frames;
+}
+
+u32 Netplay::GetMaxRollbackFrames()
+{
+  return s_max_rollback_frames;
+}
+
+bool Netplay::CheckCanStart(Error* error)
+{
+  if (!System::IsValid())
+  {
+    Error::SetStringView(error, "System is not running.");
+    return false;
+  }
+
+  // runahead and rewind load states behind our back, and achievements can refuse the reset
+  if (g_settings.runahead_frames > 0 || g_settings.rewind_enable)
+  {
+    Error::SetStringView(error, "Runahead and rewind must be disabled to use netplay.");
+    return false;
+  }
+  if (Achievements::IsHardcoreModeActive())
+  {
+    Error::SetStringView(error, "Netplay can't be used in hardcore mode.");
+    return false;
+  }
+  if (InputMovie::IsActive())
+  {
+    Error::SetStringView(error, "Netplay can't be used while an input movie is active.");
+    return false;
+  }
+
+  // both players use their port 1 bindings, so the bind indices have to line up
+  const Controller* controller0 = System::GetController(0);
+  const Controller* controller1 = System::GetController(1);
+  if (!controller0 || !controller1 || controller0->GetType() != controller1->GetType())
+  {
+    Error::SetStringView(error, "Netplay requires the same type of controller in ports 1 and 2.");
+    return false;
+  }
+
+  return true;
+}
+
+bool Netplay::StartHost(u16 port, u32 input_delay, Error* error)
+{
+  if (!CheckCanStart(error))
+    return false;
+
+  Stop();
+  if (!OpenSocket(port, error))
+    return false;
+
+  s_is_host = true;
+  s_has_peer = false;
+  s_input_delay = std::min(input_delay, MAX_INPUT_DELAY);
+  s_state = State::Connecting;
+
+  Log_InfoFmt("Waiting for netplay connection on port {}.", port);
+  Host::AddIconOSDMessage("netplay", ICON_FA_WIFI,
+                          fmt::format(TRANSLATE_FS("Netplay", "Waiting for the other player on port {}."), port),
+                          Host::OSD_INFO_DURATION);
+  return true;
+}
+
+bool Netplay::StartJoin(const std::string& address, u16 port, u32 input_delay, Error* error)
+{
+  if (!CheckCanStart(error))
+    return false;
+
+  Stop();
+  if (!OpenSocket(0, error))
+    return false;
+
+  if (!ResolveAddress(address, port, error))
+  {
+    CloseSocket();
+    return false;
+  }
+
+  s_is_host = false;
+  s_has_peer = true;
+  s_input_delay = std::min(input_delay, MAX_INPUT_DELAY);
+  s_state = State::Connecting;
+  s_last_receive_time = Common::Timer::GetCurrentValue();
+  SendHello();
+
+  Log_InfoFmt("Connecting to netplay host {}:{}.", address, port);
+  Host::AddIconOSDMessage("netplay", ICON_FA_WIFI,
+                          fmt::format(TRANSLATE_FS("Netplay", "Connecting to {}:{}..."), address, port),
+                          Host::OSD_INFO_DURATION);
+  return true;
+}
+
+void Netplay::Stop()
+{
+  if (s_state == State::Inactive)
+    return;
+
+  // it's only a courtesy, the other side times out otherwise
+  if (s_has_peer)
+  {
+    PacketHeader header;
+    FillHeader(&header, PacketType::Quit);
+    SendPacket(&header, sizeof(header));
+  }
+
+  CloseSocket();
+
+  if (s_replaying)
+  {
+    SPU::SetAudioOutputMuted(false);
+    s_replaying = false;
+  }
+
+  // textures have to be released on the CPU thread
+  for (FrameState& fs : s_states)
+  {
+    fs.frame = INVALID_FRAME;
+    fs.mss = {};
+  }
+
+  s_has_peer = false;
+  s_bind_indices.clear();
+  s_state = State::Inactive;
+  Log_InfoPrint("Netplay session ended.");
+}
+
+bool Netplay::InterceptBindState(u32 pad, u32 bind_index, float value)
+{
+  if (s_state != State::Running)
+    return false;
+
+  // everything goes through the input buffer, the other ports are controlled by the other player
+  if (pad == 0 && bind_index < MAX_BINDS)
+    s_current_local_input.values[bind_index] = static_cast<u8>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+  return true;
+}
+
+bool Netplay::FrameDone()
+{
+  if (s_state == State::Connecting)
+  {
+    ReceivePackets();
+    if (s_state == State::Connecting && !s_is_host &&
+        Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() - s_last_send_time) >=
+          HELLO_INTERVAL_MS)
+    {
+      SendHello();
+    }
+
+    return false;
+  }
+  else if (s_state != State::Running)
+  {
+    return false;
+  }
+
+  s_frame++;
+  if (s_replaying)
+  {
+    // states are saved again as we go, since the old ones were based on the wrong input
+    if (s_frame < s_replay_target_frame)
+    {
+      BeginFrame(s_frame);
+      return true;
+    }
+
+    // caught up, this frame is handled like any other
+    s_replaying = false;
+    SPU::SetAudioOutputMuted(false);
+  }
+
+  CaptureLocalInput();
+  ReceivePackets();
+  if (s_state != State::Running)
+    return false;
+
+  SendInputs();
+  if (!WaitForRemoteInput())
+    return false;
+
+  if (s_rollback_frame != INVALID_FRAME)
+    return StartRollback();
+
+  SendConfirmedChecksums();
+  if ((s_frame % 60) == 0)
+    UpdateMaxRollbackFrames();
+
+  BeginFrame(s_frame);
+  return false;
+}
+
+void Netplay::BeginSession()
+{
+  System::ResetSystem();
+
+  s_local_pad = s_is_host ? 0 : 1;
+  s_remote_pad = s_is_host ? 1 : 0;
+
+  s_bind_indices.clear();
+  const Controller* controller = System::GetController(s_local_pad);
+  const Controller::ControllerInfo* cinfo = controller ? Controller::GetControllerInfo(controller->GetType()) : nullptr;
+  if (cinfo)
+  {
+    for (const Controller::ControllerBindingInfo& bi : cinfo->bindings)
+    {
+      if ((bi.type == InputBindingInfo::Type::Button || bi.type == InputBindingInfo::Type::HalfAxis ||
+           bi.type == InputBindingInfo::Type::Axis) &&
+          bi.bind_index < MAX_BINDS)
+      {
+        s_bind_indices.push_back(bi.bind_index);
+      }
+    }
+  }
+
+  // the first frames before the input delay has passed are neutral on both sides
+  const PlayerInput neutral = GetNeutralInput();
+  s_current_local_input = neutral;
+  s_local_inputs.fill(neutral);
+  s_remote_inputs.fill(neutral);
+  s_remote_used_inputs.fill(neutral);
+  for (FrameState& fs : s_states)
+    fs.frame = INVALID_FRAME;
+  for (FrameChecksum& fc : s_local_checksums)
+    fc = {INVALID_FRAME, 0, false};
+  for (FrameChecksum& fc : s_remote_checksums)
+    fc = {INVALID_FRAME, 0, false};
+
+  s_frame = 0;
+  s_local_input_end = s_input_delay;
+  s_remote_input_end = 0;
+  s_remote_ack = 0;
+  s_rollback_frame = INVALID_FRAME;
+  s_replay_target_frame = 0;
+  s_replaying = false;
+  s_max_rollback_frames = MAX_ROLLBACK_FRAMES;
+  s_last_rollback_frames = 0;
+  s_last_receive_time = Common::Timer::GetCurrentValue();
+  s_state = State::Running;
+
+  CaptureLocalInput();
+  BeginFrame(0);
+
+  Log_InfoFmt("Netplay session started, playing as player {}.", s_local_pad + 1);
+  Host::AddIconOSDMessage(
+    "netplay", ICON_FA_WIFI,
+    fmt::format(TRANSLATE_FS("Netplay", "Connected. You are player {}."), s_local_pad + 1), Host::OSD_INFO_DURATION);
+}
+
+Netplay::PlayerInput Netplay::GetNeutralInput()
+{
+  // full axes rest in the middle
+  PlayerInput input = {};
+  const Controller* controller = System::GetController(s_local_pad);
+  const Controller::ControllerInfo* cinfo = controller ? Controller::GetControllerInfo(controller->GetType()) : nullptr;
+  if (cinfo)
+  {
+    for (const Controller::ControllerBindingInfo& bi : cinfo->bindings)
+    {
+      if (bi.type == InputBindingInfo::Type::Axis && bi.bind_index < MAX_BINDS)
+        input.values[bi.bind_index] = 128;
+    }
+  }
+
+  return input;
+}
+
+void Netplay::CaptureLocalInput()
+{
+  while (s_local_input_end <= (s_frame + s_input_delay))
+  {
+    s_local_inputs[s_local_input_end % INPUT_BUFFER_SIZE] = s_current_local_input;
+    s_local_input_end++;
+  }
+}
+
+void Netplay::ApplyInputs(u32 frame)
+{
+  // the other player's last known input is the prediction for frames we don't have yet
+  const u32 index = frame % INPUT_BUFFER_SIZE;
+  if (frame < s_remote_input_end)
+    s_remote_used_inputs[index] = s_remote_inputs[index];
+  else if (s_remote_input_end > 0)
+    s_remote_used_inputs[index] = s_remote_inputs[(s_remote_input_end - 1) % INPUT_BUFFER_SIZE];
+  else
+    s_remote_used_inputs[index] = GetNeutralInput();
+
+  SetPadInput(s_local_pad, s_local_inputs[index]);
+  SetPadInput(s_remote_pad, s_remote_used_inputs[index]);
+}
+
+void Netplay::SetPadInput(u32 pad, const PlayerInput& input)
+{
+  Controller* controller = System::GetController(pad);
+  if (!controller)
+    return;
+
+  for (const u32 bind_index : s_bind_indices)
+    controller->SetBindState(bind_index, static_cast<float>(input.values[bind_index]) / 255.0f);
+}
+
+void Netplay::BeginFrame(u32 frame)
+{
+  FrameState& fs = s_states[frame % STATE_BUFFER_SIZE];
+  Common::Timer timer;
+  if (System::SaveMemoryState(&fs.mss))
+    fs.frame = frame;
+  else
+    fs.frame = INVALID_FRAME;
+
+  s_save_time_ms += (static_cast<float>(timer.GetTimeMilliseconds()) - s_save_time_ms) * TIME_AVERAGE_WEIGHT;
+
+  UpdateChecksum(frame);
+  ApplyInputs(frame);
+}
+
+bool Netplay::WaitForRemoteInput()
+{
+  // If we get too far ahead of the other player, a rollback would need states we've already thrown away, or take
+  // longer than a frame to replay. So wait for them to catch up.
+  if (s_frame < (s_remote_input_end + s_max_rollback_frames))
+    return true;
+
+  Log_DevFmt("Waiting for input, at frame {} with remote input up to {}", s_frame, s_remote_input_end);
+  while (s_frame >= (s_remote_input_end + s_max_rollback_frames))
+  {
+    Host::PumpMessagesOnCPUThread();
+    if (s_state != State::Running)
+      return false;
+
+    ReceivePackets();
+    if (s_state != State::Running)
+      return false;
+
+    const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+    if (Common::Timer::ConvertValueToMilliseconds(current_time - s_last_receive_time) >= DISCONNECT_TIMEOUT_MS)
+    {
+      Disconnect(TRANSLATE_STR("Netplay", "Connection to the other player timed out."));
+      return false;
+    }
+
+    if (Common::Timer::ConvertValueToMilliseconds(current_time - s_last_send_time) >= RESEND_INTERVAL_MS)
+      SendInputs();
+
+    Common::Timer::NanoSleep(1000000);
+  }
+
+  return true;
+}
+
+bool Netplay::StartRollback()
+{
+  const u32 rollback_frame = std::exchange(s_rollback_frame, INVALID_FRAME);
+  const u32 target_frame = s_frame;
+  const FrameState& fs = s_states[rollback_frame % STATE_BUFFER_SIZE];
+  if (fs.frame != rollback_frame)
+  {
+    Log_ErrorFmt("No state for rollback to frame {} from frame {}", rollback_frame, target_frame);
+    Disconnect(TRANSLATE_STR("Netplay", "Rollback went further back than the saved states."));
+    return false;
+  }
+
+  Common::Timer timer;
+  if (!System::LoadMemoryState(fs.mss))
+  {
+    Disconnect(TRANSLATE_STR("Netplay", "Failed to load rollback state."));
+    return false;
+  }
+  s_load_time_ms += (static_cast<float>(timer.GetTimeMilliseconds()) - s_load_time_ms) * TIME_AVERAGE_WEIGHT;
+
+  Log_DevFmt("Rolling back {} frames from {} to {}", target_frame - rollback_frame, target_frame, rollback_frame);
+  s_last_rollback_frames = target_frame - rollback_frame;
+  s_frame = rollback_frame;
+  s_replay_target_frame = target_frame;
+  s_replaying = true;
+  SPU::SetAudioOutputMuted(true);
+
+  // the state for this frame is still good, it's only the input which was wrong
+  UpdateChecksum(rollback_frame);
+  ApplyInputs(rollback_frame);
+  return true;
+}
+
+void Netplay::UpdateMaxRollbackFrames()
+{
+  // A rollback of n frames costs a load, then n frames which are each run and saved, and has to fit in what's left of
+  // the frame after running it normally. Otherwise a rollback would cause a stutter.
+  const float frame_period_ms = 1000.0f / std::max(System::GetThrottleFrequency(), 1.0f);
+  const float frame_run_ms = std::max(System::GetCPUThreadAverageTime(), 0.1f);
+  const float spare_ms = frame_period_ms - frame_run_ms - s_load_time_ms;
+  const float replay_frame_ms = frame_run_ms + s_save_time_ms;
+  const u32 max_frames = (spare_ms > 0.0f) ? static_cast<u32>(spare_ms / replay_frame_ms) : 0;
+  const u32 new_max_frames = std::clamp(max_frames, MIN_ROLLBACK_FRAMES, MAX_ROLLBACK_FRAMES);
+  if (new_max_frames != s_max_rollback_frames)
+  {
+    Log_DevFmt("Max rollback frames now {} (save {:.2f}ms, load {:.2f}ms, frame {:.2f}ms)", new_max_frames,
+               s_save_time_ms, s_load_time_ms, frame_run_ms);
+    s_max_rollback_frames = new_max_frames;
+  }
+}
+
+void Netplay::UpdateChecksum(u32 frame)
+{
+  if ((frame % CHECKSUM_INTERVAL) != 0)
+    return;
+
+  // overwritten when the frame is replayed, it's only final once all the input before it is confirmed
+  FrameChecksum& fc = s_local_checksums[(frame / CHECKSUM_INTERVAL) % CHECKSUM_BUFFER_SIZE];
+  fc.frame = frame;
+  fc.checksum = XXH3_64bits(Bus::g_ram, Bus::g_ram_size);
+  fc.confirmed = false;
+}
+
+void Netplay::SendConfirmedChecksums()
+{
+  // checksums are of the state at the start of the frame, so they're final once the previous frame's input is
+  const u32 last_confirmed_frame = std::min(s_remote_input_end, s_frame);
+  const u32 checksum_frame = last_confirmed_frame - (last_confirmed_frame % CHECKSUM_INTERVAL);
+  FrameChecksum& fc = s_local_checksums[(checksum_frame / CHECKSUM_INTERVAL) % CHECKSUM_BUFFER_SIZE];
+  if (fc.frame != checksum_frame || fc.confirmed)
+    return;
+
+  fc.confirmed = true;
+
+  ChecksumPacket packet;
+  FillHeader(&packet.header, PacketType::Checksum);
+  packet.frame = fc.frame;
+  packet.checksum = fc.checksum;
+  SendPacket(&packet, sizeof(packet));
+
+  CompareChecksums(checksum_frame);
+}
+
+void Netplay::CompareChecksums(u32 frame)
+{
+  const u32 index = (frame / CHECKSUM_INTERVAL) % CHECKSUM_BUFFER_SIZE;
+  const FrameChecksum& local = s_local_checksums[index];
+  const FrameChecksum& remote = s_remote_checksums[index];
+  if (local.frame != frame || remote.frame != frame || !local.confirmed)
+    return;
+
+  if (local.checksum != remote.checksum)
+  {
+    Log_ErrorFmt("Desync at frame {}, local checksum {:016X}, remote checksum {:016X}", frame, local.checksum,
+                 remote.checksum);
+    Disconnect(fmt::format(TRANSLATE_FS("Netplay", "Desynced with the other player at frame {}."), frame));
+  }
+}
+
+void Netplay::Disconnect(std::string message)
+{
+  Log_ErrorFmt("Netplay: {}", message);
+  Host::AddIconOSDMessage("netplay", ICON_FA_WIFI, std::move(message), Host::OSD_ERROR_DURATION);
+  Stop();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Transport
+//////////////////////////////////////////////////////////////////////////
+
+static int GetSocketError()
+{
+#ifdef _WIN32
+  return WSAGetLastError();
+#else
+  return errno;
+#endif
+}
+
+bool Netplay::OpenSocket(u16 port, Error* error)
+{
+#ifdef _WIN32
+  WSADATA wd;
+  if (const int res = WSAStartup(MAKEWORD(2, 2), &wd); res != 0)
+  {
+    Error::SetSocket(error, "WSAStartup() failed: ", res);
+    return false;
+  }
+#endif
+
+  s_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (s_socket == INVALID_SOCKET_VALUE)
+  {
+    Error::SetSocket(error, "socket() failed: ", GetSocketError());
+    CloseSocket();
+    return false;
+  }
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(s_socket, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+  {
+    Error::SetSocket(error, fmt::format("Failed to bind to port {}: ", port), GetSocketError());
+    CloseSocket();
+    return false;
+  }
+
+  // packets are polled once per frame, we never want to block
+#ifdef _WIN32
+  u_long non_blocking = 1;
+  const bool set_non_blocking = (ioctlsocket(s_socket, FIONBIO, &non_blocking) == 0);
+#else
+  const int flags = fcntl(s_socket, F_GETFL, 0);
+  const bool set_non_blocking = (flags >= 0 && fcntl(s_socket, F_SETFL, flags | O_NONBLOCK) == 0);
+#endif
+  if (!set_non_blocking)
+  {
+    Error::SetSocket(error, "Failed to make socket non-blocking: ", GetSocketError());
+    CloseSocket();
+    return false;
+  }
+
+  return true;
+}
+
+void Netplay::CloseSocket()
+{
+  if (s_socket != INVALID_SOCKET_VALUE)
+  {
+#ifdef _WIN32
+    closesocket(s_socket);
+#else
+    close(s_socket);
+#endif
+    s_socket = INVALID_SOCKET_VALUE;
+  }
+
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+bool Netplay::ResolveAddress(const std::string& address, u16 port, Error* error)
+{
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_protocol = IPPROTO_UDP;
+
+  addrinfo* result = nullptr;
+  const std::string port_str = std::to_string(port);
+  if (const int res = getaddrinfo(address.c_str(), port_str.c_str(), &hints, &result); res != 0 || !result)
+  {
+    Error::SetStringFmt(error, "Failed to resolve '{}': {}", address, gai_strerror(res));
+    return false;
+  }
+
+  std::memcpy(&s_peer_address, result->ai_addr, result->ai_addrlen);
+  s_peer_address_length = static_cast<u32>(result->ai_addrlen);
+  freeaddrinfo(result);
+  return true;
+}
+
+void Netplay::FillHeader(PacketHeader* header, PacketType type)
+{
+  header->magic = PacketHeader::MAGIC;
+  header->protocol_version = PacketHeader::PROTOCOL_VERSION;
+  header->type = type;
+  header->reserved = 0;
+}
+
+void Netplay::SendPacket(const void* data, size_t size)
+{
+  if (s_socket == INVALID_SOCKET_VALUE || !s_has_peer)
+    return;
+
+  // Dropped packets are fine, inputs are resent until they're acknowledged.
+  if (sendto(s_socket, static_cast<const char*>(data), static_cast<int>(size), 0,
+             reinterpret_cast<const sockaddr*>(&s_peer_address), static_cast<socklen_t>(s_peer_address_length)) < 0)
+  {
+    Log_DevFmt("sendto() failed: {}", GetSocketError());
+  }
+
+  s_last_send_time = Common::Timer::GetCurrentValue();
+}
+
+void Netplay::SendHello()
+{
+  HelloPacket packet = {};
+  FillHeader(&packet.header, PacketType::Hello);
+  packet.save_state_version = SAVE_STATE_VERSION;
+  StringUtil::Strlcpy(packet.serial, System::GetGameSerial().c_str(), sizeof(packet.serial));
+  packet.bios_hash = System::GetBIOSHash();
+  for (u32 i = 0; i < 2; i++)
+  {
+    const Controller* controller = System::GetController(i);
+    packet.controller_types[i] = controller ? controller->GetType() : ControllerType::None;
+  }
+
+  SendPacket(&packet, sizeof(packet));
+}
+
+void Netplay::SendReject(RejectReason reason)
+{
+  RejectPacket packet;
+  FillHeader(&packet.header, PacketType::Reject);
+  packet.reason = reason;
+  SendPacket(&packet, sizeof(packet));
+}
+
+void Netplay::SendInputs()
+{
+  // everything the other player hasn't acknowledged yet goes in every packet, so there's no need for retransmission
+  std::array<u8, MAX_PACKET_SIZE> buffer;
+  InputPacket packet;
+  FillHeader(&packet.header, PacketType::Input);
+  packet.ack_frame = s_remote_input_end;
+  packet.start_frame = s_remote_ack;
+  packet.num_frames = static_cast<u8>(std::min(s_local_input_end - s_remote_ack, MAX_FRAMES_PER_PACKET));
+  std::memcpy(buffer.data(), &packet, sizeof(packet));
+
+  size_t size = sizeof(packet);
+  for (u32 i = 0; i < packet.num_frames; i++)
+  {
+    std::memcpy(&buffer[size], &s_local_inputs[(packet.start_frame + i) % INPUT_BUFFER_SIZE], sizeof(PlayerInput));
+    size += sizeof(PlayerInput);
+  }
+
+  SendPacket(buffer.data(), size);
+}
+
+void Netplay::ReceivePackets()
+{
+  if (s_socket == INVALID_SOCKET_VALUE)
+    return;
+
+  std::array<u8, MAX_PACKET_SIZE> buffer;
+  for (;;)
+  {
+    sockaddr_storage from = {};
+    socklen_t from_length = sizeof(from);
+    const auto size = recvfrom(s_socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                               reinterpret_cast<sockaddr*>(&from), &from_length);
+    if (size <= 0)
+      break;
+
+    HandlePacket(buffer.data(), static_cast<size_t>(size), from, static_cast<u32>(from_length));
+    if (s_state == State::Inactive)
+      break;
+  }
+}
+
+void Netplay::HandlePacket(const u8* data, size_t size, const sockaddr_storage& from, u32 from_length)
+{
+  PacketHeader header;
+  if (size < sizeof(header))
+    return;
+
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != PacketHeader::MAGIC || header.protocol_version != PacketHeader::PROTOCOL_VERSION)
+  {
+    if (header.magic == PacketHeader::MAGIC && s_is_host && !s_has_peer)
+    {
+      s_peer_address = from;
+      s_peer_address_length = from_length;
+      s_has_peer = true;
+      SendReject(RejectReason::VersionMismatch);
+      s_has_peer = false;
+    }
+
+    return;
+  }
+
+  // the host accepts the first player to say hello, after that only the peer is listened to
+  const bool from_peer =
+    (s_has_peer && from_length == s_peer_address_length && std::memcmp(&from, &s_peer_address, from_length) == 0);
+  if (header.type == PacketType::Hello)
+  {
+    HelloPacket packet;
+    if (s_is_host && size >= sizeof(packet) && (!s_has_peer || from_peer))
+    {
+      std::memcpy(&packet, data, sizeof(packet));
+      HandleHello(packet, from, from_length);
+    }
+
+    return;
+  }
+  else if (!from_peer)
+  {
+    return;
+  }
+
+  s_last_receive_time = Common::Timer::GetCurrentValue();
+
+  switch (header.type)
+  {
+    case PacketType::Welcome:
+    {
+      if (!s_is_host && s_state == State::Connecting)
+        BeginSession();
+    }
+    break;
+
+    case PacketType::Reject:
+    {
+      if (s_is_host || s_state != State::Connecting || size < sizeof(RejectPacket))
+        break;
+
+      RejectPacket packet;
+      std::memcpy(&packet, data, sizeof(packet));
+      switch (packet.reason)
+      {
+        case RejectReason::VersionMismatch:
+          Disconnect(TRANSLATE_STR("Netplay", "The host is running a different version."));
+          break;
+        case RejectReason::GameMismatch:
+          Disconnect(TRANSLATE_STR("Netplay", "The host is running a different game."));
+          break;
+        case RejectReason::BIOSMismatch:
+          Disconnect(TRANSLATE_STR("Netplay", "The host is using a different BIOS."));
+          break;
+        case RejectReason::ControllerMismatch:
+        default:
+          Disconnect(TRANSLATE_STR("Netplay", "The host is using different controllers."));
+          break;
+      }
+    }
+    break;
+
+    case PacketType::Input:
+    {
+      InputPacket packet;
+      if (s_state != State::Running || size < sizeof(packet))
+        break;
+
+      std::memcpy(&packet, data, sizeof(packet));
+      if (size < (sizeof(packet) + sizeof(PlayerInput) * packet.num_frames))
+        break;
+
+      std::array<PlayerInput, MAX_FRAMES_PER_PACKET> inputs;
+      const u32 num_frames = std::min<u32>(packet.num_frames, MAX_FRAMES_PER_PACKET);
+      std::memcpy(inputs.data(), data + sizeof(packet), sizeof(PlayerInput) * num_frames);
+      packet.num_frames = static_cast<u8>(num_frames);
+      HandleInput(packet, inputs.data());
+    }
+    break;
+
+    case PacketType::Checksum:
+    {
+      ChecksumPacket packet;
+      if (s_state != State::Running || size < sizeof(packet))
+        break;
+
+      std::memcpy(&packet, data, sizeof(packet));
+      HandleChecksum(packet);
+    }
+    break;
+
+    case PacketType::Quit:
+    {
+      s_has_peer = false;
+      Disconnect(TRANSLATE_STR("Netplay", "The other player left the session."));
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
+void Netplay::HandleHello(const HelloPacket& packet, const sockaddr_storage& from, u32 from_length)
+{
+  s_peer_address = from;
+  s_peer_address_length = from_length;
+  s_has_peer = true;
+
+  // the welcome may have been lost, in which case they'll keep saying hello
+  if (s_state == State::Running)
+  {
+    PacketHeader header;
+    FillHeader(&header, PacketType::Welcome);
+    SendPacket(&header, sizeof(header));
+    return;
+  }
+
+  std::optional<RejectReason> reject_reason;
+  if (packet.save_state_version != SAVE_STATE_VERSION)
+  {
+    reject_reason = RejectReason::VersionMismatch;
+  }
+  else if (!std::memchr(packet.serial, 0, sizeof(packet.serial)) || System::GetGameSerial() != packet.serial)
+  {
+    reject_reason = RejectReason::GameMismatch;
+  }
+  else if (packet.bios_hash != System::GetBIOSHash())
+  {
+    reject_reason = RejectReason::BIOSMismatch;
+  }
+  else
+  {
+    for (u32 i = 0; i < 2; i++)
+    {
+      const Controller* controller = System::GetController(i);
+      if (packet.controller_types[i] != (controller ? controller->GetType() : ControllerType::None))
+        reject_reason = RejectReason::ControllerMismatch;
+    }
+  }
+
+  if (reject_reason.has_value())
+  {
+    Log_WarningFmt("Rejecting netplay connection, reason {}", static_cast<u32>(reject_reason.value()));
+    SendReject(reject_reason.value());
+    s_has_peer = false;
+    return;
+  }
+
+  PacketHeader header;
+  FillHeader(&header, PacketType::Welcome);
+  SendPacket(&header, sizeof(header));
+  BeginSession();
+}
+
+void Netplay::HandleInput(const InputPacket& packet, const PlayerInput* inputs)
+{
+  // acks only go forwards, packets can arrive out of order
+  if (packet.ack_frame > s_remote_ack && packet.ack_frame <= s_local_input_end)
+    s_remote_ack = packet.ack_frame;
+
+  for (u32 i = 0; i < packet.num_frames; i++)
+  {
+    const u32 frame = packet.start_frame + i;
+    if (frame < s_remote_input_end)
+      continue;
+    else if (frame > s_remote_input_end || frame >= (s_frame + INPUT_BUFFER_SIZE / 2))
+      break;
+
+    const u32 index = frame % INPUT_BUFFER_SIZE;
+    s_remote_inputs[index] = inputs[i];
+    s_remote_input_end++;
+
+    // if we've already run this frame with a different prediction, we need to go back
+    if (frame < s_frame && s_remote_used_inputs[index] != inputs[i])
+      s_rollback_frame = std::min(s_rollback_frame, frame);
+  }
+}
+
+void Netplay::HandleChecksum(const ChecksumPacket& packet)
+{
+  if ((packet.frame % CHECKSUM_INTERVAL) != 0)
+    return;
+
+  FrameChecksum& fc = s_remote_checksums[(packet.frame / CHECKSUM_INTERVAL) % CHECKSUM_BUFFER_SIZE];
+  fc.frame = packet.frame;
+  fc.checksum = packet.checksum;
+  fc.confirmed = true;
+  CompareChecksums(packet.frame);
+}
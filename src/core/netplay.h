@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "types.h"
+
+#include <string>
+
+class Error;
+
+/// Two-player online play over UDP, with rollback instead of input delay. Both players must be running the same game
+/// with the same BIOS, settings and memory cards, and the system is reset when the session starts. Each side then runs
+/// using a prediction of the other player's input. When the real input arrives and differs, the system is rolled back
+/// to the first wrong frame with a memory save state, and the frames up to the present are replayed without being
+/// shown. RAM checksums of confirmed frames are exchanged to detect desyncs.
+///
+/// The host plays with the controller in port 1, the other player with the controller in port 2. Both players use
+/// their port 1 bindings.
+namespace Netplay {
+
+static constexpr u16 DEFAULT_PORT = 31200;
+static constexpr u32 DEFAULT_INPUT_DELAY = 1;
+static constexpr u32 MAX_INPUT_DELAY = 8;
+
+bool IsActive();
+
+/// Returns true once the other player has connected, and frames are being synchronised.
+bool IsConnected();
+
+/// Returns true while frames are being replayed after a rollback.
+bool IsReplaying();
+
+/// Waits for the other player to connect on the specified port.
+bool StartHost(u16 port, u32 input_delay, Error* error);
+
+/// Connects to a host. The address can be a hostname or IPv4 address.
+bool StartJoin(const std::string& address, u16 port, u32 input_delay, Error* error);
+
+/// Leaves the session, and lets the other player know.
+void Stop();
+
+/// Returns how many frames the most recent rollback replayed.
+u32 GetLastRollbackFrames();
+
+/// Returns the maximum number of frames which can be rolled back, based on how long saving, loading and running
+/// frames takes. The player who is ahead waits for the other when this would be exceeded.
+u32 GetMaxRollbackFrames();
+
+/// Called when the host changes a controller binding. Returns true if netplay has taken the input, in which case it
+/// should not be applied to the controller.
+bool InterceptBindState(u32 pad, u32 bind_index, float value);
+
+/// Called at the end of each frame, after host input has been polled. Returns true if the next frame is a replay after
+/// a rollback, and should not be presented.
+bool FrameDone();
+
+} // namespace Netplay
@@ -101,7 +101,9 @@ static void SoftReset();
 static void UpdateJoyStat();
 static void TransferEvent(void*, TickCount ticks, TickCount ticks_late);
 static void BeginTransfer();
-static void DoTransfer(TickCount ticks_late);
+static bool DoTransfer();
+static void FinishTransfer();
+static void UpdateTransfer();
 static void DoACK();
 static void EndTransfer();
 static void ResetDeviceTransferState();
@@ -132,6 +134,10 @@ static u8 s_transmit_value = 0;
 static bool s_receive_buffer_full = false;
 static bool s_transmit_buffer_full = false;
 
+// The device's reply is computed when the byte starts transmitting, and received when the transfer time elapses.
+static u8 s_pending_receive_value = 0xFF;
+static bool s_pending_ack = false;
+
 static u32 s_last_memory_card_transfer_frame = 0;
 static std::unique_ptr<GrowableMemoryByteStream> s_memory_card_backup;
 static std::unique_ptr<MemoryCard> s_dummy_card;
@@ -535,9 +541,18 @@ bool Pad::DoState(StateWrapper& sw, bool is_memory_state)
   sw.Do(&s_transmit_buffer);
   sw.Do(&s_receive_buffer_full);
   sw.Do(&s_transmit_buffer_full);
+  sw.DoEx(&s_pending_receive_value, 65, static_cast<u8>(0xFF));
+  sw.DoEx(&s_pending_ack, 65, false);
 
   if (sw.IsReading() && IsTransmitting())
+  {
+    // Older states exchange the byte at the end of the transfer. Doing it now means the ACK is raised along with the
+    // receive for this one byte, instead of after the usual delay.
+    if (sw.GetVersion() < 65 && s_state == State::Transmitting)
+      s_pending_ack = DoTransfer();
+
     s_transfer_event->Activate();
+  }
 
   return !sw.HasError();
 }
@@ -585,8 +600,7 @@ u32 Pad::ReadRegister(u32 offset)
   {
     case 0x00: // JOY_DATA
     {
-      if (IsTransmitting())
-        s_transfer_event->InvokeEarly();
+      UpdateTransfer();
 
       const u8 value = s_receive_buffer_full ? s_receive_buffer : 0xFF;
       Log_DebugPrintf("JOY_DATA (R) -> 0x%02X%s", ZeroExtend32(value), s_receive_buffer_full ? "" : "(EMPTY)");
@@ -599,8 +613,7 @@ u32 Pad::ReadRegister(u32 offset)
 
     case 0x04: // JOY_STAT
     {
-      if (IsTransmitting())
-        s_transfer_event->InvokeEarly();
+      UpdateTransfer();
 
       const u32 bits = s_JOY_STAT.bits;
       s_JOY_STAT.ACKINPUT = false;
@@ -736,8 +749,8 @@ void Pad::UpdateJoyStat()
 void Pad::TransferEvent(void*, TickCount ticks, TickCount ticks_late)
 {
   if (s_state == State::Transmitting)
-    DoTransfer(ticks_late);
-  else
+    FinishTransfer();
+  if (s_state == State::WaitingForACK)
     DoACK();
 }
 
@@ -766,10 +779,28 @@ void Pad::BeginTransfer()
   // until after (4) and (5) have been completed.
 
   s_state = State::Transmitting;
-  s_transfer_event->SetPeriodAndSchedule(GetTransferTicks());
+
+  // The device's reply only depends on the byte sent, so exchange it now, and use a single event for both the receive
+  // and the ACK. That halves the event reschedules per byte, which adds up with multitaps and memory cards. Register
+  // reads in between catch up on the receive through UpdateTransfer(), so the timing seen by the CPU is unchanged.
+  s_pending_ack = DoTransfer();
+  if (s_pending_ack)
+  {
+    const bool memcard_transfer =
+      s_active_device == ActiveDevice::MemoryCard ||
+      (s_active_device == ActiveDevice::Multitap && s_multitaps[s_JOY_CTRL.SLOT].IsReadingMemoryCard());
+
+    const TickCount ack_timer = GetACKTicks(memcard_transfer);
+    Log_DebugPrintf("Delaying ACK for %d ticks", ack_timer);
+    s_transfer_event->SetPeriodAndSchedule(GetTransferTicks() + ack_timer);
+  }
+  else
+  {
+    s_transfer_event->SetPeriodAndSchedule(GetTransferTicks());
+  }
 }
 
-void Pad::DoTransfer(TickCount ticks_late)
+bool Pad::DoTransfer()
 {
   Log_DebugPrintf("Transferring slot %d", s_JOY_CTRL.SLOT.GetValue());
 
@@ -827,6 +858,7 @@ void Pad::DoTransfer(TickCount ticks_late)
         else
         {
           // controller responded, make it the active device until non-ack
+          System::Internal::OnControllerLatched();
           Log_TracePrintf("Transfer to controller, data_out=0x%02X, data_in=0x%02X", data_out, data_in);
           s_active_device = ActiveDevice::Controller;
         }
@@ -867,30 +899,45 @@ void Pad::DoTransfer(TickCount ticks_late)
     break;
   }
 
-  s_receive_buffer = data_in;
-  s_receive_buffer_full = true;
+  s_pending_receive_value = data_in;
 
   // device no longer active?
   if (!ack)
-  {
     s_active_device = ActiveDevice::None;
+
+  return ack;
+}
+
+void Pad::FinishTransfer()
+{
+  DebugAssert(s_state == State::Transmitting);
+
+  s_receive_buffer = s_pending_receive_value;
+  s_receive_buffer_full = true;
+
+  // Without an ACK, the event only ran until the end of the transfer.
+  if (!s_pending_ack)
     EndTransfer();
-  }
   else
-  {
-    const bool memcard_transfer =
-      s_active_device == ActiveDevice::MemoryCard ||
-      (s_active_device == ActiveDevice::Multitap && s_multitaps[s_JOY_CTRL.SLOT].IsReadingMemoryCard());
-
-    const TickCount ack_timer = GetACKTicks(memcard_transfer);
-    Log_DebugPrintf("Delaying ACK for %d ticks", ack_timer);
     s_state = State::WaitingForACK;
-    s_transfer_event->SetPeriodAndSchedule(ack_timer);
-  }
 
   UpdateJoyStat();
 }
 
+void Pad::UpdateTransfer()
+{
+  if (!IsTransmitting())
+    return;
+
+  if (s_state == State::Transmitting && s_pending_ack &&
+      s_transfer_event->GetTicksSinceLastExecution() >= GetTransferTicks())
+  {
+    FinishTransfer();
+  }
+
+  s_transfer_event->InvokeEarly();
+}
+
 void Pad::DoACK()
 {
   s_JOY_STAT.ACKINPUT = true;
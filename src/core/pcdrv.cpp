@@ -6,13 +6,79 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "cpu_core.h"
 #include "settings.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 Log_SetChannel(PCDrv);
 
 static constexpr u32 MAX_FILES = 100;
 
-static std::vector<FileSystem::ManagedCFilePtr> s_files;
+/// Sequential reads fetch this much more of the file in the background.
+static constexpr u32 READAHEAD_SIZE = 64 * 1024;
+
+namespace {
+
+// File access happens on the I/O thread, except when the CPU thread has waited for all of a file's jobs to finish.
+struct PCDrvFile
+{
+  FileSystem::ManagedCFilePtr fp;
+  std::string path;
+
+  // Only accessed from the CPU thread.
+  s64 position = 0;
+  s64 last_read_end = -1;
+
+  // Written by the I/O thread, read by the CPU thread once pending_jobs is zero.
+  std::vector<u8> readahead_data;
+  s64 readahead_offset = 0;
+  std::atomic_bool write_error{false};
+
+  // Protected by s_io_mutex.
+  u32 pending_jobs = 0;
+};
+
+struct IOJob
+{
+  enum class Type : u8
+  {
+    Write,
+    ReadAhead,
+    Close,
+  };
+
+  Type type;
+  std::shared_ptr<PCDrvFile> file;
+  s64 offset;
+  std::vector<u8> data;
+};
+
+} // namespace
+
+static void QueueJob(IOJob job);
+static void WaitForFile(PCDrvFile* file);
+static void WaitForAllJobs();
+static void IOThreadEntryPoint();
+static void ExecuteJob(IOJob& job);
+
+static std::vector<std::shared_ptr<PCDrvFile>> s_files;
+
+static std::mutex s_io_mutex;
+static std::condition_variable s_io_cv;
+static std::condition_variable s_io_done_cv;
+static std::deque<IOJob> s_io_jobs;
+static u32 s_pending_job_count = 0;
+static std::thread s_io_thread;
+static bool s_io_thread_shutdown = false;
 
 enum PCDrvAttribute : u32
 {
@@ -23,6 +89,109 @@ enum PCDrvAttribute : u32
   PCDRV_ATTRIBUTE_ARCHIVE = (1 << 5),
 };
 
+void QueueJob(IOJob job)
+{
+  std::unique_lock lock(s_io_mutex);
+  job.file->pending_jobs++;
+  s_pending_job_count++;
+  s_io_jobs.push_back(std::move(job));
+
+  if (!s_io_thread.joinable())
+  {
+    s_io_thread_shutdown = false;
+    s_io_thread = std::thread(&IOThreadEntryPoint);
+  }
+
+  s_io_cv.notify_one();
+}
+
+void WaitForFile(PCDrvFile* file)
+{
+  std::unique_lock lock(s_io_mutex);
+  if (file->pending_jobs == 0)
+    return;
+
+  Log_DebugPrintf("Waiting for I/O on '%s'", file->path.c_str());
+  s_io_done_cv.wait(lock, [file]() { return (file->pending_jobs == 0); });
+}
+
+void WaitForAllJobs()
+{
+  std::unique_lock lock(s_io_mutex);
+  s_io_done_cv.wait(lock, []() { return (s_pending_job_count == 0); });
+}
+
+void IOThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("PCDrv I/O");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Background);
+
+  std::unique_lock lock(s_io_mutex);
+  for (;;)
+  {
+    s_io_cv.wait(lock, []() { return (s_io_thread_shutdown || !s_io_jobs.empty()); });
+    if (s_io_jobs.empty())
+      break;
+
+    IOJob job = std::move(s_io_jobs.front());
+    s_io_jobs.pop_front();
+
+    lock.unlock();
+    ExecuteJob(job);
+    lock.lock();
+
+    job.file->pending_jobs--;
+    s_pending_job_count--;
+    s_io_done_cv.notify_all();
+  }
+}
+
+void ExecuteJob(IOJob& job)
+{
+  PCDrvFile* file = job.file.get();
+  switch (job.type)
+  {
+    case IOJob::Type::Write:
+    {
+      // anything read ahead over this range is now stale
+      if (job.offset < static_cast<s64>(file->readahead_offset + file->readahead_data.size()) &&
+          (job.offset + static_cast<s64>(job.data.size())) > file->readahead_offset)
+      {
+        file->readahead_data.clear();
+      }
+
+      if (FileSystem::FSeek64(file->fp.get(), job.offset, SEEK_SET) != 0 ||
+          std::fwrite(job.data.data(), job.data.size(), 1, file->fp.get()) != 1)
+      {
+        Log_ErrorPrintf("Failed to write %zu bytes at offset %lld to '%s'", job.data.size(),
+                        static_cast<long long>(job.offset), file->path.c_str());
+        file->write_error = true;
+      }
+    }
+    break;
+
+    case IOJob::Type::ReadAhead:
+    {
+      file->readahead_data.resize(READAHEAD_SIZE);
+      file->readahead_offset = job.offset;
+
+      size_t bytes_read = 0;
+      if (FileSystem::FSeek64(file->fp.get(), job.offset, SEEK_SET) == 0)
+        bytes_read = std::fread(file->readahead_data.data(), 1, READAHEAD_SIZE, file->fp.get());
+
+      file->readahead_data.resize(bytes_read);
+    }
+    break;
+
+    case IOJob::Type::Close:
+    {
+      Log_DebugPrintf("Closing '%s'", file->path.c_str());
+      file->fp.reset();
+    }
+    break;
+  }
+}
+
 static s32 GetFreeFileHandle()
 {
   for (s32 i = 0; i < static_cast<s32>(s_files.size()); i++)
@@ -38,19 +207,22 @@ static s32 GetFreeFileHandle()
   }
 
   const s32 index = static_cast<s32>(s_files.size());
-  s_files.emplace_back(nullptr, FileSystem::FileDeleter());
+  s_files.emplace_back();
   return index;
 }
 
 static void CloseAllFiles()
 {
+  // writes have to land before the files are closed
+  WaitForAllJobs();
+
   if (!s_files.empty())
     Log_DevPrintf("Closing %zu open files.", s_files.size());
 
   s_files.clear();
 }
 
-static FILE* GetFileFromHandle(u32 handle)
+static PCDrvFile* GetFileFromHandle(u32 handle)
 {
   if (handle >= static_cast<u32>(s_files.size()) || !s_files[handle])
   {
@@ -69,12 +241,27 @@ static bool CloseFileHandle(u32 handle)
     return false;
   }
 
-  s_files[handle].reset();
+  // closed after any writes which are still queued
+  QueueJob(IOJob{IOJob::Type::Close, std::move(s_files[handle]), 0, {}});
   while (!s_files.empty() && !s_files.back())
     s_files.pop_back();
   return true;
 }
 
+static void ShutdownIOThread()
+{
+  if (!s_io_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(s_io_mutex);
+    s_io_thread_shutdown = true;
+    s_io_cv.notify_one();
+  }
+
+  s_io_thread.join();
+}
+
 static std::string ResolveHostPath(const std::string& path)
 {
   // Double-check that it falls within the directory of the elf.
@@ -111,6 +298,7 @@ void PCDrv::Reset()
 void PCDrv::Shutdown()
 {
   CloseAllFiles();
+  ShutdownIOThread();
 }
 
 bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
@@ -176,16 +364,23 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
         return true;
       }
 
-      s_files[handle] = FileSystem::OpenManagedCFile(filename.c_str(),
-                                                     is_open ? (g_settings.pcdrv_enable_writes ? "r+b" : "rb") : "w+b");
-      if (!s_files[handle])
+      // The file could have been closed with writes still in flight.
+      WaitForAllJobs();
+
+      FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(
+        filename.c_str(), is_open ? (g_settings.pcdrv_enable_writes ? "r+b" : "rb") : "w+b");
+      if (!fp)
       {
         Log_ErrorPrintf("%s: Failed to open '%s'", func, filename.c_str());
         RETURN_ERROR();
         return true;
       }
 
-      Log_DebugPrintf("PCDrv: Opened '%s' => %d", filename.c_str(), handle);
+      s_files[handle] = std::make_shared<PCDrvFile>();
+      s_files[handle]->fp = std::move(fp);
+      s_files[handle]->path = std::move(filename);
+
+      Log_DebugPrintf("PCDrv: Opened '%s' => %d", s_files[handle]->path.c_str(), handle);
       regs.v0 = 0;
       regs.v1 = static_cast<u32>(handle);
       return true;
@@ -210,35 +405,53 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
     {
       Log_DebugPrintf("PCread(%u, %u, 0x%08x)", regs.a1, regs.a2, regs.a3);
 
-      std::FILE* fp = GetFileFromHandle(regs.a1);
-      if (!fp)
+      PCDrvFile* file = GetFileFromHandle(regs.a1);
+      if (!file)
       {
         RETURN_ERROR();
         return true;
       }
 
+      // Only stalls if the read-ahead hasn't finished yet, or writes to this file are still queued.
+      WaitForFile(file);
+
       const u32 count = regs.a2;
-      u32 dstaddr = regs.a3;
-      for (u32 i = 0; i < count; i++)
+      std::vector<u8> buffer(count);
+      const s64 readahead_end = file->readahead_offset + static_cast<s64>(file->readahead_data.size());
+      if (file->position >= file->readahead_offset && (file->position + count) <= readahead_end)
       {
-        // Certainly less than optimal, but it's not like you're going to be reading megabytes of data here.
-        u8 val;
-        if (std::fread(&val, 1, 1, fp) != 1)
+        std::memcpy(buffer.data(), &file->readahead_data[file->position - file->readahead_offset], count);
+      }
+      else
+      {
+        // Does not stop at EOF according to psx-spx, the rest is zero.
+        if (FileSystem::FSeek64(file->fp.get(), file->position, SEEK_SET) != 0)
         {
-          // Does not stop at EOF according to psx-spx.
-          if (std::ferror(fp) != 0)
-          {
-            RETURN_ERROR();
-            return true;
-          }
-
-          val = 0;
+          RETURN_ERROR();
+          return true;
         }
 
-        CPU::SafeWriteMemoryByte(dstaddr, val);
-        dstaddr++;
+        std::fread(buffer.data(), 1, count, file->fp.get());
+        if (std::ferror(file->fp.get()) != 0)
+        {
+          std::clearerr(file->fp.get());
+          RETURN_ERROR();
+          return true;
+        }
       }
 
+      u32 dstaddr = regs.a3;
+      for (u32 i = 0; i < count; i++)
+        CPU::SafeWriteMemoryByte(dstaddr++, buffer[i]);
+
+      // Streaming tends to be in small chunks, so fetch the next part while the guest works on this one.
+      const bool sequential = (file->position == file->last_read_end);
+      file->position += count;
+      file->last_read_end = file->position;
+      if (sequential && (file->position + READAHEAD_SIZE / 2) > readahead_end &&
+          (file->readahead_data.size() == READAHEAD_SIZE || file->position >= readahead_end))
+        QueueJob(IOJob{IOJob::Type::ReadAhead, s_files[regs.a1], file->position, {}});
+
       regs.v0 = 0;
       regs.v1 = count;
       return true;
@@ -248,8 +461,15 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
     {
       Log_DebugPrintf("PCwrite(%u, %u, 0x%08x)", regs.a1, regs.a2, regs.a3);
 
-      std::FILE* fp = GetFileFromHandle(regs.a1);
-      if (!fp)
+      PCDrvFile* file = GetFileFromHandle(regs.a1);
+      if (!file)
+      {
+        RETURN_ERROR();
+        return true;
+      }
+
+      // A failed write can only be reported by the next call, since they complete in the background.
+      if (file->write_error.exchange(false))
       {
         RETURN_ERROR();
         return true;
@@ -257,23 +477,23 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
 
       const u32 count = regs.a2;
       u32 srcaddr = regs.a3;
-      u32 written = 0;
+      std::vector<u8> data;
+      data.reserve(count);
       for (u32 i = 0; i < count; i++)
       {
         u8 val;
         if (!CPU::SafeReadMemoryByte(srcaddr, &val))
           break;
 
-        if (std::fwrite(&val, 1, 1, fp) != 1)
-        {
-          RETURN_ERROR();
-          return true;
-        }
-
+        data.push_back(val);
         srcaddr++;
-        written++;
       }
 
+      const u32 written = static_cast<u32>(data.size());
+      if (written > 0)
+        QueueJob(IOJob{IOJob::Type::Write, s_files[regs.a1], file->position, std::move(data)});
+
+      file->position += written;
       regs.v0 = 0;
       regs.v1 = written;
       return true;
@@ -283,41 +503,47 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
     {
       Log_DebugPrintf("PClseek(%u, %u, %u)", regs.a1, regs.a2, regs.a3);
 
-      std::FILE* fp = GetFileFromHandle(regs.a1);
-      if (!fp)
+      PCDrvFile* file = GetFileFromHandle(regs.a1);
+      if (!file)
       {
         RETURN_ERROR();
         return true;
       }
 
+      // The position is tracked here, I/O jobs carry their own offsets.
       const s32 offset = static_cast<s32>(regs.a2);
       const u32 mode = regs.a3;
-      int hmode;
+      s64 new_position;
       switch (mode)
       {
         case 0:
-          hmode = SEEK_SET;
+          new_position = offset;
           break;
         case 1:
-          hmode = SEEK_CUR;
+          new_position = file->position + offset;
           break;
         case 2:
-          hmode = SEEK_END;
-          break;
+        {
+          // queued writes could extend the file
+          WaitForFile(file);
+          new_position = FileSystem::FSize64(file->fp.get()) + offset;
+        }
+        break;
         default:
           RETURN_ERROR();
           return true;
       }
 
-      if (FileSystem::FSeek64(fp, offset, hmode) != 0)
+      if (new_position < 0)
       {
-        Log_ErrorPrintf("FSeek for PCDrv failed: %d %u", offset, hmode);
+        Log_ErrorPrintf("FSeek for PCDrv failed: %d %u", offset, mode);
         RETURN_ERROR();
         return true;
       }
 
+      file->position = new_position;
       regs.v0 = 0;
-      regs.v1 = static_cast<u32>(static_cast<s32>(FileSystem::FTell64(fp)));
+      regs.v1 = static_cast<u32>(static_cast<s32>(new_position));
       return true;
     }
 
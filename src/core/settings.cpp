@@ -7,6 +7,7 @@
 #include "host.h"
 #include "system.h"
 
+#include "util/cd_image.h"
 #include "util/gpu_device.h"
 #include "util/imgui_manager.h"
 #include "util/input_manager.h"
@@ -159,6 +160,11 @@ void Settings::Load(SettingsInterface& si)
   rewind_save_frequency = si.GetFloatValue("Main", "RewindFrequency", 10.0f);
   rewind_save_slots = static_cast<u32>(si.GetIntValue("Main", "RewindSaveSlots", 10));
   runahead_frames = static_cast<u32>(si.GetIntValue("Main", "RunaheadFrameCount", 0));
+  late_input_polling = si.GetBoolValue("Main", "LateInputPolling", false);
+  thread_placement =
+    ParseThreadPlacementPolicy(
+      si.GetStringValue("Main", "ThreadPlacement", GetThreadPlacementPolicyName(DEFAULT_THREAD_PLACEMENT)).c_str())
+      .value_or(DEFAULT_THREAD_PLACEMENT);
 
   cpu_execution_mode =
     ParseCPUExecutionMode(
@@ -171,6 +177,11 @@ void Settings::Load(SettingsInterface& si)
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_persistent_cache = si.GetBoolValue("CPU", "RecompilerPersistentCache", false);
+  cpu_recompiler_defer_compilation = si.GetBoolValue("CPU", "RecompilerDeferCompilation", false);
+  cpu_recompiler_superblocks = si.GetBoolValue("CPU", "RecompilerSuperblocks", false);
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", false);
+  cpu_use_huge_pages = si.GetBoolValue("CPU", "UseHugePages", false);
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
@@ -179,8 +190,11 @@ void Settings::Load(SettingsInterface& si)
                    .value_or(DEFAULT_GPU_RENDERER);
   gpu_adapter = si.GetStringValue("GPU", "Adapter", "");
   gpu_resolution_scale = static_cast<u8>(si.GetIntValue("GPU", "ResolutionScale", 1));
+  gpu_dynamic_resolution = si.GetBoolValue("GPU", "DynamicResolution", false);
+  gpu_dynamic_resolution_min_scale = static_cast<u8>(si.GetIntValue("GPU", "DynamicResolutionMinScale", 1));
   gpu_multisamples = static_cast<u8>(si.GetIntValue("GPU", "Multisamples", 1));
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
+  gpu_use_null_device = si.GetBoolValue("GPU", "UseNullDevice", false);
   gpu_disable_shader_cache = si.GetBoolValue("GPU", "DisableShaderCache", false);
   gpu_disable_dual_source_blend = si.GetBoolValue("GPU", "DisableDualSourceBlend", false);
   gpu_disable_framebuffer_fetch = si.GetBoolValue("GPU", "DisableFramebufferFetch", false);
@@ -188,11 +202,21 @@ void Settings::Load(SettingsInterface& si)
   gpu_disable_texture_copy_to_self = si.GetBoolValue("GPU", "DisableTextureCopyToSelf", false);
   gpu_per_sample_shading = si.GetBoolValue("GPU", "PerSampleShading", false);
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_use_hardware_render_thread = si.GetBoolValue("GPU", "UseHardwareRenderThread", false);
+  gpu_sw_rasterizer_threads = static_cast<u8>(
+    std::clamp<s32>(si.GetIntValue("GPU", "SoftwareRasterizerThreads", DEFAULT_GPU_SW_RASTERIZER_THREADS), 1,
+                    MAX_GPU_SW_RASTERIZER_THREADS));
+  gpu_sw_span_jit = si.GetBoolValue("GPU", "SoftwareRasterizerJIT", false);
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
   gpu_threaded_presentation = si.GetBoolValue("GPU", "ThreadedPresentation", true);
+  gpu_non_blocking_presentation = si.GetBoolValue("GPU", "NonBlockingPresentation", false);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", true);
   gpu_debanding = si.GetBoolValue("GPU", "Debanding", false);
   gpu_scaled_dithering = si.GetBoolValue("GPU", "ScaledDithering", true);
+  gpu_batch_mixed_texture_modes = si.GetBoolValue("GPU", "BatchMixedTextureModes", false);
+  gpu_defer_pipeline_compilation = si.GetBoolValue("GPU", "DeferPipelineCompilation", false);
+  gpu_texture_filter_cache = si.GetBoolValue("GPU", "TextureFilterCache", false);
+  gpu_sparse_vram = si.GetBoolValue("GPU", "SparseVRAM", false);
   gpu_texture_filter =
     ParseTextureFilterName(
       si.GetStringValue("GPU", "TextureFilter", GetTextureFilterName(DEFAULT_GPU_TEXTURE_FILTER)).c_str())
@@ -267,10 +291,20 @@ void Settings::Load(SettingsInterface& si)
       .value_or(DEFAULT_DISPLAY_SCREENSHOT_FORMAT);
   display_screenshot_quality = static_cast<u8>(
     std::clamp<u32>(si.GetUIntValue("Display", "ScreenshotQuality", DEFAULT_DISPLAY_SCREENSHOT_QUALITY), 1, 100));
+  media_capture_encoder =
+    MediaCapture::ParseEncoderName(
+      si.GetStringValue("MediaCapture", "Encoder", MediaCapture::GetEncoderName(DEFAULT_MEDIA_CAPTURE_ENCODER)).c_str())
+      .value_or(DEFAULT_MEDIA_CAPTURE_ENCODER);
+  media_capture_video_bitrate = std::clamp<u32>(
+    si.GetUIntValue("MediaCapture", "VideoBitrate", DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE), 100, 100000);
+  media_capture_internal_resolution = si.GetBoolValue("MediaCapture", "InternalResolution", false);
   display_optimal_frame_pacing = si.GetBoolValue("Display", "OptimalFramePacing", false);
   display_pre_frame_sleep = si.GetBoolValue("Display", "PreFrameSleep", false);
   display_pre_frame_sleep_buffer =
     si.GetFloatValue("Display", "PreFrameSleepBuffer", DEFAULT_DISPLAY_PRE_FRAME_SLEEP_BUFFER);
+  display_adaptive_frame_skip = si.GetBoolValue("Display", "AdaptiveFrameSkip", false);
+  display_skip_unchanged_frames = si.GetBoolValue("Display", "SkipUnchangedFrames", false);
+  display_skip_unchanged_presents = si.GetBoolValue("Display", "SkipUnchangedPresents", false);
   display_vsync = si.GetBoolValue("Display", "VSync", false);
   display_force_4_3_for_24bit = si.GetBoolValue("Display", "Force4_3For24Bit", false);
   display_active_start_offset = static_cast<s16>(si.GetIntValue("Display", "ActiveStartOffset", 0));
@@ -305,6 +339,9 @@ void Settings::Load(SettingsInterface& si)
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
   cdrom_read_speedup = si.GetIntValue("CDROM", "ReadSpeedup", 1);
   cdrom_seek_speedup = si.GetIntValue("CDROM", "SeekSpeedup", 1);
+  cdrom_preload_memory_limit = si.GetUIntValue("CDROM", "PreloadMemoryLimit", DEFAULT_CDROM_PRELOAD_MEMORY_LIMIT);
+  cdrom_local_cache = si.GetBoolValue("CDROM", "LocalCache", false);
+  cdrom_local_cache_size = si.GetUIntValue("CDROM", "LocalCacheSize", DEFAULT_CDROM_LOCAL_CACHE_SIZE);
 
   audio_backend =
     AudioStream::ParseBackendName(
@@ -319,6 +356,8 @@ void Settings::Load(SettingsInterface& si)
   audio_output_muted = si.GetBoolValue("Audio", "OutputMuted", false);
 
   use_old_mdec_routines = si.GetBoolValue("Hacks", "UseOldMDECRoutines", false);
+  mdec_use_thread = si.GetBoolValue("Hacks", "UseMDECThread", false);
+  spu_use_thread = si.GetBoolValue("Hacks", "UseSPUThread", false);
   pcdrv_enable = si.GetBoolValue("PCDrv", "Enabled", false);
   pcdrv_enable_writes = si.GetBoolValue("PCDrv", "EnableWrites", false);
   pcdrv_root = si.GetStringValue("PCDrv", "Root");
@@ -364,6 +403,7 @@ void Settings::Load(SettingsInterface& si)
   memory_card_paths[0] = si.GetStringValue("MemoryCards", "Card1Path", "");
   memory_card_paths[1] = si.GetStringValue("MemoryCards", "Card2Path", "");
   memory_card_use_playlist_title = si.GetBoolValue("MemoryCards", "UsePlaylistTitle", true);
+  memory_card_sync_on_save = si.GetBoolValue("MemoryCards", "SyncOnSave", false);
 
   achievements_enabled = si.GetBoolValue("Cheevos", "Enabled", false);
   achievements_hardcore_mode = si.GetBoolValue("Cheevos", "ChallengeMode", false);
@@ -389,22 +429,28 @@ void Settings::Load(SettingsInterface& si)
   log_to_debug = si.GetBoolValue("Logging", "LogToDebug", false);
   log_to_window = si.GetBoolValue("Logging", "LogToWindow", false);
   log_to_file = si.GetBoolValue("Logging", "LogToFile", false);
+  log_async = si.GetBoolValue("Logging", "LogAsync", false);
 
   debugging.show_vram = si.GetBoolValue("Debug", "ShowVRAM");
   debugging.dump_cpu_to_vram_copies = si.GetBoolValue("Debug", "DumpCPUToVRAMCopies");
   debugging.dump_vram_to_cpu_copies = si.GetBoolValue("Debug", "DumpVRAMToCPUCopies");
   debugging.enable_gdb_server = si.GetBoolValue("Debug", "EnableGDBServer");
   debugging.gdb_server_port = static_cast<u16>(si.GetIntValue("Debug", "GDBServerPort"));
+  debugging.enable_metrics_server = si.GetBoolValue("Debug", "EnableMetricsServer");
+  debugging.metrics_server_port = static_cast<u16>(si.GetIntValue("Debug", "MetricsServerPort", 9260));
   debugging.show_gpu_state = si.GetBoolValue("Debug", "ShowGPUState");
   debugging.show_cdrom_state = si.GetBoolValue("Debug", "ShowCDROMState");
   debugging.show_spu_state = si.GetBoolValue("Debug", "ShowSPUState");
   debugging.show_timers_state = si.GetBoolValue("Debug", "ShowTimersState");
   debugging.show_mdec_state = si.GetBoolValue("Debug", "ShowMDECState");
   debugging.show_dma_state = si.GetBoolValue("Debug", "ShowDMAState");
+  debugging.show_memory_state = si.GetBoolValue("Debug", "ShowMemoryState");
 
   texture_replacements.enable_vram_write_replacements =
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   texture_replacements.preload_textures = si.GetBoolValue("TextureReplacements", "PreloadTextures", false);
+  texture_replacements.max_cache_size_mb = std::max<u32>(
+    si.GetUIntValue("TextureReplacements", "MaxCacheSizeMB", DEFAULT_TEXTURE_REPLACEMENT_CACHE_SIZE_MB), 16u);
   texture_replacements.dump_vram_writes = si.GetBoolValue("TextureReplacements", "DumpVRAMWrites", false);
   texture_replacements.dump_vram_write_force_alpha_channel =
     si.GetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel", true);
@@ -446,6 +492,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Main", "CompressSaveStates", compress_save_states);
     si.SetBoolValue("Main", "ConfirmPowerOff", confim_power_off);
     si.SetBoolValue("Main", "EnableDiscordPresence", enable_discord_presence);
+    si.SetStringValue("Main", "ThreadPlacement", GetThreadPlacementPolicyName(thread_placement));
   }
 
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
@@ -455,6 +502,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetFloatValue("Main", "RewindFrequency", rewind_save_frequency);
   si.SetIntValue("Main", "RewindSaveSlots", rewind_save_slots);
   si.SetIntValue("Main", "RunaheadFrameCount", runahead_frames);
+  si.SetBoolValue("Main", "LateInputPolling", late_input_polling);
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
   si.SetBoolValue("CPU", "OverclockEnable", cpu_overclock_enable);
@@ -463,16 +511,24 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerPersistentCache", cpu_recompiler_persistent_cache);
+  si.SetBoolValue("CPU", "RecompilerDeferCompilation", cpu_recompiler_defer_compilation);
+  si.SetBoolValue("CPU", "RecompilerSuperblocks", cpu_recompiler_superblocks);
+  si.SetBoolValue("CPU", "IdleLoopSkipping", cpu_idle_loop_skipping);
+  si.SetBoolValue("CPU", "UseHugePages", cpu_use_huge_pages);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
   si.SetIntValue("GPU", "ResolutionScale", static_cast<long>(gpu_resolution_scale));
+  si.SetBoolValue("GPU", "DynamicResolution", gpu_dynamic_resolution);
+  si.SetIntValue("GPU", "DynamicResolutionMinScale", static_cast<long>(gpu_dynamic_resolution_min_scale));
   si.SetIntValue("GPU", "Multisamples", static_cast<long>(gpu_multisamples));
 
   if (!ignore_base)
   {
     si.SetBoolValue("GPU", "UseDebugDevice", gpu_use_debug_device);
+    si.SetBoolValue("GPU", "UseNullDevice", gpu_use_null_device);
     si.SetBoolValue("GPU", "DisableShaderCache", gpu_disable_shader_cache);
     si.SetBoolValue("GPU", "DisableDualSourceBlend", gpu_disable_dual_source_blend);
     si.SetBoolValue("GPU", "DisableFramebufferFetch", gpu_disable_framebuffer_fetch);
@@ -482,11 +538,19 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
 
   si.SetBoolValue("GPU", "PerSampleShading", gpu_per_sample_shading);
   si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetBoolValue("GPU", "UseHardwareRenderThread", gpu_use_hardware_render_thread);
+  si.SetIntValue("GPU", "SoftwareRasterizerThreads", gpu_sw_rasterizer_threads);
+  si.SetBoolValue("GPU", "SoftwareRasterizerJIT", gpu_sw_span_jit);
   si.SetBoolValue("GPU", "ThreadedPresentation", gpu_threaded_presentation);
+  si.SetBoolValue("GPU", "NonBlockingPresentation", gpu_non_blocking_presentation);
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", gpu_use_software_renderer_for_readbacks);
   si.SetBoolValue("GPU", "TrueColor", gpu_true_color);
   si.SetBoolValue("GPU", "Debanding", gpu_debanding);
   si.SetBoolValue("GPU", "ScaledDithering", gpu_scaled_dithering);
+  si.SetBoolValue("GPU", "BatchMixedTextureModes", gpu_batch_mixed_texture_modes);
+  si.SetBoolValue("GPU", "DeferPipelineCompilation", gpu_defer_pipeline_compilation);
+  si.SetBoolValue("GPU", "TextureFilterCache", gpu_texture_filter_cache);
+  si.SetBoolValue("GPU", "SparseVRAM", gpu_sparse_vram);
   si.SetStringValue("GPU", "TextureFilter", GetTextureFilterName(gpu_texture_filter));
   si.SetStringValue("GPU", "LineDetectMode", GetLineDetectModeName(gpu_line_detect_mode));
   si.SetStringValue("GPU", "DownsampleMode", GetDownsampleModeName(gpu_downsample_mode));
@@ -520,12 +584,18 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("Display", "OptimalFramePacing", display_optimal_frame_pacing);
   si.SetBoolValue("Display", "PreFrameSleep", display_pre_frame_sleep);
   si.SetFloatValue("Display", "PreFrameSleepBuffer", display_pre_frame_sleep_buffer);
+  si.SetBoolValue("Display", "AdaptiveFrameSkip", display_adaptive_frame_skip);
+  si.SetBoolValue("Display", "SkipUnchangedFrames", display_skip_unchanged_frames);
+  si.SetBoolValue("Display", "SkipUnchangedPresents", display_skip_unchanged_presents);
   si.SetBoolValue("Display", "VSync", display_vsync);
   si.SetStringValue("Display", "ExclusiveFullscreenControl",
                     GetDisplayExclusiveFullscreenControlName(display_exclusive_fullscreen_control));
   si.SetStringValue("Display", "ScreenshotMode", GetDisplayScreenshotModeName(display_screenshot_mode));
   si.SetStringValue("Display", "ScreenshotFormat", GetDisplayScreenshotFormatName(display_screenshot_format));
   si.SetUIntValue("Display", "ScreenshotQuality", display_screenshot_quality);
+  si.SetStringValue("MediaCapture", "Encoder", MediaCapture::GetEncoderName(media_capture_encoder));
+  si.SetUIntValue("MediaCapture", "VideoBitrate", media_capture_video_bitrate);
+  si.SetBoolValue("MediaCapture", "InternalResolution", media_capture_internal_resolution);
   si.SetIntValue("Display", "CustomAspectRatioNumerator", display_aspect_ratio_custom_numerator);
   si.GetIntValue("Display", "CustomAspectRatioDenominator", display_aspect_ratio_custom_denominator);
   if (!ignore_base)
@@ -556,6 +626,9 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
   si.SetIntValue("CDROM", "ReadSpeedup", cdrom_read_speedup);
   si.SetIntValue("CDROM", "SeekSpeedup", cdrom_seek_speedup);
+  si.SetUIntValue("CDROM", "PreloadMemoryLimit", cdrom_preload_memory_limit);
+  si.SetBoolValue("CDROM", "LocalCache", cdrom_local_cache);
+  si.SetUIntValue("CDROM", "LocalCacheSize", cdrom_local_cache_size);
 
   si.SetStringValue("Audio", "Backend", AudioStream::GetBackendName(audio_backend));
   si.SetStringValue("Audio", "Driver", audio_driver.c_str());
@@ -566,6 +639,8 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
   si.SetBoolValue("Audio", "OutputMuted", audio_output_muted);
 
   si.SetBoolValue("Hacks", "UseOldMDECRoutines", use_old_mdec_routines);
+  si.SetBoolValue("Hacks", "UseMDECThread", mdec_use_thread);
+  si.SetBoolValue("Hacks", "UseSPUThread", spu_use_thread);
 
   if (!ignore_base)
   {
@@ -602,6 +677,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.DeleteValue("MemoryCards", "Card2Path");
 
   si.SetBoolValue("MemoryCards", "UsePlaylistTitle", memory_card_use_playlist_title);
+  si.SetBoolValue("MemoryCards", "SyncOnSave", memory_card_sync_on_save);
 
   si.SetStringValue("ControllerPorts", "MultitapMode", GetMultitapModeName(multitap_mode));
 
@@ -628,6 +704,7 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Logging", "LogToDebug", log_to_debug);
     si.SetBoolValue("Logging", "LogToWindow", log_to_window);
     si.SetBoolValue("Logging", "LogToFile", log_to_file);
+    si.SetBoolValue("Logging", "LogAsync", log_async);
 
     si.SetBoolValue("Debug", "ShowVRAM", debugging.show_vram);
     si.SetBoolValue("Debug", "DumpCPUToVRAMCopies", debugging.dump_cpu_to_vram_copies);
@@ -638,11 +715,13 @@ void Settings::Save(SettingsInterface& si, bool ignore_base) const
     si.SetBoolValue("Debug", "ShowTimersState", debugging.show_timers_state);
     si.SetBoolValue("Debug", "ShowMDECState", debugging.show_mdec_state);
     si.SetBoolValue("Debug", "ShowDMAState", debugging.show_dma_state);
+    si.SetBoolValue("Debug", "ShowMemoryState", debugging.show_memory_state);
   }
 
   si.SetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements",
                   texture_replacements.enable_vram_write_replacements);
   si.SetBoolValue("TextureReplacements", "PreloadTextures", texture_replacements.preload_textures);
+  si.SetUIntValue("TextureReplacements", "MaxCacheSizeMB", texture_replacements.max_cache_size_mb);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWrites", texture_replacements.dump_vram_writes);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel",
                   texture_replacements.dump_vram_write_force_alpha_channel);
@@ -796,6 +875,7 @@ void Settings::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.debugging.show_timers_state = false;
     g_settings.debugging.show_mdec_state = false;
     g_settings.debugging.show_dma_state = false;
+    g_settings.debugging.show_memory_state = false;
     g_settings.debugging.dump_cpu_to_vram_copies = false;
     g_settings.debugging.dump_vram_to_cpu_copies = false;
   }
@@ -807,6 +887,7 @@ void Settings::UpdateLogSettings()
   Log::SetLogFilter(log_filter);
   Log::SetConsoleOutputParams(log_to_console, log_timestamps);
   Log::SetDebugOutputParams(log_to_debug);
+  Log::SetAsyncOutput(log_async);
 
   if (log_to_file)
   {
@@ -996,6 +1077,37 @@ const char* Settings::GetCPUFastmemModeDisplayName(CPUFastmemMode mode)
   return Host::TranslateToCString("CPUFastmemMode", s_cpu_fastmem_mode_display_names[static_cast<u8>(mode)]);
 }
 
+static constexpr const std::array s_thread_placement_policy_names = {"Default", "PerformanceCores", "SplitCores"};
+static constexpr const std::array s_thread_placement_policy_display_names = {
+  TRANSLATE_NOOP("ThreadPlacementPolicy", "Default (Let OS Decide)"),
+  TRANSLATE_NOOP("ThreadPlacementPolicy", "Prefer Performance Cores"),
+  TRANSLATE_NOOP("ThreadPlacementPolicy", "Split Performance/Efficiency Cores")};
+
+std::optional<Threading::ThreadPlacementPolicy> Settings::ParseThreadPlacementPolicy(const char* str)
+{
+  u8 index = 0;
+  for (const char* name : s_thread_placement_policy_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<Threading::ThreadPlacementPolicy>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetThreadPlacementPolicyName(Threading::ThreadPlacementPolicy policy)
+{
+  return s_thread_placement_policy_names[static_cast<u8>(policy)];
+}
+
+const char* Settings::GetThreadPlacementPolicyDisplayName(Threading::ThreadPlacementPolicy policy)
+{
+  return Host::TranslateToCString("ThreadPlacementPolicy",
+                                  s_thread_placement_policy_display_names[static_cast<u8>(policy)]);
+}
+
 static constexpr const std::array s_gpu_renderer_names = {
   "Automatic",
 #ifdef _WIN32
@@ -1704,6 +1816,7 @@ std::string EmuFolders::Screenshots;
 std::string EmuFolders::Shaders;
 std::string EmuFolders::Textures;
 std::string EmuFolders::UserResources;
+std::string EmuFolders::Videos;
 
 void EmuFolders::SetDefaults()
 {
@@ -1720,6 +1833,7 @@ void EmuFolders::SetDefaults()
   Shaders = Path::Combine(DataRoot, "shaders");
   Textures = Path::Combine(DataRoot, "textures");
   UserResources = Path::Combine(DataRoot, "resources");
+  Videos = Path::Combine(DataRoot, "videos");
 }
 
 static std::string LoadPathFromSettings(SettingsInterface& si, const std::string& root, const char* section,
@@ -1749,6 +1863,8 @@ void EmuFolders::LoadConfig(SettingsInterface& si)
   Shaders = LoadPathFromSettings(si, DataRoot, "Folders", "Shaders", "shaders");
   Textures = LoadPathFromSettings(si, DataRoot, "Folders", "Textures", "textures");
   UserResources = LoadPathFromSettings(si, DataRoot, "Folders", "UserResources", "resources");
+  Videos = LoadPathFromSettings(si, DataRoot, "Folders", "Videos", "videos");
+  CDImage::SetIndexCacheDirectory(Path::Combine(Cache, "discindex"));
 
   Log_DevFmt("BIOS Directory: {}", Bios);
   Log_DevFmt("Cache Directory: {}", Cache);
@@ -1764,6 +1880,7 @@ void EmuFolders::LoadConfig(SettingsInterface& si)
   Log_DevFmt("Shaders Directory: {}", Shaders);
   Log_DevFmt("Textures Directory: {}", Textures);
   Log_DevFmt("User Resources Directory: {}", UserResources);
+  Log_DevFmt("Videos Directory: {}", Videos);
 }
 
 void EmuFolders::Save(SettingsInterface& si)
@@ -1782,6 +1899,7 @@ void EmuFolders::Save(SettingsInterface& si)
   si.SetStringValue("Folders", "Shaders", Path::MakeRelative(Shaders, DataRoot).c_str());
   si.SetStringValue("Folders", "Textures", Path::MakeRelative(Textures, DataRoot).c_str());
   si.SetStringValue("Folders", "UserResources", Path::MakeRelative(UserResources, DataRoot).c_str());
+  si.SetStringValue("Folders", "Videos", Path::MakeRelative(Videos, DataRoot).c_str());
 }
 
 void EmuFolders::Update()
@@ -1810,6 +1928,7 @@ bool EmuFolders::EnsureFoldersExist()
   result = FileSystem::EnsureDirectoryExists(Cache.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Path::Combine(Cache, "achievement_badge").c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Path::Combine(Cache, "achievement_gameicon").c_str(), false) && result;
+  result = FileSystem::EnsureDirectoryExists(Path::Combine(Cache, "discindex").c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Cheats.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Covers.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Dumps.c_str(), false) && result;
@@ -6,10 +6,12 @@
 #include "types.h"
 
 #include "util/audio_stream.h"
+#include "util/media_capture.h"
 
 #include "common/log.h"
 #include "common/settings_interface.h"
 #include "common/small_string.h"
+#include "common/threading.h"
 
 #include <array>
 #include <optional>
@@ -70,6 +72,11 @@ struct Settings
   bool cpu_recompiler_memory_exceptions : 1 = false;
   bool cpu_recompiler_block_linking : 1 = true;
   bool cpu_recompiler_icache : 1 = false;
+  bool cpu_recompiler_persistent_cache : 1 = false;
+  bool cpu_recompiler_defer_compilation : 1 = false;
+  bool cpu_recompiler_superblocks : 1 = false;
+  bool cpu_idle_loop_skipping : 1 = false;
+  bool cpu_use_huge_pages : 1 = false;
   CPUFastmemMode cpu_fastmem_mode = DEFAULT_CPU_FASTMEM_MODE;
 
   float emulation_speed = 1.0f;
@@ -97,15 +104,24 @@ struct Settings
   float rewind_save_frequency = 10.0f;
   u32 rewind_save_slots = 10;
   u32 runahead_frames = 0;
+  bool late_input_polling = false;
+
+  Threading::ThreadPlacementPolicy thread_placement = DEFAULT_THREAD_PLACEMENT;
 
   GPURenderer gpu_renderer = DEFAULT_GPU_RENDERER;
   std::string gpu_adapter;
   u8 gpu_resolution_scale = 1;
+  u8 gpu_dynamic_resolution_min_scale = 1;
   u8 gpu_multisamples = 1;
+  u8 gpu_sw_rasterizer_threads = DEFAULT_GPU_SW_RASTERIZER_THREADS;
   bool gpu_use_thread : 1 = true;
+  bool gpu_use_hardware_render_thread : 1 = false;
+  bool gpu_sw_span_jit : 1 = false;
   bool gpu_use_software_renderer_for_readbacks : 1 = false;
   bool gpu_threaded_presentation : 1 = true;
+  bool gpu_non_blocking_presentation : 1 = false;
   bool gpu_use_debug_device : 1 = false;
+  bool gpu_use_null_device : 1 = false;
   bool gpu_disable_shader_cache : 1 = false;
   bool gpu_disable_dual_source_blend : 1 = false;
   bool gpu_disable_framebuffer_fetch : 1 = false;
@@ -115,6 +131,11 @@ struct Settings
   bool gpu_true_color : 1 = true;
   bool gpu_debanding : 1 = false;
   bool gpu_scaled_dithering : 1 = true;
+  bool gpu_batch_mixed_texture_modes : 1 = false;
+  bool gpu_defer_pipeline_compilation : 1 = false;
+  bool gpu_texture_filter_cache : 1 = false;
+  bool gpu_dynamic_resolution : 1 = false;
+  bool gpu_sparse_vram : 1 = false;
   GPUTextureFilter gpu_texture_filter = DEFAULT_GPU_TEXTURE_FILTER;
   GPULineDetectMode gpu_line_detect_mode = DEFAULT_GPU_LINE_DETECT_MODE;
   GPUDownsampleMode gpu_downsample_mode = DEFAULT_GPU_DOWNSAMPLE_MODE;
@@ -140,6 +161,8 @@ struct Settings
   DisplayScreenshotMode display_screenshot_mode = DEFAULT_DISPLAY_SCREENSHOT_MODE;
   DisplayScreenshotFormat display_screenshot_format = DEFAULT_DISPLAY_SCREENSHOT_FORMAT;
   u8 display_screenshot_quality = DEFAULT_DISPLAY_SCREENSHOT_QUALITY;
+  MediaCaptureEncoder media_capture_encoder = DEFAULT_MEDIA_CAPTURE_ENCODER;
+  u32 media_capture_video_bitrate = DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE;
   u16 display_aspect_ratio_custom_numerator = 0;
   u16 display_aspect_ratio_custom_denominator = 0;
   s16 display_active_start_offset = 0;
@@ -148,6 +171,9 @@ struct Settings
   s8 display_line_end_offset = 0;
   bool display_optimal_frame_pacing : 1 = false;
   bool display_pre_frame_sleep : 1 = false;
+  bool display_adaptive_frame_skip : 1 = false;
+  bool display_skip_unchanged_frames : 1 = false;
+  bool display_skip_unchanged_presents : 1 = false;
   bool display_vsync : 1 = false;
   bool display_force_4_3_for_24bit : 1 = false;
   bool gpu_24bit_chroma_smoothing : 1 = false;
@@ -164,6 +190,7 @@ struct Settings
   bool display_show_inputs : 1 = false;
   bool display_show_enhancements : 1 = false;
   bool display_stretch_vertically : 1 = false;
+  bool media_capture_internal_resolution : 1 = false;
   float display_pre_frame_sleep_buffer = DEFAULT_DISPLAY_PRE_FRAME_SLEEP_BUFFER;
   float display_max_fps = DEFAULT_DISPLAY_MAX_FPS;
   float display_osd_scale = 100.0f;
@@ -176,8 +203,11 @@ struct Settings
   bool cdrom_load_image_to_ram : 1 = false;
   bool cdrom_load_image_patches : 1 = false;
   bool cdrom_mute_cd_audio : 1 = false;
+  bool cdrom_local_cache : 1 = false;
   u32 cdrom_read_speedup = 1;
   u32 cdrom_seek_speedup = 1;
+  u32 cdrom_preload_memory_limit = DEFAULT_CDROM_PRELOAD_MEMORY_LIMIT;
+  u32 cdrom_local_cache_size = DEFAULT_CDROM_LOCAL_CACHE_SIZE;
 
   std::string audio_driver;
   std::string audio_output_device;
@@ -188,6 +218,8 @@ struct Settings
   bool audio_output_muted : 1 = false;
 
   bool use_old_mdec_routines : 1 = false;
+  bool mdec_use_thread : 1 = false;
+  bool spu_use_thread : 1 = false;
   bool pcdrv_enable : 1 = false;
 
   // timing hacks section
@@ -220,6 +252,9 @@ struct Settings
     bool enable_gdb_server : 1 = false;
     u16 gdb_server_port = 1234;
 
+    bool enable_metrics_server : 1 = false;
+    u16 metrics_server_port = 9260;
+
     // Mutable because the imgui window can close itself.
     mutable bool show_gpu_state = false;
     mutable bool show_cdrom_state = false;
@@ -227,6 +262,7 @@ struct Settings
     mutable bool show_timers_state = false;
     mutable bool show_mdec_state = false;
     mutable bool show_dma_state = false;
+    mutable bool show_memory_state = false;
   } debugging;
 
   // texture replacements
@@ -237,6 +273,7 @@ struct Settings
 
     bool dump_vram_writes : 1 = false;
     bool dump_vram_write_force_alpha_channel : 1 = true;
+    u32 max_cache_size_mb = DEFAULT_TEXTURE_REPLACEMENT_CACHE_SIZE_MB;
     u32 dump_vram_write_width_threshold = 128;
     u32 dump_vram_write_height_threshold = 128;
 
@@ -258,6 +295,7 @@ struct Settings
   std::array<MemoryCardType, NUM_CONTROLLER_AND_CARD_PORTS> memory_card_types{};
   std::array<std::string, NUM_CONTROLLER_AND_CARD_PORTS> memory_card_paths{};
   bool memory_card_use_playlist_title = true;
+  bool memory_card_sync_on_save = false;
 
   MultitapMode multitap_mode = DEFAULT_MULTITAP_MODE;
 
@@ -271,6 +309,7 @@ struct Settings
   bool log_to_debug : 1 = false;
   bool log_to_window : 1 = false;
   bool log_to_file : 1 = false;
+  bool log_async : 1 = false;
 
   ALWAYS_INLINE bool IsUsingSoftwareRenderer() const { return (gpu_renderer == GPURenderer::Software); }
   ALWAYS_INLINE bool IsRunaheadEnabled() const { return (runahead_frames > 0); }
@@ -340,6 +379,7 @@ struct Settings
     DEFAULT_GPU_MAX_RUN_AHEAD = 128,
     DEFAULT_VRAM_WRITE_DUMP_WIDTH_THRESHOLD = 128,
     DEFAULT_VRAM_WRITE_DUMP_HEIGHT_THRESHOLD = 128,
+    DEFAULT_TEXTURE_REPLACEMENT_CACHE_SIZE_MB = 1024,
   };
 
   void Load(SettingsInterface& si);
@@ -375,6 +415,10 @@ struct Settings
   static const char* GetCPUFastmemModeName(CPUFastmemMode mode);
   static const char* GetCPUFastmemModeDisplayName(CPUFastmemMode mode);
 
+  static std::optional<Threading::ThreadPlacementPolicy> ParseThreadPlacementPolicy(const char* str);
+  static const char* GetThreadPlacementPolicyName(Threading::ThreadPlacementPolicy policy);
+  static const char* GetThreadPlacementPolicyDisplayName(Threading::ThreadPlacementPolicy policy);
+
   static std::optional<GPURenderer> ParseRendererName(const char* str);
   static const char* GetRendererName(GPURenderer renderer);
   static const char* GetRendererDisplayName(GPURenderer renderer);
@@ -448,6 +492,8 @@ struct Settings
   static constexpr GPULineDetectMode DEFAULT_GPU_LINE_DETECT_MODE = GPULineDetectMode::Disabled;
   static constexpr GPUDownsampleMode DEFAULT_GPU_DOWNSAMPLE_MODE = GPUDownsampleMode::Disabled;
   static constexpr GPUWireframeMode DEFAULT_GPU_WIREFRAME_MODE = GPUWireframeMode::Disabled;
+  static constexpr u8 DEFAULT_GPU_SW_RASTERIZER_THREADS = 1;
+  static constexpr u8 MAX_GPU_SW_RASTERIZER_THREADS = 16;
   static constexpr ConsoleRegion DEFAULT_CONSOLE_REGION = ConsoleRegion::Auto;
   static constexpr float DEFAULT_GPU_PGXP_DEPTH_THRESHOLD = 300.0f;
   static constexpr float GPU_PGXP_DEPTH_THRESHOLD_SCALE = 4096.0f;
@@ -466,6 +512,9 @@ struct Settings
   static constexpr CPUFastmemMode DEFAULT_CPU_FASTMEM_MODE = CPUFastmemMode::LUT;
 #endif
 
+  static constexpr Threading::ThreadPlacementPolicy DEFAULT_THREAD_PLACEMENT =
+    Threading::ThreadPlacementPolicy::Default;
+
   static constexpr DisplayDeinterlacingMode DEFAULT_DISPLAY_DEINTERLACING_MODE = DisplayDeinterlacingMode::Adaptive;
   static constexpr DisplayCropMode DEFAULT_DISPLAY_CROP_MODE = DisplayCropMode::Overscan;
   static constexpr DisplayAspectRatio DEFAULT_DISPLAY_ASPECT_RATIO = DisplayAspectRatio::Auto;
@@ -476,10 +525,14 @@ struct Settings
   static constexpr DisplayScreenshotMode DEFAULT_DISPLAY_SCREENSHOT_MODE = DisplayScreenshotMode::ScreenResolution;
   static constexpr DisplayScreenshotFormat DEFAULT_DISPLAY_SCREENSHOT_FORMAT = DisplayScreenshotFormat::PNG;
   static constexpr u8 DEFAULT_DISPLAY_SCREENSHOT_QUALITY = 85;
+  static constexpr MediaCaptureEncoder DEFAULT_MEDIA_CAPTURE_ENCODER = MediaCaptureEncoder::Software;
+  static constexpr u32 DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE = 6000;
   static constexpr float DEFAULT_DISPLAY_PRE_FRAME_SLEEP_BUFFER = 2.0f;
   static constexpr float DEFAULT_OSD_SCALE = 100.0f;
 
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u32 DEFAULT_CDROM_PRELOAD_MEMORY_LIMIT = 1024; // MB
+  static constexpr u32 DEFAULT_CDROM_LOCAL_CACHE_SIZE = 16384;    // MB
   static constexpr CDROMMechaconVersion DEFAULT_CDROM_MECHACON_VERSION = CDROMMechaconVersion::VC1A;
 
   static constexpr ControllerType DEFAULT_CONTROLLER_1_TYPE = ControllerType::AnalogController;
@@ -533,6 +586,7 @@ extern std::string Screenshots;
 extern std::string Shaders;
 extern std::string Textures;
 extern std::string UserResources;
+extern std::string Videos;
 
 // Assumes that AppRoot and DataRoot have been initialized.
 void SetDefaults();
@@ -11,6 +11,7 @@
 
 #include "util/audio_stream.h"
 #include "util/imgui_manager.h"
+#include "util/media_capture.h"
 #include "util/state_wrapper.h"
 #include "util/wav_writer.h"
 
@@ -18,10 +19,17 @@
 #include "common/bitutils.h"
 #include "common/error.h"
 #include "common/fifo_queue.h"
+#include "common/intrin.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/threading.h"
+#include "common/trace.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 Log_SetChannel(SPU);
 
@@ -53,7 +61,14 @@ enum : u32
   CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400,
   MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2,
   NUM_REVERB_REGS = 32,
-  FIFO_SIZE_IN_HALFWORDS = 32
+  FIFO_SIZE_IN_HALFWORDS = 32,
+  ADPCM_BLOCK_CACHE_SIZE = 512,
+  ADPCM_BLOCK_CACHE_INVALID_ADDRESS = 0xFFFFFFFFu,
+
+  THREAD_COMMAND_QUEUE_SIZE = 64 * 1024,
+  THREAD_CD_AUDIO_QUEUE_SIZE = 8 * 1024,
+  MAX_THREAD_FRAMES_PER_COMMAND = 1024,
+  THREAD_SYNC_SPIN_ITERATIONS = 4096,
 };
 enum : s16
 {
@@ -238,6 +253,16 @@ enum class ADSRPhase : u8
   Release = 4
 };
 
+/// Samples from a previous decode of a block. Decoding depends on the filter history from the previous block, so an
+/// entry is only reused when the voice's history matches, which makes the result identical to decoding again.
+struct DecodedADPCMBlock
+{
+  u32 address;
+  std::array<s16, 2> history;
+  ADPCMFlags flags;
+  std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+};
+
 struct Voice
 {
   u16 current_address;
@@ -265,6 +290,7 @@ struct Voice
   void ForceOff();
 
   void DecodeBlock(const ADPCMBlock& block);
+  void LoadDecodedBlock(const DecodedADPCMBlock& block);
   s32 Interpolate() const;
 
   // Switches to the specified phase, filling in target.
@@ -310,6 +336,20 @@ struct ReverbRegisters
     u16 rev[NUM_REVERB_REGS];
   };
 };
+
+enum class ThreadCommandType : u8
+{
+  GenerateFrames, // param = frame count, value = output muted
+  WriteRegister,  // param = register offset
+  WriteRAM,       // param = RAM address
+};
+
+struct ThreadCommand
+{
+  ThreadCommandType type;
+  u16 value;
+  u32 param;
+};
 } // namespace
 
 static ADSRPhase GetNextADSRPhase(ADSRPhase phase);
@@ -330,7 +370,11 @@ static void CheckForLateRAMIRQs();
 static void WriteToCaptureBuffer(u32 index, s16 value);
 static void IncrementCaptureBufferPosition();
 
+static void CheckADPCMBlockIRQ(u32 ram_address);
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
+static void ReadAndDecodeADPCMBlock(Voice& voice);
+static void InvalidateDecodedADPCMBlocks(u32 ram_address);
+static void InvalidateAllDecodedADPCMBlocks();
 static std::tuple<s32, s32> SampleVoice(u32 voice_index);
 
 static void UpdateNoise();
@@ -341,8 +385,23 @@ static void ReverbWrite(u32 address, s16 data);
 static void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
 static void Execute(void* param, TickCount ticks, TickCount ticks_late);
+static void GenerateFrames(u32 remaining_frames, AudioStream* output_stream);
 static void UpdateEventInterval();
 
+static void ApplyRegisterWrite(u32 offset, u16 value);
+static void WriteTransferRAM(u32 address, u16 value);
+
+static bool IsCPUThreadRegister(u32 offset);
+static void GeneratePendingSamplesForRead();
+static void UpdateThreadActive();
+static void StartThread();
+static void StopThread();
+static void WakeThread();
+static void PushThreadCommand(const ThreadCommand& cmd, bool wake);
+static void QueueThreadFrames(u32 frames);
+static std::tuple<s16, s16> PopThreadCDAudioFrame();
+static void ThreadEntryPoint();
+
 static void ExecuteFIFOWriteToRAM(TickCount& ticks);
 static void ExecuteFIFOReadFromRAM(TickCount& ticks);
 static void ExecuteTransfer(void* param, TickCount ticks, TickCount ticks_late);
@@ -403,6 +462,11 @@ static s32 s_reverb_resample_buffer_position = 0;
 
 static std::array<Voice, NUM_VOICES> s_voices{};
 
+// Direct-mapped by block address.
+static std::array<DecodedADPCMBlock, ADPCM_BLOCK_CACHE_SIZE> s_adpcm_block_cache;
+static u32 s_adpcm_block_cache_hits = 0;
+static u32 s_adpcm_block_cache_misses = 0;
+
 static InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> s_transfer_fifo;
 
 static std::array<u8, RAM_SIZE> s_ram{};
@@ -411,6 +475,26 @@ static std::array<u8, RAM_SIZE> s_ram{};
 // +1 for reverb output
 static std::array<std::unique_ptr<WAVWriter>, NUM_VOICES + 1> s_voice_dump_writers;
 #endif
+
+// With the thread active, the CPU thread journals register and RAM writes, along with how many frames to generate
+// between them. The thread owns the voice, mixing and reverb state, and SPU RAM, until it has drained the journal.
+// The CPU thread keeps the transfer FIFO, control and status registers. The thread is only used while the RAM IRQ is
+// disabled, since IRQs can't be raised late, so every write to SPUCNT catches up first.
+static std::thread s_thread;
+static std::mutex s_thread_mutex;
+static std::condition_variable s_thread_wake_cv;
+static std::condition_variable s_thread_idle_cv;
+static std::atomic_bool s_thread_sleeping{false};
+static bool s_thread_shutdown = false;
+static bool s_thread_active = false;
+static u16 s_thread_capture_buffer_position = 0;
+static thread_local bool s_on_spu_thread = false;
+
+// Only pushed to by the CPU thread, and commands are removed once they've executed, so empty means caught up.
+static SPSCFIFOQueue<ThreadCommand, THREAD_COMMAND_QUEUE_SIZE> s_thread_commands;
+
+// CD audio belongs to the CPU thread, so it's read when the frames are queued.
+static SPSCFIFOQueue<u32, THREAD_CD_AUDIO_QUEUE_SIZE> s_thread_cd_audio_frames;
 } // namespace SPU
 
 void SPU::Initialize()
@@ -425,6 +509,10 @@ void SPU::Initialize()
   s_null_audio_stream = AudioStream::CreateNullStream(SAMPLE_RATE, g_settings.audio_stream_parameters.buffer_ms);
 
   CreateOutputStream();
+
+  if (g_settings.spu_use_thread)
+    StartThread();
+
   Reset();
 }
 
@@ -458,6 +546,7 @@ void SPU::CreateOutputStream()
 
 void SPU::RecreateOutputStream()
 {
+  SyncThread();
   s_audio_stream.reset();
   CreateOutputStream();
 }
@@ -473,6 +562,7 @@ void SPU::CPUClockChanged()
 
 void SPU::Shutdown()
 {
+  StopThread();
   StopDumpingAudio();
   s_tick_event.reset();
   s_transfer_event.reset();
@@ -481,6 +571,7 @@ void SPU::Shutdown()
 
 void SPU::Reset()
 {
+  SyncThread();
   s_ticks_carry = 0;
 
   s_SPUCNT.bits = 0;
@@ -535,11 +626,17 @@ void SPU::Reset()
   s_transfer_event->Deactivate();
   s_transfer_fifo.Clear();
   s_ram.fill(0);
+  InvalidateAllDecodedADPCMBlocks();
+  s_adpcm_block_cache_hits = 0;
+  s_adpcm_block_cache_misses = 0;
+  UpdateThreadActive();
   UpdateEventInterval();
 }
 
 bool SPU::DoState(StateWrapper& sw)
 {
+  SyncThread();
+
   sw.Do(&s_ticks_carry);
   sw.Do(&s_SPUCNT.bits);
   sw.Do(&s_SPUSTAT.bits);
@@ -601,6 +698,8 @@ bool SPU::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    InvalidateAllDecodedADPCMBlocks();
+    UpdateThreadActive();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -610,6 +709,11 @@ bool SPU::DoState(StateWrapper& sw)
 
 u16 SPU::ReadRegister(u32 offset)
 {
+  // Registers other than those kept by the CPU thread need the SPU thread to catch up to the read first. Samples are
+  // only generated for registers which mixing changes, since both paths have to generate at the same points.
+  if (s_thread_active && !IsCPUThreadRegister(offset))
+    SyncThread();
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -625,15 +729,19 @@ u16 SPU::ReadRegister(u32 offset)
       return s_reverb_registers.vROUT;
 
     case 0x1F801D88 - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_key_on_register);
 
     case 0x1F801D8A - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_key_on_register >> 16);
 
     case 0x1F801D8C - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_key_off_register);
 
     case 0x1F801D8E - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_key_off_register >> 16);
 
     case 0x1F801D90 - SPU_BASE:
@@ -655,9 +763,11 @@ u16 SPU::ReadRegister(u32 offset)
       return Truncate16(s_reverb_on_register >> 16);
 
     case 0x1F801D9C - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_endx_register);
 
     case 0x1F801D9E - SPU_BASE:
+      GeneratePendingSamplesForRead();
       return Truncate16(s_endx_register >> 16);
 
     case 0x1F801DA2 - SPU_BASE:
@@ -701,11 +811,11 @@ u16 SPU::ReadRegister(u32 offset)
       return s_external_volume_right;
 
     case 0x1F801DB8 - SPU_BASE:
-      GeneratePendingSamples();
+      GeneratePendingSamplesForRead();
       return s_main_volume_left.current_level;
 
     case 0x1F801DBA - SPU_BASE:
-      GeneratePendingSamples();
+      GeneratePendingSamplesForRead();
       return s_main_volume_right.current_level;
 
     default:
@@ -719,7 +829,7 @@ u16 SPU::ReadRegister(u32 offset)
       if (offset >= (0x1F801E00 - SPU_BASE) && offset < (0x1F801E60 - SPU_BASE))
       {
         const u32 voice_index = (offset - (0x1F801E00 - SPU_BASE)) / 4;
-        GeneratePendingSamples();
+        GeneratePendingSamplesForRead();
         if (offset & 0x02)
           return s_voices[voice_index].left_volume.current_level;
         else
@@ -733,6 +843,29 @@ u16 SPU::ReadRegister(u32 offset)
 }
 
 void SPU::WriteRegister(u32 offset, u16 value)
+{
+  if (s_thread_active)
+  {
+    // The SPU thread applies the write once it has generated the samples leading up to it.
+    if (!IsCPUThreadRegister(offset))
+    {
+      GeneratePendingSamples();
+      PushThreadCommand(ThreadCommand{ThreadCommandType::WriteRegister, value, offset}, false);
+      return;
+    }
+
+    // SPUCNT affects mixing, transfers and whether the thread can be used at all.
+    if (offset == (0x1F801DAA - SPU_BASE))
+    {
+      GeneratePendingSamples();
+      SyncThread();
+    }
+  }
+
+  ApplyRegisterWrite(offset, value);
+}
+
+void SPU::ApplyRegisterWrite(u32 offset, u16 value)
 {
   switch (offset)
   {
@@ -947,6 +1080,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
         CheckForLateRAMIRQs();
       }
 
+      UpdateThreadActive();
       UpdateEventInterval();
       UpdateDMARequest();
       UpdateTransferEvent();
@@ -1031,7 +1165,7 @@ u16 SPU::ReadVoiceRegister(u32 offset)
   // ADSR volume needs to be updated when reading. A voice might be off as well, but key on is pending.
   const Voice& voice = s_voices[voice_index];
   if (reg_index >= 6 && (voice.IsOn() || s_key_on_register & (1u << voice_index)))
-    GeneratePendingSamples();
+    GeneratePendingSamplesForRead();
 
   Log_TraceFmt("Read voice {} register {} -> 0x{:02X}", voice_index, reg_index, voice.regs.index[reg_index]);
   return voice.regs.index[reg_index];
@@ -1204,6 +1338,7 @@ void SPU::WriteToCaptureBuffer(u32 index, s16 value)
   const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(s_capture_buffer_position);
   // Log_DebugFmt("write to capture buffer {} (0x{:08X}) <- 0x{:04X}", index, ram_address, u16(value));
   std::memcpy(&s_ram[ram_address], &value, sizeof(value));
+  InvalidateDecodedADPCMBlocks(ram_address);
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(ram_address))
   {
     Log_DebugFmt("Trigger IRQ @ {:08X} ({:04X}) from capture buffer", ram_address, ram_address / 8);
@@ -1215,11 +1350,17 @@ void SPU::IncrementCaptureBufferPosition()
 {
   s_capture_buffer_position += sizeof(s16);
   s_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
-  s_SPUSTAT.second_half_capture_buffer = s_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
+
+  // SPUSTAT belongs to the CPU thread, which tracks the position itself when frames are queued.
+  if (!s_on_spu_thread)
+    s_SPUSTAT.second_half_capture_buffer = s_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
 }
 
 ALWAYS_INLINE_RELEASE void SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
 {
+  // RAM may have pending writes or capture buffer updates.
+  SyncThread();
+
   while (ticks > 0 && !s_transfer_fifo.IsFull())
   {
     u16 value;
@@ -1240,8 +1381,8 @@ ALWAYS_INLINE_RELEASE void SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
 {
   while (ticks > 0 && !s_transfer_fifo.IsEmpty())
   {
-    u16 value = s_transfer_fifo.Pop();
-    std::memcpy(&s_ram[s_transfer_address], &value, sizeof(u16));
+    const u16 value = s_transfer_fifo.Pop();
+    WriteTransferRAM(s_transfer_address, value);
     s_transfer_address = (s_transfer_address + sizeof(u16)) & RAM_MASK;
     ticks -= TRANSFER_TICKS_PER_HALFWORD;
 
@@ -1316,7 +1457,7 @@ void SPU::ManualTransferWrite(u16 value)
       ExecuteTransfer(nullptr, std::numeric_limits<s32>::max(), 0);
   }
 
-  std::memcpy(&s_ram[s_transfer_address], &value, sizeof(u16));
+  WriteTransferRAM(s_transfer_address, value);
   s_transfer_address = (s_transfer_address + sizeof(u16)) & RAM_MASK;
 
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(s_transfer_address))
@@ -1326,6 +1467,18 @@ void SPU::ManualTransferWrite(u16 value)
   }
 }
 
+void SPU::WriteTransferRAM(u32 address, u16 value)
+{
+  if (s_thread_active && !s_on_spu_thread)
+  {
+    PushThreadCommand(ThreadCommand{ThreadCommandType::WriteRAM, value, address}, false);
+    return;
+  }
+
+  std::memcpy(&s_ram[address], &value, sizeof(u16));
+  InvalidateDecodedADPCMBlocks(address);
+}
+
 void SPU::UpdateTransferEvent()
 {
   const RAMTransferMode mode = s_SPUCNT.ram_transfer_mode;
@@ -1468,6 +1621,10 @@ void SPU::DMAWrite(const u32* words, u32 word_count)
 
 void SPU::GeneratePendingSamples()
 {
+  // Writes replayed on the SPU thread are already at the right point in time.
+  if (s_on_spu_thread)
+    return;
+
   if (s_transfer_event->IsActive())
     s_transfer_event->InvokeEarly();
 
@@ -1495,9 +1652,10 @@ bool SPU::IsDumpingAudio()
 
 bool SPU::StartDumpingAudio(const char* filename)
 {
+  SyncThread();
   s_dump_writer.reset();
   s_dump_writer = std::make_unique<WAVWriter>();
-  if (!s_dump_writer->Open(filename, SAMPLE_RATE, 2))
+  if (!s_dump_writer->Open(filename, SAMPLE_RATE, 2, true))
   {
     Log_ErrorFmt("Failed to open '{}'", filename);
     s_dump_writer.reset();
@@ -1517,7 +1675,7 @@ bool SPU::StartDumpingAudio(const char* filename)
       new_suffix.format("voice{}.wav", i);
 
     const std::string voice_filename = Path::ReplaceExtension(filename, new_suffix);
-    if (!s_voice_dump_writers[i]->Open(voice_filename.c_str(), SAMPLE_RATE, 2))
+    if (!s_voice_dump_writers[i]->Open(voice_filename.c_str(), SAMPLE_RATE, 2, true))
     {
       Log_ErrorFmt("Failed to open voice dump filename '{}'", voice_filename.c_str());
       s_voice_dump_writers[i].reset();
@@ -1533,6 +1691,7 @@ bool SPU::StopDumpingAudio()
   if (!s_dump_writer)
     return false;
 
+  SyncThread();
   s_dump_writer.reset();
 
 #ifdef SPU_DUMP_ALL_VOICES
@@ -1545,11 +1704,16 @@ bool SPU::StopDumpingAudio()
 
 const std::array<u8, SPU::RAM_SIZE>& SPU::GetRAM()
 {
+  SyncThread();
   return s_ram;
 }
 
 std::array<u8, SPU::RAM_SIZE>& SPU::GetWritableRAM()
 {
+  SyncThread();
+
+  // Caller may modify sample data.
+  InvalidateAllDecodedADPCMBlocks();
   return s_ram;
 }
 
@@ -1565,6 +1729,8 @@ void SPU::SetAudioOutputMuted(bool muted)
 
 AudioStream* SPU::GetOutputStream()
 {
+  // The SPU thread writes to the stream, it can't be changed underneath it.
+  SyncThread();
   return s_audio_stream.get();
 }
 
@@ -1840,6 +2006,19 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
+void SPU::Voice::LoadDecodedBlock(const DecodedADPCMBlock& block)
+{
+  current_block_samples[2] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  current_block_samples[1] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+  current_block_samples[0] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 3];
+  std::copy(block.samples.begin(), block.samples.end(),
+            current_block_samples.begin() + NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK);
+
+  adpcm_last_samples[0] = block.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  adpcm_last_samples[1] = block.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+  current_block_flags.bits = block.flags.bits;
+}
+
 s32 SPU::Voice::Interpolate() const
 {
   static constexpr std::array<s16, 0x200> gauss = {{
@@ -1909,24 +2088,50 @@ s32 SPU::Voice::Interpolate() const
     0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
   }};
 
+  // Rearranged so the four coefficients for an interpolation index are adjacent, in the same order as the samples,
+  // and the filter is a single 4-wide multiply-add.
+  alignas(8) static constexpr std::array<std::array<s16, 4>, 0x100> gauss_taps = []() {
+    std::array<std::array<s16, 4>, 0x100> ret = {};
+    for (u32 i = 0; i < 0x100; i++)
+      ret[i] = {gauss[0x0FF - i], gauss[0x1FF - i], gauss[0x100 + i], gauss[0x000 + i]};
+    return ret;
+  }();
+
   const u8 i = counter.interpolation_index;
   const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
-
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
+  const s16* const samples = &current_block_samples[s - 3];
+  const s16* const taps = gauss_taps[i].data();
+
+  // Products are at most 16 bits * 15 bits, and the coefficients sum to less than 0x8000, so none of these overflow
+  // and the result is identical to the scalar sum.
+#if defined(CPU_ARCH_SSE)
+  const __m128i prod = _mm_madd_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(samples)),
+                                      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(taps)));
+  const s32 out = _mm_cvtsi128_si32(_mm_add_epi32(prod, _mm_srli_si128(prod, 4)));
+#elif defined(CPU_ARCH_NEON)
+  const s32 out = vaddvq_s32(vmull_s16(vld1_s16(samples), vld1_s16(taps)));
+#else
+  s32 out = s32(taps[0]) * s32(samples[0]);
+  out += s32(taps[1]) * s32(samples[1]);
+  out += s32(taps[2]) * s32(samples[2]);
+  out += s32(taps[3]) * s32(samples[3]);
+#endif
   return out >> 15;
 }
 
-void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
+ALWAYS_INLINE_RELEASE void SPU::CheckADPCMBlockIRQ(u32 ram_address)
 {
-  u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
   if (IsRAMIRQTriggerable() && (CheckRAMIRQ(ram_address) || CheckRAMIRQ((ram_address + 8) & RAM_MASK)))
   {
     Log_DebugFmt("Trigger IRQ @ {:08X} ({:04X}) from ADPCM reader", ram_address, ram_address / 8);
     TriggerRAMIRQ();
   }
+}
+
+void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
+{
+  u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
+  CheckADPCMBlockIRQ(ram_address);
 
   // fast path - no wrap-around
   if ((ram_address + sizeof(ADPCMBlock)) <= RAM_SIZE)
@@ -1946,6 +2151,51 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
+ALWAYS_INLINE_RELEASE void SPU::ReadAndDecodeADPCMBlock(Voice& voice)
+{
+  // Blocks are 16 bytes, but can start at any 8 byte boundary.
+  const u32 address = ZeroExtend32(voice.current_address);
+  DecodedADPCMBlock& cached = s_adpcm_block_cache[(address >> 1) % ADPCM_BLOCK_CACHE_SIZE];
+  if (cached.address == address && cached.history == voice.adpcm_last_samples)
+  {
+    // Reading the block still triggers IRQs.
+    CheckADPCMBlockIRQ((address * 8) & RAM_MASK);
+    voice.LoadDecodedBlock(cached);
+    s_adpcm_block_cache_hits++;
+    return;
+  }
+
+  ADPCMBlock block;
+  ReadADPCMBlock(voice.current_address, &block);
+  cached.address = address;
+  cached.history = voice.adpcm_last_samples;
+  voice.DecodeBlock(block);
+  std::copy_n(voice.current_block_samples.begin() + NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK, NUM_SAMPLES_PER_ADPCM_BLOCK,
+              cached.samples.begin());
+  cached.flags.bits = voice.current_block_flags.bits;
+  s_adpcm_block_cache_misses++;
+}
+
+ALWAYS_INLINE void SPU::InvalidateDecodedADPCMBlocks(u32 ram_address)
+{
+  // The write can land in the block starting at this 8 byte unit, or the one before it.
+  const u32 unit = ram_address / 8;
+  DecodedADPCMBlock& first = s_adpcm_block_cache[(unit >> 1) % ADPCM_BLOCK_CACHE_SIZE];
+  if (first.address == unit)
+    first.address = ADPCM_BLOCK_CACHE_INVALID_ADDRESS;
+
+  const u32 prev_unit = (unit - 1) & (RAM_MASK / 8);
+  DecodedADPCMBlock& second = s_adpcm_block_cache[(prev_unit >> 1) % ADPCM_BLOCK_CACHE_SIZE];
+  if (second.address == prev_unit)
+    second.address = ADPCM_BLOCK_CACHE_INVALID_ADDRESS;
+}
+
+void SPU::InvalidateAllDecodedADPCMBlocks()
+{
+  for (DecodedADPCMBlock& block : s_adpcm_block_cache)
+    block.address = ADPCM_BLOCK_CACHE_INVALID_ADDRESS;
+}
+
 ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
 {
   Voice& voice = s_voices[voice_index];
@@ -1966,9 +2216,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
 
   if (!voice.has_samples)
   {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
+    ReadAndDecodeADPCMBlock(voice);
     voice.has_samples = true;
 
     if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
@@ -2122,6 +2370,7 @@ void SPU::ReverbWrite(u32 address, s16 data)
   // TODO: This should check interrupts.
   const u32 real_address = ReverbMemoryAddress(address << 2);
   std::memcpy(&s_ram[real_address], &data, sizeof(data));
+  InvalidateDecodedADPCMBlocks(real_address);
 }
 
 // Zeroes optimized out; middle removed too(it's 16384)
@@ -2131,15 +2380,72 @@ static constexpr std::array<s16, 20> s_reverb_resample_coefficients = {
 static s16 s_last_reverb_input[2];
 static s32 s_last_reverb_output[2];
 
-ALWAYS_INLINE static s32 Reverb4422(const s16* src)
-{
-  s32 out = 0; // 32-bits is adequate(it won't overflow)
+// Downsampling applies the coefficients to every second sample, plus the middle tap. Spreading them out with zeros
+// lets both filters run as contiguous multiply-adds. The upsampling taps are padded to a multiple of four.
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, 40> s_reverb_downsample_taps = []() {
+  std::array<s16, 40> ret = {};
   for (u32 i = 0; i < 20; i++)
-    out += s_reverb_resample_coefficients[i] * src[i * 2];
+    ret[i * 2] = s_reverb_resample_coefficients[i];
+  ret[19] = 0x4000;
+  return ret;
+}();
+alignas(VECTOR_ALIGNMENT) static constexpr std::array<s16, 24> s_reverb_upsample_taps = []() {
+  std::array<s16, 24> ret = {};
+  for (u32 i = 0; i < 20; i++)
+    ret[i] = s_reverb_resample_coefficients[i];
+  return ret;
+}();
+
+/// Sums products of N samples with taps. The sum of the absolute coefficients of both filters times 0x8000 fits in 32
+/// bits, so partial sums can't overflow, and the order of accumulation doesn't change the result.
+template<u32 N>
+ALWAYS_INLINE static s32 ReverbDotProduct(const s16* src, const s16* taps)
+{
+  static_assert((N % 4) == 0);
 
-  // Middle non-zero
-  out += 0x4000 * src[19];
-  out >>= 15;
+#if defined(CPU_ARCH_SSE)
+  __m128i acc = _mm_setzero_si128();
+  u32 i = 0;
+  for (; (i + 8) <= N; i += 8)
+  {
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)),
+                                            _mm_load_si128(reinterpret_cast<const __m128i*>(taps + i))));
+  }
+  if constexpr ((N % 8) != 0)
+  {
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)),
+                                            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(taps + i))));
+  }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(acc);
+#elif defined(CPU_ARCH_NEON)
+  int32x4_t acc = vdupq_n_s32(0);
+  u32 i = 0;
+  for (; (i + 8) <= N; i += 8)
+  {
+    const int16x8_t s = vld1q_s16(src + i);
+    const int16x8_t t = vld1q_s16(taps + i);
+    acc = vmlal_s16(acc, vget_low_s16(s), vget_low_s16(t));
+    acc = vmlal_high_s16(acc, s, t);
+  }
+  if constexpr ((N % 8) != 0)
+    acc = vmlal_s16(acc, vld1_s16(src + i), vld1_s16(taps + i));
+
+  return vaddvq_s32(acc);
+#else
+  s32 out = 0;
+  for (u32 i = 0; i < N; i++)
+    out += s32(src[i]) * s32(taps[i]);
+  return out;
+#endif
+}
+
+ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+{
+  // 32-bits is adequate(it won't overflow)
+  const s32 out = ReverbDotProduct<40>(src, s_reverb_downsample_taps.data()) >> 15;
   return std::clamp<s32>(out, -32768, 32767);
 }
 
@@ -2154,11 +2460,8 @@ ALWAYS_INLINE static s32 Reverb2244(const s16* src)
   }
   else
   {
-    out = 0;
-    for (u32 i = 0; i < 20; i++)
-      out += s_reverb_resample_coefficients[i] * src[i];
-
-    out >>= 14;
+    // Only the first 20 samples have non-zero taps.
+    out = ReverbDotProduct<24>(src, s_reverb_upsample_taps.data()) >> 14;
     out = std::clamp<s32>(out, -32768, 32767);
   }
 
@@ -2286,6 +2589,9 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
 
 void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 {
+  TRACE_ZONE("SPU::Execute");
+  System::ProfileSubsystemScope profile(System::ProfiledSubsystem::SPUMixing);
+
   u32 remaining_frames;
   if (g_settings.cpu_overclock_active)
   {
@@ -2300,8 +2606,17 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     s_ticks_carry = (ticks + s_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
-  AudioStream* output_stream = s_audio_output_muted ? s_null_audio_stream.get() : s_audio_stream.get();
+  if (s_thread_active)
+  {
+    QueueThreadFrames(remaining_frames);
+    return;
+  }
+
+  GenerateFrames(remaining_frames, s_audio_output_muted ? s_null_audio_stream.get() : s_audio_stream.get());
+}
 
+void SPU::GenerateFrames(u32 remaining_frames, AudioStream* output_stream)
+{
   while (remaining_frames > 0)
   {
     s16* output_frame_start;
@@ -2343,7 +2658,7 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       UpdateNoise();
 
       // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = CDROM::GetAudioFrame();
+      const auto [cd_audio_left, cd_audio_right] = s_on_spu_thread ? PopThreadCDAudioFrame() : CDROM::GetAudioFrame();
       if (s_SPUCNT.cd_audio_enable)
       {
         const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), s_cd_audio_volume_left);
@@ -2408,6 +2723,8 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 
     if (s_dump_writer)
       s_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+    if (MediaCapture* cap = System::GetMediaCapture())
+      cap->DeliverAudioFrames(output_frame_start, frames_in_this_batch);
 
     output_stream->EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
@@ -2438,8 +2755,202 @@ void SPU::UpdateEventInterval()
   s_tick_event->Schedule(downcount);
 }
 
+void SPU::SetUseThread(bool enabled)
+{
+  if (s_thread.joinable() == enabled)
+    return;
+
+  if (enabled)
+    StartThread();
+  else
+    StopThread();
+
+  UpdateThreadActive();
+}
+
+bool SPU::IsCPUThreadRegister(u32 offset)
+{
+  // Transfer address/data, SPUCNT, transfer control and SPUSTAT.
+  return (offset >= (0x1F801DA6 - SPU_BASE) && offset <= (0x1F801DAE - SPU_BASE));
+}
+
+void SPU::GeneratePendingSamplesForRead()
+{
+  // Writes to voices which are off don't generate samples, so how far behind mixing is depends on the mode. Registers
+  // which mixing changes have to be caught up to the read, so that the value doesn't depend on that.
+  GeneratePendingSamples();
+  SyncThread();
+}
+
+void SPU::UpdateThreadActive()
+{
+  // The thread has to be caught up to switch, and the CPU thread may have changed the state directly since.
+  SyncThread();
+
+  const bool active = (s_thread.joinable() && !s_SPUCNT.irq9_enable);
+  s_thread_active = active;
+  s_thread_capture_buffer_position = s_capture_buffer_position;
+}
+
+void SPU::StartThread()
+{
+  DebugAssert(!s_thread.joinable());
+  Log_DevPrint("Starting SPU thread.");
+  s_thread_shutdown = false;
+  s_thread = std::thread(&SPU::ThreadEntryPoint);
+}
+
+void SPU::StopThread()
+{
+  if (!s_thread.joinable())
+    return;
+
+  SyncThread();
+  {
+    std::unique_lock lock(s_thread_mutex);
+    s_thread_shutdown = true;
+  }
+  s_thread_wake_cv.notify_one();
+  s_thread.join();
+  s_thread_active = false;
+  Log_DevPrint("SPU thread stopped.");
+}
+
+void SPU::WakeThread()
+{
+  // Pairs with the fence in the thread, so either it sees the new commands before sleeping, or we see it sleeping.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!s_thread_sleeping.load(std::memory_order_relaxed))
+    return;
+
+  std::unique_lock lock(s_thread_mutex);
+  s_thread_wake_cv.notify_one();
+}
+
+void SPU::SyncThread()
+{
+  if (s_thread_commands.IsEmpty())
+    return;
+
+  // Register writes don't wake the thread, so it may be asleep with some still queued.
+  WakeThread();
+
+  for (u32 i = 0; i < THREAD_SYNC_SPIN_ITERATIONS; i++)
+  {
+    if (s_thread_commands.IsEmpty())
+      return;
+
+    SpinPause();
+  }
+
+  std::unique_lock lock(s_thread_mutex);
+  s_thread_idle_cv.wait(lock, []() { return s_thread_commands.IsEmpty(); });
+}
+
+void SPU::PushThreadCommand(const ThreadCommand& cmd, bool wake)
+{
+  while (!s_thread_commands.Push(cmd))
+  {
+    // Full, the thread has to be awake to drain it.
+    WakeThread();
+    SpinPause();
+  }
+
+  if (wake)
+    WakeThread();
+}
+
+void SPU::QueueThreadFrames(u32 frames)
+{
+  if (frames == 0)
+    return;
+
+  // SPUSTAT reflects the capture position as if the frames had already been generated.
+  s_thread_capture_buffer_position = static_cast<u16>(
+    (s_thread_capture_buffer_position + (frames * sizeof(s16))) % CAPTURE_BUFFER_SIZE_PER_CHANNEL);
+  s_SPUSTAT.second_half_capture_buffer = s_thread_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
+
+  const u16 muted = static_cast<u16>(s_audio_output_muted);
+  while (frames > 0)
+  {
+    // Split up so the CD audio for a single command always fits in the queue.
+    const u32 batch_frames = std::min<u32>(frames, MAX_THREAD_FRAMES_PER_COMMAND);
+    for (u32 i = 0; i < batch_frames; i++)
+    {
+      const auto [left, right] = CDROM::GetAudioFrame();
+      const u32 packed = ZeroExtend32(static_cast<u16>(left)) | (ZeroExtend32(static_cast<u16>(right)) << 16);
+      while (!s_thread_cd_audio_frames.Push(packed))
+      {
+        WakeThread();
+        SpinPause();
+      }
+    }
+
+    PushThreadCommand(ThreadCommand{ThreadCommandType::GenerateFrames, muted, batch_frames}, true);
+    frames -= batch_frames;
+  }
+}
+
+std::tuple<s16, s16> SPU::PopThreadCDAudioFrame()
+{
+  // Always pushed before the command which consumes it.
+  u32 packed = 0;
+  s_thread_cd_audio_frames.Pop(&packed);
+  return std::make_tuple(static_cast<s16>(Truncate16(packed)), static_cast<s16>(Truncate16(packed >> 16)));
+}
+
+void SPU::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("SPU Worker");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Worker);
+  s_on_spu_thread = true;
+
+  for (;;)
+  {
+    const ThreadCommand* cmd = s_thread_commands.Peek();
+    if (!cmd)
+    {
+      std::unique_lock lock(s_thread_mutex);
+      s_thread_sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      s_thread_idle_cv.notify_all();
+      s_thread_wake_cv.wait(lock, []() { return (s_thread_shutdown || !s_thread_commands.IsEmpty()); });
+      s_thread_sleeping.store(false, std::memory_order_relaxed);
+      if (s_thread_shutdown)
+        break;
+
+      continue;
+    }
+
+    switch (cmd->type)
+    {
+      case ThreadCommandType::GenerateFrames:
+      {
+        TRACE_ZONE("SPU::GenerateFrames");
+        GenerateFrames(cmd->param, (cmd->value != 0) ? s_null_audio_stream.get() : s_audio_stream.get());
+      }
+      break;
+
+      case ThreadCommandType::WriteRegister:
+        ApplyRegisterWrite(cmd->param, cmd->value);
+        break;
+
+      case ThreadCommandType::WriteRAM:
+        WriteTransferRAM(cmd->param, cmd->value);
+        break;
+
+        DefaultCaseIsUnreachable();
+    }
+
+    // Removed after executing, so that an empty queue means the thread is done with the state.
+    s_thread_commands.RemoveOne();
+  }
+}
+
 void SPU::DrawDebugStateWindow()
 {
+  SyncThread();
+
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
   static const ImVec4 inactive_color{0.4f, 0.4f, 0.4f, 1.0f};
   const float framebuffer_scale = Host::GetOSDScale();
@@ -2512,6 +3023,14 @@ void SPU::DrawDebugStateWindow()
     ImGui::SameLine(offsets[0]);
     ImGui::TextColored(s_transfer_event->IsActive() ? active_color : inactive_color, "%u halfwords (%u bytes)",
                        s_transfer_fifo.GetSize(), s_transfer_fifo.GetSize() * 2);
+
+    const u32 adpcm_cache_lookups = s_adpcm_block_cache_hits + s_adpcm_block_cache_misses;
+    ImGui::Text("ADPCM Cache: ");
+    ImGui::SameLine(offsets[0]);
+    ImGui::Text("%u hits, %u misses (%.1f%% hit rate)", s_adpcm_block_cache_hits, s_adpcm_block_cache_misses,
+                (adpcm_cache_lookups > 0) ? (static_cast<float>(s_adpcm_block_cache_hits) * 100.0f /
+                                             static_cast<float>(adpcm_cache_lookups)) :
+                                            0.0f);
   }
 
   // draw voice states
@@ -30,6 +30,13 @@ void WriteRegister(u32 offset, u16 value);
 void DMARead(u32* words, u32 word_count);
 void DMAWrite(const u32* words, u32 word_count);
 
+/// Moves sample generation to a separate thread, which register writes are journaled to. Only used while the RAM IRQ
+/// is disabled, otherwise the SPU runs synchronously as before.
+void SetUseThread(bool enabled);
+
+/// Waits for the SPU thread to apply everything journaled so far. Does nothing when the thread isn't running.
+void SyncThread();
+
 // Render statistics debug window.
 void DrawDebugStateWindow();
 
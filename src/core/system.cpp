@@ -21,10 +21,12 @@
 #include "host.h"
 #include "host_interface_progress_callback.h"
 #include "imgui_overlays.h"
+#include "input_movie.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
 #include "memory_card.h"
 #include "multitap.h"
+#include "netplay.h"
 #include "pad.h"
 #include "pcdrv.h"
 #include "psf_loader.h"
@@ -49,22 +51,32 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
+#include "common/scoped_guard.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "common/threading.h"
+#include "common/trace.h"
 
 #include "fmt/chrono.h"
 #include "fmt/format.h"
 #include "imgui.h"
 #include "xxhash.h"
 
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <deque>
 #include <fstream>
+#include <future>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 Log_SetChannel(System);
@@ -93,16 +105,53 @@ SystemBootParameters::SystemBootParameters(std::string filename_) : filename(std
 
 SystemBootParameters::~SystemBootParameters() = default;
 
+namespace {
+
+// Disc opened on a worker thread during boot, while the GPU device is created on the CPU thread.
+struct BootDisc
+{
+  std::unique_ptr<CDImage> image;
+  DiscRegion region = DiscRegion::NonPS1;
+  std::string id;
+  System::GameHash hash = 0;
+  Error error;
+};
+
+// Logs how long a step of startup took, and records it in the trace if one is being captured.
+class StartupPhase
+{
+public:
+  StartupPhase(const char* name);
+  ~StartupPhase();
+
+private:
+  const char* m_name;
+  Common::Timer::Value m_start_time;
+#ifdef ENABLE_TRACING
+  u64 m_trace_start_time;
+#endif
+};
+
+} // namespace
+
 namespace System {
 static void CheckCacheLineSize();
 
 static std::optional<ExtendedSaveStateInfo> InternalGetExtendedSaveStateInfo(ByteStream* stream);
+static std::string GetSaveStateIndexFileName(std::string_view state_path);
+static void LoadSaveStateIndex(std::string index_filename);
+static void WriteSaveStateIndex();
+static std::optional<ExtendedSaveStateInfo> ReadAndIndexExtendedSaveStateInfo(const char* path,
+                                                                               const FILESYSTEM_STAT_DATA& sd);
+static void UpdateSaveStateIndex(const char* path, const FILESYSTEM_STAT_DATA& sd, const ExtendedSaveStateInfo* ssi);
 
 static void LoadInputBindings(SettingsInterface& si, std::unique_lock<std::mutex>& lock);
 
 static bool LoadEXE(const char* filename);
 
 static std::string GetExecutableNameForImage(IsoReader& iso, bool strip_subdirectories);
+static std::string GetGameIdForExecutableName(std::string_view exe_name);
+static DiscRegion GetRegionForImage(CDImage* cdi, IsoReader* iso);
 static bool ReadExecutableFromImage(IsoReader& iso, std::string* out_executable_name,
                                     std::vector<u8>* out_executable_data);
 
@@ -111,7 +160,10 @@ static void InternalReset();
 static void ClearRunningGame();
 static void DestroySystem();
 static std::string GetMediaPathFromSaveState(const char* path);
+static std::unique_ptr<CDImage> OpenDiscImage(const char* path, Error* error);
+static std::string GetWarmupListFileName(std::string_view state_path);
 static bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display, bool is_memory_state);
+static RenderAPI GetRenderAPIForGPUDevice(GPURenderer renderer);
 static bool CreateGPU(GPURenderer renderer, bool is_switching, Error* error);
 static bool SaveUndoLoadState();
 static void WarnAboutUnsafeSettings();
@@ -119,21 +171,51 @@ static void LogUnsafeSettingsToConsole(const SmallStringBase& messages);
 
 /// Throttles the system, i.e. sleeps until it's time to execute the next frame.
 static void Throttle(Common::Timer::Value current_time);
+static void ResetAdaptiveFrameSkip();
+static void UpdateAdaptiveFrameSkip(bool skipped, Common::Timer::Value present_time);
 static void UpdatePerformanceCounters();
+static void ClearPendingInputLatency();
 static void AccumulatePreFrameSleepTime();
 static void UpdatePreFrameSleepTime();
 
 static void SetRewinding(bool enabled);
 static bool SaveRewindState();
 static void DoRewind();
+static bool CompressRewindData(const u8* data, u32 size, std::vector<u8>* compressed_data,
+                               std::span<const u8> dictionary = {});
+static bool DecompressRewindData(const std::vector<u8>& compressed_data, u8* data, u32 size,
+                                 std::span<const u8> dictionary = {});
+static std::string GetRewindDictionaryPath(std::string_view serial);
+static void UpdateRewindDictionary();
+static void AddRewindDictionarySamples(const u8* data, u32 size);
+static void UpdateRewindMemoryUsage();
+static void StartRewindThread();
+static void StopRewindThread();
+static void SyncRewindThread();
+static void RewindThreadEntryPoint();
 
 static void SaveRunaheadState();
 static bool DoRunahead();
+static void ClearRunaheadStates();
+
+static u32 GetVRAMSnapshotPoolSize();
+static void AllocateVRAMSnapshots();
+static void DestroyVRAMSnapshots();
+static std::unique_ptr<GPUTexture> AcquireVRAMSnapshot();
+static void ReleaseVRAMSnapshot(std::unique_ptr<GPUTexture> tex);
+static void UpdateVRAMSnapshotMemoryUsage();
 
 static bool Initialize(bool force_software_renderer, Error* error);
 
+static void OpenBootDisc(const std::string& path, u32 playlist_index, BootDisc* disc);
+static bool CreateBootGPUDevice(bool force_software_renderer);
+static bool IsGPUDeviceRecreationRequired(const Settings& device_settings);
+static void ReleaseBootGPUDevice();
+
 static bool UpdateGameSettingsLayer();
 static void UpdateRunningGame(const char* path, CDImage* image, bool booting);
+static void PrefetchNextDiscSetMember();
+static std::unique_ptr<CDImage> TakePrefetchedDisc(const char* path);
 static bool CheckForSBIFile(CDImage* image, Error* error);
 static std::unique_ptr<MemoryCard> GetMemoryCardForSlot(u32 slot, MemoryCardType type);
 
@@ -150,11 +232,15 @@ static void PollDiscordPresence();
 
 static constexpr const float PERFORMANCE_COUNTER_UPDATE_INTERVAL = 1.0f;
 static constexpr const char FALLBACK_EXE_NAME[] = "PSX.EXE";
+static constexpr u32 MAX_SAVE_STATE_COMPRESSION_THREADS = 4;
 
 static std::unique_ptr<INISettingsInterface> s_game_settings_interface;
 static std::unique_ptr<INISettingsInterface> s_input_settings_interface;
 static std::string s_input_profile_name;
 
+// Settings layer generations at the time input bindings were last loaded.
+static LayeredSettingsInterface::LayerGenerations s_input_bindings_generations = {};
+
 static System::State s_state = System::State::Shutdown;
 static std::atomic_bool s_startup_cancelled{false};
 static bool s_keep_gpu_device_on_shutdown = false;
@@ -174,6 +260,18 @@ static const GameDatabase::Entry* s_running_game_entry = nullptr;
 static System::GameHash s_running_game_hash;
 static bool s_was_fast_booted;
 
+// Details read from the disc on the boot worker, so UpdateRunningGame() doesn't have to read them again.
+static const CDImage* s_boot_disc_image = nullptr;
+static std::string s_boot_disc_id;
+static System::GameHash s_boot_disc_hash = 0;
+
+// Next disc of a multi-disc set, opened in the background so that swapping to it doesn't stall.
+static std::future<std::unique_ptr<CDImage>> s_next_disc_image;
+static std::string s_next_disc_path;
+
+// Time at which the current boot started, cleared once the first frame is presented.
+static Common::Timer::Value s_boot_start_time = 0;
+
 static bool s_system_executing = false;
 static bool s_system_interrupted = false;
 static bool s_frame_step_request = false;
@@ -184,21 +282,38 @@ static bool s_optimal_frame_pacing = false;
 static bool s_pre_frame_sleep = false;
 static bool s_syncing_to_host = false;
 static bool s_last_frame_skipped = false;
+static bool s_adaptive_frame_skip = false;
+static bool s_skipping_frame = false;
 
 static float s_throttle_frequency = 0.0f;
 static float s_target_speed = 0.0f;
 
 static Common::Timer::Value s_frame_period = 0;
+static double s_frame_period_fraction = 0.0;
+static double s_frame_period_remainder = 0.0;
 static Common::Timer::Value s_next_frame_time = 0;
+static float s_last_frame_pacing_error = 0.0f;
 
 static Common::Timer::Value s_frame_start_time = 0;
 static Common::Timer::Value s_last_active_frame_time = 0;
 static Common::Timer::Value s_pre_frame_sleep_time = 0;
 static Common::Timer::Value s_max_active_frame_time = 0;
 
+static constexpr u32 MAX_CONSECUTIVE_SKIPPED_FRAMES = 3;
+static u32 s_consecutive_skipped_frames = 0;
+static float s_frame_skip_credit = 0.0f;
+static float s_presented_frame_cost = 0.0f;
+static float s_skipped_frame_cost = 0.0f;
+
+// Unchanged frames are still presented every so often, so on-screen messages keep updating.
+static constexpr u32 MAX_SKIPPED_UNCHANGED_PRESENTS = 30;
+static u32 s_skipped_unchanged_presents = 0;
+
 static float s_average_frame_time_accumulator = 0.0f;
 static float s_minimum_frame_time_accumulator = 0.0f;
 static float s_maximum_frame_time_accumulator = 0.0f;
+static float s_frame_pacing_jitter_accumulator = 0.0f;
+static float s_maximum_frame_pacing_error_accumulator = 0.0f;
 
 static float s_vps = 0.0f;
 static float s_fps = 0.0f;
@@ -206,6 +321,8 @@ static float s_speed = 0.0f;
 static float s_minimum_frame_time = 0.0f;
 static float s_maximum_frame_time = 0.0f;
 static float s_average_frame_time = 0.0f;
+static float s_frame_pacing_jitter = 0.0f;
+static float s_maximum_frame_pacing_error = 0.0f;
 static float s_cpu_thread_usage = 0.0f;
 static float s_cpu_thread_time = 0.0f;
 static float s_sw_thread_usage = 0.0f;
@@ -213,7 +330,10 @@ static float s_sw_thread_time = 0.0f;
 static float s_average_gpu_time = 0.0f;
 static float s_accumulated_gpu_time = 0.0f;
 static float s_gpu_usage = 0.0f;
+static GPUDevice::GPUTimingRegionTimes s_accumulated_gpu_region_times = {};
+static GPUDevice::GPUTimingRegionTimes s_average_gpu_region_times = {};
 static System::FrameTimeHistory s_frame_time_history;
+static System::FrameTimeHistory s_frame_pacing_error_history;
 static u32 s_frame_time_history_pos = 0;
 static u32 s_last_frame_number = 0;
 static u32 s_last_internal_frame_number = 0;
@@ -225,14 +345,117 @@ static Common::Timer s_fps_timer;
 static Common::Timer s_frame_timer;
 static Threading::ThreadHandle s_cpu_thread_handle;
 
+// Timestamps for the input currently being measured, zero if the stage hasn't been reached.
+static Common::Timer::Value s_input_latency_event_time = 0;
+static Common::Timer::Value s_input_latency_latch_time = 0;
+static Common::Timer::Value s_input_latency_frame_done_time = 0;
+static Common::Timer::Value s_input_latency_submit_time = 0;
+static std::array<System::InputLatencySample, System::NUM_INPUT_LATENCY_SAMPLES> s_input_latency_samples = {};
+static u32 s_input_latency_sample_pos = 0;
+static u32 s_input_latency_sample_count = 0;
+
+std::atomic<bool> System::g_subsystem_profiling_enabled{false};
+static std::array<std::atomic<Common::Timer::Value>, static_cast<size_t>(System::ProfiledSubsystem::Count)>
+  s_subsystem_times = {};
+
 static std::unique_ptr<CheatList> s_cheat_list;
 
+static std::unique_ptr<MediaCapture> s_media_capture;
+
 // temporary save state, created when loading, used to undo load state
 static std::unique_ptr<ByteStream> m_undo_load_state;
 
+namespace {
+
+// Header and screenshot of a save state, so the selectors don't have to open every state file.
+struct SaveStateIndexEntry
+{
+  std::string path;
+  s64 modification_time;
+  s64 size;
+  ExtendedSaveStateInfo info;
+};
+
+enum : u32
+{
+  SAVE_STATE_INDEX_SIGNATURE = 0x58444953, // SIDX
+  SAVE_STATE_INDEX_VERSION = 1,
+  SAVE_STATE_INDEX_MAX_SCREENSHOT_PIXELS = 1024 * 1024,
+};
+
+} // namespace
+
+// Only the index for the most recently browsed game is kept in memory.
+static std::mutex s_save_state_index_mutex;
+static std::string s_save_state_index_filename;
+static std::vector<SaveStateIndexEntry> s_save_state_index;
+
 static bool s_memory_saves_enabled = false;
 
-static std::deque<System::MemorySaveState> s_rewind_states;
+namespace {
+
+// Rewind states are stored as zstd-compressed XOR deltas against the most recent keyframe, which is itself stored
+// compressed. Deltas hold a reference to their keyframe, so it outlives the keyframe's own slot being recycled.
+struct RewindKeyframe
+{
+  std::vector<u8> compressed_data;
+  std::shared_ptr<const std::vector<u8>> dictionary; // null if compressed without one
+  u32 size;
+};
+
+struct RewindState
+{
+  std::unique_ptr<GPUTexture> vram_texture;
+  std::shared_ptr<const RewindKeyframe> keyframe;
+  std::vector<u8> compressed_delta; // empty for keyframes
+  u32 size;
+};
+
+// Uncompressed state waiting for the rewind thread to encode it.
+struct PendingRewindState
+{
+  std::unique_ptr<GPUTexture> vram_texture;
+  std::unique_ptr<GrowableMemoryByteStream> state_stream;
+  u32 size;
+};
+
+} // namespace
+
+static constexpr u32 REWIND_KEYFRAME_INTERVAL = 16;
+static constexpr int REWIND_COMPRESSION_LEVEL = 1;
+static constexpr u32 NUM_PENDING_REWIND_STATES = 2;
+
+// Keyframes of the same game share a lot of structure, so once a few have been seen, they're used to train a
+// dictionary which later keyframes are compressed with. It's kept in the cache directory for the next session.
+static constexpr u32 REWIND_DICTIONARY_SAMPLE_KEYFRAMES = 8;
+static constexpr u32 REWIND_DICTIONARY_SAMPLE_SIZE = 4096;
+static constexpr u32 REWIND_DICTIONARY_SAMPLE_STRIDE = 16; // every Nth sample-sized chunk of the keyframe is taken
+static constexpr u32 REWIND_DICTIONARY_MAX_SIZE = 112 * 1024;
+
+static std::deque<RewindState> s_rewind_states;
+static std::shared_ptr<const RewindKeyframe> s_rewind_keyframe;
+static std::vector<u8> s_rewind_keyframe_data;
+static std::vector<u8> s_rewind_delta_buffer;
+static std::shared_ptr<const std::vector<u8>> s_rewind_dictionary;
+static std::string s_rewind_dictionary_serial;
+static std::vector<u8> s_rewind_dictionary_samples;
+static u32 s_rewind_dictionary_sample_keyframes = 0;
+static std::unique_ptr<GrowableMemoryByteStream> s_rewind_compress_stream;
+static System::MemorySaveState s_rewind_scratch_state;
+static u32 s_rewind_saves_since_keyframe = 0;
+static u64 s_rewind_memory_usage = 0;
+
+// The CPU thread only serializes into a pending slot, compression runs on the rewind thread.
+// s_rewind_states and the pending slots are protected by s_rewind_mutex, the keyframe and compression buffers are
+// only touched by the rewind thread, or the CPU thread once it has synced.
+static std::thread s_rewind_thread;
+static std::mutex s_rewind_mutex;
+static std::condition_variable s_rewind_thread_cv;
+static std::condition_variable s_rewind_done_cv;
+static std::array<PendingRewindState, NUM_PENDING_REWIND_STATES> s_pending_rewind_states;
+static u32 s_pending_rewind_read = 0;
+static u32 s_pending_rewind_count = 0;
+static bool s_rewind_thread_shutdown = false;
 static s32 s_rewind_load_frequency = -1;
 static s32 s_rewind_load_counter = -1;
 static s32 s_rewind_save_frequency = -1;
@@ -244,6 +467,12 @@ static bool s_runahead_replay_pending = false;
 static u32 s_runahead_frames = 0;
 static u32 s_runahead_replay_frames = 0;
 
+// VRAM copies for rewind and runahead states come from a pool which is allocated up front for the configured
+// history, so saving states doesn't create textures during gameplay. Only touched by the CPU thread.
+static std::vector<std::unique_ptr<GPUTexture>> s_vram_snapshot_pool;
+static u32 s_vram_snapshots_in_use = 0;
+static size_t s_vram_snapshot_size = 0;
+
 // Used to track play time. We use a monotonic timer here, in case of clock changes.
 static u64 s_session_start_time = 0;
 
@@ -309,7 +538,12 @@ bool System::Internal::CPUThreadInitialize(Error* error)
   }
 #endif
 
-  if (!Bus::AllocateMemory(error) || !CPU::CodeCache::ProcessStartup(error))
+  // Registered before settings are loaded, so the placement policy applies to this thread too.
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Emulation);
+
+  // Memory is allocated before settings are loaded, so read this one directly.
+  const bool use_huge_pages = Host::GetBaseBoolSettingValue("CPU", "UseHugePages", false);
+  if (!Bus::AllocateMemory(use_huge_pages, error) || !CPU::CodeCache::ProcessStartup(use_huge_pages, error))
   {
     CPUThreadShutdown();
     return false;
@@ -345,6 +579,8 @@ void System::Internal::CPUThreadShutdown()
 
   InputManager::CloseSources();
 
+  MemoryCard::StopSaveThread();
+
   CPU::CodeCache::ProcessShutdown();
   Bus::ReleaseMemory();
 
@@ -546,6 +782,14 @@ float System::GetMaximumFrameTime()
 {
   return s_maximum_frame_time;
 }
+float System::GetFramePacingJitter()
+{
+  return s_frame_pacing_jitter;
+}
+float System::GetMaximumFramePacingError()
+{
+  return s_maximum_frame_pacing_error;
+}
 float System::GetThrottleFrequency()
 {
   return s_throttle_frequency;
@@ -574,10 +818,18 @@ float System::GetGPUAverageTime()
 {
   return s_average_gpu_time;
 }
+float System::GetGPUTimingRegionAverageTime(GPUTimingRegion region)
+{
+  return s_average_gpu_region_times[static_cast<size_t>(region)];
+}
 const System::FrameTimeHistory& System::GetFrameTimeHistory()
 {
   return s_frame_time_history;
 }
+const System::FrameTimeHistory& System::GetFramePacingErrorHistory()
+{
+  return s_frame_pacing_error_history;
+}
 u32 System::GetFrameTimeHistoryPos()
 {
   return s_frame_time_history_pos;
@@ -641,10 +893,15 @@ std::string System::GetGameHashId(GameHash hash)
   return fmt::format("HASH-{:X}", hash);
 }
 
-bool System::GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash* out_hash)
+bool System::GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash* out_hash,
+                                     DiscRegion* out_region /* = nullptr */)
 {
+  // Sharing the reader with region detection means the directories are only read once.
   IsoReader iso;
-  if (!iso.Open(cdi, 1))
+  const bool iso_opened = iso.Open(cdi, 1);
+  if (out_region)
+    *out_region = GetRegionForImage(cdi, iso_opened ? &iso : nullptr);
+  if (!iso_opened)
   {
     if (out_id)
       out_id->clear();
@@ -653,7 +910,6 @@ bool System::GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash
     return false;
   }
 
-  std::string id;
   std::string exe_name;
   std::vector<u8> exe_buffer;
   if (!ReadExecutableFromImage(iso, &exe_name, &exe_buffer))
@@ -677,35 +933,9 @@ bool System::GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash
   XXH64_freeState(state);
   Log_DevPrintf("Hash for '%s' - %" PRIX64, exe_name.c_str(), hash);
 
-  if (exe_name != FALLBACK_EXE_NAME)
-  {
-    // Strip off any subdirectories.
-    const std::string::size_type slash = exe_name.rfind('\\');
-    if (slash != std::string::npos)
-      id = std::string_view(exe_name).substr(slash + 1);
-    else
-      id = exe_name;
-
-    // SCES_123.45 -> SCES-12345
-    for (std::string::size_type pos = 0; pos < id.size();)
-    {
-      if (id[pos] == '.')
-      {
-        id.erase(pos, 1);
-        continue;
-      }
-
-      if (id[pos] == '_')
-        id[pos] = '-';
-      else
-        id[pos] = static_cast<char>(std::toupper(id[pos]));
-
-      pos++;
-    }
-  }
-
   if (out_id)
   {
+    std::string id = GetGameIdForExecutableName(exe_name);
     if (id.empty())
       *out_id = GetGameHashId(hash);
     else
@@ -718,6 +948,57 @@ bool System::GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash
   return true;
 }
 
+bool System::GetGameIdFromImage(CDImage* cdi, std::string* out_id, DiscRegion* out_region /* = nullptr */)
+{
+  IsoReader iso;
+  const bool iso_opened = iso.Open(cdi, 1);
+  if (out_region)
+    *out_region = GetRegionForImage(cdi, iso_opened ? &iso : nullptr);
+
+  std::string id;
+  if (iso_opened)
+    id = GetGameIdForExecutableName(GetExecutableNameForImage(iso, false));
+
+  const bool result = !id.empty();
+  if (out_id)
+    *out_id = std::move(id);
+
+  return result;
+}
+
+std::string System::GetGameIdForExecutableName(std::string_view exe_name)
+{
+  std::string id;
+  if (exe_name == FALLBACK_EXE_NAME)
+    return id;
+
+  // Strip off any subdirectories.
+  const std::string_view::size_type slash = exe_name.rfind('\\');
+  if (slash != std::string_view::npos)
+    id = exe_name.substr(slash + 1);
+  else
+    id = exe_name;
+
+  // SCES_123.45 -> SCES-12345
+  for (std::string::size_type pos = 0; pos < id.size();)
+  {
+    if (id[pos] == '.')
+    {
+      id.erase(pos, 1);
+      continue;
+    }
+
+    if (id[pos] == '_')
+      id[pos] = '-';
+    else
+      id[pos] = static_cast<char>(std::toupper(id[pos]));
+
+    pos++;
+  }
+
+  return id;
+}
+
 std::string System::GetExecutableNameForImage(IsoReader& iso, bool strip_subdirectories)
 {
   // Read SYSTEM.CNF
@@ -891,19 +1172,36 @@ DiscRegion System::GetRegionFromSystemArea(CDImage* cdi)
     return DiscRegion::Other;
 }
 
+std::unique_ptr<CDImage> System::OpenDiscImage(const char* path, Error* error)
+{
+  std::unique_ptr<CDImage> image = CDImage::Open(path, g_settings.cdrom_load_image_patches, error);
+  if (image && g_settings.cdrom_local_cache && !CDImage::IsDeviceName(path))
+  {
+    image = CDImage::CreateLocalCacheImage(std::move(image), Path::Combine(EmuFolders::Cache, "disccache").c_str(),
+                                           static_cast<u64>(g_settings.cdrom_local_cache_size) * 1048576);
+  }
+
+  return image;
+}
+
 DiscRegion System::GetRegionForImage(CDImage* cdi)
+{
+  IsoReader iso;
+  return GetRegionForImage(cdi, iso.Open(cdi, 1) ? &iso : nullptr);
+}
+
+DiscRegion System::GetRegionForImage(CDImage* cdi, IsoReader* iso)
 {
   const DiscRegion system_area_region = GetRegionFromSystemArea(cdi);
   if (system_area_region != DiscRegion::Other)
     return system_area_region;
 
-  IsoReader iso;
-  if (!iso.Open(cdi, 1))
+  if (!iso)
     return DiscRegion::NonPS1;
 
   // The executable must exist, because this just returns PSX.EXE if it doesn't.
-  const std::string exename = GetExecutableNameForImage(iso, false);
-  if (exename.empty() || !iso.FileExists(exename.c_str()))
+  const std::string exename = GetExecutableNameForImage(*iso, false);
+  if (exename.empty() || !iso->FileExists(exename.c_str()))
     return DiscRegion::NonPS1;
 
   // Strip off any subdirectories.
@@ -967,8 +1265,13 @@ std::string System::GetInputProfilePath(std::string_view name)
 bool System::RecreateGPU(GPURenderer renderer, bool force_recreate_device, bool update_display /* = true*/)
 {
   ClearMemorySaveStates();
+  DestroyVRAMSnapshots();
   g_gpu->RestoreDeviceContext();
 
+  // frames still being read back would be lost with the old renderer
+  if (s_media_capture)
+    g_gpu->FlushMediaCapture(s_media_capture.get());
+
   // save current state
   std::unique_ptr<ByteStream> state_stream = ByteStream::CreateGrowableMemoryStream();
   StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
@@ -994,6 +1297,10 @@ bool System::RecreateGPU(GPURenderer renderer, bool force_recreate_device, bool
     return false;
   }
 
+  // The new device may not support the same compressed formats.
+  if (force_recreate_device && g_settings.texture_replacements.AnyReplacementsEnabled())
+    g_texture_replacements.Reload();
+
   if (state_valid)
   {
     state_stream->SeekAbsolute(0);
@@ -1014,10 +1321,14 @@ void System::LoadSettings(bool display_osd_messages)
   SettingsInterface& si = *Host::GetSettingsInterface();
   g_settings.Load(si);
   g_settings.UpdateLogSettings();
+  Threading::SetThreadPlacementPolicy(g_settings.thread_placement);
 
   Host::LoadSettings(si, lock);
   InputManager::ReloadSources(si, lock);
-  LoadInputBindings(si, lock);
+
+  // Bindings are only built from the settings layers, so there's no need to rebuild them if nothing has changed.
+  if (Host::Internal::GetSettingsLayerGenerations() != s_input_bindings_generations)
+    LoadInputBindings(si, lock);
 
   // apply compatibility settings
   if (g_settings.apply_compatibility_settings)
@@ -1089,6 +1400,8 @@ void System::LoadInputBindings(SettingsInterface& si, std::unique_lock<std::mute
   {
     InputManager::ReloadBindings(si, si, si);
   }
+
+  s_input_bindings_generations = Host::Internal::GetSettingsLayerGenerations();
 }
 
 void System::SetDefaultSettings(SettingsInterface& si)
@@ -1245,7 +1558,7 @@ void System::PauseSystem(bool paused)
   if (paused)
   {
     // Make sure the GPU is flushed, otherwise the VB might still be mapped.
-    g_gpu->FlushRender();
+    g_gpu->SyncRenderThread();
 
     FullscreenUI::OnSystemPaused();
 
@@ -1297,8 +1610,7 @@ bool System::LoadState(const char* filename, Error* error)
 
   Common::Timer load_timer;
 
-  std::unique_ptr<ByteStream> stream =
-    ByteStream::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED, error);
+  std::unique_ptr<ByteStream> stream = ByteStream::OpenMemoryMappedFile(filename, error);
   if (!stream)
   {
     Error::AddPrefixFmt(error, "Failed to open '{}': ", Path::GetFileName(filename));
@@ -1373,6 +1685,12 @@ bool System::SaveState(const char* filename, Error* error, bool backup_existing_
       "save_state", ICON_FA_SAVE,
       fmt::format(TRANSLATE_FS("OSDMessage", "State saved to '{}'."), Path::GetFileName(display_name)), 5.0f);
     stream->Commit();
+
+    // Refresh the index now, the header and screenshot are still in the OS cache. Always replaces the entry, since
+    // a resave within the same second can leave the modification time and size unchanged.
+    FILESYSTEM_STAT_DATA sd;
+    if (FileSystem::StatFile(filename, &sd))
+      ReadAndIndexExtendedSaveStateInfo(filename, sd);
   }
 
   Log_VerbosePrintf("Saving state took %.2f msec", save_timer.GetTimeMilliseconds());
@@ -1388,7 +1706,23 @@ bool System::SaveResumeState(Error* error)
   }
 
   const std::string path(GetGameSaveStateFileName(s_running_game_serial, -1));
-  return SaveState(path.c_str(), error, false);
+  if (!SaveState(path.c_str(), error, false))
+    return false;
+
+  // Blocks which were running get compiled up front on resume, otherwise the first few seconds stutter.
+  const std::string warmup_path = GetWarmupListFileName(path);
+  Error warmup_error;
+  if (!CPU::CodeCache::IsUsingAnyRecompiler())
+    FileSystem::DeleteFile(warmup_path.c_str());
+  else if (!CPU::CodeCache::SaveWarmupList(warmup_path.c_str(), &warmup_error))
+    Log_ErrorFmt("Failed to save warmup list: {}", warmup_error.GetDescription());
+
+  return true;
+}
+
+std::string System::GetWarmupListFileName(std::string_view state_path)
+{
+  return Path::ReplaceExtension(state_path, "blocks");
 }
 
 bool System::BootSystem(SystemBootParameters parameters, Error* error)
@@ -1411,6 +1745,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   s_startup_cancelled.store(false);
   s_keep_gpu_device_on_shutdown = static_cast<bool>(g_gpu_device);
   s_region = g_settings.region;
+  s_boot_start_time = Common::Timer::GetCurrentValue();
   Host::OnSystemStarting();
 
   // Load CD image up and detect region.
@@ -1418,6 +1753,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   DiscRegion disc_region = DiscRegion::NonPS1;
   std::string exe_boot;
   std::string psf_boot;
+  std::optional<Settings> boot_device_settings;
   if (!parameters.filename.empty())
   {
     const bool do_exe_boot = IsExeFileName(parameters.filename);
@@ -1438,18 +1774,31 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
     }
     else
     {
+      // Opening and hashing the disc doesn't depend on the GPU device, so do both at once.
       Log_InfoPrintf("Loading CD image '%s'...", parameters.filename.c_str());
-      disc = CDImage::Open(parameters.filename.c_str(), g_settings.cdrom_load_image_patches, error);
-      if (!disc)
+      BootDisc boot_disc;
+      std::thread disc_thread(&OpenBootDisc, std::cref(parameters.filename), parameters.media_playlist_index,
+                              &boot_disc);
+      if (CreateBootGPUDevice(parameters.force_software_renderer))
+        boot_device_settings.emplace(g_settings);
+      disc_thread.join();
+
+      if (!boot_disc.image)
       {
-        Error::AddPrefixFmt(error, "Failed to open CD image '{}':\n", Path::GetFileName(parameters.filename));
+        if (error)
+          *error = std::move(boot_disc.error);
         s_state = State::Shutdown;
+        ReleaseBootGPUDevice();
         Host::OnSystemDestroyed();
         Host::OnIdleStateChanged();
         return false;
       }
 
-      disc_region = GetRegionForImage(disc.get());
+      disc = std::move(boot_disc.image);
+      disc_region = boot_disc.region;
+      s_boot_disc_image = disc.get();
+      s_boot_disc_id = std::move(boot_disc.id);
+      s_boot_disc_hash = boot_disc.hash;
       if (s_region == ConsoleRegion::Auto)
       {
         if (disc_region != DiscRegion::Other)
@@ -1477,19 +1826,20 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
 
   Log_InfoPrintf("Console Region: %s", Settings::GetConsoleRegionDisplayName(s_region));
 
-  // Switch subimage.
-  if (disc && parameters.media_playlist_index != 0 && !disc->SwitchSubImage(parameters.media_playlist_index, error))
+  // Update running game, this will apply settings as well.
   {
-    Error::AddPrefixFmt(error, "Failed to switch to subimage {} in '{}':\n", parameters.media_playlist_index,
-                        Path::GetFileName(parameters.filename));
-    s_state = State::Shutdown;
-    Host::OnSystemDestroyed();
-    Host::OnIdleStateChanged();
-    return false;
+    StartupPhase phase("Apply game settings");
+    UpdateRunningGame(disc ? disc->GetFileName().c_str() : parameters.filename.c_str(), disc.get(), true);
+    s_boot_disc_image = nullptr;
+    s_boot_disc_id = {};
   }
 
-  // Update running game, this will apply settings as well.
-  UpdateRunningGame(disc ? disc->GetFileName().c_str() : parameters.filename.c_str(), disc.get(), true);
+  // The device was created before game settings were applied. If they change it, Initialize() creates a new one.
+  if (boot_device_settings.has_value() && IsGPUDeviceRecreationRequired(boot_device_settings.value()))
+  {
+    Log_InfoPrint("Game settings change the GPU device, recreating it.");
+    ReleaseBootGPUDevice();
+  }
 
   if (!parameters.override_exe.empty())
   {
@@ -1498,6 +1848,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
       Error::SetStringFmt(error, "File '{}' is not a valid executable to boot.",
                           Path::GetFileName(parameters.override_exe));
       s_state = State::Shutdown;
+      ReleaseBootGPUDevice();
       Host::OnSystemDestroyed();
       Host::OnIdleStateChanged();
       return false;
@@ -1512,6 +1863,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   {
     s_state = State::Shutdown;
     ClearRunningGame();
+    ReleaseBootGPUDevice();
     Host::OnSystemDestroyed();
     Host::OnIdleStateChanged();
     return false;
@@ -1544,6 +1896,7 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
     {
       s_state = State::Shutdown;
       ClearRunningGame();
+      ReleaseBootGPUDevice();
       Host::OnSystemDestroyed();
       Host::OnIdleStateChanged();
       return false;
@@ -1551,20 +1904,32 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   }
 
   // Load BIOS image.
-  if (!LoadBIOS(error))
+  bool bios_loaded;
+  {
+    StartupPhase phase("Load BIOS");
+    bios_loaded = LoadBIOS(error);
+  }
+  if (!bios_loaded)
   {
     s_state = State::Shutdown;
     ClearRunningGame();
+    ReleaseBootGPUDevice();
     Host::OnSystemDestroyed();
     Host::OnIdleStateChanged();
     return false;
   }
 
   // Component setup.
-  if (!Initialize(parameters.force_software_renderer, error))
+  bool initialized;
+  {
+    StartupPhase phase("Initialize system");
+    initialized = Initialize(parameters.force_software_renderer, error);
+  }
+  if (!initialized)
   {
     s_state = State::Shutdown;
     ClearRunningGame();
+    ReleaseBootGPUDevice();
     Host::OnSystemDestroyed();
     Host::OnIdleStateChanged();
     return false;
@@ -1574,10 +1939,13 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   if (disc)
     CDROM::InsertMedia(std::move(disc), disc_region);
 
-  UpdateControllers();
-  UpdateMemoryCardTypes();
-  UpdateMultitaps();
-  InternalReset();
+  {
+    StartupPhase phase("Reset system");
+    UpdateControllers();
+    UpdateMemoryCardTypes();
+    UpdateMultitaps();
+    InternalReset();
+  }
 
   // Load EXE late after BIOS.
   if (!exe_boot.empty() && !LoadEXE(exe_boot.c_str()))
@@ -1632,8 +2000,8 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
   // try to load the state, if it fails, bail out
   if (!parameters.save_state.empty())
   {
-    std::unique_ptr<ByteStream> stream =
-      ByteStream::OpenFile(parameters.save_state.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED, error);
+    StartupPhase phase("Load state");
+    std::unique_ptr<ByteStream> stream = ByteStream::OpenMemoryMappedFile(parameters.save_state.c_str(), error);
     if (!stream)
     {
       Error::AddPrefixFmt(error, "Failed to load save state file '{}' for booting:\n",
@@ -1647,6 +2015,8 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
       DestroySystem();
       return false;
     }
+
+    CPU::CodeCache::CompileWarmupList(GetWarmupListFileName(parameters.save_state).c_str());
   }
 
   if (parameters.load_image_to_ram || g_settings.cdrom_load_image_to_ram)
@@ -1660,9 +2030,101 @@ bool System::BootSystem(SystemBootParameters parameters, Error* error)
 
   UpdateSpeedLimiterState();
   ResetPerformanceCounters();
+  Log_InfoFmt("Startup: System started after {:.2f} ms",
+              Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() - s_boot_start_time));
+  return true;
+}
+
+StartupPhase::StartupPhase(const char* name) : m_name(name), m_start_time(Common::Timer::GetCurrentValue())
+{
+#ifdef ENABLE_TRACING
+  m_trace_start_time = Trace::IsCapturing() ? Trace::Internal::GetTimestamp() : 0;
+#endif
+}
+
+StartupPhase::~StartupPhase()
+{
+#ifdef ENABLE_TRACING
+  if (m_trace_start_time != 0)
+    Trace::Internal::AddZone(m_name, m_trace_start_time, Trace::Internal::GetTimestamp());
+#endif
+
+  const Common::Timer::Value end_time = Common::Timer::GetCurrentValue();
+  Log_InfoFmt("Startup: {} took {:.2f} ms, {:.2f} ms since boot", m_name,
+              Common::Timer::ConvertValueToMilliseconds(end_time - m_start_time),
+              Common::Timer::ConvertValueToMilliseconds(end_time - s_boot_start_time));
+}
+
+void System::OpenBootDisc(const std::string& path, u32 playlist_index, BootDisc* disc)
+{
+  Threading::SetNameOfCurrentThread("Boot Disc Open");
+
+  {
+    StartupPhase phase("Open disc");
+    disc->image = OpenDiscImage(path.c_str(), &disc->error);
+    if (!disc->image)
+    {
+      disc->error.AddPrefixFmt("Failed to open CD image '{}':\n", Path::GetFileName(path));
+      return;
+    }
+
+    if (playlist_index != 0 && !disc->image->SwitchSubImage(playlist_index, &disc->error))
+    {
+      disc->error.AddPrefixFmt("Failed to switch to subimage {} in '{}':\n", playlist_index, Path::GetFileName(path));
+      disc->image.reset();
+      return;
+    }
+  }
+
+  // Region detection shares the ISO reader with the executable hash.
+  StartupPhase phase("Read game details");
+  GetGameDetailsFromImage(disc->image.get(), &disc->id, &disc->hash, &disc->region);
+}
+
+bool System::CreateBootGPUDevice(bool force_software_renderer)
+{
+  // Keeping the device from fullscreen UI, or it'll be created later.
+  if (g_gpu_device)
+    return false;
+
+  StartupPhase phase("Create GPU device");
+  const GPURenderer renderer = force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer;
+  Error error;
+  if (!Host::CreateGPUDevice(GetRenderAPIForGPUDevice(renderer), &error))
+  {
+    // Not fatal yet, CreateGPU() will try again and report the error.
+    Log_WarningFmt("Failed to create GPU device early: {}", error.GetDescription());
+    Host::ReleaseRenderWindow();
+    return false;
+  }
+
   return true;
 }
 
+bool System::IsGPUDeviceRecreationRequired(const Settings& device_settings)
+{
+  // Switching between APIs is handled by CreateGPU().
+  return (g_settings.gpu_adapter != device_settings.gpu_adapter ||
+          g_settings.gpu_use_debug_device != device_settings.gpu_use_debug_device ||
+          g_settings.gpu_use_null_device != device_settings.gpu_use_null_device ||
+          g_settings.gpu_threaded_presentation != device_settings.gpu_threaded_presentation ||
+          g_settings.gpu_disable_shader_cache != device_settings.gpu_disable_shader_cache ||
+          g_settings.gpu_disable_dual_source_blend != device_settings.gpu_disable_dual_source_blend ||
+          g_settings.gpu_disable_framebuffer_fetch != device_settings.gpu_disable_framebuffer_fetch ||
+          g_settings.gpu_disable_texture_buffers != device_settings.gpu_disable_texture_buffers ||
+          g_settings.gpu_disable_texture_copy_to_self != device_settings.gpu_disable_texture_copy_to_self ||
+          g_settings.display_exclusive_fullscreen_control != device_settings.display_exclusive_fullscreen_control);
+}
+
+void System::ReleaseBootGPUDevice()
+{
+  if (s_keep_gpu_device_on_shutdown || !g_gpu_device)
+    return;
+
+  Host::ReleaseGPUDevice();
+  Host::ReleaseRenderWindow();
+}
+
 bool System::Initialize(bool force_software_renderer, Error* error)
 {
   g_ticks_per_second = ScaleTicksToOverclock(MASTER_CLOCK);
@@ -1673,9 +2135,13 @@ bool System::Initialize(bool force_software_renderer, Error* error)
   s_target_speed = g_settings.emulation_speed;
   s_throttle_frequency = 60.0f;
   s_frame_period = 0;
+  s_frame_period_fraction = 0.0;
+  s_frame_period_remainder = 0.0;
   s_next_frame_time = 0;
+  s_last_frame_pacing_error = 0.0f;
   s_turbo_enabled = false;
   s_fast_forward_enabled = false;
+  ResetAdaptiveFrameSkip();
 
   s_rewind_load_frequency = -1;
   s_rewind_load_counter = -1;
@@ -1684,6 +2150,8 @@ bool System::Initialize(bool force_software_renderer, Error* error)
   s_average_frame_time_accumulator = 0.0f;
   s_minimum_frame_time_accumulator = 0.0f;
   s_maximum_frame_time_accumulator = 0.0f;
+  s_frame_pacing_jitter_accumulator = 0.0f;
+  s_maximum_frame_pacing_error_accumulator = 0.0f;
 
   s_vps = 0.0f;
   s_fps = 0.0f;
@@ -1691,6 +2159,8 @@ bool System::Initialize(bool force_software_renderer, Error* error)
   s_minimum_frame_time = 0.0f;
   s_maximum_frame_time = 0.0f;
   s_average_frame_time = 0.0f;
+  s_frame_pacing_jitter = 0.0f;
+  s_maximum_frame_pacing_error = 0.0f;
   s_cpu_thread_usage = 0.0f;
   s_cpu_thread_time = 0.0f;
   s_sw_thread_usage = 0.0f;
@@ -1698,6 +2168,8 @@ bool System::Initialize(bool force_software_renderer, Error* error)
   s_average_gpu_time = 0.0f;
   s_accumulated_gpu_time = 0.0f;
   s_gpu_usage = 0.0f;
+  s_accumulated_gpu_region_times = {};
+  s_average_gpu_region_times = {};
   s_last_frame_number = 0;
   s_last_internal_frame_number = 0;
   s_last_global_tick_counter = 0;
@@ -1706,6 +2178,7 @@ bool System::Initialize(bool force_software_renderer, Error* error)
   s_fps_timer.Reset();
   s_frame_timer.Reset();
   s_frame_time_history.fill(0.0f);
+  s_frame_pacing_error_history.fill(0.0f);
   s_frame_time_history_pos = 0;
 
   TimingEvents::Initialize();
@@ -1720,7 +2193,12 @@ bool System::Initialize(bool force_software_renderer, Error* error)
 
   CPU::CodeCache::Initialize();
 
-  if (!CreateGPU(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer, false, error))
+  bool gpu_created;
+  {
+    StartupPhase phase("Create GPU renderer");
+    gpu_created = CreateGPU(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer, false, error);
+  }
+  if (!gpu_created)
   {
     Bus::Shutdown();
     CPU::Shutdown();
@@ -1789,6 +2267,12 @@ void System::DestroySystem()
   s_cpu_thread_usage = {};
 
   ClearMemorySaveStates();
+  StopRewindThread();
+  DestroyVRAMSnapshots();
+  ResetInputLatencyStats();
+  InputMovie::Stop();
+  Netplay::Stop();
+  StopMediaCapture();
 
   g_texture_replacements.Shutdown();
 
@@ -1840,6 +2324,9 @@ void System::ClearRunningGame()
   s_running_game_entry = nullptr;
   s_running_game_hash = 0;
 
+  s_next_disc_image = {};
+  s_next_disc_path = {};
+
   Host::OnGameChanged(s_running_game_path, s_running_game_serial, s_running_game_title);
 
   Achievements::GameChanged(s_running_game_path, nullptr);
@@ -1868,6 +2355,9 @@ void System::Execute()
         else
           CPU::Execute();
 
+        // The host device is used outside of execution, so the render thread has to be idle.
+        g_gpu->SyncRenderThread();
+
         s_system_executing = false;
         continue;
       }
@@ -1889,8 +2379,14 @@ void System::FrameDone()
 {
   s_frame_number++;
 
+  if (s_input_latency_latch_time != 0 && s_input_latency_frame_done_time == 0)
+    s_input_latency_frame_done_time = Common::Timer::GetCurrentValue();
+
   // Vertex buffer is shared, need to flush what we have.
-  g_gpu->FlushRender();
+  g_gpu->SyncRenderThread();
+
+  CPU::CodeCache::ResetCompileBudget();
+  g_texture_replacements.ResetUploadBudget();
 
   // Generate any pending samples from the SPU before sleeping, this way we reduce the chances of underruns.
   // TODO: when running ahead, we can skip this (and the flush above)
@@ -1927,6 +2423,12 @@ void System::FrameDone()
   }
   else if (s_runahead_frames > 0)
   {
+    // runahead replays frames with input applied early, which movies and netplay can't reproduce
+    if (InputMovie::IsActive())
+      InputMovie::Stop();
+    if (Netplay::IsActive())
+      Netplay::Stop();
+
     // We don't want to poll during replay, because otherwise we'll lose frames.
     if (s_runahead_replay_frames == 0)
     {
@@ -1953,6 +2455,36 @@ void System::FrameDone()
 
     SaveRunaheadState();
   }
+  else if (Netplay::IsActive())
+  {
+    // Like runahead, replayed frames run back-to-back, and input for the next frame has to be known before it starts.
+    if (!Netplay::IsReplaying())
+    {
+      Host::PumpMessagesOnCPUThread();
+      InputManager::PollSources();
+      g_gpu->RestoreDeviceContext();
+    }
+
+    if (Netplay::FrameDone())
+    {
+      // replaying after a rollback, don't show or wait for these frames
+      return;
+    }
+
+    if (IsExecutionInterrupted())
+    {
+      s_system_interrupted = false;
+      CPU::ExitExecution();
+      return;
+    }
+  }
+
+  if (s_media_capture &&
+      !g_gpu->SendDisplayToMediaCapture(s_media_capture.get(), !g_settings.media_capture_internal_resolution))
+  {
+    Log_ErrorPrint("Failed to send frame to media capture, stopping.");
+    StopMediaCapture();
+  }
 
   Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
 
@@ -1963,13 +2495,32 @@ void System::FrameDone()
     AccumulatePreFrameSleepTime();
 
   // explicit present (frame pacing)
-  if (current_time < s_next_frame_time || s_syncing_to_host || s_optimal_frame_pacing || s_last_frame_skipped)
+  // frames chosen by adaptive frame skip were never copied out of VRAM, so there's nothing to present
+  const bool adaptive_skip = s_skipping_frame;
+  Common::Timer::Value present_time = 0;
+
+  // with variable refresh, the display keeps showing the last image, so unchanged frames don't need presenting
+  const bool unchanged_skip =
+    (s_optimal_frame_pacing && g_settings.display_skip_unchanged_presents && g_gpu->IsDisplayFrameUnchanged() &&
+     !s_last_frame_skipped && !FullscreenUI::HasActiveWindow() &&
+     s_skipped_unchanged_presents < MAX_SKIPPED_UNCHANGED_PRESENTS);
+  if (unchanged_skip)
+  {
+    Log_DebugPrintf("Skipping presenting unchanged frame");
+    s_skipped_unchanged_presents++;
+    Throttle(current_time);
+  }
+  else if (!adaptive_skip &&
+           (current_time < s_next_frame_time || s_syncing_to_host || s_optimal_frame_pacing || s_last_frame_skipped))
   {
+    s_skipped_unchanged_presents = 0;
+
     const bool throttle_before_present = (s_optimal_frame_pacing && s_throttler_enabled && !IsExecutionInterrupted());
     const bool explicit_present = (throttle_before_present && g_gpu_device->GetFeatures().explicit_present);
     if (explicit_present)
     {
       s_last_frame_skipped = !PresentDisplay(!throttle_before_present, true);
+      present_time = Common::Timer::GetCurrentValue() - current_time;
       Throttle(current_time);
       g_gpu_device->SubmitPresent();
     }
@@ -1978,19 +2529,24 @@ void System::FrameDone()
       if (throttle_before_present)
         Throttle(current_time);
 
+      const Common::Timer::Value present_start_time = Common::Timer::GetCurrentValue();
       s_last_frame_skipped = !PresentDisplay(!throttle_before_present, false);
+      present_time = Common::Timer::GetCurrentValue() - present_start_time;
 
       if (!throttle_before_present && s_throttler_enabled && !IsExecutionInterrupted())
         Throttle(current_time);
     }
   }
-  else if (current_time >= s_next_frame_time)
+  else
   {
     Log_DebugPrintf("Skipping displaying frame");
     s_last_frame_skipped = true;
     Throttle(current_time);
   }
 
+  if (s_adaptive_frame_skip)
+    UpdateAdaptiveFrameSkip(adaptive_skip, present_time);
+
   // pre-frame sleep (input lag reduction)
   current_time = Common::Timer::GetCurrentValue();
   if (s_pre_frame_sleep)
@@ -2007,10 +2563,12 @@ void System::FrameDone()
   s_frame_start_time = current_time;
 
   // Input poll already done above
-  if (s_runahead_frames == 0)
+  if (s_runahead_frames == 0 && !Netplay::IsActive())
   {
     Host::PumpMessagesOnCPUThread();
     InputManager::PollSources();
+    if (InputMovie::IsActive())
+      InputMovie::OnFrameDone();
 
     if (IsExecutionInterrupted())
     {
@@ -2028,6 +2586,68 @@ void System::FrameDone()
   System::UpdatePerformanceCounters();
 }
 
+bool System::IsSkippingFrame()
+{
+  return s_skipping_frame;
+}
+
+void System::ResetAdaptiveFrameSkip()
+{
+  s_skipping_frame = false;
+  s_consecutive_skipped_frames = 0;
+  s_frame_skip_credit = 0.0f;
+  s_presented_frame_cost = 0.0f;
+  s_skipped_frame_cost = 0.0f;
+}
+
+void System::UpdateAdaptiveFrameSkip(bool skipped, Common::Timer::Value present_time)
+{
+  // Smoothed cost of a frame which is displayed (emulation plus display/present, or the GPU time if that's longer),
+  // and of one which is skipped (emulation only, since the display update and post-processing are not done).
+  static constexpr float SMOOTHING = 0.1f;
+  const float active_time = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(s_last_active_frame_time));
+  if (skipped)
+  {
+    s_skipped_frame_cost = (s_skipped_frame_cost > 0.0f) ?
+                             (s_skipped_frame_cost + (active_time - s_skipped_frame_cost) * SMOOTHING) :
+                             active_time;
+  }
+  else if (present_time > 0)
+  {
+    float cost = active_time + static_cast<float>(Common::Timer::ConvertValueToMilliseconds(present_time));
+    if (g_gpu_device->IsGPUTimingEnabled())
+      cost = std::max(cost, s_average_gpu_time);
+
+    s_presented_frame_cost = (s_presented_frame_cost > 0.0f) ?
+                               (s_presented_frame_cost + (cost - s_presented_frame_cost) * SMOOTHING) :
+                               cost;
+  }
+
+  // Skip just enough frames to bring the average back under the frame period. Until a skipped frame has been
+  // measured, its cost is unknown, so assume skipping saves everything, and let the credit build up from there.
+  const float budget = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(s_frame_period));
+  float skip_ratio = 0.0f;
+  if (s_presented_frame_cost > budget && !s_media_capture)
+  {
+    static constexpr float MAX_SKIP_RATIO =
+      static_cast<float>(MAX_CONSECUTIVE_SKIPPED_FRAMES) / static_cast<float>(MAX_CONSECUTIVE_SKIPPED_FRAMES + 1);
+    const float saved_per_skip = std::max(s_presented_frame_cost - s_skipped_frame_cost, 0.1f);
+    skip_ratio = std::min((s_presented_frame_cost - budget) / saved_per_skip, MAX_SKIP_RATIO);
+  }
+
+  s_frame_skip_credit = (skip_ratio > 0.0f) ? (s_frame_skip_credit + skip_ratio) : 0.0f;
+  s_skipping_frame = (s_frame_skip_credit >= 1.0f && s_consecutive_skipped_frames < MAX_CONSECUTIVE_SKIPPED_FRAMES);
+  if (s_skipping_frame)
+  {
+    s_frame_skip_credit -= 1.0f;
+    s_consecutive_skipped_frames++;
+  }
+  else
+  {
+    s_consecutive_skipped_frames = 0;
+  }
+}
+
 void System::SetThrottleFrequency(float frequency)
 {
   if (s_throttle_frequency == frequency)
@@ -2042,12 +2662,18 @@ void System::UpdateThrottlePeriod()
   if (s_target_speed > std::numeric_limits<double>::epsilon())
   {
     const double target_speed = std::max(static_cast<double>(s_target_speed), std::numeric_limits<double>::epsilon());
-    s_frame_period =
-      Common::Timer::ConvertSecondsToValue(1.0 / (static_cast<double>(s_throttle_frequency) * target_speed));
+    const double period = (1.0 / (static_cast<double>(s_throttle_frequency) * target_speed)) *
+                          1000000000.0 * Common::Timer::GetFrequency();
+
+    // Keep the part of a tick that doesn't fit in the integer period, and add it back in Throttle(). Otherwise we'd
+    // run slightly fast, and drift away from the emulated refresh rate, which shows up as judder with VRR.
+    s_frame_period = static_cast<Common::Timer::Value>(period);
+    s_frame_period_fraction = period - static_cast<double>(s_frame_period);
   }
   else
   {
     s_frame_period = 1;
+    s_frame_period_fraction = 0.0;
   }
 
   ResetThrottler();
@@ -2056,6 +2682,7 @@ void System::UpdateThrottlePeriod()
 void System::ResetThrottler()
 {
   s_next_frame_time = Common::Timer::GetCurrentValue() + s_frame_period;
+  s_frame_period_remainder = 0.0;
   s_pre_frame_sleep_time = 0;
 }
 
@@ -2067,18 +2694,25 @@ void System::Throttle(Common::Timer::Value current_time)
   if (current_time > s_next_frame_time)
   {
     const Common::Timer::Value diff = static_cast<s64>(current_time) - static_cast<s64>(s_next_frame_time);
+    s_last_frame_pacing_error = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(diff));
     s_next_frame_time += (diff / s_frame_period) * s_frame_period + s_frame_period;
     return;
   }
 
   // Use a spinwait if we undersleep for all platforms except android.. don't want to burn battery.
-  // Linux also seems to do a much better job of waking up at the requested time.
-#if !defined(__linux__) && !defined(__ANDROID__)
+  // Linux does a much better job of waking up at the requested time, but with optimal frame pacing (i.e. VRR), the
+  // displayed frame is only as even as our wakeups, so it's still worth spinning off the last bit there.
+#ifndef __ANDROID__
   Common::Timer::SleepUntil(s_next_frame_time, g_settings.display_optimal_frame_pacing);
 #else
   Common::Timer::SleepUntil(s_next_frame_time, false);
 #endif
 
+  const Common::Timer::Value wake_time = Common::Timer::GetCurrentValue();
+  s_last_frame_pacing_error = static_cast<float>(
+    (wake_time >= s_next_frame_time) ? Common::Timer::ConvertValueToMilliseconds(wake_time - s_next_frame_time) :
+                                       -Common::Timer::ConvertValueToMilliseconds(s_next_frame_time - wake_time));
+
 #if 0
   Log_DevPrintf("Asked for %.2f ms, slept for %.2f ms, %.2f ms late",
                 Common::Timer::ConvertValueToMilliseconds(s_next_frame_time - current_time),
@@ -2087,6 +2721,12 @@ void System::Throttle(Common::Timer::Value current_time)
 #endif
 
   s_next_frame_time += s_frame_period;
+  s_frame_period_remainder += s_frame_period_fraction;
+  if (s_frame_period_remainder >= 1.0)
+  {
+    s_next_frame_time++;
+    s_frame_period_remainder -= 1.0;
+  }
 }
 
 void System::SingleStepCPU()
@@ -2141,9 +2781,18 @@ void System::RecreateSystem()
     PauseSystem(true);
 }
 
+RenderAPI System::GetRenderAPIForGPUDevice(GPURenderer renderer)
+{
+  // The null device can't draw, so it's only usable with the software renderer, which just uploads the display.
+  if (g_settings.gpu_use_null_device && renderer == GPURenderer::Software)
+    return RenderAPI::None;
+
+  return Settings::GetRenderAPIForRenderer(renderer);
+}
+
 bool System::CreateGPU(GPURenderer renderer, bool is_switching, Error* error)
 {
-  const RenderAPI api = Settings::GetRenderAPIForRenderer(renderer);
+  const RenderAPI api = GetRenderAPIForGPUDevice(renderer);
 
   if (!g_gpu_device ||
       (renderer != GPURenderer::Software && !GPUDevice::IsSameRenderAPI(g_gpu_device->GetRenderAPI(), api)))
@@ -2166,7 +2815,10 @@ bool System::CreateGPU(GPURenderer renderer, bool is_switching, Error* error)
       PostProcessing::Initialize();
   }
 
-  if (renderer == GPURenderer::Software)
+  // PSFs are music only, so there's nothing to render.
+  if (!s_running_game_path.empty() && IsPsfFileName(s_running_game_path))
+    g_gpu = GPU::CreateNullRenderer();
+  else if (renderer == GPURenderer::Software)
     g_gpu = GPU::CreateSoftwareRenderer();
   else
     g_gpu = GPU::CreateHardwareRenderer();
@@ -2198,6 +2850,20 @@ bool System::CreateGPU(GPURenderer renderer, bool is_switching, Error* error)
 
 bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display, bool is_memory_state)
 {
+  // loading a state takes the run off the recorded path
+  if (sw.IsReading() && InputMovie::IsActive())
+  {
+    Log_WarningPrint("Stopping input movie due to state load.");
+    InputMovie::Stop();
+  }
+
+  // rollback states are fine, anything else means we're no longer in sync with the other player
+  if (sw.IsReading() && !is_memory_state && Netplay::IsActive())
+  {
+    Log_WarningPrint("Stopping netplay due to state load.");
+    Netplay::Stop();
+  }
+
   if (!sw.DoMarker("System"))
     return false;
 
@@ -2225,20 +2891,16 @@ bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   if (!sw.DoMarker("CPU") || !CPU::DoState(sw))
     return false;
 
-  if (sw.IsReading())
-  {
-    if (is_memory_state)
-      CPU::CodeCache::InvalidateAllRAMBlocks();
-    else
-      CPU::CodeCache::Reset();
-  }
+  // memory states only invalidate the RAM pages which change, in Bus::DoState()
+  if (sw.IsReading() && !is_memory_state)
+    CPU::CodeCache::Reset();
 
   // only reset pgxp if we're not runahead-rollbacking. the value checks will save us from broken rendering, and it
   // saves using imprecise values for a frame in 30fps games.
   if (sw.IsReading() && g_settings.gpu_pgxp_enable && !is_memory_state)
     CPU::PGXP::Reset();
 
-  if (!sw.DoMarker("Bus") || !Bus::DoState(sw))
+  if (!sw.DoMarker("Bus") || !Bus::DoState(sw, is_memory_state))
     return false;
 
   if (!sw.DoMarker("DMA") || !DMA::DoState(sw))
@@ -2437,8 +3099,7 @@ bool System::LoadStateFromStream(ByteStream* state, Error* error, bool update_di
       else
       {
         Error local_error;
-        media =
-          CDImage::Open(media_filename.c_str(), g_settings.cdrom_load_image_patches, error ? error : &local_error);
+        media = OpenDiscImage(media_filename.c_str(), error ? error : &local_error);
         if (!media)
         {
           if (old_media)
@@ -2549,6 +3210,10 @@ bool System::SaveStateToStream(ByteStream* state, Error* error, u32 screenshot_s
   if (IsShutdown())
     return false;
 
+  // VRAM comes after the CPU and RAM in the state, so the download can happen while they're written.
+  g_gpu->BeginSaveStateVRAMReadback();
+  const ScopedGuard vram_readback_guard([]() { g_gpu->CancelSaveStateVRAMReadback(); });
+
   SAVE_STATE_HEADER header = {};
 
   const u64 header_position = state->GetPosition();
@@ -2636,7 +3301,10 @@ bool System::SaveStateToStream(ByteStream* state, Error* error, u32 screenshot_s
     }
     else if (compression_method == SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD)
     {
-      std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(state, 0));
+      // compress on worker threads while the state is serialized, leaving one core for the UI/GPU
+      const u32 num_threads =
+        std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1u, MAX_SAVE_STATE_COMPRESSION_THREADS);
+      std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(state, 0, num_threads));
       StateWrapper sw(cstream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
       result = DoState(sw, nullptr, false, false) && cstream->Commit();
       header.data_uncompressed_size = static_cast<u32>(cstream->GetPosition());
@@ -2671,6 +3339,10 @@ void System::UpdatePerformanceCounters()
   s_average_frame_time_accumulator += frame_time;
   s_maximum_frame_time_accumulator = std::max(s_maximum_frame_time_accumulator, frame_time);
   s_frame_time_history[s_frame_time_history_pos] = frame_time;
+  const float pacing_error = std::exchange(s_last_frame_pacing_error, 0.0f);
+  s_frame_pacing_jitter_accumulator += std::abs(pacing_error);
+  s_maximum_frame_pacing_error_accumulator = std::max(s_maximum_frame_pacing_error_accumulator, std::abs(pacing_error));
+  s_frame_pacing_error_history[s_frame_time_history_pos] = pacing_error;
   s_frame_time_history_pos = (s_frame_time_history_pos + 1) % NUM_FRAME_TIME_SAMPLES;
 
   // update fps counter
@@ -2694,6 +3366,8 @@ void System::UpdatePerformanceCounters()
   s_minimum_frame_time = std::exchange(s_minimum_frame_time_accumulator, 0.0f);
   s_average_frame_time = std::exchange(s_average_frame_time_accumulator, 0.0f) / frames_runf;
   s_maximum_frame_time = std::exchange(s_maximum_frame_time_accumulator, 0.0f);
+  s_frame_pacing_jitter = std::exchange(s_frame_pacing_jitter_accumulator, 0.0f) / frames_runf;
+  s_maximum_frame_pacing_error = std::exchange(s_maximum_frame_pacing_error_accumulator, 0.0f);
 
   s_vps = static_cast<float>(frames_runf / time);
   s_last_frame_number = s_frame_number;
@@ -2723,10 +3397,34 @@ void System::UpdatePerformanceCounters()
   {
     s_average_gpu_time = s_accumulated_gpu_time / static_cast<float>(std::max(s_presents_since_last_update, 1u));
     s_gpu_usage = s_accumulated_gpu_time / (time * 10.0f);
+
+    // Fast forward shortens the frame period, but shouldn't lower the resolution.
+    if (g_settings.gpu_dynamic_resolution && s_presents_since_last_update > 0 && !IsRunningAtNonStandardSpeed())
+    {
+      g_gpu->UpdateDynamicResolution(s_average_gpu_time,
+                                     static_cast<float>(Common::Timer::ConvertValueToMilliseconds(s_frame_period)));
+    }
+
+    if (g_gpu_device->IsGPUTimingRegionsEnabled())
+    {
+      SmallString region_str;
+      for (u32 i = 0; i < static_cast<u32>(GPUTimingRegion::Count); i++)
+      {
+        s_average_gpu_region_times[i] =
+          s_accumulated_gpu_region_times[i] / static_cast<float>(std::max(s_presents_since_last_update, 1u));
+        region_str.append_format("{}{}: {:.3f}ms", (i > 0) ? " " : "",
+                                 GPU::GetTimingRegionName(static_cast<GPUTimingRegion>(i)),
+                                 s_average_gpu_region_times[i]);
+      }
+      Log_VerboseFmt("GPU time per frame: {}", region_str);
+    }
   }
   s_accumulated_gpu_time = 0.0f;
+  s_accumulated_gpu_region_times = {};
   s_presents_since_last_update = 0;
 
+  g_gpu_device->UpdatePipelineCache();
+
   if (g_settings.display_show_gpu_stats)
     g_gpu->UpdateStatistics(frames_run);
 
@@ -2753,9 +3451,14 @@ void System::ResetPerformanceCounters()
   s_average_frame_time_accumulator = 0.0f;
   s_minimum_frame_time_accumulator = 0.0f;
   s_maximum_frame_time_accumulator = 0.0f;
+  s_frame_pacing_jitter_accumulator = 0.0f;
+  s_maximum_frame_pacing_error_accumulator = 0.0f;
   s_frame_timer.Reset();
   s_fps_timer.Reset();
   ResetThrottler();
+
+  // pausing or loading a state would count towards the input's latency
+  ClearPendingInputLatency();
 }
 
 void System::AccumulatePreFrameSleepTime()
@@ -2808,6 +3511,103 @@ void System::FormatLatencyStats(SmallStringBase& str)
              audio_latency);
 }
 
+void System::GetInputLatencyStats(InputLatencyStats* stats)
+{
+  *stats = {};
+  stats->num_samples = s_input_latency_sample_count;
+  if (s_input_latency_sample_count == 0)
+    return;
+
+  stats->minimum = std::numeric_limits<float>::max();
+  for (u32 i = 0; i < s_input_latency_sample_count; i++)
+  {
+    const InputLatencySample& sample = s_input_latency_samples[i];
+    stats->average.latch += sample.latch;
+    stats->average.frame_done += sample.frame_done;
+    stats->average.submit += sample.submit;
+    stats->average.present += sample.present;
+    stats->minimum = std::min(stats->minimum, sample.present);
+    stats->maximum = std::max(stats->maximum, sample.present);
+
+    const u32 bucket = static_cast<u32>(sample.present / INPUT_LATENCY_HISTOGRAM_BUCKET_MS);
+    stats->histogram[std::min(bucket, NUM_INPUT_LATENCY_HISTOGRAM_BUCKETS - 1)]++;
+  }
+
+  const float count = static_cast<float>(s_input_latency_sample_count);
+  stats->average.latch /= count;
+  stats->average.frame_done /= count;
+  stats->average.submit /= count;
+  stats->average.present /= count;
+}
+
+void System::ResetInputLatencyStats()
+{
+  ClearPendingInputLatency();
+  s_input_latency_sample_pos = 0;
+  s_input_latency_sample_count = 0;
+}
+
+void System::ClearPendingInputLatency()
+{
+  s_input_latency_event_time = 0;
+  s_input_latency_latch_time = 0;
+  s_input_latency_frame_done_time = 0;
+  s_input_latency_submit_time = 0;
+}
+
+void System::Internal::OnHostInputEvent()
+{
+  if (s_input_latency_event_time == 0)
+    s_input_latency_event_time = Common::Timer::GetCurrentValue();
+}
+
+void System::Internal::OnControllerLatched()
+{
+  // Pick up any input which arrived since the start of the frame, right before the game reads it. Runahead,
+  // movies and netplay expect input to only change on frame boundaries, and runahead already hides the latency anyway.
+  if (g_settings.late_input_polling && s_runahead_frames == 0 && !InputMovie::IsActive() &&
+      !Netplay::IsActive())
+    InputManager::PollSourcesForControllerRead();
+
+  if (s_input_latency_event_time != 0 && s_input_latency_latch_time == 0)
+    s_input_latency_latch_time = Common::Timer::GetCurrentValue();
+}
+
+void System::SetSubsystemProfilingEnabled(bool enabled)
+{
+  if (enabled)
+  {
+    for (std::atomic<Common::Timer::Value>& time : s_subsystem_times)
+      time.store(0, std::memory_order_relaxed);
+  }
+
+  g_subsystem_profiling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+double System::GetSubsystemTime(ProfiledSubsystem subsystem)
+{
+  return Common::Timer::ConvertValueToSeconds(
+    s_subsystem_times[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed));
+}
+
+void System::AddSubsystemTime(ProfiledSubsystem subsystem, Common::Timer::Value ticks)
+{
+  s_subsystem_times[static_cast<size_t>(subsystem)].fetch_add(ticks, std::memory_order_relaxed);
+}
+
+double System::GetCPUThreadCPUTime()
+{
+  const u64 time = s_cpu_thread_handle ? s_cpu_thread_handle.GetCPUTime() : 0;
+  return static_cast<double>(time) / static_cast<double>(Threading::GetThreadTicksPerSecond());
+}
+
+double System::GetSWThreadCPUTime()
+{
+  const Threading::Thread* sw_thread = g_gpu ? g_gpu->GetSWThread() : nullptr;
+  const u64 time = sw_thread ? sw_thread->GetCPUTime() : 0;
+  return static_cast<double>(time) / static_cast<double>(Threading::GetThreadTicksPerSecond());
+}
+
 void System::UpdateSpeedLimiterState()
 {
   const float old_target_speed = s_target_speed;
@@ -2818,6 +3618,13 @@ void System::UpdateSpeedLimiterState()
   s_optimal_frame_pacing = s_throttler_enabled && g_settings.display_optimal_frame_pacing;
   s_pre_frame_sleep = s_throttler_enabled && g_settings.display_pre_frame_sleep;
 
+  const bool adaptive_frame_skip = s_throttler_enabled && g_settings.display_adaptive_frame_skip;
+  if (s_adaptive_frame_skip != adaptive_frame_skip)
+  {
+    s_adaptive_frame_skip = adaptive_frame_skip;
+    ResetAdaptiveFrameSkip();
+  }
+
   s_syncing_to_host = false;
   if (g_settings.sync_to_host_refresh_rate &&
       (g_settings.audio_stream_parameters.stretch_mode != AudioStretchMode::Off) && s_target_speed == 1.0f && IsValid())
@@ -2880,6 +3687,11 @@ void System::UpdateDisplaySync()
 
   g_gpu_device->SetDisplayMaxFPS(max_display_fps);
   g_gpu_device->SetVSyncEnabled(vsync_enabled);
+
+  // If requested, and vsync isn't what's pacing emulation, don't let a full present queue stall the next frame.
+  g_gpu_device->SetNonBlockingPresentEnabled(vsync_enabled && !syncing_to_host_vsync &&
+                                             g_settings.gpu_threaded_presentation &&
+                                             g_settings.gpu_non_blocking_presentation);
 }
 
 bool System::IsVSyncEffectivelyEnabled()
@@ -3492,7 +4304,9 @@ std::string System::GetMediaFileName()
 bool System::InsertMedia(const char* path)
 {
   Error error;
-  std::unique_ptr<CDImage> image = CDImage::Open(path, g_settings.cdrom_load_image_patches, &error);
+  std::unique_ptr<CDImage> image = TakePrefetchedDisc(path);
+  if (!image)
+    image = OpenDiscImage(path, &error);
   if (!image)
   {
     Host::AddIconOSDMessage(
@@ -3557,7 +4371,15 @@ void System::UpdateRunningGame(const char* path, CDImage* image, bool booting)
     else if (image && image->GetTrack(1).mode != CDImage::TrackMode::Audio)
     {
       std::string id;
-      GetGameDetailsFromImage(image, &id, &s_running_game_hash);
+      if (booting && image == s_boot_disc_image)
+      {
+        id = s_boot_disc_id;
+        s_running_game_hash = s_boot_disc_hash;
+      }
+      else
+      {
+        GetGameDetailsFromImage(image, &id, &s_running_game_hash);
+      }
 
       s_running_game_entry = GameDatabase::GetEntryForGameDetails(id, s_running_game_hash);
       if (s_running_game_entry)
@@ -3596,8 +4418,14 @@ void System::UpdateRunningGame(const char* path, CDImage* image, bool booting)
     LoadCheatList();
 
   if (s_running_game_serial != prev_serial)
+  {
     UpdateSessionTime(prev_serial);
 
+    // Blocks are cached per serial, so a disc change has to switch to the new game's cache.
+    if (!booting)
+      CPU::CodeCache::ReloadPersistentCache();
+  }
+
   if (SaveStateSelectorUI::IsOpen())
     SaveStateSelectorUI::RefreshList(s_running_game_serial);
   else
@@ -3607,9 +4435,60 @@ void System::UpdateRunningGame(const char* path, CDImage* image, bool booting)
   UpdateDiscordPresence(booting);
 #endif
 
+  PrefetchNextDiscSetMember();
+
   Host::OnGameChanged(s_running_game_path, s_running_game_serial, s_running_game_title);
 }
 
+void System::PrefetchNextDiscSetMember()
+{
+  // Only the following disc is opened, that's the one which the game asks for in the vast majority of cases.
+  std::string next_path;
+  if (s_running_game_entry && s_running_game_entry->disc_set_serials.size() > 1 && GameList::IsGameListLoaded())
+  {
+    const std::vector<std::string>& serials = s_running_game_entry->disc_set_serials;
+    const auto iter = std::find(serials.begin(), serials.end(), s_running_game_serial);
+    if (iter != serials.end() && (iter + 1) != serials.end())
+    {
+      const auto lock = GameList::GetLock();
+      const GameList::Entry* entry = GameList::GetEntryBySerial(*(iter + 1));
+      if (entry && entry->IsDisc())
+        next_path = entry->path;
+    }
+  }
+
+  if (next_path == s_next_disc_path)
+    return;
+
+  s_next_disc_path = std::move(next_path);
+  if (s_next_disc_path.empty())
+  {
+    s_next_disc_image = {};
+    return;
+  }
+
+  Log_DevFmt("Prefetching next disc '{}'", Path::GetFileName(s_next_disc_path));
+  s_next_disc_image = Threading::ThreadPool::GetShared().Submit(
+    [path = s_next_disc_path]() {
+      std::unique_ptr<CDImage> image = OpenDiscImage(path.c_str(), nullptr);
+      if (image)
+        image->WarmUp();
+      return image;
+    },
+    Threading::ThreadPool::Priority::Low);
+}
+
+std::unique_ptr<CDImage> System::TakePrefetchedDisc(const char* path)
+{
+  if (!s_next_disc_image.valid() || s_next_disc_path != path)
+    return {};
+
+  // Usually finished long ago, but if not, it's still further along than starting over.
+  std::unique_ptr<CDImage> image = s_next_disc_image.get();
+  s_next_disc_path = {};
+  return image;
+}
+
 bool System::CheckForSBIFile(CDImage* image, Error* error)
 {
   if (!s_running_game_entry || !s_running_game_entry->HasTrait(GameDatabase::Trait::IsLibCryptProtected) || !image ||
@@ -3748,6 +4627,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
   if (IsValid() &&
       (g_settings.gpu_renderer != old_settings.gpu_renderer ||
        g_settings.gpu_use_debug_device != old_settings.gpu_use_debug_device ||
+       g_settings.gpu_use_null_device != old_settings.gpu_use_null_device ||
        g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation ||
        g_settings.gpu_disable_shader_cache != old_settings.gpu_disable_shader_cache ||
        g_settings.gpu_disable_dual_source_blend != old_settings.gpu_disable_dual_source_blend ||
@@ -3759,6 +4639,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     // if debug device/threaded presentation change, we need to recreate the whole display
     const bool recreate_device =
       (g_settings.gpu_use_debug_device != old_settings.gpu_use_debug_device ||
+       g_settings.gpu_use_null_device != old_settings.gpu_use_null_device ||
        g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation ||
        g_settings.gpu_disable_shader_cache != old_settings.gpu_disable_shader_cache ||
        g_settings.gpu_disable_dual_source_blend != old_settings.gpu_disable_dual_source_blend ||
@@ -3832,6 +4713,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
          g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_superblocks != old_settings.cpu_recompiler_superblocks ||
+         g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping ||
          g_settings.bios_tty_logging != old_settings.bios_tty_logging))
     {
       Host::AddIconOSDMessage("CPUFlushAllBlocks", ICON_FA_MICROCHIP,
@@ -3848,6 +4731,14 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     {
       CPU::UpdateDebugDispatcherFlag();
     }
+    else if (g_settings.cpu_execution_mode == CPUExecutionMode::CachedInterpreter &&
+             g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping)
+    {
+      CPU::CodeCache::Reset();
+    }
+
+    if (g_settings.cpu_recompiler_persistent_cache != old_settings.cpu_recompiler_persistent_cache)
+      CPU::CodeCache::ReloadPersistentCache();
 
     if (g_settings.enable_cheats != old_settings.enable_cheats)
     {
@@ -3860,15 +4751,24 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     SPU::GetOutputStream()->SetOutputVolume(GetAudioOutputVolume());
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
+        g_settings.gpu_dynamic_resolution != old_settings.gpu_dynamic_resolution ||
+        g_settings.gpu_dynamic_resolution_min_scale != old_settings.gpu_dynamic_resolution_min_scale ||
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_use_hardware_render_thread != old_settings.gpu_use_hardware_render_thread ||
+        g_settings.gpu_sw_rasterizer_threads != old_settings.gpu_sw_rasterizer_threads ||
+        g_settings.gpu_sw_span_jit != old_settings.gpu_sw_span_jit ||
         g_settings.gpu_use_software_renderer_for_readbacks != old_settings.gpu_use_software_renderer_for_readbacks ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
         g_settings.gpu_debanding != old_settings.gpu_debanding ||
         g_settings.gpu_scaled_dithering != old_settings.gpu_scaled_dithering ||
+        g_settings.gpu_batch_mixed_texture_modes != old_settings.gpu_batch_mixed_texture_modes ||
+        g_settings.gpu_defer_pipeline_compilation != old_settings.gpu_defer_pipeline_compilation ||
+        g_settings.gpu_texture_filter_cache != old_settings.gpu_texture_filter_cache ||
+        g_settings.gpu_sparse_vram != old_settings.gpu_sparse_vram ||
         g_settings.gpu_texture_filter != old_settings.gpu_texture_filter ||
         g_settings.gpu_line_detect_mode != old_settings.gpu_line_detect_mode ||
         g_settings.gpu_disable_interlacing != old_settings.gpu_disable_interlacing ||
@@ -3928,6 +4828,12 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
       CDROM::SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
 
+    if (g_settings.mdec_use_thread != old_settings.mdec_use_thread)
+      MDEC::SetUseThread(g_settings.mdec_use_thread);
+
+    if (g_settings.spu_use_thread != old_settings.spu_use_thread)
+      SPU::SetUseThread(g_settings.spu_use_thread);
+
     if (g_settings.memory_card_types != old_settings.memory_card_types ||
         g_settings.memory_card_paths != old_settings.memory_card_paths ||
         (g_settings.memory_card_use_playlist_title != old_settings.memory_card_use_playlist_title))
@@ -3961,7 +4867,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.display_optimal_frame_pacing != old_settings.display_optimal_frame_pacing ||
         g_settings.display_pre_frame_sleep != old_settings.display_pre_frame_sleep ||
         g_settings.display_pre_frame_sleep_buffer != old_settings.display_pre_frame_sleep_buffer ||
+        g_settings.display_adaptive_frame_skip != old_settings.display_adaptive_frame_skip ||
         g_settings.display_vsync != old_settings.display_vsync ||
+        g_settings.gpu_non_blocking_presentation != old_settings.gpu_non_blocking_presentation ||
         g_settings.sync_to_host_refresh_rate != old_settings.sync_to_host_refresh_rate)
     {
       UpdateSpeedLimiterState();
@@ -4024,7 +4932,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
       g_settings.log_timestamps != old_settings.log_timestamps ||
       g_settings.log_to_console != old_settings.log_to_console ||
       g_settings.log_to_debug != old_settings.log_to_debug || g_settings.log_to_window != old_settings.log_to_window ||
-      g_settings.log_to_file != old_settings.log_to_file)
+      g_settings.log_to_file != old_settings.log_to_file || g_settings.log_async != old_settings.log_async)
   {
     g_settings.UpdateLogSettings();
   }
@@ -4123,13 +5031,43 @@ void System::CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u64
 
 void System::ClearMemorySaveStates()
 {
+  SyncRewindThread();
+
+  for (PendingRewindState& ps : s_pending_rewind_states)
+    ReleaseVRAMSnapshot(std::move(ps.vram_texture));
+  for (RewindState& rs : s_rewind_states)
+    ReleaseVRAMSnapshot(std::move(rs.vram_texture));
+
   s_rewind_states.clear();
-  s_runahead_states.clear();
+  s_rewind_keyframe.reset();
+  s_rewind_keyframe_data = {};
+  s_rewind_delta_buffer = {};
+  s_rewind_compress_stream.reset();
+  s_rewind_scratch_state = {};
+  s_rewind_saves_since_keyframe = 0;
+  s_rewind_memory_usage = 0;
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::Rewind, 0);
+  ClearRunaheadStates();
+
+  // the rewind thread is idle, so it's safe to swap the dictionary if the game changed
+  UpdateRewindDictionary();
+}
+
+u64 System::GetRewindMemoryPerSecond()
+{
+  std::unique_lock lock(s_rewind_mutex);
+  if (s_rewind_states.empty() || g_settings.rewind_save_frequency <= 0.0f)
+    return 0;
+
+  const float history_seconds = static_cast<float>(s_rewind_states.size()) * g_settings.rewind_save_frequency;
+  return static_cast<u64>(static_cast<float>(s_rewind_memory_usage) / history_seconds);
 }
 
 void System::UpdateMemorySaveStateSettings()
 {
+  // the pool is resized for the new history the next time a state is saved
   ClearMemorySaveStates();
+  DestroyVRAMSnapshots();
 
   s_memory_saves_enabled = g_settings.rewind_enable;
 
@@ -4137,6 +5075,7 @@ void System::UpdateMemorySaveStateSettings()
   {
     s_rewind_save_frequency = static_cast<s32>(std::ceil(g_settings.rewind_save_frequency * s_throttle_frequency));
     s_rewind_save_counter = 0;
+    StartRewindThread();
 
     u64 ram_usage, vram_usage;
     CalculateRewindMemoryUsage(g_settings.rewind_save_slots, g_settings.gpu_resolution_scale, &ram_usage, &vram_usage);
@@ -4148,6 +5087,7 @@ void System::UpdateMemorySaveStateSettings()
   {
     s_rewind_save_frequency = -1;
     s_rewind_save_counter = -1;
+    StopRewindThread();
   }
 
   s_rewind_load_frequency = -1;
@@ -4163,7 +5103,8 @@ bool System::LoadMemoryState(const MemorySaveState& mss)
 {
   mss.state_stream->SeekAbsolute(0);
 
-  StateWrapper sw(mss.state_stream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  StateWrapper sw(std::span<u8>(mss.state_stream->GetMemoryPointer(), static_cast<size_t>(mss.state_stream->GetSize())),
+                  StateWrapper::Mode::Read, SAVE_STATE_VERSION);
   GPUTexture* host_texture = mss.vram_texture.get();
   if (!DoState(sw, &host_texture, true, true))
   {
@@ -4179,45 +5120,313 @@ bool System::SaveMemoryState(MemorySaveState* mss)
 {
   if (!mss->state_stream)
     mss->state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
-  else
-    mss->state_stream->SeekAbsolute(0);
+  else if (mss->state_stream->GetMemorySize() < MAX_SAVE_STATE_SIZE)
+    mss->state_stream->ResizeMemory(MAX_SAVE_STATE_SIZE);
 
+  // Written directly to the stream's memory, since this happens every frame with runahead or rewind.
   GPUTexture* host_texture = mss->vram_texture.release();
-  StateWrapper sw(mss->state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  StateWrapper sw(std::span<u8>(mss->state_stream->GetMemoryPointer(), mss->state_stream->GetMemorySize()),
+                  StateWrapper::Mode::Write, SAVE_STATE_VERSION);
   if (!DoState(sw, &host_texture, false, true))
   {
     Log_ErrorPrint("Failed to create rewind state.");
-    delete host_texture;
+    mss->vram_texture.reset(host_texture);
     return false;
   }
 
+  const u32 size = static_cast<u32>(sw.GetPosition());
+  mss->state_stream->Resize(size);
+  mss->state_stream->SeekAbsolute(size);
   mss->vram_texture.reset(host_texture);
   return true;
 }
 
+bool System::CompressRewindData(const u8* data, u32 size, std::vector<u8>* compressed_data,
+                                std::span<const u8> dictionary /* = {} */)
+{
+  if (!s_rewind_compress_stream)
+    s_rewind_compress_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+  else
+    s_rewind_compress_stream->SeekAbsolute(0);
+
+  std::unique_ptr<ByteStream> cstream =
+    ByteStream::CreateZstdCompressStream(s_rewind_compress_stream.get(), REWIND_COMPRESSION_LEVEL, 0, dictionary);
+  if (!cstream->Write2(data, size) || !cstream->Commit())
+  {
+    Log_ErrorPrint("Failed to compress rewind state.");
+    return false;
+  }
+
+  // copy out to an exactly-sized buffer, the scratch stream is reused
+  const u8* compressed_ptr = s_rewind_compress_stream->GetMemoryPointer();
+  *compressed_data =
+    std::vector<u8>(compressed_ptr, compressed_ptr + static_cast<u32>(s_rewind_compress_stream->GetPosition()));
+  return true;
+}
+
+bool System::DecompressRewindData(const std::vector<u8>& compressed_data, u8* data, u32 size,
+                                  std::span<const u8> dictionary /* = {} */)
+{
+  const u32 compressed_size = static_cast<u32>(compressed_data.size());
+  ReadOnlyMemoryByteStream stream(compressed_data.data(), compressed_size);
+  std::unique_ptr<ByteStream> dstream = ByteStream::CreateZstdDecompressStream(&stream, compressed_size, dictionary);
+  return dstream->Read2(data, size);
+}
+
+std::string System::GetRewindDictionaryPath(std::string_view serial)
+{
+  return Path::Combine(Path::Combine(EmuFolders::Cache, "rewind_dictionaries"),
+                       fmt::format("{}.zdict", Path::SanitizeFileName(serial)));
+}
+
+void System::UpdateRewindDictionary()
+{
+  if (s_rewind_dictionary_serial == s_running_game_serial)
+    return;
+
+  s_rewind_dictionary.reset();
+  s_rewind_dictionary_serial = s_running_game_serial;
+  s_rewind_dictionary_samples = {};
+  s_rewind_dictionary_sample_keyframes = 0;
+  if (s_rewind_dictionary_serial.empty())
+    return;
+
+  std::optional<std::vector<u8>> data =
+    FileSystem::ReadBinaryFile(GetRewindDictionaryPath(s_rewind_dictionary_serial).c_str());
+  if (data.has_value() && !data->empty())
+  {
+    Log_DevFmt("Loaded {} byte rewind dictionary for {}", data->size(), s_rewind_dictionary_serial);
+    s_rewind_dictionary = std::make_shared<const std::vector<u8>>(std::move(data.value()));
+  }
+}
+
+void System::AddRewindDictionarySamples(const u8* data, u32 size)
+{
+  // only games with a serial get one, since it's stored by serial
+  if (s_rewind_dictionary || s_rewind_dictionary_serial.empty())
+    return;
+
+  for (u32 offset = 0; (offset + REWIND_DICTIONARY_SAMPLE_SIZE) <= size;
+       offset += REWIND_DICTIONARY_SAMPLE_SIZE * REWIND_DICTIONARY_SAMPLE_STRIDE)
+  {
+    s_rewind_dictionary_samples.insert(s_rewind_dictionary_samples.end(), data + offset,
+                                       data + offset + REWIND_DICTIONARY_SAMPLE_SIZE);
+  }
+
+  if ((++s_rewind_dictionary_sample_keyframes) < REWIND_DICTIONARY_SAMPLE_KEYFRAMES)
+    return;
+
+  Common::Timer train_timer;
+  const std::vector<size_t> sample_sizes(s_rewind_dictionary_samples.size() / REWIND_DICTIONARY_SAMPLE_SIZE,
+                                         REWIND_DICTIONARY_SAMPLE_SIZE);
+  std::vector<u8> dictionary = ByteStream::TrainZstdDictionary(s_rewind_dictionary_samples.data(), sample_sizes,
+                                                               REWIND_DICTIONARY_MAX_SIZE);
+  s_rewind_dictionary_samples = {};
+  if (dictionary.empty())
+    return;
+
+  Log_DevFmt("Trained {} byte rewind dictionary for {} in {:.2f} ms", dictionary.size(), s_rewind_dictionary_serial,
+             train_timer.GetTimeMilliseconds());
+
+  const std::string path = GetRewindDictionaryPath(s_rewind_dictionary_serial);
+  Error error;
+  if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(path)).c_str(), false, &error))
+    Log_WarningFmt("Failed to create rewind dictionary directory: {}", error.GetDescription());
+  else if (!FileSystem::WriteBinaryFile(path.c_str(), dictionary.data(), dictionary.size()))
+    Log_WarningFmt("Failed to save rewind dictionary to '{}'", path);
+
+  s_rewind_dictionary = std::make_shared<const std::vector<u8>>(std::move(dictionary));
+}
+
+void System::UpdateRewindMemoryUsage()
+{
+  // consecutive states share keyframes, so only count each one once
+  u64 usage = 0;
+  const RewindKeyframe* last_keyframe = nullptr;
+  for (const RewindState& rs : s_rewind_states)
+  {
+    usage += rs.compressed_delta.size();
+    if (rs.keyframe.get() != last_keyframe)
+    {
+      usage += rs.keyframe->compressed_data.size();
+      last_keyframe = rs.keyframe.get();
+    }
+  }
+
+  s_rewind_memory_usage = usage;
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::Rewind, static_cast<size_t>(usage));
+}
+
+void System::StartRewindThread()
+{
+  if (s_rewind_thread.joinable())
+    return;
+
+  for (PendingRewindState& ps : s_pending_rewind_states)
+    ps.state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+
+  s_rewind_thread_shutdown = false;
+  s_rewind_thread = std::thread(&System::RewindThreadEntryPoint);
+}
+
+void System::StopRewindThread()
+{
+  if (!s_rewind_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(s_rewind_mutex);
+    s_rewind_thread_shutdown = true;
+    s_rewind_thread_cv.notify_one();
+  }
+
+  s_rewind_thread.join();
+
+  // anything left over was never encoded
+  s_pending_rewind_read = 0;
+  s_pending_rewind_count = 0;
+  for (PendingRewindState& ps : s_pending_rewind_states)
+  {
+    ReleaseVRAMSnapshot(std::move(ps.vram_texture));
+    ps.state_stream.reset();
+  }
+}
+
+void System::SyncRewindThread()
+{
+  std::unique_lock lock(s_rewind_mutex);
+  s_rewind_done_cv.wait(lock, []() { return (s_pending_rewind_count == 0 || !s_rewind_thread.joinable()); });
+}
+
+void System::RewindThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Rewind Compression");
+
+  std::unique_lock lock(s_rewind_mutex);
+  for (;;)
+  {
+    s_rewind_thread_cv.wait(lock, []() { return (s_pending_rewind_count > 0 || s_rewind_thread_shutdown); });
+    if (s_rewind_thread_shutdown)
+      break;
+
+    // the CPU thread won't touch the slot until it's retired
+    PendingRewindState& ps = s_pending_rewind_states[s_pending_rewind_read];
+    lock.unlock();
+
+#ifdef PROFILE_MEMORY_SAVE_STATES
+    Common::Timer encode_timer;
+#endif
+
+    RewindState rs;
+    const u8* data = ps.state_stream->GetMemoryPointer();
+    const u32 size = ps.size;
+    bool result;
+    if (!s_rewind_keyframe || s_rewind_saves_since_keyframe >= REWIND_KEYFRAME_INTERVAL)
+    {
+      std::shared_ptr<RewindKeyframe> keyframe = std::make_shared<RewindKeyframe>();
+      keyframe->dictionary = s_rewind_dictionary;
+      result = CompressRewindData(data, size, &keyframe->compressed_data,
+                                  keyframe->dictionary ? std::span<const u8>(*keyframe->dictionary) :
+                                                         std::span<const u8>());
+      if (result)
+      {
+        AddRewindDictionarySamples(data, size);
+        keyframe->size = size;
+        s_rewind_keyframe_data.assign(data, data + size);
+        s_rewind_keyframe = std::move(keyframe);
+        s_rewind_saves_since_keyframe = 0;
+      }
+    }
+    else
+    {
+      // the state can change size slightly, anything past the end of the keyframe is stored as-is
+      s_rewind_delta_buffer.assign(data, data + size);
+      const u32 xor_size = std::min(size, static_cast<u32>(s_rewind_keyframe_data.size()));
+      const u8* keyframe_data = s_rewind_keyframe_data.data();
+      u8* delta = s_rewind_delta_buffer.data();
+      for (u32 i = 0; i < xor_size; i++)
+        delta[i] ^= keyframe_data[i];
+
+      result = CompressRewindData(delta, size, &rs.compressed_delta);
+    }
+
+#ifdef PROFILE_MEMORY_SAVE_STATES
+    if (result)
+    {
+      Log_DevFmt("Encoded rewind state ({} bytes, {} compressed, took {:.4f} ms)", size,
+                 rs.compressed_delta.empty() ? s_rewind_keyframe->compressed_data.size() : rs.compressed_delta.size(),
+                 encode_timer.GetTimeMilliseconds());
+    }
+#endif
+
+    lock.lock();
+
+    if (result)
+    {
+      rs.vram_texture = std::move(ps.vram_texture);
+      rs.keyframe = s_rewind_keyframe;
+      rs.size = size;
+      s_rewind_saves_since_keyframe++;
+      s_rewind_states.push_back(std::move(rs));
+      UpdateRewindMemoryUsage();
+    }
+
+    s_pending_rewind_read = (s_pending_rewind_read + 1) % NUM_PENDING_REWIND_STATES;
+    s_pending_rewind_count--;
+    s_rewind_done_cv.notify_all();
+  }
+}
+
 bool System::SaveRewindState()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Common::Timer save_timer;
 #endif
 
-  // try to reuse the frontmost slot
+  std::unique_lock lock(s_rewind_mutex);
+
+  // if the rewind thread has fallen behind, drop this save rather than stalling the frame
+  if (s_pending_rewind_count == NUM_PENDING_REWIND_STATES)
+  {
+    Log_DevPrint("Rewind thread is busy, skipping save.");
+    return false;
+  }
+
+  // try to reuse the frontmost slot's texture
+  PendingRewindState& ps =
+    s_pending_rewind_states[(s_pending_rewind_read + s_pending_rewind_count) % NUM_PENDING_REWIND_STATES];
   const u32 save_slots = g_settings.rewind_save_slots;
-  MemorySaveState mss;
-  while (s_rewind_states.size() >= save_slots)
+  while (!s_rewind_states.empty() && (s_rewind_states.size() + s_pending_rewind_count) >= save_slots)
   {
-    mss = std::move(s_rewind_states.front());
+    if (!ps.vram_texture)
+      ps.vram_texture = std::move(s_rewind_states.front().vram_texture);
+    else
+      ReleaseVRAMSnapshot(std::move(s_rewind_states.front().vram_texture));
     s_rewind_states.pop_front();
   }
+  UpdateRewindMemoryUsage();
 
-  if (!SaveMemoryState(&mss))
+  // slot isn't visible to the rewind thread until the count is bumped
+  lock.unlock();
+
+  if (!ps.vram_texture)
+    ps.vram_texture = AcquireVRAMSnapshot();
+
+  MemorySaveState mss{std::move(ps.vram_texture), std::move(ps.state_stream)};
+  const bool result = SaveMemoryState(&mss);
+  ps.vram_texture = std::move(mss.vram_texture);
+  ps.state_stream = std::move(mss.state_stream);
+  if (!result)
     return false;
 
-  s_rewind_states.push_back(std::move(mss));
+  ps.size = static_cast<u32>(ps.state_stream->GetPosition());
+
+  lock.lock();
+  s_pending_rewind_count++;
+  s_rewind_thread_cv.notify_one();
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
-  Log_DevPrintf("Saved rewind state (%" PRIu64 " bytes, took %.4f ms)", s_rewind_states.back().state_stream->GetSize(),
-                save_timer.GetTimeMilliseconds());
+  Log_DevFmt("Saved rewind state ({} bytes, took {:.4f} ms)", ps.size, save_timer.GetTimeMilliseconds());
 #endif
 
   return true;
@@ -4225,13 +5434,18 @@ bool System::SaveRewindState()
 
 bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true */)
 {
+  // make sure the most recent saves have been encoded, this also leaves the rewind thread idle so the states can be
+  // accessed without the lock, since only this thread queues saves
+  SyncRewindThread();
+
   while (skip_saves > 0 && !s_rewind_states.empty())
   {
-    g_gpu_device->RecycleTexture(std::move(s_rewind_states.back().vram_texture));
+    ReleaseVRAMSnapshot(std::move(s_rewind_states.back().vram_texture));
     s_rewind_states.pop_back();
     skip_saves--;
   }
 
+  UpdateRewindMemoryUsage();
   if (s_rewind_states.empty())
     return false;
 
@@ -4239,11 +5453,68 @@ bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true
   Common::Timer load_timer;
 #endif
 
-  if (!LoadMemoryState(s_rewind_states.back()))
+  RewindState& rs = s_rewind_states.back();
+  const RewindKeyframe& keyframe = *rs.keyframe;
+  const std::span<const u8> keyframe_dictionary =
+    keyframe.dictionary ? std::span<const u8>(*keyframe.dictionary) : std::span<const u8>();
+  MemorySaveState& mss = s_rewind_scratch_state;
+  if (!mss.state_stream)
+    mss.state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+  mss.state_stream->Resize(rs.size);
+
+  u8* data = mss.state_stream->GetMemoryPointer();
+  if (rs.compressed_delta.empty())
+  {
+    if (!DecompressRewindData(keyframe.compressed_data, data, rs.size, keyframe_dictionary))
+    {
+      Log_ErrorPrint("Failed to decompress rewind keyframe.");
+      return false;
+    }
+  }
+  else
+  {
+    // skip decompressing the keyframe if it's the one we're currently saving against
+    const u8* keyframe_data;
+    if (rs.keyframe == s_rewind_keyframe)
+    {
+      keyframe_data = s_rewind_keyframe_data.data();
+    }
+    else
+    {
+      s_rewind_delta_buffer.resize(keyframe.size);
+      if (!DecompressRewindData(keyframe.compressed_data, s_rewind_delta_buffer.data(), keyframe.size,
+                                keyframe_dictionary))
+      {
+        Log_ErrorPrint("Failed to decompress rewind keyframe.");
+        return false;
+      }
+
+      keyframe_data = s_rewind_delta_buffer.data();
+    }
+
+    if (!DecompressRewindData(rs.compressed_delta, data, rs.size))
+    {
+      Log_ErrorPrint("Failed to decompress rewind state.");
+      return false;
+    }
+
+    const u32 xor_size = std::min(rs.size, keyframe.size);
+    for (u32 i = 0; i < xor_size; i++)
+      data[i] ^= keyframe_data[i];
+  }
+
+  mss.vram_texture = std::move(rs.vram_texture);
+  const bool loaded = LoadMemoryState(mss);
+  rs.vram_texture = std::move(mss.vram_texture);
+  if (!loaded)
     return false;
 
   if (consume_state)
+  {
+    ReleaseVRAMSnapshot(std::move(rs.vram_texture));
     s_rewind_states.pop_back();
+    UpdateRewindMemoryUsage();
+  }
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Log_DevPrintf("Rewind load took %.4f ms", load_timer.GetTimeMilliseconds());
@@ -4307,19 +5578,120 @@ void System::SaveRunaheadState()
   MemorySaveState mss;
   while (s_runahead_states.size() >= s_runahead_frames)
   {
+    ReleaseVRAMSnapshot(std::move(mss.vram_texture));
     mss = std::move(s_runahead_states.front());
     s_runahead_states.pop_front();
   }
+  if (!mss.vram_texture)
+    mss.vram_texture = AcquireVRAMSnapshot();
 
   if (!SaveMemoryState(&mss))
   {
     Log_ErrorPrint("Failed to save runahead state.");
+    ReleaseVRAMSnapshot(std::move(mss.vram_texture));
     return;
   }
 
   s_runahead_states.push_back(std::move(mss));
 }
 
+void System::ClearRunaheadStates()
+{
+  for (MemorySaveState& mss : s_runahead_states)
+    ReleaseVRAMSnapshot(std::move(mss.vram_texture));
+  s_runahead_states.clear();
+}
+
+u32 System::GetVRAMSnapshotPoolSize()
+{
+  // rewind keeps at most the configured number of slots between queued and encoded states
+  u32 count = g_settings.rewind_enable ? g_settings.rewind_save_slots : 0;
+  count += s_runahead_frames;
+  return count;
+}
+
+void System::AllocateVRAMSnapshots()
+{
+  const u32 count = GetVRAMSnapshotPoolSize();
+  s_vram_snapshot_pool.reserve(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    // software renderer keeps VRAM in the state itself
+    std::unique_ptr<GPUTexture> tex = g_gpu->CreateVRAMSnapshotTexture();
+    if (!tex)
+      break;
+
+    s_vram_snapshot_size = tex->GetVRAMUsage();
+    s_vram_snapshot_pool.push_back(std::move(tex));
+  }
+
+  if (!s_vram_snapshot_pool.empty())
+  {
+    Log_DevFmt("Allocated {} VRAM snapshots ({:.2f} MB)", s_vram_snapshot_pool.size(),
+               static_cast<double>(s_vram_snapshot_pool.size() * s_vram_snapshot_size) / 1048576.0);
+  }
+
+  UpdateVRAMSnapshotMemoryUsage();
+}
+
+void System::DestroyVRAMSnapshots()
+{
+  DebugAssert(s_vram_snapshots_in_use == 0);
+  s_vram_snapshot_pool.clear();
+  UpdateVRAMSnapshotMemoryUsage();
+}
+
+std::unique_ptr<GPUTexture> System::AcquireVRAMSnapshot()
+{
+  // resolution or multisampling changed, the free snapshots are the old size
+  if (!s_vram_snapshot_pool.empty() && !g_gpu->IsValidVRAMSnapshotTexture(s_vram_snapshot_pool.back().get()))
+    s_vram_snapshot_pool.clear();
+
+  // the whole pool is created at once, the first time it's needed
+  if (s_vram_snapshot_pool.empty() && s_vram_snapshots_in_use == 0)
+    AllocateVRAMSnapshots();
+
+  std::unique_ptr<GPUTexture> tex;
+  if (!s_vram_snapshot_pool.empty())
+  {
+    tex = std::move(s_vram_snapshot_pool.back());
+    s_vram_snapshot_pool.pop_back();
+  }
+  else
+  {
+    // shouldn't happen unless the history size is exceeded, but don't fail the save over it
+    tex = g_gpu->CreateVRAMSnapshotTexture();
+    if (!tex)
+      return tex;
+
+    Log_DevPrint("VRAM snapshot pool is exhausted, allocating another.");
+    s_vram_snapshot_size = tex->GetVRAMUsage();
+  }
+
+  s_vram_snapshots_in_use++;
+  UpdateVRAMSnapshotMemoryUsage();
+  return tex;
+}
+
+void System::ReleaseVRAMSnapshot(std::unique_ptr<GPUTexture> tex)
+{
+  if (!tex)
+    return;
+
+  DebugAssert(s_vram_snapshots_in_use > 0);
+  s_vram_snapshots_in_use--;
+  if (g_gpu && g_gpu->IsValidVRAMSnapshotTexture(tex.get()))
+    s_vram_snapshot_pool.push_back(std::move(tex));
+
+  UpdateVRAMSnapshotMemoryUsage();
+}
+
+void System::UpdateVRAMSnapshotMemoryUsage()
+{
+  MemoryAccounting::SetGPUBytes(MemoryAccounting::Category::VRAMSnapshots,
+                                (s_vram_snapshot_pool.size() + s_vram_snapshots_in_use) * s_vram_snapshot_size);
+}
+
 bool System::DoRunahead()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -4337,7 +5709,7 @@ bool System::DoRunahead()
     s_runahead_replay_pending = false;
     if (s_runahead_states.empty() || !LoadMemoryState(s_runahead_states.front()))
     {
-      s_runahead_states.clear();
+      ClearRunaheadStates();
       return false;
     }
 
@@ -4345,7 +5717,7 @@ bool System::DoRunahead()
     s_runahead_replay_frames = static_cast<u32>(s_runahead_states.size());
 
     // and throw away all the states, forcing us to catch up below
-    s_runahead_states.clear();
+    ClearRunaheadStates();
 
     // run the frames with no audio
     SPU::SetAudioOutputMuted(true);
@@ -4553,6 +5925,176 @@ void System::StopDumpingAudio()
   Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Stopped dumping audio."), 5.0f);
 }
 
+MediaCapture* System::GetMediaCapture()
+{
+  return s_media_capture.get();
+}
+
+static std::string GetFFmpegPath()
+{
+#ifdef _WIN32
+  // Prefer a copy next to the executable, so it doesn't have to be installed.
+  std::string path = Path::Combine(EmuFolders::AppRoot, "ffmpeg.exe");
+  if (FileSystem::FileExists(path.c_str()))
+    return path;
+
+  return "ffmpeg.exe";
+#else
+  return "ffmpeg";
+#endif
+}
+
+bool System::StartMediaCapture(std::string path)
+{
+  if (!IsValid() || s_media_capture)
+    return false;
+
+  Error error;
+  if (path.empty())
+  {
+    const std::string& serial = GetGameSerial();
+    path = Path::Combine(EmuFolders::Videos, serial.empty() ?
+                                               fmt::format("{}.mp4", GetTimestampStringForFileName()) :
+                                               fmt::format("{}_{}.mp4", serial, GetTimestampStringForFileName()));
+    if (!FileSystem::EnsureDirectoryExists(EmuFolders::Videos.c_str(), false, &error))
+    {
+      Host::AddIconOSDMessage("media_capture", ICON_FA_CAMERA,
+                              fmt::format(TRANSLATE_FS("OSDMessage", "Failed to create videos directory: {}"),
+                                          error.GetDescription()),
+                              Host::OSD_ERROR_DURATION);
+      return false;
+    }
+  }
+
+  u32 width, height;
+  Common::Rectangle<s32> draw_rect;
+  bool internal_resolution;
+  g_gpu->CalculateScreenshotSize(g_settings.media_capture_internal_resolution ?
+                                   DisplayScreenshotMode::InternalResolution :
+                                   DisplayScreenshotMode::ScreenResolution,
+                                 &width, &height, &draw_rect, &internal_resolution);
+
+  // 4:2:0 chroma subsampling needs even dimensions.
+  width &= ~1u;
+  height &= ~1u;
+  if (width > 0 && height > 0)
+  {
+    // The SPU thread delivers audio to the capture.
+    SPU::SyncThread();
+    s_media_capture = MediaCapture::Create(path, GetFFmpegPath(), g_settings.media_capture_encoder,
+                                           g_settings.media_capture_video_bitrate, width, height,
+                                           s_throttle_frequency, SPU::SAMPLE_RATE,
+                                           g_gpu_device->UsesLowerLeftOrigin(), &error);
+  }
+  else
+  {
+    error.SetStringView("The display has no size.");
+  }
+
+  if (!s_media_capture)
+  {
+    Host::AddIconOSDMessage("media_capture", ICON_FA_CAMERA,
+                            fmt::format(TRANSLATE_FS("OSDMessage", "Failed to start video capture: {}"),
+                                        error.GetDescription()),
+                            Host::OSD_ERROR_DURATION);
+    return false;
+  }
+
+  Host::AddIconOSDMessage("media_capture", ICON_FA_CAMERA,
+                          fmt::format(TRANSLATE_FS("OSDMessage", "Started capturing video to '{}'."),
+                                      Path::GetFileName(path)),
+                          Host::OSD_INFO_DURATION);
+  return true;
+}
+
+void System::StopMediaCapture()
+{
+  if (!s_media_capture)
+    return;
+
+  if (g_gpu)
+    g_gpu->FlushMediaCapture(s_media_capture.get());
+
+  // Audio stops being delivered as soon as the capture is no longer active.
+  SPU::SyncThread();
+  const std::unique_ptr<MediaCapture> cap = std::move(s_media_capture);
+
+  Error error;
+  if (cap->EndCapture(&error))
+  {
+    Host::AddIconOSDMessage("media_capture", ICON_FA_CAMERA,
+                            fmt::format(TRANSLATE_FS("OSDMessage", "Saved video capture to '{}'."),
+                                        Path::GetFileName(cap->GetPath())),
+                            Host::OSD_INFO_DURATION);
+  }
+  else
+  {
+    Host::AddIconOSDMessage("media_capture", ICON_FA_CAMERA,
+                            fmt::format(TRANSLATE_FS("OSDMessage", "Failed to save video capture: {}"),
+                                        error.GetDescription()),
+                            Host::OSD_ERROR_DURATION);
+  }
+}
+
+void System::ToggleCPUTraceBuffer()
+{
+  if (!IsValid())
+    return;
+
+  if (!CPU::IsTraceBufferEnabled())
+  {
+    CPU::SetTraceBufferEnabled(true);
+    Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Started recording CPU trace buffer."), 5.0f);
+    return;
+  }
+
+  const std::string directory = Path::Combine(EmuFolders::Dumps, "traces");
+  const std::string filename = Path::Combine(directory, fmt::format("cpu_{}.txt", GetTimestampStringForFileName()));
+
+  Error error;
+  const bool result = (FileSystem::EnsureDirectoryExists(directory.c_str(), true, &error) &&
+                       CPU::DumpTraceBuffer(filename.c_str(), &error));
+  CPU::SetTraceBufferEnabled(false);
+  if (!result)
+  {
+    Host::AddOSDMessage(fmt::format(TRANSLATE_FS("OSDMessage", "Failed to write CPU trace to '{}': {}"), filename,
+                                    error.GetDescription()),
+                        10.0f);
+    return;
+  }
+
+  Host::AddOSDMessage(fmt::format(TRANSLATE_FS("OSDMessage", "Saved CPU trace to '{}'."), filename), 5.0f);
+}
+
+#ifdef ENABLE_TRACING
+
+void System::ToggleTraceCapture()
+{
+  if (!Trace::IsCapturing())
+  {
+    Trace::StartCapture();
+    Host::AddOSDMessage(TRANSLATE_STR("OSDMessage", "Started trace capture."), 5.0f);
+    return;
+  }
+
+  const std::string directory = Path::Combine(EmuFolders::Dumps, "traces");
+  const std::string filename = Path::Combine(directory, fmt::format("{}.json", GetTimestampStringForFileName()));
+
+  Error error;
+  if (!FileSystem::EnsureDirectoryExists(directory.c_str(), true, &error) ||
+      !Trace::StopCapture(filename.c_str(), &error))
+  {
+    Host::AddOSDMessage(fmt::format(TRANSLATE_FS("OSDMessage", "Failed to write trace to '{}': {}"), filename,
+                                    error.GetDescription()),
+                        10.0f);
+    return;
+  }
+
+  Host::AddOSDMessage(fmt::format(TRANSLATE_FS("OSDMessage", "Saved trace to '{}'."), filename), 5.0f);
+}
+
+#endif
+
 bool System::SaveScreenshot(const char* filename, DisplayScreenshotMode mode, DisplayScreenshotFormat format,
                             u8 quality, bool compress_on_thread)
 {
@@ -4647,17 +6189,168 @@ std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char
   if (!FileSystem::StatFile(path, &sd))
     return std::nullopt;
 
-  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(path, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_SEEKABLE);
-  if (!stream)
-    return std::nullopt;
+  {
+    std::unique_lock lock(s_save_state_index_mutex);
+    std::string index_filename = GetSaveStateIndexFileName(path);
+    if (s_save_state_index_filename != index_filename)
+      LoadSaveStateIndex(std::move(index_filename));
+
+    for (const SaveStateIndexEntry& entry : s_save_state_index)
+    {
+      if (entry.path == path && entry.modification_time == static_cast<s64>(sd.ModificationTime) &&
+          entry.size == sd.Size)
+      {
+        ExtendedSaveStateInfo ssi = entry.info;
+        ssi.timestamp = sd.ModificationTime;
+        return ssi;
+      }
+    }
+  }
 
-  std::optional<ExtendedSaveStateInfo> ssi(InternalGetExtendedSaveStateInfo(stream.get()));
+  return ReadAndIndexExtendedSaveStateInfo(path, sd);
+}
+
+std::optional<ExtendedSaveStateInfo> System::ReadAndIndexExtendedSaveStateInfo(const char* path,
+                                                                               const FILESYSTEM_STAT_DATA& sd)
+{
+  std::optional<ExtendedSaveStateInfo> ssi;
+  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(path, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_SEEKABLE);
+  if (stream)
+    ssi = InternalGetExtendedSaveStateInfo(stream.get());
   if (ssi)
     ssi->timestamp = sd.ModificationTime;
 
+  // An unreadable state still has to drop its old entry, otherwise it could be used again.
+  UpdateSaveStateIndex(path, sd, ssi.has_value() ? &ssi.value() : nullptr);
   return ssi;
 }
 
+std::string System::GetSaveStateIndexFileName(std::string_view state_path)
+{
+  // Game states are named {serial}_{slot} or {serial}_resume, and global states savestate_{slot} or resume.
+  const std::string_view title = Path::GetFileTitle(state_path);
+  const std::string_view::size_type pos = title.rfind('_');
+  const std::string_view group = (pos != std::string_view::npos) ? title.substr(0, pos) : std::string_view("savestate");
+  return Path::Combine(Path::Combine(EmuFolders::Cache, "savestates"), fmt::format("{}.index", group));
+}
+
+void System::LoadSaveStateIndex(std::string index_filename)
+{
+  s_save_state_index.clear();
+  s_save_state_index_filename = std::move(index_filename);
+
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(s_save_state_index_filename.c_str());
+  if (!data.has_value())
+    return;
+
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream =
+    ByteStream::CreateReadOnlyMemoryStream(data->data(), static_cast<u32>(data->size()));
+  u32 signature, version, num_entries;
+  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU32(&num_entries) ||
+      signature != SAVE_STATE_INDEX_SIGNATURE || version != SAVE_STATE_INDEX_VERSION)
+  {
+    Log_WarningFmt("Ignoring invalid save state index '{}'", s_save_state_index_filename);
+    return;
+  }
+
+  for (u32 i = 0; i < num_entries; i++)
+  {
+    SaveStateIndexEntry entry;
+    u32 screenshot_width, screenshot_height;
+    if (!stream->ReadSizePrefixedString(&entry.path) || !stream->ReadS64(&entry.modification_time) ||
+        !stream->ReadS64(&entry.size) || !stream->ReadSizePrefixedString(&entry.info.title) ||
+        !stream->ReadSizePrefixedString(&entry.info.serial) ||
+        !stream->ReadSizePrefixedString(&entry.info.media_path) || !stream->ReadU32(&screenshot_width) ||
+        !stream->ReadU32(&screenshot_height) ||
+        (static_cast<u64>(screenshot_width) * screenshot_height) > SAVE_STATE_INDEX_MAX_SCREENSHOT_PIXELS)
+    {
+      Log_WarningFmt("Ignoring truncated save state index '{}'", s_save_state_index_filename);
+      s_save_state_index.clear();
+      return;
+    }
+
+    entry.info.timestamp = static_cast<std::time_t>(entry.modification_time);
+    entry.info.screenshot_width = screenshot_width;
+    entry.info.screenshot_height = screenshot_height;
+    entry.info.screenshot_data.resize(screenshot_width * screenshot_height);
+    if (!stream->Read2(entry.info.screenshot_data.data(), screenshot_width * screenshot_height * sizeof(u32), nullptr))
+    {
+      Log_WarningFmt("Ignoring truncated save state index '{}'", s_save_state_index_filename);
+      s_save_state_index.clear();
+      return;
+    }
+
+    s_save_state_index.push_back(std::move(entry));
+  }
+}
+
+void System::WriteSaveStateIndex()
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  stream->WriteU32(SAVE_STATE_INDEX_SIGNATURE);
+  stream->WriteU32(SAVE_STATE_INDEX_VERSION);
+  stream->WriteU32(static_cast<u32>(s_save_state_index.size()));
+  for (const SaveStateIndexEntry& entry : s_save_state_index)
+  {
+    stream->WriteSizePrefixedString(entry.path);
+    stream->WriteS64(entry.modification_time);
+    stream->WriteS64(entry.size);
+    stream->WriteSizePrefixedString(entry.info.title);
+    stream->WriteSizePrefixedString(entry.info.serial);
+    stream->WriteSizePrefixedString(entry.info.media_path);
+    stream->WriteU32(entry.info.screenshot_width);
+    stream->WriteU32(entry.info.screenshot_height);
+    stream->Write2(entry.info.screenshot_data.data(),
+                   static_cast<u32>(entry.info.screenshot_data.size() * sizeof(u32)), nullptr);
+  }
+
+  // Write to a temporary file first, so a crash doesn't leave a half-written index.
+  const std::string temp_filename = s_save_state_index_filename + ".tmp";
+  Error error;
+  if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(s_save_state_index_filename)).c_str(), false,
+                                         &error) ||
+      !FileSystem::WriteBinaryFile(temp_filename.c_str(), stream->GetMemoryPointer(),
+                                   static_cast<size_t>(stream->GetSize())) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), s_save_state_index_filename.c_str(), &error))
+  {
+    Log_ErrorFmt("Failed to write save state index '{}': {}", s_save_state_index_filename, error.GetDescription());
+    FileSystem::DeleteFile(temp_filename.c_str());
+  }
+}
+
+void System::UpdateSaveStateIndex(const char* path, const FILESYSTEM_STAT_DATA& sd, const ExtendedSaveStateInfo* ssi)
+{
+  std::unique_lock lock(s_save_state_index_mutex);
+  std::string index_filename = GetSaveStateIndexFileName(path);
+  if (s_save_state_index_filename != index_filename)
+    LoadSaveStateIndex(std::move(index_filename));
+
+  // Drop entries for states which have since been deleted, so the index doesn't grow forever.
+  const size_t removed = std::erase_if(s_save_state_index, [path](const SaveStateIndexEntry& entry) {
+    return (entry.path == path || !FileSystem::FileExists(entry.path.c_str()));
+  });
+  if (!ssi)
+  {
+    if (removed > 0)
+      WriteSaveStateIndex();
+
+    return;
+  }
+
+  SaveStateIndexEntry& entry = s_save_state_index.emplace_back();
+  entry.path = path;
+  entry.modification_time = static_cast<s64>(sd.ModificationTime);
+  entry.size = sd.Size;
+  entry.info = *ssi;
+  if (entry.info.screenshot_data.empty())
+  {
+    entry.info.screenshot_width = 0;
+    entry.info.screenshot_height = 0;
+  }
+
+  WriteSaveStateIndex();
+}
+
 std::optional<ExtendedSaveStateInfo> System::InternalGetExtendedSaveStateInfo(ByteStream* stream)
 {
   SAVE_STATE_HEADER header;
@@ -5084,6 +6777,8 @@ void System::HostDisplayResized()
 
 bool System::PresentDisplay(bool allow_skip_present, bool explicit_present)
 {
+  TRACE_ZONE("System::PresentDisplay");
+
   const bool skip_present = allow_skip_present && g_gpu_device->ShouldSkipDisplayingFrame();
 
   Host::BeginPresentFrame();
@@ -5105,6 +6800,9 @@ bool System::PresentDisplay(bool allow_skip_present, bool explicit_present)
   ImGuiManager::RenderOverlayWindows();
   ImGuiManager::RenderDebugWindows();
 
+  if (!skip_present && s_input_latency_frame_done_time != 0 && s_input_latency_submit_time == 0)
+    s_input_latency_submit_time = Common::Timer::GetCurrentValue();
+
   bool do_present;
   if (g_gpu && !skip_present)
     do_present = g_gpu->PresentDisplay();
@@ -5113,13 +6811,41 @@ bool System::PresentDisplay(bool allow_skip_present, bool explicit_present)
 
   if (do_present)
   {
+    GPU::SetTimingRegion(GPUTimingRegion::ImGui);
     g_gpu_device->RenderImGui();
     g_gpu_device->EndPresent(explicit_present);
+    GPU::SetTimingRegion(GPUTimingRegion::Other);
+
+    if (s_boot_start_time != 0 && s_state == State::Running)
+    {
+      Log_InfoFmt("Startup: First frame presented after {:.2f} ms",
+                  Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() - s_boot_start_time));
+      s_boot_start_time = 0;
+    }
+
+    if (s_input_latency_submit_time != 0)
+    {
+      const Common::Timer::Value event_time = s_input_latency_event_time;
+      const auto ms_since_event = [event_time](Common::Timer::Value time) {
+        return static_cast<float>(Common::Timer::ConvertValueToMilliseconds(time - event_time));
+      };
+
+      s_input_latency_samples[s_input_latency_sample_pos] = {
+        ms_since_event(s_input_latency_latch_time), ms_since_event(s_input_latency_frame_done_time),
+        ms_since_event(s_input_latency_submit_time), ms_since_event(Common::Timer::GetCurrentValue())};
+      s_input_latency_sample_pos = (s_input_latency_sample_pos + 1) % NUM_INPUT_LATENCY_SAMPLES;
+      s_input_latency_sample_count = std::min(s_input_latency_sample_count + 1, NUM_INPUT_LATENCY_SAMPLES);
+      ClearPendingInputLatency();
+    }
 
     if (g_gpu_device->IsGPUTimingEnabled())
     {
       s_accumulated_gpu_time += g_gpu_device->GetAndResetAccumulatedGPUTime();
       s_presents_since_last_update++;
+
+      const GPUDevice::GPUTimingRegionTimes region_times = g_gpu_device->GetAndResetAccumulatedGPURegionTimes();
+      for (u32 i = 0; i < static_cast<u32>(GPUTimingRegion::Count); i++)
+        s_accumulated_gpu_region_times[i] += region_times[i];
     }
   }
   else
@@ -9,6 +9,7 @@
 
 #include "common/timer.h"
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
@@ -128,7 +129,12 @@ std::string GetExecutableNameForImage(CDImage* cdi, bool strip_subdirectories);
 bool ReadExecutableFromImage(CDImage* cdi, std::string* out_executable_name, std::vector<u8>* out_executable_data);
 
 std::string GetGameHashId(GameHash hash);
-bool GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash* out_hash);
+bool GetGameDetailsFromImage(CDImage* cdi, std::string* out_id, GameHash* out_hash,
+                             DiscRegion* out_region = nullptr);
+
+/// Returns the serial from SYSTEM.CNF without reading or hashing the executable. Returns false if the disc has no
+/// boot line, in which case only the hash can identify it.
+bool GetGameIdFromImage(CDImage* cdi, std::string* out_id, DiscRegion* out_region = nullptr);
 DiscRegion GetRegionForSerial(std::string_view serial);
 DiscRegion GetRegionFromSystemArea(CDImage* cdi);
 DiscRegion GetRegionForImage(CDImage* cdi);
@@ -224,6 +230,8 @@ float GetEmulationSpeed();
 float GetAverageFrameTime();
 float GetMinimumFrameTime();
 float GetMaximumFrameTime();
+float GetFramePacingJitter();       // Average difference between the intended and actual wakeup, in milliseconds.
+float GetMaximumFramePacingError(); // Worst difference between the intended and actual wakeup, in milliseconds.
 float GetThrottleFrequency();
 float GetCPUThreadUsage();
 float GetCPUThreadAverageTime();
@@ -231,10 +239,85 @@ float GetSWThreadUsage();
 float GetSWThreadAverageTime();
 float GetGPUUsage();
 float GetGPUAverageTime();
+float GetGPUTimingRegionAverageTime(GPUTimingRegion region);
 const FrameTimeHistory& GetFrameTimeHistory();
+const FrameTimeHistory& GetFramePacingErrorHistory(); // Indexed the same as the frame time history.
 u32 GetFrameTimeHistoryPos();
 void FormatLatencyStats(SmallStringBase& str);
 
+/// Measured latency of a single host input, in milliseconds from the input event to each stage.
+struct InputLatencySample
+{
+  float latch;      ///< Read by the emulated controller.
+  float frame_done; ///< End of the emulated frame which read it.
+  float submit;     ///< Frame handed to the GPU for display.
+  float present;    ///< Present call returned.
+};
+static constexpr u32 NUM_INPUT_LATENCY_SAMPLES = 64;
+static constexpr u32 NUM_INPUT_LATENCY_HISTOGRAM_BUCKETS = 20;
+static constexpr float INPUT_LATENCY_HISTOGRAM_BUCKET_MS = 5.0f;
+
+struct InputLatencyStats
+{
+  InputLatencySample average;
+  float minimum;
+  float maximum;
+  u32 num_samples;
+
+  /// Counts of total latency, the last bucket also includes anything longer.
+  std::array<u32, NUM_INPUT_LATENCY_HISTOGRAM_BUCKETS> histogram;
+};
+
+/// Returns statistics over the last NUM_INPUT_LATENCY_SAMPLES measured inputs.
+void GetInputLatencyStats(InputLatencyStats* stats);
+void ResetInputLatencyStats();
+
+/// Subsystems whose host time can be accumulated for benchmarking.
+enum class ProfiledSubsystem : u8
+{
+  CodeCompile,
+  GPUCommands,
+  SoftwareRasterizer,
+  SPUMixing,
+  CDROMRead,
+  Achievements,
+  Count
+};
+
+/// Set when subsystem timing is being collected. Checked before reading the timer, so it costs nothing otherwise.
+extern std::atomic<bool> g_subsystem_profiling_enabled;
+
+/// Enables or disables subsystem timing. Accumulated times are reset on enable.
+void SetSubsystemProfilingEnabled(bool enabled);
+
+/// Returns the accumulated host time for a subsystem, in seconds.
+double GetSubsystemTime(ProfiledSubsystem subsystem);
+void AddSubsystemTime(ProfiledSubsystem subsystem, Common::Timer::Value ticks);
+
+/// Returns the total CPU time consumed by the CPU and software renderer threads, in seconds.
+double GetCPUThreadCPUTime();
+double GetSWThreadCPUTime();
+
+/// Accumulates the time spent in the enclosing scope to a subsystem, when profiling is enabled.
+class ProfileSubsystemScope
+{
+public:
+  ALWAYS_INLINE ProfileSubsystemScope(ProfiledSubsystem subsystem)
+    : m_start(g_subsystem_profiling_enabled.load(std::memory_order_relaxed) ? Common::Timer::GetCurrentValue() : 0),
+      m_subsystem(subsystem)
+  {
+  }
+  ALWAYS_INLINE ~ProfileSubsystemScope()
+  {
+    if (m_start != 0)
+      AddSubsystemTime(m_subsystem, Common::Timer::GetCurrentValue() - m_start);
+  }
+
+private:
+  Common::Timer::Value m_start;
+  ProfiledSubsystem m_subsystem;
+};
+
 /// Loads global settings (i.e. EmuConfig).
 void LoadSettings(bool display_osd_messages);
 void SetDefaultSettings(SettingsInterface& si);
@@ -429,6 +512,23 @@ bool StartDumpingAudio(const char* filename = nullptr);
 /// Stops dumping audio to file if it has been started.
 void StopDumpingAudio();
 
+/// Returns the active video capture, or nullptr if there isn't one.
+MediaCapture* GetMediaCapture();
+
+/// Starts capturing video and audio to a file. If no path is provided, one will be generated in the videos directory.
+bool StartMediaCapture(std::string path = {});
+
+/// Stops the video capture if it has been started, waiting for the encoder and writing the final file.
+void StopMediaCapture();
+
+/// Starts recording executed instructions to the CPU trace buffer, or stops and writes it to the dumps directory.
+void ToggleCPUTraceBuffer();
+
+#ifdef ENABLE_TRACING
+/// Starts a timeline trace capture, or stops the current one and writes it to the dumps directory.
+void ToggleTraceCapture();
+#endif
+
 /// Saves a screenshot to the specified file. If no file name is provided, one will be generated automatically.
 bool SaveScreenshot(const char* filename = nullptr, DisplayScreenshotMode mode = g_settings.display_screenshot_mode,
                     DisplayScreenshotFormat format = g_settings.display_screenshot_format,
@@ -464,6 +564,9 @@ void ToggleWidescreen();
 /// Returns true if fast forwarding or slow motion is currently active.
 bool IsRunningAtNonStandardSpeed();
 
+/// Returns true if adaptive frame skipping has chosen not to display the current frame.
+bool IsSkippingFrame();
+
 /// Returns true if vsync should be used.
 bool IsVSyncEffectivelyEnabled();
 
@@ -485,6 +588,9 @@ void InvalidateDisplay();
 // Memory Save States (Rewind and Runahead)
 //////////////////////////////////////////////////////////////////////////
 void CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u64* ram_usage, u64* vram_usage);
+
+/// Returns the average size of the rewind states per second of history, not including VRAM textures.
+u64 GetRewindMemoryPerSecond();
 void ClearMemorySaveStates();
 void UpdateMemorySaveStateSettings();
 bool LoadRewindState(u32 skip_saves = 0, bool consume_state = true);
@@ -507,6 +613,12 @@ void CPUThreadShutdown();
 
 /// Polls input, updates subsystems which are present while paused/inactive.
 void IdlePollUpdate();
+
+/// Input latency instrumentation. Only the first input since the last measured present is tracked.
+void OnHostInputEvent();
+
+/// Called when the game begins reading a controller. Polls input again first if late input polling is enabled.
+void OnControllerLatched();
 } // namespace Internal
 
 } // namespace System
@@ -2,12 +2,17 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "texture_replacements.h"
+#include "gpu_types.h"
 #include "host.h"
 #include "settings.h"
+#include "system.h"
+
+#include "util/gpu_device.h"
 
 #include "common/bitutils.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
@@ -18,12 +23,31 @@
 #include "xxh_x86dispatch.h"
 #endif
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <cinttypes>
 
 Log_SetChannel(TextureReplacements);
 
 TextureReplacements g_texture_replacements;
 
+// Maximum number of bytes of newly-decoded replacements handed to the renderer per frame. At least one is always
+// allowed, so large replacements still make progress.
+static constexpr u32 UPLOAD_BUDGET_PER_FRAME = 16 * 1024 * 1024;
+
+// Maximum number of textures queued from a directory when it's first touched.
+static constexpr u32 MAX_PREFETCH_PER_DIRECTORY = 64;
+
+static constexpr u32 MAX_LOAD_THREADS = 4;
+
+// Maximum number of bytes of VRAM writes waiting to be dumped. Writes past this are dropped, and dumped the next time
+// they occur, so the emulation thread never waits for the encoder.
+static constexpr size_t MAX_QUEUED_DUMP_BYTES = 16 * 1024 * 1024;
+
+// Dumps favour encoding speed over size, they're intermediate files which get edited anyway.
+static constexpr u8 DUMP_PNG_QUALITY = 10;
+
 static constexpr u32 VRAMRGBA5551ToRGBA8888(u16 color)
 {
   u8 r = Truncate8(color & 31);
@@ -40,6 +64,336 @@ static constexpr u32 VRAMRGBA5551ToRGBA8888(u16 color)
   return ZeroExtend32(r) | (ZeroExtend32(g) << 8) | (ZeroExtend32(b) << 16) | (ZeroExtend32(a) << 24);
 }
 
+namespace {
+#pragma pack(push, 4)
+struct DDS_PIXELFORMAT
+{
+  u32 dwSize;
+  u32 dwFlags;
+  u32 dwFourCC;
+  u32 dwRGBBitCount;
+  u32 dwRBitMask;
+  u32 dwGBitMask;
+  u32 dwBBitMask;
+  u32 dwABitMask;
+};
+
+struct DDS_HEADER
+{
+  u32 dwSize;
+  u32 dwFlags;
+  u32 dwHeight;
+  u32 dwWidth;
+  u32 dwPitchOrLinearSize;
+  u32 dwDepth;
+  u32 dwMipMapCount;
+  u32 dwReserved1[11];
+  DDS_PIXELFORMAT ddspf;
+  u32 dwCaps;
+  u32 dwCaps2;
+  u32 dwCaps3;
+  u32 dwCaps4;
+  u32 dwReserved2;
+};
+
+struct DDS_HEADER_DXT10
+{
+  u32 dxgiFormat;
+  u32 resourceDimension;
+  u32 miscFlag;
+  u32 arraySize;
+  u32 miscFlags2;
+};
+#pragma pack(pop)
+static_assert(sizeof(DDS_HEADER) == 124 && sizeof(DDS_PIXELFORMAT) == 32 && sizeof(DDS_HEADER_DXT10) == 20);
+} // namespace
+
+static constexpr u32 DDS_MAGIC = 0x20534444; // "DDS "
+static constexpr u32 DDSD_MIPMAPCOUNT = 0x20000;
+static constexpr u32 DDPF_FOURCC = 0x4;
+
+static constexpr u32 MakeFourCC(char a, char b, char c, char d)
+{
+  return static_cast<u32>(static_cast<u8>(a)) | (static_cast<u32>(static_cast<u8>(b)) << 8) |
+         (static_cast<u32>(static_cast<u8>(c)) << 16) | (static_cast<u32>(static_cast<u8>(d)) << 24);
+}
+
+static GPUTexture::Format GetDDSFormat(const DDS_HEADER& header, const DDS_HEADER_DXT10* dx10_header)
+{
+  if (dx10_header)
+  {
+    // UNORM and SRGB variants, treated the same, since the blit doesn't do any conversion.
+    switch (dx10_header->dxgiFormat)
+    {
+      case 71:
+      case 72:
+        return GPUTexture::Format::BC1;
+      case 74:
+      case 75:
+        return GPUTexture::Format::BC2;
+      case 77:
+      case 78:
+        return GPUTexture::Format::BC3;
+      case 98:
+      case 99:
+        return GPUTexture::Format::BC7;
+      default:
+        return GPUTexture::Format::Unknown;
+    }
+  }
+
+  if (!(header.ddspf.dwFlags & DDPF_FOURCC))
+    return GPUTexture::Format::Unknown;
+
+  switch (header.ddspf.dwFourCC)
+  {
+    case MakeFourCC('D', 'X', 'T', '1'):
+      return GPUTexture::Format::BC1;
+    case MakeFourCC('D', 'X', 'T', '2'):
+    case MakeFourCC('D', 'X', 'T', '3'):
+      return GPUTexture::Format::BC2;
+    case MakeFourCC('D', 'X', 'T', '4'):
+    case MakeFourCC('D', 'X', 'T', '5'):
+      return GPUTexture::Format::BC3;
+    default:
+      return GPUTexture::Format::Unknown;
+  }
+}
+
+static u32 ExpandRGB565(u16 color)
+{
+  const u32 r = (color >> 11) & 31;
+  const u32 g = (color >> 5) & 63;
+  const u32 b = color & 31;
+  return ((r << 3) | (r >> 2)) | (((g << 2) | (g >> 4)) << 8) | (((b << 3) | (b >> 2)) << 16);
+}
+
+static u32 LerpRGB(u32 c0, u32 c1, u32 w0, u32 w1, u32 div)
+{
+  u32 ret = 0;
+  for (u32 shift = 0; shift < 24; shift += 8)
+    ret |= (((((c0 >> shift) & 0xFF) * w0) + (((c1 >> shift) & 0xFF) * w1)) / div) << shift;
+  return ret;
+}
+
+/// Decodes the colour part of a BC1-3 block. Alpha is left at 255, except for the BC1 transparent index.
+static void DecodeBCColorBlock(const u8* block, bool bc1, u32 pixels[16])
+{
+  u16 c0, c1;
+  u32 indices;
+  std::memcpy(&c0, block, sizeof(c0));
+  std::memcpy(&c1, block + 2, sizeof(c1));
+  std::memcpy(&indices, block + 4, sizeof(indices));
+
+  u32 palette[4];
+  palette[0] = ExpandRGB565(c0) | 0xFF000000u;
+  palette[1] = ExpandRGB565(c1) | 0xFF000000u;
+  if (c0 > c1 || !bc1)
+  {
+    palette[2] = LerpRGB(palette[0], palette[1], 2, 1, 3) | 0xFF000000u;
+    palette[3] = LerpRGB(palette[0], palette[1], 1, 2, 3) | 0xFF000000u;
+  }
+  else
+  {
+    palette[2] = LerpRGB(palette[0], palette[1], 1, 1, 2) | 0xFF000000u;
+    palette[3] = 0;
+  }
+
+  for (u32 i = 0; i < 16; i++)
+    pixels[i] = palette[(indices >> (i * 2)) & 3];
+}
+
+static void DecodeBC3AlphaBlock(const u8* block, u32 pixels[16])
+{
+  const u32 a0 = block[0];
+  const u32 a1 = block[1];
+  u64 indices = 0;
+  std::memcpy(&indices, block + 2, 6);
+
+  u32 palette[8] = {a0, a1};
+  if (a0 > a1)
+  {
+    for (u32 i = 1; i < 7; i++)
+      palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+  }
+  else
+  {
+    for (u32 i = 1; i < 5; i++)
+      palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  for (u32 i = 0; i < 16; i++)
+    pixels[i] = (pixels[i] & 0x00FFFFFFu) | (palette[(indices >> (i * 3)) & 7] << 24);
+}
+
+/// Decodes the top level of a BC1-3 image, for devices which can't sample them. BC7 isn't handled.
+static bool DecodeBCImage(GPUTexture::Format format, u32 width, u32 height, const u8* data, RGBA8Image* image)
+{
+  if (format != GPUTexture::Format::BC1 && format != GPUTexture::Format::BC2 && format != GPUTexture::Format::BC3)
+    return false;
+
+  const u32 block_bytes = GPUTexture::GetCompressedBytesPerBlock(format);
+  image->SetSize(width, height);
+  for (u32 by = 0; by < height; by += 4)
+  {
+    for (u32 bx = 0; bx < width; bx += 4)
+    {
+      u32 pixels[16];
+      if (format == GPUTexture::Format::BC1)
+      {
+        DecodeBCColorBlock(data, true, pixels);
+      }
+      else
+      {
+        DecodeBCColorBlock(data + 8, false, pixels);
+        if (format == GPUTexture::Format::BC3)
+        {
+          DecodeBC3AlphaBlock(data, pixels);
+        }
+        else
+        {
+          u64 alpha;
+          std::memcpy(&alpha, data, sizeof(alpha));
+          for (u32 i = 0; i < 16; i++)
+            pixels[i] = (pixels[i] & 0x00FFFFFFu) | (static_cast<u32>((alpha >> (i * 4)) & 0xF) * 17) << 24;
+        }
+      }
+
+      const u32 copy_width = std::min(width - bx, 4u);
+      const u32 copy_height = std::min(height - by, 4u);
+      for (u32 y = 0; y < copy_height; y++)
+        std::memcpy(image->GetRowPixels(by + y) + bx, &pixels[y * 4], copy_width * sizeof(u32));
+
+      data += block_bytes;
+    }
+  }
+
+  return true;
+}
+
+const void* TextureReplacementTexture::GetLevelData(u32 level) const
+{
+  return IsCompressed() ? static_cast<const void*>(&m_compressed_data[m_level_offsets[level]]) :
+                          static_cast<const void*>(m_image.GetPixels());
+}
+
+u32 TextureReplacementTexture::GetLevelPitch(u32 level) const
+{
+  return IsCompressed() ? GPUTexture::CalcUploadPitch(m_format, GetMipWidth(level)) : m_image.GetPitch();
+}
+
+size_t TextureReplacementTexture::GetSizeInBytes() const
+{
+  return IsCompressed() ? m_compressed_data.size() : (m_image.GetPitch() * m_image.GetHeight());
+}
+
+bool TextureReplacementTexture::LoadFromFile(const char* filename, u32 supported_formats)
+{
+  const char* extension = std::strrchr(filename, '.');
+  if (extension && StringUtil::Strcasecmp(extension, ".dds") == 0)
+    return LoadDDS(filename, supported_formats);
+
+  if (!m_image.LoadFromFile(filename))
+    return false;
+
+  m_format = GPUTexture::Format::RGBA8;
+  m_width = m_image.GetWidth();
+  m_height = m_image.GetHeight();
+  m_levels = 1;
+  return true;
+}
+
+bool TextureReplacementTexture::LoadDDS(const char* filename, u32 supported_formats)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename);
+  if (!data.has_value())
+    return false;
+
+  u32 magic;
+  DDS_HEADER header;
+  if (data->size() < (sizeof(magic) + sizeof(header)))
+    return false;
+  std::memcpy(&magic, data->data(), sizeof(magic));
+  std::memcpy(&header, data->data() + sizeof(magic), sizeof(header));
+  if (magic != DDS_MAGIC || header.dwSize != sizeof(header) || header.ddspf.dwSize != sizeof(header.ddspf))
+  {
+    Log_ErrorFmt("'{}' is not a valid DDS file", filename);
+    return false;
+  }
+
+  size_t data_offset = sizeof(magic) + sizeof(header);
+  DDS_HEADER_DXT10 dx10_header;
+  const bool has_dx10_header =
+    ((header.ddspf.dwFlags & DDPF_FOURCC) && header.ddspf.dwFourCC == MakeFourCC('D', 'X', '1', '0'));
+  if (has_dx10_header)
+  {
+    if (data->size() < (data_offset + sizeof(dx10_header)))
+      return false;
+    std::memcpy(&dx10_header, data->data() + data_offset, sizeof(dx10_header));
+    data_offset += sizeof(dx10_header);
+  }
+
+  const GPUTexture::Format format = GetDDSFormat(header, has_dx10_header ? &dx10_header : nullptr);
+  if (format == GPUTexture::Format::Unknown)
+  {
+    Log_ErrorFmt("'{}' is not in a supported format (BC1/BC2/BC3/BC7)", filename);
+    return false;
+  }
+
+  const u32 width = header.dwWidth;
+  const u32 height = header.dwHeight;
+  if (width == 0 || height == 0 || width > GPUTexture::MAX_WIDTH || height > GPUTexture::MAX_HEIGHT)
+    return false;
+
+  const u32 max_levels = static_cast<u32>(std::bit_width(std::max(width, height)));
+  const u32 levels = ((header.dwFlags & DDSD_MIPMAPCOUNT) && header.dwMipMapCount > 0) ?
+                       std::min(header.dwMipMapCount, max_levels) :
+                       1;
+
+  std::vector<size_t> level_offsets;
+  size_t level_offset = 0;
+  for (u32 i = 0; i < levels; i++)
+  {
+    const u32 mip_width = std::max<u32>(width >> i, 1u);
+    const u32 mip_height = std::max<u32>(height >> i, 1u);
+    level_offsets.push_back(level_offset);
+    level_offset += GPUTexture::CalcUploadSize(format, mip_height, GPUTexture::CalcUploadPitch(format, mip_width));
+  }
+  if (data->size() < (data_offset + level_offset))
+  {
+    Log_ErrorFmt("'{}' is truncated", filename);
+    return false;
+  }
+
+  if (!(supported_formats & (1u << static_cast<u32>(format))))
+  {
+    if (!DecodeBCImage(format, width, height, data->data() + data_offset, &m_image))
+    {
+      Log_ErrorFmt("'{}' is in {} format, which the GPU does not support, and can't be decoded", filename,
+                   GPUTexture::GetFormatName(format));
+      return false;
+    }
+
+    m_format = GPUTexture::Format::RGBA8;
+    m_width = width;
+    m_height = height;
+    m_levels = 1;
+    return true;
+  }
+
+  data->erase(data->begin(), data->begin() + data_offset);
+  data->resize(level_offset);
+  m_compressed_data = std::move(data.value());
+  m_level_offsets = std::move(level_offsets);
+  m_format = format;
+  m_width = width;
+  m_height = height;
+  m_levels = levels;
+  return true;
+}
+
 std::string TextureReplacementHash::ToString() const
 {
   return StringUtil::StdStringFromFormat("%" PRIx64 "%" PRIx64, high, low);
@@ -62,7 +416,11 @@ bool TextureReplacementHash::ParseString(std::string_view sv)
 
 TextureReplacements::TextureReplacements() = default;
 
-TextureReplacements::~TextureReplacements() = default;
+TextureReplacements::~TextureReplacements()
+{
+  StopLoadThreads();
+  StopDumpThread();
+}
 
 void TextureReplacements::SetGameID(std::string game_id)
 {
@@ -75,53 +433,151 @@ void TextureReplacements::SetGameID(std::string game_id)
 
 const TextureReplacementTexture* TextureReplacements::GetVRAMWriteReplacement(u32 width, u32 height, const void* pixels)
 {
+  // Hashing is the expensive part, skip it if this write can't possibly match.
+  if (m_vram_write_replacements.empty() ||
+      (m_vram_write_replacement_sizes_known && !m_vram_write_replacement_sizes.contains((width << 16) | height)))
+  {
+    return nullptr;
+  }
+
   const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
 
   const auto it = m_vram_write_replacements.find(hash);
   if (it == m_vram_write_replacements.end())
     return nullptr;
 
-  return LoadTexture(it->second);
+  if (g_settings.texture_replacements.preload_textures)
+    return LoadTexture(it->second);
+
+  return GetOrQueueTexture(it->second);
 }
 
 void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixels)
 {
-  std::string filename = GetVRAMWriteDumpFilename(width, height, pixels);
+  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
+  if (!m_dumped_vram_writes.insert(hash).second)
+    return;
+
+  const size_t size = width * height * sizeof(u16);
+  {
+    std::unique_lock lock(m_dump_mutex);
+    if ((m_queued_dump_bytes + size) > MAX_QUEUED_DUMP_BYTES && !m_dump_queue.empty())
+    {
+      // Forget the hash, so it gets another chance next time the game writes it.
+      m_dumped_vram_writes.erase(hash);
+      m_dropped_dumps++;
+      return;
+    }
+  }
+
+  std::string filename = GetVRAMWriteDumpFilename(width, height, hash);
   if (filename.empty())
     return;
 
-  RGBA8Image image;
-  image.SetSize(width, height);
+  DumpRequest req;
+  req.filename = std::move(filename);
+  req.width = width;
+  req.height = height;
+  req.force_alpha_channel = g_settings.texture_replacements.dump_vram_write_force_alpha_channel;
+  req.pixels.resize(width * height);
+  std::memcpy(req.pixels.data(), pixels, size);
 
-  const u16* src_pixels = reinterpret_cast<const u16*>(pixels);
+  if (!m_dump_thread.joinable())
+    StartDumpThread();
 
-  for (u32 y = 0; y < height; y++)
   {
-    for (u32 x = 0; x < width; x++)
-    {
-      image.SetPixel(x, y, VRAMRGBA5551ToRGBA8888(*src_pixels));
-      src_pixels++;
-    }
+    std::unique_lock lock(m_dump_mutex);
+    m_queued_dump_bytes += size;
+    m_dump_queue.push_back(std::move(req));
+  }
+  m_dump_cv.notify_one();
+}
+
+void TextureReplacements::StartDumpThread()
+{
+  m_dump_thread_shutdown = false;
+  m_dump_thread = std::thread(&TextureReplacements::DumpThreadEntryPoint, this);
+}
+
+void TextureReplacements::StopDumpThread()
+{
+  if (!m_dump_thread.joinable())
+    return;
+
+  // Anything already queued is still written.
+  {
+    std::unique_lock lock(m_dump_mutex);
+    m_dump_thread_shutdown = true;
+  }
+  m_dump_cv.notify_one();
+  m_dump_thread.join();
+
+  if (m_dropped_dumps > 0)
+  {
+    Log_WarningFmt("{} VRAM write dumps were dropped because the dump queue was full.", m_dropped_dumps);
+    m_dropped_dumps = 0;
   }
+}
 
-  if (g_settings.texture_replacements.dump_vram_write_force_alpha_channel)
+void TextureReplacements::DumpThreadEntryPoint()
+{
+  std::unique_lock lock(m_dump_mutex);
+  for (;;)
   {
-    for (u32 y = 0; y < height; y++)
+    m_dump_cv.wait(lock, [this]() { return m_dump_thread_shutdown || !m_dump_queue.empty(); });
+    if (m_dump_queue.empty())
+      break;
+
+    DumpRequest req = std::move(m_dump_queue.front());
+    m_dump_queue.pop_front();
+    lock.unlock();
+
+    RGBA8Image image(req.width, req.height);
+    const u16* src_pixels = req.pixels.data();
+    const u32 alpha_mask = req.force_alpha_channel ? 0xFF000000u : 0u;
+    for (u32 y = 0; y < req.height; y++)
     {
-      for (u32 x = 0; x < width; x++)
-        image.SetPixel(x, y, image.GetPixel(x, y) | 0xFF000000u);
+      u32* dst_pixels = image.GetRowPixels(y);
+      for (u32 x = 0; x < req.width; x++)
+        *(dst_pixels++) = VRAMRGBA5551ToRGBA8888(*(src_pixels++)) | alpha_mask;
     }
+
+    Log_InfoFmt("Dumping {}x{} VRAM write to '{}'", req.width, req.height, req.filename);
+    if (!image.SaveToFile(req.filename.c_str(), DUMP_PNG_QUALITY))
+      Log_ErrorFmt("Failed to dump {}x{} VRAM write to '{}'", req.width, req.height, req.filename);
+
+    lock.lock();
+    m_queued_dump_bytes -= req.pixels.size() * sizeof(u16);
   }
+}
 
-  Log_InfoPrintf("Dumping %ux%u VRAM write to '%s'", width, height, filename.c_str());
-  if (!image.SaveToFile(filename.c_str()))
-    Log_ErrorPrintf("Failed to dump %ux%u VRAM write to '%s'", width, height, filename.c_str());
+void TextureReplacements::ResetUploadBudget()
+{
+  m_upload_budget_remaining = UPLOAD_BUDGET_PER_FRAME;
+}
+
+void TextureReplacements::GetCacheStatsString(SmallStringBase& str) const
+{
+  const u32 lookups = m_cache_hits + m_cache_misses;
+  str.format("Replacements: {} ({:.1f}/{}MB) | Hit: {:.1f}%", m_texture_cache.size(),
+             static_cast<double>(m_texture_cache_size) / 1048576.0,
+             g_settings.texture_replacements.max_cache_size_mb,
+             (lookups > 0) ? (static_cast<double>(m_cache_hits) * 100.0 / static_cast<double>(lookups)) : 0.0);
 }
 
 void TextureReplacements::Shutdown()
 {
+  StopLoadThreads();
+  StopDumpThread();
+  CancelTextureLoads();
   m_texture_cache.clear();
+  m_texture_cache_size = 0;
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::TextureReplacements, 0);
   m_vram_write_replacements.clear();
+  m_vram_write_replacement_sizes.clear();
+  m_vram_write_replacement_sizes_known = false;
+  m_dumped_vram_writes.clear();
+  m_replacement_directories.clear();
   m_game_id.clear();
 }
 
@@ -141,17 +597,22 @@ TextureReplacementHash TextureReplacements::GetVRAMWriteHash(u32 width, u32 heig
   return {hash.low64, hash.high64};
 }
 
-std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const
+std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height,
+                                                          const TextureReplacementHash& hash) const
 {
   if (m_game_id.empty())
     return {};
 
-  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
+  // The size is included so replacement lookups can skip hashing writes of other sizes. Dumps from older versions
+  // don't have it, but shouldn't be dumped again.
   const std::string dump_directory(GetDumpDirectory());
-  std::string filename(Path::Combine(dump_directory, fmt::format("vram-write-{}.png", hash.ToString())));
-
-  if (FileSystem::FileExists(filename.c_str()))
+  const std::string hash_str(hash.ToString());
+  std::string filename(Path::Combine(dump_directory, fmt::format("vram-write-{}-{}x{}.png", hash_str, width, height)));
+  if (FileSystem::FileExists(filename.c_str()) ||
+      FileSystem::FileExists(Path::Combine(dump_directory, fmt::format("vram-write-{}.png", hash_str)).c_str()))
+  {
     return {};
+  }
 
   if (!FileSystem::EnsureDirectoryExists(dump_directory.c_str(), false))
     return {};
@@ -161,7 +622,42 @@ std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height,
 
 void TextureReplacements::Reload()
 {
+  CancelTextureLoads();
+  ResetUploadBudget();
   m_vram_write_replacements.clear();
+  m_vram_write_replacement_sizes.clear();
+  m_vram_write_replacement_sizes_known = false;
+  m_dumped_vram_writes.clear();
+  m_replacement_directories.clear();
+
+  // Compressed textures from a previous device may not be usable on this one.
+  u32 supported_formats = 0;
+  for (GPUTexture::Format format :
+       {GPUTexture::Format::BC1, GPUTexture::Format::BC2, GPUTexture::Format::BC3, GPUTexture::Format::BC7})
+  {
+    if (g_gpu_device && g_gpu_device->SupportsTextureFormat(format))
+      supported_formats |= (1u << static_cast<u32>(format));
+  }
+  {
+    std::unique_lock lock(m_load_mutex);
+    m_supported_formats = supported_formats;
+  }
+  for (auto it = m_texture_cache.begin(); it != m_texture_cache.end();)
+  {
+    const TextureReplacementTexture& tex = it->second.texture;
+    if (tex.IsCompressed() && !(supported_formats & (1u << static_cast<u32>(tex.GetFormat()))))
+    {
+      m_texture_cache_size -= tex.GetSizeInBytes();
+      it = m_texture_cache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  m_cache_hits = 0;
+  m_cache_misses = 0;
 
   if (g_settings.texture_replacements.AnyReplacementsEnabled())
     FindTextures(GetSourceDirectory());
@@ -175,20 +671,72 @@ void TextureReplacements::Reload()
 void TextureReplacements::PurgeUnreferencedTexturesFromCache()
 {
   TextureCache old_map = std::move(m_texture_cache);
+  m_texture_cache_size = 0;
   for (const auto& it : m_vram_write_replacements)
   {
     auto it2 = old_map.find(it.second);
     if (it2 != old_map.end())
     {
+      m_texture_cache_size += it2->second.texture.GetSizeInBytes();
       m_texture_cache[it.second] = std::move(it2->second);
       old_map.erase(it2);
     }
   }
+
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::TextureReplacements, m_texture_cache_size);
+}
+
+const TextureReplacementTexture* TextureReplacements::LookupCachedTexture(const std::string& filename, bool* found)
+{
+  const auto it = m_texture_cache.find(filename);
+  *found = (it != m_texture_cache.end());
+  if (!*found)
+  {
+    m_cache_misses++;
+    return nullptr;
+  }
+
+  m_cache_hits++;
+  it->second.last_used_frame = System::GetFrameNumber();
+  return it->second.texture.IsValid() ? &it->second.texture : nullptr;
+}
+
+const TextureReplacementTexture* TextureReplacements::InsertCachedTexture(const std::string& filename,
+                                                                          TextureReplacementTexture texture)
+{
+  const size_t size = texture.GetSizeInBytes();
+  if (!g_settings.texture_replacements.preload_textures)
+    EvictCachedTextures(size);
+
+  m_texture_cache_size += size;
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::TextureReplacements, m_texture_cache_size);
+  const auto it = m_texture_cache.emplace(filename, CacheEntry{std::move(texture), System::GetFrameNumber()}).first;
+  return it->second.texture.IsValid() ? &it->second.texture : nullptr;
+}
+
+void TextureReplacements::EvictCachedTextures(size_t required)
+{
+  const size_t budget = static_cast<size_t>(g_settings.texture_replacements.max_cache_size_mb) * 1048576;
+  while (!m_texture_cache.empty() && (m_texture_cache_size + required) > budget)
+  {
+    // Evictions are rare compared to lookups, so a linear search for the oldest is cheaper than maintaining a list.
+    auto oldest = m_texture_cache.begin();
+    for (auto it = std::next(oldest); it != m_texture_cache.end(); ++it)
+    {
+      if (it->second.last_used_frame < oldest->second.last_used_frame)
+        oldest = it;
+    }
+
+    Log_DevFmt("Evicting '{}' from replacement cache, last used frame {}", oldest->first,
+               oldest->second.last_used_frame);
+    m_texture_cache_size -= oldest->second.texture.GetSizeInBytes();
+    m_texture_cache.erase(oldest);
+  }
 }
 
 bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
                                                    TextureReplacementHash* replacement_hash,
-                                                   ReplacmentType* replacement_type)
+                                                   ReplacmentType* replacement_type, u32* width, u32* height)
 {
   const char* extension = std::strrchr(filename.c_str(), '.');
   const char* title = std::strrchr(filename.c_str(), '/');
@@ -215,13 +763,36 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
     return false;
   }
 
-  if (!replacement_hash->ParseString(std::string_view(hashpart, static_cast<size_t>(extension - hashpart))))
+  // Hash, optionally followed by -WIDTHxHEIGHT of the write.
+  const std::string_view name(hashpart, static_cast<size_t>(extension - hashpart));
+  if (name.length() < 32 || !replacement_hash->ParseString(name.substr(0, 32)))
     return false;
 
+  *width = 0;
+  *height = 0;
+  if (name.length() > 32)
+  {
+    const std::string_view size = name.substr(32);
+    const std::string_view::size_type xpos = size.find('x');
+    const std::optional<u32> parsed_width =
+      (size[0] == '-' && xpos != std::string_view::npos) ? StringUtil::FromChars<u32>(size.substr(1, xpos - 1)) :
+                                                           std::nullopt;
+    const std::optional<u32> parsed_height =
+      parsed_width.has_value() ? StringUtil::FromChars<u32>(size.substr(xpos + 1)) : std::nullopt;
+    if (!parsed_height.has_value() || parsed_width.value() == 0 || parsed_width.value() > VRAM_WIDTH ||
+        parsed_height.value() == 0 || parsed_height.value() > VRAM_HEIGHT)
+    {
+      return false;
+    }
+
+    *width = parsed_width.value();
+    *height = parsed_height.value();
+  }
+
   extension++;
 
   bool valid_extension = false;
-  for (const char* test_extension : {"png", "jpg", "tga", "bmp"})
+  for (const char* test_extension : {"png", "jpg", "tga", "bmp", "dds"})
   {
     if (StringUtil::Strcasecmp(extension, test_extension) == 0)
     {
@@ -238,6 +809,7 @@ void TextureReplacements::FindTextures(const std::string& dir)
   FileSystem::FindResultsArray files;
   FileSystem::FindFiles(dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
 
+  bool has_unsized_replacements = false;
   for (FILESYSTEM_FIND_DATA& fd : files)
   {
     if (fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
@@ -245,7 +817,8 @@ void TextureReplacements::FindTextures(const std::string& dir)
 
     TextureReplacementHash hash;
     ReplacmentType type;
-    if (!ParseReplacementFilename(fd.FileName, &hash, &type))
+    u32 width, height;
+    if (!ParseReplacementFilename(fd.FileName, &hash, &type, &width, &height))
       continue;
 
     switch (type)
@@ -255,35 +828,62 @@ void TextureReplacements::FindTextures(const std::string& dir)
         auto it = m_vram_write_replacements.find(hash);
         if (it != m_vram_write_replacements.end())
         {
+          // Packs can ship a DDS alongside the source image, use the DDS since it doesn't need decoding.
+          const bool is_dds = StringUtil::EndsWithNoCase(fd.FileName, ".dds");
+          if (is_dds != StringUtil::EndsWithNoCase(it->second, ".dds"))
+          {
+            if (is_dds)
+              it->second = std::move(fd.FileName);
+            continue;
+          }
+
           Log_WarningPrintf("Duplicate VRAM write replacement: '%s' and '%s'", it->second.c_str(), fd.FileName.c_str());
           continue;
         }
 
         m_vram_write_replacements.emplace(hash, std::move(fd.FileName));
+
+        // Writes can only be filtered by size if every replacement has one.
+        if (width != 0)
+          m_vram_write_replacement_sizes.insert((width << 16) | height);
+        else
+          has_unsized_replacements = true;
       }
       break;
     }
   }
 
+  m_vram_write_replacement_sizes_known = !has_unsized_replacements;
+  if (has_unsized_replacements)
+    m_vram_write_replacement_sizes.clear();
+
+  for (const auto& it : m_vram_write_replacements)
+  {
+    std::vector<std::string>& dir_files = m_replacement_directories[std::string(Path::GetDirectory(it.second))];
+    if (dir_files.size() < MAX_PREFETCH_PER_DIRECTORY)
+      dir_files.push_back(it.second);
+  }
+
   Log_InfoPrintf("Found %zu replacement VRAM writes for '%s'", m_vram_write_replacements.size(), m_game_id.c_str());
 }
 
 const TextureReplacementTexture* TextureReplacements::LoadTexture(const std::string& filename)
 {
-  auto it = m_texture_cache.find(filename);
-  if (it != m_texture_cache.end())
-    return &it->second;
+  bool found;
+  const TextureReplacementTexture* cached = LookupCachedTexture(filename, &found);
+  if (found)
+    return cached;
 
-  RGBA8Image image;
-  if (!image.LoadFromFile(filename.c_str()))
+  TextureReplacementTexture image;
+  if (!image.LoadFromFile(filename.c_str(), m_supported_formats))
   {
     Log_ErrorPrintf("Failed to load '%s'", filename.c_str());
     return nullptr;
   }
 
-  Log_InfoPrintf("Loaded '%s': %ux%u", filename.c_str(), image.GetWidth(), image.GetHeight());
-  it = m_texture_cache.emplace(filename, std::move(image)).first;
-  return &it->second;
+  Log_InfoFmt("Loaded '{}': {}x{} {}", filename, image.GetWidth(), image.GetHeight(),
+              GPUTexture::GetFormatName(image.GetFormat()));
+  return InsertCachedTexture(filename, std::move(image));
 }
 
 void TextureReplacements::PreloadTextures()
@@ -312,3 +912,124 @@ void TextureReplacements::PreloadTextures()
 
 #undef UPDATE_PROGRESS
 }
+
+const TextureReplacementTexture* TextureReplacements::GetOrQueueTexture(const std::string& filename)
+{
+  bool found;
+  const TextureReplacementTexture* cached = LookupCachedTexture(filename, &found);
+  if (found)
+    return cached;
+
+  std::unique_lock lock(m_load_mutex);
+
+  // Decoded but not handed out yet? Only move it to the cache if it fits in this frame's budget.
+  const auto lit = std::find_if(m_loaded_textures.begin(), m_loaded_textures.end(),
+                                [&filename](const auto& lt) { return lt.first == filename; });
+  if (lit != m_loaded_textures.end())
+  {
+    const u32 size = static_cast<u32>(lit->second.GetSizeInBytes());
+    if (m_upload_budget_remaining != UPLOAD_BUDGET_PER_FRAME && size > m_upload_budget_remaining)
+      return nullptr;
+
+    m_upload_budget_remaining -= std::min(size, m_upload_budget_remaining);
+    TextureReplacementTexture texture = std::move(lit->second);
+    m_loaded_textures.erase(lit);
+    m_pending_loads.erase(filename);
+    return InsertCachedTexture(filename, std::move(texture));
+  }
+
+  if (m_pending_loads.contains(filename))
+    return nullptr;
+
+  if (m_load_threads.empty())
+    StartLoadThreads();
+
+  QueueTextureLoad(filename);
+
+  // Replacement packs tend to be organized by scene, so the rest of the directory is likely to be needed soon.
+  std::string directory(Path::GetDirectory(filename));
+  const auto dit = m_replacement_directories.find(directory);
+  if (dit != m_replacement_directories.end() && m_prefetched_directories.insert(std::move(directory)).second)
+  {
+    for (const std::string& neighbour : dit->second)
+    {
+      if (!m_pending_loads.contains(neighbour) && !m_texture_cache.contains(neighbour))
+        QueueTextureLoad(neighbour);
+    }
+  }
+
+  lock.unlock();
+  m_load_cv.notify_all();
+  return nullptr;
+}
+
+void TextureReplacements::QueueTextureLoad(const std::string& filename)
+{
+  m_load_queue.push_back(filename);
+  m_pending_loads.insert(filename);
+}
+
+void TextureReplacements::StartLoadThreads()
+{
+  const u32 num_threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_LOAD_THREADS);
+  Log_DevFmt("Starting {} texture replacement load threads", num_threads);
+
+  m_load_threads_shutdown = false;
+  for (u32 i = 0; i < num_threads; i++)
+    m_load_threads.emplace_back(&TextureReplacements::LoadThreadEntryPoint, this);
+}
+
+void TextureReplacements::StopLoadThreads()
+{
+  if (m_load_threads.empty())
+    return;
+
+  {
+    std::unique_lock lock(m_load_mutex);
+    m_load_threads_shutdown = true;
+  }
+  m_load_cv.notify_all();
+
+  for (std::thread& thread : m_load_threads)
+    thread.join();
+  m_load_threads.clear();
+}
+
+void TextureReplacements::CancelTextureLoads()
+{
+  std::unique_lock lock(m_load_mutex);
+  m_load_queue.clear();
+  m_pending_loads.clear();
+  m_loaded_textures.clear();
+  m_prefetched_directories.clear();
+  m_load_generation++;
+}
+
+void TextureReplacements::LoadThreadEntryPoint()
+{
+  std::unique_lock lock(m_load_mutex);
+  for (;;)
+  {
+    m_load_cv.wait(lock, [this]() { return m_load_threads_shutdown || !m_load_queue.empty(); });
+    if (m_load_threads_shutdown)
+      break;
+
+    std::string filename = std::move(m_load_queue.front());
+    m_load_queue.pop_front();
+    const u32 generation = m_load_generation;
+    const u32 supported_formats = m_supported_formats;
+    lock.unlock();
+
+    // Failed loads are still passed back as an invalid image, so they're not retried on every write.
+    TextureReplacementTexture image;
+    if (image.LoadFromFile(filename.c_str(), supported_formats))
+      Log_DevFmt("Loaded '{}': {}x{} {}", filename, image.GetWidth(), image.GetHeight(),
+                 GPUTexture::GetFormatName(image.GetFormat()));
+    else
+      Log_ErrorFmt("Failed to load '{}'", filename);
+
+    lock.lock();
+    if (generation == m_load_generation)
+      m_loaded_textures.emplace_back(std::move(filename), std::move(image));
+  }
+}
@@ -3,15 +3,22 @@
 
 #pragma once
 
+#include "util/gpu_texture.h"
 #include "util/image.h"
 
 #include "common/hash_combine.h"
+#include "common/small_string.h"
 
 #include "types.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 struct TextureReplacementHash
@@ -40,7 +47,39 @@ struct hash<TextureReplacementHash>
 };
 } // namespace std
 
-using TextureReplacementTexture = RGBA8Image;
+/// A replacement texture. Either an RGBA8 image, or a block-compressed mip chain from a DDS file, which is uploaded to
+/// the GPU without decoding.
+class TextureReplacementTexture
+{
+public:
+  ALWAYS_INLINE bool IsValid() const { return (m_width > 0 && m_height > 0); }
+  ALWAYS_INLINE bool IsCompressed() const { return GPUTexture::IsCompressedFormat(m_format); }
+  ALWAYS_INLINE GPUTexture::Format GetFormat() const { return m_format; }
+  ALWAYS_INLINE u32 GetWidth() const { return m_width; }
+  ALWAYS_INLINE u32 GetHeight() const { return m_height; }
+  ALWAYS_INLINE u32 GetLevels() const { return m_levels; }
+  ALWAYS_INLINE u32 GetMipWidth(u32 level) const { return std::max<u32>(m_width >> level, 1u); }
+  ALWAYS_INLINE u32 GetMipHeight(u32 level) const { return std::max<u32>(m_height >> level, 1u); }
+
+  const void* GetLevelData(u32 level) const;
+  u32 GetLevelPitch(u32 level) const;
+  size_t GetSizeInBytes() const;
+
+  /// Loads a replacement. Compressed formats which aren't set in supported_formats (bits of GPUTexture::Format) are
+  /// decoded to RGBA8, if a decoder exists for them.
+  bool LoadFromFile(const char* filename, u32 supported_formats);
+
+private:
+  bool LoadDDS(const char* filename, u32 supported_formats);
+
+  RGBA8Image m_image;
+  std::vector<u8> m_compressed_data;
+  std::vector<size_t> m_level_offsets;
+  GPUTexture::Format m_format = GPUTexture::Format::Unknown;
+  u32 m_width = 0;
+  u32 m_height = 0;
+  u32 m_levels = 0;
+};
 
 class TextureReplacements
 {
@@ -58,9 +97,21 @@ public:
 
   void Reload();
 
+  /// Returns the replacement for a VRAM write, if one is loaded. Replacements which are not loaded yet are queued for
+  /// decoding on a worker thread, along with the other replacements in the same directory, and nullptr is returned
+  /// until the decode finishes, so the original data is used in the meantime.
   const TextureReplacementTexture* GetVRAMWriteReplacement(u32 width, u32 height, const void* pixels);
+
+  /// Queues a VRAM write to be dumped on a worker thread, if it hasn't been already. Writes are dropped when the queue
+  /// is full, and picked up again the next time they occur.
   void DumpVRAMWrite(u32 width, u32 height, const void* pixels);
 
+  /// Resets the number of bytes of newly-loaded replacements which can be handed out this frame.
+  void ResetUploadBudget();
+
+  /// Formats the cache size and hit rate for the performance overlay.
+  void GetCacheStatsString(SmallStringBase& str) const;
+
   void Shutdown();
 
 private:
@@ -70,16 +121,32 @@ private:
   };
 
   using VRAMWriteReplacementMap = std::unordered_map<TextureReplacementHash, std::string>;
-  using TextureCache = std::unordered_map<std::string, TextureReplacementTexture>;
+  struct CacheEntry
+  {
+    TextureReplacementTexture texture;
+    u32 last_used_frame;
+  };
+
+  using TextureCache = std::unordered_map<std::string, CacheEntry>;
+  using DirectoryMap = std::unordered_map<std::string, std::vector<std::string>>;
+
+  struct DumpRequest
+  {
+    std::string filename;
+    std::vector<u16> pixels;
+    u32 width;
+    u32 height;
+    bool force_alpha_channel;
+  };
 
   static bool ParseReplacementFilename(const std::string& filename, TextureReplacementHash* replacement_hash,
-                                       ReplacmentType* replacement_type);
+                                       ReplacmentType* replacement_type, u32* width, u32* height);
 
   std::string GetSourceDirectory() const;
   std::string GetDumpDirectory() const;
 
   TextureReplacementHash GetVRAMWriteHash(u32 width, u32 height, const void* pixels) const;
-  std::string GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const;
+  std::string GetVRAMWriteDumpFilename(u32 width, u32 height, const TextureReplacementHash& hash) const;
 
   void FindTextures(const std::string& dir);
 
@@ -87,11 +154,65 @@ private:
   void PreloadTextures();
   void PurgeUnreferencedTexturesFromCache();
 
+  const TextureReplacementTexture* LookupCachedTexture(const std::string& filename, bool* found);
+  const TextureReplacementTexture* InsertCachedTexture(const std::string& filename, TextureReplacementTexture texture);
+  void EvictCachedTextures(size_t required);
+
+  const TextureReplacementTexture* GetOrQueueTexture(const std::string& filename);
+  void QueueTextureLoad(const std::string& filename);
+  void StartLoadThreads();
+  void StopLoadThreads();
+  void CancelTextureLoads();
+  void LoadThreadEntryPoint();
+
+  void StartDumpThread();
+  void StopDumpThread();
+  void DumpThreadEntryPoint();
+
   std::string m_game_id;
 
+  // Textures are evicted least-recently-used first to stay within the cache size setting, unless preloading.
   TextureCache m_texture_cache;
+  size_t m_texture_cache_size = 0;
+  u32 m_cache_hits = 0;
+  u32 m_cache_misses = 0;
 
   VRAMWriteReplacementMap m_vram_write_replacements;
+
+  // Sizes of the VRAM writes which have replacements, packed as (width << 16) | height. Newer dumps include the size in
+  // the filename, when every replacement has one, writes of other sizes are skipped without hashing.
+  std::unordered_set<u32> m_vram_write_replacement_sizes;
+  bool m_vram_write_replacement_sizes_known = false;
+
+  // Hashes which have already been dumped, or found to exist, this session.
+  std::unordered_set<TextureReplacementHash> m_dumped_vram_writes;
+
+  // Replacement filenames grouped by directory, used to prefetch neighbours when a directory is first touched.
+  DirectoryMap m_replacement_directories;
+  std::unordered_set<std::string> m_prefetched_directories;
+  u32 m_upload_budget_remaining = 0;
+
+  // Shared with the load threads, protected by m_load_mutex. m_pending_loads holds everything queued or in
+  // flight, so a texture is never decoded twice. The generation is bumped on reload, so in-flight decodes for the
+  // previous game are dropped. m_supported_formats is the mask of compressed formats the device can sample.
+  std::vector<std::thread> m_load_threads;
+  std::mutex m_load_mutex;
+  std::condition_variable m_load_cv;
+  std::deque<std::string> m_load_queue;
+  std::unordered_set<std::string> m_pending_loads;
+  std::vector<std::pair<std::string, TextureReplacementTexture>> m_loaded_textures;
+  u32 m_load_generation = 0;
+  u32 m_supported_formats = 0;
+  bool m_load_threads_shutdown = false;
+
+  // VRAM writes are copied and handed to a single thread for conversion and encoding, protected by m_dump_mutex.
+  std::thread m_dump_thread;
+  std::mutex m_dump_mutex;
+  std::condition_variable m_dump_cv;
+  std::deque<DumpRequest> m_dump_queue;
+  size_t m_queued_dump_bytes = 0;
+  u32 m_dropped_dumps = 0;
+  bool m_dump_thread_shutdown = false;
 };
 
 extern TextureReplacements g_texture_replacements;
\ No newline at end of file
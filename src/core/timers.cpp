@@ -66,6 +66,7 @@ struct CounterState
 
 static void UpdateCountingEnabled(CounterState& cs);
 static void CheckForIRQ(u32 index, u32 old_counter);
+static bool GetLazyCounterValue(u32 timer, u32* value);
 
 static void AddSysClkTicks(void*, TickCount sysclk_ticks, TickCount ticks_late);
 
@@ -269,6 +270,34 @@ void Timers::CheckForIRQ(u32 timer, u32 old_counter)
   }
 }
 
+bool Timers::GetLazyCounterValue(u32 timer, u32* value)
+{
+  // The event is always scheduled for the next IRQ, so the pending ticks can only cross the target or overflow when
+  // that doesn't raise an interrupt. The counter only needs to be brought up to date if it would reset or wrap.
+  const CounterState& cs = s_states[timer];
+  TickCount sysclk_carry = s_sysclk_ticks_carry;
+  TickCount ticks = System::UnscaleTicksToOverclock(s_sysclk_event->GetTicksSinceLastExecution(), &sysclk_carry);
+  if (!cs.counting_enabled || ticks <= 0)
+  {
+    *value = cs.counter;
+    return true;
+  }
+
+  if (cs.external_counting_enabled) // sysclk/8 for timer 2
+    ticks = (ticks + static_cast<TickCount>(s_sysclk_div_8_carry)) / 8;
+
+  const u32 new_counter = cs.counter + static_cast<u32>(ticks);
+  const bool reaches_target = (new_counter >= cs.target && (cs.counter < cs.target || cs.target == 0));
+  if ((reaches_target && (cs.mode.irq_at_target || (cs.mode.reset_at_target && cs.target > 0))) ||
+      new_counter >= 0xFFFF)
+  {
+    return false;
+  }
+
+  *value = new_counter;
+  return true;
+}
+
 void Timers::AddSysClkTicks(void*, TickCount sysclk_ticks, TickCount ticks_late)
 {
   sysclk_ticks = System::UnscaleTicksToOverclock(sysclk_ticks, &s_sysclk_ticks_carry);
@@ -312,8 +341,15 @@ u32 Timers::ReadRegister(u32 offset)
         // timers 0/1 depend on the GPU
         if (timer_index == 0 || g_gpu->IsCRTCScanlinePending())
           g_gpu->SynchronizeCRTC();
+
+        return cs.counter;
       }
 
+      // Games tend to poll the counter in a loop, so avoid running and rescheduling the event for every read.
+      u32 value;
+      if (GetLazyCounterValue(timer_index, &value))
+        return value;
+
       s_sysclk_event->InvokeEarly();
 
       return cs.counter;
@@ -4,18 +4,40 @@
 #include "timing_event.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+
+#include <algorithm>
+#include <utility>
+
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
-static TimingEvent* s_active_events_head;
-static TimingEvent* s_active_events_tail;
+// Active events are kept in a binary min-heap ordered by downcount, so scheduling is O(log n) instead of a walk
+// through a sorted list. Ties are broken by a sequence number which gives the same order the sorted list did: added
+// events and events which are pushed back go before others with the same downcount, events which are pulled forward
+// go after them, and an event whose downcount doesn't change keeps its place.
+// The heap is keyed on the downcount each event was last positioned with, so an event's downcount can change without
+// it moving, like it could in the list. While an event's callback runs, it's held at the head with its new downcount,
+// and anything which gets queued in front of it during the callback sorts below its sequence, the rest above.
+// The list could end up out of order when an event was queued in front of the running event, but behind events which
+// were due before it. The heap can't represent that, and runs them in downcount order instead. Events moved during an
+// InvokeEarly() callback also don't take the invoked event's new downcount into account, only its old position.
+static constexpr s64 HELD_EVENT_SEQUENCE_GAP = 0x10000;
+static std::vector<TimingEvent*> s_active_events;
+static TimingEvent* s_active_events_head = nullptr;
 static TimingEvent* s_current_event = nullptr;
 static u32 s_active_event_count = 0;
+static s64 s_front_sequence = -1;
+static s64 s_back_sequence = 0;
+static s64 s_held_front_sequence = 0;
+static s64 s_held_back_sequence = 0;
+static TickCount s_held_ahead_max_downcount = 0;
+static bool s_current_event_held = false;
 static u32 s_global_tick_counter = 0;
 static u32 s_event_run_tick_counter = 0;
 static bool s_frame_done = false;
@@ -67,209 +89,302 @@ TimingEvent** GetHeadEventPtr()
   return &s_active_events_head;
 }
 
-static void SortEvent(TimingEvent* event)
+ALWAYS_INLINE static bool EventRunsBefore(const TimingEvent* lhs, const TimingEvent* rhs)
 {
-  const TickCount event_downcount = event->m_downcount;
+  return (lhs->m_sorted_downcount < rhs->m_sorted_downcount ||
+          (lhs->m_sorted_downcount == rhs->m_sorted_downcount && lhs->m_sequence < rhs->m_sequence));
+}
+
+static void SetHeapEvent(u32 index, TimingEvent* event)
+{
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
 
-  if (event->prev && event->prev->m_downcount > event_downcount)
+static void SiftEventUp(u32 index)
+{
+  TimingEvent* const event = s_active_events[index];
+  while (index > 0)
   {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_downcount > event_downcount)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
+    const u32 parent = (index - 1) / 2;
+    if (!EventRunsBefore(event, s_active_events[parent]))
+      break;
 
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_active_events_tail = event;
-
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_active_events_head);
-      s_active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_active_events_head;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    SetHeapEvent(index, s_active_events[parent]);
+    index = parent;
   }
-  else if (event->next && event_downcount > event->next->m_downcount)
+
+  SetHeapEvent(index, event);
+}
+
+static void SiftEventDown(u32 index)
+{
+  TimingEvent* const event = s_active_events[index];
+  for (;;)
   {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_downcount > current->m_downcount)
-      current = current->next;
+    const u32 left = (index * 2) + 1;
+    if (left >= s_active_event_count)
+      break;
+
+    const u32 right = left + 1;
+    const u32 child =
+      (right < s_active_event_count && EventRunsBefore(s_active_events[right], s_active_events[left])) ? right : left;
+    if (!EventRunsBefore(s_active_events[child], event))
+      break;
+
+    SetHeapEvent(index, s_active_events[child]);
+    index = child;
+  }
 
-    // unlink
-    if (event->prev)
-    {
-      event->prev->next = event->next;
-    }
-    else
-    {
-      s_active_events_head = event->next;
-      UpdateCPUDowncount();
-    }
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
+  SetHeapEvent(index, event);
+}
 
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+static void UpdateHeadEvent()
+{
+  TimingEvent* const head = (s_active_event_count > 0) ? s_active_events[0] : nullptr;
+  if (s_active_events_head == head)
+    return;
 
-      if (current->prev)
-      {
-        current->prev->next = event;
-      }
-      else
-      {
-        s_active_events_head = event;
-        UpdateCPUDowncount();
-      }
+  s_active_events_head = head;
+  if (head)
+    UpdateCPUDowncount();
+}
 
-      current->prev = event;
-    }
-    else
+ALWAYS_INLINE static bool IsAheadOfHeldEvent(const TimingEvent* event)
+{
+  return (event->m_sequence < s_current_event->m_sequence);
+}
+
+static bool HasEventAheadOfHeldEvent(const TimingEvent* event, bool include_equal)
+{
+  // Looks for an event in front of the held event which isn't due before this one. Equal events only count if this
+  // one is being placed before them, or is already in front of them.
+  const TickCount downcount = event->m_downcount;
+  if (downcount > s_held_ahead_max_downcount)
+    return false;
+
+  for (u32 i = 0; i < s_active_event_count; i++)
+  {
+    const TimingEvent* other = s_active_events[i];
+    if (other != event && IsAheadOfHeldEvent(other) &&
+        (other->m_downcount > downcount ||
+         (other->m_downcount == downcount && (include_equal || other->m_sequence > event->m_sequence))))
     {
-      // insert at back
-      DebugAssert(s_active_events_tail);
-      s_active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_active_events_tail;
-      s_active_events_tail = event;
+      return true;
     }
   }
+
+  return false;
 }
 
-static void AddActiveEvent(TimingEvent* event)
+static bool HasEventBehindHeldEvent(const TimingEvent* event, bool include_equal, u32 index = 0)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_active_event_count++;
-
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_active_events_head;
-  while (next && event->m_downcount > next->m_downcount)
+  // Looks for an event behind the held event which isn't due after this one. Only the subtrees which can contain
+  // such an event need to be searched.
+  if (index >= s_active_event_count)
+    return false;
+
+  const TimingEvent* other = s_active_events[index];
+  if (other->m_sorted_downcount > event->m_downcount)
+    return false;
+
+  if (other != event && other != s_current_event && !IsAheadOfHeldEvent(other) &&
+      (other->m_downcount < event->m_downcount ||
+       (other->m_downcount == event->m_downcount && (include_equal || other->m_sequence < event->m_sequence))))
   {
-    current = next;
-    next = next->next;
+    return true;
   }
 
-  if (!next)
+  return (HasEventBehindHeldEvent(event, include_equal, (index * 2) + 1) ||
+          HasEventBehindHeldEvent(event, include_equal, (index * 2) + 2));
+}
+
+static bool PassesHeldEventForwards(const TimingEvent* event, bool moved)
+{
+  // The list was searched forwards from the event, so it passes the held event if that and every event in front of
+  // it is due before this one.
+  return (event->m_downcount > s_current_event->m_downcount && !HasEventAheadOfHeldEvent(event, moved));
+}
+
+static bool PassesHeldEventBackwards(const TimingEvent* event, bool moved)
+{
+  // The list was searched backwards from the event, so it passes the held event if that and every event behind it
+  // is due after this one.
+  return (event->m_downcount < s_current_event->m_downcount && !HasEventBehindHeldEvent(event, moved));
+}
+
+static void SetFrontSequence(TimingEvent* event, bool ahead_of_held_event)
+{
+  // Goes before anything else with the same downcount. Events behind the held event use the gap left between it and
+  // the events which were queued before the callback started.
+  if (!s_current_event_held)
   {
-    // new tail
-    event->prev = s_active_events_tail;
-    if (s_active_events_tail)
-    {
-      s_active_events_tail->next = event;
-      s_active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_active_events_tail = event;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    event->m_sequence = s_front_sequence--;
   }
-  else if (!current)
+  else if (ahead_of_held_event)
   {
-    // new head
-    event->next = s_active_events_head;
-    s_active_events_head->prev = event;
-    s_active_events_head = event;
-    UpdateCPUDowncount();
+    event->m_sequence = s_front_sequence--;
+    s_held_ahead_max_downcount = std::max(s_held_ahead_max_downcount, event->m_downcount);
   }
   else
   {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
+    DebugAssert(s_held_front_sequence > s_current_event->m_sequence);
+    event->m_sequence = s_held_front_sequence--;
   }
 }
 
+static void SetBackSequence(TimingEvent* event, bool ahead_of_held_event)
+{
+  // Goes after anything else with the same downcount. Events in front of the held event use the gap left below it.
+  if (!s_current_event_held || !ahead_of_held_event)
+  {
+    event->m_sequence = s_back_sequence++;
+  }
+  else
+  {
+    DebugAssert(s_held_back_sequence < s_current_event->m_sequence);
+    event->m_sequence = s_held_back_sequence++;
+    s_held_ahead_max_downcount = std::max(s_held_ahead_max_downcount, event->m_downcount);
+  }
+}
+
+static void InsertEvent(TimingEvent* event)
+{
+  const u32 index = s_active_event_count++;
+  if (index == s_active_events.size())
+    s_active_events.push_back(event);
+
+  event->m_sorted_downcount = event->m_downcount;
+  SetHeapEvent(index, event);
+  SiftEventUp(index);
+  UpdateHeadEvent();
+}
+
+static void UpdateEventPosition(TimingEvent* event)
+{
+  event->m_sorted_downcount = event->m_downcount;
+
+  const u32 index = event->m_heap_index;
+  if (index > 0 && EventRunsBefore(event, s_active_events[(index - 1) / 2]))
+    SiftEventUp(index);
+  else
+    SiftEventDown(index);
+
+  UpdateHeadEvent();
+}
+
 static void RemoveActiveEvent(TimingEvent* event)
 {
   DebugAssert(s_active_event_count > 0);
+  if (event == s_current_event)
+    s_current_event_held = false;
+
+  const u32 index = event->m_heap_index;
+  DebugAssert(s_active_events[index] == event);
 
-  if (event->next)
+  const u32 last_index = --s_active_event_count;
+  if (index == last_index)
   {
-    event->next->prev = event->prev;
+    s_active_events[last_index] = nullptr;
   }
   else
   {
-    s_active_events_tail = event->prev;
+    // move the last event into the hole, and fix up its position
+    TimingEvent* const last_event = std::exchange(s_active_events[last_index], nullptr);
+    SetHeapEvent(index, last_event);
+    if (index > 0 && EventRunsBefore(last_event, s_active_events[(index - 1) / 2]))
+      SiftEventUp(index);
+    else
+      SiftEventDown(index);
   }
 
-  if (event->prev)
+  UpdateHeadEvent();
+}
+
+static void SortEvent(TimingEvent* event)
+{
+  DebugAssert(!s_current_event_held || event != s_current_event);
+
+  const TickCount downcount = event->m_downcount;
+  if (downcount < event->m_sorted_downcount)
+  {
+    // pulled forward, goes after anything else scheduled for the same time
+    SetBackSequence(event, s_current_event_held &&
+                             (IsAheadOfHeldEvent(event) || PassesHeldEventBackwards(event, true)));
+  }
+  else if (downcount > event->m_sorted_downcount)
   {
-    event->prev->next = event->next;
+    // pushed back, goes before anything else scheduled for the same time
+    SetFrontSequence(event, s_current_event_held && IsAheadOfHeldEvent(event) && !PassesHeldEventForwards(event, true));
+  }
+  else if (s_current_event_held &&
+           (IsAheadOfHeldEvent(event) ? PassesHeldEventForwards(event, false) : PassesHeldEventBackwards(event, false)))
+  {
+    // the held event's downcount changed while it stayed in place, so this event moves past it
+    if (IsAheadOfHeldEvent(event))
+      SetFrontSequence(event, false);
+    else
+      SetBackSequence(event, true);
   }
   else
   {
-    s_active_events_head = event->next;
-    if (s_active_events_head)
-      UpdateCPUDowncount();
+    // position hasn't changed
+    return;
   }
 
-  event->prev = nullptr;
-  event->next = nullptr;
+  UpdateEventPosition(event);
+}
 
-  s_active_event_count--;
+static void AddActiveEvent(TimingEvent* event)
+{
+  // new events go before anything else scheduled for the same time
+  SetFrontSequence(event, s_current_event_held && !PassesHeldEventForwards(event, true));
+  InsertEvent(event);
 }
 
-static void SortEvents()
+static void HoldCurrentEvent()
 {
-  std::vector<TimingEvent*> events;
-  events.reserve(s_active_event_count);
+  // Leave gaps on both sides for events which get queued next to it while the callback runs. It's already at the head,
+  // and stays there with a lower sequence.
+  TimingEvent* event = s_current_event;
+  DebugAssert(event == s_active_events_head);
+  s_held_front_sequence = s_front_sequence;
+  event->m_sequence = s_front_sequence - HELD_EVENT_SEQUENCE_GAP;
+  s_held_back_sequence = event->m_sequence - HELD_EVENT_SEQUENCE_GAP + 1;
+  s_front_sequence = event->m_sequence - HELD_EVENT_SEQUENCE_GAP;
+  s_held_ahead_max_downcount = event->m_downcount;
+  s_current_event_held = true;
+}
 
-  TimingEvent* next = s_active_events_head;
-  while (next)
-  {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
-  }
+static void ReleaseCurrentEvent()
+{
+  s_current_event_held = false;
+  UpdateEventPosition(s_current_event);
+}
 
-  s_active_events_head = nullptr;
-  s_active_events_tail = nullptr;
+static void SortEvents(const std::vector<TimingEvent*>& events)
+{
+  // called after loading state, events are added again in the order they ran in before
   s_active_event_count = 0;
-
+  s_front_sequence = -1;
+  s_back_sequence = 0;
   for (TimingEvent* event : events)
     AddActiveEvent(event);
 }
 
+static std::vector<TimingEvent*> GetSortedActiveEvents()
+{
+  std::vector<TimingEvent*> events(s_active_events.begin(), s_active_events.begin() + s_active_event_count);
+  std::sort(events.begin(), events.end(), &EventRunsBefore);
+  return events;
+}
+
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  for (TimingEvent* event = s_active_events_head; event; event = event->next)
+  for (u32 i = 0; i < s_active_event_count; i++)
   {
-    if (event->GetName().compare(name) == 0)
-      return event;
+    if (s_active_events[i]->GetName().compare(name) == 0)
+      return s_active_events[i];
   }
 
   return nullptr;
@@ -288,6 +403,8 @@ void SetFrameDone()
 
 void RunEvents()
 {
+  TRACE_ZONE("TimingEvents::RunEvents");
+
   DebugAssert(!s_current_event);
 
   do
@@ -309,16 +426,18 @@ void RunEvents()
 
         // Apply downcount to all events.
         // This will result in a negative downcount for those events which are late.
-        for (TimingEvent* event = s_active_events_head; event; event = event->next)
+        // Every event moves by the same amount, so the heap order doesn't change.
+        for (u32 i = 0; i < s_active_event_count; i++)
         {
+          TimingEvent* event = s_active_events[i];
           event->m_downcount -= time;
+          event->m_sorted_downcount -= time;
           event->m_time_since_last_run += time;
         }
 
         // Now we can actually run the callbacks.
         while (s_active_events_head->m_downcount <= 0)
         {
-          // move it to the end, since that'll likely be its new position
           TimingEvent* event = s_active_events_head;
           s_current_event = event;
 
@@ -329,8 +448,11 @@ void RunEvents()
           event->m_time_since_last_run = 0;
 
           // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
+          HoldCurrentEvent();
           event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
-          if (event->m_active)
+          if (s_current_event_held)
+            ReleaseCurrentEvent();
+          else if (event->m_active)
             SortEvent(event);
         }
       } while (pending_ticks > 0);
@@ -359,6 +481,8 @@ bool DoState(StateWrapper& sw)
     u32 event_count = 0;
     sw.Do(&event_count);
 
+    const std::vector<TimingEvent*> events = GetSortedActiveEvents();
+
     for (u32 i = 0; i < event_count; i++)
     {
       std::string event_name;
@@ -392,14 +516,15 @@ bool DoState(StateWrapper& sw)
     }
 
     Log_DebugPrintf("Loaded %u events from save state.", event_count);
-    SortEvents();
+    SortEvents(events);
   }
   else
   {
 
     sw.Do(&s_active_event_count);
 
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    // written in the order they'll run
+    for (TimingEvent* event : GetSortedActiveEvents())
     {
       sw.Do(&event->m_name);
       sw.Do(&event->m_downcount);
@@ -63,8 +63,11 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
+  // position in the active event heap, order relative to events with the same downcount, and the downcount it was
+  // positioned with
+  u32 m_heap_index = 0;
+  s64 m_sequence = 0;
+  TickCount m_sorted_downcount = 0;
 
   TimingEventCallback m_callback;
   void* m_callback_param;
@@ -106,6 +106,20 @@ enum class GPUDownsampleMode : u8
   Count
 };
 
+/// Parts of the frame which GPU time is broken down into, when GPU timing is enabled.
+enum class GPUTimingRegion : u8
+{
+  Other,
+  Draw,
+  CopyFill,
+  Readback,
+  Downsample,
+  Display,
+  PostProcessing,
+  ImGui,
+  Count
+};
+
 enum class GPUWireframeMode : u8
 {
   Disabled,
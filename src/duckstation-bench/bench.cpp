@@ -0,0 +1,300 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "bench.h"
+
+#include "scmversion/scmversion.h"
+
+#include "common/file_system.h"
+#include "common/string_util.h"
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+struct RegisteredBenchmark
+{
+  const char* name;
+  Bench::Function func;
+};
+
+struct BenchmarkResult
+{
+  const char* name;
+  u64 iterations;
+  double min_ns;    // per iteration, fastest repetition
+  double median_ns; // per iteration, median repetition
+  double bytes_per_second;
+  double items_per_second;
+};
+} // namespace
+
+static std::vector<RegisteredBenchmark>& GetRegisteredBenchmarks();
+static void PrintCommandLineHelp(const char* progname);
+static bool ParseCommandLineParameters(int argc, char* argv[]);
+static BenchmarkResult RunBenchmark(const RegisteredBenchmark& bench);
+static void PrintResult(const BenchmarkResult& result);
+static bool WriteReport(const char* path, const std::vector<BenchmarkResult>& results);
+
+static std::string s_filter;
+static std::string s_report_path;
+static double s_min_time = 0.2;
+static u32 s_repetitions = 5;
+static bool s_list_only = false;
+
+std::vector<RegisteredBenchmark>& GetRegisteredBenchmarks()
+{
+  // Function-local, since registrations run during static initialization, in no particular order.
+  static std::vector<RegisteredBenchmark> s_benchmarks;
+  return s_benchmarks;
+}
+
+Bench::Registration::Registration(const char* name, Function func)
+{
+  GetRegisteredBenchmarks().push_back({name, func});
+}
+
+void Bench::FillRandom(std::span<u8> buffer, u32 seed)
+{
+  // xorshift32, so the data is identical on every platform and standard library.
+  u32 state = (seed != 0) ? seed : 0x9E3779B9u;
+  for (u8& byte : buffer)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    byte = static_cast<u8>(state);
+  }
+}
+
+void PrintCommandLineHelp(const char* progname)
+{
+  std::fprintf(stderr, "DuckStation Microbenchmarks Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "Usage: %s [parameters]\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -list: Lists the available benchmarks and exits.\n");
+  std::fprintf(stderr, "  -filter <text>: Only runs benchmarks whose name contains <text>.\n");
+  std::fprintf(stderr, "  -mintime <seconds>: Minimum time for each repetition. Defaults to 0.2.\n");
+  std::fprintf(stderr, "  -repeat <count>: Number of timed repetitions, the fastest and median are reported.\n"
+                       "    Defaults to 5.\n");
+  std::fprintf(stderr, "  -report <file>: Writes the results as JSON, for comparing between builds or machines.\n");
+  std::fprintf(stderr, "\n");
+}
+
+bool ParseCommandLineParameters(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+    if (CHECK_ARG("-help"))
+    {
+      PrintCommandLineHelp(argv[0]);
+      return false;
+    }
+    else if (CHECK_ARG("-list"))
+    {
+      s_list_only = true;
+    }
+    else if (CHECK_ARG_PARAM("-filter"))
+    {
+      s_filter = argv[++i];
+    }
+    else if (CHECK_ARG_PARAM("-mintime"))
+    {
+      s_min_time = StringUtil::FromChars<double>(argv[++i]).value_or(0.0);
+      if (s_min_time <= 0.0)
+      {
+        std::fprintf(stderr, "Invalid minimum time specified: %s\n", argv[i]);
+        return false;
+      }
+    }
+    else if (CHECK_ARG_PARAM("-repeat"))
+    {
+      s_repetitions = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+      if (s_repetitions == 0)
+      {
+        std::fprintf(stderr, "Invalid repetition count specified: %s\n", argv[i]);
+        return false;
+      }
+    }
+    else if (CHECK_ARG_PARAM("-report"))
+    {
+      s_report_path = argv[++i];
+    }
+    else
+    {
+      std::fprintf(stderr, "Unknown parameter: '%s'\n", argv[i]);
+      PrintCommandLineHelp(argv[0]);
+      return false;
+    }
+
+#undef CHECK_ARG_PARAM
+#undef CHECK_ARG
+  }
+
+  return true;
+}
+
+BenchmarkResult RunBenchmark(const RegisteredBenchmark& bench)
+{
+  // Grow the iteration count until a run takes long enough for the timer to be accurate. This also warms the caches.
+  u64 iterations = 1;
+  for (;;)
+  {
+    Bench::State state(iterations);
+    bench.func(state);
+
+    const double elapsed = state.GetElapsedSeconds();
+    if (elapsed >= s_min_time || iterations >= (UINT64_C(1) << 40))
+      break;
+
+    const double scale = (elapsed > 0.0) ? std::min((s_min_time * 1.2) / elapsed, 10.0) : 10.0;
+    iterations = std::max(iterations + 1, static_cast<u64>(static_cast<double>(iterations) * scale));
+  }
+
+  std::vector<double> times;
+  u64 bytes_per_iteration = 0;
+  u64 items_per_iteration = 0;
+  for (u32 i = 0; i < s_repetitions; i++)
+  {
+    Bench::State state(iterations);
+    bench.func(state);
+    times.push_back(state.GetElapsedSeconds() * 1e9 / static_cast<double>(iterations));
+    bytes_per_iteration = state.GetBytesPerIteration();
+    items_per_iteration = state.GetItemsPerIteration();
+  }
+
+  std::sort(times.begin(), times.end());
+
+  BenchmarkResult result;
+  result.name = bench.name;
+  result.iterations = iterations;
+  result.min_ns = times.front();
+  result.median_ns = times[times.size() / 2];
+  result.bytes_per_second = (bytes_per_iteration > 0) ? (bytes_per_iteration * 1e9 / result.median_ns) : 0.0;
+  result.items_per_second = (items_per_iteration > 0) ? (items_per_iteration * 1e9 / result.median_ns) : 0.0;
+  return result;
+}
+
+void PrintResult(const BenchmarkResult& result)
+{
+  std::string line = fmt::format("{:<40} {:>14.1f} ns {:>14.1f} ns {:>12}", result.name, result.median_ns,
+                                 result.min_ns, result.iterations);
+  if (result.bytes_per_second > 0.0)
+    line += fmt::format("  {:.1f} MB/s", result.bytes_per_second / 1048576.0);
+  if (result.items_per_second > 0.0)
+    line += fmt::format("  {:.2f} M items/s", result.items_per_second / 1e6);
+
+  std::fprintf(stdout, "%s\n", line.c_str());
+  std::fflush(stdout);
+}
+
+bool WriteReport(const char* path, const std::vector<BenchmarkResult>& results)
+{
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+
+  // Enough to tell runs apart when comparing commits or machines.
+  writer.Key("version");
+  writer.String(g_scm_tag_str);
+  writer.Key("hash");
+  writer.String(g_scm_hash_str);
+  writer.Key("arch");
+  writer.String(CPU_ARCH_STR);
+  writer.Key("minTime");
+  writer.Double(s_min_time);
+  writer.Key("repetitions");
+  writer.Uint(s_repetitions);
+
+  writer.Key("results");
+  writer.StartArray();
+  for (const BenchmarkResult& result : results)
+  {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(result.name);
+    writer.Key("iterations");
+    writer.Uint64(result.iterations);
+    writer.Key("medianNs");
+    writer.Double(result.median_ns);
+    writer.Key("minNs");
+    writer.Double(result.min_ns);
+    if (result.bytes_per_second > 0.0)
+    {
+      writer.Key("bytesPerSecond");
+      writer.Double(result.bytes_per_second);
+    }
+    if (result.items_per_second > 0.0)
+    {
+      writer.Key("itemsPerSecond");
+      writer.Double(result.items_per_second);
+    }
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  if (!FileSystem::WriteBinaryFile(path, buffer.GetString(), buffer.GetSize()))
+  {
+    std::fprintf(stderr, "Failed to write report to '%s'\n", path);
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (!ParseCommandLineParameters(argc, argv))
+    return EXIT_FAILURE;
+
+  std::vector<RegisteredBenchmark> benchmarks = GetRegisteredBenchmarks();
+  std::sort(benchmarks.begin(), benchmarks.end(),
+            [](const RegisteredBenchmark& lhs, const RegisteredBenchmark& rhs) {
+              return (std::strcmp(lhs.name, rhs.name) < 0);
+            });
+  if (!s_filter.empty())
+  {
+    benchmarks.erase(std::remove_if(benchmarks.begin(), benchmarks.end(),
+                                    [](const RegisteredBenchmark& bench) {
+                                      return (std::strstr(bench.name, s_filter.c_str()) == nullptr);
+                                    }),
+                     benchmarks.end());
+  }
+
+  if (s_list_only)
+  {
+    for (const RegisteredBenchmark& bench : benchmarks)
+      std::fprintf(stdout, "%s\n", bench.name);
+    return EXIT_SUCCESS;
+  }
+
+  std::fprintf(stdout, "%-40s %17s %17s %12s\n", "Benchmark", "Median", "Min", "Iterations");
+
+  std::vector<BenchmarkResult> results;
+  results.reserve(benchmarks.size());
+  for (const RegisteredBenchmark& bench : benchmarks)
+  {
+    results.push_back(RunBenchmark(bench));
+    PrintResult(results.back());
+  }
+
+  if (!s_report_path.empty() && !WriteReport(s_report_path.c_str(), results))
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
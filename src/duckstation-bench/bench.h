@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "common/timer.h"
+#include "common/types.h"
+
+#include <span>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Bench {
+
+// --------------------------------------------------------------------------------------
+//  State
+// --------------------------------------------------------------------------------------
+// Passed to each benchmark function. Setup goes before the loop, and only the loop is timed:
+//
+//   BENCHMARK(Example)
+//   {
+//     std::vector<u8> data = MakeData();
+//     while (state.KeepRunning())
+//       DoNotOptimize(Process(data));
+//     state.SetBytesProcessed(data.size());
+//   }
+//
+class State
+{
+public:
+  explicit State(u64 iterations) : m_iterations(iterations), m_remaining(iterations) {}
+
+  /// Returns true while there are iterations left to run. The clock starts on the first call.
+  ALWAYS_INLINE bool KeepRunning()
+  {
+    if (m_remaining == m_iterations) [[unlikely]]
+      m_start_time = Common::Timer::GetCurrentValue();
+
+    if (m_remaining == 0) [[unlikely]]
+    {
+      m_end_time = Common::Timer::GetCurrentValue();
+      return false;
+    }
+
+    m_remaining--;
+    return true;
+  }
+
+  u64 GetIterations() const { return m_iterations; }
+
+  /// Amount of work done by one iteration, used to report throughput.
+  void SetBytesProcessed(u64 bytes) { m_bytes_per_iteration = bytes; }
+  void SetItemsProcessed(u64 items) { m_items_per_iteration = items; }
+
+  u64 GetBytesPerIteration() const { return m_bytes_per_iteration; }
+  u64 GetItemsPerIteration() const { return m_items_per_iteration; }
+  double GetElapsedSeconds() const { return Common::Timer::ConvertValueToSeconds(m_end_time - m_start_time); }
+
+private:
+  u64 m_iterations;
+  u64 m_remaining;
+  u64 m_bytes_per_iteration = 0;
+  u64 m_items_per_iteration = 0;
+  Common::Timer::Value m_start_time = 0;
+  Common::Timer::Value m_end_time = 0;
+};
+
+using Function = void (*)(State& state);
+
+struct Registration
+{
+  Registration(const char* name, Function func);
+};
+
+/// Stops the compiler from throwing away a value which is otherwise unused.
+template<typename T>
+ALWAYS_INLINE void DoNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+  const volatile char* ptr = reinterpret_cast<const volatile char*>(&value);
+  (void)*ptr;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Fills a buffer with pseudo-random bytes. The same seed always gives the same data, so runs can be compared.
+void FillRandom(std::span<u8> buffer, u32 seed);
+
+} // namespace Bench
+
+#define BENCHMARK(name)                                                                                                \
+  static void Benchmark_##name(Bench::State& state);                                                                 \
+  static const Bench::Registration s_benchmark_registration_##name(#name, &Benchmark_##name);                          \
+  static void Benchmark_##name(Bench::State& state)
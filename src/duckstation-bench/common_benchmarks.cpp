@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "bench.h"
+
+#include "common/fifo_queue.h"
+#include "common/lru_cache.h"
+#include "common/md5_digest.h"
+#include "common/path.h"
+#include "common/sha1_digest.h"
+#include "common/small_string.h"
+#include "common/string_util.h"
+#include "common/thread_pool.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Matches the size of a hunk in most CHD images.
+static constexpr u32 HASH_BUFFER_SIZE = 19584;
+
+BENCHMARK(MD5Digest)
+{
+  std::vector<u8> data(HASH_BUFFER_SIZE);
+  Bench::FillRandom(data, 1);
+
+  u8 digest[16];
+  while (state.KeepRunning())
+  {
+    MD5Digest md5;
+    md5.Update(data.data(), static_cast<u32>(data.size()));
+    md5.Final(digest);
+    Bench::DoNotOptimize(digest);
+  }
+
+  state.SetBytesProcessed(data.size());
+}
+
+BENCHMARK(SHA1Digest)
+{
+  std::vector<u8> data(HASH_BUFFER_SIZE);
+  Bench::FillRandom(data, 2);
+
+  u8 digest[SHA1Digest::DIGEST_SIZE];
+  while (state.KeepRunning())
+  {
+    SHA1Digest sha1;
+    sha1.Update(data.data(), static_cast<u32>(data.size()));
+    sha1.Final(digest);
+    Bench::DoNotOptimize(digest);
+  }
+
+  state.SetBytesProcessed(data.size());
+}
+
+BENCHMARK(StringUtilFromChars)
+{
+  static constexpr const char* values[] = {"0", "12", "4096", "65535", "-1", "1234567", "not a number", "0x10"};
+  while (state.KeepRunning())
+  {
+    for (const char* value : values)
+      Bench::DoNotOptimize(StringUtil::FromChars<s32>(value));
+  }
+
+  state.SetItemsProcessed(std::size(values));
+}
+
+BENCHMARK(StringUtilEqualNoCase)
+{
+  static constexpr std::pair<std::string_view, std::string_view> values[] = {
+    {"CPU", "cpu"}, {"ExecutionMode", "executionmode"}, {"Recompiler", "Interpreter"}, {"GPU", "GPUs"}};
+  while (state.KeepRunning())
+  {
+    for (const auto& [lhs, rhs] : values)
+      Bench::DoNotOptimize(StringUtil::EqualNoCase(lhs, rhs));
+  }
+
+  state.SetItemsProcessed(std::size(values));
+}
+
+BENCHMARK(StringUtilSplitString)
+{
+  const std::string line = "Pad1/Up, Pad1/Down, Pad1/Left, Pad1/Right, Keyboard/Return, Keyboard/Escape";
+  while (state.KeepRunning())
+    Bench::DoNotOptimize(StringUtil::SplitString(line, ',', true));
+}
+
+BENCHMARK(SmallStringFormat)
+{
+  u32 value = 0;
+  while (state.KeepRunning())
+  {
+    TinyString str = TinyString::from_format("memory_card_save_{}_{:08X}", value, value * 31);
+    Bench::DoNotOptimize(str);
+    value++;
+  }
+}
+
+BENCHMARK(PathCanonicalize)
+{
+  const std::string path = "/home/user/.local/share/duckstation/../duckstation/./cache/shaders/../../memcards";
+  while (state.KeepRunning())
+    Bench::DoNotOptimize(Path::Canonicalize(path));
+}
+
+BENCHMARK(PathCombine)
+{
+  while (state.KeepRunning())
+    Bench::DoNotOptimize(Path::Combine("/home/user/.local/share/duckstation/memcards", "SCES-00344_1.mcd"));
+}
+
+BENCHMARK(PathSanitizeFileName)
+{
+  const std::string name = "Final Fantasy VII: Disc 1 <USA> \"Greatest Hits\" | v1.1?";
+  while (state.KeepRunning())
+    Bench::DoNotOptimize(Path::SanitizeFileName(name));
+}
+
+BENCHMARK(LRUCacheLookup)
+{
+  // Mostly hits, with the occasional miss and eviction, as with the texture and shader caches.
+  static constexpr u32 CAPACITY = 256;
+  static constexpr u32 LOOKUPS = 1024;
+  LRUCache<u32, u32> cache(CAPACITY);
+  std::vector<u8> keys(LOOKUPS);
+  Bench::FillRandom(keys, 3);
+
+  while (state.KeepRunning())
+  {
+    for (const u8 key : keys)
+    {
+      const u32 lookup_key = (key < 240) ? key : (key * 7u);
+      if (const u32* value = cache.Lookup(lookup_key))
+        Bench::DoNotOptimize(*value);
+      else
+        cache.Insert(lookup_key, lookup_key);
+    }
+  }
+
+  state.SetItemsProcessed(LOOKUPS);
+}
+
+BENCHMARK(SPSCFIFOQueuePushPop)
+{
+  static constexpr u32 COUNT = 256;
+  auto queue = std::make_unique<SPSCFIFOQueue<u32, COUNT>>();
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < COUNT; i++)
+      queue->Push(i);
+
+    u32 value;
+    while (queue->Pop(&value))
+      Bench::DoNotOptimize(value);
+  }
+
+  state.SetItemsProcessed(COUNT);
+}
+
+// Hands values from a producer thread to the benchmark thread, spinning when the queue is full or empty.
+template<typename PushFunc, typename PopFunc>
+static void RunCrossThreadQueue(Bench::State& state, u32 count, const PushFunc& push, const PopFunc& pop)
+{
+  while (state.KeepRunning())
+  {
+    std::thread producer([count, &push]() {
+      for (u32 i = 0; i < count;)
+      {
+        if (push(i))
+          i++;
+        else
+          std::this_thread::yield();
+      }
+    });
+
+    u64 sum = 0;
+    for (u32 received = 0; received < count;)
+    {
+      u32 value;
+      if (pop(&value))
+      {
+        sum += value;
+        received++;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    producer.join();
+    Bench::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(count);
+}
+
+static constexpr u32 CROSS_THREAD_QUEUE_COUNT = 65536;
+static constexpr u32 CROSS_THREAD_QUEUE_CAPACITY = 1024;
+
+BENCHMARK(SPSCFIFOQueueCrossThread)
+{
+  auto queue = std::make_unique<SPSCFIFOQueue<u32, CROSS_THREAD_QUEUE_CAPACITY>>();
+  RunCrossThreadQueue(
+    state, CROSS_THREAD_QUEUE_COUNT, [&queue](u32 value) { return queue->Push(value); },
+    [&queue](u32* value) { return queue->Pop(value); });
+}
+
+// Baseline for the above, most of the cross-thread queues are currently a FIFOQueue behind a mutex.
+BENCHMARK(FIFOQueueMutexCrossThread)
+{
+  auto queue = std::make_unique<HeapFIFOQueue<u32, CROSS_THREAD_QUEUE_CAPACITY>>();
+  std::mutex mutex;
+  RunCrossThreadQueue(
+    state, CROSS_THREAD_QUEUE_COUNT,
+    [&queue, &mutex](u32 value) {
+      std::unique_lock lock(mutex);
+      if (queue->IsFull())
+        return false;
+      queue->Push(value);
+      return true;
+    },
+    [&queue, &mutex](u32* value) {
+      std::unique_lock lock(mutex);
+      if (queue->IsEmpty())
+        return false;
+      *value = queue->Pop();
+      return true;
+    });
+}
+
+BENCHMARK(ThreadPoolParallelFor)
+{
+  // Mostly measures the overhead of handing out and waiting for batches.
+  static constexpr u32 COUNT = 4096;
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  std::vector<u32> values(COUNT);
+  while (state.KeepRunning())
+  {
+    pool.ParallelFor(
+      COUNT,
+      [&values](u32 start, u32 end) {
+        for (u32 i = start; i < end; i++)
+          values[i] = values[i] * 3 + i;
+      },
+      256);
+  }
+
+  Bench::DoNotOptimize(values);
+  state.SetItemsProcessed(COUNT);
+}
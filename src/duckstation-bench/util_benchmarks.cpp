@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "bench.h"
+
+#include "util/state_wrapper.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+// Roughly the shape of the system state: a couple of large memory blocks, and lots of small scalar fields.
+struct FakeSystemState
+{
+  std::array<u8, 2 * 1024 * 1024> ram;
+  std::array<u16, 1024 * 512> vram;
+  std::array<u8, 512 * 1024> spu_ram;
+  std::array<u32, 4096> registers;
+  std::array<bool, 256> flags;
+
+  void DoState(StateWrapper& sw)
+  {
+    sw.DoBytes(ram.data(), sizeof(ram));
+    sw.DoBytes(vram.data(), sizeof(vram));
+    sw.DoBytes(spu_ram.data(), sizeof(spu_ram));
+    for (u32& reg : registers)
+      sw.Do(&reg);
+    for (bool& flag : flags)
+      sw.Do(&flag);
+  }
+};
+} // namespace
+
+static constexpr u32 STATE_VERSION = 1;
+static constexpr size_t STATE_BUFFER_SIZE = sizeof(FakeSystemState) + 4096;
+
+BENCHMARK(StateWrapperSave)
+{
+  std::unique_ptr<FakeSystemState> st = std::make_unique<FakeSystemState>();
+  Bench::FillRandom(std::span<u8>(reinterpret_cast<u8*>(st.get()), sizeof(FakeSystemState)), 4);
+  std::vector<u8> buffer(STATE_BUFFER_SIZE);
+
+  u64 size = 0;
+  while (state.KeepRunning())
+  {
+    StateWrapper sw(buffer, StateWrapper::Mode::Write, STATE_VERSION);
+    st->DoState(sw);
+    size = sw.GetPosition();
+  }
+
+  state.SetBytesProcessed(size);
+}
+
+BENCHMARK(StateWrapperLoad)
+{
+  std::unique_ptr<FakeSystemState> st = std::make_unique<FakeSystemState>();
+  Bench::FillRandom(std::span<u8>(reinterpret_cast<u8*>(st.get()), sizeof(FakeSystemState)), 5);
+  for (bool& flag : st->flags)
+    flag = false;
+
+  std::vector<u8> buffer(STATE_BUFFER_SIZE);
+  u64 size;
+  {
+    StateWrapper sw(buffer, StateWrapper::Mode::Write, STATE_VERSION);
+    st->DoState(sw);
+    size = sw.GetPosition();
+  }
+
+  while (state.KeepRunning())
+  {
+    StateWrapper sw(std::span<u8>(buffer.data(), size), StateWrapper::Mode::Read, STATE_VERSION);
+    st->DoState(sw);
+    Bench::DoNotOptimize(st->registers);
+  }
+
+  state.SetBytesProcessed(size);
+}
@@ -172,6 +172,7 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToDebug, "Logging", "LogToDebug", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToWindow, "Logging", "LogToWindow", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToFile, "Logging", "LogToFile", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logAsync, "Logging", "LogAsync", false);
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showDebugMenu, "Main", "ShowDebugMenu", false);
 
@@ -196,6 +197,9 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(SettingsWindow* dialog, QWidget*
                              tr("Logs messages to the window."));
   dialog->registerWidgetHelp(m_ui.logToFile, tr("Log To File"), tr("User Preference"),
                              tr("Logs messages to duckstation.log in the user directory."));
+  dialog->registerWidgetHelp(m_ui.logAsync, tr("Asynchronous Logging"), tr("Unchecked"),
+                             tr("Writes messages to the outputs from a separate thread, so logging doesn't slow down "
+                                "emulation. The last messages can be lost if the application crashes."));
   dialog->registerWidgetHelp(m_ui.showDebugMenu, tr("Show Debug Menu"), tr("Unchecked"),
                              tr("Shows a debug menu bar with additional statistics and quick settings."));
 }
@@ -224,6 +228,8 @@ void AdvancedSettingsWidget::addTweakOptions()
                         "LoadDevicesFromSaveStates", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Compress Save States"), "Main", "CompressSaveStates",
                         Settings::DEFAULT_SAVE_STATE_COMPRESSION);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Sync Memory Card Saves To Disk"), "MemoryCards",
+                        "SyncOnSave", false);
 
   if (m_dialog->isPerGameSettings())
   {
@@ -250,6 +256,27 @@ void AdvancedSettingsWidget::addTweakOptions()
                         "RecompilerMemoryExceptions", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Linking"), "CPU",
                         "RecompilerBlockLinking", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Persistent Block Cache"), "CPU",
+                        "RecompilerPersistentCache", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Defer Recompiler Block Compilation"), "CPU",
+                        "RecompilerDeferCompilation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Superblocks"), "CPU",
+                        "RecompilerSuperblocks", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip Idle Loops"), "CPU", "IdleLoopSkipping", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Decode MDEC Macroblocks On Worker Thread"), "Hacks",
+                        "UseMDECThread", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Generate SPU Audio On Worker Thread"), "Hacks",
+                        "UseSPUThread", false);
+  if (!m_dialog->isPerGameSettings())
+  {
+    // Memory is only allocated once at startup, so this can't be changed per-game.
+    addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Huge Pages (Requires Restart)"), "CPU",
+                          "UseHugePages", false);
+    addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Thread Placement"), "Main", "ThreadPlacement",
+                         Settings::ParseThreadPlacementPolicy, Settings::GetThreadPlacementPolicyName,
+                         Settings::GetThreadPlacementPolicyDisplayName,
+                         static_cast<u32>(Threading::ThreadPlacementPolicy::Count), Settings::DEFAULT_THREAD_PLACEMENT);
+  }
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Fast Memory Access"), "CPU",
                        "FastmemMode", Settings::ParseCPUFastmemMode, Settings::GetCPUFastmemModeName,
                        Settings::GetCPUFastmemModeDisplayName, static_cast<u32>(CPUFastmemMode::Count),
@@ -279,6 +306,7 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);  // Increase Timer Resolution
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Load Devices From Save States
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_SAVE_STATE_COMPRESSION); // Compress Save States
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Sync Memory Card Saves
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            static_cast<int>(Settings::DEFAULT_DMA_MAX_SLICE_TICKS)); // DMA max slice ticks
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
@@ -289,6 +317,14 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
                            static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD)); // GPU max run-ahead
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler memory exceptions
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Recompiler block linking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler persistent cache
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler defer compilation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Recompiler superblocks
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Skip idle loops
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // MDEC worker thread
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // SPU worker thread
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Use huge pages
+    setChoiceTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_THREAD_PLACEMENT); // Thread placement
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
                          Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
     setChoiceTweakOption(m_ui.tweakOptionTable, i++,
@@ -308,6 +344,7 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Main", "IncreaseTimerResolution");
   sif->DeleteValue("Main", "LoadDevicesFromSaveStates");
   sif->DeleteValue("Main", "CompressSaveStates");
+  sif->DeleteValue("MemoryCards", "SyncOnSave");
   sif->DeleteValue("Display", "ActiveStartOffset");
   sif->DeleteValue("Display", "ActiveEndOffset");
   sif->DeleteValue("Display", "LineStartOffset");
@@ -318,6 +355,12 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Hacks", "GPUMaxRunAhead");
   sif->DeleteValue("CPU", "RecompilerMemoryExceptions");
   sif->DeleteValue("CPU", "RecompilerBlockLinking");
+  sif->DeleteValue("CPU", "RecompilerPersistentCache");
+  sif->DeleteValue("CPU", "RecompilerDeferCompilation");
+  sif->DeleteValue("CPU", "RecompilerSuperblocks");
+  sif->DeleteValue("CPU", "IdleLoopSkipping");
+  sif->DeleteValue("Hacks", "UseMDECThread");
+  sif->DeleteValue("Hacks", "UseSPUThread");
   sif->DeleteValue("CPU", "FastmemMode");
   sif->DeleteValue("CDROM", "MechaconVersion");
   sif->DeleteValue("CDROM", "RegionCheck");
@@ -117,7 +117,8 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsWindow* dialog, QWidget* parent
   dialog->registerWidgetHelp(
     m_ui.stretchMode, tr("Stretch Mode"), tr("Time Stretching"),
     tr("When running outside of 100% speed, adjusts the tempo on audio instead of dropping frames. Produces "
-       "much nicer fast forward/slowdown audio at a small cost to performance."));
+       "much nicer fast forward/slowdown audio at a small cost to performance. Resampling instead keeps the output "
+       "buffer level steady with inaudible pitch adjustments, which pairs well with Sync To Host Refresh Rate."));
   dialog->registerWidgetHelp(m_ui.stretchSettings, tr("Stretch Settings"), tr("N/A"),
                              tr("These settings fine-tune the behavior of the SoundTouch audio time stretcher when "
                                 "running outside of 100% speed."));
@@ -11,6 +11,7 @@
 
 #include "util/http_downloader.h"
 
+#include "common/binary_delta.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
@@ -278,6 +279,26 @@ void AutoUpdaterDialog::getLatestReleaseComplete(s32 status_code, std::vector<u8
       // search for the correct file
       const QJsonArray assets(doc_object["assets"].toArray());
       const QString asset_filename(UPDATE_ASSET_FILENAME);
+
+#ifdef _WIN32
+      // Releases can also carry deltas from recent versions, which only contain the files that changed.
+      const QString delta_asset_filename =
+        QStringLiteral("%1-delta-%2.zip").arg(asset_filename.chopped(4)).arg(QString::fromUtf8(g_scm_hash_str));
+      m_delta_download_url = QString();
+      m_delta_download_size = 0;
+      for (const QJsonValue& asset : assets)
+      {
+        const QJsonObject asset_obj(asset.toObject());
+        if (asset_obj["name"] == delta_asset_filename)
+        {
+          m_delta_download_url = asset_obj["browser_download_url"].toString();
+          m_delta_download_size = asset_obj["size"].toInt();
+          Log_InfoFmt("Found delta update {} ({} bytes)", delta_asset_filename.toStdString(), m_delta_download_size);
+          break;
+        }
+      }
+#endif
+
       for (const QJsonValue& asset : assets)
       {
         const QJsonObject asset_obj(asset.toObject());
@@ -390,8 +411,9 @@ void AutoUpdaterDialog::getChangesComplete(s32 status_code, std::vector<u8> resp
              "that you will have to reconfigure your settings after this update.</p>"));
       }
 
+      const int download_size = m_delta_download_url.isEmpty() ? m_download_size : m_delta_download_size;
       changes_html += tr("<h4>Installing this update will download %1 MB through your internet connection.</h4>")
-                        .arg(static_cast<double>(m_download_size) / 1000000.0, 0, 'f', 2);
+                        .arg(static_cast<double>(download_size) / 1000000.0, 0, 'f', 2);
 
       m_ui.updateNotes->setText(changes_html);
     }
@@ -411,36 +433,63 @@ void AutoUpdaterDialog::downloadUpdateClicked()
 {
   m_display_messages = true;
 
-  std::optional<bool> download_result;
   QtModalProgressCallback progress(this);
   progress.SetTitle(tr("Automatic Updater").toUtf8().constData());
   progress.SetStatusText(tr("Downloading %1...").arg(m_latest_sha).toUtf8().constData());
   progress.GetDialog().setWindowIcon(windowIcon());
   progress.SetCancellable(true);
 
+  // A delta is only usable if this install hasn't been modified, otherwise fetch the whole thing.
+  std::optional<std::vector<u8>> update_data;
+  if (!m_delta_download_url.isEmpty())
+  {
+    update_data = downloadFile(m_delta_download_url, &progress, false);
+    if (update_data.has_value() && !isDeltaUpdateApplicable(update_data.value()))
+    {
+      Log_WarningPrint("Delta update does not apply to this installation, downloading full update.");
+      update_data.reset();
+    }
+  }
+  if (!update_data.has_value() && !progress.IsCancelled())
+    update_data = downloadFile(m_download_url, &progress, true);
+
+  if (update_data.has_value() && processUpdate(update_data.value()))
+  {
+    // updater started. since we're a modal on the main window, we have to queue this.
+    QMetaObject::invokeMethod(g_main_window, "requestExit", Qt::QueuedConnection, Q_ARG(bool, true));
+    done(0);
+  }
+}
+
+std::optional<std::vector<u8>> AutoUpdaterDialog::downloadFile(const QString& url, QtModalProgressCallback* progress,
+                                                               bool report_errors)
+{
+  std::optional<std::vector<u8>> result;
   m_http->CreateRequest(
-    m_download_url.toStdString(),
-    [this, &download_result](s32 status_code, const std::string&, std::vector<u8> response) {
+    url.toStdString(),
+    [this, &result, report_errors](s32 status_code, const std::string&, std::vector<u8> response) {
       if (status_code == HTTPDownloader::HTTP_STATUS_CANCELLED)
         return;
 
       if (status_code != HTTPDownloader::HTTP_STATUS_OK)
       {
-        reportError("Download failed: %d", status_code);
-        download_result = false;
+        if (report_errors)
+          reportError("Download failed: %d", status_code);
+        else
+          Log_WarningFmt("Download failed: {}", status_code);
         return;
       }
 
       if (response.empty())
       {
-        reportError("Download failed: Update is empty");
-        download_result = false;
+        if (report_errors)
+          reportError("Download failed: Update is empty");
         return;
       }
 
-      download_result = processUpdate(response);
+      result = std::move(response);
     },
-    &progress);
+    progress);
 
   // Since we're going to block, don't allow the timer to poll, otherwise the progress callback can cause the timer to
   // run, and recursively poll again.
@@ -453,12 +502,56 @@ void AutoUpdaterDialog::downloadUpdateClicked()
     m_http->PollRequests();
   }
 
-  if (download_result.value_or(false))
+  return result;
+}
+
+bool AutoUpdaterDialog::isDeltaUpdateApplicable(const std::vector<u8>& update_data) const
+{
+  // The updater checks this too, but by then the full update can't be downloaded any more.
+  unzFile zf = MinizipHelpers::OpenUnzMemoryFile(update_data.data(), update_data.size());
+  if (!zf)
+    return false;
+
+  std::string manifest_data;
+  unz_file_info64 file_info;
+  if (unzLocateFile(zf, BinaryDelta::MANIFEST_FILENAME, 0) == UNZ_OK &&
+      unzGetCurrentFileInfo64(zf, &file_info, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+      unzOpenCurrentFile(zf) == UNZ_OK)
   {
-    // updater started. since we're a modal on the main window, we have to queue this.
-    QMetaObject::invokeMethod(g_main_window, "requestExit", Qt::QueuedConnection, Q_ARG(bool, true));
-    done(0);
+    manifest_data.resize(static_cast<size_t>(file_info.uncompressed_size));
+    if (unzReadCurrentFile(zf, manifest_data.data(), static_cast<u32>(manifest_data.size())) !=
+        static_cast<int>(manifest_data.size()))
+    {
+      manifest_data.clear();
+    }
+    unzCloseCurrentFile(zf);
   }
+  unzClose(zf);
+
+  Error error;
+  const std::optional<std::vector<BinaryDelta::ManifestEntry>> manifest =
+    BinaryDelta::ParseManifest(manifest_data, &error);
+  if (manifest_data.empty() || !manifest.has_value())
+  {
+    Log_ErrorFmt("Delta update manifest is invalid: {}", error.GetDescription());
+    return false;
+  }
+
+  for (const BinaryDelta::ManifestEntry& entry : manifest.value())
+  {
+    if (entry.source_hash.empty())
+      continue;
+
+    const std::string path = Path::Combine(EmuFolders::AppRoot, Path::ToNativePath(entry.path));
+    const std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+    if (!data.has_value() || !StringUtil::EqualNoCase(BinaryDelta::GetHash(data.value()), entry.source_hash))
+    {
+      Log_WarningFmt("'{}' differs from the version the delta was made for", path);
+      return false;
+    }
+  }
+
+  return true;
 }
 
 bool AutoUpdaterDialog::updateNeeded() const
@@ -8,7 +8,9 @@
 #include "ui_autoupdaterdialog.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QStringList>
@@ -17,6 +19,7 @@
 
 class Error;
 class HTTPDownloader;
+class QtModalProgressCallback;
 
 class EmuThread;
 
@@ -61,6 +64,9 @@ private:
   void queueGetChanges();
   void getChangesComplete(s32 status_code, std::vector<u8> response);
 
+  std::optional<std::vector<u8>> downloadFile(const QString& url, QtModalProgressCallback* progress,
+                                              bool report_errors);
+  bool isDeltaUpdateApplicable(const std::vector<u8>& update_data) const;
   bool processUpdate(const std::vector<u8>& update_data);
 
 #ifdef _WIN32
@@ -76,6 +82,8 @@ private:
   QString m_latest_sha;
   QString m_download_url;
   int m_download_size = 0;
+  QString m_delta_download_url;
+  int m_delta_download_size = 0;
 
   bool m_display_messages = false;
   bool m_update_will_break_save_states = false;
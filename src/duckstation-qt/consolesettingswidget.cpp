@@ -51,8 +51,13 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(SettingsWindow* dialog, QWidget* pa
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromReadaheadSectors, "CDROM", "ReadaheadSectors",
                                               Settings::DEFAULT_CDROM_READAHEAD_SECTORS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLoadImageToRAM, "CDROM", "LoadImageToRAM", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromPreloadMemoryLimit, "CDROM", "PreloadMemoryLimit",
+                                              Settings::DEFAULT_CDROM_PRELOAD_MEMORY_LIMIT);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLoadImagePatches, "CDROM", "LoadImagePatches", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromIgnoreDriveSubcode, "CDROM", "IgnoreHostSubcode", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLocalCache, "CDROM", "LocalCache", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromLocalCacheSize, "CDROM", "LocalCacheSize",
+                                              Settings::DEFAULT_CDROM_LOCAL_CACHE_SIZE);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromSeekSpeedup, "CDROM", "SeekSpeedup", 1);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromReadSpeedup, "CDROM", "ReadSpeedup", 1, 1);
 
@@ -98,6 +103,10 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(SettingsWindow* dialog, QWidget* pa
     m_ui.cdromLoadImageToRAM, tr("Preload Image to RAM"), tr("Unchecked"),
     tr("Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay. In some "
        "cases also eliminates stutter when games initiate audio track playback."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromPreloadMemoryLimit, tr("Preload Memory Limit"), tr("1024 MB"),
+    tr("The most memory a preloaded image can use. CHD images are preloaded decompressed, images which would need more "
+       "than this are read from disk instead, with the hunks following each read decompressed ahead of time."));
   dialog->registerWidgetHelp(m_ui.cdromLoadImagePatches, tr("Apply Image Patches"), tr("Unchecked"),
                              tr("Automatically applies patches to disc images when they are present in the same "
                                 "directory. Currently only PPF patches are supported with this option."));
@@ -105,6 +114,13 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(SettingsWindow* dialog, QWidget* pa
     m_ui.cdromIgnoreDriveSubcode, tr("Ignore Drive Subcode"), tr("Unchecked"),
     tr("Ignores the subchannel provided by the drive when using physical discs, instead always generating subchannel "
        "data. Won't work with libcrypt games, but can improve read reliability on some drives."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromLocalCache, tr("Cache Image Locally"), tr("Unchecked"),
+    tr("Copies the parts of the game image which are read into the cache folder, and the rest while the disc is idle. "
+       "Avoids stutter from seeking when images are stored on a network share or other slow storage."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromLocalCacheSize, tr("Local Cache Size"), tr("16384 MB"),
+    tr("The most space cached images can use in total. The least recently played images are removed first."));
 
   m_ui.cpuClockSpeed->setEnabled(m_dialog->getEffectiveBoolValue("CPU", "OverclockEnable", false));
 
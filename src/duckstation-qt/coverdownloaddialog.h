@@ -37,7 +37,8 @@ private:
   class CoverDownloadThread : public QtAsyncProgressThread
   {
   public:
-    CoverDownloadThread(QWidget* parent, const QString& urls, bool use_serials);
+    CoverDownloadThread(QWidget* parent, const QString& urls, bool use_serials, bool update_existing,
+                        u32 max_concurrent_downloads);
     ~CoverDownloadThread();
 
   protected:
@@ -46,6 +47,8 @@ private:
   private:
     std::vector<std::string> m_urls;
     bool m_use_serials;
+    bool m_update_existing;
+    u32 m_max_concurrent_downloads;
   };
 
   void startThread();
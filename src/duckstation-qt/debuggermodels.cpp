@@ -17,8 +17,6 @@
 #include <QtWidgets/QPushButton>
 
 static constexpr int NUM_COLUMNS = 5;
-static constexpr int STACK_RANGE = 128;
-static constexpr u32 STACK_VALUE_SIZE = sizeof(u32);
 
 DebuggerCodeModel::DebuggerCodeModel(QObject* parent /*= nullptr*/) : QAbstractTableModel(parent)
 {
@@ -374,17 +372,23 @@ QVariant DebuggerRegistersModel::headerData(int section, Qt::Orientation orienta
 
 void DebuggerRegistersModel::updateValues()
 {
-  beginResetModel();
-
+  // Only repaint the registers which changed, this is also called periodically while running.
   for (u32 i = 0; i < CPU::NUM_DEBUGGER_REGISTER_LIST_ENTRIES; i++)
-    m_reg_values[i] = *CPU::g_debugger_register_list[i].value_ptr;
+  {
+    const u32 value = *CPU::g_debugger_register_list[i].value_ptr;
+    if (m_reg_values[i] == value)
+      continue;
 
-  endResetModel();
+    m_reg_values[i] = value;
+    emit dataChanged(index(static_cast<int>(i), 1), index(static_cast<int>(i), 1));
+  }
 }
 
 void DebuggerRegistersModel::saveCurrentValues()
 {
   m_old_reg_values = m_reg_values;
+  emit dataChanged(index(0, 1), index(static_cast<int>(CPU::NUM_DEBUGGER_REGISTER_LIST_ENTRIES) - 1, 1),
+                   {Qt::ForegroundRole});
 }
 
 DebuggerStackModel::DebuggerStackModel(QObject* parent /*= nullptr*/) : QAbstractListModel(parent)
@@ -413,18 +417,20 @@ QVariant DebuggerStackModel::data(const QModelIndex& index, int role /*= Qt::Dis
   if (role != Qt::DisplayRole)
     return QVariant();
 
-  const u32 sp = CPU::g_state.regs.sp;
+  const int row = index.row();
+  if (row < 0 || row >= static_cast<int>(m_values.size()))
+    return QVariant();
+
   const VirtualMemoryAddress address =
-    (sp - static_cast<u32>(STACK_RANGE * STACK_VALUE_SIZE)) + static_cast<u32>(index.row()) * STACK_VALUE_SIZE;
+    (m_sp - static_cast<u32>(STACK_RANGE * STACK_VALUE_SIZE)) + static_cast<u32>(row) * STACK_VALUE_SIZE;
 
   if (index.column() == 0)
     return QString::asprintf("0x%08X", address);
 
-  u32 value;
-  if (!CPU::SafeReadMemoryWord(address, &value))
+  if (!m_values[row].has_value())
     return tr("<invalid>");
 
-  return QString::asprintf("0x%08X", ZeroExtend32(value));
+  return QString::asprintf("0x%08X", ZeroExtend32(m_values[row].value()));
 }
 
 QVariant DebuggerStackModel::headerData(int section, Qt::Orientation orientation, int role /*= Qt::DisplayRole*/) const
@@ -449,9 +455,50 @@ QVariant DebuggerStackModel::headerData(int section, Qt::Orientation orientation
 void DebuggerStackModel::invalidateView()
 {
   beginResetModel();
+  readValues(&m_sp, &m_values);
   endResetModel();
 }
 
+void DebuggerStackModel::updateValues()
+{
+  u32 sp;
+  ValueArray values;
+  readValues(&sp, &values);
+
+  // Every address moves with the stack pointer, otherwise only repaint what changed.
+  if (sp != m_sp)
+  {
+    m_sp = sp;
+    m_values = values;
+    emit dataChanged(index(0, 0), index(static_cast<int>(m_values.size()) - 1, 1));
+    return;
+  }
+
+  for (size_t i = 0; i < m_values.size(); i++)
+  {
+    if (m_values[i] == values[i])
+      continue;
+
+    m_values[i] = values[i];
+    emit dataChanged(index(static_cast<int>(i), 1), index(static_cast<int>(i), 1));
+  }
+}
+
+void DebuggerStackModel::readValues(u32* sp, ValueArray* values)
+{
+  *sp = CPU::g_state.regs.sp;
+
+  const VirtualMemoryAddress start_address = *sp - static_cast<u32>(STACK_RANGE * STACK_VALUE_SIZE);
+  for (size_t i = 0; i < values->size(); i++)
+  {
+    u32 value;
+    if (CPU::SafeReadMemoryWord(start_address + static_cast<u32>(i) * STACK_VALUE_SIZE, &value))
+      (*values)[i] = value;
+    else
+      (*values)[i].reset();
+  }
+}
+
 DebuggerAddBreakpointDialog::DebuggerAddBreakpointDialog(QWidget* parent /*= nullptr*/) : QDialog(parent)
 {
   m_ui.setupUi(this);
@@ -13,7 +13,9 @@
 #include <QtCore/QAbstractTableModel>
 #include <QtGui/QPixmap>
 #include <QtWidgets/QDialog>
+#include <array>
 #include <map>
+#include <optional>
 
 class DebuggerCodeModel final : public QAbstractTableModel
 {
@@ -91,6 +93,20 @@ public:
   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
   void invalidateView();
+
+  /// Re-reads the stack, and repaints only the values which changed.
+  void updateValues();
+
+private:
+  static constexpr int STACK_RANGE = 128;
+  static constexpr u32 STACK_VALUE_SIZE = sizeof(u32);
+
+  using ValueArray = std::array<std::optional<u32>, STACK_RANGE * 2>;
+
+  static void readValues(u32* sp, ValueArray* values);
+
+  u32 m_sp = 0;
+  ValueArray m_values = {};
 };
 
 class DebuggerAddBreakpointDialog final : public QDialog
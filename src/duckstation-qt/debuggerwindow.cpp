@@ -7,7 +7,15 @@
 #include "qtutils.h"
 
 #include "common/assert.h"
+#include "common/error.h"
+#include "common/small_string.h"
+#include "common/timer.h"
+#include "core/cpu_code_cache.h"
 #include "core/cpu_core_private.h"
+#include "core/cpu_disasm.h"
+#include "core/system.h"
+
+#include "fmt/format.h"
 
 #include <QtCore/QSignalBlocker>
 #include <QtGui/QCursor>
@@ -15,6 +23,9 @@
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
 
+static constexpr int LIVE_UPDATE_MIN_INTERVAL_MS = 100;
+static constexpr int LIVE_UPDATE_MAX_INTERVAL_MS = 1000;
+
 DebuggerWindow::DebuggerWindow(QWidget* parent /* = nullptr */)
   : QMainWindow(parent), m_active_memory_region(Bus::MemoryRegion::Count)
 {
@@ -24,6 +35,12 @@ DebuggerWindow::DebuggerWindow(QWidget* parent /* = nullptr */)
   createModels();
   setMemoryViewRegion(Bus::MemoryRegion::RAM);
   setUIEnabled(QtHost::IsSystemPaused(), QtHost::IsSystemValid());
+
+  m_live_update_timer = new QTimer(this);
+  m_live_update_timer->setSingleShot(true);
+  connect(m_live_update_timer, &QTimer::timeout, this, &DebuggerWindow::onLiveUpdateTimer);
+  if (QtHost::IsSystemValid() && !QtHost::IsSystemPaused())
+    startLiveUpdates();
 }
 
 DebuggerWindow::~DebuggerWindow() = default;
@@ -31,15 +48,18 @@ DebuggerWindow::~DebuggerWindow() = default;
 void DebuggerWindow::onSystemStarted()
 {
   setUIEnabled(false, true);
+  startLiveUpdates();
 }
 
 void DebuggerWindow::onSystemDestroyed()
 {
+  stopLiveUpdates();
   setUIEnabled(false, false);
 }
 
 void DebuggerWindow::onSystemPaused()
 {
+  stopLiveUpdates();
   setUIEnabled(true, true);
   refreshAll();
 
@@ -52,6 +72,7 @@ void DebuggerWindow::onSystemPaused()
 void DebuggerWindow::onSystemResumed()
 {
   setUIEnabled(false, true);
+  startLiveUpdates();
 
   {
     QSignalBlocker sb(m_ui.actionPause);
@@ -72,6 +93,45 @@ void DebuggerWindow::refreshAll()
 
   m_code_model->setPC(CPU::g_state.pc);
   scrollToPC();
+
+  refreshTraceBuffer();
+}
+
+void DebuggerWindow::startLiveUpdates()
+{
+  m_live_update_interval = LIVE_UPDATE_MIN_INTERVAL_MS;
+  m_live_update_timer->start(m_live_update_interval);
+}
+
+void DebuggerWindow::stopLiveUpdates()
+{
+  m_live_update_timer->stop();
+}
+
+void DebuggerWindow::onLiveUpdateTimer()
+{
+  if (!QtHost::IsSystemValid() || QtHost::IsSystemPaused())
+    return;
+
+  // State is read while the CPU thread is running, like the memory scanner does. Values can be a little stale or
+  // inconsistent with each other, but that's fine for watching, and everything is re-read when paused.
+  Common::Timer update_timer;
+  if (isVisible() && !isMinimized())
+  {
+    m_registers_model->updateValues();
+    m_stack_model->updateValues();
+    m_ui.memoryView->updateChangedBytes();
+  }
+  const double update_time = update_timer.GetTimeMilliseconds();
+
+  // Back off while the game isn't keeping up with its target speed, and never spend more than ~2% of the time here.
+  const float target_speed = System::GetTargetSpeed();
+  const bool falling_behind = (target_speed > 0.0f && System::GetEmulationSpeed() < (target_speed * 95.0f));
+  m_live_update_interval =
+    falling_behind ? (m_live_update_interval * 2) : std::max(m_live_update_interval / 2, LIVE_UPDATE_MIN_INTERVAL_MS);
+  m_live_update_interval = std::clamp(std::max(m_live_update_interval, static_cast<int>(update_time * 50.0)),
+                                      LIVE_UPDATE_MIN_INTERVAL_MS, LIVE_UPDATE_MAX_INTERVAL_MS);
+  m_live_update_timer->start(m_live_update_interval);
 }
 
 void DebuggerWindow::scrollToPC()
@@ -156,6 +216,55 @@ void DebuggerWindow::onTraceTriggered()
   }
 }
 
+void DebuggerWindow::onProfileBlocksTriggered()
+{
+  if (!CPU::CodeCache::IsBlockProfilingEnabled())
+  {
+    Host::RunOnCPUThread([]() { CPU::CodeCache::SetBlockProfilingEnabled(true); });
+    QMessageBox::information(
+      this, windowTitle(),
+      tr("Block profiling started, all blocks will be recompiled.\nSelect Profile Blocks again to save the results."));
+    return;
+  }
+
+  const QString path = QFileDialog::getSaveFileName(this, tr("Save Block Profile"), QString(),
+                                                    tr("CSV Files (*.csv);;JSON Files (*.json)"));
+  if (path.isEmpty())
+    return;
+
+  Host::RunOnCPUThread([path = path.toStdString()]() {
+    Error error;
+    if (!CPU::CodeCache::DumpBlockProfile(path.c_str(), &error))
+      Host::ReportErrorAsync("Error", fmt::format("Failed to save block profile: {}", error.GetDescription()));
+
+    CPU::CodeCache::SetBlockProfilingEnabled(false);
+  });
+}
+
+void DebuggerWindow::onTraceBufferTriggered()
+{
+  if (!CPU::IsTraceBufferEnabled())
+  {
+    Host::RunOnCPUThread([]() { CPU::SetTraceBufferEnabled(true); });
+    QMessageBox::information(this, windowTitle(),
+                             tr("Trace buffer recording started. The most recent instructions will be shown when "
+                                "execution pauses.\nSelect Record Trace Buffer again to save it."));
+    return;
+  }
+
+  const QString path = QFileDialog::getSaveFileName(this, tr("Save Trace Buffer"), QString(), tr("Text Files (*.txt)"));
+
+  Host::RunOnCPUThread([path = path.toStdString()]() {
+    Error error;
+    if (!path.empty() && !CPU::DumpTraceBuffer(path.c_str(), &error))
+      Host::ReportErrorAsync("Error", fmt::format("Failed to save trace buffer: {}", error.GetDescription()));
+
+    CPU::SetTraceBufferEnabled(false);
+  });
+
+  m_ui.traceWidget->clear();
+}
+
 void DebuggerWindow::onFollowAddressTriggered()
 {
   //
@@ -435,6 +544,7 @@ void DebuggerWindow::setupAdditionalUi()
   m_ui.registerView->setFont(fixedFont);
   m_ui.memoryView->setFont(fixedFont);
   m_ui.stackView->setFont(fixedFont);
+  m_ui.traceWidget->setFont(fixedFont);
 
   m_ui.codeView->setContextMenuPolicy(Qt::CustomContextMenu);
   m_ui.breakpointsWidget->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -457,6 +567,8 @@ void DebuggerWindow::connectSignals()
   connect(m_ui.actionGoToAddress, &QAction::triggered, this, &DebuggerWindow::onGoToAddressTriggered);
   connect(m_ui.actionDumpAddress, &QAction::triggered, this, &DebuggerWindow::onDumpAddressTriggered);
   connect(m_ui.actionTrace, &QAction::triggered, this, &DebuggerWindow::onTraceTriggered);
+  connect(m_ui.actionProfileBlocks, &QAction::triggered, this, &DebuggerWindow::onProfileBlocksTriggered);
+  connect(m_ui.actionTraceBuffer, &QAction::triggered, this, &DebuggerWindow::onTraceBufferTriggered);
   connect(m_ui.actionStepInto, &QAction::triggered, this, &DebuggerWindow::onStepIntoActionTriggered);
   connect(m_ui.actionStepOver, &QAction::triggered, this, &DebuggerWindow::onStepOverActionTriggered);
   connect(m_ui.actionStepOut, &QAction::triggered, this, &DebuggerWindow::onStepOutActionTriggered);
@@ -509,6 +621,11 @@ void DebuggerWindow::createModels()
   m_ui.breakpointsWidget->setColumnWidth(2, 50);
   m_ui.breakpointsWidget->setColumnWidth(3, 40);
   m_ui.breakpointsWidget->setRootIsDecorated(false);
+
+  m_ui.traceWidget->setColumnWidth(0, 80);
+  m_ui.traceWidget->setColumnWidth(1, 80);
+  m_ui.traceWidget->setColumnWidth(2, 250);
+  m_ui.traceWidget->setRootIsDecorated(false);
 }
 
 void DebuggerWindow::setUIEnabled(bool enabled, bool allow_pause)
@@ -531,6 +648,8 @@ void DebuggerWindow::setUIEnabled(bool enabled, bool allow_pause)
   m_ui.actionGoToAddress->setEnabled(enabled);
   m_ui.actionGoToPC->setEnabled(enabled);
   m_ui.actionTrace->setEnabled(enabled);
+  m_ui.actionTraceBuffer->setEnabled(enabled);
+  m_ui.traceWidget->setEnabled(enabled);
   m_ui.memoryRegionRAM->setEnabled(enabled);
   m_ui.memoryRegionEXP1->setEnabled(enabled);
   m_ui.memoryRegionScratchpad->setEnabled(enabled);
@@ -637,6 +756,41 @@ void DebuggerWindow::refreshBreakpointList()
     [this]() { QtHost::RunOnUIThread([this, bps = CPU::CopyBreakpointList()]() { refreshBreakpointList(bps); }); });
 }
 
+void DebuggerWindow::refreshTraceBuffer()
+{
+  // The full buffer is far too many items, it can be saved to a file instead.
+  static constexpr u32 MAX_VIEW_ENTRIES = 1000;
+
+  Host::RunOnCPUThread([this]() {
+    QtHost::RunOnUIThread([this, entries = CPU::CopyTraceBuffer(MAX_VIEW_ENTRIES)]() { refreshTraceBuffer(entries); });
+  });
+}
+
+void DebuggerWindow::refreshTraceBuffer(const std::vector<CPU::TraceBufferEntry>& entries)
+{
+  m_ui.traceWidget->clear();
+
+  SmallString str;
+  for (const CPU::TraceBufferEntry& entry : entries)
+  {
+    CPU::DisassembleInstruction(&str, entry.pc, entry.bits);
+
+    QTreeWidgetItem* item = new QTreeWidgetItem();
+    item->setText(0, QString::asprintf("0x%08X", entry.pc));
+    item->setText(1, QString::asprintf("%08X", entry.bits));
+    item->setText(2, QString::fromUtf8(str.c_str(), static_cast<int>(str.length())));
+    if (entry.has_address)
+    {
+      const QString address = QString::asprintf("0x%08X", entry.address);
+      item->setText(3, entry.is_write ? tr("Write %1").arg(address) : tr("Read %1").arg(address));
+    }
+
+    m_ui.traceWidget->addTopLevelItem(item);
+  }
+
+  m_ui.traceWidget->scrollToBottom();
+}
+
 void DebuggerWindow::refreshBreakpointList(const CPU::BreakpointList& bps)
 {
   while (m_ui.breakpointsWidget->topLevelItemCount() > 0)
@@ -8,6 +8,7 @@
 #include "core/cpu_core.h"
 #include "core/types.h"
 
+#include <QtCore/QTimer>
 #include <QtWidgets/QMainWindow>
 #include <memory>
 #include <optional>
@@ -42,6 +43,7 @@ private Q_SLOTS:
   void onDebuggerMessageReported(const QString& message);
 
   void refreshAll();
+  void onLiveUpdateTimer();
 
   void scrollToPC();
 
@@ -52,6 +54,8 @@ private Q_SLOTS:
   void onDumpAddressTriggered();
   void onFollowAddressTriggered();
   void onTraceTriggered();
+  void onProfileBlocksTriggered();
+  void onTraceBufferTriggered();
   void onAddBreakpointTriggered();
   void onToggleBreakpointTriggered();
   void onClearBreakpointsTriggered();
@@ -70,6 +74,8 @@ private:
   void disconnectSignals();
   void createModels();
   void setUIEnabled(bool enabled, bool allow_pause);
+  void startLiveUpdates();
+  void stopLiveUpdates();
   void setMemoryViewRegion(Bus::MemoryRegion region);
   void toggleBreakpoint(VirtualMemoryAddress address);
   void clearBreakpoints();
@@ -78,6 +84,8 @@ private:
   void scrollToCodeAddress(VirtualMemoryAddress address);
   bool scrollToMemoryAddress(VirtualMemoryAddress address);
   void refreshBreakpointList();
+  void refreshTraceBuffer();
+  void refreshTraceBuffer(const std::vector<CPU::TraceBufferEntry>& entries);
   void refreshBreakpointList(const CPU::BreakpointList& bps);
   void addBreakpoint(CPU::BreakpointType type, u32 address);
   void removeBreakpoint(CPU::BreakpointType type, u32 address);
@@ -91,4 +99,7 @@ private:
   Bus::MemoryRegion m_active_memory_region;
 
   PhysicalMemoryAddress m_next_memory_search_address = 0;
+
+  QTimer* m_live_update_timer = nullptr;
+  int m_live_update_interval = 0;
 };
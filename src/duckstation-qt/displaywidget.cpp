@@ -32,7 +32,7 @@
 
 Log_SetChannel(DisplayWidget);
 
-DisplayWidget::DisplayWidget(QWidget* parent) : QWidget(parent)
+DisplayWidget::DisplayWidget(QWidget* parent, Qt::WindowFlags flags) : QWidget(parent, flags)
 {
   // We want a native window for both D3D and OpenGL.
   setAutoFillBackground(false);
@@ -464,3 +464,59 @@ bool DisplayContainer::event(QEvent* event)
 
   return res;
 }
+
+DisplayPlaceholder::DisplayPlaceholder(DisplayWidget* display_widget, QWidget* parent)
+  : QWidget(parent), m_display_widget(display_widget)
+{
+}
+
+DisplayPlaceholder::~DisplayPlaceholder() = default;
+
+bool DisplayPlaceholder::isNeeded(bool fullscreen, bool render_to_main)
+{
+#ifdef _WIN32
+  // Only Windows needs this. Wayland already embeds native child windows as subsurfaces, which can be scanned out
+  // directly, and there's no way to position a top-level window there anyway.
+  return (!fullscreen && render_to_main && Host::GetBaseBoolSettingValue("Main", "LowLatencyWindowedDisplay", false));
+#else
+  return false;
+#endif
+}
+
+void DisplayPlaceholder::updateDisplayGeometry()
+{
+  if (!isVisible())
+    return;
+
+  m_display_widget->setGeometry(QRect(mapToGlobal(QPoint(0, 0)), size()));
+}
+
+void DisplayPlaceholder::moveEvent(QMoveEvent* event)
+{
+  QWidget::moveEvent(event);
+  updateDisplayGeometry();
+}
+
+void DisplayPlaceholder::resizeEvent(QResizeEvent* event)
+{
+  QWidget::resizeEvent(event);
+  updateDisplayGeometry();
+}
+
+void DisplayPlaceholder::showEvent(QShowEvent* event)
+{
+  QWidget::showEvent(event);
+  updateDisplayGeometry();
+  m_display_widget->show();
+  m_display_widget->activateWindow();
+}
+
+void DisplayPlaceholder::hideEvent(QHideEvent* event)
+{
+  QWidget::hideEvent(event);
+
+  // Switching to the game list while running. Minimizing is spontaneous, and Windows hides owned windows with their
+  // owner itself.
+  if (!event->spontaneous())
+    m_display_widget->hide();
+}
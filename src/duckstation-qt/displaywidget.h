@@ -18,7 +18,7 @@ class DisplayWidget final : public QWidget
   Q_OBJECT
 
 public:
-  explicit DisplayWidget(QWidget* parent);
+  explicit DisplayWidget(QWidget* parent, Qt::WindowFlags flags = {});
   ~DisplayWidget();
 
   QPaintEngine* paintEngine() const override;
@@ -87,3 +87,29 @@ protected:
 private:
   DisplayWidget* m_display_widget = nullptr;
 };
+
+/// Takes the place of the display widget in the main window, when the display is rendered in a borderless top-level
+/// window owned by the main window instead of a child window. The display window tracks this widget's position on
+/// screen so it appears embedded, but since it's a top-level window, the compositor can flip its swap chain straight
+/// to the screen, instead of composing it with the rest of the main window.
+class DisplayPlaceholder final : public QWidget
+{
+  Q_OBJECT
+
+public:
+  DisplayPlaceholder(DisplayWidget* display_widget, QWidget* parent);
+  ~DisplayPlaceholder();
+
+  static bool isNeeded(bool fullscreen, bool render_to_main);
+
+  void updateDisplayGeometry();
+
+protected:
+  void moveEvent(QMoveEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+  void showEvent(QShowEvent* event) override;
+  void hideEvent(QHideEvent* event) override;
+
+private:
+  DisplayWidget* m_display_widget;
+};
@@ -22,6 +22,11 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.preFrameSleep, "Display", "PreFrameSleep", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(sif, m_ui.preFrameSleepBuffer, "Display", "PreFrameSleepBuffer",
                                                 Settings::DEFAULT_DISPLAY_PRE_FRAME_SLEEP_BUFFER);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.lateInputPolling, "Main", "LateInputPolling", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.adaptiveFrameSkip, "Display", "AdaptiveFrameSkip", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.skipUnchangedFrames, "Display", "SkipUnchangedFrames", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.skipUnchangedPresents, "Display", "SkipUnchangedPresents",
+                                               false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindEnable, "Main", "RewindEnable", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(sif, m_ui.rewindSaveFrequency, "Main", "RewindFrequency", 10.0f);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.rewindSaveSlots, "Main", "RewindSaveSlots", 10);
@@ -75,6 +80,8 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
   connect(m_ui.optimalFramePacing, &QCheckBox::checkStateChanged, this,
           &EmulationSettingsWidget::onOptimalFramePacingChanged);
   connect(m_ui.preFrameSleep, &QCheckBox::checkStateChanged, this, &EmulationSettingsWidget::onPreFrameSleepChanged);
+  connect(m_ui.skipUnchangedFrames, &QCheckBox::checkStateChanged, this,
+          &EmulationSettingsWidget::onSkipUnchangedFramesChanged);
 
   connect(m_ui.rewindEnable, &QCheckBox::checkStateChanged, this, &EmulationSettingsWidget::updateRewind);
   connect(m_ui.rewindSaveFrequency, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
@@ -121,6 +128,26 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsWindow* dialog, QWidget
                              tr("Specifies the amount of buffer time added, which reduces the additional sleep time "
                                 "introduced. Higher values increase input latency, but decrease the risk of overrun, "
                                 "or missed frames. Lower values require faster hardware."));
+  dialog->registerWidgetHelp(
+    m_ui.lateInputPolling, tr("Late Input Polling"), tr("Unchecked"),
+    tr("Polls controllers again when the game reads them, instead of only once at the start of each frame. This can "
+       "reduce input latency by up to a frame, with a small CPU cost. Has no effect when runahead is enabled."));
+  dialog->registerWidgetHelp(
+    m_ui.adaptiveFrameSkip, tr("Adaptive Frame Skip"), tr("Unchecked"),
+    tr("Skips displaying frames when the host can't keep up with the target speed, based on how long recent frames "
+       "took to emulate and present. Skipped frames are still emulated, but are not copied out of VRAM, "
+       "post-processed, or presented. At most three frames in a row are skipped."));
+  dialog->registerWidgetHelp(
+    m_ui.skipUnchangedFrames, tr("Reuse Unchanged Frames"), tr("Unchecked"),
+    tr("Detects when the game displays the same image as the previous frame, such as on menus or pause screens, and "
+       "reuses the previous frame instead of copying it out of VRAM and post-processing it again. Reduces power usage, "
+       "but post-processing shaders which animate over time will pause while the image is unchanged. Only applies to "
+       "the hardware renderers."));
+  dialog->registerWidgetHelp(
+    m_ui.skipUnchangedPresents, tr("Skip Presenting Unchanged Frames"), tr("Unchecked"),
+    tr("When Reuse Unchanged Frames and Optimal Frame Pacing are enabled, frames identical to the previous frame are "
+       "not presented at all, and the variable refresh display keeps showing the last image. On-screen messages and "
+       "statistics update less often while the image is unchanged."));
   dialog->registerWidgetHelp(
     m_ui.rewindEnable, tr("Rewinding"), tr("Unchecked"),
     tr("<b>Enable Rewinding:</b> Saves state periodically so you can rewind any mistakes while playing.<br> "
@@ -211,6 +238,14 @@ void EmulationSettingsWidget::onOptimalFramePacingChanged()
   const bool optimal_frame_pacing_enabled = m_dialog->getEffectiveBoolValue("Display", "OptimalFramePacing", false);
   m_ui.preFrameSleep->setEnabled(optimal_frame_pacing_enabled);
   onPreFrameSleepChanged();
+  onSkipUnchangedFramesChanged();
+}
+
+void EmulationSettingsWidget::onSkipUnchangedFramesChanged()
+{
+  const bool optimal_frame_pacing_enabled = m_dialog->getEffectiveBoolValue("Display", "OptimalFramePacing", false);
+  const bool skip_unchanged_frames = m_dialog->getEffectiveBoolValue("Display", "SkipUnchangedFrames", false);
+  m_ui.skipUnchangedPresents->setEnabled(optimal_frame_pacing_enabled && skip_unchanged_frames);
 }
 
 void EmulationSettingsWidget::onPreFrameSleepChanged()
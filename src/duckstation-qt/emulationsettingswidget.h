@@ -24,6 +24,7 @@ private Q_SLOTS:
   void onVSyncChanged();
   void onOptimalFramePacingChanged();
   void onPreFrameSleepChanged();
+  void onSkipUnchangedFramesChanged();
   void updateRewind();
 
 private:
@@ -3,20 +3,23 @@
 
 #include "gamelistmodel.h"
 #include "common/file_system.h"
+#include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "core/settings.h"
 #include "core/system.h"
 #include "qthost.h"
 #include "qtutils.h"
-#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDate>
 #include <QtCore/QDateTime>
-#include <QtCore/QFuture>
-#include <QtCore/QFutureWatcher>
+#include <QtCore/QTimer>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QIcon>
 #include <QtGui/QPainter>
 
+Log_SetChannel(GameListModel);
+
 static constexpr std::array<const char*, GameListModel::Column_Count> s_column_names = {
   {"Type", "Serial", "Title", "File Title", "Developer", "Publisher", "Genre", "Year", "Players", "Time Played",
    "Last Played", "Size", "File Size", "Region", "Compatibility", "Cover"}};
@@ -25,6 +28,7 @@ static constexpr int COVER_ART_WIDTH = 512;
 static constexpr int COVER_ART_HEIGHT = 512;
 static constexpr int COVER_ART_SPACING = 32;
 static constexpr int MIN_COVER_CACHE_SIZE = 256;
+static constexpr int COVER_UPDATE_INTERVAL_MS = 16;
 
 static int DPRScale(int size, float dpr)
 {
@@ -36,53 +40,52 @@ static int DPRUnscale(int size, float dpr)
   return static_cast<int>(static_cast<float>(size) / dpr);
 }
 
-static void resizeAndPadPixmap(QPixmap* pm, int expected_width, int expected_height, float dpr)
+static void resizeAndPadImage(QImage* image, int expected_width, int expected_height, float dpr)
 {
   const int dpr_expected_width = DPRScale(expected_width, dpr);
   const int dpr_expected_height = DPRScale(expected_height, dpr);
-  if (pm->width() == dpr_expected_width && pm->height() == dpr_expected_height)
+  if (image->width() == dpr_expected_width && image->height() == dpr_expected_height)
     return;
 
-  *pm = pm->scaled(dpr_expected_width, dpr_expected_height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-  if (pm->width() == dpr_expected_width && pm->height() == dpr_expected_height)
+  *image = image->scaled(dpr_expected_width, dpr_expected_height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  if (image->width() == dpr_expected_width && image->height() == dpr_expected_height)
     return;
 
   // QPainter works in unscaled coordinates.
   int xoffs = 0;
   int yoffs = 0;
-  if (pm->width() < dpr_expected_width)
-    xoffs = DPRUnscale((dpr_expected_width - pm->width()) / 2, dpr);
-  if (pm->height() < dpr_expected_height)
-    yoffs = DPRUnscale((dpr_expected_height - pm->height()) / 2, dpr);
+  if (image->width() < dpr_expected_width)
+    xoffs = DPRUnscale((dpr_expected_width - image->width()) / 2, dpr);
+  if (image->height() < dpr_expected_height)
+    yoffs = DPRUnscale((dpr_expected_height - image->height()) / 2, dpr);
 
-  QPixmap padded_image(dpr_expected_width, dpr_expected_height);
+  QImage padded_image(dpr_expected_width, dpr_expected_height, QImage::Format_ARGB32_Premultiplied);
   padded_image.setDevicePixelRatio(dpr);
   padded_image.fill(Qt::transparent);
   QPainter painter;
   if (painter.begin(&padded_image))
   {
     painter.setCompositionMode(QPainter::CompositionMode_Source);
-    painter.drawPixmap(xoffs, yoffs, *pm);
+    painter.drawImage(xoffs, yoffs, *image);
     painter.setCompositionMode(QPainter::CompositionMode_Destination);
     painter.fillRect(padded_image.rect(), QColor(0, 0, 0, 0));
     painter.end();
   }
 
-  *pm = padded_image;
+  *image = padded_image;
 }
 
-static QPixmap createPlaceholderImage(const QPixmap& placeholder_pixmap, int width, int height, float scale,
-                                      const std::string& title)
+static QImage createPlaceholderImage(const QImage& placeholder_image, int width, int height, float scale, float dpr,
+                                     const std::string& title)
 {
-  const float dpr = qApp->devicePixelRatio();
-  QPixmap pm(placeholder_pixmap.copy());
-  pm.setDevicePixelRatio(dpr);
-  if (pm.isNull())
-    return QPixmap();
+  QImage image(placeholder_image.copy());
+  image.setDevicePixelRatio(dpr);
+  if (image.isNull())
+    return QImage();
 
-  resizeAndPadPixmap(&pm, width, height, dpr);
+  resizeAndPadImage(&image, width, height, dpr);
   QPainter painter;
-  if (painter.begin(&pm))
+  if (painter.begin(&image))
   {
     QFont font;
     font.setPointSize(std::max(static_cast<int>(32.0f * scale), 1));
@@ -95,7 +98,50 @@ static QPixmap createPlaceholderImage(const QPixmap& placeholder_pixmap, int wid
     painter.end();
   }
 
-  return pm;
+  return image;
+}
+
+static std::string getCoverThumbnailPath(const std::string& cover_path, int width, int height, float dpr)
+{
+  const QByteArray key = QStringLiteral("%1|%2x%3@%4")
+                           .arg(QString::fromStdString(cover_path))
+                           .arg(width)
+                           .arg(height)
+                           .arg(dpr)
+                           .toUtf8();
+  const QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+  return Path::Combine(EmuFolders::Cache, fmt::format("thumbnails" FS_OSPATH_SEPARATOR_STR "{}.png",
+                                                      std::string_view(hash.constData(), hash.size())));
+}
+
+static QImage loadCoverThumbnail(const std::string& cover_path, int width, int height, float dpr)
+{
+  FILESYSTEM_STAT_DATA cover_sd;
+  if (!FileSystem::StatFile(cover_path.c_str(), &cover_sd))
+    return QImage();
+
+  // Thumbnails which are older than the cover are from a cover that's since been replaced.
+  const std::string thumbnail_path = getCoverThumbnailPath(cover_path, width, height, dpr);
+  FILESYSTEM_STAT_DATA thumbnail_sd;
+  QImage image;
+  if (FileSystem::StatFile(thumbnail_path.c_str(), &thumbnail_sd) &&
+      thumbnail_sd.ModificationTime >= cover_sd.ModificationTime &&
+      image.load(QString::fromStdString(thumbnail_path)) && image.width() == DPRScale(width, dpr) &&
+      image.height() == DPRScale(height, dpr))
+  {
+    image.setDevicePixelRatio(dpr);
+    return image;
+  }
+
+  if (!image.load(QString::fromStdString(cover_path)))
+    return QImage();
+
+  image.setDevicePixelRatio(dpr);
+  resizeAndPadImage(&image, width, height, dpr);
+  if (!image.save(QString::fromStdString(thumbnail_path), "PNG"))
+    Log_WarningFmt("Failed to save cover thumbnail '{}'", thumbnail_path);
+
+  return image;
 }
 
 std::optional<GameListModel::Column> GameListModel::getColumnIdForName(std::string_view name)
@@ -120,15 +166,26 @@ GameListModel::GameListModel(float cover_scale, bool show_cover_titles, QObject*
   loadCommonImages();
   setCoverScale(cover_scale);
   setColumnDisplayNames();
+
+  FileSystem::EnsureDirectoryExists(Path::Combine(EmuFolders::Cache, "thumbnails").c_str(), false);
+
+  // Pick up anything which was loaded from the cache before we were created.
+  refresh();
+}
+
+GameListModel::~GameListModel()
+{
+  // Results are delivered to this object, so nothing can be left running.
+  m_cover_thread_pool.clear();
+  m_cover_thread_pool.waitForDone();
 }
-GameListModel::~GameListModel() = default;
 
 void GameListModel::setCoverScale(float scale)
 {
   if (m_cover_scale == scale)
     return;
 
-  m_cover_pixmap_cache.Clear();
+  cancelCoverLoads();
   m_cover_scale = scale;
   m_loading_pixmap = QPixmap(getCoverArtWidth(), getCoverArtHeight());
   m_loading_pixmap.fill(QColor(0, 0, 0, 0));
@@ -138,8 +195,16 @@ void GameListModel::setCoverScale(float scale)
 
 void GameListModel::refreshCovers()
 {
+  cancelCoverLoads();
+  invalidate();
+}
+
+void GameListModel::cancelCoverLoads()
+{
+  // Anything still in flight was for the old covers or scale, so drop it when it arrives.
+  m_cover_thread_pool.clear();
+  m_cover_generation++;
   m_cover_pixmap_cache.Clear();
-  refresh();
 }
 
 void GameListModel::updateCacheSize(int width, int height)
@@ -155,62 +220,52 @@ void GameListModel::updateCacheSize(int width, int height)
 void GameListModel::reloadThemeSpecificImages()
 {
   loadThemeSpecificImages();
-  refresh();
+  invalidate();
 }
 
 void GameListModel::loadOrGenerateCover(const GameList::Entry* ge)
 {
-  QFuture<QPixmap> future =
-    QtConcurrent::run([this, path = ge->path, title = ge->title, serial = ge->serial]() -> QPixmap {
-      QPixmap image;
+  // Newer requests are for the rows which are on screen now, so they go ahead of anything scrolled past.
+  const int width = getCoverArtWidth();
+  const int height = getCoverArtHeight();
+  const float dpr = qApp->devicePixelRatio();
+  m_cover_thread_pool.start(
+    [this, path = ge->path, title = ge->title, serial = ge->serial, placeholder = m_placeholder_image, width, height,
+     dpr, scale = m_cover_scale, generation = m_cover_generation]() {
+      QImage image;
       const std::string cover_path(GameList::GetCoverImagePath(path, serial, title));
       if (!cover_path.empty())
-      {
-        const float dpr = qApp->devicePixelRatio();
-        image = QPixmap(QString::fromStdString(cover_path));
-        if (!image.isNull())
-        {
-          image.setDevicePixelRatio(dpr);
-          resizeAndPadPixmap(&image, getCoverArtWidth(), getCoverArtHeight(), dpr);
-        }
-      }
-
+        image = loadCoverThumbnail(cover_path, width, height, dpr);
       if (image.isNull())
-        image =
-          createPlaceholderImage(m_placeholder_pixmap, getCoverArtWidth(), getCoverArtHeight(), m_cover_scale, title);
-
-      return image;
-    });
-
-  // Context must be 'this' so we run on the UI thread.
-  future.then(this, [this, path = ge->path](QPixmap pm) {
-    m_cover_pixmap_cache.Insert(std::move(path), std::move(pm));
-    invalidateCoverForPath(path);
-  });
+        image = createPlaceholderImage(placeholder, width, height, scale, dpr, title);
+
+      QMetaObject::invokeMethod(
+        this,
+        [this, path, image = std::move(image), generation]() mutable {
+          if (generation != m_cover_generation)
+            return;
+
+          m_cover_pixmap_cache.Insert(std::move(path), QPixmap::fromImage(std::move(image)));
+          queueCoverUpdate();
+        },
+        Qt::QueuedConnection);
+    },
+    ++m_cover_request_priority);
 }
 
-void GameListModel::invalidateCoverForPath(const std::string& path)
+void GameListModel::queueCoverUpdate()
 {
-  // This isn't ideal, but not sure how else we can get the row, when it might change while scanning...
-  auto lock = GameList::GetLock();
-  const u32 count = GameList::GetEntryCount();
-  std::optional<u32> row;
-  for (u32 i = 0; i < count; i++)
-  {
-    if (GameList::GetEntryByIndex(i)->path == path)
-    {
-      row = i;
-      break;
-    }
-  }
-  if (!row.has_value())
-  {
-    // Game removed?
+  // Covers arrive in bursts while scrolling, so repaint at most once a frame.
+  if (m_cover_update_queued)
     return;
-  }
 
-  const QModelIndex mi(index(static_cast<int>(row.value()), Column_Cover));
-  emit dataChanged(mi, mi, {Qt::DecorationRole});
+  m_cover_update_queued = true;
+  QTimer::singleShot(COVER_UPDATE_INTERVAL_MS, this, [this]() {
+    m_cover_update_queued = false;
+    const int rows = rowCount();
+    if (rows > 0)
+      emit dataChanged(index(0, Column_Cover), index(rows - 1, Column_Cover), {Qt::DecorationRole});
+  });
 }
 
 QString GameListModel::formatTimespan(time_t timespan)
@@ -244,7 +299,7 @@ int GameListModel::rowCount(const QModelIndex& parent) const
   if (parent.isValid())
     return 0;
 
-  return static_cast<int>(GameList::GetEntryCount());
+  return static_cast<int>(m_rows.size());
 }
 
 int GameListModel::columnCount(const QModelIndex& parent) const
@@ -261,13 +316,10 @@ QVariant GameListModel::data(const QModelIndex& index, int role) const
     return {};
 
   const int row = index.row();
-  if (row < 0 || row >= static_cast<int>(GameList::GetEntryCount()))
+  if (row < 0 || row >= static_cast<int>(m_rows.size()))
     return {};
 
-  const auto lock = GameList::GetLock();
-  const GameList::Entry* ge = GameList::GetEntryByIndex(row);
-  if (!ge)
-    return {};
+  const GameList::Entry* ge = &m_rows[row].entry;
 
   switch (role)
   {
@@ -453,22 +505,131 @@ QVariant GameListModel::headerData(int section, Qt::Orientation orientation, int
 }
 
 void GameListModel::refresh()
+{
+  // Only entries which are new or have changed are copied while the lock is held. The views are notified after it's
+  // released, since they call back into data() and can take a while with large lists.
+  std::vector<std::pair<size_t, GameList::Entry>> changed_entries;
+  std::vector<GameList::Entry> added_entries;
+  std::vector<bool> row_present(m_rows.size(), false);
+  {
+    const auto lock = GameList::GetLock();
+    const u32 count = GameList::GetEntryCount();
+    for (u32 i = 0; i < count; i++)
+    {
+      const GameList::Entry* ge = GameList::GetEntryByIndex(i);
+      const auto iter = m_row_indices.find(ge->path);
+      if (iter == m_row_indices.end())
+      {
+        added_entries.push_back(*ge);
+        continue;
+      }
+
+      row_present[iter->second] = true;
+      if (!(m_rows[iter->second].entry == *ge))
+        changed_entries.emplace_back(iter->second, *ge);
+    }
+  }
+
+  // Updates go first, the removals below would shift the row numbers.
+  for (auto& [row, entry] : changed_entries)
+  {
+    // Title may have changed, which is drawn into the placeholder cover.
+    m_cover_pixmap_cache.Remove(entry.path);
+
+    m_rows[row].entry = std::move(entry);
+    updateSortKeys(m_rows[row]);
+    emit dataChanged(index(static_cast<int>(row), 0), index(static_cast<int>(row), Column_Count - 1));
+  }
+
+  // Remove from the back in contiguous ranges, so the earlier row numbers stay valid.
+  bool rows_moved = !added_entries.empty();
+  for (size_t end = m_rows.size(); end > 0;)
+  {
+    if (row_present[end - 1])
+    {
+      end--;
+      continue;
+    }
+
+    size_t start = end - 1;
+    while (start > 0 && !row_present[start - 1])
+      start--;
+
+    beginRemoveRows(QModelIndex(), static_cast<int>(start), static_cast<int>(end - 1));
+    m_rows.erase(m_rows.begin() + start, m_rows.begin() + end);
+    endRemoveRows();
+
+    rows_moved = true;
+    end = start;
+  }
+
+  if (!added_entries.empty())
+  {
+    const int first_row = static_cast<int>(m_rows.size());
+    beginInsertRows(QModelIndex(), first_row, first_row + static_cast<int>(added_entries.size()) - 1);
+    m_rows.reserve(m_rows.size() + added_entries.size());
+    for (GameList::Entry& entry : added_entries)
+    {
+      Row& row = m_rows.emplace_back();
+      row.entry = std::move(entry);
+      updateSortKeys(row);
+    }
+    endInsertRows();
+  }
+
+  if (rows_moved)
+  {
+    m_row_indices.clear();
+    for (size_t i = 0; i < m_rows.size(); i++)
+      m_row_indices.emplace(m_rows[i].entry.path, i);
+  }
+
+  if (!changed_entries.empty() || rows_moved)
+  {
+    Log_DevFmt("Game list model: {} updated, {} added, {} rows total", changed_entries.size(), added_entries.size(),
+               m_rows.size());
+  }
+}
+
+void GameListModel::invalidate()
 {
   beginResetModel();
   endResetModel();
 }
 
+const GameList::Entry* GameListModel::getEntry(int row) const
+{
+  if (row < 0 || row >= static_cast<int>(m_rows.size()))
+    return nullptr;
+
+  return &m_rows[row].entry;
+}
+
+void GameListModel::updateSortKeys(Row& row)
+{
+  static constexpr auto fold = [](std::string_view str) {
+    std::string ret(str);
+    for (char& ch : ret)
+    {
+      if (ch >= 'A' && ch <= 'Z')
+        ch = static_cast<char>(ch + ('a' - 'A'));
+    }
+    return ret;
+  };
+
+  row.sort_title = fold(row.entry.title);
+  row.sort_file_title = fold(Path::GetFileTitle(row.entry.path));
+}
+
 bool GameListModel::titlesLessThan(int left_row, int right_row) const
 {
-  if (left_row < 0 || left_row >= static_cast<int>(GameList::GetEntryCount()) || right_row < 0 ||
-      right_row >= static_cast<int>(GameList::GetEntryCount()))
+  if (left_row < 0 || left_row >= static_cast<int>(m_rows.size()) || right_row < 0 ||
+      right_row >= static_cast<int>(m_rows.size()))
   {
     return false;
   }
 
-  const GameList::Entry* left = GameList::GetEntryByIndex(left_row);
-  const GameList::Entry* right = GameList::GetEntryByIndex(right_row);
-  return (StringUtil::Strcasecmp(left->title.c_str(), right->title.c_str()) < 0);
+  return (m_rows[left_row].sort_title < m_rows[right_row].sort_title);
 }
 
 bool GameListModel::lessThan(const QModelIndex& left_index, const QModelIndex& right_index, int column) const
@@ -478,17 +639,14 @@ bool GameListModel::lessThan(const QModelIndex& left_index, const QModelIndex& r
 
   const int left_row = left_index.row();
   const int right_row = right_index.row();
-  if (left_row < 0 || left_row >= static_cast<int>(GameList::GetEntryCount()) || right_row < 0 ||
-      right_row >= static_cast<int>(GameList::GetEntryCount()))
+  if (left_row < 0 || left_row >= static_cast<int>(m_rows.size()) || right_row < 0 ||
+      right_row >= static_cast<int>(m_rows.size()))
   {
     return false;
   }
 
-  const auto lock = GameList::GetLock();
-  const GameList::Entry* left = GameList::GetEntryByIndex(left_row);
-  const GameList::Entry* right = GameList::GetEntryByIndex(right_row);
-  if (!left || !right)
-    return false;
+  const GameList::Entry* left = &m_rows[left_row].entry;
+  const GameList::Entry* right = &m_rows[right_row].entry;
 
   switch (column)
   {
@@ -514,13 +672,12 @@ bool GameListModel::lessThan(const QModelIndex& left_index, const QModelIndex& r
 
     case Column_FileTitle:
     {
-      const std::string_view file_title_left(Path::GetFileTitle(left->path));
-      const std::string_view file_title_right(Path::GetFileTitle(right->path));
+      const std::string& file_title_left = m_rows[left_row].sort_file_title;
+      const std::string& file_title_right = m_rows[right_row].sort_file_title;
       if (file_title_left == file_title_right)
         return titlesLessThan(left_row, right_row);
 
-      const std::size_t smallest = std::min(file_title_left.size(), file_title_right.size());
-      return (StringUtil::Strncasecmp(file_title_left.data(), file_title_right.data(), smallest) < 0);
+      return (file_title_left < file_title_right);
     }
 
     case Column_Region:
@@ -633,7 +790,7 @@ void GameListModel::loadCommonImages()
       QtUtils::GetIconForCompatibility(static_cast<GameDatabase::CompatibilityRating>(i)).pixmap(96, 24);
   }
 
-  m_placeholder_pixmap.load(QStringLiteral("%1/images/cover-placeholder.png").arg(QtHost::GetResourcesBasePath()));
+  m_placeholder_image.load(QStringLiteral("%1/images/cover-placeholder.png").arg(QtHost::GetResourcesBasePath()));
 }
 
 void GameListModel::setColumnDisplayNames()
@@ -11,10 +11,14 @@
 #include "common/lru_cache.h"
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
 #include <QtGui/QPixmap>
 #include <algorithm>
 #include <array>
 #include <optional>
+#include <string>
+#include <vector>
 
 class GameListModel final : public QAbstractTableModel
 {
@@ -56,9 +60,17 @@ public:
 
   ALWAYS_INLINE const QString& getColumnDisplayName(int column) { return m_column_display_names[column]; }
 
+  /// Brings the rows up to date with the game list, inserting, removing and updating only what changed.
   void refresh();
+
+  /// Repaints every row without re-reading the game list, for when only the presentation changed.
+  void invalidate();
+
   void reloadThemeSpecificImages();
 
+  /// Returns the model's copy of the entry for a row. Only valid until the next refresh().
+  const GameList::Entry* getEntry(int row) const;
+
   bool titlesLessThan(int left_row, int right_row) const;
 
   bool lessThan(const QModelIndex& left_index, const QModelIndex& right_index, int column) const;
@@ -78,11 +90,23 @@ Q_SIGNALS:
   void coverScaleChanged();
 
 private:
+  struct Row
+  {
+    GameList::Entry entry;
+
+    // Lower-cased, so sorting doesn't need case-insensitive comparisons.
+    std::string sort_title;
+    std::string sort_file_title;
+  };
+
+  static void updateSortKeys(Row& row);
+
   void loadCommonImages();
   void loadThemeSpecificImages();
   void setColumnDisplayNames();
   void loadOrGenerateCover(const GameList::Entry* ge);
-  void invalidateCoverForPath(const std::string& path);
+  void cancelCoverLoads();
+  void queueCoverUpdate();
 
   static QString formatTimespan(time_t timespan);
 
@@ -94,8 +118,18 @@ private:
   std::array<QPixmap, static_cast<int>(DiscRegion::Count)> m_region_pixmaps;
   std::array<QPixmap, static_cast<int>(GameDatabase::CompatibilityRating::Count)> m_compatibility_pixmaps;
 
-  QPixmap m_placeholder_pixmap;
+  // Snapshot of the game list, so the views never need to take the game list lock.
+  std::vector<Row> m_rows;
+  PreferUnorderedStringMap<size_t> m_row_indices;
+
+  QImage m_placeholder_image;
   QPixmap m_loading_pixmap;
 
   mutable LRUCache<std::string, QPixmap> m_cover_pixmap_cache;
+
+  // Covers are decoded and scaled on these threads, and the scaled images are kept in the cache directory.
+  QThreadPool m_cover_thread_pool;
+  u32 m_cover_generation = 0;
+  int m_cover_request_priority = 0;
+  bool m_cover_update_queued = false;
 };
\ No newline at end of file
@@ -64,8 +64,9 @@ public:
 
   bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override
   {
-    const auto lock = GameList::GetLock();
-    const GameList::Entry* entry = GameList::GetEntryByIndex(source_row);
+    const GameList::Entry* entry = m_model->getEntry(source_row);
+    if (!entry)
+      return false;
 
     if (m_merge_disc_sets)
     {
@@ -107,7 +108,11 @@ GameListWidget::GameListWidget(QWidget* parent /* = nullptr */) : QWidget(parent
 {
 }
 
-GameListWidget::~GameListWidget() = default;
+GameListWidget::~GameListWidget()
+{
+  GameList::CancelDeferredHashing();
+  GameList::StopDirectoryWatcher();
+}
 
 void GameListWidget::initialize()
 {
@@ -288,12 +293,30 @@ void GameListWidget::onRefreshComplete()
   // if we still had no games, switch to the helper widget
   if (m_model->rowCount() == 0)
     m_ui.stack->setCurrentIndex(2);
+
+  // pick up changes from here on without needing another full refresh
+  GameList::StartDirectoryWatcher(
+    [this]() { QMetaObject::invokeMethod(this, &GameListWidget::onDirectoryWatcherChanged, Qt::QueuedConnection); });
+}
+
+void GameListWidget::onDirectoryWatcherChanged()
+{
+  // a full refresh will update the model itself
+  if (m_refresh_thread)
+    return;
+
+  m_model->refresh();
+
+  if (m_model->rowCount() == 0)
+    m_ui.stack->setCurrentIndex(2);
+  else if (m_ui.stack->currentIndex() == 2)
+    m_ui.stack->setCurrentIndex(Host::GetBaseBoolSettingValue("UI", "GameListGridView", false) ? 1 : 0);
 }
 
 void GameListWidget::onSelectionModelCurrentChanged(const QModelIndex& current, const QModelIndex& previous)
 {
   const QModelIndex source_index = m_sort_model->mapToSource(current);
-  if (!source_index.isValid() || source_index.row() >= static_cast<int>(GameList::GetEntryCount()))
+  if (!source_index.isValid() || source_index.row() >= m_model->rowCount())
     return;
 
   emit selectionChanged();
@@ -302,7 +325,7 @@ void GameListWidget::onSelectionModelCurrentChanged(const QModelIndex& current,
 void GameListWidget::onTableViewItemActivated(const QModelIndex& index)
 {
   const QModelIndex source_index = m_sort_model->mapToSource(index);
-  if (!source_index.isValid() || source_index.row() >= static_cast<int>(GameList::GetEntryCount()))
+  if (!source_index.isValid() || source_index.row() >= m_model->rowCount())
     return;
 
   emit entryActivated();
@@ -316,7 +339,7 @@ void GameListWidget::onTableViewContextMenuRequested(const QPoint& point)
 void GameListWidget::onListViewItemActivated(const QModelIndex& index)
 {
   const QModelIndex source_index = m_sort_model->mapToSource(index);
-  if (!source_index.isValid() || source_index.row() >= static_cast<int>(GameList::GetEntryCount()))
+  if (!source_index.isValid() || source_index.row() >= m_model->rowCount())
     return;
 
   emit entryActivated();
@@ -373,7 +396,7 @@ void GameListWidget::listZoom(float delta)
   m_model->setCoverScale(new_scale);
   updateToolbar();
 
-  m_model->refresh();
+  m_model->invalidate();
 }
 
 void GameListWidget::gridZoomIn()
@@ -395,7 +418,7 @@ void GameListWidget::gridIntScale(int int_scale)
   m_model->setCoverScale(new_scale);
   updateToolbar();
 
-  m_model->refresh();
+  m_model->invalidate();
 }
 
 void GameListWidget::refreshGridCovers()
@@ -446,7 +469,7 @@ void GameListWidget::setShowCoverTitles(bool enabled)
   Host::CommitBaseSettingChanges();
   m_model->setShowCoverTitles(enabled);
   if (isShowingGameGrid())
-    m_model->refresh();
+    m_model->invalidate();
   updateToolbar();
   emit layoutChange();
 }
@@ -615,7 +638,8 @@ const GameList::Entry* GameListWidget::getSelectedEntry() const
     if (!source_index.isValid())
       return nullptr;
 
-    return GameList::GetEntryByIndex(source_index.row());
+    const GameList::Entry* entry = m_model->getEntry(source_index.row());
+    return entry ? GameList::GetEntryForPath(entry->path) : nullptr;
   }
   else
   {
@@ -627,7 +651,8 @@ const GameList::Entry* GameListWidget::getSelectedEntry() const
     if (!source_index.isValid())
       return nullptr;
 
-    return GameList::GetEntryByIndex(source_index.row());
+    const GameList::Entry* entry = m_model->getEntry(source_index.row());
+    return entry ? GameList::GetEntryForPath(entry->path) : nullptr;
   }
 }
 
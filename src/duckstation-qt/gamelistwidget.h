@@ -52,6 +52,7 @@ public:
   bool isShowingGameGrid() const;
   bool getShowGridCoverTitles() const;
 
+  /// Returns the game list entry for the selection. The caller must hold the game list lock.
   const GameList::Entry* getSelectedEntry() const;
 
 Q_SIGNALS:
@@ -68,6 +69,7 @@ Q_SIGNALS:
 private Q_SLOTS:
   void onRefreshProgress(const QString& status, int current, int total);
   void onRefreshComplete();
+  void onDirectoryWatcherChanged();
 
   void onSelectionModelCurrentChanged(const QModelIndex& current, const QModelIndex& previous);
   void onTableViewItemActivated(const QModelIndex& index);
@@ -255,9 +255,22 @@ void GameSummaryWidget::onComputeHashClicked()
   std::vector<CDImageHasher::Hash> track_hashes;
   track_hashes.reserve(image->GetTrackCount());
 
-  // Calculate hashes
+  // Hashes from an earlier run can be reused if the file hasn't changed since.
   bool calculate_hash_success = true;
-  for (u8 track = 1; track <= image->GetTrackCount(); track++)
+  const bool hashes_cached =
+    (GameList::GetCachedTrackHashes(m_path, &track_hashes) && track_hashes.size() == image->GetTrackCount());
+  if (hashes_cached)
+  {
+    for (u32 i = 0; i < track_hashes.size(); i++)
+      m_ui.tracks->item(i, 4)->setText(QString::fromStdString(CDImageHasher::HashToString(track_hashes[i])));
+  }
+  else
+  {
+    track_hashes.clear();
+  }
+
+  // Calculate hashes
+  for (u8 track = 1; !hashes_cached && track <= image->GetTrackCount(); track++)
   {
     progress_callback.SetProgressValue(track - 1);
     progress_callback.PushState();
@@ -277,6 +290,9 @@ void GameSummaryWidget::onComputeHashClicked()
     progress_callback.PopState();
   }
 
+  if (calculate_hash_success && !hashes_cached)
+    GameList::AddCachedTrackHashes(m_path, track_hashes);
+
   // Verify hashes against gamedb
   std::vector<bool> verification_results(image->GetTrackCount(), false);
   if (calculate_hash_success)
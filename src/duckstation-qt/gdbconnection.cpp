@@ -37,7 +37,7 @@ void GDBConnection::gotDisconnected()
 void GDBConnection::receivedData()
 {
   qint64 bytesRead;
-  char buffer[256];
+  char buffer[16384];
 
   while ((bytesRead = read(buffer, sizeof(buffer))) > 0)
   {
@@ -60,7 +60,7 @@ void GDBConnection::receivedData()
       else if (GDBProtocol::IsPacketComplete(m_readBuffer))
       {
         Log_DebugPrintf("(%" PRIdPTR ") > %s", m_descriptor, m_readBuffer.c_str());
-        writePacket(GDBProtocol::ProcessPacket(m_readBuffer));
+        queuePacket(GDBProtocol::ProcessPacket(m_readBuffer));
         m_readBuffer.erase();
       }
     }
@@ -70,6 +70,9 @@ void GDBConnection::receivedData()
     Log_ErrorPrintf("(%" PRIdPTR ") Failed to read from socket: %s", m_descriptor,
                     errorString().toUtf8().constData());
   }
+
+  // GDB often sends several requests at once, so reply to all of them with a single write.
+  flushPackets();
 }
 
 void GDBConnection::onEmulationPaused()
@@ -90,11 +93,27 @@ void GDBConnection::onEmulationResumed()
 }
 
 void GDBConnection::writePacket(std::string_view packet)
+{
+  queuePacket(packet);
+  flushPackets();
+}
+
+void GDBConnection::queuePacket(std::string_view packet)
 {
   Log_DebugPrintf("(%" PRIdPTR ") < %.*s", m_descriptor, static_cast<int>(packet.length()), packet.data());
-  if (write(packet.data(), packet.length()) == -1)
+  m_writeBuffer.append(packet);
+}
+
+void GDBConnection::flushPackets()
+{
+  if (m_writeBuffer.empty())
+    return;
+
+  if (write(m_writeBuffer.data(), m_writeBuffer.length()) == -1)
   {
     Log_ErrorPrintf("(%" PRIdPTR ") Failed to write to socket: %s", m_descriptor,
                     errorString().toUtf8().constData());
   }
+
+  m_writeBuffer.clear();
 }
@@ -22,8 +22,11 @@ public Q_SLOTS:
 
 private:
   void writePacket(std::string_view data);
+  void queuePacket(std::string_view data);
+  void flushPackets();
 
   intptr_t m_descriptor;
   std::string m_readBuffer;
+  std::string m_writeBuffer;
   bool m_seen_resume;
 };
@@ -126,7 +126,12 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.displayFPSLimit, "Display", "MaxFPS",
                                               Settings::DEFAULT_DISPLAY_MAX_FPS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.gpuThread, "GPU", "UseThread", true);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.gpuSWRasterizerThreads, "GPU", "SoftwareRasterizerThreads",
+                                              Settings::DEFAULT_GPU_SW_RASTERIZER_THREADS);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.gpuSWRasterizerJIT, "GPU", "SoftwareRasterizerJIT", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.threadedPresentation, "GPU", "ThreadedPresentation", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.nonBlockingPresentation, "GPU", "NonBlockingPresentation",
+                                               false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.stretchDisplayVertically, "Display", "StretchVertically",
                                                false);
 #ifdef _WIN32
@@ -142,6 +147,12 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.scaledDithering, "GPU", "ScaledDithering", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useSoftwareRendererForReadbacks, "GPU",
                                                "UseSoftwareRendererForReadbacks", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.batchMixedTextureModes, "GPU", "BatchMixedTextureModes",
+                                               false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.deferPipelineCompilation, "GPU", "DeferPipelineCompilation",
+                                               false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.textureFilterCache, "GPU", "TextureFilterCache", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.dynamicResolution, "GPU", "DynamicResolution", false);
 
   connect(m_ui.fullscreenMode, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           &GraphicsSettingsWidget::onFullscreenModeChanged);
@@ -190,6 +201,13 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
     &Settings::GetDisplayScreenshotFormatName, Settings::DEFAULT_DISPLAY_SCREENSHOT_FORMAT);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.screenshotQuality, "Display", "ScreenshotQuality",
                                               Settings::DEFAULT_DISPLAY_SCREENSHOT_QUALITY);
+  SettingWidgetBinder::BindWidgetToEnumSetting(sif, m_ui.mediaCaptureEncoder, "MediaCapture", "Encoder",
+                                               &MediaCapture::ParseEncoderName, &MediaCapture::GetEncoderName,
+                                               Settings::DEFAULT_MEDIA_CAPTURE_ENCODER);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.mediaCaptureVideoBitrate, "MediaCapture", "VideoBitrate",
+                                              Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.mediaCaptureInternalResolution, "MediaCapture",
+                                               "InternalResolution", false);
 
   // Texture Replacements Tab
 
@@ -197,6 +215,8 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
                                                "EnableVRAMWriteReplacements", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.preloadTextureReplacements, "TextureReplacements",
                                                "PreloadTextures", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.textureReplacementCacheSize, "TextureReplacements",
+                                              "MaxCacheSizeMB", Settings::DEFAULT_TEXTURE_REPLACEMENT_CACHE_SIZE_MB);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useOldMDECRoutines, "Hacks", "UseOldMDECRoutines", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.vramWriteDumping, "TextureReplacements", "DumpVRAMWrites",
                                                false);
@@ -216,6 +236,7 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
 
   // Debugging Tab
 
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.sparseVRAM, "GPU", "SparseVRAM", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useDebugDevice, "GPU", "UseDebugDevice", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.disableShaderCache, "GPU", "DisableShaderCache", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.disableDualSource, "GPU", "DisableDualSourceBlend", false);
@@ -337,9 +358,22 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   dialog->registerWidgetHelp(m_ui.gpuThread, tr("Threaded Rendering"), tr("Checked"),
                              tr("Uses a second thread for drawing graphics. Currently only available for the software "
                                 "renderer, but can provide a significant speed improvement, and is safe to use."));
+  dialog->registerWidgetHelp(
+    m_ui.gpuSWRasterizerThreads, tr("Software Rasterizer Threads"), tr("1"),
+    tr("Splits the screen into horizontal bands which are drawn in parallel by the software renderer. Results are "
+       "identical to a single thread. Set this to the number of free CPU cores for the best performance."));
+  dialog->registerWidgetHelp(
+    m_ui.gpuSWRasterizerJIT, tr("Recompile Software Rasterizer"), tr("Unchecked"),
+    tr("Generates machine code for each combination of drawing state used by the software renderer, instead of "
+       "selecting between them for every pixel. Results are identical. Only available on x86-64."));
   dialog->registerWidgetHelp(m_ui.threadedPresentation, tr("Threaded Presentation"), tr("Checked"),
                              tr("Presents frames on a background thread when fast forwarding or vsync is disabled. "
                                 "This can measurably improve performance in the Vulkan renderer."));
+  dialog->registerWidgetHelp(
+    m_ui.nonBlockingPresentation, tr("Non-Blocking Presentation"), tr("Unchecked"),
+    tr("With vsync enabled, presents on the background thread too, and drops frames which are ready while the "
+       "previous frame is still waiting to be displayed, instead of blocking emulation. Has no effect when syncing to "
+       "the host refresh rate. Requires threaded presentation."));
   dialog->registerWidgetHelp(
     m_ui.stretchDisplayVertically, tr("Stretch Vertically"), tr("Unchecked"),
     tr("Prefers stretching the display vertically instead of horizontally, when applying the display aspect ratio."));
@@ -372,6 +406,28 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
     m_ui.useSoftwareRendererForReadbacks, tr("Software Renderer Readbacks"), tr("Unchecked"),
     tr("Runs the software renderer in parallel for VRAM readbacks. On some systems, this may result in greater "
        "performance when using graphical enhancements with the hardware renderer."));
+  dialog->registerWidgetHelp(
+    m_ui.batchMixedTextureModes, tr("Batch Mixed Texture Modes"), tr("Unchecked"),
+    tr("Allows primitives with different texture modes (4-bit, 8-bit, 16-bit and raw) and dithering to be drawn "
+       "together, instead of starting a new draw call each time they change. Reduces CPU overhead in games which "
+       "switch frequently, at a small cost in GPU performance. Results are identical."));
+  dialog->registerWidgetHelp(
+    m_ui.deferPipelineCompilation, tr("Deferred Pipeline Compilation"), tr("Unchecked"),
+    tr("Only compiles a small set of general pipelines at startup, and builds the texture mode specific ones when the "
+       "game first uses them. Greatly reduces the time taken to start a game when the shader cache is empty, and "
+       "pipelines which are never used are never built, at a small cost in GPU performance until they are. Results "
+       "are identical."));
+  dialog->registerWidgetHelp(
+    m_ui.textureFilterCache, tr("Cache Filtered Textures"), tr("Unchecked"),
+    tr("Filters each palette texture page once at the internal resolution and reuses it until VRAM changes, instead "
+       "of filtering in every draw. Greatly reduces the GPU cost of the xBR and JINC2 filters at high resolution "
+       "scales. Has no effect at 1x, with bilinear filtering, or for textures using a texture window, and edges of "
+       "sprites which are packed together may blend slightly."));
+  dialog->registerWidgetHelp(
+    m_ui.dynamicResolution, tr("Dynamic Resolution"), tr("Unchecked"),
+    tr("Lowers the internal resolution when the GPU can't render frames in time, and raises it back up to the "
+       "selected internal resolution when there is enough headroom. Useful on devices which throttle when hot. The "
+       "lowest scale used can be set with DynamicResolutionMinScale in the GPU section of the settings file."));
 
   // PGXP Tab
 
@@ -455,6 +511,19 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
                              QStringLiteral("%1%").arg(Settings::DEFAULT_DISPLAY_SCREENSHOT_QUALITY),
                              tr("Selects the quality at which screenshots will be compressed. Higher values preserve "
                                 "more detail for JPEG, and reduce file size for PNG."));
+  dialog->registerWidgetHelp(
+    m_ui.mediaCaptureEncoder, tr("Video Capture Encoder"), tr("Software (x264)"),
+    tr("Selects the FFmpeg encoder used for video captures. Hardware encoders use much less CPU time, but require a "
+       "supported GPU and an FFmpeg build which includes them. FFmpeg must be installed, or placed next to the "
+       "DuckStation executable on Windows."));
+  dialog->registerWidgetHelp(m_ui.mediaCaptureVideoBitrate, tr("Video Capture Bitrate"),
+                             tr("%1 kbps").arg(Settings::DEFAULT_MEDIA_CAPTURE_VIDEO_BITRATE),
+                             tr("Sets the bitrate which video captures are encoded at. Higher values preserve more "
+                                "detail, at the cost of file size."));
+  dialog->registerWidgetHelp(
+    m_ui.mediaCaptureInternalResolution, tr("Capture at Internal Resolution"), tr("Unchecked"),
+    tr("Captures video at the internal resolution, without post-processing, instead of the window size. The "
+       "resolution is fixed when the capture starts."));
 
   // Texture Replacements Tab
 
@@ -463,6 +532,10 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
                                 "not general texture replacement.</strong>"));
   dialog->registerWidgetHelp(m_ui.preloadTextureReplacements, tr("Preload Texture Replacements"), tr("Unchecked"),
                              tr("Loads all replacement texture to RAM, reducing stuttering at runtime."));
+  dialog->registerWidgetHelp(m_ui.textureReplacementCacheSize, tr("Cache Size"), tr("1024 MB"),
+                             tr("Maximum amount of memory used by loaded replacement textures. When exceeded, the "
+                                "least recently used replacements are unloaded, and loaded again when next needed. "
+                                "Ignored when preloading texture replacements."));
   dialog->registerWidgetHelp(m_ui.useOldMDECRoutines, tr("Use Old MDEC Routines"), tr("Unchecked"),
                              tr("Enables the older, less accurate MDEC decoding routines. May be required for old "
                                 "replacement backgrounds to match/load."));
@@ -480,6 +553,11 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   dialog->registerWidgetHelp(m_ui.gpuWireframeMode, tr("Wireframe Mode"), tr("Disabled"),
                              tr("Draws a wireframe outline of the triangles rendered by the console's GPU, either as a "
                                 "replacement or an overlay."));
+  dialog->registerWidgetHelp(
+    m_ui.sparseVRAM, tr("Use Sparse VRAM"), tr("Unchecked"),
+    tr("Only allocates memory for the parts of the upscaled VRAM which games draw or write to, reducing GPU memory "
+       "use at high resolution scales. Requires Vulkan, and is not used with multisampling. "
+       "<strong>Experimental.</strong>"));
 
   dialog->registerWidgetHelp(
     m_ui.useDebugDevice, tr("Use Debug Device"), tr("Unchecked"),
@@ -593,6 +671,12 @@ void GraphicsSettingsWidget::setupAdditionalUi()
       QString::fromUtf8(Settings::GetDisplayScreenshotFormatDisplayName(static_cast<DisplayScreenshotFormat>(i))));
   }
 
+  for (u32 i = 0; i < static_cast<u32>(MediaCaptureEncoder::Count); i++)
+  {
+    m_ui.mediaCaptureEncoder->addItem(
+      QString::fromUtf8(MediaCapture::GetEncoderDisplayName(static_cast<MediaCaptureEncoder>(i))));
+  }
+
   // Debugging Tab
 
   for (u32 i = 0; i < static_cast<u32>(GPUWireframeMode::Count); i++)
@@ -655,6 +739,10 @@ void GraphicsSettingsWidget::updateRendererDependentOptions()
   m_ui.debanding->setEnabled(is_hardware);
   m_ui.scaledDithering->setEnabled(is_hardware);
   m_ui.useSoftwareRendererForReadbacks->setEnabled(is_hardware);
+  m_ui.batchMixedTextureModes->setEnabled(is_hardware);
+  m_ui.deferPipelineCompilation->setEnabled(is_hardware);
+  m_ui.textureFilterCache->setEnabled(is_hardware);
+  m_ui.dynamicResolution->setEnabled(is_hardware);
 
   m_ui.tabs->setTabEnabled(TAB_INDEX_TEXTURE_REPLACEMENTS, is_hardware);
 
@@ -663,7 +751,11 @@ void GraphicsSettingsWidget::updateRendererDependentOptions()
 #endif
 
   m_ui.gpuThread->setEnabled(!is_hardware);
+  m_ui.gpuSWRasterizerThreadsLabel->setEnabled(!is_hardware);
+  m_ui.gpuSWRasterizerThreads->setEnabled(!is_hardware);
+  m_ui.gpuSWRasterizerJIT->setEnabled(!is_hardware);
   m_ui.threadedPresentation->setEnabled(render_api == RenderAPI::Vulkan);
+  m_ui.nonBlockingPresentation->setEnabled(render_api == RenderAPI::Vulkan);
 
   m_ui.exclusiveFullscreenLabel->setEnabled(render_api == RenderAPI::D3D11 || render_api == RenderAPI::D3D12 ||
                                             render_api == RenderAPI::Vulkan);
@@ -863,6 +955,7 @@ void GraphicsSettingsWidget::onEnableAnyTextureReplacementsChanged()
   const bool any_replacements_enabled =
     m_dialog->getEffectiveBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   m_ui.preloadTextureReplacements->setEnabled(any_replacements_enabled);
+  m_ui.textureReplacementCacheSize->setEnabled(any_replacements_enabled);
 }
 
 void GraphicsSettingsWidget::onEnableVRAMWriteDumpingChanged()
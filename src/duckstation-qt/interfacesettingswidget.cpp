@@ -64,6 +64,12 @@ InterfaceSettingsWidget::InterfaceSettingsWidget(SettingsWindow* dialog, QWidget
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.hideMainWindow, "Main", "HideMainWindowWhenRunning", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.disableWindowResizing, "Main", "DisableWindowResize", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.hideMouseCursor, "Main", "HideCursorInFullscreen", true);
+#ifdef _WIN32
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.lowLatencyWindowedDisplay, "Main", "LowLatencyWindowedDisplay",
+                                               false);
+#else
+  m_ui.lowLatencyWindowedDisplay->hide();
+#endif
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.createSaveStateBackups, "Main", "CreateSaveStateBackups",
                                                Settings::DEFAULT_SAVE_STATE_BACKUPS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.enableDiscordPresence, "Main", "EnableDiscordPresence", false);
@@ -90,6 +96,11 @@ InterfaceSettingsWidget::InterfaceSettingsWidget(SettingsWindow* dialog, QWidget
     m_ui.renderToSeparateWindow, tr("Render To Separate Window"), tr("Checked"),
     tr("Renders the display of the simulated console to the main window of the application, over "
        "the game list. If checked, the display will render in a separate window."));
+  dialog->registerWidgetHelp(
+    m_ui.lowLatencyWindowedDisplay, tr("Low-Latency Windowed Display"), tr("Unchecked"),
+    tr("When rendering to the main window, draws the display in a borderless window placed over the main window, "
+       "instead of inside it. This lets Windows present frames directly to the screen without composing them, "
+       "giving the same latency as exclusive fullscreen. Takes effect the next time the display is created."));
   dialog->registerWidgetHelp(m_ui.pauseOnStart, tr("Pause On Start"), tr("Unchecked"),
                              tr("Pauses the emulator when a game is started."));
   dialog->registerWidgetHelp(m_ui.pauseOnFocusLoss, tr("Pause On Focus Loss"), tr("Unchecked"),
@@ -14,8 +14,6 @@
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QScrollBar>
 
-// TODO: Since log callbacks are synchronized, no mutex is needed here.
-// But once I get rid of that, there will be.
 LogWindow* g_log_window;
 
 LogWindow::LogWindow(bool attach_to_main)
@@ -276,7 +274,7 @@ void LogWindow::onSaveTriggered()
   file.write(m_text->toPlainText().toUtf8());
   file.close();
 
-  appendMessage(QLatin1StringView("LogWindow"), LOGLEVEL_INFO, tr("Log was written to %1.\n").arg(path));
+  appendMessage(QLatin1StringView("LogWindow"), LOGLEVEL_INFO, tr("Log was written to %1.").arg(path));
 }
 
 void LogWindow::logCallback(void* pUserParam, const char* channelName, const char* functionName, LOGLEVEL level,
@@ -284,26 +282,40 @@ void LogWindow::logCallback(void* pUserParam, const char* channelName, const cha
 {
   LogWindow* this_ptr = static_cast<LogWindow*>(pUserParam);
 
-  // TODO: Split message based on lines.
-  // I don't like the memory allocations here either...
-
-  QString qmessage;
-  qmessage.reserve(message.length() + 1);
-  qmessage.append(QUtf8StringView(message.data(), message.length()));
-  qmessage.append(QChar('\n'));
-
   const QLatin1StringView qchannel((level <= LOGLEVEL_PERF) ? functionName : channelName);
+  QString qmessage = QString::fromUtf8(message.data(), static_cast<qsizetype>(message.length()));
+  const float message_time = Log::GetCurrentMessageTime();
+
+  std::unique_lock lock(this_ptr->m_pending_mutex);
 
-  if (g_emu_thread->isOnUIThread())
+  // Runs of the same line are shown once, with a count.
+  if (!this_ptr->m_pending_messages.empty())
   {
-    this_ptr->appendMessage(qchannel, level, qmessage);
+    PendingMessage& last = this_ptr->m_pending_messages.back();
+    if (last.level == static_cast<u32>(level) && last.channel == qchannel && last.message == qmessage)
+    {
+      last.repeat_count++;
+      return;
+    }
   }
-  else
+
+  // Only the first message in a batch needs to schedule the flush, the rest are picked up with it.
+  const bool schedule_flush = this_ptr->m_pending_messages.empty();
+  this_ptr->m_pending_messages.push_back(
+    PendingMessage{qchannel, static_cast<u32>(level), 1, message_time, std::move(qmessage)});
+  if (schedule_flush)
+    QMetaObject::invokeMethod(this_ptr, &LogWindow::flushPendingMessages, Qt::QueuedConnection);
+}
+
+void LogWindow::flushPendingMessages()
+{
+  std::vector<PendingMessage> messages;
   {
-    QMetaObject::invokeMethod(this_ptr, "appendMessage", Qt::QueuedConnection,
-                              Q_ARG(const QLatin1StringView&, qchannel), Q_ARG(quint32, static_cast<u32>(level)),
-                              Q_ARG(const QString&, qmessage));
+    std::unique_lock lock(m_pending_mutex);
+    messages.swap(m_pending_messages);
   }
+
+  appendMessages(messages);
 }
 
 void LogWindow::closeEvent(QCloseEvent* event)
@@ -323,6 +335,15 @@ void LogWindow::closeEvent(QCloseEvent* event)
 
 void LogWindow::appendMessage(const QLatin1StringView& channel, quint32 level, const QString& message)
 {
+  const PendingMessage msg{channel, level, 1, Log::GetCurrentMessageTime(), message};
+  appendMessages(std::span<const PendingMessage>(&msg, 1));
+}
+
+void LogWindow::appendMessages(std::span<const PendingMessage> messages)
+{
+  if (messages.empty())
+    return;
+
   QTextCursor temp_cursor = m_text->textCursor();
   QScrollBar* scrollbar = m_text->verticalScrollBar();
   const bool cursor_at_end = temp_cursor.atEnd();
@@ -330,6 +351,9 @@ void LogWindow::appendMessage(const QLatin1StringView& channel, quint32 level, c
 
   temp_cursor.movePosition(QTextCursor::End);
 
+  // Lays the document out once for the whole batch, instead of after every insert.
+  temp_cursor.beginEditBlock();
+
   {
     static constexpr const QChar level_characters[LOGLEVEL_COUNT] = {'X', 'E', 'W', 'P', 'I', 'V', 'D', 'R', 'B', 'T'};
     static constexpr const QColor level_colors[LOGLEVEL_COUNT] = {
@@ -349,28 +373,34 @@ void LogWindow::appendMessage(const QLatin1StringView& channel, quint32 level, c
 
     QTextCharFormat format = temp_cursor.charFormat();
 
-    if (g_settings.log_timestamps)
+    for (const PendingMessage& msg : messages)
     {
-      const float message_time = Log::GetCurrentMessageTime();
-      const QString qtimestamp = QStringLiteral("[%1] ").arg(message_time, 10, 'f', 4);
-      format.setForeground(QBrush(timestamp_color));
+      if (g_settings.log_timestamps)
+      {
+        const QString qtimestamp = QStringLiteral("[%1] ").arg(msg.time, 10, 'f', 4);
+        format.setForeground(QBrush(timestamp_color));
+        temp_cursor.setCharFormat(format);
+        temp_cursor.insertText(qtimestamp);
+      }
+
+      const QString qchannel = (msg.level <= LOGLEVEL_PERF) ?
+                                 QStringLiteral("%1(%2): ").arg(level_characters[msg.level]).arg(msg.channel) :
+                                 QStringLiteral("%1/%2: ").arg(level_characters[msg.level]).arg(msg.channel);
+      format.setForeground(QBrush(channel_color));
       temp_cursor.setCharFormat(format);
-      temp_cursor.insertText(qtimestamp);
-    }
+      temp_cursor.insertText(qchannel);
 
-    const QString qchannel = (level <= LOGLEVEL_PERF) ?
-                               QStringLiteral("%1(%2): ").arg(level_characters[level]).arg(channel) :
-                               QStringLiteral("%1/%2: ").arg(level_characters[level]).arg(channel);
-    format.setForeground(QBrush(channel_color));
-    temp_cursor.setCharFormat(format);
-    temp_cursor.insertText(qchannel);
-
-    // message has \n already
-    format.setForeground(QBrush(level_colors[level]));
-    temp_cursor.setCharFormat(format);
-    temp_cursor.insertText(message);
+      format.setForeground(QBrush(level_colors[msg.level]));
+      temp_cursor.setCharFormat(format);
+      temp_cursor.insertText(msg.message);
+      if (msg.repeat_count > 1)
+        temp_cursor.insertText(QStringLiteral(" (x%1)").arg(msg.repeat_count));
+      temp_cursor.insertText(QStringLiteral("\n"));
+    }
   }
 
+  temp_cursor.endEditBlock();
+
   if (cursor_at_end)
   {
     if (scroll_at_end)
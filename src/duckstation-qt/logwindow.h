@@ -7,7 +7,9 @@
 
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QPlainTextEdit>
+#include <mutex>
 #include <span>
+#include <vector>
 
 class LogWindow : public QMainWindow
 {
@@ -26,6 +28,15 @@ public:
   void updateWindowTitle();
 
 private:
+  struct PendingMessage
+  {
+    QLatin1StringView channel;
+    u32 level;
+    u32 repeat_count;
+    float time;
+    QString message;
+  };
+
   void createUi();
   void updateLogLevelUi();
   void setLogLevel(LOGLEVEL level);
@@ -41,7 +52,7 @@ protected:
 private Q_SLOTS:
   void onClearTriggered();
   void onSaveTriggered();
-  void appendMessage(const QLatin1StringView& channel, quint32 level, const QString& message);
+  void flushPendingMessages();
 
 private:
   static constexpr int DEFAULT_WIDTH = 750;
@@ -50,12 +61,19 @@ private:
   void saveSize();
   void restoreSize();
 
+  void appendMessage(const QLatin1StringView& channel, quint32 level, const QString& message);
+  void appendMessages(std::span<const PendingMessage> messages);
+
   QPlainTextEdit* m_text;
   QMenu* m_level_menu;
   std::span<const char*> m_filter_names;
 
   bool m_attached_to_main_window = true;
   bool m_destroying = false;
+
+  // Messages are collected here and added to the text box in batches, since doing it per message is slow.
+  std::mutex m_pending_mutex;
+  std::vector<PendingMessage> m_pending_messages;
 };
 
 extern LogWindow* g_log_window;
@@ -25,6 +25,7 @@
 #include "core/game_list.h"
 #include "core/host.h"
 #include "core/memory_card.h"
+#include "core/netplay.h"
 #include "core/settings.h"
 #include "core/system.h"
 
@@ -344,6 +345,13 @@ void MainWindow::createDisplayWidget(bool fullscreen, bool render_to_main, bool
     m_display_container->setDisplayWidget(m_display_widget);
     container = m_display_container;
   }
+  else if (DisplayPlaceholder::isNeeded(fullscreen, render_to_main) && !s_use_central_widget)
+  {
+    // Owned by the main window, so it stays above it, and is minimized with it.
+    m_display_widget = new DisplayWidget(this, Qt::Tool | Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint);
+    m_display_placeholder = new DisplayPlaceholder(m_display_widget, m_ui.mainContainer);
+    container = m_display_placeholder;
+  }
   else
   {
     m_display_widget = new DisplayWidget((!fullscreen && render_to_main) ? getContentParent() : nullptr);
@@ -461,8 +469,9 @@ void MainWindow::destroyDisplayWidget(bool show_game_list)
     }
     else
     {
-      AssertMsg(m_ui.mainContainer->indexOf(m_display_widget) == 1, "Display widget in stack");
-      m_ui.mainContainer->removeWidget(m_display_widget);
+      QWidget* widget = m_display_placeholder ? static_cast<QWidget*>(m_display_placeholder) : m_display_widget;
+      AssertMsg(m_ui.mainContainer->indexOf(widget) == 1, "Display widget in stack");
+      m_ui.mainContainer->removeWidget(widget);
       if (show_game_list)
       {
         m_ui.mainContainer->setCurrentIndex(0);
@@ -471,6 +480,12 @@ void MainWindow::destroyDisplayWidget(bool show_game_list)
     }
   }
 
+  if (m_display_placeholder)
+  {
+    delete m_display_placeholder;
+    m_display_placeholder = nullptr;
+  }
+
   if (m_display_widget)
   {
     m_display_widget->destroy();
@@ -1778,6 +1793,15 @@ void MainWindow::updateEmulationActions(bool starting, bool running, bool cheevo
   m_ui.actionDumpRAM->setDisabled(starting || !running || cheevos_challenge_mode);
   m_ui.actionDumpVRAM->setDisabled(starting || !running || cheevos_challenge_mode);
   m_ui.actionDumpSPURAM->setDisabled(starting || !running || cheevos_challenge_mode);
+  m_ui.actionRecordInputMovie->setDisabled(starting || !running || cheevos_challenge_mode);
+  m_ui.actionPlayInputMovie->setDisabled(starting || !running || cheevos_challenge_mode);
+  m_ui.actionStopInputMovie->setDisabled(starting || !running);
+  m_ui.actionHostNetplay->setDisabled(starting || !running || cheevos_challenge_mode);
+  m_ui.actionJoinNetplay->setDisabled(starting || !running || cheevos_challenge_mode);
+  m_ui.actionStopNetplay->setDisabled(starting || !running);
+  m_ui.actionMediaCapture->setDisabled(starting || !running);
+  if (!running)
+    m_ui.actionMediaCapture->setChecked(false);
 
   m_ui.actionSaveState->setDisabled(starting || !running);
   m_ui.menuSaveState->setDisabled(starting || !running);
@@ -1819,6 +1843,16 @@ void MainWindow::updateEmulationActions(bool starting, bool running, bool cheevo
     QMetaObject::invokeMethod(g_gdb_server, "stop", Qt::QueuedConnection);
   }
 
+  if (!g_metrics_server->isListening() && g_settings.debugging.enable_metrics_server && starting)
+  {
+    QMetaObject::invokeMethod(g_metrics_server, "start", Qt::QueuedConnection,
+                              Q_ARG(quint16, g_settings.debugging.metrics_server_port));
+  }
+  else if (g_metrics_server->isListening() && !running)
+  {
+    QMetaObject::invokeMethod(g_metrics_server, "stop", Qt::QueuedConnection);
+  }
+
   m_ui.statusBar->clearMessage();
 }
 
@@ -1937,6 +1971,8 @@ bool MainWindow::isRenderingToMain() const
 {
   if (s_use_central_widget)
     return (m_display_widget && centralWidget() == m_display_widget);
+  else if (m_display_placeholder)
+    return (m_ui.mainContainer->indexOf(m_display_placeholder) == 1);
   else
     return (m_display_widget && m_ui.mainContainer->indexOf(m_display_widget) == 1);
 }
@@ -2134,6 +2170,65 @@ void MainWindow::connectSignals()
     else
       g_emu_thread->stopDumpingAudio();
   });
+  connect(m_ui.actionMediaCapture, &QAction::toggled, [](bool checked) {
+    if (checked)
+      g_emu_thread->startMediaCapture();
+    else
+      g_emu_thread->stopMediaCapture();
+  });
+  connect(m_ui.actionRecordInputMovie, &QAction::triggered, [this]() {
+    const QString filename = QDir::toNativeSeparators(
+      QFileDialog::getSaveFileName(this, tr("Destination File"), QString(), tr("Input Movies (*.dsm)")));
+    if (filename.isEmpty())
+      return;
+
+    g_emu_thread->startInputMovie(filename, true);
+  });
+  connect(m_ui.actionPlayInputMovie, &QAction::triggered, [this]() {
+    const QString filename = QDir::toNativeSeparators(
+      QFileDialog::getOpenFileName(this, tr("Select Input Movie"), QString(), tr("Input Movies (*.dsm)")));
+    if (filename.isEmpty())
+      return;
+
+    g_emu_thread->startInputMovie(filename, false);
+  });
+  connect(m_ui.actionStopInputMovie, &QAction::triggered, g_emu_thread, &EmuThread::stopInputMovie);
+  connect(m_ui.actionHostNetplay, &QAction::triggered, [this]() {
+    bool ok;
+    const int port = QInputDialog::getInt(this, tr("Host Netplay Session"), tr("Port:"), Netplay::DEFAULT_PORT, 1,
+                                          65535, 1, &ok);
+    if (!ok)
+      return;
+
+    g_emu_thread->startNetplaySession(QString(), static_cast<quint16>(port));
+  });
+  connect(m_ui.actionJoinNetplay, &QAction::triggered, [this]() {
+    const QString address =
+      QInputDialog::getText(this, tr("Join Netplay Session"), tr("Host address, optionally followed by :port:"))
+        .trimmed();
+    if (address.isEmpty())
+      return;
+
+    // last colon separates the port
+    QString hostname = address;
+    quint16 port = Netplay::DEFAULT_PORT;
+    if (const qsizetype pos = address.lastIndexOf(QChar(':')); pos >= 0)
+    {
+      bool ok;
+      const uint parsed_port = address.mid(pos + 1).toUInt(&ok);
+      if (!ok || parsed_port == 0 || parsed_port > 65535)
+      {
+        QMessageBox::critical(this, tr("Join Netplay Session"), tr("Invalid port in address."));
+        return;
+      }
+
+      hostname = address.left(pos);
+      port = static_cast<quint16>(parsed_port);
+    }
+
+    g_emu_thread->startNetplaySession(hostname, port);
+  });
+  connect(m_ui.actionStopNetplay, &QAction::triggered, g_emu_thread, &EmuThread::stopNetplaySession);
   connect(m_ui.actionDumpRAM, &QAction::triggered, [this]() {
     const QString filename = QDir::toNativeSeparators(
       QFileDialog::getSaveFileName(this, tr("Destination File"), QString(), tr("Binary Files (*.bin)")));
@@ -2167,6 +2262,8 @@ void MainWindow::connectSignals()
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMDECState, "Debug", "ShowMDECState", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowDMAState, "Debug", "ShowDMAState", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMemoryState, "Debug", "ShowMemoryState",
+                                               false);
 
   for (u32 i = 0; InterfaceSettingsWidget::THEME_NAMES[i]; i++)
   {
@@ -2774,6 +2871,9 @@ void MainWindow::moveEvent(QMoveEvent* event)
 {
   QMainWindow::moveEvent(event);
 
+  if (m_display_placeholder)
+    m_display_placeholder->updateDisplayGeometry();
+
   if (g_log_window && g_log_window->isAttachedToMainWindow())
     g_log_window->reattachToMainWindow();
 }
@@ -284,6 +284,7 @@ private:
 
   DisplayWidget* m_display_widget = nullptr;
   DisplayContainer* m_display_container = nullptr;
+  DisplayPlaceholder* m_display_placeholder = nullptr;
 
   QProgressBar* m_status_progress_widget = nullptr;
   QLabel* m_status_renderer_widget = nullptr;
@@ -101,7 +101,7 @@ bool MemoryCardEditorWindow::createMemoryCard(const QString& path)
   MemoryCardImage::DataArray data;
   MemoryCardImage::Format(&data);
 
-  return MemoryCardImage::SaveToFile(data, path.toUtf8().constData());
+  return MemoryCardImage::SaveToFile(data, path.toUtf8().constData(), false);
 }
 
 void MemoryCardEditorWindow::resizeEvent(QResizeEvent* ev)
@@ -367,7 +367,7 @@ void MemoryCardEditorWindow::saveCard(Card* card)
   if (card->filename.empty())
     return;
 
-  if (!MemoryCardImage::SaveToFile(card->data, card->filename.c_str()))
+  if (!MemoryCardImage::SaveToFile(card->data, card->filename.c_str(), false))
   {
     QMessageBox::critical(this, tr("Error"),
                           tr("Failed to write card to '%1'").arg(QString::fromStdString(card->filename)));
@@ -477,12 +477,13 @@ void MemoryScannerWindow::updateResults()
     row++;
   }
 
-  m_ui.scanResultCount->setText((row < static_cast<int>(results.size())) ?
-                                  tr("%1 (only showing first %2)").arg(results.size()).arg(row) :
-                                  QString::number(m_scanner.GetResultCount()));
+  const u32 result_count = m_scanner.GetResultCount();
+  m_ui.scanResultCount->setText((static_cast<u32>(row) < result_count) ?
+                                  tr("%1 (only showing first %2)").arg(result_count).arg(row) :
+                                  QString::number(result_count));
 
-  m_ui.scanResetSearch->setEnabled(!results.empty());
-  m_ui.scanSearchAgain->setEnabled(!results.empty());
+  m_ui.scanResetSearch->setEnabled(result_count > 0);
+  m_ui.scanSearchAgain->setEnabled(result_count > 0);
   m_ui.scanAddWatch->setEnabled(false);
 }
 
@@ -566,21 +567,18 @@ void MemoryScannerWindow::updateWatch()
 void MemoryScannerWindow::updateWatchValues()
 {
   QSignalBlocker sb(m_ui.watchTable);
-  int row = 0;
-  for (const MemoryWatchList::Entry& res : m_watch.GetEntries())
+  for (const u32 index : m_watch.GetChangedEntryIndices())
   {
-    if (res.changed)
-    {
-      if (m_ui.scanValueBase->currentIndex() == 0)
-        m_ui.watchTable->item(row, 3)->setText(formatValue(res.value, res.is_signed));
-      else if (m_scanner.GetSize() == MemoryAccessSize::Byte)
-        m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 2));
-      else if (m_scanner.GetSize() == MemoryAccessSize::HalfWord)
-        m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 4));
-      else
-        m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 8));
-    }
-    row++;
+    const MemoryWatchList::Entry& res = m_watch.GetEntry(index);
+    const int row = static_cast<int>(index);
+    if (m_ui.scanValueBase->currentIndex() == 0)
+      m_ui.watchTable->item(row, 3)->setText(formatValue(res.value, res.is_signed));
+    else if (m_scanner.GetSize() == MemoryAccessSize::Byte)
+      m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 2));
+    else if (m_scanner.GetSize() == MemoryAccessSize::HalfWord)
+      m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 4));
+    else
+      m_ui.watchTable->item(row, 3)->setText(formatHexValue(res.value, 8));
   }
 }
 
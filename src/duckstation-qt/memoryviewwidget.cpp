@@ -1,8 +1,11 @@
 #include "memoryviewwidget.h"
+#include <QtGui/QPaintEvent>
 #include <QtGui/QPainter>
 #include <QtWidgets/QScrollBar>
 #include <cstring>
 
+static constexpr unsigned CHANGE_HIGHLIGHT_UPDATES = 8;
+
 MemoryViewWidget::MemoryViewWidget(QWidget* parent /* = nullptr */, size_t address_offset /* = 0 */,
                                    const void* data_ptr /* = nullptr */, size_t data_size /* = 0 */)
   : QAbstractScrollArea(parent)
@@ -44,6 +47,8 @@ void MemoryViewWidget::updateMetrics()
 
 void MemoryViewWidget::setData(size_t address_offset, const void* data_ptr, size_t data_size)
 {
+  m_snapshot.clear();
+  m_change_age.clear();
   m_data = data_ptr;
   m_data_size = data_size;
   m_address_offset = address_offset;
@@ -89,13 +94,85 @@ void MemoryViewWidget::resizeEvent(QResizeEvent*)
   adjustContent();
 }
 
+void MemoryViewWidget::updateChangedBytes()
+{
+  if (!m_data || !isVisible() || m_end_offset < m_start_offset)
+    return;
+
+  const size_t count = m_end_offset - m_start_offset + 1;
+  const unsigned char* data = static_cast<const unsigned char*>(m_data) + m_start_offset;
+  if (m_snapshot_offset != m_start_offset || m_snapshot.size() != count)
+  {
+    // Scrolled or resized, so there's nothing to compare against.
+    m_snapshot.assign(data, data + count);
+    m_change_age.assign(count, 0);
+    m_snapshot_offset = m_start_offset;
+    return;
+  }
+
+  QRegion dirty;
+  for (size_t i = 0; i < count; i++)
+  {
+    const unsigned char value = data[i];
+    if (value != m_snapshot[i])
+    {
+      m_snapshot[i] = value;
+      m_change_age[i] = CHANGE_HIGHLIGHT_UPDATES;
+    }
+    else if (m_change_age[i] > 0)
+    {
+      m_change_age[i]--;
+    }
+    else
+    {
+      continue;
+    }
+
+    dirty += getHexCellRect(m_start_offset + i);
+    dirty += getAsciiCellRect(m_start_offset + i);
+  }
+
+  if (!dirty.isEmpty())
+    viewport()->update(dirty);
+}
+
+unsigned MemoryViewWidget::getChangeAge(size_t offset) const
+{
+  if (offset < m_snapshot_offset || (offset - m_snapshot_offset) >= m_change_age.size())
+    return 0;
+
+  return m_change_age[offset - m_snapshot_offset];
+}
+
+QRect MemoryViewWidget::getHexCellRect(size_t offset) const
+{
+  const int row = static_cast<int>((offset - m_start_offset) / m_bytes_per_line);
+  const int col = static_cast<int>((offset - m_start_offset) % m_bytes_per_line);
+  return QRect(addressWidth() - horizontalScrollBar()->value() + col * 4 * m_char_width,
+               (row + 1) * m_char_height + 3, 4 * m_char_width, m_char_height);
+}
+
+QRect MemoryViewWidget::getAsciiCellRect(size_t offset) const
+{
+  const int row = static_cast<int>((offset - m_start_offset) / m_bytes_per_line);
+  const int col = static_cast<int>((offset - m_start_offset) % m_bytes_per_line);
+  return QRect(addressWidth() + hexWidth() + m_char_width - horizontalScrollBar()->value() + col * 2 * m_char_width,
+               (row + 1) * m_char_height + 3, 2 * m_char_width, m_char_height);
+}
+
+static QColor GetChangeColor(unsigned age)
+{
+  // Fades out as the change gets older.
+  return QColor(200, 50, 50, static_cast<int>((age * 160) / CHANGE_HIGHLIGHT_UPDATES));
+}
+
 template<typename T>
 static bool RangesOverlap(T x1, T x2, T y1, T y2)
 {
   return (x2 >= y1 && x1 < y2);
 }
 
-void MemoryViewWidget::paintEvent(QPaintEvent*)
+void MemoryViewWidget::paintEvent(QPaintEvent* event)
 {
   QPainter painter(viewport());
   painter.setFont(font());
@@ -103,6 +180,7 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
     return;
 
   const QColor highlight_color(100, 100, 0);
+  const QRect& paint_rect = event->rect();
   const int offsetX = horizontalScrollBar()->value();
 
   int y = m_char_height;
@@ -154,9 +232,13 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
   painter.drawLine(0, y + 3, width(), y + 3);
   y += m_char_height;
 
-  size_t offset = m_start_offset;
-  for (unsigned row = 0; row <= num_rows; row++)
+  for (unsigned row = 0; row <= num_rows; row++, y += m_char_height)
   {
+    // While running, only the changed cells are repainted, so don't bother drawing rows outside them.
+    if ((y + 3) <= paint_rect.top() || (y - m_char_height + 3) > paint_rect.bottom())
+      continue;
+
+    size_t offset = m_start_offset + (row * m_bytes_per_line);
     x = lx - offsetX + m_char_width;
     for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
     {
@@ -164,11 +246,12 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
       std::memcpy(&value, static_cast<const unsigned char*>(m_data) + offset, sizeof(value));
       if (offset >= m_highlight_start && offset < m_highlight_end)
         painter.fillRect(x - m_char_width, y - m_char_height + 3, HEX_CHAR_WIDTH, m_char_height, highlight_color);
+      if (const unsigned age = getChangeAge(offset); age > 0)
+        painter.fillRect(x - m_char_width, y - m_char_height + 3, HEX_CHAR_WIDTH, m_char_height, GetChangeColor(age));
 
       painter.drawText(x, y, QString::asprintf("%02X", value));
       x += HEX_CHAR_WIDTH;
     }
-    y += m_char_height;
   }
 
   lx = addressWidth() + hexWidth();
@@ -187,9 +270,12 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
 
   y += m_char_height;
 
-  offset = m_start_offset;
-  for (unsigned row = 0; row <= num_rows; row++)
+  for (unsigned row = 0; row <= num_rows; row++, y += m_char_height)
   {
+    if ((y + 3) <= paint_rect.top() || (y - m_char_height + 3) > paint_rect.bottom())
+      continue;
+
+    size_t offset = m_start_offset + (row * m_bytes_per_line);
     x = lx - offsetX;
     for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
     {
@@ -197,13 +283,14 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
       std::memcpy(&value, static_cast<const unsigned char*>(m_data) + offset, sizeof(value));
       if (offset >= m_highlight_start && offset < m_highlight_end)
         painter.fillRect(x, y - m_char_height + 3, 2 * m_char_width, m_char_height, highlight_color);
+      if (const unsigned age = getChangeAge(offset); age > 0)
+        painter.fillRect(x, y - m_char_height + 3, 2 * m_char_width, m_char_height, GetChangeColor(age));
 
       if (!std::isprint(value))
         value = '.';
       painter.drawText(x, y, static_cast<QChar>(value));
       x += 2 * m_char_width;
     }
-    y += m_char_height;
   }
 }
 
@@ -216,6 +303,8 @@ void MemoryViewWidget::adjustContent()
   }
 
   setEnabled(true);
+  m_snapshot.clear();
+  m_change_age.clear();
 
   int w = addressWidth() + hexWidth() + asciiWidth();
   horizontalScrollBar()->setRange(0, w - viewport()->width());
@@ -1,5 +1,6 @@
 #pragma once
 #include <QtWidgets/QAbstractScrollArea>
+#include <vector>
 
 // Based on https://stackoverflow.com/questions/46375673/how-can-realize-my-own-memory-viewer-by-qt
 
@@ -21,6 +22,10 @@ public:
   void scrollToAddress(size_t address);
   void setFont(const QFont& font);
 
+  /// Compares the visible bytes with the last call, and repaints only the ones which changed. Changed bytes stay
+  /// highlighted for a few calls, fading out, so this should be called periodically while the system is running.
+  void updateChangedBytes();
+
 protected:
   void paintEvent(QPaintEvent*);
   void resizeEvent(QResizeEvent*);
@@ -33,6 +38,9 @@ private:
   int hexWidth() const;
   int asciiWidth() const;
   void updateMetrics();
+  unsigned getChangeAge(size_t offset) const;
+  QRect getHexCellRect(size_t offset) const;
+  QRect getAsciiCellRect(size_t offset) const;
 
   const void* m_data;
   size_t m_data_size;
@@ -50,4 +58,9 @@ private:
   int m_char_height;
 
   int m_rows_visible;
+
+  // Visible bytes as of the last updateChangedBytes(), and how many more updates each stays highlighted for.
+  std::vector<unsigned char> m_snapshot;
+  std::vector<unsigned char> m_change_age;
+  size_t m_snapshot_offset = 0;
 };
\ No newline at end of file
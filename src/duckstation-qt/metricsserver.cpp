@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "metricsserver.h"
+#include "qthost.h"
+
+#include "core/cdrom.h"
+#include "core/cpu_code_cache.h"
+#include "core/spu.h"
+#include "core/system.h"
+
+#include "util/audio_stream.h"
+
+#include "common/log.h"
+#include "common/memory_accounting.h"
+
+#include "fmt/format.h"
+
+#include <QtNetwork/QTcpSocket>
+#include <algorithm>
+#include <iterator>
+
+Log_SetChannel(MetricsServer);
+
+// Requests are tiny, anything bigger than this isn't a metrics scraper.
+static constexpr qint64 MAX_REQUEST_SIZE = 8192;
+
+MetricsServer::MetricsServer(QObject* parent) : QTcpServer(parent)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+  stop();
+}
+
+void MetricsServer::start(quint16 port)
+{
+  if (isListening())
+    return;
+
+  if (!listen(QHostAddress::LocalHost, port))
+  {
+    Log_ErrorFmt("Failed to listen on TCP port {} for metrics server: {}", port, errorString().toStdString());
+    return;
+  }
+
+  Log_InfoFmt("Metrics server listening on TCP port {}", port);
+}
+
+void MetricsServer::stop()
+{
+  if (isListening())
+  {
+    close();
+    Log_InfoPrint("Metrics server stopped");
+  }
+
+  for (QObject* connection : children())
+    connection->deleteLater();
+}
+
+void MetricsServer::incomingConnection(qintptr descriptor)
+{
+  QTcpSocket* socket = new QTcpSocket(this);
+  if (!socket->setSocketDescriptor(descriptor))
+  {
+    socket->deleteLater();
+    return;
+  }
+
+  connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+  connect(socket, &QTcpSocket::readyRead, this, [socket]() {
+    // Wait for the whole header, we don't care about anything after the request line.
+    if (!socket->peek(MAX_REQUEST_SIZE).contains("\r\n\r\n"))
+    {
+      if (socket->bytesAvailable() >= MAX_REQUEST_SIZE)
+        socket->abort();
+      return;
+    }
+
+    const QByteArray request = socket->readAll();
+    const QList<QByteArray> request_line = request.left(request.indexOf("\r\n")).split(' ');
+    const bool is_metrics = (request_line.size() >= 2 && request_line[0] == "GET" &&
+                             (request_line[1] == "/metrics" || request_line[1] == "/"));
+
+    std::string response;
+    if (is_metrics)
+    {
+      const std::string body = getMetrics();
+      response = fmt::format("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                             "Content-Length: {}\r\nConnection: close\r\n\r\n{}",
+                             body.size(), body);
+    }
+    else
+    {
+      response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+
+    socket->write(response.data(), static_cast<qint64>(response.size()));
+    socket->disconnectFromHost();
+  });
+}
+
+std::string MetricsServer::getMetrics()
+{
+  std::string ret;
+  const auto add = [&ret](const char* name, const char* type, const char* help, auto value) {
+    fmt::format_to(std::back_inserter(ret), "# HELP {0} {1}\n# TYPE {0} {2}\n{0} {3}\n", name, help, type, value);
+  };
+
+  const bool running = System::IsValid();
+  add("duckstation_system_running", "gauge", "Whether a game is running.", running ? 1 : 0);
+
+  // Shader and texture caches outlive the system, so memory is reported even when nothing is running.
+  for (const bool gpu : {false, true})
+  {
+    const char* name = gpu ? "duckstation_memory_gpu_bytes" : "duckstation_memory_host_bytes";
+    fmt::format_to(std::back_inserter(ret), "# HELP {0} {1} memory allocated by each subsystem.\n# TYPE {0} gauge\n",
+                   name, gpu ? "GPU" : "Host");
+    for (u32 i = 0; i < static_cast<u32>(MemoryAccounting::Category::Count); i++)
+    {
+      const MemoryAccounting::Category category = static_cast<MemoryAccounting::Category>(i);
+      fmt::format_to(std::back_inserter(ret), "{}{{category=\"{}\"}} {}\n", name,
+                     MemoryAccounting::GetCategoryName(category),
+                     gpu ? MemoryAccounting::GetGPUBytes(category) : MemoryAccounting::GetHostBytes(category));
+    }
+  }
+
+  if (!running)
+    return ret;
+
+  add("duckstation_fps", "gauge", "Frames rendered by the game per second.", System::GetFPS());
+  add("duckstation_vps", "gauge", "Vertical blanks per second.", System::GetVPS());
+  add("duckstation_emulation_speed_percent", "gauge", "Emulation speed relative to the console.",
+      System::GetEmulationSpeed());
+  add("duckstation_frame_time_average_ms", "gauge", "Average host frame time.", System::GetAverageFrameTime());
+  add("duckstation_frame_time_minimum_ms", "gauge", "Minimum host frame time.", System::GetMinimumFrameTime());
+  add("duckstation_frame_time_maximum_ms", "gauge", "Maximum host frame time.", System::GetMaximumFrameTime());
+  add("duckstation_frame_pacing_jitter_ms", "gauge", "Average difference between the intended and actual wakeup.",
+      System::GetFramePacingJitter());
+  add("duckstation_cpu_thread_usage_percent", "gauge", "CPU thread usage.", System::GetCPUThreadUsage());
+  add("duckstation_cpu_thread_time_ms", "gauge", "Average CPU thread time per frame.",
+      System::GetCPUThreadAverageTime());
+  add("duckstation_sw_thread_usage_percent", "gauge", "Software renderer thread usage.",
+      System::GetSWThreadUsage());
+  add("duckstation_gpu_usage_percent", "gauge", "Host GPU usage.", System::GetGPUUsage());
+  add("duckstation_gpu_time_ms", "gauge", "Average host GPU time per frame.", System::GetGPUAverageTime());
+
+  // The frame time history is a window of the most recent frames, not a running total, so it's exposed as gauges.
+  static constexpr float frame_time_buckets[] = {8.34f, 16.7f, 20.0f, 33.4f, 50.0f, 100.0f};
+  const System::FrameTimeHistory& history = System::GetFrameTimeHistory();
+  fmt::format_to(std::back_inserter(ret),
+                 "# HELP duckstation_recent_frames Number of the last {} frames which took at most le milliseconds.\n"
+                 "# TYPE duckstation_recent_frames gauge\n",
+                 history.size());
+  for (const float bucket : frame_time_buckets)
+  {
+    fmt::format_to(std::back_inserter(ret), "duckstation_recent_frames{{le=\"{}\"}} {}\n", bucket,
+                   std::count_if(history.begin(), history.end(), [bucket](float t) { return t <= bucket; }));
+  }
+  fmt::format_to(std::back_inserter(ret), "duckstation_recent_frames{{le=\"+Inf\"}} {}\n", history.size());
+
+  if (const AudioStream* stream = SPU::GetOutputStream())
+  {
+    add("duckstation_audio_underruns_total", "counter", "Times the audio output ran out of buffered samples.",
+        stream->GetUnderrunCount());
+  }
+
+  const CPU::CodeCache::Statistics jit_stats = CPU::CodeCache::GetStatistics();
+  add("duckstation_jit_blocks", "gauge", "Blocks in the code cache.", jit_stats.num_blocks);
+  add("duckstation_jit_code_buffer_used_bytes", "gauge", "Recompiler code buffer usage.", jit_stats.code_buffer_used);
+  add("duckstation_jit_code_buffer_size_bytes", "gauge", "Recompiler code buffer size.", jit_stats.code_buffer_size);
+  add("duckstation_jit_code_evictions_total", "counter", "Times old blocks were evicted from the code buffer.",
+      jit_stats.code_evictions);
+
+  add("duckstation_cdrom_readahead_hits_total", "counter", "CD-ROM sector reads satisfied by readahead.",
+      CDROM::GetReadaheadHits());
+  add("duckstation_cdrom_readahead_misses_total", "counter", "CD-ROM sector reads which missed readahead.",
+      CDROM::GetReadaheadMisses());
+
+  return ret;
+}
@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "core/types.h"
+#include <QtNetwork/QTcpServer>
+#include <string>
+
+/// Serves performance counters in the Prometheus text format over HTTP. Only listens on localhost, like the GDB server,
+/// so remote monitoring needs a local agent or a forwarded port.
+class MetricsServer : public QTcpServer
+{
+  Q_OBJECT
+
+public:
+  MetricsServer(QObject* parent = nullptr);
+  ~MetricsServer();
+
+public Q_SLOTS:
+  void start(quint16 port);
+  void stop();
+
+protected:
+  void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+  static std::string getMetrics();
+};
@@ -19,7 +19,9 @@
 #include "core/gpu.h"
 #include "core/host.h"
 #include "core/imgui_overlays.h"
+#include "core/input_movie.h"
 #include "core/memory_card.h"
+#include "core/netplay.h"
 #include "core/spu.h"
 #include "core/system.h"
 
@@ -118,6 +120,7 @@ static bool s_cleanup_after_update = false;
 
 EmuThread* g_emu_thread;
 GDBServer* g_gdb_server;
+MetricsServer* g_metrics_server;
 
 EmuThread::EmuThread(QThread* ui_thread) : QThread(), m_ui_thread(ui_thread)
 {
@@ -848,6 +851,57 @@ void EmuThread::resumeSystemFromMostRecentState()
   bootOrLoadState(std::move(state_filename));
 }
 
+void EmuThread::pushHostCommand(const HostCommand& cmd)
+{
+  DebugAssert(!isOnThread());
+
+  if (!m_host_commands.Push(cmd))
+  {
+    // emu thread hasn't drained in a while, don't drop the event (e.g. a key release)
+    Log_WarningPrint("Host command queue is full, using a queued call.");
+    QMetaObject::invokeMethod(this, [this, cmd]() { executeHostCommand(cmd); }, Qt::QueuedConnection);
+    return;
+  }
+
+  // pairs with the fence in run(), so either the thread sees the command before sleeping, or we see it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_host_commands_need_wake.load(std::memory_order_relaxed))
+    QMetaObject::invokeMethod(this, &EmuThread::processHostCommands, Qt::QueuedConnection);
+}
+
+void EmuThread::processHostCommands()
+{
+  DebugAssert(isOnThread());
+
+  HostCommand cmd;
+  while (m_host_commands.Pop(&cmd))
+    executeHostCommand(cmd);
+}
+
+void EmuThread::executeHostCommand(const HostCommand& cmd)
+{
+  switch (cmd.type)
+  {
+    case HostCommand::Type::KeyEvent:
+      onDisplayWindowKeyEvent(cmd.key_or_button, cmd.pressed);
+      break;
+
+    case HostCommand::Type::MouseButtonEvent:
+      onDisplayWindowMouseButtonEvent(cmd.key_or_button, cmd.pressed);
+      break;
+
+    case HostCommand::Type::MouseWheelEvent:
+      onDisplayWindowMouseWheelEvent(cmd.scale_or_delta_x, cmd.delta_y);
+      break;
+
+    case HostCommand::Type::WindowResized:
+      onDisplayWindowResized(cmd.width, cmd.height, cmd.scale_or_delta_x);
+      break;
+
+      DefaultCaseIsUnreachable();
+  }
+}
+
 void EmuThread::onDisplayWindowKeyEvent(int key, bool pressed)
 {
   DebugAssert(isOnThread());
@@ -871,15 +925,13 @@ void EmuThread::onDisplayWindowMouseButtonEvent(int button, bool pressed)
                              GenericInputBinding::Unknown);
 }
 
-void EmuThread::onDisplayWindowMouseWheelEvent(const QPoint& delta_angle)
+void EmuThread::onDisplayWindowMouseWheelEvent(float dx, float dy)
 {
   DebugAssert(isOnThread());
 
-  const float dx = std::clamp(static_cast<float>(delta_angle.x()) / QtUtils::MOUSE_WHEEL_DELTA, -1.0f, 1.0f);
   if (dx != 0.0f)
     InputManager::UpdatePointerRelativeDelta(0, InputPointerAxis::WheelX, dx);
 
-  const float dy = std::clamp(static_cast<float>(delta_angle.y()) / QtUtils::MOUSE_WHEEL_DELTA, -1.0f, 1.0f);
   if (dy != 0.0f)
     InputManager::UpdatePointerRelativeDelta(0, InputPointerAxis::WheelY, dy);
 }
@@ -995,12 +1047,36 @@ void EmuThread::connectDisplaySignals(DisplayWidget* widget)
 {
   widget->disconnect(this);
 
-  connect(widget, &DisplayWidget::windowResizedEvent, this, &EmuThread::onDisplayWindowResized);
+  // These run on the UI thread, and only queue the event for the emu thread.
+  connect(
+    widget, &DisplayWidget::windowResizedEvent, this,
+    [this](int width, int height, float scale) {
+      pushHostCommand({.type = HostCommand::Type::WindowResized, .width = width, .height = height,
+                       .scale_or_delta_x = scale});
+    },
+    Qt::DirectConnection);
+  connect(
+    widget, &DisplayWidget::windowKeyEvent, this,
+    [this](int key, bool pressed) {
+      pushHostCommand({.type = HostCommand::Type::KeyEvent, .pressed = pressed, .key_or_button = key});
+    },
+    Qt::DirectConnection);
+  connect(
+    widget, &DisplayWidget::windowMouseButtonEvent, this,
+    [this](int button, bool pressed) {
+      pushHostCommand({.type = HostCommand::Type::MouseButtonEvent, .pressed = pressed, .key_or_button = button});
+    },
+    Qt::DirectConnection);
+  connect(
+    widget, &DisplayWidget::windowMouseWheelEvent, this,
+    [this](const QPoint& delta_angle) {
+      const float dx = std::clamp(static_cast<float>(delta_angle.x()) / QtUtils::MOUSE_WHEEL_DELTA, -1.0f, 1.0f);
+      const float dy = std::clamp(static_cast<float>(delta_angle.y()) / QtUtils::MOUSE_WHEEL_DELTA, -1.0f, 1.0f);
+      pushHostCommand({.type = HostCommand::Type::MouseWheelEvent, .scale_or_delta_x = dx, .delta_y = dy});
+    },
+    Qt::DirectConnection);
   connect(widget, &DisplayWidget::windowRestoredEvent, this, &EmuThread::redrawDisplayWindow);
-  connect(widget, &DisplayWidget::windowKeyEvent, this, &EmuThread::onDisplayWindowKeyEvent);
   connect(widget, &DisplayWidget::windowTextEntered, this, &EmuThread::onDisplayWindowTextEntered);
-  connect(widget, &DisplayWidget::windowMouseButtonEvent, this, &EmuThread::onDisplayWindowMouseButtonEvent);
-  connect(widget, &DisplayWidget::windowMouseWheelEvent, this, &EmuThread::onDisplayWindowMouseWheelEvent);
 }
 
 void Host::OnSystemStarting()
@@ -1467,6 +1543,84 @@ void EmuThread::stopDumpingAudio()
   System::StopDumpingAudio();
 }
 
+void EmuThread::startMediaCapture()
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "startMediaCapture", Qt::QueuedConnection);
+    return;
+  }
+
+  System::StartMediaCapture();
+}
+
+void EmuThread::stopMediaCapture()
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "stopMediaCapture", Qt::QueuedConnection);
+    return;
+  }
+
+  System::StopMediaCapture();
+}
+
+void EmuThread::startInputMovie(const QString& filename, bool record)
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "startInputMovie", Qt::QueuedConnection, Q_ARG(const QString&, filename),
+                              Q_ARG(bool, record));
+    return;
+  }
+
+  const std::string filename_str = filename.toStdString();
+  Error error;
+  const bool result = record ? InputMovie::StartRecording(filename_str.c_str(), &error) :
+                               InputMovie::StartPlayback(filename_str.c_str(), &error);
+  if (!result)
+    Host::ReportErrorAsync("Error", fmt::format("Failed to start input movie: {}", error.GetDescription()));
+}
+
+void EmuThread::stopInputMovie()
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "stopInputMovie", Qt::QueuedConnection);
+    return;
+  }
+
+  InputMovie::Stop();
+}
+
+void EmuThread::startNetplaySession(const QString& address, quint16 port)
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "startNetplaySession", Qt::QueuedConnection, Q_ARG(const QString&, address),
+                              Q_ARG(quint16, port));
+    return;
+  }
+
+  Error error;
+  const bool result = address.isEmpty() ?
+                        Netplay::StartHost(port, Netplay::DEFAULT_INPUT_DELAY, &error) :
+                        Netplay::StartJoin(address.toStdString(), port, Netplay::DEFAULT_INPUT_DELAY, &error);
+  if (!result)
+    Host::ReportErrorAsync("Error", fmt::format("Failed to start netplay session: {}", error.GetDescription()));
+}
+
+void EmuThread::stopNetplaySession()
+{
+  if (!isOnThread())
+  {
+    QMetaObject::invokeMethod(this, "stopNetplaySession", Qt::QueuedConnection);
+    return;
+  }
+
+  Netplay::Stop();
+}
+
 void EmuThread::singleStepCPU()
 {
   if (!isOnThread())
@@ -1689,6 +1843,8 @@ void EmuThread::start()
   g_emu_thread = new EmuThread(QThread::currentThread());
   g_gdb_server = new GDBServer();
   g_gdb_server->moveToThread(g_emu_thread);
+  g_metrics_server = new MetricsServer();
+  g_metrics_server->moveToThread(g_emu_thread);
   g_emu_thread->QThread::start();
   g_emu_thread->m_started_semaphore.acquire();
   g_emu_thread->moveToThread(g_emu_thread);
@@ -1744,11 +1900,16 @@ void EmuThread::run()
       // we want to keep rendering the UI when paused and fullscreen UI is enabled
       if (!FullscreenUI::HasActiveWindow() && !System::IsRunning())
       {
-        // wait until we have a system before running
+        // wait until we have a system before running, commands pushed while we're asleep have to wake us
+        m_host_commands_need_wake.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        processHostCommands();
         m_event_loop->exec();
+        m_host_commands_need_wake.store(false, std::memory_order_relaxed);
         continue;
       }
 
+      processHostCommands();
       m_event_loop->processEvents(QEventLoop::AllEvents);
       System::Internal::IdlePollUpdate();
       if (g_gpu_device)
@@ -2049,6 +2210,7 @@ void Host::SetMouseMode(bool relative, bool hide_cursor)
 
 void Host::PumpMessagesOnCPUThread()
 {
+  g_emu_thread->processHostCommands();
   g_emu_thread->getEventLoop()->processEvents(QEventLoop::AllEvents);
 }
 
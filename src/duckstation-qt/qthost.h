@@ -4,6 +4,7 @@
 #pragma once
 
 #include "gdbserver.h"
+#include "metricsserver.h"
 #include "qtutils.h"
 
 #include "core/game_list.h"
@@ -11,6 +12,8 @@
 #include "core/system.h"
 #include "core/types.h"
 
+#include "common/fifo_queue.h"
+
 #include "util/gpu_device.h"
 #include "util/input_manager.h"
 
@@ -93,6 +96,9 @@ public:
 
   ALWAYS_INLINE QEventLoop* getEventLoop() const { return m_event_loop; }
 
+  /// Executes display window events queued by the UI thread. Called once per frame.
+  void processHostCommands();
+
   ALWAYS_INLINE bool isFullscreen() const { return m_is_fullscreen; }
   ALWAYS_INLINE bool isRenderingToMain() const { return m_is_rendering_to_main; }
   ALWAYS_INLINE bool isSurfaceless() const { return m_is_surfaceless; }
@@ -181,6 +187,12 @@ public Q_SLOTS:
   void setAudioOutputMuted(bool muted);
   void startDumpingAudio();
   void stopDumpingAudio();
+  void startMediaCapture();
+  void stopMediaCapture();
+  void startInputMovie(const QString& filename, bool record);
+  void stopInputMovie();
+  void startNetplaySession(const QString& address, quint16 port);
+  void stopNetplaySession();
   void singleStepCPU();
   void dumpRAM(const QString& filename);
   void dumpVRAM(const QString& filename);
@@ -199,10 +211,6 @@ public Q_SLOTS:
 
 private Q_SLOTS:
   void stopInThread();
-  void onDisplayWindowMouseButtonEvent(int button, bool pressed);
-  void onDisplayWindowMouseWheelEvent(const QPoint& delta_angle);
-  void onDisplayWindowResized(int width, int height, float scale);
-  void onDisplayWindowKeyEvent(int key, bool pressed);
   void onDisplayWindowTextEntered(const QString& text);
   void doBackgroundControllerPoll();
   void runOnEmuThread(std::function<void()> callback);
@@ -214,6 +222,34 @@ private:
   using InputButtonHandler = std::function<void(bool)>;
   using InputAxisHandler = std::function<void(float)>;
 
+  /// Display window events are frequent, so they skip the Qt event loop, and go through a lock-free queue instead.
+  struct HostCommand
+  {
+    enum class Type : u8
+    {
+      KeyEvent,
+      MouseButtonEvent,
+      MouseWheelEvent,
+      WindowResized,
+    };
+
+    Type type;
+    bool pressed;
+    s32 key_or_button;
+    s32 width;
+    s32 height;
+    float scale_or_delta_x;
+    float delta_y;
+  };
+  static constexpr u32 HOST_COMMAND_QUEUE_SIZE = 256;
+
+  void pushHostCommand(const HostCommand& cmd);
+  void executeHostCommand(const HostCommand& cmd);
+  void onDisplayWindowMouseButtonEvent(int button, bool pressed);
+  void onDisplayWindowMouseWheelEvent(float dx, float dy);
+  void onDisplayWindowResized(int width, int height, float scale);
+  void onDisplayWindowKeyEvent(int key, bool pressed);
+
   void createBackgroundControllerPollTimer();
   void destroyBackgroundControllerPollTimer();
   void setInitialState(std::optional<bool> override_fullscreen);
@@ -225,6 +261,10 @@ private:
   QEventLoop* m_event_loop = nullptr;
   QTimer* m_background_controller_polling_timer = nullptr;
 
+  // Set while the thread is sleeping in the event loop, and won't drain the queue until it's woken.
+  SPSCFIFOQueue<HostCommand, HOST_COMMAND_QUEUE_SIZE> m_host_commands;
+  std::atomic_bool m_host_commands_need_wake{false};
+
   bool m_shutdown_flag = false;
   bool m_run_fullscreen_ui = false;
   bool m_is_rendering_to_main = false;
@@ -247,6 +287,7 @@ private:
 
 extern EmuThread* g_emu_thread;
 extern GDBServer* g_gdb_server;
+extern MetricsServer* g_metrics_server;
 
 namespace QtHost {
 /// Sets batch mode (exit after game shutdown).
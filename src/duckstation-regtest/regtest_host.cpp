@@ -7,17 +7,21 @@
 #include "core/game_list.h"
 #include "core/gpu.h"
 #include "core/host.h"
+#include "core/input_movie.h"
+#include "core/spu.h"
 #include "core/system.h"
 
 #include "scmversion/scmversion.h"
 
 #include "util/gpu_device.h"
 #include "util/imgui_fullscreen.h"
+#include "util/ini_settings_interface.h"
 #include "util/imgui_manager.h"
 #include "util/input_manager.h"
 #include "util/platform_misc.h"
 
 #include "common/assert.h"
+#include "common/byte_stream.h"
 #include "common/crash_handler.h"
 #include "common/error.h"
 #include "common/file_system.h"
@@ -25,13 +29,97 @@
 #include "common/memory_settings_interface.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 
+#include "core/game_list.h"
+
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cerrno>
 #include <csignal>
 #include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 Log_SetChannel(RegTestHost);
 
 namespace RegTestHost {
+namespace {
+struct BootResult
+{
+  std::string path;
+  std::string serial;
+  std::string title;
+  bool booted = false;
+  u32 frames_run = 0;
+  std::vector<std::pair<u32, u64>> frame_hashes;
+  std::vector<u32> mismatched_frames;
+
+  bool benchmarked = false;
+  double wall_time = 0.0;
+  double cpu_thread_time = 0.0;
+  double sw_thread_time = 0.0;
+  u64 dtlb_misses = 0;
+  std::array<double, static_cast<size_t>(System::ProfiledSubsystem::Count)> subsystem_times = {};
+};
+
+using FrameHashMap = std::unordered_map<u32, u64>;
+
+struct TuneCandidate
+{
+  const char* name;
+  void (*apply)(SettingsInterface& si);
+};
+
+struct TuneDimension
+{
+  const char* name;
+
+  // Quality options are listed from most to least demanding, and the first one which holds full speed is taken.
+  // Otherwise, every candidate is tried and the one with the lowest average frame time wins.
+  bool quality;
+
+  // Candidate used before this dimension has been tuned.
+  u32 initial;
+
+  std::vector<TuneCandidate> candidates;
+};
+
+struct TuneResult
+{
+  bool ran = false;
+  bool full_speed = false;
+  double mean = 0.0;
+  double stddev = 0.0;
+  double p99 = 0.0;
+};
+} // namespace
+
 static bool ParseCommandLineParameters(int argc, char* argv[], std::optional<SystemBootParameters>& autoboot);
 static void PrintCommandLineVersion();
 static void PrintCommandLineHelp(const char* progname);
@@ -39,13 +127,59 @@ static bool InitializeConfig();
 static void InitializeEarlyConsole();
 static void HookSignals();
 static bool SetFolders();
+static bool LoadBootList(const char* path);
+static void GetJobArguments(int argc, char* argv[]);
+static bool RunBoot(SystemBootParameters parameters);
+static bool RunJobs();
+static bool IsHashingFrames();
+static void StartBenchmark();
+static void StopBenchmark();
+static void RunStateBenchmark();
+static std::vector<TuneDimension> GetTuneDimensions();
+static TuneResult RunTuneCandidate(const SystemBootParameters& parameters, const std::vector<TuneDimension>& dimensions,
+                                   const std::vector<u32>& selection);
+static bool RunTune(const SystemBootParameters& parameters);
+static bool RunSPUWorkerCheck(const SystemBootParameters& parameters);
+static void StartDTLBMissCounters();
+static u64 StopDTLBMissCounters();
+static bool ReadReport(const char* path, std::vector<BootResult>* results);
+static bool WriteReport(const char* path);
 static std::string GetFrameDumpFilename(u32 frame);
 } // namespace RegTestHost
 
 static std::unique_ptr<MemorySettingsInterface> s_base_settings_interface;
 
-static u32 s_frames_to_run = 60 * 60;
+static u32 s_frames_per_boot = 60 * 60;
+static u32 s_frames_to_run = 0;
+static std::vector<std::string> s_boot_list;
+static std::vector<std::string> s_job_arguments;
+static u32 s_num_jobs = 1;
+static std::string s_report_path;
+static std::string s_baseline_path;
+static std::unordered_map<std::string, RegTestHost::FrameHashMap> s_baseline_hashes;
+static const RegTestHost::FrameHashMap* s_current_baseline = nullptr;
+static std::vector<RegTestHost::BootResult> s_boot_results;
 static u32 s_frame_dump_interval = 0;
+static bool s_benchmark = false;
+static u32 s_state_benchmark_iterations = 0;
+static bool s_tune = false;
+static Common::Timer s_tune_frame_timer;
+static std::vector<float> s_tune_frame_times;
+static float s_tune_frame_period = 0.0f;
+static bool s_spu_worker_check = false;
+static std::string s_movie_path;
+static std::string s_audio_dump_directory;
+#ifdef ENABLE_TRACING
+static std::string s_trace_path;
+#endif
+static constexpr std::array<const char*, static_cast<size_t>(System::ProfiledSubsystem::Count)> s_subsystem_names = {
+  {"codeCompileTime", "gpuCommandTime", "softwareRasterizerTime", "spuMixingTime", "cdromReadTime",
+   "achievementsTime"}};
+static Common::Timer s_benchmark_timer;
+static double s_benchmark_start_cpu_time = 0.0;
+#ifdef __linux__
+static std::array<int, 2> s_dtlb_miss_counters = {{-1, -1}};
+#endif
 static std::string s_dump_base_directory;
 static std::string s_dump_game_directory;
 
@@ -286,6 +420,12 @@ void Host::OnGameChanged(const std::string& disc_path, const std::string& game_s
   Log_InfoPrintf("Game Serial: %s", game_serial.c_str());
   Log_InfoPrintf("Game Name: %s", game_name.c_str());
 
+  if (!s_boot_results.empty())
+  {
+    s_boot_results.back().serial = game_serial;
+    s_boot_results.back().title = game_name;
+  }
+
   if (!s_dump_base_directory.empty())
   {
     s_dump_game_directory = Path::Combine(s_dump_base_directory, game_name);
@@ -302,9 +442,22 @@ void Host::OnGameChanged(const std::string& disc_path, const std::string& game_s
 
 void Host::PumpMessagesOnCPUThread()
 {
+  if (s_tune)
+    s_tune_frame_times.push_back(static_cast<float>(s_tune_frame_timer.GetTimeMillisecondsAndReset()));
+
   s_frames_to_run--;
   if (s_frames_to_run == 0)
+  {
+    if (s_tune)
+      s_tune_frame_period = 1000.0f / System::GetThrottleFrequency();
+    // the software renderer thread goes away with the system, so sample before shutting down
+    if (s_benchmark)
+      RegTestHost::StopBenchmark();
+    if (s_state_benchmark_iterations > 0)
+      RegTestHost::RunStateBenchmark();
+
     System::ShutdownSystem(false);
+  }
 }
 
 void Host::RunOnCPUThread(std::function<void()> function, bool block /* = false */)
@@ -358,11 +511,32 @@ void Host::ReleaseRenderWindow()
 void Host::BeginPresentFrame()
 {
   const u32 frame = System::GetFrameNumber();
-  if (s_frame_dump_interval > 0 && (s_frame_dump_interval == 1 || (frame % s_frame_dump_interval) == 0))
+  if (s_frame_dump_interval == 0 || (s_frame_dump_interval != 1 && (frame % s_frame_dump_interval) != 0))
+    return;
+
+  if (RegTestHost::IsHashingFrames())
   {
-    std::string dump_filename(RegTestHost::GetFrameDumpFilename(frame));
-    g_gpu->WriteDisplayTextureToFile(std::move(dump_filename));
+    u64 hash;
+    if (!g_gpu->GetDisplayTextureHash(&hash))
+      return;
+
+    RegTestHost::BootResult& result = s_boot_results.back();
+    result.frame_hashes.emplace_back(frame, hash);
+
+    // with a baseline, only frames which differ get written out
+    if (s_current_baseline)
+    {
+      const auto it = s_current_baseline->find(frame);
+      if (it != s_current_baseline->end() && it->second == hash)
+        return;
+
+      Log_WarningFmt("Frame {} hash {:016X} does not match baseline.", frame, hash);
+      result.mismatched_frames.push_back(frame);
+    }
   }
+
+  if (!s_dump_game_directory.empty())
+    g_gpu->WriteDisplayTextureToFile(RegTestHost::GetFrameDumpFilename(frame));
 }
 
 void Host::OpenURL(std::string_view url)
@@ -509,8 +683,32 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -dumpdir: Set frame dump base directory (will be dumped to basedir/gametitle).\n");
   std::fprintf(stderr, "  -dumpinterval: Dumps every N frames.\n");
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
+  std::fprintf(stderr, "  -bootlist <file|dir>: Runs each filename in the file (one per line), or each image in the\n"
+                       "    directory, in turn.\n");
+  std::fprintf(stderr, "  -jobs <count>: Runs boot list entries in this many processes at once.\n");
+  std::fprintf(stderr, "  -report <file>: Writes a JSON report with the hash of every dumped frame.\n");
+  std::fprintf(stderr, "  -baseline <file>: Compares frame hashes against a previous report, and only writes\n"
+                       "    frames which don't match.\n");
+  std::fprintf(stderr, "  -movie <file>: Plays back an input movie after booting, and fails if it desyncs.\n");
+  std::fprintf(stderr, "  -dumpaudio <dir>: Writes the audio of each boot to <dir>/<file title>.wav. Combined with\n"
+                       "    PSF files, renders music faster than real time.\n");
+  std::fprintf(stderr, "  -benchmark: Disables frame dumping and records timings for each boot, written to the\n"
+                       "    report when one is specified.\n");
+  std::fprintf(stderr, "  -statebenchmark <count>: Saves and loads a memory save state <count> times at the end\n"
+                       "    of each boot, and logs the throughput.\n");
+  std::fprintf(stderr, "  -tune: Runs the boot (usually with -movie) under a range of renderer, resolution scale,\n"
+                       "    PGXP, runahead and readahead settings, and writes the best configuration which holds\n"
+                       "    full speed to the game's settings file.\n");
+  std::fprintf(stderr, "  -spuworkercheck: Runs the boot with SPU mixing on the CPU thread, then on the worker\n"
+                       "    thread, and fails if the audio differs. Written to the -dumpaudio directory if set.\n");
+  std::fprintf(stderr, "  -hugepages: Backs RAM and the recompiler code buffer with huge pages, if available.\n");
+#ifdef ENABLE_TRACING
+  std::fprintf(stderr, "  -trace <file>: Captures a timeline trace of the whole run, in Chrome trace format.\n");
+#endif
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -nulldevice: Uses a GPU device which never touches the host GPU. Only works with the\n"
+                       "    software renderer, frame dumps and hashes are unaffected.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -559,7 +757,7 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
       else if (CHECK_ARG_PARAM("-dumpinterval"))
       {
         s_frame_dump_interval = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
-        if (s_frames_to_run <= 0)
+        if (s_frame_dump_interval <= 0)
         {
           Log_ErrorPrintf("Invalid dump interval specified: %s", argv[i]);
           return false;
@@ -569,8 +767,8 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
       }
       else if (CHECK_ARG_PARAM("-frames"))
       {
-        s_frames_to_run = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
-        if (s_frames_to_run == 0)
+        s_frames_per_boot = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_frames_per_boot == 0)
         {
           Log_ErrorPrintf("Invalid frame count specified: %s", argv[i]);
           return false;
@@ -578,6 +776,95 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-bootlist"))
+      {
+        if (!LoadBootList(argv[++i]))
+          return false;
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-jobs"))
+      {
+        s_num_jobs = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_num_jobs == 0)
+        {
+          Log_ErrorPrintf("Invalid job count specified: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-report"))
+      {
+        s_report_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-baseline"))
+      {
+        s_baseline_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-movie"))
+      {
+        s_movie_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-dumpaudio"))
+      {
+        s_audio_dump_directory = argv[++i];
+        if (s_audio_dump_directory.empty())
+        {
+          Log_ErrorPrintf("Invalid audio dump directory specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-benchmark"))
+      {
+        s_benchmark = true;
+        continue;
+      }
+      else if (CHECK_ARG("-tune"))
+      {
+        s_tune = true;
+        continue;
+      }
+      else if (CHECK_ARG("-spuworkercheck"))
+      {
+        s_spu_worker_check = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-statebenchmark"))
+      {
+        s_state_benchmark_iterations = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_state_benchmark_iterations == 0)
+        {
+          Log_ErrorPrintf("Invalid state benchmark iteration count: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-nulldevice"))
+      {
+        Log_InfoPrint("Using null GPU device.");
+        s_base_settings_interface->SetBoolValue("GPU", "UseNullDevice", true);
+        continue;
+      }
+      else if (CHECK_ARG("-hugepages"))
+      {
+        Log_InfoPrint("Enabling huge pages.");
+        s_base_settings_interface->SetBoolValue("CPU", "UseHugePages", true);
+        continue;
+      }
+#ifdef ENABLE_TRACING
+      else if (CHECK_ARG_PARAM("-trace"))
+      {
+        s_trace_path = argv[++i];
+        continue;
+      }
+#endif
       else if (CHECK_ARG_PARAM("-log"))
       {
         std::optional<LOGLEVEL> level = Settings::ParseLogLevelName(argv[++i]);
@@ -666,6 +953,798 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
   return true;
 }
 
+bool RegTestHost::LoadBootList(const char* path)
+{
+  if (FileSystem::DirectoryExists(path))
+  {
+    FileSystem::FindResultsArray files;
+    FileSystem::FindFiles(path, "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
+    for (FILESYSTEM_FIND_DATA& fd : files)
+    {
+      if (GameList::IsScannableFilename(fd.FileName))
+        s_boot_list.push_back(std::move(fd.FileName));
+    }
+
+    std::sort(s_boot_list.begin(), s_boot_list.end());
+    if (s_boot_list.empty())
+    {
+      Log_ErrorFmt("No images found in '{}'.", path);
+      return false;
+    }
+
+    return true;
+  }
+
+  Error error;
+  const std::optional<std::string> data = FileSystem::ReadFileToString(path, &error);
+  if (!data.has_value())
+  {
+    Log_ErrorFmt("Failed to read boot list '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  for (const std::string_view line : StringUtil::SplitString(data.value(), '\n'))
+  {
+    const std::string_view filename = StringUtil::StripWhitespace(line);
+    if (!filename.empty() && filename[0] != '#')
+      s_boot_list.emplace_back(filename);
+  }
+
+  if (s_boot_list.empty())
+  {
+    Log_ErrorFmt("Boot list '{}' is empty.", path);
+    return false;
+  }
+
+  return true;
+}
+
+void RegTestHost::GetJobArguments(int argc, char* argv[])
+{
+  // everything except the batch options and the boot path is passed through to job processes
+  // traces are per-process, so they aren't passed through either
+  static constexpr const char* param_options[] = {"-dumpdir", "-dumpinterval", "-frames", "-log",     "-renderer",
+                                                  "-upscale", "-cpu",          "-bootlist", "-jobs", "-report",
+                                                  "-baseline", "-trace", "-movie", "-statebenchmark", "-dumpaudio"};
+  static constexpr const char* batch_options[] = {"-bootlist", "-jobs", "-report", "-trace"};
+
+  s_job_arguments.push_back(FileSystem::GetProgramPath());
+  for (int i = 1; i < argc; i++)
+  {
+    if (!std::strcmp(argv[i], "--"))
+      break;
+    else if (argv[i][0] != '-')
+      continue;
+
+    const bool has_param =
+      ((i + 1) < argc && std::any_of(std::begin(param_options), std::end(param_options),
+                                     [arg = argv[i]](const char* opt) { return !std::strcmp(arg, opt); }));
+    const bool is_batch_option = std::any_of(std::begin(batch_options), std::end(batch_options),
+                                             [arg = argv[i]](const char* opt) { return !std::strcmp(arg, opt); });
+    if (!is_batch_option)
+    {
+      s_job_arguments.emplace_back(argv[i]);
+      if (has_param)
+        s_job_arguments.emplace_back(argv[i + 1]);
+    }
+
+    if (has_param)
+      i++;
+  }
+}
+
+bool RegTestHost::IsHashingFrames()
+{
+  return (!s_benchmark && !s_tune && (!s_report_path.empty() || !s_baseline_path.empty()));
+}
+
+void RegTestHost::StartBenchmark()
+{
+  System::SetSubsystemProfilingEnabled(true);
+  s_benchmark_start_cpu_time = System::GetCPUThreadCPUTime();
+  StartDTLBMissCounters();
+  s_benchmark_timer.Reset();
+}
+
+void RegTestHost::StopBenchmark()
+{
+  BootResult& result = s_boot_results.back();
+  result.benchmarked = true;
+  result.wall_time = s_benchmark_timer.GetTimeSeconds();
+  result.cpu_thread_time = System::GetCPUThreadCPUTime() - s_benchmark_start_cpu_time;
+  result.sw_thread_time = System::GetSWThreadCPUTime();
+  result.dtlb_misses = StopDTLBMissCounters();
+  for (size_t i = 0; i < result.subsystem_times.size(); i++)
+    result.subsystem_times[i] = System::GetSubsystemTime(static_cast<System::ProfiledSubsystem>(i));
+  System::SetSubsystemProfilingEnabled(false);
+
+  const u32 frames = s_frames_per_boot - s_frames_to_run;
+  Log_InfoFmt("Benchmark: {} frames in {:.2f} seconds, {:.2f} FPS, CPU thread {:.2f}s, SW thread {:.2f}s.", frames,
+              result.wall_time, (result.wall_time > 0.0) ? (static_cast<double>(frames) / result.wall_time) : 0.0,
+              result.cpu_thread_time, result.sw_thread_time);
+  if (result.dtlb_misses > 0)
+    Log_InfoFmt("Benchmark: {} dTLB misses on the CPU thread.", result.dtlb_misses);
+}
+
+void RegTestHost::RunStateBenchmark()
+{
+  // Same path as runahead and rewind, the first save allocates the buffer so it isn't timed.
+  System::MemorySaveState mss;
+  if (!System::SaveMemoryState(&mss))
+  {
+    Log_ErrorPrint("State benchmark: Failed to save memory state.");
+    return;
+  }
+
+  Common::Timer timer;
+  for (u32 i = 0; i < s_state_benchmark_iterations; i++)
+    System::SaveMemoryState(&mss);
+  const double save_time = timer.GetTimeSeconds();
+
+  timer.Reset();
+  for (u32 i = 0; i < s_state_benchmark_iterations; i++)
+    System::LoadMemoryState(mss);
+  const double load_time = timer.GetTimeSeconds();
+
+  const double size_mb = static_cast<double>(mss.state_stream->GetSize()) / 1048576.0;
+  const double total_mb = size_mb * static_cast<double>(s_state_benchmark_iterations);
+  Log_InfoFmt("State benchmark: {:.2f}MB state, save {:.1f}us ({:.0f}MB/s), load {:.1f}us ({:.0f}MB/s).", size_mb,
+              (save_time * 1000000.0) / s_state_benchmark_iterations, total_mb / save_time,
+              (load_time * 1000000.0) / s_state_benchmark_iterations, total_mb / load_time);
+}
+
+std::vector<RegTestHost::TuneDimension> RegTestHost::GetTuneDimensions()
+{
+  // Tuned in order, so the settings with the biggest impact are settled first.
+  return {
+    {"Renderer",
+     true,
+     1,
+     {{"Automatic",
+       [](SettingsInterface& si) {
+         si.SetStringValue("GPU", "Renderer", Settings::GetRendererName(GPURenderer::Automatic));
+       }},
+      {"Software",
+       [](SettingsInterface& si) {
+         si.SetStringValue("GPU", "Renderer", Settings::GetRendererName(GPURenderer::Software));
+       }}}},
+    {"Resolution Scale",
+     true,
+     3,
+     {{"4x", [](SettingsInterface& si) { si.SetIntValue("GPU", "ResolutionScale", 4); }},
+      {"3x", [](SettingsInterface& si) { si.SetIntValue("GPU", "ResolutionScale", 3); }},
+      {"2x", [](SettingsInterface& si) { si.SetIntValue("GPU", "ResolutionScale", 2); }},
+      {"1x", [](SettingsInterface& si) { si.SetIntValue("GPU", "ResolutionScale", 1); }}}},
+    {"PGXP",
+     true,
+     2,
+     {{"CPU Mode",
+       [](SettingsInterface& si) {
+         si.SetBoolValue("GPU", "PGXPEnable", true);
+         si.SetBoolValue("GPU", "PGXPCPU", true);
+       }},
+      {"Memory Mode",
+       [](SettingsInterface& si) {
+         si.SetBoolValue("GPU", "PGXPEnable", true);
+         si.SetBoolValue("GPU", "PGXPCPU", false);
+       }},
+      {"Disabled",
+       [](SettingsInterface& si) {
+         si.SetBoolValue("GPU", "PGXPEnable", false);
+         si.SetBoolValue("GPU", "PGXPCPU", false);
+       }}}},
+    {"Runahead",
+     true,
+     2,
+     {{"2 Frames", [](SettingsInterface& si) { si.SetIntValue("Main", "RunaheadFrameCount", 2); }},
+      {"1 Frame", [](SettingsInterface& si) { si.SetIntValue("Main", "RunaheadFrameCount", 1); }},
+      {"Disabled", [](SettingsInterface& si) { si.SetIntValue("Main", "RunaheadFrameCount", 0); }}}},
+    {"CD-ROM Readahead",
+     false,
+     1,
+     {{"Disabled", [](SettingsInterface& si) { si.SetIntValue("CDROM", "ReadaheadSectors", 0); }},
+      {"8 Sectors", [](SettingsInterface& si) { si.SetIntValue("CDROM", "ReadaheadSectors", 8); }},
+      {"16 Sectors", [](SettingsInterface& si) { si.SetIntValue("CDROM", "ReadaheadSectors", 16); }},
+      {"32 Sectors", [](SettingsInterface& si) { si.SetIntValue("CDROM", "ReadaheadSectors", 32); }}}},
+  };
+}
+
+RegTestHost::TuneResult RegTestHost::RunTuneCandidate(const SystemBootParameters& parameters,
+                                                      const std::vector<TuneDimension>& dimensions,
+                                                      const std::vector<u32>& selection)
+{
+  SmallString description;
+  for (size_t i = 0; i < dimensions.size(); i++)
+  {
+    dimensions[i].candidates[selection[i]].apply(*s_base_settings_interface);
+    description.append_format("{}{}: {}", description.empty() ? "" : ", ", dimensions[i].name,
+                              dimensions[i].candidates[selection[i]].name);
+  }
+
+  Log_InfoFmt("Tune: Trying {}", description);
+
+  TuneResult result;
+  s_tune_frame_times.clear();
+  s_tune_frame_period = 0.0f;
+  if (!RunBoot(parameters) || s_tune_frame_times.empty() || s_tune_frame_period <= 0.0f)
+  {
+    Log_WarningPrint("Tune: Run failed, skipping candidate.");
+    return result;
+  }
+
+  // The start of the run is dominated by block compilation and texture uploads, which every candidate pays.
+  std::vector<float> times(s_tune_frame_times.begin() + (s_tune_frame_times.size() / 10), s_tune_frame_times.end());
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  for (const float time : times)
+  {
+    sum += time;
+    sum_sq += static_cast<double>(time) * static_cast<double>(time);
+  }
+
+  const double count = static_cast<double>(times.size());
+  const size_t p99_index = std::min(times.size() - 1, (times.size() * 99) / 100);
+  std::nth_element(times.begin(), times.begin() + p99_index, times.end());
+
+  result.ran = true;
+  result.mean = sum / count;
+  result.stddev = std::sqrt(std::max(sum_sq / count - result.mean * result.mean, 0.0));
+  result.p99 = times[p99_index];
+  result.full_speed = (result.p99 <= s_tune_frame_period);
+  Log_InfoFmt("Tune: Mean {:.2f}ms, stddev {:.2f}ms, 99th percentile {:.2f}ms of {:.2f}ms, {}.", result.mean,
+              result.stddev, result.p99, s_tune_frame_period, result.full_speed ? "full speed" : "too slow");
+  return result;
+}
+
+bool RegTestHost::RunTune(const SystemBootParameters& parameters)
+{
+  const std::vector<TuneDimension> dimensions = GetTuneDimensions();
+  std::vector<u32> selection;
+  for (const TuneDimension& dim : dimensions)
+    selection.push_back(dim.initial);
+
+  // Greedy search, one dimension at a time, with the ones not yet tuned at their initial candidate.
+  // Exhaustively trying every combination would take hundreds of runs.
+  for (size_t i = 0; i < dimensions.size(); i++)
+  {
+    const TuneDimension& dim = dimensions[i];
+    std::optional<u32> best;
+    double best_mean = 0.0;
+    for (u32 j = 0; j < static_cast<u32>(dim.candidates.size()); j++)
+    {
+      selection[i] = j;
+      const TuneResult result = RunTuneCandidate(parameters, dimensions, selection);
+      if (!result.ran || !result.full_speed)
+        continue;
+
+      if (dim.quality)
+      {
+        best = j;
+        break;
+      }
+      else if (!best.has_value() || result.mean < best_mean)
+      {
+        best = j;
+        best_mean = result.mean;
+      }
+    }
+
+    // Nothing held full speed, so fall back to the least demanding quality option, or leave it alone.
+    selection[i] = best.value_or(dim.quality ? static_cast<u32>(dim.candidates.size() - 1) : dim.initial);
+    Log_InfoFmt("Tune: Selected {} for {}.", dim.candidates[selection[i]].name, dim.name);
+  }
+
+  const std::string serial = s_boot_results.empty() ? std::string() : s_boot_results.back().serial;
+  std::string path = serial.empty() ? std::string() : System::GetGameSettingsPath(serial);
+  if (path.empty())
+  {
+    Log_ErrorPrint("Tune: Game has no serial, can't write game settings.");
+    return false;
+  }
+
+  INISettingsInterface si(std::move(path));
+  if (FileSystem::FileExists(si.GetFileName().c_str()) && !si.Load())
+  {
+    Log_ErrorFmt("Tune: Failed to load existing game settings from '{}'.", si.GetFileName());
+    return false;
+  }
+
+  for (size_t i = 0; i < dimensions.size(); i++)
+    dimensions[i].candidates[selection[i]].apply(si);
+
+  if (!si.Save())
+  {
+    Log_ErrorFmt("Tune: Failed to write game settings to '{}'.", si.GetFileName());
+    return false;
+  }
+
+  Log_InfoFmt("Tune: Wrote game settings to '{}'.", si.GetFileName());
+  return true;
+}
+
+bool RegTestHost::RunSPUWorkerCheck(const SystemBootParameters& parameters)
+{
+  // The worker only changes which thread mixes, so the same boot has to produce exactly the same samples.
+  const std::string base_directory =
+    s_audio_dump_directory.empty() ? Path::Combine(EmuFolders::DataRoot, "spuworkercheck") : s_audio_dump_directory;
+  const std::string filename = fmt::format("{}.wav", Path::GetFileTitle(parameters.filename));
+  static constexpr std::array<const char*, 2> modes = {{"sync", "worker"}};
+  std::array<std::vector<u8>, 2> data;
+  for (size_t i = 0; i < modes.size(); i++)
+  {
+    s_base_settings_interface->SetBoolValue("Hacks", "UseSPUThread", (i != 0));
+    s_audio_dump_directory = Path::Combine(base_directory, modes[i]);
+    Log_InfoFmt("SPU worker check: Running with {} mixing.", modes[i]);
+    if (!RunBoot(parameters))
+      return false;
+
+    Error error;
+    const std::string path = Path::Combine(s_audio_dump_directory, filename);
+    std::optional<std::vector<u8>> file_data = FileSystem::ReadBinaryFile(path.c_str(), &error);
+    if (!file_data.has_value())
+    {
+      Log_ErrorFmt("SPU worker check: Failed to read '{}': {}", path, error.GetDescription());
+      return false;
+    }
+
+    data[i] = std::move(file_data.value());
+  }
+
+  // Both dumps have the same 44 byte header, followed by 16-bit stereo frames.
+  static constexpr size_t WAV_HEADER_SIZE = 44;
+  static constexpr size_t WAV_FRAME_SIZE = sizeof(s16) * 2;
+  const auto [sync_it, worker_it] = std::mismatch(data[0].begin(), data[0].end(), data[1].begin(), data[1].end());
+  if (sync_it == data[0].end() && worker_it == data[1].end())
+  {
+    Log_InfoFmt("SPU worker check: {} frames match.", (data[0].size() - WAV_HEADER_SIZE) / WAV_FRAME_SIZE);
+    return true;
+  }
+
+  const size_t offset = static_cast<size_t>(std::distance(data[0].begin(), sync_it));
+  if (offset < WAV_HEADER_SIZE)
+  {
+    Log_ErrorFmt("SPU worker check: Lengths differ, {} bytes synchronous vs {} bytes worker.", data[0].size(),
+                 data[1].size());
+  }
+  else
+  {
+    Log_ErrorFmt("SPU worker check: Audio differs from frame {}.", (offset - WAV_HEADER_SIZE) / WAV_FRAME_SIZE);
+  }
+
+  return false;
+}
+
+void RegTestHost::StartDTLBMissCounters()
+{
+#ifdef __linux__
+  // Only counts the calling thread, which runs the CPU, and whatever it calls into (compiling, GPU commands, etc).
+  static constexpr std::array<u64, 2> ops = {{PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_OP_WRITE}};
+  for (size_t i = 0; i < ops.size(); i++)
+  {
+    perf_event_attr attr = {};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (ops[i] << 8) | (static_cast<u64>(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd < 0)
+    {
+      // Not all CPUs count stores, and perf_event_paranoid can disallow it entirely.
+      Log_WarningFmt("perf_event_open() for dTLB misses failed: {}", errno);
+      continue;
+    }
+
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    s_dtlb_miss_counters[i] = fd;
+  }
+#endif
+}
+
+u64 RegTestHost::StopDTLBMissCounters()
+{
+  u64 total = 0;
+#ifdef __linux__
+  for (int& fd : s_dtlb_miss_counters)
+  {
+    if (fd < 0)
+      continue;
+
+    u64 count = 0;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) == sizeof(count))
+      total += count;
+
+    close(fd);
+    fd = -1;
+  }
+#endif
+  return total;
+}
+
+bool RegTestHost::RunBoot(SystemBootParameters parameters)
+{
+  BootResult& result = s_boot_results.emplace_back();
+  result.path = parameters.filename;
+  s_dump_game_directory = {};
+
+  if (!s_baseline_path.empty())
+  {
+    // anything missing from the baseline counts as a mismatch
+    s_current_baseline = &s_baseline_hashes[result.path];
+  }
+
+  Error error;
+  Log_InfoPrintf("Trying to boot '%s'...", parameters.filename.c_str());
+  if (!System::BootSystem(std::move(parameters), &error))
+  {
+    Log_ErrorFmt("Failed to boot system: {}", error.GetDescription());
+    return false;
+  }
+
+  result.booted = true;
+
+  if (!s_movie_path.empty())
+  {
+    if (!InputMovie::StartPlayback(s_movie_path.c_str(), &error))
+    {
+      Log_ErrorFmt("Failed to play back input movie: {}", error.GetDescription());
+      System::ShutdownSystem(false);
+      return false;
+    }
+  }
+
+  if (!s_audio_dump_directory.empty())
+  {
+    const std::string path =
+      Path::Combine(s_audio_dump_directory, fmt::format("{}.wav", Path::GetFileTitle(result.path)));
+    if (!FileSystem::EnsureDirectoryExists(s_audio_dump_directory.c_str(), false) ||
+        !SPU::StartDumpingAudio(path.c_str()))
+    {
+      Log_ErrorFmt("Failed to start dumping audio to '{}'.", path);
+      System::ShutdownSystem(false);
+      return false;
+    }
+  }
+
+  s_frames_to_run = s_frames_per_boot;
+  Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
+  if (s_benchmark)
+    StartBenchmark();
+  if (s_tune)
+    s_tune_frame_timer.Reset();
+  System::Execute();
+  s_boot_results.back().frames_run = s_frames_per_boot - s_frames_to_run;
+
+  if (!s_movie_path.empty() && InputMovie::GetDesyncFrame().has_value())
+  {
+    Log_ErrorFmt("Input movie desynced at frame {}.", InputMovie::GetDesyncFrame().value());
+    return false;
+  }
+
+  return true;
+}
+
+bool RegTestHost::RunJobs()
+{
+  struct Job
+  {
+#ifdef _WIN32
+    HANDLE process;
+#else
+    pid_t pid;
+#endif
+    size_t index;
+    std::string report_path;
+  };
+
+  const std::string report_base =
+    s_report_path.empty() ? Path::Combine(EmuFolders::DataRoot, "regtest") : s_report_path;
+  std::vector<Job> jobs;
+  std::vector<std::vector<BootResult>> job_results(s_boot_list.size());
+  size_t next_index = 0;
+  bool result = true;
+
+  Log_InfoFmt("Running {} boot list entries with {} jobs.", s_boot_list.size(), s_num_jobs);
+
+  while (next_index < s_boot_list.size() || !jobs.empty())
+  {
+    while (next_index < s_boot_list.size() && jobs.size() < s_num_jobs)
+    {
+      Job job;
+      job.index = next_index++;
+      job.report_path = fmt::format("{}.job{}.json", report_base, job.index);
+
+      std::vector<std::string> args = s_job_arguments;
+      args.insert(args.end(), {"-report", job.report_path, "--", s_boot_list[job.index]});
+
+#ifdef _WIN32
+      std::wstring command_line;
+      for (const std::string& arg : args)
+      {
+        // quote everything, backslashes only need escaping before a quote
+        if (!command_line.empty())
+          command_line += L' ';
+        command_line += L'"';
+        const std::wstring warg = StringUtil::UTF8StringToWideString(arg);
+        size_t num_backslashes = 0;
+        for (const wchar_t ch : warg)
+        {
+          if (ch == L'\\')
+          {
+            num_backslashes++;
+            continue;
+          }
+
+          command_line.append((ch == L'"') ? (num_backslashes * 2 + 1) : num_backslashes, L'\\');
+          command_line += ch;
+          num_backslashes = 0;
+        }
+        command_line.append(num_backslashes * 2, L'\\');
+        command_line += L'"';
+      }
+
+      STARTUPINFOW si = {};
+      si.cb = sizeof(si);
+      PROCESS_INFORMATION pi = {};
+      if (!CreateProcessW(nullptr, command_line.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi))
+      {
+        Log_ErrorFmt("Failed to start job for '{}': {}", s_boot_list[job.index], GetLastError());
+        job_results[job.index].emplace_back().path = s_boot_list[job.index];
+        result = false;
+        continue;
+      }
+
+      CloseHandle(pi.hThread);
+      job.process = pi.hProcess;
+#else
+      std::vector<char*> argv;
+      for (std::string& arg : args)
+        argv.push_back(arg.data());
+      argv.push_back(nullptr);
+
+      if (const int err = posix_spawn(&job.pid, argv[0], nullptr, nullptr, argv.data(), environ); err != 0)
+      {
+        Log_ErrorFmt("Failed to start job for '{}': {}", s_boot_list[job.index], err);
+        job_results[job.index].emplace_back().path = s_boot_list[job.index];
+        result = false;
+        continue;
+      }
+#endif
+
+      jobs.push_back(std::move(job));
+    }
+
+    if (jobs.empty())
+      break;
+
+    // wait for any job to finish
+    int exit_code;
+    size_t finished;
+#ifdef _WIN32
+    std::vector<HANDLE> handles;
+    for (const Job& job : jobs)
+      handles.push_back(job.process);
+
+    finished = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE) -
+               WAIT_OBJECT_0;
+    if (finished >= jobs.size())
+    {
+      Log_ErrorFmt("WaitForMultipleObjects() failed: {}", GetLastError());
+      return false;
+    }
+
+    DWORD process_exit_code = 0;
+    GetExitCodeProcess(jobs[finished].process, &process_exit_code);
+    CloseHandle(jobs[finished].process);
+    exit_code = static_cast<int>(process_exit_code);
+#else
+    int status;
+    const pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0)
+    {
+      Log_ErrorFmt("waitpid() failed: {}", errno);
+      return false;
+    }
+
+    finished = static_cast<size_t>(
+      std::find_if(jobs.begin(), jobs.end(), [pid](const Job& job) { return job.pid == pid; }) - jobs.begin());
+    if (finished == jobs.size())
+      continue;
+
+    exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+
+    const Job& job = jobs[finished];
+    if (exit_code != 0)
+    {
+      Log_ErrorFmt("Job for '{}' exited with code {}.", s_boot_list[job.index], exit_code);
+      result = false;
+    }
+
+    // a job which crashed won't have written a report
+    if (!ReadReport(job.report_path.c_str(), &job_results[job.index]) || job_results[job.index].empty())
+    {
+      BootResult& br = job_results[job.index].emplace_back();
+      br.path = s_boot_list[job.index];
+    }
+    FileSystem::DeleteFile(job.report_path.c_str());
+
+    jobs.erase(jobs.begin() + finished);
+  }
+
+  // keep the report in boot list order, regardless of which jobs finished first
+  for (std::vector<BootResult>& results : job_results)
+    std::move(results.begin(), results.end(), std::back_inserter(s_boot_results));
+
+  return result;
+}
+
+bool RegTestHost::ReadReport(const char* path, std::vector<BootResult>* results)
+{
+  Error error;
+  const std::optional<std::string> data = FileSystem::ReadFileToString(path, &error);
+  if (!data.has_value())
+  {
+    Log_ErrorFmt("Failed to read report '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  rapidjson::Document doc;
+  doc.Parse(data->c_str(), data->size());
+  if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("results") || !doc["results"].IsArray())
+  {
+    Log_ErrorFmt("Report '{}' is not valid.", path);
+    return false;
+  }
+
+  for (const rapidjson::Value& entry : doc["results"].GetArray())
+  {
+    if (!entry.IsObject() || !entry.HasMember("path") || !entry["path"].IsString())
+      continue;
+
+    BootResult& result = results->emplace_back();
+    result.path = entry["path"].GetString();
+    if (entry.HasMember("serial") && entry["serial"].IsString())
+      result.serial = entry["serial"].GetString();
+    if (entry.HasMember("title") && entry["title"].IsString())
+      result.title = entry["title"].GetString();
+    if (entry.HasMember("booted") && entry["booted"].IsBool())
+      result.booted = entry["booted"].GetBool();
+    if (entry.HasMember("frames") && entry["frames"].IsUint())
+      result.frames_run = entry["frames"].GetUint();
+
+    if (entry.HasMember("hashes") && entry["hashes"].IsObject())
+    {
+      for (const auto& it : entry["hashes"].GetObject())
+      {
+        const std::optional<u32> frame = StringUtil::FromChars<u32>(it.name.GetString());
+        const std::optional<u64> hash =
+          it.value.IsString() ? StringUtil::FromChars<u64>(it.value.GetString(), 16) : std::nullopt;
+        if (frame.has_value() && hash.has_value())
+          result.frame_hashes.emplace_back(frame.value(), hash.value());
+      }
+    }
+
+    if (entry.HasMember("mismatches") && entry["mismatches"].IsArray())
+    {
+      for (const rapidjson::Value& frame : entry["mismatches"].GetArray())
+      {
+        if (frame.IsUint())
+          result.mismatched_frames.push_back(frame.GetUint());
+      }
+    }
+
+    if (entry.HasMember("benchmark") && entry["benchmark"].IsObject())
+    {
+      const rapidjson::Value& benchmark = entry["benchmark"];
+      const auto get_time = [&benchmark](const char* name) {
+        return (benchmark.HasMember(name) && benchmark[name].IsNumber()) ? benchmark[name].GetDouble() : 0.0;
+      };
+
+      result.benchmarked = true;
+      result.wall_time = get_time("wallTime");
+      result.cpu_thread_time = get_time("cpuThreadTime");
+      result.sw_thread_time = get_time("swThreadTime");
+      result.dtlb_misses = (benchmark.HasMember("dtlbMisses") && benchmark["dtlbMisses"].IsUint64()) ?
+                             benchmark["dtlbMisses"].GetUint64() :
+                             0;
+      for (size_t i = 0; i < result.subsystem_times.size(); i++)
+        result.subsystem_times[i] = get_time(s_subsystem_names[i]);
+    }
+  }
+
+  return true;
+}
+
+bool RegTestHost::WriteReport(const char* path)
+{
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("results");
+  writer.StartArray();
+  for (const BootResult& result : s_boot_results)
+  {
+    writer.StartObject();
+    writer.Key("path");
+    writer.String(result.path.c_str(), static_cast<rapidjson::SizeType>(result.path.size()));
+    writer.Key("serial");
+    writer.String(result.serial.c_str(), static_cast<rapidjson::SizeType>(result.serial.size()));
+    writer.Key("title");
+    writer.String(result.title.c_str(), static_cast<rapidjson::SizeType>(result.title.size()));
+    writer.Key("booted");
+    writer.Bool(result.booted);
+    writer.Key("frames");
+    writer.Uint(result.frames_run);
+
+    // hashes are strings, 64-bit integers don't survive most JSON parsers
+    writer.Key("hashes");
+    writer.StartObject();
+    for (const auto& [frame, hash] : result.frame_hashes)
+    {
+      writer.Key(fmt::format("{}", frame).c_str());
+      writer.String(fmt::format("{:016X}", hash).c_str());
+    }
+    writer.EndObject();
+
+    writer.Key("mismatches");
+    writer.StartArray();
+    for (const u32 frame : result.mismatched_frames)
+      writer.Uint(frame);
+    writer.EndArray();
+
+    if (result.benchmarked)
+    {
+      // compile, GPU command and SPU time are spent on the CPU thread, the rest of it is CPU/recompiled code
+      double cpu_execution_time = result.cpu_thread_time;
+      for (const System::ProfiledSubsystem subsystem :
+           {System::ProfiledSubsystem::CodeCompile, System::ProfiledSubsystem::GPUCommands,
+            System::ProfiledSubsystem::SPUMixing})
+      {
+        cpu_execution_time -= result.subsystem_times[static_cast<size_t>(subsystem)];
+      }
+
+      writer.Key("benchmark");
+      writer.StartObject();
+      writer.Key("wallTime");
+      writer.Double(result.wall_time);
+      writer.Key("fps");
+      writer.Double((result.wall_time > 0.0) ? (static_cast<double>(result.frames_run) / result.wall_time) : 0.0);
+      writer.Key("cpuThreadTime");
+      writer.Double(result.cpu_thread_time);
+      writer.Key("cpuExecutionTime");
+      writer.Double(std::max(cpu_execution_time, 0.0));
+      writer.Key("swThreadTime");
+      writer.Double(result.sw_thread_time);
+      writer.Key("dtlbMisses");
+      writer.Uint64(result.dtlb_misses);
+      for (size_t i = 0; i < result.subsystem_times.size(); i++)
+      {
+        writer.Key(s_subsystem_names[i]);
+        writer.Double(result.subsystem_times[i]);
+      }
+      writer.EndObject();
+    }
+
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  if (!FileSystem::WriteStringToFile(path, std::string_view(buffer.GetString(), buffer.GetSize())))
+  {
+    Log_ErrorFmt("Failed to write report to '{}'.", path);
+    return false;
+  }
+
+  Log_InfoFmt("Wrote report for {} boots to '{}'.", s_boot_results.size(), path);
+  return true;
+}
+
 std::string RegTestHost::GetFrameDumpFilename(u32 frame)
 {
   return Path::Combine(s_dump_game_directory, fmt::format("frame_{:05d}.png", frame));
@@ -681,13 +1760,63 @@ int main(int argc, char* argv[])
   std::optional<SystemBootParameters> autoboot;
   if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
     return EXIT_FAILURE;
+  RegTestHost::GetJobArguments(argc, argv);
 
-  if (!autoboot || autoboot->filename.empty())
+  if ((!autoboot || autoboot->filename.empty()) && s_boot_list.empty())
   {
     Log_ErrorPrint("No boot path specified.");
     return EXIT_FAILURE;
   }
 
+  if (s_frame_dump_interval > 0 && s_dump_base_directory.empty() && !RegTestHost::IsHashingFrames())
+  {
+    Log_ErrorPrint("Dump directory not specified.");
+    return EXIT_FAILURE;
+  }
+
+  // hash every frame by default when writing a report
+  if (s_frame_dump_interval == 0 && RegTestHost::IsHashingFrames())
+    s_frame_dump_interval = 1;
+
+  if (s_tune && (!autoboot || autoboot->filename.empty() || !s_boot_list.empty()))
+  {
+    Log_ErrorPrint("Tuning requires a single boot path, and can't be used with a boot list.");
+    return EXIT_FAILURE;
+  }
+
+  if (s_spu_worker_check && (s_tune || !autoboot || autoboot->filename.empty() || !s_boot_list.empty()))
+  {
+    Log_ErrorPrint("The SPU worker check requires a single boot path, and can't be used with a boot list or tuning.");
+    return EXIT_FAILURE;
+  }
+
+  if (s_num_jobs > 1 && !s_boot_list.empty())
+  {
+    // the jobs do the actual emulation, all we need to do is collect the results
+    if (autoboot && !autoboot->filename.empty())
+      s_boot_list.insert(s_boot_list.begin(), std::move(autoboot->filename));
+
+    int result = RegTestHost::RunJobs() ? 0 : -1;
+    if (!s_report_path.empty() && !RegTestHost::WriteReport(s_report_path.c_str()))
+      result = -1;
+
+    return result;
+  }
+
+  if (!s_baseline_path.empty())
+  {
+    std::vector<RegTestHost::BootResult> baseline;
+    if (!RegTestHost::ReadReport(s_baseline_path.c_str(), &baseline))
+      return EXIT_FAILURE;
+
+    for (const RegTestHost::BootResult& br : baseline)
+    {
+      RegTestHost::FrameHashMap& hashes = s_baseline_hashes[br.path];
+      for (const auto& [frame, hash] : br.frame_hashes)
+        hashes.emplace(frame, hash);
+    }
+  }
+
   {
     Error startup_error;
     if (!System::Internal::PerformEarlyHardwareChecks(&startup_error) ||
@@ -700,33 +1829,64 @@ int main(int argc, char* argv[])
 
   RegTestHost::HookSignals();
 
-  Error error;
-  int result = -1;
-  Log_InfoPrintf("Trying to boot '%s'...", autoboot->filename.c_str());
-  if (!System::BootSystem(std::move(autoboot.value()), &error))
+  if (s_frame_dump_interval > 0 && !s_dump_base_directory.empty())
+    Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
+
+#ifdef ENABLE_TRACING
+  if (!s_trace_path.empty())
+    Trace::StartCapture();
+#endif
+
+  // boot list entries share the process, so the game database, BIOS lookups and device setup are only paid once
+  int result = 0;
+  if (s_tune)
   {
-    Log_ErrorFmt("Failed to boot system: {}", error.GetDescription());
-    goto cleanup;
+    if (!RegTestHost::RunTune(autoboot.value()))
+      result = -1;
+  }
+  else if (s_spu_worker_check)
+  {
+    if (!RegTestHost::RunSPUWorkerCheck(autoboot.value()))
+      result = -1;
+  }
+  else if (autoboot && !autoboot->filename.empty() && !RegTestHost::RunBoot(std::move(autoboot.value())))
+  {
+    result = -1;
   }
 
-  if (s_frame_dump_interval > 0)
+  u32 failed_boots = 0;
+  for (const std::string& filename : s_boot_list)
   {
-    if (s_dump_base_directory.empty())
+    SystemBootParameters parameters;
+    parameters.filename = filename;
+    if (!RegTestHost::RunBoot(std::move(parameters)))
     {
-      Log_ErrorPrint("Dump directory not specified.");
-      goto cleanup;
+      failed_boots++;
+      result = -1;
     }
-
-    Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
   }
 
-  Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
-  System::Execute();
+  if (!s_boot_list.empty())
+    Log_InfoFmt("Ran {} of {} boot list entries.", s_boot_list.size() - failed_boots, s_boot_list.size());
+
+  if (!s_report_path.empty() && !RegTestHost::WriteReport(s_report_path.c_str()))
+    result = -1;
+
+#ifdef ENABLE_TRACING
+  if (!s_trace_path.empty())
+  {
+    Error error;
+    if (!Trace::StopCapture(s_trace_path.c_str(), &error))
+    {
+      Log_ErrorFmt("Failed to write trace to '{}': {}", s_trace_path, error.GetDescription());
+      result = -1;
+    }
+  }
+#endif
 
-  Log_InfoPrintf("Exiting with success.");
-  result = 0;
+  if (result == 0)
+    Log_InfoPrintf("Exiting with success.");
 
-cleanup:
   System::Internal::CPUThreadShutdown();
   return result;
 }
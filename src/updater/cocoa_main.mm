@@ -96,7 +96,8 @@ int main(int argc, char* argv[])
       return;
     }
 
-    if (!updater.ClearDestinationDirectory())
+    // Delta updates only contain the files which changed, the rest of the installation has to stay.
+    if (!updater.IsDeltaUpdate() && !updater.ClearDestinationDirectory())
     {
       progress.ModalError("Failed to clear destination directory. Your installation may be corrupted, please "
                           "re-download a fresh version from GitHub.");
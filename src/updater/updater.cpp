@@ -3,18 +3,21 @@
 
 #include "updater.h"
 
+#include "common/binary_delta.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/minizip_helpers.h"
 #include "common/path.h"
 #include "common/progress_callback.h"
+#include "common/sha1_digest.h"
 #include "common/string_util.h"
 
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -32,6 +35,41 @@
 #include "common/cocoa_tools.h"
 #endif
 
+// Converts a path in the zip to one relative to the destination directory. Returns nullopt for directories, and for
+// files which are not installed by the updater.
+static std::optional<std::string> GetDestinationFilename(std::string_view zip_filename)
+{
+  // replace forward slashes with backslashes
+  std::string filename(zip_filename);
+  for (char& ch : filename)
+  {
+    if (ch == '/' || ch == '\\')
+      ch = FS_OSPATH_SEPARATOR_CHARACTER;
+  }
+
+  // should never have a leading slash. just in case.
+  while (!filename.empty() && filename.front() == FS_OSPATH_SEPARATOR_CHARACTER)
+    filename.erase(0, 1);
+
+  // skip directories (we sort them out later)
+  if (filename.empty() || filename.back() == FS_OSPATH_SEPARATOR_CHARACTER)
+    return std::nullopt;
+
+#ifdef _WIN32
+  // skip updater itself, since it was already pre-extracted.
+  if (StringUtil::Strcasecmp(filename.c_str(), "updater.exe") == 0)
+    return std::nullopt;
+#elif defined(__APPLE__)
+  // on MacOS, we want to remove the DuckStation.app prefix.
+  static constexpr std::string_view PREFIX_PATH = "DuckStation.app/";
+  if (!filename.starts_with(PREFIX_PATH))
+    return std::nullopt;
+  filename.erase(0, PREFIX_PATH.length());
+#endif
+
+  return filename;
+}
+
 Updater::Updater(ProgressCallback* progress) : m_progress(progress)
 {
   progress->SetTitle("DuckStation Update Installer");
@@ -163,6 +201,7 @@ bool Updater::ParseZip()
     return {};
   }
 
+  bool has_delta_manifest = false;
   for (;;)
   {
     char zip_filename_buffer[256];
@@ -177,18 +216,6 @@ bool Updater::ParseZip()
     FileToUpdate entry;
     entry.original_zip_filename = zip_filename_buffer;
 
-    // replace forward slashes with backslashes
-    size_t len = std::strlen(zip_filename_buffer);
-    for (size_t i = 0; i < len; i++)
-    {
-      if (zip_filename_buffer[i] == '/' || zip_filename_buffer[i] == '\\')
-        zip_filename_buffer[i] = FS_OSPATH_SEPARATOR_CHARACTER;
-    }
-
-    // should never have a leading slash. just in case.
-    while (zip_filename_buffer[0] == FS_OSPATH_SEPARATOR_CHARACTER)
-      std::memmove(&zip_filename_buffer[1], &zip_filename_buffer[0], --len);
-
 #ifdef _WIN32
     entry.file_mode = 0;
 #else
@@ -198,27 +225,15 @@ bool Updater::ParseZip()
       ((file_info.external_fa >> 16) & 0x01FFu) & PERMISSION_MASK; // https://stackoverflow.com/a/28753385
 #endif
 
-    // skip directories (we sort them out later)
-    if (len > 0 && zip_filename_buffer[len - 1] != FS_OSPATH_SEPARATOR_CHARACTER)
+    if (entry.original_zip_filename == BinaryDelta::MANIFEST_FILENAME)
     {
-      bool process_file = true;
-      const char* filename_to_add = zip_filename_buffer;
-#ifdef _WIN32
-      // skip updater itself, since it was already pre-extracted.
-      process_file = process_file && (StringUtil::Strcasecmp(zip_filename_buffer, "updater.exe") != 0);
-#elif defined(__APPLE__)
-      // on MacOS, we want to remove the DuckStation.app prefix.
-      static constexpr const char* PREFIX_PATH = "DuckStation.app/";
-      const size_t prefix_length = std::strlen(PREFIX_PATH);
-      process_file = process_file && (std::strncmp(zip_filename_buffer, PREFIX_PATH, prefix_length) == 0);
-      filename_to_add += prefix_length;
-#endif
-      if (process_file)
-      {
-        entry.destination_filename = filename_to_add;
-        m_progress->DisplayFormattedInformation("Found file in zip: '%s'", entry.destination_filename.c_str());
-        m_update_paths.push_back(std::move(entry));
-      }
+      has_delta_manifest = true;
+    }
+    else if (std::optional<std::string> destination_filename = GetDestinationFilename(entry.original_zip_filename))
+    {
+      entry.destination_filename = std::move(destination_filename.value());
+      m_progress->DisplayFormattedInformation("Found file in zip: '%s'", entry.destination_filename.c_str());
+      m_update_paths.push_back(std::move(entry));
     }
 
     int res = unzGoToNextFile(m_zf);
@@ -231,7 +246,11 @@ bool Updater::ParseZip()
     }
   }
 
-  if (m_update_paths.empty())
+  if (has_delta_manifest && !ParseDeltaManifest())
+    return false;
+
+  // a delta can consist only of removals
+  if (m_update_paths.empty() && m_remove_paths.empty())
   {
     m_progress->ModalError("No files found in update zip.");
     return false;
@@ -261,6 +280,166 @@ bool Updater::ParseZip()
   return true;
 }
 
+bool Updater::ParseDeltaManifest()
+{
+  Error error;
+  FileToUpdate manifest_file = {};
+  manifest_file.original_zip_filename = BinaryDelta::MANIFEST_FILENAME;
+  std::vector<u8> manifest_data;
+  std::optional<std::vector<BinaryDelta::ManifestEntry>> manifest;
+  if (!ReadCurrentZipFile(manifest_file, &manifest_data) ||
+      !(manifest = BinaryDelta::ParseManifest(
+          std::string_view(reinterpret_cast<const char*>(manifest_data.data()), manifest_data.size()), &error)))
+  {
+    m_progress->DisplayFormattedModalError("Failed to parse delta manifest: %s", error.GetDescription().c_str());
+    return false;
+  }
+
+  m_progress->DisplayFormattedInformation("Delta update with %zu files.", manifest->size());
+
+  // Every file in the zip needs a hash, otherwise a broken patch could be installed.
+  for (FileToUpdate& ftu : m_update_paths)
+  {
+    std::string_view path = ftu.original_zip_filename;
+    const bool is_patch = path.ends_with(BinaryDelta::PATCH_SUFFIX);
+    if (is_patch)
+    {
+      path.remove_suffix(std::strlen(BinaryDelta::PATCH_SUFFIX));
+      ftu.destination_filename.resize(ftu.destination_filename.length() - std::strlen(BinaryDelta::PATCH_SUFFIX));
+    }
+
+    const auto it = std::find_if(manifest->begin(), manifest->end(),
+                                 [&path](const BinaryDelta::ManifestEntry& entry) { return (entry.path == path); });
+    if (it == manifest->end() || it->IsRemoved() || is_patch == it->source_hash.empty())
+    {
+      m_progress->DisplayFormattedModalError("File '%s' is missing or mismatched in delta manifest.",
+                                             ftu.original_zip_filename.c_str());
+      return false;
+    }
+
+    ftu.target_hash = it->target_hash;
+    ftu.source_hash = it->source_hash;
+  }
+
+  // Files which are no longer part of the release get deleted on commit, everything else has to be in the zip.
+  for (const BinaryDelta::ManifestEntry& entry : manifest.value())
+  {
+    std::optional<std::string> destination_filename = GetDestinationFilename(entry.path);
+    if (!destination_filename.has_value())
+      continue;
+
+    if (entry.IsRemoved())
+    {
+      m_progress->DisplayFormattedInformation("File removed in update: '%s'", destination_filename->c_str());
+      m_remove_paths.push_back(std::move(destination_filename.value()));
+      continue;
+    }
+
+    const std::string zip_filename =
+      entry.source_hash.empty() ? entry.path : (entry.path + BinaryDelta::PATCH_SUFFIX);
+    if (std::none_of(m_update_paths.begin(), m_update_paths.end(),
+                     [&zip_filename](const FileToUpdate& ftu) { return (ftu.original_zip_filename == zip_filename); }))
+    {
+      m_progress->DisplayFormattedModalError("File '%s' in delta manifest is missing from the zip.",
+                                             zip_filename.c_str());
+      return false;
+    }
+  }
+
+  m_is_delta_update = true;
+  return true;
+}
+
+bool Updater::ReadCurrentZipFile(const FileToUpdate& ftu, std::vector<u8>* data)
+{
+  unz_file_info64 file_info;
+  if (unzLocateFile(m_zf, ftu.original_zip_filename.c_str(), 0) != UNZ_OK ||
+      unzGetCurrentFileInfo64(m_zf, &file_info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK ||
+      unzOpenCurrentFile(m_zf) != UNZ_OK)
+  {
+    m_progress->DisplayFormattedModalError("Unable to open file '%s' in zip", ftu.original_zip_filename.c_str());
+    return false;
+  }
+
+  data->resize(static_cast<size_t>(file_info.uncompressed_size));
+  const int byte_count = data->empty() ? 0 : unzReadCurrentFile(m_zf, data->data(), static_cast<u32>(data->size()));
+  unzCloseCurrentFile(m_zf);
+  if (byte_count < 0 || static_cast<size_t>(byte_count) != data->size())
+  {
+    m_progress->DisplayFormattedModalError("Failed to read file '%s' from zip", ftu.original_zip_filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool Updater::StagePatchedFile(const FileToUpdate& ftu, const std::string& destination_file)
+{
+  m_progress->DisplayFormattedInformation("Patching '%s'...", ftu.destination_filename.c_str());
+
+  // Staging happens before anything in the destination is touched, so failing here leaves the install intact.
+  const std::string source_file = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s", m_destination_directory.c_str(), ftu.destination_filename.c_str());
+  if (!FileSystem::FileExists(source_file.c_str()))
+  {
+    m_progress->DisplayFormattedModalError(
+      "'%s' is missing, so it cannot be patched. Please install the full update.", source_file.c_str());
+    return false;
+  }
+
+  Error error;
+  const std::optional<std::vector<u8>> source_data = FileSystem::ReadBinaryFile(source_file.c_str(), &error);
+  if (!source_data.has_value())
+  {
+    m_progress->DisplayFormattedModalError("Failed to read '%s' for patching: %s", source_file.c_str(),
+                                           error.GetDescription().c_str());
+    return false;
+  }
+  else if (!StringUtil::EqualNoCase(BinaryDelta::GetHash(source_data.value()), ftu.source_hash))
+  {
+    m_progress->DisplayFormattedModalError(
+      "'%s' does not match the version this delta update was made for. Please install the full update.",
+      source_file.c_str());
+    return false;
+  }
+
+  std::vector<u8> patch_data;
+  if (!ReadCurrentZipFile(ftu, &patch_data))
+    return false;
+
+  std::vector<u8> patched_data;
+  if (!BinaryDelta::ApplyPatch(source_data.value(), patch_data, &patched_data, &error))
+  {
+    m_progress->DisplayFormattedModalError("Failed to patch '%s': %s", ftu.destination_filename.c_str(),
+                                           error.GetDescription().c_str());
+    return false;
+  }
+  else if (!StringUtil::EqualNoCase(BinaryDelta::GetHash(patched_data), ftu.target_hash))
+  {
+    m_progress->DisplayFormattedModalError("Patched '%s' does not match the expected hash.",
+                                           ftu.destination_filename.c_str());
+    return false;
+  }
+
+  if (!FileSystem::WriteBinaryFile(destination_file.c_str(), patched_data.data(), patched_data.size()))
+  {
+    m_progress->DisplayFormattedModalError("Failed to write staging output file '%s'", destination_file.c_str());
+    return false;
+  }
+
+#ifndef _WIN32
+  if (ftu.file_mode != 0 && chmod(destination_file.c_str(), ftu.file_mode) != 0)
+  {
+    m_progress->DisplayFormattedModalError("Failed to set mode for file '%s' to %u: errno %d",
+                                           destination_file.c_str(), ftu.file_mode, errno);
+    FileSystem::DeleteFile(destination_file.c_str());
+    return false;
+  }
+#endif
+
+  return true;
+}
+
 bool Updater::PrepareStagingDirectory()
 {
   if (FileSystem::DirectoryExists(m_staging_directory.c_str()))
@@ -303,6 +482,17 @@ bool Updater::StageUpdate()
 
   for (const FileToUpdate& ftu : m_update_paths)
   {
+    const std::string destination_file = StringUtil::StdStringFromFormat(
+      "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
+    if (!ftu.source_hash.empty())
+    {
+      if (!StagePatchedFile(ftu, destination_file))
+        return false;
+
+      m_progress->IncrementProgressValue();
+      continue;
+    }
+
     m_progress->SetFormattedStatusText("Extracting '%s' (mode %o)...", ftu.original_zip_filename.c_str(),
                                        ftu.file_mode);
 
@@ -319,8 +509,6 @@ bool Updater::StageUpdate()
 
     m_progress->DisplayFormattedInformation("Extracting '%s'...", ftu.destination_filename.c_str());
 
-    const std::string destination_file = StringUtil::StdStringFromFormat(
-      "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
     std::FILE* fp = FileSystem::OpenCFile(destination_file.c_str(), "wb");
     if (!fp)
     {
@@ -331,6 +519,7 @@ bool Updater::StageUpdate()
 
     static constexpr u32 CHUNK_SIZE = 4096;
     u8 buffer[CHUNK_SIZE];
+    SHA1Digest digest;
     for (;;)
     {
       int byte_count = unzReadCurrentFile(m_zf, buffer, CHUNK_SIZE);
@@ -356,6 +545,23 @@ bool Updater::StageUpdate()
         unzCloseCurrentFile(m_zf);
         return false;
       }
+
+      digest.Update(buffer, static_cast<u32>(byte_count));
+    }
+
+    if (!ftu.target_hash.empty())
+    {
+      u8 hash[SHA1Digest::DIGEST_SIZE];
+      digest.Final(hash);
+      if (!StringUtil::EqualNoCase(SHA1Digest::DigestToString(hash), ftu.target_hash))
+      {
+        m_progress->DisplayFormattedModalError("File '%s' in zip does not match the expected hash.",
+                                               ftu.original_zip_filename.c_str());
+        std::fclose(fp);
+        FileSystem::DeleteFile(destination_file.c_str());
+        unzCloseCurrentFile(m_zf);
+        return false;
+      }
     }
 
 #ifndef _WIN32
@@ -428,6 +634,25 @@ bool Updater::CommitUpdate()
     }
   }
 
+  // remove files which are no longer part of the release, already being gone is fine
+  for (const std::string& path : m_remove_paths)
+  {
+    const std::string dest_file_name =
+      StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "%s", m_destination_directory.c_str(), path.c_str());
+    if (!FileSystem::FileExists(dest_file_name.c_str()))
+      continue;
+
+    m_progress->DisplayFormattedInformation("Removing '%s'", dest_file_name.c_str());
+
+    Error error;
+    if (!FileSystem::DeleteFile(dest_file_name.c_str(), &error))
+    {
+      m_progress->DisplayFormattedModalError("Failed to remove '%s': %s", dest_file_name.c_str(),
+                                             error.GetDescription().c_str());
+      return false;
+    }
+  }
+
   return true;
 }
 
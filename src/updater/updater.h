@@ -23,6 +23,9 @@ public:
   void CleanupStagingDirectory();
   bool ClearDestinationDirectory();
 
+  /// Delta updates only contain changed files, so the destination must not be cleared before committing them.
+  bool IsDeltaUpdate() const { return m_is_delta_update; }
+
 private:
   bool RecursiveDeleteDirectory(const char* path, bool remove_dir);
 
@@ -30,10 +33,15 @@ private:
   {
     std::string original_zip_filename;
     std::string destination_filename;
+    std::string target_hash; // only set for delta updates
+    std::string source_hash; // set if the zip holds a patch against the installed file
     u32 file_mode;
   };
 
   bool ParseZip();
+  bool ParseDeltaManifest();
+  bool ReadCurrentZipFile(const FileToUpdate& ftu, std::vector<u8>* data);
+  bool StagePatchedFile(const FileToUpdate& ftu, const std::string& destination_file);
   void CloseUpdateZip();
 
   std::string m_zip_path;
@@ -42,6 +50,8 @@ private:
 
   std::vector<FileToUpdate> m_update_paths;
   std::vector<std::string> m_update_directories;
+  std::vector<std::string> m_remove_paths; // files removed since the installed version, only for delta updates
+  bool m_is_delta_update = false;
 
   ProgressCallback* m_progress;
   unzFile m_zf = nullptr;
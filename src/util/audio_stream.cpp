@@ -11,6 +11,7 @@
 #include "common/log.h"
 #include "common/settings_interface.h"
 #include "common/small_string.h"
+#include "common/threading.h"
 #include "common/timer.h"
 
 #include "SoundTouch.h"
@@ -54,6 +55,7 @@ AudioStream::AudioStream(u32 sample_rate, const AudioStreamParameters& parameter
 
 AudioStream::~AudioStream()
 {
+  StopDSPThread();
   DestroyBuffer();
 }
 
@@ -273,7 +275,20 @@ u32 AudioStream::GetBufferedFramesRelaxed() const
 
 void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 {
-  const u32 available_frames = GetBufferedFramesRelaxed();
+  // Acquire pairs with the writer's release, so the frames up to wpos are visible.
+  u32 rpos = m_rpos.load(std::memory_order_relaxed);
+  const u32 wpos = m_wpos.load(std::memory_order_acquire);
+  u32 available_frames = (wpos + m_buffer_size - rpos) % m_buffer_size;
+
+  // Only the reader moves the read position, so drops requested by the writer are applied here.
+  if (m_discard_frames.load(std::memory_order_relaxed) != 0) [[unlikely]]
+  {
+    const u32 discard = std::min(m_discard_frames.exchange(0, std::memory_order_relaxed), available_frames);
+    rpos = (rpos + discard) % m_buffer_size;
+    available_frames -= discard;
+    m_rpos.store(rpos, std::memory_order_release);
+  }
+
   u32 frames_to_read = num_frames;
   u32 silence_frames = 0;
 
@@ -299,6 +314,7 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
     silence_frames = frames_to_read - available_frames;
     frames_to_read = available_frames;
     m_filling = true;
+    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
 
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
       StretchUnderrun();
@@ -306,8 +322,6 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 
   if (frames_to_read > 0)
   {
-    u32 rpos = m_rpos.load(std::memory_order_acquire);
-
     u32 end = m_buffer_size - rpos;
     if (end > frames_to_read)
       end = frames_to_read;
@@ -432,21 +446,19 @@ void AudioStream::StereoSampleReaderImpl(SampleType* dest, const SampleType* src
 
 void AudioStream::InternalWriteFrames(s16* data, u32 num_frames)
 {
-  const u32 free = m_buffer_size - GetBufferedFramesRelaxed();
+  // Acquire pairs with the reader's release, so it has finished with the frames before rpos.
+  const u32 rpos = m_rpos.load(std::memory_order_acquire);
+  u32 wpos = m_wpos.load(std::memory_order_relaxed);
+  const u32 free = m_buffer_size - ((wpos + m_buffer_size - rpos) % m_buffer_size);
   if (free <= num_frames)
   {
+    // The reader drops the oldest frames, this chunk can't be written until it has.
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
-    {
       StretchOverrun();
-    }
-    else
-    {
-      Log_DebugPrintf("Buffer overrun, chunk dropped");
-      return;
-    }
-  }
 
-  u32 wpos = m_wpos.load(std::memory_order_acquire);
+    Log_DebugPrintf("Buffer overrun, chunk dropped");
+    return;
+  }
 
   // wrapping around the end of the buffer?
   if ((m_buffer_size - wpos) <= num_frames)
@@ -479,6 +491,7 @@ void AudioStream::BaseInitialize(SampleReader sample_reader)
   AllocateBuffer();
   ExpandAllocate();
   StretchAllocate();
+  StartDSPThread();
 }
 
 void AudioStream::AllocateBuffer()
@@ -513,10 +526,20 @@ void AudioStream::DestroyBuffer()
   m_buffer_size = 0;
   m_wpos.store(0, std::memory_order_release);
   m_rpos.store(0, std::memory_order_release);
+  m_discard_frames.store(0, std::memory_order_relaxed);
 }
 
 void AudioStream::EmptyBuffer()
 {
+  std::unique_lock lock(m_dsp_process_mutex);
+  if (m_dsp_thread.joinable())
+  {
+    // Drop anything the DSP thread hasn't got to yet.
+    std::unique_lock queue_lock(m_dsp_queue_mutex);
+    m_dsp_queue_read_chunk = m_dsp_queue_write_chunk;
+    m_dsp_queued_chunks = 0;
+  }
+
 #ifndef __ANDROID__
   if (IsExpansionEnabled())
   {
@@ -529,18 +552,30 @@ void AudioStream::EmptyBuffer()
   if (IsStretchEnabled())
   {
     m_soundtouch->clear();
-    if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
+    if (m_parameters.stretch_mode == AudioStretchMode::Resample)
+    {
+      m_soundtouch->setRate(m_nominal_rate);
+      m_average_resample_usage = 0.0f;
+    }
+    else
+    {
       m_soundtouch->setTempo(m_nominal_rate);
+    }
   }
 
+  m_discard_frames.store(0, std::memory_order_relaxed);
   m_wpos.store(m_rpos.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void AudioStream::SetNominalRate(float tempo)
 {
+  std::unique_lock lock(m_dsp_process_mutex);
   m_nominal_rate = tempo;
   if (m_parameters.stretch_mode == AudioStretchMode::Resample)
+  {
     m_soundtouch->setRate(tempo);
+    m_average_resample_usage = 0.0f;
+  }
 }
 
 void AudioStream::UpdateTargetTempo(float tempo)
@@ -548,6 +583,8 @@ void AudioStream::UpdateTargetTempo(float tempo)
   if (m_parameters.stretch_mode != AudioStretchMode::TimeStretch)
     return;
 
+  std::unique_lock lock(m_dsp_process_mutex);
+
   // undo sqrt()
   if (tempo)
     tempo *= tempo;
@@ -572,6 +609,7 @@ void AudioStream::SetStretchMode(AudioStretchMode mode)
   if (!paused)
     SetPaused(true);
 
+  StopDSPThread();
   DestroyBuffer();
   StretchDestroy();
   m_parameters.stretch_mode = mode;
@@ -579,6 +617,7 @@ void AudioStream::SetStretchMode(AudioStretchMode mode)
   AllocateBuffer();
   if (m_parameters.stretch_mode != AudioStretchMode::Off)
     StretchAllocate();
+  StartDSPThread();
 
   if (!paused)
     SetPaused(false);
@@ -597,7 +636,10 @@ void AudioStream::SetOutputVolume(u32 volume)
 void AudioStream::BeginWrite(SampleType** buffer_ptr, u32* num_frames)
 {
   // TODO: Write directly to buffer when not using stretching.
-  *buffer_ptr = &m_staging_buffer[m_staging_buffer_pos];
+  // With the DSP thread running, frames go straight into the slot which will be queued next.
+  *buffer_ptr = m_dsp_queue ?
+                  &m_dsp_queue[m_dsp_queue_write_chunk * (CHUNK_SIZE * NUM_INPUT_CHANNELS) + m_staging_buffer_pos] :
+                  &m_staging_buffer[m_staging_buffer_pos];
   *num_frames = CHUNK_SIZE - (m_staging_buffer_pos / NUM_INPUT_CHANNELS);
 }
 
@@ -771,6 +813,17 @@ void AudioStream::EndWrite(u32 num_frames)
 
   m_staging_buffer_pos = 0;
 
+  if (m_dsp_queue)
+  {
+    QueueDSPChunk();
+    return;
+  }
+
+  ProcessChunk();
+}
+
+void AudioStream::ProcessChunk()
+{
   if (!IsExpansionEnabled() && !IsStretchEnabled())
   {
     InternalWriteFrames(m_staging_buffer.get(), CHUNK_SIZE);
@@ -804,6 +857,85 @@ void AudioStream::EndWrite(u32 num_frames)
   }
 }
 
+void AudioStream::StartDSPThread()
+{
+  DebugAssert(!m_dsp_thread.joinable());
+  if (!IsExpansionEnabled() && !IsStretchEnabled())
+    return;
+
+  m_dsp_queue = std::make_unique<s16[]>(DSP_QUEUE_CHUNKS * CHUNK_SIZE * NUM_INPUT_CHANNELS);
+  m_dsp_queue_read_chunk = 0;
+  m_dsp_queue_write_chunk = 0;
+  m_dsp_queued_chunks = 0;
+  m_dsp_shutdown = false;
+  m_staging_buffer_pos = 0;
+  m_dsp_thread = std::thread(&AudioStream::DSPThreadEntryPoint, this);
+}
+
+void AudioStream::StopDSPThread()
+{
+  if (!m_dsp_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_dsp_queue_mutex);
+    m_dsp_shutdown = true;
+    m_dsp_queue_cv.notify_one();
+  }
+
+  m_dsp_thread.join();
+  m_dsp_queue.reset();
+  m_staging_buffer_pos = 0;
+}
+
+void AudioStream::QueueDSPChunk()
+{
+  {
+    std::unique_lock lock(m_dsp_queue_mutex);
+    if (m_dsp_queued_chunks == (DSP_QUEUE_CHUNKS - 1))
+    {
+      // DSP thread has fallen behind, the slot gets overwritten by the next chunk.
+      Log_DebugPrint("DSP queue full, dropping chunk.");
+      return;
+    }
+
+    m_dsp_queued_chunks++;
+    m_dsp_queue_cv.notify_one();
+  }
+
+  m_dsp_queue_write_chunk = (m_dsp_queue_write_chunk + 1) % DSP_QUEUE_CHUNKS;
+}
+
+void AudioStream::DSPThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Audio DSP Thread");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Audio);
+
+  for (;;)
+  {
+    std::unique_lock queue_lock(m_dsp_queue_mutex);
+    m_dsp_queue_cv.wait(queue_lock, [this]() { return (m_dsp_shutdown || m_dsp_queued_chunks > 0); });
+    if (m_dsp_shutdown)
+      break;
+
+    // Chunks may have been emptied while we didn't hold the lock, so check again once we're processing.
+    queue_lock.unlock();
+    std::unique_lock process_lock(m_dsp_process_mutex);
+    queue_lock.lock();
+    if (m_dsp_queued_chunks == 0)
+      continue;
+
+    std::memcpy(m_staging_buffer.get(),
+                &m_dsp_queue[m_dsp_queue_read_chunk * (CHUNK_SIZE * NUM_INPUT_CHANNELS)],
+                sizeof(s16) * CHUNK_SIZE * NUM_INPUT_CHANNELS);
+    m_dsp_queue_read_chunk = (m_dsp_queue_read_chunk + 1) % DSP_QUEUE_CHUNKS;
+    m_dsp_queued_chunks--;
+    queue_lock.unlock();
+
+    ProcessChunk();
+  }
+}
+
 // Time stretching algorithm based on PCSX2 implementation.
 
 template<class T>
@@ -837,6 +969,7 @@ void AudioStream::StretchAllocate()
   m_stretch_inactive = false;
   m_stretch_ok_count = 0;
   m_dynamic_target_usage = 0.0f;
+  m_average_resample_usage = 0.0f;
   m_average_position = 0;
   m_average_available = 0;
 
@@ -863,6 +996,8 @@ void AudioStream::StretchWriteBlock(const float* block)
 
     if (m_parameters.stretch_mode == AudioStretchMode::TimeStretch)
       UpdateStretchTempo();
+    else
+      UpdateResampleRate();
   }
   else
   {
@@ -985,6 +1120,25 @@ void AudioStream::UpdateStretchTempo()
     m_stretch_reset = 0;
 }
 
+void AudioStream::UpdateResampleRate()
+{
+  // Dynamic rate control: nudge the resampling ratio so the buffer settles at the target size, instead of slowly
+  // drifting into an underrun or overrun because the input rate doesn't exactly match the output. Capping the
+  // deviation keeps the pitch change inaudible, so larger mismatches are left to the nominal rate.
+  static constexpr float MAX_RATE_DEVIATION = 0.005f;
+  static constexpr float USAGE_SMOOTHING = 0.01f;
+
+  const float target_usage = static_cast<float>(m_target_buffer_size);
+  const float buffer_usage = static_cast<float>(GetBufferedFramesRelaxed());
+  if (m_average_resample_usage > 0.0f)
+    m_average_resample_usage += (buffer_usage - m_average_resample_usage) * USAGE_SMOOTHING;
+  else
+    m_average_resample_usage = target_usage;
+
+  const float error = std::clamp((m_average_resample_usage - target_usage) / target_usage, -1.0f, 1.0f);
+  m_soundtouch->setRate(m_nominal_rate * (1.0f + error * MAX_RATE_DEVIATION));
+}
+
 void AudioStream::StretchUnderrun()
 {
   // Didn't produce enough frames in time.
@@ -997,8 +1151,7 @@ void AudioStream::StretchOverrun()
   m_stretch_reset++;
 
   // Drop two packets to give the time stretcher a bit more time to slow things down.
-  const u32 discard = CHUNK_SIZE * 2;
-  m_rpos.store((m_rpos.load(std::memory_order_acquire) + discard) % m_buffer_size, std::memory_order_release);
+  m_discard_frames.store(CHUNK_SIZE * 2, std::memory_order_relaxed);
 }
 
 void AudioStreamParameters::Load(SettingsInterface& si, const char* section)
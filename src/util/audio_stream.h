@@ -7,9 +7,12 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -174,6 +177,9 @@ public:
   ALWAYS_INLINE float GetNominalTempo() const { return m_nominal_rate; }
   ALWAYS_INLINE bool IsPaused() const { return m_paused; }
 
+  /// Returns the number of times the output ran out of buffered frames since the stream was created.
+  ALWAYS_INLINE u32 GetUnderrunCount() const { return m_underrun_count.load(std::memory_order_relaxed); }
+
   u32 GetBufferedFramesRelaxed() const;
 
   /// Temporarily pauses the stream, preventing it from requesting data.
@@ -243,6 +249,9 @@ private:
   static constexpr u32 STRETCH_RESET_THRESHOLD = 5;
   static constexpr u32 TARGET_IPS = 691;
 
+  // Input chunks waiting for the DSP thread. One slot is always being written by the emulation thread.
+  static constexpr u32 DSP_QUEUE_CHUNKS = 32;
+
 #ifndef __ANDROID__
   static std::vector<std::pair<std::string, std::string>> GetCubebDriverNames();
   static std::vector<DeviceInfo> GetCubebOutputDevices(const char* driver, u32 sample_rate);
@@ -265,6 +274,12 @@ private:
   void DestroyBuffer();
 
   void InternalWriteFrames(SampleType* samples, u32 num_frames);
+  void ProcessChunk();
+
+  void StartDSPThread();
+  void StopDSPThread();
+  void DSPThreadEntryPoint();
+  void QueueDSPChunk();
 
 #ifndef __ANDROID__
   void ExpandAllocate();
@@ -278,13 +293,22 @@ private:
 
   float AddAndGetAverageTempo(float val);
   void UpdateStretchTempo();
+  void UpdateResampleRate();
 
   u32 m_buffer_size = 0;
   std::unique_ptr<s16[]> m_buffer;
   SampleReader m_sample_reader = nullptr;
 
-  std::atomic<u32> m_rpos{0};
-  std::atomic<u32> m_wpos{0};
+  // The buffer is a single-producer single-consumer ring. The read position is only written by the output callback,
+  // and the write position by the emulation thread, so each is kept on its own cache line.
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_rpos{0};
+  alignas(HOST_CACHE_LINE_SIZE) std::atomic<u32> m_wpos{0};
+
+  // Frames the writer wants dropped from the read side after an overrun, applied by the reader.
+  std::atomic<u32> m_discard_frames{0};
+
+  // Only written by the output callback, read by the host for statistics.
+  std::atomic<u32> m_underrun_count{0};
 
   std::unique_ptr<soundtouch::SoundTouch> m_soundtouch;
 
@@ -294,6 +318,7 @@ private:
   u32 m_stretch_ok_count = 0;
   float m_nominal_rate = 1.0f;
   float m_dynamic_target_usage = 0.0f;
+  float m_average_resample_usage = 0.0f;
 
   u32 m_average_position = 0;
   u32 m_average_available = 0;
@@ -315,6 +340,19 @@ private:
   float* m_expand_output_buffer = nullptr;
   u32 m_expand_buffer_pos = 0;
 #endif
+
+  // Expansion and stretching run on a separate thread, so the emulation thread only has to queue raw input chunks.
+  // The process mutex is held while a chunk is being processed, and by anything which touches the DSP state from
+  // outside the thread. It is always acquired before the queue mutex.
+  std::thread m_dsp_thread;
+  std::mutex m_dsp_process_mutex;
+  std::mutex m_dsp_queue_mutex;
+  std::condition_variable m_dsp_queue_cv;
+  std::unique_ptr<s16[]> m_dsp_queue;
+  u32 m_dsp_queue_read_chunk = 0;
+  u32 m_dsp_queue_write_chunk = 0;
+  u32 m_dsp_queued_chunks = 0;
+  bool m_dsp_shutdown = false;
 };
 
 template<AudioExpansionMode mode, AudioStream::ReadChannel c0, AudioStream::ReadChannel c1, AudioStream::ReadChannel c2,
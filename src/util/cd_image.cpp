@@ -7,11 +7,17 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/md5_digest.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include <algorithm>
 #include <array>
+#include <cstring>
 Log_SetChannel(CDImage);
 
+static std::string s_index_cache_directory;
+
 CDImage::CDImage() = default;
 
 CDImage::~CDImage() = default;
@@ -287,6 +293,21 @@ u32 CDImage::Read(ReadMode read_mode, u32 sector_count, void* buffer)
   return sectors_read;
 }
 
+void CDImage::WarmUp(u32 sector_count)
+{
+  if (!Seek(1, Position{0, 0, 0}))
+    return;
+
+  u8 raw_sector[RAW_SECTOR_SIZE];
+  for (u32 i = 0; i < sector_count; i++)
+  {
+    if (!ReadRawSector(raw_sector, nullptr))
+      break;
+  }
+
+  Seek(1, Position{0, 0, 0});
+}
+
 bool CDImage::ReadRawSector(void* buffer, SubChannelQ* subq)
 {
   if (m_position_in_index == m_current_index->length)
@@ -383,7 +404,8 @@ std::string CDImage::GetSubImageMetadata(u32 index, std::string_view type) const
   return {};
 }
 
-CDImage::PrecacheResult CDImage::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+CDImage::PrecacheResult CDImage::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/,
+                                          u64 max_size /*= std::numeric_limits<u64>::max()*/)
 {
   return PrecacheResult::Unsupported;
 }
@@ -476,6 +498,54 @@ bool CDImage::GenerateSubChannelQ(SubChannelQ* subq, LBA lba)
   return true;
 }
 
+void CDImage::SetIndexCacheDirectory(std::string path)
+{
+  s_index_cache_directory = std::move(path);
+}
+
+std::string CDImage::GetIndexCachePath(const char* filename, std::string_view extension)
+{
+  if (s_index_cache_directory.empty())
+    return {};
+
+  return GetCachePathForImage(s_index_cache_directory, filename, extension);
+}
+
+std::string CDImage::GetCachePathForImage(std::string_view directory, const char* filename, std::string_view extension)
+{
+  // Images with the same name in different directories must not share a cache file.
+  MD5Digest digest;
+  digest.Update(filename, static_cast<u32>(std::strlen(filename)));
+  u8 hash[16];
+  digest.Final(hash);
+  u64 short_hash;
+  std::memcpy(&short_hash, hash, sizeof(short_hash));
+
+  return Path::Combine(directory, fmt::format("{}.{:016x}.{}", Path::GetFileTitle(filename), short_hash, extension));
+}
+
+bool CDImage::ReadSectorFromMapping(void* buffer, const u8* mapping, u64 mapping_size, u64 file_position,
+                                    u32 sector_size, u64* prefetch_end)
+{
+  // Roughly 28 sectors, or 90ms of reading at double speed. Re-hinted once half of it has been read.
+  static constexpr u64 PREFETCH_SIZE = 64 * 1024;
+
+  if ((file_position + sector_size) > mapping_size)
+    return false;
+
+  const u64 read_end = file_position + sector_size;
+  if (read_end > *prefetch_end || (*prefetch_end - read_end) < (PREFETCH_SIZE / 2) ||
+      (*prefetch_end - read_end) > PREFETCH_SIZE)
+  {
+    *prefetch_end = std::min(read_end + PREFETCH_SIZE, mapping_size);
+    if (*prefetch_end > read_end)
+      MemMap::PrefetchMappedRange(mapping + read_end, static_cast<size_t>(*prefetch_end - read_end));
+  }
+
+  std::memcpy(buffer, mapping + file_position, sector_size);
+  return true;
+}
+
 void CDImage::GenerateSubChannelQ(SubChannelQ* subq, const Index& index, u32 index_offset)
 {
   subq->control_bits = index.control.bits;
@@ -7,6 +7,7 @@
 #include "common/progress_callback.h"
 #include "common/types.h"
 #include <array>
+#include <limits>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -71,6 +72,8 @@ public:
   {
     Unsupported,
     ReadError,
+    TooLarge,
+    Cancelled,
     Success,
   };
 
@@ -239,6 +242,10 @@ public:
   /// Returns true if the specified filename is a CD-ROM device name.
   static bool IsDeviceName(const char* filename);
 
+  /// Sets the directory where formats which have to scan the whole file on open store their sector index, so later
+  /// opens can skip the scan. An empty path disables the index cache.
+  static void SetIndexCacheDirectory(std::string path);
+
   // Opening disc image.
   static std::unique_ptr<CDImage> Open(const char* filename, bool allow_patches, Error* error);
   static std::unique_ptr<CDImage> OpenBinImage(const char* filename, Error* error);
@@ -254,6 +261,12 @@ public:
   static std::unique_ptr<CDImage> OverlayPPFPatch(const char* filename, std::unique_ptr<CDImage> parent_image,
                                                   ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
+  /// Mirrors sectors into a file in cache_directory as they are read, and fills in the rest while the image is idle.
+  /// Intended for images on slow or network storage. Cache files beyond max_cache_size in total are evicted, least
+  /// recently used first. Returns parent_image unchanged if it can't be cached.
+  static std::unique_ptr<CDImage> CreateLocalCacheImage(std::unique_ptr<CDImage> parent_image,
+                                                        const char* cache_directory, u64 max_cache_size);
+
   // Accessors.
   const std::string& GetFileName() const { return m_filename; }
   LBA GetPositionOnDisc() const { return m_position_on_disc; }
@@ -297,6 +310,10 @@ public:
   // Read a single raw sector, and subchannel from the current LBA.
   bool ReadRawSector(void* buffer, SubChannelQ* subq);
 
+  // Reads the first sectors of the disc, so the file system headers are in the OS and image caches before the disc is
+  // used, then seeks back to the start. Intended for images which are opened ahead of time on a worker thread.
+  void WarmUp(u32 sector_count = 32);
+
   // Reads sub-channel Q for the specified index+LBA.
   virtual bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index);
 
@@ -325,7 +342,9 @@ public:
   virtual std::string GetSubImageMetadata(u32 index, std::string_view type) const;
 
   // Returns true if the source supports precaching, which may be more optimal than an in-memory copy.
-  virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
+  // Images which would need more than max_size bytes of memory return TooLarge, and are left as-is.
+  virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback,
+                                  u64 max_size = std::numeric_limits<u64>::max());
   virtual bool IsPrecached() const;
 
   // Returns the size on disk of the image. This could be multiple files.
@@ -348,6 +367,18 @@ protected:
   /// Synthesis of lead-out data.
   void AddLeadOutIndex();
 
+  /// Returns the path of the persisted sector index for an image file, or an empty string if index caching is off.
+  static std::string GetIndexCachePath(const char* filename, std::string_view extension);
+
+  /// Returns a path in directory which is unique to the image file.
+  static std::string GetCachePathForImage(std::string_view directory, const char* filename,
+                                          std::string_view extension);
+
+  /// Copies a sector out of a memory-mapped image file. Reads which pass prefetch_end ask the OS to page in the data
+  /// following them, so sequential reads rarely fault.
+  static bool ReadSectorFromMapping(void* buffer, const u8* mapping, u64 mapping_size, u64 file_position,
+                                    u32 sector_size, u64* prefetch_end);
+
   std::string m_filename;
   u32 m_lba_count = 0;
 
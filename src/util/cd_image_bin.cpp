@@ -6,8 +6,12 @@
 
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 
+Log_SetChannel(CDImageBin);
+
 namespace {
 
 class CDImageBin : public CDImage
@@ -30,6 +34,11 @@ private:
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
 
+  // Sectors are copied straight out of a mapping of the file when possible, instead of going through stdio.
+  const u8* m_mapping = nullptr;
+  u64 m_mapping_size = 0;
+  u64 m_prefetch_end = 0;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -39,6 +48,8 @@ CDImageBin::CDImageBin() = default;
 
 CDImageBin::~CDImageBin()
 {
+  if (m_mapping)
+    MemMap::UnmapFile(m_mapping, static_cast<size_t>(m_mapping_size));
   if (m_fp)
     std::fclose(m_fp);
 }
@@ -62,6 +73,16 @@ bool CDImageBin::Open(const char* filename, Error* error)
 
   m_lba_count = file_size / track_sector_size;
 
+  if (file_size > 0)
+  {
+    Error map_error;
+    m_mapping = static_cast<const u8*>(MemMap::MapFileReadOnly(m_fp, file_size, &map_error));
+    if (m_mapping)
+      m_mapping_size = file_size;
+    else
+      Log_DevFmt("Failed to map '{}', using buffered reads: {}", filename, map_error.GetDescription());
+  }
+
   SubChannelQ::Control control = {};
   TrackMode mode = TrackMode::Mode2Raw;
   control.data = mode != TrackMode::Audio;
@@ -123,6 +144,12 @@ bool CDImageBin::HasNonStandardSubchannel() const
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (m_mapping)
+  {
+    return ReadSectorFromMapping(buffer, m_mapping, m_mapping_size, file_position, index.file_sector_size,
+                                 &m_prefetch_end);
+  }
+
   if (m_file_position != file_position)
   {
     if (std::fseek(m_fp, static_cast<long>(file_position), SEEK_SET) != 0)
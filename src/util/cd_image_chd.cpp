@@ -3,6 +3,7 @@
 
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
+#include "http_range_reader.h"
 
 #include "common/align.h"
 #include "common/assert.h"
@@ -12,20 +13,28 @@
 #include "common/heap_array.h"
 #include "common/intrin.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 
 #include "fmt/format.h"
 #include "libchdr/cdrom.h"
 #include "libchdr/chd.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <deque>
 #include <limits>
 #include <mutex>
 #include <optional>
+#include <thread>
 
 Log_SetChannel(CDImageCHD);
 
@@ -56,6 +65,86 @@ static std::optional<CDImage::TrackMode> ParseTrackModeString(const char* str)
 static std::vector<std::pair<std::string, chd_header>> s_chd_hash_cache; // <filename, header>
 static std::recursive_mutex s_chd_hash_cache_mutex;
 
+// Lets libchdr read from a HTTP server. Each handle has its own position, but they share the reader's block cache.
+struct HTTPCoreFile
+{
+  core_file cf;
+  std::shared_ptr<HTTPRangeReader> reader;
+  u64 position = 0;
+
+  static core_file* Create(std::shared_ptr<HTTPRangeReader> reader);
+
+  static UINT64 FSize(core_file* cf);
+  static size_t FRead(void* ptr, size_t size, size_t nmemb, core_file* cf);
+  static int FClose(core_file* cf);
+  static int FSeek(core_file* cf, INT64 offset, int whence);
+};
+
+core_file* HTTPCoreFile::Create(std::shared_ptr<HTTPRangeReader> reader)
+{
+  HTTPCoreFile* file = new HTTPCoreFile();
+  file->cf.argp = file;
+  file->cf.fsize = &HTTPCoreFile::FSize;
+  file->cf.fread = &HTTPCoreFile::FRead;
+  file->cf.fclose = &HTTPCoreFile::FClose;
+  file->cf.fseek = &HTTPCoreFile::FSeek;
+  file->reader = std::move(reader);
+  return &file->cf;
+}
+
+UINT64 HTTPCoreFile::FSize(core_file* cf)
+{
+  return static_cast<HTTPCoreFile*>(cf->argp)->reader->GetSize();
+}
+
+size_t HTTPCoreFile::FRead(void* ptr, size_t size, size_t nmemb, core_file* cf)
+{
+  HTTPCoreFile* file = static_cast<HTTPCoreFile*>(cf->argp);
+  const u64 file_size = file->reader->GetSize();
+  if (size == 0 || file->position >= file_size)
+    return 0;
+
+  const size_t count = static_cast<size_t>(std::min<u64>(nmemb, (file_size - file->position) / size));
+  if (count == 0 || !file->reader->Read(file->position, ptr, count * size))
+    return 0;
+
+  file->position += count * size;
+  return count;
+}
+
+int HTTPCoreFile::FClose(core_file* cf)
+{
+  // libchdr closes the file itself if the open fails, so this always owns it.
+  delete static_cast<HTTPCoreFile*>(cf->argp);
+  return 0;
+}
+
+int HTTPCoreFile::FSeek(core_file* cf, INT64 offset, int whence)
+{
+  HTTPCoreFile* file = static_cast<HTTPCoreFile*>(cf->argp);
+  s64 new_position;
+  switch (whence)
+  {
+    case SEEK_SET:
+      new_position = offset;
+      break;
+    case SEEK_CUR:
+      new_position = static_cast<s64>(file->position) + offset;
+      break;
+    case SEEK_END:
+      new_position = static_cast<s64>(file->reader->GetSize()) + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (new_position < 0)
+    return -1;
+
+  file->position = static_cast<u64>(new_position);
+  return 0;
+}
+
 class CDImageCHD : public CDImage
 {
 public:
@@ -66,7 +155,7 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
-  PrecacheResult Precache(ProgressCallback* progress) override;
+  PrecacheResult Precache(ProgressCallback* progress, u64 max_size) override;
   bool IsPrecached() const override;
   s64 GetSizeOnDisk() const override;
 
@@ -77,20 +166,69 @@ private:
   static constexpr u32 CHD_CD_SECTOR_DATA_SIZE = 2352 + 96;
   static constexpr u32 CHD_CD_TRACK_ALIGNMENT = 4;
   static constexpr u32 MAX_PARENTS = 32; // Surely someone wouldn't be insane enough to go beyond this...
+  static constexpr u32 INVALID_HUNK_INDEX = static_cast<u32>(-1);
+  static constexpr u32 MAX_PRECACHE_THREADS = 8;
+
+  // Decompressed hunks are kept in a small LRU cache, and the hunks following the last one read are decompressed
+  // ahead of time on a worker thread, through a second handle to the file since libchdr handles aren't thread-safe.
+  static constexpr u32 HUNK_CACHE_SIZE = 8;
+  static constexpr u32 PREFETCH_HUNKS = 4;
+  static_assert(HUNK_CACHE_SIZE > (PREFETCH_HUNKS + 1));
+
+  enum class HunkState : u8
+  {
+    Empty,
+    Queued,
+    Ready,
+  };
+
+  struct CachedHunk
+  {
+    DynamicHeapArray<u8, 16> data;
+    u32 hunk_index = INVALID_HUNK_INDEX;
+    u32 last_used = 0;
+    HunkState state = HunkState::Empty;
+  };
 
   chd_file* OpenCHD(std::string_view filename, FileSystem::ManagedCFilePtr fp, Error* error, u32 recursion_level);
+  chd_file* OpenHTTPCHD(Error* error);
+
+  /// Opens another handle to the same image, for worker threads.
+  chd_file* OpenAdditionalHandle(Error* error);
+
   bool UpdateHunkBuffer(const Index& index, LBA lba_in_index, u32& hunk_offset);
 
+  CachedHunk* FindCachedHunk(u32 hunk_index);
+  CachedHunk* GetEvictableHunk(u32 first_protected_hunk, u32 last_protected_hunk);
+  void QueuePrefetch(u32 hunk_index);
+  void StartPrefetchThread();
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
+
   static void CopyAndSwap(void* dst_ptr, const u8* src_ptr);
 
   chd_file* m_chd = nullptr;
+  std::shared_ptr<HTTPRangeReader> m_http_reader;
+  DynamicHeapArray<u8, 16> m_precache_data;
   u32 m_hunk_size = 0;
   u32 m_sectors_per_hunk = 0;
+  u32 m_total_hunks = 0;
 
-  DynamicHeapArray<u8, 16> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  const u8* m_hunk_data = nullptr;
+  u32 m_current_hunk_index = INVALID_HUNK_INDEX;
+  u32 m_hunk_use_counter = 0;
   bool m_precached = false;
 
+  // Slot states and the queue are protected by the mutex. Queued slots are owned by the prefetch thread.
+  std::array<CachedHunk, HUNK_CACHE_SIZE> m_hunk_cache;
+  chd_file* m_prefetch_chd = nullptr;
+  std::thread m_prefetch_thread;
+  std::mutex m_prefetch_mutex;
+  std::condition_variable m_prefetch_work_cv;
+  std::condition_variable m_prefetch_done_cv;
+  std::deque<CachedHunk*> m_prefetch_queue;
+  bool m_prefetch_shutdown = false;
+
   CDSubChannelReplacement m_sbi;
 };
 } // namespace
@@ -99,6 +237,12 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  if (m_precached)
+    MemoryAccounting::SubtractHostBytes(MemoryAccounting::Category::CDImagePrecache, m_precache_data.size());
+
+  StopPrefetchThread();
+  if (m_prefetch_chd)
+    chd_close(m_prefetch_chd);
   if (m_chd)
     chd_close(m_chd);
 }
@@ -234,19 +378,58 @@ chd_file* CDImageCHD::OpenCHD(std::string_view filename, FileSystem::ManagedCFil
   return chd;
 }
 
+chd_file* CDImageCHD::OpenHTTPCHD(Error* error)
+{
+  chd_file* chd;
+  const chd_error err =
+    chd_open_core_file(HTTPCoreFile::Create(m_http_reader), CHD_OPEN_READ | CHD_OPEN_TRANSFER_FILE, nullptr, &chd);
+  if (err == CHDERR_NONE)
+    return chd;
+
+  // Searching for parents would mean listing a directory on the server, which we can't do.
+  const char* msg =
+    (err == CHDERR_REQUIRES_PARENT) ? "Parent CHDs are not supported over HTTP." : chd_error_string(err);
+  Log_ErrorFmt("Failed to open CHD '{}': {}", m_http_reader->GetURL(), msg);
+  Error::SetString(error, msg);
+  return nullptr;
+}
+
+chd_file* CDImageCHD::OpenAdditionalHandle(Error* error)
+{
+  if (m_http_reader)
+    return OpenHTTPCHD(error);
+
+  auto fp = FileSystem::OpenManagedSharedCFile(m_filename.c_str(), "rb", FileSystem::FileShareMode::DenyWrite, error);
+  return fp ? OpenCHD(m_filename, std::move(fp), error, 0) : nullptr;
+}
+
 bool CDImageCHD::Open(const char* filename, Error* error)
 {
-  auto fp = FileSystem::OpenManagedSharedCFile(filename, "rb", FileSystem::FileShareMode::DenyWrite);
-  if (!fp)
+  if (HTTPRangeReader::IsHTTPURL(filename))
   {
-    Log_ErrorFmt("Failed to open CHD '{}': errno {}", filename, errno);
-    if (error)
-      error->SetErrno(errno);
+    m_http_reader = HTTPRangeReader::Open(filename, error);
+    if (!m_http_reader)
+    {
+      Log_ErrorFmt("Failed to open CHD '{}': {}", filename, error ? error->GetDescription() : std::string());
+      return false;
+    }
 
-    return false;
+    m_chd = OpenHTTPCHD(error);
   }
+  else
+  {
+    auto fp = FileSystem::OpenManagedSharedCFile(filename, "rb", FileSystem::FileShareMode::DenyWrite);
+    if (!fp)
+    {
+      Log_ErrorFmt("Failed to open CHD '{}': errno {}", filename, errno);
+      if (error)
+        error->SetErrno(errno);
+
+      return false;
+    }
 
-  m_chd = OpenCHD(filename, std::move(fp), error, 0);
+    m_chd = OpenCHD(filename, std::move(fp), error, 0);
+  }
   if (!m_chd)
     return false;
 
@@ -261,7 +444,9 @@ bool CDImageCHD::Open(const char* filename, Error* error)
   }
 
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
+  m_total_hunks = header->totalhunks;
+  for (CachedHunk& hunk : m_hunk_cache)
+    hunk.data.resize(m_hunk_size);
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -417,6 +602,7 @@ bool CDImageCHD::Open(const char* filename, Error* error)
 
   m_sbi.LoadFromImagePath(filename);
 
+  StartPrefetchThread();
   return Seek(1, Position{0, 0, 0});
 }
 
@@ -433,7 +619,7 @@ bool CDImageCHD::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_
     return false;
 
   u8 deinterleaved_subchannel_data[96];
-  const u8* raw_subchannel_data = &m_hunk_buffer[hunk_offset + RAW_SECTOR_SIZE];
+  const u8* raw_subchannel_data = &m_hunk_data[hunk_offset + RAW_SECTOR_SIZE];
   const u8* real_subchannel_data = raw_subchannel_data;
   if (index.submode == CDImage::SubchannelMode::RawInterleaved)
   {
@@ -452,23 +638,128 @@ bool CDImageCHD::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0 || m_tracks.front().submode != CDImage::SubchannelMode::None);
 }
 
-CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
+CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress, u64 max_size)
 {
   if (m_precached)
     return CDImage::PrecacheResult::Success;
 
+  // Hunks are stored decompressed, so reads don't have to decode anything.
+  const u64 precache_size = static_cast<u64>(m_total_hunks) * m_hunk_size;
+  if (precache_size > max_size)
+  {
+    Log_WarningFmt("Not precaching '{}', {} MB decompressed is over the limit of {} MB.",
+                   FileSystem::GetDisplayNameFromPath(m_filename), precache_size / 1048576, max_size / 1048576);
+    return CDImage::PrecacheResult::TooLarge;
+  }
+
   progress->SetStatusText(fmt::format("Precaching {}...", FileSystem::GetDisplayNameFromPath(m_filename)).c_str());
-  progress->SetProgressRange(100);
+  progress->SetProgressRange(m_total_hunks);
+  progress->SetProgressValue(0);
+
+  // Our prefetch thread can't be touching the handle either.
+  StopPrefetchThread();
+  m_precache_data.resize(static_cast<size_t>(precache_size));
+
+  // Each extra thread needs its own handle, libchdr handles aren't thread-safe.
+  std::vector<chd_file*> worker_chds;
+  if (m_prefetch_chd)
+  {
+    worker_chds.push_back(m_prefetch_chd);
+    m_prefetch_chd = nullptr;
+  }
+  const u32 num_workers =
+    std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1, std::min(MAX_PRECACHE_THREADS, m_total_hunks));
+  while (worker_chds.size() < num_workers)
+  {
+    chd_file* chd = OpenAdditionalHandle(nullptr);
+    if (!chd)
+      break;
+    worker_chds.push_back(chd);
+  }
+
+  std::atomic<u32> next_hunk{0};
+  std::atomic<u32> completed_hunks{0};
+  std::atomic_bool failed{false};
+  std::atomic_bool cancelled{false};
+  const auto decompress_hunks = [this, &next_hunk, &completed_hunks, &failed, &cancelled](chd_file* chd) {
+    for (;;)
+    {
+      const u32 hunk_index = next_hunk.fetch_add(1, std::memory_order_relaxed);
+      if (hunk_index >= m_total_hunks || failed.load(std::memory_order_relaxed) ||
+          cancelled.load(std::memory_order_relaxed))
+      {
+        break;
+      }
+
+      const chd_error err = chd_read(chd, hunk_index, &m_precache_data[static_cast<size_t>(hunk_index) * m_hunk_size]);
+      if (err != CHDERR_NONE)
+      {
+        Log_ErrorFmt("chd_read({}) failed: {}", hunk_index, chd_error_string(err));
+        failed.store(true, std::memory_order_relaxed);
+        break;
+      }
 
-  auto callback = [](size_t pos, size_t total, void* param) {
-    const u32 percent = static_cast<u32>((pos * 100) / total);
-    static_cast<ProgressCallback*>(param)->SetProgressValue(std::min<u32>(percent, 100));
+      completed_hunks.fetch_add(1, std::memory_order_relaxed);
+    }
   };
 
-  if (chd_precache_progress(m_chd, callback, progress) != CHDERR_NONE)
-    return CDImage::PrecacheResult::ReadError;
+  std::vector<std::thread> workers;
+  workers.reserve(worker_chds.size());
+  for (chd_file* chd : worker_chds)
+    workers.emplace_back(decompress_hunks, chd);
+
+  // This thread only updates the progress, the callback isn't thread-safe.
+  while (completed_hunks.load(std::memory_order_relaxed) < m_total_hunks && !failed.load(std::memory_order_relaxed))
+  {
+    if (workers.empty())
+    {
+      // Couldn't open any extra handles, decompress them here instead.
+      const u32 hunk_index = completed_hunks.load(std::memory_order_relaxed);
+      if (chd_read(m_chd, hunk_index, &m_precache_data[static_cast<size_t>(hunk_index) * m_hunk_size]) != CHDERR_NONE)
+      {
+        failed.store(true, std::memory_order_relaxed);
+        break;
+      }
+
+      completed_hunks.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    progress->SetProgressValue(completed_hunks.load(std::memory_order_relaxed));
+    if (progress->IsCancelled())
+    {
+      cancelled.store(true, std::memory_order_relaxed);
+      break;
+    }
+  }
+
+  for (std::thread& worker : workers)
+    worker.join();
+  for (chd_file* chd : worker_chds)
+    chd_close(chd);
+
+  if (failed.load(std::memory_order_relaxed) || cancelled.load(std::memory_order_relaxed))
+  {
+    m_precache_data.deallocate();
+    StartPrefetchThread();
+    return failed.load(std::memory_order_relaxed) ? CDImage::PrecacheResult::ReadError :
+                                                    CDImage::PrecacheResult::Cancelled;
+  }
 
+  // Drop anything cached from before, the hunk pointer has to be into the precached data now.
+  for (CachedHunk& hunk : m_hunk_cache)
+  {
+    hunk.data.deallocate();
+    hunk.hunk_index = INVALID_HUNK_INDEX;
+    hunk.state = HunkState::Empty;
+  }
+  m_current_hunk_index = INVALID_HUNK_INDEX;
+  m_hunk_data = nullptr;
   m_precached = true;
+  MemoryAccounting::AddHostBytes(MemoryAccounting::Category::CDImagePrecache, m_precache_data.size());
   return CDImage::PrecacheResult::Success;
 }
 
@@ -541,9 +832,9 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset]);
+    CopyAndSwap(buffer, &m_hunk_data[hunk_offset]);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &m_hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
@@ -558,20 +849,193 @@ ALWAYS_INLINE_RELEASE bool CDImageCHD::UpdateHunkBuffer(const Index& index, LBA
   if (m_current_hunk_index == hunk_index)
     return true;
 
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
-  if (err != CHDERR_NONE)
+  if (m_precached)
   {
-    Log_ErrorFmt("chd_read({}) failed: %s", hunk_index, chd_error_string(err));
+    m_current_hunk_index = hunk_index;
+    m_hunk_data = &m_precache_data[static_cast<size_t>(hunk_index) * m_hunk_size];
+    return true;
+  }
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
-    return false;
+  std::unique_lock lock(m_prefetch_mutex);
+  CachedHunk* hunk = FindCachedHunk(hunk_index);
+  if (hunk && hunk->state == HunkState::Queued)
+  {
+    // Usually at the front of the queue, if it's not already being decompressed.
+    m_prefetch_done_cv.wait(lock, [hunk]() { return (hunk->state != HunkState::Queued); });
+  }
+
+  // Failed prefetches are retried here, so the error gets reported for the right read.
+  if (!hunk || hunk->state != HunkState::Ready)
+  {
+    if (!hunk)
+      hunk = GetEvictableHunk(hunk_index, hunk_index);
+
+    DebugAssert(hunk);
+    hunk->hunk_index = hunk_index;
+    hunk->state = HunkState::Empty;
+    lock.unlock();
+
+    const chd_error err = chd_read(m_chd, hunk_index, hunk->data.data());
+
+    lock.lock();
+    if (err != CHDERR_NONE)
+    {
+      Log_ErrorFmt("chd_read({}) failed: {}", hunk_index, chd_error_string(err));
+
+      // data might have been partially written
+      hunk->hunk_index = INVALID_HUNK_INDEX;
+      m_current_hunk_index = INVALID_HUNK_INDEX;
+      m_hunk_data = nullptr;
+      return false;
+    }
+
+    hunk->state = HunkState::Ready;
   }
 
+  hunk->last_used = ++m_hunk_use_counter;
   m_current_hunk_index = hunk_index;
+  m_hunk_data = hunk->data.data();
+  QueuePrefetch(hunk_index);
   return true;
 }
 
+CDImageCHD::CachedHunk* CDImageCHD::FindCachedHunk(u32 hunk_index)
+{
+  for (CachedHunk& hunk : m_hunk_cache)
+  {
+    if (hunk.hunk_index == hunk_index)
+      return &hunk;
+  }
+
+  return nullptr;
+}
+
+CDImageCHD::CachedHunk* CDImageCHD::GetEvictableHunk(u32 first_protected_hunk, u32 last_protected_hunk)
+{
+  CachedHunk* ret = nullptr;
+  for (CachedHunk& hunk : m_hunk_cache)
+  {
+    if (hunk.state == HunkState::Queued || hunk.hunk_index == m_current_hunk_index ||
+        (hunk.hunk_index >= first_protected_hunk && hunk.hunk_index <= last_protected_hunk))
+    {
+      continue;
+    }
+
+    if (!ret || hunk.last_used < ret->last_used)
+      ret = &hunk;
+  }
+
+  return ret;
+}
+
+void CDImageCHD::QueuePrefetch(u32 hunk_index)
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  const u32 last_hunk_index = std::min(hunk_index + PREFETCH_HUNKS, m_total_hunks - 1);
+
+  // Drop prefetches which haven't started yet, and aren't ahead of this read, since we've seeked away.
+  for (auto it = m_prefetch_queue.begin(); it != m_prefetch_queue.end();)
+  {
+    CachedHunk* hunk = *it;
+    if (hunk->hunk_index > hunk_index && hunk->hunk_index <= last_hunk_index)
+    {
+      ++it;
+      continue;
+    }
+
+    hunk->hunk_index = INVALID_HUNK_INDEX;
+    hunk->state = HunkState::Empty;
+    it = m_prefetch_queue.erase(it);
+  }
+
+  bool queued = false;
+  for (u32 next_hunk_index = hunk_index + 1; next_hunk_index <= last_hunk_index; next_hunk_index++)
+  {
+    if (FindCachedHunk(next_hunk_index))
+      continue;
+
+    CachedHunk* hunk = GetEvictableHunk(hunk_index, last_hunk_index);
+    if (!hunk)
+      break;
+
+    hunk->hunk_index = next_hunk_index;
+    hunk->last_used = m_hunk_use_counter;
+    hunk->state = HunkState::Queued;
+    m_prefetch_queue.push_back(hunk);
+    queued = true;
+  }
+
+  if (queued)
+    m_prefetch_work_cv.notify_one();
+}
+
+void CDImageCHD::StartPrefetchThread()
+{
+  // Not having prefetch isn't fatal, reads just happen on demand.
+  Error error;
+  m_prefetch_chd = OpenAdditionalHandle(&error);
+  if (!m_prefetch_chd)
+  {
+    Log_WarningFmt("Failed to open prefetch handle for '{}': {}", m_filename, error.GetDescription());
+    return;
+  }
+
+  m_prefetch_shutdown = false;
+  m_prefetch_thread = std::thread(&CDImageCHD::PrefetchThreadEntryPoint, this);
+}
+
+void CDImageCHD::StopPrefetchThread()
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_prefetch_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_work_cv.notify_one();
+  }
+
+  m_prefetch_thread.join();
+
+  for (CachedHunk* hunk : m_prefetch_queue)
+  {
+    hunk->hunk_index = INVALID_HUNK_INDEX;
+    hunk->state = HunkState::Empty;
+  }
+  m_prefetch_queue.clear();
+}
+
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("CHD Prefetch Thread");
+  Threading::SetCurrentThreadRole(Threading::ThreadRole::Background);
+
+  std::unique_lock lock(m_prefetch_mutex);
+  for (;;)
+  {
+    m_prefetch_work_cv.wait(lock, [this]() { return (m_prefetch_shutdown || !m_prefetch_queue.empty()); });
+    if (m_prefetch_shutdown)
+      break;
+
+    CachedHunk* hunk = m_prefetch_queue.front();
+    m_prefetch_queue.pop_front();
+    const u32 hunk_index = hunk->hunk_index;
+    lock.unlock();
+
+    const chd_error err = chd_read(m_prefetch_chd, hunk_index, hunk->data.data());
+    if (err != CHDERR_NONE)
+      Log_DevFmt("Prefetch of hunk {} failed: {}", hunk_index, chd_error_string(err));
+
+    lock.lock();
+    if (err != CHDERR_NONE)
+      hunk->hunk_index = INVALID_HUNK_INDEX;
+    hunk->state = (err == CHDERR_NONE) ? HunkState::Ready : HunkState::Empty;
+    m_prefetch_done_cv.notify_all();
+  }
+}
+
 s64 CDImageCHD::GetSizeOnDisk() const
 {
   return static_cast<s64>(chd_get_compressed_size(m_chd));
@@ -9,6 +9,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 
 #include "fmt/format.h"
@@ -42,6 +43,11 @@ private:
     std::string filename;
     std::FILE* file;
     u64 file_position;
+
+    // Sectors are copied straight out of a mapping of the file when possible, instead of going through stdio.
+    const u8* mapping;
+    u64 mapping_size;
+    u64 prefetch_end;
   };
 
   std::vector<TrackFile> m_files;
@@ -54,7 +60,12 @@ CDImageCueSheet::CDImageCueSheet() = default;
 
 CDImageCueSheet::~CDImageCueSheet()
 {
-  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) { std::fclose(t.file); });
+  for (TrackFile& tf : m_files)
+  {
+    if (tf.mapping)
+      MemMap::UnmapFile(tf.mapping, static_cast<size_t>(tf.mapping_size));
+    std::fclose(tf.file);
+  }
 }
 
 bool CDImageCueSheet::OpenAndParse(const char* filename, Error* error)
@@ -124,7 +135,16 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Error* error)
         return false;
       }
 
-      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      const s64 track_file_size = FileSystem::FSize64(track_fp);
+      Error map_error;
+      const u8* mapping = (track_file_size > 0) ? static_cast<const u8*>(MemMap::MapFileReadOnly(
+                                                    track_fp, static_cast<size_t>(track_file_size), &map_error)) :
+                                                  nullptr;
+      if (!mapping && track_file_size > 0)
+        Log_DevFmt("Failed to map '{}', using buffered reads: {}", track_filename, map_error.GetDescription());
+
+      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0, mapping,
+                                  mapping ? static_cast<u64>(track_file_size) : 0, 0});
     }
 
     // data type determines the sector size
@@ -317,6 +337,12 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
 
   TrackFile& tf = m_files[index.file_index];
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (tf.mapping)
+  {
+    return ReadSectorFromMapping(buffer, tf.mapping, tf.mapping_size, file_position, index.file_sector_size,
+                                 &tf.prefetch_end);
+  }
+
   if (tf.file_position != file_position)
   {
     if (std::fseek(tf.file, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -10,8 +10,9 @@
 #include "common/log.h"
 #include "common/path.h"
 
+#include <algorithm>
 #include <array>
-#include <map>
+#include <vector>
 
 Log_SetChannel(CDImageEcm);
 
@@ -179,6 +180,22 @@ protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  static constexpr u32 INDEX_CACHE_MAGIC = 0x49434345; // ECCI
+  static constexpr u32 INDEX_CACHE_VERSION = 1;
+
+  struct IndexCacheHeader
+  {
+    u32 magic;
+    u32 version;
+    s64 file_size;
+    s64 modification_time;
+    u32 num_entries;
+    u32 disc_size;
+  };
+
+  bool BuildSectorMap(s64 file_size, Error* error);
+  bool LoadSectorMap(const std::string& path, const FILESYSTEM_STAT_DATA& sd);
+  void SaveSectorMap(const std::string& path, const FILESYSTEM_STAT_DATA& sd) const;
   bool ReadChunks(u32 disc_offset, u32 size);
 
   std::FILE* m_fp = nullptr;
@@ -208,14 +225,17 @@ private:
 
   struct SectorEntry
   {
+    u32 disc_offset;
     u32 file_offset;
     u32 chunk_size;
     SectorType type;
   };
 
-  using DataMap = std::map<u32, SectorEntry>;
+  // Sorted by disc offset, so lookups are a binary search.
+  using DataMap = std::vector<SectorEntry>;
 
   DataMap m_data_map;
+  u32 m_disc_size = 0;
   std::vector<u8> m_chunk_buffer;
   u32 m_chunk_start = 0;
 
@@ -262,7 +282,73 @@ bool CDImageEcm::Open(const char* filename, Error* error)
     return false;
   }
 
-  // build sector map
+  // Building the sector map means walking every chunk header in the file, so keep it around for next time.
+  FILESYSTEM_STAT_DATA sd;
+  const std::string index_path = GetIndexCachePath(filename, "ecmidx");
+  const bool can_cache_index = (!index_path.empty() && FileSystem::StatFile(m_fp, &sd));
+  if (!can_cache_index || !LoadSectorMap(index_path, sd))
+  {
+    if (!BuildSectorMap(file_size, error))
+      return false;
+
+    if (can_cache_index)
+      SaveSectorMap(index_path, sd);
+  }
+
+  m_lba_count = m_disc_size / RAW_SECTOR_SIZE;
+  if ((m_disc_size % RAW_SECTOR_SIZE) != 0)
+    Log_WarningPrintf("ECM image is misaligned with offset %u", m_disc_size);
+  if (m_lba_count == 0)
+    return false;
+
+  SubChannelQ::Control control = {};
+  TrackMode mode = TrackMode::Mode2Raw;
+  control.data = mode != TrackMode::Audio;
+
+  // Two seconds default pregap.
+  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
+  Index pregap_index = {};
+  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
+  pregap_index.start_lba_on_disc = 0;
+  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
+  pregap_index.length = pregap_frames;
+  pregap_index.track_number = 1;
+  pregap_index.index_number = 0;
+  pregap_index.mode = mode;
+  pregap_index.submode = CDImage::SubchannelMode::None;
+  pregap_index.control.bits = control.bits;
+  pregap_index.is_pregap = true;
+  m_indices.push_back(pregap_index);
+
+  // Data index.
+  Index data_index = {};
+  data_index.file_index = 0;
+  data_index.file_offset = 0;
+  data_index.file_sector_size = RAW_SECTOR_SIZE;
+  data_index.start_lba_on_disc = pregap_index.length;
+  data_index.track_number = 1;
+  data_index.index_number = 1;
+  data_index.start_lba_in_track = 0;
+  data_index.length = m_lba_count;
+  data_index.mode = mode;
+  data_index.submode = CDImage::SubchannelMode::None;
+  data_index.control.bits = control.bits;
+  m_indices.push_back(data_index);
+
+  // Assume a single track.
+  m_tracks.push_back(Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode,
+                           SubchannelMode::None, control});
+
+  AddLeadOutIndex();
+
+  m_sbi.LoadFromImagePath(filename);
+
+  m_chunk_buffer.reserve(RAW_SECTOR_SIZE * 2);
+  return Seek(1, Position{0, 0, 0});
+}
+
+bool CDImageEcm::BuildSectorMap(s64 file_size, Error* error)
+{
   u32 file_offset = static_cast<u32>(std::ftell(m_fp));
   u32 disc_offset = 0;
 
@@ -313,7 +399,7 @@ bool CDImageEcm::Open(const char* filename, Error* error)
       while (count > 0)
       {
         const u32 size = std::min<u32>(count, 2352);
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, size, type});
+        m_data_map.push_back(SectorEntry{disc_offset, file_offset, size, type});
         disc_offset += size;
         file_offset += size;
         count -= size;
@@ -331,7 +417,7 @@ bool CDImageEcm::Open(const char* filename, Error* error)
       const u32 chunk_size = s_chunk_sizes[static_cast<u32>(type)];
       for (u32 i = 0; i < count; i++)
       {
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, chunk_size, type});
+        m_data_map.push_back(SectorEntry{disc_offset, file_offset, chunk_size, type});
         disc_offset += chunk_size;
         file_offset += size;
 
@@ -353,88 +439,89 @@ bool CDImageEcm::Open(const char* filename, Error* error)
 
   if (m_data_map.empty())
   {
-    Log_ErrorPrintf("No data in image '%s'", filename);
-    Error::SetStringFmt(error, "No data in image '{}'", filename);
+    Log_ErrorPrintf("No data in image '%s'", m_filename.c_str());
+    Error::SetStringFmt(error, "No data in image '{}'", m_filename);
     return false;
   }
 
-  m_lba_count = disc_offset / RAW_SECTOR_SIZE;
-  if ((disc_offset % RAW_SECTOR_SIZE) != 0)
-    Log_WarningPrintf("ECM image is misaligned with offset %u", disc_offset);
-  if (m_lba_count == 0)
-    return false;
-
-  SubChannelQ::Control control = {};
-  TrackMode mode = TrackMode::Mode2Raw;
-  control.data = mode != TrackMode::Audio;
-
-  // Two seconds default pregap.
-  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
-  Index pregap_index = {};
-  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
-  pregap_index.start_lba_on_disc = 0;
-  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
-  pregap_index.length = pregap_frames;
-  pregap_index.track_number = 1;
-  pregap_index.index_number = 0;
-  pregap_index.mode = mode;
-  pregap_index.submode = CDImage::SubchannelMode::None;
-  pregap_index.control.bits = control.bits;
-  pregap_index.is_pregap = true;
-  m_indices.push_back(pregap_index);
+  m_disc_size = disc_offset;
+  return true;
+}
 
-  // Data index.
-  Index data_index = {};
-  data_index.file_index = 0;
-  data_index.file_offset = 0;
-  data_index.file_sector_size = RAW_SECTOR_SIZE;
-  data_index.start_lba_on_disc = pregap_index.length;
-  data_index.track_number = 1;
-  data_index.index_number = 1;
-  data_index.start_lba_in_track = 0;
-  data_index.length = m_lba_count;
-  data_index.mode = mode;
-  data_index.submode = CDImage::SubchannelMode::None;
-  data_index.control.bits = control.bits;
-  m_indices.push_back(data_index);
+bool CDImageEcm::LoadSectorMap(const std::string& path, const FILESYSTEM_STAT_DATA& sd)
+{
+  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "rb");
+  if (!fp)
+    return false;
 
-  // Assume a single track.
-  m_tracks.push_back(Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode,
-                           SubchannelMode::None, control});
+  IndexCacheHeader header;
+  if (std::fread(&header, sizeof(header), 1, fp.get()) != 1 || header.magic != INDEX_CACHE_MAGIC ||
+      header.version != INDEX_CACHE_VERSION || header.file_size != sd.Size ||
+      header.modification_time != static_cast<s64>(sd.ModificationTime) || header.num_entries == 0)
+  {
+    Log_WarningFmt("Ignoring stale or invalid sector index '{}'", Path::GetFileName(path));
+    return false;
+  }
 
-  AddLeadOutIndex();
+  m_data_map.resize(header.num_entries);
+  if (std::fread(m_data_map.data(), sizeof(SectorEntry), header.num_entries, fp.get()) != header.num_entries)
+  {
+    Log_WarningFmt("Failed to read sector index '{}'", Path::GetFileName(path));
+    m_data_map.clear();
+    return false;
+  }
 
-  m_sbi.LoadFromImagePath(filename);
+  m_disc_size = header.disc_size;
+  Log_DevFmt("Loaded {} sector map entries from '{}'", m_data_map.size(), Path::GetFileName(path));
+  return true;
+}
 
-  m_chunk_buffer.reserve(RAW_SECTOR_SIZE * 2);
-  return Seek(1, Position{0, 0, 0});
+void CDImageEcm::SaveSectorMap(const std::string& path, const FILESYSTEM_STAT_DATA& sd) const
+{
+  const IndexCacheHeader header = {INDEX_CACHE_MAGIC,
+                                   INDEX_CACHE_VERSION,
+                                   sd.Size,
+                                   static_cast<s64>(sd.ModificationTime),
+                                   static_cast<u32>(m_data_map.size()),
+                                   m_disc_size};
+
+  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb");
+  if (!fp || std::fwrite(&header, sizeof(header), 1, fp.get()) != 1 ||
+      std::fwrite(m_data_map.data(), sizeof(SectorEntry), m_data_map.size(), fp.get()) != m_data_map.size())
+  {
+    Log_WarningFmt("Failed to write sector index '{}'", Path::GetFileName(path));
+    fp.reset();
+    FileSystem::DeleteFile(path.c_str());
+  }
 }
 
 bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
 {
-  DataMap::iterator next =
-    m_data_map.lower_bound((disc_offset > RAW_SECTOR_SIZE) ? (disc_offset - RAW_SECTOR_SIZE) : 0);
-  DataMap::iterator current = m_data_map.begin();
-  while (next != m_data_map.end() && next->first <= disc_offset)
-    current = next++;
+  // Find the last chunk starting at or before the offset.
+  DataMap::iterator current =
+    std::upper_bound(m_data_map.begin(), m_data_map.end(), disc_offset,
+                     [](u32 offset, const SectorEntry& entry) { return (offset < entry.disc_offset); });
+  if (current == m_data_map.begin())
+    return false;
+  --current;
 
   // extra bytes if we need to buffer some at the start
-  m_chunk_start = current->first;
+  m_chunk_start = current->disc_offset;
   m_chunk_buffer.clear();
   if (m_chunk_start < disc_offset)
-    size += (disc_offset - current->first);
+    size += (disc_offset - current->disc_offset);
 
   u32 total_bytes_read = 0;
   while (total_bytes_read < size)
   {
-    if (current == m_data_map.end() || std::fseek(m_fp, current->second.file_offset, SEEK_SET) != 0)
+    if (current == m_data_map.end() || std::fseek(m_fp, current->file_offset, SEEK_SET) != 0)
       return false;
 
-    const u32 chunk_size = current->second.chunk_size;
+    const u32 chunk_size = current->chunk_size;
     const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
     m_chunk_buffer.resize(chunk_start + chunk_size);
 
-    if (current->second.type == SectorType::Raw)
+    if (current->type == SectorType::Raw)
     {
       if (std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
         return false;
@@ -451,7 +538,7 @@ bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
       std::memset(sector + 1, 0xFF, 10);
 
       u32 skip;
-      switch (current->second.type)
+      switch (current->type)
       {
         case SectorType::Mode1:
         {
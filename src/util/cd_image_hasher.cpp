@@ -8,9 +8,19 @@
 
 #include "common/md5_digest.h"
 #include "common/string_util.h"
+#include "common/threading.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace CDImageHasher {
 
+// Sectors are read on a worker thread in chunks this size, so reading/decompressing overlaps hashing.
+static constexpr u32 READ_CHUNK_SECTORS = 64;
+static constexpr u32 NUM_READ_CHUNKS = 4;
+
 static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback);
 static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback);
 
@@ -34,19 +44,104 @@ bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* dig
     return false;
   }
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
-  for (u32 lba = 0; lba < index_length; lba++)
+  struct ReadChunk
   {
-    if ((lba % update_interval) == 0)
-      progress_callback->SetProgressValue(lba);
+    std::array<u8, READ_CHUNK_SECTORS * CDImage::RAW_SECTOR_SIZE> data;
+    u32 num_sectors;
+  };
+
+  const std::unique_ptr<ReadChunk[]> chunks = std::make_unique<ReadChunk[]>(NUM_READ_CHUNKS);
+  const u32 num_chunks = (index_length + (READ_CHUNK_SECTORS - 1)) / READ_CHUNK_SECTORS;
+  std::mutex mutex;
+  std::condition_variable cv;
+  u32 chunks_read = 0;
+  u32 chunks_hashed = 0;
+  bool read_error = false;
+  bool cancelled = false;
+  CDImage::LBA error_lba = 0;
+
+  // The image is only touched by the reader until it has been joined.
+  std::thread reader([&]() {
+    Threading::SetNameOfCurrentThread("CD Image Hasher Reader");
+
+    u32 lba = 0;
+    for (u32 i = 0; i < num_chunks; i++)
+    {
+      {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&]() { return (cancelled || (chunks_read - chunks_hashed) < NUM_READ_CHUNKS); });
+        if (cancelled)
+          return;
+      }
+
+      ReadChunk& chunk = chunks[i % NUM_READ_CHUNKS];
+      chunk.num_sectors = std::min(index_length - lba, READ_CHUNK_SECTORS);
+      for (u32 j = 0; j < chunk.num_sectors; j++)
+      {
+        if (!image->ReadRawSector(&chunk.data[j * CDImage::RAW_SECTOR_SIZE], nullptr))
+        {
+          std::unique_lock lock(mutex);
+          read_error = true;
+          error_lba = image->GetPositionOnDisc();
+          cv.notify_all();
+          return;
+        }
+      }
+      lba += chunk.num_sectors;
+
+      std::unique_lock lock(mutex);
+      chunks_read++;
+      cv.notify_all();
+    }
+  });
 
-    if (!image->ReadRawSector(sector.data(), nullptr))
+  bool result = true;
+  u32 lba = 0;
+  for (u32 i = 0; i < num_chunks; i++)
+  {
     {
-      progress_callback->DisplayFormattedModalError("Failed to read sector %u from image", image->GetPositionOnDisc());
-      return false;
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [&]() { return (read_error || chunks_read > i); });
+      if (chunks_read <= i)
+      {
+        result = false;
+        break;
+      }
     }
 
-    digest->Update(sector.data(), static_cast<u32>(sector.size()));
+    const ReadChunk& chunk = chunks[i % NUM_READ_CHUNKS];
+    digest->Update(chunk.data.data(), chunk.num_sectors * CDImage::RAW_SECTOR_SIZE);
+
+    {
+      std::unique_lock lock(mutex);
+      chunks_hashed++;
+      cv.notify_all();
+    }
+
+    if ((lba / update_interval) != ((lba + chunk.num_sectors) / update_interval))
+      progress_callback->SetProgressValue(lba + chunk.num_sectors);
+    lba += chunk.num_sectors;
+
+    if (progress_callback->IsCancelled())
+    {
+      std::unique_lock lock(mutex);
+      cancelled = true;
+      cv.notify_all();
+      result = false;
+      break;
+    }
+  }
+
+  reader.join();
+
+  if (read_error)
+  {
+    progress_callback->DisplayFormattedModalError("Failed to read sector %u from image", error_lba);
+    return false;
+  }
+  else if (!result)
+  {
+    return false;
   }
 
   progress_callback->SetProgressValue(index_length);
@@ -0,0 +1,429 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "cd_image.h"
+
+#include "common/align.h"
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "common/threading.h"
+#include "common/timer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+Log_SetChannel(CDImageLocalCache);
+
+namespace {
+
+class CDImageLocalCache : public CDImage
+{
+public:
+  CDImageLocalCache();
+  ~CDImageLocalCache() override;
+
+  bool Open(std::unique_ptr<CDImage>& parent_image, const char* cache_directory, u64 max_cache_size, Error* error);
+
+  bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
+  bool HasNonStandardSubchannel() const override;
+  s64 GetSizeOnDisk() const override;
+
+  std::string GetMetadata(std::string_view type) const override;
+  std::string GetSubImageMetadata(u32 index, std::string_view type) const override;
+
+protected:
+  bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+
+private:
+  static constexpr u32 CACHE_MAGIC = 0x48434344; // DCCH
+  static constexpr u32 CACHE_VERSION = 1;
+  static constexpr u32 DATA_ALIGNMENT = 4096;
+
+  // The bitmap is written back after this many new sectors, and when the image is closed. Sectors are always written
+  // before their bit is set, so a stale bitmap only loses recently-cached sectors.
+  static constexpr u32 BITMAP_FLUSH_INTERVAL = 256;
+
+  // Background fill only runs once nothing has been read for this long, and drops the lock between batches, so the
+  // emulated drive never waits behind it for the network.
+  static constexpr double IDLE_TIME_BEFORE_FILL = 0.5;
+  static constexpr u32 FILL_BATCH_SECTORS = 16;
+
+  struct CacheHeader
+  {
+    u32 magic;
+    u32 version;
+    s64 source_size;
+    s64 source_modification_time;
+    u32 lba_count;
+    u32 data_offset;
+  };
+
+  static void EvictCacheFiles(const char* directory, const std::string& keep_path, u64 needed_size, u64 max_size);
+
+  bool OpenCacheFile(const std::string& path, const FILESYSTEM_STAT_DATA& sd);
+  bool CreateCacheFile(const std::string& path, const FILESYSTEM_STAT_DATA& sd, Error* error);
+
+  ALWAYS_INLINE bool IsSectorCached(LBA lba) const { return ((m_bitmap[lba / 64] >> (lba % 64)) & 1) != 0; }
+  void CacheSector(LBA lba, const void* buffer);
+  void FlushBitmap();
+
+  void FillThreadEntryPoint();
+  void StopFillThread();
+
+  std::unique_ptr<CDImage> m_parent_image;
+
+  std::FILE* m_cache_fp = nullptr;
+  u32 m_data_offset = 0;
+  std::vector<u64> m_bitmap;
+  u32 m_sectors_since_flush = 0;
+  bool m_cache_write_failed = false;
+
+  // Guards the parent image and the cache file, which are shared with the fill thread.
+  mutable std::mutex m_mutex;
+  std::condition_variable m_fill_cv;
+  std::thread m_fill_thread;
+  Common::Timer::Value m_last_read_time = 0;
+  bool m_fill_shutdown = false;
+};
+
+} // namespace
+
+CDImageLocalCache::CDImageLocalCache() = default;
+
+CDImageLocalCache::~CDImageLocalCache()
+{
+  StopFillThread();
+
+  if (m_cache_fp)
+  {
+    FlushBitmap();
+    std::fclose(m_cache_fp);
+  }
+}
+
+bool CDImageLocalCache::Open(std::unique_ptr<CDImage>& parent_image, const char* cache_directory, u64 max_cache_size,
+                             Error* error)
+{
+  // Sub-image switching isn't forwarded, so multi-disc images can't be wrapped.
+  if (parent_image->HasSubImages() && parent_image->GetSubImageCount() > 1)
+  {
+    Error::SetStringView(error, "Multi-disc images are not supported.");
+    return false;
+  }
+
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(parent_image->GetFileName().c_str(), &sd))
+  {
+    Error::SetStringView(error, "Failed to stat source image.");
+    return false;
+  }
+
+  const u32 lba_count = parent_image->GetLBACount();
+  const u32 bitmap_size = ((lba_count + 63) / 64) * sizeof(u64);
+  const u32 data_offset = Common::AlignUpPow2(static_cast<u32>(sizeof(CacheHeader)) + bitmap_size, DATA_ALIGNMENT);
+  const u64 cache_size = data_offset + static_cast<u64>(lba_count) * RAW_SECTOR_SIZE;
+  if (cache_size > max_cache_size)
+  {
+    Error::SetStringFmt(error, "Image needs {} MB of cache, which is over the limit.", cache_size / 1048576);
+    return false;
+  }
+
+  if (!FileSystem::EnsureDirectoryExists(cache_directory, false, error))
+    return false;
+
+  const std::string path = GetCachePathForImage(cache_directory, parent_image->GetFileName().c_str(), "dcache");
+  EvictCacheFiles(cache_directory, path, cache_size, max_cache_size);
+
+  m_bitmap.resize(bitmap_size / sizeof(u64));
+  m_data_offset = data_offset;
+  m_lba_count = lba_count;
+  if (!OpenCacheFile(path, sd) && !CreateCacheFile(path, sd, error))
+    return false;
+
+  u32 cached_sectors = 0;
+  for (const u64 word : m_bitmap)
+    cached_sectors += static_cast<u32>(std::popcount(word));
+  Log_InfoFmt("Using local cache '{}' for '{}', {} of {} sectors cached", Path::GetFileName(path),
+              Path::GetFileName(parent_image->GetFileName()), cached_sectors, lba_count);
+
+  CopyTOC(parent_image.get());
+  m_filename = parent_image->GetFileName();
+  if (!Seek(1, Position{0, 0, 0}))
+  {
+    Error::SetStringView(error, "Failed to seek to start of image.");
+    return false;
+  }
+
+  // Ownership is only taken once nothing can fail, so the caller can fall back to the parent.
+  m_parent_image = std::move(parent_image);
+  m_last_read_time = Common::Timer::GetCurrentValue();
+  m_fill_thread = std::thread(&CDImageLocalCache::FillThreadEntryPoint, this);
+  return true;
+}
+
+void CDImageLocalCache::EvictCacheFiles(const char* directory, const std::string& keep_path, u64 needed_size,
+                                        u64 max_size)
+{
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(directory, "*.dcache", FILESYSTEM_FIND_FILES, &files);
+
+  u64 total_size = needed_size;
+  for (auto it = files.begin(); it != files.end();)
+  {
+    if (it->FileName == keep_path)
+    {
+      it = files.erase(it);
+      continue;
+    }
+
+    total_size += static_cast<u64>(it->Size);
+    ++it;
+  }
+
+  // Cache files are rewritten whenever they're used, so the modification time doubles as the last use.
+  std::sort(files.begin(), files.end(), [](const FILESYSTEM_FIND_DATA& lhs, const FILESYSTEM_FIND_DATA& rhs) {
+    return (lhs.ModificationTime < rhs.ModificationTime);
+  });
+
+  for (const FILESYSTEM_FIND_DATA& fd : files)
+  {
+    if (total_size <= max_size)
+      break;
+
+    Log_InfoFmt("Evicting local disc cache '{}'", Path::GetFileName(fd.FileName));
+    if (FileSystem::DeleteFile(fd.FileName.c_str()))
+      total_size -= static_cast<u64>(fd.Size);
+  }
+}
+
+bool CDImageLocalCache::OpenCacheFile(const std::string& path, const FILESYSTEM_STAT_DATA& sd)
+{
+  m_cache_fp = FileSystem::OpenCFile(path.c_str(), "r+b", nullptr);
+  if (!m_cache_fp)
+    return false;
+
+  CacheHeader header;
+  if (std::fread(&header, sizeof(header), 1, m_cache_fp) != 1 || header.magic != CACHE_MAGIC ||
+      header.version != CACHE_VERSION || header.source_size != sd.Size ||
+      header.source_modification_time != static_cast<s64>(sd.ModificationTime) || header.lba_count != m_lba_count ||
+      header.data_offset != m_data_offset ||
+      std::fread(m_bitmap.data(), sizeof(u64), m_bitmap.size(), m_cache_fp) != m_bitmap.size())
+  {
+    Log_WarningFmt("Discarding stale local cache '{}'", Path::GetFileName(path));
+    std::fclose(m_cache_fp);
+    m_cache_fp = nullptr;
+    return false;
+  }
+
+  // Rewrite the header, so the modification time reflects the last use for eviction.
+  if (FileSystem::FSeek64(m_cache_fp, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, m_cache_fp) != 1)
+    Log_WarningFmt("Failed to update local cache '{}'", Path::GetFileName(path));
+
+  return true;
+}
+
+bool CDImageLocalCache::CreateCacheFile(const std::string& path, const FILESYSTEM_STAT_DATA& sd, Error* error)
+{
+  m_cache_fp = FileSystem::OpenCFile(path.c_str(), "w+b", error);
+  if (!m_cache_fp)
+    return false;
+
+  // Sector data is written at its final offset as it arrives, which leaves the file sparse where supported.
+  const CacheHeader header = {
+    CACHE_MAGIC, CACHE_VERSION, sd.Size, static_cast<s64>(sd.ModificationTime), m_lba_count, m_data_offset};
+  std::fill(m_bitmap.begin(), m_bitmap.end(), 0);
+  if (std::fwrite(&header, sizeof(header), 1, m_cache_fp) != 1 ||
+      std::fwrite(m_bitmap.data(), sizeof(u64), m_bitmap.size(), m_cache_fp) != m_bitmap.size())
+  {
+    Error::SetErrno(error, "Failed to write local cache header: ", errno);
+    std::fclose(m_cache_fp);
+    m_cache_fp = nullptr;
+    FileSystem::DeleteFile(path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void CDImageLocalCache::CacheSector(LBA lba, const void* buffer)
+{
+  if (m_cache_write_failed)
+    return;
+
+  const s64 offset = static_cast<s64>(m_data_offset) + static_cast<s64>(lba) * RAW_SECTOR_SIZE;
+  if (FileSystem::FSeek64(m_cache_fp, offset, SEEK_SET) != 0 || std::fwrite(buffer, RAW_SECTOR_SIZE, 1, m_cache_fp) != 1)
+  {
+    // Probably out of space. Keep serving what's already cached, but stop adding to it.
+    Log_ErrorFmt("Failed to write LBA {} to local cache, disabling further caching", lba);
+    m_cache_write_failed = true;
+    return;
+  }
+
+  m_bitmap[lba / 64] |= (u64(1) << (lba % 64));
+  if ((++m_sectors_since_flush) == BITMAP_FLUSH_INTERVAL)
+    FlushBitmap();
+}
+
+void CDImageLocalCache::FlushBitmap()
+{
+  if (m_sectors_since_flush == 0)
+    return;
+
+  m_sectors_since_flush = 0;
+  if (std::fflush(m_cache_fp) != 0 || FileSystem::FSeek64(m_cache_fp, sizeof(CacheHeader), SEEK_SET) != 0 ||
+      std::fwrite(m_bitmap.data(), sizeof(u64), m_bitmap.size(), m_cache_fp) != m_bitmap.size())
+  {
+    Log_ErrorPrint("Failed to write local cache bitmap");
+  }
+}
+
+void CDImageLocalCache::FillThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("CD Local Cache Fill");
+
+  std::array<u8, RAW_SECTOR_SIZE> buffer;
+  size_t index_pos = 0;
+  LBA lba_in_index = 0;
+
+  std::unique_lock lock(m_mutex);
+  while (!m_fill_shutdown && !m_cache_write_failed)
+  {
+    const double idle_time =
+      Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - m_last_read_time);
+    if (idle_time < IDLE_TIME_BEFORE_FILL)
+    {
+      m_fill_cv.wait_for(lock, std::chrono::duration<double>(IDLE_TIME_BEFORE_FILL - idle_time));
+      continue;
+    }
+
+    u32 sectors_filled = 0;
+    while (sectors_filled < FILL_BATCH_SECTORS && index_pos < m_indices.size())
+    {
+      const Index& index = m_indices[index_pos];
+      if (index.file_sector_size == 0 || lba_in_index >= index.length)
+      {
+        index_pos++;
+        lba_in_index = 0;
+        continue;
+      }
+
+      const LBA lba = index.start_lba_on_disc + lba_in_index;
+      if (!IsSectorCached(lba))
+      {
+        if (!m_parent_image->ReadSectorFromIndex(buffer.data(), index, lba_in_index))
+        {
+          Log_ErrorFmt("Failed to read LBA {} for local cache, stopping background fill", lba);
+          return;
+        }
+
+        CacheSector(lba, buffer.data());
+        sectors_filled++;
+      }
+
+      lba_in_index++;
+    }
+
+    if (index_pos == m_indices.size())
+    {
+      FlushBitmap();
+      Log_InfoFmt("Local cache for '{}' is complete", Path::GetFileName(m_filename));
+      return;
+    }
+
+    lock.unlock();
+    std::this_thread::yield();
+    lock.lock();
+  }
+}
+
+void CDImageLocalCache::StopFillThread()
+{
+  if (!m_fill_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_fill_shutdown = true;
+    m_fill_cv.notify_one();
+  }
+
+  m_fill_thread.join();
+}
+
+bool CDImageLocalCache::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+{
+  const LBA lba = index.start_lba_on_disc + lba_in_index;
+  DebugAssert(lba < m_lba_count);
+
+  std::unique_lock lock(m_mutex);
+  m_last_read_time = Common::Timer::GetCurrentValue();
+
+  if (IsSectorCached(lba))
+  {
+    const s64 offset = static_cast<s64>(m_data_offset) + static_cast<s64>(lba) * RAW_SECTOR_SIZE;
+    if (FileSystem::FSeek64(m_cache_fp, offset, SEEK_SET) == 0 &&
+        std::fread(buffer, RAW_SECTOR_SIZE, 1, m_cache_fp) == 1)
+    {
+      return true;
+    }
+
+    Log_WarningFmt("Failed to read LBA {} from local cache, falling back to source", lba);
+  }
+
+  if (!m_parent_image->ReadSectorFromIndex(buffer, index, lba_in_index))
+    return false;
+
+  CacheSector(lba, buffer);
+  return true;
+}
+
+bool CDImageLocalCache::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
+{
+  std::unique_lock lock(m_mutex);
+  return m_parent_image->ReadSubChannelQ(subq, index, lba_in_index);
+}
+
+bool CDImageLocalCache::HasNonStandardSubchannel() const
+{
+  return m_parent_image->HasNonStandardSubchannel();
+}
+
+s64 CDImageLocalCache::GetSizeOnDisk() const
+{
+  return m_parent_image->GetSizeOnDisk();
+}
+
+std::string CDImageLocalCache::GetMetadata(std::string_view type) const
+{
+  std::unique_lock lock(m_mutex);
+  return m_parent_image->GetMetadata(type);
+}
+
+std::string CDImageLocalCache::GetSubImageMetadata(u32 index, std::string_view type) const
+{
+  std::unique_lock lock(m_mutex);
+  return m_parent_image->GetSubImageMetadata(index, type);
+}
+
+std::unique_ptr<CDImage> CDImage::CreateLocalCacheImage(std::unique_ptr<CDImage> parent_image,
+                                                        const char* cache_directory, u64 max_cache_size)
+{
+  Error error;
+  std::unique_ptr<CDImageLocalCache> image = std::make_unique<CDImageLocalCache>();
+  if (!image->Open(parent_image, cache_directory, max_cache_size, &error))
+  {
+    Log_WarningFmt("Not using local cache for '{}': {}", Path::GetFileName(parent_image->GetFileName()),
+                   error.GetDescription());
+    return parent_image;
+  }
+
+  return image;
+}
@@ -9,9 +9,11 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/thread_pool.h"
 
 #include <algorithm>
 #include <cerrno>
+#include <future>
 #include <map>
 #include <sstream>
 
@@ -47,10 +49,16 @@ private:
     std::string title;
   };
 
+  void PrefetchSubImage(u32 index);
+
   std::vector<Entry> m_entries;
   std::unique_ptr<CDImage> m_current_image;
   u32 m_current_image_index = UINT32_C(0xFFFFFFFF);
   bool m_apply_patches = false;
+
+  // Next entry in the playlist, opened on the thread pool so that the disc change doesn't stall the game.
+  std::future<std::unique_ptr<CDImage>> m_next_image;
+  u32 m_next_image_index = UINT32_C(0xFFFFFFFF);
 };
 
 } // namespace
@@ -143,7 +151,16 @@ bool CDImageM3u::SwitchSubImage(u32 index, Error* error)
     return true;
 
   const Entry& entry = m_entries[index];
-  std::unique_ptr<CDImage> new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
+  std::unique_ptr<CDImage> new_image;
+  if (m_next_image.valid() && m_next_image_index == index)
+  {
+    new_image = m_next_image.get();
+    m_next_image_index = UINT32_C(0xFFFFFFFF);
+  }
+
+  // Open it again if the prefetch failed, so the caller gets the error.
+  if (!new_image)
+    new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
   if (!new_image)
   {
     Log_ErrorPrintf("Failed to load subimage %u (%s)", index, entry.filename.c_str());
@@ -156,9 +173,35 @@ bool CDImageM3u::SwitchSubImage(u32 index, Error* error)
   if (!Seek(1, Position{0, 0, 0}))
     Panic("Failed to seek to start after sub-image change.");
 
+  PrefetchSubImage(index + 1);
   return true;
 }
 
+void CDImageM3u::PrefetchSubImage(u32 index)
+{
+  if (index >= m_entries.size())
+  {
+    m_next_image = {};
+    m_next_image_index = UINT32_C(0xFFFFFFFF);
+    return;
+  }
+  else if (m_next_image.valid() && m_next_image_index == index)
+  {
+    return;
+  }
+
+  // The task owns the image until it's taken, so an abandoned prefetch is simply freed when it completes.
+  m_next_image = Threading::ThreadPool::GetShared().Submit(
+    [filename = m_entries[index].filename, apply_patches = m_apply_patches]() {
+      std::unique_ptr<CDImage> image = CDImage::Open(filename.c_str(), apply_patches, nullptr);
+      if (image)
+        image->WarmUp();
+      return image;
+    },
+    Threading::ThreadPool::Priority::Low);
+  m_next_image_index = index;
+}
+
 std::string CDImageM3u::GetSubImageMetadata(u32 index, std::string_view type) const
 {
   if (index > m_entries.size())
@@ -148,12 +148,23 @@ protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  // Ping-ponging between a few blocks, e.g. when a game streams audio while loading data, would otherwise inflate the
+  // same blocks again on every sector read.
+  static constexpr u32 BLOCK_CACHE_SIZE = 8;
+
   struct BlockInfo
   {
     u32 offset; // Absolute offset from start of file
     u16 size;
   };
 
+  struct CachedBlock
+  {
+    u32 block_index;
+    u32 last_used;
+    std::array<u8, DECOMPRESSED_BLOCK_SIZE> data;
+  };
+
 #if _DEBUG
   static void PrintPBPHeaderInfo(const PBPHeader& pbp_header);
   static void PrintSFOHeaderInfo(const SFOHeader& sfo_header);
@@ -169,7 +180,8 @@ private:
   bool IsValidEboot(Error* error);
 
   bool InitDecompressionStream();
-  bool DecompressBlock(const BlockInfo& block_info);
+  bool DecompressBlock(const BlockInfo& block_info, u8* decompressed_block);
+  void ClearBlockCache();
 
   bool OpenDisc(u32 index, Error* error);
 
@@ -191,8 +203,8 @@ private:
 
   std::array<TOCEntry, TOC_NUM_ENTRIES> m_toc;
 
-  u32 m_current_block = static_cast<u32>(-1);
-  std::array<u8, DECOMPRESSED_BLOCK_SIZE> m_decompressed_block;
+  std::array<CachedBlock, BLOCK_CACHE_SIZE> m_block_cache;
+  u32 m_block_cache_counter = 0;
   std::vector<u8> m_compressed_block;
 
   z_stream m_inflate_stream;
@@ -514,10 +526,9 @@ bool CDImagePBP::OpenDisc(u32 index, Error* error)
     return false;
   }
 
-  m_current_block = static_cast<u32>(-1);
+  ClearBlockCache();
   m_blockinfo_table.fill({});
   m_toc.fill({});
-  m_decompressed_block.fill(0x00);
   m_compressed_block.clear();
 
   // Go to ISO header
@@ -783,17 +794,24 @@ bool CDImagePBP::InitDecompressionStream()
   return ret == Z_OK;
 }
 
-bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+void CDImagePBP::ClearBlockCache()
+{
+  for (CachedBlock& cb : m_block_cache)
+  {
+    cb.block_index = static_cast<u32>(-1);
+    cb.last_used = 0;
+  }
+  m_block_cache_counter = 0;
+}
+
+bool CDImagePBP::DecompressBlock(const BlockInfo& block_info, u8* decompressed_block)
 {
   if (FileSystem::FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
     return false;
 
   // Compression level 0 has compressed size == decompressed size.
-  if (block_info.size == m_decompressed_block.size())
-  {
-    return (std::fread(m_decompressed_block.data(), sizeof(u8), m_decompressed_block.size(), m_file) ==
-            m_decompressed_block.size());
-  }
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+    return (std::fread(decompressed_block, sizeof(u8), DECOMPRESSED_BLOCK_SIZE, m_file) == DECOMPRESSED_BLOCK_SIZE);
 
   m_compressed_block.resize(block_info.size);
 
@@ -802,8 +820,8 @@ bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
 
   m_inflate_stream.next_in = m_compressed_block.data();
   m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+  m_inflate_stream.next_out = decompressed_block;
+  m_inflate_stream.avail_out = DECOMPRESSED_BLOCK_SIZE;
 
   if (inflateReset(&m_inflate_stream) != Z_OK)
     return false;
@@ -845,13 +863,35 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi))
+  CachedBlock* cb = &m_block_cache[0];
+  for (CachedBlock& it : m_block_cache)
   {
-    Log_ErrorPrintf("Failed to decompress block %u", requested_block);
-    return false;
+    if (it.block_index == requested_block)
+    {
+      cb = &it;
+      break;
+    }
+    else if (it.last_used < cb->last_used)
+    {
+      cb = &it;
+    }
+  }
+
+  if (cb->block_index != requested_block)
+  {
+    if (!DecompressBlock(bi, cb->data.data()))
+    {
+      Log_ErrorPrintf("Failed to decompress block %u", requested_block);
+      cb->block_index = static_cast<u32>(-1);
+      cb->last_used = 0;
+      return false;
+    }
+
+    cb->block_index = requested_block;
   }
 
-  std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
+  cb->last_used = ++m_block_cache_counter;
+  std::memcpy(buffer, &cb->data[offset_in_block], RAW_SECTOR_SIZE);
   return true;
 }
 
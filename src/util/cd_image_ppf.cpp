@@ -38,7 +38,8 @@ public:
   std::string GetMetadata(std::string_view type) const override;
   std::string GetSubImageMetadata(u32 index, std::string_view type) const override;
 
-  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback,
+                          u64 max_size = std::numeric_limits<u64>::max()) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -431,9 +432,10 @@ std::string CDImagePPF::GetSubImageMetadata(u32 index, std::string_view type) co
   return ret;
 }
 
-CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/,
+                                             u64 max_size /*= std::numeric_limits<u64>::max()*/)
 {
-  return m_parent_image->Precache(progress);
+  return m_parent_image->Precache(progress, max_size);
 }
 
 bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
@@ -4,20 +4,52 @@
 #include "cd_xa.h"
 #include "cd_image.h"
 
+#include "common/gsvector.h"
+
 #include <algorithm>
 #include <array>
+#include <cstring>
 
 namespace CDXA {
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_pos = {{0, 60, 115, 98}};
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_neg = {{0, 0, -52, -55}};
 
+static constexpr u32 WORDS_PER_BLOCK = 28;
+
+/// Extracts one block's nibbles from the interleaved words, and applies the shift. Equivalent to:
+///   static_cast<s16>(Truncate16(((word >> bit_offset) & 0x0F) << 12)) >> shift
+/// Only the low four bits are kept for 8-bit blocks too, which matches the decoder's existing behaviour.
+ALWAYS_INLINE_RELEASE static void ExtractXA_ADPCMBlockSamples(const u8* words_ptr, u32 bit_offset, u8 shift,
+                                                               s16* out)
+{
+#if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
+  // Move the nibble to the top of each word, then an arithmetic shift gives the sign-extended, shifted sample.
+  const GSVector4i mask = GSVector4i::broadcast32(0xF0000000u);
+  const s32 left_shift = static_cast<s32>(28 - bit_offset);
+  const s32 right_shift = 16 + shift;
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    const GSVector4i words = GSVector4i::load<false>(&words_ptr[word * sizeof(u32)]);
+    const GSVector4i samples = (words.sll32(left_shift) & mask).sra32(right_shift);
+    GSVector4i::storel(&out[word], samples.ps32(samples));
+  }
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    // NOTE: assumes LE
+    u32 word_data;
+    std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+    out[word] = static_cast<s16>(Truncate16(((word_data >> bit_offset) & 0x0F) << 12)) >> shift;
+  }
+#endif
+}
+
 template<bool IS_STEREO, bool IS_8BIT>
 ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
   // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
   // passes to decode the whole chunk.
   constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
-  constexpr u32 WORDS_PER_BLOCK = 28;
 
   const u8* headers_ptr = chunk_ptr + 4;
   const u8* words_ptr = chunk_ptr + 16;
@@ -34,15 +66,13 @@ ALWAYS_INLINE_RELEASE static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16*
       IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
     constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
 
-    for (u32 word = 0; word < 28; word++)
-    {
-      // NOTE: assumes LE
-      u32 word_data;
-      std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+    // extract nibbles from block, the filter has to be applied serially
+    std::array<s16, WORDS_PER_BLOCK> block_samples;
+    ExtractXA_ADPCMBlockSamples(words_ptr, block * (IS_8BIT ? 8 : 4), shift, block_samples.data());
 
-      // extract nibble from block
-      const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-      const s16 sample = static_cast<s16>(Truncate16(nibble << 12)) >> shift;
+    for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+    {
+      const s16 sample = block_samples[word];
 
       // mix in previous values
       s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
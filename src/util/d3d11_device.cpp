@@ -192,9 +192,12 @@ void D3D11Device::SetFeatures(FeatureMask disabled_features)
   m_features.memory_import = false;
   m_features.explicit_present = false;
   m_features.gpu_timing = true;
+  m_features.gpu_timing_regions = true;
   m_features.shader_cache = true;
   m_features.pipeline_cache = false;
   m_features.prefer_unused_textures = false;
+  m_features.threaded_shader_compile = true;
+  m_features.sparse_textures = false;
 }
 
 bool D3D11Device::CreateSwapChain()
@@ -672,6 +675,11 @@ void D3D11Device::SubmitPresent()
   Panic("Not supported by this API.");
 }
 
+void D3D11Device::FlushCommands()
+{
+  m_context->Flush();
+}
+
 GPUDevice::AdapterAndModeList D3D11Device::StaticGetAdapterAndModeList()
 {
   AdapterAndModeList ret;
@@ -707,17 +715,20 @@ GPUDevice::AdapterAndModeList D3D11Device::GetAdapterAndModeList()
 
 bool D3D11Device::CreateTimestampQueries()
 {
-  for (u32 i = 0; i < NUM_TIMESTAMP_QUERIES; i++)
+  const CD3D11_QUERY_DESC disjoint_desc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+  const CD3D11_QUERY_DESC timestamp_desc(D3D11_QUERY_TIMESTAMP);
+  for (TimestampQuery& query : m_timestamp_queries)
   {
-    for (u32 j = 0; j < 3; j++)
+    HRESULT hr = m_device->CreateQuery(&disjoint_desc, query.disjoint.ReleaseAndGetAddressOf());
+    for (ComPtr<ID3D11Query>& timestamp : query.timestamps)
     {
-      const CD3D11_QUERY_DESC qdesc((j == 0) ? D3D11_QUERY_TIMESTAMP_DISJOINT : D3D11_QUERY_TIMESTAMP);
-      const HRESULT hr = m_device->CreateQuery(&qdesc, m_timestamp_queries[i][j].ReleaseAndGetAddressOf());
-      if (FAILED(hr))
-      {
-        m_timestamp_queries = {};
-        return false;
-      }
+      if (SUCCEEDED(hr))
+        hr = m_device->CreateQuery(&timestamp_desc, timestamp.ReleaseAndGetAddressOf());
+    }
+    if (FAILED(hr))
+    {
+      m_timestamp_queries = {};
+      return false;
     }
   }
 
@@ -727,11 +738,11 @@ bool D3D11Device::CreateTimestampQueries()
 
 void D3D11Device::DestroyTimestampQueries()
 {
-  if (!m_timestamp_queries[0][0])
+  if (!m_timestamp_queries[0].disjoint)
     return;
 
   if (m_timestamp_query_started)
-    m_context->End(m_timestamp_queries[m_write_timestamp_query][1].Get());
+    m_context->End(m_timestamp_queries[m_write_timestamp_query].disjoint.Get());
 
   m_timestamp_queries = {};
   m_read_timestamp_query = 0;
@@ -744,9 +755,10 @@ void D3D11Device::PopTimestampQuery()
 {
   while (m_waiting_timestamp_queries > 0)
   {
+    TimestampQuery& query = m_timestamp_queries[m_read_timestamp_query];
     D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
-    const HRESULT disjoint_hr = m_context->GetData(m_timestamp_queries[m_read_timestamp_query][0].Get(), &disjoint,
-                                                   sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    const HRESULT disjoint_hr =
+      m_context->GetData(query.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH);
     if (disjoint_hr != S_OK)
       break;
 
@@ -760,26 +772,31 @@ void D3D11Device::PopTimestampQuery()
     }
     else
     {
-      u64 start = 0, end = 0;
-      const HRESULT start_hr = m_context->GetData(m_timestamp_queries[m_read_timestamp_query][1].Get(), &start,
-                                                  sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH);
-      const HRESULT end_hr = m_context->GetData(m_timestamp_queries[m_read_timestamp_query][2].Get(), &end, sizeof(end),
-                                                D3D11_ASYNC_GETDATA_DONOTFLUSH);
-      if (start_hr == S_OK && end_hr == S_OK)
+      const u32 num_timestamps = query.num_regions + 1;
+      std::array<u64, MAX_GPU_TIMING_REGION_CHANGES + 2> timestamps;
+      HRESULT hr = S_OK;
+      for (u32 i = 0; i < num_timestamps && hr == S_OK; i++)
       {
-        const float delta =
-          static_cast<float>(static_cast<double>(end - start) / (static_cast<double>(disjoint.Frequency) / 1000.0));
-        m_accumulated_gpu_time += delta;
-        m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
-        m_waiting_timestamp_queries--;
+        hr = m_context->GetData(query.timestamps[i].Get(), &timestamps[i], sizeof(timestamps[i]),
+                                D3D11_ASYNC_GETDATA_DONOTFLUSH);
       }
+      if (hr != S_OK)
+        break;
+
+      const double ms_per_tick = 1000.0 / static_cast<double>(disjoint.Frequency);
+      m_accumulated_gpu_time +=
+        static_cast<float>(static_cast<double>(timestamps[num_timestamps - 1] - timestamps[0]) * ms_per_tick);
+      AccumulateGPUTimingRegions(timestamps.data(), query.regions.data(), query.num_regions, ms_per_tick);
+      m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
+      m_waiting_timestamp_queries--;
     }
   }
 
   if (m_timestamp_query_started)
   {
-    m_context->End(m_timestamp_queries[m_write_timestamp_query][2].Get());
-    m_context->End(m_timestamp_queries[m_write_timestamp_query][0].Get());
+    TimestampQuery& query = m_timestamp_queries[m_write_timestamp_query];
+    m_context->End(query.timestamps[query.num_regions].Get());
+    m_context->End(query.disjoint.Get());
     m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_timestamp_query_started = false;
     m_waiting_timestamp_queries++;
@@ -788,14 +805,30 @@ void D3D11Device::PopTimestampQuery()
 
 void D3D11Device::KickTimestampQuery()
 {
-  if (m_timestamp_query_started || !m_timestamp_queries[0][0] || m_waiting_timestamp_queries == NUM_TIMESTAMP_QUERIES)
+  if (m_timestamp_query_started || !m_timestamp_queries[0].disjoint ||
+      m_waiting_timestamp_queries == NUM_TIMESTAMP_QUERIES)
+  {
     return;
+  }
 
-  m_context->Begin(m_timestamp_queries[m_write_timestamp_query][0].Get());
-  m_context->End(m_timestamp_queries[m_write_timestamp_query][1].Get());
+  TimestampQuery& query = m_timestamp_queries[m_write_timestamp_query];
+  m_context->Begin(query.disjoint.Get());
+  m_context->End(query.timestamps[0].Get());
+  query.regions[0] = m_gpu_timing_region;
+  query.num_regions = 1;
   m_timestamp_query_started = true;
 }
 
+void D3D11Device::WriteGPUTimingRegionChange()
+{
+  TimestampQuery& query = m_timestamp_queries[m_write_timestamp_query];
+  if (!m_timestamp_query_started || query.num_regions > MAX_GPU_TIMING_REGION_CHANGES)
+    return;
+
+  m_context->End(query.timestamps[query.num_regions].Get());
+  query.regions[query.num_regions++] = m_gpu_timing_region;
+}
+
 bool D3D11Device::SetGPUTimingEnabled(bool enabled)
 {
   if (m_gpu_timing_enabled == enabled)
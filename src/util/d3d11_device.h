@@ -71,6 +71,8 @@ public:
   std::unique_ptr<GPUShader> CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data) override;
   std::unique_ptr<GPUShader> CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
                                                     const char* entry_point, DynamicHeapArray<u8>* binary) override;
+  bool CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                             DynamicHeapArray<u8>* out_binary) override;
   std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config) override;
 
   void PushDebugGroup(const char* name) override;
@@ -104,6 +106,7 @@ public:
   bool BeginPresent(bool skip_present) override;
   void EndPresent(bool explicit_present) override;
   void SubmitPresent() override;
+  void FlushCommands() override;
 
   void UnbindPipeline(D3D11Pipeline* pl);
   void UnbindTexture(D3D11Texture* tex);
@@ -116,6 +119,8 @@ protected:
                     Error* error) override;
   void DestroyDevice() override;
 
+  void WriteGPUTimingRegionChange() override;
+
 private:
   using RasterizationStateMap = std::unordered_map<u8, ComPtr<ID3D11RasterizerState>>;
   using DepthStateMap = std::unordered_map<u8, ComPtr<ID3D11DepthStencilState>>;
@@ -196,7 +201,17 @@ private:
   std::array<ID3D11ShaderResourceView*, MAX_TEXTURE_SAMPLERS> m_current_textures = {};
   std::array<ID3D11SamplerState*, MAX_TEXTURE_SAMPLERS> m_current_samplers = {};
 
-  std::array<std::array<ComPtr<ID3D11Query>, 3>, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
+  struct TimestampQuery
+  {
+    ComPtr<ID3D11Query> disjoint;
+
+    // Start, one for each timing region change, end. Regions are those active after each timestamp.
+    std::array<ComPtr<ID3D11Query>, MAX_GPU_TIMING_REGION_CHANGES + 2> timestamps;
+    std::array<u8, MAX_GPU_TIMING_REGION_CHANGES + 1> regions;
+    u32 num_regions;
+  };
+
+  std::array<TimestampQuery, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
   u8 m_read_timestamp_query = 0;
   u8 m_write_timestamp_query = 0;
   u8 m_waiting_timestamp_queries = 0;
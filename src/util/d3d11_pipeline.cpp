@@ -108,6 +108,18 @@ std::unique_ptr<GPUShader> D3D11Device::CreateShaderFromSource(GPUShaderStage st
   return ret;
 }
 
+bool D3D11Device::CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                                        DynamicHeapArray<u8>* out_binary)
+{
+  std::optional<DynamicHeapArray<u8>> bytecode =
+    D3DCommon::CompileShader(m_device->GetFeatureLevel(), m_debug_device, stage, source, entry_point);
+  if (!bytecode.has_value())
+    return false;
+
+  *out_binary = std::move(bytecode.value());
+  return true;
+}
+
 D3D11Pipeline::D3D11Pipeline(ComPtr<ID3D11RasterizerState> rs, ComPtr<ID3D11DepthStencilState> ds,
                              ComPtr<ID3D11BlendState> bs, ComPtr<ID3D11InputLayout> il, ComPtr<ID3D11VertexShader> vs,
                              ComPtr<ID3D11GeometryShader> gs, ComPtr<ID3D11PixelShader> ps,
@@ -162,10 +162,14 @@ bool D3D11Texture::Update(u32 x, u32 y, u32 width, u32 height, const void* data,
   ID3D11DeviceContext1* context = D3D11Device::GetD3DContext();
   CommitClear(context);
 
-  GPUDevice::GetStatistics().buffer_streamed += height * pitch;
+  GPUDevice::GetStatistics().buffer_streamed += CalcUploadSize(height, pitch);
   GPUDevice::GetStatistics().num_uploads++;
 
-  context->UpdateSubresource(m_texture.Get(), srnum, &box, data, pitch, 0);
+  // Boxes for compressed formats have to be block-aligned, which the smallest mip levels aren't, so whole-level
+  // updates don't pass one.
+  const bool whole_level = (x == 0 && y == 0 && width == GetMipWidth(level) && height == GetMipHeight(level));
+  context->UpdateSubresource(m_texture.Get(), srnum, (IsCompressedFormat(m_format) && whole_level) ? nullptr : &box,
+                             data, pitch, 0);
   m_state = GPUTexture::State::Dirty;
   return true;
 }
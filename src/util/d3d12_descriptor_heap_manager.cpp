@@ -12,9 +12,9 @@ D3D12DescriptorHeapManager::D3D12DescriptorHeapManager() = default;
 D3D12DescriptorHeapManager::~D3D12DescriptorHeapManager() = default;
 
 bool D3D12DescriptorHeapManager::Create(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, u32 num_descriptors,
-                                        bool shader_visible)
+                                        bool shader_visible, u32 num_reserved /* = 0 */)
 {
-  D3D12_DESCRIPTOR_HEAP_DESC desc = {type, static_cast<UINT>(num_descriptors),
+  D3D12_DESCRIPTOR_HEAP_DESC desc = {type, static_cast<UINT>(num_descriptors + num_reserved),
                                      shader_visible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE :
                                                       D3D12_DESCRIPTOR_HEAP_FLAG_NONE, 0u};
 
@@ -61,6 +61,15 @@ void D3D12DescriptorHeapManager::Destroy()
 }
 
 bool D3D12DescriptorHeapManager::Allocate(D3D12DescriptorHandle* handle)
+{
+  if (TryAllocate(handle))
+    return true;
+
+  Panic("Out of fixed descriptors");
+  return false;
+}
+
+bool D3D12DescriptorHeapManager::TryAllocate(D3D12DescriptorHandle* handle)
 {
   // Start past the temporary slots, no point in searching those.
   for (u32 group = 0; group < m_free_slots.size(); group++)
@@ -77,6 +86,9 @@ bool D3D12DescriptorHeapManager::Allocate(D3D12DescriptorHandle* handle)
     }
 
     u32 index = group * BITSET_SIZE + bit;
+    if (index >= m_num_descriptors)
+      break;
+
     bs[bit] = false;
 
     handle->index = index;
@@ -85,7 +97,6 @@ bool D3D12DescriptorHeapManager::Allocate(D3D12DescriptorHandle* handle)
     return true;
   }
 
-  Panic("Out of fixed descriptors");
   return false;
 }
 
@@ -128,6 +139,28 @@ bool D3D12DescriptorAllocator::Create(ID3D12Device* device, D3D12_DESCRIPTOR_HEA
   return true;
 }
 
+bool D3D12DescriptorAllocator::Create(ID3D12Device* device, const D3D12DescriptorHeapManager& heap,
+                                      D3D12_DESCRIPTOR_HEAP_TYPE type, u32 first_reserved_index, u32 num_descriptors)
+{
+  ID3D12DescriptorHeap* const dh = heap.GetDescriptorHeap();
+  const D3D12_DESCRIPTOR_HEAP_DESC desc = dh->GetDesc();
+  if (desc.Type != type || !(desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) ||
+      (first_reserved_index + num_descriptors) > desc.NumDescriptors)
+  {
+    Log_ErrorPrintf("Descriptor range %u-%u is not valid for heap", first_reserved_index,
+                    first_reserved_index + num_descriptors);
+    return false;
+  }
+
+  m_descriptor_heap = dh;
+  m_num_descriptors = num_descriptors;
+  m_descriptor_increment_size = device->GetDescriptorHandleIncrementSize(type);
+  const u32 base_offset = first_reserved_index * m_descriptor_increment_size;
+  m_heap_base_cpu.ptr = dh->GetCPUDescriptorHandleForHeapStart().ptr + base_offset;
+  m_heap_base_gpu.ptr = dh->GetGPUDescriptorHandleForHeapStart().ptr + base_offset;
+  return true;
+}
+
 void D3D12DescriptorAllocator::Destroy()
 {
   m_descriptor_heap.Reset();
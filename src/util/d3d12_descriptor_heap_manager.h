@@ -55,10 +55,14 @@ public:
   ID3D12DescriptorHeap* GetDescriptorHeap() const { return m_descriptor_heap.Get(); }
   u32 GetDescriptorIncrementSize() const { return m_descriptor_increment_size; }
 
-  bool Create(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, u32 num_descriptors, bool shader_visible);
+  /// num_reserved descriptors are added to the end of the heap, and are not handed out by Allocate(). They can be
+  /// sub-allocated by per-frame D3D12DescriptorAllocators, so both share one shader-visible heap.
+  bool Create(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, u32 num_descriptors, bool shader_visible,
+              u32 num_reserved = 0);
   void Destroy();
 
   bool Allocate(D3D12DescriptorHandle* handle);
+  bool TryAllocate(D3D12DescriptorHandle* handle);
   void Free(D3D12DescriptorHandle* handle);
   void Free(u32 index);
 
@@ -86,6 +90,10 @@ public:
   ALWAYS_INLINE u32 GetDescriptorIncrementSize() const { return m_descriptor_increment_size; }
 
   bool Create(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, u32 num_descriptors);
+
+  /// Allocates from the reserved range of a shader-visible heap manager, starting at first_reserved_index.
+  bool Create(ID3D12Device* device, const D3D12DescriptorHeapManager& heap, D3D12_DESCRIPTOR_HEAP_TYPE type,
+              u32 first_reserved_index, u32 num_descriptors);
   void Destroy();
 
   bool Allocate(u32 num_handles, D3D12DescriptorHandle* out_base_handle);
@@ -38,6 +38,7 @@ enum : u32
   MAX_DESCRIPTOR_SETS_PER_FRAME = MAX_DRAW_CALLS_PER_FRAME,
 
   MAX_PERSISTENT_DESCRIPTORS = 2048,
+  MAX_PERSISTENT_SHADER_DESCRIPTORS = 2048,
   MAX_PERSISTENT_RTVS = 512,
   MAX_PERSISTENT_DSVS = 128,
   MAX_PERSISTENT_SAMPLERS = 512,
@@ -226,6 +227,17 @@ bool D3D12Device::CreateDevice(std::string_view adapter, bool threaded_presentat
     return false;
   }
 
+  // The copy queue is optional, uploads go through the direct queue without it.
+  const D3D12_COMMAND_QUEUE_DESC copy_queue_desc = {D3D12_COMMAND_LIST_TYPE_COPY, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL,
+                                                    D3D12_COMMAND_QUEUE_FLAG_NONE, 0u};
+  if (FAILED(hr = m_device->CreateCommandQueue(&copy_queue_desc, IID_PPV_ARGS(&m_copy_queue))) ||
+      FAILED(hr = m_device->CreateFence(m_copy_fence_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_copy_fence))))
+  {
+    Log_WarningPrintf("Failed to create copy queue: %08X", hr);
+    m_copy_queue.Reset();
+    m_copy_fence.Reset();
+  }
+
   SetFeatures(disabled_features);
 
   if (!CreateCommandLists() || !CreateDescriptorHeaps())
@@ -279,6 +291,8 @@ void D3D12Device::DestroyDevice()
   }
 
   m_allocator.Reset();
+  m_copy_fence.Reset();
+  m_copy_queue.Reset();
   m_command_queue.Reset();
   m_device.Reset();
   m_adapter.Reset();
@@ -351,6 +365,16 @@ bool D3D12Device::GetPipelineCacheData(DynamicHeapArray<u8>* data)
 
 bool D3D12Device::CreateCommandLists()
 {
+  // Only one shader-visible heap can be bound at once, so the per-frame descriptors come from the end of the heap
+  // which holds the persistent texture descriptors.
+  if (!m_shader_descriptor_heap_manager.Create(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                               MAX_PERSISTENT_SHADER_DESCRIPTORS, true,
+                                               MAX_DESCRIPTORS_PER_FRAME * NUM_COMMAND_LISTS))
+  {
+    Log_ErrorPrintf("Failed to create shader-visible descriptor heap");
+    return false;
+  }
+
   for (u32 i = 0; i < NUM_COMMAND_LISTS; i++)
   {
     CommandList& res = m_command_lists[i];
@@ -383,7 +407,9 @@ bool D3D12Device::CreateCommandLists()
       }
     }
 
-    if (!res.descriptor_allocator.Create(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+    if (!res.descriptor_allocator.Create(m_device.Get(), m_shader_descriptor_heap_manager,
+                                         D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                         MAX_PERSISTENT_SHADER_DESCRIPTORS + i * MAX_DESCRIPTORS_PER_FRAME,
                                          MAX_DESCRIPTORS_PER_FRAME))
     {
       Log_ErrorPrintf("Failed to create per frame descriptor allocator");
@@ -411,6 +437,8 @@ void D3D12Device::MoveToNextCommandList()
   WaitForFence(res.fence_counter);
   res.fence_counter = m_current_fence_value;
   res.init_list_used = false;
+  res.num_copy_lists_used = 0;
+  res.copy_fence_value = 0;
 
   // Begin command list.
   res.command_allocators[1]->Reset();
@@ -423,16 +451,20 @@ void D3D12Device::MoveToNextCommandList()
   {
     // readback timestamp from the last time this cmdlist was used.
     // we don't need to worry about disjoint in dx12, the frequency is reliable within a single cmdlist.
+    // timestamps are laid out as start, region changes, end.
+    const u32 num_timestamps = res.num_timing_regions + 1;
     const u32 offset = (m_current_command_list * (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST));
-    const D3D12_RANGE read_range = {offset, offset + (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST)};
+    const D3D12_RANGE read_range = {offset, offset + (sizeof(u64) * num_timestamps)};
     void* map;
     HRESULT hr = m_timestamp_query_buffer->Map(0, &read_range, &map);
     if (SUCCEEDED(hr))
     {
-      u64 timestamps[2];
-      std::memcpy(timestamps, static_cast<const u8*>(map) + offset, sizeof(timestamps));
-      m_accumulated_gpu_time +=
-        static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) / m_timestamp_frequency);
+      std::array<u64, NUM_TIMESTAMP_QUERIES_PER_CMDLIST> timestamps;
+      std::memcpy(timestamps.data(), static_cast<const u8*>(map) + offset, sizeof(u64) * num_timestamps);
+      m_accumulated_gpu_time += static_cast<float>(
+        static_cast<double>(timestamps[num_timestamps - 1] - timestamps[0]) / m_timestamp_frequency);
+      AccumulateGPUTimingRegions(timestamps.data(), res.timing_regions.data(), res.num_timing_regions,
+                                 1.0 / m_timestamp_frequency);
 
       const D3D12_RANGE write_range = {};
       m_timestamp_query_buffer->Unmap(0, &write_range);
@@ -444,6 +476,8 @@ void D3D12Device::MoveToNextCommandList()
   }
 
   res.has_timestamp_query = m_gpu_timing_enabled;
+  res.num_timing_regions = 1;
+  res.timing_regions[0] = m_gpu_timing_region;
   if (m_gpu_timing_enabled)
   {
     res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
@@ -469,7 +503,11 @@ void D3D12Device::DestroyCommandLists()
       resources.command_lists[i].Reset();
       resources.command_allocators[i].Reset();
     }
+    resources.copy_lists.clear();
+    resources.num_copy_lists_used = 0;
   }
+
+  m_shader_descriptor_heap_manager.Destroy();
 }
 
 bool D3D12Device::CreateDescriptorHeaps()
@@ -505,6 +543,8 @@ bool D3D12Device::CreateDescriptorHeaps()
 
 void D3D12Device::DestroyDescriptorHeaps()
 {
+  if (m_null_shader_srv_descriptor)
+    m_shader_descriptor_heap_manager.Free(&m_null_shader_srv_descriptor);
   if (m_null_srv_descriptor)
     m_descriptor_heap_manager.Free(&m_null_srv_descriptor);
   m_sampler_heap_manager.Destroy();
@@ -529,6 +569,74 @@ ID3D12GraphicsCommandList4* D3D12Device::GetInitCommandList()
   return res.command_lists[0].Get();
 }
 
+ID3D12GraphicsCommandList* D3D12Device::BeginCopyCommandList()
+{
+  DebugAssert(m_copy_queue);
+
+  CommandList& res = m_command_lists[m_current_command_list];
+  HRESULT hr;
+  if (res.num_copy_lists_used == res.copy_lists.size())
+  {
+    ComPtr<ID3D12CommandAllocator> allocator;
+    ComPtr<ID3D12GraphicsCommandList> cmdlist;
+    hr = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(allocator.GetAddressOf()));
+    if (FAILED(hr))
+    {
+      Log_ErrorPrintf("CreateCommandAllocator() for copy failed: %08X", hr);
+      return nullptr;
+    }
+
+    hr = m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, allocator.Get(), nullptr,
+                                     IID_PPV_ARGS(cmdlist.GetAddressOf()));
+    if (FAILED(hr))
+    {
+      Log_ErrorPrintf("CreateCommandList() for copy failed: %08X", hr);
+      return nullptr;
+    }
+
+    // Newly-created lists are open, and ready for recording.
+    res.copy_lists.emplace_back(std::move(allocator), std::move(cmdlist));
+    return res.copy_lists.back().second.Get();
+  }
+
+  // Safe to reset, the direct command list which waited on this copy has completed.
+  const auto& [allocator, cmdlist] = res.copy_lists[res.num_copy_lists_used];
+  if (FAILED(hr = allocator->Reset()) || FAILED(hr = cmdlist->Reset(allocator.Get(), nullptr)))
+  {
+    Log_ErrorPrintf("Resetting copy command list failed: %08X", hr);
+    return nullptr;
+  }
+
+  return cmdlist.Get();
+}
+
+bool D3D12Device::SubmitCopyCommandList()
+{
+  CommandList& res = m_command_lists[m_current_command_list];
+  ID3D12GraphicsCommandList* const cmdlist = res.copy_lists[res.num_copy_lists_used].second.Get();
+  res.num_copy_lists_used++;
+
+  HRESULT hr = cmdlist->Close();
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("Closing copy command list failed: %08X", hr);
+    return false;
+  }
+
+  ID3D12CommandList* const execute_list = cmdlist;
+  m_copy_queue->ExecuteCommandLists(1, &execute_list);
+
+  hr = m_copy_queue->Signal(m_copy_fence.Get(), ++m_copy_fence_value);
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("Signaling copy fence failed: %08X", hr);
+    return false;
+  }
+
+  res.copy_fence_value = m_copy_fence_value;
+  return true;
+}
+
 void D3D12Device::SubmitCommandList(bool wait_for_completion)
 {
   CommandList& res = m_command_lists[m_current_command_list];
@@ -538,10 +646,11 @@ void D3D12Device::SubmitCommandList(bool wait_for_completion)
   {
     // write the timestamp back at the end of the cmdlist
     res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
-                                   (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) + 1);
+                                   (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) +
+                                     res.num_timing_regions);
     res.command_lists[1]->ResolveQueryData(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
                                            m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST,
-                                           NUM_TIMESTAMP_QUERIES_PER_CMDLIST, m_timestamp_query_buffer.Get(),
+                                           res.num_timing_regions + 1, m_timestamp_query_buffer.Get(),
                                            m_current_command_list * (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST));
   }
 
@@ -564,6 +673,13 @@ void D3D12Device::SubmitCommandList(bool wait_for_completion)
     Panic("TODO cannot continue");
   }
 
+  // Uploads on the copy queue have to land before anything samples them.
+  if (res.copy_fence_value > 0)
+  {
+    hr = m_command_queue->Wait(m_copy_fence.Get(), res.copy_fence_value);
+    DebugAssertMsg(SUCCEEDED(hr), "Wait for copy fence");
+  }
+
   if (res.init_list_used)
   {
     const std::array<ID3D12CommandList*, 2> execute_lists{res.command_lists[0].Get(), res.command_lists[1].Get()};
@@ -636,6 +752,14 @@ void D3D12Device::WaitForGPUIdle()
     WaitForFence(m_command_lists[index].fence_counter);
     index = (index + 1) % NUM_COMMAND_LISTS;
   }
+
+  // Copies for the current command list haven't been waited on by the direct queue yet.
+  if (m_copy_fence && m_copy_fence->GetCompletedValue() < m_copy_fence_value)
+  {
+    HRESULT hr = m_copy_fence->SetEventOnCompletion(m_copy_fence_value, m_fence_event);
+    AssertMsg(SUCCEEDED(hr), "Set copy fence event on completion");
+    WaitForSingleObject(m_fence_event, INFINITE);
+  }
 }
 
 bool D3D12Device::CreateTimestampQuery()
@@ -649,6 +773,7 @@ bool D3D12Device::CreateTimestampQuery()
   {
     Log_ErrorPrintf("CreateQueryHeap() for timestamp failed with %08X", hr);
     m_features.gpu_timing = false;
+    m_features.gpu_timing_regions = false;
     return false;
   }
 
@@ -671,6 +796,7 @@ bool D3D12Device::CreateTimestampQuery()
   {
     Log_ErrorPrintf("CreateResource() for timestamp failed with %08X", hr);
     m_features.gpu_timing = false;
+    m_features.gpu_timing_regions = false;
     return false;
   }
 
@@ -680,6 +806,7 @@ bool D3D12Device::CreateTimestampQuery()
   {
     Log_ErrorPrintf("GetTimestampFrequency() failed: %08X", hr);
     m_features.gpu_timing = false;
+    m_features.gpu_timing_regions = false;
     return false;
   }
 
@@ -707,6 +834,17 @@ bool D3D12Device::SetGPUTimingEnabled(bool enabled)
   return (enabled == m_gpu_timing_enabled);
 }
 
+void D3D12Device::WriteGPUTimingRegionChange()
+{
+  CommandList& res = m_command_lists[m_current_command_list];
+  if (!res.has_timestamp_query || res.num_timing_regions > MAX_GPU_TIMING_REGION_CHANGES)
+    return;
+
+  res.command_lists[1]->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                                 (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) + res.num_timing_regions);
+  res.timing_regions[res.num_timing_regions++] = m_gpu_timing_region;
+}
+
 void D3D12Device::DeferObjectDestruction(ComPtr<ID3D12Object> resource)
 {
   DebugAssert(resource);
@@ -1146,6 +1284,14 @@ void D3D12Device::SubmitPresent()
     m_swap_chain->Present(0, 0);
 }
 
+void D3D12Device::FlushCommands()
+{
+  if (InRenderPass())
+    EndRenderPass();
+
+  SubmitCommandList(false);
+}
+
 #ifdef _DEBUG
 static UINT64 Palette(float phase, const std::array<float, 3>& a, const std::array<float, 3>& b,
                       const std::array<float, 3>& c, const std::array<float, 3>& d)
@@ -1224,9 +1370,12 @@ void D3D12Device::SetFeatures(FeatureMask disabled_features)
   m_features.memory_import = false;
   m_features.explicit_present = true;
   m_features.gpu_timing = true;
+  m_features.gpu_timing_regions = true;
   m_features.shader_cache = true;
   m_features.pipeline_cache = true;
   m_features.prefer_unused_textures = true;
+  m_features.threaded_shader_compile = true;
+  m_features.sparse_textures = false;
 
   BOOL allow_tearing_supported = false;
   HRESULT hr = m_dxgi_factory->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allow_tearing_supported,
@@ -2076,17 +2225,24 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
   {
     D3D12DescriptorAllocator& allocator = m_command_lists[m_current_command_list].descriptor_allocator;
     D3D12DescriptorHandle gpu_handle;
-    if (!allocator.Allocate(num_textures, &gpu_handle))
-      return false;
-
     if constexpr (num_textures == 1)
     {
-      m_device->CopyDescriptorsSimple(
-        1, gpu_handle, m_current_textures[0] ? m_current_textures[0]->GetSRVDescriptor() : m_null_srv_descriptor,
-        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+      // Single textures are bound straight from their persistent descriptor, only copy if the heap is full.
+      if (!GetPersistentShaderSRVDescriptor(m_current_textures[0], &gpu_handle))
+      {
+        if (!allocator.Allocate(1, &gpu_handle))
+          return false;
+
+        m_device->CopyDescriptorsSimple(
+          1, gpu_handle, m_current_textures[0] ? m_current_textures[0]->GetSRVDescriptor() : m_null_srv_descriptor,
+          D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+      }
     }
     else
     {
+      if (!allocator.Allocate(num_textures, &gpu_handle))
+        return false;
+
       D3D12_CPU_DESCRIPTOR_HANDLE src_handles[MAX_TEXTURE_SAMPLERS];
       UINT src_sizes[MAX_TEXTURE_SAMPLERS];
       for (u32 i = 0; i < num_textures; i++)
@@ -2135,6 +2291,22 @@ bool D3D12Device::UpdateParametersForLayout(u32 dirty)
   return true;
 }
 
+bool D3D12Device::GetPersistentShaderSRVDescriptor(D3D12Texture* texture, D3D12DescriptorHandle* handle)
+{
+  D3D12DescriptorHandle& dh = texture ? texture->m_shader_srv_descriptor : m_null_shader_srv_descriptor;
+  if (!dh)
+  {
+    if (!m_shader_descriptor_heap_manager.TryAllocate(&dh))
+      return false;
+
+    m_device->CopyDescriptorsSimple(1, dh, texture ? texture->GetSRVDescriptor() : m_null_srv_descriptor,
+                                    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+  }
+
+  *handle = dh;
+  return true;
+}
+
 bool D3D12Device::UpdateRootParameters(u32 dirty)
 {
   switch (m_current_pipeline_layout)
@@ -49,8 +49,8 @@ public:
   {
     NUM_COMMAND_LISTS = 3,
 
-    /// Start/End timestamp queries.
-    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2,
+    /// Start/End timestamp queries, and one for each timing region change.
+    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2 + MAX_GPU_TIMING_REGION_CHANGES,
   };
 
 public:
@@ -93,6 +93,8 @@ public:
   std::unique_ptr<GPUShader> CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data) override;
   std::unique_ptr<GPUShader> CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
                                                     const char* entry_point, DynamicHeapArray<u8>* out_binary) override;
+  bool CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                             DynamicHeapArray<u8>* out_binary) override;
   std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config) override;
 
   void PushDebugGroup(const char* name) override;
@@ -124,6 +126,7 @@ public:
   bool BeginPresent(bool skip_present) override;
   void EndPresent(bool explicit_present) override;
   void SubmitPresent() override;
+  void FlushCommands() override;
 
   // Global state accessors
   ALWAYS_INLINE static D3D12Device& GetInstance() { return *static_cast<D3D12Device*>(g_gpu_device.get()); }
@@ -136,6 +139,7 @@ public:
 
   // Descriptor manager access.
   D3D12DescriptorHeapManager& GetDescriptorHeapManager() { return m_descriptor_heap_manager; }
+  D3D12DescriptorHeapManager& GetShaderDescriptorHeapManager() { return m_shader_descriptor_heap_manager; }
   D3D12DescriptorHeapManager& GetRTVHeapManager() { return m_rtv_heap_manager; }
   D3D12DescriptorHeapManager& GetDSVHeapManager() { return m_dsv_heap_manager; }
   D3D12DescriptorHeapManager& GetSamplerHeapManager() { return m_sampler_heap_manager; }
@@ -150,6 +154,18 @@ public:
   ALWAYS_INLINE D3D12StreamBuffer& GetTextureUploadBuffer() { return m_texture_upload_buffer; }
   ID3D12GraphicsCommandList4* GetInitCommandList();
 
+  /// Uploads at least this large into textures the direct queue hasn't touched yet go through the copy queue.
+  static constexpr u32 MIN_COPY_QUEUE_UPLOAD_SIZE = 64 * 1024;
+
+  ALWAYS_INLINE bool HasCopyQueue() const { return static_cast<bool>(m_copy_queue); }
+
+  /// Begins a command list for the copy queue. Only valid if HasCopyQueue() is true.
+  ID3D12GraphicsCommandList* BeginCopyCommandList();
+
+  /// Executes the command list from BeginCopyCommandList() immediately. The next direct command list waits for it to
+  /// complete, and resources used by it are released along with that command list's.
+  bool SubmitCopyCommandList();
+
   // Root signature access.
   ComPtr<ID3DBlob> SerializeRootSignature(const D3D12_ROOT_SIGNATURE_DESC* desc);
   ComPtr<ID3D12RootSignature> CreateRootSignature(const D3D12_ROOT_SIGNATURE_DESC* desc);
@@ -188,6 +204,8 @@ protected:
   bool ReadPipelineCache(const std::string& filename) override;
   bool GetPipelineCacheData(DynamicHeapArray<u8>* data) override;
 
+  void WriteGPUTimingRegionChange() override;
+
 private:
   enum DIRTY_FLAG : u32
   {
@@ -212,6 +230,15 @@ private:
     bool init_list_used = false;
     bool needs_fence_wait = false;
     bool has_timestamp_query = false;
+
+    // Region active after each timestamp, the first being the start of the command list.
+    u32 num_timing_regions = 0;
+    std::array<u8, MAX_GPU_TIMING_REGION_CHANGES + 1> timing_regions;
+
+    // Copy queue uploads executed while this command list was current, and the copy fence value to wait for.
+    std::vector<std::pair<ComPtr<ID3D12CommandAllocator>, ComPtr<ID3D12GraphicsCommandList>>> copy_lists;
+    u32 num_copy_lists_used = 0;
+    u64 copy_fence_value = 0;
   };
 
   using SamplerMap = std::unordered_map<u64, D3D12DescriptorHandle>;
@@ -265,6 +292,7 @@ private:
   template<GPUPipeline::Layout layout>
   bool UpdateParametersForLayout(u32 dirty);
   bool UpdateRootParameters(u32 dirty);
+  bool GetPersistentShaderSRVDescriptor(D3D12Texture* texture, D3D12DescriptorHandle* handle);
 
   // Ends a render pass if we're currently in one.
   // When Bind() is next called, the pass will be restarted.
@@ -283,6 +311,10 @@ private:
   u64 m_current_fence_value = 0;
   u64 m_completed_fence_value = 0;
 
+  ComPtr<ID3D12CommandQueue> m_copy_queue;
+  ComPtr<ID3D12Fence> m_copy_fence;
+  u64 m_copy_fence_value = 0;
+
   std::array<CommandList, NUM_COMMAND_LISTS> m_command_lists;
   u32 m_current_command_list = NUM_COMMAND_LISTS - 1;
   D3D_FEATURE_LEVEL m_feature_level = D3D_FEATURE_LEVEL_11_0;
@@ -296,10 +328,12 @@ private:
   bool m_is_exclusive_fullscreen = false;
 
   D3D12DescriptorHeapManager m_descriptor_heap_manager;
+  D3D12DescriptorHeapManager m_shader_descriptor_heap_manager;
   D3D12DescriptorHeapManager m_rtv_heap_manager;
   D3D12DescriptorHeapManager m_dsv_heap_manager;
   D3D12DescriptorHeapManager m_sampler_heap_manager;
   D3D12DescriptorHandle m_null_srv_descriptor;
+  D3D12DescriptorHandle m_null_shader_srv_descriptor;
   D3D12DescriptorHandle m_point_sampler;
 
   ComPtr<ID3D12QueryHeap> m_timestamp_query_heap;
@@ -48,6 +48,18 @@ std::unique_ptr<GPUShader> D3D12Device::CreateShaderFromSource(GPUShaderStage st
   return ret;
 }
 
+bool D3D12Device::CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                                        DynamicHeapArray<u8>* out_binary)
+{
+  std::optional<DynamicHeapArray<u8>> bytecode =
+    D3DCommon::CompileShader(m_feature_level, m_debug_device, stage, source, entry_point);
+  if (!bytecode.has_value())
+    return false;
+
+  *out_binary = std::move(bytecode.value());
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 D3D12Pipeline::D3D12Pipeline(Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline, Layout layout,
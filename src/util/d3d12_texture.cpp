@@ -67,8 +67,9 @@ std::unique_ptr<GPUTexture> D3D12Device::CreateTexture(u32 width, u32 height, u3
     case GPUTexture::Type::Texture:
     case GPUTexture::Type::DynamicTexture:
     {
+      // Left in COMMON until the first upload, so it can be written by the copy queue.
       desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-      state = D3D12_RESOURCE_STATE_COPY_DEST;
+      state = D3D12_RESOURCE_STATE_COMMON;
     }
     break;
 
@@ -277,6 +278,8 @@ void D3D12Texture::Destroy(bool defer)
   if (defer)
   {
     dev.DeferDescriptorDestruction(dev.GetDescriptorHeapManager(), &m_srv_descriptor);
+    if (m_shader_srv_descriptor)
+      dev.DeferDescriptorDestruction(dev.GetShaderDescriptorHeapManager(), &m_shader_srv_descriptor);
 
     switch (m_write_descriptor_type)
     {
@@ -299,6 +302,7 @@ void D3D12Texture::Destroy(bool defer)
   else
   {
     dev.GetDescriptorHeapManager().Free(&m_srv_descriptor);
+    dev.GetShaderDescriptorHeapManager().Free(&m_shader_srv_descriptor);
 
     switch (m_write_descriptor_type)
     {
@@ -340,13 +344,13 @@ ID3D12GraphicsCommandList4* D3D12Texture::GetCommandBufferForUpdate()
 void D3D12Texture::CopyTextureDataForUpload(void* dst, const void* src, u32 width, u32 height, u32 pitch,
                                             u32 upload_pitch) const
 {
-  StringUtil::StrideMemCpy(dst, upload_pitch, src, pitch, GetPixelSize() * width, height);
+  StringUtil::StrideMemCpy(dst, upload_pitch, src, pitch, CalcUploadPitch(width), CalcUploadRows(height));
 }
 
 ID3D12Resource* D3D12Texture::AllocateUploadStagingBuffer(const void* data, u32 pitch, u32 upload_pitch, u32 width,
                                                           u32 height) const
 {
-  const u32 size = upload_pitch * height;
+  const u32 size = CalcUploadSize(height, upload_pitch);
   ComPtr<ID3D12Resource> resource;
   ComPtr<D3D12MA::Allocation> allocation;
 
@@ -392,26 +396,60 @@ bool D3D12Texture::Update(u32 x, u32 y, u32 width, u32 height, const void* data,
   D3D12Device& dev = D3D12Device::GetInstance();
   D3D12StreamBuffer& sbuffer = dev.GetTextureUploadBuffer();
 
-  const u32 upload_pitch = Common::AlignUpPow2<u32>(pitch, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
-  const u32 required_size = height * upload_pitch;
+  const u32 upload_pitch = Common::AlignUpPow2<u32>(CalcUploadPitch(width), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+  const u32 required_size = CalcUploadSize(height, upload_pitch);
+
+  // Footprints of compressed formats have to cover whole blocks, even for mip levels smaller than a block.
+  const u32 block_size = GetCompressedBlockSize();
+  const u32 footprint_width = Common::AlignUpPow2(width, block_size);
+  const u32 footprint_height = Common::AlignUpPow2(height, block_size);
 
   D3D12_TEXTURE_COPY_LOCATION srcloc;
   srcloc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-  srcloc.PlacedFootprint.Footprint.Width = width;
-  srcloc.PlacedFootprint.Footprint.Height = height;
+  srcloc.PlacedFootprint.Footprint.Width = footprint_width;
+  srcloc.PlacedFootprint.Footprint.Height = footprint_height;
   srcloc.PlacedFootprint.Footprint.Depth = 1;
   srcloc.PlacedFootprint.Footprint.Format = m_dxgi_format;
   srcloc.PlacedFootprint.Footprint.RowPitch = upload_pitch;
 
+  D3D12_TEXTURE_COPY_LOCATION dstloc;
+  dstloc.pResource = m_resource.Get();
+  dstloc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+  dstloc.SubresourceIndex = CalculateSubresource(layer, level);
+
+  const D3D12_BOX srcbox{0u, 0u, 0u, footprint_width, footprint_height, 1u};
+
+  // Textures which haven't been touched yet can't be in use by the direct queue, so bulk uploads into them (e.g.
+  // replacement textures) can run on the copy queue without serializing with rendering. The texture decays back to
+  // COMMON afterwards, and the direct queue waits on the copy fence before its next command list.
+  const bool use_copy_queue = (m_resource_state == D3D12_RESOURCE_STATE_COMMON &&
+                               (m_type == Type::Texture || m_type == Type::DynamicTexture) &&
+                               required_size >= D3D12Device::MIN_COPY_QUEUE_UPLOAD_SIZE && dev.HasCopyQueue());
+
   // If the texture is larger than half our streaming buffer size, use a separate buffer.
   // Otherwise allocation will either fail, or require lots of cmdbuffer submissions.
-  if (required_size > (sbuffer.GetSize() / 2))
+  if (use_copy_queue || required_size > (sbuffer.GetSize() / 2))
   {
     srcloc.pResource = AllocateUploadStagingBuffer(data, pitch, upload_pitch, width, height);
     if (!srcloc.pResource)
       return false;
 
     srcloc.PlacedFootprint.Offset = 0;
+
+    // If the copy queue fails, fall back to the direct queue with the same staging buffer.
+    if (use_copy_queue)
+    {
+      if (ID3D12GraphicsCommandList* const copy_cmdlist = dev.BeginCopyCommandList())
+      {
+        copy_cmdlist->CopyTextureRegion(&dstloc, x, y, 0, &srcloc, &srcbox);
+        if (dev.SubmitCopyCommandList())
+        {
+          GPUDevice::GetStatistics().buffer_streamed += required_size;
+          GPUDevice::GetStatistics().num_uploads++;
+          return true;
+        }
+      }
+    }
   }
   else
   {
@@ -452,12 +490,6 @@ bool D3D12Texture::Update(u32 x, u32 y, u32 width, u32 height, const void* data,
   else if (m_resource_state != D3D12_RESOURCE_STATE_COPY_DEST)
     TransitionSubresourceToState(cmdlist, layer, level, m_resource_state, D3D12_RESOURCE_STATE_COPY_DEST);
 
-  D3D12_TEXTURE_COPY_LOCATION dstloc;
-  dstloc.pResource = m_resource.Get();
-  dstloc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-  dstloc.SubresourceIndex = layer;
-
-  const D3D12_BOX srcbox{0u, 0u, 0u, width, height, 1u};
   cmdlist->CopyTextureRegion(&dstloc, x, y, 0, &srcloc, &srcbox);
 
   if (m_resource_state != D3D12_RESOURCE_STATE_COPY_DEST)
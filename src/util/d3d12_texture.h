@@ -90,6 +90,9 @@ private:
   D3D12DescriptorHandle m_write_descriptor = {};
   D3D12DescriptorHandle m_uav_descriptor = {};
 
+  // Copy of the SRV in the shader-visible heap, created when the texture is first bound on its own.
+  D3D12DescriptorHandle m_shader_srv_descriptor = {};
+
   DXGI_FORMAT m_dxgi_format = DXGI_FORMAT_UNKNOWN;
   D3D12_RESOURCE_STATES m_resource_state = D3D12_RESOURCE_STATE_COMMON;
   WriteDescriptorType m_write_descriptor_type = WriteDescriptorType::None;
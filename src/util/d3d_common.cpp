@@ -468,6 +468,10 @@ static constexpr std::array<D3DCommon::DXGIFormatMapping, static_cast<int>(GPUTe
   {DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_UNKNOWN   }, // RGBA16F
   {DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_UNKNOWN   }, // RGBA32F
   {DXGI_FORMAT_R10G10B10A2_UNORM,  DXGI_FORMAT_R10G10B10A2_UNORM,  DXGI_FORMAT_R10G10B10A2_UNORM,  DXGI_FORMAT_UNKNOWN   }, // RGB10A2
+  {DXGI_FORMAT_BC1_UNORM,          DXGI_FORMAT_BC1_UNORM,          DXGI_FORMAT_UNKNOWN,            DXGI_FORMAT_UNKNOWN   }, // BC1
+  {DXGI_FORMAT_BC2_UNORM,          DXGI_FORMAT_BC2_UNORM,          DXGI_FORMAT_UNKNOWN,            DXGI_FORMAT_UNKNOWN   }, // BC2
+  {DXGI_FORMAT_BC3_UNORM,          DXGI_FORMAT_BC3_UNORM,          DXGI_FORMAT_UNKNOWN,            DXGI_FORMAT_UNKNOWN   }, // BC3
+  {DXGI_FORMAT_BC7_UNORM,          DXGI_FORMAT_BC7_UNORM,          DXGI_FORMAT_UNKNOWN,            DXGI_FORMAT_UNKNOWN   }, // BC7
     // clang-format on
   }};
 
@@ -5,6 +5,7 @@
 #include "core/host.h"     // TODO: Remove, needed for getting fullscreen mode.
 #include "core/settings.h" // TODO: Remove, needed for dump directory.
 #include "gpu_framebuffer_manager.h"
+#include "null_device.h"
 #include "shadergen.h"
 
 #include "common/assert.h"
@@ -12,14 +13,19 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "common/timer.h"
 
 #include "fmt/format.h"
 #include "imgui.h"
 #include "xxhash.h"
 
+#include <atomic>
+#include <thread>
+
 Log_SetChannel(GPUDevice);
 
 #ifdef _WIN32
@@ -43,7 +49,16 @@ Log_SetChannel(GPUDevice);
 
 std::unique_ptr<GPUDevice> g_gpu_device;
 
+// Pipeline caches are written at most this often while running, as well as at shutdown.
+static constexpr double PIPELINE_CACHE_SAVE_INTERVAL = 5.0 * 60.0;
+
 static std::string s_pipeline_cache_path;
+
+// State of the file when we last read or wrote it, so writes from other instances can be merged.
+static s64 s_pipeline_cache_file_size = 0;
+static std::time_t s_pipeline_cache_file_time = 0;
+static Common::Timer::Value s_pipeline_cache_save_time = 0;
+static std::thread s_pipeline_cache_save_thread;
 size_t GPUDevice::s_total_vram_usage = 0;
 GPUDevice::Statistics GPUDevice::s_stats = {};
 
@@ -360,9 +375,18 @@ void GPUDevice::OpenShaderCache(std::string_view base_path, u32 version)
     const std::string basename = GetShaderCacheBaseName("pipelines");
     const std::string filename = Path::Combine(base_path, TinyString::from_format("{}.bin", basename));
     if (ReadPipelineCache(filename))
+    {
+      FILESYSTEM_STAT_DATA sd;
+      const bool exists = FileSystem::StatFile(filename.c_str(), &sd);
+      s_pipeline_cache_file_size = exists ? sd.Size : 0;
+      s_pipeline_cache_file_time = exists ? sd.ModificationTime : 0;
+      s_pipeline_cache_save_time = Common::Timer::GetCurrentValue();
       s_pipeline_cache_path = std::move(filename);
+    }
     else
+    {
       Log_WarningPrintf("Failed to read pipeline cache.");
+    }
   }
 }
 
@@ -372,25 +396,77 @@ void GPUDevice::CloseShaderCache()
 
   if (!s_pipeline_cache_path.empty())
   {
-    DynamicHeapArray<u8> data;
-    if (GetPipelineCacheData(&data))
+    WritePipelineCache(false);
+    s_pipeline_cache_path = {};
+  }
+}
+
+void GPUDevice::UpdatePipelineCache()
+{
+  if (s_pipeline_cache_path.empty())
+    return;
+
+  const Common::Timer::Value now = Common::Timer::GetCurrentValue();
+  if (Common::Timer::ConvertValueToSeconds(now - s_pipeline_cache_save_time) < PIPELINE_CACHE_SAVE_INTERVAL)
+    return;
+
+  s_pipeline_cache_save_time = now;
+  WritePipelineCache(true);
+}
+
+void GPUDevice::WritePipelineCache(bool background)
+{
+  // The file state is updated by the previous write.
+  if (s_pipeline_cache_save_thread.joinable())
+    s_pipeline_cache_save_thread.join();
+
+  // If another instance has written the cache since we last touched it, pull its pipelines in so they aren't lost.
+  FILESYSTEM_STAT_DATA sd;
+  if (FileSystem::StatFile(s_pipeline_cache_path.c_str(), &sd) &&
+      (sd.Size != s_pipeline_cache_file_size || sd.ModificationTime != s_pipeline_cache_file_time))
+  {
+    std::optional<std::vector<u8>> disk_data = FileSystem::ReadBinaryFile(s_pipeline_cache_path.c_str());
+    if (disk_data.has_value() && MergePipelineCache(disk_data.value()))
+      Log_InfoPrintf("Merged %zu bytes of pipeline cache written by another instance", disk_data->size());
+  }
+
+  DynamicHeapArray<u8> data;
+  if (!GetPipelineCacheData(&data))
+    return;
+
+  // Save disk writes if it hasn't changed, think of the poor SSDs.
+  if (static_cast<s64>(data.size()) == s_pipeline_cache_file_size)
+  {
+    Log_DevPrintf("Skipping updating pipeline cache '%s' due to no changes.", s_pipeline_cache_path.c_str());
+    return;
+  }
+
+  // Written to a temporary file and renamed over the old one, so a crash or another instance can't see a partial file.
+  const auto write = [](std::string path, DynamicHeapArray<u8> data) {
+    Log_InfoPrintf("Writing %zu bytes to '%s'", data.size(), path.c_str());
+
+    Error error;
+    const std::string temp_path = path + ".tmp";
+    if (!FileSystem::WriteBinaryFile(temp_path.c_str(), data.data(), data.size()) ||
+        !FileSystem::RenamePath(temp_path.c_str(), path.c_str(), &error))
     {
-      // Save disk writes if it hasn't changed, think of the poor SSDs.
-      FILESYSTEM_STAT_DATA sd;
-      if (!FileSystem::StatFile(s_pipeline_cache_path.c_str(), &sd) || sd.Size != static_cast<s64>(data.size()))
-      {
-        Log_InfoPrintf("Writing %zu bytes to '%s'", data.size(), s_pipeline_cache_path.c_str());
-        if (!FileSystem::WriteBinaryFile(s_pipeline_cache_path.c_str(), data.data(), data.size()))
-          Log_ErrorPrintf("Failed to write pipeline cache to '%s'", s_pipeline_cache_path.c_str());
-      }
-      else
-      {
-        Log_InfoPrintf("Skipping updating pipeline cache '%s' due to no changes.", s_pipeline_cache_path.c_str());
-      }
+      Log_ErrorPrintf("Failed to write pipeline cache to '%s': %s", path.c_str(), error.GetDescription().c_str());
+      FileSystem::DeleteFile(temp_path.c_str());
+      return;
     }
 
-    s_pipeline_cache_path = {};
-  }
+    FILESYSTEM_STAT_DATA new_sd;
+    if (FileSystem::StatFile(path.c_str(), &new_sd))
+    {
+      s_pipeline_cache_file_size = new_sd.Size;
+      s_pipeline_cache_file_time = new_sd.ModificationTime;
+    }
+  };
+
+  if (background)
+    s_pipeline_cache_save_thread = std::thread(write, s_pipeline_cache_path, std::move(data));
+  else
+    write(s_pipeline_cache_path, std::move(data));
 }
 
 std::string GPUDevice::GetShaderCacheBaseName(std::string_view type) const
@@ -447,6 +523,11 @@ bool GPUDevice::GetPipelineCacheData(DynamicHeapArray<u8>* data)
   return false;
 }
 
+bool GPUDevice::MergePipelineCache(std::span<const u8> data)
+{
+  return false;
+}
+
 bool GPUDevice::AcquireWindow(bool recreate_window)
 {
   std::optional<WindowInfo> wi = Host::AcquireRenderWindow(recreate_window);
@@ -595,6 +676,11 @@ void GPUDevice::SetVSyncEnabled(bool enabled)
   m_vsync_enabled = enabled;
 }
 
+bool GPUDevice::IsPresentPending() const
+{
+  return false;
+}
+
 void GPUDevice::UploadVertexBuffer(const void* vertices, u32 vertex_size, u32 vertex_count, u32* base_vertex)
 {
   void* map;
@@ -682,6 +768,134 @@ std::unique_ptr<GPUShader> GPUDevice::CreateShader(GPUShaderStage stage, std::st
   return shader;
 }
 
+bool GPUDevice::CreateShaders(std::span<ShaderCompileRequest> requests,
+                              const ShaderCompileProgressCallback& progress_callback)
+{
+  // Anything in the cache is cheap to create, so do those first.
+  std::vector<std::pair<u32, GPUShaderCache::CacheIndexKey>> misses;
+  u32 completed = 0;
+  for (u32 i = 0; i < static_cast<u32>(requests.size()); i++)
+  {
+    ShaderCompileRequest& req = requests[i];
+    GPUShaderCache::CacheIndexKey key = {};
+    if (m_shader_cache.IsOpen())
+    {
+      key = m_shader_cache.GetCacheKey(req.stage, req.source, req.entry_point);
+      DynamicHeapArray<u8> binary;
+      if (m_shader_cache.Lookup(key, &binary))
+      {
+        if ((req.shader = CreateShaderFromBinary(req.stage, binary)))
+        {
+          completed++;
+          continue;
+        }
+
+        Log_ErrorPrintf("Failed to create shader from binary (driver changed?). Clearing cache.");
+        m_shader_cache.Clear();
+      }
+    }
+
+    misses.emplace_back(i, key);
+  }
+
+  progress_callback(completed);
+  if (misses.empty())
+    return true;
+
+  if (!m_features.threaded_shader_compile || misses.size() == 1)
+  {
+    for (const auto& [index, key] : misses)
+    {
+      ShaderCompileRequest& req = requests[index];
+      if (!(req.shader = CreateShader(req.stage, req.source, req.entry_point)))
+        return false;
+
+      progress_callback(++completed);
+    }
+
+    return true;
+  }
+
+  // The first shader is compiled on this thread before starting the workers, so any lazy compiler initialization
+  // happens single-threaded.
+  const u32 num_misses = static_cast<u32>(misses.size());
+  std::vector<DynamicHeapArray<u8>> binaries(num_misses);
+  std::unique_ptr<bool[]> results = std::make_unique<bool[]>(num_misses);
+  std::atomic<u32> next_index{1};
+  std::atomic<u32> num_compiled{1};
+  const auto compile = [this, &requests, &misses, &binaries, &results](u32 i) {
+    const ShaderCompileRequest& req = requests[misses[i].first];
+    results[i] = CompileShaderToBinary(req.stage, req.source, req.entry_point, &binaries[i]);
+  };
+  compile(0);
+
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  const u32 num_workers = std::min(pool.GetWorkerCount(), num_misses - 1);
+  Log_DevFmt("Compiling {} shaders with {} worker threads", num_misses, num_workers);
+
+  std::atomic<u32> num_workers_done{0};
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    pool.Enqueue(
+      [&compile, &next_index, &num_compiled, &num_workers_done, num_misses]() {
+        u32 index;
+        while ((index = next_index.fetch_add(1, std::memory_order_relaxed)) < num_misses)
+        {
+          compile(index);
+          num_compiled.fetch_add(1, std::memory_order_release);
+        }
+        num_workers_done.fetch_add(1, std::memory_order_release);
+      },
+      Threading::ThreadPool::Priority::High);
+  }
+
+  // Keep the progress display going while waiting.
+  u32 last_reported = 0;
+  for (;;)
+  {
+    const u32 count = num_compiled.load(std::memory_order_acquire);
+    if (count != last_reported)
+    {
+      last_reported = count;
+      progress_callback(completed + count);
+    }
+    if (count == num_misses)
+      break;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Workers which didn't get a shader still look at our locals on the way out.
+  while (num_workers_done.load(std::memory_order_acquire) != num_workers)
+    std::this_thread::yield();
+
+  bool result = true;
+  for (u32 i = 0; i < num_misses; i++)
+  {
+    ShaderCompileRequest& req = requests[misses[i].first];
+    if (!results[i] || !(req.shader = CreateShaderFromBinary(req.stage, binaries[i])))
+    {
+      result = false;
+      continue;
+    }
+
+    if (m_shader_cache.IsOpen() && !binaries[i].empty() &&
+        !m_shader_cache.Insert(misses[i].second, binaries[i].data(), static_cast<u32>(binaries[i].size())))
+    {
+      m_shader_cache.Close();
+    }
+  }
+
+  return result;
+}
+
+bool GPUDevice::CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                                      DynamicHeapArray<u8>* out_binary)
+{
+  Log_ErrorPrint("Shader compilation to binary is not supported by this backend.");
+  return false;
+}
+
 bool GPUDevice::GetRequestedExclusiveFullscreenMode(u32* width, u32* height, float* refresh_rate)
 {
   const std::string mode = Host::GetBaseStringSettingValue("GPU", "FullscreenMode", "");
@@ -890,9 +1104,16 @@ GPUDevice::FetchAutoRecycleTexture(u32 width, u32 height, u32 layers, u32 levels
   return std::unique_ptr<GPUTexture, PooledTextureDeleter>(ret.release());
 }
 
+std::unique_ptr<GPUTexture> GPUDevice::CreateSparseTexture(u32 width, u32 height, GPUTexture::Type type,
+                                                           GPUTexture::Format format)
+{
+  return {};
+}
+
 void GPUDevice::RecycleTexture(std::unique_ptr<GPUTexture> texture)
 {
-  if (!texture)
+  // Committed regions aren't part of the pool key, so sparse textures can't be handed out again.
+  if (!texture || texture->IsSparse())
     return;
 
   const TexturePoolKey key = {static_cast<u16>(texture->GetWidth()),
@@ -932,6 +1153,19 @@ void GPUDevice::TrimTexturePool()
   Log_DebugFmt("Texture Pool Size: {} Target Pool Size: {} VRAM: {:.2f} MB", m_texture_pool.size(),
                m_target_pool.size(), s_total_vram_usage / 1048756.0);
 
+  m_pool_vram_usage = 0;
+  for (const TexturePool* pool : {&m_texture_pool, &m_target_pool})
+  {
+    for (const TexturePoolEntry& entry : *pool)
+      m_pool_vram_usage += entry.texture->GetVRAMUsage();
+  }
+  MemoryAccounting::SetGPUBytes(MemoryAccounting::Category::GPUTexturePool, m_pool_vram_usage);
+  // VRAM snapshots are owned by the system, and report themselves.
+  const size_t snapshot_vram_usage = std::min(MemoryAccounting::GetGPUBytes(MemoryAccounting::Category::VRAMSnapshots),
+                                              s_total_vram_usage - m_pool_vram_usage);
+  MemoryAccounting::SetGPUBytes(MemoryAccounting::Category::GPUTextures,
+                                s_total_vram_usage - m_pool_vram_usage - snapshot_vram_usage);
+
   if (m_texture_pool.empty() && m_target_pool.empty())
     return;
 
@@ -1022,6 +1256,10 @@ bool GPUDevice::ResizeTexture(std::unique_ptr<GPUTexture>* tex, u32 new_width, u
 
 bool GPUDevice::ShouldSkipDisplayingFrame()
 {
+  // Rather than waiting for the previous frame to be presented, drop this one, and let the throttler pace emulation.
+  if (m_non_blocking_present && IsPresentPending())
+    return true;
+
   if (m_display_frame_interval == 0.0f)
     return false;
 
@@ -1073,6 +1311,29 @@ float GPUDevice::GetAndResetAccumulatedGPUTime()
   return 0.0f;
 }
 
+GPUDevice::GPUTimingRegionTimes GPUDevice::GetAndResetAccumulatedGPURegionTimes()
+{
+  return std::exchange(m_accumulated_gpu_region_times, {});
+}
+
+void GPUDevice::WriteGPUTimingRegionChange()
+{
+}
+
+void GPUDevice::AccumulateGPUTimingRegions(const u64* timestamps, const u8* regions, u32 num_regions,
+                                           double ms_per_tick)
+{
+  for (u32 i = 0; i < num_regions; i++)
+  {
+    // Shouldn't go backwards within a command buffer, but don't trust the driver.
+    if (timestamps[i + 1] > timestamps[i])
+    {
+      m_accumulated_gpu_region_times[regions[i]] +=
+        static_cast<float>(static_cast<double>(timestamps[i + 1] - timestamps[i]) * ms_per_tick);
+    }
+  }
+}
+
 void GPUDevice::ResetStatistics()
 {
   s_stats = {};
@@ -1106,6 +1367,9 @@ std::unique_ptr<GPUDevice> GPUDevice::CreateDeviceForAPI(RenderAPI api)
       return WrapNewMetalDevice();
 #endif
 
+    case RenderAPI::None:
+      return std::make_unique<NullDevice>();
+
     default:
       return {};
   }
@@ -13,8 +13,10 @@
 #include "common/small_string.h"
 #include "common/types.h"
 
+#include <array>
 #include <cstring>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <span>
@@ -473,9 +475,12 @@ public:
     bool memory_import : 1;
     bool explicit_present : 1;
     bool gpu_timing : 1;
+    bool gpu_timing_regions : 1;
     bool shader_cache : 1;
     bool pipeline_cache : 1;
     bool prefer_unused_textures : 1;
+    bool threaded_shader_compile : 1;
+    bool sparse_textures : 1;
   };
 
   struct Statistics
@@ -505,6 +510,12 @@ public:
   static constexpr u32 MAX_RENDER_TARGETS = 4;
   static_assert(sizeof(GPUPipeline::GraphicsConfig::color_formats) == sizeof(GPUTexture::Format) * MAX_RENDER_TARGETS);
 
+  /// Number of regions GPU time can be split into, and the number of times the region can change in one command
+  /// buffer. Changes past the limit are ignored, so the time is attributed to the previous region.
+  static constexpr u32 MAX_GPU_TIMING_REGIONS = 8;
+  static constexpr u32 MAX_GPU_TIMING_REGION_CHANGES = 128;
+  using GPUTimingRegionTimes = std::array<float, MAX_GPU_TIMING_REGIONS>;
+
   GPUDevice();
   virtual ~GPUDevice();
 
@@ -569,6 +580,21 @@ public:
   ALWAYS_INLINE GPUSampler* GetNearestSampler() const { return m_nearest_sampler.get(); }
 
   ALWAYS_INLINE bool IsGPUTimingEnabled() const { return m_gpu_timing_enabled; }
+  ALWAYS_INLINE bool IsGPUTimingRegionsEnabled() const
+  {
+    return (m_gpu_timing_enabled && m_features.gpu_timing_regions);
+  }
+
+  /// Attributes GPU time from this point onwards to the specified region, until it is next changed. Which region
+  /// means what is up to the caller. Has no effect unless GPU timing is enabled, and the device supports regions.
+  ALWAYS_INLINE void SetGPUTimingRegion(u32 region)
+  {
+    if (region != m_gpu_timing_region && IsGPUTimingRegionsEnabled())
+    {
+      m_gpu_timing_region = static_cast<u8>(region);
+      WriteGPUTimingRegionChange();
+    }
+  }
 
   virtual RenderAPI GetRenderAPI() const = 0;
 
@@ -593,6 +619,12 @@ public:
                                                     GPUTexture::Type type, GPUTexture::Format format,
                                                     const void* data = nullptr, u32 data_stride = 0) = 0;
   virtual std::unique_ptr<GPUSampler> CreateSampler(const GPUSampler::Config& config) = 0;
+
+  /// Creates a single-level, single-sample texture with no memory behind it. Regions must be committed with
+  /// CommitSparseRegion() before they are written to. Sparse textures are never pooled.
+  virtual std::unique_ptr<GPUTexture> CreateSparseTexture(u32 width, u32 height, GPUTexture::Type type,
+                                                          GPUTexture::Format format);
+
   virtual std::unique_ptr<GPUTextureBuffer> CreateTextureBuffer(GPUTextureBuffer::Format format,
                                                                 u32 size_in_elements) = 0;
 
@@ -624,6 +656,20 @@ public:
   /// Shader abstraction.
   std::unique_ptr<GPUShader> CreateShader(GPUShaderStage stage, std::string_view source,
                                           const char* entry_point = "main");
+
+  struct ShaderCompileRequest
+  {
+    GPUShaderStage stage;
+    std::string source;
+    const char* entry_point;
+    std::unique_ptr<GPUShader> shader;
+  };
+  using ShaderCompileProgressCallback = std::function<void(u32 completed)>;
+
+  /// Creates a set of shaders. Those not in the cache are compiled on worker threads if the backend supports it.
+  /// The progress callback is called on the calling thread. Returns false if any shader failed to compile.
+  bool CreateShaders(std::span<ShaderCompileRequest> requests, const ShaderCompileProgressCallback& progress_callback);
+
   virtual std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config) = 0;
 
   /// Debug messaging.
@@ -669,12 +715,23 @@ public:
   virtual void EndPresent(bool explicit_submit) = 0;
   virtual void SubmitPresent() = 0;
 
+  /// Submits queued GPU work without waiting for it to complete, so it can overlap with CPU work.
+  virtual void FlushCommands() = 0;
+
   /// Renders ImGui screen elements. Call before EndPresent().
   void RenderImGui();
 
   ALWAYS_INLINE bool IsVSyncEnabled() const { return m_vsync_enabled; }
   virtual void SetVSyncEnabled(bool enabled);
 
+  /// When enabled, a frame is dropped if the previous frame is still waiting to be presented, instead of blocking on
+  /// the swap chain. Used when vsync is on, but emulation is being paced by the throttler.
+  ALWAYS_INLINE bool IsNonBlockingPresentEnabled() const { return m_non_blocking_present; }
+  ALWAYS_INLINE void SetNonBlockingPresentEnabled(bool enabled) { m_non_blocking_present = enabled; }
+
+  /// Returns true if a previously-submitted frame has not been handed to the swap chain yet.
+  virtual bool IsPresentPending() const;
+
   ALWAYS_INLINE bool IsDebugDevice() const { return m_debug_device; }
   ALWAYS_INLINE size_t GetVRAMUsage() const { return s_total_vram_usage; }
 
@@ -697,6 +754,12 @@ public:
   /// Returns the amount of GPU time utilized since the last time this method was called.
   virtual float GetAndResetAccumulatedGPUTime();
 
+  /// Returns the amount of GPU time spent in each region since the last time this method was called.
+  GPUTimingRegionTimes GetAndResetAccumulatedGPURegionTimes();
+
+  /// Writes the pipeline cache out in the background if it has grown, at most once every few minutes.
+  void UpdatePipelineCache();
+
   ALWAYS_INLINE static Statistics& GetStatistics() { return s_stats; }
   static void ResetStatistics();
 
@@ -710,11 +773,19 @@ protected:
   virtual bool ReadPipelineCache(const std::string& filename);
   virtual bool GetPipelineCacheData(DynamicHeapArray<u8>* data);
 
+  /// Merges cache data written by another instance into the current pipeline cache.
+  virtual bool MergePipelineCache(std::span<const u8> data);
+
   virtual std::unique_ptr<GPUShader> CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data) = 0;
   virtual std::unique_ptr<GPUShader> CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
                                                             const char* entry_point,
                                                             DynamicHeapArray<u8>* out_binary) = 0;
 
+  /// Compiles source to the binary format taken by CreateShaderFromBinary(). Only used when threaded_shader_compile is
+  /// set, and must be safe to call from multiple threads at once.
+  virtual bool CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                                     DynamicHeapArray<u8>* out_binary);
+
   bool AcquireWindow(bool recreate_window);
 
   void TrimTexturePool();
@@ -771,6 +842,7 @@ private:
 
   void OpenShaderCache(std::string_view base_path, u32 version);
   void CloseShaderCache();
+  void WritePipelineCache(bool background);
   bool CreateResources();
   void DestroyResources();
 
@@ -791,9 +863,20 @@ private:
   float m_display_frame_interval = 0.0f;
 
 protected:
+  /// Records the time at which the region changed to m_gpu_timing_region in the current command buffer.
+  virtual void WriteGPUTimingRegionChange();
+
+  /// Adds the time between each pair of timestamps in a command buffer to the region which was active during it.
+  /// There is one more timestamp than regions, the first is the start of the command buffer and the last the end.
+  void AccumulateGPUTimingRegions(const u64* timestamps, const u8* regions, u32 num_regions, double ms_per_tick);
+
   static Statistics s_stats;
 
+  GPUTimingRegionTimes m_accumulated_gpu_region_times = {};
+  u8 m_gpu_timing_region = 0;
+
   bool m_vsync_enabled = false;
+  bool m_non_blocking_present = false;
   bool m_gpu_timing_enabled = false;
   bool m_debug_device = false;
 };
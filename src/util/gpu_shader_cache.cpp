@@ -14,9 +14,22 @@
 #include "zstd.h"
 #include "zstd_errors.h"
 
+#include <ctime>
+
 Log_SetChannel(GPUShaderCache);
 
+static constexpr u32 INDEX_SIGNATURE = 0x58494853; // SHIX
+
+// Entries which haven't been used for this long are dropped when the cache is opened.
+static constexpr u32 MAX_UNUSED_DAYS = 30;
+
 #pragma pack(push, 1)
+struct CacheIndexHeader
+{
+  u32 signature;
+  u32 version;
+};
+
 struct CacheIndexEntry
 {
   u32 shader_type;
@@ -28,9 +41,15 @@ struct CacheIndexEntry
   u32 file_offset;
   u32 compressed_size;
   u32 uncompressed_size;
+  u32 last_used_day;
 };
 #pragma pack(pop)
 
+static u32 GetCurrentDay()
+{
+  return static_cast<u32>(std::time(nullptr) / (24 * 60 * 60));
+}
+
 GPUShaderCache::GPUShaderCache() = default;
 
 GPUShaderCache::~GPUShaderCache()
@@ -60,13 +79,21 @@ bool GPUShaderCache::Open(std::string_view base_filename, u32 version)
 {
   m_base_filename = base_filename;
   m_version = version;
+  m_current_day = GetCurrentDay();
 
   if (base_filename.empty())
     return true;
 
   const std::string index_filename = fmt::format("{}.idx", m_base_filename);
   const std::string blob_filename = fmt::format("{}.bin", m_base_filename);
-  return ReadExisting(index_filename, blob_filename);
+  if (!ReadExisting(index_filename, blob_filename))
+    return false;
+
+  // If compaction fails before the files are replaced, we can carry on with the existing cache.
+  if (IsOpen() && ShouldCompact(static_cast<u64>(FileSystem::FTell64(m_blob_file))) && !Compact(MAX_UNUSED_DAYS))
+    return IsOpen();
+
+  return true;
 }
 
 bool GPUShaderCache::Create()
@@ -77,6 +104,31 @@ bool GPUShaderCache::Create()
 }
 
 void GPUShaderCache::Close()
+{
+  if (m_index_file && m_index_dirty)
+  {
+    // Entries are appended as they're inserted, so the only thing lost if this fails is the use times.
+    const std::string index_filename = fmt::format("{}.idx", m_base_filename);
+    const std::string new_index_filename = fmt::format("{}.idx.tmp", m_base_filename);
+    std::FILE* fp = FileSystem::OpenCFile(new_index_filename.c_str(), "wb");
+    const bool result = (fp && WriteIndex(fp));
+    if (fp)
+      std::fclose(fp);
+
+    CloseFiles();
+    if (!result || !FileSystem::RenamePath(new_index_filename.c_str(), index_filename.c_str()))
+    {
+      Log_WarningPrintf("Failed to update use times in '%s'", index_filename.c_str());
+      FileSystem::DeleteFile(new_index_filename.c_str());
+    }
+  }
+
+  CloseFiles();
+  m_index.clear();
+  m_index_dirty = false;
+}
+
+void GPUShaderCache::CloseFiles()
 {
   if (m_index_file)
   {
@@ -117,6 +169,9 @@ bool GPUShaderCache::CreateNew(const std::string& index_filename, const std::str
     FileSystem::DeleteFile(blob_filename.c_str());
   }
 
+  m_index.clear();
+  m_index_dirty = false;
+
   m_index_file = FileSystem::OpenCFile(index_filename.c_str(), "wb");
   if (!m_index_file)
   {
@@ -124,7 +179,8 @@ bool GPUShaderCache::CreateNew(const std::string& index_filename, const std::str
     return false;
   }
 
-  if (std::fwrite(&m_version, sizeof(m_version), 1, m_index_file) != 1)
+  const CacheIndexHeader header = {INDEX_SIGNATURE, m_version};
+  if (std::fwrite(&header, sizeof(header), 1, m_index_file) != 1)
   {
     Log_ErrorPrintf("Failed to write version to index file '%s'", index_filename.c_str());
     std::fclose(m_index_file);
@@ -162,8 +218,9 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
     return false;
   }
 
-  u32 file_version = 0;
-  if (std::fread(&file_version, sizeof(file_version), 1, m_index_file) != 1 || file_version != m_version)
+  CacheIndexHeader header;
+  if (std::fread(&header, sizeof(header), 1, m_index_file) != 1 || header.signature != INDEX_SIGNATURE ||
+      header.version != m_version)
   {
     Log_ErrorPrintf("Bad file/data version in '%s'", index_filename.c_str());
     std::fclose(m_index_file);
@@ -180,14 +237,16 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
     return false;
   }
 
-  std::fseek(m_blob_file, 0, SEEK_END);
-  const u32 blob_file_size = static_cast<u32>(std::ftell(m_blob_file));
+  FileSystem::FSeek64(m_blob_file, 0, SEEK_END);
+  const u64 blob_file_size = static_cast<u64>(FileSystem::FTell64(m_blob_file));
 
+  m_index.clear();
+  m_index_dirty = false;
   for (;;)
   {
     CacheIndexEntry entry;
     if (std::fread(&entry, sizeof(entry), 1, m_index_file) != 1 ||
-        (entry.file_offset + entry.compressed_size) > blob_file_size)
+        (static_cast<u64>(entry.file_offset) + entry.compressed_size) > blob_file_size)
     {
       if (std::feof(m_index_file))
         break;
@@ -203,7 +262,7 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
 
     const CacheIndexKey key{entry.shader_type,      entry.source_length,   entry.source_hash_low,
                             entry.source_hash_high, entry.entry_point_low, entry.entry_point_high};
-    const CacheIndexData data{entry.file_offset, entry.compressed_size, entry.uncompressed_size};
+    const CacheIndexData data{entry.file_offset, entry.compressed_size, entry.uncompressed_size, entry.last_used_day};
     m_index.emplace(key, data);
   }
 
@@ -214,6 +273,120 @@ bool GPUShaderCache::ReadExisting(const std::string& index_filename, const std::
   return true;
 }
 
+bool GPUShaderCache::WriteIndex(std::FILE* fp) const
+{
+  const CacheIndexHeader header = {INDEX_SIGNATURE, m_version};
+  if (std::fwrite(&header, sizeof(header), 1, fp) != 1)
+    return false;
+
+  for (const auto& [key, data] : m_index)
+  {
+    const CacheIndexEntry entry = {key.shader_type,      key.source_length,   key.source_hash_low,
+                                   key.source_hash_high, key.entry_point_low, key.entry_point_high,
+                                   data.file_offset,     data.compressed_size, data.uncompressed_size,
+                                   data.last_used_day};
+    if (std::fwrite(&entry, sizeof(entry), 1, fp) != 1)
+      return false;
+  }
+
+  return (std::fflush(fp) == 0);
+}
+
+bool GPUShaderCache::ShouldCompact(u64 blob_file_size) const
+{
+  // Worth doing if anything has expired, or a quarter of the blob is no longer referenced.
+  u64 used_size = 0;
+  for (const auto& [key, data] : m_index)
+  {
+    if ((data.last_used_day + MAX_UNUSED_DAYS) < m_current_day)
+      return true;
+
+    used_size += data.compressed_size;
+  }
+
+  return ((blob_file_size - std::min(used_size, blob_file_size)) > (blob_file_size / 4));
+}
+
+bool GPUShaderCache::Compact(u32 max_unused_days)
+{
+  if (!IsOpen())
+    return false;
+
+  const std::string index_filename = fmt::format("{}.idx", m_base_filename);
+  const std::string blob_filename = fmt::format("{}.bin", m_base_filename);
+  const std::string new_index_filename = fmt::format("{}.idx.tmp", m_base_filename);
+  const std::string new_blob_filename = fmt::format("{}.bin.tmp", m_base_filename);
+
+  std::FILE* new_blob_file = FileSystem::OpenCFile(new_blob_filename.c_str(), "wb");
+  if (!new_blob_file)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", new_blob_filename.c_str());
+    return false;
+  }
+
+  // Copy the blobs which are still in use, entries keep their use time but get a new offset.
+  const size_t old_count = m_index.size();
+  const u64 old_size = static_cast<u64>(FileSystem::FTell64(m_blob_file));
+  CacheIndex new_index;
+  new_index.reserve(m_index.size());
+  DynamicHeapArray<u8> buffer;
+  u64 new_size = 0;
+  bool result = true;
+  for (const auto& [key, data] : m_index)
+  {
+    if ((data.last_used_day + max_unused_days) < m_current_day)
+      continue;
+
+    buffer.resize(data.compressed_size);
+    if (std::fseek(m_blob_file, data.file_offset, SEEK_SET) != 0 ||
+        std::fread(buffer.data(), data.compressed_size, 1, m_blob_file) != 1 ||
+        std::fwrite(buffer.data(), data.compressed_size, 1, new_blob_file) != 1)
+    {
+      result = false;
+      break;
+    }
+
+    CacheIndexData new_data = data;
+    new_data.file_offset = static_cast<u32>(new_size);
+    new_index.emplace(key, new_data);
+    new_size += data.compressed_size;
+  }
+  result = (std::fflush(new_blob_file) == 0) && result;
+  std::fclose(new_blob_file);
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to write compacted blob file '%s'", new_blob_filename.c_str());
+    FileSystem::DeleteFile(new_blob_filename.c_str());
+    return false;
+  }
+
+  m_index = std::move(new_index);
+  std::FILE* new_index_file = FileSystem::OpenCFile(new_index_filename.c_str(), "wb");
+  result = (new_index_file && WriteIndex(new_index_file));
+  if (new_index_file)
+    std::fclose(new_index_file);
+
+  // The old index goes first, so a failure part-way through can't leave it pointing into the new blob.
+  CloseFiles();
+  m_index.clear();
+  if (!result || !FileSystem::DeleteFile(index_filename.c_str()) ||
+      !FileSystem::RenamePath(new_blob_filename.c_str(), blob_filename.c_str()) ||
+      !FileSystem::RenamePath(new_index_filename.c_str(), index_filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to replace shader cache '%s' with compacted version", m_base_filename.c_str());
+    FileSystem::DeleteFile(new_blob_filename.c_str());
+    FileSystem::DeleteFile(new_index_filename.c_str());
+    return false;
+  }
+
+  if (!ReadExisting(index_filename, blob_filename))
+    return false;
+
+  Log_InfoPrintf("Compacted shader cache '%s': %zu -> %zu entries, %u -> %u KB", m_base_filename.c_str(), old_count,
+                 m_index.size(), static_cast<u32>(old_size / 1024), static_cast<u32>(new_size / 1024));
+  return true;
+}
+
 GPUShaderCache::CacheIndexKey GPUShaderCache::GetCacheKey(GPUShaderStage stage, std::string_view shader_code,
                                                           std::string_view entry_point)
 {
@@ -252,6 +425,12 @@ bool GPUShaderCache::Lookup(const CacheIndexKey& key, ShaderBinary* binary)
   if (iter == m_index.end())
     return false;
 
+  if (iter->second.last_used_day != m_current_day)
+  {
+    iter->second.last_used_day = m_current_day;
+    m_index_dirty = true;
+  }
+
   binary->resize(iter->second.uncompressed_size);
 
   DynamicHeapArray<u8> compressed_data(iter->second.compressed_size);
@@ -292,6 +471,7 @@ bool GPUShaderCache::Insert(const CacheIndexKey& key, const void* data, u32 data
   idata.file_offset = static_cast<u32>(std::ftell(m_blob_file));
   idata.compressed_size = static_cast<u32>(compress_result);
   idata.uncompressed_size = data_size;
+  idata.last_used_day = m_current_day;
 
   CacheIndexEntry entry = {};
   entry.shader_type = static_cast<u32>(key.shader_type);
@@ -303,6 +483,7 @@ bool GPUShaderCache::Insert(const CacheIndexKey& key, const void* data, u32 data
   entry.file_offset = idata.file_offset;
   entry.compressed_size = idata.compressed_size;
   entry.uncompressed_size = idata.uncompressed_size;
+  entry.last_used_day = idata.last_used_day;
 
   if (std::fwrite(compress_buffer.data(), compress_result, 1, m_blob_file) != 1 || std::fflush(m_blob_file) != 0 ||
       std::fwrite(&entry, sizeof(entry), 1, m_index_file) != 1 || std::fflush(m_index_file) != 0)
@@ -56,24 +56,36 @@ public:
   bool Insert(const CacheIndexKey& key, const void* data, u32 data_size);
   void Clear();
 
+  /// Rewrites the cache without entries which haven't been used in max_unused_days, and without any blob space which
+  /// is no longer referenced. Also done automatically when the cache is opened.
+  bool Compact(u32 max_unused_days);
+
 private:
   struct CacheIndexData
   {
     u32 file_offset;
     u32 compressed_size;
     u32 uncompressed_size;
+    u32 last_used_day;
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHash>;
 
   bool CreateNew(const std::string& index_filename, const std::string& blob_filename);
   bool ReadExisting(const std::string& index_filename, const std::string& blob_filename);
+  bool WriteIndex(std::FILE* fp) const;
+  bool ShouldCompact(u64 blob_file_size) const;
+  void CloseFiles();
 
   CacheIndex m_index;
 
   std::string m_base_filename;
   u32 m_version;
 
+  // Days since the epoch, for tracking when entries were last used.
+  u32 m_current_day = 0;
+  bool m_index_dirty = false;
+
   std::FILE* m_index_file = nullptr;
   std::FILE* m_blob_file = nullptr;
 };
@@ -48,6 +48,10 @@ const char* GPUTexture::GetFormatName(Format format)
     "RGBA16F", // RGBA16F
     "RGBA32F", // RGBA32F
     "RGB10A2", // RGB10A2
+    "BC1",     // BC1
+    "BC2",     // BC2
+    "BC3",     // BC3
+    "BC7",     // BC7
   };
 
   return format_names[static_cast<u8>(format)];
@@ -60,7 +64,7 @@ u32 GPUTexture::GetCompressedBytesPerBlock() const
 
 u32 GPUTexture::GetCompressedBytesPerBlock(Format format)
 {
-  // TODO: Implement me
+  // Pixel size is the block size for compressed formats.
   return GetPixelSize(format);
 }
 
@@ -71,19 +75,14 @@ u32 GPUTexture::GetCompressedBlockSize() const
 
 u32 GPUTexture::GetCompressedBlockSize(Format format)
 {
-  // TODO: Implement me
-  /*if (format >= Format::BC1 && format <= Format::BC7)
-    return 4;
-  else*/
-  return 1;
+  return IsCompressedFormat(format) ? 4 : 1;
 }
 
 u32 GPUTexture::CalcUploadPitch(Format format, u32 width)
 {
-  /*
-  if (format >= Format::BC1 && format <= Format::BC7)
+  if (IsCompressedFormat(format))
     width = Common::AlignUpPow2(width, 4) / 4;
-  */
+
   return width * GetCompressedBytesPerBlock(format);
 }
 
@@ -110,9 +109,19 @@ u32 GPUTexture::CalcUploadSize(u32 height, u32 pitch) const
 }
 
 u32 GPUTexture::CalcUploadSize(Format format, u32 height, u32 pitch)
+{
+  return pitch * CalcUploadRows(format, height);
+}
+
+u32 GPUTexture::CalcUploadRows(u32 height) const
+{
+  return CalcUploadRows(m_format, height);
+}
+
+u32 GPUTexture::CalcUploadRows(Format format, u32 height)
 {
   const u32 block_size = GetCompressedBlockSize(format);
-  return pitch * ((static_cast<u32>(height) + (block_size - 1)) / block_size);
+  return ((height + (block_size - 1)) / block_size);
 }
 
 std::array<float, 4> GPUTexture::GetUNormClearColor() const
@@ -122,21 +131,20 @@ std::array<float, 4> GPUTexture::GetUNormClearColor() const
 
 size_t GPUTexture::GetVRAMUsage() const
 {
-  if (m_levels == 1) [[likely]]
+  if (m_levels == 1 && !IsCompressedFormat(m_format)) [[likely]]
     return ((static_cast<size_t>(m_width * m_height) * GetPixelSize(m_format)) * m_layers * m_samples);
 
-  const size_t ps = GetPixelSize(m_format) * m_layers * m_samples;
   u32 width = m_width;
   u32 height = m_height;
   size_t ts = 0;
   for (u32 i = 0; i < m_levels; i++)
   {
+    ts += CalcUploadSize(m_format, height, CalcUploadPitch(m_format, width));
     width = (width > 1) ? (width / 2) : width;
     height = (height > 1) ? (height / 2) : height;
-    ts += static_cast<size_t>(width * height) * ps;
   }
 
-  return ts;
+  return ts * m_layers * m_samples;
 }
 
 u32 GPUTexture::GetPixelSize(GPUTexture::Format format)
@@ -164,6 +172,10 @@ u32 GPUTexture::GetPixelSize(GPUTexture::Format format)
     8,  // RGBA16F
     16, // RGBA32F
     4,  // RGB10A2
+    8,  // BC1
+    16, // BC2
+    16, // BC3
+    16, // BC7
   }};
 
   return sizes[static_cast<size_t>(format)];
@@ -182,8 +194,7 @@ bool GPUTexture::IsDepthStencilFormat(Format format)
 
 bool GPUTexture::IsCompressedFormat(Format format)
 {
-  // TODO: Implement me
-  return false;
+  return (format >= Format::BC1 && format <= Format::BC7);
 }
 
 bool GPUTexture::ValidateConfig(u32 width, u32 height, u32 layers, u32 levels, u32 samples, Type type, Format format)
@@ -227,6 +238,12 @@ bool GPUTexture::ValidateConfig(u32 width, u32 height, u32 layers, u32 levels, u
     return false;
   }
 
+  if (IsCompressedFormat(format) && type != Type::Texture)
+  {
+    Log_ErrorPrintf("Compressed formats are only supported on static textures.");
+    return false;
+  }
+
   return true;
 }
 
@@ -340,6 +357,12 @@ void GPUTexture::MakeReadyForSampling()
 {
 }
 
+bool GPUTexture::CommitSparseRegion(u32 x, u32 y, u32 width, u32 height)
+{
+  // Non-sparse textures are always backed.
+  return !IsSparse();
+}
+
 GPUDownloadTexture::GPUDownloadTexture(u32 width, u32 height, GPUTexture::Format format, bool is_imported)
   : m_width(width), m_height(height), m_format(format), m_is_imported(is_imported)
 {
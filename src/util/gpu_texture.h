@@ -56,6 +56,10 @@ public:
     RGBA16F,
     RGBA32F,
     RGB10A2,
+    BC1, ///< BC1/DXT1, 4x4 blocks of 8 bytes.
+    BC2, ///< BC2/DXT3, 4x4 blocks of 16 bytes.
+    BC3, ///< BC3/DXT5, 4x4 blocks of 16 bytes.
+    BC7, ///< BC7/BPTC, 4x4 blocks of 16 bytes.
     MaxCount
   };
 
@@ -86,6 +90,7 @@ public:
   static u32 CalcUploadPitch(Format format, u32 width);
   static u32 CalcUploadRowLengthFromPitch(Format format, u32 pitch);
   static u32 CalcUploadSize(Format format, u32 height, u32 pitch);
+  static u32 CalcUploadRows(Format format, u32 height);
 
   static bool ValidateConfig(u32 width, u32 height, u32 layers, u32 levels, u32 samples, Type type, Format format);
 
@@ -103,6 +108,9 @@ public:
 
   ALWAYS_INLINE bool IsTextureArray() const { return m_layers > 1; }
   ALWAYS_INLINE bool IsMultisampled() const { return m_samples > 1; }
+  ALWAYS_INLINE bool IsSparse() const { return (m_sparse_tile_width != 0); }
+  ALWAYS_INLINE u32 GetSparseTileWidth() const { return m_sparse_tile_width; }
+  ALWAYS_INLINE u32 GetSparseTileHeight() const { return m_sparse_tile_height; }
 
   ALWAYS_INLINE u32 GetPixelSize() const { return GetPixelSize(m_format); }
   ALWAYS_INLINE u32 GetMipWidth(u32 level) const { return std::max<u32>(m_width >> level, 1u); }
@@ -145,6 +153,7 @@ public:
   u32 CalcUploadPitch(u32 width) const;
   u32 CalcUploadRowLengthFromPitch(u32 pitch) const;
   u32 CalcUploadSize(u32 height, u32 pitch) const;
+  u32 CalcUploadRows(u32 height) const;
 
   GPUTexture& operator=(const GPUTexture&) = delete;
 
@@ -156,6 +165,10 @@ public:
   // Instructs the backend that we're finished rendering to this texture. It may transition it to a new layout.
   virtual void MakeReadyForSampling();
 
+  // Backs a region of a sparse texture with memory. The region must be aligned to the tile size, or end at the edge of
+  // the texture. Newly-committed tiles have undefined contents. Uncommitted regions read as zero, and discard writes.
+  virtual bool CommitSparseRegion(u32 x, u32 y, u32 width, u32 height);
+
   virtual void SetDebugName(std::string_view name) = 0;
 
 protected:
@@ -171,6 +184,10 @@ protected:
 
   State m_state = State::Dirty;
 
+  // Zero unless the texture is sparse.
+  u16 m_sparse_tile_width = 0;
+  u16 m_sparse_tile_height = 0;
+
   ClearValue m_clear_value = {};
 };
 
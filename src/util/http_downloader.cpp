@@ -9,6 +9,8 @@
 #include "common/string_util.h"
 #include "common/timer.h"
 
+#include "fmt/format.h"
+
 Log_SetChannel(HTTPDownloader);
 
 static constexpr float DEFAULT_TIMEOUT_IN_SECONDS = 30;
@@ -77,6 +79,80 @@ void HTTPDownloader::CreatePostRequest(std::string url, std::string post_data, R
   LockedAddRequest(req);
 }
 
+void HTTPDownloader::CreateRangeRequest(std::string url, u64 offset, u32 length, RangeCallback callback)
+{
+  DebugAssert(length > 0);
+
+  Request* req = InternalCreateRequest();
+  req->parent = this;
+  req->type = Request::Type::Get;
+  req->url = std::move(url);
+  req->range_start = offset;
+  req->range_length = length;
+  req->progress = nullptr;
+  req->start_time = Common::Timer::GetCurrentValue();
+
+  // The callback always runs before the request is closed, so it can pick the total size up from the request.
+  req->callback = [req, callback = std::move(callback)](s32 status_code, const std::string&,
+                                                        Request::Data data) {
+    callback(status_code, req->range_total_size, std::move(data));
+  };
+
+  std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+  if (LockedGetActiveRequestCount() < m_max_active_requests)
+  {
+    if (!StartRequest(req))
+      return;
+  }
+
+  LockedAddRequest(req);
+}
+
+void HTTPDownloader::CreateConditionalRequest(std::string url, CacheValidators validators,
+                                              ConditionalCallback callback)
+{
+  Request* req = InternalCreateRequest();
+  req->parent = this;
+  req->type = Request::Type::Get;
+  req->url = std::move(url);
+  req->request_validators = std::move(validators);
+  req->progress = nullptr;
+  req->start_time = Common::Timer::GetCurrentValue();
+  req->callback = [req, callback = std::move(callback)](s32 status_code, const std::string& content_type,
+                                                        Request::Data data) {
+    callback(status_code, content_type, std::move(req->response_validators), std::move(data));
+  };
+
+  std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+  if (LockedGetActiveRequestCount() < m_max_active_requests)
+  {
+    if (!StartRequest(req))
+      return;
+  }
+
+  LockedAddRequest(req);
+}
+
+std::string HTTPDownloader::GetConditionalRequestHeaders(const CacheValidators& validators)
+{
+  std::string ret;
+  if (!validators.etag.empty())
+    ret += fmt::format("If-None-Match: {}\r\n", validators.etag);
+  if (!validators.last_modified.empty())
+    ret += fmt::format("If-Modified-Since: {}\r\n", validators.last_modified);
+  return ret;
+}
+
+std::optional<u64> HTTPDownloader::ParseContentRangeTotalSize(std::string_view value)
+{
+  // Total is "*" if the server doesn't know it.
+  const std::string_view::size_type pos = value.rfind('/');
+  if (pos == std::string_view::npos)
+    return std::nullopt;
+
+  return StringUtil::FromChars<u64>(StringUtil::StripWhitespace(value.substr(pos + 1)));
+}
+
 void HTTPDownloader::LockedPollRequests(std::unique_lock<std::mutex>& lock)
 {
   if (m_pending_http_requests.empty())
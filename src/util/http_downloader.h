@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -23,7 +24,18 @@ public:
     HTTP_STATUS_CANCELLED = -3,
     HTTP_STATUS_TIMEOUT = -2,
     HTTP_STATUS_ERROR = -1,
-    HTTP_STATUS_OK = 200
+    HTTP_STATUS_OK = 200,
+    HTTP_STATUS_PARTIAL_CONTENT = 206,
+    HTTP_STATUS_NOT_MODIFIED = 304,
+  };
+
+  /// Response headers which let a later request for the same resource skip the body if it hasn't changed.
+  struct CacheValidators
+  {
+    std::string etag;
+    std::string last_modified;
+
+    ALWAYS_INLINE bool IsEmpty() const { return etag.empty() && last_modified.empty(); }
   };
 
   struct Request
@@ -57,10 +69,22 @@ public:
     s32 status_code = 0;
     u32 content_length = 0;
     u32 last_progress_update = 0;
+    u64 range_start = 0;
+    u32 range_length = 0;
+    u64 range_total_size = 0;
+    CacheValidators request_validators;
+    CacheValidators response_validators;
     Type type = Type::Get;
     std::atomic<State> state{State::Pending};
   };
 
+  /// total_size is the size of the whole resource, from the Content-Range header, or zero if it wasn't sent.
+  using RangeCallback = std::function<void(s32 status_code, u64 total_size, Request::Data data)>;
+
+  /// validators are the ones sent with the response, to be passed to the next request for the same URL.
+  using ConditionalCallback = std::function<void(s32 status_code, const std::string& content_type,
+                                                 CacheValidators validators, Request::Data data)>;
+
   HTTPDownloader();
   virtual ~HTTPDownloader();
 
@@ -73,6 +97,12 @@ public:
   void CreateRequest(std::string url, Request::Callback callback, ProgressCallback* progress = nullptr);
   void CreatePostRequest(std::string url, std::string post_data, Request::Callback callback,
                          ProgressCallback* progress = nullptr);
+
+  /// Requests length bytes starting at offset. Servers which support ranges respond with HTTP_STATUS_PARTIAL_CONTENT.
+  void CreateRangeRequest(std::string url, u64 offset, u32 length, RangeCallback callback);
+
+  /// Sends If-None-Match/If-Modified-Since from validators. Unchanged resources return HTTP_STATUS_NOT_MODIFIED.
+  void CreateConditionalRequest(std::string url, CacheValidators validators, ConditionalCallback callback);
   void PollRequests();
   void WaitForAllRequests();
   bool HasAnyRequests();
@@ -86,6 +116,12 @@ protected:
   virtual bool StartRequest(Request* request) = 0;
   virtual void CloseRequest(Request* request) = 0;
 
+  /// Returns the total size from a Content-Range header value, e.g. "bytes 0-1023/4096".
+  static std::optional<u64> ParseContentRangeTotalSize(std::string_view value);
+
+  /// Returns the request headers for the validators, each terminated with CRLF.
+  static std::string GetConditionalRequestHeaders(const CacheValidators& validators);
+
   void LockedAddRequest(Request* request);
   u32 LockedGetActiveRequestCount();
   void LockedPollRequests(std::unique_lock<std::mutex>& lock);
@@ -8,6 +8,8 @@
 #include "common/string_util.h"
 #include "common/timer.h"
 
+#include "fmt/format.h"
+
 #include <algorithm>
 #include <functional>
 #include <pthread.h>
@@ -65,6 +67,11 @@ bool HTTPDownloaderCurl::Initialize(std::string user_agent)
     return false;
   }
 
+  // Finished handles leave their connections in the multi handle's cache, so keep enough around to reuse them, and
+  // share HTTP/2 connections between requests to the same host.
+  curl_multi_setopt(m_multi_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  curl_multi_setopt(m_multi_handle, CURLMOPT_MAXCONNECTS, static_cast<long>(MAX_CACHED_CONNECTIONS));
+
   m_user_agent = std::move(user_agent);
   return true;
 }
@@ -89,6 +96,30 @@ size_t HTTPDownloaderCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, v
   return nmemb;
 }
 
+size_t HTTPDownloaderCurl::HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+  Request* req = static_cast<Request*>(userdata);
+  const std::string_view line(buffer, size * nitems);
+  static constexpr std::string_view content_range = "content-range:";
+  static constexpr std::string_view etag = "etag:";
+  static constexpr std::string_view last_modified = "last-modified:";
+  if (line.size() > content_range.size() && StringUtil::StartsWithNoCase(line, content_range))
+  {
+    if (const std::optional<u64> total_size = ParseContentRangeTotalSize(line.substr(content_range.size())))
+      req->range_total_size = total_size.value();
+  }
+  else if (line.size() > etag.size() && StringUtil::StartsWithNoCase(line, etag))
+  {
+    req->response_validators.etag = StringUtil::StripWhitespace(line.substr(etag.size()));
+  }
+  else if (line.size() > last_modified.size() && StringUtil::StartsWithNoCase(line, last_modified))
+  {
+    req->response_validators.last_modified = StringUtil::StripWhitespace(line.substr(last_modified.size()));
+  }
+
+  return size * nitems;
+}
+
 HTTPDownloader::Request* HTTPDownloaderCurl::InternalCreateRequest()
 {
   Request* req = new Request();
@@ -172,12 +203,37 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
   curl_easy_setopt(req->handle, CURLOPT_NOSIGNAL, 1L);
   curl_easy_setopt(req->handle, CURLOPT_PRIVATE, req);
   curl_easy_setopt(req->handle, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(req->handle, CURLOPT_HEADERFUNCTION, &HTTPDownloaderCurl::HeaderCallback);
+  curl_easy_setopt(req->handle, CURLOPT_HEADERDATA, req);
+  curl_easy_setopt(req->handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(req->handle, CURLOPT_PIPEWAIT, 1L);
+  curl_easy_setopt(req->handle, CURLOPT_TCP_KEEPALIVE, 1L);
 
   if (request->type == Request::Type::Post)
   {
     curl_easy_setopt(req->handle, CURLOPT_POST, 1L);
     curl_easy_setopt(req->handle, CURLOPT_POSTFIELDS, request->post_data.c_str());
   }
+  else if (request->range_length > 0)
+  {
+    // Handles from the same multi handle share its connection cache, so range requests reuse connections.
+    const std::string range = fmt::format("{}-{}", request->range_start,
+                                          request->range_start + request->range_length - 1);
+    curl_easy_setopt(req->handle, CURLOPT_RANGE, range.c_str());
+  }
+  else if (!request->request_validators.IsEmpty())
+  {
+    const CacheValidators& validators = request->request_validators;
+    if (!validators.etag.empty())
+      req->headers = curl_slist_append(req->headers, fmt::format("If-None-Match: {}", validators.etag).c_str());
+    if (!validators.last_modified.empty())
+    {
+      req->headers =
+        curl_slist_append(req->headers, fmt::format("If-Modified-Since: {}", validators.last_modified).c_str());
+    }
+
+    curl_easy_setopt(req->handle, CURLOPT_HTTPHEADER, req->headers);
+  }
 
   Log_DevPrintf("Started HTTP request for '%s'", req->url.c_str());
   req->state.store(Request::State::Started, std::memory_order_release);
@@ -189,6 +245,7 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
     Log_ErrorFmt("curl_multi_add_handle() returned {}", static_cast<int>(err));
     req->callback(HTTP_STATUS_ERROR, std::string(), req->data);
     curl_easy_cleanup(req->handle);
+    curl_slist_free_all(req->headers);
     delete req;
     return false;
   }
@@ -202,5 +259,6 @@ void HTTPDownloaderCurl::CloseRequest(HTTPDownloader::Request* request)
   DebugAssert(req->handle);
   curl_multi_remove_handle(m_multi_handle, req->handle);
   curl_easy_cleanup(req->handle);
+  curl_slist_free_all(req->headers);
   delete req;
 }
@@ -27,9 +27,13 @@ private:
   struct Request : HTTPDownloader::Request
   {
     CURL* handle = nullptr;
+    curl_slist* headers = nullptr;
   };
 
+  static constexpr u32 MAX_CACHED_CONNECTIONS = 16;
+
   static size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
+  static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata);
 
   CURLM* m_multi_handle = nullptr;
   std::string m_user_agent;
@@ -8,6 +8,8 @@
 #include "common/string_util.h"
 #include "common/timer.h"
 
+#include "fmt/format.h"
+
 #include <algorithm>
 
 Log_SetChannel(HTTPDownloader);
@@ -55,6 +57,34 @@ bool HTTPDownloaderWinHttp::Initialize(std::string user_agent)
     return false;
   }
 
+  // Connections are pooled by the session and kept alive between requests. HTTP/2 lets requests to the same host
+  // share one connection, but isn't available before Windows 10 1607, so it's not fatal.
+  DWORD protocol_flags = WINHTTP_PROTOCOL_FLAG_HTTP2;
+  if (!WinHttpSetOption(m_hSession, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocol_flags, sizeof(protocol_flags)))
+    Log_WarningPrintf("Failed to enable HTTP/2: %u", GetLastError());
+
+  return true;
+}
+
+bool HTTPDownloaderWinHttp::QueryHeaderString(HINTERNET hRequest, DWORD info_level, std::string* value)
+{
+  DWORD length = 0;
+  if (WinHttpQueryHeaders(hRequest, info_level, WINHTTP_HEADER_NAME_BY_INDEX, WINHTTP_NO_OUTPUT_BUFFER, &length,
+                          WINHTTP_NO_HEADER_INDEX) ||
+      GetLastError() != ERROR_INSUFFICIENT_BUFFER || length < sizeof(wchar_t))
+  {
+    return false;
+  }
+
+  std::wstring value_wstring;
+  value_wstring.resize((length / sizeof(wchar_t)) - 1);
+  if (!WinHttpQueryHeaders(hRequest, info_level, WINHTTP_HEADER_NAME_BY_INDEX, value_wstring.data(), &length,
+                           WINHTTP_NO_HEADER_INDEX))
+  {
+    return false;
+  }
+
+  *value = StringUtil::WideStringToUTF8String(value_wstring);
   return true;
 }
 
@@ -131,19 +161,14 @@ void CALLBACK HTTPDownloaderWinHttp::HTTPStatusCallback(HINTERNET hRequest, DWOR
         req->content_length = 0;
       }
 
-      DWORD content_type_length = 0;
-      if (!WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_TYPE, WINHTTP_HEADER_NAME_BY_INDEX,
-                               WINHTTP_NO_OUTPUT_BUFFER, &content_type_length, WINHTTP_NO_HEADER_INDEX) &&
-          GetLastError() == ERROR_INSUFFICIENT_BUFFER && content_type_length >= sizeof(content_type_length))
-      {
-        std::wstring content_type_wstring;
-        content_type_wstring.resize((content_type_length / sizeof(wchar_t)) - 1);
-        if (WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_TYPE, WINHTTP_HEADER_NAME_BY_INDEX,
-                                content_type_wstring.data(), &content_type_length, WINHTTP_NO_HEADER_INDEX))
-        {
-          req->content_type = StringUtil::WideStringToUTF8String(content_type_wstring);
-        }
-      }
+      QueryHeaderString(hRequest, WINHTTP_QUERY_CONTENT_TYPE, &req->content_type);
+
+      std::string content_range;
+      if (req->range_length > 0 && QueryHeaderString(hRequest, WINHTTP_QUERY_CONTENT_RANGE, &content_range))
+        req->range_total_size = ParseContentRangeTotalSize(content_range).value_or(0);
+
+      QueryHeaderString(hRequest, WINHTTP_QUERY_ETAG, &req->response_validators.etag);
+      QueryHeaderString(hRequest, WINHTTP_QUERY_LAST_MODIFIED, &req->response_validators.last_modified);
 
       Log_DevPrintf("Status code %d, content-length is %u", req->status_code, req->content_length);
       req->data.reserve(req->content_length);
@@ -275,6 +300,21 @@ bool HTTPDownloaderWinHttp::StartRequest(HTTPDownloader::Request* request)
                                 req->post_data.data(), static_cast<DWORD>(req->post_data.size()),
                                 static_cast<DWORD>(req->post_data.size()), reinterpret_cast<DWORD_PTR>(req));
   }
+  else if (req->range_length > 0)
+  {
+    // The session keeps connections alive between requests to the same host.
+    const std::wstring additional_headers = StringUtil::UTF8StringToWideString(
+      fmt::format("Range: bytes={}-{}\r\n", req->range_start, req->range_start + req->range_length - 1));
+    result = WinHttpSendRequest(req->hRequest, additional_headers.data(), static_cast<DWORD>(additional_headers.size()),
+                                WINHTTP_NO_REQUEST_DATA, 0, 0, reinterpret_cast<DWORD_PTR>(req));
+  }
+  else if (!req->request_validators.IsEmpty())
+  {
+    const std::wstring additional_headers =
+      StringUtil::UTF8StringToWideString(GetConditionalRequestHeaders(req->request_validators));
+    result = WinHttpSendRequest(req->hRequest, additional_headers.data(), static_cast<DWORD>(additional_headers.size()),
+                                WINHTTP_NO_REQUEST_DATA, 0, 0, reinterpret_cast<DWORD_PTR>(req));
+  }
   else
   {
     result = WinHttpSendRequest(req->hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0,
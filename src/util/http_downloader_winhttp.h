@@ -31,6 +31,9 @@ private:
     u32 io_position = 0;
   };
 
+  /// Reads a response header into value. Returns false if it wasn't sent.
+  static bool QueryHeaderString(HINTERNET hRequest, DWORD info_level, std::string* value);
+
   static void CALLBACK HTTPStatusCallback(HINTERNET hInternet, DWORD_PTR dwContext, DWORD dwInternetStatus,
                                           LPVOID lpvStatusInformation, DWORD dwStatusInformationLength);
 
@@ -0,0 +1,270 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "http_range_reader.h"
+#include "http_downloader.h"
+
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "common/threading.h"
+#include "common/timer.h"
+
+#include <algorithm>
+#include <cstring>
+
+Log_SetChannel(HTTPRangeReader);
+
+HTTPRangeReader::HTTPRangeReader() = default;
+
+HTTPRangeReader::~HTTPRangeReader()
+{
+  if (m_worker_thread.joinable())
+  {
+    {
+      std::unique_lock lock(m_mutex);
+      m_shutdown = true;
+      m_work_cv.notify_one();
+    }
+
+    m_worker_thread.join();
+  }
+
+  // Callbacks reference this object, so they have to be done before it goes away.
+  if (m_downloader)
+    m_downloader->WaitForAllRequests();
+}
+
+bool HTTPRangeReader::IsHTTPURL(std::string_view path)
+{
+  return (StringUtil::StartsWithNoCase(path, "http://") || StringUtil::StartsWithNoCase(path, "https://"));
+}
+
+std::shared_ptr<HTTPRangeReader> HTTPRangeReader::Open(std::string url, Error* error)
+{
+  std::shared_ptr<HTTPRangeReader> reader(new HTTPRangeReader());
+  reader->m_url = std::move(url);
+  reader->m_downloader = HTTPDownloader::Create();
+  if (!reader->m_downloader)
+  {
+    Error::SetStringView(error, "Failed to create HTTP downloader.");
+    return {};
+  }
+  reader->m_downloader->SetMaxActiveRequests(MAX_ACTIVE_REQUESTS);
+
+  // The first block tells us the size of the file, and whether the server handles ranges at all.
+  s32 status_code = HTTPDownloader::HTTP_STATUS_ERROR;
+  u64 total_size = 0;
+  HTTPDownloader::Request::Data data;
+  reader->m_downloader->CreateRangeRequest(reader->m_url, 0, BLOCK_SIZE,
+                                           [&status_code, &total_size, &data](s32 res_status_code, u64 res_total_size,
+                                                                              HTTPDownloader::Request::Data res_data) {
+                                             status_code = res_status_code;
+                                             total_size = res_total_size;
+                                             data = std::move(res_data);
+                                           });
+  reader->m_downloader->WaitForAllRequests();
+
+  if (status_code == HTTPDownloader::HTTP_STATUS_OK)
+  {
+    Error::SetStringView(error, "Server does not support range requests.");
+    return {};
+  }
+  else if (status_code != HTTPDownloader::HTTP_STATUS_PARTIAL_CONTENT)
+  {
+    Error::SetStringFmt(error, "Request failed with status code {}.", status_code);
+    return {};
+  }
+  else if (total_size == 0)
+  {
+    Error::SetStringView(error, "Server did not report the size of the file.");
+    return {};
+  }
+
+  reader->m_size = total_size;
+  reader->m_total_blocks = (total_size + (BLOCK_SIZE - 1)) / BLOCK_SIZE;
+  if (data.size() != reader->GetBlockLength(0))
+  {
+    Error::SetStringFmt(error, "Server returned {} bytes for the first block, expected {}.", data.size(),
+                        reader->GetBlockLength(0));
+    return {};
+  }
+
+  Block& first_block = reader->m_blocks[0];
+  first_block.data = std::move(data);
+  first_block.block_index = 0;
+  first_block.last_used = ++reader->m_use_counter;
+  first_block.state = BlockState::Ready;
+
+  Log_InfoFmt("Opened '{}' over HTTP, {} bytes", reader->m_url, reader->m_size);
+  reader->m_worker_thread = std::thread(&HTTPRangeReader::WorkerThreadEntryPoint, reader.get());
+  return reader;
+}
+
+u32 HTTPRangeReader::GetBlockLength(u64 block_index) const
+{
+  return static_cast<u32>(std::min<u64>(BLOCK_SIZE, m_size - (block_index * BLOCK_SIZE)));
+}
+
+HTTPRangeReader::Block* HTTPRangeReader::FindBlock(u64 block_index)
+{
+  for (Block& block : m_blocks)
+  {
+    if (block.block_index == block_index)
+      return &block;
+  }
+
+  return nullptr;
+}
+
+HTTPRangeReader::Block* HTTPRangeReader::GetEvictableBlock()
+{
+  // Blocks in flight can't be reused until their request completes.
+  Block* ret = nullptr;
+  for (Block& block : m_blocks)
+  {
+    if (block.state != BlockState::Pending && (!ret || block.last_used < ret->last_used))
+      ret = &block;
+  }
+
+  return ret;
+}
+
+void HTTPRangeReader::QueueBlocks(u64 first_block, u64 last_block, std::vector<u64>* to_submit)
+{
+  for (u64 block_index = first_block; block_index <= last_block && block_index < m_total_blocks; block_index++)
+  {
+    if (FindBlock(block_index))
+      continue;
+
+    Block* block = GetEvictableBlock();
+    if (!block)
+      break;
+
+    block->data.clear();
+    block->block_index = block_index;
+    block->last_used = ++m_use_counter;
+    block->state = BlockState::Pending;
+    m_pending_requests++;
+    to_submit->push_back(block_index);
+  }
+
+  if (!to_submit->empty())
+    m_work_cv.notify_one();
+}
+
+void HTTPRangeReader::SubmitBlockRequests(const std::vector<u64>& block_indices)
+{
+  // Must be called without the lock held, since failed requests can call back immediately.
+  for (const u64 block_index : block_indices)
+  {
+    const u32 length = GetBlockLength(block_index);
+    m_downloader->CreateRangeRequest(
+      m_url, block_index * BLOCK_SIZE, length,
+      [this, block_index, length](s32 status_code, u64 total_size, HTTPDownloader::Request::Data data) {
+        std::unique_lock lock(m_mutex);
+        Block* block = FindBlock(block_index);
+        DebugAssert(block && block->state == BlockState::Pending);
+        if (status_code == HTTPDownloader::HTTP_STATUS_PARTIAL_CONTENT && data.size() == length)
+        {
+          block->data = std::move(data);
+          block->state = BlockState::Ready;
+        }
+        else
+        {
+          Log_ErrorFmt("Request for block {} of '{}' failed with status code {} and {} bytes", block_index, m_url,
+                       status_code, data.size());
+          block->state = BlockState::Failed;
+        }
+
+        m_pending_requests--;
+        m_block_cv.notify_all();
+      });
+  }
+}
+
+bool HTTPRangeReader::Read(u64 offset, void* dst, size_t size)
+{
+  if (size == 0)
+    return true;
+  else if (offset >= m_size || size > (m_size - offset))
+    return false;
+
+  const u64 first_block = offset / BLOCK_SIZE;
+  const u64 last_block = (offset + size - 1) / BLOCK_SIZE;
+  std::vector<u64> to_submit;
+  u8* dst_ptr = static_cast<u8*>(dst);
+
+  std::unique_lock lock(m_mutex);
+
+  // Request everything we need up front, along with the blocks after it, so they arrive in parallel.
+  QueueBlocks(first_block, last_block + PREFETCH_BLOCKS, &to_submit);
+  if (!to_submit.empty())
+  {
+    lock.unlock();
+    SubmitBlockRequests(to_submit);
+    lock.lock();
+  }
+
+  for (u64 block_index = first_block; block_index <= last_block;)
+  {
+    Block* block = FindBlock(block_index);
+    if (!block)
+    {
+      // Evicted by another reader before we got to it, or there was no free slot when queueing.
+      to_submit.clear();
+      QueueBlocks(block_index, block_index, &to_submit);
+      if (to_submit.empty())
+      {
+        m_block_cv.wait(lock);
+        continue;
+      }
+
+      lock.unlock();
+      SubmitBlockRequests(to_submit);
+      lock.lock();
+      continue;
+    }
+    else if (block->state == BlockState::Pending)
+    {
+      m_block_cv.wait(lock);
+      continue;
+    }
+    else if (block->state != BlockState::Ready)
+    {
+      // Let the next read retry it.
+      block->block_index = INVALID_BLOCK_INDEX;
+      block->state = BlockState::Empty;
+      return false;
+    }
+
+    const u64 block_start = block_index * BLOCK_SIZE;
+    const u64 copy_start = std::max(offset, block_start);
+    const u64 copy_end = std::min<u64>(offset + size, block_start + block->data.size());
+    std::memcpy(dst_ptr + (copy_start - offset), &block->data[copy_start - block_start], copy_end - copy_start);
+    block->last_used = ++m_use_counter;
+    block_index++;
+  }
+
+  return true;
+}
+
+void HTTPRangeReader::WorkerThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("HTTP Range Reader");
+
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_work_cv.wait(lock, [this]() { return (m_shutdown || m_pending_requests > 0); });
+    if (m_shutdown)
+      break;
+
+    // Callbacks run from PollRequests(), and take the lock.
+    lock.unlock();
+    m_downloader->PollRequests();
+    Common::Timer::NanoSleep(1000000);
+    lock.lock();
+  }
+}
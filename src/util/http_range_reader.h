@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "common/types.h"
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class Error;
+class HTTPDownloader;
+
+/// Random access to a file on a HTTP server, through range requests. The file is fetched in aligned blocks which are
+/// kept in an LRU cache, and the blocks following each read are requested ahead of time. All requests go through one
+/// downloader, so connections are reused. Safe to read from multiple threads.
+class HTTPRangeReader
+{
+public:
+  static constexpr u32 BLOCK_SIZE = 128 * 1024;
+
+  ~HTTPRangeReader();
+
+  /// Returns true if the path is a http:// or https:// URL.
+  static bool IsHTTPURL(std::string_view path);
+
+  /// Fetches the first block, and checks that the server supports range requests.
+  static std::shared_ptr<HTTPRangeReader> Open(std::string url, Error* error);
+
+  ALWAYS_INLINE const std::string& GetURL() const { return m_url; }
+  ALWAYS_INLINE u64 GetSize() const { return m_size; }
+
+  /// Copies size bytes at offset to dst, waiting for any blocks which haven't arrived yet.
+  /// Returns false if the range is past the end of the file, or a request failed.
+  bool Read(u64 offset, void* dst, size_t size);
+
+private:
+  static constexpr u32 CACHE_BLOCKS = 64;
+  static constexpr u32 PREFETCH_BLOCKS = 4;
+  static constexpr u32 MAX_ACTIVE_REQUESTS = 4;
+  static constexpr u64 INVALID_BLOCK_INDEX = static_cast<u64>(-1);
+
+  enum class BlockState : u8
+  {
+    Empty,
+    Pending,
+    Ready,
+    Failed,
+  };
+
+  struct Block
+  {
+    std::vector<u8> data;
+    u64 block_index = INVALID_BLOCK_INDEX;
+    u32 last_used = 0;
+    BlockState state = BlockState::Empty;
+  };
+
+  HTTPRangeReader();
+
+  Block* FindBlock(u64 block_index);
+  Block* GetEvictableBlock();
+  u32 GetBlockLength(u64 block_index) const;
+
+  /// Claims a cache slot for each block which isn't cached or in flight, and returns the ones to submit.
+  void QueueBlocks(u64 first_block, u64 last_block, std::vector<u64>* to_submit);
+  void SubmitBlockRequests(const std::vector<u64>& block_indices);
+
+  void WorkerThreadEntryPoint();
+
+  std::string m_url;
+  u64 m_size = 0;
+  u64 m_total_blocks = 0;
+
+  std::unique_ptr<HTTPDownloader> m_downloader;
+
+  std::mutex m_mutex;
+  std::condition_variable m_block_cv;
+  std::condition_variable m_work_cv;
+  std::array<Block, CACHE_BLOCKS> m_blocks;
+  u32 m_use_counter = 0;
+  u32 m_pending_requests = 0;
+  bool m_shutdown = false;
+  std::thread m_worker_thread;
+};
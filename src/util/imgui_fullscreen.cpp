@@ -13,6 +13,7 @@
 #include "common/easing.h"
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/heterogeneous_containers.h"
 #include "common/log.h"
 #include "common/lru_cache.h"
 #include "common/path.h"
@@ -44,6 +45,9 @@ using MessageDialogCallbackVariant = std::variant<InfoMessageDialogCallback, Con
 
 static constexpr float MENU_BACKGROUND_ANIMATION_TIME = 0.5f;
 
+// Decoded textures are uploaded until this many bytes have gone up in a frame, the rest wait for the next frame.
+static constexpr size_t TEXTURE_UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;
+
 static std::optional<RGBA8Image> LoadTextureImage(std::string_view path);
 static std::shared_ptr<GPUTexture> UploadTexture(std::string_view path, const RGBA8Image& image);
 static void TextureLoaderThread();
@@ -99,6 +103,7 @@ static std::atomic_bool s_texture_load_thread_quit{false};
 static std::mutex s_texture_load_mutex;
 static std::condition_variable s_texture_load_cv;
 static std::deque<std::string> s_texture_load_queue;
+static PreferUnorderedStringSet s_texture_load_pending;
 static std::deque<std::pair<std::string, RGBA8Image>> s_texture_upload_queue;
 static std::thread s_texture_load_thread;
 
@@ -372,9 +377,14 @@ GPUTexture* ImGuiFullscreen::GetCachedTextureAsync(std::string_view name)
     tex_ptr = s_texture_cache.Insert(std::string(name), s_placeholder_texture);
 
     // queue the actual load
+    // A texture can be evicted and requested again before the first load finishes.
     std::unique_lock lock(s_texture_load_mutex);
-    s_texture_load_queue.emplace_back(name);
-    s_texture_load_cv.notify_one();
+    if (s_texture_load_pending.find(name) == s_texture_load_pending.end())
+    {
+      s_texture_load_pending.emplace(name);
+      s_texture_load_queue.emplace_back(name);
+      s_texture_load_cv.notify_one();
+    }
   }
 
   return tex_ptr->get();
@@ -387,16 +397,26 @@ bool ImGuiFullscreen::InvalidateCachedTexture(const std::string& path)
 
 void ImGuiFullscreen::UploadAsyncTextures()
 {
+  // Scrolling through a grid of covers decodes many at once. Spread the uploads out, so one frame doesn't take them
+  // all. At least one is uploaded per frame, however large it is.
+  size_t uploaded_bytes = 0;
   std::unique_lock lock(s_texture_load_mutex);
-  while (!s_texture_upload_queue.empty())
+  while (!s_texture_upload_queue.empty() && uploaded_bytes < TEXTURE_UPLOAD_BYTES_PER_FRAME)
   {
     std::pair<std::string, RGBA8Image> it(std::move(s_texture_upload_queue.front()));
     s_texture_upload_queue.pop_front();
+    s_texture_load_pending.erase(it.first);
     lock.unlock();
 
-    std::shared_ptr<GPUTexture> tex = UploadTexture(it.first.c_str(), it.second);
-    if (tex)
-      s_texture_cache.Insert(std::move(it.first), std::move(tex));
+    uploaded_bytes += static_cast<size_t>(it.second.GetPitch()) * it.second.GetHeight();
+
+    // Don't bother if it was evicted while it was being decoded, it'll be requested again if it's still needed.
+    if (s_texture_cache.Lookup(it.first))
+    {
+      std::shared_ptr<GPUTexture> tex = UploadTexture(it.first.c_str(), it.second);
+      if (tex)
+        s_texture_cache.Insert(std::move(it.first), std::move(tex));
+    }
 
     lock.lock();
   }
@@ -419,8 +439,9 @@ void ImGuiFullscreen::TextureLoaderThread()
 
     while (!s_texture_load_queue.empty())
     {
-      std::string path(std::move(s_texture_load_queue.front()));
-      s_texture_load_queue.pop_front();
+      // Newest first, the most recent requests are the ones which are on screen now.
+      std::string path(std::move(s_texture_load_queue.back()));
+      s_texture_load_queue.pop_back();
 
       lock.unlock();
       std::optional<RGBA8Image> image(LoadTextureImage(path.c_str()));
@@ -429,10 +450,13 @@ void ImGuiFullscreen::TextureLoaderThread()
       // don't bother queuing back if it doesn't exist
       if (image)
         s_texture_upload_queue.emplace_back(std::move(path), std::move(image.value()));
+      else
+        s_texture_load_pending.erase(path);
     }
   }
 
   s_texture_load_queue.clear();
+  s_texture_load_pending.clear();
 }
 
 bool ImGuiFullscreen::UpdateLayoutScale()
@@ -2932,7 +2956,7 @@ void ImGuiFullscreen::DrawNotifications(ImVec2& position, float spacing)
     const ImVec2 badge_max(badge_min.x + badge_size, badge_min.y + badge_size);
     if (!notif.badge_path.empty())
     {
-      GPUTexture* tex = GetCachedTexture(notif.badge_path.c_str());
+      GPUTexture* tex = GetCachedTextureAsync(notif.badge_path.c_str());
       if (tex)
       {
         dl->AddImage(tex, badge_min, badge_max, ImVec2(0.0f, 0.0f), ImVec2(1.0f, 1.0f),
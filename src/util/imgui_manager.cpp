@@ -9,21 +9,29 @@
 #include "input_manager.h"
 
 #include "common/assert.h"
+#include "common/byte_stream.h"
 #include "common/easing.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
 
+#include "core/settings.h" // TODO: Remove, needed for cache directory.
+
 #include "IconsFontAwesome5.h"
 #include "fmt/format.h"
 #include "imgui.h"
+#include "imgui_freetype.h"
 #include "imgui_internal.h"
+#include "xxhash.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <deque>
 #include <mutex>
 #include <unordered_map>
@@ -65,6 +73,11 @@ static bool AddImGuiFonts(bool fullscreen_fonts);
 static ImFont* AddTextFont(float size);
 static ImFont* AddFixedFont(float size);
 static bool AddIconFonts(float size);
+static bool BuildFontAtlas(ImFontAtlas* atlas);
+static u64 GetFontAtlasHash(const ImFontAtlas* atlas);
+static std::string GetFontAtlasCachePath(u64 hash);
+static bool LoadFontAtlasCache(ImFontAtlas* atlas, const std::string& path);
+static void SaveFontAtlasCache(const ImFontAtlas* atlas, const std::string& path);
 static void AcquirePendingOSDMessages(Common::Timer::Value current_time);
 static void DrawOSDMessages(Common::Timer::Value current_time);
 static void CreateSoftwareCursorTextures();
@@ -88,6 +101,14 @@ static std::vector<u8> s_fixed_font_data;
 static std::vector<u8> s_icon_fa_font_data;
 static std::vector<u8> s_icon_pf_font_data;
 
+// Rasterizing the atlas takes a long time with large glyph ranges, so the result is kept in the cache directory,
+// keyed by everything that goes into it. Only the most recent few are kept, since each scale has its own atlas.
+static constexpr u32 FONT_ATLAS_CACHE_SIGNATURE = 0x41464D49; // IMFA
+static constexpr u32 FONT_ATLAS_CACHE_VERSION = 1;
+static constexpr u32 MAX_FONT_ATLAS_CACHE_DIMENSION = 16384;
+static constexpr u32 MAX_FONT_ATLAS_CACHE_FILES = 4;
+static constexpr ImFontBuilderIO s_font_builder_io = {&BuildFontAtlas};
+
 static float s_window_width;
 static float s_window_height;
 static Common::Timer s_last_render_time;
@@ -172,6 +193,7 @@ bool ImGuiManager::Initialize(float global_scale, bool show_osd_messages, Error*
   ImGui::CreateContext();
 
   ImGuiIO& io = ImGui::GetIO();
+  io.Fonts->FontBuilderIO = &s_font_builder_io;
   io.IniFilename = nullptr;
   io.BackendFlags |= ImGuiBackendFlags_HasGamepad | ImGuiBackendFlags_RendererHasVtxOffset;
   io.BackendUsingLegacyKeyArrays = 0;
@@ -653,6 +675,220 @@ bool ImGuiManager::AddImGuiFonts(bool fullscreen_fonts)
   return io.Fonts->Build();
 }
 
+bool ImGuiManager::BuildFontAtlas(ImFontAtlas* atlas)
+{
+  // Font sizes are rounded here, so it has to happen before hashing.
+  ImFontAtlasBuildInit(atlas);
+
+  Common::Timer timer;
+  const std::string path = EmuFolders::Cache.empty() ? std::string() : GetFontAtlasCachePath(GetFontAtlasHash(atlas));
+  if (!path.empty() && LoadFontAtlasCache(atlas, path))
+  {
+    Log_DevFmt("Loaded font atlas from cache in {:.2f} ms", timer.GetTimeMilliseconds());
+    return true;
+  }
+
+  if (!ImGuiFreeType::GetBuilderForFreeType()->FontBuilder_Build(atlas))
+    return false;
+
+  Log_DevFmt("Built {}x{} font atlas in {:.2f} ms", atlas->TexWidth, atlas->TexHeight, timer.GetTimeMilliseconds());
+  if (!path.empty())
+    SaveFontAtlasCache(atlas, path);
+  return true;
+}
+
+u64 ImGuiManager::GetFontAtlasHash(const ImFontAtlas* atlas)
+{
+  XXH64_state_t* state = XXH64_createState();
+  XXH64_reset(state, FONT_ATLAS_CACHE_VERSION);
+
+  const auto hash_value = [state](const auto& value) { XXH64_update(state, &value, sizeof(value)); };
+  hash_value(atlas->Flags);
+  hash_value(atlas->TexDesiredWidth);
+  hash_value(atlas->TexGlyphPadding);
+  hash_value(atlas->FontBuilderFlags);
+  for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+  {
+    hash_value(rect.Width);
+    hash_value(rect.Height);
+    hash_value(rect.GlyphID);
+  }
+
+  for (const ImFontConfig& cfg : atlas->ConfigData)
+  {
+    XXH64_update(state, cfg.FontData, static_cast<size_t>(cfg.FontDataSize));
+    hash_value(cfg.FontNo);
+    hash_value(cfg.SizePixels);
+    hash_value(cfg.OversampleH);
+    hash_value(cfg.OversampleV);
+    hash_value(cfg.PixelSnapH);
+    hash_value(cfg.GlyphExtraSpacing);
+    hash_value(cfg.GlyphOffset);
+    hash_value(cfg.GlyphMinAdvanceX);
+    hash_value(cfg.GlyphMaxAdvanceX);
+    hash_value(cfg.MergeMode);
+    hash_value(cfg.FontBuilderFlags);
+    hash_value(cfg.RasterizerMultiply);
+    hash_value(cfg.RasterizerDensity);
+    hash_value(cfg.EllipsisChar);
+
+    for (int i = 0; i < atlas->Fonts.Size; i++)
+    {
+      if (atlas->Fonts[i] == cfg.DstFont)
+        hash_value(i);
+    }
+
+    for (const ImWchar* range = cfg.GlyphRanges; range && range[0] != 0; range += 2)
+    {
+      hash_value(range[0]);
+      hash_value(range[1]);
+    }
+  }
+
+  const u64 hash = XXH64_digest(state);
+  XXH64_freeState(state);
+  return hash;
+}
+
+std::string ImGuiManager::GetFontAtlasCachePath(u64 hash)
+{
+  return Path::Combine(EmuFolders::Cache, fmt::format("fontatlas_{:016X}.bin", hash));
+}
+
+bool ImGuiManager::LoadFontAtlasCache(ImFontAtlas* atlas, const std::string& path)
+{
+  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(path.c_str(), BYTESTREAM_OPEN_READ);
+  if (!stream)
+    return false;
+
+  u32 signature, version, width, height, num_rects, num_fonts;
+  ImVec2 white_pixel;
+  ImVec4 uv_lines[std::size(atlas->TexUvLines)];
+  if (!stream->ReadU32(&signature) || signature != FONT_ATLAS_CACHE_SIGNATURE || !stream->ReadU32(&version) ||
+      version != FONT_ATLAS_CACHE_VERSION || !stream->ReadU32(&width) || !stream->ReadU32(&height) ||
+      !stream->ReadU32(&num_rects) || !stream->ReadU32(&num_fonts) ||
+      num_rects != static_cast<u32>(atlas->CustomRects.Size) || num_fonts != static_cast<u32>(atlas->Fonts.Size) ||
+      width == 0 || height == 0 || width > MAX_FONT_ATLAS_CACHE_DIMENSION ||
+      height > MAX_FONT_ATLAS_CACHE_DIMENSION || !stream->Read2(&white_pixel, sizeof(white_pixel)) ||
+      !stream->Read2(uv_lines, sizeof(uv_lines)))
+  {
+    Log_WarningFmt("Ignoring invalid font atlas cache '{}'", Path::GetFileName(path));
+    return false;
+  }
+
+  // Don't allocate more than the file could possibly contain.
+  const u64 pixels_size = static_cast<u64>(width) * static_cast<u64>(height);
+  if (pixels_size > (stream->GetSize() - stream->GetPosition()))
+  {
+    Log_WarningFmt("Font atlas cache '{}' is truncated", Path::GetFileName(path));
+    return false;
+  }
+
+  atlas->TexID = nullptr;
+  atlas->ClearTexData();
+  atlas->TexWidth = static_cast<int>(width);
+  atlas->TexHeight = static_cast<int>(height);
+  atlas->TexUvScale = ImVec2(1.0f / static_cast<float>(width), 1.0f / static_cast<float>(height));
+  atlas->TexUvWhitePixel = white_pixel;
+  std::memcpy(atlas->TexUvLines, uv_lines, sizeof(uv_lines));
+  atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(static_cast<size_t>(pixels_size)));
+
+  bool result = stream->Read2(atlas->TexPixelsAlpha8, static_cast<u32>(pixels_size));
+  for (ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    result = result && stream->ReadU16(&rect.X) && stream->ReadU16(&rect.Y);
+
+  for (ImFont* font : atlas->Fonts)
+  {
+    float ascent, descent;
+    u32 num_glyphs;
+    s32 surface;
+    if (!result || !stream->Read2(&ascent, sizeof(ascent)) || !stream->Read2(&descent, sizeof(descent)) ||
+        !stream->ReadS32(&surface) ||
+        !stream->ReadU32(&num_glyphs) || num_glyphs == 0 || num_glyphs >= 0xFFFF)
+    {
+      result = false;
+      break;
+    }
+
+    ImFontAtlasBuildSetupFont(atlas, font, const_cast<ImFontConfig*>(font->ConfigData), ascent, descent);
+    font->MetricsTotalSurface = surface;
+    font->Glyphs.resize(static_cast<int>(num_glyphs));
+    result = stream->Read2(font->Glyphs.Data, static_cast<u32>(font->Glyphs.size_in_bytes()));
+  }
+
+  if (!result)
+  {
+    Log_WarningFmt("Font atlas cache '{}' is truncated", Path::GetFileName(path));
+    atlas->ClearTexData();
+    for (ImFont* font : atlas->Fonts)
+      font->ClearOutputData();
+    return false;
+  }
+
+  for (ImFont* font : atlas->Fonts)
+    font->BuildLookupTable();
+
+  atlas->TexPixelsUseColors = false;
+  atlas->TexReady = true;
+  return true;
+}
+
+void ImGuiManager::SaveFontAtlasCache(const ImFontAtlas* atlas, const std::string& path)
+{
+  // Colour glyphs would need the RGBA texture to be stored, and we don't use any.
+  if (!atlas->TexPixelsAlpha8 || atlas->TexPixelsUseColors)
+    return;
+
+  // Drop the oldest atlases, so changing the scale doesn't fill up the cache directory.
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(EmuFolders::Cache.c_str(), "fontatlas_*.bin", FILESYSTEM_FIND_FILES, &files);
+  if (files.size() >= MAX_FONT_ATLAS_CACHE_FILES)
+  {
+    std::sort(files.begin(), files.end(), [](const FILESYSTEM_FIND_DATA& lhs, const FILESYSTEM_FIND_DATA& rhs) {
+      return (lhs.ModificationTime < rhs.ModificationTime);
+    });
+    for (size_t i = 0; i <= (files.size() - MAX_FONT_ATLAS_CACHE_FILES); i++)
+      FileSystem::DeleteFile(files[i].FileName.c_str());
+  }
+
+  Error error;
+  std::unique_ptr<ByteStream> stream =
+    ByteStream::OpenFile(path.c_str(),
+                         BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                           BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED,
+                         &error);
+  if (!stream)
+  {
+    Log_ErrorFmt("Failed to open font atlas cache '{}': {}", Path::GetFileName(path), error.GetDescription());
+    return;
+  }
+
+  const u32 width = static_cast<u32>(atlas->TexWidth);
+  const u32 height = static_cast<u32>(atlas->TexHeight);
+  bool result = (stream->WriteU32(FONT_ATLAS_CACHE_SIGNATURE) && stream->WriteU32(FONT_ATLAS_CACHE_VERSION) &&
+                 stream->WriteU32(width) && stream->WriteU32(height) &&
+                 stream->WriteU32(static_cast<u32>(atlas->CustomRects.Size)) &&
+                 stream->WriteU32(static_cast<u32>(atlas->Fonts.Size)) &&
+                 stream->Write2(&atlas->TexUvWhitePixel, sizeof(atlas->TexUvWhitePixel)) &&
+                 stream->Write2(atlas->TexUvLines, sizeof(atlas->TexUvLines)) &&
+                 stream->Write2(atlas->TexPixelsAlpha8, width * height));
+  for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    result = result && stream->WriteU16(rect.X) && stream->WriteU16(rect.Y);
+  for (const ImFont* font : atlas->Fonts)
+  {
+    result = result && stream->Write2(&font->Ascent, sizeof(font->Ascent)) &&
+             stream->Write2(&font->Descent, sizeof(font->Descent)) &&
+             stream->WriteS32(font->MetricsTotalSurface) && stream->WriteU32(static_cast<u32>(font->Glyphs.Size)) &&
+             stream->Write2(font->Glyphs.Data, static_cast<u32>(font->Glyphs.size_in_bytes()));
+  }
+
+  if (!result || !stream->Commit())
+  {
+    Log_ErrorFmt("Failed to write font atlas cache '{}'", Path::GetFileName(path));
+    stream->Discard();
+  }
+}
+
 bool ImGuiManager::AddFullscreenFontsIfMissing()
 {
   if (HasFullscreenFonts())
@@ -85,6 +85,7 @@ bool INISettingsInterface::Load()
   if (fp)
     err = m_ini.LoadFile(fp.get());
 
+  UpdateGeneration();
   return (err == SI_OK);
 }
 
@@ -133,6 +134,7 @@ bool INISettingsInterface::Save(Error* error /* = nullptr */)
 void INISettingsInterface::Clear()
 {
   m_ini.Reset();
+  UpdateGeneration();
 }
 
 bool INISettingsInterface::IsEmpty()
@@ -233,36 +235,42 @@ bool INISettingsInterface::GetStringValue(const char* section, const char* key,
 void INISettingsInterface::SetIntValue(const char* section, const char* key, s32 value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetUIntValue(const char* section, const char* key, u32 value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetFloatValue(const char* section, const char* key, float value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetDoubleValue(const char* section, const char* key, double value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, StringUtil::ToChars(value).c_str(), nullptr, true);
 }
 
 void INISettingsInterface::SetBoolValue(const char* section, const char* key, bool value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetBoolValue(section, key, value, nullptr, true);
 }
 
 void INISettingsInterface::SetStringValue(const char* section, const char* key, const char* value)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, value, nullptr, true);
 }
 
@@ -274,12 +282,14 @@ bool INISettingsInterface::ContainsValue(const char* section, const char* key) c
 void INISettingsInterface::DeleteValue(const char* section, const char* key)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.Delete(section, key);
 }
 
 void INISettingsInterface::ClearSection(const char* section)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.Delete(section, nullptr);
   m_ini.SetValue(section, nullptr, nullptr);
 }
@@ -290,6 +300,7 @@ void INISettingsInterface::RemoveSection(const char* section)
     return;
 
   m_dirty = true;
+  UpdateGeneration();
   m_ini.Delete(section, nullptr);
 }
 
@@ -303,6 +314,7 @@ void INISettingsInterface::RemoveEmptySections()
       continue;
 
     m_dirty = true;
+    UpdateGeneration();
     m_ini.Delete(entry.pItem, nullptr);
   }
 }
@@ -323,6 +335,7 @@ std::vector<std::string> INISettingsInterface::GetStringList(const char* section
 void INISettingsInterface::SetStringList(const char* section, const char* key, const std::vector<std::string>& items)
 {
   m_dirty = true;
+  UpdateGeneration();
   m_ini.Delete(section, key);
 
   for (const std::string& sv : items)
@@ -332,6 +345,7 @@ void INISettingsInterface::SetStringList(const char* section, const char* key, c
 bool INISettingsInterface::RemoveFromStringList(const char* section, const char* key, const char* item)
 {
   m_dirty = true;
+  UpdateGeneration();
   return m_ini.DeleteValue(section, key, item, true);
 }
 
@@ -346,6 +360,7 @@ bool INISettingsInterface::AddToStringList(const char* section, const char* key,
   }
 
   m_dirty = true;
+  UpdateGeneration();
   m_ini.SetValue(section, key, item, nullptr, false);
   return true;
 }
@@ -385,4 +400,6 @@ void INISettingsInterface::SetKeyValueList(const char* section,
   m_ini.Delete(section, nullptr);
   for (const std::pair<std::string, std::string>& item : items)
     m_ini.SetValue(section, item.first.c_str(), item.second.c_str(), nullptr, false);
+
+  UpdateGeneration();
 }
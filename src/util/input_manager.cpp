@@ -10,6 +10,8 @@
 #include "common/timer.h"
 #include "core/controller.h"
 #include "core/host.h"
+#include "core/input_movie.h"
+#include "core/netplay.h"
 #include "core/system.h"
 #include "imgui_manager.h"
 #include "input_source.h"
@@ -58,6 +60,7 @@ struct InputBinding
   u8 num_keys = 0;
   u8 full_mask = 0;
   u8 current_mask = 0;
+  bool controller_binding = false;
 };
 
 struct PadVibrationBinding
@@ -65,24 +68,34 @@ struct PadVibrationBinding
   struct Motor
   {
     InputBindingKey binding;
-    u64 last_update_time;
     InputSource* source;
+    float pending_intensity;
     float last_intensity;
   };
 
   u32 pad_index = 0;
   Motor motors[MAX_MOTORS_PER_PAD] = {};
+  u64 last_update_time = 0;
+  bool update_pending = false;
 
   /// Returns true if the two motors are bound to the same host motor.
   ALWAYS_INLINE bool AreMotorsCombined() const { return motors[0].binding == motors[1].binding; }
 
-  /// Returns the intensity when both motors are combined.
-  ALWAYS_INLINE float GetCombinedIntensity() const
+  /// Returns true if the last update sent to the sources had either motor running.
+  ALWAYS_INLINE bool IsVibrating() const
   {
-    return std::max(motors[0].last_intensity, motors[1].last_intensity);
+    return (motors[0].last_intensity != 0.0f || motors[1].last_intensity != 0.0f);
   }
 };
 
+struct DeferredEvent
+{
+  InputBindingKey key;
+  float value;
+  GenericInputBinding generic_key;
+  bool preprocess_only;
+};
+
 struct MacroButton
 {
   std::vector<u32> buttons; ///< Buttons to activate.
@@ -106,19 +119,25 @@ static std::optional<InputBindingKey> ParseSensorKey(std::string_view source, st
 static std::vector<std::string_view> SplitChord(std::string_view binding);
 static bool SplitBinding(std::string_view binding, std::string_view* source, std::string_view* sub_binding);
 static void PrettifyInputBindingPart(std::string_view binding, SmallString& ret, bool& changed);
-static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler);
+static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                        bool controller_binding);
+static void AddBinding(std::string_view binding, const InputEventHandler& handler, bool controller_binding);
 
 static bool IsAxisHandler(const InputEventHandler& handler);
 
 static void AddHotkeyBindings(SettingsInterface& si);
 static void AddPadBindings(SettingsInterface& si, const std::string& section, u32 pad,
                            const Controller::ControllerInfo* cinfo);
-static void UpdateContinuedVibration();
+static void UpdateVibration();
+static void SendPadVibration(PadVibrationBinding& pad, u64 current_time);
 static void GenerateRelativeMouseEvents();
 
 static bool DoEventHook(InputBindingKey key, float value);
 static bool PreprocessEvent(InputBindingKey key, float value, GenericInputBinding generic_key);
 static bool ProcessEvent(InputBindingKey key, float value, bool skip_button_handlers);
+static bool IsControllerOnlyKey(InputBindingKey key);
+static bool InvokeEventsForControllerRead(InputBindingKey key, float value, GenericInputBinding generic_key);
+static void ProcessDeferredEvents();
 
 static void LoadMacroButtonConfig(SettingsInterface& si, const std::string& section, u32 pad,
                                   const Controller::ControllerInfo* cinfo);
@@ -144,6 +163,11 @@ static std::mutex s_binding_map_write_lock;
 static std::mutex m_event_intercept_mutex;
 static InputInterceptHook::Callback m_event_intercept_callback;
 
+// Events from polling in the middle of a frame, which can't be processed until the frame boundary.
+static std::vector<DeferredEvent> s_deferred_events;
+static Common::Timer::Value s_last_poll_time = 0;
+static bool s_polling_for_controller_read = false;
+
 // Input sources. Keyboard/mouse don't exist here.
 static std::array<std::unique_ptr<InputSource>, static_cast<u32>(InputSourceType::Count)> s_input_sources;
 
@@ -477,13 +501,19 @@ void InputManager::PrettifyInputBindingPart(const std::string_view binding, Smal
   ret.append(binding);
 }
 
-void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler)
+void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                               bool controller_binding)
 {
   for (const std::string& binding : bindings)
-    AddBinding(binding, handler);
+    AddBinding(binding, handler, controller_binding);
 }
 
 void InputManager::AddBinding(std::string_view binding, const InputEventHandler& handler)
+{
+  AddBinding(binding, handler, false);
+}
+
+void InputManager::AddBinding(std::string_view binding, const InputEventHandler& handler, bool controller_binding)
 {
   std::shared_ptr<InputBinding> ibinding;
   const std::vector<std::string_view> chord_bindings(SplitChord(binding));
@@ -502,6 +532,7 @@ void InputManager::AddBinding(std::string_view binding, const InputEventHandler&
     {
       ibinding = std::make_shared<InputBinding>();
       ibinding->handler = handler;
+      ibinding->controller_binding = controller_binding;
     }
 
     if (ibinding->num_keys == MAX_KEYS_PER_BINDING)
@@ -799,7 +830,7 @@ void InputManager::AddHotkeyBindings(SettingsInterface& si)
       if (bindings.empty())
         continue;
 
-      AddBindings(bindings, InputButtonEventHandler{hotkey->handler});
+      AddBindings(bindings, InputButtonEventHandler{hotkey->handler}, false);
     }
   }
 }
@@ -825,8 +856,14 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
 
                         Controller* c = System::GetController(pad_index);
                         if (c)
-                          c->SetBindState(bind_index, value);
-                      }});
+                        {
+                          System::Internal::OnHostInputEvent();
+                          if (!InputMovie::InterceptBindState(pad_index, bind_index, value) &&
+                              !Netplay::InterceptBindState(pad_index, bind_index, value))
+                            c->SetBindState(bind_index, value);
+                        }
+                      }},
+                      true);
         }
       }
       break;
@@ -838,7 +875,8 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
             return;
 
           Controller* c = System::GetController(pad_index);
-          if (c)
+          if (c && !InputMovie::InterceptBindState(pad_index, base + key.data, value) &&
+              !Netplay::InterceptBindState(pad_index, base + key.data, value))
             c->SetBindState(base + key.data, value);
         };
 
@@ -878,7 +916,8 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
                       return;
 
                     SetMacroButtonState(pad_index, macro_button_index, state);
-                  }});
+                  }},
+                  true);
     }
   }
 
@@ -948,6 +987,9 @@ bool InputManager::IsAxisHandler(const InputEventHandler& handler)
 
 bool InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBinding generic_key)
 {
+  if (s_polling_for_controller_read) [[unlikely]]
+    return InvokeEventsForControllerRead(key, value, generic_key);
+
   if (DoEventHook(key, value))
     return true;
 
@@ -1068,6 +1110,46 @@ bool InputManager::ProcessEvent(InputBindingKey key, float value, bool skip_butt
   return true;
 }
 
+bool InputManager::IsControllerOnlyKey(InputBindingKey key)
+{
+  const auto range = s_binding_map.equal_range(key.MaskDirection());
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (!it->second->controller_binding)
+      return false;
+  }
+
+  return true;
+}
+
+bool InputManager::InvokeEventsForControllerRead(InputBindingKey key, float value, GenericInputBinding generic_key)
+{
+  // We're in the middle of executing, and hotkeys can do things like load states, so anything which isn't only bound
+  // to the controllers has to wait until the frame boundary. The UI still sees controller events then as well.
+  if (HasHook() || !IsControllerOnlyKey(key))
+  {
+    s_deferred_events.push_back({key, value, generic_key, false});
+    return true;
+  }
+
+  s_deferred_events.push_back({key, value, generic_key, true});
+  return ProcessEvent(key, value, false);
+}
+
+void InputManager::ProcessDeferredEvents()
+{
+  const std::vector<DeferredEvent> events = std::move(s_deferred_events);
+  s_deferred_events.clear();
+
+  for (const DeferredEvent& event : events)
+  {
+    if (event.preprocess_only)
+      PreprocessEvent(event.key, event.value, event.generic_key);
+    else
+      InvokeEvents(event.key, event.value, event.generic_key);
+  }
+}
+
 void InputManager::ClearBindStateFromSource(InputBindingKey key)
 {
   // Why are we doing it this way? Because any of the bindings could cause a reload and invalidate our iterators :(.
@@ -1454,6 +1536,8 @@ void InputManager::OnInputDeviceDisconnected(InputBindingKey key, std::string_vi
 void InputManager::SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_intensity,
                                             float small_motor_intensity)
 {
+  // Only recorded here, the sources are updated from PollSources(). Games can set the motors several times a frame,
+  // so this coalesces them, and changes which are undone before the next poll never reach the device.
   for (PadVibrationBinding& pad : s_pad_vibration_array)
   {
     if (pad.pad_index != pad_index)
@@ -1461,45 +1545,48 @@ void InputManager::SetPadVibrationIntensity(u32 pad_index, float large_or_single
 
     PadVibrationBinding::Motor& large_motor = pad.motors[0];
     PadVibrationBinding::Motor& small_motor = pad.motors[1];
-    if (large_motor.last_intensity == large_or_single_motor_intensity &&
-        small_motor.last_intensity == small_motor_intensity)
-      continue;
+    large_motor.pending_intensity = large_or_single_motor_intensity;
+    small_motor.pending_intensity = small_motor_intensity;
+    pad.update_pending = (large_motor.last_intensity != large_or_single_motor_intensity ||
+                          small_motor.last_intensity != small_motor_intensity);
+  }
+}
 
-    if (pad.AreMotorsCombined())
-    {
-      // if the motors are combined, we need to adjust to the maximum of both
-      const float report_intensity = std::max(large_or_single_motor_intensity, small_motor_intensity);
-      if (large_motor.source)
-      {
-        large_motor.last_update_time = Common::Timer::GetCurrentValue();
-        large_motor.source->UpdateMotorState(large_motor.binding, report_intensity);
-      }
-    }
-    else if (large_motor.source == small_motor.source)
-    {
-      // both motors are bound to the same source, do an optimal update
-      large_motor.last_update_time = Common::Timer::GetCurrentValue();
-      large_motor.source->UpdateMotorState(large_motor.binding, small_motor.binding, large_or_single_motor_intensity,
-                                           small_motor_intensity);
-    }
-    else
+void InputManager::SendPadVibration(PadVibrationBinding& pad, u64 current_time)
+{
+  PadVibrationBinding::Motor& large_motor = pad.motors[0];
+  PadVibrationBinding::Motor& small_motor = pad.motors[1];
+  const float large_intensity = large_motor.pending_intensity;
+  const float small_intensity = small_motor.pending_intensity;
+
+  if (pad.AreMotorsCombined())
+  {
+    // if the motors are combined, we need to adjust to the maximum of both
+    if (large_motor.source)
+      large_motor.source->UpdateMotorState(large_motor.binding, std::max(large_intensity, small_intensity));
+  }
+  else if (large_motor.source == small_motor.source)
+  {
+    // both motors are bound to the same source, do an optimal update
+    if (large_motor.source)
     {
-      // update motors independently
-      if (large_motor.source && large_motor.last_intensity != large_or_single_motor_intensity)
-      {
-        large_motor.last_update_time = Common::Timer::GetCurrentValue();
-        large_motor.source->UpdateMotorState(large_motor.binding, large_or_single_motor_intensity);
-      }
-      if (small_motor.source && small_motor.last_intensity != small_motor_intensity)
-      {
-        small_motor.last_update_time = Common::Timer::GetCurrentValue();
-        small_motor.source->UpdateMotorState(small_motor.binding, small_motor_intensity);
-      }
+      large_motor.source->UpdateMotorState(large_motor.binding, small_motor.binding, large_intensity,
+                                           small_intensity);
     }
-
-    large_motor.last_intensity = large_or_single_motor_intensity;
-    small_motor.last_intensity = small_motor_intensity;
   }
+  else
+  {
+    // update motors independently
+    if (large_motor.source)
+      large_motor.source->UpdateMotorState(large_motor.binding, large_intensity);
+    if (small_motor.source)
+      small_motor.source->UpdateMotorState(small_motor.binding, small_intensity);
+  }
+
+  large_motor.last_intensity = large_intensity;
+  small_motor.last_intensity = small_intensity;
+  pad.last_update_time = current_time;
+  pad.update_pending = false;
 }
 
 void InputManager::PauseVibration()
@@ -1512,57 +1599,34 @@ void InputManager::PauseVibration()
       if (!motor.source || motor.last_intensity == 0.0f)
         continue;
 
-      // we deliberately don't zero the intensity here, so it can resume later
-      motor.last_update_time = 0;
+      // we deliberately don't zero the pending intensity here, so it resumes on the next poll after unpausing
+      motor.last_intensity = 0.0f;
       motor.source->UpdateMotorState(motor.binding, 0.0f);
+      binding.update_pending = true;
     }
   }
 }
 
-void InputManager::UpdateContinuedVibration()
+void InputManager::UpdateVibration()
 {
-  // update vibration intensities, so if the game does a long effect, it continues
   const u64 current_time = Common::Timer::GetCurrentValue();
   for (PadVibrationBinding& pad : s_pad_vibration_array)
   {
-    if (pad.AreMotorsCombined())
+    const double dt = Common::Timer::ConvertValueToSeconds(current_time - pad.last_update_time);
+    if (pad.update_pending)
     {
-      // motors are combined
-      PadVibrationBinding::Motor& large_motor = pad.motors[0];
-      if (!large_motor.source)
-        continue;
-
-      // so only check the first one
-      const double dt = Common::Timer::ConvertValueToSeconds(current_time - large_motor.last_update_time);
-      if (dt < VIBRATION_UPDATE_INTERVAL_SECONDS)
-        continue;
-
-      // but take max of both motors for the intensity
-      const float intensity = pad.GetCombinedIntensity();
-      if (intensity == 0.0f)
+      // changes which arrive too quickly stay pending, and the latest one is sent once the interval has passed
+      if (dt < VIBRATION_MIN_UPDATE_INTERVAL_SECONDS)
         continue;
-
-      large_motor.last_update_time = current_time;
-      large_motor.source->UpdateMotorState(large_motor.binding, intensity);
     }
     else
     {
-      // independent motor control
-      for (u32 i = 0; i < MAX_MOTORS_PER_PAD; i++)
-      {
-        PadVibrationBinding::Motor& motor = pad.motors[i];
-        if (!motor.source || motor.last_intensity == 0.0f)
-          continue;
-
-        const double dt = Common::Timer::ConvertValueToSeconds(current_time - motor.last_update_time);
-        if (dt < VIBRATION_UPDATE_INTERVAL_SECONDS)
-          continue;
-
-        // re-notify the source of the continued effect
-        motor.last_update_time = current_time;
-        motor.source->UpdateMotorState(motor.binding, motor.last_intensity);
-      }
+      // unchanged effects only need re-sending before the source's own duration runs out
+      if (!pad.IsVibrating() || dt < VIBRATION_REFRESH_INTERVAL_SECONDS)
+        continue;
     }
+
+    SendPadVibration(pad, current_time);
   }
 }
 
@@ -1652,7 +1716,10 @@ void InputManager::ApplyMacroButton(u32 pad, const MacroButton& mb)
 
   const float value = mb.toggle_state ? 1.0f : 0.0f;
   for (const u32 btn : mb.buttons)
-    controller->SetBindState(btn, value);
+  {
+    if (!InputMovie::InterceptBindState(pad, btn, value) && !Netplay::InterceptBindState(pad, btn, value))
+      controller->SetBindState(btn, value);
+  }
 }
 
 void InputManager::UpdateMacroButtons()
@@ -1791,6 +1858,10 @@ void InputManager::CloseSources()
 
 void InputManager::PollSources()
 {
+  if (!s_deferred_events.empty())
+    ProcessDeferredEvents();
+
+  s_last_poll_time = Common::Timer::GetCurrentValue();
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1803,8 +1874,25 @@ void InputManager::PollSources()
   {
     UpdateMacroButtons();
     if (!s_pad_vibration_array.empty())
-      UpdateContinuedVibration();
+      UpdateVibration();
+  }
+}
+
+void InputManager::PollSourcesForControllerRead()
+{
+  // Games can read the pad several times a frame, limit it to 1KHz so we're not hammering the device APIs.
+  const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+  if (Common::Timer::ConvertValueToMilliseconds(current_time - s_last_poll_time) < 1.0)
+    return;
+
+  s_last_poll_time = current_time;
+  s_polling_for_controller_read = true;
+  for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+  {
+    if (s_input_sources[i])
+      s_input_sources[i]->PollEvents();
   }
+  s_polling_for_controller_read = false;
 }
 
 std::vector<std::pair<std::string, std::string>> InputManager::EnumerateDevices()
@@ -170,8 +170,12 @@ enum class InputPointerAxis : u8
 class InputSource;
 
 namespace InputManager {
-/// Minimum interval between vibration updates when the effect is continuous.
-static constexpr double VIBRATION_UPDATE_INTERVAL_SECONDS = 0.5; // 500ms
+/// Minimum interval between vibration updates to a single pad. Games can change the motors on every poll, and each
+/// update is a HID write, which is slow over Bluetooth.
+static constexpr double VIBRATION_MIN_UPDATE_INTERVAL_SECONDS = 1.0 / 60.0;
+
+/// Interval between refreshes of an unchanged effect, so it outlasts SDL's maximum rumble duration of ~65 seconds.
+static constexpr double VIBRATION_REFRESH_INTERVAL_SECONDS = 30.0;
 
 /// Maximum number of host mouse devices.
 static constexpr u32 MAX_POINTER_DEVICES = 1;
@@ -268,6 +272,10 @@ void CloseSources();
 /// Polls input sources for events (e.g. external controllers).
 void PollSources();
 
+/// Polls input sources again when the game is about to read a controller, at most once per millisecond. Only events
+/// which are exclusively bound to controllers are applied immediately, the rest wait for the next PollSources().
+void PollSourcesForControllerRead();
+
 /// Returns true if any bindings exist for the specified key.
 /// Can be safely called on another thread.
 bool HasAnyBindingsForKey(InputBindingKey key);
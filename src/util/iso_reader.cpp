@@ -11,6 +11,7 @@
 #include "fmt/format.h"
 
 #include <cctype>
+#include <cstring>
 
 Log_SetChannel(IsoReader);
 
@@ -28,6 +29,7 @@ bool IsoReader::Open(CDImage* image, u32 track_number, Error* error)
 {
   m_image = image;
   m_track_number = track_number;
+  m_directory_cache.clear();
 
   if (!ReadPVD(error))
     return false;
@@ -84,16 +86,51 @@ bool IsoReader::ReadPVD(Error* error)
 
 std::optional<IsoReader::ISODirectoryEntry> IsoReader::LocateFile(std::string_view path, Error* error)
 {
-  const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
-  if (path.empty() || path == "/" || path == "\\")
+  // start at the root directory
+  ISODirectoryEntry current_de;
+  std::memcpy(&current_de, m_pvd.root_directory_entry, sizeof(current_de));
+
+  size_t pos = 0;
+  while (pos < path.length())
   {
-    // locating the root directory
-    return *root_de;
+    // skip over any slashes, there's no need to handle leading/repeated ones specially
+    if (path[pos] == '/' || path[pos] == '\\')
+    {
+      pos++;
+      continue;
+    }
+
+    size_t component_length = 0;
+    while ((pos + component_length) < path.length() && path[pos + component_length] != '/' &&
+           path[pos + component_length] != '\\')
+    {
+      component_length++;
+    }
+
+    const std::string_view path_component = path.substr(pos, component_length);
+    pos += component_length;
+
+    if (!current_de.IsDirectory())
+    {
+      Error::SetString(error, fmt::format("Looking for '{}' in '{}', but it is a file", path_component, path));
+      return std::nullopt;
+    }
+
+    const CachedDirectory* dir = GetDirectory(current_de, error);
+    if (!dir)
+      return std::nullopt;
+
+    const auto iter = dir->lookup.find(GetLookupKey(path_component));
+    if (iter == dir->lookup.end())
+    {
+      Error::SetString(error, fmt::format("Path component '{}' not found", path_component));
+      return std::nullopt;
+    }
+
+    current_de = dir->entries[iter->second].second;
   }
 
-  // start at the root directory
-  u8 sector_buffer[SECTOR_SIZE];
-  return LocateFile(path, sector_buffer, root_de->location_le, root_de->length_le, error);
+  return current_de;
 }
 
 std::string_view IsoReader::GetDirectoryEntryFileName(const u8* sector, u32 de_sector_offset)
@@ -125,144 +162,98 @@ std::string_view IsoReader::GetDirectoryEntryFileName(const u8* sector, u32 de_s
   return std::string_view(str, length_without_version);
 }
 
-std::optional<IsoReader::ISODirectoryEntry> IsoReader::LocateFile(std::string_view path, u8* sector_buffer,
-                                                                  u32 directory_record_lba, u32 directory_record_size,
-                                                                  Error* error)
+std::string IsoReader::GetLookupKey(std::string_view name)
 {
-  if (directory_record_size == 0)
-  {
-    Error::SetString(error, fmt::format("Directory entry record size 0 while looking for '{}'", path));
-    return std::nullopt;
-  }
-
-  // strip any leading slashes
-  size_t path_component_start = 0;
-  while (path_component_start < path.length() &&
-         (path[path_component_start] == '/' || path[path_component_start] == '\\'))
-  {
-    path_component_start++;
-  }
+  std::string ret(name);
+  for (char& ch : ret)
+    ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+  return ret;
+}
 
-  size_t path_component_length = 0;
-  while ((path_component_start + path_component_length) < path.length() &&
-         path[path_component_start + path_component_length] != '/' &&
-         path[path_component_start + path_component_length] != '\\')
-  {
-    path_component_length++;
-  }
+const IsoReader::CachedDirectory* IsoReader::GetDirectory(const ISODirectoryEntry& de, Error* error)
+{
+  auto iter = m_directory_cache.find(de.location_le);
+  if (iter != m_directory_cache.end())
+    return &iter->second;
 
-  const std::string_view path_component = path.substr(path_component_start, path_component_length);
-  if (path_component.empty())
+  if (de.length_le == 0)
   {
-    Error::SetString(error, fmt::format("Empty path component in {}", path));
-    return std::nullopt;
+    Error::SetString(error, fmt::format("Directory at LSN #{} has a record size of 0", de.location_le));
+    return nullptr;
   }
 
   // start reading directory entries
-  const u32 num_sectors = (directory_record_size + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
+  CachedDirectory dir;
+  const u32 num_sectors = de.GetSizeInSectors();
+  u8 sector_buffer[SECTOR_SIZE];
   for (u32 i = 0; i < num_sectors; i++)
   {
-    if (!ReadSector(sector_buffer, directory_record_lba + i, error))
-      return std::nullopt;
+    if (!ReadSector(sector_buffer, de.location_le + i, error))
+      return nullptr;
 
     u32 sector_offset = 0;
     while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
     {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      if (de->entry_length < sizeof(ISODirectoryEntry))
+      const ISODirectoryEntry* entry = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
+      if (entry->entry_length < sizeof(ISODirectoryEntry))
         break;
 
-      const std::string_view de_filename = GetDirectoryEntryFileName(sector_buffer, sector_offset);
-      sector_offset += de->entry_length;
+      const std::string_view entry_filename = GetDirectoryEntryFileName(sector_buffer, sector_offset);
+      sector_offset += entry->entry_length;
 
       // Empty file would be pretty strange..
-      if (de_filename.empty() || de_filename == "." || de_filename == "..")
+      if (entry_filename.empty() || entry_filename == "." || entry_filename == "..")
         continue;
 
-      if (de_filename.length() != path_component.length() ||
-          StringUtil::Strncasecmp(de_filename.data(), path_component.data(), path_component.length()) != 0)
-      {
-        continue;
-      }
-
-      // found it. is this the file we're looking for?
-      if ((path_component_start + path_component_length) == path.length())
-        return *de;
-
-      // if it is a directory, recurse into it
-      if (de->flags & ISODirectoryEntryFlag_Directory)
-      {
-        return LocateFile(path.substr(path_component_start + path_component_length), sector_buffer, de->location_le,
-                          de->length_le, error);
-      }
-
-      // we're looking for a directory but got a file
-      Error::SetString(error, fmt::format("Looking for directory '{}' but got file", path_component));
-      return std::nullopt;
+      // If there's duplicates, the first one wins, same as a linear search.
+      dir.lookup.emplace(GetLookupKey(entry_filename), dir.entries.size());
+      dir.entries.emplace_back(entry_filename, *entry);
     }
   }
 
-  Error::SetString(error, fmt::format("Path component '{}' not found", path_component));
-  return std::nullopt;
+  return &m_directory_cache.emplace(de.location_le, std::move(dir)).first->second;
 }
 
-std::vector<std::string> IsoReader::GetFilesInDirectory(std::string_view path, Error* error)
+std::optional<IsoReader::ISODirectoryEntry> IsoReader::LocateDirectory(std::string_view path, std::string* base_path,
+                                                                       Error* error)
 {
-  std::string base_path(path);
-  u32 directory_record_lsn;
-  u32 directory_record_length;
-  if (base_path.empty())
+  base_path->assign(path);
+  if (base_path->empty())
   {
     // root directory
-    const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
-    directory_record_lsn = root_de->location_le;
-    directory_record_length = root_de->length_le;
+    ISODirectoryEntry root_de;
+    std::memcpy(&root_de, m_pvd.root_directory_entry, sizeof(root_de));
+    return root_de;
   }
-  else
-  {
-    auto directory_de = LocateFile(base_path, error);
-    if (!directory_de.has_value())
-      return {};
-
-    if ((directory_de->flags & ISODirectoryEntryFlag_Directory) == 0)
-    {
-      Error::SetString(error, fmt::format("Path '{}' is not a directory, can't list", path));
-      return {};
-    }
-
-    directory_record_lsn = directory_de->location_le;
-    directory_record_length = directory_de->length_le;
 
-    if (base_path[base_path.size() - 1] != '/')
-      base_path += '/';
-  }
+  std::optional<ISODirectoryEntry> directory_de = LocateFile(path, error);
+  if (!directory_de.has_value())
+    return std::nullopt;
 
-  // start reading directory entries
-  const u32 num_sectors = (directory_record_length + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
-  std::vector<std::string> files;
-  u8 sector_buffer[SECTOR_SIZE];
-  for (u32 i = 0; i < num_sectors; i++)
+  if (!directory_de->IsDirectory())
   {
-    if (!ReadSector(sector_buffer, directory_record_lsn + i, error))
-      break;
+    Error::SetString(error, fmt::format("Path '{}' is not a directory, can't list", path));
+    return std::nullopt;
+  }
 
-    u32 sector_offset = 0;
-    while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
-    {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      if (de->entry_length < sizeof(ISODirectoryEntry))
-        break;
+  if (base_path->back() != '/')
+    base_path->push_back('/');
 
-      const std::string_view de_filename = GetDirectoryEntryFileName(sector_buffer, sector_offset);
-      sector_offset += de->entry_length;
+  return directory_de;
+}
 
-      // Empty file would be pretty strange..
-      if (de_filename.empty() || de_filename == "." || de_filename == "..")
-        continue;
+std::vector<std::string> IsoReader::GetFilesInDirectory(std::string_view path, Error* error)
+{
+  std::string base_path;
+  const std::optional<ISODirectoryEntry> directory_de = LocateDirectory(path, &base_path, error);
+  const CachedDirectory* dir = directory_de.has_value() ? GetDirectory(directory_de.value(), error) : nullptr;
+  if (!dir)
+    return {};
 
-      files.push_back(fmt::format("{}{}", base_path, de_filename));
-    }
-  }
+  std::vector<std::string> files;
+  files.reserve(dir->entries.size());
+  for (const auto& [name, entry] : dir->entries)
+    files.push_back(fmt::format("{}{}", base_path, name));
 
   return files;
 }
@@ -270,61 +261,16 @@ std::vector<std::string> IsoReader::GetFilesInDirectory(std::string_view path, E
 std::vector<std::pair<std::string, IsoReader::ISODirectoryEntry>>
 IsoReader::GetEntriesInDirectory(std::string_view path, Error* error /*= nullptr*/)
 {
-  std::string base_path(path);
-  u32 directory_record_lsn;
-  u32 directory_record_length;
-  if (base_path.empty())
-  {
-    // root directory
-    const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
-    directory_record_lsn = root_de->location_le;
-    directory_record_length = root_de->length_le;
-  }
-  else
-  {
-    auto directory_de = LocateFile(base_path, error);
-    if (!directory_de.has_value())
-      return {};
+  std::string base_path;
+  const std::optional<ISODirectoryEntry> directory_de = LocateDirectory(path, &base_path, error);
+  const CachedDirectory* dir = directory_de.has_value() ? GetDirectory(directory_de.value(), error) : nullptr;
+  if (!dir)
+    return {};
 
-    if ((directory_de->flags & ISODirectoryEntryFlag_Directory) == 0)
-    {
-      Error::SetString(error, fmt::format("Path '{}' is not a directory, can't list", path));
-      return {};
-    }
-
-    directory_record_lsn = directory_de->location_le;
-    directory_record_length = directory_de->length_le;
-
-    if (base_path[base_path.size() - 1] != '/')
-      base_path += '/';
-  }
-
-  // start reading directory entries
-  const u32 num_sectors = (directory_record_length + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
   std::vector<std::pair<std::string, IsoReader::ISODirectoryEntry>> files;
-  u8 sector_buffer[SECTOR_SIZE];
-  for (u32 i = 0; i < num_sectors; i++)
-  {
-    if (!ReadSector(sector_buffer, directory_record_lsn + i, error))
-      break;
-
-    u32 sector_offset = 0;
-    while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
-    {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      if (de->entry_length < sizeof(ISODirectoryEntry))
-        break;
-
-      const std::string_view de_filename = GetDirectoryEntryFileName(sector_buffer, sector_offset);
-      sector_offset += de->entry_length;
-
-      // Empty file would be pretty strange..
-      if (de_filename.empty() || de_filename == "." || de_filename == "..")
-        continue;
-
-      files.emplace_back(fmt::format("{}{}", base_path, de_filename), *de);
-    }
-  }
+  files.reserve(dir->entries.size());
+  for (const auto& [name, entry] : dir->entries)
+    files.emplace_back(fmt::format("{}{}", base_path, name), entry);
 
   return files;
 }
@@ -8,6 +8,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CDImage;
@@ -162,17 +163,30 @@ public:
   bool ReadFile(const ISODirectoryEntry& de, std::vector<u8>* data, Error* error = nullptr);
 
 private:
+  /// Parsed contents of a directory, with names converted to upper case for lookups.
+  struct CachedDirectory
+  {
+    std::vector<std::pair<std::string, ISODirectoryEntry>> entries;
+    std::unordered_map<std::string, size_t> lookup;
+  };
+
   static std::string_view GetDirectoryEntryFileName(const u8* sector, u32 de_sector_offset);
+  static std::string GetLookupKey(std::string_view name);
 
   bool ReadSector(u8* buf, u32 lsn, Error* error);
   bool ReadPVD(Error* error);
 
-  std::optional<ISODirectoryEntry> LocateFile(std::string_view path, u8* sector_buffer, u32 directory_record_lba,
-                                              u32 directory_record_size, Error* error);
+  /// Returns the entries for a directory, reading them from the disc the first time it is accessed.
+  const CachedDirectory* GetDirectory(const ISODirectoryEntry& de, Error* error);
 
-  CDImage* m_image;
-  u32 m_track_number;
+  std::optional<ISODirectoryEntry> LocateDirectory(std::string_view path, std::string* base_path, Error* error);
+
+  CDImage* m_image = nullptr;
+  u32 m_track_number = 0;
 
   ISOPrimaryVolumeDescriptor m_pvd = {};
   u32 m_pvd_lba = 0;
+
+  // Keyed by the LBA of the directory record.
+  std::unordered_map<u32, CachedDirectory> m_directory_cache;
 };
@@ -256,6 +256,7 @@ void JitCodeBuffer::Destroy()
   m_free_far_code_ptr = nullptr;
   m_far_code_size = 0;
   m_far_code_used = 0;
+  m_generations_enabled = false;
   m_total_size = 0;
   m_guard_size = 0;
   m_old_protection = 0;
@@ -282,7 +283,7 @@ void JitCodeBuffer::CommitCode(u32 length)
   FlushInstructionCache(m_free_code_ptr, length);
 #endif
 
-  Assert(length <= (m_code_size - m_code_used));
+  Assert(length <= (GetCodeLimit() - m_code_used));
   m_free_code_ptr += length;
   m_code_used += length;
 }
@@ -297,7 +298,7 @@ void JitCodeBuffer::CommitFarCode(u32 length)
   FlushInstructionCache(m_free_far_code_ptr, length);
 #endif
 
-  Assert(length <= (m_far_code_size - m_far_code_used));
+  Assert(length <= (GetFarCodeLimit() - m_far_code_used));
   m_free_far_code_ptr += length;
   m_far_code_used += length;
 }
@@ -306,6 +307,7 @@ void JitCodeBuffer::Reset()
 {
   MemMap::BeginCodeWrite();
 
+  m_generations_enabled = false;
   m_free_code_ptr = m_code_ptr + m_guard_size + m_code_reserve_size;
   m_code_used = 0;
   std::memset(m_free_code_ptr, 0, m_code_size);
@@ -322,6 +324,52 @@ void JitCodeBuffer::Reset()
   MemMap::EndCodeWrite();
 }
 
+void JitCodeBuffer::EnableGenerations()
+{
+  m_code_generation_base = m_code_used;
+  m_far_code_generation_base = m_far_code_used;
+  m_current_generation = 0;
+  m_generations_enabled = true;
+  UpdateGenerationRange();
+}
+
+bool JitCodeBuffer::SwitchGeneration()
+{
+  if (!m_generations_enabled)
+    return false;
+
+  m_current_generation ^= 1;
+  UpdateGenerationRange();
+
+  m_code_used = m_code_generation_start;
+  m_free_code_ptr = GetCodeBase() + m_code_used;
+  m_far_code_used = m_far_code_generation_start;
+  m_free_far_code_ptr = m_far_code_ptr + m_far_code_used;
+  return true;
+}
+
+void JitCodeBuffer::UpdateGenerationRange()
+{
+  // second generation gets any odd bytes at the end
+  const u32 code_half = (m_code_size - m_code_generation_base) / 2;
+  m_code_generation_start = m_code_generation_base + (code_half * m_current_generation);
+  m_code_generation_end = m_current_generation ? m_code_size : (m_code_generation_base + code_half);
+
+  const u32 far_code_half = (m_far_code_size - m_far_code_generation_base) / 2;
+  m_far_code_generation_start = m_far_code_generation_base + (far_code_half * m_current_generation);
+  m_far_code_generation_end =
+    m_current_generation ? m_far_code_size : (m_far_code_generation_base + far_code_half);
+}
+
+bool JitCodeBuffer::IsInCurrentGeneration(const void* ptr) const
+{
+  const u8* bptr = static_cast<const u8*>(ptr);
+  const u8* code_base = GetCodeBase();
+  return ((bptr >= (code_base + m_code_generation_start) && bptr < (code_base + m_code_generation_end)) ||
+          (bptr >= (m_far_code_ptr + m_far_code_generation_start) &&
+           bptr < (m_far_code_ptr + m_far_code_generation_end)));
+}
+
 void JitCodeBuffer::Align(u32 alignment, u8 padding_value)
 {
   DebugAssert(Common::IsPow2(alignment));
@@ -32,14 +32,25 @@ public:
   ALWAYS_INLINE u32 GetTotalUsed() const { return m_code_used + m_far_code_used; }
 
   ALWAYS_INLINE u8* GetFreeCodePointer() const { return m_free_code_ptr; }
-  ALWAYS_INLINE u32 GetFreeCodeSpace() const { return static_cast<u32>(m_code_size - m_code_used); }
+  ALWAYS_INLINE u32 GetFreeCodeSpace() const { return static_cast<u32>(GetCodeLimit() - m_code_used); }
   void ReserveCode(u32 size);
   void CommitCode(u32 length);
 
   ALWAYS_INLINE u8* GetFreeFarCodePointer() const { return m_free_far_code_ptr; }
-  ALWAYS_INLINE u32 GetFreeFarCodeSpace() const { return static_cast<u32>(m_far_code_size - m_far_code_used); }
+  ALWAYS_INLINE u32 GetFreeFarCodeSpace() const { return static_cast<u32>(GetFarCodeLimit() - m_far_code_used); }
   void CommitFarCode(u32 length);
 
+  /// Splits the remaining near and far code space into two generations, which are filled in turn.
+  /// Anything committed before this call (e.g. dispatchers) is never reused. Reset() merges the generations again.
+  void EnableGenerations();
+
+  /// Moves allocation to the start of the other generation, so its code can be overwritten. The caller must drop
+  /// everything which points into it first. Returns false if generations are not enabled.
+  bool SwitchGeneration();
+
+  /// Returns true if the pointer is inside the near or far code of the generation currently being filled.
+  bool IsInCurrentGeneration(const void* ptr) const;
+
   /// Adjusts the free code pointer to the specified alignment, padding with bytes.
   /// Assumes alignment is a power-of-two.
   void Align(u32 alignment, u8 padding_value);
@@ -48,6 +59,15 @@ public:
   static void FlushInstructionCache(void* address, u32 size);
 
 private:
+  ALWAYS_INLINE u32 GetCodeLimit() const { return m_generations_enabled ? m_code_generation_end : m_code_size; }
+  ALWAYS_INLINE u32 GetFarCodeLimit() const
+  {
+    return m_generations_enabled ? m_far_code_generation_end : m_far_code_size;
+  }
+  ALWAYS_INLINE u8* GetCodeBase() const { return m_code_ptr + m_guard_size + m_code_reserve_size; }
+
+  void UpdateGenerationRange();
+
   bool TryAllocateAt(const void* addr);
 
   u8* m_code_ptr = nullptr;
@@ -61,6 +81,16 @@ private:
   u32 m_far_code_size = 0;
   u32 m_far_code_used = 0;
 
+  // generations are offsets relative to the start of near/far code
+  u32 m_code_generation_base = 0;
+  u32 m_code_generation_start = 0;
+  u32 m_code_generation_end = 0;
+  u32 m_far_code_generation_base = 0;
+  u32 m_far_code_generation_start = 0;
+  u32 m_far_code_generation_end = 0;
+  u8 m_current_generation = 0;
+  bool m_generations_enabled = false;
+
   u32 m_total_size = 0;
   u32 m_guard_size = 0;
   u32 m_old_protection = 0;
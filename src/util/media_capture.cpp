@@ -0,0 +1,569 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "media_capture.h"
+#include "host.h"
+#include "wav_writer.h"
+
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "common/threading.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#else
+#include <csignal>
+#include <pthread.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+Log_SetChannel(MediaCapture);
+
+static constexpr const std::array s_encoder_names = {
+  "Software", "NVENC", "AMF", "QSV", "VideoToolbox", "VAAPI",
+};
+static constexpr const std::array s_encoder_display_names = {
+  TRANSLATE_NOOP("MediaCapture", "Software (x264)"),
+  TRANSLATE_NOOP("MediaCapture", "NVIDIA NVENC"),
+  TRANSLATE_NOOP("MediaCapture", "AMD AMF"),
+  TRANSLATE_NOOP("MediaCapture", "Intel Quick Sync"),
+  TRANSLATE_NOOP("MediaCapture", "Apple VideoToolbox"),
+  TRANSLATE_NOOP("MediaCapture", "VA-API"),
+};
+static constexpr const std::array s_encoder_codec_names = {
+  "libx264", "h264_nvenc", "h264_amf", "h264_qsv", "h264_videotoolbox", "h264_vaapi",
+};
+static_assert(s_encoder_names.size() == static_cast<size_t>(MediaCaptureEncoder::Count));
+
+static constexpr u32 AUDIO_BITRATE = 192;
+static constexpr u32 MAX_FREE_VIDEO_BUFFERS = 4;
+
+/// A child FFmpeg process, optionally with its standard input connected to a pipe.
+struct MediaCapture::Process
+{
+  ~Process();
+
+  bool Start(const std::string& exe, const std::vector<std::string>& args, bool pipe_input, Error* error);
+  bool Write(const void* data, size_t size);
+  void CloseInput();
+
+  /// Waits for the process to exit, and returns its exit code, or -1 if it could not be retrieved.
+  int Wait();
+
+#ifdef _WIN32
+  HANDLE process = NULL;
+  HANDLE input = NULL;
+#else
+  pid_t pid = -1;
+  int input = -1;
+#endif
+};
+
+MediaCapture::Process::~Process()
+{
+  CloseInput();
+  Wait();
+}
+
+#ifdef _WIN32
+
+static void AppendQuotedArgument(std::string* cmdline, std::string_view arg)
+{
+  if (!cmdline->empty())
+    cmdline->push_back(' ');
+
+  if (!arg.empty() && arg.find_first_of(" \t\"") == std::string_view::npos)
+  {
+    cmdline->append(arg);
+    return;
+  }
+
+  // Backslashes only need escaping when they precede a quote.
+  cmdline->push_back('"');
+  size_t num_backslashes = 0;
+  for (const char ch : arg)
+  {
+    if (ch == '\\')
+    {
+      num_backslashes++;
+      continue;
+    }
+
+    cmdline->append((ch == '"') ? (num_backslashes * 2 + 1) : num_backslashes, '\\');
+    cmdline->push_back(ch);
+    num_backslashes = 0;
+  }
+  cmdline->append(num_backslashes * 2, '\\');
+  cmdline->push_back('"');
+}
+
+bool MediaCapture::Process::Start(const std::string& exe, const std::vector<std::string>& args, bool pipe_input,
+                                  Error* error)
+{
+  std::string cmdline;
+  AppendQuotedArgument(&cmdline, exe);
+  for (const std::string& arg : args)
+    AppendQuotedArgument(&cmdline, arg);
+
+  SECURITY_ATTRIBUTES sa = {sizeof(sa), nullptr, TRUE};
+  HANDLE read_handle = NULL;
+  if (pipe_input)
+  {
+    if (!CreatePipe(&read_handle, &input, &sa, 0))
+    {
+      Error::SetWin32(error, "CreatePipe() failed: ", GetLastError());
+      return false;
+    }
+
+    // Only the read end is passed to the child.
+    SetHandleInformation(input, HANDLE_FLAG_INHERIT, 0);
+  }
+
+  STARTUPINFOW si = {};
+  si.cb = sizeof(si);
+  si.dwFlags = STARTF_USESTDHANDLES;
+  si.hStdInput = pipe_input ? read_handle : GetStdHandle(STD_INPUT_HANDLE);
+  si.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+  si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+  PROCESS_INFORMATION pi = {};
+  std::wstring wcmdline = StringUtil::UTF8StringToWideString(cmdline);
+  const BOOL result =
+    CreateProcessW(nullptr, wcmdline.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi);
+  if (read_handle)
+    CloseHandle(read_handle);
+  if (!result)
+  {
+    Error::SetWin32(error, "CreateProcessW() failed: ", GetLastError());
+    CloseInput();
+    return false;
+  }
+
+  CloseHandle(pi.hThread);
+  process = pi.hProcess;
+  return true;
+}
+
+bool MediaCapture::Process::Write(const void* data, size_t size)
+{
+  const u8* ptr = static_cast<const u8*>(data);
+  while (size > 0)
+  {
+    DWORD written;
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1024 * 1024 * 1024));
+    if (!WriteFile(input, ptr, chunk, &written, nullptr))
+      return false;
+
+    ptr += written;
+    size -= written;
+  }
+
+  return true;
+}
+
+void MediaCapture::Process::CloseInput()
+{
+  if (!input)
+    return;
+
+  CloseHandle(input);
+  input = NULL;
+}
+
+int MediaCapture::Process::Wait()
+{
+  if (!process)
+    return -1;
+
+  DWORD exit_code;
+  WaitForSingleObject(process, INFINITE);
+  if (!GetExitCodeProcess(process, &exit_code))
+    exit_code = static_cast<DWORD>(-1);
+
+  CloseHandle(process);
+  process = NULL;
+  return static_cast<int>(exit_code);
+}
+
+#else
+
+bool MediaCapture::Process::Start(const std::string& exe, const std::vector<std::string>& args, bool pipe_input,
+                                  Error* error)
+{
+  int fds[2];
+  if (pipe_input && pipe(fds) != 0)
+  {
+    Error::SetErrno(error, "pipe() failed: ", errno);
+    return false;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (pipe_input)
+  {
+    posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+  }
+
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 2);
+  argv.push_back(const_cast<char*>(exe.c_str()));
+  for (const std::string& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  const int res = posix_spawnp(&pid, exe.c_str(), &actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  if (pipe_input)
+    close(fds[0]);
+  if (res != 0)
+  {
+    Error::SetErrno(error, "posix_spawnp() failed: ", res);
+    if (pipe_input)
+      close(fds[1]);
+    pid = -1;
+    return false;
+  }
+
+  input = pipe_input ? fds[1] : -1;
+  return true;
+}
+
+bool MediaCapture::Process::Write(const void* data, size_t size)
+{
+  const u8* ptr = static_cast<const u8*>(data);
+  while (size > 0)
+  {
+    const ssize_t written = write(input, ptr, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    ptr += written;
+    size -= static_cast<size_t>(written);
+  }
+
+  return true;
+}
+
+void MediaCapture::Process::CloseInput()
+{
+  if (input < 0)
+    return;
+
+  close(input);
+  input = -1;
+}
+
+int MediaCapture::Process::Wait()
+{
+  if (pid < 0)
+    return -1;
+
+  int status;
+  pid_t res;
+  while ((res = waitpid(pid, &status, 0)) < 0 && errno == EINTR)
+    ;
+
+  pid = -1;
+  return (res >= 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+}
+
+#endif
+
+MediaCapture::MediaCapture() = default;
+
+MediaCapture::~MediaCapture()
+{
+  if (m_worker_thread.joinable())
+    EndCapture(nullptr);
+}
+
+std::optional<MediaCaptureEncoder> MediaCapture::ParseEncoderName(const char* str)
+{
+  int index = 0;
+  for (const char* name : s_encoder_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<MediaCaptureEncoder>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* MediaCapture::GetEncoderName(MediaCaptureEncoder encoder)
+{
+  return s_encoder_names[static_cast<size_t>(encoder)];
+}
+
+const char* MediaCapture::GetEncoderDisplayName(MediaCaptureEncoder encoder)
+{
+  return Host::TranslateToCString("MediaCapture", s_encoder_display_names[static_cast<size_t>(encoder)]);
+}
+
+std::unique_ptr<MediaCapture> MediaCapture::Create(std::string path, std::string ffmpeg_path,
+                                                   MediaCaptureEncoder encoder, u32 video_bitrate, u32 width,
+                                                   u32 height, float frame_rate, u32 sample_rate,
+                                                   bool flip_vertically, Error* error)
+{
+  std::unique_ptr<MediaCapture> cap(new MediaCapture());
+  cap->m_path = std::move(path);
+  cap->m_ffmpeg_path = std::move(ffmpeg_path);
+  cap->m_video_path = cap->m_path + ".video.mkv";
+  cap->m_audio_path = cap->m_path + ".audio.wav";
+  cap->m_width = width;
+  cap->m_height = height;
+
+  cap->m_audio_writer = std::make_unique<WAVWriter>();
+  if (!cap->m_audio_writer->Open(cap->m_audio_path.c_str(), sample_rate, 2))
+  {
+    Error::SetStringFmt(error, "Failed to open '{}' for writing.", cap->m_audio_path);
+    return {};
+  }
+
+  if (!cap->StartEncoder(encoder, video_bitrate, frame_rate, flip_vertically, error))
+  {
+    cap->m_audio_writer->Close();
+    FileSystem::DeleteFile(cap->m_audio_path.c_str());
+    return {};
+  }
+
+  cap->m_worker_thread = std::thread(&MediaCapture::WorkerThreadEntryPoint, cap.get());
+  return cap;
+}
+
+bool MediaCapture::StartEncoder(MediaCaptureEncoder encoder, u32 video_bitrate, float frame_rate,
+                                bool flip_vertically, Error* error)
+{
+  const bool vaapi = (encoder == MediaCaptureEncoder::VAAPI);
+
+  std::vector<std::string> args = {"-hide_banner", "-loglevel", "error", "-y"};
+  if (vaapi)
+    args.insert(args.end(), {"-vaapi_device", "/dev/dri/renderD128"});
+
+  // Frames are always converted to RGBA8 before being written.
+  args.insert(args.end(), {"-f", "rawvideo", "-pix_fmt", "rgba", "-s", fmt::format("{}x{}", m_width, m_height),
+                           "-framerate", fmt::format("{:.4f}", frame_rate), "-i", "-"});
+
+  std::string filters;
+  if (flip_vertically)
+    filters = "vflip";
+  if (vaapi)
+    filters.append(filters.empty() ? "format=nv12,hwupload" : ",format=nv12,hwupload");
+  if (!filters.empty())
+    args.insert(args.end(), {"-vf", std::move(filters)});
+
+  args.insert(args.end(), {"-c:v", s_encoder_codec_names[static_cast<size_t>(encoder)], "-b:v",
+                           fmt::format("{}k", video_bitrate)});
+  if (!vaapi)
+    args.insert(args.end(), {"-pix_fmt", (encoder == MediaCaptureEncoder::Software) ? "yuv420p" : "nv12"});
+  args.insert(args.end(), {"-an", m_video_path});
+
+  Log_InfoFmt("Starting {} encoder for {}x{} @ {:.2f} fps capture to '{}'", GetEncoderName(encoder), m_width,
+              m_height, frame_rate, m_path);
+
+  m_process = std::make_unique<Process>();
+  if (!m_process->Start(m_ffmpeg_path, args, true, error))
+  {
+    m_process.reset();
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<u32> MediaCapture::GetVideoFrameBuffer()
+{
+  std::unique_lock lock(m_mutex);
+  if (m_free_video_buffers.empty())
+    return {};
+
+  std::vector<u32> ret = std::move(m_free_video_buffers.back());
+  m_free_video_buffers.pop_back();
+  return ret;
+}
+
+bool MediaCapture::DeliverVideoFrame(std::vector<u32> pixels, u32 stride, GPUTexture::Format format)
+{
+  const size_t size = pixels.size() * sizeof(u32);
+
+  std::unique_lock lock(m_mutex);
+  if (m_failed)
+    return false;
+
+  // Dropping frames would throw off the timing, so wait for the encoder to catch up instead.
+  if (m_queued_video_bytes > 0 && (m_queued_video_bytes + size) > MAX_QUEUED_VIDEO_BYTES)
+  {
+    Log_WarningPrint("Encoder is falling behind, waiting for it to catch up.");
+    m_done_cv.wait(lock, [this, size]() {
+      return m_failed || m_queued_video_bytes == 0 || (m_queued_video_bytes + size) <= MAX_QUEUED_VIDEO_BYTES;
+    });
+    if (m_failed)
+      return false;
+  }
+
+  m_queued_video_bytes += size;
+  m_video_queue.push_back(VideoFrame{std::move(pixels), stride, format});
+  m_work_cv.notify_one();
+  return true;
+}
+
+void MediaCapture::DeliverAudioFrames(const s16* frames, u32 num_frames)
+{
+  std::unique_lock lock(m_mutex);
+  m_audio_queue.insert(m_audio_queue.end(), frames, frames + num_frames * 2);
+  m_work_cv.notify_one();
+}
+
+void MediaCapture::WorkerThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Media Capture");
+
+#ifndef _WIN32
+  // If FFmpeg exits early, writes should fail with EPIPE, instead of raising SIGPIPE.
+  sigset_t sigpipe_set;
+  sigemptyset(&sigpipe_set);
+  sigaddset(&sigpipe_set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &sigpipe_set, nullptr);
+#endif
+
+  std::vector<s16> audio_samples;
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_work_cv.wait(lock,
+                   [this]() { return m_worker_shutdown || !m_video_queue.empty() || !m_audio_queue.empty(); });
+
+    if (!m_audio_queue.empty())
+    {
+      audio_samples.swap(m_audio_queue);
+      lock.unlock();
+      m_audio_writer->WriteFrames(audio_samples.data(), static_cast<u32>(audio_samples.size() / 2));
+      audio_samples.clear();
+      lock.lock();
+    }
+
+    if (!m_video_queue.empty())
+    {
+      VideoFrame frame = std::move(m_video_queue.front());
+      m_video_queue.pop_front();
+      const size_t size = frame.pixels.size() * sizeof(u32);
+      const bool failed = m_failed;
+      lock.unlock();
+
+      const bool result = failed || WriteVideoFrame(frame);
+
+      lock.lock();
+      if (!result && !m_failed)
+      {
+        m_failed = true;
+        m_failure_reason = "Failed to write frame to the encoder, check that FFmpeg is installed and supports the "
+                           "selected encoder.";
+        Log_ErrorPrint(m_failure_reason.c_str());
+      }
+
+      m_queued_video_bytes -= size;
+      if (m_free_video_buffers.size() < MAX_FREE_VIDEO_BUFFERS)
+        m_free_video_buffers.push_back(std::move(frame.pixels));
+      m_done_cv.notify_all();
+      continue;
+    }
+
+    if (m_worker_shutdown)
+      break;
+  }
+}
+
+bool MediaCapture::WriteVideoFrame(VideoFrame& frame)
+{
+  if (!GPUTexture::ConvertTextureDataToRGBA8(m_width, m_height, frame.pixels, frame.stride, frame.format))
+    return false;
+
+  const u32 row_size = m_width * sizeof(u32);
+  if (frame.stride == row_size)
+    return m_process->Write(frame.pixels.data(), row_size * m_height);
+
+  const u8* row_ptr = reinterpret_cast<const u8*>(frame.pixels.data());
+  for (u32 row = 0; row < m_height; row++, row_ptr += frame.stride)
+  {
+    if (!m_process->Write(row_ptr, row_size))
+      return false;
+  }
+
+  return true;
+}
+
+bool MediaCapture::EndCapture(Error* error)
+{
+  {
+    std::unique_lock lock(m_mutex);
+    m_worker_shutdown = true;
+    m_work_cv.notify_one();
+  }
+  m_worker_thread.join();
+
+  m_process->CloseInput();
+  const int exit_code = m_process->Wait();
+  m_process.reset();
+  m_audio_writer->Close();
+
+  if (m_failed)
+  {
+    Error::SetString(error, std::move(m_failure_reason));
+    return false;
+  }
+  else if (exit_code != 0)
+  {
+    Error::SetStringFmt(error, "FFmpeg exited with code {}.", exit_code);
+    return false;
+  }
+
+  // Temporary files are left behind on failure, so the recording isn't lost.
+  if (!Mux(error))
+    return false;
+
+  FileSystem::DeleteFile(m_video_path.c_str());
+  FileSystem::DeleteFile(m_audio_path.c_str());
+  return true;
+}
+
+bool MediaCapture::Mux(Error* error)
+{
+  const std::vector<std::string> args = {"-hide_banner", "-loglevel", "error", "-y", "-i", m_video_path, "-i",
+                                         m_audio_path, "-map", "0:v:0", "-map", "1:a:0", "-c:v", "copy", "-c:a",
+                                         "aac", "-b:a", fmt::format("{}k", AUDIO_BITRATE), "-shortest", m_path};
+
+  Log_InfoFmt("Muxing capture to '{}'", m_path);
+
+  Process process;
+  if (!process.Start(m_ffmpeg_path, args, false, error))
+    return false;
+
+  const int exit_code = process.Wait();
+  if (exit_code != 0)
+  {
+    Error::SetStringFmt(error, "FFmpeg exited with code {} while muxing.", exit_code);
+    return false;
+  }
+
+  return true;
+}
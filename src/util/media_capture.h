@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "gpu_texture.h"
+
+#include "common/types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Error;
+class WAVWriter;
+
+enum class MediaCaptureEncoder : u8
+{
+  Software,
+  NVENC,
+  AMF,
+  QSV,
+  VideoToolbox,
+  VAAPI,
+  Count
+};
+
+/// Records video and audio to a file, by feeding raw frames to an FFmpeg process on a worker thread.
+/// Video is encoded as it is received. Audio is buffered to a temporary WAV file, and muxed in when the capture ends.
+class MediaCapture
+{
+public:
+  ~MediaCapture();
+
+  static std::optional<MediaCaptureEncoder> ParseEncoderName(const char* str);
+  static const char* GetEncoderName(MediaCaptureEncoder encoder);
+  static const char* GetEncoderDisplayName(MediaCaptureEncoder encoder);
+
+  /// Starts the encoder process. Frames must be width x height, and arrive at frame_rate.
+  static std::unique_ptr<MediaCapture> Create(std::string path, std::string ffmpeg_path, MediaCaptureEncoder encoder,
+                                              u32 video_bitrate, u32 width, u32 height, float frame_rate,
+                                              u32 sample_rate, bool flip_vertically, Error* error);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE u32 GetVideoWidth() const { return m_width; }
+  ALWAYS_INLINE u32 GetVideoHeight() const { return m_height; }
+
+  /// Returns a buffer for a video frame, reusing one which has already been encoded if possible.
+  std::vector<u32> GetVideoFrameBuffer();
+
+  /// Queues a frame for encoding. Blocks if the encoder has fallen too far behind. Returns false if it has failed.
+  bool DeliverVideoFrame(std::vector<u32> pixels, u32 stride, GPUTexture::Format format);
+
+  /// Queues interleaved stereo samples.
+  void DeliverAudioFrames(const s16* frames, u32 num_frames);
+
+  /// Waits for all queued frames to be encoded, and writes the final file.
+  bool EndCapture(Error* error);
+
+private:
+  /// Frames waiting for the encoder are capped at this size, beyond which the caller waits.
+  static constexpr size_t MAX_QUEUED_VIDEO_BYTES = 256 * 1024 * 1024;
+
+  struct VideoFrame
+  {
+    std::vector<u32> pixels;
+    u32 stride;
+    GPUTexture::Format format;
+  };
+
+  MediaCapture();
+
+  bool StartEncoder(MediaCaptureEncoder encoder, u32 video_bitrate, float frame_rate, bool flip_vertically,
+                    Error* error);
+  void WorkerThreadEntryPoint();
+  bool WriteVideoFrame(VideoFrame& frame);
+  bool Mux(Error* error);
+
+  std::string m_path;
+  std::string m_ffmpeg_path;
+  std::string m_video_path;
+  std::string m_audio_path;
+  u32 m_width = 0;
+  u32 m_height = 0;
+
+  struct Process;
+  std::unique_ptr<Process> m_process;
+  std::unique_ptr<WAVWriter> m_audio_writer;
+
+  std::thread m_worker_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::deque<VideoFrame> m_video_queue;
+  std::vector<std::vector<u32>> m_free_video_buffers;
+  std::vector<s16> m_audio_queue;
+  size_t m_queued_video_bytes = 0;
+  bool m_worker_shutdown = false;
+  bool m_failed = false;
+  std::string m_failure_reason;
+};
@@ -270,6 +270,7 @@ public:
   bool BeginPresent(bool skip_present) override;
   void EndPresent(bool explicit_submit) override;
   void SubmitPresent() override;
+  void FlushCommands() override;
 
   void WaitForFenceCounter(u64 counter);
 
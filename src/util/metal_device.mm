@@ -34,28 +34,32 @@ static constexpr u32 TEXTURE_UPLOAD_ALIGNMENT = 64;
 static constexpr u32 TEXTURE_UPLOAD_PITCH_ALIGNMENT = 64;
 
 static constexpr std::array<MTLPixelFormat, static_cast<u32>(GPUTexture::Format::MaxCount)> s_pixel_format_mapping = {
-  MTLPixelFormatInvalid,      // Unknown
-  MTLPixelFormatRGBA8Unorm,   // RGBA8
-  MTLPixelFormatBGRA8Unorm,   // BGRA8
-  MTLPixelFormatB5G6R5Unorm,  // RGB565
-  MTLPixelFormatA1BGR5Unorm,  // RGBA5551
-  MTLPixelFormatR8Unorm,      // R8
-  MTLPixelFormatDepth16Unorm, // D16
-  MTLPixelFormatR16Unorm,     // R16
-  MTLPixelFormatR16Sint,      // R16I
-  MTLPixelFormatR16Uint,      // R16U
-  MTLPixelFormatR16Float,     // R16F
-  MTLPixelFormatR32Sint,      // R32I
-  MTLPixelFormatR32Uint,      // R32U
-  MTLPixelFormatR32Float,     // R32F
-  MTLPixelFormatRG8Unorm,     // RG8
-  MTLPixelFormatRG16Unorm,    // RG16
-  MTLPixelFormatRG16Float,    // RG16F
-  MTLPixelFormatRG32Float,    // RG32F
-  MTLPixelFormatRGBA16Unorm,  // RGBA16
-  MTLPixelFormatRGBA16Float,  // RGBA16F
-  MTLPixelFormatRGBA32Float,  // RGBA32F
-  MTLPixelFormatBGR10A2Unorm, // RGB10A2
+  MTLPixelFormatInvalid,       // Unknown
+  MTLPixelFormatRGBA8Unorm,    // RGBA8
+  MTLPixelFormatBGRA8Unorm,    // BGRA8
+  MTLPixelFormatB5G6R5Unorm,   // RGB565
+  MTLPixelFormatA1BGR5Unorm,   // RGBA5551
+  MTLPixelFormatR8Unorm,       // R8
+  MTLPixelFormatDepth16Unorm,  // D16
+  MTLPixelFormatR16Unorm,      // R16
+  MTLPixelFormatR16Sint,       // R16I
+  MTLPixelFormatR16Uint,       // R16U
+  MTLPixelFormatR16Float,      // R16F
+  MTLPixelFormatR32Sint,       // R32I
+  MTLPixelFormatR32Uint,       // R32U
+  MTLPixelFormatR32Float,      // R32F
+  MTLPixelFormatRG8Unorm,      // RG8
+  MTLPixelFormatRG16Unorm,     // RG16
+  MTLPixelFormatRG16Float,     // RG16F
+  MTLPixelFormatRG32Float,     // RG32F
+  MTLPixelFormatRGBA16Unorm,   // RGBA16
+  MTLPixelFormatRGBA16Float,   // RGBA16F
+  MTLPixelFormatRGBA32Float,   // RGBA32F
+  MTLPixelFormatBGR10A2Unorm,  // RGB10A2
+  MTLPixelFormatBC1_RGBA,      // BC1
+  MTLPixelFormatBC2_RGBA,      // BC2
+  MTLPixelFormatBC3_RGBA,      // BC3
+  MTLPixelFormatBC7_RGBAUnorm, // BC7
 };
 
 static NSString* StringViewToNSString(std::string_view str)
@@ -249,6 +253,8 @@ void MetalDevice::SetFeatures(FeatureMask disabled_features)
   m_features.shader_cache = true;
   m_features.pipeline_cache = false;
   m_features.prefer_unused_textures = true;
+  m_features.threaded_shader_compile = false;
+  m_features.sparse_textures = false;
 }
 
 bool MetalDevice::LoadShaders()
@@ -1008,8 +1014,9 @@ MetalTexture::~MetalTexture()
 bool MetalTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch, u32 layer /*= 0*/,
                           u32 level /*= 0*/)
 {
-  const u32 aligned_pitch = Common::AlignUpPow2(width * GetPixelSize(), TEXTURE_UPLOAD_PITCH_ALIGNMENT);
-  const u32 req_size = height * aligned_pitch;
+  const u32 upload_rows = CalcUploadRows(height);
+  const u32 aligned_pitch = Common::AlignUpPow2(CalcUploadPitch(width), TEXTURE_UPLOAD_PITCH_ALIGNMENT);
+  const u32 req_size = upload_rows * aligned_pitch;
 
   GPUDevice::GetStatistics().buffer_streamed += req_size;
   GPUDevice::GetStatistics().num_uploads++;
@@ -1021,7 +1028,7 @@ bool MetalTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data,
   u32 actual_pitch;
   if (req_size >= (sb.GetCurrentSize() / 2u))
   {
-    const u32 upload_size = height * pitch;
+    const u32 upload_size = upload_rows * pitch;
     const MTLResourceOptions options = MTLResourceStorageModeShared;
     actual_buffer = [dev.GetMTLDevice() newBufferWithBytes:data length:upload_size options:options];
     actual_offset = 0;
@@ -1047,7 +1054,8 @@ bool MetalTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data,
     }
 
     actual_offset = sb.GetCurrentOffset();
-    StringUtil::StrideMemCpy(sb.GetCurrentHostPointer(), aligned_pitch, data, pitch, width * GetPixelSize(), height);
+    StringUtil::StrideMemCpy(sb.GetCurrentHostPointer(), aligned_pitch, data, pitch, CalcUploadPitch(width),
+                             upload_rows);
     sb.CommitMemory(req_size);
     actual_buffer = sb.GetBuffer();
     actual_pitch = aligned_pitch;
@@ -1487,6 +1495,12 @@ bool MetalDevice::SupportsTextureFormat(GPUTexture::Format format) const
     if (![m_device supportsFamily:MTLGPUFamilyApple2])
       return false;
   }
+  else if (GPUTexture::IsCompressedFormat(format))
+  {
+    // BC formats are only available on Macs, and Apple Silicon from macOS 11.
+    if (![m_device supportsBCTextureCompression])
+      return false;
+  }
 
   return (s_pixel_format_mapping[static_cast<u8>(format)] != MTLPixelFormatInvalid);
 }
@@ -2490,6 +2504,11 @@ void MetalDevice::SubmitPresent()
   Panic("Not supported by this API.");
 }
 
+void MetalDevice::FlushCommands()
+{
+  SubmitCommandBuffer(false);
+}
+
 void MetalDevice::CreateCommandBuffer()
 {
   @autoreleasepool
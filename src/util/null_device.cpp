@@ -0,0 +1,516 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "null_device.h"
+
+#include "common/assert.h"
+#include "common/log.h"
+#include "common/string_util.h"
+
+#include <algorithm>
+#include <cstring>
+
+Log_SetChannel(NullDevice);
+
+namespace {
+
+class NullSampler final : public GPUSampler
+{
+public:
+  void SetDebugName(std::string_view name) override {}
+};
+
+class NullShader final : public GPUShader
+{
+public:
+  explicit NullShader(GPUShaderStage stage) : GPUShader(stage) {}
+
+  void SetDebugName(std::string_view name) override {}
+};
+
+class NullPipeline final : public GPUPipeline
+{
+public:
+  void SetDebugName(std::string_view name) override {}
+};
+
+class NullTextureBuffer final : public GPUTextureBuffer
+{
+public:
+  NullTextureBuffer(Format format, u32 size_in_elements)
+    : GPUTextureBuffer(format, size_in_elements), m_buffer(GetSizeInBytes())
+  {
+  }
+
+  void* Map(u32 required_elements) override
+  {
+    DebugAssert(required_elements <= m_size_in_elements);
+    m_current_position = 0;
+    return m_buffer.data();
+  }
+
+  void Unmap(u32 used_elements) override {}
+
+  void SetDebugName(std::string_view name) override {}
+
+private:
+  DynamicHeapArray<u8> m_buffer;
+};
+
+} // namespace
+
+NullDevice::NullDevice() = default;
+
+NullDevice::~NullDevice() = default;
+
+RenderAPI NullDevice::GetRenderAPI() const
+{
+  return RenderAPI::None;
+}
+
+bool NullDevice::HasSurface() const
+{
+  return false;
+}
+
+void NullDevice::DestroySurface()
+{
+}
+
+bool NullDevice::UpdateWindow()
+{
+  return AcquireWindow(false);
+}
+
+GPUDevice::AdapterAndModeList NullDevice::GetAdapterAndModeList()
+{
+  return {};
+}
+
+void NullDevice::ResizeWindow(s32 new_window_width, s32 new_window_height, float new_window_scale)
+{
+  m_window_info.surface_width = static_cast<u32>(new_window_width);
+  m_window_info.surface_height = static_cast<u32>(new_window_height);
+  m_window_info.surface_scale = new_window_scale;
+}
+
+std::string NullDevice::GetDriverInfo() const
+{
+  return "Null Device (no rendering)";
+}
+
+bool NullDevice::CreateDevice(std::string_view adapter, bool threaded_presentation,
+                              std::optional<bool> exclusive_fullscreen_control, FeatureMask disabled_features,
+                              Error* error)
+{
+  // Nothing optional is supported, so the hardware renderer would have to take its slowest paths. It's not meant to
+  // be used with this device anyway, since draws are dropped.
+  m_features = {};
+  m_features.texture_copy_to_self = true;
+  m_max_texture_size = 16384;
+  m_max_multisamples = 1;
+  return true;
+}
+
+void NullDevice::DestroyDevice()
+{
+  m_vertex_buffer = {};
+  m_index_buffer = {};
+  m_uniform_buffer = {};
+}
+
+bool NullDevice::SupportsTextureFormat(GPUTexture::Format format) const
+{
+  return true;
+}
+
+std::unique_ptr<GPUTexture> NullDevice::CreateTexture(u32 width, u32 height, u32 layers, u32 levels, u32 samples,
+                                                      GPUTexture::Type type, GPUTexture::Format format,
+                                                      const void* data, u32 data_stride)
+{
+  if (!GPUTexture::ValidateConfig(width, height, layers, levels, samples, type, format))
+    return {};
+
+  std::unique_ptr<NullTexture> tex(new NullTexture(static_cast<u16>(width), static_cast<u16>(height),
+                                                   static_cast<u8>(layers), static_cast<u8>(levels),
+                                                   static_cast<u8>(samples), type, format));
+  if (data)
+    tex->Update(0, 0, width, height, data, data_stride, 0, 0);
+
+  return tex;
+}
+
+std::unique_ptr<GPUSampler> NullDevice::CreateSampler(const GPUSampler::Config& config)
+{
+  return std::make_unique<NullSampler>();
+}
+
+std::unique_ptr<GPUTextureBuffer> NullDevice::CreateTextureBuffer(GPUTextureBuffer::Format format,
+                                                                  u32 size_in_elements)
+{
+  return std::make_unique<NullTextureBuffer>(format, size_in_elements);
+}
+
+std::unique_ptr<GPUDownloadTexture> NullDevice::CreateDownloadTexture(u32 width, u32 height,
+                                                                      GPUTexture::Format format)
+{
+  const u32 pitch = GPUTexture::CalcUploadPitch(format, width);
+  std::unique_ptr<NullDownloadTexture> tex(new NullDownloadTexture(width, height, format, nullptr, pitch));
+  tex->m_buffer.resize(GPUDownloadTexture::GetBufferSize(width, height, format));
+  tex->m_memory = tex->m_buffer.data();
+  tex->m_map_pointer = tex->m_memory;
+  return tex;
+}
+
+std::unique_ptr<GPUDownloadTexture> NullDevice::CreateDownloadTexture(u32 width, u32 height,
+                                                                      GPUTexture::Format format, void* memory,
+                                                                      size_t memory_size, u32 memory_stride)
+{
+  if (memory_size < (static_cast<size_t>(memory_stride) * height))
+  {
+    Log_ErrorPrintf("Imported memory is too small (%zu bytes) for a %ux%u download texture with a stride of %u.",
+                    memory_size, width, height, memory_stride);
+    return {};
+  }
+
+  return std::unique_ptr<NullDownloadTexture>(
+    new NullDownloadTexture(width, height, format, static_cast<u8*>(memory), memory_stride));
+}
+
+void NullDevice::CopyTextureRegion(GPUTexture* dst, u32 dst_x, u32 dst_y, u32 dst_layer, u32 dst_level,
+                                   GPUTexture* src, u32 src_x, u32 src_y, u32 src_layer, u32 src_level, u32 width,
+                                   u32 height)
+{
+  NullTexture* const D = static_cast<NullTexture*>(dst);
+  NullTexture* const S = static_cast<NullTexture*>(src);
+  DebugAssert(D->GetFormat() == S->GetFormat());
+  DebugAssert((src_x + width) <= S->GetMipWidth(src_level) && (src_y + height) <= S->GetMipHeight(src_level));
+  DebugAssert((dst_x + width) <= D->GetMipWidth(dst_level) && (dst_y + height) <= D->GetMipHeight(dst_level));
+
+  s_stats.num_copies++;
+
+  S->CommitClear();
+  if (dst_x != 0 || dst_y != 0 || width != D->GetMipWidth(dst_level) || height != D->GetMipHeight(dst_level))
+    D->CommitClear();
+  D->SetState(GPUTexture::State::Dirty);
+
+  // memmove(), since copies within the same texture are allowed.
+  const u32 src_pitch = S->GetPitch(src_level);
+  const u32 dst_pitch = D->GetPitch(dst_level);
+  const u32 row_size = D->CalcUploadPitch(width);
+  const u32 rows = D->CalcUploadRows(height);
+  const u8* src_ptr = S->GetData(src_layer, src_level) + S->GetOffset(src_x, src_y, src_level);
+  u8* dst_ptr = D->GetData(dst_layer, dst_level) + D->GetOffset(dst_x, dst_y, dst_level);
+  if (dst_ptr > src_ptr)
+  {
+    for (u32 row = rows; row > 0; row--)
+      std::memmove(dst_ptr + (row - 1) * dst_pitch, src_ptr + (row - 1) * src_pitch, row_size);
+  }
+  else
+  {
+    for (u32 row = 0; row < rows; row++)
+      std::memmove(dst_ptr + row * dst_pitch, src_ptr + row * src_pitch, row_size);
+  }
+}
+
+void NullDevice::ResolveTextureRegion(GPUTexture* dst, u32 dst_x, u32 dst_y, u32 dst_layer, u32 dst_level,
+                                      GPUTexture* src, u32 src_x, u32 src_y, u32 width, u32 height)
+{
+  // Only one sample is stored, so a resolve is just a copy.
+  CopyTextureRegion(dst, dst_x, dst_y, dst_layer, dst_level, src, src_x, src_y, 0, 0, width, height);
+}
+
+std::unique_ptr<GPUPipeline> NullDevice::CreatePipeline(const GPUPipeline::GraphicsConfig& config)
+{
+  return std::make_unique<NullPipeline>();
+}
+
+std::unique_ptr<GPUShader> NullDevice::CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data)
+{
+  return std::make_unique<NullShader>(stage);
+}
+
+std::unique_ptr<GPUShader> NullDevice::CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
+                                                              const char* entry_point,
+                                                              DynamicHeapArray<u8>* out_binary)
+{
+  return std::make_unique<NullShader>(stage);
+}
+
+void NullDevice::PushDebugGroup(const char* name)
+{
+}
+
+void NullDevice::PopDebugGroup()
+{
+}
+
+void NullDevice::InsertDebugMessage(const char* msg)
+{
+}
+
+void NullDevice::MapVertexBuffer(u32 vertex_size, u32 vertex_count, void** map_ptr, u32* map_space,
+                                 u32* map_base_vertex)
+{
+  const size_t required = static_cast<size_t>(vertex_size) * vertex_count;
+  if (m_vertex_buffer.size() < required)
+    m_vertex_buffer.resize(required);
+
+  *map_ptr = m_vertex_buffer.data();
+  *map_space = static_cast<u32>(m_vertex_buffer.size() / vertex_size);
+  *map_base_vertex = 0;
+}
+
+void NullDevice::UnmapVertexBuffer(u32 vertex_size, u32 vertex_count)
+{
+  s_stats.buffer_streamed += vertex_size * vertex_count;
+}
+
+void NullDevice::MapIndexBuffer(u32 index_count, DrawIndex** map_ptr, u32* map_space, u32* map_base_index)
+{
+  const size_t required = sizeof(DrawIndex) * index_count;
+  if (m_index_buffer.size() < required)
+    m_index_buffer.resize(required);
+
+  *map_ptr = reinterpret_cast<DrawIndex*>(m_index_buffer.data());
+  *map_space = static_cast<u32>(m_index_buffer.size() / sizeof(DrawIndex));
+  *map_base_index = 0;
+}
+
+void NullDevice::UnmapIndexBuffer(u32 used_index_count)
+{
+  s_stats.buffer_streamed += sizeof(DrawIndex) * used_index_count;
+}
+
+void NullDevice::PushUniformBuffer(const void* data, u32 data_size)
+{
+  s_stats.buffer_streamed += data_size;
+}
+
+void* NullDevice::MapUniformBuffer(u32 size)
+{
+  if (m_uniform_buffer.size() < size)
+    m_uniform_buffer.resize(size);
+
+  return m_uniform_buffer.data();
+}
+
+void NullDevice::UnmapUniformBuffer(u32 size)
+{
+  s_stats.buffer_streamed += size;
+}
+
+void NullDevice::SetRenderTargets(GPUTexture* const* rts, u32 num_rts, GPUTexture* ds,
+                                  GPUPipeline::RenderPassFlag render_pass_flags)
+{
+  // Nothing gets drawn, but anything bound would be written in a real device. Commit pending clears so the contents
+  // match what a real device would read back when nothing else is drawn.
+  for (u32 i = 0; i < num_rts; i++)
+    static_cast<NullTexture*>(rts[i])->CommitClear();
+  if (ds)
+    static_cast<NullTexture*>(ds)->CommitClear();
+}
+
+void NullDevice::SetPipeline(GPUPipeline* pipeline)
+{
+}
+
+void NullDevice::SetTextureSampler(u32 slot, GPUTexture* texture, GPUSampler* sampler)
+{
+}
+
+void NullDevice::SetTextureBuffer(u32 slot, GPUTextureBuffer* buffer)
+{
+}
+
+void NullDevice::SetViewport(s32 x, s32 y, s32 width, s32 height)
+{
+}
+
+void NullDevice::SetScissor(s32 x, s32 y, s32 width, s32 height)
+{
+}
+
+void NullDevice::Draw(u32 vertex_count, u32 base_vertex)
+{
+  s_stats.num_draws++;
+}
+
+void NullDevice::DrawIndexed(u32 index_count, u32 base_index, u32 base_vertex)
+{
+  s_stats.num_draws++;
+}
+
+void NullDevice::DrawIndexedWithBarrier(u32 index_count, u32 base_index, u32 base_vertex, DrawBarrier type)
+{
+  s_stats.num_draws++;
+}
+
+bool NullDevice::BeginPresent(bool skip_present)
+{
+  // Never anything to present to. Returning false tells the caller to skip rendering the frame entirely.
+  TrimTexturePool();
+  return false;
+}
+
+void NullDevice::EndPresent(bool explicit_submit)
+{
+}
+
+void NullDevice::SubmitPresent()
+{
+}
+
+void NullDevice::FlushCommands()
+{
+}
+
+NullTexture::NullTexture(u16 width, u16 height, u8 layers, u8 levels, u8 samples, Type type, Format format)
+  : GPUTexture(width, height, layers, levels, samples, type, format)
+{
+  m_level_offsets.reserve(levels);
+  for (u32 level = 0; level < levels; level++)
+  {
+    m_level_offsets.push_back(m_layer_size);
+    m_layer_size += static_cast<size_t>(GetPitch(level)) * CalcUploadRows(GetMipHeight(level));
+  }
+
+  m_data.resize(m_layer_size * layers);
+  std::memset(m_data.data(), 0, m_data.size());
+}
+
+NullTexture::~NullTexture() = default;
+
+u8* NullTexture::GetData(u32 layer, u32 level)
+{
+  DebugAssert(layer < m_layers && level < m_levels);
+  return m_data.data() + (m_layer_size * layer) + m_level_offsets[level];
+}
+
+u32 NullTexture::GetPitch(u32 level) const
+{
+  return CalcUploadPitch(GetMipWidth(level));
+}
+
+u32 NullTexture::GetOffset(u32 x, u32 y, u32 level) const
+{
+  return (CalcUploadRows(y) * GetPitch(level)) + CalcUploadPitch(x);
+}
+
+void NullTexture::CommitClear()
+{
+  if (m_state == State::Dirty)
+    return;
+
+  // Invalidated contents are undefined, so leave whatever was there. Colour clears are only applied to RGBA8, the
+  // format used for everything that gets read back, other formats are cleared to zero.
+  if (m_state == State::Cleared)
+  {
+    if (IsRenderTarget() && GetPixelSize() == sizeof(u32))
+    {
+      const u32 color = GetClearColor();
+      for (size_t i = 0; i < m_data.size(); i += sizeof(u32))
+        std::memcpy(m_data.data() + i, &color, sizeof(u32));
+    }
+    else
+    {
+      std::memset(m_data.data(), 0, m_data.size());
+    }
+  }
+
+  m_state = State::Dirty;
+}
+
+bool NullTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch, u32 layer, u32 level)
+{
+  DebugAssert(layer < m_layers && level < m_levels);
+  DebugAssert((x + width) <= GetMipWidth(level) && (y + height) <= GetMipHeight(level));
+
+  if (x != 0 || y != 0 || width != GetMipWidth(level) || height != GetMipHeight(level))
+    CommitClear();
+  m_state = State::Dirty;
+
+  GPUDevice::GetStatistics().num_uploads++;
+
+  const u32 level_pitch = GetPitch(level);
+  StringUtil::StrideMemCpy(GetData(layer, level) + GetOffset(x, y, level), level_pitch, data, pitch,
+                           CalcUploadPitch(width), CalcUploadRows(height));
+  return true;
+}
+
+bool NullTexture::Map(void** map, u32* map_stride, u32 x, u32 y, u32 width, u32 height, u32 layer, u32 level)
+{
+  DebugAssert(layer < m_layers && level < m_levels);
+  DebugAssert((x + width) <= GetMipWidth(level) && (y + height) <= GetMipHeight(level));
+
+  if (x != 0 || y != 0 || width != GetMipWidth(level) || height != GetMipHeight(level))
+    CommitClear();
+  m_state = State::Dirty;
+
+  GPUDevice::GetStatistics().num_uploads++;
+
+  // Storage is already in system memory, so the caller can write straight into it.
+  *map = GetData(layer, level) + GetOffset(x, y, level);
+  *map_stride = GetPitch(level);
+  return true;
+}
+
+void NullTexture::Unmap()
+{
+}
+
+void NullTexture::SetDebugName(std::string_view name)
+{
+}
+
+NullDownloadTexture::NullDownloadTexture(u32 width, u32 height, GPUTexture::Format format, u8* memory, u32 pitch)
+  : GPUDownloadTexture(width, height, format, (memory != nullptr)), m_memory(memory)
+{
+  m_map_pointer = memory;
+  m_current_pitch = pitch;
+}
+
+NullDownloadTexture::~NullDownloadTexture() = default;
+
+void NullDownloadTexture::CopyFromTexture(u32 dst_x, u32 dst_y, GPUTexture* src, u32 src_x, u32 src_y, u32 width,
+                                          u32 height, u32 src_layer, u32 src_level, bool use_transfer_pitch)
+{
+  NullTexture* const S = static_cast<NullTexture*>(src);
+  DebugAssert(S->GetFormat() == m_format);
+  DebugAssert(src_level < S->GetLevels());
+  DebugAssert((src_x + width) <= S->GetMipWidth(src_level) && (src_y + height) <= S->GetMipHeight(src_level));
+  DebugAssert((dst_x + width) <= m_width && (dst_y + height) <= m_height);
+  DebugAssert((dst_x == 0 && dst_y == 0) || !use_transfer_pitch);
+
+  S->CommitClear();
+
+  GPUDevice::GetStatistics().num_downloads++;
+
+  // Pack tightly when we own the buffer, same as the backends which copy to a staging buffer.
+  if (!m_is_imported)
+    m_current_pitch = GetTransferPitch(use_transfer_pitch ? width : m_width, 1);
+
+  u32 copy_offset, copy_size, copy_rows;
+  GetTransferSize(dst_x, dst_y, width, height, m_current_pitch, &copy_offset, &copy_size, &copy_rows);
+  StringUtil::StrideMemCpy(m_memory + copy_offset, m_current_pitch,
+                           S->GetData(src_layer, src_level) + S->GetOffset(src_x, src_y, src_level),
+                           S->GetPitch(src_level), copy_size, copy_rows);
+}
+
+bool NullDownloadTexture::Map(u32 x, u32 y, u32 width, u32 height)
+{
+  // Always mapped.
+  return true;
+}
+
+void NullDownloadTexture::Unmap()
+{
+}
+
+void NullDownloadTexture::Flush()
+{
+}
+
+void NullDownloadTexture::SetDebugName(std::string_view name)
+{
+}
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2019-2024 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+
+#include "gpu_device.h"
+#include "gpu_texture.h"
+
+#include "common/heap_array.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Device which never touches a GPU. Textures live in system memory, so uploads, copies and downloads behave like a
+/// real device, but draws are discarded. Intended for headless runs with the software renderer, where the display
+/// texture is only ever read back, e.g. for frame hashing.
+class NullDevice final : public GPUDevice
+{
+public:
+  NullDevice();
+  ~NullDevice() override;
+
+  RenderAPI GetRenderAPI() const override;
+
+  bool HasSurface() const override;
+  void DestroySurface() override;
+  bool UpdateWindow() override;
+
+  AdapterAndModeList GetAdapterAndModeList() override;
+  void ResizeWindow(s32 new_window_width, s32 new_window_height, float new_window_scale) override;
+
+  std::string GetDriverInfo() const override;
+
+  std::unique_ptr<GPUTexture> CreateTexture(u32 width, u32 height, u32 layers, u32 levels, u32 samples,
+                                            GPUTexture::Type type, GPUTexture::Format format,
+                                            const void* data = nullptr, u32 data_stride = 0) override;
+  std::unique_ptr<GPUSampler> CreateSampler(const GPUSampler::Config& config) override;
+  std::unique_ptr<GPUTextureBuffer> CreateTextureBuffer(GPUTextureBuffer::Format format,
+                                                        u32 size_in_elements) override;
+
+  std::unique_ptr<GPUDownloadTexture> CreateDownloadTexture(u32 width, u32 height, GPUTexture::Format format) override;
+  std::unique_ptr<GPUDownloadTexture> CreateDownloadTexture(u32 width, u32 height, GPUTexture::Format format,
+                                                            void* memory, size_t memory_size,
+                                                            u32 memory_stride) override;
+
+  void CopyTextureRegion(GPUTexture* dst, u32 dst_x, u32 dst_y, u32 dst_layer, u32 dst_level, GPUTexture* src,
+                         u32 src_x, u32 src_y, u32 src_layer, u32 src_level, u32 width, u32 height) override;
+  void ResolveTextureRegion(GPUTexture* dst, u32 dst_x, u32 dst_y, u32 dst_layer, u32 dst_level, GPUTexture* src,
+                            u32 src_x, u32 src_y, u32 width, u32 height) override;
+
+  std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config) override;
+
+  void PushDebugGroup(const char* name) override;
+  void PopDebugGroup() override;
+  void InsertDebugMessage(const char* msg) override;
+
+  void MapVertexBuffer(u32 vertex_size, u32 vertex_count, void** map_ptr, u32* map_space,
+                       u32* map_base_vertex) override;
+  void UnmapVertexBuffer(u32 vertex_size, u32 vertex_count) override;
+  void MapIndexBuffer(u32 index_count, DrawIndex** map_ptr, u32* map_space, u32* map_base_index) override;
+  void UnmapIndexBuffer(u32 used_index_count) override;
+  void PushUniformBuffer(const void* data, u32 data_size) override;
+  void* MapUniformBuffer(u32 size) override;
+  void UnmapUniformBuffer(u32 size) override;
+  void SetRenderTargets(GPUTexture* const* rts, u32 num_rts, GPUTexture* ds,
+                        GPUPipeline::RenderPassFlag render_pass_flags = GPUPipeline::NoRenderPassFlags) override;
+  void SetPipeline(GPUPipeline* pipeline) override;
+  void SetTextureSampler(u32 slot, GPUTexture* texture, GPUSampler* sampler) override;
+  void SetTextureBuffer(u32 slot, GPUTextureBuffer* buffer) override;
+  void SetViewport(s32 x, s32 y, s32 width, s32 height) override;
+  void SetScissor(s32 x, s32 y, s32 width, s32 height) override;
+  void Draw(u32 vertex_count, u32 base_vertex) override;
+  void DrawIndexed(u32 index_count, u32 base_index, u32 base_vertex) override;
+  void DrawIndexedWithBarrier(u32 index_count, u32 base_index, u32 base_vertex, DrawBarrier type) override;
+
+  bool BeginPresent(bool skip_present) override;
+  void EndPresent(bool explicit_submit) override;
+  void SubmitPresent() override;
+
+  void FlushCommands() override;
+
+  bool SupportsTextureFormat(GPUTexture::Format format) const override;
+
+protected:
+  bool CreateDevice(std::string_view adapter, bool threaded_presentation,
+                    std::optional<bool> exclusive_fullscreen_control, FeatureMask disabled_features,
+                    Error* error) override;
+  void DestroyDevice() override;
+
+  std::unique_ptr<GPUShader> CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data) override;
+  std::unique_ptr<GPUShader> CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
+                                                    const char* entry_point,
+                                                    DynamicHeapArray<u8>* out_binary) override;
+
+private:
+  // Streaming buffers only need somewhere to write to, since nothing reads them. They grow to the largest request.
+  std::vector<u8> m_vertex_buffer;
+  std::vector<u8> m_index_buffer;
+  std::vector<u8> m_uniform_buffer;
+};
+
+class NullTexture final : public GPUTexture
+{
+  friend NullDevice;
+
+public:
+  ~NullTexture() override;
+
+  /// Returns a pointer to the start of the specified layer and level, rows are GetPitch() bytes apart.
+  u8* GetData(u32 layer, u32 level);
+  u32 GetPitch(u32 level) const;
+
+  /// Byte offset of (x, y) within a level, both in pixels.
+  u32 GetOffset(u32 x, u32 y, u32 level) const;
+
+  /// Writes any pending clear to the stored data, must be called before it's read or partially written.
+  void CommitClear();
+
+  bool Update(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch, u32 layer = 0,
+              u32 level = 0) override;
+  bool Map(void** map, u32* map_stride, u32 x, u32 y, u32 width, u32 height, u32 layer = 0, u32 level = 0) override;
+  void Unmap() override;
+
+  void SetDebugName(std::string_view name) override;
+
+private:
+  NullTexture(u16 width, u16 height, u8 layers, u8 levels, u8 samples, Type type, Format format);
+
+  // Every layer and level, one after the other. Multisampled textures only store one sample.
+  DynamicHeapArray<u8> m_data;
+  std::vector<size_t> m_level_offsets;
+  size_t m_layer_size = 0;
+};
+
+class NullDownloadTexture final : public GPUDownloadTexture
+{
+  friend NullDevice;
+
+public:
+  ~NullDownloadTexture() override;
+
+  void CopyFromTexture(u32 dst_x, u32 dst_y, GPUTexture* src, u32 src_x, u32 src_y, u32 width, u32 height,
+                       u32 src_layer, u32 src_level, bool use_transfer_pitch) override;
+
+  bool Map(u32 x, u32 y, u32 width, u32 height) override;
+  void Unmap() override;
+
+  void Flush() override;
+
+  void SetDebugName(std::string_view name) override;
+
+private:
+  NullDownloadTexture(u32 width, u32 height, GPUTexture::Format format, u8* memory, u32 pitch);
+
+  // Only allocated when the memory isn't imported.
+  DynamicHeapArray<u8> m_buffer;
+  u8* m_memory;
+};
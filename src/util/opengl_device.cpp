@@ -64,6 +64,11 @@ std::unique_ptr<GPUTexture> OpenGLDevice::CreateTexture(u32 width, u32 height, u
 
 bool OpenGLDevice::SupportsTextureFormat(GPUTexture::Format format) const
 {
+  if (format == GPUTexture::Format::BC7)
+    return (GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc || GLAD_GL_EXT_texture_compression_bptc);
+  else if (GPUTexture::IsCompressedFormat(format))
+    return GLAD_GL_EXT_texture_compression_s3tc;
+
   const auto [gl_internal_format, gl_format, gl_type] =
     OpenGLTexture::GetPixelFormatMapping(format, m_gl_context->IsGLES());
   return (gl_internal_format != static_cast<GLenum>(0));
@@ -477,6 +482,7 @@ bool OpenGLDevice::CheckFeatures(FeatureMask disabled_features)
 
   m_features.gpu_timing = !(m_gl_context->IsGLES() &&
                             (!GLAD_GL_EXT_disjoint_timer_query || !glGetQueryObjectivEXT || !glGetQueryObjectui64vEXT));
+  m_features.gpu_timing_regions = m_features.gpu_timing;
   m_features.partial_msaa_resolve = true;
   m_features.memory_import = true;
   m_features.explicit_present = false;
@@ -501,6 +507,8 @@ bool OpenGLDevice::CheckFeatures(FeatureMask disabled_features)
 
   // Mobile drivers prefer textures to not be updated mid-frame.
   m_features.prefer_unused_textures = is_gles || vendor_id_arm || vendor_id_powervr || vendor_id_qualcomm;
+  m_features.threaded_shader_compile = false;
+  m_features.sparse_textures = false;
 
   if (vendor_id_intel)
   {
@@ -796,6 +804,11 @@ void OpenGLDevice::SubmitPresent()
   Panic("Not supported by this API.");
 }
 
+void OpenGLDevice::FlushCommands()
+{
+  glFlush();
+}
+
 void OpenGLDevice::CreateTimestampQueries()
 {
   const bool gles = m_gl_context->IsGLES();
@@ -860,20 +873,27 @@ void OpenGLDevice::PopTimestampQuery()
 
     u64 result = 0;
     GetQueryObjectui64v(m_timestamp_queries[m_read_timestamp_query], GL_QUERY_RESULT, &result);
-    m_accumulated_gpu_time += static_cast<float>(static_cast<double>(result) / 1000000.0);
+    const float time = static_cast<float>(static_cast<double>(result) / 1000000.0);
+    m_accumulated_gpu_time += time;
+    m_accumulated_gpu_region_times[m_timestamp_query_regions[m_read_timestamp_query]] += time;
     m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_waiting_timestamp_queries--;
   }
 
-  if (m_timestamp_query_started)
-  {
-    const auto EndQuery = gles ? glEndQueryEXT : glEndQuery;
-    EndQuery(GL_TIME_ELAPSED);
+  EndTimestampQuery();
+}
 
-    m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
-    m_timestamp_query_started = false;
-    m_waiting_timestamp_queries++;
-  }
+void OpenGLDevice::EndTimestampQuery()
+{
+  if (!m_timestamp_query_started)
+    return;
+
+  const auto EndQuery = m_gl_context->IsGLES() ? glEndQueryEXT : glEndQuery;
+  EndQuery(GL_TIME_ELAPSED);
+
+  m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
+  m_timestamp_query_started = false;
+  m_waiting_timestamp_queries++;
 }
 
 void OpenGLDevice::KickTimestampQuery()
@@ -885,9 +905,20 @@ void OpenGLDevice::KickTimestampQuery()
   const auto BeginQuery = gles ? glBeginQueryEXT : glBeginQuery;
 
   BeginQuery(GL_TIME_ELAPSED, m_timestamp_queries[m_write_timestamp_query]);
+  m_timestamp_query_regions[m_write_timestamp_query] = m_gpu_timing_region;
   m_timestamp_query_started = true;
 }
 
+void OpenGLDevice::WriteGPUTimingRegionChange()
+{
+  // Elapsed time queries can't overlap, so split the current one. Keep one free for the next frame.
+  if (!m_timestamp_query_started || (m_waiting_timestamp_queries + 2) >= NUM_TIMESTAMP_QUERIES)
+    return;
+
+  EndTimestampQuery();
+  KickTimestampQuery();
+}
+
 bool OpenGLDevice::SetGPUTimingEnabled(bool enabled)
 {
   if (m_gpu_timing_enabled == enabled)
@@ -1004,6 +1035,12 @@ void OpenGLDevice::UnbindPipeline(const OpenGLPipeline* pl)
 
 ALWAYS_INLINE_RELEASE void OpenGLDevice::SetVertexBufferOffsets(u32 base_vertex)
 {
+  // Multi-pass draws reuse the same vertices, the bindings are VAO state so only need updating if it changed.
+  if (m_last_base_vertex == base_vertex)
+    return;
+
+  m_last_base_vertex = base_vertex;
+
   const OpenGLPipeline::VertexArrayCacheKey& va = m_last_vao->first;
   const size_t stride = va.vertex_attribute_stride;
   for (u32 i = 0; i < va.num_vertex_attributes; i++)
@@ -105,6 +105,7 @@ public:
   bool BeginPresent(bool skip_present) override;
   void EndPresent(bool explicit_present) override;
   void SubmitPresent() override;
+  void FlushCommands() override;
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
@@ -138,8 +139,11 @@ protected:
   bool ReadPipelineCache(const std::string& filename) override;
   bool GetPipelineCacheData(DynamicHeapArray<u8>* data) override;
 
+  void WriteGPUTimingRegionChange() override;
+
 private:
-  static constexpr u8 NUM_TIMESTAMP_QUERIES = 3;
+  // Each query times one frame, or the part of it spent in one timing region.
+  static constexpr u8 NUM_TIMESTAMP_QUERIES = 192;
 
   static constexpr GLenum UPDATE_TEXTURE_UNIT = GL_TEXTURE8;
 
@@ -147,6 +151,7 @@ private:
   static constexpr u32 INDEX_BUFFER_SIZE = 4 * 1024 * 1024;
   static constexpr u32 UNIFORM_BUFFER_SIZE = 2 * 1024 * 1024;
   static constexpr u32 TEXTURE_STREAM_BUFFER_SIZE = 16 * 1024 * 1024;
+  static constexpr u32 INVALID_BASE_VERTEX = 0xFFFFFFFFu;
 
   bool CheckFeatures(FeatureMask disabled_features);
   bool CreateBuffers();
@@ -165,6 +170,7 @@ private:
   void CreateTimestampQueries();
   void DestroyTimestampQueries();
   void PopTimestampQuery();
+  void EndTimestampQuery();
   void KickTimestampQuery();
 
   GLuint CreateProgramFromPipelineCache(const OpenGLPipeline::ProgramCacheItem& it,
@@ -201,6 +207,7 @@ private:
   u32 m_last_texture_unit = 0;
   std::array<std::pair<GLuint, GLuint>, MAX_TEXTURE_SAMPLERS> m_last_samplers = {};
   GLuint m_last_ssbo = 0;
+  u32 m_last_base_vertex = INVALID_BASE_VERTEX;
   Common::Rectangle<s32> m_last_viewport{0, 0, 1, 1};
   Common::Rectangle<s32> m_last_scissor{0, 0, 1, 1};
 
@@ -216,6 +223,7 @@ private:
   OpenGLPipeline* m_current_pipeline = nullptr;
 
   std::array<GLuint, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
+  std::array<u8, NUM_TIMESTAMP_QUERIES> m_timestamp_query_regions = {};
   float m_accumulated_gpu_time = 0.0f;
   u8 m_read_timestamp_query = 0;
   u8 m_write_timestamp_query = 0;
@@ -707,6 +707,7 @@ void OpenGLDevice::SetPipeline(GPUPipeline* pipeline)
   if (m_last_vao != P->GetVAO())
   {
     m_last_vao = P->GetVAO();
+    m_last_base_vertex = INVALID_BASE_VERTEX;
     glBindVertexArray(m_last_vao->second.vao_id);
   }
   if (m_last_program != P->GetProgram())
@@ -29,55 +29,63 @@ const std::tuple<GLenum, GLenum, GLenum>& OpenGLTexture::GetPixelFormatMapping(G
 {
   static constexpr std::array<std::tuple<GLenum, GLenum, GLenum>, static_cast<u32>(GPUTexture::Format::MaxCount)>
     mapping = {{
-      {},                                                     // Unknown
-      {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},                  // RGBA8
-      {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE},                  // BGRA8
-      {GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5},           // RGB565
-      {GL_RGB5_A1, GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV},   // RGBA5551
-      {GL_R8, GL_RED, GL_UNSIGNED_BYTE},                      // R8
-      {GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_SHORT},   // D16
-      {GL_R16, GL_RED, GL_UNSIGNED_SHORT},                    // R16
-      {GL_R16I, GL_RED_INTEGER, GL_SHORT},                    // R16I
-      {GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT},          // R16U
-      {GL_R16F, GL_RED, GL_HALF_FLOAT},                       // R16F
-      {GL_R32I, GL_RED_INTEGER, GL_INT},                      // R32I
-      {GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT},            // R32U
-      {GL_R32F, GL_RED, GL_FLOAT},                            // R32F
-      {GL_RG8, GL_RG_INTEGER, GL_UNSIGNED_BYTE},              // RG8
-      {GL_RG16F, GL_RG, GL_UNSIGNED_SHORT},                   // RG16
-      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                       // RG16F
-      {GL_RG32F, GL_RG, GL_FLOAT},                            // RG32F
-      {GL_RGBA16, GL_RGBA, GL_UNSIGNED_BYTE},                 // RGBA16
-      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                   // RGBA16F
-      {GL_RGBA32F, GL_RGBA, GL_FLOAT},                        // RGBA32F
-      {GL_RGB10_A2, GL_BGRA, GL_UNSIGNED_INT_2_10_10_10_REV}, // RGB10A2
+      {},                                                            // Unknown
+      {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},                         // RGBA8
+      {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE},                         // BGRA8
+      {GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5},                  // RGB565
+      {GL_RGB5_A1, GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV},          // RGBA5551
+      {GL_R8, GL_RED, GL_UNSIGNED_BYTE},                             // R8
+      {GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_SHORT},          // D16
+      {GL_R16, GL_RED, GL_UNSIGNED_SHORT},                           // R16
+      {GL_R16I, GL_RED_INTEGER, GL_SHORT},                           // R16I
+      {GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT},                 // R16U
+      {GL_R16F, GL_RED, GL_HALF_FLOAT},                              // R16F
+      {GL_R32I, GL_RED_INTEGER, GL_INT},                             // R32I
+      {GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT},                   // R32U
+      {GL_R32F, GL_RED, GL_FLOAT},                                   // R32F
+      {GL_RG8, GL_RG_INTEGER, GL_UNSIGNED_BYTE},                     // RG8
+      {GL_RG16F, GL_RG, GL_UNSIGNED_SHORT},                          // RG16
+      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                              // RG16F
+      {GL_RG32F, GL_RG, GL_FLOAT},                                   // RG32F
+      {GL_RGBA16, GL_RGBA, GL_UNSIGNED_BYTE},                        // RGBA16
+      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                          // RGBA16F
+      {GL_RGBA32F, GL_RGBA, GL_FLOAT},                               // RGBA32F
+      {GL_RGB10_A2, GL_BGRA, GL_UNSIGNED_INT_2_10_10_10_REV},        // RGB10A2
+      {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC1
+      {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC2
+      {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC3
+      {GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, GL_UNSIGNED_BYTE},    // BC7
     }};
 
   // GLES doesn't have the non-normalized 16-bit formats.. use float and hope for the best, lol.
   static constexpr std::array<std::tuple<GLenum, GLenum, GLenum>, static_cast<u32>(GPUTexture::Format::MaxCount)>
     mapping_gles = {{
-      {},                                                     // Unknown
-      {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},                  // RGBA8
-      {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE},                  // BGRA8
-      {GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5},           // RGB565
-      {GL_RGB5_A1, GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV},   // RGBA5551
-      {GL_R8, GL_RED, GL_UNSIGNED_BYTE},                      // R8
-      {GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_SHORT},   // D16
-      {GL_R16F, GL_RED, GL_HALF_FLOAT},                       // R16
-      {GL_R16I, GL_RED_INTEGER, GL_SHORT},                    // R16I
-      {GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT},          // R16U
-      {GL_R16F, GL_RED, GL_HALF_FLOAT},                       // R16F
-      {GL_R32I, GL_RED_INTEGER, GL_INT},                      // R32I
-      {GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT},            // R32U
-      {GL_R32F, GL_RED, GL_FLOAT},                            // R32F
-      {GL_RG8, GL_RG, GL_UNSIGNED_BYTE},                      // RG8
-      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                       // RG16
-      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                       // RG16F
-      {GL_RG32F, GL_RG, GL_FLOAT},                            // RG32F
-      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                   // RGBA16
-      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                   // RGBA16F
-      {GL_RGBA32F, GL_RGBA, GL_FLOAT},                        // RGBA32F
-      {GL_RGB10_A2, GL_BGRA, GL_UNSIGNED_INT_2_10_10_10_REV}, // RGB10A2
+      {},                                                            // Unknown
+      {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},                         // RGBA8
+      {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE},                         // BGRA8
+      {GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5},                  // RGB565
+      {GL_RGB5_A1, GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV},          // RGBA5551
+      {GL_R8, GL_RED, GL_UNSIGNED_BYTE},                             // R8
+      {GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_SHORT},          // D16
+      {GL_R16F, GL_RED, GL_HALF_FLOAT},                              // R16
+      {GL_R16I, GL_RED_INTEGER, GL_SHORT},                           // R16I
+      {GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT},                 // R16U
+      {GL_R16F, GL_RED, GL_HALF_FLOAT},                              // R16F
+      {GL_R32I, GL_RED_INTEGER, GL_INT},                             // R32I
+      {GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT},                   // R32U
+      {GL_R32F, GL_RED, GL_FLOAT},                                   // R32F
+      {GL_RG8, GL_RG, GL_UNSIGNED_BYTE},                             // RG8
+      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                              // RG16
+      {GL_RG16F, GL_RG, GL_HALF_FLOAT},                              // RG16F
+      {GL_RG32F, GL_RG, GL_FLOAT},                                   // RG32F
+      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                          // RGBA16
+      {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},                          // RGBA16F
+      {GL_RGBA32F, GL_RGBA, GL_FLOAT},                               // RGBA32F
+      {GL_RGB10_A2, GL_BGRA, GL_UNSIGNED_INT_2_10_10_10_REV},        // RGB10A2
+      {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC1
+      {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC2
+      {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, GL_UNSIGNED_BYTE}, // BC3
+      {GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, GL_UNSIGNED_BYTE},    // BC7
     }};
 
   return gles ? mapping_gles[static_cast<u32>(format)] : mapping[static_cast<u32>(format)];
@@ -123,6 +131,12 @@ std::unique_ptr<OpenGLTexture> OpenGLTexture::Create(u32 width, u32 height, u32
     return nullptr;
   }
 
+  if (IsCompressedFormat(format) && (layers > 1 || data))
+  {
+    Log_ErrorPrintf("Compressed textures must be single layer, and filled with Update()");
+    return nullptr;
+  }
+
   const GLenum target =
     ((samples > 1) ? GL_TEXTURE_2D_MULTISAMPLE : ((layers > 1) ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D));
   const auto [gl_internal_format, gl_format, gl_type] = GetPixelFormatMapping(format, OpenGLDevice::IsGLES());
@@ -187,6 +201,12 @@ std::unique_ptr<OpenGLTexture> OpenGLTexture::Create(u32 width, u32 height, u32
           else
             glTexSubImage2D(target, i, 0, 0, current_width, current_height, gl_format, gl_type, data_ptr);
         }
+        else if (IsCompressedFormat(format))
+        {
+          glCompressedTexImage2D(target, i, gl_internal_format, current_width, current_height, 0,
+                                 CalcUploadSize(format, current_height, CalcUploadPitch(format, current_width)),
+                                 nullptr);
+        }
         else
         {
           if (layers > 1)
@@ -258,11 +278,26 @@ bool OpenGLTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data
   OpenGLDevice::BindUpdateTextureUnit();
   glBindTexture(target, m_id);
 
-  if (!sb || map_size > sb->GetChunkSize())
+  if (IsCompressedFormat(m_format))
+  {
+    // The unpack row length doesn't apply to compressed uploads, so padded rows have to be removed first.
+    const u32 upload_pitch = CalcUploadPitch(width);
+    const u32 upload_size = CalcUploadSize(height, upload_pitch);
+    std::vector<u8> repacked;
+    if (pitch != upload_pitch)
+    {
+      repacked.resize(upload_size);
+      StringUtil::StrideMemCpy(repacked.data(), upload_pitch, data, pitch, upload_pitch, CalcUploadRows(height));
+      data = repacked.data();
+    }
+
+    glCompressedTexSubImage2D(target, level, x, y, width, height, gl_internal_format, upload_size, data);
+  }
+  else if (!sb || map_size > sb->GetChunkSize())
   {
     GL_INS_FMT("Not using PBO for map size {}", map_size);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / GetPixelSize());
-    glTexSubImage2D(target, layer, x, y, width, height, gl_format, gl_type, data);
+    glTexSubImage2D(target, level, x, y, width, height, gl_format, gl_type, data);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
   }
   else
@@ -273,7 +308,7 @@ bool OpenGLTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data
     sb->Bind();
 
     glPixelStorei(GL_UNPACK_ROW_LENGTH, preferred_pitch / GetPixelSize());
-    glTexSubImage2D(GL_TEXTURE_2D, layer, x, y, width, height, gl_format, gl_type,
+    glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, gl_format, gl_type,
                     reinterpret_cast<void*>(static_cast<uintptr_t>(map.buffer_offset)));
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
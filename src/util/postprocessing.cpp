@@ -53,11 +53,26 @@ static GPUTexture::Format s_target_format = GPUTexture::Format::Unknown;
 static u32 s_target_width = 0;
 static u32 s_target_height = 0;
 static Common::Timer s_timer;
+static u32 s_generation = 0;
 
 static std::unique_ptr<GPUTexture> s_input_texture;
 
 static std::unique_ptr<GPUTexture> s_output_texture;
 
+namespace {
+struct SharedTexture
+{
+  std::unique_ptr<GPUTexture> texture;
+  GPUTexture::Format format;
+  u32 width;
+  u32 height;
+  u32 index;
+};
+} // namespace
+
+// Intermediate render targets which only live for the duration of one stage, shared between all stages.
+static std::vector<SharedTexture> s_shared_textures;
+
 static std::unordered_map<u64, std::unique_ptr<GPUSampler>> s_samplers;
 static std::unique_ptr<GPUTexture> s_dummy_texture;
 } // namespace PostProcessing
@@ -373,6 +388,7 @@ bool PostProcessing::IsEnabled()
 void PostProcessing::SetEnabled(bool enabled)
 {
   s_enabled = enabled;
+  s_generation++;
 }
 
 std::unique_ptr<PostProcessing::Shader> PostProcessing::TryLoadingShader(const std::string& shader_name,
@@ -456,6 +472,8 @@ void PostProcessing::Initialize()
 
 void PostProcessing::LoadStages()
 {
+  s_generation++;
+
   auto lock = Host::GetSettingsLock();
   SettingsInterface& si = GetLoadSettingsInterface();
 
@@ -512,6 +530,8 @@ void PostProcessing::LoadStages()
 
 void PostProcessing::UpdateSettings()
 {
+  s_generation++;
+
   auto lock = Host::GetSettingsLock();
   SettingsInterface& si = GetLoadSettingsInterface();
 
@@ -597,6 +617,7 @@ void PostProcessing::Toggle()
                                         TRANSLATE_STR("OSDMessage", "Post-processing is now disabled."),
                           Host::OSD_QUICK_DURATION);
   s_enabled = new_enabled;
+  s_generation++;
   if (s_enabled)
     s_timer.Reset();
 }
@@ -639,6 +660,11 @@ const Common::Timer& PostProcessing::GetTimer()
   return s_timer;
 }
 
+u32 PostProcessing::GetGeneration()
+{
+  return s_generation;
+}
+
 GPUSampler* PostProcessing::GetSampler(const GPUSampler::Config& config)
 {
   auto it = s_samplers.find(config.key);
@@ -653,6 +679,28 @@ GPUSampler* PostProcessing::GetSampler(const GPUSampler::Config& config)
   return it->second.get();
 }
 
+GPUTexture* PostProcessing::GetSharedTexture(u32 width, u32 height, GPUTexture::Format format, u32 index)
+{
+  for (const SharedTexture& st : s_shared_textures)
+  {
+    if (st.width == width && st.height == height && st.format == format && st.index == index)
+      return st.texture.get();
+  }
+
+  std::unique_ptr<GPUTexture> texture =
+    g_gpu_device->FetchTexture(width, height, 1, 1, 1, GPUTexture::Type::RenderTarget, format);
+  if (!texture)
+  {
+    Log_ErrorFmt("Failed to create {}x{} shared texture", width, height);
+    return nullptr;
+  }
+
+  Log_DevFmt("Created {}x{} {} shared texture {}", width, height, GPUTexture::GetFormatName(format), index);
+  GPUTexture* const ret = texture.get();
+  s_shared_textures.push_back(SharedTexture{std::move(texture), format, width, height, index});
+  return ret;
+}
+
 GPUTexture* PostProcessing::GetDummyTexture()
 {
   if (s_dummy_texture)
@@ -676,10 +724,12 @@ bool PostProcessing::CheckTargets(GPUTexture::Format target_format, u32 target_w
   // In case any allocs fail.
   DestroyTextures();
 
+  // The last stage draws straight to the final target, so a single stage doesn't need somewhere to ping-pong to.
   if (!(s_input_texture = g_gpu_device->FetchTexture(target_width, target_height, 1, 1, 1,
                                                      GPUTexture::Type::RenderTarget, target_format)) ||
-      !(s_output_texture = g_gpu_device->FetchTexture(target_width, target_height, 1, 1, 1,
-                                                      GPUTexture::Type::RenderTarget, target_format)))
+      (s_stages.size() > 1 &&
+       !(s_output_texture = g_gpu_device->FetchTexture(target_width, target_height, 1, 1, 1,
+                                                       GPUTexture::Type::RenderTarget, target_format))))
   {
     DestroyTextures();
     return false;
@@ -719,10 +769,15 @@ bool PostProcessing::CheckTargets(GPUTexture::Format target_format, u32 target_w
 
 void PostProcessing::DestroyTextures()
 {
+  s_generation++;
   s_target_format = GPUTexture::Format::Unknown;
   s_target_width = 0;
   s_target_height = 0;
 
+  for (SharedTexture& st : s_shared_textures)
+    g_gpu_device->RecycleTexture(std::move(st.texture));
+  s_shared_textures.clear();
+
   g_gpu_device->RecycleTexture(std::move(s_output_texture));
   g_gpu_device->RecycleTexture(std::move(s_input_texture));
 }
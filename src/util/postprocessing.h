@@ -125,6 +125,9 @@ void Shutdown();
 GPUTexture* GetInputTexture();
 const Common::Timer& GetTimer();
 
+/// Changes whenever the chain, its options or its targets change, so output from an older generation is stale.
+u32 GetGeneration();
+
 bool CheckTargets(GPUTexture::Format target_format, u32 target_width, u32 target_height, ProgressCallback* progress = nullptr);
 
 bool Apply(GPUTexture* final_target, s32 final_left, s32 final_top, s32 final_width, s32 final_height, s32 orig_width,
@@ -133,4 +136,9 @@ bool Apply(GPUTexture* final_target, s32 final_left, s32 final_top, s32 final_wi
 GPUSampler* GetSampler(const GPUSampler::Config& config);
 GPUTexture* GetDummyTexture();
 
+/// Returns a render target shared between all stages. Stages run one at a time, so a stage can use it freely, but the
+/// contents don't survive to the next stage or frame. Index distinguishes textures of the same size and format.
+/// Only valid until the targets are next resized.
+GPUTexture* GetSharedTexture(u32 width, u32 height, GPUTexture::Format format, u32 index);
+
 }; // namespace PostProcessing
@@ -14,6 +14,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memory_accounting.h"
 #include "common/path.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
@@ -24,17 +25,46 @@
 
 #include "fmt/format.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cctype>
 #include <cmath>
 #include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
 #include <sstream>
+#include <tuple>
 
 Log_SetChannel(ReShadeFXShader);
 
+namespace {
+struct CachedModule
+{
+  std::string filename;
+  std::string code;
+  s32 buffer_width;
+  s32 buffer_height;
+  RenderAPI render_api;
+  bool debug_info;
+
+  // includes can change without the main file changing
+  std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> included_files;
+
+  reshadefx::module mod;
+};
+} // namespace
+
 static constexpr s32 DEFAULT_BUFFER_WIDTH = 3840;
 static constexpr s32 DEFAULT_BUFFER_HEIGHT = 2160;
 
+// Parsed modules are kept around, since the same shader gets parsed for its options and again for its pipelines,
+// and chains are reloaded whenever a preset or option is changed. The backend compile is in the shader cache.
+static constexpr size_t MAX_CACHED_MODULES = 8;
+static std::mutex s_module_cache_mutex;
+static std::deque<CachedModule> s_module_cache; // most recently used first
+static size_t s_module_cache_size = 0;
+
 static RenderAPI GetRenderAPI()
 {
   return g_gpu_device ? g_gpu_device->GetRenderAPI() : RenderAPI::D3D11;
@@ -95,6 +125,89 @@ static std::unique_ptr<reshadefx::codegen> CreateRFXCodegen()
   }
 }
 
+static std::filesystem::file_time_type GetIncludedFileTime(const std::filesystem::path& path)
+{
+  // Resources aren't real files, but they also don't change.
+  std::error_code ec;
+  const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, ec);
+  return ec ? std::filesystem::file_time_type::min() : time;
+}
+
+static size_t GetCachedModuleSize(const CachedModule& entry)
+{
+  return entry.code.size() + entry.mod.code.size();
+}
+
+static void RemoveCachedModule(std::deque<CachedModule>::iterator it)
+{
+  s_module_cache_size -= GetCachedModuleSize(*it);
+  MemoryAccounting::SetHostBytes(MemoryAccounting::Category::ShaderCache, s_module_cache_size);
+  s_module_cache.erase(it);
+}
+
+static bool LookupCachedModule(const std::string& filename, const std::string& code, s32 buffer_width,
+                               s32 buffer_height, reshadefx::module* mod)
+{
+  const RenderAPI render_api = GetRenderAPI();
+  const bool debug_info = g_gpu_device ? g_gpu_device->IsDebugDevice() : false;
+
+  std::unique_lock lock(s_module_cache_mutex);
+  for (auto it = s_module_cache.begin(); it != s_module_cache.end(); ++it)
+  {
+    if (it->filename != filename || it->buffer_width != buffer_width || it->buffer_height != buffer_height ||
+        it->render_api != render_api || it->debug_info != debug_info || it->code != code)
+    {
+      continue;
+    }
+
+    if (std::any_of(it->included_files.begin(), it->included_files.end(),
+                    [](const auto& file) { return GetIncludedFileTime(file.first) != file.second; }))
+    {
+      Log_DevFmt("Included files for '{}' changed, discarding cached module.", filename);
+      RemoveCachedModule(it);
+      return false;
+    }
+
+    *mod = it->mod;
+    if (it != s_module_cache.begin())
+    {
+      CachedModule entry = std::move(*it);
+      s_module_cache.erase(it);
+      s_module_cache.push_front(std::move(entry));
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+static void InsertCachedModule(const std::string& filename, std::string code, s32 buffer_width, s32 buffer_height,
+                               const reshadefx::preprocessor& pp, const reshadefx::module& mod)
+{
+  CachedModule entry;
+  entry.filename = filename;
+  entry.code = std::move(code);
+  entry.buffer_width = buffer_width;
+  entry.buffer_height = buffer_height;
+  entry.render_api = GetRenderAPI();
+  entry.debug_info = g_gpu_device ? g_gpu_device->IsDebugDevice() : false;
+  for (std::filesystem::path& path : pp.included_files())
+  {
+    const std::filesystem::file_time_type time = GetIncludedFileTime(path);
+    entry.included_files.emplace_back(std::move(path), time);
+  }
+  entry.mod = mod;
+
+  std::unique_lock lock(s_module_cache_mutex);
+  s_module_cache_size += GetCachedModuleSize(entry);
+  s_module_cache.push_front(std::move(entry));
+  if (s_module_cache.size() > MAX_CACHED_MODULES)
+    RemoveCachedModule(std::prev(s_module_cache.end()));
+  else
+    MemoryAccounting::SetHostBytes(MemoryAccounting::Category::ShaderCache, s_module_cache_size);
+}
+
 static GPUTexture::Format MapTextureFormat(reshadefx::texture_format format)
 {
   static constexpr GPUTexture::Format s_mapping[] = {
@@ -370,6 +483,14 @@ bool PostProcessing::ReShadeFXShader::IsValid() const
 bool PostProcessing::ReShadeFXShader::CreateModule(s32 buffer_width, s32 buffer_height, reshadefx::module* mod,
                                                    std::string code, Error* error)
 {
+  if (LookupCachedModule(m_filename, code, buffer_width, buffer_height, mod))
+  {
+    Log_DevFmt("Using cached module for '{}'.", m_filename);
+    return true;
+  }
+
+  std::string code_key = code;
+
   reshadefx::preprocessor pp;
   pp.set_include_callbacks(PreprocessorFileExistsCallback, PreprocessorReadFileCallback);
 
@@ -433,6 +554,7 @@ bool PostProcessing::ReShadeFXShader::CreateModule(s32 buffer_width, s32 buffer_
   }
 
   cg->write_result(*mod);
+  InsertCachedModule(m_filename, std::move(code_key), buffer_width, buffer_height, pp, *mod);
 
   // FileSystem::WriteBinaryFile("D:\\out.txt", mod->code.data(), mod->code.size());
   return true;
@@ -906,7 +1028,7 @@ bool PostProcessing::ReShadeFXShader::CreatePasses(GPUTexture::Format backbuffer
   // Named render targets.
   for (const reshadefx::texture_info& ti : mod.textures)
   {
-    Texture tex;
+    Texture tex = {};
 
     if (!ti.semantic.empty())
     {
@@ -968,6 +1090,7 @@ bool PostProcessing::ReShadeFXShader::CreatePasses(GPUTexture::Format backbuffer
 
       Pass pass;
       pass.num_vertices = pi.num_vertices;
+      pass.blend_enable = (pi.blend_enable[0] != 0);
 
       if (is_final)
       {
@@ -1001,7 +1124,7 @@ bool PostProcessing::ReShadeFXShader::CreatePasses(GPUTexture::Format backbuffer
       }
       else
       {
-        Texture new_rt;
+        Texture new_rt = {};
         new_rt.rt_scale = 1.0f;
         new_rt.format = backbuffer_format;
         pass.render_targets.push_back(static_cast<TextureID>(m_textures.size()));
@@ -1078,9 +1201,42 @@ bool PostProcessing::ReShadeFXShader::CreatePasses(GPUTexture::Format backbuffer
     }
   }
 
+  FindTransientTextures();
   return true;
 }
 
+void PostProcessing::ReShadeFXShader::FindTransientTextures()
+{
+  // Anything sampled or blended into before it's written in a frame depends on the previous frame's contents.
+  std::vector<bool> written(m_textures.size(), false);
+  std::vector<bool> read_first(m_textures.size(), false);
+  for (const Pass& pass : m_passes)
+  {
+    for (const Sampler& sampler : pass.samplers)
+    {
+      if (sampler.texture_id >= 0 && !written[sampler.texture_id])
+        read_first[sampler.texture_id] = true;
+    }
+    for (const TextureID rt : pass.render_targets)
+    {
+      if (rt < 0)
+        continue;
+
+      if (pass.blend_enable && !written[rt])
+        read_first[rt] = true;
+      written[rt] = true;
+    }
+  }
+
+  for (size_t i = 0; i < m_textures.size(); i++)
+  {
+    Texture& tex = m_textures[i];
+    tex.transient = (tex.rt_scale != 0.0f && written[i] && !read_first[i]);
+    if (tex.transient)
+      Log_DevFmt("Render target '{}' is transient", tex.reshade_name);
+  }
+}
+
 const char* PostProcessing::ReShadeFXShader::GetTextureNameForID(TextureID id) const
 {
   if (id == INPUT_COLOR_TEXTURE)
@@ -1122,7 +1278,8 @@ GPUTexture* PostProcessing::ReShadeFXShader::GetTextureByID(TextureID id, GPUTex
   if (static_cast<size_t>(id) >= m_textures.size())
     Panic("Unexpected texture ID");
 
-  return m_textures[static_cast<size_t>(id)].texture.get();
+  const Texture& tex = m_textures[static_cast<size_t>(id)];
+  return tex.transient ? tex.shared_texture : tex.texture.get();
 }
 
 bool PostProcessing::ReShadeFXShader::CompilePipeline(GPUTexture::Format format, u32 width, u32 height,
@@ -1295,15 +1452,37 @@ bool PostProcessing::ReShadeFXShader::ResizeOutput(GPUTexture::Format format, u3
 {
   m_valid = false;
 
+  // Transient textures of the same size and format need distinct shared textures, since they're all live at once.
+  llvm::SmallVector<std::tuple<u32, u32, GPUTexture::Format, u32>, 4> shared_counts;
+
   for (Texture& tex : m_textures)
   {
     if (tex.rt_scale == 0.0f)
       continue;
 
     g_gpu_device->RecycleTexture(std::move(tex.texture));
+    tex.shared_texture = nullptr;
 
     const u32 t_width = std::max(static_cast<u32>(static_cast<float>(width) * tex.rt_scale), 1u);
     const u32 t_height = std::max(static_cast<u32>(static_cast<float>(height) * tex.rt_scale), 1u);
+    if (tex.transient)
+    {
+      u32 index = 0;
+      auto it = std::find_if(shared_counts.begin(), shared_counts.end(), [&](const auto& sc) {
+        return (std::get<0>(sc) == t_width && std::get<1>(sc) == t_height && std::get<2>(sc) == tex.format);
+      });
+      if (it != shared_counts.end())
+        index = std::get<3>(*it)++;
+      else
+        shared_counts.push_back(std::make_tuple(t_width, t_height, tex.format, 1u));
+
+      tex.shared_texture = PostProcessing::GetSharedTexture(t_width, t_height, tex.format, index);
+      if (!tex.shared_texture)
+        return false;
+
+      continue;
+    }
+
     tex.texture = g_gpu_device->FetchTexture(t_width, t_height, 1, 1, 1, GPUTexture::Type::RenderTarget, tex.format);
     if (!tex.texture)
     {
@@ -79,6 +79,7 @@ private:
   bool CreateOptions(const reshadefx::module& mod, Error* error);
   bool GetSourceOption(const reshadefx::uniform_info& ui, SourceOptionType* si, Error* error);
   bool CreatePasses(GPUTexture::Format backbuffer_format, reshadefx::module& mod, Error* error);
+  void FindTransientTextures();
 
   const char* GetTextureNameForID(TextureID id) const;
   GPUTexture* GetTextureByID(TextureID id, GPUTexture* input, GPUTexture* final_target) const;
@@ -91,6 +92,11 @@ private:
     std::string reshade_name; // TODO: we might be able to drop this
     GPUTexture::Format format;
     float rt_scale;
+
+    // Render targets which are always written before they're read don't need to keep their contents between frames,
+    // so they come from the pool shared with the other stages, instead of being owned by this shader.
+    bool transient;
+    GPUTexture* shared_texture;
   };
 
   struct Sampler
@@ -107,6 +113,7 @@ private:
     llvm::SmallVector<TextureID, GPUDevice::MAX_RENDER_TARGETS> render_targets;
     llvm::SmallVector<Sampler, GPUDevice::MAX_TEXTURE_SAMPLERS> samplers;
     u32 num_vertices;
+    bool blend_enable;
 
 #ifdef _DEBUG
     std::string name;
@@ -590,7 +590,8 @@ void ShaderGen::DeclareFragmentEntryPoint(
 #ifdef ENABLE_VULKAN
       if (m_render_api == RenderAPI::Vulkan)
       {
-        ss << "layout(input_attachment_index = 0, set = 2, binding = 0) uniform "
+        // Follows the texture set, which moves down when the uniforms are push constants.
+        ss << "layout(input_attachment_index = 0, set = " << (m_has_uniform_buffer ? 2 : 1) << ", binding = 0) uniform "
            << (msaa ? "subpassInputMS" : "subpassInput") << " u_input_rt; \n";
         ss << "#define LAST_FRAG_COLOR " << (msaa ? "subpassLoad(u_input_rt, gl_SampleID)" : "subpassLoad(u_input_rt)")
            << "\n";
@@ -8,6 +8,7 @@
 #include "common/types.h"
 #include <cstring>
 #include <deque>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -24,10 +25,20 @@ public:
   };
 
   StateWrapper(ByteStream* stream, Mode mode, u32 version);
+
+  /// Reads from or writes to a fixed buffer directly, avoiding a virtual call per value. Writing past the end of the
+  /// buffer is an error, it does not grow.
+  StateWrapper(std::span<u8> buffer, Mode mode, u32 version);
+
   StateWrapper(const StateWrapper&) = delete;
   ~StateWrapper();
 
+  /// Returns null when using a buffer.
   ByteStream* GetStream() const { return m_stream; }
+
+  /// Returns the offset in the stream or buffer. When writing to a buffer, this is the number of bytes written.
+  u64 GetPosition() const { return m_stream ? m_stream->GetPosition() : m_buffer_position; }
+
   bool HasError() const { return m_error; }
   bool IsReading() const { return (m_mode == Mode::Read); }
   bool IsWriting() const { return (m_mode == Mode::Write); }
@@ -41,13 +52,13 @@ public:
   {
     if (m_mode == Mode::Read)
     {
-      if (m_error || (m_error |= !m_stream->Read2(value_ptr, sizeof(T))) == true)
+      if (m_error || (m_error |= !ReadData(value_ptr, sizeof(T))) == true)
         *value_ptr = static_cast<T>(0);
     }
     else
     {
       if (!m_error)
-        m_error |= !m_stream->Write2(value_ptr, sizeof(T));
+        m_error |= !WriteData(value_ptr, sizeof(T));
     }
   }
 
@@ -59,7 +70,7 @@ public:
     if (m_mode == Mode::Read)
     {
       TType temp;
-      if (m_error || (m_error |= !m_stream->Read2(&temp, sizeof(TType))) == true)
+      if (m_error || (m_error |= !ReadData(&temp, sizeof(TType))) == true)
         temp = static_cast<TType>(0);
 
       *value_ptr = static_cast<T>(temp);
@@ -69,7 +80,7 @@ public:
       TType temp;
       std::memcpy(&temp, value_ptr, sizeof(TType));
       if (!m_error)
-        m_error |= !m_stream->Write2(&temp, sizeof(TType));
+        m_error |= !WriteData(&temp, sizeof(TType));
     }
   }
 
@@ -79,28 +90,38 @@ public:
   {
     if (m_mode == Mode::Read)
     {
-      if (m_error || (m_error |= !m_stream->Read2(value_ptr, sizeof(T))) == true)
+      if (m_error || (m_error |= !ReadData(value_ptr, sizeof(T))) == true)
         std::memset(value_ptr, 0, sizeof(*value_ptr));
     }
     else
     {
       if (!m_error)
-        m_error |= !m_stream->Write2(value_ptr, sizeof(T));
+        m_error |= !WriteData(value_ptr, sizeof(T));
     }
   }
 
   template<typename T>
   void DoArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      Do(&values[i]);
+    // Arrays of values which are written as-is can be copied in one go. Bools are excluded, since reading normalises
+    // them.
+    if constexpr ((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_floating_point_v<T> ||
+                  std::is_enum_v<T>)
+    {
+      DoBytes(values, sizeof(T) * count);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        Do(&values[i]);
+    }
   }
 
   template<typename T>
   void DoPODArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      DoPOD(&values[i]);
+    static_assert(std::is_standard_layout_v<T> && std::is_trivial_v<T>);
+    DoBytes(values, sizeof(T) * count);
   }
 
   void DoBytes(void* data, size_t length);
@@ -200,12 +221,56 @@ public:
       return;
     }
 
-    if (!m_error)
+    if (m_error)
+      return;
+
+    if (!m_stream)
+    {
+      m_error = (count > (m_buffer_size - m_buffer_position));
+      if (!m_error)
+        m_buffer_position += count;
+    }
+    else
+    {
       m_error = !m_stream->SeekRelative(static_cast<s64>(count));
+    }
   }
 
 private:
-  ByteStream* m_stream;
+  ALWAYS_INLINE bool ReadData(void* data, size_t length)
+  {
+    if (!m_stream)
+    {
+      if (length > (m_buffer_size - m_buffer_position)) [[unlikely]]
+        return false;
+
+      std::memcpy(data, m_buffer + m_buffer_position, length);
+      m_buffer_position += length;
+      return true;
+    }
+
+    return m_stream->Read2(data, static_cast<u32>(length));
+  }
+
+  ALWAYS_INLINE bool WriteData(const void* data, size_t length)
+  {
+    if (!m_stream)
+    {
+      if (length > (m_buffer_size - m_buffer_position)) [[unlikely]]
+        return false;
+
+      std::memcpy(m_buffer + m_buffer_position, data, length);
+      m_buffer_position += length;
+      return true;
+    }
+
+    return m_stream->Write2(data, static_cast<u32>(length));
+  }
+
+  ByteStream* m_stream = nullptr;
+  u8* m_buffer = nullptr;
+  size_t m_buffer_size = 0;
+  size_t m_buffer_position = 0;
   Mode m_mode;
   u32 m_version;
   bool m_error = false;
@@ -299,6 +299,94 @@ VkPipeline Vulkan::GraphicsPipelineBuilder::Create(VkDevice device, VkPipelineCa
   return pipeline;
 }
 
+VkPipeline Vulkan::GraphicsPipelineBuilder::CreateLibrary(VkDevice device, VkPipelineCache pipeline_cache,
+                                                          VkGraphicsPipelineLibraryFlagsEXT flags)
+{
+  const bool vertex_input = (flags & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) != 0;
+  const bool pre_rasterization = (flags & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) != 0;
+  const bool fragment_shader = (flags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) != 0;
+  const bool fragment_output = (flags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0;
+
+  // Only pass the stages and state which belong to this part of the pipeline.
+  std::array<VkPipelineShaderStageCreateInfo, MAX_SHADER_STAGES> stages;
+  u32 num_stages = 0;
+  for (u32 i = 0; i < m_ci.stageCount; i++)
+  {
+    if ((m_shader_stages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT) ? fragment_shader : pre_rasterization)
+      stages[num_stages++] = m_shader_stages[i];
+  }
+
+  std::array<VkDynamicState, MAX_DYNAMIC_STATE> dynamic_states;
+  VkPipelineDynamicStateCreateInfo dynamic_state = {VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO, nullptr, 0,
+                                                    0, dynamic_states.data()};
+  for (u32 i = 0; i < m_dynamic_state.dynamicStateCount; i++)
+  {
+    const VkDynamicState ds = m_dynamic_state_values[i];
+    const bool is_depth =
+      (ds == VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT || ds == VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT ||
+       ds == VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+    if (is_depth ? fragment_shader : pre_rasterization)
+      dynamic_states[dynamic_state.dynamicStateCount++] = ds;
+  }
+
+  const VkGraphicsPipelineLibraryCreateInfoEXT library_info = {
+    VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT, m_ci.pNext, flags};
+
+  VkGraphicsPipelineCreateInfo ci = m_ci;
+  ci.pNext = &library_info;
+  ci.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+  ci.stageCount = num_stages;
+  ci.pStages = (num_stages > 0) ? stages.data() : nullptr;
+  ci.pVertexInputState = vertex_input ? m_ci.pVertexInputState : nullptr;
+  ci.pInputAssemblyState = vertex_input ? m_ci.pInputAssemblyState : nullptr;
+  ci.pTessellationState = nullptr;
+  ci.pViewportState = pre_rasterization ? m_ci.pViewportState : nullptr;
+  ci.pRasterizationState = pre_rasterization ? m_ci.pRasterizationState : nullptr;
+  ci.pMultisampleState = (fragment_shader || fragment_output) ? m_ci.pMultisampleState : nullptr;
+  ci.pDepthStencilState = fragment_shader ? m_ci.pDepthStencilState : nullptr;
+  ci.pColorBlendState = fragment_output ? m_ci.pColorBlendState : nullptr;
+  ci.pDynamicState = (dynamic_state.dynamicStateCount > 0) ? &dynamic_state : nullptr;
+  if (!pre_rasterization && !fragment_shader)
+    ci.layout = VK_NULL_HANDLE;
+  if (!pre_rasterization && !fragment_shader && !fragment_output)
+    ci.renderPass = VK_NULL_HANDLE;
+
+  VkPipeline pipeline;
+  VkResult res = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &ci, nullptr, &pipeline);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateGraphicsPipelines() for library failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  return pipeline;
+}
+
+VkPipeline Vulkan::GraphicsPipelineBuilder::LinkLibraries(VkDevice device, VkPipelineCache pipeline_cache,
+                                                          VkPipelineLayout layout,
+                                                          std::span<const VkPipeline> libraries)
+{
+  const VkPipelineLibraryCreateInfoKHR library_info = {VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR, nullptr,
+                                                       static_cast<u32>(libraries.size()), libraries.data()};
+
+  // No link-time optimization, linking needs to be fast enough to do during gameplay.
+  VkGraphicsPipelineCreateInfo ci = {};
+  ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  ci.pNext = &library_info;
+  ci.layout = layout;
+  ci.basePipelineIndex = -1;
+
+  VkPipeline pipeline;
+  VkResult res = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &ci, nullptr, &pipeline);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateGraphicsPipelines() for link failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  return pipeline;
+}
+
 void Vulkan::GraphicsPipelineBuilder::SetShaderStage(VkShaderStageFlagBits stage, VkShaderModule module,
                                                      const char* entry_point)
 {
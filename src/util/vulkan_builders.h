@@ -10,6 +10,7 @@
 
 #include <array>
 #include <cstdarg>
+#include <span>
 #include <string_view>
 
 #if defined(_DEBUG) && !defined(CPU_ARCH_ARM32) && !defined(CPU_ARCH_X86)
@@ -91,6 +92,13 @@ public:
 
   VkPipeline Create(VkDevice device, VkPipelineCache pipeline_cache = VK_NULL_HANDLE, bool clear = true);
 
+  /// Creates a graphics pipeline library from the parts of the current state selected by flags.
+  VkPipeline CreateLibrary(VkDevice device, VkPipelineCache pipeline_cache, VkGraphicsPipelineLibraryFlagsEXT flags);
+
+  /// Links a complete set of graphics pipeline libraries into an executable pipeline.
+  static VkPipeline LinkLibraries(VkDevice device, VkPipelineCache pipeline_cache, VkPipelineLayout layout,
+                                  std::span<const VkPipeline> libraries);
+
   void SetShaderStage(VkShaderStageFlagBits stage, VkShaderModule module, const char* entry_point);
   void SetVertexShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_VERTEX_BIT, module, "main"); }
   void SetGeometryShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_GEOMETRY_BIT, module, "main"); }
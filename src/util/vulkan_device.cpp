@@ -19,6 +19,7 @@
 #include "common/path.h"
 #include "common/scoped_guard.h"
 #include "common/small_string.h"
+#include "common/thirdparty/SmallVector.h"
 
 #include "fmt/format.h"
 #include "xxhash.h"
@@ -93,6 +94,10 @@ const std::array<VkFormat, static_cast<u32>(GPUTexture::Format::MaxCount)> Vulka
   VK_FORMAT_R16G16B16A16_SFLOAT,      // RGBA16F
   VK_FORMAT_R32G32B32A32_SFLOAT,      // RGBA32F
   VK_FORMAT_A2R10G10B10_UNORM_PACK32, // RGB10A2
+  VK_FORMAT_BC1_RGBA_UNORM_BLOCK,     // BC1
+  VK_FORMAT_BC2_UNORM_BLOCK,          // BC2
+  VK_FORMAT_BC3_UNORM_BLOCK,          // BC3
+  VK_FORMAT_BC7_UNORM_BLOCK,          // BC7
 };
 
 static constexpr VkClearValue s_present_clear_color = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
@@ -409,6 +414,11 @@ bool VulkanDevice::SelectDeviceExtensions(ExtensionList* extension_list, bool en
 
   m_optional_extensions.vk_ext_external_memory_host =
     SupportsExtension(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, false);
+  m_optional_extensions.vk_ext_graphics_pipeline_library =
+    SupportsExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, false) &&
+    SupportsExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, false);
+  m_optional_extensions.vk_ext_extended_dynamic_state =
+    SupportsExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, false);
 
 #ifdef _WIN32
   m_optional_extensions.vk_ext_full_screen_exclusive =
@@ -432,6 +442,9 @@ bool VulkanDevice::SelectDeviceFeatures()
   m_device_features.samplerAnisotropy = available_features.samplerAnisotropy;
   m_device_features.sampleRateShading = available_features.sampleRateShading;
   m_device_features.geometryShader = available_features.geometryShader;
+  m_device_features.textureCompressionBC = available_features.textureCompressionBC;
+  m_device_features.sparseBinding = available_features.sparseBinding;
+  m_device_features.sparseResidencyImage2D = available_features.sparseResidencyImage2D;
 
   return true;
 }
@@ -499,6 +512,22 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
     return false;
   }
 
+  // Transfer-only families map to the copy engines, which run alongside rendering. Families with a coarser transfer
+  // granularity can't do arbitrary sub-rect copies, so ignore those.
+  u32 transfer_queue_family_index = queue_family_count;
+  for (u32 i = 0; i < queue_family_count; i++)
+  {
+    const VkQueueFamilyProperties& props = queue_family_properties[i];
+    if ((props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) ==
+          VK_QUEUE_TRANSFER_BIT &&
+        props.queueCount > 0 && props.minImageTransferGranularity.width == 1 &&
+        props.minImageTransferGranularity.height == 1 && props.minImageTransferGranularity.depth == 1)
+    {
+      transfer_queue_family_index = i;
+      break;
+    }
+  }
+
   VkDeviceCreateInfo device_info = {};
   device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   device_info.pNext = nullptr;
@@ -506,7 +535,7 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
   device_info.queueCreateInfoCount = 0;
 
   static constexpr float queue_priorities[] = {1.0f};
-  std::array<VkDeviceQueueCreateInfo, 2> queue_infos;
+  std::array<VkDeviceQueueCreateInfo, 3> queue_infos;
   VkDeviceQueueCreateInfo& graphics_queue_info = queue_infos[device_info.queueCreateInfoCount++];
   graphics_queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
   graphics_queue_info.pNext = nullptr;
@@ -526,6 +555,17 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
     present_queue_info.pQueuePriorities = queue_priorities;
   }
 
+  if (transfer_queue_family_index != queue_family_count)
+  {
+    VkDeviceQueueCreateInfo& transfer_queue_info = queue_infos[device_info.queueCreateInfoCount++];
+    transfer_queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    transfer_queue_info.pNext = nullptr;
+    transfer_queue_info.flags = 0;
+    transfer_queue_info.queueFamilyIndex = transfer_queue_family_index;
+    transfer_queue_info.queueCount = 1;
+    transfer_queue_info.pQueuePriorities = queue_priorities;
+  }
+
   device_info.pQueueCreateInfos = queue_infos.data();
 
   ExtensionList enabled_extensions;
@@ -556,6 +596,10 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES, nullptr, VK_TRUE};
   VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR dynamic_rendering_local_read_feature = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR, nullptr, VK_TRUE};
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT, nullptr, VK_TRUE};
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extended_dynamic_state_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT, nullptr, VK_TRUE};
 
   if (m_optional_extensions.vk_ext_rasterization_order_attachment_access)
     Vulkan::AddPointerToChain(&device_info, &rasterization_order_access_feature);
@@ -565,6 +609,10 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
     if (m_optional_extensions.vk_khr_dynamic_rendering_local_read)
       Vulkan::AddPointerToChain(&device_info, &dynamic_rendering_local_read_feature);
   }
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    Vulkan::AddPointerToChain(&device_info, &graphics_pipeline_library_feature);
+  if (m_optional_extensions.vk_ext_extended_dynamic_state)
+    Vulkan::AddPointerToChain(&device_info, &extended_dynamic_state_feature);
 
   VkResult res = vkCreateDevice(m_physical_device, &device_info, nullptr, &m_device);
   if (res != VK_SUCCESS)
@@ -581,6 +629,12 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
   vkGetDeviceQueue(m_device, m_graphics_queue_family_index, 0, &m_graphics_queue);
   if (surface)
     vkGetDeviceQueue(m_device, m_present_queue_family_index, 0, &m_present_queue);
+  if (transfer_queue_family_index != queue_family_count)
+  {
+    m_transfer_queue_family_index = transfer_queue_family_index;
+    vkGetDeviceQueue(m_device, m_transfer_queue_family_index, 0, &m_transfer_queue);
+    Log_DevFmt("Using dedicated transfer queue family {}", m_transfer_queue_family_index);
+  }
 
   m_features.gpu_timing = (m_device_properties.limits.timestampComputeAndGraphics != 0 &&
                            queue_family_properties[m_graphics_queue_family_index].timestampValidBits > 0 &&
@@ -590,6 +644,14 @@ bool VulkanDevice::CreateDevice(VkSurfaceKHR surface, bool enable_validation_lay
                 static_cast<u32>(m_device_properties.limits.timestampComputeAndGraphics),
                 queue_family_properties[m_graphics_queue_family_index].timestampValidBits,
                 m_device_properties.limits.timestampPeriod);
+  m_features.gpu_timing_regions = m_features.gpu_timing;
+
+  // Uncommitted tiles have to read as zero, otherwise we'd have to clear the whole texture up front.
+  m_features.sparse_textures =
+    (m_device_features.sparseBinding && m_device_features.sparseResidencyImage2D &&
+     m_device_properties.sparseProperties.residencyNonResidentStrict &&
+     (queue_family_properties[m_graphics_queue_family_index].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0);
+  Log_DevFmt("Sparse textures are {}", m_features.sparse_textures ? "supported" : "not supported");
 
   ProcessDeviceExtensions();
   return true;
@@ -606,6 +668,10 @@ void VulkanDevice::ProcessDeviceExtensions()
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES, nullptr, VK_FALSE};
   VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR dynamic_rendering_local_read_feature = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR, nullptr, VK_FALSE};
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT, nullptr, VK_FALSE};
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extended_dynamic_state_feature = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT, nullptr, VK_FALSE};
 
   // add in optional feature structs
   if (m_optional_extensions.vk_ext_rasterization_order_attachment_access)
@@ -616,6 +682,10 @@ void VulkanDevice::ProcessDeviceExtensions()
     if (m_optional_extensions.vk_khr_dynamic_rendering_local_read)
       Vulkan::AddPointerToChain(&features2, &dynamic_rendering_local_read_feature);
   }
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    Vulkan::AddPointerToChain(&features2, &graphics_pipeline_library_feature);
+  if (m_optional_extensions.vk_ext_extended_dynamic_state)
+    Vulkan::AddPointerToChain(&features2, &extended_dynamic_state_feature);
 
   // we might not have VK_KHR_get_physical_device_properties2...
   if (!vkGetPhysicalDeviceFeatures2 || !vkGetPhysicalDeviceProperties2 || !vkGetPhysicalDeviceMemoryProperties2)
@@ -648,12 +718,19 @@ void VulkanDevice::ProcessDeviceExtensions()
   m_optional_extensions.vk_khr_dynamic_rendering &= (dynamic_rendering_feature.dynamicRendering == VK_TRUE);
   m_optional_extensions.vk_khr_dynamic_rendering_local_read &=
     (dynamic_rendering_local_read_feature.dynamicRenderingLocalRead == VK_TRUE);
+  m_optional_extensions.vk_ext_graphics_pipeline_library &=
+    (graphics_pipeline_library_feature.graphicsPipelineLibrary == VK_TRUE);
+  m_optional_extensions.vk_ext_extended_dynamic_state &=
+    (extended_dynamic_state_feature.extendedDynamicState == VK_TRUE && vkCmdSetDepthTestEnableEXT &&
+     vkCmdSetDepthWriteEnableEXT && vkCmdSetDepthCompareOpEXT);
 
   VkPhysicalDeviceProperties2 properties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, nullptr, {}};
   VkPhysicalDevicePushDescriptorPropertiesKHR push_descriptor_properties = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR, nullptr, 0u};
   VkPhysicalDeviceExternalMemoryHostPropertiesEXT external_memory_host_properties = {
     VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT, nullptr, 0};
+  VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphics_pipeline_library_properties = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT, nullptr, VK_FALSE, VK_FALSE};
 
   if (m_optional_extensions.vk_khr_driver_properties)
   {
@@ -666,6 +743,9 @@ void VulkanDevice::ProcessDeviceExtensions()
   if (m_optional_extensions.vk_ext_external_memory_host)
     Vulkan::AddPointerToChain(&properties2, &external_memory_host_properties);
 
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+    Vulkan::AddPointerToChain(&properties2, &graphics_pipeline_library_properties);
+
   // don't bother querying if we're not actually looking at any features
   if (vkGetPhysicalDeviceProperties2 && properties2.pNext)
     vkGetPhysicalDeviceProperties2(m_physical_device, &properties2);
@@ -676,6 +756,10 @@ void VulkanDevice::ProcessDeviceExtensions()
   m_optional_extensions.vk_ext_external_memory_host &=
     (external_memory_host_properties.minImportedHostPointerAlignment == HOST_PAGE_SIZE);
 
+  // Libraries are only worth it if linking is cheap, otherwise we're better off with monolithic pipelines.
+  m_optional_extensions.vk_ext_graphics_pipeline_library &=
+    (graphics_pipeline_library_properties.graphicsPipelineLibraryFastLinking == VK_TRUE);
+
   if (IsBrokenMobileDriver())
   {
     // Push descriptor is broken on Adreno v502.. don't want to think about dynamic rendending.
@@ -710,6 +794,10 @@ void VulkanDevice::ProcessDeviceExtensions()
               m_optional_extensions.vk_khr_push_descriptor ? "supported" : "NOT supported");
   Log_InfoFmt("VK_EXT_external_memory_host is {}",
               m_optional_extensions.vk_ext_external_memory_host ? "supported" : "NOT supported");
+  Log_InfoFmt("VK_EXT_graphics_pipeline_library is {}",
+              m_optional_extensions.vk_ext_graphics_pipeline_library ? "supported" : "NOT supported");
+  Log_InfoFmt("VK_EXT_extended_dynamic_state is {}",
+              m_optional_extensions.vk_ext_extended_dynamic_state ? "supported" : "NOT supported");
 }
 
 bool VulkanDevice::CreateAllocator()
@@ -851,6 +939,34 @@ bool VulkanDevice::CreateCommandBuffers()
     }
     Vulkan::SetObjectName(m_device, resources.fence, TinyString::from_format("Frame Fence {}", frame_index));
 
+    if (m_features.sparse_textures)
+    {
+      const VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0};
+      res = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &resources.sparse_bind_semaphore);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+        return false;
+      }
+      Vulkan::SetObjectName(m_device, resources.sparse_bind_semaphore,
+                            TinyString::from_format("Frame Sparse Bind Semaphore {}", frame_index));
+    }
+
+    if (m_transfer_queue != VK_NULL_HANDLE)
+    {
+      const VkCommandPoolCreateInfo transfer_pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr,
+                                                          VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                                          m_transfer_queue_family_index};
+      res = vkCreateCommandPool(m_device, &transfer_pool_info, nullptr, &resources.transfer_command_pool);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateCommandPool failed: ");
+        return false;
+      }
+      Vulkan::SetObjectName(m_device, resources.transfer_command_pool,
+                            TinyString::from_format("Frame Transfer Command Pool {}", frame_index));
+    }
+
     u32 num_pools = 0;
     VkDescriptorPoolSize pool_sizes[2];
     if (!m_optional_extensions.vk_khr_push_descriptor)
@@ -885,6 +1001,17 @@ void VulkanDevice::DestroyCommandBuffers()
   {
     if (resources.fence != VK_NULL_HANDLE)
       vkDestroyFence(m_device, resources.fence, nullptr);
+    if (resources.sparse_bind_semaphore != VK_NULL_HANDLE)
+      vkDestroySemaphore(m_device, resources.sparse_bind_semaphore, nullptr);
+    for (const auto& [cmdbuf, semaphore] : resources.transfer_submissions)
+    {
+      vkFreeCommandBuffers(m_device, resources.transfer_command_pool, 1, &cmdbuf);
+      vkDestroySemaphore(m_device, semaphore, nullptr);
+    }
+    resources.transfer_submissions.clear();
+    resources.num_transfer_submissions = 0;
+    if (resources.transfer_command_pool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(m_device, resources.transfer_command_pool, nullptr);
     if (resources.descriptor_pool != VK_NULL_HANDLE)
       vkDestroyDescriptorPool(m_device, resources.descriptor_pool, nullptr);
     if (resources.command_buffers[0] != VK_NULL_HANDLE)
@@ -921,13 +1048,18 @@ bool VulkanDevice::CreatePersistentDescriptorPool()
 
   if (m_features.gpu_timing)
   {
-    const VkQueryPoolCreateInfo query_create_info = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP, NUM_COMMAND_BUFFERS * 4, 0};
+    const VkQueryPoolCreateInfo query_create_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                                     nullptr,
+                                                     0,
+                                                     VK_QUERY_TYPE_TIMESTAMP,
+                                                     NUM_COMMAND_BUFFERS * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER,
+                                                     0};
     res = vkCreateQueryPool(m_device, &query_create_info, nullptr, &m_timestamp_query_pool);
     if (res != VK_SUCCESS)
     {
       LOG_VULKAN_ERROR(res, "vkCreateQueryPool failed: ");
       m_features.gpu_timing = false;
+      m_features.gpu_timing_regions = false;
       return false;
     }
   }
@@ -1093,6 +1225,75 @@ VkCommandBuffer VulkanDevice::GetCurrentInitCommandBuffer()
   return buf;
 }
 
+VkCommandBuffer VulkanDevice::BeginTransferCommandBuffer()
+{
+  DebugAssert(m_transfer_queue != VK_NULL_HANDLE);
+
+  CommandBuffer& res = m_frame_resources[m_current_frame];
+  if (res.num_transfer_submissions == res.transfer_submissions.size())
+  {
+    const VkCommandBufferAllocateInfo buffer_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, nullptr,
+                                                     res.transfer_command_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1u};
+    VkCommandBuffer cmdbuf;
+    VkResult vres = vkAllocateCommandBuffers(m_device, &buffer_info, &cmdbuf);
+    if (vres != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(vres, "vkAllocateCommandBuffers() for transfer failed: ");
+      return VK_NULL_HANDLE;
+    }
+
+    const VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0};
+    VkSemaphore semaphore;
+    vres = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &semaphore);
+    if (vres != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(vres, "vkCreateSemaphore() for transfer failed: ");
+      vkFreeCommandBuffers(m_device, res.transfer_command_pool, 1, &cmdbuf);
+      return VK_NULL_HANDLE;
+    }
+
+    res.transfer_submissions.emplace_back(cmdbuf, semaphore);
+  }
+
+  const VkCommandBuffer cmdbuf = res.transfer_submissions[res.num_transfer_submissions].first;
+  const VkCommandBufferBeginInfo bi = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
+                                       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr};
+  const VkResult vres = vkBeginCommandBuffer(cmdbuf, &bi);
+  if (vres != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(vres, "vkBeginCommandBuffer() for transfer failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  return cmdbuf;
+}
+
+bool VulkanDevice::SubmitTransferCommandBuffer()
+{
+  CommandBuffer& res = m_frame_resources[m_current_frame];
+  const auto& [cmdbuf, semaphore] = res.transfer_submissions[res.num_transfer_submissions];
+
+  VkResult vres = vkEndCommandBuffer(cmdbuf);
+  if (vres != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(vres, "vkEndCommandBuffer() for transfer failed: ");
+    return false;
+  }
+
+  const VkSubmitInfo submit_info = {
+    VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, 0u, nullptr, nullptr, 1u, &cmdbuf, 1u, &semaphore};
+  vres = vkQueueSubmit(m_transfer_queue, 1, &submit_info, VK_NULL_HANDLE);
+  if (vres != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(vres, "vkQueueSubmit() for transfer failed: ");
+    m_last_submit_failed.store(true, std::memory_order_release);
+    return false;
+  }
+
+  res.num_transfer_submissions++;
+  return true;
+}
+
 VkDescriptorSet VulkanDevice::AllocateDescriptorSet(VkDescriptorSetLayout set_layout)
 {
   VkDescriptorSetAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr,
@@ -1166,6 +1367,17 @@ bool VulkanDevice::SetGPUTimingEnabled(bool enabled)
   return (enabled == m_gpu_timing_enabled);
 }
 
+void VulkanDevice::WriteGPUTimingRegionChange()
+{
+  CommandBuffer& resources = m_frame_resources[m_current_frame];
+  if (!resources.timestamp_written || resources.num_timing_regions > MAX_GPU_TIMING_REGION_CHANGES)
+    return;
+
+  vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
+                      m_current_frame * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + resources.num_timing_regions);
+  resources.timing_regions[resources.num_timing_regions++] = m_gpu_timing_region;
+}
+
 void VulkanDevice::WaitForCommandBufferCompletion(u32 index)
 {
   // We might be waiting for the buffer we just submitted to the worker thread.
@@ -1209,19 +1421,23 @@ void VulkanDevice::WaitForCommandBufferCompletion(u32 index)
 
     if (m_gpu_timing_enabled && resources.timestamp_written)
     {
-      std::array<u64, 2> timestamps;
-      VkResult res =
-        vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * 2, static_cast<u32>(timestamps.size()),
-                              sizeof(u64) * timestamps.size(), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+      // Timestamps are laid out as start, region changes, end.
+      std::array<u64, NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER> timestamps;
+      const u32 num_timestamps = resources.num_timing_regions + 1;
+      VkResult res = vkGetQueryPoolResults(
+        m_device, m_timestamp_query_pool, cleanup_index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, num_timestamps,
+        sizeof(u64) * num_timestamps, timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
       if (res == VK_SUCCESS)
       {
         // if we didn't write the timestamp at the start of the cmdbuffer (just enabled timing), the first TS will be
         // zero
         if (timestamps[0] > 0 && m_gpu_timing_enabled)
         {
-          const double ns_diff =
-            (timestamps[1] - timestamps[0]) * static_cast<double>(m_device_properties.limits.timestampPeriod);
-          m_accumulated_gpu_time += static_cast<float>(ns_diff / 1000000.0);
+          const double ms_per_tick = static_cast<double>(m_device_properties.limits.timestampPeriod) / 1000000.0;
+          m_accumulated_gpu_time +=
+            static_cast<float>(static_cast<double>(timestamps[num_timestamps - 1] - timestamps[0]) * ms_per_tick);
+          AccumulateGPUTimingRegions(timestamps.data(), resources.timing_regions.data(), resources.num_timing_regions,
+                                     ms_per_tick);
         }
       }
       else
@@ -1267,7 +1483,7 @@ void VulkanDevice::EndAndSubmitCommandBuffer(VulkanSwapChain* present_swap_chain
   if (m_gpu_timing_enabled && resources.timestamp_written)
   {
     vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        m_current_frame * 2 + 1);
+                        m_current_frame * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + resources.num_timing_regions);
   }
 
   res = vkEndCommandBuffer(resources.command_buffers[1]);
@@ -1301,7 +1517,26 @@ void VulkanDevice::DoSubmitCommandBuffer(u32 index, VulkanSwapChain* present_swa
 {
   CommandBuffer& resources = m_frame_resources[index];
 
-  uint32_t wait_bits = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  // Transfers are only waited on by this submission, so there can be a few of them.
+  llvm::SmallVector<VkSemaphore, 4> wait_semaphores;
+  llvm::SmallVector<VkPipelineStageFlags, 4> wait_stages;
+  for (u32 i = 0; i < resources.num_transfer_submissions; i++)
+  {
+    wait_semaphores.push_back(resources.transfer_submissions[i].second);
+    wait_stages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+  }
+  if (!resources.sparse_binds.empty())
+  {
+    if (!SubmitSparseBinds(resources))
+    {
+      m_last_submit_failed.store(true, std::memory_order_release);
+      return;
+    }
+
+    wait_semaphores.push_back(resources.sparse_bind_semaphore);
+    wait_stages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+  }
+
   VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
                               nullptr,
                               0u,
@@ -1315,14 +1550,20 @@ void VulkanDevice::DoSubmitCommandBuffer(u32 index, VulkanSwapChain* present_swa
 
   if (present_swap_chain)
   {
-    submit_info.pWaitSemaphores = present_swap_chain->GetImageAvailableSemaphorePtr();
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitDstStageMask = &wait_bits;
+    wait_semaphores.push_back(*present_swap_chain->GetImageAvailableSemaphorePtr());
+    wait_stages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
     submit_info.pSignalSemaphores = present_swap_chain->GetRenderingFinishedSemaphorePtr();
     submit_info.signalSemaphoreCount = 1;
   }
 
+  if (!wait_semaphores.empty())
+  {
+    submit_info.waitSemaphoreCount = static_cast<u32>(wait_semaphores.size());
+    submit_info.pWaitSemaphores = wait_semaphores.data();
+    submit_info.pWaitDstStageMask = wait_stages.data();
+  }
+
   const VkResult res = vkQueueSubmit(m_graphics_queue, 1, &submit_info, resources.fence);
   if (res != VK_SUCCESS)
   {
@@ -1332,6 +1573,57 @@ void VulkanDevice::DoSubmitCommandBuffer(u32 index, VulkanSwapChain* present_swa
   }
 }
 
+bool VulkanDevice::SubmitSparseBinds(CommandBuffer& resources)
+{
+  // Binds are queued a texture at a time, so group runs for the same image.
+  std::vector<VkSparseImageMemoryBind> binds;
+  std::vector<VkSparseImageMemoryBindInfo> image_binds;
+  binds.reserve(resources.sparse_binds.size());
+  for (const auto& [image, bind] : resources.sparse_binds)
+  {
+    if (image_binds.empty() || image_binds.back().image != image)
+      image_binds.push_back({image, 0, nullptr});
+
+    image_binds.back().bindCount++;
+    binds.push_back(bind);
+  }
+
+  const VkSparseImageMemoryBind* next_bind = binds.data();
+  for (VkSparseImageMemoryBindInfo& info : image_binds)
+  {
+    info.pBinds = next_bind;
+    next_bind += info.bindCount;
+  }
+
+  resources.sparse_binds.clear();
+
+  const VkBindSparseInfo bind_info = {VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+                                      nullptr,
+                                      0u,
+                                      nullptr,
+                                      0u,
+                                      nullptr,
+                                      0u,
+                                      nullptr,
+                                      static_cast<u32>(image_binds.size()),
+                                      image_binds.data(),
+                                      1u,
+                                      &resources.sparse_bind_semaphore};
+  const VkResult res = vkQueueBindSparse(m_graphics_queue, 1, &bind_info, VK_NULL_HANDLE);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkQueueBindSparse failed: ");
+    return false;
+  }
+
+  return true;
+}
+
+void VulkanDevice::QueueSparseImageBind(VkImage image, const VkSparseImageMemoryBind& bind)
+{
+  m_frame_resources[m_current_frame].sparse_binds.emplace_back(image, bind);
+}
+
 void VulkanDevice::DoPresent(VulkanSwapChain* present_swap_chain)
 {
   const VkPresentInfoKHR present_info = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -1444,6 +1736,15 @@ void VulkanDevice::BeginCommandBuffer(u32 index)
   if (res != VK_SUCCESS)
     LOG_VULKAN_ERROR(res, "vkResetCommandPool failed: ");
 
+  // Transfers were waited on by the graphics submission, so they're done too.
+  if (resources.num_transfer_submissions > 0)
+  {
+    res = vkResetCommandPool(m_device, resources.transfer_command_pool, 0);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetCommandPool() for transfer failed: ");
+    resources.num_transfer_submissions = 0;
+  }
+
   // Enable commands to be recorded to the two buffers again.
   VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr};
@@ -1461,14 +1762,17 @@ void VulkanDevice::BeginCommandBuffer(u32 index)
 
   if (m_gpu_timing_enabled)
   {
-    vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool, index * 2, 2);
+    vkCmdResetQueryPool(resources.command_buffers[1], m_timestamp_query_pool,
+                        index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
     vkCmdWriteTimestamp(resources.command_buffers[1], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        index * 2);
+                        index * NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
   }
 
   resources.fence_counter = m_next_fence_counter++;
   resources.init_buffer_used = false;
   resources.timestamp_written = m_gpu_timing_enabled;
+  resources.num_timing_regions = 1;
+  resources.timing_regions[0] = m_gpu_timing_region;
 
   m_current_frame = index;
   m_current_command_buffer = resources.command_buffers[1];
@@ -1550,6 +1854,15 @@ void VulkanDevice::DeferImageDestruction(VkImage object, VmaAllocation allocatio
                                  [this, object, allocation]() { vmaDestroyImage(m_allocator, object, allocation); });
 }
 
+void VulkanDevice::DeferSparseImageDestruction(VkImage object, std::vector<VkDeviceMemory> memory)
+{
+  m_cleanup_objects.emplace_back(GetCurrentFenceCounter(), [this, object, memory = std::move(memory)]() {
+    vkDestroyImage(m_device, object, nullptr);
+    for (VkDeviceMemory it : memory)
+      vkFreeMemory(m_device, it, nullptr);
+  });
+}
+
 void VulkanDevice::DeferImageViewDestruction(VkImageView object)
 {
   m_cleanup_objects.emplace_back(GetCurrentFenceCounter(),
@@ -2104,6 +2417,8 @@ void VulkanDevice::DestroyDevice()
   DestroyCommandBuffers();
   DestroyAllocator();
 
+  DestroyPipelineLibraries();
+
   for (auto& it : m_render_pass_cache)
     vkDestroyRenderPass(m_device, it.second, nullptr);
   m_render_pass_cache.clear();
@@ -2239,6 +2554,37 @@ bool VulkanDevice::GetPipelineCacheData(DynamicHeapArray<u8>* data)
   return true;
 }
 
+bool VulkanDevice::MergePipelineCache(std::span<const u8> data)
+{
+  if (m_pipeline_cache == VK_NULL_HANDLE || data.size() < sizeof(VK_PIPELINE_CACHE_HEADER))
+    return false;
+
+  VK_PIPELINE_CACHE_HEADER header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (!ValidatePipelineCacheHeader(header))
+    return false;
+
+  const VkPipelineCacheCreateInfo ci{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, nullptr, 0, data.size(),
+                                     data.data()};
+  VkPipelineCache src_cache;
+  VkResult res = vkCreatePipelineCache(m_device, &ci, nullptr, &src_cache);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreatePipelineCache() for merge failed: ");
+    return false;
+  }
+
+  res = vkMergePipelineCaches(m_device, m_pipeline_cache, 1, &src_cache);
+  vkDestroyPipelineCache(m_device, src_cache, nullptr);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkMergePipelineCaches() failed: ");
+    return false;
+  }
+
+  return true;
+}
+
 bool VulkanDevice::UpdateWindow()
 {
   DestroySurface();
@@ -2309,6 +2655,9 @@ void VulkanDevice::DestroySurface()
 
 bool VulkanDevice::SupportsTextureFormat(GPUTexture::Format format) const
 {
+  if (GPUTexture::IsCompressedFormat(format) && !m_device_features.textureCompressionBC)
+    return false;
+
   return (TEXTURE_FORMAT_MAPPING[static_cast<u8>(format)] != VK_FORMAT_UNDEFINED);
 }
 
@@ -2436,7 +2785,8 @@ void VulkanDevice::EndPresent(bool explicit_present)
   VulkanTexture::TransitionSubresourcesToLayout(cmdbuf, m_swap_chain->GetCurrentImage(), GPUTexture::Type::RenderTarget,
                                                 0, 1, 0, 1, VulkanTexture::Layout::ColorAttachment,
                                                 VulkanTexture::Layout::PresentSrc);
-  EndAndSubmitCommandBuffer(m_swap_chain.get(), explicit_present, !m_swap_chain->IsPresentModeSynchronizing());
+  EndAndSubmitCommandBuffer(m_swap_chain.get(), explicit_present,
+                            !m_swap_chain->IsPresentModeSynchronizing() || m_non_blocking_present);
   MoveToNextCommandBuffer();
   InvalidateCachedState();
   TrimTexturePool();
@@ -2448,6 +2798,19 @@ void VulkanDevice::SubmitPresent()
   DoPresent(m_swap_chain.get());
 }
 
+bool VulkanDevice::IsPresentPending() const
+{
+  return !m_present_done.load(std::memory_order_acquire);
+}
+
+void VulkanDevice::FlushCommands()
+{
+  if (InRenderPass())
+    EndRenderPass();
+
+  SubmitCommandBuffer(false);
+}
+
 #ifdef _DEBUG
 static std::array<float, 3> Palette(float phase, const std::array<float, 3>& a, const std::array<float, 3>& b,
                                     const std::array<float, 3>& c, const std::array<float, 3>& d)
@@ -2571,6 +2934,7 @@ bool VulkanDevice::CheckFeatures(FeatureMask disabled_features)
   m_features.shader_cache = true;
   m_features.pipeline_cache = true;
   m_features.prefer_unused_textures = true;
+  m_features.threaded_shader_compile = true;
 
   return true;
 }
@@ -3515,7 +3879,7 @@ void VulkanDevice::SetPipeline(GPUPipeline* pipeline)
 
   m_current_pipeline = static_cast<VulkanPipeline*>(pipeline);
 
-  vkCmdBindPipeline(m_current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_current_pipeline->GetPipeline());
+  m_current_pipeline->Bind(m_current_command_buffer);
 
   if (m_current_pipeline_layout != m_current_pipeline->GetLayout())
   {
@@ -3567,7 +3931,7 @@ void VulkanDevice::SetInitialPipelineState()
   vkCmdBindIndexBuffer(cmdbuf, m_index_buffer.GetBuffer(), 0, VK_INDEX_TYPE_UINT16);
 
   m_current_pipeline_layout = m_current_pipeline->GetLayout();
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_current_pipeline->GetPipeline());
+  m_current_pipeline->Bind(cmdbuf);
 
   const VkViewport vp = {static_cast<float>(m_current_viewport.left),
                          static_cast<float>(m_current_viewport.top),
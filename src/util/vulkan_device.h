@@ -27,6 +27,10 @@ class VulkanTexture;
 class VulkanTextureBuffer;
 class VulkanDownloadTexture;
 
+namespace Vulkan {
+class GraphicsPipelineBuilder;
+}
+
 struct VK_PIPELINE_CACHE_HEADER;
 
 class VulkanDevice final : public GPUDevice
@@ -38,6 +42,9 @@ public:
   enum : u32
   {
     NUM_COMMAND_BUFFERS = 3,
+
+    /// Start/End timestamps, and one for each timing region change.
+    NUM_TIMESTAMP_QUERIES_PER_COMMAND_BUFFER = 2 + MAX_GPU_TIMING_REGION_CHANGES,
   };
 
   struct OptionalExtensions
@@ -55,6 +62,8 @@ public:
     bool vk_khr_push_descriptor : 1;
     bool vk_khr_shader_non_semantic_info : 1;
     bool vk_ext_external_memory_host : 1;
+    bool vk_ext_graphics_pipeline_library : 1;
+    bool vk_ext_extended_dynamic_state : 1;
   };
 
   static GPUTexture::Format GetFormatForVkFormat(VkFormat format);
@@ -81,6 +90,8 @@ public:
   std::unique_ptr<GPUTexture> CreateTexture(u32 width, u32 height, u32 layers, u32 levels, u32 samples,
                                             GPUTexture::Type type, GPUTexture::Format format,
                                             const void* data = nullptr, u32 data_stride = 0) override;
+  std::unique_ptr<GPUTexture> CreateSparseTexture(u32 width, u32 height, GPUTexture::Type type,
+                                                  GPUTexture::Format format) override;
   std::unique_ptr<GPUSampler> CreateSampler(const GPUSampler::Config& config) override;
   std::unique_ptr<GPUTextureBuffer> CreateTextureBuffer(GPUTextureBuffer::Format format, u32 size_in_elements) override;
 
@@ -101,6 +112,8 @@ public:
   std::unique_ptr<GPUShader> CreateShaderFromBinary(GPUShaderStage stage, std::span<const u8> data) override;
   std::unique_ptr<GPUShader> CreateShaderFromSource(GPUShaderStage stage, std::string_view source,
                                                     const char* entry_point, DynamicHeapArray<u8>* out_binary) override;
+  bool CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                             DynamicHeapArray<u8>* out_binary) override;
   std::unique_ptr<GPUPipeline> CreatePipeline(const GPUPipeline::GraphicsConfig& config) override;
 
   void PushDebugGroup(const char* name) override;
@@ -134,6 +147,8 @@ public:
   bool BeginPresent(bool skip_present) override;
   void EndPresent(bool explicit_present) override;
   void SubmitPresent() override;
+  bool IsPresentPending() const override;
+  void FlushCommands() override;
 
   // Global state accessors
   ALWAYS_INLINE static VulkanDevice& GetInstance() { return *static_cast<VulkanDevice*>(g_gpu_device.get()); }
@@ -143,6 +158,8 @@ public:
   ALWAYS_INLINE VkPhysicalDevice GetVulkanPhysicalDevice() const { return m_physical_device; }
   ALWAYS_INLINE u32 GetGraphicsQueueFamilyIndex() const { return m_graphics_queue_family_index; }
   ALWAYS_INLINE u32 GetPresentQueueFamilyIndex() const { return m_present_queue_family_index; }
+  ALWAYS_INLINE bool HasTransferQueue() const { return (m_transfer_queue != VK_NULL_HANDLE); }
+  ALWAYS_INLINE u32 GetTransferQueueFamilyIndex() const { return m_transfer_queue_family_index; }
   ALWAYS_INLINE const OptionalExtensions& GetOptionalExtensions() const { return m_optional_extensions; }
 
   /// Returns true if Vulkan is suitable as a default for the devices in the system.
@@ -175,6 +192,16 @@ public:
   ALWAYS_INLINE VulkanStreamBuffer& GetTextureUploadBuffer() { return m_texture_upload_buffer; }
   VkCommandBuffer GetCurrentInitCommandBuffer();
 
+  /// Uploads at least this large into textures the graphics queue hasn't touched yet go through the transfer queue.
+  static constexpr u32 MIN_TRANSFER_QUEUE_UPLOAD_SIZE = 64 * 1024;
+
+  /// Begins a command buffer for the dedicated transfer queue. Only valid if HasTransferQueue() is true.
+  VkCommandBuffer BeginTransferCommandBuffer();
+
+  /// Submits the command buffer from BeginTransferCommandBuffer() immediately. The next graphics submission waits for
+  /// it to complete, and resources used by it are released along with that submission's.
+  bool SubmitTransferCommandBuffer();
+
   /// Allocates a descriptor set from the pool reserved for the current frame.
   VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout set_layout);
 
@@ -201,11 +228,19 @@ public:
   void DeferBufferDestruction(VkBuffer object, VkDeviceMemory memory);
   void DeferFramebufferDestruction(VkFramebuffer object);
   void DeferImageDestruction(VkImage object, VmaAllocation allocation);
+  void DeferSparseImageDestruction(VkImage object, std::vector<VkDeviceMemory> memory);
   void DeferImageViewDestruction(VkImageView object);
   void DeferPipelineDestruction(VkPipeline object);
   void DeferBufferViewDestruction(VkBufferView object);
   void DeferPersistentDescriptorSetDestruction(VkDescriptorSet object);
 
+  // Drops any pipeline libraries built from a shader module which is being destroyed, so a new module reusing the
+  // handle can't pick them up.
+  void DestroyPipelineLibrariesForShader(VkShaderModule module);
+
+  // Binds memory to a sparse image before the current command buffer executes.
+  void QueueSparseImageBind(VkImage image, const VkSparseImageMemoryBind& bind);
+
   // Wait for a fence to be completed.
   // Also invokes callbacks for completion.
   void WaitForFenceCounter(u64 fence_counter);
@@ -228,6 +263,9 @@ protected:
 
   bool ReadPipelineCache(const std::string& filename) override;
   bool GetPipelineCacheData(DynamicHeapArray<u8>* data) override;
+  bool MergePipelineCache(std::span<const u8> data) override;
+
+  void WriteGPUTimingRegionChange() override;
 
 private:
   enum DIRTY_FLAG : u32
@@ -280,10 +318,30 @@ private:
     bool init_buffer_used = false;
     bool needs_fence_wait = false;
     bool timestamp_written = false;
+
+    // Region active after each timestamp, the first being the start of the command buffer.
+    u32 num_timing_regions = 0;
+    std::array<u8, MAX_GPU_TIMING_REGION_CHANGES + 1> timing_regions;
+
+    // Sparse tiles to bind before the command buffer executes. The submission waits on the semaphore.
+    std::vector<std::pair<VkImage, VkSparseImageMemoryBind>> sparse_binds;
+    VkSemaphore sparse_bind_semaphore = VK_NULL_HANDLE;
+
+    // Uploads submitted to the transfer queue while this command buffer was current, each signaling its semaphore.
+    VkCommandPool transfer_command_pool = VK_NULL_HANDLE;
+    std::vector<std::pair<VkCommandBuffer, VkSemaphore>> transfer_submissions;
+    u32 num_transfer_submissions = 0;
+  };
+
+  struct PipelineLibrary
+  {
+    VkPipeline pipeline;
+    std::array<VkShaderModule, 2> shaders;
   };
 
   using CleanupObjectFunction = void (*)(VulkanDevice& dev, void* obj);
   using SamplerMap = std::unordered_map<u64, VkSampler>;
+  using PipelineLibraryMap = std::unordered_map<std::string, PipelineLibrary>;
 
   static void GetAdapterAndModeList(AdapterAndModeList* ret, VkInstance instance);
 
@@ -339,6 +397,14 @@ private:
   bool CreateBuffers();
   void DestroyBuffers();
   bool CreatePipelineLayouts();
+
+  /// Builds a pipeline by linking separately-compiled vertex input, pre-rasterization, fragment shader and fragment
+  /// output libraries. Libraries are shared between pipelines, so e.g. blend variants only need a new output library.
+  VkPipeline CreatePipelineFromLibraries(const GPUPipeline::GraphicsConfig& config, VkRenderPass render_pass,
+                                         Vulkan::GraphicsPipelineBuilder& gpb);
+  VkPipeline GetPipelineLibrary(std::string key, VkGraphicsPipelineLibraryFlagsEXT flags,
+                                Vulkan::GraphicsPipelineBuilder& gpb, VkShaderModule shader0, VkShaderModule shader1);
+  void DestroyPipelineLibraries();
   void DestroyPipelineLayouts();
   bool CreatePersistentDescriptorSets();
   void DestroyPersistentDescriptorSets();
@@ -381,6 +447,7 @@ private:
   void WaitForCommandBufferCompletion(u32 index);
 
   void DoSubmitCommandBuffer(u32 index, VulkanSwapChain* present_swap_chain);
+  bool SubmitSparseBinds(CommandBuffer& resources);
   void DoPresent(VulkanSwapChain* present_swap_chain);
   void WaitForPresentComplete(std::unique_lock<std::mutex>& lock);
   void PresentThread();
@@ -400,6 +467,8 @@ private:
   VkQueue m_present_queue = VK_NULL_HANDLE;
   u32 m_graphics_queue_family_index = 0;
   u32 m_present_queue_family_index = 0;
+  VkQueue m_transfer_queue = VK_NULL_HANDLE;
+  u32 m_transfer_queue_family_index = 0;
 
   VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
   float m_accumulated_gpu_time = 0.0f;
@@ -430,6 +499,7 @@ private:
   std::unordered_map<RenderPassCacheKey, VkRenderPass, RenderPassCacheKeyHash> m_render_pass_cache;
   GPUFramebufferManager<VkFramebuffer, CreateFramebuffer, DestroyFramebuffer> m_framebuffer_manager;
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+  PipelineLibraryMap m_pipeline_libraries;
 
   // TODO: Move to static?
   VkDebugUtilsMessengerEXT m_debug_messenger_callback = VK_NULL_HANDLE;
@@ -8,6 +8,8 @@
 #include "common/assert.h"
 #include "common/log.h"
 
+#include <algorithm>
+
 Log_SetChannel(VulkanDevice);
 
 VulkanShader::VulkanShader(GPUShaderStage stage, VkShaderModule mod) : GPUShader(stage), m_module(mod)
@@ -16,7 +18,9 @@ VulkanShader::VulkanShader(GPUShaderStage stage, VkShaderModule mod) : GPUShader
 
 VulkanShader::~VulkanShader()
 {
-  vkDestroyShaderModule(VulkanDevice::GetInstance().GetVulkanDevice(), m_module, nullptr);
+  VulkanDevice& dev = VulkanDevice::GetInstance();
+  dev.DestroyPipelineLibrariesForShader(m_module);
+  vkDestroyShaderModule(dev.GetVulkanDevice(), m_module, nullptr);
 }
 
 void VulkanShader::SetDebugName(std::string_view name)
@@ -46,23 +50,33 @@ std::unique_ptr<GPUShader> VulkanDevice::CreateShaderFromSource(GPUShaderStage s
 {
   DynamicHeapArray<u8> local_binary;
   DynamicHeapArray<u8>* dest_binary = out_binary ? out_binary : &local_binary;
+  if (!CompileShaderToBinary(stage, source, entry_point, dest_binary))
+    return {};
+
+  return CreateShaderFromBinary(stage, dest_binary->cspan());
+}
+
+bool VulkanDevice::CompileShaderToBinary(GPUShaderStage stage, std::string_view source, const char* entry_point,
+                                         DynamicHeapArray<u8>* out_binary)
+{
   if (!CompileGLSLShaderToVulkanSpv(stage, source, entry_point, m_optional_extensions.vk_khr_shader_non_semantic_info,
-                                    dest_binary))
+                                    out_binary))
   {
-    return {};
+    return false;
   }
 
-  AssertMsg((dest_binary->size() % 4) == 0, "Compile result should be 4 byte aligned.");
-
-  return CreateShaderFromBinary(stage, dest_binary->cspan());
+  AssertMsg((out_binary->size() % 4) == 0, "Compile result should be 4 byte aligned.");
+  return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 VulkanPipeline::VulkanPipeline(VkPipeline pipeline, Layout layout, u8 vertices_per_primitive,
-                               RenderPassFlag render_pass_flags)
+                               RenderPassFlag render_pass_flags, bool dynamic_depth, bool depth_test_enable,
+                               bool depth_write_enable, VkCompareOp depth_compare_op)
   : GPUPipeline(), m_pipeline(pipeline), m_layout(layout), m_vertices_per_primitive(vertices_per_primitive),
-    m_render_pass_flags(render_pass_flags)
+    m_render_pass_flags(render_pass_flags), m_dynamic_depth(dynamic_depth), m_depth_test_enable(depth_test_enable),
+    m_depth_write_enable(depth_write_enable), m_depth_compare_op(depth_compare_op)
 {
 }
 
@@ -76,6 +90,17 @@ void VulkanPipeline::SetDebugName(std::string_view name)
   Vulkan::SetObjectName(VulkanDevice::GetInstance().GetVulkanDevice(), m_pipeline, name);
 }
 
+void VulkanPipeline::Bind(VkCommandBuffer cmdbuf) const
+{
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+  if (m_dynamic_depth)
+  {
+    vkCmdSetDepthTestEnableEXT(cmdbuf, m_depth_test_enable);
+    vkCmdSetDepthWriteEnableEXT(cmdbuf, m_depth_write_enable);
+    vkCmdSetDepthCompareOpEXT(cmdbuf, m_depth_compare_op);
+  }
+}
+
 std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::GraphicsConfig& config)
 {
   static constexpr std::array<std::pair<VkPrimitiveTopology, u32>, static_cast<u32>(GPUPipeline::Primitive::MaxCount)>
@@ -171,8 +196,10 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
                             VK_FRONT_FACE_CLOCKWISE);
   if (config.samples > 1)
     gpb.SetMultisamples(config.samples, config.per_sample_shading);
-  gpb.SetDepthState(config.depth.depth_test != GPUPipeline::DepthFunc::Always || config.depth.depth_write,
-                    config.depth.depth_write, compare_mapping[static_cast<u8>(config.depth.depth_test.GetValue())]);
+  const bool depth_test_enable =
+    (config.depth.depth_test != GPUPipeline::DepthFunc::Always || config.depth.depth_write);
+  const VkCompareOp depth_compare_op = compare_mapping[static_cast<u8>(config.depth.depth_test.GetValue())];
+  gpb.SetDepthState(depth_test_enable, config.depth.depth_write, depth_compare_op);
   gpb.SetNoStencilState();
 
   for (u32 i = 0; i < MAX_RENDER_TARGETS; i++)
@@ -195,8 +222,19 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
   gpb.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT);
   gpb.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR);
 
+  // Dynamic depth state lets depth variants share a fragment shader library.
+  const bool dynamic_depth =
+    (m_optional_extensions.vk_ext_graphics_pipeline_library && m_optional_extensions.vk_ext_extended_dynamic_state);
+  if (dynamic_depth)
+  {
+    gpb.AddDynamicState(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+    gpb.AddDynamicState(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+    gpb.AddDynamicState(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+  }
+
   gpb.SetPipelineLayout(m_pipeline_layouts[static_cast<u8>(config.layout)]);
 
+  VkRenderPass render_pass = VK_NULL_HANDLE;
   if (m_optional_extensions.vk_khr_dynamic_rendering && (m_optional_extensions.vk_khr_dynamic_rendering_local_read ||
                                                          !(config.render_pass_flags & GPUPipeline::ColorFeedbackLoop)))
   {
@@ -226,15 +264,121 @@ std::unique_ptr<GPUPipeline> VulkanDevice::CreatePipeline(const GPUPipeline::Gra
   }
   else
   {
-    const VkRenderPass render_pass = GetRenderPass(config);
+    render_pass = GetRenderPass(config);
     DebugAssert(render_pass != VK_NULL_HANDLE);
     gpb.SetRenderPass(render_pass, 0);
   }
 
-  const VkPipeline pipeline = gpb.Create(m_device, m_pipeline_cache, false);
+  const VkPipeline pipeline = m_optional_extensions.vk_ext_graphics_pipeline_library ?
+                                CreatePipelineFromLibraries(config, render_pass, gpb) :
+                                gpb.Create(m_device, m_pipeline_cache, false);
   if (!pipeline)
     return {};
 
-  return std::unique_ptr<GPUPipeline>(
-    new VulkanPipeline(pipeline, config.layout, static_cast<u8>(vertices_per_primitive), config.render_pass_flags));
+  return std::unique_ptr<GPUPipeline>(new VulkanPipeline(pipeline, config.layout,
+                                                         static_cast<u8>(vertices_per_primitive),
+                                                         config.render_pass_flags, dynamic_depth, depth_test_enable,
+                                                         config.depth.depth_write, depth_compare_op));
+}
+
+template<typename T>
+static void AppendLibraryKey(std::string& key, const T& value)
+{
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+VkPipeline VulkanDevice::CreatePipelineFromLibraries(const GPUPipeline::GraphicsConfig& config,
+                                                     VkRenderPass render_pass, Vulkan::GraphicsPipelineBuilder& gpb)
+{
+  const VkShaderModule vs = static_cast<const VulkanShader*>(config.vertex_shader)->GetModule();
+  const VkShaderModule gs =
+    config.geometry_shader ? static_cast<const VulkanShader*>(config.geometry_shader)->GetModule() : VK_NULL_HANDLE;
+  const VkShaderModule fs = static_cast<const VulkanShader*>(config.fragment_shader)->GetModule();
+
+  // Everything but the vertex input library depends on the render targets and sample count.
+  std::string target_key;
+  AppendLibraryKey(target_key, render_pass);
+  AppendLibraryKey(target_key, config.color_formats);
+  AppendLibraryKey(target_key, config.depth_format);
+  AppendLibraryKey(target_key, config.samples);
+  AppendLibraryKey(target_key, config.per_sample_shading);
+  AppendLibraryKey(target_key, config.render_pass_flags);
+
+  std::array<VkPipeline, 4> libraries;
+
+  std::string key(1, 'V');
+  AppendLibraryKey(key, config.primitive);
+  AppendLibraryKey(key, config.input_layout.vertex_stride);
+  for (const GPUPipeline::VertexAttribute& va : config.input_layout.vertex_attributes)
+    AppendLibraryKey(key, va.key);
+  libraries[0] = GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, gpb,
+                                    VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+  key.assign(1, 'P');
+  AppendLibraryKey(key, vs);
+  AppendLibraryKey(key, gs);
+  AppendLibraryKey(key, config.rasterization.key);
+  AppendLibraryKey(key, config.layout);
+  key.append(target_key);
+  libraries[1] = GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+                                    gpb, vs, gs);
+
+  key.assign(1, 'F');
+  AppendLibraryKey(key, fs);
+  if (!m_optional_extensions.vk_ext_extended_dynamic_state)
+    AppendLibraryKey(key, config.depth.key);
+  AppendLibraryKey(key, config.layout);
+  key.append(target_key);
+  libraries[2] =
+    GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, gpb, fs, VK_NULL_HANDLE);
+
+  key.assign(1, 'O');
+  AppendLibraryKey(key, config.blend.key);
+  key.append(target_key);
+  libraries[3] = GetPipelineLibrary(std::move(key), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+                                    gpb, VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+  if (std::any_of(libraries.begin(), libraries.end(), [](VkPipeline p) { return p == VK_NULL_HANDLE; }))
+    return VK_NULL_HANDLE;
+
+  return Vulkan::GraphicsPipelineBuilder::LinkLibraries(m_device, m_pipeline_cache,
+                                                        m_pipeline_layouts[static_cast<u8>(config.layout)], libraries);
+}
+
+VkPipeline VulkanDevice::GetPipelineLibrary(std::string key, VkGraphicsPipelineLibraryFlagsEXT flags,
+                                            Vulkan::GraphicsPipelineBuilder& gpb, VkShaderModule shader0,
+                                            VkShaderModule shader1)
+{
+  const auto it = m_pipeline_libraries.find(key);
+  if (it != m_pipeline_libraries.end())
+    return it->second.pipeline;
+
+  const VkPipeline pipeline = gpb.CreateLibrary(m_device, m_pipeline_cache, flags);
+  if (pipeline != VK_NULL_HANDLE)
+    m_pipeline_libraries.emplace(std::move(key), PipelineLibrary{pipeline, {shader0, shader1}});
+
+  return pipeline;
+}
+
+void VulkanDevice::DestroyPipelineLibrariesForShader(VkShaderModule module)
+{
+  for (auto it = m_pipeline_libraries.begin(); it != m_pipeline_libraries.end();)
+  {
+    if (it->second.shaders[0] == module || it->second.shaders[1] == module)
+    {
+      DeferPipelineDestruction(it->second.pipeline);
+      it = m_pipeline_libraries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void VulkanDevice::DestroyPipelineLibraries()
+{
+  for (const auto& it : m_pipeline_libraries)
+    vkDestroyPipeline(m_device, it.second.pipeline, nullptr);
+  m_pipeline_libraries.clear();
 }
@@ -36,11 +36,20 @@ public:
 
   void SetDebugName(std::string_view name) override;
 
+  /// Binds the pipeline, and sets any state it leaves dynamic.
+  void Bind(VkCommandBuffer cmdbuf) const;
+
 private:
-  VulkanPipeline(VkPipeline pipeline, Layout layout, u8 vertices_per_primitive, RenderPassFlag render_pass_flags);
+  VulkanPipeline(VkPipeline pipeline, Layout layout, u8 vertices_per_primitive, RenderPassFlag render_pass_flags,
+                 bool dynamic_depth, bool depth_test_enable, bool depth_write_enable, VkCompareOp depth_compare_op);
 
   VkPipeline m_pipeline;
   Layout m_layout;
   u8 m_vertices_per_primitive;
   RenderPassFlag m_render_pass_flags;
+
+  bool m_dynamic_depth;
+  bool m_depth_test_enable;
+  bool m_depth_write_enable;
+  VkCompareOp m_depth_compare_op;
 };
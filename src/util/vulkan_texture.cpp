@@ -170,6 +170,144 @@ std::unique_ptr<VulkanTexture> VulkanTexture::Create(u32 width, u32 height, u32
     new VulkanTexture(width, height, layers, levels, samples, type, format, image, allocation, view, vk_format));
 }
 
+std::unique_ptr<VulkanTexture> VulkanTexture::CreateSparse(u32 width, u32 height, Type type, Format format,
+                                                           VkFormat vk_format)
+{
+  if (!ValidateConfig(width, height, 1, 1, 1, type, format))
+    return {};
+
+  VulkanDevice& dev = VulkanDevice::GetInstance();
+  DebugAssert(dev.GetFeatures().sparse_textures);
+
+  VkImageUsageFlags usage;
+  VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+  switch (type)
+  {
+    case Type::Texture:
+      usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+      break;
+
+    case Type::RenderTarget:
+      usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+              VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+      break;
+
+    case Type::DepthStencil:
+      usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+      aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+      break;
+
+    default:
+      return {};
+  }
+
+  u32 num_format_properties = 0;
+  vkGetPhysicalDeviceSparseImageFormatProperties(dev.GetVulkanPhysicalDevice(), vk_format, VK_IMAGE_TYPE_2D,
+                                                 VK_SAMPLE_COUNT_1_BIT, usage, VK_IMAGE_TILING_OPTIMAL,
+                                                 &num_format_properties, nullptr);
+  if (num_format_properties == 0)
+  {
+    Log_ErrorFmt("Sparse {} textures are not supported.", GetFormatName(format));
+    return {};
+  }
+
+  const VkImageCreateInfo ici = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                 nullptr,
+                                 VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT,
+                                 VK_IMAGE_TYPE_2D,
+                                 vk_format,
+                                 {width, height, 1u},
+                                 1u,
+                                 1u,
+                                 VK_SAMPLE_COUNT_1_BIT,
+                                 VK_IMAGE_TILING_OPTIMAL,
+                                 usage,
+                                 VK_SHARING_MODE_EXCLUSIVE,
+                                 0,
+                                 nullptr,
+                                 VK_IMAGE_LAYOUT_UNDEFINED};
+
+  VkImage image = VK_NULL_HANDLE;
+  VkResult res = vkCreateImage(dev.GetVulkanDevice(), &ici, nullptr, &image);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateImage() for sparse texture failed: ");
+    return {};
+  }
+
+  VkMemoryRequirements mem_req;
+  vkGetImageMemoryRequirements(dev.GetVulkanDevice(), image, &mem_req);
+
+  u32 num_sparse_reqs = 0;
+  vkGetImageSparseMemoryRequirements(dev.GetVulkanDevice(), image, &num_sparse_reqs, nullptr);
+  std::vector<VkSparseImageMemoryRequirements> sparse_reqs(num_sparse_reqs);
+  vkGetImageSparseMemoryRequirements(dev.GetVulkanDevice(), image, &num_sparse_reqs, sparse_reqs.data());
+
+  // We only bind tiles of the first level, so anything that needs a mip tail or metadata bound isn't usable.
+  const VkSparseImageMemoryRequirements* aspect_req = nullptr;
+  for (const VkSparseImageMemoryRequirements& req : sparse_reqs)
+  {
+    if (req.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT)
+    {
+      aspect_req = nullptr;
+      break;
+    }
+    else if (req.formatProperties.aspectMask & aspect)
+    {
+      aspect_req = &req;
+    }
+  }
+  if (!aspect_req || aspect_req->imageMipTailFirstLod == 0)
+  {
+    Log_ErrorFmt("Unusable sparse memory requirements for {}x{} {} texture.", width, height, GetFormatName(format));
+    vkDestroyImage(dev.GetVulkanDevice(), image, nullptr);
+    return {};
+  }
+
+  VmaAllocationCreateInfo aci = {};
+  aci.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  aci.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  u32 memory_type;
+  res = vmaFindMemoryTypeIndex(dev.GetAllocator(), mem_req.memoryTypeBits, &aci, &memory_type);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vmaFindMemoryTypeIndex() for sparse texture failed: ");
+    vkDestroyImage(dev.GetVulkanDevice(), image, nullptr);
+    return {};
+  }
+
+  const VkImageViewCreateInfo vci = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                                     nullptr,
+                                     0,
+                                     image,
+                                     VK_IMAGE_VIEW_TYPE_2D,
+                                     vk_format,
+                                     s_identity_swizzle,
+                                     {aspect, 0, 1, 0, 1}};
+  VkImageView view = VK_NULL_HANDLE;
+  res = vkCreateImageView(dev.GetVulkanDevice(), &vci, nullptr, &view);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateImageView failed: ");
+    vkDestroyImage(dev.GetVulkanDevice(), image, nullptr);
+    return {};
+  }
+
+  std::unique_ptr<VulkanTexture> tex(
+    new VulkanTexture(width, height, 1, 1, 1, type, format, image, VK_NULL_HANDLE, view, vk_format));
+  const VkExtent3D& granularity = aspect_req->formatProperties.imageGranularity;
+  tex->m_sparse_tile_width = static_cast<u16>(granularity.width);
+  tex->m_sparse_tile_height = static_cast<u16>(granularity.height);
+  tex->m_sparse_committed_tiles.resize(((width + granularity.width - 1) / granularity.width) *
+                                       ((height + granularity.height - 1) / granularity.height));
+  tex->m_sparse_tile_size = mem_req.alignment;
+  tex->m_sparse_memory_type = memory_type;
+  Log_DevFmt("Created sparse {}x{} {} texture with {}x{} tiles of {} bytes", width, height, GetFormatName(format),
+             granularity.width, granularity.height, mem_req.alignment);
+  return tex;
+}
+
 void VulkanTexture::Destroy(bool defer)
 {
   VulkanDevice& dev = VulkanDevice::GetInstance();
@@ -195,6 +333,22 @@ void VulkanTexture::Destroy(bool defer)
     m_view = VK_NULL_HANDLE;
   }
 
+  if (IsSparse())
+  {
+    if (defer)
+    {
+      VulkanDevice::GetInstance().DeferSparseImageDestruction(m_image, std::move(m_sparse_memory));
+    }
+    else
+    {
+      vkDestroyImage(VulkanDevice::GetInstance().GetVulkanDevice(), m_image, nullptr);
+      for (VkDeviceMemory memory : m_sparse_memory)
+        vkFreeMemory(VulkanDevice::GetInstance().GetVulkanDevice(), memory, nullptr);
+    }
+    m_image = VK_NULL_HANDLE;
+    m_sparse_memory.clear();
+  }
+
   // If we don't have device memory allocated, the image is not owned by us (e.g. swapchain)
   if (m_allocation != VK_NULL_HANDLE)
   {
@@ -242,13 +396,13 @@ VkCommandBuffer VulkanTexture::GetCommandBufferForUpdate()
 void VulkanTexture::CopyTextureDataForUpload(void* dst, const void* src, u32 width, u32 height, u32 pitch,
                                              u32 upload_pitch) const
 {
-  StringUtil::StrideMemCpy(dst, upload_pitch, src, pitch, GetPixelSize() * width, height);
+  StringUtil::StrideMemCpy(dst, upload_pitch, src, pitch, CalcUploadPitch(width), CalcUploadRows(height));
 }
 
 VkBuffer VulkanTexture::AllocateUploadStagingBuffer(const void* data, u32 pitch, u32 upload_pitch, u32 width,
                                                     u32 height) const
 {
-  const u32 size = upload_pitch * height;
+  const u32 size = CalcUploadSize(height, upload_pitch);
   const VkBufferCreateInfo bci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
                                   nullptr,
                                   0,
@@ -291,11 +445,12 @@ void VulkanTexture::UpdateFromBuffer(VkCommandBuffer cmdbuf, u32 x, u32 y, u32 w
   if (old_layout != Layout::TransferDst)
     TransitionSubresourcesToLayout(cmdbuf, layer, 1, level, 1, old_layout, Layout::TransferDst);
 
-  const u32 row_length = pitch / GetPixelSize();
+  const u32 row_length = CalcUploadRowLengthFromPitch(pitch);
+  const u32 image_height = CalcUploadRows(height) * GetCompressedBlockSize();
 
   const VkBufferImageCopy bic = {static_cast<VkDeviceSize>(buffer_offset),
                                  row_length,
-                                 height,
+                                 image_height,
                                  {VK_IMAGE_ASPECT_COLOR_BIT, static_cast<u32>(level), 0u, 1u},
                                  {static_cast<s32>(x), static_cast<s32>(y), 0},
                                  {width, height, 1u}};
@@ -306,16 +461,73 @@ void VulkanTexture::UpdateFromBuffer(VkCommandBuffer cmdbuf, u32 x, u32 y, u32 w
     TransitionSubresourcesToLayout(cmdbuf, layer, 1, level, 1, Layout::TransferDst, old_layout);
 }
 
+bool VulkanTexture::UpdateOnTransferQueue(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch,
+                                          u32 layer, u32 level, u32 upload_pitch)
+{
+  VulkanDevice& dev = VulkanDevice::GetInstance();
+  const VkBuffer buffer = AllocateUploadStagingBuffer(data, pitch, upload_pitch, width, height);
+  if (buffer == VK_NULL_HANDLE)
+    return false;
+
+  const VkCommandBuffer cmdbuf = dev.BeginTransferCommandBuffer();
+  if (cmdbuf == VK_NULL_HANDLE)
+    return false;
+
+  // The layout is only changed once the transfer is submitted, so a failure can fall back to the graphics queue.
+  TransitionSubresourcesToLayout(cmdbuf, 0, m_layers, 0, m_levels, Layout::Undefined, Layout::TransferDst);
+  m_layout = Layout::TransferDst;
+  UpdateFromBuffer(cmdbuf, x, y, width, height, layer, level, upload_pitch, buffer, 0);
+  m_layout = Layout::Undefined;
+
+  // Ownership goes back to the graphics queue with a release/acquire pair, which performs the layout transition once.
+  // The acquire is in the init command buffer, which runs after the graphics submission's semaphore wait.
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                  nullptr,
+                                  VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  0,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                  dev.GetTransferQueueFamilyIndex(),
+                                  dev.GetGraphicsQueueFamilyIndex(),
+                                  m_image,
+                                  {VK_IMAGE_ASPECT_COLOR_BIT, 0, m_levels, 0, m_layers}};
+  vkCmdPipelineBarrier(cmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+  if (!dev.SubmitTransferCommandBuffer())
+    return false;
+
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(dev.GetCurrentInitCommandBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+  m_layout = Layout::ShaderReadOnly;
+  return true;
+}
+
 bool VulkanTexture::Update(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch, u32 layer, u32 level)
 {
   DebugAssert(layer < m_layers && level < m_levels);
   DebugAssert((x + width) <= GetMipWidth(level) && (y + height) <= GetMipHeight(level));
 
-  const u32 upload_pitch = Common::AlignUpPow2(pitch, VulkanDevice::GetInstance().GetBufferCopyRowPitchAlignment());
-  const u32 required_size = height * upload_pitch;
+  const u32 upload_pitch =
+    Common::AlignUpPow2(CalcUploadPitch(width), VulkanDevice::GetInstance().GetBufferCopyRowPitchAlignment());
+  const u32 required_size = CalcUploadSize(height, upload_pitch);
   VulkanDevice& dev = VulkanDevice::GetInstance();
   VulkanStreamBuffer& sbuffer = dev.GetTextureUploadBuffer();
 
+  // Textures which haven't been touched yet can't be in use by the graphics queue, so bulk uploads into them (e.g.
+  // replacement textures) can run on the copy engine without serializing with rendering.
+  if (m_layout == Layout::Undefined && (m_type == Type::Texture || m_type == Type::DynamicTexture) &&
+      required_size >= VulkanDevice::MIN_TRANSFER_QUEUE_UPLOAD_SIZE && dev.HasTransferQueue())
+  {
+    if (UpdateOnTransferQueue(x, y, width, height, data, pitch, layer, level, upload_pitch))
+    {
+      GPUDevice::GetStatistics().buffer_streamed += required_size;
+      GPUDevice::GetStatistics().num_uploads++;
+      return true;
+    }
+  }
+
   // If the texture is larger than half our streaming buffer size, use a separate buffer.
   // Otherwise allocation will either fail, or require lots of cmdbuffer submissions.
   VkBuffer buffer;
@@ -729,6 +941,66 @@ void VulkanTexture::MakeReadyForSampling()
   TransitionToLayout(Layout::ShaderReadOnly);
 }
 
+bool VulkanTexture::CommitSparseRegion(u32 x, u32 y, u32 width, u32 height)
+{
+  if (!IsSparse())
+    return true;
+
+  const u32 tile_width = m_sparse_tile_width;
+  const u32 tile_height = m_sparse_tile_height;
+  DebugAssert((x % tile_width) == 0 && (y % tile_height) == 0);
+  DebugAssert(((x + width) % tile_width) == 0 || (x + width) == m_width);
+  DebugAssert(((y + height) % tile_height) == 0 || (y + height) == m_height);
+
+  VulkanDevice& dev = VulkanDevice::GetInstance();
+  const VkImageAspectFlags aspect = IsDepthStencil() ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+  const VkDeviceSize allocation_size = m_sparse_tile_size * SPARSE_TILES_PER_ALLOCATION;
+  const u32 tiles_wide = (m_width + tile_width - 1) / tile_width;
+  const u32 end_tile_x = std::min((x + width + tile_width - 1) / tile_width, tiles_wide);
+  const u32 end_tile_y = std::min((y + height + tile_height - 1) / tile_height,
+                                  static_cast<u32>(m_sparse_committed_tiles.size()) / tiles_wide);
+  for (u32 tile_y = y / tile_height; tile_y < end_tile_y; tile_y++)
+  {
+    for (u32 tile_x = x / tile_width; tile_x < end_tile_x; tile_x++)
+    {
+      const u32 tile_index = tile_y * tiles_wide + tile_x;
+      if (m_sparse_committed_tiles[tile_index])
+        continue;
+
+      if (m_sparse_memory.empty() || m_sparse_memory_offset == allocation_size)
+      {
+        const VkMemoryAllocateInfo ai = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, allocation_size,
+                                         m_sparse_memory_type};
+        VkDeviceMemory memory;
+        const VkResult res = vkAllocateMemory(dev.GetVulkanDevice(), &ai, nullptr, &memory);
+        if (res != VK_SUCCESS)
+        {
+          LOG_VULKAN_ERROR(res, "vkAllocateMemory() for sparse tiles failed: ");
+          return false;
+        }
+
+        m_sparse_memory.push_back(memory);
+        m_sparse_memory_offset = 0;
+      }
+
+      const u32 tile_left = tile_x * tile_width;
+      const u32 tile_top = tile_y * tile_height;
+      const VkSparseImageMemoryBind bind = {
+        {aspect, 0, 0},
+        {static_cast<s32>(tile_left), static_cast<s32>(tile_top), 0},
+        {std::min<u32>(tile_width, m_width - tile_left), std::min<u32>(tile_height, m_height - tile_top), 1u},
+        m_sparse_memory.back(),
+        m_sparse_memory_offset,
+        0};
+      dev.QueueSparseImageBind(m_image, bind);
+      m_sparse_memory_offset += m_sparse_tile_size;
+      m_sparse_committed_tiles[tile_index] = true;
+    }
+  }
+
+  return true;
+}
+
 std::unique_ptr<GPUTexture> VulkanDevice::CreateTexture(u32 width, u32 height, u32 layers, u32 levels, u32 samples,
                                                         GPUTexture::Type type, GPUTexture::Format format,
                                                         const void* data /* = nullptr */, u32 data_stride /* = 0 */)
@@ -742,6 +1014,16 @@ std::unique_ptr<GPUTexture> VulkanDevice::CreateTexture(u32 width, u32 height, u
   return tex;
 }
 
+std::unique_ptr<GPUTexture> VulkanDevice::CreateSparseTexture(u32 width, u32 height, GPUTexture::Type type,
+                                                              GPUTexture::Format format)
+{
+  if (!m_features.sparse_textures)
+    return {};
+
+  const VkFormat vk_format = VulkanDevice::TEXTURE_FORMAT_MAPPING[static_cast<u8>(format)];
+  return VulkanTexture::CreateSparse(width, height, type, format, vk_format);
+}
+
 VulkanSampler::VulkanSampler(VkSampler sampler) : m_sampler(sampler)
 {
 }
@@ -39,6 +39,8 @@ public:
 
   static std::unique_ptr<VulkanTexture> Create(u32 width, u32 height, u32 layers, u32 levels, u32 samples, Type type,
                                                Format format, VkFormat vk_format);
+  static std::unique_ptr<VulkanTexture> CreateSparse(u32 width, u32 height, Type type, Format format,
+                                                     VkFormat vk_format);
   void Destroy(bool defer);
 
   ALWAYS_INLINE VkImage GetImage() const { return m_image; }
@@ -54,6 +56,7 @@ public:
   bool Map(void** map, u32* map_stride, u32 x, u32 y, u32 width, u32 height, u32 layer = 0, u32 level = 0) override;
   void Unmap() override;
   void MakeReadyForSampling() override;
+  bool CommitSparseRegion(u32 x, u32 y, u32 width, u32 height) override;
 
   void SetDebugName(std::string_view name) override;
 
@@ -80,6 +83,9 @@ public:
   VkDescriptorSet GetDescriptorSetWithSampler(VkSampler sampler);
 
 private:
+  // Tiles are suballocated from blocks of this many, so committing a small region doesn't need an allocation each time.
+  static constexpr u32 SPARSE_TILES_PER_ALLOCATION = 64;
+
   VulkanTexture(u32 width, u32 height, u32 layers, u32 levels, u32 samples, Type type, Format format, VkImage image,
                 VmaAllocation allocation, VkImageView view, VkFormat vk_format);
 
@@ -88,6 +94,8 @@ private:
   VkBuffer AllocateUploadStagingBuffer(const void* data, u32 pitch, u32 upload_pitch, u32 width, u32 height) const;
   void UpdateFromBuffer(VkCommandBuffer cmdbuf, u32 x, u32 y, u32 width, u32 height, u32 layer, u32 level, u32 pitch,
                         VkBuffer buffer, u32 buffer_offset);
+  bool UpdateOnTransferQueue(u32 x, u32 y, u32 width, u32 height, const void* data, u32 pitch, u32 layer, u32 level,
+                             u32 upload_pitch);
 
   VkImage m_image = VK_NULL_HANDLE;
   VmaAllocation m_allocation = VK_NULL_HANDLE;
@@ -102,6 +110,13 @@ private:
   // Single-bind-point descriptor/sampler pairs.
   std::vector<std::pair<VkSampler, VkDescriptorSet>> m_descriptor_sets;
 
+  // Sparse textures only. Memory is never released until the texture is destroyed.
+  std::vector<VkDeviceMemory> m_sparse_memory;
+  std::vector<bool> m_sparse_committed_tiles;
+  VkDeviceSize m_sparse_tile_size = 0;
+  VkDeviceSize m_sparse_memory_offset = 0;
+  u32 m_sparse_memory_type = 0;
+
   u16 m_map_x = 0;
   u16 m_map_y = 0;
   u16 m_map_width = 0;
@@ -4,6 +4,14 @@
 #include "wav_writer.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/threading.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 Log_SetChannel(WAVWriter);
 
 namespace {
@@ -33,8 +41,55 @@ struct WAV_HEADER
   } data_chunk_header;
 };
 #pragma pack(pop)
+
+struct AsyncBuffer
+{
+  WAVWriter* writer;
+  std::vector<s16> samples;
+};
 } // namespace
 
+// Buffers waiting to be written are capped at this size, beyond which the caller waits.
+static constexpr size_t MAX_QUEUED_ASYNC_BYTES = 64 * 1024 * 1024;
+
+static std::thread s_async_thread;
+static std::mutex s_async_mutex;
+static std::condition_variable s_async_work_cv;
+static std::condition_variable s_async_done_cv;
+static std::deque<AsyncBuffer> s_async_queue;
+static std::vector<std::vector<s16>> s_async_free_buffers;
+static size_t s_async_queued_bytes = 0;
+static u32 s_async_writer_count = 0;
+static bool s_async_shutdown = false;
+
+void WAVWriter::AsyncThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("WAV Writer Thread");
+
+  std::unique_lock lock(s_async_mutex);
+  for (;;)
+  {
+    s_async_work_cv.wait(lock, []() { return (s_async_shutdown || !s_async_queue.empty()); });
+    if (s_async_queue.empty())
+      break;
+
+    AsyncBuffer buf = std::move(s_async_queue.front());
+    s_async_queue.pop_front();
+    lock.unlock();
+
+    const u32 num_frames = static_cast<u32>(buf.samples.size() / buf.writer->m_num_channels);
+    const u32 num_frames_written = buf.writer->WriteToFile(buf.samples.data(), num_frames);
+
+    lock.lock();
+    s_async_queued_bytes -= buf.samples.size() * sizeof(SampleType);
+    buf.writer->m_lost_frames += num_frames - num_frames_written;
+    buf.writer->m_pending_buffers--;
+    buf.samples.clear();
+    s_async_free_buffers.push_back(std::move(buf.samples));
+    s_async_done_cv.notify_all();
+  }
+}
+
 WAVWriter::WAVWriter() = default;
 
 WAVWriter::~WAVWriter()
@@ -43,7 +98,7 @@ WAVWriter::~WAVWriter()
     Close();
 }
 
-bool WAVWriter::Open(const char* filename, u32 sample_rate, u32 num_channels)
+bool WAVWriter::Open(const char* filename, u32 sample_rate, u32 num_channels, bool async /* = false */)
 {
   if (IsOpen())
     Close();
@@ -65,6 +120,19 @@ bool WAVWriter::Open(const char* filename, u32 sample_rate, u32 num_channels)
     return false;
   }
 
+  m_buffer.reserve(BUFFER_FRAMES * m_num_channels);
+
+  m_async = async;
+  if (m_async)
+  {
+    std::unique_lock lock(s_async_mutex);
+    if ((s_async_writer_count++) == 0)
+    {
+      s_async_shutdown = false;
+      s_async_thread = std::thread(&WAVWriter::AsyncThreadEntryPoint);
+    }
+  }
+
   return true;
 }
 
@@ -73,6 +141,24 @@ void WAVWriter::Close()
   if (!IsOpen())
     return;
 
+  FlushBuffer();
+
+  if (m_async)
+  {
+    std::unique_lock lock(s_async_mutex);
+    s_async_done_cv.wait(lock, [this]() { return (m_pending_buffers == 0); });
+    m_num_frames -= m_lost_frames;
+
+    if ((--s_async_writer_count) == 0)
+    {
+      s_async_shutdown = true;
+      s_async_work_cv.notify_one();
+      lock.unlock();
+      s_async_thread.join();
+      s_async_free_buffers.clear();
+    }
+  }
+
   if (std::fseek(m_file, 0, SEEK_SET) != 0 || !WriteHeader())
     Log_ErrorPrintf("Failed to re-write header on file, file may be unplayable");
 
@@ -81,16 +167,70 @@ void WAVWriter::Close()
   m_sample_rate = 0;
   m_num_channels = 0;
   m_num_frames = 0;
+  m_lost_frames = 0;
+  m_async = false;
+  m_buffer = {};
 }
 
 void WAVWriter::WriteFrames(const s16* samples, u32 num_frames)
+{
+  while (num_frames > 0)
+  {
+    const u32 buffered_frames = static_cast<u32>(m_buffer.size() / m_num_channels);
+    const u32 frames_to_copy = std::min(num_frames, BUFFER_FRAMES - buffered_frames);
+    m_buffer.insert(m_buffer.end(), samples, samples + frames_to_copy * m_num_channels);
+    samples += frames_to_copy * m_num_channels;
+    num_frames -= frames_to_copy;
+
+    if ((buffered_frames + frames_to_copy) == BUFFER_FRAMES)
+      FlushBuffer();
+  }
+}
+
+void WAVWriter::FlushBuffer()
+{
+  if (m_buffer.empty())
+    return;
+
+  const u32 num_frames = static_cast<u32>(m_buffer.size() / m_num_channels);
+  if (!m_async)
+  {
+    m_num_frames += WriteToFile(m_buffer.data(), num_frames);
+    m_buffer.clear();
+    return;
+  }
+
+  std::unique_lock lock(s_async_mutex);
+  s_async_done_cv.wait(lock, []() { return (s_async_queued_bytes < MAX_QUEUED_ASYNC_BYTES); });
+
+  // Swap in a buffer which has already been written, so the caller doesn't have to allocate.
+  std::vector<SampleType> next_buffer;
+  if (!s_async_free_buffers.empty())
+  {
+    next_buffer = std::move(s_async_free_buffers.back());
+    s_async_free_buffers.pop_back();
+  }
+  else
+  {
+    next_buffer.reserve(BUFFER_FRAMES * m_num_channels);
+  }
+
+  s_async_queued_bytes += m_buffer.size() * sizeof(SampleType);
+  s_async_queue.push_back(AsyncBuffer{this, std::move(m_buffer)});
+  m_buffer = std::move(next_buffer);
+  m_num_frames += num_frames;
+  m_pending_buffers++;
+  s_async_work_cv.notify_one();
+}
+
+u32 WAVWriter::WriteToFile(const SampleType* samples, u32 num_frames)
 {
   const u32 num_frames_written =
-    static_cast<u32>(std::fwrite(samples, sizeof(s16) * m_num_channels, num_frames, m_file));
+    static_cast<u32>(std::fwrite(samples, sizeof(SampleType) * m_num_channels, num_frames, m_file));
   if (num_frames_written != num_frames)
     Log_ErrorPrintf("Only wrote %u of %u frames to output file", num_frames_written, num_frames);
 
-  m_num_frames += num_frames_written;
+  return num_frames_written;
 }
 
 bool WAVWriter::WriteHeader()
@@ -4,6 +4,7 @@
 #pragma once
 #include "common/types.h"
 #include <cstdio>
+#include <vector>
 
 class WAVWriter
 {
@@ -16,7 +17,9 @@ public:
   ALWAYS_INLINE u32 GetNumFrames() const { return m_num_frames; }
   ALWAYS_INLINE bool IsOpen() const { return (m_file != nullptr); }
 
-  bool Open(const char* filename, u32 sample_rate, u32 num_channels);
+  /// Frames are buffered in memory before being written. If async is set, buffers are handed off to a background
+  /// thread shared by all writers, so a stalled disk doesn't hold up the caller.
+  bool Open(const char* filename, u32 sample_rate, u32 num_channels, bool async = false);
   void Close();
 
   void WriteFrames(const s16* samples, u32 num_frames);
@@ -24,10 +27,23 @@ public:
 private:
   using SampleType = s16;
 
+  static constexpr u32 BUFFER_FRAMES = 16384;
+
+  static void AsyncThreadEntryPoint();
+
   bool WriteHeader();
+  void FlushBuffer();
+  u32 WriteToFile(const SampleType* samples, u32 num_frames);
 
   std::FILE* m_file = nullptr;
   u32 m_sample_rate = 0;
   u32 m_num_channels = 0;
   u32 m_num_frames = 0;
+  bool m_async = false;
+
+  std::vector<SampleType> m_buffer;
+
+  // Only accessed with the background writer's lock held.
+  u32 m_pending_buffers = 0;
+  u32 m_lost_frames = 0;
 };
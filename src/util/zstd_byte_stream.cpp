@@ -4,6 +4,7 @@
 #include "common/byte_stream.h"
 #include "common/log.h"
 
+#include <zdict.h>
 #include <zstd.h>
 #include <zstd_errors.h>
 
@@ -13,10 +14,33 @@ namespace {
 class ZstdCompressStream final : public ByteStream
 {
 public:
-  ZstdCompressStream(ByteStream* dst_stream, int compression_level) : m_dst_stream(dst_stream)
+  ZstdCompressStream(ByteStream* dst_stream, int compression_level, u32 num_threads, std::span<const u8> dictionary)
+    : m_dst_stream(dst_stream)
   {
     m_cstream = ZSTD_createCStream();
     ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_compressionLevel, compression_level);
+
+    if (!dictionary.empty())
+    {
+      const size_t ret = ZSTD_CCtx_loadDictionary_byReference(m_cstream, dictionary.data(), dictionary.size());
+      if (ZSTD_isError(ret))
+        Log_ErrorPrintf("ZSTD_CCtx_loadDictionary_byReference() failed: %s", ZSTD_getErrorName(ret));
+    }
+
+    if (num_threads > 0)
+    {
+      // fails if libzstd was built without multithreading, in which case we just compress on this thread
+      const size_t ret = ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_nbWorkers, static_cast<int>(num_threads));
+      if (ZSTD_isError(ret))
+      {
+        Log_DevPrintf("Multithreaded zstd compression is unavailable: %s", ZSTD_getErrorName(ret));
+      }
+      else
+      {
+        // save states are only a few megabytes, use the smallest jobs so they're actually split across workers
+        ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_jobSize, static_cast<int>(MIN_JOB_SIZE));
+      }
+    }
   }
 
   ~ZstdCompressStream() override
@@ -89,6 +113,7 @@ private:
   {
     INPUT_BUFFER_SIZE = 131072,
     OUTPUT_BUFFER_SIZE = 65536,
+    MIN_JOB_SIZE = 512 * 1024,
   };
 
   bool Compress(ZSTD_EndDirective action)
@@ -155,20 +180,41 @@ private:
 };
 } // namespace
 
-std::unique_ptr<ByteStream> ByteStream::CreateZstdCompressStream(ByteStream* src_stream, int compression_level)
+std::unique_ptr<ByteStream> ByteStream::CreateZstdCompressStream(ByteStream* src_stream, int compression_level,
+                                                                  u32 num_threads, std::span<const u8> dictionary)
 {
-  return std::make_unique<ZstdCompressStream>(src_stream, compression_level);
+  return std::make_unique<ZstdCompressStream>(src_stream, compression_level, num_threads, dictionary);
 }
 
 namespace {
 class ZstdDecompressStream final : public ByteStream
 {
 public:
-  ZstdDecompressStream(ByteStream* src_stream, u32 compressed_size)
+  ZstdDecompressStream(ByteStream* src_stream, u32 compressed_size, std::span<const u8> dictionary)
     : m_src_stream(src_stream), m_bytes_remaining(compressed_size)
   {
     m_cstream = ZSTD_createDStream();
-    m_in_buffer.src = m_input_buffer;
+
+    if (!dictionary.empty())
+    {
+      const size_t ret = ZSTD_DCtx_loadDictionary_byReference(m_cstream, dictionary.data(), dictionary.size());
+      if (ZSTD_isError(ret))
+        Log_ErrorPrintf("ZSTD_DCtx_loadDictionary_byReference() failed: %s", ZSTD_getErrorName(ret));
+    }
+
+    // If the source is already in memory (e.g. a mapped save state), decompress straight from it.
+    const u8* src_ptr = src_stream->GetReadPointer(compressed_size);
+    if (src_ptr && src_stream->SeekRelative(compressed_size))
+    {
+      m_in_buffer.src = src_ptr;
+      m_in_buffer.size = compressed_size;
+      m_bytes_remaining = 0;
+    }
+    else
+    {
+      m_in_buffer.src = m_input_buffer;
+    }
+
     Decompress();
   }
 
@@ -311,7 +357,24 @@ private:
 };
 } // namespace
 
-std::unique_ptr<ByteStream> ByteStream::CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size)
+std::unique_ptr<ByteStream> ByteStream::CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size,
+                                                                    std::span<const u8> dictionary)
+{
+  return std::make_unique<ZstdDecompressStream>(src_stream, compressed_size, dictionary);
+}
+
+std::vector<u8> ByteStream::TrainZstdDictionary(const void* sample_data, std::span<const size_t> sample_sizes,
+                                                u32 max_dictionary_size)
 {
-  return std::make_unique<ZstdDecompressStream>(src_stream, compressed_size);
+  std::vector<u8> dictionary(max_dictionary_size);
+  const size_t ret = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), sample_data, sample_sizes.data(),
+                                           static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(ret))
+  {
+    Log_WarningPrintf("ZDICT_trainFromBuffer() failed: %s", ZDICT_getErrorName(ret));
+    return {};
+  }
+
+  dictionary.resize(ret);
+  return dictionary;
 }